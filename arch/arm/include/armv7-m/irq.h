@@ -202,6 +202,10 @@ struct xcpt_syscall_s
 {
   uint32_t excreturn;   /* The EXC_RETURN value */
   uint32_t sysreturn;   /* The return PC */
+#ifdef CONFIG_SYSCALL_STATS
+  uint32_t nr;          /* The system call number */
+  uint32_t start;       /* up_perf_gettime() on entry */
+#endif
 };
 #endif
 
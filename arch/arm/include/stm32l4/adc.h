@@ -0,0 +1,91 @@
+/****************************************************************************
+ * arch/arm/include/stm32l4/adc.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_INCLUDE_STM32L4_ADC_H
+#define __ARCH_ARM_INCLUDE_STM32L4_ADC_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Values of ovs_flags */
+
+#define STM32L4_ADCOVS_REGULAR    (1 << 0) /* Oversample the regular group */
+#define STM32L4_ADCOVS_INJECTED   (1 << 1) /* Oversample the injected group */
+#define STM32L4_ADCOVS_TRIGGERED  (1 << 2) /* One trigger per regular sample */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Argument of ANIOC_STM32L4_OVERSAMPLE.  The hardware accumulates
+ * 2^ovs_ratio conversions and shifts the sum right by ovs_shift bits; with
+ * a 12-bit resolution, a 16x ratio without shift gives 16-bit results.
+ * Results are truncated to 16 bits, so ratios above 16x need a shift.
+ */
+
+struct stm32l4_adc_ovs_s
+{
+  uint8_t ovs_ratio;               /* log2 of the ratio: 1 (2x) to 8 (256x) */
+  uint8_t ovs_shift;               /* Right shift of the sum: 0 to 8 */
+  uint8_t ovs_flags;               /* See STM32L4_ADCOVS_*; 0: disabled */
+};
+
+/* The ADC DMA streaming device (see CONFIG_STM32L4_ADCx_STREAM) delivers
+ * samples in blocks of raw, right-aligned uint16_t values, the channels of
+ * the conversion sequence interleaved in sequence order.  The DMA fills the
+ * two halves of a circular buffer in turn, so block n is found in half
+ * (n & 1).  A completed block stays intact until the DMA has completed the
+ * next one.
+ *
+ * In dual interleaved mode (CONFIG_STM32L4_ADC_DUAL), each channel of the
+ * sequence yields a sample of ADC1 followed by a sample of ADC2.
+ *
+ * read() copies the latest completed block and fails with EINVAL if the
+ * buffer cannot hold a whole block.  Alternatively the circular buffer can
+ * be mapped with mmap() and ANIOC_STM32L4_STREAM_WAIT used to learn where
+ * the next block is.
+ */
+
+/* Returned by ANIOC_STM32L4_STREAM_INFO */
+
+struct stm32l4_adcstream_info_s
+{
+  uint32_t si_blocksize;           /* Bytes per block */
+  uint32_t si_bufsize;             /* Bytes in the mmap()able buffer */
+  uint32_t si_lost;                /* Blocks overwritten before being read */
+  uint8_t  si_nchannels;           /* Channels interleaved in each block */
+};
+
+/* Returned by ANIOC_STM32L4_STREAM_WAIT */
+
+struct stm32l4_adcstream_block_s
+{
+  uint32_t sb_seq;                 /* Sequence number of the block */
+  uint32_t sb_offset;              /* Byte offset in the mapped buffer */
+};
+
+#endif /* __ARCH_ARM_INCLUDE_STM32L4_ADC_H */
@@ -0,0 +1,63 @@
+/****************************************************************************
+ * arch/arm/include/stm32l4/can.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_INCLUDE_STM32L4_CAN_H
+#define __ARCH_ARM_INCLUDE_STM32L4_CAN_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Values of cf_flags */
+
+#define STM32L4_CANFRAME_EXTID    (1 << 0) /* cf_id is a 29-bit identifier */
+#define STM32L4_CANFRAME_RTR      (1 << 1) /* Remote transmission request */
+#define STM32L4_CANFRAME_FIFO1    (1 << 2) /* Received through RX FIFO 1 */
+#define STM32L4_CANFRAME_OVERRUN  (1 << 3) /* Frames were lost before this one */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Frame format returned by read() on the bxCAN RX ring device (see
+ * CONFIG_STM32L4_CAN_RXRING).  A read() returns as many whole frames as
+ * fit in the user buffer.
+ *
+ * cf_ts is the value of the 16-bit bxCAN timer, which counts CAN bit times,
+ * sampled by hardware at the start of frame.  It wraps around every 65536
+ * bit times (65.5 ms at 1 Mbit/s).
+ */
+
+struct stm32l4_canframe_s
+{
+  uint32_t cf_id;                  /* 11- or 29-bit identifier */
+  uint16_t cf_ts;                  /* Hardware timestamp in bit times */
+  uint8_t  cf_dlc;                 /* Data length code */
+  uint8_t  cf_flags;               /* See STM32L4_CANFRAME_* */
+  uint8_t  cf_data[8];             /* Frame data */
+};
+
+#endif /* __ARCH_ARM_INCLUDE_STM32L4_CAN_H */
@@ -0,0 +1,67 @@
+/****************************************************************************
+ * arch/arm/include/stm32l4/dac.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_INCLUDE_STM32L4_DAC_H
+#define __ARCH_ARM_INCLUDE_STM32L4_DAC_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/compiler.h>
+
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Values of wv_flags */
+
+#define STM32L4_DACWAVE_DUAL  (1 << 0) /* Drive DAC1 and DAC2 together */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Argument of ANIOC_STM32L4_DAC_WAVESTART and ANIOC_STM32L4_DAC_WAVESWAP.
+ *
+ * The table holds one period of 12-bit right-aligned samples that the DMA
+ * replays continuously at wv_rate samples per second.  The table is copied
+ * by the driver, so the caller may reuse it as soon as the ioctl returns.
+ * With STM32L4_DACWAVE_DUAL (DAC1 only), the table holds wv_nsamples pairs
+ * of DAC1 and DAC2 samples and both outputs are updated by the same timer
+ * trigger.
+ *
+ * A swap replaces the table at the end of the current period, so the
+ * output changes from the last sample of the old table to the first sample
+ * of the new one.  It requires the same number of samples and flags as the
+ * running waveform; wv_rate is ignored.
+ */
+
+struct stm32l4_dac_wave_s
+{
+  FAR const uint16_t *wv_samples;  /* One period of samples */
+  uint16_t wv_nsamples;            /* Samples (or pairs) per period; even */
+  uint8_t  wv_flags;               /* See STM32L4_DACWAVE_* */
+  uint32_t wv_rate;                /* Sample rate in Hz; 0: keep current */
+};
+
+#endif /* __ARCH_ARM_INCLUDE_STM32L4_DAC_H */
@@ -0,0 +1,72 @@
+/****************************************************************************
+ * arch/arm/include/stm32l4/dfsdm.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_INCLUDE_STM32L4_DFSDM_H
+#define __ARCH_ARM_INCLUDE_STM32L4_DFSDM_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdint.h>
+
+#include <nuttx/fs/ioctl.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Audio ioctl commands of the DFSDM PDM microphone device.  These are
+ * forwarded by the audio upper half and sit above the generic AUDIOIOC_*
+ * commands.
+ *
+ * AUDIOIOC_STM32L4_GETFILTER
+ *   Return the filter configuration shared by all microphones.
+ *   Argument: struct stm32l4_dfsdm_filter_s *
+ *
+ * AUDIOIOC_STM32L4_SETFILTER
+ *   Set the filter configuration.  The sample rate becomes the PDM clock
+ *   divided by df_fosr * df_iosr.  Only allowed while stopped.
+ *   Argument: const struct stm32l4_dfsdm_filter_s *
+ */
+
+#define AUDIOIOC_STM32L4_GETFILTER  _AUDIOIOC(0xf0)
+#define AUDIOIOC_STM32L4_SETFILTER  _AUDIOIOC(0xf1)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Argument of AUDIOIOC_STM32L4_GETFILTER/SETFILTER.  The output of a sinc
+ * filter of order N spans (df_fosr ^ N) * df_iosr; df_shift must bring it
+ * within the 24-bit data register.
+ */
+
+struct stm32l4_dfsdm_filter_s
+{
+  uint32_t df_pdmclk;              /* PDM clock in Hz (read only) */
+  uint16_t df_fosr;                /* Sinc decimation ratio: 1 to 1024 */
+  uint16_t df_iosr;                /* Integrator ratio: 1 to 256 */
+  uint8_t  df_order;               /* Sinc order: 0 (FastSinc), 1 to 5 */
+  uint8_t  df_shift;               /* Data right shift: 0 to 31 */
+  int32_t  df_offset;              /* 24-bit offset correction */
+};
+
+#endif /* __ARCH_ARM_INCLUDE_STM32L4_DFSDM_H */
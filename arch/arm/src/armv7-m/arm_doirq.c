@@ -36,11 +36,25 @@
 #include "arm_internal.h"
 #include "exc_return.h"
 
+#ifdef CONFIG_ARMV7M_STACKGUARD
+#  include "mpu.h"
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_ARMV7M_RAMFUNC_IRQ
+#  define doirq_ramfunc __ramfunc__
+#else
+#  define doirq_ramfunc
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
-uint32_t *arm_doirq(int irq, uint32_t *regs)
+doirq_ramfunc uint32_t *arm_doirq(int irq, uint32_t *regs)
 {
   board_autoled_on(LED_INIRQ);
 #ifdef CONFIG_SUPPRESS_INTERRUPTS
@@ -79,6 +93,12 @@ uint32_t *arm_doirq(int irq, uint32_t *regs)
 
           g_running_tasks[this_cpu()] = this_task();
 
+#ifdef CONFIG_ARMV7M_STACKGUARD
+          /* Move the stack guard to the bottom of the new stack */
+
+          mpu_stackguard((uintptr_t)this_task()->stack_base_ptr);
+#endif
+
           restore_critical_section();
           regs = (uint32_t *)CURRENT_REGS;
         }
@@ -0,0 +1,210 @@
+/****************************************************************************
+ * arch/arm/src/armv7-m/arm_itm_note.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/note/note_driver.h>
+
+#include "nvic.h"
+#include "itm.h"
+#include "tpi.h"
+#include "dwt.h"
+#include "arm_internal.h"
+#include "itm_note.h"
+
+#ifdef CONFIG_ARMV7M_ITMNOTE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_ARMV7M_ITMNOTE_SWODIV
+#  define CONFIG_ARMV7M_ITMNOTE_SWODIV 1
+#endif
+
+#ifndef CONFIG_ARMV7M_ITMNOTE_PORT
+#  define CONFIG_ARMV7M_ITMNOTE_PORT 1
+#endif
+
+#define ITMNOTE_PORT ITM_PORT(CONFIG_ARMV7M_ITMNOTE_PORT)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void itmnote_add(FAR struct note_driver_s *drv,
+                        FAR const void *note, size_t notelen);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct note_driver_ops_s g_itmnote_ops =
+{
+  itmnote_add,
+};
+
+static struct note_driver_s g_itmnote_driver =
+{
+  &g_itmnote_ops
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: itmnote_wait
+ *
+ * Description:
+ *   Wait until the stimulus port FIFO can take another write.
+ *
+ ****************************************************************************/
+
+static inline void itmnote_wait(void)
+{
+  while (getreg32(ITMNOTE_PORT) == 0);
+}
+
+/****************************************************************************
+ * Name: itmnote_add
+ *
+ * Description:
+ *   Put the variable length note to the ITM stimulus port.  Full words are
+ *   written as 32-bit stimulus packets, which cost five bits on the wire
+ *   per four bytes less than byte packets; the tail goes out byte by byte.
+ *   Notes are written with interrupts disabled so that notes from nested
+ *   interrupts cannot interleave.
+ *
+ * Input Parameters:
+ *   drv     - The note driver
+ *   note    - The note buffer
+ *   notelen - The buffer length
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void itmnote_add(FAR struct note_driver_s *drv,
+                        FAR const void *note, size_t notelen)
+{
+  FAR const uint8_t *buf = note;
+  irqstate_t flags;
+  uint32_t word;
+
+  UNUSED(drv);
+
+  /* Drop the note if the debugger disabled the ITM or the port */
+
+  if ((getreg32(ITM_TCR) & ITM_TCR_ITMENA_MASK) == 0 ||
+      (getreg32(ITM_TER) & (1 << CONFIG_ARMV7M_ITMNOTE_PORT)) == 0)
+    {
+      return;
+    }
+
+  flags = up_irq_save();
+
+  for (; notelen >= 4; notelen -= 4, buf += 4)
+    {
+      word = (uint32_t)buf[0]         | ((uint32_t)buf[1] << 8) |
+             ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+
+      itmnote_wait();
+      putreg32(word, ITMNOTE_PORT);
+    }
+
+  for (; notelen > 0; notelen--)
+    {
+      itmnote_wait();
+      putreg8(*buf++, ITMNOTE_PORT);
+    }
+
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: itm_note_initialize
+ *
+ * Description:
+ *   Configure the ITM and TPIU for SWO output and register the ITM sched
+ *   note driver.  Additional, MCU specific logic may be required to:
+ *
+ *   - Enable/configured serial wire output pins
+ *   - Enable debug clocking.
+ *
+ *   Those operations must be performed by MCU-specific logic before this
+ *   function is called.
+ *
+ ****************************************************************************/
+
+void itm_note_initialize(void)
+{
+  uint32_t regval;
+  int ret;
+
+  /* Enable trace in core debug */
+
+  regval  = getreg32(NVIC_DEMCR);
+  regval |= NVIC_DEMCR_TRCENA;
+  putreg32(regval, NVIC_DEMCR);
+
+  putreg32(0xc5acce55, ITM_LAR);
+
+  /* Leave the TPIU alone if the ITM SYSLOG already set it up */
+
+  if ((getreg32(ITM_TCR) & ITM_TCR_ITMENA_MASK) == 0)
+    {
+      putreg32(0,          ITM_TER);
+      putreg32(2,          TPI_SPPR); /* Pin protocol: 2=> NRZ (USART) */
+
+      /* TRACECLKIN/(ACPR+1) SWO speed, TRACECLKIN itself by default */
+
+      regval = CONFIG_ARMV7M_ITMNOTE_SWODIV - 1;
+      putreg32(regval,     TPI_ACPR);
+
+      putreg32(0,          ITM_TPR);
+      putreg32(0x400003fe, DWT_CTRL);
+      putreg32(0x0001000d, ITM_TCR);
+      putreg32(0x00000100, TPI_FFCR); /* Bypass the formatter */
+    }
+
+  modifyreg32(ITM_TER, 0, 1 << CONFIG_ARMV7M_ITMNOTE_PORT);
+
+  ret = note_driver_register(&g_itmnote_driver);
+  if (ret < 0)
+    {
+      serr("note_driver_register failed %d\n", ret);
+    }
+}
+
+#endif /* CONFIG_ARMV7M_ITMNOTE */
@@ -33,6 +33,11 @@
 #include "nvic.h"
 #include "arm_internal.h"
 
+#ifdef CONFIG_ARMV7M_STACKGUARD
+#  include "sched/sched.h"
+#  include "mpu.h"
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -98,6 +103,23 @@ int arm_memfault(int irq, void *context, void *arg)
       mfalert("\tFloating-point lazy state preservation error\n");
     }
 
+#ifdef CONFIG_ARMV7M_STACKGUARD
+  /* A stacking error or an access to the guard region means that the
+   * running thread has overflowed its stack.
+   */
+
+  if ((cfsr & NVIC_CFAULTS_MSTKERR) != 0 ||
+      ((cfsr & NVIC_CFAULTS_MMARVALID) != 0 &&
+       mpu_stackguard_hit(getreg32(NVIC_MEMMANAGE_ADDR))))
+    {
+      _alert("Stack overflow in PID %d\n", this_task()->pid);
+    }
+
+  /* Let the crash dump read the stack */
+
+  mpu_stackguard(0);
+#endif
+
   up_irq_save();
   PANIC_WITH_REGS("panic", context);
   return OK; /* Won't get here */
@@ -40,6 +40,19 @@
 #  define CONFIG_ARM_MPU_NREGIONS 8
 #endif
 
+/* Stack guard region: no access, never executable.  It is the highest
+ * region, which takes precedence over all the others, and is not handed
+ * out by mpu_allocregion().
+ */
+
+#ifdef CONFIG_ARMV7M_STACKGUARD
+#  define STACKGUARD_REGION (CONFIG_ARM_MPU_NREGIONS - 1)
+#  define STACKGUARD_SIZE  (1 << CONFIG_ARMV7M_STACKGUARD_L2SIZE)
+#  define STACKGUARD_RASR  (MPU_RASR_ENABLE | MPU_RASR_AP_NONO | \
+                            MPU_RASR_XN | \
+                            MPU_RASR_SIZE_LOG2(CONFIG_ARMV7M_STACKGUARD_L2SIZE))
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -72,6 +85,12 @@ static const uint8_t g_ls_regionmask[9] =
 
 static uint8_t g_region;
 
+#ifdef CONFIG_ARMV7M_STACKGUARD
+/* The current base address of the stack guard */
+
+static uintptr_t g_guard_base;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -223,7 +242,11 @@ static void mpu_reset_internal()
 
 unsigned int mpu_allocregion(void)
 {
+#ifdef CONFIG_ARMV7M_STACKGUARD
+  DEBUGASSERT(g_region < STACKGUARD_REGION);
+#else
   DEBUGASSERT(g_region < CONFIG_ARM_MPU_NREGIONS);
+#endif
   return (unsigned int)g_region++;
 }
 
@@ -415,6 +438,63 @@ void mpu_configure_region(uintptr_t base, size_t size,
   putreg32(regval, MPU_RASR);
 }
 
+/****************************************************************************
+ * Name: mpu_stackguard_initialize
+ *
+ * Description:
+ *   Disable the stack guard region and enable the MPU with the default
+ *   memory map as background region for privileged accesses.  The guard
+ *   uses the highest region, so it takes precedence over the regions
+ *   allocated before or after, like those of the user heap in a protected
+ *   build.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARMV7M_STACKGUARD
+void mpu_stackguard_initialize(void)
+{
+  putreg32(STACKGUARD_REGION, MPU_RNR);
+  putreg32(0, MPU_RASR);
+
+  mpu_control(true, false, true);
+}
+
+/****************************************************************************
+ * Name: mpu_stackguard
+ *
+ * Description:
+ *   Move the stack guard to the lowest aligned block of a new stack, or
+ *   disable it if stackbase is zero.  Called on every context switch; it
+ *   takes only two register writes.
+ *
+ ****************************************************************************/
+
+void mpu_stackguard(uintptr_t stackbase)
+{
+  uintptr_t base = (stackbase + STACKGUARD_SIZE - 1) &
+                   ~(STACKGUARD_SIZE - 1);
+
+  g_guard_base = base;
+
+  putreg32(base | MPU_RBAR_VALID | STACKGUARD_REGION, MPU_RBAR);
+  putreg32(stackbase != 0 ? STACKGUARD_RASR : 0, MPU_RASR);
+}
+
+/****************************************************************************
+ * Name: mpu_stackguard_hit
+ *
+ * Description:
+ *   Return true if an address lies within the stack guard of the running
+ *   thread.
+ *
+ ****************************************************************************/
+
+bool mpu_stackguard_hit(uintptr_t addr)
+{
+  return addr - g_guard_base < STACKGUARD_SIZE;
+}
+#endif
+
 /****************************************************************************
  * Name: mpu_reset
  *
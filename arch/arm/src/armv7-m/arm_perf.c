@@ -38,6 +38,14 @@
 
 static unsigned long g_cpu_freq = ULONG_MAX;
 
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* DWT_CYCCNT at the last exception entry, stored by exception_common */
+
+unsigned long g_irq_timestamp;
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -76,4 +84,9 @@ void up_perf_convert(unsigned long elapsed, struct timespec *ts)
   left        = elapsed - ts->tv_sec * g_cpu_freq;
   ts->tv_nsec = NSEC_PER_SEC * (uint64_t)left / g_cpu_freq;
 }
+
+unsigned long up_irq_timestamp(void)
+{
+  return g_irq_timestamp;
+}
 #endif
@@ -25,13 +25,17 @@
 #include <nuttx/config.h>
 
 #include <inttypes.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 #include <assert.h>
 #include <debug.h>
 #include <syscall.h>
+#include <semaphore.h>
+#include <time.h>
 
 #include <arch/irq.h>
+#include <nuttx/arch.h>
 #include <nuttx/sched.h>
 #include <nuttx/userspace.h>
 
@@ -39,6 +43,16 @@
 #include "exc_return.h"
 #include "arm_internal.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_ARMV7M_RAMFUNC_SWITCH
+#  define svcall_ramfunc __ramfunc__
+#else
+#  define svcall_ramfunc
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -110,6 +124,66 @@ static void dispatch_syscall(void)
 }
 #endif
 
+/****************************************************************************
+ * Name: arm_svcall_fast
+ *
+ * Description:
+ *   Run a system call that never blocks in the SVCall handler, like an
+ *   interrupt handler would, and return straight to the caller.
+ *
+ * Returned Value:
+ *   True if the call was handled; false if it must be dispatched in thread
+ *   mode.  That is the case for the semaphores with priority inheritance or
+ *   protection, whose holder lists and priority changes must not be
+ *   managed from an interrupt context.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARMV7M_SYSCALL_FASTPATH
+static bool arm_svcall_fast(uint32_t *regs, uint32_t cmd)
+{
+#ifdef CONFIG_SYSCALL_STATS
+  unsigned long start;
+#endif
+
+  if (cmd != SYS_clock_gettime)
+    {
+      FAR sem_t *sem = (FAR sem_t *)regs[REG_R1];
+
+      if (sem == NULL || (sem->flags & SEM_PRIO_MASK) != SEM_PRIO_NONE)
+        {
+          return false;
+        }
+    }
+
+#ifdef CONFIG_SYSCALL_STATS
+  start = up_perf_gettime();
+#endif
+
+  switch (cmd)
+    {
+      case SYS_clock_gettime:
+        regs[REG_R0] = clock_gettime((clockid_t)regs[REG_R1],
+                                     (struct timespec *)regs[REG_R2]);
+        break;
+
+      case SYS_sem_post:
+        regs[REG_R0] = sem_post((sem_t *)regs[REG_R1]);
+        break;
+
+      case SYS_sem_trywait:
+        regs[REG_R0] = sem_trywait((sem_t *)regs[REG_R1]);
+        break;
+    }
+
+#ifdef CONFIG_SYSCALL_STATS
+  syscall_account(cmd - CONFIG_SYS_RESERVED, up_perf_gettime() - start);
+#endif
+
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -122,7 +196,7 @@ static void dispatch_syscall(void)
  *
  ****************************************************************************/
 
-int arm_svcall(int irq, void *context, void *arg)
+svcall_ramfunc int arm_svcall(int irq, void *context, void *arg)
 {
   uint32_t *regs = (uint32_t *)context;
   uint32_t cmd;
@@ -234,6 +308,12 @@ int arm_svcall(int irq, void *context, void *arg)
           regs[REG_EXC_RETURN] = rtcb->xcp.syscall[index].excreturn;
           rtcb->xcp.nsyscalls  = index;
 
+#ifdef CONFIG_SYSCALL_STATS
+          syscall_account(rtcb->xcp.syscall[index].nr,
+                          up_perf_gettime() -
+                          rtcb->xcp.syscall[index].start);
+#endif
+
           /* The return value must be in R0-R1.  dispatch_syscall()
            * temporarily moved the value for R0 into R2.
            */
@@ -398,6 +478,24 @@ int arm_svcall(int irq, void *context, void *arg)
           rtcb->xcp.sigreturn  = 0;
         }
         break;
+#endif
+
+      /* These system calls never block and are handled right here,
+       * without the round trip through dispatch_syscall(), unless the
+       * semaphore needs the thread mode path.
+       */
+
+#ifdef CONFIG_ARMV7M_SYSCALL_FASTPATH
+      case SYS_clock_gettime:
+      case SYS_sem_post:
+      case SYS_sem_trywait:
+        if (arm_svcall_fast(regs, cmd))
+          {
+            break;
+          }
+
+        /* Fall through */
+
 #endif
 
       /* This is not an architecture-specific system call.  If NuttX is built
@@ -438,6 +536,11 @@ int arm_svcall(int irq, void *context, void *arg)
 
           regs[REG_R0]        -= CONFIG_SYS_RESERVED;
 
+#ifdef CONFIG_SYSCALL_STATS
+          rtcb->xcp.syscall[index].nr    = regs[REG_R0];
+          rtcb->xcp.syscall[index].start = up_perf_gettime();
+#endif
+
           /* Indicate that we are in a syscall handler. */
 
           rtcb->flags         |= TCB_FLAG_SYSCALL;
@@ -0,0 +1,100 @@
+/****************************************************************************
+ * arch/arm/src/armv7-m/arm_tasklet.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/tasklet.h>
+#include <arch/irq.h>
+
+#include "arm_internal.h"
+#include "nvic.h"
+
+#ifdef CONFIG_SCHED_TASKLET
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arm_pendsv
+ *
+ * Description:
+ *   The PendSV handler.  Being the lowest priority exception, it runs after
+ *   all other pending interrupts have been handled and on the same stack.
+ *   Any context switch caused by a tasklet is performed by arm_doirq() on
+ *   the way out, like for any other interrupt.
+ *
+ ****************************************************************************/
+
+static int arm_pendsv(int irq, void *context, void *arg)
+{
+  tasklet_run();
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arm_tasklet_initialize
+ *
+ * Description:
+ *   Attach the PendSV handler that runs the tasklets and give PendSV the
+ *   lowest priority.  Called from up_irqinitialize() after the exception
+ *   priorities have been set to their defaults.
+ *
+ ****************************************************************************/
+
+void arm_tasklet_initialize(void)
+{
+  uint32_t regval;
+
+  irq_attach(NVIC_IRQ_PENDSV, arm_pendsv, NULL);
+
+  regval  = getreg32(NVIC_SYSH12_15_PRIORITY);
+  regval &= ~NVIC_SYSH_PRIORITY_PR14_MASK;
+  regval |= (NVIC_SYSH_PRIORITY_MIN << NVIC_SYSH_PRIORITY_PR14_SHIFT);
+  putreg32(regval, NVIC_SYSH12_15_PRIORITY);
+}
+
+/****************************************************************************
+ * Name: up_trigger_tasklet
+ *
+ * Description:
+ *   Pend PendSV.  The other bits of ICSR are not read back, writing zero to
+ *   them has no effect.
+ *
+ ****************************************************************************/
+
+void up_trigger_tasklet(void)
+{
+  putreg32(NVIC_INTCTRL_PENDSVSET, NVIC_INTCTRL);
+}
+
+#endif /* CONFIG_SCHED_TASKLET */
@@ -77,7 +77,11 @@
 
 #define EXC_RETURN_HANDLER       0xfffffff1
 
-#ifdef CONFIG_ARCH_FPU
+/* With the lazy FPU context save, new contexts start without the FP frame
+ * and get one only after their first FP instruction.
+ */
+
+#if defined(CONFIG_ARCH_FPU) && !defined(CONFIG_ARMV7M_LAZYFPU)
 #  define EXC_RETURN_FPU         0
 #else
 #  define EXC_RETURN_FPU         EXC_RETURN_STD_CONTEXT
@@ -0,0 +1,49 @@
+/****************************************************************************
+ * arch/arm/src/armv7-m/itm_note.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_SRC_ARMV7_M_ITM_NOTE_H
+#define __ARCH_ARM_SRC_ARMV7_M_ITM_NOTE_H
+
+/****************************************************************************
+ * Public Functions Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: itm_note_initialize
+ *
+ * Description:
+ *   Configure the ITM and TPIU for SWO output and register the ITM sched
+ *   note driver.  Additional, MCU specific logic may be required to:
+ *
+ *   - Enable/configured serial wire output pins
+ *   - Enable debug clocking.
+ *
+ *   Those operations must be performed by MCU-specific logic before this
+ *   function is called.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARMV7M_ITMNOTE
+void itm_note_initialize(void);
+#else
+#  define itm_note_initialize()
+#endif
+
+#endif /* __ARCH_ARM_SRC_ARMV7_M_ITM_NOTE_H */
@@ -249,6 +249,40 @@ void mpu_control(bool enable, bool hfnmiena, bool privdefena);
 void mpu_configure_region(uintptr_t base, size_t size,
                                         uint32_t flags);
 
+/****************************************************************************
+ * Name: mpu_stackguard_initialize
+ *
+ * Description:
+ *   Disable the stack guard, which uses the highest region, and enable the
+ *   MPU
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARMV7M_STACKGUARD
+void mpu_stackguard_initialize(void);
+
+/****************************************************************************
+ * Name: mpu_stackguard
+ *
+ * Description:
+ *   Move the stack guard to the bottom of the stack of the next thread,
+ *   or disable it if stackbase is zero
+ *
+ ****************************************************************************/
+
+void mpu_stackguard(uintptr_t stackbase);
+
+/****************************************************************************
+ * Name: mpu_stackguard_hit
+ *
+ * Description:
+ *   Check if an address lies within the current stack guard
+ *
+ ****************************************************************************/
+
+bool mpu_stackguard_hit(uintptr_t addr);
+#endif
+
 /****************************************************************************
  * Inline Functions
  ****************************************************************************/
@@ -384,6 +384,10 @@ int  arm_busfault(int irq, void *context, void *arg);
 int  arm_usagefault(int irq, void *context, void *arg);
 int  arm_securefault(int irq, void *context, void *arg);
 
+#    ifdef CONFIG_SCHED_TASKLET
+void arm_tasklet_initialize(void);
+#    endif
+
 #  endif /* CONFIG_ARCH_CORTEXM3,4,7 */
 
 /* Exception handling logic unique to the Cortex-A and Cortex-R families
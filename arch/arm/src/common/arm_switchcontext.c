@@ -35,6 +35,16 @@
 #include "clock/clock.h"
 #include "arm_internal.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_ARMV7M_RAMFUNC_SWITCH
+#  define switch_ramfunc __ramfunc__
+#else
+#  define switch_ramfunc
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -53,7 +63,8 @@
  *
  ****************************************************************************/
 
-void up_switch_context(struct tcb_s *tcb, struct tcb_s *rtcb)
+switch_ramfunc void up_switch_context(struct tcb_s *tcb,
+                                     struct tcb_s *rtcb)
 {
   /* Update scheduler parameters */
 
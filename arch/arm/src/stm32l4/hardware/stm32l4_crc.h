@@ -0,0 +1,74 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/hardware/stm32l4_crc.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_SRC_STM32L4_HARDWARE_STM32L4_CRC_H
+#define __ARCH_ARM_SRC_STM32L4_HARDWARE_STM32L4_CRC_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include "chip.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Register Offsets *********************************************************/
+
+#define STM32L4_CRC_DR_OFFSET     0x0000  /* CRC Data Register */
+#define STM32L4_CRC_IDR_OFFSET    0x0004  /* CRC Independent Data Register */
+#define STM32L4_CRC_CR_OFFSET     0x0008  /* CRC Control Register */
+#define STM32L4_CRC_INIT_OFFSET   0x0010  /* CRC Initial Value Register */
+#define STM32L4_CRC_POL_OFFSET    0x0014  /* CRC Polynomial Register */
+
+/* Register Addresses *******************************************************/
+
+#define STM32L4_CRC_DR            (STM32L4_CRC_BASE+STM32L4_CRC_DR_OFFSET)
+#define STM32L4_CRC_IDR           (STM32L4_CRC_BASE+STM32L4_CRC_IDR_OFFSET)
+#define STM32L4_CRC_CR            (STM32L4_CRC_BASE+STM32L4_CRC_CR_OFFSET)
+#define STM32L4_CRC_INIT          (STM32L4_CRC_BASE+STM32L4_CRC_INIT_OFFSET)
+#define STM32L4_CRC_POL           (STM32L4_CRC_BASE+STM32L4_CRC_POL_OFFSET)
+
+/* Register Bitfield Definitions ********************************************/
+
+/* CRC Independent Data Register */
+
+#define CRC_IDR_MASK              0xff      /* General purpose byte, not affected by RESET */
+
+/* CRC Control Register */
+
+#define CRC_CR_RESET              (1 << 0)  /* Bit 0: Load DR with INIT */
+#define CRC_CR_POLYSIZE_SHIFT     (3)       /* Bits 3-4: Polynomial size */
+#define CRC_CR_POLYSIZE_MASK      (3 << CRC_CR_POLYSIZE_SHIFT)
+#  define CRC_CR_POLYSIZE_32      (0 << CRC_CR_POLYSIZE_SHIFT)
+#  define CRC_CR_POLYSIZE_16      (1 << CRC_CR_POLYSIZE_SHIFT)
+#  define CRC_CR_POLYSIZE_8       (2 << CRC_CR_POLYSIZE_SHIFT)
+#  define CRC_CR_POLYSIZE_7       (3 << CRC_CR_POLYSIZE_SHIFT)
+#define CRC_CR_REVIN_SHIFT        (5)       /* Bits 5-6: Reverse input data */
+#define CRC_CR_REVIN_MASK         (3 << CRC_CR_REVIN_SHIFT)
+#  define CRC_CR_REVIN_NONE       (0 << CRC_CR_REVIN_SHIFT)
+#  define CRC_CR_REVIN_BYTE       (1 << CRC_CR_REVIN_SHIFT)
+#  define CRC_CR_REVIN_HWORD      (2 << CRC_CR_REVIN_SHIFT)
+#  define CRC_CR_REVIN_WORD       (3 << CRC_CR_REVIN_SHIFT)
+#define CRC_CR_REVOUT             (1 << 7)  /* Bit 7: Reverse output data */
+
+#endif /* __ARCH_ARM_SRC_STM32L4_HARDWARE_STM32L4_CRC_H */
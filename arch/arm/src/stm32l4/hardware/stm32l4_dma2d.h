@@ -0,0 +1,211 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/hardware/stm32l4_dma2d.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_SRC_STM32L4_HARDWARE_STM32L4_DMA2D_H
+#define __ARCH_ARM_SRC_STM32L4_HARDWARE_STM32L4_DMA2D_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include "hardware/stm32l4_memorymap.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define STM32L4_DMA2D_NCLUT          256    /* Number of entries in the CLUT */
+
+/* DMA2D Register Offsets ***************************************************/
+
+#define STM32L4_DMA2D_CR_OFFSET      0x0000 /* Control Register */
+#define STM32L4_DMA2D_ISR_OFFSET     0x0004 /* Interrupt Status Register */
+#define STM32L4_DMA2D_IFCR_OFFSET    0x0008 /* Interrupt Flag Clear Register */
+#define STM32L4_DMA2D_FGMAR_OFFSET   0x000c /* Foreground Memory Address Register */
+#define STM32L4_DMA2D_FGOR_OFFSET    0x0010 /* Foreground Offset Register */
+#define STM32L4_DMA2D_BGMAR_OFFSET   0x0014 /* Background Memory Address Register */
+#define STM32L4_DMA2D_BGOR_OFFSET    0x0018 /* Background Offset Register */
+#define STM32L4_DMA2D_FGPFCCR_OFFSET 0x001c /* Foreground PFC Control Register */
+#define STM32L4_DMA2D_FGCOLR_OFFSET  0x0020 /* Foreground Color Register */
+#define STM32L4_DMA2D_BGPFCCR_OFFSET 0x0024 /* Background PFC Control Register */
+#define STM32L4_DMA2D_BGCOLR_OFFSET  0x0028 /* Background Color Register */
+#define STM32L4_DMA2D_FGCMAR_OFFSET  0x002c /* Foreground CLUT Memory Address Register */
+#define STM32L4_DMA2D_BGCMAR_OFFSET  0x0030 /* Background CLUT Memory Address Register */
+#define STM32L4_DMA2D_OPFCCR_OFFSET  0x0034 /* Output PFC Control Register */
+#define STM32L4_DMA2D_OCOLR_OFFSET   0x0038 /* Output Color Register */
+#define STM32L4_DMA2D_OMAR_OFFSET    0x003c /* Output Memory Address Register */
+#define STM32L4_DMA2D_OOR_OFFSET     0x0040 /* Output Offset Register */
+#define STM32L4_DMA2D_NLR_OFFSET     0x0044 /* Number Of Line Register */
+#define STM32L4_DMA2D_LWR_OFFSET     0x0048 /* Line Watermark Register */
+#define STM32L4_DMA2D_AMTCR_OFFSET   0x004c /* AHB Master Timer Configuration Register */
+
+/* DMA2D Register Addresses *************************************************/
+
+#define STM32L4_DMA2D_CR             (STM32L4_DMA2D_BASE+STM32L4_DMA2D_CR_OFFSET)
+#define STM32L4_DMA2D_ISR            (STM32L4_DMA2D_BASE+STM32L4_DMA2D_ISR_OFFSET)
+#define STM32L4_DMA2D_IFCR           (STM32L4_DMA2D_BASE+STM32L4_DMA2D_IFCR_OFFSET)
+#define STM32L4_DMA2D_FGMAR          (STM32L4_DMA2D_BASE+STM32L4_DMA2D_FGMAR_OFFSET)
+#define STM32L4_DMA2D_FGOR           (STM32L4_DMA2D_BASE+STM32L4_DMA2D_FGOR_OFFSET)
+#define STM32L4_DMA2D_BGMAR          (STM32L4_DMA2D_BASE+STM32L4_DMA2D_BGMAR_OFFSET)
+#define STM32L4_DMA2D_BGOR           (STM32L4_DMA2D_BASE+STM32L4_DMA2D_BGOR_OFFSET)
+#define STM32L4_DMA2D_FGPFCCR        (STM32L4_DMA2D_BASE+STM32L4_DMA2D_FGPFCCR_OFFSET)
+#define STM32L4_DMA2D_FGCOLR         (STM32L4_DMA2D_BASE+STM32L4_DMA2D_FGCOLR_OFFSET)
+#define STM32L4_DMA2D_BGPFCCR        (STM32L4_DMA2D_BASE+STM32L4_DMA2D_BGPFCCR_OFFSET)
+#define STM32L4_DMA2D_BGCOLR         (STM32L4_DMA2D_BASE+STM32L4_DMA2D_BGCOLR_OFFSET)
+#define STM32L4_DMA2D_FGCMAR         (STM32L4_DMA2D_BASE+STM32L4_DMA2D_FGCMAR_OFFSET)
+#define STM32L4_DMA2D_BGCMAR         (STM32L4_DMA2D_BASE+STM32L4_DMA2D_BGCMAR_OFFSET)
+#define STM32L4_DMA2D_OPFCCR         (STM32L4_DMA2D_BASE+STM32L4_DMA2D_OPFCCR_OFFSET)
+#define STM32L4_DMA2D_OCOLR          (STM32L4_DMA2D_BASE+STM32L4_DMA2D_OCOLR_OFFSET)
+#define STM32L4_DMA2D_OMAR           (STM32L4_DMA2D_BASE+STM32L4_DMA2D_OMAR_OFFSET)
+#define STM32L4_DMA2D_OOR            (STM32L4_DMA2D_BASE+STM32L4_DMA2D_OOR_OFFSET)
+#define STM32L4_DMA2D_NLR            (STM32L4_DMA2D_BASE+STM32L4_DMA2D_NLR_OFFSET)
+#define STM32L4_DMA2D_LWR            (STM32L4_DMA2D_BASE+STM32L4_DMA2D_LWR_OFFSET)
+#define STM32L4_DMA2D_AMTCR          (STM32L4_DMA2D_BASE+STM32L4_DMA2D_AMTCR_OFFSET)
+
+/* DMA2D Register Bit Definitions *******************************************/
+
+/* Control Register */
+
+#define DMA2D_CR_START               (1 << 0)  /* Bit 0:  Start */
+#define DMA2D_CR_SUSP                (1 << 1)  /* Bit 1:  Suspend */
+#define DMA2D_CR_ABORT               (1 << 2)  /* Bit 2:  Abort */
+#define DMA2D_CR_LOM                 (1 << 6)  /* Bit 6:  Line offset mode (bytes) */
+#define DMA2D_CR_TEIE                (1 << 8)  /* Bit 8:  Transfer error interrupt enable */
+#define DMA2D_CR_TCIE                (1 << 9)  /* Bit 9:  Transfer complete interrupt enable */
+#define DMA2D_CR_TWIE                (1 << 10) /* Bit 10: Transfer watermark interrupt enable */
+#define DMA2D_CR_CAEIE               (1 << 11) /* Bit 11: CLUT access error interrupt enable */
+#define DMA2D_CR_CTCIE               (1 << 12) /* Bit 12: CLUT transfer complete interrupt enable */
+#define DMA2D_CR_CEIE                (1 << 13) /* Bit 13: Configuration error interrupt enable */
+#define DMA2D_CR_MODE_SHIFT          (16)      /* Bits 16-18: DMA2D mode */
+#define DMA2D_CR_MODE_MASK           (7 << DMA2D_CR_MODE_SHIFT)
+#  define DMA2D_CR_MODE_M2M          (0 << DMA2D_CR_MODE_SHIFT) /* Memory-to-memory */
+#  define DMA2D_CR_MODE_M2MPFC       (1 << DMA2D_CR_MODE_SHIFT) /* Memory-to-memory with PFC */
+#  define DMA2D_CR_MODE_M2MBLEND     (2 << DMA2D_CR_MODE_SHIFT) /* Memory-to-memory with blending */
+#  define DMA2D_CR_MODE_R2M          (3 << DMA2D_CR_MODE_SHIFT) /* Register-to-memory */
+#  define DMA2D_CR_MODE_M2MBLENDFG   (4 << DMA2D_CR_MODE_SHIFT) /* Blending, fixed FG color */
+#  define DMA2D_CR_MODE_M2MBLENDBG   (5 << DMA2D_CR_MODE_SHIFT) /* Blending, fixed BG color */
+
+#define DMA2D_CR_ALLINTS             (DMA2D_CR_TEIE | DMA2D_CR_TCIE | \
+                                      DMA2D_CR_TWIE | DMA2D_CR_CAEIE | \
+                                      DMA2D_CR_CTCIE | DMA2D_CR_CEIE)
+
+/* Interrupt Status Register */
+
+#define DMA2D_ISR_TEIF               (1 << 0)  /* Bit 0: Transfer error interrupt flag */
+#define DMA2D_ISR_TCIF               (1 << 1)  /* Bit 1: Transfer complete interrupt flag */
+#define DMA2D_ISR_TWIF               (1 << 2)  /* Bit 2: Transfer watermark interrupt flag */
+#define DMA2D_ISR_CAEIF              (1 << 3)  /* Bit 3: CLUT access error interrupt flag */
+#define DMA2D_ISR_CTCIF              (1 << 4)  /* Bit 4: CLUT transfer complete interrupt flag */
+#define DMA2D_ISR_CEIF               (1 << 5)  /* Bit 5: Configuration error interrupt flag */
+
+/* Interrupt Flag Clear Register */
+
+#define DMA2D_IFCR_CTEIF             (1 << 0)  /* Bit 0: Clear transfer error flag */
+#define DMA2D_IFCR_CTCIF             (1 << 1)  /* Bit 1: Clear transfer complete flag */
+#define DMA2D_IFCR_CTWIF             (1 << 2)  /* Bit 2: Clear transfer watermark flag */
+#define DMA2D_IFCR_CAECIF            (1 << 3)  /* Bit 3: Clear CLUT access error flag */
+#define DMA2D_IFCR_CCTCIF            (1 << 4)  /* Bit 4: Clear CLUT transfer complete flag */
+#define DMA2D_IFCR_CCEIF             (1 << 5)  /* Bit 5: Clear configuration error flag */
+#define DMA2D_IFCR_ALL               (0x3f)
+
+/* Foreground/Background/Output Offset Registers */
+
+#define DMA2D_XGOR_SHIFT             (0)       /* Bits 0-15: Line offset */
+#define DMA2D_XGOR_MASK              (0xffff << DMA2D_XGOR_SHIFT)
+#define DMA2D_XGOR(n)                ((uint32_t)(n) << DMA2D_XGOR_SHIFT)
+
+#define DMA2D_OOR_LO_SHIFT           (0)       /* Bits 0-15: Line offset */
+#define DMA2D_OOR_LO_MASK            (0xffff << DMA2D_OOR_LO_SHIFT)
+#define DMA2D_OOR_LO(n)              ((uint32_t)(n) << DMA2D_OOR_LO_SHIFT)
+
+/* Foreground/Background PFC Control Registers */
+
+#define DMA2D_XGPFCCR_CM_SHIFT       (0)       /* Bits 0-3: Color mode */
+#define DMA2D_XGPFCCR_CM_MASK        (0xf << DMA2D_XGPFCCR_CM_SHIFT)
+#define DMA2D_XGPFCCR_CM(n)          ((uint32_t)(n) << DMA2D_XGPFCCR_CM_SHIFT)
+#define DMA2D_XGPFCCR_CCM            (1 << 4)  /* Bit 4: CLUT color mode */
+#define DMA2D_XGPFCCR_START          (1 << 5)  /* Bit 5: Start CLUT loading */
+#define DMA2D_XGPFCCR_CS_SHIFT       (8)       /* Bits 8-15: CLUT size */
+#define DMA2D_XGPFCCR_CS_MASK        (0xff << DMA2D_XGPFCCR_CS_SHIFT)
+#define DMA2D_XGPFCCR_CS(n)          ((uint32_t)(n) << DMA2D_XGPFCCR_CS_SHIFT)
+#define DMA2D_XGPFCCR_AM_SHIFT       (16)      /* Bits 16-17: Alpha mode */
+#define DMA2D_XGPFCCR_AM_MASK        (3 << DMA2D_XGPFCCR_AM_SHIFT)
+#define DMA2D_XGPFCCR_AM(n)          ((uint32_t)(n) << DMA2D_XGPFCCR_AM_SHIFT)
+#define DMA2D_XGPFCCR_AI             (1 << 20) /* Bit 20: Alpha inverted */
+#define DMA2D_XGPFCCR_RBS            (1 << 21) /* Bit 21: Red/blue swap */
+#define DMA2D_XGPFCCR_ALPHA_SHIFT    (24)      /* Bits 24-31: Alpha value */
+#define DMA2D_XGPFCCR_ALPHA_MASK     (0xff << DMA2D_XGPFCCR_ALPHA_SHIFT)
+#define DMA2D_XGPFCCR_ALPHA(n)       ((uint32_t)(n) << DMA2D_XGPFCCR_ALPHA_SHIFT)
+
+/* PFC alpha modes */
+
+#define STM32L4_DMA2D_PFCCR_AM_NONE  0     /* Keep the pixel alpha */
+#define STM32L4_DMA2D_PFCCR_AM_CONST 1     /* Replace with ALPHA */
+#define STM32L4_DMA2D_PFCCR_AM_PIXEL 2     /* Pixel alpha multiplied by ALPHA */
+
+/* Output PFC Control Register */
+
+#define DMA2D_OPFCCR_CM_SHIFT        (0)       /* Bits 0-2: Color mode */
+#define DMA2D_OPFCCR_CM_MASK         (7 << DMA2D_OPFCCR_CM_SHIFT)
+#define DMA2D_OPFCCR_CM(n)           ((uint32_t)(n) << DMA2D_OPFCCR_CM_SHIFT)
+#define DMA2D_OPFCCR_SB              (1 << 8)  /* Bit 8:  Swap bytes */
+#define DMA2D_OPFCCR_AI              (1 << 20) /* Bit 20: Alpha inverted */
+#define DMA2D_OPFCCR_RBS             (1 << 21) /* Bit 21: Red/blue swap */
+
+/* PFC pixel formats.  Only ARGB8888 through ARGB4444 are valid output
+ * formats.
+ */
+
+#define DMA2D_PF_ARGB8888            0
+#define DMA2D_PF_RGB888              1
+#define DMA2D_PF_RGB565              2
+#define DMA2D_PF_ARGB1555            3
+#define DMA2D_PF_ARGB4444            4
+#define DMA2D_PF_L8                  5
+#define DMA2D_PF_AL44                6
+#define DMA2D_PF_AL88                7
+#define DMA2D_PF_L4                  8
+#define DMA2D_PF_A8                  9
+#define DMA2D_PF_A4                  10
+
+/* Number Of Line Register */
+
+#define DMA2D_NLR_NL_SHIFT           (0)       /* Bits 0-15: Number of lines */
+#define DMA2D_NLR_NL_MASK            (0xffff << DMA2D_NLR_NL_SHIFT)
+#define DMA2D_NLR_NL(n)              ((uint32_t)(n) << DMA2D_NLR_NL_SHIFT)
+#define DMA2D_NLR_PL_SHIFT           (16)      /* Bits 16-29: Pixels per line */
+#define DMA2D_NLR_PL_MASK            (0x3fff << DMA2D_NLR_PL_SHIFT)
+#define DMA2D_NLR_PL(n)              ((uint32_t)(n) << DMA2D_NLR_PL_SHIFT)
+
+/* Line Watermark Register */
+
+#define DMA2D_LWR_LW_SHIFT           (0)       /* Bits 0-15: Line watermark */
+#define DMA2D_LWR_LW_MASK            (0xffff << DMA2D_LWR_LW_SHIFT)
+#define DMA2D_LWR_LW(n)              ((uint32_t)(n) << DMA2D_LWR_LW_SHIFT)
+
+/* AHB Master Timer Configuration Register */
+
+#define DMA2D_AMTCR_EN               (1 << 0)  /* Bit 0: Dead time enable */
+#define DMA2D_AMTCR_DT_SHIFT         (8)       /* Bits 8-15: Dead time */
+#define DMA2D_AMTCR_DT_MASK          (0xff << DMA2D_AMTCR_DT_SHIFT)
+#define DMA2D_AMTCR_DT(n)            ((uint32_t)(n) << DMA2D_AMTCR_DT_SHIFT)
+
+#endif /* __ARCH_ARM_SRC_STM32L4_HARDWARE_STM32L4_DMA2D_H */
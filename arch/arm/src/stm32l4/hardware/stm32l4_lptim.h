@@ -132,4 +132,20 @@
 #define LPTIM_ISR_UP              (1 << 5)   /* Bit 5: Counter direction change down to up */
 #define LPTIM_ISR_DOWN            (1 << 6)   /* Bit 6: Counter direction change up to down */
 
+#define LPTIM_ICR_CMPMCF          (1 << 0)   /* Bit 0: Compare match clear flag */
+#define LPTIM_ICR_ARRMCF          (1 << 1)   /* Bit 1: Autoreload match clear flag */
+#define LPTIM_ICR_EXTTRIGCF       (1 << 2)   /* Bit 2: External trigger clear flag */
+#define LPTIM_ICR_CMPOKCF         (1 << 3)   /* Bit 3: Compare register update OK clear flag */
+#define LPTIM_ICR_ARROKCF         (1 << 4)   /* Bit 4: Autoreload register update OK clear flag */
+#define LPTIM_ICR_UPCF            (1 << 5)   /* Bit 5: Direction change to up clear flag */
+#define LPTIM_ICR_DOWNCF          (1 << 6)   /* Bit 6: Direction change to down clear flag */
+
+#define LPTIM_IER_CMPMIE          (1 << 0)   /* Bit 0: Compare match interrupt enable */
+#define LPTIM_IER_ARRMIE          (1 << 1)   /* Bit 1: Autoreload match interrupt enable */
+#define LPTIM_IER_EXTTRIGIE       (1 << 2)   /* Bit 2: External trigger interrupt enable */
+#define LPTIM_IER_CMPOKIE         (1 << 3)   /* Bit 3: Compare register update OK interrupt enable */
+#define LPTIM_IER_ARROKIE         (1 << 4)   /* Bit 4: Autoreload register update OK interrupt enable */
+#define LPTIM_IER_UPIE            (1 << 5)   /* Bit 5: Direction change to up interrupt enable */
+#define LPTIM_IER_DOWNIE          (1 << 6)   /* Bit 6: Direction change to down interrupt enable */
+
 #endif /* __ARCH_ARM_SRC_STM32L4_HARDWARE_STM32L4_LPTIM_H */
@@ -36,6 +36,8 @@
 #define STM32L4_FSMC_BASE34    0x80000000     /* 0x80000000-0x8fffffff: 512Mb FSMC bank3 / QSPI  block */
 #  define STM32L4_FSMC_BANK3   0x80000000     /* 0x80000000-0x8fffffff:   256Mb NAND FLASH */
 #  define STM32L4_QSPI_BANK    0x90000000     /* 0x90000000-0x9fffffff:   256Mb QUADSPI */
+#  define STM32L4_OCTOSPI1_BANK 0x90000000    /* 0x90000000-0x9fffffff:   256Mb OCTOSPI1 (L4+) */
+#  define STM32L4_OCTOSPI2_BANK 0x70000000    /* 0x70000000-0x7fffffff:   256Mb OCTOSPI2 (L4+) */
 #define STM32L4_FSMC_BASE      0xa0000000     /* 0xa0000000-0xbfffffff:       FSMC register block */
 #define STM32L4_QSPI_BASE      0xa0001000     /* 0xa0001000-0xbfffffff:       QSPI register block */
 #define STM32L4_OCTOSPI1_BASE  0xa0001000     /* 0xa0001000-0xa00013ff: OCTOSPI1 register block */
@@ -50,7 +50,7 @@
 
 /* Register Addresses *******************************************************/
 
-#define STM32L4_SAI1_GCR           (STM32L4_SAI_GCR_OFFSET)
+#define STM32L4_SAI1_GCR           (STM32L4_SAI1_BASE+STM32L4_SAI_GCR_OFFSET)
 
 #define STM32L4_SAI1_A_BASE        (STM32L4_SAI1_BASE+STM32L4_SAI_A_OFFSET)
 #define STM32L4_SAI1_B_BASE        (STM32L4_SAI1_BASE+STM32L4_SAI_B_OFFSET)
@@ -106,7 +106,7 @@
                                              /* Bits 2-3: Reserved */
 #define SAI_GCR_SYNCOUT_SHIFT      (4)       /* Bits 4-5: Synchronization outputs */
 #define SAI_GCR_SYNCOUT_MASK       (3 << SAI_GCR_SYNCOUT_SHIFT)
-#  define SAI_GCR_SYNCOUT          ((uint32_t)(n) << SAI_GCR_SYNCOUT_SHIFT)
+#  define SAI_GCR_SYNCOUT(n)       ((uint32_t)(n) << SAI_GCR_SYNCOUT_SHIFT)
                                              /* Bits 6-31: Reserved */
 
 /* SAI Configuration Register 1 */
@@ -209,7 +209,7 @@
 /* SAI Slot Register */
 
 #define SAI_SLOTR_FBOFF_SHIFT      (0)       /* Bits 0-4: First bit offset */
-#define SAI_SLOTR_FBOFF_MASK       (32 << SAI_SLOTR_FBOFF_SHIFT)
+#define SAI_SLOTR_FBOFF_MASK       (0x1f << SAI_SLOTR_FBOFF_SHIFT)
 #  define SAI_SLOTR_FBOFF(n)       ((uint32_t)(n) << SAI_SLOTR_FBOFF_SHIFT)
                                              /* Bit 5: Reserved */
 #define SAI_SLOTR_SLOTSZ_SHIFT     (6)       /* Bits 6-7: Slot size */
@@ -218,7 +218,7 @@
 #  define SAI_SLOTR_SLOTSZ_16BIT   (1 << SAI_SLOTR_SLOTSZ_SHIFT) /* 16-bit */
 #  define SAI_SLOTR_SLOTSZ_32BIT   (2 << SAI_SLOTR_SLOTSZ_SHIFT) /* 32-bit */
 
-#define SAI_SLOTR_NBSLOT_SHIFT     (0)       /* Bits 0-3: Number of slots in an audio frame */
+#define SAI_SLOTR_NBSLOT_SHIFT     (8)       /* Bits 8-11: Number of slots in an audio frame */
 #define SAI_SLOTR_NBSLOT_MASK      (15 << SAI_SLOTR_NBSLOT_SHIFT)
 #  define SAI_SLOTR_NBSLOT(n)      ((uint32_t)((n) - 1) << SAI_SLOTR_NBSLOT_SHIFT)
                                              /* Bits 12-15: Reserved */
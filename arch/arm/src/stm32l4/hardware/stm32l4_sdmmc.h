@@ -47,6 +47,13 @@
 #define STM32_SDMMC_FIFOCNT_OFFSET            0x0048 /* SDMMC FIFO counter register */
 #define STM32_SDMMC_FIFO_OFFSET               0x0080 /* SDMMC data FIFO register */
 
+#ifdef CONFIG_STM32L4_STM32L4XR
+#  define STM32_SDMMC_IDMACTRL_OFFSET         0x0050 /* SDMMC DMA control register */
+#  define STM32_SDMMC_IDMABSIZE_OFFSET        0x0054 /* SDMMC IDMA buffer size register */
+#  define STM32_SDMMC_IDMABASE0_OFFSET        0x0058 /* SDMMC IDMA buffer 0 base address register */
+#  define STM32_SDMMC_IDMABASE1_OFFSET        0x005c /* SDMMC IDMA buffer 1 base address register */
+#endif
+
 /* Register Bitfield Definitions ********************************************/
 
 #define STM32_SDMMC_POWER_PWRCTRL_SHIFT       (0)       /* Bits 0-1: Power supply control bits */
@@ -153,6 +160,12 @@
 #define STM32_SDMMC_STA_TXDAVL                (1 << 20) /* Bit 20: Data available in transmit FIFO */
 #define STM32_SDMMC_STA_RXDAVL                (1 << 21) /* Bit 21: Data available in receive FIFO */
 #define STM32_SDMMC_STA_SDIOIT                (1 << 22) /* Bit 22: SDIO interrupt received */
+#ifdef CONFIG_STM32L4_STM32L4XR
+#  define STM32_SDMMC_STA_BUSYD0              (1 << 20) /* Bit 20: Card signals busy on SDMMC_D0 */
+#  define STM32_SDMMC_STA_BUSYD0END           (1 << 21) /* Bit 21: End of SDMMC_D0 busy after a command response */
+#  define STM32_SDMMC_STA_IDMATE              (1 << 27) /* Bit 27: IDMA transfer error */
+#  define STM32_SDMMC_STA_IDMABTC             (1 << 28) /* Bit 28: IDMA buffer transfer complete */
+#endif
 
 #define STM32_SDMMC_ICR_CCRCFAILC             (1 << 0)  /* Bit 0: CCRCFAIL flag clear bit */
 #define STM32_SDMMC_ICR_DCRCFAILC             (1 << 1)  /* Bit 1: DCRCFAIL flag clear bit */
@@ -165,6 +178,11 @@
 #define STM32_SDMMC_ICR_DATAENDC              (1 << 8)  /* Bit 8: DATAEND flag clear bit */
 #define STM32_SDMMC_ICR_DBCKENDC              (1 << 10) /* Bit 10: DBCKEND flag clear bit */
 #define STM32_SDMMC_ICR_SDIOITC               (1 << 22) /* Bit 22: SDIOIT flag clear bit */
+#ifdef CONFIG_STM32L4_STM32L4XR
+#  define STM32_SDMMC_ICR_BUSYD0ENDC          (1 << 21) /* Bit 21: BUSYD0END flag clear bit */
+#  define STM32_SDMMC_ICR_IDMATEC             (1 << 27) /* Bit 27: IDMATE flag clear bit */
+#  define STM32_SDMMC_ICR_IDMABTCC            (1 << 28) /* Bit 28: IDMABTC flag clear bit */
+#endif
 
 #define STM32_SDMMC_ICR_RESET                 0x00c007ff
 #define STM32_SDMMC_ICR_STATICFLAGS           0x000005ff
@@ -193,10 +211,24 @@
 #define STM32_SDMMC_MASK_RXDAVLIE             (1 << 21) /* Bit 21: Data available in Rx FIFO interrupt enable */
 #define STM32_SDMMC_MASK_SDIOITIE             (1 << 22) /* Bit 22: SDIO mode interrupt received interrupt enable */
 #define STM32_SDMMC_MASK_CEATAENDIE           (1 << 23) /* Bit 23: CE-ATA command completion interrupt enable */
+#ifdef CONFIG_STM32L4_STM32L4XR
+#  define STM32_SDMMC_MASK_BUSYD0ENDIE        (1 << 21) /* Bit 21: BUSYD0END interrupt enable */
+#  define STM32_SDMMC_MASK_IDMABTCIE          (1 << 28) /* Bit 28: IDMA buffer transfer complete interrupt enable */
+#endif
 
 #define STM32_SDMMC_MASK_RESET                (0)
 
 #define STM32_SDMMC_FIFOCNT_SHIFT             (0)
 #define STM32_SDMMC_FIFOCNT_MASK              (0x0ffffff << STM32_SDMMC_FIFOCNT_SHIFT)
 
+#ifdef CONFIG_STM32L4_STM32L4XR
+#  define STM32_SDMMC_IDMACTRL_IDMAEN         (1 << 0)  /* Bit 0: IDMA enable */
+#  define STM32_SDMMC_IDMACTRL_IDMABMODE      (1 << 1)  /* Bit 1: Buffer mode (0: single, 1: double) */
+#  define STM32_SDMMC_IDMACTRL_IDMABACT       (1 << 2)  /* Bit 2: Double buffer mode active buffer (0: BASE0, 1: BASE1) */
+
+#  define STM32_SDMMC_IDMABSIZE_IDMABNDT_SHIFT (5)      /* Bits 12-5: Number of 32 byte data transfers per buffer */
+#  define STM32_SDMMC_IDMABSIZE_IDMABNDT_MASK (0xff << STM32_SDMMC_IDMABSIZE_IDMABNDT_SHIFT)
+#  define STM32_SDMMC_IDMABSIZE_MAX           (0xff << STM32_SDMMC_IDMABSIZE_IDMABNDT_SHIFT)
+#endif
+
 #endif /* __ARCH_ARM_SRC_STM32L4_HARDWARE_STM32L46XX_SDMMC_H */
@@ -100,17 +100,20 @@
 
 /* DMAMUX1 request line multiplexer channel x configuration register */
 
-#define DMAMUX_CCR_DMAREQID_SHIFT (0)  /* Bits 0-6: DMA request identification */
+#define DMAMUX_CCR_DMAREQID_SHIFT (0)       /* Bits 0-6: DMA request identification */
 #define DMAMUX_CCR_DMAREQID_MASK  (0x7f << DMAMUX_CCR_DMAREQID_SHIFT)
-#define DMAMUX_CCR_SOIE           (8)  /* Bit 8: Synchronization overrun interrupt enable */
-#define DMAMUX_CCR_EGE            (9)  /* Bit 9: Event generation enable */
-#define DMAMUX_CCR_SE             (16) /* Bit 16: Synchronization enable */
-#define DMAMUX_CCR_SPOL_SHIFT     (17) /* Bits 17-18: Synchronization polarity */
+#define DMAMUX_CCR_SOIE           (1 << 8)  /* Bit 8: Synchronization overrun interrupt enable */
+#define DMAMUX_CCR_EGE            (1 << 9)  /* Bit 9: Event generation enable */
+#define DMAMUX_CCR_SE             (1 << 16) /* Bit 16: Synchronization enable */
+#define DMAMUX_CCR_SPOL_SHIFT     (17)      /* Bits 17-18: Synchronization polarity */
 #define DMAMUX_CCR_SPOL_MASK      (0x3 << DMAMUX_CCR_SPOL_SHIFT)
-#define DMAMUX_CCR_NBREQ_SHIFT    (19) /* Bits 19-23: Number of DMA request - 1 to forward */
+#  define DMAMUX_CCR_SPOL(n)      ((uint32_t)(n) << DMAMUX_CCR_SPOL_SHIFT)
+#define DMAMUX_CCR_NBREQ_SHIFT    (19)      /* Bits 19-23: Number of DMA request - 1 to forward */
 #define DMAMUX_CCR_NBREQ_MASK     (0x1f << DMAMUX_CCR_NBREQ_SHIFT)
-#define DMAMUX_CCR_SYNCID_SHIFT   (24) /* Bits 24-28: Synchronization identification */
+#  define DMAMUX_CCR_NBREQ(n)     ((uint32_t)((n) - 1) << DMAMUX_CCR_NBREQ_SHIFT)
+#define DMAMUX_CCR_SYNCID_SHIFT   (24)      /* Bits 24-28: Synchronization identification */
 #define DMAMUX_CCR_SYNCID_MASK    (0x1f << DMAMUX_CCR_SYNCID_SHIFT)
+#  define DMAMUX_CCR_SYNCID(n)    ((uint32_t)(n) << DMAMUX_CCR_SYNCID_SHIFT)
 
 /* DMAMUX1 request line multiplexer interrupt channel status register */
 
@@ -122,14 +125,24 @@
 
 /* DMAMUX1 request generator channel x configuration register */
 
-#define DMAMUX_RGCR_SIGID_SHIFT   (0)  /* Bits 0-4: Signal identifiaction */
+#define DMAMUX_RGCR_SIGID_SHIFT   (0)       /* Bits 0-4: Signal identifiaction */
 #define DMAMUX_RGCR_SIGID_MASK    (0x1f << DMAMUX_RGCR_SIGID_SHIFT)
-#define DMAMUX_RGCR_OIE           (8)  /* Bit 8: Trigger overrun interrupt enable */
-#define DMAMUX_RGCR_GE            (16) /* Bit 16: DMA request generator channel X enable*/
-#define DMAMUX_RGCR_GPOL_SHIFT    (17) /* Bits 17-18: DMA request generator trigger polarity */
+#  define DMAMUX_RGCR_SIGID(n)    ((uint32_t)(n) << DMAMUX_RGCR_SIGID_SHIFT)
+#define DMAMUX_RGCR_OIE           (1 << 8)  /* Bit 8: Trigger overrun interrupt enable */
+#define DMAMUX_RGCR_GE            (1 << 16) /* Bit 16: DMA request generator channel X enable*/
+#define DMAMUX_RGCR_GPOL_SHIFT    (17)      /* Bits 17-18: DMA request generator trigger polarity */
 #define DMAMUX_RGCR_GPOL_MASK     (0x3 << DMAMUX_RGCR_GPOL_SHIFT)
-#define DMAMUX_RGCR_GNBREQ_SHIFT  (19) /* Bits 19-23: Number of DMA requests to be generated -1 */
+#  define DMAMUX_RGCR_GPOL(n)     ((uint32_t)(n) << DMAMUX_RGCR_GPOL_SHIFT)
+#define DMAMUX_RGCR_GNBREQ_SHIFT  (19)      /* Bits 19-23: Number of DMA requests to be generated -1 */
 #define DMAMUX_RGCR_GNBREQ_MASK   (0x1f << DMAMUX_RGCR_GNBREQ_SHIFT)
+#  define DMAMUX_RGCR_GNBREQ(n)   ((uint32_t)((n) - 1) << DMAMUX_RGCR_GNBREQ_SHIFT)
+
+/* Synchronization / trigger polarity (SPOL and GPOL fields) */
+
+#define DMAMUX_POL_NONE           (0)  /* No event: input disabled */
+#define DMAMUX_POL_RISING         (1)  /* Rising edge */
+#define DMAMUX_POL_FALLING        (2)  /* Falling edge */
+#define DMAMUX_POL_BOTH           (3)  /* Rising and falling edges */
 
 /* DMAMUX1 request generator interrupt status register */
 
@@ -139,6 +152,22 @@
 
 #define DMAMUX_RGCFR_COF(x)       (1 << (x)) /* Clear trigger overrun event flag */
 
+/* DMAMUX1 synchronization inputs (SYNCID) and request generator trigger
+ * inputs (SIGID).  Both use the same assignment on the STM32L4+.
+ */
+
+#define DMAMUX1_NREQGEN           (4)        /* Number of request generators */
+#define DMAMUX1_NBREQ_MAX         (32)       /* Maximum requests per event */
+
+#define DMAMUX1_SIG_EXTI(n)       (n)        /* 0-15: EXTI lines 0-15 */
+#define DMAMUX1_SIG_EVT(n)        (16 + (n)) /* 16-19: DMAMUX1 channel 0-3 events */
+#define DMAMUX1_SIG_LPTIM1_OUT    (20)
+#define DMAMUX1_SIG_LPTIM2_OUT    (21)
+#define DMAMUX1_SIG_DSI_TE        (22)
+#define DMAMUX1_SIG_DSI_REFRESH   (23)
+#define DMAMUX1_SIG_DMA2D_TXEND   (24)
+#define DMAMUX1_SIG_LTDC_LINE     (25)
+
 /* DMA channel mapping
  *
  * D.CCCCCCC
@@ -0,0 +1,271 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/hardware/stm32l4xrxx_octospi.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_SRC_STM32L4_HARDWARE_STM32L4XRXX_OCTOSPI_H
+#define __ARCH_ARM_SRC_STM32L4_HARDWARE_STM32L4XRXX_OCTOSPI_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include "chip.h"
+
+#if defined(CONFIG_STM32L4_STM32L4XR)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Register Offsets *********************************************************/
+
+#define STM32L4_OCTOSPI_CR_OFFSET       0x0000    /* Control Register */
+#define STM32L4_OCTOSPI_DCR1_OFFSET     0x0008    /* Device Configuration Register 1 */
+#define STM32L4_OCTOSPI_DCR2_OFFSET     0x000c    /* Device Configuration Register 2 */
+#define STM32L4_OCTOSPI_DCR3_OFFSET     0x0010    /* Device Configuration Register 3 */
+#define STM32L4_OCTOSPI_DCR4_OFFSET     0x0014    /* Device Configuration Register 4 */
+#define STM32L4_OCTOSPI_SR_OFFSET       0x0020    /* Status Register */
+#define STM32L4_OCTOSPI_FCR_OFFSET      0x0024    /* Flag Clear Register */
+#define STM32L4_OCTOSPI_DLR_OFFSET      0x0040    /* Data Length Register */
+#define STM32L4_OCTOSPI_AR_OFFSET       0x0048    /* Address Register */
+#define STM32L4_OCTOSPI_DR_OFFSET       0x0050    /* Data Register */
+#define STM32L4_OCTOSPI_PSMKR_OFFSET    0x0080    /* Polling Status Mask Register */
+#define STM32L4_OCTOSPI_PSMAR_OFFSET    0x0088    /* Polling Status Match Register */
+#define STM32L4_OCTOSPI_PIR_OFFSET      0x0090    /* Polling Interval Register */
+#define STM32L4_OCTOSPI_CCR_OFFSET      0x0100    /* Communication Configuration Register */
+#define STM32L4_OCTOSPI_TCR_OFFSET      0x0108    /* Timing Configuration Register */
+#define STM32L4_OCTOSPI_IR_OFFSET       0x0110    /* Instruction Register */
+#define STM32L4_OCTOSPI_ABR_OFFSET      0x0120    /* Alternate Bytes Register */
+#define STM32L4_OCTOSPI_LPTR_OFFSET     0x0130    /* Low-Power Timeout Register */
+#define STM32L4_OCTOSPI_WCCR_OFFSET     0x0180    /* Write Communication Configuration Register */
+#define STM32L4_OCTOSPI_WTCR_OFFSET     0x0188    /* Write Timing Configuration Register */
+#define STM32L4_OCTOSPI_WIR_OFFSET      0x0190    /* Write Instruction Register */
+#define STM32L4_OCTOSPI_WABR_OFFSET     0x01a0    /* Write Alternate Bytes Register */
+#define STM32L4_OCTOSPI_HLCR_OFFSET     0x0200    /* HyperBus Latency Configuration Register */
+
+#define STM32L4_OCTOSPIM_CR_OFFSET      0x0000    /* OCTOSPI IO Manager Control Register */
+#define STM32L4_OCTOSPIM_P1CR_OFFSET    0x0004    /* OCTOSPI IO Manager Port 1 Configuration Register */
+#define STM32L4_OCTOSPIM_P2CR_OFFSET    0x0008    /* OCTOSPI IO Manager Port 2 Configuration Register */
+
+/* Register Addresses *******************************************************/
+
+#define STM32L4_OCTOSPIM_CR             (STM32L4_OCTOSPIIOM_BASE+STM32L4_OCTOSPIM_CR_OFFSET)
+#define STM32L4_OCTOSPIM_P1CR           (STM32L4_OCTOSPIIOM_BASE+STM32L4_OCTOSPIM_P1CR_OFFSET)
+#define STM32L4_OCTOSPIM_P2CR           (STM32L4_OCTOSPIIOM_BASE+STM32L4_OCTOSPIM_P2CR_OFFSET)
+
+/* Register Bitfield Definitions ********************************************/
+
+/* Functional, instruction, address, alternate byte and data modes */
+
+#define OCTOSPI_FMODE_INDWR         0   /* Indirect write mode */
+#define OCTOSPI_FMODE_INDRD         1   /* Indirect read mode */
+#define OCTOSPI_FMODE_AUTOPOLL      2   /* Automatic polling mode */
+#define OCTOSPI_FMODE_MEMMAP        3   /* Memory-mapped mode */
+
+#define OCTOSPI_LINES_NONE          0   /* Phase is skipped */
+#define OCTOSPI_LINES_SINGLE        1   /* Phase on a single line */
+#define OCTOSPI_LINES_DUAL          2   /* Phase on two lines */
+#define OCTOSPI_LINES_QUAD          3   /* Phase on four lines */
+#define OCTOSPI_LINES_OCTAL         4   /* Phase on eight lines */
+
+#define OCTOSPI_SIZE_8              0   /* 8-bit instruction/address/alternate bytes */
+#define OCTOSPI_SIZE_16             1   /* 16-bit */
+#define OCTOSPI_SIZE_24             2   /* 24-bit */
+#define OCTOSPI_SIZE_32             3   /* 32-bit */
+
+/* Control Register */
+
+#define OCTOSPI_CR_EN                 (1 << 0)   /* Bit 0:  Enable */
+#define OCTOSPI_CR_ABORT              (1 << 1)   /* Bit 1:  Abort request */
+#define OCTOSPI_CR_DMAEN              (1 << 2)   /* Bit 2:  DMA enable */
+#define OCTOSPI_CR_TCEN               (1 << 3)   /* Bit 3:  Timeout counter enable */
+#define OCTOSPI_CR_DQM                (1 << 6)   /* Bit 6:  Dual-quad mode */
+#define OCTOSPI_CR_FSEL               (1 << 7)   /* Bit 7:  Flash memory selection */
+#define OCTOSPI_CR_FTHRES_SHIFT       (8)        /* Bits 8-12: FIFO threshold level */
+#define OCTOSPI_CR_FTHRES_MASK        (0x1f << OCTOSPI_CR_FTHRES_SHIFT)
+#  define OCTOSPI_CR_FTHRES(n)        ((uint32_t)((n) - 1) << OCTOSPI_CR_FTHRES_SHIFT)
+#define OCTOSPI_CR_TEIE               (1 << 16)  /* Bit 16: Transfer error interrupt enable */
+#define OCTOSPI_CR_TCIE               (1 << 17)  /* Bit 17: Transfer complete interrupt enable */
+#define OCTOSPI_CR_FTIE               (1 << 18)  /* Bit 18: FIFO threshold interrupt enable */
+#define OCTOSPI_CR_SMIE               (1 << 19)  /* Bit 19: Status match interrupt enable */
+#define OCTOSPI_CR_TOIE               (1 << 20)  /* Bit 20: Timeout interrupt enable */
+#define OCTOSPI_CR_APMS               (1 << 22)  /* Bit 22: Automatic poll mode stop */
+#define OCTOSPI_CR_PMM                (1 << 23)  /* Bit 23: Polling match mode */
+#define OCTOSPI_CR_FMODE_SHIFT        (28)       /* Bits 28-29: Functional mode */
+#define OCTOSPI_CR_FMODE_MASK         (0x3 << OCTOSPI_CR_FMODE_SHIFT)
+#  define OCTOSPI_CR_FMODE(n)         ((uint32_t)(n) << OCTOSPI_CR_FMODE_SHIFT)
+
+/* Device Configuration Register 1 */
+
+#define OCTOSPI_DCR1_CKMODE           (1 << 0)   /* Bit 0:  Mode 0 / mode 3 */
+#define OCTOSPI_DCR1_FRCK             (1 << 1)   /* Bit 1:  Free running clock */
+#define OCTOSPI_DCR1_DLYBYP           (1 << 3)   /* Bit 3:  Delay block bypass */
+#define OCTOSPI_DCR1_CSHT_SHIFT       (8)        /* Bits 8-10: Chip select high time */
+#define OCTOSPI_DCR1_CSHT_MASK        (0x7 << OCTOSPI_DCR1_CSHT_SHIFT)
+#  define OCTOSPI_DCR1_CSHT(n)        ((uint32_t)((n) - 1) << OCTOSPI_DCR1_CSHT_SHIFT)
+#define OCTOSPI_DCR1_DEVSIZE_SHIFT    (16)       /* Bits 16-20: Device size, 2^(DEVSIZE+1) bytes */
+#define OCTOSPI_DCR1_DEVSIZE_MASK     (0x1f << OCTOSPI_DCR1_DEVSIZE_SHIFT)
+#  define OCTOSPI_DCR1_DEVSIZE(n)     ((uint32_t)(n) << OCTOSPI_DCR1_DEVSIZE_SHIFT)
+#define OCTOSPI_DCR1_MTYP_SHIFT       (24)       /* Bits 24-26: Memory type */
+#define OCTOSPI_DCR1_MTYP_MASK        (0x7 << OCTOSPI_DCR1_MTYP_SHIFT)
+#  define OCTOSPI_DCR1_MTYP_MICRON    (0 << OCTOSPI_DCR1_MTYP_SHIFT) /* D0/D1 ordering in octal DTR */
+#  define OCTOSPI_DCR1_MTYP_MACRONIX  (1 << OCTOSPI_DCR1_MTYP_SHIFT) /* D1/D0 ordering in octal DTR */
+#  define OCTOSPI_DCR1_MTYP_STANDARD  (2 << OCTOSPI_DCR1_MTYP_SHIFT) /* Standard mode */
+#  define OCTOSPI_DCR1_MTYP_MXRAM     (3 << OCTOSPI_DCR1_MTYP_SHIFT) /* Macronix RAM mode */
+#  define OCTOSPI_DCR1_MTYP_HYPERMEM  (4 << OCTOSPI_DCR1_MTYP_SHIFT) /* HyperBus memory mode */
+#  define OCTOSPI_DCR1_MTYP_HYPERREG  (5 << OCTOSPI_DCR1_MTYP_SHIFT) /* HyperBus register mode */
+
+/* Device Configuration Register 2 */
+
+#define OCTOSPI_DCR2_PRESCALER_SHIFT  (0)        /* Bits 0-7: Clock prescaler */
+#define OCTOSPI_DCR2_PRESCALER_MASK   (0xff << OCTOSPI_DCR2_PRESCALER_SHIFT)
+#define OCTOSPI_DCR2_WRAPSIZE_SHIFT   (16)       /* Bits 16-18: Wrap size */
+#define OCTOSPI_DCR2_WRAPSIZE_MASK    (0x7 << OCTOSPI_DCR2_WRAPSIZE_SHIFT)
+
+/* Device Configuration Register 3 */
+
+#define OCTOSPI_DCR3_MAXTRAN_SHIFT    (0)        /* Bits 0-7: Maximum transfer */
+#define OCTOSPI_DCR3_MAXTRAN_MASK     (0xff << OCTOSPI_DCR3_MAXTRAN_SHIFT)
+#define OCTOSPI_DCR3_CSBOUND_SHIFT    (16)       /* Bits 16-20: CS boundary */
+#define OCTOSPI_DCR3_CSBOUND_MASK     (0x1f << OCTOSPI_DCR3_CSBOUND_SHIFT)
+
+/* Device Configuration Register 4 (32-bit refresh rate) */
+
+/* Status Register */
+
+#define OCTOSPI_SR_TEF                (1 << 0)   /* Bit 0:  Transfer error flag */
+#define OCTOSPI_SR_TCF                (1 << 1)   /* Bit 1:  Transfer complete flag */
+#define OCTOSPI_SR_FTF                (1 << 2)   /* Bit 2:  FIFO threshold flag */
+#define OCTOSPI_SR_SMF                (1 << 3)   /* Bit 3:  Status match flag */
+#define OCTOSPI_SR_TOF                (1 << 4)   /* Bit 4:  Timeout flag */
+#define OCTOSPI_SR_BUSY               (1 << 5)   /* Bit 5:  Busy */
+#define OCTOSPI_SR_FLEVEL_SHIFT       (8)        /* Bits 8-13: FIFO level */
+#define OCTOSPI_SR_FLEVEL_MASK        (0x3f << OCTOSPI_SR_FLEVEL_SHIFT)
+
+/* Flag Clear Register */
+
+#define OCTOSPI_FCR_CTEF              (1 << 0)   /* Bit 0:  Clear transfer error flag */
+#define OCTOSPI_FCR_CTCF              (1 << 1)   /* Bit 1:  Clear transfer complete flag */
+#define OCTOSPI_FCR_CSMF              (1 << 3)   /* Bit 3:  Clear status match flag */
+#define OCTOSPI_FCR_CTOF              (1 << 4)   /* Bit 4:  Clear timeout flag */
+#define OCTOSPI_FCR_ALL               (OCTOSPI_FCR_CTEF | OCTOSPI_FCR_CTCF | \
+                                       OCTOSPI_FCR_CSMF | OCTOSPI_FCR_CTOF)
+
+/* Data Length Register (32-bit number of bytes - 1) */
+
+/* Address Register (32-bit address) */
+
+/* Data Register (8/16/32-bit access to the FIFO) */
+
+/* Polling Interval Register */
+
+#define OCTOSPI_PIR_INTERVAL_SHIFT    (0)        /* Bits 0-15: Polling interval */
+#define OCTOSPI_PIR_INTERVAL_MASK     (0xffff << OCTOSPI_PIR_INTERVAL_SHIFT)
+
+/* Communication Configuration Register and
+ * Write Communication Configuration Register
+ */
+
+#define OCTOSPI_CCR_IMODE_SHIFT       (0)        /* Bits 0-2: Instruction mode */
+#define OCTOSPI_CCR_IMODE_MASK        (0x7 << OCTOSPI_CCR_IMODE_SHIFT)
+#  define OCTOSPI_CCR_IMODE(n)        ((uint32_t)(n) << OCTOSPI_CCR_IMODE_SHIFT)
+#define OCTOSPI_CCR_IDTR              (1 << 3)   /* Bit 3:  Instruction double transfer rate */
+#define OCTOSPI_CCR_ISIZE_SHIFT       (4)        /* Bits 4-5: Instruction size */
+#define OCTOSPI_CCR_ISIZE_MASK        (0x3 << OCTOSPI_CCR_ISIZE_SHIFT)
+#  define OCTOSPI_CCR_ISIZE(n)        ((uint32_t)(n) << OCTOSPI_CCR_ISIZE_SHIFT)
+#define OCTOSPI_CCR_ADMODE_SHIFT      (8)        /* Bits 8-10: Address mode */
+#define OCTOSPI_CCR_ADMODE_MASK       (0x7 << OCTOSPI_CCR_ADMODE_SHIFT)
+#  define OCTOSPI_CCR_ADMODE(n)       ((uint32_t)(n) << OCTOSPI_CCR_ADMODE_SHIFT)
+#define OCTOSPI_CCR_ADDTR             (1 << 11)  /* Bit 11: Address double transfer rate */
+#define OCTOSPI_CCR_ADSIZE_SHIFT      (12)       /* Bits 12-13: Address size */
+#define OCTOSPI_CCR_ADSIZE_MASK       (0x3 << OCTOSPI_CCR_ADSIZE_SHIFT)
+#  define OCTOSPI_CCR_ADSIZE(n)       ((uint32_t)(n) << OCTOSPI_CCR_ADSIZE_SHIFT)
+#define OCTOSPI_CCR_ABMODE_SHIFT      (16)       /* Bits 16-18: Alternate bytes mode */
+#define OCTOSPI_CCR_ABMODE_MASK       (0x7 << OCTOSPI_CCR_ABMODE_SHIFT)
+#  define OCTOSPI_CCR_ABMODE(n)       ((uint32_t)(n) << OCTOSPI_CCR_ABMODE_SHIFT)
+#define OCTOSPI_CCR_ABDTR             (1 << 19)  /* Bit 19: Alternate bytes double transfer rate */
+#define OCTOSPI_CCR_ABSIZE_SHIFT      (20)       /* Bits 20-21: Alternate bytes size */
+#define OCTOSPI_CCR_ABSIZE_MASK       (0x3 << OCTOSPI_CCR_ABSIZE_SHIFT)
+#  define OCTOSPI_CCR_ABSIZE(n)       ((uint32_t)(n) << OCTOSPI_CCR_ABSIZE_SHIFT)
+#define OCTOSPI_CCR_DMODE_SHIFT       (24)       /* Bits 24-26: Data mode */
+#define OCTOSPI_CCR_DMODE_MASK        (0x7 << OCTOSPI_CCR_DMODE_SHIFT)
+#  define OCTOSPI_CCR_DMODE(n)        ((uint32_t)(n) << OCTOSPI_CCR_DMODE_SHIFT)
+#define OCTOSPI_CCR_DDTR              (1 << 27)  /* Bit 27: Data double transfer rate */
+#define OCTOSPI_CCR_DQSE              (1 << 29)  /* Bit 29: DQS enable */
+#define OCTOSPI_CCR_SIOO              (1 << 31)  /* Bit 31: Send instruction only once mode */
+
+/* Timing Configuration Register and Write Timing Configuration Register */
+
+#define OCTOSPI_TCR_DCYC_SHIFT        (0)        /* Bits 0-4: Number of dummy cycles */
+#define OCTOSPI_TCR_DCYC_MASK         (0x1f << OCTOSPI_TCR_DCYC_SHIFT)
+#  define OCTOSPI_TCR_DCYC(n)         ((uint32_t)(n) << OCTOSPI_TCR_DCYC_SHIFT)
+#define OCTOSPI_TCR_DHQC              (1 << 28)  /* Bit 28: Delay hold quarter cycle */
+#define OCTOSPI_TCR_SSHIFT            (1 << 30)  /* Bit 30: Sample shift */
+
+/* Instruction Register (32-bit instruction) */
+
+/* Alternate Bytes Register (32-bit alternate bytes) */
+
+/* Low-Power Timeout Register */
+
+#define OCTOSPI_LPTR_TIMEOUT_SHIFT    (0)        /* Bits 0-15: Timeout period */
+#define OCTOSPI_LPTR_TIMEOUT_MASK     (0xffff << OCTOSPI_LPTR_TIMEOUT_SHIFT)
+
+/* HyperBus Latency Configuration Register */
+
+#define OCTOSPI_HLCR_LM               (1 << 0)   /* Bit 0:  Latency mode */
+#define OCTOSPI_HLCR_WZL              (1 << 1)   /* Bit 1:  Write zero latency */
+#define OCTOSPI_HLCR_TACC_SHIFT       (8)        /* Bits 8-15: Access time */
+#define OCTOSPI_HLCR_TACC_MASK        (0xff << OCTOSPI_HLCR_TACC_SHIFT)
+#define OCTOSPI_HLCR_TRWR_SHIFT       (16)       /* Bits 16-23: Read write recovery time */
+#define OCTOSPI_HLCR_TRWR_MASK        (0xff << OCTOSPI_HLCR_TRWR_SHIFT)
+
+/* OCTOSPI IO Manager Control Register */
+
+#define OCTOSPIM_CR_MUXEN             (1 << 0)   /* Bit 0:  Multiplexed mode enable */
+#define OCTOSPIM_CR_REQ2ACKTIME_SHIFT (16)       /* Bits 16-23: REQ to ACK time */
+#define OCTOSPIM_CR_REQ2ACKTIME_MASK  (0xff << OCTOSPIM_CR_REQ2ACKTIME_SHIFT)
+
+/* OCTOSPI IO Manager Port n Configuration Register */
+
+#define OCTOSPIM_PCR_CLKEN            (1 << 0)   /* Bit 0:  CLK/NCLK enable */
+#define OCTOSPIM_PCR_CLKSRC           (1 << 1)   /* Bit 1:  CLK/NCLK source (0=OCTOSPI1, 1=OCTOSPI2) */
+#define OCTOSPIM_PCR_DQSEN            (1 << 4)   /* Bit 4:  DQS enable */
+#define OCTOSPIM_PCR_DQSSRC           (1 << 5)   /* Bit 5:  DQS source */
+#define OCTOSPIM_PCR_NCSEN            (1 << 8)   /* Bit 8:  NCS enable */
+#define OCTOSPIM_PCR_NCSSRC           (1 << 9)   /* Bit 9:  NCS source */
+#define OCTOSPIM_PCR_IOLEN            (1 << 16)  /* Bit 16: IO[3:0] enable */
+#define OCTOSPIM_PCR_IOLSRC_SHIFT     (17)       /* Bits 17-18: IO[3:0] source */
+#define OCTOSPIM_PCR_IOLSRC_MASK      (0x3 << OCTOSPIM_PCR_IOLSRC_SHIFT)
+#  define OCTOSPIM_PCR_IOLSRC(n)      ((uint32_t)(n) << OCTOSPIM_PCR_IOLSRC_SHIFT)
+#define OCTOSPIM_PCR_IOHEN            (1 << 24)  /* Bit 24: IO[7:4] enable */
+#define OCTOSPIM_PCR_IOHSRC_SHIFT     (25)       /* Bits 25-26: IO[7:4] source */
+#define OCTOSPIM_PCR_IOHSRC_MASK      (0x3 << OCTOSPIM_PCR_IOHSRC_SHIFT)
+#  define OCTOSPIM_PCR_IOHSRC(n)      ((uint32_t)(n) << OCTOSPIM_PCR_IOHSRC_SHIFT)
+
+/* IOLSRC/IOHSRC encodings */
+
+#define OCTOSPIM_IOSRC_OSPI1_LOW      0          /* OCTOSPI1 IO[3:0] */
+#define OCTOSPIM_IOSRC_OSPI1_HIGH     1          /* OCTOSPI1 IO[7:4] */
+#define OCTOSPIM_IOSRC_OSPI2_LOW      2          /* OCTOSPI2 IO[3:0] */
+#define OCTOSPIM_IOSRC_OSPI2_HIGH     3          /* OCTOSPI2 IO[7:4] */
+
+#endif /* CONFIG_STM32L4_STM32L4XR */
+#endif /* __ARCH_ARM_SRC_STM32L4_HARDWARE_STM32L4XRXX_OCTOSPI_H */
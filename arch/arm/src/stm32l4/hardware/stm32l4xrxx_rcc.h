@@ -858,5 +858,11 @@
 #  define RCC_CCIPR2_SAI2SEL_SAI2_EXT  (3 << RCC_CCIPR2_SAI2SEL_SHIFT)
 #  define RCC_CCIPR2_SAI2SEL_HSI       (4 << RCC_CCIPR2_SAI2SEL_SHIFT)
 
+#define RCC_CCIPR2_OSPISEL_SHIFT       (20)      /* Bits 20-21: OCTOSPI clock source selection */
+#define RCC_CCIPR2_OSPISEL_MASK        (3 << RCC_CCIPR2_OSPISEL_SHIFT)
+#  define RCC_CCIPR2_OSPISEL_SYSCLK    (0 << RCC_CCIPR2_OSPISEL_SHIFT)
+#  define RCC_CCIPR2_OSPISEL_MSI       (1 << RCC_CCIPR2_OSPISEL_SHIFT)
+#  define RCC_CCIPR2_OSPISEL_PLL48M1   (2 << RCC_CCIPR2_OSPISEL_SHIFT)
+
 #endif /* CONFIG_STM32L4_STM32L4XR */
 #endif /* __ARCH_ARM_SRC_STM32L4_HARDWARE_STM32L4XRXX_RCC_H */
@@ -60,4 +60,12 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Interrupt handlers executed from SRAM2 with CONFIG_STM32L4_RAMFUNC_ISRS */
+
+#ifdef CONFIG_STM32L4_RAMFUNC_ISRS
+#  define isr_ramfunc __ramfunc__
+#else
+#  define isr_ramfunc
+#endif
+
 #endif /* __ARCH_ARM_SRC_STM32L4_STM32L4_H */
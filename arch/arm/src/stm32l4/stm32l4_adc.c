@@ -40,6 +40,17 @@
 #include <nuttx/power/pm.h>
 #include <nuttx/analog/adc.h>
 #include <nuttx/analog/ioctl.h>
+#include <arch/chip/adc.h>
+
+#if defined(CONFIG_STM32L4_ADC1_STREAM) || \
+    defined(CONFIG_STM32L4_ADC2_STREAM) || \
+    defined(CONFIG_STM32L4_ADC3_STREAM)
+#  include <fcntl.h>
+#  include <poll.h>
+#  include <nuttx/fs/fs.h>
+#  include <nuttx/mutex.h>
+#  include <nuttx/semaphore.h>
+#endif
 
 #include "chip.h"
 #include "stm32l4_rcc.h"
@@ -119,6 +130,26 @@
                               DMA_CCR_MINC | \
                               DMA_CCR_CIRC)
 
+/* In dual mode, each 32-bit transfer from the common data register holds
+ * the master result in the lower and the slave result in the upper half.
+ */
+
+#ifdef ADC_HAVE_DUAL
+#  define ADC_DMA_DUAL_CONTROL_WORD (DMA_CCR_MSIZE_32BITS | \
+                                     DMA_CCR_PSIZE_32BITS | \
+                                     DMA_CCR_MINC | \
+                                     DMA_CCR_CIRC)
+#  define ADC_DMA_SAMPLES (2 * ADC_MAX_SAMPLES)
+#else
+#  define ADC_DMA_SAMPLES ADC_MAX_SAMPLES
+#endif
+
+/* Oversampling bits of CFGR2 */
+
+#define ADC_CFGR2_OVS_MASK (ADC_CFGR2_ROVSE | ADC_CFGR2_JOVSE | \
+                            ADC_CFGR2_OVSR_MASK | ADC_CFGR2_OVSS_MASK | \
+                            ADC_CFGR2_TROVS | ADC_CFGR2_ROVSM)
+
 /* Sample time default configuration */
 
 #ifndef CONFIG_STM32L4_ADC_SMPR
@@ -168,6 +199,34 @@
  * Private Types
  ****************************************************************************/
 
+#ifdef ADC_HAVE_STREAM
+/* State of the DMA streaming device of one ADC.  The DMA fills the two
+ * halves of buffer[] in turn, block n going to half (n & 1).  head counts
+ * the blocks completed and is only written by the DMA callback; tail is
+ * the next block to return and is only written by the reader.
+ */
+
+struct adc_stream_s
+{
+  volatile uint32_t head;          /* Blocks completed by the DMA */
+  uint32_t tail;                   /* Next block for the reader */
+  uint32_t lost;                   /* Blocks overwritten before being read */
+  uint16_t halfsize;               /* Samples per block */
+  uint16_t halfxfers;              /* DMA transfers per block */
+  uint8_t  nchannels;              /* Channels interleaved in each block */
+  volatile bool waiting;           /* A reader waits for a block */
+  sem_t waitsem;                   /* Posted when a block completes */
+  mutex_t lock;                    /* Serializes readers */
+  struct pollfd *fds;              /* Poll waiter */
+  stm32l4_adcstream_cb_t callback; /* Block callback */
+  void *arg;                       /* Argument of the block callback */
+
+  /* Circular DMA buffer */
+
+  uint16_t buffer[2 * CONFIG_STM32L4_ADC_STREAM_BLOCKSIZE] aligned_data(4);
+};
+#endif
+
 /* This structure describes the state of one ADC block */
 
 struct stm32_dev_s
@@ -197,10 +256,14 @@ struct stm32_dev_s
 #ifdef ADC_HAVE_DFSDM
   bool    hasdfsdm;     /* True: This ADC routes its output to DFSDM */
 #endif
+#ifdef ADC_HAVE_DUAL
+  bool    dual;         /* True: Master of the dual interleaved pair */
+#endif
 #ifdef ADC_HAVE_TIMER
   uint8_t channel;      /* Timer channel: 1=CC1, 2=CC2, 3=CC3, 4=CC4 */
 #endif
   xcpt_t   isr;         /* Interrupt handler for this ADC block */
+  uint32_t ovscfg;      /* CFGR2 oversampling configuration */
   uint32_t base;        /* Base address of registers unique to this ADC
                          * block */
 #ifdef ADC_HAVE_EXTCFG
@@ -221,10 +284,13 @@ struct stm32_dev_s
 
 #ifdef ADC_HAVE_DMA
   DMA_HANDLE dma;       /* Allocated DMA channel */
+#  ifdef ADC_HAVE_STREAM
+  struct adc_stream_s *stream; /* Streaming state; NULL: upper half mode */
+#  endif
 
   /* DMA transfer buffer */
 
-  uint16_t dmabuffer[ADC_MAX_SAMPLES];
+  uint16_t dmabuffer[ADC_DMA_SAMPLES] aligned_data(4);
 #endif
 
   /* List of selected ADC channels to sample */
@@ -295,6 +361,12 @@ static void     adc_dmaconvcallback(DMA_HANDLE handle, uint8_t isr,
                                     void *arg);
 #  endif
 #endif
+#ifdef ADC_HAVE_STREAM
+static void     adc_stream_start(struct adc_dev_s *dev);
+static void     adc_streamcallback(DMA_HANDLE handle, uint8_t status,
+                                   void *arg);
+static struct adc_stream_s *adc_stream_lookup(int intf);
+#endif
 #if defined(ADC_HAVE_DFSDM) || defined(CONFIG_STM32L4_ADC_LL_OPS)
 static int      adc_offset_set(struct stm32_dev_s *priv, uint8_t ch,
                                uint8_t i, uint16_t offset);
@@ -307,6 +379,11 @@ static int      adc_extsel_set(struct stm32_dev_s *priv,
 static int      adc_jextsel_set(struct stm32_dev_s *priv,
                                 uint32_t jextcfg);
 #endif
+static int      adc_ovs_set(struct stm32_dev_s *priv,
+                            const struct stm32l4_adc_ovs_s *ovs);
+#ifdef ADC_HAVE_DUAL
+static void     adc_dual_cfg(struct stm32_dev_s *priv);
+#endif
 
 #ifdef CONFIG_PM
 static int      adc_pm_prepare(struct pm_callback_s *cb, int domain,
@@ -369,6 +446,22 @@ static void adc_shutdown(struct adc_dev_s *dev);
 static void adc_rxint(struct adc_dev_s *dev, bool enable);
 static int  adc_ioctl(struct adc_dev_s *dev, int cmd, unsigned long arg);
 
+/* DMA Streaming Device Methods */
+
+#ifdef ADC_HAVE_STREAM
+static int     adc_stream_wait(struct adc_stream_s *stream, bool nonblock,
+                               uint32_t *seq);
+static int     adc_stream_open(struct file *filep);
+static ssize_t adc_stream_read(struct file *filep, char *buffer,
+                               size_t buflen);
+static int     adc_stream_ioctl(struct file *filep, int cmd,
+                                unsigned long arg);
+static int     adc_stream_mmap(struct file *filep,
+                               struct mm_map_entry_s *map);
+static int     adc_stream_poll(struct file *filep, struct pollfd *fds,
+                               bool setup);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -385,6 +478,23 @@ static const struct adc_ops_s g_adcops =
   .ao_ioctl       = adc_ioctl,
 };
 
+/* DMA streaming device operations */
+
+#ifdef ADC_HAVE_STREAM
+static const struct file_operations g_adcstreamops =
+{
+  adc_stream_open,   /* open */
+  NULL,              /* close */
+  adc_stream_read,   /* read */
+  NULL,              /* write */
+  NULL,              /* seek */
+  adc_stream_ioctl,  /* ioctl */
+  adc_stream_mmap,   /* mmap */
+  NULL,              /* truncate */
+  adc_stream_poll,   /* poll */
+};
+#endif
+
 /* Publicly visible ADC lower-half operations */
 
 #ifdef CONFIG_STM32L4_ADC_LL_OPS
@@ -417,6 +527,14 @@ static const struct stm32_adc_ops_s g_adc_llops =
 /* ADC1 state */
 
 #ifdef CONFIG_STM32L4_ADC1
+#ifdef ADC1_HAVE_STREAM
+static struct adc_stream_s g_adcstream1 =
+{
+  .waitsem     = SEM_INITIALIZER(0),
+  .lock        = NXMUTEX_INITIALIZER,
+};
+#endif
+
 static struct stm32_dev_s g_adcpriv1 =
 {
 #ifdef CONFIG_STM32L4_ADC_LL_OPS
@@ -431,6 +549,7 @@ static struct stm32_dev_s g_adcpriv1 =
   .resolution  = CONFIG_STM32L4_ADC1_RESOLUTION,
 #endif
   .base        = STM32L4_ADC1_BASE,
+  .ovscfg      = ADC1_OVSCFG_VALUE,
 #if defined(ADC1_HAVE_TIMER) || defined(ADC1_HAVE_EXTCFG)
   .extcfg      = ADC1_EXTCFG_VALUE,
 #endif
@@ -445,12 +564,20 @@ static struct stm32_dev_s g_adcpriv1 =
 #endif
 #ifdef ADC1_HAVE_DMA
   .dmachan     = ADC1_DMA_CHAN,
+#  ifdef ADC1_HAVE_STREAM
+  .dmacfg      = 1,             /* Streaming needs circular mode */
+  .stream      = &g_adcstream1,
+#  else
   .dmacfg      = CONFIG_STM32L4_ADC1_DMA_CFG,
+#  endif
   .hasdma      = true,
 #endif
 #ifdef ADC1_HAVE_DFSDM
   .hasdfsdm    = true,
 #endif
+#ifdef ADC_HAVE_DUAL
+  .dual        = true,
+#endif
 #ifdef CONFIG_PM
   .pm_callback =
     {
@@ -469,6 +596,14 @@ static struct adc_dev_s g_adcdev1 =
 /* ADC2 state */
 
 #ifdef CONFIG_STM32L4_ADC2
+#ifdef ADC2_HAVE_STREAM
+static struct adc_stream_s g_adcstream2 =
+{
+  .waitsem     = SEM_INITIALIZER(0),
+  .lock        = NXMUTEX_INITIALIZER,
+};
+#endif
+
 static struct stm32_dev_s g_adcpriv2 =
 {
 #ifdef CONFIG_STM32L4_ADC_LL_OPS
@@ -483,6 +618,7 @@ static struct stm32_dev_s g_adcpriv2 =
   .resolution  = CONFIG_STM32L4_ADC2_RESOLUTION,
 #endif
   .base        = STM32L4_ADC2_BASE,
+  .ovscfg      = ADC2_OVSCFG_VALUE,
 #if defined(ADC2_HAVE_TIMER) || defined(ADC2_HAVE_EXTCFG)
   .extcfg      = ADC2_EXTCFG_VALUE,
 #endif
@@ -497,7 +633,12 @@ static struct stm32_dev_s g_adcpriv2 =
 #endif
 #ifdef ADC2_HAVE_DMA
   .dmachan     = ADC2_DMA_CHAN,
+#  ifdef ADC2_HAVE_STREAM
+  .dmacfg      = 1,             /* Streaming needs circular mode */
+  .stream      = &g_adcstream2,
+#  else
   .dmacfg      = CONFIG_STM32L4_ADC2_DMA_CFG,
+#  endif
   .hasdma      = true,
 #endif
 #ifdef ADC2_HAVE_DFSDM
@@ -521,6 +662,14 @@ static struct adc_dev_s g_adcdev2 =
 /* ADC3 state */
 
 #ifdef CONFIG_STM32L4_ADC3
+#ifdef ADC3_HAVE_STREAM
+static struct adc_stream_s g_adcstream3 =
+{
+  .waitsem     = SEM_INITIALIZER(0),
+  .lock        = NXMUTEX_INITIALIZER,
+};
+#endif
+
 static struct stm32_dev_s g_adcpriv3 =
 {
 #ifdef CONFIG_STM32L4_ADC_LL_OPS
@@ -535,6 +684,7 @@ static struct stm32_dev_s g_adcpriv3 =
   .resolution  = CONFIG_STM32L4_ADC3_RESOLUTION,
 #endif
   .base        = STM32L4_ADC3_BASE,
+  .ovscfg      = ADC3_OVSCFG_VALUE,
 #if defined(ADC3_HAVE_TIMER) || defined(ADC3_HAVE_EXTCFG)
   .extcfg      = ADC3_EXTCFG_VALUE,
 #endif
@@ -549,7 +699,12 @@ static struct stm32_dev_s g_adcpriv3 =
 #endif
 #ifdef ADC3_HAVE_DMA
   .dmachan     = ADC3_DMA_CHAN,
+#  ifdef ADC3_HAVE_STREAM
+  .dmacfg      = 1,             /* Streaming needs circular mode */
+  .stream      = &g_adcstream3,
+#  else
   .dmacfg      = CONFIG_STM32L4_ADC3_DMA_CFG,
+#  endif
   .hasdma      = true,
 #endif
 #ifdef ADC3_HAVE_DFSDM
@@ -946,6 +1101,13 @@ static int adc_timinit(struct stm32_dev_s *priv)
   tim_putreg(priv, STM32L4_GTIM_PSC_OFFSET, prescaler - 1);
   tim_putreg(priv, STM32L4_GTIM_ARR_OFFSET, reload);
 
+  /* Output the update event on TRGO, so that the TIMx_TRGO events can be
+   * selected as trigger as well as the CCx events.
+   */
+
+  tim_modifyreg(priv, STM32L4_GTIM_CR2_OFFSET, GTIM_CR2_MMS_MASK,
+                GTIM_CR2_MMS_UPDATE);
+
   /* Clear the advanced timers repetition counter in TIM1 */
 
   if (priv->tbase == STM32L4_TIM1_BASE || priv->tbase == STM32L4_TIM8_BASE)
@@ -1378,10 +1540,32 @@ static int adc_setup(struct adc_dev_s *dev)
   clrbits |= ADC_CFGR_EXTEN_MASK;
   setbits |= ADC_CFGR_EXTEN_NONE;
 
+#ifdef ADC_HAVE_STREAM
+  /* Without a hardware trigger, a stream converts continuously.  With a
+   * trigger, each event converts the sequence once, so that the sample
+   * clock is set by the timer alone.
+   */
+
+  if (priv->stream != NULL)
+    {
+#  ifdef ADC_HAVE_EXTCFG
+      if ((priv->extcfg & ADC_CFGR_EXTEN_MASK) == 0)
+#  endif
+        {
+          setbits |= ADC_CFGR_CONT;
+        }
+    }
+#endif
+
   /* Set CFGR configuration */
 
   adc_modifyreg(priv, STM32L4_ADC_CFGR_OFFSET, clrbits, setbits);
 
+  /* Set the hardware oversampling */
+
+  adc_modifyreg(priv, STM32L4_ADC_CFGR2_OFFSET, ADC_CFGR2_OVS_MASK,
+                priv->ovscfg);
+
   /* Configuration of the channel conversions */
 
   if (priv->cchannels > 0)
@@ -1447,6 +1631,17 @@ static int adc_setup(struct adc_dev_s *dev)
   adc_jextsel_set(priv, priv->jextcfg);
 #endif
 
+#ifdef ADC_HAVE_DUAL
+  /* Bring up the slave ADC.  The dual mode can only be selected while
+   * both ADCs are disabled.
+   */
+
+  if (priv->dual)
+    {
+      adc_dual_cfg(priv);
+    }
+#endif
+
   /* Set ADEN to wake up the ADC from Power Down. */
 
   adc_enable(priv);
@@ -1516,15 +1711,26 @@ static int adc_setup(struct adc_dev_s *dev)
 
 static void adc_shutdown(struct adc_dev_s *dev)
 {
+#if !defined(CONFIG_STM32L4_ADC_NOIRQ) || defined(ADC_HAVE_STREAM)
+  struct stm32_dev_s *priv = (struct stm32_dev_s *)dev->ad_priv;
+#endif
+
 #ifndef CONFIG_STM32L4_ADC_NOIRQ
   /* Disable ADC interrupts and detach the ADC interrupt handler */
 
-  struct stm32_dev_s *priv = (struct stm32_dev_s *)dev->ad_priv;
-
   up_disable_irq(priv->irq);
   irq_detach(priv->irq);
 #endif
 
+#ifdef ADC_HAVE_STREAM
+  /* Stop the circular stream transfer, it is not ended by the ADC reset */
+
+  if (priv->stream != NULL && priv->dma != NULL)
+    {
+      stm32l4_dmastop(priv->dma);
+    }
+#endif
+
   /* Disable and reset the ADC module */
 
   adc_reset(dev);
@@ -1552,9 +1758,15 @@ static void adc_rxint(struct adc_dev_s *dev, bool enable)
   regval = adc_getreg(priv, STM32L4_ADC_IER_OFFSET);
   if (enable)
     {
-      /* Enable end of conversion interrupt */
+      /* Enable end of conversion interrupt, unless the samples are
+       * streamed
+       */
 
+#ifdef ADC_HAVE_STREAM
+      if (priv->cchannels > 0 && priv->stream == NULL)
+#else
       if (priv->cchannels > 0)
+#endif
         {
           regval |= ADC_INT_EOC;
         }
@@ -1701,6 +1913,166 @@ static int adc_jextsel_set(struct stm32_dev_s *priv, uint32_t jextcfg)
 }
 #endif
 
+/****************************************************************************
+ * Name: adc_ovs_set
+ *
+ * Description:
+ *   Set the hardware oversampling of the regular and injected groups.
+ *   CFGR2 can only be written while no conversion is ongoing, so running
+ *   conversions are stopped and restarted.
+ *
+ * Input Parameters:
+ *   priv - A reference to the ADC block status
+ *   ovs  - The oversampling configuration
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int adc_ovs_set(struct stm32_dev_s *priv,
+                       const struct stm32l4_adc_ovs_s *ovs)
+{
+  uint32_t cfgr2 = 0;
+  uint32_t running;
+  irqstate_t flags;
+
+  if (ovs->ovs_flags != 0)
+    {
+      if (ovs->ovs_ratio < 1 || ovs->ovs_ratio > 8 || ovs->ovs_shift > 8)
+        {
+          return -EINVAL;
+        }
+
+      cfgr2 = ((uint32_t)(ovs->ovs_ratio - 1) << ADC_CFGR2_OVSR_SHIFT) |
+              ADC_CFGR2_OVSS(ovs->ovs_shift);
+
+      if ((ovs->ovs_flags & STM32L4_ADCOVS_REGULAR) != 0)
+        {
+          cfgr2 |= ADC_CFGR2_ROVSE;
+        }
+
+      if ((ovs->ovs_flags & STM32L4_ADCOVS_INJECTED) != 0)
+        {
+          cfgr2 |= ADC_CFGR2_JOVSE;
+        }
+
+      if ((ovs->ovs_flags & STM32L4_ADCOVS_TRIGGERED) != 0)
+        {
+          cfgr2 |= ADC_CFGR2_TROVS;
+        }
+    }
+
+  flags = enter_critical_section();
+
+  running = adc_getreg(priv, STM32L4_ADC_CR_OFFSET) &
+            (ADC_CR_ADSTART | ADC_CR_JADSTART);
+
+  if ((running & ADC_CR_ADSTART) != 0)
+    {
+      adc_startconv(priv, false);
+    }
+
+#ifdef ADC_HAVE_INJECTED
+  if ((running & ADC_CR_JADSTART) != 0)
+    {
+      adc_inj_startconv(priv, false);
+    }
+#endif
+
+  while ((adc_getreg(priv, STM32L4_ADC_CR_OFFSET) &
+          (ADC_CR_ADSTART | ADC_CR_JADSTART)) != 0);
+
+  priv->ovscfg = cfgr2;
+  adc_modifyreg(priv, STM32L4_ADC_CFGR2_OFFSET, ADC_CFGR2_OVS_MASK, cfgr2);
+
+#ifdef ADC_HAVE_DUAL
+  /* The slave samples the same signal and must match */
+
+  if (priv->dual)
+    {
+      adc_modifyreg(&g_adcpriv2, STM32L4_ADC_CFGR2_OFFSET,
+                    ADC_CFGR2_OVS_MASK, cfgr2);
+    }
+#endif
+
+  if ((running & ADC_CR_ADSTART) != 0)
+    {
+      adc_startconv(priv, true);
+    }
+
+#ifdef ADC_HAVE_INJECTED
+  if ((running & ADC_CR_JADSTART) != 0)
+    {
+      adc_inj_startconv(priv, true);
+    }
+#endif
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: adc_dual_cfg
+ *
+ * Description:
+ *   Configure ADC2 as the slave of ADC1 in interleaved mode.  The slave
+ *   converts the same sequence, started by the master after a delay of
+ *   CONFIG_STM32L4_ADC_DUAL_DELAY ADC clock cycles, so that for a single
+ *   channel the sample rate is doubled.  The DMA of ADC1 reads both
+ *   results at once from the common data register.
+ *
+ * Input Parameters:
+ *   priv - A reference to the ADC1 block status
+ *
+ * Assumptions:
+ *   Both ADCs are disabled.
+ *
+ ****************************************************************************/
+
+#ifdef ADC_HAVE_DUAL
+static void adc_dual_cfg(struct stm32_dev_s *priv)
+{
+  struct stm32_dev_s *slave = &g_adcpriv2;
+  uint32_t regval;
+  uint32_t mdma;
+
+  /* Same sequence, sample times, resolution, alignment, continuous mode
+   * and oversampling as the master.  The trigger of the slave is unused.
+   */
+
+  slave->cchannels = priv->cchannels;
+  memcpy(slave->chanlist, priv->chanlist, priv->cchannels);
+
+  adc_sample_time_set(&g_adcdev2);
+  if (slave->cchannels > 0)
+    {
+      adc_set_ch(&g_adcdev2, 0);
+    }
+
+  regval = adc_getreg(priv, STM32L4_ADC_CFGR_OFFSET) &
+           (ADC_CFGR_RES_MASK | ADC_CFGR_ALIGN | ADC_CFGR_CONT);
+  adc_modifyreg(slave, STM32L4_ADC_CFGR_OFFSET,
+                ADC_CFGR_RES_MASK | ADC_CFGR_ALIGN | ADC_CFGR_CONT |
+                ADC_CFGR_EXTEN_MASK | ADC_CFGR_DMAEN, regval);
+  adc_modifyreg(slave, STM32L4_ADC_CFGR2_OFFSET, ADC_CFGR2_OVS_MASK,
+                priv->ovscfg);
+
+  /* Pack both results in one 32-bit transfer, each in a half word */
+
+  mdma = priv->resolution < 2 ? ADC_CCR_MDMA_10_12 : ADC_CCR_MDMA_6_8;
+
+  stm32_modifyreg32(STM32L4_ADC_CCR,
+                    ADC_CCR_DUAL_MASK | ADC_CCR_DELAY_MASK |
+                    ADC_CCR_MDMA_MASK | ADC_CCR_DMACFG,
+                    ADC_CCR_DUAL_INTERLEAVE |
+                    ADC_CCR_DELAY(CONFIG_STM32L4_ADC_DUAL_DELAY) |
+                    mdma | ADC_CCR_DMACFG);
+
+  adc_enable(slave);
+}
+#endif
+
 /****************************************************************************
  * Name: adc_dumpregs
  ****************************************************************************/
@@ -2065,6 +2437,21 @@ static int adc_ioctl(struct adc_dev_s *dev, int cmd, unsigned long arg)
 
         break;
 
+      case ANIOC_STM32L4_OVERSAMPLE:
+        {
+          const struct stm32l4_adc_ovs_s *ovs =
+            (const struct stm32l4_adc_ovs_s *)((uintptr_t)arg);
+
+          if (ovs == NULL)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          ret = adc_ovs_set(priv, ovs);
+        }
+        break;
+
 #ifdef ADC_HAVE_INJECTED
       case ANIOC_STM32L4_TRIGGER_INJ:
 
@@ -2304,6 +2691,18 @@ static void adc_dma_cfg(struct stm32_dev_s *priv)
 
   setbits |= ADC_CFGR_DMAEN;
 
+#ifdef ADC_HAVE_DUAL
+  if (priv->dual)
+    {
+      /* The DMA requests come from the common DMA mode of the pair, see
+       * adc_dual_cfg().
+       */
+
+      clrbits |= ADC_CFGR_DMAEN | ADC_CFGR_DMACFG;
+      setbits  = 0;
+    }
+#endif
+
 #ifdef ADC_HAVE_DFSDM
   if (priv->hasdfsdm)
     {
@@ -2340,12 +2739,33 @@ static void adc_dma_start(struct adc_dev_s *dev)
 
   priv->dma = stm32l4_dmachannel(priv->dmachan);
 
+#ifdef ADC_HAVE_STREAM
+  if (priv->stream != NULL)
+    {
+      adc_stream_start(dev);
+      return;
+    }
+#endif
+
 #ifndef CONFIG_STM32L4_ADC_NOIRQ
-  stm32l4_dmasetup(priv->dma,
-                   priv->base + STM32L4_ADC_DR_OFFSET,
-                   (uint32_t)priv->dmabuffer,
-                   priv->nchannels,
-                   ADC_DMA_CONTROL_WORD);
+#  ifdef ADC_HAVE_DUAL
+  if (priv->dual)
+    {
+      stm32l4_dmasetup(priv->dma,
+                       STM32L4_ADC_CDR,
+                       (uint32_t)priv->dmabuffer,
+                       priv->nchannels,
+                       ADC_DMA_DUAL_CONTROL_WORD);
+    }
+  else
+#  endif
+    {
+      stm32l4_dmasetup(priv->dma,
+                       priv->base + STM32L4_ADC_DR_OFFSET,
+                       (uint32_t)priv->dmabuffer,
+                       priv->nchannels,
+                       ADC_DMA_CONTROL_WORD);
+    }
 
   stm32l4_dmastart(priv->dma, adc_dmaconvcallback, dev, false);
 #endif
@@ -2382,6 +2802,23 @@ static void adc_dmaconvcallback(DMA_HANDLE handle,
     {
       DEBUGASSERT(priv->cb->au_receive != NULL);
 
+#ifdef ADC_HAVE_DUAL
+      if (priv->dual)
+        {
+          /* The master and slave results of each channel */
+
+          for (i = 0; i < 2 * priv->nchannels; i++)
+            {
+              priv->cb->au_receive(dev, priv->chanlist[i >> 1],
+                                   priv->dmabuffer[i]);
+            }
+
+          /* The common DMA mode of the pair is always circular */
+
+          return;
+        }
+#endif
+
       for (i = 0; i < priv->nchannels; i++)
         {
           priv->cb->au_receive(dev, priv->chanlist[priv->current],
@@ -2404,6 +2841,443 @@ static void adc_dmaconvcallback(DMA_HANDLE handle,
 #endif
 #endif  /* ADC_HAVE_DMA */
 
+#ifdef ADC_HAVE_STREAM
+/****************************************************************************
+ * Name: adc_stream_start
+ *
+ * Description:
+ *   Start the circular DMA transfer of a stream.  Each block holds whole
+ *   conversion sequences.  The block counters are not reset, so that a
+ *   reader only sees blocks lost across the restart.
+ *
+ * Input Parameters:
+ *   dev - The ADC device
+ *
+ ****************************************************************************/
+
+static void adc_stream_start(struct adc_dev_s *dev)
+{
+  struct stm32_dev_s *priv = (struct stm32_dev_s *)dev->ad_priv;
+  struct adc_stream_s *stream = priv->stream;
+
+  if (priv->nchannels == 0)
+    {
+      return;
+    }
+
+  stream->nchannels = priv->nchannels;
+
+#ifdef ADC_HAVE_DUAL
+  if (priv->dual)
+    {
+      /* Each transfer holds a master and a slave sample */
+
+      stream->halfsize  = CONFIG_STM32L4_ADC_STREAM_BLOCKSIZE -
+                          CONFIG_STM32L4_ADC_STREAM_BLOCKSIZE %
+                          (2 * priv->nchannels);
+      stream->halfxfers = stream->halfsize / 2;
+
+      stm32l4_dmasetup(priv->dma,
+                       STM32L4_ADC_CDR,
+                       (uint32_t)stream->buffer,
+                       2 * stream->halfxfers,
+                       ADC_DMA_DUAL_CONTROL_WORD);
+    }
+  else
+#endif
+    {
+      stream->halfsize  = CONFIG_STM32L4_ADC_STREAM_BLOCKSIZE -
+                          CONFIG_STM32L4_ADC_STREAM_BLOCKSIZE %
+                          priv->nchannels;
+      stream->halfxfers = stream->halfsize;
+
+      stm32l4_dmasetup(priv->dma,
+                       priv->base + STM32L4_ADC_DR_OFFSET,
+                       (uint32_t)stream->buffer,
+                       2 * stream->halfxfers,
+                       ADC_DMA_CONTROL_WORD);
+    }
+
+  stm32l4_dmastart(priv->dma, adc_streamcallback, dev, true);
+}
+
+/****************************************************************************
+ * Name: adc_streamcallback
+ *
+ * Description:
+ *   Callback for the stream DMA.  Called from the half transfer and
+ *   transfer complete interrupts; publishes the block just completed.
+ *
+ * Input Parameters:
+ *   handle - handle to DMA
+ *   status - DMA interrupt status
+ *   arg    - adc device
+ *
+ ****************************************************************************/
+
+static void adc_streamcallback(DMA_HANDLE handle, uint8_t status, void *arg)
+{
+  struct adc_dev_s *dev = (struct adc_dev_s *)arg;
+  struct stm32_dev_s *priv = (struct stm32_dev_s *)dev->ad_priv;
+  struct adc_stream_s *stream = priv->stream;
+  unsigned int ready;
+  uint32_t seq;
+
+  if ((status & DMA_STATUS_ERROR) != 0)
+    {
+      aerr("ERROR: ADC%d DMA transfer error\n", priv->intf);
+      return;
+    }
+
+  /* The completed half is the one the DMA is not transferring.  It is
+   * found from the transfer counter rather than from the status, which
+   * has both HTIF and TCIF set if the interrupt was serviced late.  Then
+   * a block was skipped: keep block n in half (n & 1).
+   */
+
+  ready = stm32l4_dmaresidual(handle) > stream->halfxfers ? 1 : 0;
+  seq   = stream->head;
+  if ((seq & 1) != ready)
+    {
+      seq++;
+    }
+
+  if (stream->callback != NULL)
+    {
+      stream->callback(&stream->buffer[ready * stream->halfsize],
+                       stream->halfsize, seq, stream->arg);
+    }
+
+  stream->head = seq + 1;
+
+  /* Wake up the reader and any poll waiter */
+
+  if (stream->waiting)
+    {
+      stream->waiting = false;
+      nxsem_post(&stream->waitsem);
+    }
+
+  poll_notify(&stream->fds, 1, POLLIN);
+}
+
+/****************************************************************************
+ * Name: adc_stream_lookup
+ *
+ * Description:
+ *   Return the streaming state of an ADC, or NULL if it has none.
+ *
+ ****************************************************************************/
+
+static struct adc_stream_s *adc_stream_lookup(int intf)
+{
+  switch (intf)
+    {
+#ifdef ADC1_HAVE_STREAM
+      case 1:
+        return &g_adcstream1;
+#endif
+#ifdef ADC2_HAVE_STREAM
+      case 2:
+        return &g_adcstream2;
+#endif
+#ifdef ADC3_HAVE_STREAM
+      case 3:
+        return &g_adcstream3;
+#endif
+      default:
+        return NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: adc_stream_wait
+ *
+ * Description:
+ *   Wait for a block that has not been returned yet, and take the latest
+ *   completed one, which is the only one still intact.  The blocks skipped
+ *   are counted as lost.
+ *
+ * Input Parameters:
+ *   stream   - The streaming state
+ *   nonblock - Return -EAGAIN instead of waiting
+ *   seq      - Location to return the sequence number of the block
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   The stream lock is held.
+ *
+ ****************************************************************************/
+
+static int adc_stream_wait(struct adc_stream_s *stream, bool nonblock,
+                           uint32_t *seq)
+{
+  irqstate_t flags;
+  uint32_t head;
+  int ret = OK;
+
+  for (; ; )
+    {
+      head = stream->head;
+      if (head != stream->tail)
+        {
+          *seq          = head - 1;
+          stream->lost += head - 1 - stream->tail;
+          stream->tail  = head;
+          return OK;
+        }
+
+      if (nonblock)
+        {
+          return -EAGAIN;
+        }
+
+      /* Re-check with interrupts disabled so that a block completing now
+       * cannot be missed.
+       */
+
+      flags = enter_critical_section();
+      if (stream->head == stream->tail)
+        {
+          stream->waiting = true;
+          ret = nxsem_wait(&stream->waitsem);
+          stream->waiting = false;
+        }
+
+      leave_critical_section(flags);
+
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: adc_stream_open
+ *
+ * Description:
+ *   Open the streaming device.  The reader starts with the next block.
+ *
+ ****************************************************************************/
+
+static int adc_stream_open(struct file *filep)
+{
+  struct adc_stream_s *stream = filep->f_inode->i_private;
+  int ret;
+
+  ret = nxmutex_lock(&stream->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  stream->tail = stream->head;
+  stream->lost = 0;
+
+  nxmutex_unlock(&stream->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: adc_stream_read
+ *
+ * Description:
+ *   Copy the latest completed block to the user buffer.  Blocks until a
+ *   new block is available unless O_NONBLOCK is set.
+ *
+ ****************************************************************************/
+
+static ssize_t adc_stream_read(struct file *filep, char *buffer,
+                               size_t buflen)
+{
+  struct adc_stream_s *stream = filep->f_inode->i_private;
+  size_t blocksize;
+  uint32_t seq;
+  int ret;
+
+  ret = nxmutex_lock(&stream->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (; ; )
+    {
+      ret = adc_stream_wait(stream, (filep->f_oflags & O_NONBLOCK) != 0,
+                            &seq);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      blocksize = stream->halfsize * sizeof(uint16_t);
+      if (buflen < blocksize)
+        {
+          ret = -EINVAL;
+          break;
+        }
+
+      memcpy(buffer, &stream->buffer[(seq & 1) * stream->halfsize],
+             blocksize);
+
+      /* If the next block has been completed in the meantime, the DMA has
+       * been writing this one during the copy.
+       */
+
+      if (stream->head - seq > 1)
+        {
+          stream->lost++;
+          continue;
+        }
+
+      ret = blocksize;
+      break;
+    }
+
+  nxmutex_unlock(&stream->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: adc_stream_ioctl
+ *
+ * Description:
+ *   Handle the ANIOC_STM32L4_STREAM_* commands.
+ *
+ ****************************************************************************/
+
+static int adc_stream_ioctl(struct file *filep, int cmd, unsigned long arg)
+{
+  struct adc_stream_s *stream = filep->f_inode->i_private;
+  int ret;
+
+  ret = nxmutex_lock(&stream->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (cmd)
+    {
+      case ANIOC_STM32L4_STREAM_INFO:
+        {
+          struct stm32l4_adcstream_info_s *info =
+            (struct stm32l4_adcstream_info_s *)((uintptr_t)arg);
+
+          if (info == NULL)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          info->si_blocksize = stream->halfsize * sizeof(uint16_t);
+          info->si_bufsize   = sizeof(stream->buffer);
+          info->si_lost      = stream->lost;
+          info->si_nchannels = stream->nchannels;
+        }
+        break;
+
+      case ANIOC_STM32L4_STREAM_WAIT:
+        {
+          struct stm32l4_adcstream_block_s *block =
+            (struct stm32l4_adcstream_block_s *)((uintptr_t)arg);
+          uint32_t seq;
+
+          if (block == NULL)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          ret = adc_stream_wait(stream,
+                                (filep->f_oflags & O_NONBLOCK) != 0, &seq);
+          if (ret >= 0)
+            {
+              block->sb_seq    = seq;
+              block->sb_offset = (seq & 1) * stream->halfsize *
+                                 sizeof(uint16_t);
+            }
+        }
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  nxmutex_unlock(&stream->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: adc_stream_mmap
+ *
+ * Description:
+ *   Map the circular DMA buffer.
+ *
+ ****************************************************************************/
+
+static int adc_stream_mmap(struct file *filep, struct mm_map_entry_s *map)
+{
+  struct adc_stream_s *stream = filep->f_inode->i_private;
+
+  if (map->offset >= 0 && map->length > 0 &&
+      map->offset + map->length <= sizeof(stream->buffer))
+    {
+      map->vaddr = (char *)stream->buffer + map->offset;
+      return OK;
+    }
+
+  return -EINVAL;
+}
+
+/****************************************************************************
+ * Name: adc_stream_poll
+ *
+ * Description:
+ *   Set up or tear down a poll for completed blocks
+ *
+ ****************************************************************************/
+
+static int adc_stream_poll(struct file *filep, struct pollfd *fds,
+                           bool setup)
+{
+  struct adc_stream_s *stream = filep->f_inode->i_private;
+  irqstate_t flags;
+  int ret = OK;
+
+  flags = enter_critical_section();
+  if (setup)
+    {
+      if (stream->fds != NULL)
+        {
+          ret = -EBUSY;
+        }
+      else
+        {
+          stream->fds = fds;
+          fds->priv   = &stream->fds;
+
+          if (stream->head != stream->tail)
+            {
+              poll_notify(&stream->fds, 1, POLLIN);
+            }
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      stream->fds = NULL;
+      fds->priv   = NULL;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+#endif /* ADC_HAVE_STREAM */
+
 #ifdef CONFIG_STM32L4_ADC_LL_OPS
 
 /****************************************************************************
@@ -2695,6 +3569,10 @@ struct adc_dev_s *stm32l4_adc_initialize(int intf,
       case 2:
         {
           ainfo("ADC2 selected\n");
+#  ifdef ADC_HAVE_DUAL
+          aerr("ERROR: ADC2 is the slave of ADC1 in dual mode\n");
+          return NULL;
+#  endif
           cjchannels = CONFIG_STM32L4_ADC2_INJ_CHAN;
           crchannels = cchannels - cjchannels;
           ainfo("  Reg. chan: %d Inj chan: %d\n", crchannels, cjchannels);
@@ -2772,5 +3650,55 @@ struct adc_dev_s *stm32l4_adc_initialize(int intf,
   return dev;
 }
 
+#ifdef ADC_HAVE_STREAM
+/****************************************************************************
+ * Name: stm32l4_adc_stream_register
+ *
+ * Description:
+ *   Register the DMA streaming device of an ADC
+ *
+ ****************************************************************************/
+
+int stm32l4_adc_stream_register(const char *devpath, int intf)
+{
+  struct adc_stream_s *stream = adc_stream_lookup(intf);
+
+  if (stream == NULL)
+    {
+      aerr("ERROR: ADC%d has no DMA stream\n", intf);
+      return -ENODEV;
+    }
+
+  return register_driver(devpath, &g_adcstreamops, 0444, stream);
+}
+
+/****************************************************************************
+ * Name: stm32l4_adc_stream_callback
+ *
+ * Description:
+ *   Set the block callback of the stream of an ADC
+ *
+ ****************************************************************************/
+
+int stm32l4_adc_stream_callback(int intf, stm32l4_adcstream_cb_t callback,
+                                void *arg)
+{
+  struct adc_stream_s *stream = adc_stream_lookup(intf);
+  irqstate_t flags;
+
+  if (stream == NULL)
+    {
+      return -ENODEV;
+    }
+
+  flags = enter_critical_section();
+  stream->callback = callback;
+  stream->arg      = arg;
+  leave_critical_section(flags);
+
+  return OK;
+}
+#endif /* ADC_HAVE_STREAM */
+
 #endif /* CONFIG_STM32L4_ADC1 || CONFIG_STM32L4_ADC2 || CONFIG_STM32L4_ADC3 */
 #endif /* CONFIG_ADC */
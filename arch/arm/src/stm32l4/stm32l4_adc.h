@@ -161,6 +161,73 @@
 #  undef  ADC3_HAVE_DMA
 #endif
 
+/* DMA streaming support */
+
+#if defined(ADC1_HAVE_DMA) && defined(CONFIG_STM32L4_ADC1_STREAM)
+#  define ADC1_HAVE_STREAM 1
+#else
+#  undef  ADC1_HAVE_STREAM
+#endif
+
+#if defined(ADC2_HAVE_DMA) && defined(CONFIG_STM32L4_ADC2_STREAM)
+#  define ADC2_HAVE_STREAM 1
+#else
+#  undef  ADC2_HAVE_STREAM
+#endif
+
+#if defined(ADC3_HAVE_DMA) && defined(CONFIG_STM32L4_ADC3_STREAM)
+#  define ADC3_HAVE_STREAM 1
+#else
+#  undef  ADC3_HAVE_STREAM
+#endif
+
+#if defined(ADC1_HAVE_STREAM) || defined(ADC2_HAVE_STREAM) || \
+    defined(ADC3_HAVE_STREAM)
+#  define ADC_HAVE_STREAM 1
+#else
+#  undef  ADC_HAVE_STREAM
+#endif
+
+/* Dual interleaved mode: ADC1 is the master, ADC2 the slave, and the
+ * results of both are transferred by the DMA of ADC1.
+ */
+
+#if defined(CONFIG_STM32L4_ADC_DUAL) && defined(ADC1_HAVE_DMA) && \
+    defined(CONFIG_STM32L4_ADC2)
+#  define ADC_HAVE_DUAL 1
+#else
+#  undef  ADC_HAVE_DUAL
+#endif
+
+/* Hardware oversampling of the regular group.  CONFIG_STM32L4_ADCx_OVS_RATIO
+ * is the base 2 logarithm of the ratio; 0 disables oversampling.
+ */
+
+#define ADC_OVSCFG(ratio, shift) \
+        (ADC_CFGR2_ROVSE | (((ratio) - 1) << ADC_CFGR2_OVSR_SHIFT) | \
+         ADC_CFGR2_OVSS(shift))
+
+#if defined(CONFIG_STM32L4_ADC1_OVS_RATIO) && CONFIG_STM32L4_ADC1_OVS_RATIO > 0
+#  define ADC1_OVSCFG_VALUE \
+          ADC_OVSCFG(CONFIG_STM32L4_ADC1_OVS_RATIO, CONFIG_STM32L4_ADC1_OVS_SHIFT)
+#else
+#  define ADC1_OVSCFG_VALUE 0
+#endif
+
+#if defined(CONFIG_STM32L4_ADC2_OVS_RATIO) && CONFIG_STM32L4_ADC2_OVS_RATIO > 0
+#  define ADC2_OVSCFG_VALUE \
+          ADC_OVSCFG(CONFIG_STM32L4_ADC2_OVS_RATIO, CONFIG_STM32L4_ADC2_OVS_SHIFT)
+#else
+#  define ADC2_OVSCFG_VALUE 0
+#endif
+
+#if defined(CONFIG_STM32L4_ADC3_OVS_RATIO) && CONFIG_STM32L4_ADC3_OVS_RATIO > 0
+#  define ADC3_OVSCFG_VALUE \
+          ADC_OVSCFG(CONFIG_STM32L4_ADC3_OVS_RATIO, CONFIG_STM32L4_ADC3_OVS_SHIFT)
+#else
+#  define ADC3_OVSCFG_VALUE 0
+#endif
+
 /* Injected channels support */
 
 #if (defined(CONFIG_STM32L4_ADC1) && (CONFIG_STM32L4_ADC1_INJ_CHAN > 0)) || \
@@ -481,10 +548,41 @@
 #define ANIOC_STM32L4_TRIGGER_REG           _ANIOC(AN_STM32L4_FIRST + 0)
 #define ANIOC_STM32L4_TRIGGER_INJ           _ANIOC(AN_STM32L4_FIRST + 1)
 
+/* Set the hardware oversampling of the regular and injected groups.
+ * Argument: const struct stm32l4_adc_ovs_s * (see arch/chip/adc.h)
+ */
+
+#define ANIOC_STM32L4_OVERSAMPLE            _ANIOC(AN_STM32L4_FIRST + 4)
+
+/* ioctl commands of the DMA streaming device:
+ *
+ * ANIOC_STM32L4_STREAM_INFO - Get the block layout and the number of lost
+ *   blocks.  Argument: struct stm32l4_adcstream_info_s *
+ * ANIOC_STM32L4_STREAM_WAIT - Wait for the next completed block (or return
+ *   EAGAIN if none is pending and O_NONBLOCK is set) and return its
+ *   position in the buffer mapped with mmap().
+ *   Argument: struct stm32l4_adcstream_block_s *
+ */
+
+#define ANIOC_STM32L4_STREAM_INFO           _ANIOC(AN_STM32L4_FIRST + 2)
+#define ANIOC_STM32L4_STREAM_WAIT           _ANIOC(AN_STM32L4_FIRST + 3)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+#ifdef ADC_HAVE_STREAM
+/* Callback invoked from the DMA interrupt each time a block of the stream
+ * has been completed, i.e. at the half and at the end of the circular
+ * buffer.  'block' points to the 'nsamples' samples of block 'seq', which
+ * remain intact until the next call.
+ */
+
+typedef void (*stm32l4_adcstream_cb_t)(const uint16_t *block,
+                                       size_t nsamples, uint32_t seq,
+                                       void *arg);
+#endif
+
 #ifdef CONFIG_STM32L4_ADC_LL_OPS
 
 /* This structure provides the publicly visible representation of the
@@ -598,6 +696,52 @@ struct adc_dev_s;
 struct adc_dev_s *stm32l4_adc_initialize(int intf,
                                          const uint8_t *chanlist,
                                          int nchannels);
+
+#ifdef ADC_HAVE_STREAM
+/****************************************************************************
+ * Name: stm32l4_adc_stream_register
+ *
+ * Description:
+ *   Register the DMA streaming device of an ADC.  read() returns the
+ *   samples in blocks of raw uint16_t values (see arch/chip/adc.h); the
+ *   circular DMA buffer can also be mapped with mmap().
+ *
+ *   When streaming is enabled, samples no longer go through the upper half
+ *   driver.  The ADC character device must still be opened to power up
+ *   the ADC and start the conversions, and remains the interface for the
+ *   ADC ioctls.
+ *
+ * Input Parameters:
+ *   devpath - The full path to the device, e.g. "/dev/adcstream0"
+ *   intf    - ADC number, as passed to stm32l4_adc_initialize()
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure
+ *
+ ****************************************************************************/
+
+int stm32l4_adc_stream_register(const char *devpath, int intf);
+
+/****************************************************************************
+ * Name: stm32l4_adc_stream_callback
+ *
+ * Description:
+ *   Set (or clear, with a NULL callback) the function called from the DMA
+ *   interrupt each time a block of the stream has been completed.
+ *
+ * Input Parameters:
+ *   intf     - ADC number, as passed to stm32l4_adc_initialize()
+ *   callback - The block callback
+ *   arg      - Argument passed to the callback
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure
+ *
+ ****************************************************************************/
+
+int stm32l4_adc_stream_callback(int intf, stm32l4_adcstream_cb_t callback,
+                                void *arg);
+#endif
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -40,6 +40,7 @@
 #include "mpu.h"
 #include "arm_internal.h"
 #include "stm32l4_mpuinit.h"
+#include "stm32l4_sramheap.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -99,8 +100,14 @@
 
 /* Set the range of SRAM2 as well, requires a second memory region */
 
-#define SRAM2_START  STM32L4_SRAM2_BASE
-#define SRAM2_END    (SRAM2_START + STM32L4_SRAM2_SIZE)
+#if defined(CONFIG_STM32L4_MPU_MEMMAP)
+#  define SRAM2_START  ((uintptr_t)_esram2_fast)
+#elif defined(CONFIG_STM32L4_RAMFUNCS)
+#  define SRAM2_START  ((uintptr_t)_eramfuncs)
+#else
+#  define SRAM2_START  STM32L4_SRAM2_BASE
+#endif
+#define SRAM2_END    (STM32L4_SRAM2_BASE + STM32L4_SRAM2_SIZE)
 
 /* Set the range of SRAM3, requiring a third memory region */
 
@@ -109,19 +116,31 @@
 #  define SRAM3_END    (SRAM3_START + STM32L4_SRAM3_SIZE)
 #endif
 
+/* SRAM2 and SRAM3 are regions of the user heap unless they have heaps of
+ * their own.
+ */
+
+#if defined(CONFIG_STM32L4_SRAM2_HEAP) && !defined(HAVE_SRAM2_HEAP)
+#  define HAVE_SRAM2_REGION 1
+#endif
+
+#if defined(CONFIG_STM32L4_SRAM3_HEAP) && !defined(HAVE_SRAM3_HEAP)
+#  define HAVE_SRAM3_REGION 1
+#endif
+
 /* Some sanity checking.  If multiple memory regions are defined, verify
  * that CONFIG_MM_REGIONS is set to match the number of memory regions
  * that we have been asked to add to the heap.
  */
 
-#if CONFIG_MM_REGIONS < defined(CONFIG_STM32L4_SRAM2_HEAP) + \
-                        defined(CONFIG_STM32L4_SRAM3_HEAP) + \
+#if CONFIG_MM_REGIONS < defined(HAVE_SRAM2_REGION) + \
+                        defined(HAVE_SRAM3_REGION) + \
                         defined(CONFIG_STM32L4_FSMC_SRAM_HEAP) + 1
 #  error "You need more memory manager regions to support selected heap components"
 #endif
 
-#if CONFIG_MM_REGIONS > defined(CONFIG_STM32L4_SRAM2_HEAP) + \
-                        defined(CONFIG_STM32L4_SRAM3_HEAP) + \
+#if CONFIG_MM_REGIONS > defined(HAVE_SRAM2_REGION) + \
+                        defined(HAVE_SRAM3_REGION) + \
                         defined(CONFIG_STM32L4_FSMC_SRAM_HEAP) + 1
 #  warning "CONFIG_MM_REGIONS large enough but I do not know what some of the region(s) are"
 #endif
@@ -163,6 +182,32 @@ static inline void up_heap_color(void *start, size_t size)
 #  define up_heap_color(start,size)
 #endif
 
+/****************************************************************************
+ * Name: stm32l4_sramheap_initialize
+ *
+ * Description:
+ *   Create the heaps of SRAM2 and SRAM3 when they are not regions of the
+ *   user heap.  See stm32l4_sramheap.h.
+ *
+ ****************************************************************************/
+
+#if defined(HAVE_SRAM2_HEAP) || defined(HAVE_SRAM3_HEAP)
+static void stm32l4_sramheap_initialize(void)
+{
+#ifdef HAVE_SRAM2_HEAP
+  up_heap_color((void *)SRAM2_START, SRAM2_END - SRAM2_START);
+  g_sram2_heap = mm_initialize("sram2", (void *)SRAM2_START,
+                               SRAM2_END - SRAM2_START);
+#endif
+
+#ifdef HAVE_SRAM3_HEAP
+  up_heap_color((void *)SRAM3_START, SRAM3_END - SRAM3_START);
+  g_sram3_heap = mm_initialize("sram3", (void *)SRAM3_START,
+                               SRAM3_END - SRAM3_START);
+#endif
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -251,6 +296,14 @@ void up_allocate_heap(void **heap_start, size_t *heap_size)
   /* Colorize the heap for debug */
 
   up_heap_color(*heap_start, *heap_size);
+
+#if defined(HAVE_SRAM2_HEAP) || defined(HAVE_SRAM3_HEAP)
+  /* SRAM2 and SRAM3 get their heaps together with the user heap, before
+   * anything is allocated.
+   */
+
+  stm32l4_sramheap_initialize();
+#endif
 #endif
 }
 
@@ -311,7 +364,7 @@ void up_allocate_kheap(void **heap_start, size_t *heap_size)
 #if CONFIG_MM_REGIONS > 1
 void arm_addregion(void)
 {
-#ifdef CONFIG_STM32L4_SRAM2_HEAP
+#ifdef HAVE_SRAM2_REGION
 
 #if defined(CONFIG_BUILD_PROTECTED) && defined(CONFIG_MM_KERNEL_HEAP)
 
@@ -330,7 +383,7 @@ void arm_addregion(void)
 
 #endif /* SRAM2 */
 
-#ifdef CONFIG_STM32L4_SRAM3_HEAP
+#ifdef HAVE_SRAM3_REGION
 
 #if defined(CONFIG_BUILD_PROTECTED) && defined(CONFIG_MM_KERNEL_HEAP)
 
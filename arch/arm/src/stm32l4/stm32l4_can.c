@@ -28,6 +28,9 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
@@ -36,8 +39,15 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/can/can.h>
+#ifdef CONFIG_STM32L4_CAN_RXRING
+#  include <nuttx/fs/fs.h>
+#  include <nuttx/mutex.h>
+#  include <nuttx/semaphore.h>
+#  include <arch/chip/can.h>
+#endif
 
 #include "arm_internal.h"
+#include "barriers.h"
 #include "chip.h"
 #include "stm32l4.h"
 #include "stm32l4_can.h"
@@ -66,6 +76,15 @@
 #  undef CONFIG_STM32L4_CAN_REGDEBUG
 #endif
 
+/* RX ring ******************************************************************/
+
+#ifdef CONFIG_STM32L4_CAN_RXRING
+#  define CAN_RXRING_MASK (CONFIG_STM32L4_CAN_RXRING_SIZE - 1)
+#  if (CONFIG_STM32L4_CAN_RXRING_SIZE & CAN_RXRING_MASK) != 0
+#    error "CONFIG_STM32L4_CAN_RXRING_SIZE must be a power of two"
+#  endif
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -79,8 +98,39 @@ struct stm32l4_can_s
   uint32_t base;     /* Base address of the CAN control registers */
   uint32_t fbase;    /* Base address of the CAN filter registers */
   uint32_t baud;     /* Configured baud */
+
+  /* Acceptance filters, compiled into the filter banks */
+
+  struct stm32l4_canfilter_s filters[CONFIG_STM32L4_CAN_MAXFILTERS];
 };
 
+#ifdef CONFIG_STM32L4_CAN_RXRING
+/* Single-producer, single-consumer ring of received frames for one RX FIFO.
+ * head is only written by the RX interrupt handler and tail only by the
+ * reader, so no lock is needed between the two.  Both are free running;
+ * head - tail is the number of frames in the ring.
+ */
+
+struct stm32l4_canring_s
+{
+  volatile uint16_t head;  /* Next slot to fill (RX ISR) */
+  volatile uint16_t tail;  /* Next slot to read (reader) */
+  bool lost;               /* Frames were dropped since the last store */
+  struct stm32l4_canframe_s frame[CONFIG_STM32L4_CAN_RXRING_SIZE];
+};
+
+/* State of the RX ring character device */
+
+struct stm32l4_canraw_s
+{
+  struct stm32l4_canring_s ring[2];  /* One ring per RX FIFO */
+  volatile bool waiting;             /* A reader waits for frames */
+  sem_t waitsem;                     /* Posted when frames arrive */
+  mutex_t lock;                      /* Serializes readers */
+  struct pollfd *fds;                /* Poll waiter */
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -108,8 +158,14 @@ static void stm32l4can_dumpfiltregs(struct stm32l4_can_s *priv,
 #  define stm32l4can_dumpfiltregs(priv,msg)
 #endif
 
-/* Filtering (todo) */
+/* Filtering */
 
+static int  stm32l4can_setfilters(struct stm32l4_can_s *priv);
+static int  stm32l4can_addfilter(struct stm32l4_can_s *priv,
+                                 uint32_t id1, uint32_t id2, uint8_t type,
+                                 uint8_t prio, uint8_t flags);
+static int  stm32l4can_delfilter(struct stm32l4_can_s *priv, int arg,
+                                 uint8_t flags);
 #ifdef CONFIG_CAN_EXTID
 static int  stm32l4can_addextfilter(struct stm32l4_can_s *priv,
                                     struct canioc_extfilter_s *arg);
@@ -155,6 +211,19 @@ static int  stm32l4can_bittiming(struct stm32l4_can_s *priv);
 static int  stm32l4can_cellinit(struct stm32l4_can_s *priv);
 static int  stm32l4can_filterinit(struct stm32l4_can_s *priv);
 
+/* RX ring */
+
+#ifdef CONFIG_STM32L4_CAN_RXRING
+static void stm32l4can_ringreceive(struct stm32l4_can_s *priv, int rxmb);
+static size_t stm32l4can_ringdrain(struct stm32l4_canring_s *ring,
+                                   struct stm32l4_canframe_s *frame,
+                                   size_t nframes);
+static ssize_t stm32l4can_rawread(struct file *filep, char *buffer,
+                                  size_t buflen);
+static int  stm32l4can_rawpoll(struct file *filep, struct pollfd *fds,
+                               bool setup);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -196,6 +265,27 @@ static struct can_dev_s g_can1dev =
 };
 #endif
 
+#ifdef CONFIG_STM32L4_CAN_RXRING
+static const struct file_operations g_canrawops =
+{
+  NULL,                /* open */
+  NULL,                /* close */
+  stm32l4can_rawread,  /* read */
+  NULL,                /* write */
+  NULL,                /* seek */
+  NULL,                /* ioctl */
+  NULL,                /* mmap */
+  NULL,                /* truncate */
+  stm32l4can_rawpoll,  /* poll */
+};
+
+static struct stm32l4_canraw_s g_can1raw =
+{
+  .waitsem          = SEM_INITIALIZER(0),
+  .lock             = NXMUTEX_INITIALIZER,
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -1016,9 +1106,6 @@ static int stm32l4can_ioctl(struct can_dev_s *dev, int cmd,
 
       case CANIOC_DEL_EXTFILTER:
         {
-#if 0 /* Unimplemented */
-          DEBUGASSERT(arg <= priv->config->nextfilters);
-#endif
           ret = stm32l4can_delextfilter(priv, (int)arg);
         }
         break;
@@ -1053,9 +1140,6 @@ static int stm32l4can_ioctl(struct can_dev_s *dev, int cmd,
 
       case CANIOC_DEL_STDFILTER:
         {
-#if 0 /* Unimplemented */
-          DEBUGASSERT(arg <= priv->config->nstdfilters);
-#endif
           ret = stm32l4can_delstdfilter(priv, (int)arg);
         }
         break;
@@ -1395,6 +1479,13 @@ static int stm32l4can_rxinterrupt(int irq, void *context, int rxmb)
   dev = &g_can1dev;
   priv = dev->cd_priv;
 
+#ifdef CONFIG_STM32L4_CAN_RXRING
+  /* Frames bypass the upper half and go to the RX ring */
+
+  stm32l4can_ringreceive(priv, rxmb);
+  return OK;
+#endif
+
   /* Verify that a message is pending in the FIFO */
 
   regval   = stm32l4can_getreg(priv, STM32L4_CAN_RFR_OFFSET(rxmb));
@@ -1485,6 +1576,120 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: stm32l4can_ringreceive
+ *
+ * Description:
+ *   Move all frames pending in an RX FIFO into its RX ring and wake up the
+ *   reader.  Called from the RX FIFO 0/1 interrupt handlers.
+ *
+ * Input Parameters:
+ *   priv - A pointer to the private data structure for this CAN block
+ *   rxmb - The RX FIFO number.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_CAN_RXRING
+static void stm32l4can_ringreceive(struct stm32l4_can_s *priv, int rxmb)
+{
+  struct stm32l4_canraw_s *raw = &g_can1raw;
+  struct stm32l4_canring_s *ring = &raw->ring[rxmb];
+  struct stm32l4_canframe_s *frame;
+  uint32_t regval;
+  uint32_t rfr;
+  uint16_t head;
+
+  rfr = stm32l4can_getreg(priv, STM32L4_CAN_RFR_OFFSET(rxmb));
+  while ((rfr & CAN_RFR_FMP_MASK) != 0)
+    {
+      /* A hardware FIFO overrun also counts as lost frames */
+
+      if ((rfr & CAN_RFR_FOVR) != 0)
+        {
+          ring->lost = true;
+        }
+
+      head = ring->head;
+      if ((uint16_t)(head - ring->tail) < CONFIG_STM32L4_CAN_RXRING_SIZE)
+        {
+          frame = &ring->frame[head & CAN_RXRING_MASK];
+
+          regval = stm32l4can_getreg(priv, STM32L4_CAN_RIR_OFFSET(rxmb));
+          if ((regval & CAN_RIR_IDE) != 0)
+            {
+              frame->cf_id    = (regval & CAN_RIR_EXID_MASK) >>
+                                CAN_RIR_EXID_SHIFT;
+              frame->cf_flags = STM32L4_CANFRAME_EXTID;
+            }
+          else
+            {
+              frame->cf_id    = (regval & CAN_RIR_STID_MASK) >>
+                                CAN_RIR_STID_SHIFT;
+              frame->cf_flags = 0;
+            }
+
+          if ((regval & CAN_RIR_RTR) != 0)
+            {
+              frame->cf_flags |= STM32L4_CANFRAME_RTR;
+            }
+
+          if (rxmb != 0)
+            {
+              frame->cf_flags |= STM32L4_CANFRAME_FIFO1;
+            }
+
+          if (ring->lost)
+            {
+              frame->cf_flags |= STM32L4_CANFRAME_OVERRUN;
+              ring->lost = false;
+            }
+
+          /* The timestamp is captured by the TTCM timer at SOF */
+
+          regval = stm32l4can_getreg(priv, STM32L4_CAN_RDTR_OFFSET(rxmb));
+          frame->cf_dlc = (regval & CAN_RDTR_DLC_MASK) >> CAN_RDTR_DLC_SHIFT;
+          frame->cf_ts  = (regval & CAN_RDTR_TIME_MASK) >>
+                          CAN_RDTR_TIME_SHIFT;
+
+          /* RDLR/RDHR hold the data bytes in little-endian order */
+
+          regval = stm32l4can_getreg(priv, STM32L4_CAN_RDLR_OFFSET(rxmb));
+          memcpy(&frame->cf_data[0], &regval, 4);
+          regval = stm32l4can_getreg(priv, STM32L4_CAN_RDHR_OFFSET(rxmb));
+          memcpy(&frame->cf_data[4], &regval, 4);
+
+          /* Publish the frame only after it has been written completely */
+
+          ARM_DMB();
+          ring->head = head + 1;
+        }
+      else
+        {
+          ring->lost = true;
+        }
+
+      /* Release the FIFO output mailbox; this also clears FOVR */
+
+      stm32l4can_putreg(priv, STM32L4_CAN_RFR_OFFSET(rxmb),
+                        rfr | CAN_RFR_RFOM);
+      rfr = stm32l4can_getreg(priv, STM32L4_CAN_RFR_OFFSET(rxmb));
+    }
+
+  /* Wake up the reader and any poll waiter */
+
+  if (raw->waiting)
+    {
+      raw->waiting = false;
+      nxsem_post(&raw->waitsem);
+    }
+
+  poll_notify(&raw->fds, 1, POLLIN);
+}
+#endif
+
 /****************************************************************************
  * Name: stm32l4can_rx0interrupt
  *
@@ -1757,6 +1962,174 @@ static int stm32l4can_bittiming(struct stm32l4_can_s *priv)
   return OK;
 }
 
+/****************************************************************************
+ * Name: stm32l4can_ringdrain
+ *
+ * Description:
+ *   Copy up to nframes frames out of an RX ring
+ *
+ * Returned Value:
+ *   The number of frames copied
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_CAN_RXRING
+static size_t stm32l4can_ringdrain(struct stm32l4_canring_s *ring,
+                                   struct stm32l4_canframe_s *frame,
+                                   size_t nframes)
+{
+  uint16_t tail = ring->tail;
+  size_t avail = (uint16_t)(ring->head - tail);
+  size_t first;
+  size_t n;
+
+  n = avail < nframes ? avail : nframes;
+  if (n == 0)
+    {
+      return 0;
+    }
+
+  /* Order the frame reads after the head read */
+
+  ARM_DMB();
+
+  /* Copy at most two contiguous runs */
+
+  first = CONFIG_STM32L4_CAN_RXRING_SIZE - (tail & CAN_RXRING_MASK);
+  if (first > n)
+    {
+      first = n;
+    }
+
+  memcpy(frame, &ring->frame[tail & CAN_RXRING_MASK],
+         first * sizeof(struct stm32l4_canframe_s));
+  memcpy(frame + first, &ring->frame[0],
+         (n - first) * sizeof(struct stm32l4_canframe_s));
+
+  ARM_DMB();
+  ring->tail = tail + n;
+  return n;
+}
+#endif
+
+/****************************************************************************
+ * Name: stm32l4can_rawread
+ *
+ * Description:
+ *   Read as many whole frames as fit in the user buffer, FIFO 0 first.
+ *   Blocks until at least one frame is available unless O_NONBLOCK is set.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_CAN_RXRING
+static ssize_t stm32l4can_rawread(struct file *filep, char *buffer,
+                                  size_t buflen)
+{
+  struct stm32l4_canraw_s *raw = filep->f_inode->i_private;
+  struct stm32l4_canframe_s *frame = (struct stm32l4_canframe_s *)buffer;
+  size_t nframes = buflen / sizeof(struct stm32l4_canframe_s);
+  irqstate_t flags;
+  size_t n;
+  int ret;
+
+  if (nframes == 0)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&raw->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (; ; )
+    {
+      n  = stm32l4can_ringdrain(&raw->ring[0], frame, nframes);
+      n += stm32l4can_ringdrain(&raw->ring[1], frame + n, nframes - n);
+      if (n > 0)
+        {
+          break;
+        }
+
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          ret = -EAGAIN;
+          break;
+        }
+
+      /* Re-check with interrupts disabled so that a frame arriving now
+       * cannot be missed.
+       */
+
+      flags = enter_critical_section();
+      if (raw->ring[0].head == raw->ring[0].tail &&
+          raw->ring[1].head == raw->ring[1].tail)
+        {
+          raw->waiting = true;
+          ret = nxsem_wait(&raw->waitsem);
+          raw->waiting = false;
+        }
+
+      leave_critical_section(flags);
+
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  nxmutex_unlock(&raw->lock);
+  return n > 0 ? n * sizeof(struct stm32l4_canframe_s) : ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: stm32l4can_rawpoll
+ *
+ * Description:
+ *   Set up or tear down a poll for received frames
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_CAN_RXRING
+static int stm32l4can_rawpoll(struct file *filep, struct pollfd *fds,
+                              bool setup)
+{
+  struct stm32l4_canraw_s *raw = filep->f_inode->i_private;
+  irqstate_t flags;
+  int ret = OK;
+
+  flags = enter_critical_section();
+  if (setup)
+    {
+      if (raw->fds != NULL)
+        {
+          ret = -EBUSY;
+        }
+      else
+        {
+          raw->fds  = fds;
+          fds->priv = &raw->fds;
+
+          if (raw->ring[0].head != raw->ring[0].tail ||
+              raw->ring[1].head != raw->ring[1].tail)
+            {
+              poll_notify(&raw->fds, 1, POLLIN);
+            }
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      raw->fds  = NULL;
+      fds->priv = NULL;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: stm32l4can_enterinitmode
  *
@@ -1901,11 +2274,17 @@ static int stm32l4can_cellinit(struct stm32l4_can_s *priv)
    *  - No automatic retransmission
    *  - Receive FIFO locked mode
    *  - Transmit FIFO priority
+   *
+   * Time triggered communication mode is enabled instead when the RX ring
+   * is used, so that the hardware timestamps every received frame.
    */
 
   regval   = stm32l4can_getreg(priv, STM32L4_CAN_MCR_OFFSET);
   regval &= ~(CAN_MCR_TXFP | CAN_MCR_RFLM | CAN_MCR_NART |
               CAN_MCR_AWUM | CAN_MCR_ABOM | CAN_MCR_TTCM);
+#ifdef CONFIG_STM32L4_CAN_RXRING
+  regval |= CAN_MCR_TTCM;
+#endif
   stm32l4can_putreg(priv, STM32L4_CAN_MCR_OFFSET, regval);
 
   /* Configure bit timing. */
@@ -1924,8 +2303,8 @@ static int stm32l4can_cellinit(struct stm32l4_can_s *priv)
  * Name: stm32l4can_filterinit
  *
  * Description:
- *   CAN filter initialization.  CAN filters are not currently used by this
- *   driver.  The CAN filters can be configured in a different way:
+ *   CAN filter initialization.  The CAN filters can be configured in a
+ *   different way:
  *
  *   1. As a match of specific IDs in a list (IdList mode), or as
  *   2. And ID and a mask (IdMask mode).
@@ -1940,9 +2319,11 @@ static int stm32l4can_cellinit(struct stm32l4_can_s *priv)
  *   contains one CAN device. If one day some STM32L4 has 2 CANs, then
  *   code will have to be imported from the STM32 port.
  *
- *   32-bit IdMask mode is configured.  However, both the ID and the MASK
- *   are set to zero thus suppressing all filtering because anything masked
- *   with zero matches zero.
+ *   The filters added with CANIOC_ADD_STDFILTER and CANIOC_ADD_EXTFILTER
+ *   are compiled into the banks by stm32l4can_compilefilters().  Without
+ *   any, one bank is set up in 32-bit IdMask mode with both the ID and the
+ *   MASK set to zero, thus suppressing all filtering because anything
+ *   masked with zero matches zero.
  *
  * Input Parameters:
  *   priv - A pointer to the private data structure for this CAN block
@@ -1954,64 +2335,150 @@ static int stm32l4can_cellinit(struct stm32l4_can_s *priv)
 
 static int stm32l4can_filterinit(struct stm32l4_can_s *priv)
 {
-  uint32_t regval;
-  uint32_t bitmask;
-
   caninfo("CAN%d filter: %d\n", priv->port, priv->filter);
 
-  /* Get the bitmask associated with the filter used by this CAN block */
+  return stm32l4can_setfilters(priv);
+}
+
+/****************************************************************************
+ * Name: stm32l4can_setfilters
+ *
+ * Description:
+ *   Compile the acceptance filters in use and program the filter banks.
+ *   The banks are left unchanged if the filters do not fit.
+ *
+ * Input Parameters:
+ *   priv - A pointer to the private data structure for this CAN block
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int stm32l4can_setfilters(struct stm32l4_can_s *priv)
+{
+  struct stm32l4_canbank_s banks[CAN_NFILTERS];
+  int nbanks;
 
-  bitmask = (uint32_t)1 << priv->filter;
+  nbanks = stm32l4can_compilefilters(priv->filters,
+                                     CONFIG_STM32L4_CAN_MAXFILTERS,
+                                     banks, CAN_NFILTERS);
+  if (nbanks < 0)
+    {
+      return nbanks;
+    }
 
-  /* Enter filter initialization mode */
+  if (nbanks == 0)
+    {
+      /* No filter: accept all frames in FIFO 0 */
 
-  regval  = stm32l4can_getfreg(priv, STM32L4_CAN_FMR_OFFSET);
-  regval |= CAN_FMR_FINIT;
-  stm32l4can_putfreg(priv, STM32L4_CAN_FMR_OFFSET, regval);
+      banks[0].fr1   = 0;
+      banks[0].fr2   = 0;
+      banks[0].flags = STM32L4_CANBANK_32BIT;
+      nbanks         = 1;
+    }
 
-  /* Disable the filter */
+  stm32l4can_programbanks(priv->fbase, banks, nbanks);
+  return OK;
+}
 
-  regval  = stm32l4can_getfreg(priv, STM32L4_CAN_FA1R_OFFSET);
-  regval &= ~bitmask;
-  stm32l4can_putfreg(priv, STM32L4_CAN_FA1R_OFFSET, regval);
+/****************************************************************************
+ * Name: stm32l4can_addfilter
+ *
+ * Description:
+ *   Add an acceptance filter and reprogram the filter banks
+ *
+ * Input Parameters:
+ *   priv  - A pointer to the private data structure for this CAN block
+ *   id1   - ID; first ID of a dual match or of a range
+ *   id2   - Mask; second ID of a dual match or last ID of a range
+ *   type  - See CAN_FILTER_* definitions
+ *   prio  - See CAN_MSGPRIO_* definitions.  CAN_MSGPRIO_HIGH frames go to
+ *           RX FIFO 0, the others to RX FIFO 1.
+ *   flags - STM32L4_CANFILTER_EXT for extended IDs
+ *
+ * Returned Value:
+ *   A non-negative filter ID on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
 
-  /* Select the 32-bit scale for the filter */
+static int stm32l4can_addfilter(struct stm32l4_can_s *priv,
+                                uint32_t id1, uint32_t id2, uint8_t type,
+                                uint8_t prio, uint8_t flags)
+{
+  struct stm32l4_canfilter_s *filter;
+  int ret;
+  int i;
 
-  regval  = stm32l4can_getfreg(priv, STM32L4_CAN_FS1R_OFFSET);
-  regval |= bitmask;
-  stm32l4can_putfreg(priv, STM32L4_CAN_FS1R_OFFSET, regval);
+  for (i = 0; i < CONFIG_STM32L4_CAN_MAXFILTERS; i++)
+    {
+      if ((priv->filters[i].flags & STM32L4_CANFILTER_USED) == 0)
+        {
+          break;
+        }
+    }
 
-  /* There are 14 or 28 filter banks (depending) on the device.
-   * Each filter bank is composed of two 32-bit registers, CAN_FiR:
-   */
+  if (i >= CONFIG_STM32L4_CAN_MAXFILTERS)
+    {
+      return -ENOSPC;
+    }
 
-  stm32l4can_putfreg(priv, STM32L4_CAN_FIR_OFFSET(priv->filter, 1), 0);
-  stm32l4can_putfreg(priv, STM32L4_CAN_FIR_OFFSET(priv->filter, 2), 0);
+  filter        = &priv->filters[i];
+  filter->id1   = id1;
+  filter->id2   = id2;
+  filter->type  = type;
+  filter->flags = flags | STM32L4_CANFILTER_USED;
 
-  /* Set Id/Mask mode for the filter */
+  if (prio != CAN_MSGPRIO_HIGH)
+    {
+      filter->flags |= STM32L4_CANFILTER_FIFO1;
+    }
 
-  regval  = stm32l4can_getfreg(priv, STM32L4_CAN_FM1R_OFFSET);
-  regval &= ~bitmask;
-  stm32l4can_putfreg(priv, STM32L4_CAN_FM1R_OFFSET, regval);
+  ret = stm32l4can_setfilters(priv);
+  if (ret < 0)
+    {
+      filter->flags = 0;
+      return ret;
+    }
 
-  /* Assign FIFO 0 for the filter */
+  return i;
+}
 
-  regval  = stm32l4can_getfreg(priv, STM32L4_CAN_FFA1R_OFFSET);
-  regval &= ~bitmask;
-  stm32l4can_putfreg(priv, STM32L4_CAN_FFA1R_OFFSET, regval);
+/****************************************************************************
+ * Name: stm32l4can_delfilter
+ *
+ * Description:
+ *   Remove an acceptance filter and reprogram the filter banks
+ *
+ * Input Parameters:
+ *   priv  - A pointer to the private data structure for this CAN block
+ *   arg   - The filter ID returned by stm32l4can_addfilter()
+ *   flags - STM32L4_CANFILTER_EXT for extended IDs
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
 
-  /* Enable the filter */
+static int stm32l4can_delfilter(struct stm32l4_can_s *priv, int arg,
+                                uint8_t flags)
+{
+  struct stm32l4_canfilter_s *filter;
 
-  regval  = stm32l4can_getfreg(priv, STM32L4_CAN_FA1R_OFFSET);
-  regval |= bitmask;
-  stm32l4can_putfreg(priv, STM32L4_CAN_FA1R_OFFSET, regval);
+  if (arg < 0 || arg >= CONFIG_STM32L4_CAN_MAXFILTERS)
+    {
+      return -EINVAL;
+    }
 
-  /* Exit filter initialization mode */
+  filter = &priv->filters[arg];
+  if ((filter->flags & STM32L4_CANFILTER_USED) == 0 ||
+      (filter->flags & STM32L4_CANFILTER_EXT) != flags)
+    {
+      return -EINVAL;
+    }
 
-  regval  = stm32l4can_getfreg(priv, STM32L4_CAN_FMR_OFFSET);
-  regval &= ~CAN_FMR_FINIT;
-  stm32l4can_putfreg(priv, STM32L4_CAN_FMR_OFFSET, regval);
-  return OK;
+  filter->flags = 0;
+  return stm32l4can_setfilters(priv);
 }
 
 /****************************************************************************
@@ -2035,7 +2502,8 @@ static int stm32l4can_filterinit(struct stm32l4_can_s *priv)
 static int stm32l4can_addextfilter(struct stm32l4_can_s *priv,
                                    struct canioc_extfilter_s *arg)
 {
-  return -ENOTTY;
+  return stm32l4can_addfilter(priv, arg->xf_id1, arg->xf_id2, arg->xf_type,
+                              arg->xf_prio, STM32L4_CANFILTER_EXT);
 }
 #endif
 
@@ -2060,7 +2528,7 @@ static int stm32l4can_addextfilter(struct stm32l4_can_s *priv,
 #ifdef CONFIG_CAN_EXTID
 static int stm32l4can_delextfilter(struct stm32l4_can_s *priv, int arg)
 {
-  return -ENOTTY;
+  return stm32l4can_delfilter(priv, arg, STM32L4_CANFILTER_EXT);
 }
 #endif
 
@@ -2084,7 +2552,8 @@ static int stm32l4can_delextfilter(struct stm32l4_can_s *priv, int arg)
 static int stm32l4can_addstdfilter(struct stm32l4_can_s *priv,
                                    struct canioc_stdfilter_s *arg)
 {
-  return -ENOTTY;
+  return stm32l4can_addfilter(priv, arg->sf_id1, arg->sf_id2, arg->sf_type,
+                              arg->sf_prio, 0);
 }
 
 /****************************************************************************
@@ -2107,7 +2576,7 @@ static int stm32l4can_addstdfilter(struct stm32l4_can_s *priv,
 
 static int stm32l4can_delstdfilter(struct stm32l4_can_s *priv, int arg)
 {
-  return -ENOTTY;
+  return stm32l4can_delfilter(priv, arg, 0);
 }
 
 /****************************************************************************
@@ -2162,4 +2631,27 @@ struct can_dev_s *stm32l4can_initialize(int port)
   return dev;
 }
 
+/****************************************************************************
+ * Name: stm32l4can_rxring_register
+ *
+ * Description:
+ *   Register the RX ring character device of the selected CAN port
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_CAN_RXRING
+int stm32l4can_rxring_register(const char *devpath, int port)
+{
+#ifdef CONFIG_STM32L4_CAN1
+  if (port == 1)
+    {
+      return register_driver(devpath, &g_canrawops, 0444, &g_can1raw);
+    }
+#endif
+
+  canerr("ERROR: Unsupported port %d\n", port);
+  return -ENODEV;
+}
+#endif
+
 #endif /* CONFIG_CAN && (CONFIG_STM32L4_CAN1 || CONFIG_STM32L4_CAN2) */
@@ -44,7 +44,7 @@
 #  undef CONFIG_STM32L4_CAN1
 #endif
 
-#if defined(CONFIG_CAN) && defined(CONFIG_STM32L4_CAN1)
+#ifdef CONFIG_STM32L4_CAN1
 
 /* CAN BAUD */
 
@@ -75,12 +75,45 @@
 #  error "CONFIG_STM32L4_CAN_TSEG2 is out of range"
 #endif
 
+/* Acceptance filter flags (struct stm32l4_canfilter_s) */
+
+#define STM32L4_CANFILTER_USED     (1 << 0) /* Filter in use */
+#define STM32L4_CANFILTER_EXT      (1 << 1) /* Extended (29-bit) IDs */
+#define STM32L4_CANFILTER_RTR      (1 << 2) /* RTR value to match... */
+#define STM32L4_CANFILTER_RTRMASK  (1 << 3) /* ...if the RTR bit is matched */
+#define STM32L4_CANFILTER_FIFO1    (1 << 4) /* Matching frames go to FIFO 1 */
+
+/* Filter bank flags (struct stm32l4_canbank_s) */
+
+#define STM32L4_CANBANK_32BIT      (1 << 0) /* 32-bit scale, else 16-bit */
+#define STM32L4_CANBANK_LIST       (1 << 1) /* IdList mode, else IdMask */
+#define STM32L4_CANBANK_FIFO1      (1 << 2) /* Assigned to FIFO 1 */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
 #ifndef __ASSEMBLY__
 
+/* An acceptance filter, as requested by the application */
+
+struct stm32l4_canfilter_s
+{
+  uint32_t id1;    /* ID; first ID of a dual match or of a range */
+  uint32_t id2;    /* Mask; second ID of a dual match, or last of a range */
+  uint8_t  type;   /* CAN_FILTER_MASK, CAN_FILTER_DUAL or CAN_FILTER_RANGE */
+  uint8_t  flags;  /* See STM32L4_CANFILTER_* definitions */
+};
+
+/* The contents of a filter bank */
+
+struct stm32l4_canbank_s
+{
+  uint32_t fr1;    /* CAN_FiR1 */
+  uint32_t fr2;    /* CAN_FiR2 */
+  uint8_t  flags;  /* See STM32L4_CANBANK_* definitions */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -98,11 +131,59 @@ extern "C"
  * Public Functions Prototypes
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: stm32l4can_compilefilters
+ *
+ * Description:
+ *   Compile a set of acceptance filters into as few filter banks as
+ *   possible, mixing 16- and 32-bit banks in IdList and IdMask modes, with
+ *   separate banks for each RX FIFO.
+ *
+ * Input Parameters:
+ *   filters  - The filters; entries without STM32L4_CANFILTER_USED are
+ *              skipped.
+ *   nfilters - Number of entries in filters.
+ *   banks    - Receives the filter banks.
+ *   nbanks   - Number of available banks.
+ *
+ * Returned Value:
+ *   The number of banks used on success; -EINVAL if a filter is invalid,
+ *   or -ENOSPC if the filters do not fit in the available banks.
+ *
+ ****************************************************************************/
+
+int stm32l4can_compilefilters(const struct stm32l4_canfilter_s *filters,
+                              int nfilters, struct stm32l4_canbank_s *banks,
+                              int nbanks);
+
+/****************************************************************************
+ * Name: stm32l4can_programbanks
+ *
+ * Description:
+ *   Load and activate filter banks 0 to nbanks-1, and deactivate the
+ *   others.
+ *
+ * Input Parameters:
+ *   fbase  - Base address of the CAN filter registers
+ *   banks  - The filter banks, see stm32l4can_compilefilters()
+ *   nbanks - Number of banks
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void stm32l4can_programbanks(uint32_t fbase,
+                             const struct stm32l4_canbank_s *banks,
+                             int nbanks);
+
+#ifdef CONFIG_STM32L4_CAN_CHARDRIVER
+
 /****************************************************************************
  * Name: stm32l4can_initialize
  *
  * Description:
- *   Initialize the selected CAN port
+ *   Initialize the selected CAN port as character device
  *
  * Input Parameters:
  *   Port number (for hardware that has multiple CAN interfaces)
@@ -115,11 +196,58 @@ extern "C"
 struct can_dev_s;
 struct can_dev_s *stm32l4can_initialize(int port);
 
+/****************************************************************************
+ * Name: stm32l4can_rxring_register
+ *
+ * Description:
+ *   Register a character device that returns received frames, with their
+ *   hardware timestamps, from per-FIFO lock-free rings filled directly by
+ *   the RX interrupt handlers.  read() returns as many struct
+ *   stm32l4_canframe_s (see arch/chip/can.h) as fit in the buffer.
+ *
+ *   When the RX ring is enabled, received frames no longer go through the
+ *   upper half driver.  The CAN character device must still be opened to
+ *   bring up the controller, and remains the interface for transmission
+ *   and ioctls.
+ *
+ * Input Parameters:
+ *   devpath - The full path to the device, e.g. "/dev/canraw0"
+ *   port    - Port number, as passed to stm32l4can_initialize()
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_CAN_RXRING
+int stm32l4can_rxring_register(const char *devpath, int port);
+#endif
+#endif /* CONFIG_STM32L4_CAN_CHARDRIVER */
+
+#ifdef CONFIG_STM32L4_CAN_SOCKET
+
+/****************************************************************************
+ * Name: stm32l4can_sockinitialize
+ *
+ * Description:
+ *   Initialize the selected CAN port as SocketCAN interface
+ *
+ * Input Parameters:
+ *   Port number (for hardware that has multiple CAN interfaces)
+ *
+ * Returned Value:
+ *   OK on success; Negated errno on failure.
+ *
+ ****************************************************************************/
+
+int stm32l4can_sockinitialize(int port);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
 #endif
 
 #endif /* __ASSEMBLY__ */
-#endif /* CONFIG_CAN && CONFIG_STM32L4_CAN1 */
+#endif /* CONFIG_STM32L4_CAN1 */
 #endif /* __ARCH_ARM_SRC_STM32L4_STM32L4_CAN_H */
@@ -0,0 +1,2854 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_can_sock.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <arch/board/board.h>
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+
+#include <nuttx/wqueue.h>
+#include <nuttx/can.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ioctl.h>
+#include <nuttx/net/can.h>
+#include <netpacket/can.h>
+#include <net/if.h>
+
+#include "arm_internal.h"
+#include "chip.h"
+#include "stm32l4.h"
+#include "stm32l4_can.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Delays *******************************************************************/
+
+/* Time out for INAK bit */
+
+#define INAK_TIMEOUT 65535
+
+/* Bit timing ***************************************************************/
+
+#define CAN_BIT_QUANTA (CONFIG_STM32L4_CAN_TSEG1 + CONFIG_STM32L4_CAN_TSEG2 + 1)
+
+#ifndef CONFIG_DEBUG_CAN_INFO
+#  undef CONFIG_STM32L4_CAN_REGDEBUG
+#endif
+
+/* Pool configuration *******************************************************/
+
+#define POOL_SIZE  (1)
+
+/* TX scheduling ************************************************************/
+
+#define CAN_NTXMB  (3)  /* Number of TX mailboxes */
+
+/* Acceptance filters *******************************************************/
+
+/* The filter table holds the filters added with SIOCACANSTDFILTER and
+ * SIOCACANEXTFILTER, whose ID is their index, followed by the offloaded
+ * CAN_RAW_FILTER set, each filter of which takes up to two entries.  The
+ * table is compiled into the filter banks by stm32l4can_compilefilters().
+ */
+
+#ifdef CONFIG_NETDEV_CAN_FILTER_IOCTL
+#  define CAN_NIOCFILTERS CONFIG_STM32L4_CAN_MAXFILTERS
+#else
+#  define CAN_NIOCFILTERS 0
+#endif
+
+#ifdef CONFIG_NET_CAN_RAW_FILTER_OFFLOAD
+#  define CAN_NRAWFILTERS (2 * CONFIG_NET_CAN_RAW_FILTER_MAX)
+#else
+#  define CAN_NRAWFILTERS 0
+#endif
+
+#define CAN_NTABFILTERS   (CAN_NIOCFILTERS + CAN_NRAWFILTERS)
+
+#if CAN_NTABFILTERS > 0
+#  define STM32L4_CAN_FILTERS 1
+#endif
+
+/* Work queue support is required. */
+
+#if !defined(CONFIG_SCHED_WORKQUEUE)
+#  error Work queue support is required
+#endif
+
+/* The low priority work queue is preferred.  If it is not enabled, LPWORK
+ * will be the same as HPWORK.
+ *
+ * NOTE:  However, the network should NEVER run on the high priority work
+ * queue!  That queue is intended only to service short back end interrupt
+ * processing that never suspends.  Suspending the high priority work queue
+ * may bring the system to its knees!
+ */
+
+#define CANWORK LPWORK
+
+/* CAN error interrupts */
+
+#ifdef CONFIG_NET_CAN_ERRORS
+#  define STM32L4_CAN_ERRINT (CAN_IER_LECIE | CAN_IER_ERRIE | \
+                            CAN_IER_BOFIE | CAN_IER_EPVIE | \
+                            CAN_IER_EWGIE)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct stm32l4_can_s
+{
+  uint8_t  port;     /* CAN port number (1 or 2) */
+  uint8_t  canrx[2]; /* CAN RX FIFO 0/1 IRQ number */
+  uint8_t  cantx;    /* CAN TX IRQ number */
+#ifdef CONFIG_NET_CAN_ERRORS
+  uint8_t  cansce;   /* CAN SCE IRQ number */
+#endif
+  uint8_t  filter;   /* Filter number */
+  uint32_t base;     /* Base address of the CAN control registers */
+  uint32_t fbase;    /* Base address of the CAN filter registers */
+  uint32_t baud;     /* Configured baud */
+
+  bool                bifup;  /* true:ifup false:ifdown */
+  struct net_driver_s dev;    /* Interface understood by the network */
+
+  struct work_s rxwork;   /* For deferring RX interrupt work to the wq */
+  struct work_s txwork;   /* For deferring TX interrupt work to the wq */
+#ifdef CONFIG_NET_CAN_ERRORS
+  struct work_s scework;  /* For deferring SCE interrupt work to the wq */
+#endif
+  struct work_s pollwork; /* For deferring poll work to the work wq */
+
+  /* TX scheduling.  Frames wait in txq, sorted by arbitration priority,
+   * until a mailbox is free.  txmb holds a copy of the frame loaded in each
+   * mailbox so that a frame preempted by a higher priority one can be put
+   * back in the queue; txq has room for those on top of its nominal size.
+   */
+
+  struct can_frame txq[CONFIG_STM32L4_CAN_TXQSIZE + CAN_NTXMB];
+  struct can_frame txmb[CAN_NTXMB];
+  uint8_t ntxq;           /* Number of frames in txq */
+  uint8_t txbusy;         /* Mailboxes loaded with a frame */
+  uint8_t txabort;        /* Mailboxes with an abort request pending */
+
+#ifdef STM32L4_CAN_FILTERS
+  /* Acceptance filters */
+
+  struct stm32l4_canfilter_s filters[CAN_NTABFILTERS];
+#endif
+#ifdef CONFIG_NET_CAN_RAW_FILTER_OFFLOAD
+  bool rawset;            /* An offloaded filter set is in effect */
+#endif
+
+  /* A pointer to the TX descriptor */
+
+  struct can_frame *txdesc;
+
+  /* TX pool */
+
+  uint8_t tx_pool[sizeof(struct can_frame)*POOL_SIZE];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* CAN Register access */
+
+static uint32_t stm32l4can_getreg(struct stm32l4_can_s *priv,
+                                int offset);
+static uint32_t stm32l4can_getfreg(struct stm32l4_can_s *priv,
+                                 int offset);
+static void stm32l4can_putreg(struct stm32l4_can_s *priv, int offset,
+                            uint32_t value);
+static void stm32l4can_putfreg(struct stm32l4_can_s *priv, int offset,
+                             uint32_t value);
+#ifdef CONFIG_STM32L4_CAN_REGDEBUG
+static void stm32l4can_dumpctrlregs(struct stm32l4_can_s *priv,
+                                  const char *msg);
+static void stm32l4can_dumpmbregs(struct stm32l4_can_s *priv,
+                                const char *msg);
+static void stm32l4can_dumpfiltregs(struct stm32l4_can_s *priv,
+                                  const char *msg);
+#else
+#  define stm32l4can_dumpctrlregs(priv,msg)
+#  define stm32l4can_dumpmbregs(priv,msg)
+#  define stm32l4can_dumpfiltregs(priv,msg)
+#endif
+
+/* CAN interrupt enable functions */
+
+static void stm32l4can_rx0int(struct stm32l4_can_s *priv, bool enable);
+static void stm32l4can_rx1int(struct stm32l4_can_s *priv, bool enable);
+static void stm32l4can_txint(struct stm32l4_can_s *priv, bool enable);
+#ifdef CONFIG_NET_CAN_ERRORS
+static void stm32l4can_errint(struct stm32l4_can_s *priv, bool enable);
+#endif
+
+/* Common TX logic */
+
+static uint32_t stm32l4can_txprio(const struct can_frame *frame);
+static void stm32l4can_txenqueue(struct stm32l4_can_s *priv,
+                                 const struct can_frame *frame,
+                                 bool ahead);
+static void stm32l4can_txmbload(struct stm32l4_can_s *priv, int txmb,
+                                const struct can_frame *frame);
+static void stm32l4can_txsched(struct stm32l4_can_s *priv);
+static bool stm32l4can_txready(struct stm32l4_can_s *priv);
+static int  stm32l4can_txpoll(struct net_driver_s *dev);
+
+/* CAN RX interrupt handling */
+
+static void stm32l4can_receive(struct stm32l4_can_s *priv, int rxmb);
+static void stm32l4can_rxinterrupt_work(void *arg);
+static int  stm32l4can_rxinterrupt(struct stm32l4_can_s *priv, int rxmb);
+
+static int  stm32l4can_rx0interrupt(int irq, void *context, void *arg);
+static int  stm32l4can_rx1interrupt(int irq, void *context, void *arg);
+
+/* CAN TX interrupt handling */
+
+static int  stm32l4can_txinterrupt(int irq, void *context, void *arg);
+static void stm32l4can_txdone_work(void *arg);
+
+#ifdef CONFIG_NET_CAN_ERRORS
+/* CAN errors interrupt handling */
+
+static void stm32l4can_sceinterrupt_work(void *arg);
+static int  stm32l4can_sceinterrupt(int irq, void *context, void *arg);
+#endif
+
+/* Initialization */
+
+static int  stm32l4can_setup(struct stm32l4_can_s *priv);
+static void stm32l4can_shutdown(struct stm32l4_can_s *priv);
+static void stm32l4can_reset(struct stm32l4_can_s *priv);
+static int  stm32l4can_enterinitmode(struct stm32l4_can_s *priv);
+static int  stm32l4can_exitinitmode(struct stm32l4_can_s *priv);
+static int  stm32l4can_bittiming(struct stm32l4_can_s *priv);
+static int  stm32l4can_cellinit(struct stm32l4_can_s *priv);
+static int  stm32l4can_filterinit(struct stm32l4_can_s *priv);
+
+/* Acceptance filters */
+
+static int  stm32l4can_setfilters(struct stm32l4_can_s *priv);
+#ifdef CONFIG_NETDEV_CAN_FILTER_IOCTL
+static int  stm32l4can_addfilter(struct stm32l4_can_s *priv,
+                                 const struct can_ioctl_filter_s *arg,
+                                 uint8_t flags);
+static int  stm32l4can_delfilter(struct stm32l4_can_s *priv, int arg,
+                                 uint8_t flags);
+#endif
+#ifdef CONFIG_NET_CAN_RAW_FILTER_OFFLOAD
+static int  stm32l4can_rawfilter(struct stm32l4_can_s *priv,
+                                 const struct can_rawfilter_s *req);
+#endif
+
+/* TX mailbox status */
+
+static bool stm32l4can_txmbempty(uint32_t tsr_regval, int txmb);
+
+/* NuttX callback functions */
+
+static int  stm32l4can_ifup(struct net_driver_s *dev);
+static int  stm32l4can_ifdown(struct net_driver_s *dev);
+
+static void stm32l4can_txavail_work(void *arg);
+static int  stm32l4can_txavail(struct net_driver_s *dev);
+
+#ifdef CONFIG_NETDEV_IOCTL
+static int  stm32l4can_netdev_ioctl(struct net_driver_s *dev, int cmd,
+                                    unsigned long arg);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_CAN1
+
+static struct stm32l4_can_s g_can1priv =
+{
+  .port             = 1,
+  .canrx            =
+  {
+                      STM32L4_IRQ_CAN1RX0,
+                      STM32L4_IRQ_CAN1RX1,
+  },
+  .cantx            = STM32L4_IRQ_CAN1TX,
+#ifdef CONFIG_NET_CAN_ERRORS
+  .cansce           = STM32L4_IRQ_CAN1SCE,
+#endif
+  .filter           = 0,
+  .base             = STM32L4_CAN1_BASE,
+  .fbase            = STM32L4_CAN1_BASE,
+  .baud             = CONFIG_STM32L4_CAN1_BAUD,
+};
+
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4can_getreg
+ * Name: stm32l4can_getfreg
+ *
+ * Description:
+ *   Read the value of a CAN register or filter block register.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_CAN_REGDEBUG
+static uint32_t stm32l4can_vgetreg(uint32_t addr)
+{
+  static uint32_t prevaddr = 0;
+  static uint32_t preval   = 0;
+  static uint32_t count    = 0;
+
+  /* Read the value from the register */
+
+  uint32_t val = getreg32(addr);
+
+  /* Is this the same value that we read from the same register last time?
+   * Are we polling the register?  If so, suppress some of the output.
+   */
+
+  if (addr == prevaddr && val == preval)
+    {
+      if (count == 0xffffffff || ++count > 3)
+        {
+          if (count == 4)
+            {
+              ninfo("...\n");
+            }
+
+          return val;
+        }
+    }
+
+  /* No this is a new address or value */
+
+  else
+    {
+      /* Did we print "..." for the previous value? */
+
+      if (count > 3)
+        {
+          /* Yes.. then show how many times the value repeated */
+
+          ninfo("[repeats %" PRIu32 " more times]\n", count - 3);
+        }
+
+      /* Save the new address, value, and count */
+
+      prevaddr = addr;
+      preval   = val;
+      count    = 1;
+    }
+
+  /* Show the register value read */
+
+  ninfo("%08" PRIx32 "->%08" PRIx32 "\n", addr, val);
+  return val;
+}
+
+static uint32_t stm32l4can_getreg(struct stm32l4_can_s *priv, int offset)
+{
+  return stm32l4can_vgetreg(priv->base + offset);
+}
+
+static uint32_t stm32l4can_getfreg(struct stm32l4_can_s *priv, int offset)
+{
+  return stm32l4can_vgetreg(priv->fbase + offset);
+}
+
+#else
+static uint32_t stm32l4can_getreg(struct stm32l4_can_s *priv, int offset)
+{
+  return getreg32(priv->base + offset);
+}
+
+static uint32_t stm32l4can_getfreg(struct stm32l4_can_s *priv, int offset)
+{
+  return getreg32(priv->fbase + offset);
+}
+
+#endif
+
+/****************************************************************************
+ * Name: stm32l4can_putreg
+ * Name: stm32l4can_putfreg
+ *
+ * Description:
+ *   Set the value of a CAN register or filter block register.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_CAN_REGDEBUG
+static void stm32l4can_vputreg(uint32_t addr, uint32_t value)
+{
+  /* Show the register value being written */
+
+  ninfo("%08" PRIx32 "->%08" PRIx32 "\n", addr, val);
+
+  /* Write the value */
+
+  putreg32(value, addr);
+}
+
+static void stm32l4can_putreg(struct stm32l4_can_s *priv, int offset,
+                            uint32_t value)
+{
+  stm32l4can_vputreg(priv->base + offset, value);
+}
+
+static void stm32l4can_putfreg(struct stm32l4_can_s *priv, int offset,
+                             uint32_t value)
+{
+  stm32l4can_vputreg(priv->fbase + offset, value);
+}
+
+#else
+static void stm32l4can_putreg(struct stm32l4_can_s *priv, int offset,
+                            uint32_t value)
+{
+  putreg32(value, priv->base + offset);
+}
+
+static void stm32l4can_putfreg(struct stm32l4_can_s *priv, int offset,
+                             uint32_t value)
+{
+  putreg32(value, priv->fbase + offset);
+}
+#endif
+
+/****************************************************************************
+ * Name: stm32l4can_dumpctrlregs
+ *
+ * Description:
+ *   Dump the contents of all CAN control registers
+ *
+ * Input Parameters:
+ *   priv - reference to the private CAN driver state structure
+ *   msg  - message
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_CAN_REGDEBUG
+static void stm32l4can_dumpctrlregs(struct stm32l4_can_s *priv,
+                                  const char *msg)
+{
+  if (msg)
+    {
+      ninfo("Control Registers: %s\n", msg);
+    }
+  else
+    {
+      ninfo("Control Registers:\n");
+    }
+
+  /* CAN control and status registers */
+
+  ninfo("  MCR: %08" PRIx32 "   MSR: %08" PRIx32 "   TSR: %08" PRIx32 "\n",
+          getreg32(priv->base + STM32L4_CAN_MCR_OFFSET),
+          getreg32(priv->base + STM32L4_CAN_MSR_OFFSET),
+          getreg32(priv->base + STM32L4_CAN_TSR_OFFSET));
+
+  ninfo(" RF0R: %08" PRIx32 "  RF1R: %08" PRIx32 "\n",
+          getreg32(priv->base + STM32L4_CAN_RF0R_OFFSET),
+          getreg32(priv->base + STM32L4_CAN_RF1R_OFFSET));
+
+  ninfo("  IER: %08" PRIx32 "   ESR: %08" PRIx32 "   BTR: %08" PRIx32 "\n",
+          getreg32(priv->base + STM32L4_CAN_IER_OFFSET),
+          getreg32(priv->base + STM32L4_CAN_ESR_OFFSET),
+          getreg32(priv->base + STM32L4_CAN_BTR_OFFSET));
+}
+#endif
+
+/****************************************************************************
+ * Name: stm32l4can_dumpmbregs
+ *
+ * Description:
+ *   Dump the contents of all CAN mailbox registers
+ *
+ * Input Parameters:
+ *   priv - reference to the private CAN driver state structure
+ *   msg  - message
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_CAN_REGDEBUG
+static void stm32l4can_dumpmbregs(struct stm32l4_can_s *priv,
+                                const char *msg)
+{
+  if (msg)
+    {
+      ninfo("Mailbox Registers: %s\n", msg);
+    }
+  else
+    {
+      ninfo("Mailbox Registers:\n");
+    }
+
+  /* CAN mailbox registers (3 TX and 2 RX) */
+
+  ninfo(" TI0R: %08" PRIx32 " TDT0R: %08" PRIx32 " TDL0R: %08"
+          PRIx32 " TDH0R: %08" PRIx32 "\n",
+          getreg32(priv->base + STM32L4_CAN_TI0R_OFFSET),
+          getreg32(priv->base + STM32L4_CAN_TDT0R_OFFSET),
+          getreg32(priv->base + STM32L4_CAN_TDL0R_OFFSET),
+          getreg32(priv->base + STM32L4_CAN_TDH0R_OFFSET));
+
+  ninfo(" TI1R: %08" PRIx32 " TDT1R: %08" PRIx32 " TDL1R: %08"
+          PRIx32 " TDH1R: %08" PRIx32 "\n",
+          getreg32(priv->base + STM32L4_CAN_TI1R_OFFSET),
+          getreg32(priv->base + STM32L4_CAN_TDT1R_OFFSET),
+          getreg32(priv->base + STM32L4_CAN_TDL1R_OFFSET),
+          getreg32(priv->base + STM32L4_CAN_TDH1R_OFFSET));
+
+  ninfo(" TI2R: %08" PRIx32 " TDT2R: %08" PRIx32 " TDL2R: %08"
+          PRIx32 " TDH2R: %08" PRIx32 "\n",
+          getreg32(priv->base + STM32L4_CAN_TI2R_OFFSET),
+          getreg32(priv->base + STM32L4_CAN_TDT2R_OFFSET),
+          getreg32(priv->base + STM32L4_CAN_TDL2R_OFFSET),
+          getreg32(priv->base + STM32L4_CAN_TDH2R_OFFSET));
+
+  ninfo(" RI0R: %08" PRIx32 " RDT0R: %08" PRIx32 " RDL0R: %08"
+          PRIx32 " RDH0R: %08" PRIx32 "\n",
+          getreg32(priv->base + STM32L4_CAN_RI0R_OFFSET),
+          getreg32(priv->base + STM32L4_CAN_RDT0R_OFFSET),
+          getreg32(priv->base + STM32L4_CAN_RDL0R_OFFSET),
+          getreg32(priv->base + STM32L4_CAN_RDH0R_OFFSET));
+
+  ninfo(" RI1R: %08" PRIx32 " RDT1R: %08" PRIx32 " RDL1R: %08"
+          PRIx32 " RDH1R: %08" PRIx32 "\n",
+          getreg32(priv->base + STM32L4_CAN_RI1R_OFFSET),
+          getreg32(priv->base + STM32L4_CAN_RDT1R_OFFSET),
+          getreg32(priv->base + STM32L4_CAN_RDL1R_OFFSET),
+          getreg32(priv->base + STM32L4_CAN_RDH1R_OFFSET));
+}
+#endif
+
+/****************************************************************************
+ * Name: stm32l4can_dumpfiltregs
+ *
+ * Description:
+ *   Dump the contents of all CAN filter registers
+ *
+ * Input Parameters:
+ *   priv - reference to the private CAN driver state structure
+ *   msg  - message
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_CAN_REGDEBUG
+static void stm32l4can_dumpfiltregs(struct stm32l4_can_s *priv,
+                                  const char *msg)
+{
+  int i;
+
+  if (msg)
+    {
+      ninfo("Filter Registers: %s\n", msg);
+    }
+  else
+    {
+      ninfo("Filter Registers:\n");
+    }
+
+  ninfo(" FMR: %08" PRIx32 "   FM1R: %08" PRIx32 "  FS1R: %08"
+          PRIx32 " FFA1R: %08" PRIx32 "  FA1R: %08" PRIx32 "\n",
+          getreg32(priv->base + STM32L4_CAN_FMR_OFFSET),
+          getreg32(priv->base + STM32L4_CAN_FM1R_OFFSET),
+          getreg32(priv->base + STM32L4_CAN_FS1R_OFFSET),
+          getreg32(priv->base + STM32L4_CAN_FFA1R_OFFSET),
+          getreg32(priv->base + STM32L4_CAN_FA1R_OFFSET));
+
+  for (i = 0; i < CAN_NFILTERS; i++)
+    {
+      ninfo(" F%dR1: %08" PRIx32 " F%dR2: %08" PRIx32 "\n",
+              i, getreg32(priv->base + STM32L4_CAN_FIR_OFFSET(i, 1)),
+              i, getreg32(priv->base + STM32L4_CAN_FIR_OFFSET(i, 2)));
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: stm32l4can_rx0int
+ *
+ * Description:
+ *   Call to enable or disable RX0 interrupts.
+ *
+ * Input Parameters:
+ *   priv - reference to the private CAN driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void stm32l4can_rx0int(struct stm32l4_can_s *priv, bool enable)
+{
+  uint32_t regval = 0;
+
+  ninfo("CAN%" PRIu8 "RX0 enable: %d\n", priv->port, enable);
+
+  /* Enable/disable the FIFO 0 message pending interrupt */
+
+  regval = stm32l4can_getreg(priv, STM32L4_CAN_IER_OFFSET);
+  if (enable)
+    {
+      regval |= CAN_IER_FMPIE0;
+    }
+  else
+    {
+      regval &= ~CAN_IER_FMPIE0;
+    }
+
+  stm32l4can_putreg(priv, STM32L4_CAN_IER_OFFSET, regval);
+}
+
+/****************************************************************************
+ * Name: stm32l4can_rx1int
+ *
+ * Description:
+ *   Call to enable or disable RX1 interrupts.
+ *
+ * Input Parameters:
+ *   priv - reference to the private CAN driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void stm32l4can_rx1int(struct stm32l4_can_s *priv, bool enable)
+{
+  uint32_t regval = 0;
+
+  ninfo("CAN%" PRIu8 "RX1 enable: %d\n", priv->port, enable);
+
+  /* Enable/disable the FIFO 1 message pending interrupt */
+
+  regval = stm32l4can_getreg(priv, STM32L4_CAN_IER_OFFSET);
+  if (enable)
+    {
+      regval |= CAN_IER_FMPIE1;
+    }
+  else
+    {
+      regval &= ~CAN_IER_FMPIE1;
+    }
+
+  stm32l4can_putreg(priv, STM32L4_CAN_IER_OFFSET, regval);
+}
+
+/****************************************************************************
+ * Name: stm32l4can_txint
+ *
+ * Description:
+ *   Call to enable or disable TX interrupts.
+ *
+ * Input Parameters:
+ *   priv - reference to the private CAN driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void stm32l4can_txint(struct stm32l4_can_s *priv, bool enable)
+{
+  uint32_t regval = 0;
+
+  ninfo("CAN%" PRIu8 " txint enable: %d\n", priv->port, enable);
+
+  /* Enable/disable the transmit mailbox interrupt */
+
+  regval  = stm32l4can_getreg(priv, STM32L4_CAN_IER_OFFSET);
+  if (enable)
+    {
+      regval |= CAN_IER_TMEIE;
+    }
+  else
+    {
+      regval &= ~CAN_IER_TMEIE;
+    }
+
+  stm32l4can_putreg(priv, STM32L4_CAN_IER_OFFSET, regval);
+}
+
+#ifdef CONFIG_NET_CAN_ERRORS
+/****************************************************************************
+ * Name: stm32l4can_errint
+ *
+ * Description:
+ *   Call to enable or disable CAN SCE interrupts.
+ *
+ * Input Parameters:
+ *   priv - reference to the private CAN driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void stm32l4can_errint(struct stm32l4_can_s *priv, bool enable)
+{
+  uint32_t regval = 0;
+
+  /* Enable/disable the transmit mailbox interrupt */
+
+  regval  = stm32l4can_getreg(priv, STM32L4_CAN_IER_OFFSET);
+  if (enable)
+    {
+      regval |= STM32L4_CAN_ERRINT;
+    }
+  else
+    {
+      regval &= ~STM32L4_CAN_ERRINT;
+    }
+
+  stm32l4can_putreg(priv, STM32L4_CAN_IER_OFFSET, regval);
+}
+#endif
+
+/****************************************************************************
+ * Function: stm32l4can_ifup
+ *
+ * Description:
+ *   NuttX Callback: Bring up the CAN interface
+ *
+ * Input Parameters:
+ *   dev  - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *
+ ****************************************************************************/
+
+static int stm32l4can_ifup(struct net_driver_s *dev)
+{
+  struct stm32l4_can_s *priv = (struct stm32l4_can_s *)dev->d_private;
+
+  /* Start with empty TX mailboxes and queue */
+
+  priv->ntxq    = 0;
+  priv->txbusy  = 0;
+  priv->txabort = 0;
+
+  /* Setup CAN */
+
+  stm32l4can_setup(priv);
+
+  /* Enable interrupts */
+
+  stm32l4can_rx0int(priv, true);
+  stm32l4can_rx1int(priv, true);
+  stm32l4can_txint(priv, true);
+#ifdef CONFIG_NET_CAN_ERRORS
+  stm32l4can_errint(priv, true);
+#endif
+
+  /* Enable the interrupts at the NVIC */
+
+  up_enable_irq(priv->canrx[0]);
+  up_enable_irq(priv->canrx[1]);
+  up_enable_irq(priv->cantx);
+#ifdef CONFIG_NET_CAN_ERRORS
+  up_enable_irq(priv->cansce);
+#endif
+
+  priv->bifup = true;
+
+  priv->txdesc = (struct can_frame *)priv->tx_pool;
+
+  priv->dev.d_buf = (uint8_t *)priv->txdesc;
+
+  return OK;
+}
+
+/****************************************************************************
+ * Function: stm32l4can_ifdown
+ *
+ * Description:
+ *   NuttX Callback: Stop the interface.
+ *
+ * Input Parameters:
+ *   dev  - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *
+ ****************************************************************************/
+
+static int stm32l4can_ifdown(struct net_driver_s *dev)
+{
+  struct stm32l4_can_s *priv = (struct stm32l4_can_s *)dev->d_private;
+
+  priv->bifup = false;
+
+  /* Disable CAN interrupts */
+
+  stm32l4can_shutdown(priv);
+
+  /* Reset CAN.  Frames still queued or in the mailboxes are lost. */
+
+  stm32l4can_reset(priv);
+
+  priv->ntxq    = 0;
+  priv->txbusy  = 0;
+  priv->txabort = 0;
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4can_txready
+ *
+ * Description:
+ *   Return true if the driver can accept another TX frame.  Frames are
+ *   accepted as long as the TX queue has room; they are moved into the
+ *   hardware mailboxes by stm32l4can_txsched().
+ *
+ ****************************************************************************/
+
+static bool stm32l4can_txready(struct stm32l4_can_s *priv)
+{
+  return priv->ntxq < CONFIG_STM32L4_CAN_TXQSIZE;
+}
+
+/****************************************************************************
+ * Name: stm32l4can_txprio
+ *
+ * Description:
+ *   Return a key that sorts frames in the order in which they would win
+ *   bus arbitration: the smaller the key, the higher the priority.
+ *
+ *   The key is made of the base identifier, the IDE bit (a standard frame
+ *   wins over an extended frame with the same base identifier), the
+ *   identifier extension and the RTR bit (a data frame wins over a remote
+ *   frame).
+ *
+ ****************************************************************************/
+
+static uint32_t stm32l4can_txprio(const struct can_frame *frame)
+{
+  uint32_t id = frame->can_id;
+  uint32_t key;
+
+#ifdef CONFIG_NET_CAN_EXTID
+  if ((id & CAN_EFF_FLAG) != 0)
+    {
+      key = ((id & CAN_EFF_MASK) >> 18) << 20 | (1 << 19) |
+            (id & 0x3ffff) << 1;
+    }
+  else
+#endif
+    {
+      key = (id & CAN_SFF_MASK) << 20;
+    }
+
+  if ((id & CAN_RTR_FLAG) != 0)
+    {
+      key |= 1;
+    }
+
+  return key;
+}
+
+/****************************************************************************
+ * Name: stm32l4can_txenqueue
+ *
+ * Description:
+ *   Insert a frame in the TX queue, after the frames of higher or equal
+ *   priority.  A frame taken back from a mailbox (ahead == true) goes
+ *   before the frames of equal priority instead, which were all queued
+ *   after it.
+ *
+ * Input Parameters:
+ *   priv  - reference to the private CAN driver state structure
+ *   frame - the frame to queue
+ *   ahead - queue ahead of frames of equal priority
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked and the queue has room for the frame.
+ *
+ ****************************************************************************/
+
+static void stm32l4can_txenqueue(struct stm32l4_can_s *priv,
+                                 const struct can_frame *frame,
+                                 bool ahead)
+{
+  uint32_t key = stm32l4can_txprio(frame);
+  uint32_t prev;
+  int i;
+
+  DEBUGASSERT(priv->ntxq < CONFIG_STM32L4_CAN_TXQSIZE + CAN_NTXMB);
+
+  for (i = priv->ntxq; i > 0; i--)
+    {
+      prev = stm32l4can_txprio(&priv->txq[i - 1]);
+      if (prev < key || (prev == key && !ahead))
+        {
+          break;
+        }
+
+      priv->txq[i] = priv->txq[i - 1];
+    }
+
+  priv->txq[i] = *frame;
+  priv->ntxq++;
+}
+
+/****************************************************************************
+ * Name: stm32l4can_txmbload
+ *
+ * Description:
+ *   Load a frame in an empty TX mailbox and request its transmission
+ *
+ * Input Parameters:
+ *   priv  - reference to the private CAN driver state structure
+ *   txmb  - the TX mailbox to use
+ *   frame - the frame to send
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void stm32l4can_txmbload(struct stm32l4_can_s *priv, int txmb,
+                                const struct can_frame *frame)
+{
+  const uint8_t *ptr;
+  uint32_t       regval;
+  uint32_t       tmp;
+  int            dlc;
+
+  ninfo("CAN%" PRIu8 " TX%d ID: %" PRIu32 " DLC: %" PRIu8 "\n",
+        priv->port, txmb, (uint32_t)frame->can_id, frame->can_dlc);
+
+  /* Keep a copy, in case the frame is preempted before it is sent */
+
+  memcpy(&priv->txmb[txmb], frame, sizeof(struct can_frame));
+  priv->txbusy |= 1 << txmb;
+
+  /* Clear TXRQ, RTR, IDE, EXID, and STID fields */
+
+  regval  = stm32l4can_getreg(priv, STM32L4_CAN_TIR_OFFSET(txmb));
+  regval &= ~(CAN_TIR_TXRQ | CAN_TIR_RTR | CAN_TIR_IDE |
+              CAN_TIR_EXID_MASK | CAN_TIR_STID_MASK);
+  stm32l4can_putreg(priv, STM32L4_CAN_TIR_OFFSET(txmb), regval);
+
+  /* Set up the ID, standard 11-bit or extended 29-bit. */
+
+#ifdef CONFIG_NET_CAN_EXTID
+  regval &= ~CAN_TIR_EXID_MASK;
+  if (frame->can_id & CAN_EFF_FLAG)
+    {
+      DEBUGASSERT(frame->can_id < (1 << 29));
+      regval |= (frame->can_id << CAN_TIR_EXID_SHIFT) | CAN_TIR_IDE;
+    }
+  else
+    {
+      DEBUGASSERT(frame->can_id < (1 << 11));
+      regval |= frame->can_id << CAN_TIR_STID_SHIFT;
+    }
+
+#else
+  regval |= (((uint32_t) frame->can_id << CAN_TIR_STID_SHIFT) &
+               CAN_TIR_STID_MASK);
+
+#endif
+
+#ifdef CONFIG_CAN_USE_RTR
+  regval |= ((frame->can_id & CAN_RTR_FLAG) ? CAN_TIR_RTR : 0);
+#endif
+
+  stm32l4can_putreg(priv, STM32L4_CAN_TIR_OFFSET(txmb), regval);
+
+  /* Set up the DLC */
+
+  dlc     = frame->can_dlc;
+  regval  = stm32l4can_getreg(priv, STM32L4_CAN_TDTR_OFFSET(txmb));
+  regval &= ~(CAN_TDTR_DLC_MASK | CAN_TDTR_TGT);
+  regval |= (uint32_t)dlc << CAN_TDTR_DLC_SHIFT;
+  stm32l4can_putreg(priv, STM32L4_CAN_TDTR_OFFSET(txmb), regval);
+
+  /* Set up the data fields */
+
+  ptr    = frame->data;
+  regval = 0;
+
+  if (dlc > 0)
+    {
+      tmp    = (uint32_t)*ptr++;
+      regval = tmp << CAN_TDLR_DATA0_SHIFT;
+
+      if (dlc > 1)
+        {
+          tmp     = (uint32_t)*ptr++;
+          regval |= tmp << CAN_TDLR_DATA1_SHIFT;
+
+          if (dlc > 2)
+            {
+              tmp     = (uint32_t)*ptr++;
+              regval |= tmp << CAN_TDLR_DATA2_SHIFT;
+
+              if (dlc > 3)
+                {
+                  tmp     = (uint32_t)*ptr++;
+                  regval |= tmp << CAN_TDLR_DATA3_SHIFT;
+                }
+            }
+        }
+    }
+
+  stm32l4can_putreg(priv, STM32L4_CAN_TDLR_OFFSET(txmb), regval);
+
+  regval = 0;
+  if (dlc > 4)
+    {
+      tmp    = (uint32_t)*ptr++;
+      regval = tmp << CAN_TDHR_DATA4_SHIFT;
+
+      if (dlc > 5)
+        {
+          tmp     = (uint32_t)*ptr++;
+          regval |= tmp << CAN_TDHR_DATA5_SHIFT;
+
+          if (dlc > 6)
+            {
+              tmp     = (uint32_t)*ptr++;
+              regval |= tmp << CAN_TDHR_DATA6_SHIFT;
+
+              if (dlc > 7)
+                {
+                  tmp     = (uint32_t)*ptr++;
+                  regval |= tmp << CAN_TDHR_DATA7_SHIFT;
+                }
+            }
+        }
+    }
+
+  stm32l4can_putreg(priv, STM32L4_CAN_TDHR_OFFSET(txmb), regval);
+
+  /* Enable the transmit mailbox empty interrupt (may already be enabled) */
+
+  regval  = stm32l4can_getreg(priv, STM32L4_CAN_IER_OFFSET);
+  regval |= CAN_IER_TMEIE;
+  stm32l4can_putreg(priv, STM32L4_CAN_IER_OFFSET, regval);
+
+  /* Request transmission */
+
+  regval  = stm32l4can_getreg(priv, STM32L4_CAN_TIR_OFFSET(txmb));
+  regval |= CAN_TIR_TXRQ;  /* Transmit Mailbox Request */
+  stm32l4can_putreg(priv, STM32L4_CAN_TIR_OFFSET(txmb), regval);
+
+  stm32l4can_dumpmbregs(priv, "After send");
+}
+
+/****************************************************************************
+ * Name: stm32l4can_txsched
+ *
+ * Description:
+ *   Move frames from the TX queue into the TX mailboxes, highest priority
+ *   first.  The mailboxes are served by identifier priority (TXFP is
+ *   cleared), so a high priority frame is never stuck behind the frames
+ *   already loaded.  When all mailboxes are busy and the head of the queue
+ *   has a higher priority than one of them, the lowest priority mailbox is
+ *   aborted; once the abort completes, its frame is queued again and the
+ *   mailbox is reloaded.
+ *
+ *   A frame is not loaded while a frame with the same identifier is still
+ *   in a mailbox, so the order of frames with the same identifier is kept.
+ *
+ * Input Parameters:
+ *   priv - reference to the private CAN driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void stm32l4can_txsched(struct stm32l4_can_s *priv)
+{
+  uint32_t regval;
+  uint32_t key;
+  uint32_t mbkey;
+  uint32_t victimkey = 0;
+  int victim;
+  int empty;
+  int txmb;
+
+  while (priv->ntxq > 0)
+    {
+      key    = stm32l4can_txprio(&priv->txq[0]);
+      regval = stm32l4can_getreg(priv, STM32L4_CAN_TSR_OFFSET);
+      victim = -1;
+      empty  = -1;
+
+      for (txmb = 0; txmb < CAN_NTXMB; txmb++)
+        {
+          if ((priv->txbusy & (1 << txmb)) == 0)
+            {
+              if (empty < 0 && stm32l4can_txmbempty(regval, txmb))
+                {
+                  empty = txmb;
+                }
+
+              continue;
+            }
+
+          mbkey = stm32l4can_txprio(&priv->txmb[txmb]);
+          if (mbkey == key)
+            {
+              /* Wait for the previous frame with this identifier */
+
+              return;
+            }
+
+          if ((priv->txabort & (1 << txmb)) == 0 && mbkey > key &&
+              (victim < 0 || mbkey > victimkey))
+            {
+              victim    = txmb;
+              victimkey = mbkey;
+            }
+        }
+
+      if (empty < 0)
+        {
+          if (victim >= 0)
+            {
+              /* Preempt the lowest priority mailbox.  If its frame is
+               * already on the bus, it completes normally.
+               */
+
+              stm32l4can_putreg(priv, STM32L4_CAN_TSR_OFFSET,
+                                CAN_TSR_ABRQ0 << (victim * 8));
+              priv->txabort |= 1 << victim;
+            }
+
+          return;
+        }
+
+      stm32l4can_txmbload(priv, empty, &priv->txq[0]);
+
+      priv->ntxq--;
+      memmove(&priv->txq[0], &priv->txq[1],
+              priv->ntxq * sizeof(struct can_frame));
+    }
+}
+
+/****************************************************************************
+ * Function: stm32l4can_txpoll
+ *
+ * Description:
+ *   The transmitter is available, check if the network has any outgoing
+ *   packets ready to send.  This is a callback from devif_poll().
+ *   devif_poll() may be called:
+ *
+ *   1. When the preceding TX packet send is complete,
+ *   2. When the preceding TX packet send timesout and the interface is reset
+ *   3. During normal TX polling
+ *
+ * Input Parameters:
+ *   dev  - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   OK on success; a negated errno on failure
+ *
+ * Assumptions:
+ *   May or may not be called from an interrupt handler.  In either case,
+ *   global interrupts are disabled, either explicitly or indirectly through
+ *   interrupt handling logic.
+ *
+ ****************************************************************************/
+
+static int stm32l4can_txpoll(struct net_driver_s *dev)
+{
+  struct stm32l4_can_s *priv = (struct stm32l4_can_s *)dev->d_private;
+
+  /* If the polling resulted in data that should be sent out on the network,
+   * the field d_len is set to a value > 0.
+   */
+
+  if (priv->dev.d_len > 0)
+    {
+      NETDEV_TXPACKETS(&priv->dev);
+
+      /* Queue the packet and load it if a mailbox is available */
+
+      stm32l4can_txenqueue(priv, (struct can_frame *)priv->dev.d_buf,
+                           false);
+      stm32l4can_txsched(priv);
+
+      /* Check if there is room in the device to hold another packet. If
+       * not, return a non-zero value to terminate the poll.
+       */
+
+      if (stm32l4can_txready(priv) == false)
+        {
+          return -EBUSY;
+        }
+    }
+
+  /* If zero is returned, the polling will continue until all connections
+   * have been examined.
+   */
+
+  return 0;
+}
+
+/****************************************************************************
+ * Function: stm32l4can_txavail_work
+ *
+ * Description:
+ *   Perform an out-of-cycle poll on the worker thread.
+ *
+ * Input Parameters:
+ *   arg - Reference to the NuttX driver state structure (cast to void*)
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called on the higher priority worker thread.
+ *
+ ****************************************************************************/
+
+static void stm32l4can_txavail_work(void *arg)
+{
+  struct stm32l4_can_s *priv = (struct stm32l4_can_s *)arg;
+
+  /* Ignore the notification if the interface is not yet up */
+
+  net_lock();
+  if (priv->bifup)
+    {
+      /* Check if there is room in the hardware to hold another outgoing
+       * packet.
+       */
+
+      if (stm32l4can_txready(priv))
+        {
+          /* No, there is space for another transfer.  Poll the network for
+           * new XMIT data.
+           */
+
+          devif_poll(&priv->dev, stm32l4can_txpoll);
+        }
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Function: stm32l4can_txavail
+ *
+ * Description:
+ *   Driver callback invoked when new TX data is available.  This is a
+ *   stimulus perform an out-of-cycle poll and, thereby, reduce the TX
+ *   latency.
+ *
+ * Input Parameters:
+ *   dev  - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called in normal user mode
+ *
+ ****************************************************************************/
+
+static int stm32l4can_txavail(struct net_driver_s *dev)
+{
+  struct stm32l4_can_s *priv = (struct stm32l4_can_s *)dev->d_private;
+
+  /* Is our single work structure available?  It may not be if there are
+   * pending interrupt actions and we will have to ignore the Tx
+   * availability action.
+   */
+
+  if (work_available(&priv->pollwork))
+    {
+      /* Schedule to serialize the poll on the worker thread. */
+
+      stm32l4can_txavail_work(priv);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Function: stm32l4can_netdev_ioctl
+ *
+ * Description:
+ *   Network device ioctl command handler: hardware acceptance filters
+ *
+ * Input Parameters:
+ *   dev  - Reference to the NuttX driver state structure
+ *   cmd  - ioctl command
+ *   arg  - Argument accompanying the command
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ * Assumptions:
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_IOCTL
+static int stm32l4can_netdev_ioctl(struct net_driver_s *dev, int cmd,
+                                   unsigned long arg)
+{
+#ifdef STM32L4_CAN_FILTERS
+  struct stm32l4_can_s *priv = (struct stm32l4_can_s *)dev->d_private;
+#endif
+  int ret;
+
+  switch (cmd)
+    {
+#ifdef CONFIG_NETDEV_CAN_FILTER_IOCTL
+#ifdef CONFIG_NET_CAN_EXTID
+      case SIOCACANEXTFILTER:  /* Add an extended-ID filter */
+        ret = stm32l4can_addfilter(priv,
+                (const struct can_ioctl_filter_s *)((uintptr_t)arg),
+                STM32L4_CANFILTER_EXT);
+        break;
+
+      case SIOCDCANEXTFILTER:  /* Delete an extended-ID filter */
+        ret = stm32l4can_delfilter(priv,
+                ((const struct can_ioctl_filter_s *)((uintptr_t)arg))->fid1,
+                STM32L4_CANFILTER_EXT);
+        break;
+#endif
+
+      case SIOCACANSTDFILTER:  /* Add a standard-ID filter */
+        ret = stm32l4can_addfilter(priv,
+                (const struct can_ioctl_filter_s *)((uintptr_t)arg), 0);
+        break;
+
+      case SIOCDCANSTDFILTER:  /* Delete a standard-ID filter */
+        ret = stm32l4can_delfilter(priv,
+                ((const struct can_ioctl_filter_s *)((uintptr_t)arg))->fid1,
+                0);
+        break;
+#endif
+
+#ifdef CONFIG_NET_CAN_RAW_FILTER_OFFLOAD
+      case SIOCSCANRAWFILTER:  /* Offload the CAN_RAW_FILTER sets */
+        ret = stm32l4can_rawfilter(priv,
+                (const struct can_rawfilter_s *)((uintptr_t)arg));
+        break;
+#endif
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  return ret;
+}
+#endif /* CONFIG_NETDEV_IOCTL */
+
+/****************************************************************************
+ * Name: stm32l4can_receive
+ *
+ * Description:
+ *   Read the frame at the head of an RX FIFO and pass it to the network.
+ *   The frame is built directly in an IOB that the network takes over, so
+ *   it is not copied again before it reaches the sockets.
+ *
+ * Input Parameters:
+ *   priv - reference to the private CAN driver state structure
+ *   rxmb - The RX FIFO number.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void stm32l4can_receive(struct stm32l4_can_s *priv, int rxmb)
+{
+  struct can_frame *frame;
+  uint32_t          regval;
+
+  if (rxmb == 0)
+    {
+      stm32l4can_dumpmbregs(priv, "RX0 interrupt");
+    }
+  else
+    {
+      stm32l4can_dumpmbregs(priv, "RX1 interrupt");
+    }
+
+  /* Get the CAN identifier. */
+
+  regval = stm32l4can_getreg(priv, STM32L4_CAN_RIR_OFFSET(rxmb));
+
+#ifndef CONFIG_NET_CAN_EXTID
+  if ((regval & CAN_RIR_IDE) != 0)
+    {
+      nerr("ERROR: Received message with extended identifier.  Dropped\n");
+      NETDEV_RXDROPPED(&priv->dev);
+      goto errout;
+    }
+#endif
+
+  /* Get an IOB for the frame.  Do not wait for one: the frame is dropped
+   * rather than stalling the RX FIFOs.
+   */
+
+  if (netdev_iob_prepare(&priv->dev, false, 0) != OK)
+    {
+      NETDEV_RXDROPPED(&priv->dev);
+      goto errout;
+    }
+
+  frame = (struct can_frame *)IOB_DATA(priv->dev.d_iob);
+  memset(frame, 0, sizeof(struct can_frame));
+
+#ifdef CONFIG_NET_CAN_EXTID
+  if ((regval & CAN_RIR_IDE) != 0)
+    {
+      frame->can_id  = (regval & CAN_RIR_EXID_MASK) >> CAN_RIR_EXID_SHIFT;
+      frame->can_id |= CAN_EFF_FLAG;
+    }
+  else
+#endif
+    {
+      frame->can_id  = (regval & CAN_RIR_STID_MASK) >> CAN_RIR_STID_SHIFT;
+    }
+
+  /* Extract the RTR bit */
+
+  if ((regval & CAN_RIR_RTR) != 0)
+    {
+      frame->can_id |= CAN_RTR_FLAG;
+    }
+
+  /* Get the DLC */
+
+  regval        = stm32l4can_getreg(priv, STM32L4_CAN_RDTR_OFFSET(rxmb));
+  frame->can_dlc = (regval & CAN_RDTR_DLC_MASK) >> CAN_RDTR_DLC_SHIFT;
+
+  /* Save the message data */
+
+  regval  = stm32l4can_getreg(priv, STM32L4_CAN_RDLR_OFFSET(rxmb));
+  frame->data[0] = (regval & CAN_RDLR_DATA0_MASK) >> CAN_RDLR_DATA0_SHIFT;
+  frame->data[1] = (regval & CAN_RDLR_DATA1_MASK) >> CAN_RDLR_DATA1_SHIFT;
+  frame->data[2] = (regval & CAN_RDLR_DATA2_MASK) >> CAN_RDLR_DATA2_SHIFT;
+  frame->data[3] = (regval & CAN_RDLR_DATA3_MASK) >> CAN_RDLR_DATA3_SHIFT;
+
+  regval  = stm32l4can_getreg(priv, STM32L4_CAN_RDHR_OFFSET(rxmb));
+  frame->data[4] = (regval & CAN_RDHR_DATA4_MASK) >> CAN_RDHR_DATA4_SHIFT;
+  frame->data[5] = (regval & CAN_RDHR_DATA5_MASK) >> CAN_RDHR_DATA5_SHIFT;
+  frame->data[6] = (regval & CAN_RDHR_DATA6_MASK) >> CAN_RDHR_DATA6_SHIFT;
+  frame->data[7] = (regval & CAN_RDHR_DATA7_MASK) >> CAN_RDHR_DATA7_SHIFT;
+
+  /* Hand the IOB to the socket interface */
+
+  iob_update_pktlen(priv->dev.d_iob, sizeof(struct can_frame), false);
+  priv->dev.d_len = sizeof(struct can_frame);
+
+  NETDEV_RXPACKETS(&priv->dev);
+
+  can_input(&priv->dev);
+
+  /* Free the IOB if it was not taken over and point the packet buffer
+   * back to the Tx buffer that will be used during the next write.
+   */
+
+  netdev_iob_release(&priv->dev);
+  priv->dev.d_buf = (uint8_t *)priv->txdesc;
+
+  /* Release the FIFO */
+
+errout:
+  regval  = stm32l4can_getreg(priv, STM32L4_CAN_RFR_OFFSET(rxmb));
+  regval |= CAN_RFR_RFOM;
+  stm32l4can_putreg(priv, STM32L4_CAN_RFR_OFFSET(rxmb), regval);
+}
+
+/****************************************************************************
+ * Name: stm32l4can_rxinterrupt_work
+ *
+ * Description:
+ *   CAN RX FIFO 0/1 interrupt work.  All the frames pending in the two
+ *   FIFOs are passed to the network in one go; FIFO 0, which holds the
+ *   frames of the high priority filters, is emptied first.
+ *
+ * Input Parameters:
+ *   arg  - reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void stm32l4can_rxinterrupt_work(void *arg)
+{
+  struct stm32l4_can_s *priv = (struct stm32l4_can_s *)arg;
+  uint32_t regval;
+  int rxmb;
+
+  DEBUGASSERT(priv != NULL);
+
+  net_lock();
+
+  for (rxmb = 0; rxmb < 2; rxmb++)
+    {
+      for (; ; )
+        {
+          regval = stm32l4can_getreg(priv, STM32L4_CAN_RFR_OFFSET(rxmb));
+          if ((regval & CAN_RFR_FMP_MASK) == 0)
+            {
+              break;
+            }
+
+          stm32l4can_receive(priv, rxmb);
+        }
+    }
+
+  net_unlock();
+
+  /* Re-enable CAN RX interrupts */
+
+  stm32l4can_rx0int(priv, true);
+  stm32l4can_rx1int(priv, true);
+}
+
+/****************************************************************************
+ * Name: stm32l4can_rxinterrupt
+ *
+ * Description:
+ *   CAN RX FIFO common interrupt handler
+ *
+ ****************************************************************************/
+
+static int stm32l4can_rxinterrupt(struct stm32l4_can_s *priv, int rxmb)
+{
+  uint32_t regval   = 0;
+  int      npending = 0;
+
+  /* Verify that a message is pending in the FIFO */
+
+  regval   = stm32l4can_getreg(priv, STM32L4_CAN_RFR_OFFSET(rxmb));
+  npending = (regval & CAN_RFR_FMP_MASK) >> CAN_RFR_FMP_SHIFT;
+  if (npending < 1)
+    {
+      nwarn("WARNING: No messages pending\n");
+      return OK;
+    }
+
+  /* Disable further CAN RX interrupts and schedule to perform the
+   * interrupt processing on the worker thread
+   */
+
+  if (rxmb == 0)
+    {
+      stm32l4can_rx0int(priv, false);
+    }
+  else
+    {
+      stm32l4can_rx1int(priv, false);
+    }
+
+  work_queue(CANWORK, &priv->rxwork, stm32l4can_rxinterrupt_work, priv, 0);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4can_rx0interrupt
+ *
+ * Description:
+ *   CAN RX FIFO 0 interrupt handler
+ *
+ * Input Parameters:
+ *   irq - The IRQ number of the interrupt.
+ *   context - The register state save array at the time of the interrupt.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno on failure
+ *
+ ****************************************************************************/
+
+static int stm32l4can_rx0interrupt(int irq, void *context, void *arg)
+{
+  struct stm32l4_can_s *priv = (struct stm32l4_can_s *)arg;
+  return stm32l4can_rxinterrupt(priv, 0);
+}
+
+/****************************************************************************
+ * Name: stm32l4can_rx1interrupt
+ *
+ * Description:
+ *   CAN RX FIFO 1 interrupt handler
+ *
+ * Input Parameters:
+ *   irq - The IRQ number of the interrupt.
+ *   context - The register state save array at the time of the interrupt.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno on failure
+ *
+ ****************************************************************************/
+
+static int stm32l4can_rx1interrupt(int irq, void *context, void *arg)
+{
+  struct stm32l4_can_s *priv = (struct stm32l4_can_s *)arg;
+  return stm32l4can_rxinterrupt(priv, 1);
+}
+
+/****************************************************************************
+ * Name: stm32l4can_txinterrupt
+ *
+ * Description:
+ *   CAN TX mailbox complete interrupt handler
+ *
+ * Input Parameters:
+ *   irq - The IRQ number of the interrupt.
+ *   context - The register state save array at the time of the interrupt.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno on failure
+ *
+ ****************************************************************************/
+
+static int stm32l4can_txinterrupt(int irq, void *context, void *arg)
+{
+  struct stm32l4_can_s *priv = (struct stm32l4_can_s *)arg;
+
+  DEBUGASSERT(priv != NULL);
+
+  /* Disable further TX CAN interrupts and schedule the completion
+   * processing on the worker thread, which clears the RQCPn bits.
+   */
+
+  stm32l4can_txint(priv, false);
+  work_queue(CANWORK, &priv->txwork, stm32l4can_txdone_work, priv, 0);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4can_txdone_work
+ *
+ * Description:
+ *   CAN TX mailbox complete interrupt work.  Account for the completed
+ *   mailboxes, queue again the frames that were preempted, refill the
+ *   mailboxes and poll the network for new XMIT data.
+ *
+ * Input Parameters:
+ *   arg  - reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void stm32l4can_txdone_work(void *arg)
+{
+  struct stm32l4_can_s *priv = (struct stm32l4_can_s *)arg;
+  uint32_t regval;
+  uint32_t rqcp;
+  int txmb;
+
+  net_lock();
+
+  regval = stm32l4can_getreg(priv, STM32L4_CAN_TSR_OFFSET);
+
+  for (txmb = 0; txmb < CAN_NTXMB; txmb++)
+    {
+      rqcp = CAN_TSR_RQCP0 << (txmb * 8);
+      if ((regval & rqcp) == 0)
+        {
+          continue;
+        }
+
+      /* Writing '1' to RQCPn clears RQCPn and all the status bits (TXOKn,
+       * ALSTn and TERRn) for Mailbox n.
+       */
+
+      stm32l4can_putreg(priv, STM32L4_CAN_TSR_OFFSET, rqcp);
+
+      if ((regval & (CAN_TSR_TXOK0 << (txmb * 8))) != 0)
+        {
+          NETDEV_TXDONE(&priv->dev);
+        }
+      else if ((priv->txabort & (1 << txmb)) != 0)
+        {
+          /* Aborted by stm32l4can_txsched() before it won the bus */
+
+          stm32l4can_txenqueue(priv, &priv->txmb[txmb], true);
+        }
+      else
+        {
+          NETDEV_TXERRORS(&priv->dev);
+        }
+
+      priv->txbusy  &= ~(1 << txmb);
+      priv->txabort &= ~(1 << txmb);
+    }
+
+  stm32l4can_txsched(priv);
+  stm32l4can_txint(priv, true);
+
+  /* Poll the network for new XMIT data if there is room for it */
+
+  if (stm32l4can_txready(priv))
+    {
+      devif_poll(&priv->dev, stm32l4can_txpoll);
+    }
+
+  net_unlock();
+}
+
+#ifdef CONFIG_NET_CAN_ERRORS
+
+/****************************************************************************
+ * Name: stm32l4can_sceinterrupt_work
+ *
+ * Description:
+ *   CAN status change interrupt work
+ *
+ * Input Parameters:
+ *   arg  - reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void stm32l4can_sceinterrupt_work(void *arg)
+{
+  struct stm32l4_can_s *priv    = (struct stm32l4_can_s *)arg;
+  struct can_frame     *frame;
+  uint32_t              regval  = 0;
+  uint16_t              errbits = 0;
+  uint8_t               data[CAN_ERR_DLC];
+
+  DEBUGASSERT(priv != NULL);
+
+  /* Check Error Interrupt flag */
+
+  regval = stm32l4can_getreg(priv, STM32L4_CAN_MSR_OFFSET);
+  if (regval & CAN_MSR_ERRI)
+    {
+      /* Encode error bits */
+
+      errbits = 0;
+      memset(data, 0, sizeof(data));
+
+      /* Get Error statur register */
+
+      regval = stm32l4can_getreg(priv, STM32L4_CAN_ESR_OFFSET);
+
+      if (regval & CAN_ESR_EWGF)
+        {
+          /* Error warning flag */
+
+          data[1] |= (CAN_ERR_CRTL_RX_WARNING | CAN_ERR_CRTL_TX_WARNING);
+          errbits |= CAN_ERR_CRTL;
+        }
+
+      if (regval & CAN_ESR_EPVF)
+        {
+          /* Error passive flag */
+
+          data[1] |= (CAN_ERR_CRTL_RX_PASSIVE | CAN_ERR_CRTL_TX_PASSIVE);
+          errbits |= CAN_ERR_CRTL;
+        }
+
+      if (regval & CAN_ESR_BOFF)
+        {
+          /* Bus-off flag */
+
+          errbits |= CAN_ERR_BUSOFF;
+        }
+
+      /* Last error code */
+
+      if (regval & CAN_ESR_LEC_MASK)
+        {
+          if (regval & CAN_ESR_STUFFERROR)
+            {
+              /* Stuff Error */
+
+              errbits |= CAN_ERR_PROT;
+              data[2] |= CAN_ERR_PROT_STUFF;
+            }
+          else if (regval & CAN_ESR_FORMERROR)
+            {
+              /* Format Error */
+
+              errbits |= CAN_ERR_PROT;
+              data[2] |= CAN_ERR_PROT_FORM;
+            }
+          else if (regval & CAN_ESR_ACKERROR)
+            {
+              /* Acknowledge Error */
+
+              errbits |= CAN_ERR_ACK;
+            }
+          else if (regval & CAN_ESR_BRECERROR)
+            {
+              /* Bit recessive Error */
+
+              errbits |= CAN_ERR_PROT;
+              data[2] |= CAN_ERR_PROT_BIT1;
+            }
+          else if (regval & CAN_ESR_BDOMERROR)
+            {
+              /* Bit dominant Error */
+
+              errbits |= CAN_ERR_PROT;
+              data[2] |= CAN_ERR_PROT_BIT0;
+            }
+          else if (regval & CAN_ESR_CRCERRPR)
+            {
+              /* Receive CRC Error */
+
+              errbits |= CAN_ERR_PROT;
+              data[3] |= CAN_ERR_PROT_LOC_CRC_SEQ;
+            }
+        }
+
+      /* Get transmit status register */
+
+      regval = stm32l4can_getreg(priv, STM32L4_CAN_TSR_OFFSET);
+
+      if (regval & CAN_TSR_ALST0 || regval & CAN_TSR_ALST1 ||
+          regval & CAN_TSR_ALST2)
+        {
+          /* Lost arbitration Error */
+
+          errbits |= CAN_ERR_LOSTARB;
+        }
+
+      /* The ALSTn bits are cleared with the RQCPn bits by
+       * stm32l4can_txdone_work(); clearing them here would lose the
+       * completion of the mailboxes.
+       */
+
+      /* Clear ERRI flag */
+
+      stm32l4can_putreg(priv, STM32L4_CAN_MSR_OFFSET, CAN_MSR_ERRI);
+    }
+
+  /* Report a CAN error */
+
+  if (errbits != 0)
+    {
+      canerr("ERROR: errbits = %08" PRIx16 "\n", errbits);
+
+      net_lock();
+
+      if (netdev_iob_prepare(&priv->dev, false, 0) != OK)
+        {
+          NETDEV_RXDROPPED(&priv->dev);
+        }
+      else
+        {
+          /* Build the error frame in the IOB */
+
+          frame = (struct can_frame *)IOB_DATA(priv->dev.d_iob);
+          memset(frame, 0, sizeof(struct can_frame));
+
+          frame->can_id  = errbits;
+          frame->can_dlc = CAN_ERR_DLC;
+
+          memcpy(frame->data, data, CAN_ERR_DLC);
+
+          iob_update_pktlen(priv->dev.d_iob, sizeof(struct can_frame),
+                            false);
+          priv->dev.d_len = sizeof(struct can_frame);
+
+          /* Send to socket interface */
+
+          NETDEV_ERRORS(&priv->dev);
+
+          can_input(&priv->dev);
+
+          /* Free the IOB if it was not taken over and point the packet
+           * buffer back to the next Tx buffer.
+           */
+
+          netdev_iob_release(&priv->dev);
+          priv->dev.d_buf = (uint8_t *)priv->txdesc;
+        }
+
+      net_unlock();
+    }
+
+  /* Re-enable CAN SCE interrupts */
+
+  stm32l4can_errint(priv, true);
+}
+
+/****************************************************************************
+ * Name: stm32l4can_sceinterrupt
+ *
+ * Description:
+ *   CAN status change interrupt handler
+ *
+ * Input Parameters:
+ *   irq - The IRQ number of the interrupt.
+ *   context - The register state save array at the time of the interrupt.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno on failure
+ *
+ ****************************************************************************/
+
+static int stm32l4can_sceinterrupt(int irq, void *context, void *arg)
+{
+  struct stm32l4_can_s *priv = (struct stm32l4_can_s *)arg;
+
+  /* Disable further CAN SCE interrupts and schedule to perform the
+   * interrupt processing on the worker thread
+   */
+
+  stm32l4can_errint(priv, false);
+  work_queue(CANWORK, &priv->scework,
+             stm32l4can_sceinterrupt_work, priv, 0);
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: stm32l4can_bittiming
+ *
+ * Description:
+ *   Set the CAN bit timing register (BTR) based on the configured BAUD.
+ *
+ * "The bit timing logic monitors the serial bus-line and performs sampling
+ *  and adjustment of the sample point by synchronizing on the start-bit edge
+ *  and resynchronizing on the following edges.
+ *
+ * "Its operation may be explained simply by splitting nominal bit time into
+ *  three segments as follows:
+ *
+ * 1. "Synchronization segment (SYNC_SEG): a bit change is expected to occur
+ *     within this time segment. It has a fixed length of one time quantum
+ *     (1 x tCAN).
+ * 2. "Bit segment 1 (BS1): defines the location of the sample point. It
+ *     includes the PROP_SEG and PHASE_SEG1 of the CAN standard. Its duration
+ *     is programmable between 1 and 16 time quanta but may be automatically
+ *     lengthened to compensate for positive phase drifts due to differences
+ *     in the frequency of the various nodes of the network.
+ * 3. "Bit segment 2 (BS2): defines the location of the transmit point. It
+ *     represents the PHASE_SEG2 of the CAN standard. Its duration is
+ *     programmable between 1 and 8 time quanta but may also be automatically
+ *     shortened to compensate for negative phase drifts."
+ *
+ * Pictorially:
+ *
+ *  |<----------------- NOMINAL BIT TIME ----------------->|
+ *  |<- SYNC_SEG ->|<------ BS1 ------>|<------ BS2 ------>|
+ *  |<---- Tq ---->|<----- Tbs1 ------>|<----- Tbs2 ------>|
+ *
+ * Where
+ *   Tbs1 is the duration of the BS1 segment
+ *   Tbs2 is the duration of the BS2 segment
+ *   Tq is the "Time Quantum"
+ *
+ * Relationships:
+ *
+ *   baud = 1 / bit_time
+ *   bit_time = Tq + Tbs1 + Tbs2
+ *   Tbs1 = Tq * ts1
+ *   Tbs2 = Tq * ts2
+ *   Tq = brp * Tpclk1
+ *   baud = Fpclk1 / (brp  * (1 + ts1 + ts2))
+ *
+ * Where:
+ *   Tpclk1 is the period of the APB1 clock (PCLK1).
+ *
+ * Input Parameters:
+ *   priv - reference to the private CAN driver state structure
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno on failure
+ *
+ ****************************************************************************/
+
+static int stm32l4can_bittiming(struct stm32l4_can_s *priv)
+{
+  uint32_t tmp;
+  uint32_t brp;
+  uint32_t ts1;
+  uint32_t ts2;
+
+  ninfo("CAN%" PRIu8 " PCLK1: %lu baud: %" PRIu32 "\n",
+          priv->port, (unsigned long) STM32L4_PCLK1_FREQUENCY, priv->baud);
+
+  /* Try to get CAN_BIT_QUANTA quanta in one bit_time.
+   *
+   *   bit_time = Tq*(ts1 + ts2 + 1)
+   *   nquanta  = bit_time / Tq
+   *   nquanta  = (ts1 + ts2 + 1)
+   *
+   *   bit_time = brp * Tpclk1 * (ts1 + ts2 + 1)
+   *   nquanta  = bit_time / brp / Tpclk1
+   *            = PCLK1 / baud / brp
+   *   brp      = PCLK1 / baud / nquanta;
+   *
+   * Example:
+   *   PCLK1 = 42,000,000 baud = 1,000,000 nquanta = 14 : brp = 3
+   *   PCLK1 = 42,000,000 baud =   700,000 nquanta = 14 : brp = 4
+   */
+
+  tmp = STM32L4_PCLK1_FREQUENCY / priv->baud;
+  if (tmp < CAN_BIT_QUANTA)
+    {
+      /* At the smallest brp value (1), there are already too few bit times
+       * (PCLCK1 / baud) to meet our goal.  brp must be one and we need
+       * make some reasonable guesses about ts1 and ts2.
+       */
+
+      brp = 1;
+
+      /* In this case, we have to guess a good value for ts1 and ts2 */
+
+      ts1 = (tmp - 1) >> 1;
+      ts2 = tmp - ts1 - 1;
+      if (ts1 == ts2 && ts1 > 1 && ts2 < CAN_BTR_TSEG2_MAX)
+        {
+          ts1--;
+          ts2++;
+        }
+    }
+
+  /* Otherwise, nquanta is CAN_BIT_QUANTA, ts1 is CONFIG_STM32L4_CAN_TSEG1,
+   * ts2 is CONFIG_STM32L4_CAN_TSEG2 and we calculate brp to achieve
+   * CAN_BIT_QUANTA quanta in the bit time
+   */
+
+  else
+    {
+      ts1 = CONFIG_STM32L4_CAN_TSEG1;
+      ts2 = CONFIG_STM32L4_CAN_TSEG2;
+      brp = (tmp + (CAN_BIT_QUANTA / 2)) / CAN_BIT_QUANTA;
+      DEBUGASSERT(brp >= 1 && brp <= CAN_BTR_BRP_MAX);
+    }
+
+  ninfo("TS1: %" PRIu32 " TS2: %" PRIu32 " BRP: %" PRIu32 "\n",
+               ts1, ts2, brp);
+
+  /* Configure bit timing.  This also does the following, less obvious
+   * things.  Unless loopback mode is enabled, it:
+   *
+   * - Disables silent mode.
+   * - Disables loopback mode.
+   *
+   * NOTE that for the time being, SJW is set to 1 just because I don't
+   * know any better.
+   */
+
+  tmp = ((brp - 1) << CAN_BTR_BRP_SHIFT) | ((ts1 - 1) << CAN_BTR_TS1_SHIFT) |
+        ((ts2 - 1) << CAN_BTR_TS2_SHIFT) | ((1 - 1) << CAN_BTR_SJW_SHIFT);
+#ifdef CONFIG_CAN_LOOPBACK
+  /* tmp |= (CAN_BTR_LBKM | CAN_BTR_SILM); */
+
+  tmp |= CAN_BTR_LBKM;
+#endif
+
+  stm32l4can_putreg(priv, STM32L4_CAN_BTR_OFFSET, tmp);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4can_setup
+ ****************************************************************************/
+
+static int  stm32l4can_setup(struct stm32l4_can_s *priv)
+{
+  int ret;
+
+#ifdef CONFIG_NET_CAN_ERRORS
+  ninfo("CAN%" PRIu8 " RX0 irq: %" PRIu8 " RX1 irq: %" PRIu8
+        " TX irq: %" PRIu8 " SCE irq: %" PRIu8 "\n",
+        priv->port, priv->canrx[0], priv->canrx[1], priv->cantx,
+        priv->cansce);
+#else
+  ninfo("CAN%" PRIu8 " RX0 irq: %" PRIu8 " RX1 irq: %" PRIu8
+        " TX irq: %" PRIu8 "\n",
+        priv->port, priv->canrx[0], priv->canrx[1], priv->cantx);
+#endif
+
+  /* CAN cell initialization */
+
+  ret = stm32l4can_cellinit(priv);
+  if (ret < 0)
+    {
+      nerr("ERROR: CAN%" PRId8 " cell initialization failed: %d\n",
+             priv->port, ret);
+      return ret;
+    }
+
+  stm32l4can_dumpctrlregs(priv, "After cell initialization");
+  stm32l4can_dumpmbregs(priv, NULL);
+
+  /* CAN filter initialization */
+
+  ret = stm32l4can_filterinit(priv);
+  if (ret < 0)
+    {
+      nerr("ERROR: CAN%" PRIu8 " filter initialization failed: %d\n",
+             priv->port, ret);
+      return ret;
+    }
+
+  stm32l4can_dumpfiltregs(priv, "After filter initialization");
+
+  /* Attach the CAN RX FIFO 0/1 interrupts and TX interrupts.
+   * The others are not used.
+   */
+
+  ret = irq_attach(priv->canrx[0], stm32l4can_rx0interrupt, priv);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to attach CAN%" PRIu8 " RX0 IRQ (%" PRIu8 ")",
+             priv->port, priv->canrx[0]);
+      return ret;
+    }
+
+  ret = irq_attach(priv->canrx[1], stm32l4can_rx1interrupt, priv);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to attach CAN%" PRIu8 " RX1 IRQ (%" PRIu8 ")",
+             priv->port, priv->canrx[1]);
+      return ret;
+    }
+
+  ret = irq_attach(priv->cantx, stm32l4can_txinterrupt, priv);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to attach CAN%" PRIu8 " TX IRQ (%" PRIu8 ")",
+             priv->port, priv->cantx);
+      return ret;
+    }
+
+#ifdef CONFIG_NET_CAN_ERRORS
+  ret = irq_attach(priv->cansce, stm32l4can_sceinterrupt, priv);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to attach CAN%" PRIu8 " SCE IRQ (%" PRIu8 ")",
+           priv->port, priv->cansce);
+      return ret;
+    }
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4can_shutdown
+ ****************************************************************************/
+
+static void stm32l4can_shutdown(struct stm32l4_can_s *priv)
+{
+  ninfo("CAN%" PRIu8 "\n", priv->port);
+
+  /* Disable the RX FIFO 0/1 and TX interrupts */
+
+  up_disable_irq(priv->canrx[0]);
+  up_disable_irq(priv->canrx[1]);
+  up_disable_irq(priv->cantx);
+#ifdef CONFIG_NET_CAN_ERRORS
+  up_disable_irq(priv->cansce);
+#endif
+
+  /* Detach the RX FIFO 0/1 and TX interrupts */
+
+  irq_detach(priv->canrx[0]);
+  irq_detach(priv->canrx[1]);
+  irq_detach(priv->cantx);
+#ifdef CONFIG_NET_CAN_ERRORS
+  irq_detach(priv->cansce);
+#endif
+}
+
+/****************************************************************************
+ * Name: stm32l4can_reset
+ *
+ * Description:
+ *   Put the CAN device in the non-operational, reset state
+ *
+ * Input Parameters:
+ *   priv - reference to the private CAN driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *
+ ****************************************************************************/
+
+static void stm32l4can_reset(struct stm32l4_can_s *priv)
+{
+  uint32_t regval;
+  uint32_t regbit = 0;
+  irqstate_t flags;
+
+  ninfo("CAN%" PRIu8 "\n", priv->port);
+
+  /* Get the bits in the APB1RSTR1 register needed to reset this CAN device */
+
+#ifdef CONFIG_STM32L4_CAN1
+  if (priv->port == 1)
+    {
+      regbit = RCC_APB1RSTR1_CAN1RST;
+    }
+  else
+#endif
+    {
+      nerr("ERROR: Unsupported port %d\n", priv->port);
+      return;
+    }
+
+  /* Disable interrupts momentarily to stop any ongoing CAN event processing
+   * and to prevent any concurrent access to the APB1RSTR1 register.
+   */
+
+  flags = enter_critical_section();
+
+  /* Reset the CAN */
+
+  regval  = getreg32(STM32L4_RCC_APB1RSTR1);
+  regval |= regbit;
+  putreg32(regval, STM32L4_RCC_APB1RSTR1);
+
+  regval &= ~regbit;
+  putreg32(regval, STM32L4_RCC_APB1RSTR1);
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: stm32l4can_enterinitmode
+ *
+ * Description:
+ *   Put the CAN cell in Initialization mode. This only disconnects the CAN
+ *   peripheral, no registers are changed. The initialization mode is
+ *   required to change the baud rate.
+ *
+ * Input Parameters:
+ *   priv - reference to the private CAN driver state structure
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int stm32l4can_enterinitmode(struct stm32l4_can_s *priv)
+{
+  uint32_t regval;
+  volatile uint32_t timeout;
+
+  ninfo("CAN%" PRIu8 "\n", priv->port);
+
+  /* Enter initialization mode */
+
+  regval  = stm32l4can_getreg(priv, STM32L4_CAN_MCR_OFFSET);
+  regval |= CAN_MCR_INRQ;
+  stm32l4can_putreg(priv, STM32L4_CAN_MCR_OFFSET, regval);
+
+  /* Wait until initialization mode is acknowledged */
+
+  for (timeout = INAK_TIMEOUT; timeout > 0; timeout--)
+    {
+      regval = stm32l4can_getreg(priv, STM32L4_CAN_MSR_OFFSET);
+      if ((regval & CAN_MSR_INAK) != 0)
+        {
+          /* We are in initialization mode */
+
+          break;
+        }
+    }
+
+  /* Check for a timeout */
+
+  if (timeout < 1)
+    {
+      nerr("ERROR: Timed out waiting to enter initialization mode\n");
+      return -ETIMEDOUT;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4can_exitinitmode
+ *
+ * Description:
+ *   Put the CAN cell out of the Initialization mode (to Normal mode)
+ *
+ * Input Parameters:
+ *   priv - reference to the private CAN driver state structure
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int stm32l4can_exitinitmode(struct stm32l4_can_s *priv)
+{
+  uint32_t regval;
+  volatile uint32_t timeout;
+
+  /* Exit Initialization mode, enter Normal mode */
+
+  regval  = stm32l4can_getreg(priv, STM32L4_CAN_MCR_OFFSET);
+  regval &= ~CAN_MCR_INRQ;
+  stm32l4can_putreg(priv, STM32L4_CAN_MCR_OFFSET, regval);
+
+  /* Wait until the initialization mode exit is acknowledged */
+
+  for (timeout = INAK_TIMEOUT; timeout > 0; timeout--)
+    {
+      regval = stm32l4can_getreg(priv, STM32L4_CAN_MSR_OFFSET);
+      if ((regval & CAN_MSR_INAK) == 0)
+        {
+          /* We are out of initialization mode */
+
+          break;
+        }
+    }
+
+  /* Check for a timeout */
+
+  if (timeout < 1)
+    {
+      nerr("ERROR: Timed out waiting to exit initialization mode: %08"
+                  PRIx32 "\n", regval);
+      return -ETIMEDOUT;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4can_cellinit
+ *
+ * Description:
+ *   CAN cell initialization
+ *
+ * Input Parameters:
+ *   priv - reference to the private CAN driver state structure
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int stm32l4can_cellinit(struct stm32l4_can_s *priv)
+{
+  uint32_t regval;
+  int ret;
+
+  ninfo("CAN%" PRIu8 "\n", priv->port);
+
+  /* Exit from sleep mode */
+
+  regval  = stm32l4can_getreg(priv, STM32L4_CAN_MCR_OFFSET);
+  regval &= ~CAN_MCR_SLEEP;
+  stm32l4can_putreg(priv, STM32L4_CAN_MCR_OFFSET, regval);
+
+  ret = stm32l4can_enterinitmode(priv);
+  if (ret != 0)
+    {
+      return ret;
+    }
+
+  /* Disable the following modes:
+   *
+   *  - Time triggered communication mode
+   *  - Automatic bus-off management
+   *  - Automatic wake-up mode
+   *  - No automatic retransmission
+   *  - Receive FIFO locked mode
+   *  - Transmit FIFO priority: the mailboxes are sent by identifier
+   *    priority, which stm32l4can_txsched() relies on.
+   */
+
+  regval  = stm32l4can_getreg(priv, STM32L4_CAN_MCR_OFFSET);
+  regval &= ~(CAN_MCR_RFLM | CAN_MCR_NART | CAN_MCR_AWUM |
+              CAN_MCR_ABOM | CAN_MCR_TTCM | CAN_MCR_TXFP);
+  stm32l4can_putreg(priv, STM32L4_CAN_MCR_OFFSET, regval);
+
+  /* Configure bit timing. */
+
+  ret = stm32l4can_bittiming(priv);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to set bit timing: %d\n", ret);
+      return ret;
+    }
+
+  return stm32l4can_exitinitmode(priv);
+}
+
+/****************************************************************************
+ * Name: stm32l4can_filterinit
+ *
+ * Description:
+ *   CAN filter initialization.  The CAN filters can be configured in a
+ *   different way:
+ *
+ *   1. As a match of specific IDs in a list (IdList mode), or as
+ *   2. And ID and a mask (IdMask mode).
+ *
+ *   Filters can also be configured as:
+ *
+ *   3. 16- or 32-bit.  The advantage of 16-bit filters is that you get
+ *      more filters;  The advantage of 32-bit filters is that you get
+ *      finer control of the filtering.
+ *
+ *   The CAN block is reset when the interface goes down, which clears the
+ *   filter banks; they are compiled again from the filter table here.
+ *
+ * Input Parameters:
+ *   priv - reference to the private CAN driver state structure
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int stm32l4can_filterinit(struct stm32l4_can_s *priv)
+{
+  ninfo("CAN%" PRIu8 " filter: %" PRIu8 "\n", priv->port, priv->filter);
+
+  return stm32l4can_setfilters(priv);
+}
+
+/****************************************************************************
+ * Name: stm32l4can_setfilters
+ *
+ * Description:
+ *   Compile the filter table and program the filter banks.  With no filter
+ *   in use, one bank is set up in 32-bit IdMask mode with both the ID and
+ *   the MASK set to zero, thus accepting all frames; an offloaded
+ *   CAN_RAW_FILTER set that selects no frames leaves all banks inactive.
+ *   The banks are left unchanged if the filters do not fit.
+ *
+ * Input Parameters:
+ *   priv - reference to the private CAN driver state structure
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int stm32l4can_setfilters(struct stm32l4_can_s *priv)
+{
+  struct stm32l4_canbank_s banks[CAN_NFILTERS];
+  int nbanks = 0;
+
+#ifdef STM32L4_CAN_FILTERS
+  nbanks = stm32l4can_compilefilters(priv->filters, CAN_NTABFILTERS,
+                                     banks, CAN_NFILTERS);
+  if (nbanks < 0)
+    {
+      return nbanks;
+    }
+#endif
+
+#ifdef CONFIG_NET_CAN_RAW_FILTER_OFFLOAD
+  if (nbanks == 0 && !priv->rawset)
+#else
+  if (nbanks == 0)
+#endif
+    {
+      banks[0].fr1   = 0;
+      banks[0].fr2   = 0;
+      banks[0].flags = STM32L4_CANBANK_32BIT;
+      nbanks         = 1;
+    }
+
+  stm32l4can_programbanks(priv->fbase, banks, nbanks);
+  return OK;
+}
+
+#ifdef CONFIG_NETDEV_CAN_FILTER_IOCTL
+/****************************************************************************
+ * Name: stm32l4can_addfilter
+ *
+ * Description:
+ *   Add a filter from a SIOCACANSTDFILTER or SIOCACANEXTFILTER request.
+ *   The filter matches both data and remote frames; CAN_MSGPRIO_HIGH
+ *   frames go to RX FIFO 0, which is emptied first, the others to RX
+ *   FIFO 1.
+ *
+ * Input Parameters:
+ *   priv  - reference to the private CAN driver state structure
+ *   arg   - the filter description
+ *   flags - STM32L4_CANFILTER_EXT for extended IDs
+ *
+ * Returned Value:
+ *   The filter ID on success; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int stm32l4can_addfilter(struct stm32l4_can_s *priv,
+                                const struct can_ioctl_filter_s *arg,
+                                uint8_t flags)
+{
+  struct stm32l4_canfilter_s *filter;
+  int ret;
+  int i;
+
+  for (i = 0; i < CAN_NIOCFILTERS; i++)
+    {
+      if ((priv->filters[i].flags & STM32L4_CANFILTER_USED) == 0)
+        {
+          break;
+        }
+    }
+
+  if (i >= CAN_NIOCFILTERS)
+    {
+      return -ENOSPC;
+    }
+
+  filter        = &priv->filters[i];
+  filter->id1   = arg->fid1;
+  filter->id2   = arg->fid2;
+  filter->type  = arg->ftype;
+  filter->flags = flags | STM32L4_CANFILTER_USED;
+
+  if (arg->fprio != CAN_MSGPRIO_HIGH)
+    {
+      filter->flags |= STM32L4_CANFILTER_FIFO1;
+    }
+
+  ret = stm32l4can_setfilters(priv);
+  if (ret < 0)
+    {
+      filter->flags = 0;
+      return ret;
+    }
+
+  return i;
+}
+
+/****************************************************************************
+ * Name: stm32l4can_delfilter
+ *
+ * Description:
+ *   Delete a filter added by stm32l4can_addfilter().
+ *
+ * Input Parameters:
+ *   priv  - reference to the private CAN driver state structure
+ *   arg   - the filter ID
+ *   flags - STM32L4_CANFILTER_EXT for extended IDs
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int stm32l4can_delfilter(struct stm32l4_can_s *priv, int arg,
+                                uint8_t flags)
+{
+  struct stm32l4_canfilter_s *filter;
+
+  if (arg < 0 || arg >= CAN_NIOCFILTERS)
+    {
+      return -EINVAL;
+    }
+
+  filter = &priv->filters[arg];
+  if ((filter->flags & STM32L4_CANFILTER_USED) == 0 ||
+      (filter->flags & STM32L4_CANFILTER_EXT) != flags)
+    {
+      return -EINVAL;
+    }
+
+  filter->flags = 0;
+  return stm32l4can_setfilters(priv);
+}
+#endif /* CONFIG_NETDEV_CAN_FILTER_IOCTL */
+
+#ifdef CONFIG_NET_CAN_RAW_FILTER_OFFLOAD
+/****************************************************************************
+ * Name: stm32l4can_rawfilter
+ *
+ * Description:
+ *   Load the union of the CAN_RAW_FILTER sets of the sockets bound to the
+ *   interface in the filter table, so that the frames no socket wants are
+ *   dropped by the hardware instead of waking up the network.
+ *
+ *   A filter whose mask selects the frame format takes one entry, other
+ *   filters one entry for each format.  The banks only need to let a
+ *   superset of the wanted frames through, as the sockets still apply
+ *   their own filters.  If the set does not fit, all frames are accepted
+ *   again.
+ *
+ * Input Parameters:
+ *   priv - reference to the private CAN driver state structure
+ *   req  - the filter set; a negative count requests to accept all frames.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int stm32l4can_rawfilter(struct stm32l4_can_s *priv,
+                                const struct can_rawfilter_s *req)
+{
+  struct stm32l4_canfilter_s *raw = &priv->filters[CAN_NIOCFILTERS];
+  const struct can_filter *filter;
+  uint8_t flags;
+  int nraw = 0;
+  int ret;
+  int i;
+
+  memset(raw, 0, CAN_NRAWFILTERS * sizeof(struct stm32l4_canfilter_s));
+  priv->rawset = req->nfilters >= 0;
+
+  for (i = 0; i < req->nfilters && i < CONFIG_NET_CAN_RAW_FILTER_MAX; i++)
+    {
+      filter = &req->filters[i];
+      flags  = STM32L4_CANFILTER_USED;
+
+      if ((filter->can_mask & CAN_RTR_FLAG) != 0)
+        {
+          flags |= STM32L4_CANFILTER_RTRMASK;
+          if ((filter->can_id & CAN_RTR_FLAG) != 0)
+            {
+              flags |= STM32L4_CANFILTER_RTR;
+            }
+        }
+
+      /* A mask with CAN_EFF_FLAG selects the frame format of the filter
+       * identifier; otherwise both formats match.
+       */
+
+      if ((filter->can_mask & CAN_EFF_FLAG) == 0 ||
+          (filter->can_id & CAN_EFF_FLAG) == 0)
+        {
+          raw[nraw].id1   = filter->can_id & CAN_SFF_MASK;
+          raw[nraw].id2   = filter->can_mask & CAN_SFF_MASK;
+          raw[nraw].type  = CAN_FILTER_MASK;
+          raw[nraw].flags = flags;
+          nraw++;
+        }
+
+#ifdef CONFIG_NET_CAN_EXTID
+      if ((filter->can_mask & CAN_EFF_FLAG) == 0 ||
+          (filter->can_id & CAN_EFF_FLAG) != 0)
+        {
+          raw[nraw].id1   = filter->can_id & CAN_EFF_MASK;
+          raw[nraw].id2   = filter->can_mask & CAN_EFF_MASK;
+          raw[nraw].type  = CAN_FILTER_MASK;
+          raw[nraw].flags = flags | STM32L4_CANFILTER_EXT;
+          nraw++;
+        }
+#endif
+    }
+
+  ret = stm32l4can_setfilters(priv);
+  if (ret < 0)
+    {
+      /* Too many filters: accept all frames again */
+
+      memset(raw, 0, CAN_NRAWFILTERS * sizeof(struct stm32l4_canfilter_s));
+      priv->rawset = false;
+      stm32l4can_setfilters(priv);
+    }
+
+  return ret;
+}
+#endif /* CONFIG_NET_CAN_RAW_FILTER_OFFLOAD */
+
+/****************************************************************************
+ * Name: stm32l4can_txmbempty
+ *
+ * Input Parameters:
+ *   tsr_regval - value of CAN transmit status register
+ *   txmb       - the TX mailbox
+ *
+ * Returned Value:
+ *   Returns true if the mailbox is empty and can be used for sending.
+ *
+ ****************************************************************************/
+
+static bool stm32l4can_txmbempty(uint32_t tsr_regval, int txmb)
+{
+  return (tsr_regval & (CAN_TSR_TME0 << txmb)) != 0 &&
+         (tsr_regval & (CAN_TSR_RQCP0 << (txmb * 8))) == 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4can_sockinitialize
+ *
+ * Description:
+ *   Initialize the selected CAN port as CAN socket interface
+ *
+ * Input Parameters:
+ *   Port number (for hardware that has multiple CAN interfaces)
+ *
+ * Returned Value:
+ *   OK on success; Negated errno on failure.
+ *
+ ****************************************************************************/
+
+int stm32l4can_sockinitialize(int port)
+{
+  struct stm32l4_can_s *priv = NULL;
+  int                 ret  = OK;
+
+  ninfo("CAN%" PRIu8 "\n", port);
+
+  /* NOTE:  Peripherical clocking for CAN1 was already provided by
+   * stm32l4_clockconfig() early in the reset sequence.
+   */
+
+#ifdef CONFIG_STM32L4_CAN1
+  if (port == 1)
+    {
+      /* Select the CAN1 device structure */
+
+      priv = &g_can1priv;
+
+      /* Configure CAN1 pins.  The ambiguous settings in the stm32*_pinmap.h
+       * file must have been disambiguated in the board.h file.
+       */
+
+      stm32l4_configgpio(GPIO_CAN1_RX);
+      stm32l4_configgpio(GPIO_CAN1_TX);
+    }
+  else
+#endif
+    {
+      nerr("ERROR: Unsupported port %d\n", port);
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  /* Initialize the driver structure */
+
+  priv->dev.d_ifup    = stm32l4can_ifup;
+  priv->dev.d_ifdown  = stm32l4can_ifdown;
+  priv->dev.d_txavail = stm32l4can_txavail;
+#ifdef CONFIG_NETDEV_IOCTL
+  priv->dev.d_ioctl   = stm32l4can_netdev_ioctl;
+#endif
+  priv->dev.d_private = priv;
+
+  /* Put the interface in the down state.  This usually amounts to resetting
+   * the device and/or calling stm32l4can_ifdown().
+   */
+
+  ninfo("callbacks done\n");
+
+  stm32l4can_ifdown(&priv->dev);
+
+  /* Register the device with the OS so that socket IOCTLs can be performed */
+
+  ret = netdev_register(&priv->dev, NET_LL_CAN);
+
+errout:
+  return ret;
+}
+
+/****************************************************************************
+ * Name: arm_netinitialize
+ *
+ * Description:
+ *   Initialize the CAN device interfaces.  If there is more than one device
+ *   interface in the chip, then board-specific logic will have to provide
+ *   this function to determine which, if any, CAN interfaces should be
+ *   initialized.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_NETDEV_LATEINIT)
+void arm_netinitialize(void)
+{
+#ifdef CONFIG_STM32L4_CAN1
+  stm32l4can_sockinitialize(1);
+#endif
+}
+#endif
+
@@ -0,0 +1,673 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_canfilter.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+#include <netpacket/can.h>
+
+#include "arm_internal.h"
+#include "chip.h"
+#include "stm32l4_can.h"
+
+#ifdef CONFIG_STM32L4_CAN1
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CAN_STDID_MASK   0x000007ff
+#define CAN_EXTID_MASK   0x1fffffff
+
+/* Entry classes, in the order in which their banks are laid out */
+
+#define CLASS_STDLIST    0  /* Exact standard ID: 16-bit list, 4 per bank */
+#define CLASS_STDMASK    1  /* Masked standard ID: 16-bit mask, 2 per bank */
+#define CLASS_EXTLIST    2  /* Exact extended ID: 32-bit list, 2 per bank */
+#define CLASS_EXTMASK    3  /* Masked extended ID: 32-bit mask, 1 per bank */
+#define NCLASSES         4
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One identifier/mask pair, expanded from a filter */
+
+struct canfilter_entry_s
+{
+  uint32_t id;
+  uint32_t mask;
+  uint8_t  flags;     /* STM32L4_CANFILTER_* */
+};
+
+/* Bank layout for one RX FIFO */
+
+struct canfilter_layout_s
+{
+  uint8_t count[NCLASSES];  /* Entries of each class */
+  uint8_t slot[NCLASSES];   /* Next slot of each class group */
+  uint8_t bank[NCLASSES];   /* First bank of each class group */
+  uint8_t nbanks[NCLASSES]; /* Banks of each class group */
+  uint8_t promote;          /* Exact standard IDs moved to 16-bit masks */
+  uint8_t share;            /* Exact standard IDs moved to 32-bit lists */
+  uint8_t nstd;             /* Exact standard IDs seen in the second pass */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: canfilter_expand
+ *
+ * Description:
+ *   Return the n-th identifier/mask pair matched by a filter.  A mask
+ *   filter is one pair, a dual filter two exact identifiers, and a range
+ *   the smallest set of aligned power-of-two blocks that covers it.
+ *
+ * Returned Value:
+ *   true if the pair exists; false past the last pair.
+ *
+ ****************************************************************************/
+
+static bool canfilter_expand(const struct stm32l4_canfilter_s *filter,
+                             int n, struct canfilter_entry_s *entry)
+{
+  uint32_t full = (filter->flags & STM32L4_CANFILTER_EXT) != 0 ?
+                  CAN_EXTID_MASK : CAN_STDID_MASK;
+  uint32_t first;
+  uint32_t last;
+  uint32_t size;
+
+  entry->flags = filter->flags;
+
+  switch (filter->type)
+    {
+      case CAN_FILTER_MASK:
+        entry->id   = filter->id1 & full;
+        entry->mask = filter->id2 & full;
+        return n == 0;
+
+      case CAN_FILTER_DUAL:
+        entry->id   = (n == 0 ? filter->id1 : filter->id2) & full;
+        entry->mask = full;
+        return n < 2;
+
+      case CAN_FILTER_RANGE:
+        first = filter->id1 & full;
+        last  = filter->id2 & full;
+
+        while (first <= last)
+          {
+            /* Largest block aligned on first that does not pass last */
+
+            size = first != 0 ? (first & -first) : full + 1;
+            while (size - 1 > last - first)
+              {
+                size >>= 1;
+              }
+
+            if (n-- == 0)
+              {
+                entry->id   = first;
+                entry->mask = full & ~(size - 1);
+                return true;
+              }
+
+            if (last - first < size)
+              {
+                break;
+              }
+
+            first += size;
+          }
+
+        return false;
+
+      default:
+        return false;
+    }
+}
+
+/****************************************************************************
+ * Name: canfilter_class
+ *
+ * Description:
+ *   Return the class of bank an entry goes to by default.
+ *
+ ****************************************************************************/
+
+static int canfilter_class(const struct canfilter_entry_s *entry)
+{
+  bool exact = (entry->flags & STM32L4_CANFILTER_RTRMASK) != 0;
+
+  if ((entry->flags & STM32L4_CANFILTER_EXT) != 0)
+    {
+      exact = exact && entry->mask == CAN_EXTID_MASK;
+      return exact ? CLASS_EXTLIST : CLASS_EXTMASK;
+    }
+
+  exact = exact && entry->mask == CAN_STDID_MASK;
+  return exact ? CLASS_STDLIST : CLASS_STDMASK;
+}
+
+/****************************************************************************
+ * Name: canfilter_field16
+ *
+ * Description:
+ *   Encode the identifier or the mask of a standard-ID entry in the 16-bit
+ *   filter register layout: STID[10:0], RTR, IDE, EXID[17:15].  The IDE
+ *   bit of a mask is always set: a filter only matches frames of its own
+ *   format.
+ *
+ ****************************************************************************/
+
+static uint32_t canfilter_field16(const struct canfilter_entry_s *entry,
+                                  bool mask)
+{
+  uint32_t value;
+
+  if (mask)
+    {
+      value = (entry->mask << 5) | (1 << 3);
+      if ((entry->flags & STM32L4_CANFILTER_RTRMASK) != 0)
+        {
+          value |= 1 << 4;
+        }
+    }
+  else
+    {
+      value = entry->id << 5;
+      if ((entry->flags & STM32L4_CANFILTER_RTR) != 0)
+        {
+          value |= 1 << 4;
+        }
+    }
+
+  return value;
+}
+
+/****************************************************************************
+ * Name: canfilter_field32
+ *
+ * Description:
+ *   Encode the identifier or the mask of an entry in the 32-bit filter
+ *   register layout: STID[10:0], EXID[17:0], IDE, RTR, 0.
+ *
+ ****************************************************************************/
+
+static uint32_t canfilter_field32(const struct canfilter_entry_s *entry,
+                                  bool mask)
+{
+  uint32_t value = mask ? entry->mask : entry->id;
+  uint8_t  rtr   = mask ? STM32L4_CANFILTER_RTRMASK : STM32L4_CANFILTER_RTR;
+
+  if ((entry->flags & STM32L4_CANFILTER_EXT) != 0)
+    {
+      value = (value << CAN_RIR_EXID_SHIFT) | CAN_RIR_IDE;
+    }
+  else
+    {
+      value = value << CAN_RIR_STID_SHIFT;
+      if (mask)
+        {
+          value |= CAN_RIR_IDE;
+        }
+    }
+
+  if ((entry->flags & rtr) != 0)
+    {
+      value |= CAN_RIR_RTR;
+    }
+
+  return value;
+}
+
+/****************************************************************************
+ * Name: canfilter_place
+ *
+ * Description:
+ *   Store an entry in a slot of a group of banks.
+ *
+ ****************************************************************************/
+
+static void canfilter_place(struct stm32l4_canbank_s *banks, int class,
+                            int first, int slot,
+                            const struct canfilter_entry_s *entry)
+{
+  struct stm32l4_canbank_s *bank;
+  uint32_t *reg;
+  int shift;
+
+  switch (class)
+    {
+      case CLASS_STDLIST:   /* Four 16-bit identifiers */
+        bank  = &banks[first + slot / 4];
+        reg   = (slot & 2) == 0 ? &bank->fr1 : &bank->fr2;
+        shift = (slot & 1) * 16;
+        *reg  = (*reg & ~(0xffff << shift)) |
+                (canfilter_field16(entry, false) << shift);
+        break;
+
+      case CLASS_STDMASK:   /* Two 16-bit identifier/mask pairs */
+        bank  = &banks[first + slot / 2];
+        reg   = (slot & 1) == 0 ? &bank->fr1 : &bank->fr2;
+        *reg  = (canfilter_field16(entry, true) << 16) |
+                canfilter_field16(entry, false);
+        break;
+
+      case CLASS_EXTLIST:   /* Two 32-bit identifiers */
+        bank  = &banks[first + slot / 2];
+        reg   = (slot & 1) == 0 ? &bank->fr1 : &bank->fr2;
+        *reg  = canfilter_field32(entry, false);
+        break;
+
+      default:              /* One 32-bit identifier/mask pair */
+        bank       = &banks[first + slot];
+        bank->fr1  = canfilter_field32(entry, false);
+        bank->fr2  = canfilter_field32(entry, true);
+        break;
+    }
+}
+
+/****************************************************************************
+ * Name: canfilter_pad
+ *
+ * Description:
+ *   Fill the unused slots of the last bank of a group with copies of its
+ *   first slot, so that they match nothing else.
+ *
+ ****************************************************************************/
+
+static void canfilter_pad(struct stm32l4_canbank_s *bank, int class,
+                          int used)
+{
+  uint32_t first = bank->fr1 & 0xffff;
+
+  switch (class)
+    {
+      case CLASS_STDLIST:
+        switch (used)
+          {
+            case 1:
+              bank->fr1 = (first << 16) | first;
+              bank->fr2 = (first << 16) | first;
+              break;
+
+            case 2:
+              bank->fr2 = (first << 16) | first;
+              break;
+
+            case 3:
+              bank->fr2 = (first << 16) | (bank->fr2 & 0xffff);
+              break;
+          }
+        break;
+
+      case CLASS_STDMASK:
+      case CLASS_EXTLIST:
+        if (used == 1)
+          {
+            bank->fr2 = bank->fr1;
+          }
+        break;
+
+      default:
+        break;
+    }
+}
+
+/****************************************************************************
+ * Name: canfilter_nbanks
+ ****************************************************************************/
+
+static int canfilter_nbanks(int nstdlist, int nstdmask, int nextlist,
+                            int nextmask)
+{
+  return (nstdlist + 3) / 4 + (nstdmask + 1) / 2 + (nextlist + 1) / 2 +
+         nextmask;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4can_compilefilters
+ *
+ * Description:
+ *   Compile a set of acceptance filters into filter banks, using as few
+ *   banks as possible.
+ *
+ *   Each filter is first expanded into identifier/mask pairs (a range into
+ *   the aligned blocks that cover it).  Standard-ID pairs go to 16-bit
+ *   banks: four exact IDs per bank in list mode, or two masked IDs per bank
+ *   in mask mode.  Extended-ID pairs go to 32-bit banks: two exact IDs per
+ *   bank in list mode, or one masked ID per bank in mask mode.  A pair is
+ *   exact when it matches every identifier bit and the RTR bit.
+ *
+ *   To fill the last bank of a group, exact standard IDs may also be moved
+ *   to the spare slots of the 16-bit mask or 32-bit list banks; all the
+ *   combinations are tried and the one with the fewest banks is used.
+ *   Banks are allocated separately for each RX FIFO.
+ *
+ * Input Parameters:
+ *   filters  - The filters; entries without STM32L4_CANFILTER_USED are
+ *              skipped.
+ *   nfilters - Number of entries in filters.
+ *   banks    - Receives the filter banks.
+ *   nbanks   - Number of available banks.
+ *
+ * Returned Value:
+ *   The number of banks used on success; -EINVAL if a filter is invalid,
+ *   or -ENOSPC if the filters do not fit in the available banks.
+ *
+ ****************************************************************************/
+
+int stm32l4can_compilefilters(const struct stm32l4_canfilter_s *filters,
+                              int nfilters, struct stm32l4_canbank_s *banks,
+                              int nbanks)
+{
+  struct canfilter_layout_s layout[2];
+  struct canfilter_layout_s *fl;
+  struct canfilter_entry_s entry;
+  int class;
+  int total;
+  int best;
+  int used;
+  int fifo;
+  int i;
+  int j;
+  int k;
+  int n;
+
+  memset(layout, 0, sizeof(layout));
+
+  /* Count the entries of each class for each FIFO */
+
+  for (i = 0; i < nfilters; i++)
+    {
+      if ((filters[i].flags & STM32L4_CANFILTER_USED) == 0)
+        {
+          continue;
+        }
+
+      if (filters[i].type > CAN_FILTER_RANGE ||
+          (filters[i].type == CAN_FILTER_RANGE &&
+           filters[i].id1 > filters[i].id2))
+        {
+          return -EINVAL;
+        }
+
+      fifo = (filters[i].flags & STM32L4_CANFILTER_FIFO1) != 0;
+      for (n = 0; canfilter_expand(&filters[i], n, &entry); n++)
+        {
+          class = canfilter_class(&entry);
+          if (layout[fifo].count[class] == UINT8_MAX)
+            {
+              return -ENOSPC;
+            }
+
+          layout[fifo].count[class]++;
+        }
+    }
+
+  /* Choose how many exact standard IDs to move to 16-bit mask slots (k)
+   * and to a spare 32-bit list slot (j), then lay out the banks.
+   */
+
+  total = 0;
+  for (fifo = 0; fifo < 2; fifo++)
+    {
+      fl   = &layout[fifo];
+      best = -1;
+
+      /* A spare 32-bit list slot exists if the exact extended IDs are odd */
+
+      used = (fl->count[CLASS_EXTLIST] & 1) != 0 &&
+             fl->count[CLASS_STDLIST] > 0;
+
+      for (j = 0; j <= used; j++)
+        {
+          for (k = 0; k <= fl->count[CLASS_STDLIST] - j; k++)
+            {
+              n = canfilter_nbanks(fl->count[CLASS_STDLIST] - k - j,
+                                   fl->count[CLASS_STDMASK] + k,
+                                   fl->count[CLASS_EXTLIST] + j,
+                                   fl->count[CLASS_EXTMASK]);
+              if (best < 0 || n < best)
+                {
+                  best        = n;
+                  fl->promote = k;
+                  fl->share   = j;
+                }
+            }
+        }
+
+      fl->nbanks[CLASS_STDLIST] = (fl->count[CLASS_STDLIST] - fl->promote -
+                                   fl->share + 3) / 4;
+      fl->nbanks[CLASS_STDMASK] = (fl->count[CLASS_STDMASK] +
+                                   fl->promote + 1) / 2;
+      fl->nbanks[CLASS_EXTLIST] = (fl->count[CLASS_EXTLIST] +
+                                   fl->share + 1) / 2;
+      fl->nbanks[CLASS_EXTMASK] = fl->count[CLASS_EXTMASK];
+
+      for (class = 0; class < NCLASSES; class++)
+        {
+          fl->bank[class] = total;
+          total += fl->nbanks[class];
+        }
+    }
+
+  if (total > nbanks)
+    {
+      return -ENOSPC;
+    }
+
+  /* Set up the banks */
+
+  for (fifo = 0; fifo < 2; fifo++)
+    {
+      fl = &layout[fifo];
+      for (class = 0; class < NCLASSES; class++)
+        {
+          for (i = 0; i < fl->nbanks[class]; i++)
+            {
+              struct stm32l4_canbank_s *bank = &banks[fl->bank[class] + i];
+
+              bank->fr1   = 0;
+              bank->fr2   = 0;
+              bank->flags = fifo != 0 ? STM32L4_CANBANK_FIFO1 : 0;
+
+              if (class == CLASS_STDLIST || class == CLASS_EXTLIST)
+                {
+                  bank->flags |= STM32L4_CANBANK_LIST;
+                }
+
+              if (class == CLASS_EXTLIST || class == CLASS_EXTMASK)
+                {
+                  bank->flags |= STM32L4_CANBANK_32BIT;
+                }
+            }
+        }
+    }
+
+  /* Place the entries */
+
+  for (i = 0; i < nfilters; i++)
+    {
+      if ((filters[i].flags & STM32L4_CANFILTER_USED) == 0)
+        {
+          continue;
+        }
+
+      fifo = (filters[i].flags & STM32L4_CANFILTER_FIFO1) != 0;
+      fl   = &layout[fifo];
+
+      for (n = 0; canfilter_expand(&filters[i], n, &entry); n++)
+        {
+          class = canfilter_class(&entry);
+          if (class == CLASS_STDLIST)
+            {
+              k = fl->nstd++;
+              used = fl->count[CLASS_STDLIST] - fl->promote - fl->share;
+              if (k >= used + fl->share)
+                {
+                  /* Moved to a 16-bit mask slot */
+
+                  canfilter_place(banks, CLASS_STDMASK,
+                                  fl->bank[CLASS_STDMASK],
+                                  fl->count[CLASS_STDMASK] + k - used -
+                                  fl->share, &entry);
+                  continue;
+                }
+              else if (k >= used)
+                {
+                  /* Moved to the spare 32-bit list slot */
+
+                  canfilter_place(banks, CLASS_EXTLIST,
+                                  fl->bank[CLASS_EXTLIST],
+                                  fl->count[CLASS_EXTLIST] + k - used,
+                                  &entry);
+                  continue;
+                }
+            }
+
+          canfilter_place(banks, class, fl->bank[class],
+                          fl->slot[class]++, &entry);
+        }
+    }
+
+  /* Pad the last bank of each group */
+
+  for (fifo = 0; fifo < 2; fifo++)
+    {
+      fl = &layout[fifo];
+      for (class = 0; class < NCLASSES; class++)
+        {
+          if (fl->nbanks[class] == 0)
+            {
+              continue;
+            }
+
+          switch (class)
+            {
+              case CLASS_STDLIST:
+                used = (fl->count[class] - fl->promote - fl->share) % 4;
+                break;
+
+              case CLASS_STDMASK:
+                used = (fl->count[class] + fl->promote) % 2;
+                break;
+
+              case CLASS_EXTLIST:
+                used = (fl->count[class] + fl->share) % 2;
+                break;
+
+              default:
+                used = 0;
+                break;
+            }
+
+          canfilter_pad(&banks[fl->bank[class] + fl->nbanks[class] - 1],
+                        class, used);
+        }
+    }
+
+  return total;
+}
+
+/****************************************************************************
+ * Name: stm32l4can_programbanks
+ *
+ * Description:
+ *   Program the filter banks.  Banks 0 to nbanks-1 are loaded and
+ *   activated; the other banks are deactivated.  Reception through the
+ *   filters is stopped while they are changed.
+ *
+ * Input Parameters:
+ *   fbase  - Base address of the CAN filter registers
+ *   banks  - The filter banks, see stm32l4can_compilefilters()
+ *   nbanks - Number of banks
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void stm32l4can_programbanks(uint32_t fbase,
+                             const struct stm32l4_canbank_s *banks,
+                             int nbanks)
+{
+  uint32_t active = 0;
+  uint32_t scale  = 0;
+  uint32_t mode   = 0;
+  uint32_t fifo   = 0;
+  int i;
+
+  DEBUGASSERT(nbanks <= CAN_NFILTERS);
+
+  /* Enter filter initialization mode and deactivate all the banks */
+
+  modifyreg32(fbase + STM32L4_CAN_FMR_OFFSET, 0, CAN_FMR_FINIT);
+  putreg32(0, fbase + STM32L4_CAN_FA1R_OFFSET);
+
+  for (i = 0; i < nbanks; i++)
+    {
+      putreg32(banks[i].fr1, fbase + STM32L4_CAN_FIR_OFFSET(i, 1));
+      putreg32(banks[i].fr2, fbase + STM32L4_CAN_FIR_OFFSET(i, 2));
+
+      if ((banks[i].flags & STM32L4_CANBANK_32BIT) != 0)
+        {
+          scale |= 1 << i;
+        }
+
+      if ((banks[i].flags & STM32L4_CANBANK_LIST) != 0)
+        {
+          mode |= 1 << i;
+        }
+
+      if ((banks[i].flags & STM32L4_CANBANK_FIFO1) != 0)
+        {
+          fifo |= 1 << i;
+        }
+
+      active |= 1 << i;
+    }
+
+  putreg32(scale, fbase + STM32L4_CAN_FS1R_OFFSET);
+  putreg32(mode, fbase + STM32L4_CAN_FM1R_OFFSET);
+  putreg32(fifo, fbase + STM32L4_CAN_FFA1R_OFFSET);
+  putreg32(active, fbase + STM32L4_CAN_FA1R_OFFSET);
+
+  /* Exit filter initialization mode */
+
+  modifyreg32(fbase + STM32L4_CAN_FMR_OFFSET, CAN_FMR_FINIT, 0);
+}
+
+#endif /* CONFIG_STM32L4_CAN1 */
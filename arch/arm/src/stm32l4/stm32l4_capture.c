@@ -0,0 +1,626 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_capture.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/timers/capture.h>
+
+#include <arch/board/board.h>
+
+#include "stm32l4_dma.h"
+#include "stm32l4_gpio.h"
+#include "stm32l4_tim.h"
+#include "stm32l4_capture.h"
+
+#ifdef CONFIG_STM32L4_CAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CAP_NEDGES          CONFIG_STM32L4_CAP_NEDGES
+
+/* The frequency is measured over the last CAP_FREQ_EDGES edges */
+
+#define CAP_FREQ_EDGES      64
+
+/* The capture register of the channel is read by one 32-bit transfer per
+ * edge; on the 16-bit timers the upper half reads as zero.
+ */
+
+#define CAP_DMA_CCR         (DMA_CCR_CIRC | DMA_CCR_MINC | \
+                             DMA_CCR_PSIZE_32BITS | DMA_CCR_MSIZE_32BITS | \
+                             DMA_CCR_PRIHI)
+
+/* Pin and DMA request of a channel given by a Kconfig number */
+
+#define CAP_PASTE2(a,b)     a##b
+#define CAP_PASTE3(a,b,c)   a##b##c
+#define CAP_PIN(a,ch)       CAP_PASTE3(a,ch,IN)
+#define CAP_DMA(a,ch)       CAP_PASTE2(a,ch)
+
+#define CAP_CCR(base,ch)    ((base) + STM32L4_GTIM_CCR1_OFFSET + \
+                             4 * ((ch) - 1))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure provides the private representation of the "lower-half"
+ * driver state structure.  This structure must be cast-compatible with the
+ * cap_lowerhalf_s structure.
+ *
+ * The DMA runs over the ring without end.  The number of edges written so
+ * far is laps * CAP_NEDGES plus the position of the DMA in the ring; the
+ * reader consumes them from rdpos on.
+ */
+
+struct stm32l4_cap_s
+{
+  const struct cap_ops_s *ops;       /* Lower half operations */
+  struct stm32l4_tim_dev_s *tim;     /* The timer counting the edges */
+  DMA_HANDLE             dma;        /* DMA channel of the capture event */
+  const uint8_t          timer;      /* Timer number */
+  const uint8_t          channel;    /* Input channel {1,..,4} */
+  const uint32_t         clock;      /* Timer counting frequency */
+  const uint32_t         mask;       /* Range of the timestamps */
+  const uint32_t         paddr;      /* Capture register of the channel */
+  const uint32_t         pincfg;     /* Pin of the channel */
+  const uint32_t         dmachan;    /* DMA request of the channel */
+  uint32_t              *ring;       /* CAP_NEDGES timestamps */
+  bool                   started;    /* True: Timer has been started */
+  volatile bool          half;       /* The DMA passed the middle */
+  volatile bool          waiting;    /* A reader waits for edges */
+  volatile uint32_t      laps;       /* Completed passes over the ring */
+  uint64_t               rdpos;      /* Edges consumed by the reader */
+  mutex_t                lock;       /* Serializes the readers */
+  sem_t                  waitsem;    /* Wakes up a waiting reader */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* "Lower half" driver methods **********************************************/
+
+static int stm32l4_cap_start(struct cap_lowerhalf_s *lower);
+static int stm32l4_cap_stop(struct cap_lowerhalf_s *lower);
+static int stm32l4_cap_getfreq(struct cap_lowerhalf_s *lower,
+                               uint32_t *freq);
+static ssize_t stm32l4_cap_read(struct cap_lowerhalf_s *lower,
+                                uint32_t *edges, size_t nedges,
+                                bool nonblock);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* "Lower half" driver methods */
+
+static const struct cap_ops_s g_cap_ops =
+{
+  .start       = stm32l4_cap_start,
+  .stop        = stm32l4_cap_stop,
+  .getfreq     = stm32l4_cap_getfreq,
+  .read        = stm32l4_cap_read,
+};
+
+#ifdef CONFIG_STM32L4_TIM1_CAP
+static uint32_t g_cap1_ring[CAP_NEDGES];
+static struct stm32l4_cap_s g_cap1_lowerhalf =
+{
+  .ops         = &g_cap_ops,
+  .timer       = 1,
+  .channel     = CONFIG_STM32L4_TIM1_CAP_CHANNEL,
+  .clock       = CONFIG_STM32L4_TIM1_CAP_CLOCK,
+  .mask        = 0xffff,
+  .paddr       = CAP_CCR(STM32L4_TIM1_BASE,
+                         CONFIG_STM32L4_TIM1_CAP_CHANNEL),
+  .pincfg      = CAP_PIN(GPIO_TIM1_CH, CONFIG_STM32L4_TIM1_CAP_CHANNEL),
+  .dmachan     = CAP_DMA(DMACHAN_TIM1_CH, CONFIG_STM32L4_TIM1_CAP_CHANNEL),
+  .ring        = g_cap1_ring,
+};
+#endif
+
+#ifdef CONFIG_STM32L4_TIM2_CAP
+static uint32_t g_cap2_ring[CAP_NEDGES];
+static struct stm32l4_cap_s g_cap2_lowerhalf =
+{
+  .ops         = &g_cap_ops,
+  .timer       = 2,
+  .channel     = CONFIG_STM32L4_TIM2_CAP_CHANNEL,
+  .clock       = CONFIG_STM32L4_TIM2_CAP_CLOCK,
+  .mask        = 0xffffffff,
+  .paddr       = CAP_CCR(STM32L4_TIM2_BASE,
+                         CONFIG_STM32L4_TIM2_CAP_CHANNEL),
+  .pincfg      = CAP_PIN(GPIO_TIM2_CH, CONFIG_STM32L4_TIM2_CAP_CHANNEL),
+  .dmachan     = CAP_DMA(DMACHAN_TIM2_CH, CONFIG_STM32L4_TIM2_CAP_CHANNEL),
+  .ring        = g_cap2_ring,
+};
+#endif
+
+#ifdef CONFIG_STM32L4_TIM3_CAP
+static uint32_t g_cap3_ring[CAP_NEDGES];
+static struct stm32l4_cap_s g_cap3_lowerhalf =
+{
+  .ops         = &g_cap_ops,
+  .timer       = 3,
+  .channel     = CONFIG_STM32L4_TIM3_CAP_CHANNEL,
+  .clock       = CONFIG_STM32L4_TIM3_CAP_CLOCK,
+  .mask        = 0xffff,
+  .paddr       = CAP_CCR(STM32L4_TIM3_BASE,
+                         CONFIG_STM32L4_TIM3_CAP_CHANNEL),
+  .pincfg      = CAP_PIN(GPIO_TIM3_CH, CONFIG_STM32L4_TIM3_CAP_CHANNEL),
+  .dmachan     = CAP_DMA(DMACHAN_TIM3_CH, CONFIG_STM32L4_TIM3_CAP_CHANNEL),
+  .ring        = g_cap3_ring,
+};
+#endif
+
+#ifdef CONFIG_STM32L4_TIM4_CAP
+static uint32_t g_cap4_ring[CAP_NEDGES];
+static struct stm32l4_cap_s g_cap4_lowerhalf =
+{
+  .ops         = &g_cap_ops,
+  .timer       = 4,
+  .channel     = CONFIG_STM32L4_TIM4_CAP_CHANNEL,
+  .clock       = CONFIG_STM32L4_TIM4_CAP_CLOCK,
+  .mask        = 0xffff,
+  .paddr       = CAP_CCR(STM32L4_TIM4_BASE,
+                         CONFIG_STM32L4_TIM4_CAP_CHANNEL),
+  .pincfg      = CAP_PIN(GPIO_TIM4_CH, CONFIG_STM32L4_TIM4_CAP_CHANNEL),
+  .dmachan     = CAP_DMA(DMACHAN_TIM4_CH, CONFIG_STM32L4_TIM4_CAP_CHANNEL),
+  .ring        = g_cap4_ring,
+};
+#endif
+
+#ifdef CONFIG_STM32L4_TIM5_CAP
+static uint32_t g_cap5_ring[CAP_NEDGES];
+static struct stm32l4_cap_s g_cap5_lowerhalf =
+{
+  .ops         = &g_cap_ops,
+  .timer       = 5,
+  .channel     = CONFIG_STM32L4_TIM5_CAP_CHANNEL,
+  .clock       = CONFIG_STM32L4_TIM5_CAP_CLOCK,
+  .mask        = 0xffffffff,
+  .paddr       = CAP_CCR(STM32L4_TIM5_BASE,
+                         CONFIG_STM32L4_TIM5_CAP_CHANNEL),
+  .pincfg      = CAP_PIN(GPIO_TIM5_CH, CONFIG_STM32L4_TIM5_CAP_CHANNEL),
+  .dmachan     = CAP_DMA(DMACHAN_TIM5_CH, CONFIG_STM32L4_TIM5_CAP_CHANNEL),
+  .ring        = g_cap5_ring,
+};
+#endif
+
+#ifdef CONFIG_STM32L4_TIM8_CAP
+static uint32_t g_cap8_ring[CAP_NEDGES];
+static struct stm32l4_cap_s g_cap8_lowerhalf =
+{
+  .ops         = &g_cap_ops,
+  .timer       = 8,
+  .channel     = CONFIG_STM32L4_TIM8_CAP_CHANNEL,
+  .clock       = CONFIG_STM32L4_TIM8_CAP_CLOCK,
+  .mask        = 0xffff,
+  .paddr       = CAP_CCR(STM32L4_TIM8_BASE,
+                         CONFIG_STM32L4_TIM8_CAP_CHANNEL),
+  .pincfg      = CAP_PIN(GPIO_TIM8_CH, CONFIG_STM32L4_TIM8_CAP_CHANNEL),
+  .dmachan     = CAP_DMA(DMACHAN_TIM8_CH, CONFIG_STM32L4_TIM8_CAP_CHANNEL),
+  .ring        = g_cap8_ring,
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4_cap_written
+ *
+ * Description:
+ *   Return the number of edges written by the DMA since the start.  A
+ *   transfer complete interrupt that is still pending is recognized by the
+ *   DMA being back in the first half after the middle was passed.
+ *
+ * Assumptions:
+ *   Called in a critical section.
+ *
+ ****************************************************************************/
+
+static uint64_t stm32l4_cap_written(struct stm32l4_cap_s *priv)
+{
+  uint64_t laps = priv->laps;
+  size_t pos;
+
+  pos = CAP_NEDGES - stm32l4_dmaresidual(priv->dma);
+  if (pos >= CAP_NEDGES)
+    {
+      pos = 0;
+    }
+
+  if (priv->half && pos < CAP_NEDGES / 2)
+    {
+      laps++;
+    }
+
+  return laps * CAP_NEDGES + pos;
+}
+
+/****************************************************************************
+ * Name: stm32l4_cap_dmacallback
+ *
+ * Description:
+ *   The DMA passed the middle or the end of the ring.
+ *
+ ****************************************************************************/
+
+static void stm32l4_cap_dmacallback(DMA_HANDLE handle, uint8_t status,
+                                    void *arg)
+{
+  struct stm32l4_cap_s *priv = arg;
+
+  if (status & DMA_STATUS_TCIF)
+    {
+      priv->laps++;
+      priv->half = false;
+    }
+  else if (status & DMA_STATUS_HTIF)
+    {
+      priv->half = true;
+    }
+
+  if (status & DMA_STATUS_TEIF)
+    {
+      cperr("TIM%d capture DMA error\n", priv->timer);
+    }
+
+  if (priv->waiting)
+    {
+      priv->waiting = false;
+      nxsem_post(&priv->waitsem);
+    }
+}
+
+/****************************************************************************
+ * Name: stm32l4_cap_start
+ *
+ * Description:
+ *   Start the timer and the DMA of the timestamps into the ring.
+ *
+ ****************************************************************************/
+
+static int stm32l4_cap_start(struct cap_lowerhalf_s *lower)
+{
+  struct stm32l4_cap_s *priv = (struct stm32l4_cap_s *)lower;
+  irqstate_t flags;
+  int ret;
+
+  DEBUGASSERT(priv->tim != NULL && priv->dma != NULL);
+
+  if (priv->started)
+    {
+      return OK;
+    }
+
+  STM32L4_TIM_SETCLOCK(priv->tim, priv->clock);
+  STM32L4_TIM_SETPERIOD(priv->tim, priv->mask);
+
+  ret = STM32L4_TIM_SETCHANNEL(priv->tim, priv->channel,
+                               STM32L4_TIM_CH_INCAPTURE);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  stm32l4_configgpio(priv->pincfg);
+
+  flags = enter_critical_section();
+
+  priv->laps    = 0;
+  priv->half    = false;
+  priv->rdpos   = 0;
+  priv->waiting = false;
+
+  stm32l4_dmasetup(priv->dma, priv->paddr, (uint32_t)priv->ring,
+                   CAP_NEDGES, CAP_DMA_CCR);
+  stm32l4_dmastart(priv->dma, stm32l4_cap_dmacallback, priv, true);
+
+  STM32L4_TIM_ENABLEDMA(priv->tim, priv->channel);
+  STM32L4_TIM_SETMODE(priv->tim, STM32L4_TIM_MODE_UP);
+  priv->started = true;
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4_cap_stop
+ ****************************************************************************/
+
+static int stm32l4_cap_stop(struct cap_lowerhalf_s *lower)
+{
+  struct stm32l4_cap_s *priv = (struct stm32l4_cap_s *)lower;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  if (priv->started)
+    {
+      STM32L4_TIM_DISABLEDMA(priv->tim, priv->channel);
+      STM32L4_TIM_SETMODE(priv->tim, STM32L4_TIM_MODE_DISABLED);
+      STM32L4_TIM_SETCHANNEL(priv->tim, priv->channel,
+                             STM32L4_TIM_CH_DISABLED);
+      stm32l4_dmastop(priv->dma);
+      priv->started = false;
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4_cap_getfreq
+ *
+ * Description:
+ *   Return the frequency of the last CAP_FREQ_EDGES edges, or zero if
+ *   there are not two yet.
+ *
+ ****************************************************************************/
+
+static int stm32l4_cap_getfreq(struct cap_lowerhalf_s *lower,
+                               uint32_t *freq)
+{
+  struct stm32l4_cap_s *priv = (struct stm32l4_cap_s *)lower;
+  irqstate_t flags;
+  uint64_t written;
+  uint32_t first;
+  uint32_t last;
+  uint32_t ticks;
+  uint32_t n;
+
+  flags   = enter_critical_section();
+  written = priv->started ? stm32l4_cap_written(priv) : 0;
+  n       = written < CAP_FREQ_EDGES ? written : CAP_FREQ_EDGES;
+  if (n >= 2)
+    {
+      first = priv->ring[(written - n) % CAP_NEDGES];
+      last  = priv->ring[(written - 1) % CAP_NEDGES];
+    }
+
+  leave_critical_section(flags);
+
+  *freq = 0;
+  if (n >= 2)
+    {
+      ticks = (last - first) & priv->mask;
+      if (ticks > 0)
+        {
+          *freq = (uint32_t)((uint64_t)priv->clock * (n - 1) / ticks);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4_cap_read
+ *
+ * Description:
+ *   Copy the timestamps captured since the last read.  A blocking read
+ *   waits for the DMA to pass the middle or the end of the ring.  If more
+ *   than the whole ring has been captured since the last read, the oldest
+ *   timestamps were overwritten: the reader skips to the newest edge and
+ *   -EOVERFLOW is returned.
+ *
+ ****************************************************************************/
+
+static ssize_t stm32l4_cap_read(struct cap_lowerhalf_s *lower,
+                                uint32_t *edges, size_t nedges,
+                                bool nonblock)
+{
+  struct stm32l4_cap_s *priv = (struct stm32l4_cap_s *)lower;
+  irqstate_t flags;
+  uint64_t written;
+  size_t avail;
+  size_t first;
+  size_t pos;
+  ssize_t ret;
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  flags = enter_critical_section();
+  for (; ; )
+    {
+      if (!priv->started)
+        {
+          ret = -EAGAIN;
+          goto errout_in_critical;
+        }
+
+      written = stm32l4_cap_written(priv);
+      if (written - priv->rdpos > CAP_NEDGES)
+        {
+          priv->rdpos = written;
+          ret = -EOVERFLOW;
+          goto errout_in_critical;
+        }
+
+      if (written != priv->rdpos)
+        {
+          break;
+        }
+
+      if (nonblock)
+        {
+          ret = -EAGAIN;
+          goto errout_in_critical;
+        }
+
+      priv->waiting = true;
+      ret = nxsem_wait(&priv->waitsem);
+      if (ret < 0)
+        {
+          priv->waiting = false;
+          goto errout_in_critical;
+        }
+    }
+
+  leave_critical_section(flags);
+
+  /* Copy out of the ring while the DMA continues */
+
+  avail = written - priv->rdpos;
+  if (avail > nedges)
+    {
+      avail = nedges;
+    }
+
+  pos   = priv->rdpos % CAP_NEDGES;
+  first = CAP_NEDGES - pos;
+  if (first > avail)
+    {
+      first = avail;
+    }
+
+  memcpy(edges, &priv->ring[pos], first * sizeof(uint32_t));
+  memcpy(edges + first, priv->ring, (avail - first) * sizeof(uint32_t));
+
+  /* The copy is only valid if the DMA did not come round meanwhile */
+
+  flags   = enter_critical_section();
+  written = stm32l4_cap_written(priv);
+  if (written - priv->rdpos > CAP_NEDGES)
+    {
+      priv->rdpos = written;
+      ret = -EOVERFLOW;
+    }
+  else
+    {
+      priv->rdpos += avail;
+      ret = avail;
+    }
+
+errout_in_critical:
+  leave_critical_section(flags);
+  nxmutex_unlock(&priv->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4_cap_initialize
+ *
+ * Description:
+ *   Initialize one timer for use with the upper_level capture driver.
+ *
+ * Input Parameters:
+ *   timer - A number identifying the timer use.
+ *
+ * Returned Value:
+ *   On success, a pointer to the STM32L4 lower half capture driver is
+ *   returned.  NULL is returned on any failure.
+ *
+ ****************************************************************************/
+
+struct cap_lowerhalf_s *stm32l4_cap_initialize(int timer)
+{
+  struct stm32l4_cap_s *priv;
+
+  switch (timer)
+    {
+#ifdef CONFIG_STM32L4_TIM1_CAP
+      case 1:
+        priv = &g_cap1_lowerhalf;
+        break;
+#endif
+#ifdef CONFIG_STM32L4_TIM2_CAP
+      case 2:
+        priv = &g_cap2_lowerhalf;
+        break;
+#endif
+#ifdef CONFIG_STM32L4_TIM3_CAP
+      case 3:
+        priv = &g_cap3_lowerhalf;
+        break;
+#endif
+#ifdef CONFIG_STM32L4_TIM4_CAP
+      case 4:
+        priv = &g_cap4_lowerhalf;
+        break;
+#endif
+#ifdef CONFIG_STM32L4_TIM5_CAP
+      case 5:
+        priv = &g_cap5_lowerhalf;
+        break;
+#endif
+#ifdef CONFIG_STM32L4_TIM8_CAP
+      case 8:
+        priv = &g_cap8_lowerhalf;
+        break;
+#endif
+      default:
+        return NULL;
+    }
+
+  if (priv->tim != NULL)
+    {
+      return (struct cap_lowerhalf_s *)priv;
+    }
+
+  priv->tim = stm32l4_tim_init(timer);
+  if (priv->tim == NULL)
+    {
+      return NULL;
+    }
+
+  priv->dma = stm32l4_dmachannel(priv->dmachan);
+  if (priv->dma == NULL)
+    {
+      stm32l4_tim_deinit(priv->tim);
+      priv->tim = NULL;
+      return NULL;
+    }
+
+  nxmutex_init(&priv->lock);
+  nxsem_init(&priv->waitsem, 0, 0);
+
+  return (struct cap_lowerhalf_s *)priv;
+}
+
+#endif /* CONFIG_STM32L4_CAP */
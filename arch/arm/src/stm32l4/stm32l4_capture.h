@@ -0,0 +1,78 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_capture.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_SRC_STM32L4_STM32L4_CAPTURE_H
+#define __ARCH_ARM_SRC_STM32L4_STM32L4_CAPTURE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/timers/capture.h>
+
+#ifdef CONFIG_STM32L4_CAP
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifndef __ASSEMBLY__
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: stm32l4_cap_initialize
+ *
+ * Description:
+ *   Initialize one timer for use with the upper_level capture driver.  The
+ *   edges on the input channel selected by CONFIG_STM32L4_TIMn_CAP_CHANNEL
+ *   are timestamped by the timer and transferred by DMA into a ring of
+ *   CONFIG_STM32L4_CAP_NEDGES entries, from which read() returns them.
+ *
+ * Input Parameters:
+ *   timer - A number identifying the timer use.  The number of valid timer
+ *     IDs varies with the STM32 MCU and MCU family but is somewhere in
+ *     the range of {1,..,5,8}.
+ *
+ * Returned Value:
+ *   On success, a pointer to the STM32L4 lower half capture driver is
+ *   returned.  NULL is returned on any failure.
+ *
+ ****************************************************************************/
+
+struct cap_lowerhalf_s *stm32l4_cap_initialize(int timer);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __ASSEMBLY__ */
+#endif /* CONFIG_STM32L4_CAP */
+#endif /* __ARCH_ARM_SRC_STM32L4_STM32L4_CAPTURE_H */
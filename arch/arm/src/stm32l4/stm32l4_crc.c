@@ -0,0 +1,358 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_crc.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/param.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/init.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+
+#include "arm_internal.h"
+#include "hardware/stm32l4_crc.h"
+
+#ifdef CONFIG_STM32L4_CRC_DMA
+#  include "stm32l4_dma.h"
+#endif
+
+#ifdef CONFIG_ARCH_CRC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Shorter buffers are cheaper with the tables of libc than taking the
+ * lock of the unit.
+ */
+
+#define CRC_MINLEN            16
+
+/* The CRC-32 of libc is bit-reflected, the CRC-16 is not.  Bytes are fed
+ * through DR with 8-bit accesses, words with 32-bit accesses.
+ */
+
+#define CRC_CR32              (CRC_CR_POLYSIZE_32 | CRC_CR_REVOUT)
+#define CRC_CR16              (CRC_CR_POLYSIZE_16 | CRC_CR_REVIN_NONE)
+#define CRC_POL32             0x04c11db7
+#define CRC_POL16             0x1021
+
+#ifdef CONFIG_STM32L4_CRC_DMA
+#  if defined(CONFIG_STM32L4_CRC_DMA2) || !defined(CONFIG_STM32L4_DMA1)
+#    define CRC_DMAMAP        DMAMAP_MAP(DMA2, 0)
+#  else
+#    define CRC_DMAMAP        DMAMAP_MAP(DMA1, 0)
+#  endif
+
+/* The channel writes DR from memory, at low priority */
+
+#  define CRC_DMACCR          (DMA_CCR_MEM2MEM | DMA_CCR_PRILO | \
+                               DMA_CCR_MINC | DMA_CCR_DIR)
+#  define CRC_DMAMAXTRANSFERS 65535
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct stm32l4_crc_s
+{
+  mutex_t    lock;         /* Held while the unit computes */
+#ifdef CONFIG_STM32L4_CRC_DMA
+  sem_t      done;         /* End of a DMA transfer */
+  DMA_HANDLE dma;          /* Reserved at the first DMA transfer */
+  uint8_t    status;       /* DMA status of the last transfer */
+#endif
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct stm32l4_crc_s g_crc =
+{
+  .lock = NXMUTEX_INITIALIZER,
+#ifdef CONFIG_STM32L4_CRC_DMA
+  .done = SEM_INITIALIZER(0),
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: crc_reflect
+ *
+ * Description:
+ *   Reverse the bit order of a word.  The unit computes the reflected
+ *   CRC-32 on the reversed register.
+ *
+ ****************************************************************************/
+
+static inline uint32_t crc_reflect(uint32_t value)
+{
+  uint32_t result;
+
+  __asm__ ("rbit %0, %1" : "=r"(result) : "r"(value));
+  return result;
+}
+
+#ifdef CONFIG_STM32L4_CRC_DMA
+/****************************************************************************
+ * Name: crc_dmacallback
+ ****************************************************************************/
+
+static void crc_dmacallback(DMA_HANDLE handle, uint8_t status,
+                            FAR void *arg)
+{
+  FAR struct stm32l4_crc_s *priv = arg;
+
+  priv->status = status;
+  nxsem_post(&priv->done);
+}
+
+/****************************************************************************
+ * Name: crc_dmafeed
+ *
+ * Description:
+ *   Feed items of (1 << shift) bytes to DR with the DMA and wait for the
+ *   end of the transfer.
+ *
+ * Returned Value:
+ *   The number of bytes fed, zero if the DMA could not be used.
+ *
+ ****************************************************************************/
+
+static size_t crc_dmafeed(FAR struct stm32l4_crc_s *priv,
+                          FAR const uint8_t *src, size_t len, int shift)
+{
+  uint32_t ccr = CRC_DMACCR | (shift << DMA_CCR_PSIZE_SHIFT) |
+                 (shift << DMA_CCR_MSIZE_SHIFT);
+  size_t ntransfers = len >> shift;
+  size_t done = 0;
+
+  if (len < CONFIG_STM32L4_CRC_DMA_THRESHOLD ||
+      !stm32l4_dmacapable((uintptr_t)src, ntransfers, ccr))
+    {
+      return 0;
+    }
+
+  if (priv->dma == NULL)
+    {
+      priv->dma = stm32l4_dmachannel(CRC_DMAMAP);
+      if (priv->dma == NULL)
+        {
+          return 0;
+        }
+    }
+
+  while (ntransfers > 0)
+    {
+      size_t n = MIN(ntransfers, CRC_DMAMAXTRANSFERS);
+
+      stm32l4_dmasetup(priv->dma, STM32L4_CRC_DR,
+                       (uint32_t)(uintptr_t)src + done, n, ccr);
+      stm32l4_dmastart(priv->dma, crc_dmacallback, priv, false);
+      nxsem_wait_uninterruptible(&priv->done);
+
+      if ((priv->status & DMA_STATUS_ERROR) != 0)
+        {
+          /* The words that were fed are unknown.  The caller starts
+           * over in software.
+           */
+
+          stm32l4_dmastop(priv->dma);
+          return SIZE_MAX;
+        }
+
+      done       += n << shift;
+      ntransfers -= n;
+    }
+
+  return done;
+}
+#endif
+
+/****************************************************************************
+ * Name: crc_feed
+ *
+ * Description:
+ *   Feed a buffer to the unit: the bytes up to word alignment and after
+ *   the last word one at a time, the words in between with 32-bit writes
+ *   or with the DMA.  A word is computed in the order of its most
+ *   significant bit, so for the CRC-32 the bits of each word are reversed
+ *   by the unit and for the CRC-16 its bytes are swapped by the CPU; the
+ *   DMA feeds the CRC-16 bytewise for that reason.
+ *
+ * Returned Value:
+ *   OK, or -EIO if a DMA transfer failed.
+ *
+ ****************************************************************************/
+
+static int crc_feed(FAR struct stm32l4_crc_s *priv, FAR const uint8_t *src,
+                    size_t len, bool reflect)
+{
+  size_t done;
+
+  while (len > 0 && ((uintptr_t)src & 3) != 0)
+    {
+      putreg8(*src++, STM32L4_CRC_DR);
+      len--;
+    }
+
+#ifdef CONFIG_STM32L4_CRC_DMA
+  if (reflect)
+    {
+      modifyreg32(STM32L4_CRC_CR, CRC_CR_REVIN_MASK, CRC_CR_REVIN_WORD);
+      done = crc_dmafeed(priv, src, len & ~3, 2);
+    }
+  else
+    {
+      done = crc_dmafeed(priv, src, len, 0);
+    }
+
+  if (done == SIZE_MAX)
+    {
+      return -EIO;
+    }
+
+  src += done;
+  len -= done;
+#else
+  if (reflect)
+    {
+      modifyreg32(STM32L4_CRC_CR, CRC_CR_REVIN_MASK, CRC_CR_REVIN_WORD);
+    }
+#endif
+
+  for (done = 0; done + 4 <= len; done += 4)
+    {
+      uint32_t word = *(FAR const uint32_t *)(src + done);
+
+      putreg32(reflect ? word : __builtin_bswap32(word), STM32L4_CRC_DR);
+    }
+
+  if (reflect)
+    {
+      modifyreg32(STM32L4_CRC_CR, CRC_CR_REVIN_MASK, CRC_CR_REVIN_BYTE);
+    }
+
+  for (; done < len; done++)
+    {
+      putreg8(src[done], STM32L4_CRC_DR);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: crc_compute
+ *
+ * Description:
+ *   Compute a CRC of the given configuration starting from 'init'.
+ *
+ ****************************************************************************/
+
+static int crc_compute(FAR const uint8_t *src, size_t len, uint32_t cr,
+                       uint32_t pol, FAR uint32_t *crc)
+{
+  FAR struct stm32l4_crc_s *priv = &g_crc;
+  bool reflect = (cr & CRC_CR_REVOUT) != 0;
+  int ret;
+
+  /* The lock cannot be waited for in an interrupt handler or before the
+   * scheduler runs; the software CRC is used then.
+   */
+
+  if (len < CRC_MINLEN || up_interrupt_context() || !OSINIT_OS_READY())
+    {
+      return -EBUSY;
+    }
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  putreg32(pol, STM32L4_CRC_POL);
+  putreg32(reflect ? crc_reflect(*crc) : *crc, STM32L4_CRC_INIT);
+  putreg32(cr | (reflect ? CRC_CR_REVIN_BYTE : 0) | CRC_CR_RESET,
+           STM32L4_CRC_CR);
+
+  ret = crc_feed(priv, src, len, reflect);
+  if (ret >= 0)
+    {
+      *crc = getreg32(STM32L4_CRC_DR);
+    }
+
+  nxmutex_unlock(&priv->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_crc32part
+ *
+ * Description:
+ *   Continue the CRC-32 of crc32part() with the CRC unit.
+ *
+ ****************************************************************************/
+
+int up_crc32part(FAR const uint8_t *src, size_t len, FAR uint32_t *crc)
+{
+  return crc_compute(src, len, CRC_CR32, CRC_POL32, crc);
+}
+
+/****************************************************************************
+ * Name: up_crc16part
+ *
+ * Description:
+ *   Continue the CRC-16 of crc16part() with the CRC unit.
+ *
+ ****************************************************************************/
+
+int up_crc16part(FAR const uint8_t *src, size_t len, FAR uint16_t *crc)
+{
+  uint32_t value = *crc;
+  int ret;
+
+  ret = crc_compute(src, len, CRC_CR16, CRC_POL16, &value);
+  if (ret >= 0)
+    {
+      *crc = (uint16_t)value;
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_ARCH_CRC */
@@ -28,6 +28,7 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
@@ -35,6 +36,9 @@
 #include <arch/board/board.h>
 #include <nuttx/irq.h>
 #include <nuttx/analog/dac.h>
+#include <nuttx/analog/ioctl.h>
+
+#include <arch/chip/dac.h>
 
 #include "arm_internal.h"
 #include "chip.h"
@@ -42,6 +46,7 @@
 #include "stm32l4_dac.h"
 #include "stm32l4_rcc.h"
 #include "stm32l4_dma.h"
+#include "stm32l4_dmacopy.h"
 
 #ifdef CONFIG_DAC
 
@@ -288,6 +293,32 @@
                               DMA_CCR_CIRC | \
                               DMA_CCR_DIR)
 
+/* Dual mode: one 32-bit transfer updates both channels through DHR12RD */
+
+#define DAC_DUALDMA_CONTROL_WORD (DMA_CCR_MSIZE_32BITS | \
+                                  DMA_CCR_PSIZE_32BITS | \
+                                  DMA_CCR_MINC | \
+                                  DMA_CCR_CIRC | \
+                                  DMA_CCR_DIR)
+
+#ifndef HAVE_DMA
+#  undef CONFIG_STM32L4_DAC_WAVEFORM
+#endif
+
+#if !defined(CONFIG_STM32L4_DAC_WAVEFORM) || \
+    !defined(CONFIG_STM32L4_DAC1_DMA) || !defined(CONFIG_STM32L4_DAC2)
+#  undef CONFIG_STM32L4_DAC_DUAL
+#endif
+
+/* States of a waveform table swap: the first half of the new table is
+ * copied once the DMA has left the first half of the buffer, the second
+ * half once the DMA has wrapped around into the (new) first half.
+ */
+
+#define DAC_SWAP_NONE        0
+#define DAC_SWAP_PENDING     1
+#define DAC_SWAP_FIRSTHALF   2
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -327,6 +358,14 @@ struct stm32_chan_s
   int        result;     /* DMA result */
   uint16_t   buffer_pos; /* Position in dmabuffer where to write new value */
   uint16_t   *dmabuffer; /* DMA transfer buffer */
+  uint32_t   tclk;       /* Timer input clock frequency */
+#endif
+#ifdef CONFIG_STM32L4_DAC_WAVEFORM
+  uint8_t    wave   : 1; /* True, a waveform is playing */
+  uint8_t    dual   : 1; /* True, the waveform drives both channels */
+  uint8_t    swap;       /* Table swap state (DAC_SWAP_*) */
+  uint16_t   wavelen;    /* DMA transfers per waveform period */
+  uint16_t   *wavebuf;   /* Staging buffer of a table swap */
 #endif
 };
 
@@ -358,8 +397,16 @@ static int  dac_ioctl(struct dac_dev_s *dev, int cmd, unsigned long arg);
 /* Initialization */
 
 #ifdef HAVE_DMA
+static void dac_timfreq(struct stm32_chan_s *chan, uint32_t frequency);
 static int  dac_timinit(struct stm32_chan_s *chan);
 #endif
+#ifdef CONFIG_STM32L4_DAC_WAVEFORM
+static int  dac_wavestart(struct stm32_chan_s *chan,
+                          const struct stm32l4_dac_wave_s *wave);
+static int  dac_waveswap(struct stm32_chan_s *chan,
+                         const struct stm32l4_dac_wave_s *wave);
+static void dac_wavestop(struct stm32_chan_s *chan);
+#endif
 static int  dac_chaninit(struct stm32_chan_s *chan);
 static void dac_blockinit(void);
 
@@ -406,7 +453,12 @@ static const struct stm32_dac_ops_s g_dac_llops =
 /* Channel 1 */
 
 #ifdef CONFIG_STM32L4_DAC1_DMA
-uint16_t stm32l4_dac1_dmabuffer[CONFIG_STM32L4_DAC1_DMA_BUFFER_SIZE];
+uint16_t stm32l4_dac1_dmabuffer[CONFIG_STM32L4_DAC1_DMA_BUFFER_SIZE]
+  aligned_data(4);
+#  ifdef CONFIG_STM32L4_DAC_WAVEFORM
+static uint16_t g_dac1_wavebuffer[CONFIG_STM32L4_DAC1_DMA_BUFFER_SIZE]
+  aligned_data(4);
+#  endif
 #endif
 
 static struct stm32_chan_s g_dac1priv =
@@ -431,6 +483,9 @@ static struct stm32_chan_s g_dac1priv =
   .tsel       = DAC1_TSEL_VALUE,
   .tbase      = DAC1_TIMER_BASE,
   .tfrequency = CONFIG_STM32L4_DAC1_TIMER_FREQUENCY,
+#  ifdef CONFIG_STM32L4_DAC_WAVEFORM
+  .wavebuf    = g_dac1_wavebuffer,
+#  endif
 #endif
 };
 
@@ -446,7 +501,12 @@ static struct dac_dev_s g_dac1dev =
 /* Channel 2 */
 
 #ifdef CONFIG_STM32L4_DAC2_DMA
-uint16_t stm32l4_dac2_dmabuffer[CONFIG_STM32L4_DAC2_DMA_BUFFER_SIZE];
+uint16_t stm32l4_dac2_dmabuffer[CONFIG_STM32L4_DAC2_DMA_BUFFER_SIZE]
+  aligned_data(4);
+#  ifdef CONFIG_STM32L4_DAC_WAVEFORM
+static uint16_t g_dac2_wavebuffer[CONFIG_STM32L4_DAC2_DMA_BUFFER_SIZE]
+  aligned_data(4);
+#  endif
 #endif
 
 static struct stm32_chan_s g_dac2priv =
@@ -471,6 +531,9 @@ static struct stm32_chan_s g_dac2priv =
   .tsel       = DAC2_TSEL_VALUE,
   .tbase      = DAC2_TIMER_BASE,
   .tfrequency = CONFIG_STM32L4_DAC2_TIMER_FREQUENCY,
+#  ifdef CONFIG_STM32L4_DAC_WAVEFORM
+  .wavebuf    = g_dac2_wavebuffer,
+#  endif
 #endif
 };
 
@@ -803,6 +866,15 @@ static int dac_send(struct dac_dev_s *dev, struct dac_msg_s *msg)
 {
   struct stm32_chan_s *chan = dev->ad_priv;
 
+#ifdef CONFIG_STM32L4_DAC_WAVEFORM
+  /* The DMA buffer belongs to the waveform while it is playing */
+
+  if (chan->wave)
+    {
+      return -EBUSY;
+    }
+#endif
+
   /* Enable DAC Channel */
 
   stm32l4_dac_modify_cr(chan, 0, DAC_CR_EN);
@@ -870,6 +942,310 @@ static int dac_send(struct dac_dev_s *dev, struct dac_msg_s *msg)
   return OK;
 }
 
+/****************************************************************************
+ * Name: dac_wavecallback
+ *
+ * Description:
+ *   Circular DMA half and full transfer callback of a playing waveform.
+ *   Completes a pending table swap, one half of the buffer at a time,
+ *   while the DMA is replaying the other half.
+ *
+ * Input Parameters:
+ *   handle - The DMA handle
+ *   isr    - The interrupt status of the DMA transfer
+ *   arg    - A reference to the DAC channel state data
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_DAC_WAVEFORM
+static void dac_wavecallback(DMA_HANDLE handle, uint8_t isr, void *arg)
+{
+  struct stm32_chan_s *chan = (struct stm32_chan_s *)arg;
+  unsigned int half = chan->wavelen >> 1;
+  size_t size;
+  size_t offset;
+
+  DEBUGASSERT(chan != NULL);
+
+  if ((isr & DMA_CHAN_TEIF_BIT) != 0)
+    {
+      aerr("ERROR: DAC%d waveform DMA error\n", chan->intf + 1);
+      dac_wavestop(chan);
+      chan->result = -EIO;
+      return;
+    }
+
+  /* Halves are in 16-bit words: one sample, or two in dual mode */
+
+  size   = (chan->dual ? 4 : 2) * half;
+  offset = size >> 1;
+
+  /* Ready half 0: the DMA has moved on to the second half */
+
+  if (stm32l4_dmaresidual(handle) <= half)
+    {
+      if (chan->swap == DAC_SWAP_PENDING)
+        {
+          memcpy(chan->dmabuffer, chan->wavebuf, size);
+          chan->swap = DAC_SWAP_FIRSTHALF;
+        }
+    }
+  else if (chan->swap == DAC_SWAP_FIRSTHALF)
+    {
+      memcpy(&chan->dmabuffer[offset], &chan->wavebuf[offset], size);
+      chan->swap = DAC_SWAP_NONE;
+    }
+}
+
+/****************************************************************************
+ * Name: dac_wavecheck
+ *
+ * Description:
+ *   Validate a waveform description against the capabilities of a channel.
+ *
+ * Input Parameters:
+ *   chan - A reference to the DAC channel state data
+ *   wave - The waveform description
+ *
+ * Returned Value:
+ *   The number of 16-bit words in the table; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+static int dac_wavecheck(struct stm32_chan_s *chan,
+                         const struct stm32l4_dac_wave_s *wave)
+{
+  int nwords;
+
+  if (!chan->hasdma)
+    {
+      return -ENOSYS;
+    }
+
+  if (wave == NULL || wave->wv_samples == NULL ||
+      wave->wv_nsamples < 2 || (wave->wv_nsamples & 1) != 0)
+    {
+      return -EINVAL;
+    }
+
+  nwords = wave->wv_nsamples;
+  if ((wave->wv_flags & STM32L4_DACWAVE_DUAL) != 0)
+    {
+#ifdef CONFIG_STM32L4_DAC_DUAL
+      if (chan->intf != 0)
+#endif
+        {
+          return -EINVAL;
+        }
+
+      nwords <<= 1;
+    }
+
+#ifdef CONFIG_STM32L4_DAC_DUAL
+  /* The channels are not independent while DAC1 drives both of them */
+
+  if (chan == &g_dac2priv ? g_dac1priv.dual :
+      (nwords > wave->wv_nsamples && g_dac2priv.wave))
+    {
+      return -EBUSY;
+    }
+#endif
+
+  if (nwords > chan->buffer_len)
+    {
+      return -E2BIG;
+    }
+
+  return nwords;
+}
+
+/****************************************************************************
+ * Name: dac_wavestart
+ *
+ * Description:
+ *   Start continuous circular playback of a waveform table.  A waveform
+ *   that is already playing on the channel is replaced immediately.
+ *
+ * Input Parameters:
+ *   chan - A reference to the DAC channel state data
+ *   wave - The waveform description
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int dac_wavestart(struct stm32_chan_s *chan,
+                         const struct stm32l4_dac_wave_s *wave)
+{
+  irqstate_t flags;
+  uint32_t paddr = chan->dro;
+  uint32_t ccr = DAC_DMA_CONTROL_WORD;
+  int nwords;
+
+  nwords = dac_wavecheck(chan, wave);
+  if (nwords < 0)
+    {
+      return nwords;
+    }
+
+  if (chan->wave)
+    {
+      dac_wavestop(chan);
+    }
+
+  stm32l4_dmacopy(chan->dmabuffer, wave->wv_samples,
+                  nwords * sizeof(uint16_t), NULL, NULL);
+
+  if (wave->wv_rate > 0)
+    {
+      dac_timfreq(chan, wave->wv_rate);
+    }
+
+  chan->dual    = (wave->wv_flags & STM32L4_DACWAVE_DUAL) != 0;
+  chan->wavelen = wave->wv_nsamples;
+  chan->swap    = DAC_SWAP_NONE;
+
+#ifdef CONFIG_STM32L4_DAC_DUAL
+  if (chan->dual)
+    {
+      /* DAC2 follows the trigger of DAC1; only DAC1 requests the DMA */
+
+      paddr = STM32L4_DAC_DHR12RD;
+      ccr   = DAC_DUALDMA_CONTROL_WORD;
+
+      stm32l4_dac_modify_cr(&g_dac2priv, DAC_CR_TSEL_MASK | DAC_CR_DMAEN,
+                            chan->tsel | DAC_CR_TEN | DAC_CR_EN);
+    }
+#endif
+
+  flags = enter_critical_section();
+
+  stm32l4_dmasetup(chan->dma, paddr, (uint32_t)chan->dmabuffer,
+                   chan->wavelen, ccr);
+
+  chan->result = OK;
+  chan->wave   = 1;
+  stm32l4_dmastart(chan->dma, dac_wavecallback, chan, true);
+
+  stm32l4_dac_modify_cr(chan, 0, DAC_CR_EN | DAC_CR_DMAEN);
+
+  /* Restart the timer period so that both channels start together */
+
+  tim_modifyreg(chan, STM32L4_GTIM_EGR_OFFSET, 0, GTIM_EGR_UG);
+  leave_critical_section(flags);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dac_waveswap
+ *
+ * Description:
+ *   Stage a new table that replaces the playing one at the end of the
+ *   current period.
+ *
+ * Input Parameters:
+ *   chan - A reference to the DAC channel state data
+ *   wave - The new waveform description
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int dac_waveswap(struct stm32_chan_s *chan,
+                        const struct stm32l4_dac_wave_s *wave)
+{
+  irqstate_t flags;
+  int nwords;
+
+  nwords = dac_wavecheck(chan, wave);
+  if (nwords < 0)
+    {
+      return nwords;
+    }
+
+  if (!chan->wave)
+    {
+      return -EPERM;
+    }
+
+  if (wave->wv_nsamples != chan->wavelen ||
+      ((wave->wv_flags & STM32L4_DACWAVE_DUAL) != 0) != chan->dual)
+    {
+      return -EINVAL;
+    }
+
+  if (chan->swap != DAC_SWAP_NONE)
+    {
+      return -EBUSY;
+    }
+
+  /* The staging buffer is only read by the DMA callback once the swap has
+   * been armed.
+   */
+
+  stm32l4_dmacopy(chan->wavebuf, wave->wv_samples,
+                  nwords * sizeof(uint16_t), NULL, NULL);
+
+  flags = enter_critical_section();
+  chan->swap = DAC_SWAP_PENDING;
+  leave_critical_section(flags);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dac_wavestop
+ *
+ * Description:
+ *   Stop the waveform playback of a channel.  The outputs keep the last
+ *   converted value.
+ *
+ * Input Parameters:
+ *   chan - A reference to the DAC channel state data
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void dac_wavestop(struct stm32_chan_s *chan)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  stm32l4_dmastop(chan->dma);
+  stm32l4_dac_modify_cr(chan, DAC_CR_DMAEN, 0);
+
+#ifdef CONFIG_STM32L4_DAC_DUAL
+  if (chan->dual)
+    {
+      /* Give DAC2 its own trigger back */
+
+      stm32l4_dac_modify_cr(&g_dac2priv, DAC_CR_TSEL_MASK,
+                            g_dac2priv.tsel);
+      if (!g_dac2priv.hasdma)
+        {
+          stm32l4_dac_modify_cr(&g_dac2priv, DAC_CR_TEN, 0);
+        }
+    }
+#endif
+
+  chan->wave = 0;
+  chan->dual = 0;
+  chan->swap = DAC_SWAP_NONE;
+
+  leave_critical_section(flags);
+}
+#endif
+
 /****************************************************************************
  * Name: dac_ioctl
  *
@@ -885,9 +1261,120 @@ static int dac_send(struct dac_dev_s *dev, struct dac_msg_s *msg)
 
 static int dac_ioctl(struct dac_dev_s *dev, int cmd, unsigned long arg)
 {
+#ifdef CONFIG_STM32L4_DAC_WAVEFORM
+  struct stm32_chan_s *chan = dev->ad_priv;
+
+  switch (cmd)
+    {
+      case ANIOC_STM32L4_DAC_WAVESTART:
+        return dac_wavestart(chan,
+                             (const struct stm32l4_dac_wave_s *)arg);
+
+      case ANIOC_STM32L4_DAC_WAVESWAP:
+        return dac_waveswap(chan,
+                            (const struct stm32l4_dac_wave_s *)arg);
+
+      case ANIOC_STM32L4_DAC_WAVESTOP:
+        if (chan->wave)
+          {
+            dac_wavestop(chan);
+          }
+
+        return OK;
+
+      default:
+        break;
+    }
+#endif
+
   return -ENOTTY;
 }
 
+/****************************************************************************
+ * Name: dac_timfreq
+ *
+ * Description:
+ *   Program the prescaler and reload registers of the timer that drives
+ *   the DAC DMA for this channel so that it triggers at 'frequency'.
+ *
+ * Input Parameters:
+ *   chan      - A reference to the DAC channel state data
+ *   frequency - The trigger (sample) frequency in Hz
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_DMA
+static void dac_timfreq(struct stm32_chan_s *chan, uint32_t frequency)
+{
+  uint32_t prescaler;
+  uint32_t timclk;
+  uint32_t reload;
+
+  /* Calculate optimal values for the timer prescaler and for the timer
+   * reload register.  If 'frequency' is the desired frequency, then
+   *
+   *   reload = timclk / frequency
+   *   timclk = tclk / presc
+   *
+   * Or,
+   *
+   *   reload = tclk / presc / frequency
+   *
+   * There are many solutions to this this, but the best solution will be the
+   * one that has the largest reload value and the smallest prescaler value.
+   * That is the solution that should give us the most accuracy in the timer
+   * control.  Subject to:
+   *
+   *   0 <= presc  <= 65536
+   *   1 <= reload <= 65535
+   *
+   * So presc = tclk / 65535 / frequency would be optimal.
+   *
+   * Example:
+   *
+   *  tclk      = 42 MHz
+   *  frequency = 100 Hz
+   *
+   *  prescaler = 42,000,000 / 65,535 / 100
+   *            = 6.4 (or 7 -- taking the ceiling always)
+   *  timclk    = 42,000,000 / 7
+   *            = 6,000,000
+   *  reload    = 6,000,000 / 100
+   *            = 60,000
+   */
+
+  prescaler = (chan->tclk / frequency + 65534) / 65535;
+  if (prescaler < 1)
+    {
+      prescaler = 1;
+    }
+  else if (prescaler > 65536)
+    {
+      prescaler = 65536;
+    }
+
+  timclk = chan->tclk / prescaler;
+
+  reload = timclk / frequency;
+  if (reload < 1)
+    {
+      reload = 1;
+    }
+  else if (reload > 65535)
+    {
+      reload = 65535;
+    }
+
+  tim_putreg(chan, STM32L4_GTIM_ARR_OFFSET, (uint16_t)reload);
+  tim_putreg(chan, STM32L4_GTIM_PSC_OFFSET, (uint16_t)(prescaler - 1));
+
+  chan->tfrequency = frequency;
+}
+#endif
+
 /****************************************************************************
  * Name: dac_timinit
  *
@@ -907,9 +1394,6 @@ static int dac_ioctl(struct dac_dev_s *dev, int cmd, unsigned long arg)
 static int dac_timinit(struct stm32_chan_s *chan)
 {
   uint32_t pclk;
-  uint32_t prescaler;
-  uint32_t timclk;
-  uint32_t reload;
   uint32_t regaddr;
   uint32_t setbits;
 
@@ -977,65 +1461,10 @@ static int dac_timinit(struct stm32_chan_s *chan)
 
   modifyreg32(regaddr, 0, setbits);
 
-  /* Calculate optimal values for the timer prescaler and for the timer
-   * reload register.  If 'frequency' is the desired frequency, then
-   *
-   *   reload = timclk / frequency
-   *   timclk = pclk / presc
-   *
-   * Or,
-   *
-   *   reload = pclk / presc / frequency
-   *
-   * There are many solutions to this this, but the best solution will be the
-   * one that has the largest reload value and the smallest prescaler value.
-   * That is the solution that should give us the most accuracy in the timer
-   * control.  Subject to:
-   *
-   *   0 <= presc  <= 65536
-   *   1 <= reload <= 65535
-   *
-   * So presc = pclk / 65535 / frequency would be optimal.
-   *
-   * Example:
-   *
-   *  pclk      = 42 MHz
-   *  frequency = 100 Hz
-   *
-   *  prescaler = 42,000,000 / 65,535 / 100
-   *            = 6.4 (or 7 -- taking the ceiling always)
-   *  timclk    = 42,000,000 / 7
-   *            = 6,000,000
-   *  reload    = 6,000,000 / 100
-   *            = 60,000
-   */
-
-  prescaler = (pclk / chan->tfrequency + 65534) / 65535;
-  if (prescaler < 1)
-    {
-      prescaler = 1;
-    }
-  else if (prescaler > 65536)
-    {
-      prescaler = 65536;
-    }
-
-  timclk = pclk / prescaler;
-
-  reload = timclk / chan->tfrequency;
-  if (reload < 1)
-    {
-      reload = 1;
-    }
-  else if (reload > 65535)
-    {
-      reload = 65535;
-    }
-
   /* Set the reload and prescaler values */
 
-  tim_putreg(chan, STM32L4_GTIM_ARR_OFFSET, (uint16_t)reload);
-  tim_putreg(chan, STM32L4_GTIM_PSC_OFFSET, (uint16_t)(prescaler - 1));
+  chan->tclk = pclk;
+  dac_timfreq(chan, chan->tfrequency);
 
   /* Count mode up, auto reload */
 
@@ -78,6 +78,23 @@
 #  undef CONFIG_STM32L4_TIM17_DAC
 #endif
 
+/* IOCTL Commands ***********************************************************
+ *
+ * ANIOC_STM32L4_DAC_WAVESTART - Start continuous circular playback of a
+ *   waveform table paced by the channel timer.
+ *   Argument: const struct stm32l4_dac_wave_s * (see arch/chip/dac.h)
+ * ANIOC_STM32L4_DAC_WAVESWAP - Replace the running table at the end of the
+ *   current period.  Fails with EBUSY while a previous swap is pending.
+ *   Argument: const struct stm32l4_dac_wave_s *
+ * ANIOC_STM32L4_DAC_WAVESTOP - Stop the waveform playback.  Argument: None
+ *
+ * The ADC uses the first commands of the AN_STM32L4 range.
+ */
+
+#define ANIOC_STM32L4_DAC_WAVESTART         _ANIOC(AN_STM32L4_FIRST + 5)
+#define ANIOC_STM32L4_DAC_WAVESWAP          _ANIOC(AN_STM32L4_FIRST + 6)
+#define ANIOC_STM32L4_DAC_WAVESTOP          _ANIOC(AN_STM32L4_FIRST + 7)
+
 /* Low-level ops helpers ****************************************************/
 
 #define DAC_ENABLE(dac,d)                            \
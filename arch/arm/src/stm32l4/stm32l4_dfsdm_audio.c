@@ -0,0 +1,1014 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_dfsdm_audio.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/queue.h>
+#include <nuttx/audio/audio.h>
+
+#include <arch/board/board.h>
+
+#include "arm_internal.h"
+#include "chip.h"
+#include "stm32l4_gpio.h"
+#include "stm32l4_dma.h"
+#include "stm32l4_rcc.h"
+#include "stm32l4_dfsdm_audio.h"
+#include "hardware/stm32l4_dfsdm.h"
+
+#ifdef CONFIG_STM32L4_DFSDM_AUDIO
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************/
+
+#define DFSDM_NMICS    CONFIG_STM32L4_DFSDM_AUDIO_NMICS
+#define DFSDM_NFRAMES  CONFIG_STM32L4_DFSDM_AUDIO_NFRAMES
+
+#if defined(CONFIG_STM32L4_STM32L4X3) && DFSDM_NMICS > 2
+#  error "The STM32L4X3 has only two DFSDM filters"
+#endif
+
+#if !defined(CONFIG_STM32L4_DMA1) && !defined(CONFIG_STM32L4_DMAMUX)
+#  error "The DFSDM audio device requires CONFIG_STM32L4_DMA1"
+#endif
+
+#ifndef GPIO_DFSDM_CKOUT
+#  error "GPIO_DFSDM_CKOUT must be defined by the board"
+#endif
+
+#ifndef GPIO_DFSDM_DATIN1
+#  error "GPIO_DFSDM_DATIN1 must be defined by the board"
+#endif
+
+#if DFSDM_NMICS > 2 && !defined(GPIO_DFSDM_DATIN3)
+#  error "GPIO_DFSDM_DATIN3 must be defined by the board"
+#endif
+
+/* The DFSDM kernel clock is SYSCLK (see the RCC setup); CKOUT is divided
+ * down from it to clock the microphones.
+ */
+
+#define DFSDM_CKOUTDIV  (STM32L4_SYSCLK_FREQUENCY / \
+                         CONFIG_STM32L4_DFSDM_AUDIO_PDMCLK)
+#define DFSDM_PDMCLK    ((uint32_t)(STM32L4_SYSCLK_FREQUENCY / DFSDM_CKOUTDIV))
+
+#if DFSDM_CKOUTDIV < 2 || DFSDM_CKOUTDIV > 256
+#  error "CONFIG_STM32L4_DFSDM_AUDIO_PDMCLK is out of range"
+#endif
+
+/* DMA requests of the filters */
+
+#ifdef DMAMAP_DFSDM0_0
+#  define DFSDM_DMA0    DMAMAP_DFSDM0_0
+#  define DFSDM_DMA1    DMAMAP_DFSDM1_0
+#  define DFSDM_DMA2    DMAMAP_DFSDM2_0
+#  define DFSDM_DMA3    DMAMAP_DFSDM3_0
+#else
+#  define DFSDM_DMA0    DMACHAN_DFSDM0
+#  define DFSDM_DMA1    DMACHAN_DFSDM1
+#  define DFSDM_DMA2    DMACHAN_DFSDM2
+#  define DFSDM_DMA3    DMACHAN_DFSDM3
+#endif
+
+#define DFSDM_DMA_CONTROL_WORD (DMA_CCR_MSIZE_32BITS | \
+                                DMA_CCR_PSIZE_32BITS | \
+                                DMA_CCR_MINC | \
+                                DMA_CCR_CIRC | \
+                                DMA_CCR_PRIHI)
+
+/* The channel bits of CHyCFGR1; the upper half of CH0CFGR1 holds the
+ * global configuration.
+ */
+
+#define DFSDM_CHCFGR1_CHMASK   0x0000ffff
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct dfsdm_audio_s
+{
+  struct audio_lowerhalf_s dev;       /* Audio lower half (must be first) */
+  struct dq_queue_s pendq;            /* Buffers waiting to be filled */
+  struct stm32l4_dfsdm_filter_s filter;
+  DMA_HANDLE dma[DFSDM_NMICS];        /* DMA channel of each filter */
+  uint32_t   lost;                    /* Frames dropped for lack of buffers */
+  uint8_t    nmics;                   /* Microphones in use */
+  uint8_t    bpsamp;                  /* Bits per sample: 16 or 32 */
+  bool       reserved;                /* True: The device is reserved */
+  bool       running;                 /* True: Started and not stopped */
+  bool       paused;                  /* True: Filters halted by pause */
+
+  /* Circular DMA buffers: two halves of DFSDM_NFRAMES samples per filter */
+
+  uint32_t dmabuf[DFSDM_NMICS][2 * DFSDM_NFRAMES];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void dfsdm_audio_hwstart(struct dfsdm_audio_s *priv);
+static void dfsdm_audio_hwstop(struct dfsdm_audio_s *priv);
+static void dfsdm_audio_dequeue(struct dfsdm_audio_s *priv,
+                                struct ap_buffer_s *apb);
+static void dfsdm_audio_deliver(struct dfsdm_audio_s *priv, int half);
+static void dfsdm_audio_dmacallback(DMA_HANDLE handle, uint8_t status,
+                                    void *arg);
+static int  dfsdm_audio_setfilter(struct dfsdm_audio_s *priv,
+                                  const struct stm32l4_dfsdm_filter_s *f);
+
+/* Audio lower half methods */
+
+static int  dfsdm_audio_getcaps(struct audio_lowerhalf_s *dev, int type,
+                                struct audio_caps_s *caps);
+static int  dfsdm_audio_shutdown(struct audio_lowerhalf_s *dev);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int  dfsdm_audio_configure(struct audio_lowerhalf_s *dev,
+                                  void *session,
+                                  const struct audio_caps_s *caps);
+static int  dfsdm_audio_start(struct audio_lowerhalf_s *dev,
+                              void *session);
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+static int  dfsdm_audio_stop(struct audio_lowerhalf_s *dev, void *session);
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+static int  dfsdm_audio_pause(struct audio_lowerhalf_s *dev,
+                              void *session);
+static int  dfsdm_audio_resume(struct audio_lowerhalf_s *dev,
+                               void *session);
+#endif
+static int  dfsdm_audio_reserve(struct audio_lowerhalf_s *dev,
+                                void **session);
+static int  dfsdm_audio_release(struct audio_lowerhalf_s *dev,
+                                void *session);
+#else
+static int  dfsdm_audio_configure(struct audio_lowerhalf_s *dev,
+                                  const struct audio_caps_s *caps);
+static int  dfsdm_audio_start(struct audio_lowerhalf_s *dev);
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+static int  dfsdm_audio_stop(struct audio_lowerhalf_s *dev);
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+static int  dfsdm_audio_pause(struct audio_lowerhalf_s *dev);
+static int  dfsdm_audio_resume(struct audio_lowerhalf_s *dev);
+#endif
+static int  dfsdm_audio_reserve(struct audio_lowerhalf_s *dev);
+static int  dfsdm_audio_release(struct audio_lowerhalf_s *dev);
+#endif
+static int  dfsdm_audio_enqueuebuffer(struct audio_lowerhalf_s *dev,
+                                      struct ap_buffer_s *apb);
+static int  dfsdm_audio_ioctl(struct audio_lowerhalf_s *dev, int cmd,
+                              unsigned long arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct audio_ops_s g_dfsdm_audio_ops =
+{
+  .getcaps       = dfsdm_audio_getcaps,
+  .configure     = dfsdm_audio_configure,
+  .shutdown      = dfsdm_audio_shutdown,
+  .start         = dfsdm_audio_start,
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+  .stop          = dfsdm_audio_stop,
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+  .pause         = dfsdm_audio_pause,
+  .resume        = dfsdm_audio_resume,
+#endif
+  .enqueuebuffer = dfsdm_audio_enqueuebuffer,
+  .ioctl         = dfsdm_audio_ioctl,
+  .reserve       = dfsdm_audio_reserve,
+  .release       = dfsdm_audio_release,
+};
+
+static const uint32_t g_dfsdm_dmamap[DFSDM_NMICS] =
+{
+  DFSDM_DMA0,
+#if DFSDM_NMICS > 1
+  DFSDM_DMA1,
+#endif
+#if DFSDM_NMICS > 2
+  DFSDM_DMA2,
+#endif
+#if DFSDM_NMICS > 3
+  DFSDM_DMA3,
+#endif
+};
+
+static struct dfsdm_audio_s g_dfsdm_audio;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dfsdm_audio_hwstart
+ *
+ * Description:
+ *   Configure the channels and filters of the microphones in use, start
+ *   their DMA and launch all filters at once.  The filters 1..n-1 run in
+ *   RSYNC mode, so the software start of FLT0 starts them all on the same
+ *   CKOUT edge and the samples of a frame belong to the same instant.
+ *
+ ****************************************************************************/
+
+static void dfsdm_audio_hwstart(struct dfsdm_audio_s *priv)
+{
+  const struct stm32l4_dfsdm_filter_s *filter = &priv->filter;
+  uint32_t fcr;
+  uint32_t regval;
+  int last = priv->nmics - 1;
+  int i;
+
+  fcr = ((uint32_t)filter->df_order << DFSDM_FLTFCR_FORD_SHIFT) |
+        DFSDM_FLTFCR_FOSR(filter->df_fosr - 1) |
+        DFSDM_FLTFCR_IOSR(filter->df_iosr - 1);
+
+  for (i = 0; i < priv->nmics; i++)
+    {
+      /* The microphones of a pair share the data pin of the odd channel:
+       * the even channel takes the pin of the next one and samples on the
+       * falling edge of CKOUT, the odd one samples on the rising edge.
+       */
+
+      regval = DFSDM_CHCFGR1_SPICKSEL_CKOUT | DFSDM_CHCFGR1_DATMPX_EXT;
+      if ((i & 1) == 0)
+        {
+          regval |= DFSDM_CHCFGR1_CHINSEL | DFSDM_CHCFGR1_SITP_SPIFALL;
+        }
+      else
+        {
+          regval |= DFSDM_CHCFGR1_SITP_SPIRISE;
+        }
+
+      modifyreg32(STM32L4_DFSDM_CHCFGR1(i), DFSDM_CHCFGR1_CHMASK, regval);
+      putreg32(DFSDM_CHCFGR2_DTRBS(filter->df_shift) |
+               DFSDM_CHCFGR2_OFFSET((uint32_t)filter->df_offset & 0xffffff),
+               STM32L4_DFSDM_CHCFGR2(i));
+      modifyreg32(STM32L4_DFSDM_CHCFGR1(i), 0, DFSDM_CHCFGR1_CHEN);
+
+      /* Filter i converts channel i continuously */
+
+      putreg32(0, STM32L4_DFSDM_FLTCR1(i));
+      putreg32(fcr, STM32L4_DFSDM_FLTFCR(i));
+
+      regval = DFSDM_FLTCR1_RCH(i) | DFSDM_FLTCR1_RCONT |
+               DFSDM_FLTCR1_RDMAEN | DFSDM_FLTCR1_FAST;
+      if (i > 0)
+        {
+          regval |= DFSDM_FLTCR1_RSYNC;
+        }
+
+      putreg32(regval, STM32L4_DFSDM_FLTCR1(i));
+
+      /* The filters complete their samples together and the DMA serves
+       * them in channel priority order, so the channel of the last filter
+       * is the last to finish a half: only it reports the halves.
+       */
+
+      stm32l4_dmasetup(priv->dma[i], STM32L4_DFSDM_FLTRDATAR(i),
+                       (uint32_t)priv->dmabuf[i], 2 * DFSDM_NFRAMES,
+                       DFSDM_DMA_CONTROL_WORD);
+      stm32l4_dmastart(priv->dma[i],
+                       i == last ? dfsdm_audio_dmacallback : NULL,
+                       priv, i == last);
+    }
+
+  /* Output the microphone clock and enable the DFSDM */
+
+  modifyreg32(STM32L4_DFSDM_CHCFGR1(0),
+              DFSDM_CH0CFGR1_CKOUTDIV_MASK | DFSDM_CH0CFGR1_CKOUTSRC,
+              DFSDM_CH0CFGR1_CKOUTDIV(DFSDM_CKOUTDIV - 1));
+  modifyreg32(STM32L4_DFSDM_CHCFGR1(0), 0, DFSDM_CH0CFGR1_DFSDMEN);
+
+  for (i = 0; i < priv->nmics; i++)
+    {
+      modifyreg32(STM32L4_DFSDM_FLTCR1(i), 0, DFSDM_FLTCR1_DFEN);
+    }
+
+  modifyreg32(STM32L4_DFSDM_FLTCR1(0), 0, DFSDM_FLTCR1_RSWSTART);
+}
+
+/****************************************************************************
+ * Name: dfsdm_audio_hwstop
+ *
+ * Description:
+ *   Stop the filters, their DMA and the microphone clock.
+ *
+ ****************************************************************************/
+
+static void dfsdm_audio_hwstop(struct dfsdm_audio_s *priv)
+{
+  int i;
+
+  for (i = 0; i < priv->nmics; i++)
+    {
+      modifyreg32(STM32L4_DFSDM_FLTCR1(i), DFSDM_FLTCR1_DFEN, 0);
+      stm32l4_dmastop(priv->dma[i]);
+      modifyreg32(STM32L4_DFSDM_CHCFGR1(i), DFSDM_CHCFGR1_CHEN, 0);
+    }
+
+  modifyreg32(STM32L4_DFSDM_CHCFGR1(0), DFSDM_CH0CFGR1_DFSDMEN, 0);
+}
+
+/****************************************************************************
+ * Name: dfsdm_audio_dequeue
+ *
+ * Description:
+ *   Return a buffer to the upper half.
+ *
+ ****************************************************************************/
+
+static void dfsdm_audio_dequeue(struct dfsdm_audio_s *priv,
+                                struct ap_buffer_s *apb)
+{
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  priv->dev.upper(priv->dev.priv, AUDIO_CALLBACK_DEQUEUE, apb, OK, NULL);
+#else
+  priv->dev.upper(priv->dev.priv, AUDIO_CALLBACK_DEQUEUE, apb, OK);
+#endif
+}
+
+/****************************************************************************
+ * Name: dfsdm_audio_deliver
+ *
+ * Description:
+ *   Interleave a completed half of the DMA buffers into the pending audio
+ *   buffers, one frame (a sample of each microphone) after another, and
+ *   return the buffers that are full.  The 24-bit samples are delivered
+ *   left aligned in 32 bits, or truncated to 16 bits.
+ *
+ ****************************************************************************/
+
+static void dfsdm_audio_deliver(struct dfsdm_audio_s *priv, int half)
+{
+  const uint32_t *src[DFSDM_NMICS];
+  struct ap_buffer_s *apb;
+  unsigned int framesize = priv->nmics * priv->bpsamp / 8;
+  unsigned int frame = 0;
+  unsigned int nframes;
+  unsigned int i;
+  int m;
+
+  for (m = 0; m < priv->nmics; m++)
+    {
+      src[m] = &priv->dmabuf[m][half * DFSDM_NFRAMES];
+    }
+
+  while (frame < DFSDM_NFRAMES)
+    {
+      apb = (struct ap_buffer_s *)dq_peek(&priv->pendq);
+      if (apb == NULL)
+        {
+          priv->lost += DFSDM_NFRAMES - frame;
+          break;
+        }
+
+      nframes = (apb->nmaxbytes - apb->nbytes) / framesize;
+      if (nframes > DFSDM_NFRAMES - frame)
+        {
+          nframes = DFSDM_NFRAMES - frame;
+        }
+
+      if (priv->bpsamp == 16)
+        {
+          int16_t *dest = (int16_t *)&apb->samp[apb->nbytes];
+
+          for (i = frame; i < frame + nframes; i++)
+            {
+              for (m = 0; m < priv->nmics; m++)
+                {
+                  *dest++ = (int16_t)(src[m][i] >> 16);
+                }
+            }
+        }
+      else
+        {
+          uint32_t *dest = (uint32_t *)&apb->samp[apb->nbytes];
+
+          for (i = frame; i < frame + nframes; i++)
+            {
+              for (m = 0; m < priv->nmics; m++)
+                {
+                  *dest++ = src[m][i] & DFSDM_FLTRDATAR_RDATA_MASK;
+                }
+            }
+        }
+
+      apb->nbytes += nframes * framesize;
+      frame       += nframes;
+
+      if (apb->nmaxbytes - apb->nbytes < framesize)
+        {
+          dq_remfirst(&priv->pendq);
+          dfsdm_audio_dequeue(priv, apb);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: dfsdm_audio_dmacallback
+ *
+ * Description:
+ *   DMA half and full transfer callback of the last filter.
+ *
+ ****************************************************************************/
+
+static void dfsdm_audio_dmacallback(DMA_HANDLE handle, uint8_t status,
+                                    void *arg)
+{
+  struct dfsdm_audio_s *priv = (struct dfsdm_audio_s *)arg;
+  int half;
+
+  /* While the DMA fills the first half, the second one is complete */
+
+  half = stm32l4_dmaresidual(handle) > DFSDM_NFRAMES ? 1 : 0;
+  dfsdm_audio_deliver(priv, half);
+}
+
+/****************************************************************************
+ * Name: dfsdm_audio_setfilter
+ *
+ * Description:
+ *   Validate and set the filter configuration of all microphones.
+ *
+ ****************************************************************************/
+
+static int dfsdm_audio_setfilter(struct dfsdm_audio_s *priv,
+                                 const struct stm32l4_dfsdm_filter_s *f)
+{
+  if (f->df_order > 5 || f->df_fosr < 1 || f->df_fosr > 1024 ||
+      f->df_iosr < 1 || f->df_iosr > 256 || f->df_shift > 31 ||
+      f->df_offset < -0x800000 || f->df_offset > 0x7fffff)
+    {
+      return -EINVAL;
+    }
+
+  if (priv->running)
+    {
+      return -EBUSY;
+    }
+
+  priv->filter.df_order  = f->df_order;
+  priv->filter.df_fosr   = f->df_fosr;
+  priv->filter.df_iosr   = f->df_iosr;
+  priv->filter.df_shift  = f->df_shift;
+  priv->filter.df_offset = f->df_offset;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dfsdm_audio_getcaps
+ *
+ * Description:
+ *   Get the audio device capabilities.
+ *
+ ****************************************************************************/
+
+static int dfsdm_audio_getcaps(struct audio_lowerhalf_s *dev, int type,
+                               struct audio_caps_s *caps)
+{
+  DEBUGASSERT(caps && caps->ac_len >= sizeof(struct audio_caps_s));
+  audinfo("type=%d ac_type=%d\n", type, caps->ac_type);
+
+  caps->ac_format.hw  = 0;
+  caps->ac_controls.w = 0;
+
+  switch (caps->ac_type)
+    {
+      case AUDIO_TYPE_QUERY:
+        caps->ac_channels = DFSDM_NMICS;
+
+        if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+          {
+            /* Raw PCM input only */
+
+            caps->ac_controls.b[0] = AUDIO_TYPE_INPUT;
+            caps->ac_format.hw     = 1 << (AUDIO_FMT_PCM - 1);
+          }
+        break;
+
+      case AUDIO_TYPE_INPUT:
+        caps->ac_channels = DFSDM_NMICS;
+
+        if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+          {
+            /* Any rate that divides the PDM clock may be set; report
+             * the usual voice rates.
+             */
+
+            caps->ac_controls.hw[0] = AUDIO_SAMP_RATE_8K |
+                                      AUDIO_SAMP_RATE_16K |
+                                      AUDIO_SAMP_RATE_32K |
+                                      AUDIO_SAMP_RATE_48K;
+            caps->ac_controls.b[2]  = 16;
+            caps->ac_controls.b[3]  = 32;
+          }
+        break;
+
+      default:
+        caps->ac_subtype = 0;
+        caps->ac_channels = 0;
+        break;
+    }
+
+  return caps->ac_len;
+}
+
+/****************************************************************************
+ * Name: dfsdm_audio_configure
+ *
+ * Description:
+ *   Configure the number of microphones, the sample width and the sample
+ *   rate.  The rate is reached by adjusting the sinc decimation ratio for
+ *   the current integrator ratio.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int dfsdm_audio_configure(struct audio_lowerhalf_s *dev,
+                                 void *session,
+                                 const struct audio_caps_s *caps)
+#else
+static int dfsdm_audio_configure(struct audio_lowerhalf_s *dev,
+                                 const struct audio_caps_s *caps)
+#endif
+{
+  struct dfsdm_audio_s *priv = (struct dfsdm_audio_s *)dev;
+  uint32_t samprate;
+  uint32_t fosr;
+
+  DEBUGASSERT(priv && caps);
+  audinfo("ac_type: %d\n", caps->ac_type);
+
+  if (caps->ac_type != AUDIO_TYPE_INPUT)
+    {
+      return -ENOTTY;
+    }
+
+  if (priv->running)
+    {
+      return -EBUSY;
+    }
+
+  if (caps->ac_channels < 1 || caps->ac_channels > DFSDM_NMICS)
+    {
+      auderr("ERROR: Unsupported number of channels: %d\n",
+             caps->ac_channels);
+      return -EINVAL;
+    }
+
+  if (caps->ac_controls.b[2] != 16 && caps->ac_controls.b[2] != 32)
+    {
+      auderr("ERROR: Unsupported bits per sample: %d\n",
+             caps->ac_controls.b[2]);
+      return -EINVAL;
+    }
+
+  samprate = caps->ac_controls.hw[0];
+  if (samprate != 0)
+    {
+      fosr = (DFSDM_PDMCLK + samprate * priv->filter.df_iosr / 2) /
+             (samprate * priv->filter.df_iosr);
+      if (fosr < 1 || fosr > 1024)
+        {
+          auderr("ERROR: Unsupported sample rate: %" PRIu32 "\n",
+                 samprate);
+          return -EINVAL;
+        }
+
+      priv->filter.df_fosr = fosr;
+    }
+
+  priv->nmics  = caps->ac_channels;
+  priv->bpsamp = caps->ac_controls.b[2];
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dfsdm_audio_shutdown
+ *
+ * Description:
+ *   Shutdown the device, stopping the capture if it is running.
+ *
+ ****************************************************************************/
+
+static int dfsdm_audio_shutdown(struct audio_lowerhalf_s *dev)
+{
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+  struct dfsdm_audio_s *priv = (struct dfsdm_audio_s *)dev;
+
+  if (priv->running)
+    {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      dfsdm_audio_stop(dev, NULL);
+#else
+      dfsdm_audio_stop(dev);
+#endif
+    }
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dfsdm_audio_start
+ *
+ * Description:
+ *   Start the capture.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int dfsdm_audio_start(struct audio_lowerhalf_s *dev, void *session)
+#else
+static int dfsdm_audio_start(struct audio_lowerhalf_s *dev)
+#endif
+{
+  struct dfsdm_audio_s *priv = (struct dfsdm_audio_s *)dev;
+  irqstate_t flags;
+  int i;
+
+  if (priv->running)
+    {
+      return -EBUSY;
+    }
+
+  for (i = 0; i < priv->nmics; i++)
+    {
+      priv->dma[i] = stm32l4_dmachannel(g_dfsdm_dmamap[i]);
+      if (priv->dma[i] == NULL)
+        {
+          while (--i >= 0)
+            {
+              stm32l4_dmafree(priv->dma[i]);
+            }
+
+          return -EBUSY;
+        }
+    }
+
+  audinfo("mics: %d fosr: %d iosr: %d rate: %" PRIu32 "\n",
+          priv->nmics, priv->filter.df_fosr, priv->filter.df_iosr,
+          DFSDM_PDMCLK / (priv->filter.df_fosr * priv->filter.df_iosr));
+
+  flags = enter_critical_section();
+  priv->lost    = 0;
+  priv->running = true;
+  priv->paused  = false;
+  dfsdm_audio_hwstart(priv);
+  leave_critical_section(flags);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dfsdm_audio_stop
+ *
+ * Description:
+ *   Stop the capture and return the pending buffers.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int dfsdm_audio_stop(struct audio_lowerhalf_s *dev, void *session)
+#else
+static int dfsdm_audio_stop(struct audio_lowerhalf_s *dev)
+#endif
+{
+  struct dfsdm_audio_s *priv = (struct dfsdm_audio_s *)dev;
+  struct ap_buffer_s *apb;
+  irqstate_t flags;
+  int i;
+
+  if (priv->running)
+    {
+      flags = enter_critical_section();
+      dfsdm_audio_hwstop(priv);
+      priv->running = false;
+      leave_critical_section(flags);
+
+      for (i = 0; i < priv->nmics; i++)
+        {
+          stm32l4_dmafree(priv->dma[i]);
+          priv->dma[i] = NULL;
+        }
+
+      if (priv->lost > 0)
+        {
+          audwarn("WARNING: %" PRIu32 " frames lost\n", priv->lost);
+        }
+    }
+
+  while ((apb = (struct ap_buffer_s *)dq_remfirst(&priv->pendq)) != NULL)
+    {
+      dfsdm_audio_dequeue(priv, apb);
+    }
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  priv->dev.upper(priv->dev.priv, AUDIO_CALLBACK_COMPLETE, NULL, OK, NULL);
+#else
+  priv->dev.upper(priv->dev.priv, AUDIO_CALLBACK_COMPLETE, NULL, OK);
+#endif
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: dfsdm_audio_pause
+ *
+ * Description:
+ *   Halt the filters, keeping the pending buffers.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int dfsdm_audio_pause(struct audio_lowerhalf_s *dev, void *session)
+#else
+static int dfsdm_audio_pause(struct audio_lowerhalf_s *dev)
+#endif
+{
+  struct dfsdm_audio_s *priv = (struct dfsdm_audio_s *)dev;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if (priv->running && !priv->paused)
+    {
+      dfsdm_audio_hwstop(priv);
+      priv->paused = true;
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dfsdm_audio_resume
+ *
+ * Description:
+ *   Restart the filters after a pause.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int dfsdm_audio_resume(struct audio_lowerhalf_s *dev, void *session)
+#else
+static int dfsdm_audio_resume(struct audio_lowerhalf_s *dev)
+#endif
+{
+  struct dfsdm_audio_s *priv = (struct dfsdm_audio_s *)dev;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if (priv->running && priv->paused)
+    {
+      priv->paused = false;
+      dfsdm_audio_hwstart(priv);
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: dfsdm_audio_enqueuebuffer
+ *
+ * Description:
+ *   Queue a buffer to be filled with frames.
+ *
+ ****************************************************************************/
+
+static int dfsdm_audio_enqueuebuffer(struct audio_lowerhalf_s *dev,
+                                     struct ap_buffer_s *apb)
+{
+  struct dfsdm_audio_s *priv = (struct dfsdm_audio_s *)dev;
+  irqstate_t flags;
+
+  if (apb->nmaxbytes < priv->nmics * priv->bpsamp / 8)
+    {
+      return -EINVAL;
+    }
+
+  apb->nbytes     = 0;
+  apb->curbyte    = 0;
+  apb->i.channels = priv->nmics;
+  apb->flags     |= AUDIO_APB_OUTPUT_ENQUEUED;
+
+  flags = enter_critical_section();
+  dq_addlast(&apb->dq_entry, &priv->pendq);
+  leave_critical_section(flags);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dfsdm_audio_ioctl
+ *
+ * Description:
+ *   Lower half ioctl commands.
+ *
+ ****************************************************************************/
+
+static int dfsdm_audio_ioctl(struct audio_lowerhalf_s *dev, int cmd,
+                             unsigned long arg)
+{
+  struct dfsdm_audio_s *priv = (struct dfsdm_audio_s *)dev;
+  int ret = OK;
+
+  switch (cmd)
+    {
+      /* Report our preferred buffer size and quantity: one DMA half */
+
+      case AUDIOIOC_GETBUFFERINFO:
+        {
+          struct ap_buffer_info_s *bufinfo =
+            (struct ap_buffer_info_s *)arg;
+
+          bufinfo->buffer_size = DFSDM_NFRAMES * priv->nmics *
+                                 priv->bpsamp / 8;
+          bufinfo->nbuffers    = CONFIG_AUDIO_NUM_BUFFERS;
+        }
+        break;
+
+      case AUDIOIOC_STM32L4_GETFILTER:
+        {
+          struct stm32l4_dfsdm_filter_s *filter =
+            (struct stm32l4_dfsdm_filter_s *)arg;
+
+          if (filter == NULL)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          *filter = priv->filter;
+        }
+        break;
+
+      case AUDIOIOC_STM32L4_SETFILTER:
+        {
+          const struct stm32l4_dfsdm_filter_s *filter =
+            (const struct stm32l4_dfsdm_filter_s *)arg;
+
+          if (filter == NULL)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          ret = dfsdm_audio_setfilter(priv, filter);
+        }
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: dfsdm_audio_reserve
+ *
+ * Description:
+ *   Reserve the device for exclusive use.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int dfsdm_audio_reserve(struct audio_lowerhalf_s *dev,
+                               void **session)
+#else
+static int dfsdm_audio_reserve(struct audio_lowerhalf_s *dev)
+#endif
+{
+  struct dfsdm_audio_s *priv = (struct dfsdm_audio_s *)dev;
+  irqstate_t flags;
+  int ret = OK;
+
+  flags = enter_critical_section();
+  if (priv->reserved)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      priv->reserved = true;
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      *session = priv;
+#endif
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: dfsdm_audio_release
+ *
+ * Description:
+ *   Release the reservation of the device.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int dfsdm_audio_release(struct audio_lowerhalf_s *dev,
+                               void *session)
+#else
+static int dfsdm_audio_release(struct audio_lowerhalf_s *dev)
+#endif
+{
+  struct dfsdm_audio_s *priv = (struct dfsdm_audio_s *)dev;
+
+  priv->reserved = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4_dfsdm_audio_initialize
+ *
+ * Description:
+ *   Initialize the DFSDM PDM microphone array as an audio capture device.
+ *
+ ****************************************************************************/
+
+struct audio_lowerhalf_s *stm32l4_dfsdm_audio_initialize(void)
+{
+  struct dfsdm_audio_s *priv = &g_dfsdm_audio;
+  irqstate_t flags;
+  uint32_t regval;
+
+  memset(priv, 0, sizeof(struct dfsdm_audio_s));
+  dq_init(&priv->pendq);
+
+  priv->dev.ops          = &g_dfsdm_audio_ops;
+  priv->nmics            = DFSDM_NMICS;
+  priv->bpsamp           = 16;
+  priv->filter.df_pdmclk = DFSDM_PDMCLK;
+  priv->filter.df_order  = CONFIG_STM32L4_DFSDM_AUDIO_SINC_ORDER;
+  priv->filter.df_fosr   = CONFIG_STM32L4_DFSDM_AUDIO_FOSR;
+  priv->filter.df_iosr   = CONFIG_STM32L4_DFSDM_AUDIO_IOSR;
+  priv->filter.df_shift  = CONFIG_STM32L4_DFSDM_AUDIO_SHIFT;
+
+  /* Reset the DFSDM.  The APB2RSTR register is shared with other drivers */
+
+  flags  = enter_critical_section();
+  regval = getreg32(STM32L4_RCC_APB2RSTR);
+  putreg32(regval | RCC_APB2RSTR_DFSDMRST, STM32L4_RCC_APB2RSTR);
+  putreg32(regval & ~RCC_APB2RSTR_DFSDMRST, STM32L4_RCC_APB2RSTR);
+  leave_critical_section(flags);
+
+  stm32l4_configgpio(GPIO_DFSDM_CKOUT);
+  stm32l4_configgpio(GPIO_DFSDM_DATIN1);
+#if DFSDM_NMICS > 2
+  stm32l4_configgpio(GPIO_DFSDM_DATIN3);
+#endif
+
+  return &priv->dev;
+}
+
+#endif /* CONFIG_STM32L4_DFSDM_AUDIO */
@@ -0,0 +1,77 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_dfsdm_audio.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_SRC_STM32L4_STM32L4_DFSDM_AUDIO_H
+#define __ARCH_ARM_SRC_STM32L4_STM32L4_DFSDM_AUDIO_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/audio/audio.h>
+#include <arch/chip/dfsdm.h>
+
+#ifdef CONFIG_STM32L4_DFSDM_AUDIO
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifndef __ASSEMBLY__
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: stm32l4_dfsdm_audio_initialize
+ *
+ * Description:
+ *   Initialize the DFSDM PDM microphone array as an audio capture device.
+ *   Microphone n is sampled by DFSDM channel n and filter n; the microphone
+ *   pairs 0/1 and 2/3 share the DATIN1 and DATIN3 pins (even microphones
+ *   on the falling edge of CKOUT, odd ones on the rising edge).  All
+ *   filters are started synchronously by the FLT0 software start and the
+ *   samples are delivered as interleaved frames in the audio buffers.
+ *
+ *   The board must define GPIO_DFSDM_CKOUT, GPIO_DFSDM_DATIN1 and, with
+ *   more than two microphones, GPIO_DFSDM_DATIN3.
+ *
+ * Returned Value:
+ *   The audio lower half on success; NULL on failure.  Register it with
+ *   audio_register().
+ *
+ ****************************************************************************/
+
+struct audio_lowerhalf_s *stm32l4_dfsdm_audio_initialize(void);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+#endif /* __ASSEMBLY__ */
+
+#endif /* CONFIG_STM32L4_DFSDM_AUDIO */
+#endif /* __ARCH_ARM_SRC_STM32L4_STM32L4_DFSDM_AUDIO_H */
@@ -27,6 +27,7 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 
 #include "chip.h"
 
@@ -80,6 +81,25 @@ typedef void *DMA_HANDLE;
 
 typedef void (*dma_callback_t)(DMA_HANDLE handle, uint8_t status, void *arg);
 
+/* Description:
+ *   This is the type of the callback that is used in circular double-buffer
+ *   mode (see stm32l4_dmadblbuf_start()) to inform the user that one half
+ *   of the buffer has been completed.
+ *
+ * Input Parameters:
+ *   handle - Refers to the DMA channel
+ *   status - A bit encoded value that provides the completion status.  If
+ *            both DMA_STATUS_HTIF and DMA_STATUS_TCIF are set, then the
+ *            interrupt was serviced too late and one half was overwritten.
+ *   ready  - The half (0 or 1) that has been completed and is now owned by
+ *            the CPU until the DMA wraps back to it.
+ *   arg    - A user-provided value that was provided when
+ *            stm32l4_dmadblbuf_start() was called.
+ */
+
+typedef void (*dma_dblcallback_t)(DMA_HANDLE handle, uint8_t status,
+                                  unsigned int ready, void *arg);
+
 #ifdef CONFIG_DEBUG_DMA_INFO
 struct stm32l4_dmaregs_s
 {
@@ -246,6 +266,174 @@ void stm32l4_dmasetup(DMA_HANDLE handle, uint32_t paddr, uint32_t maddr,
 void stm32l4_dmastart(DMA_HANDLE handle, dma_callback_t callback, void *arg,
                       bool half);
 
+#ifdef CONFIG_STM32L4_STM32L4XR
+/****************************************************************************
+ * Name: stm32l4_dmadblbuf_setup
+ *
+ * Description:
+ *   Configure a channel for gapless circular double-buffer operation.  The
+ *   memory at 'maddr' holds two consecutive halves of 'halfsize' transfers
+ *   each.  The DMA runs continuously over both halves; while it fills (or
+ *   drains) one half, the CPU owns the other.  DMA_CCR_CIRC is implied.
+ *
+ * Input Parameters:
+ *   handle   - DMA handle allocated by stm32l4_dmachannel()
+ *   paddr    - Peripheral data register address
+ *   maddr    - Address of the first half buffer
+ *   halfsize - Number of transfers in each half (the total must fit in
+ *              the 16-bit CNDTR register)
+ *   ccr      - Channel configuration, as for stm32l4_dmasetup()
+ *
+ ****************************************************************************/
+
+void stm32l4_dmadblbuf_setup(DMA_HANDLE handle, uint32_t paddr,
+                             uint32_t maddr, size_t halfsize, uint32_t ccr);
+
+/****************************************************************************
+ * Name: stm32l4_dmadblbuf_start
+ *
+ * Description:
+ *   Start a transfer configured by stm32l4_dmadblbuf_setup().  The callback
+ *   is invoked from the DMA interrupt each time a half has been completed;
+ *   the channel never has to be re-armed.  Use stm32l4_dmastop() to end
+ *   the transfer.
+ *
+ * Assumptions:
+ *   - DMA handle allocated by stm32l4_dmachannel()
+ *   - No DMA in progress
+ *
+ ****************************************************************************/
+
+void stm32l4_dmadblbuf_start(DMA_HANDLE handle, dma_dblcallback_t callback,
+                             void *arg);
+
+/****************************************************************************
+ * Name: stm32l4_dmadblbuf_current
+ *
+ * Description:
+ *   Return the half (0 or 1) that the DMA is currently transferring.
+ *
+ * Assumptions:
+ *   - A double-buffer transfer has been started on the channel
+ *
+ ****************************************************************************/
+
+unsigned int stm32l4_dmadblbuf_current(DMA_HANDLE handle);
+
+/****************************************************************************
+ * Name: stm32l4_dmasg_start
+ *
+ * Description:
+ *   Configure and start a transfer between a peripheral and a list of
+ *   memory segments, such as an I/O buffer chain described by
+ *   iob_iovec().  The channel is re-armed on the next segment from the
+ *   transfer complete interrupt, so the CPU does not touch the data.  The
+ *   callback is invoked once, after the last segment or on the first
+ *   error.  stm32l4_dmaresidual() only covers the current segment.
+ *
+ * Input Parameters:
+ *   handle   - DMA handle allocated by stm32l4_dmachannel()
+ *   paddr    - Peripheral data register address
+ *   iov      - The segments, which must stay valid until the callback
+ *   iovcnt   - The number of segments (1-256)
+ *   ccr      - Channel configuration, as for stm32l4_dmasetup().  Each
+ *              segment length must be a multiple of the memory size and
+ *              DMA_CCR_CIRC is not allowed.
+ *   callback - Invoked when the whole list has been transferred
+ *   arg      - Argument passed to the callback
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if a segment or the configuration
+ *   cannot be transferred.
+ *
+ * Assumptions:
+ *   - No DMA in progress
+ *
+ ****************************************************************************/
+
+int stm32l4_dmasg_start(DMA_HANDLE handle, uint32_t paddr,
+                        const struct iovec *iov, int iovcnt, uint32_t ccr,
+                        dma_callback_t callback, void *arg);
+
+/****************************************************************************
+ * Name: stm32l4_dmasync
+ *
+ * Description:
+ *   Synchronize the DMA requests of a channel with a DMAMUX
+ *   synchronization input.  After each selected edge on 'syncid', 'nbreq'
+ *   requests from the peripheral are forwarded to the DMA and further
+ *   requests are held until the next edge.  This paces a peripheral's
+ *   transfers from an LPTIM output or an EXTI line without CPU
+ *   involvement.  The setting takes effect at the next stm32l4_dmastart()
+ *   and is cleared by stm32l4_dmafree().
+ *
+ * Input Parameters:
+ *   handle - DMA handle allocated by stm32l4_dmachannel()
+ *   syncid - Synchronization input, one of DMAMUX1_SIG_*
+ *   pol    - Edge selection, one of DMAMUX_POL_*.  DMAMUX_POL_NONE
+ *            disables synchronization.
+ *   nbreq  - Requests forwarded per synchronization event (1-32).  When
+ *            'event' is set, an output event is also generated after this
+ *            many requests.
+ *   event  - Generate a DMAMUX1_SIG_EVT(n) event for chaining (DMAMUX
+ *            channels 0-3 only)
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if a parameter is out of range.
+ *
+ ****************************************************************************/
+
+int stm32l4_dmasync(DMA_HANDLE handle, uint8_t syncid, uint8_t pol,
+                    unsigned int nbreq, bool event);
+
+/****************************************************************************
+ * Name: stm32l4_dmamux_reqgen_start
+ *
+ * Description:
+ *   Start DMAMUX request generator 'gen' (0-3).  Each selected edge on
+ *   the trigger input produces 'nbreq' DMA requests on request line
+ *   DMAMUX1_REQ_GENn.  A channel allocated with DMAMAP_REQ_GENn_x then
+ *   moves data (for example into a DAC or GPIO BSRR register) at the pace
+ *   of an LPTIM output or EXTI line, with no CPU involvement.
+ *
+ * Input Parameters:
+ *   gen   - Request generator number (0-3)
+ *   sigid - Trigger input, one of DMAMUX1_SIG_*
+ *   pol   - Trigger edge: DMAMUX_POL_RISING, _FALLING or _BOTH
+ *   nbreq - Requests generated per trigger (1-32)
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if a parameter is out of range; -EBUSY
+ *   if the generator is already in use.
+ *
+ ****************************************************************************/
+
+int stm32l4_dmamux_reqgen_start(unsigned int gen, uint8_t sigid,
+                                uint8_t pol, unsigned int nbreq);
+
+/****************************************************************************
+ * Name: stm32l4_dmamux_reqgen_stop
+ *
+ * Description:
+ *   Stop and release a request generator started by
+ *   stm32l4_dmamux_reqgen_start().
+ *
+ ****************************************************************************/
+
+void stm32l4_dmamux_reqgen_stop(unsigned int gen);
+
+/****************************************************************************
+ * Name: stm32l4_dmamux_reqgen_overrun
+ *
+ * Description:
+ *   Return true, and clear the flag, if a trigger arrived before the DMA
+ *   served all requests from the previous trigger.
+ *
+ ****************************************************************************/
+
+bool stm32l4_dmamux_reqgen_overrun(unsigned int gen);
+#endif
+
 /****************************************************************************
  * Name: stm32l4_dmastop
  *
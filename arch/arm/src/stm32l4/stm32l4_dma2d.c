@@ -0,0 +1,732 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_dma2d.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/video/fb.h>
+
+#include "arm_internal.h"
+#include "stm32l4_dma2d.h"
+
+#ifdef CONFIG_STM32L4_DMA2D
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Largest area that can be described by the NLR register */
+
+#define DMA2D_MAXWIDTH      0x3fff
+#define DMA2D_MAXHEIGHT     0xffff
+#define DMA2D_MAXOFFSET     0xffff
+
+/* Interrupts that terminate a transfer */
+
+#define DMA2D_CR_DONEINTS   (DMA2D_CR_TCIE | DMA2D_CR_TEIE | DMA2D_CR_CEIE)
+#define DMA2D_ISR_ERRORS    (DMA2D_ISR_TEIF | DMA2D_ISR_CAEIF | \
+                             DMA2D_ISR_CEIF)
+#define DMA2D_ISR_DONE      (DMA2D_ISR_TCIF | DMA2D_ISR_ERRORS)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* DMA2D driver state.  Only one transfer can be in flight at a time; the
+ * operations start it and return, and the next operation (or
+ * stm32l4_dma2d_wait()) waits for the interrupt that ends it.
+ */
+
+struct stm32l4_dma2d_s
+{
+  mutex_t lock;           /* Serializes access to the controller */
+  sem_t waitsem;          /* Wakes up a thread waiting for completion */
+  volatile bool busy;     /* A transfer has been started */
+  volatile bool waiting;  /* A thread is waiting on waitsem */
+  volatile int result;    /* Outcome of the last transfer */
+  bool initialized;       /* The interrupt has been attached */
+};
+
+/* Register settings that locate one layer of a transfer */
+
+struct stm32l4_dma2d_layer_s
+{
+  uint32_t addr;          /* Address of the first pixel */
+  uint32_t offset;        /* Pixels to skip at the end of a line */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int stm32l4_dma2d_interrupt(int irq, void *context, void *arg);
+static int stm32l4_dma2d_pixsize(uint8_t fmt);
+static int stm32l4_dma2d_layer(FAR const struct stm32l4_dma2d_surface_s *s,
+                               fb_coord_t x, fb_coord_t y, fb_coord_t w,
+                               FAR struct stm32l4_dma2d_layer_s *layer);
+static int stm32l4_dma2d_checkarea(FAR const struct fb_area_s *area);
+static int stm32l4_dma2d_waitidle(FAR struct stm32l4_dma2d_s *priv);
+static void stm32l4_dma2d_start(FAR struct stm32l4_dma2d_s *priv,
+                                FAR const struct fb_area_s *area,
+                                uint32_t mode);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct stm32l4_dma2d_s g_dma2d =
+{
+  .lock    = NXMUTEX_INITIALIZER,
+  .waitsem = SEM_INITIALIZER(0),
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4_dma2d_interrupt
+ *
+ * Description:
+ *   DMA2D interrupt handler.  Records the outcome of the transfer and wakes
+ *   up any thread waiting for it.
+ *
+ ****************************************************************************/
+
+static int stm32l4_dma2d_interrupt(int irq, void *context, void *arg)
+{
+  FAR struct stm32l4_dma2d_s *priv = (FAR struct stm32l4_dma2d_s *)arg;
+  uint32_t isr;
+
+  isr = getreg32(STM32L4_DMA2D_ISR);
+  putreg32(isr & DMA2D_IFCR_ALL, STM32L4_DMA2D_IFCR);
+
+  if ((isr & DMA2D_ISR_ERRORS) != 0)
+    {
+      priv->result = -EIO;
+    }
+
+  if ((isr & DMA2D_ISR_DONE) != 0)
+    {
+      priv->busy = false;
+      if (priv->waiting)
+        {
+          priv->waiting = false;
+          nxsem_post(&priv->waitsem);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4_dma2d_pixsize
+ *
+ * Description:
+ *   Return the size in bytes of a pixel in the given format, or zero if
+ *   pixels of this format are smaller than a byte.
+ *
+ ****************************************************************************/
+
+static int stm32l4_dma2d_pixsize(uint8_t fmt)
+{
+  switch (fmt)
+    {
+      case DMA2D_PF_ARGB8888:
+        return 4;
+
+      case DMA2D_PF_RGB888:
+        return 3;
+
+      case DMA2D_PF_RGB565:
+      case DMA2D_PF_ARGB1555:
+      case DMA2D_PF_ARGB4444:
+      case DMA2D_PF_AL88:
+        return 2;
+
+      case DMA2D_PF_L8:
+      case DMA2D_PF_AL44:
+      case DMA2D_PF_A8:
+        return 1;
+
+      default:
+        return 0;
+    }
+}
+
+/****************************************************************************
+ * Name: stm32l4_dma2d_layer
+ *
+ * Description:
+ *   Compute the memory address and line offset registers for a w pixel
+ *   wide area starting at (x, y) in surface s.
+ *
+ ****************************************************************************/
+
+static int stm32l4_dma2d_layer(FAR const struct stm32l4_dma2d_surface_s *s,
+                               fb_coord_t x, fb_coord_t y, fb_coord_t w,
+                               FAR struct stm32l4_dma2d_layer_s *layer)
+{
+  int pixsize = stm32l4_dma2d_pixsize(s->fmt);
+  uint32_t linepixels;
+
+  if (pixsize == 0 || (s->stride % pixsize) != 0)
+    {
+      return -EINVAL;
+    }
+
+  linepixels = s->stride / pixsize;
+  if (x + w > linepixels || linepixels - w > DMA2D_MAXOFFSET)
+    {
+      return -EINVAL;
+    }
+
+  layer->addr   = (uint32_t)(uintptr_t)s->mem + y * s->stride +
+                  x * pixsize;
+  layer->offset = linepixels - w;
+
+  /* 16- and 32-bit pixels must be naturally aligned */
+
+  if (pixsize != 3 && (layer->addr & (pixsize - 1)) != 0)
+    {
+      return -EINVAL;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4_dma2d_checkarea
+ *
+ * Description:
+ *   Verify that an area can be described by the NLR register.
+ *
+ ****************************************************************************/
+
+static int stm32l4_dma2d_checkarea(FAR const struct fb_area_s *area)
+{
+  if (area->w == 0 || area->h == 0 ||
+      area->w > DMA2D_MAXWIDTH || area->h > DMA2D_MAXHEIGHT)
+    {
+      return -EINVAL;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4_dma2d_waitidle
+ *
+ * Description:
+ *   Wait for the transfer in progress, if any, to complete.  The caller
+ *   must hold the lock.
+ *
+ ****************************************************************************/
+
+static int stm32l4_dma2d_waitidle(FAR struct stm32l4_dma2d_s *priv)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  while (priv->busy)
+    {
+      priv->waiting = true;
+      nxsem_wait_uninterruptible(&priv->waitsem);
+    }
+
+  leave_critical_section(flags);
+  return priv->result;
+}
+
+/****************************************************************************
+ * Name: stm32l4_dma2d_start
+ *
+ * Description:
+ *   Start a transfer of the given area in the given mode.  The layer and
+ *   output registers must already be set up, and the caller must hold the
+ *   lock.
+ *
+ ****************************************************************************/
+
+static void stm32l4_dma2d_start(FAR struct stm32l4_dma2d_s *priv,
+                                FAR const struct fb_area_s *area,
+                                uint32_t mode)
+{
+  putreg32(DMA2D_NLR_PL(area->w) | DMA2D_NLR_NL(area->h),
+           STM32L4_DMA2D_NLR);
+
+  priv->result = OK;
+  priv->busy   = true;
+
+  putreg32(DMA2D_IFCR_ALL, STM32L4_DMA2D_IFCR);
+  putreg32(mode | DMA2D_CR_DONEINTS | DMA2D_CR_START, STM32L4_DMA2D_CR);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4_dma2d_initialize
+ *
+ * Description:
+ *   Initialize the DMA2D controller.  May be called more than once.
+ *
+ ****************************************************************************/
+
+int stm32l4_dma2d_initialize(void)
+{
+  FAR struct stm32l4_dma2d_s *priv = &g_dma2d;
+
+  nxmutex_lock(&priv->lock);
+  if (!priv->initialized)
+    {
+      /* The DMA2D clock is enabled in rcc_enableahb1() */
+
+      putreg32(DMA2D_CR_ABORT, STM32L4_DMA2D_CR);
+      putreg32(DMA2D_IFCR_ALL, STM32L4_DMA2D_IFCR);
+
+      priv->busy    = false;
+      priv->waiting = false;
+      priv->result  = OK;
+
+      irq_attach(STM32L4_IRQ_DMA2D, stm32l4_dma2d_interrupt, priv);
+      up_enable_irq(STM32L4_IRQ_DMA2D);
+
+      priv->initialized = true;
+    }
+
+  nxmutex_unlock(&priv->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4_dma2d_uninitialize
+ *
+ * Description:
+ *   Abort any transfer in progress and disable the DMA2D interrupt.
+ *
+ ****************************************************************************/
+
+void stm32l4_dma2d_uninitialize(void)
+{
+  FAR struct stm32l4_dma2d_s *priv = &g_dma2d;
+  irqstate_t flags;
+
+  nxmutex_lock(&priv->lock);
+  if (priv->initialized)
+    {
+      up_disable_irq(STM32L4_IRQ_DMA2D);
+      irq_detach(STM32L4_IRQ_DMA2D);
+
+      putreg32(DMA2D_CR_ABORT, STM32L4_DMA2D_CR);
+      putreg32(DMA2D_IFCR_ALL, STM32L4_DMA2D_IFCR);
+
+      /* Release anybody still waiting for the aborted transfer */
+
+      flags = enter_critical_section();
+      priv->busy   = false;
+      priv->result = -ECANCELED;
+      if (priv->waiting)
+        {
+          priv->waiting = false;
+          nxsem_post(&priv->waitsem);
+        }
+
+      leave_critical_section(flags);
+      priv->initialized = false;
+    }
+
+  nxmutex_unlock(&priv->lock);
+}
+
+/****************************************************************************
+ * Name: stm32l4_dma2d_fill
+ *
+ * Description:
+ *   Start filling an area of a surface with a solid color.
+ *
+ ****************************************************************************/
+
+int stm32l4_dma2d_fill(FAR const struct stm32l4_dma2d_surface_s *dest,
+                       FAR const struct fb_area_s *area, uint32_t color)
+{
+  FAR struct stm32l4_dma2d_s *priv = &g_dma2d;
+  struct stm32l4_dma2d_layer_s out;
+  int ret;
+
+  DEBUGASSERT(dest != NULL && area != NULL);
+
+  if (dest->fmt > DMA2D_PF_ARGB4444)
+    {
+      return -ENOSYS;
+    }
+
+  ret = stm32l4_dma2d_checkarea(area);
+  if (ret >= 0)
+    {
+      ret = stm32l4_dma2d_layer(dest, area->x, area->y, area->w, &out);
+    }
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  nxmutex_lock(&priv->lock);
+  if (!priv->initialized)
+    {
+      nxmutex_unlock(&priv->lock);
+      return -ENODEV;
+    }
+
+  stm32l4_dma2d_waitidle(priv);
+
+  putreg32(DMA2D_OPFCCR_CM(dest->fmt), STM32L4_DMA2D_OPFCCR);
+  putreg32(color, STM32L4_DMA2D_OCOLR);
+  putreg32(out.addr, STM32L4_DMA2D_OMAR);
+  putreg32(DMA2D_OOR_LO(out.offset), STM32L4_DMA2D_OOR);
+
+  stm32l4_dma2d_start(priv, area, DMA2D_CR_MODE_R2M);
+
+  nxmutex_unlock(&priv->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4_dma2d_copy
+ *
+ * Description:
+ *   Start copying an area of src to dest, converting the pixel format if
+ *   necessary.
+ *
+ ****************************************************************************/
+
+int stm32l4_dma2d_copy(FAR const struct stm32l4_dma2d_surface_s *dest,
+                       FAR const struct fb_area_s *area,
+                       FAR const struct stm32l4_dma2d_surface_s *src,
+                       fb_coord_t srcx, fb_coord_t srcy)
+{
+  FAR struct stm32l4_dma2d_s *priv = &g_dma2d;
+  struct stm32l4_dma2d_layer_s out;
+  struct stm32l4_dma2d_layer_s fg;
+  uint32_t mode;
+  int ret;
+
+  DEBUGASSERT(dest != NULL && area != NULL && src != NULL);
+
+  if (src->fmt == dest->fmt)
+    {
+      /* Plain copy; the foreground format only sets the pixel size */
+
+      mode = DMA2D_CR_MODE_M2M;
+    }
+  else
+    {
+      /* Pixel format conversion.  CLUT formats are not supported. */
+
+      if (dest->fmt > DMA2D_PF_ARGB4444 ||
+          (src->fmt > DMA2D_PF_ARGB4444 && src->fmt != DMA2D_PF_A8))
+        {
+          return -ENOSYS;
+        }
+
+      mode = DMA2D_CR_MODE_M2MPFC;
+    }
+
+  ret = stm32l4_dma2d_checkarea(area);
+  if (ret >= 0)
+    {
+      ret = stm32l4_dma2d_layer(dest, area->x, area->y, area->w, &out);
+    }
+
+  if (ret >= 0)
+    {
+      ret = stm32l4_dma2d_layer(src, srcx, srcy, area->w, &fg);
+    }
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  nxmutex_lock(&priv->lock);
+  if (!priv->initialized)
+    {
+      nxmutex_unlock(&priv->lock);
+      return -ENODEV;
+    }
+
+  stm32l4_dma2d_waitidle(priv);
+
+  putreg32(fg.addr, STM32L4_DMA2D_FGMAR);
+  putreg32(DMA2D_XGOR(fg.offset), STM32L4_DMA2D_FGOR);
+  putreg32(DMA2D_XGPFCCR_CM(src->fmt) |
+           DMA2D_XGPFCCR_AM(STM32L4_DMA2D_PFCCR_AM_NONE),
+           STM32L4_DMA2D_FGPFCCR);
+
+  putreg32(DMA2D_OPFCCR_CM(dest->fmt), STM32L4_DMA2D_OPFCCR);
+  putreg32(out.addr, STM32L4_DMA2D_OMAR);
+  putreg32(DMA2D_OOR_LO(out.offset), STM32L4_DMA2D_OOR);
+
+  stm32l4_dma2d_start(priv, area, mode);
+
+  nxmutex_unlock(&priv->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4_dma2d_blend
+ *
+ * Description:
+ *   Start blending an area of fore over an area of back into dest.
+ *
+ ****************************************************************************/
+
+int stm32l4_dma2d_blend(FAR const struct stm32l4_dma2d_surface_s *dest,
+                        FAR const struct fb_area_s *area,
+                        FAR const struct stm32l4_dma2d_surface_s *fore,
+                        fb_coord_t forex, fb_coord_t forey,
+                        FAR const struct stm32l4_dma2d_surface_s *back,
+                        fb_coord_t backx, fb_coord_t backy,
+                        uint8_t alpha)
+{
+  FAR struct stm32l4_dma2d_s *priv = &g_dma2d;
+  struct stm32l4_dma2d_layer_s out;
+  struct stm32l4_dma2d_layer_s fg;
+  struct stm32l4_dma2d_layer_s bg;
+  int ret;
+
+  DEBUGASSERT(dest != NULL && area != NULL && fore != NULL && back != NULL);
+
+  if (dest->fmt > DMA2D_PF_ARGB4444 ||
+      (fore->fmt > DMA2D_PF_ARGB4444 && fore->fmt != DMA2D_PF_A8) ||
+      back->fmt > DMA2D_PF_ARGB4444)
+    {
+      return -ENOSYS;
+    }
+
+  ret = stm32l4_dma2d_checkarea(area);
+  if (ret >= 0)
+    {
+      ret = stm32l4_dma2d_layer(dest, area->x, area->y, area->w, &out);
+    }
+
+  if (ret >= 0)
+    {
+      ret = stm32l4_dma2d_layer(fore, forex, forey, area->w, &fg);
+    }
+
+  if (ret >= 0)
+    {
+      ret = stm32l4_dma2d_layer(back, backx, backy, area->w, &bg);
+    }
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  nxmutex_lock(&priv->lock);
+  if (!priv->initialized)
+    {
+      nxmutex_unlock(&priv->lock);
+      return -ENODEV;
+    }
+
+  stm32l4_dma2d_waitidle(priv);
+
+  putreg32(fg.addr, STM32L4_DMA2D_FGMAR);
+  putreg32(DMA2D_XGOR(fg.offset), STM32L4_DMA2D_FGOR);
+  putreg32(DMA2D_XGPFCCR_CM(fore->fmt) |
+           DMA2D_XGPFCCR_AM(STM32L4_DMA2D_PFCCR_AM_PIXEL) |
+           DMA2D_XGPFCCR_ALPHA(alpha), STM32L4_DMA2D_FGPFCCR);
+
+  putreg32(bg.addr, STM32L4_DMA2D_BGMAR);
+  putreg32(DMA2D_XGOR(bg.offset), STM32L4_DMA2D_BGOR);
+  putreg32(DMA2D_XGPFCCR_CM(back->fmt) |
+           DMA2D_XGPFCCR_AM(STM32L4_DMA2D_PFCCR_AM_NONE),
+           STM32L4_DMA2D_BGPFCCR);
+
+  putreg32(DMA2D_OPFCCR_CM(dest->fmt), STM32L4_DMA2D_OPFCCR);
+  putreg32(out.addr, STM32L4_DMA2D_OMAR);
+  putreg32(DMA2D_OOR_LO(out.offset), STM32L4_DMA2D_OOR);
+
+  stm32l4_dma2d_start(priv, area, DMA2D_CR_MODE_M2MBLEND);
+
+  nxmutex_unlock(&priv->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4_dma2d_wait
+ *
+ * Description:
+ *   Wait for the last transfer to complete.
+ *
+ ****************************************************************************/
+
+int stm32l4_dma2d_wait(void)
+{
+  FAR struct stm32l4_dma2d_s *priv = &g_dma2d;
+  int ret;
+
+  nxmutex_lock(&priv->lock);
+  ret = stm32l4_dma2d_waitidle(priv);
+  nxmutex_unlock(&priv->lock);
+
+  return ret;
+}
+
+#ifdef CONFIG_STM32L4_DMA2D_FB
+/****************************************************************************
+ * Name: stm32l4_dma2d_fbsurface
+ *
+ * Description:
+ *   Describe a framebuffer plane as a DMA2D surface.
+ *
+ ****************************************************************************/
+
+static int stm32l4_dma2d_fbsurface(FAR struct fb_planeinfo_s *pinfo,
+                                   FAR struct stm32l4_dma2d_surface_s *s)
+{
+  switch (pinfo->bpp)
+    {
+      case 8:
+        s->fmt = DMA2D_PF_L8;
+        break;
+
+      case 16:
+        s->fmt = DMA2D_PF_RGB565;
+        break;
+
+      case 24:
+        s->fmt = DMA2D_PF_RGB888;
+        break;
+
+      case 32:
+        s->fmt = DMA2D_PF_ARGB8888;
+        break;
+
+      default:
+        return -ENOSYS;
+    }
+
+  s->mem    = pinfo->fbmem;
+  s->stride = pinfo->stride;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: up_fbfillarea
+ *
+ * Description:
+ *   Start filling an area of a framebuffer plane with a solid color.  See
+ *   include/nuttx/video/fb.h.
+ *
+ ****************************************************************************/
+
+int up_fbfillarea(FAR struct fb_planeinfo_s *pinfo,
+                  FAR const struct fb_area_s *area, uint32_t color)
+{
+  struct stm32l4_dma2d_surface_s dest;
+  int ret;
+
+  ret = stm32l4_dma2d_fbsurface(pinfo, &dest);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return stm32l4_dma2d_fill(&dest, area, color);
+}
+
+/****************************************************************************
+ * Name: up_fbcopyarea
+ *
+ * Description:
+ *   Copy an image into an area of a framebuffer plane.  See
+ *   include/nuttx/video/fb.h.
+ *
+ ****************************************************************************/
+
+int up_fbcopyarea(FAR struct fb_planeinfo_s *pinfo,
+                  FAR const struct fb_area_s *area,
+                  FAR const void *src, fb_coord_t srcstride)
+{
+  struct stm32l4_dma2d_surface_s dest;
+  struct stm32l4_dma2d_surface_s image;
+  int ret;
+
+  ret = stm32l4_dma2d_fbsurface(pinfo, &dest);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  image.mem    = (FAR void *)src;
+  image.stride = srcstride;
+  image.fmt    = dest.fmt;
+
+  ret = stm32l4_dma2d_copy(&dest, area, &image, 0, 0);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* The caller owns the source image, so the copy must finish here */
+
+  return stm32l4_dma2d_wait();
+}
+
+/****************************************************************************
+ * Name: up_fbsync
+ *
+ * Description:
+ *   Wait for accelerated rendering into a framebuffer plane to complete.
+ *   See include/nuttx/video/fb.h.
+ *
+ ****************************************************************************/
+
+void up_fbsync(FAR struct fb_planeinfo_s *pinfo)
+{
+  int ret;
+
+  ret = stm32l4_dma2d_wait();
+  if (ret < 0)
+    {
+      gerr("ERROR: DMA2D transfer failed: %d\n", ret);
+    }
+}
+#endif /* CONFIG_STM32L4_DMA2D_FB */
+#endif /* CONFIG_STM32L4_DMA2D */
@@ -0,0 +1,199 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_dma2d.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_SRC_STM32L4_STM32L4_DMA2D_H
+#define __ARCH_ARM_SRC_STM32L4_STM32L4_DMA2D_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/video/fb.h>
+
+#include "chip.h"
+#include "hardware/stm32l4_dma2d.h"
+
+#if defined(CONFIG_STM32L4_DMA2D) && !defined(__ASSEMBLY__)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This structure describes a bitmap in memory that DMA2D reads or writes.
+ * Coordinates passed to the operations below are relative to mem.
+ */
+
+struct stm32l4_dma2d_surface_s
+{
+  FAR void  *mem;     /* Address of the top-left pixel */
+  fb_coord_t stride;  /* Length of a line in bytes */
+  uint8_t    fmt;     /* Pixel format, one of DMA2D_PF_* */
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4_dma2d_initialize
+ *
+ * Description:
+ *   Initialize the DMA2D controller.  May be called more than once.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.
+ *
+ ****************************************************************************/
+
+int stm32l4_dma2d_initialize(void);
+
+/****************************************************************************
+ * Name: stm32l4_dma2d_uninitialize
+ *
+ * Description:
+ *   Abort any transfer in progress and disable the DMA2D interrupt.
+ *
+ ****************************************************************************/
+
+void stm32l4_dma2d_uninitialize(void);
+
+/****************************************************************************
+ * Name: stm32l4_dma2d_fill
+ *
+ * Description:
+ *   Start filling an area of a surface with a solid color
+ *   (register-to-memory).  Only the ARGB8888, RGB888, RGB565, ARGB1555
+ *   and ARGB4444 formats can be written.
+ *
+ *   This and the following operations return as soon as the transfer has
+ *   been started.  Any previous transfer is waited for first.  Use
+ *   stm32l4_dma2d_wait() before touching the memory involved.
+ *
+ * Input Parameters:
+ *   dest  - The surface to fill
+ *   area  - The area within dest
+ *   color - The color in the pixel format of dest
+ *
+ * Returned Value:
+ *   Zero (OK) if the transfer was started; a negated errno value if the
+ *   operation is not supported for these parameters.
+ *
+ ****************************************************************************/
+
+int stm32l4_dma2d_fill(FAR const struct stm32l4_dma2d_surface_s *dest,
+                       FAR const struct fb_area_s *area, uint32_t color);
+
+/****************************************************************************
+ * Name: stm32l4_dma2d_copy
+ *
+ * Description:
+ *   Start copying an area of src to an area of the same size in dest.  If
+ *   the pixel formats differ, then the pixels are converted on the way.
+ *
+ * Input Parameters:
+ *   dest - The surface to write
+ *   area - The area within dest
+ *   src  - The surface to read
+ *   srcx - Column in src of the first pixel to copy
+ *   srcy - Row in src of the first pixel to copy
+ *
+ * Returned Value:
+ *   Zero (OK) if the transfer was started; a negated errno value if the
+ *   operation is not supported for these parameters.
+ *
+ ****************************************************************************/
+
+int stm32l4_dma2d_copy(FAR const struct stm32l4_dma2d_surface_s *dest,
+                       FAR const struct fb_area_s *area,
+                       FAR const struct stm32l4_dma2d_surface_s *src,
+                       fb_coord_t srcx, fb_coord_t srcy);
+
+/****************************************************************************
+ * Name: stm32l4_dma2d_blend
+ *
+ * Description:
+ *   Start blending an area of fore over an area of back, writing the
+ *   result to dest.  The alpha of each foreground pixel is multiplied by
+ *   alpha; formats without an alpha channel are treated as opaque.
+ *
+ * Input Parameters:
+ *   dest  - The surface to write; may be the same as back
+ *   area  - The area within dest
+ *   fore  - The foreground surface
+ *   forex - Column in fore of the first pixel
+ *   forey - Row in fore of the first pixel
+ *   back  - The background surface
+ *   backx - Column in back of the first pixel
+ *   backy - Row in back of the first pixel
+ *   alpha - Global foreground alpha (255 = use the pixel alpha as is)
+ *
+ * Returned Value:
+ *   Zero (OK) if the transfer was started; a negated errno value if the
+ *   operation is not supported for these parameters.
+ *
+ ****************************************************************************/
+
+int stm32l4_dma2d_blend(FAR const struct stm32l4_dma2d_surface_s *dest,
+                        FAR const struct fb_area_s *area,
+                        FAR const struct stm32l4_dma2d_surface_s *fore,
+                        fb_coord_t forex, fb_coord_t forey,
+                        FAR const struct stm32l4_dma2d_surface_s *back,
+                        fb_coord_t backx, fb_coord_t backy,
+                        uint8_t alpha);
+
+/****************************************************************************
+ * Name: stm32l4_dma2d_wait
+ *
+ * Description:
+ *   Wait for the last transfer to complete.  The calling thread sleeps
+ *   until the DMA2D interrupt reports completion.
+ *
+ * Returned Value:
+ *   Zero (OK) if the last transfer completed normally; -EIO if DMA2D
+ *   reported a transfer or configuration error.
+ *
+ ****************************************************************************/
+
+int stm32l4_dma2d_wait(void);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_STM32L4_DMA2D && !__ASSEMBLY__ */
+#endif /* __ARCH_ARM_SRC_STM32L4_STM32L4_DMA2D_H */
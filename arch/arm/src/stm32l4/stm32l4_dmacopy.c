@@ -0,0 +1,337 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_dmacopy.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/semaphore.h>
+
+#include "stm32l4_dma.h"
+#include "stm32l4_dmacopy.h"
+
+#ifdef CONFIG_STM32L4_DMACOPY
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_STM32L4_DMACOPY_DMA2) || !defined(CONFIG_STM32L4_DMA1)
+#  define DMACOPY_DMAMAP      DMAMAP_MAP(DMA2, 0)
+#else
+#  define DMACOPY_DMAMAP      DMAMAP_MAP(DMA1, 0)
+#endif
+
+/* Low priority, so that the bulk copies never delay the peripherals */
+
+#define DMACOPY_CCR           (DMA_CCR_MEM2MEM | DMA_CCR_PRILO | DMA_CCR_MINC)
+
+#define DMACOPY_MAXTRANSFERS  65535
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct stm32l4_dmacopy_s
+{
+  sem_t              lock;      /* Held while the channel is in use */
+  sem_t              done;      /* End of a synchronous transfer */
+  DMA_HANDLE         dma;       /* Reserved at the first transfer */
+  dmacopy_callback_t callback;  /* NULL for a synchronous transfer */
+  FAR void          *arg;
+  uintptr_t          dest;      /* Next segment */
+  uintptr_t          src;
+  size_t             left;      /* Bytes not yet started */
+  uint32_t           ccr;
+  uint8_t            shift;     /* Log2 of the transfer width */
+  int                result;
+  uint32_t           pattern;   /* Source of a fill */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void dmacopy_callback(DMA_HANDLE handle, uint8_t status,
+                             FAR void *arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct stm32l4_dmacopy_s g_dmacopy =
+{
+  .lock = SEM_INITIALIZER(1),
+  .done = SEM_INITIALIZER(0),
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dmacopy_next
+ *
+ * Description:
+ *   Start the next segment.  A channel moves at most 65535 items at once.
+ *
+ ****************************************************************************/
+
+static void dmacopy_next(FAR struct stm32l4_dmacopy_s *priv)
+{
+  size_t ntransfers = priv->left >> priv->shift;
+  size_t nbytes;
+
+  if (ntransfers > DMACOPY_MAXTRANSFERS)
+    {
+      ntransfers = DMACOPY_MAXTRANSFERS;
+    }
+
+  stm32l4_dmasetup(priv->dma, priv->src, priv->dest, ntransfers,
+                   priv->ccr);
+  stm32l4_dmastart(priv->dma, dmacopy_callback, priv, false);
+
+  nbytes      = ntransfers << priv->shift;
+  priv->dest += nbytes;
+  priv->left -= nbytes;
+  if ((priv->ccr & DMA_CCR_PINC) != 0)
+    {
+      priv->src += nbytes;
+    }
+}
+
+/****************************************************************************
+ * Name: dmacopy_callback
+ *
+ * Description:
+ *   End of a segment, from the DMA interrupt.
+ *
+ ****************************************************************************/
+
+static void dmacopy_callback(DMA_HANDLE handle, uint8_t status,
+                             FAR void *arg)
+{
+  FAR struct stm32l4_dmacopy_s *priv = arg;
+  dmacopy_callback_t callback;
+  int result;
+
+  if ((status & DMA_STATUS_ERROR) != 0)
+    {
+      dmaerr("ERROR: DMA copy failed, status %02x\n", status);
+      stm32l4_dmastop(handle);
+      priv->result = -EIO;
+    }
+  else if (priv->left > 0)
+    {
+      dmacopy_next(priv);
+      return;
+    }
+
+  callback = priv->callback;
+  if (callback == NULL)
+    {
+      nxsem_post(&priv->done);
+    }
+  else
+    {
+      arg    = priv->arg;
+      result = priv->result;
+      nxsem_post(&priv->lock);
+      callback(arg, result);
+    }
+}
+
+/****************************************************************************
+ * Name: dmacopy_cpu
+ *
+ * Description:
+ *   Do a transfer with the CPU.
+ *
+ ****************************************************************************/
+
+static int dmacopy_cpu(FAR uint8_t *dest, FAR const uint8_t *src, size_t n,
+                       int c, dmacopy_callback_t callback, FAR void *arg)
+{
+  if (src != NULL)
+    {
+      memcpy(dest, src, n);
+    }
+  else
+    {
+      memset(dest, c, n);
+    }
+
+  if (callback != NULL)
+    {
+      callback(arg, OK);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dmacopy_transfer
+ *
+ * Description:
+ *   Copy from src, or fill with c if src is NULL.  The widest transfer
+ *   that the alignment of the buffers allows is used; the unaligned bytes
+ *   at both ends are done by the CPU before the DMA starts, which is
+ *   harmless as the buffers do not overlap.
+ *
+ ****************************************************************************/
+
+static int dmacopy_transfer(FAR uint8_t *dest, FAR const uint8_t *src,
+                            size_t n, int c, dmacopy_callback_t callback,
+                            FAR void *arg)
+{
+  FAR struct stm32l4_dmacopy_s *priv = &g_dmacopy;
+  uintptr_t diff;
+  uint32_t ccr;
+  size_t head;
+  size_t body;
+  int shift;
+  int ret;
+
+  if (n < CONFIG_STM32L4_DMACOPY_THRESHOLD)
+    {
+      return dmacopy_cpu(dest, src, n, c, callback, arg);
+    }
+
+  diff  = src != NULL ? (uintptr_t)dest ^ (uintptr_t)src : 0;
+  shift = (diff & 3) == 0 ? 2 : (diff & 1) == 0 ? 1 : 0;
+  head  = -(uintptr_t)dest & ((1 << shift) - 1);
+  body  = (n - head) & ~((1 << shift) - 1);
+
+  ccr   = DMACOPY_CCR | (src != NULL ? DMA_CCR_PINC : 0) |
+          (shift << DMA_CCR_PSIZE_SHIFT) | (shift << DMA_CCR_MSIZE_SHIFT);
+
+  if (body < CONFIG_STM32L4_DMACOPY_THRESHOLD ||
+      !stm32l4_dmacapable((uintptr_t)dest + head, body >> shift, ccr) ||
+      (src != NULL &&
+       !stm32l4_dmacapable((uintptr_t)src + head, body >> shift, ccr)))
+    {
+      return dmacopy_cpu(dest, src, n, c, callback, arg);
+    }
+
+  /* An interrupt handler can neither wait for the end of the transfer
+   * nor for the channel.
+   */
+
+  if (up_interrupt_context())
+    {
+      if (callback == NULL || nxsem_trywait(&priv->lock) < 0)
+        {
+          return dmacopy_cpu(dest, src, n, c, callback, arg);
+        }
+    }
+  else
+    {
+      nxsem_wait_uninterruptible(&priv->lock);
+    }
+
+  if (priv->dma == NULL)
+    {
+      priv->dma = stm32l4_dmachannel(DMACOPY_DMAMAP);
+      if (priv->dma == NULL)
+        {
+          nxsem_post(&priv->lock);
+          return dmacopy_cpu(dest, src, n, c, callback, arg);
+        }
+    }
+
+  dmacopy_cpu(dest, src, head, c, NULL, NULL);
+  dmacopy_cpu(dest + head + body, src != NULL ? src + head + body : NULL,
+              n - head - body, c, NULL, NULL);
+
+  if (src != NULL)
+    {
+      priv->src = (uintptr_t)src + head;
+    }
+  else
+    {
+      priv->pattern = (uint8_t)c * 0x01010101;
+      priv->src     = (uintptr_t)&priv->pattern;
+    }
+
+  priv->callback = callback;
+  priv->arg      = arg;
+  priv->dest     = (uintptr_t)dest + head;
+  priv->left     = body;
+  priv->ccr      = ccr;
+  priv->shift    = shift;
+  priv->result   = OK;
+
+  dmacopy_next(priv);
+
+  if (callback != NULL)
+    {
+      return OK;
+    }
+
+  nxsem_wait_uninterruptible(&priv->done);
+  ret = priv->result;
+  nxsem_post(&priv->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4_dmacopy
+ *
+ * Description:
+ *   Copy memory with a memory-to-memory DMA channel.
+ *
+ ****************************************************************************/
+
+int stm32l4_dmacopy(FAR void *dest, FAR const void *src, size_t n,
+                    dmacopy_callback_t callback, FAR void *arg)
+{
+  DEBUGASSERT(dest != NULL && src != NULL);
+  return dmacopy_transfer(dest, src, n, 0, callback, arg);
+}
+
+/****************************************************************************
+ * Name: stm32l4_dmafill
+ *
+ * Description:
+ *   Fill memory with a memory-to-memory DMA channel.
+ *
+ ****************************************************************************/
+
+int stm32l4_dmafill(FAR void *dest, int c, size_t n,
+                    dmacopy_callback_t callback, FAR void *arg)
+{
+  DEBUGASSERT(dest != NULL);
+  return dmacopy_transfer(dest, NULL, n, c, callback, arg);
+}
+
+#endif /* CONFIG_STM32L4_DMACOPY */
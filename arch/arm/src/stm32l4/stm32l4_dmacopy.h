@@ -0,0 +1,121 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_dmacopy.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_SRC_STM32L4_STM32L4_DMACOPY_H
+#define __ARCH_ARM_SRC_STM32L4_STM32L4_DMACOPY_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <string.h>
+
+#ifndef __ASSEMBLY__
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Called at the end of an asynchronous copy or fill, from the DMA
+ * interrupt or, if the CPU did the work, from stm32l4_dmacopy() or
+ * stm32l4_dmafill() itself.  'result' is zero (OK) or -EIO on a DMA bus
+ * error.
+ */
+
+typedef CODE void (*dmacopy_callback_t)(FAR void *arg, int result);
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#ifdef CONFIG_STM32L4_DMACOPY
+
+/****************************************************************************
+ * Name: stm32l4_dmacopy
+ *
+ * Description:
+ *   Copy n bytes from src to dest with a memory-to-memory DMA channel.  The
+ *   buffers must not overlap.  Transfers shorter than
+ *   CONFIG_STM32L4_DMACOPY_THRESHOLD, transfers from or to memory that the
+ *   DMA cannot reach, synchronous transfers from an interrupt handler and
+ *   asynchronous ones while the channel is busy are done by the CPU.
+ *
+ *   Without a callback, the call returns at the end of the transfer.  With
+ *   one, it returns as soon as the transfer is started; the buffers must
+ *   then stay valid and untouched until the callback is called.
+ *
+ * Input Parameters:
+ *   dest     - The destination
+ *   src      - The source
+ *   n        - The number of bytes
+ *   callback - Called at the end of the transfer, or NULL to wait for it
+ *   arg      - The argument of the callback
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EIO if a synchronous transfer failed.
+ *
+ ****************************************************************************/
+
+int stm32l4_dmacopy(FAR void *dest, FAR const void *src, size_t n,
+                    dmacopy_callback_t callback, FAR void *arg);
+
+/****************************************************************************
+ * Name: stm32l4_dmafill
+ *
+ * Description:
+ *   Fill n bytes at dest with the byte c, like memset(), under the same
+ *   terms as stm32l4_dmacopy().
+ *
+ ****************************************************************************/
+
+int stm32l4_dmafill(FAR void *dest, int c, size_t n,
+                    dmacopy_callback_t callback, FAR void *arg);
+
+#else
+
+/* Without the DMA service the CPU does the work */
+
+#  define stm32l4_dmacopy(dest, src, n, callback, arg) \
+     (memcpy(dest, src, n), (callback) != NULL ? \
+      ((dmacopy_callback_t)(callback))(arg, 0), 0 : 0)
+#  define stm32l4_dmafill(dest, c, n, callback, arg) \
+     (memset(dest, c, n), (callback) != NULL ? \
+      ((dmacopy_callback_t)(callback))(arg, 0), 0 : 0)
+
+#endif /* CONFIG_STM32L4_DMACOPY */
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ASSEMBLY__ */
+#endif /* __ARCH_ARM_SRC_STM32L4_STM32L4_DMACOPY_H */
@@ -0,0 +1,194 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_dmamem.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <stdint.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/mm/gran.h>
+
+#include "stm32l4_dmamem.h"
+
+#ifdef CONFIG_STM32L4_DMAMEM
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define DMAMEM_ROUNDUP(n) \
+  (((n) + STM32L4_DMAMEM_GRANULE - 1) & ~(STM32L4_DMAMEM_GRANULE - 1))
+
+#ifndef CONFIG_GRAN
+#  error CONFIG_STM32L4_DMAMEM requires CONFIG_GRAN
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The pool is placed in the section named by the configuration, if any,
+ * so that it lands in an SRAM that all the DMA masters reach.
+ */
+
+#ifdef STM32L4_DMAMEM_SECTION
+static uint8_t g_dmamem_pool[CONFIG_STM32L4_DMAMEM_SIZE]
+               locate_data(STM32L4_DMAMEM_SECTION)
+               aligned_data(STM32L4_DMAMEM_GRANULE);
+#else
+static uint8_t g_dmamem_pool[CONFIG_STM32L4_DMAMEM_SIZE]
+               aligned_data(STM32L4_DMAMEM_GRANULE);
+#endif
+
+static GRAN_HANDLE g_dmamem_handle;
+
+static struct stm32l4_dmamem_stats_s g_dmamem_stats[STM32L4_DMAMEM_NUSERS];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4_dmamem_initialize
+ *
+ * Description:
+ *   Set up the DMA buffer pool.
+ *
+ ****************************************************************************/
+
+int stm32l4_dmamem_initialize(void)
+{
+  g_dmamem_handle = gran_initialize(g_dmamem_pool, sizeof(g_dmamem_pool),
+                                    CONFIG_STM32L4_DMAMEM_GRANSHIFT,
+                                    CONFIG_STM32L4_DMAMEM_GRANSHIFT);
+
+  return g_dmamem_handle != NULL ? OK : -ENOMEM;
+}
+
+/****************************************************************************
+ * Name: stm32l4_dmamem_alloc
+ *
+ * Description:
+ *   Allocate a buffer from the DMA buffer pool.
+ *
+ ****************************************************************************/
+
+FAR void *stm32l4_dmamem_alloc(enum stm32l4_dmamem_user_e user,
+                               size_t size)
+{
+  FAR struct stm32l4_dmamem_stats_s *stats;
+  FAR void *mem = NULL;
+  irqstate_t flags;
+
+  DEBUGASSERT(user < STM32L4_DMAMEM_NUSERS);
+
+  /* gran_alloc() asserts on sizes that it cannot serve */
+
+  if (g_dmamem_handle != NULL && size > 0 &&
+      size <= STM32L4_DMAMEM_MAXALLOC)
+    {
+      mem = gran_alloc(g_dmamem_handle, size);
+    }
+
+  stats = &g_dmamem_stats[user];
+  flags = enter_critical_section();
+
+  if (mem != NULL)
+    {
+      stats->nallocs++;
+      stats->inuse += DMAMEM_ROUNDUP(size);
+      if (stats->inuse > stats->peak)
+        {
+          stats->peak = stats->inuse;
+        }
+    }
+  else
+    {
+      stats->nfails++;
+    }
+
+  leave_critical_section(flags);
+  return mem;
+}
+
+/****************************************************************************
+ * Name: stm32l4_dmamem_free
+ *
+ * Description:
+ *   Return a buffer to the DMA buffer pool.
+ *
+ ****************************************************************************/
+
+void stm32l4_dmamem_free(enum stm32l4_dmamem_user_e user, FAR void *mem,
+                         size_t size)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(user < STM32L4_DMAMEM_NUSERS);
+
+  if (mem == NULL)
+    {
+      return;
+    }
+
+  DEBUGASSERT((FAR uint8_t *)mem >= g_dmamem_pool &&
+              (FAR uint8_t *)mem < g_dmamem_pool + sizeof(g_dmamem_pool));
+
+  gran_free(g_dmamem_handle, mem, size);
+
+  flags = enter_critical_section();
+  DEBUGASSERT(g_dmamem_stats[user].inuse >= DMAMEM_ROUNDUP(size));
+  g_dmamem_stats[user].inuse -= DMAMEM_ROUNDUP(size);
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: stm32l4_dmamem_getstats
+ *
+ * Description:
+ *   Return the usage of the pool by one driver and the state of the pool.
+ *
+ ****************************************************************************/
+
+void stm32l4_dmamem_getstats(enum stm32l4_dmamem_user_e user,
+                             FAR struct stm32l4_dmamem_stats_s *stats,
+                             FAR struct graninfo_s *info)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(user < STM32L4_DMAMEM_NUSERS && stats != NULL);
+
+  flags  = enter_critical_section();
+  *stats = g_dmamem_stats[user];
+  leave_critical_section(flags);
+
+  if (info != NULL && g_dmamem_handle != NULL)
+    {
+      gran_info(g_dmamem_handle, info);
+    }
+}
+
+#endif /* CONFIG_STM32L4_DMAMEM */
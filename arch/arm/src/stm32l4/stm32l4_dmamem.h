@@ -0,0 +1,170 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_dmamem.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_SRC_STM32L4_STM32L4_DMAMEM_H
+#define __ARCH_ARM_SRC_STM32L4_STM32L4_DMAMEM_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <nuttx/mm/gran.h>
+
+#ifdef CONFIG_STM32L4_DMAMEM
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Every buffer starts on a granule boundary.  That is enough for the
+ * largest DMA burst (16 beats of 32 bits) and for the SDMMC and OTG FS
+ * word alignment.
+ */
+
+#define STM32L4_DMAMEM_GRANULE   (1 << CONFIG_STM32L4_DMAMEM_GRANSHIFT)
+
+/* The granule allocator serves at most 32 granules at once */
+
+#define STM32L4_DMAMEM_MAXALLOC  (32 * STM32L4_DMAMEM_GRANULE)
+
+#ifndef __ASSEMBLY__
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The drivers that share the pool, for the statistics */
+
+enum stm32l4_dmamem_user_e
+{
+  STM32L4_DMAMEM_SDMMC = 0,
+  STM32L4_DMAMEM_SPI,
+  STM32L4_DMAMEM_USB,
+  STM32L4_DMAMEM_SAI,
+  STM32L4_DMAMEM_OTHER,
+  STM32L4_DMAMEM_NUSERS
+};
+
+/* Usage of the pool by one driver.  Sizes are in bytes, rounded up to
+ * whole granules.
+ */
+
+struct stm32l4_dmamem_stats_s
+{
+  size_t   inuse;     /* Currently allocated */
+  size_t   peak;      /* Most allocated at once */
+  uint32_t nallocs;   /* Successful allocations */
+  uint32_t nfails;    /* Failed allocations */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: stm32l4_dmamem_initialize
+ *
+ * Description:
+ *   Set up the DMA buffer pool.  Called from arm_dma_initialize().
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if the pool could not be set up.
+ *
+ ****************************************************************************/
+
+int stm32l4_dmamem_initialize(void);
+
+/****************************************************************************
+ * Name: stm32l4_dmamem_alloc
+ *
+ * Description:
+ *   Allocate a buffer from the DMA buffer pool.  The pool is a static
+ *   array, so it can be placed in a memory that every DMA master of the
+ *   system reaches (see CONFIG_STM32L4_DMAMEM_SECTION), and buffers do not
+ *   fragment the general heap.  Must not be called from an interrupt
+ *   handler.
+ *
+ * Input Parameters:
+ *   user - The driver that allocates, for the statistics
+ *   size - The size of the buffer, at most STM32L4_DMAMEM_MAXALLOC
+ *
+ * Returned Value:
+ *   The buffer, aligned to STM32L4_DMAMEM_GRANULE, or NULL.
+ *
+ ****************************************************************************/
+
+FAR void *stm32l4_dmamem_alloc(enum stm32l4_dmamem_user_e user,
+                               size_t size);
+
+/****************************************************************************
+ * Name: stm32l4_dmamem_free
+ *
+ * Description:
+ *   Return a buffer to the DMA buffer pool.
+ *
+ * Input Parameters:
+ *   user - The driver that allocated the buffer
+ *   mem  - The buffer returned by stm32l4_dmamem_alloc()
+ *   size - The size that was passed to stm32l4_dmamem_alloc()
+ *
+ ****************************************************************************/
+
+void stm32l4_dmamem_free(enum stm32l4_dmamem_user_e user, FAR void *mem,
+                         size_t size);
+
+/****************************************************************************
+ * Name: stm32l4_dmamem_getstats
+ *
+ * Description:
+ *   Return the usage of the pool by one driver and, optionally, the state
+ *   of the whole pool.
+ *
+ * Input Parameters:
+ *   user  - The driver
+ *   stats - Location to return its usage
+ *   info  - Location to return the state of the pool, or NULL
+ *
+ ****************************************************************************/
+
+void stm32l4_dmamem_getstats(enum stm32l4_dmamem_user_e user,
+                             FAR struct stm32l4_dmamem_stats_s *stats,
+                             FAR struct graninfo_s *info);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ASSEMBLY__ */
+#endif /* CONFIG_STM32L4_DMAMEM */
+#endif /* __ARCH_ARM_SRC_STM32L4_STM32L4_DMAMEM_H */
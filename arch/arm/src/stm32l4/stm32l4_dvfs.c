@@ -0,0 +1,497 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_dvfs.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Dynamic voltage and frequency scaling for the STM32L4+.
+ *
+ * Two performance levels are supported:
+ *
+ *   HIGH - The clock tree set up by stm32l4_stdclockconfig() from board.h:
+ *          SYSCLK from the main PLL (up to 120 MHz), voltage range 1 (boost
+ *          mode above 80 MHz) and BOARD_FLASH_WAITSTATES.
+ *   LOW  - SYSCLK from MSI at 24 MHz with the main PLL stopped, voltage
+ *          range 2 and the matching flash wait states.
+ *
+ * The AHB and APB prescalers of board.h are kept in both levels, so every
+ * bus clock scales by the same factor as SYSCLK.  After a switch the
+ * registered drivers are notified and recompute their dividers from
+ * stm32l4_dvfs_scale() of the board.h frequencies.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/mutex.h>
+#include <arch/board/board.h>
+
+#include "arm_internal.h"
+#include "stm32l4_dvfs.h"
+#include "stm32l4_flash.h"
+#include "stm32l4_pwr.h"
+#include "stm32l4_rcc.h"
+
+#ifdef CONFIG_STM32L4_DVFS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if !defined(CONFIG_STM32L4_STM32L4XR)
+#  error DVFS is only supported on the STM32L4+
+#endif
+
+/* HCLK in the low level, and the flash wait states it needs in voltage
+ * range 2 (RM0432, "Number of wait states according to CPU clock (HCLK)
+ * frequency").
+ */
+
+#define DVFS_LOW_HCLK \
+  (STM32L4_HCLK_FREQUENCY * STM32L4_DVFS_LOW_FREQUENCY / \
+   STM32L4_SYSCLK_FREQUENCY)
+
+#if DVFS_LOW_HCLK <= 8000000
+#  define DVFS_LOW_WAITSTATES 0
+#elif DVFS_LOW_HCLK <= 16000000
+#  define DVFS_LOW_WAITSTATES 1
+#else
+#  define DVFS_LOW_WAITSTATES 2
+#endif
+
+#ifdef BOARD_FLASH_WAITSTATES
+#  define DVFS_HIGH_WAITSTATES BOARD_FLASH_WAITSTATES
+#else
+#  define DVFS_HIGH_WAITSTATES 3
+#endif
+
+/* Range 1 boost mode is needed if any PLL runs above 80 MHz.  This is the
+ * same condition as in stm32l4_stdclockconfig().
+ */
+
+#if STM32L4_SYSCLK_FREQUENCY > 80000000 || \
+    (defined(BOARD_MAX_PLL_FREQUENCY) && BOARD_MAX_PLL_FREQUENCY > 80000000)
+#  define DVFS_HIGH_BOOST 1
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct stm32l4_dvfs_s
+{
+  mutex_t lock;                        /* Serializes level changes */
+  dq_queue_t registry;                 /* Registered driver callbacks */
+  enum stm32l4_dvfs_level_e level;     /* Current performance level */
+  uint32_t msirange;                   /* MSI range of board.h */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct stm32l4_dvfs_s g_dvfs =
+{
+  .lock  = NXMUTEX_INITIALIZER,
+  .level = STM32L4_DVFS_HIGH,
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dvfs_setwaitstates
+ ****************************************************************************/
+
+static void dvfs_setwaitstates(uint32_t waitstates)
+{
+  modifyreg32(STM32L4_FLASH_ACR, FLASH_ACR_LATENCY_MASK,
+              FLASH_ACR_LATENCY(waitstates));
+
+  /* The new latency must be in effect before the clock is raised */
+
+  while ((getreg32(STM32L4_FLASH_ACR) & FLASH_ACR_LATENCY_MASK) !=
+         FLASH_ACR_LATENCY(waitstates))
+    {
+    }
+}
+
+/****************************************************************************
+ * Name: dvfs_waitvos
+ ****************************************************************************/
+
+static void dvfs_waitvos(void)
+{
+  while ((getreg32(STM32L4_PWR_SR2) & PWR_SR2_VOSF) != 0)
+    {
+    }
+}
+
+/****************************************************************************
+ * Name: dvfs_setmsi24
+ *
+ * Description:
+ *   Select the 24 MHz MSI range.  MSIRANGE may only be changed while MSI is
+ *   off or ready.
+ *
+ ****************************************************************************/
+
+static void dvfs_setmsi24(void)
+{
+  modifyreg32(STM32L4_RCC_CR, RCC_CR_MSIRANGE_MASK,
+              RCC_CR_MSIRANGE_24M | RCC_CR_MSIRGSEL);
+
+  while ((getreg32(STM32L4_RCC_CR) & RCC_CR_MSIRDY) == 0)
+    {
+    }
+}
+
+/****************************************************************************
+ * Name: dvfs_lowclock
+ *
+ * Description:
+ *   Switch from the board.h clock tree to the low level.
+ *
+ ****************************************************************************/
+
+static void dvfs_lowclock(void)
+{
+  bool msipll;
+
+  msipll = (getreg32(STM32L4_RCC_PLLCFG) & RCC_PLLCFG_PLLSRC_MASK) ==
+           RCC_PLLCFG_PLLSRC_MSI;
+
+  /* Make sure that MSI runs */
+
+  modifyreg32(STM32L4_RCC_CR, 0, RCC_CR_MSION);
+  while ((getreg32(STM32L4_RCC_CR) & RCC_CR_MSIRDY) == 0)
+    {
+    }
+
+  /* If MSI is the PLL input, its range can only change once the PLL has
+   * been stopped.
+   */
+
+  if (!msipll)
+    {
+      dvfs_setmsi24();
+    }
+
+  /* Run from MSI and stop the PLL */
+
+  modifyreg32(STM32L4_RCC_CFGR, RCC_CFGR_SW_MASK, RCC_CFGR_SW_MSI);
+  while ((getreg32(STM32L4_RCC_CFGR) & RCC_CFGR_SWS_MASK) !=
+         RCC_CFGR_SWS_MSI)
+    {
+    }
+
+  modifyreg32(STM32L4_RCC_CR, RCC_CR_PLLON, 0);
+  while ((getreg32(STM32L4_RCC_CR) & RCC_CR_PLLRDY) != 0)
+    {
+    }
+
+  if (msipll)
+    {
+      dvfs_setmsi24();
+    }
+
+  /* With the clock lowered, reduce the wait states and leave boost mode
+   * for range 2.
+   */
+
+  dvfs_setwaitstates(DVFS_LOW_WAITSTATES);
+
+#ifdef DVFS_HIGH_BOOST
+  modifyreg32(STM32L4_PWR_CR5, 0, PWR_CR5_R1MODE);
+  dvfs_waitvos();
+#endif
+
+  stm32_pwr_setvos(2);
+  dvfs_waitvos();
+}
+
+/****************************************************************************
+ * Name: dvfs_highclock
+ *
+ * Description:
+ *   Switch from the low level back to the board.h clock tree.
+ *
+ ****************************************************************************/
+
+static void dvfs_highclock(void)
+{
+#ifdef DVFS_HIGH_BOOST
+  uint32_t hpre;
+#endif
+
+  /* Raise the voltage and the wait states before the clock */
+
+  stm32_pwr_setvos(1);
+  dvfs_waitvos();
+
+#ifdef DVFS_HIGH_BOOST
+  modifyreg32(STM32L4_PWR_CR5, PWR_CR5_R1MODE, 0);
+  dvfs_waitvos();
+#endif
+
+  dvfs_setwaitstates(DVFS_HIGH_WAITSTATES);
+
+  /* Restore the MSI range (it may feed the PLL) and restart the PLL; its
+   * configuration is retained.
+   */
+
+  modifyreg32(STM32L4_RCC_CR, RCC_CR_MSIRANGE_MASK | RCC_CR_MSIRGSEL,
+              g_dvfs.msirange);
+  while ((getreg32(STM32L4_RCC_CR) & RCC_CR_MSIRDY) == 0)
+    {
+    }
+
+  modifyreg32(STM32L4_RCC_CR, 0, RCC_CR_PLLON);
+  while ((getreg32(STM32L4_RCC_CR) & RCC_CR_PLLRDY) == 0)
+    {
+    }
+
+#ifdef DVFS_HIGH_BOOST
+  /* Going above 80 MHz in boost mode, HCLK must first be run at half
+   * speed for 1 us (RM0432, "Dynamic voltage scaling management").
+   */
+
+  hpre = getreg32(STM32L4_RCC_CFGR) & RCC_CFGR_HPRE_MASK;
+  if (hpre == RCC_CFGR_HPRE_SYSCLK)
+    {
+      modifyreg32(STM32L4_RCC_CFGR, RCC_CFGR_HPRE_MASK,
+                  RCC_CFGR_HPRE_SYSCLKd2);
+    }
+#endif
+
+  modifyreg32(STM32L4_RCC_CFGR, RCC_CFGR_SW_MASK, RCC_CFGR_SW_PLL);
+  while ((getreg32(STM32L4_RCC_CFGR) & RCC_CFGR_SWS_MASK) !=
+         RCC_CFGR_SWS_PLL)
+    {
+    }
+
+#ifdef DVFS_HIGH_BOOST
+  if (hpre == RCC_CFGR_HPRE_SYSCLK)
+    {
+      up_udelay(1);
+      modifyreg32(STM32L4_RCC_CFGR, RCC_CFGR_HPRE_MASK, hpre);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4_dvfs_register
+ *
+ * Description:
+ *   Register a driver for clock change notifications.
+ *
+ ****************************************************************************/
+
+int stm32l4_dvfs_register(struct stm32l4_dvfs_callback_s *cb)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(cb != NULL && cb->notify != NULL);
+
+  flags = enter_critical_section();
+  dq_addlast(&cb->entry, &g_dvfs.registry);
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4_dvfs_unregister
+ *
+ * Description:
+ *   Remove a callback registered with stm32l4_dvfs_register().
+ *
+ ****************************************************************************/
+
+void stm32l4_dvfs_unregister(struct stm32l4_dvfs_callback_s *cb)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(cb != NULL);
+
+  flags = enter_critical_section();
+  dq_rem(&cb->entry, &g_dvfs.registry);
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: stm32l4_dvfs_setlevel
+ *
+ * Description:
+ *   Switch the PLL, voltage range and flash wait states to a new
+ *   performance level and notify the registered drivers.
+ *
+ ****************************************************************************/
+
+int stm32l4_dvfs_setlevel(enum stm32l4_dvfs_level_e level)
+{
+  struct stm32l4_dvfs_callback_s *cb;
+  dq_entry_t *entry;
+  irqstate_t flags;
+  uint32_t sysclk;
+  int ret;
+
+  DEBUGASSERT(level == STM32L4_DVFS_LOW || level == STM32L4_DVFS_HIGH);
+
+  ret = nxmutex_lock(&g_dvfs.lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (level == g_dvfs.level)
+    {
+      goto errout;
+    }
+
+  sysclk = level == STM32L4_DVFS_LOW ? STM32L4_DVFS_LOW_FREQUENCY :
+                                       STM32L4_SYSCLK_FREQUENCY;
+
+  /* The audio PLLs are limited to 26 MHz in range 2 */
+
+  if (level == STM32L4_DVFS_LOW &&
+      (getreg32(STM32L4_RCC_CR) &
+       (RCC_CR_PLLSAI1ON | RCC_CR_PLLSAI2ON)) != 0)
+    {
+      ret = -EBUSY;
+      goto errout;
+    }
+
+  /* Give every driver the chance to refuse the change */
+
+  for (entry = dq_peek(&g_dvfs.registry); entry; entry = dq_next(entry))
+    {
+      cb = (struct stm32l4_dvfs_callback_s *)entry;
+      if (cb->prepare != NULL)
+        {
+          ret = cb->prepare(cb, sysclk);
+          if (ret < 0)
+            {
+              pwrwarn("WARNING: DVFS change to %" PRIu32 " Hz refused: %d\n",
+                    sysclk, ret);
+              goto errout;
+            }
+        }
+    }
+
+  /* Switch the clocks and reprogram the drivers before any interrupt
+   * handler can run with stale dividers.
+   */
+
+  flags = enter_critical_section();
+
+  if (level == STM32L4_DVFS_LOW)
+    {
+      /* Remember the MSI range of board.h for the way back */
+
+      g_dvfs.msirange = getreg32(STM32L4_RCC_CR) &
+                        (RCC_CR_MSIRANGE_MASK | RCC_CR_MSIRGSEL);
+      dvfs_lowclock();
+    }
+  else
+    {
+      dvfs_highclock();
+    }
+
+  g_dvfs.level = level;
+
+  for (entry = dq_peek(&g_dvfs.registry); entry; entry = dq_next(entry))
+    {
+      cb = (struct stm32l4_dvfs_callback_s *)entry;
+      cb->notify(cb, sysclk);
+    }
+
+  leave_critical_section(flags);
+  ret = OK;
+
+errout:
+  nxmutex_unlock(&g_dvfs.lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: stm32l4_dvfs_getlevel
+ *
+ * Description:
+ *   Return the current performance level.
+ *
+ ****************************************************************************/
+
+enum stm32l4_dvfs_level_e stm32l4_dvfs_getlevel(void)
+{
+  return g_dvfs.level;
+}
+
+/****************************************************************************
+ * Name: stm32l4_dvfs_scale
+ *
+ * Description:
+ *   Convert a clock frequency of board.h that is derived from SYSCLK to its
+ *   value in the current performance level.
+ *
+ ****************************************************************************/
+
+uint32_t stm32l4_dvfs_scale(uint32_t frequency)
+{
+  if (g_dvfs.level == STM32L4_DVFS_HIGH)
+    {
+      return frequency;
+    }
+
+  return (uint32_t)(((uint64_t)frequency * STM32L4_DVFS_LOW_FREQUENCY) /
+                    STM32L4_SYSCLK_FREQUENCY);
+}
+
+/****************************************************************************
+ * Name: stm32l4_dvfs_resume
+ *
+ * Description:
+ *   Restore the clocks of the low performance level on wakeup from Stop
+ *   mode.
+ *
+ ****************************************************************************/
+
+void stm32l4_dvfs_resume(void)
+{
+  DEBUGASSERT(g_dvfs.level == STM32L4_DVFS_LOW);
+  dvfs_lowclock();
+}
+
+#endif /* CONFIG_STM32L4_DVFS */
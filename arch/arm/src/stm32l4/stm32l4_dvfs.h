@@ -0,0 +1,213 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_dvfs.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_SRC_STM32L4_STM32L4_DVFS_H
+#define __ARCH_ARM_SRC_STM32L4_STM32L4_DVFS_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/queue.h>
+
+#ifdef CONFIG_STM32L4_DVFS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* SYSCLK in the low performance level: MSI at 24 MHz, which is the fastest
+ * MSI range allowed in voltage range 2.
+ */
+
+#define STM32L4_DVFS_LOW_FREQUENCY 24000000ul
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifndef __ASSEMBLY__
+
+/* Performance levels */
+
+enum stm32l4_dvfs_level_e
+{
+  STM32L4_DVFS_LOW = 0,  /* SYSCLK from MSI at 24 MHz, voltage range 2 */
+  STM32L4_DVFS_HIGH      /* Clock tree of board.h, voltage range 1 */
+};
+
+/* Drivers whose dividers depend on the bus clocks register one of these
+ * with stm32l4_dvfs_register().  The bus prescalers of board.h are kept in
+ * both levels, so every bus clock scales with SYSCLK; drivers may simply
+ * recompute their dividers from stm32l4_dvfs_scale() of the board.h value.
+ */
+
+struct stm32l4_dvfs_callback_s
+{
+  struct dq_entry_s entry;  /* Supports a doubly linked list */
+
+  /**************************************************************************
+   * Name: prepare
+   *
+   * Description:
+   *   Request the driver to prepare for a new SYSCLK frequency.  Called
+   *   from thread context before the clocks are touched.  A negated errno
+   *   value aborts the change, e.g. because a transfer is in progress or
+   *   the peripheral cannot run from the new clock.  Must not change any
+   *   driver state.  May be NULL.
+   *
+   **************************************************************************/
+
+  int (*prepare)(struct stm32l4_dvfs_callback_s *cb, uint32_t sysclk);
+
+  /**************************************************************************
+   * Name: notify
+   *
+   * Description:
+   *   Notify the driver that SYSCLK now runs at 'sysclk'.  Called within a
+   *   critical section right after the switch, so no interrupt handler
+   *   runs with stale dividers.  Must only reprogram registers.
+   *
+   **************************************************************************/
+
+  void (*notify)(struct stm32l4_dvfs_callback_s *cb, uint32_t sysclk);
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: stm32l4_dvfs_register
+ *
+ * Description:
+ *   Register a driver for clock change notifications.  May be called
+ *   during early initialization.
+ *
+ * Input Parameters:
+ *   cb - The driver's callback structure.  Must remain valid until
+ *        unregistered.
+ *
+ * Returned Value:
+ *   Zero (OK) on success.
+ *
+ ****************************************************************************/
+
+int stm32l4_dvfs_register(struct stm32l4_dvfs_callback_s *cb);
+
+/****************************************************************************
+ * Name: stm32l4_dvfs_unregister
+ *
+ * Description:
+ *   Remove a callback registered with stm32l4_dvfs_register().
+ *
+ ****************************************************************************/
+
+void stm32l4_dvfs_unregister(struct stm32l4_dvfs_callback_s *cb);
+
+/****************************************************************************
+ * Name: stm32l4_dvfs_setlevel
+ *
+ * Description:
+ *   Switch the PLL, voltage range and flash wait states to a new
+ *   performance level and notify the registered drivers.
+ *
+ * Input Parameters:
+ *   level - The new performance level
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value if a driver or the clock
+ *   tree refused the change.  The clocks are unchanged in that case.
+ *
+ * Assumptions:
+ *   Called from thread context.
+ *
+ ****************************************************************************/
+
+int stm32l4_dvfs_setlevel(enum stm32l4_dvfs_level_e level);
+
+/****************************************************************************
+ * Name: stm32l4_dvfs_getlevel
+ *
+ * Description:
+ *   Return the current performance level.
+ *
+ ****************************************************************************/
+
+enum stm32l4_dvfs_level_e stm32l4_dvfs_getlevel(void);
+
+/****************************************************************************
+ * Name: stm32l4_dvfs_scale
+ *
+ * Description:
+ *   Convert a clock frequency of board.h that is derived from SYSCLK
+ *   (STM32L4_HCLK_FREQUENCY, STM32L4_PCLKn_FREQUENCY,
+ *   BOARD_TIMn_FREQUENCY, ...) to its value in the current performance
+ *   level.
+ *
+ ****************************************************************************/
+
+uint32_t stm32l4_dvfs_scale(uint32_t frequency);
+
+/****************************************************************************
+ * Name: stm32l4_dvfs_resume
+ *
+ * Description:
+ *   Restore the clocks of the low performance level on wakeup from Stop
+ *   mode.  Called by stm32l4_clockenable() in place of the board.h clock
+ *   configuration while the low level is selected (Stop mode retains the
+ *   voltage range, so the PLL must not be restarted).  Drivers are not
+ *   notified; they are still set up for the low level.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void stm32l4_dvfs_resume(void);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __ASSEMBLY__ */
+
+#else /* CONFIG_STM32L4_DVFS */
+
+/* Without DVFS the clocks of board.h are fixed */
+
+#  define stm32l4_dvfs_scale(f) (f)
+
+#endif /* CONFIG_STM32L4_DVFS */
+#endif /* __ARCH_ARM_SRC_STM32L4_STM32L4_DVFS_H */
@@ -0,0 +1,571 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_fb.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/board.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/lcd/lcd.h>
+#include <nuttx/video/fb.h>
+
+#include "stm32l4_dma2d.h"
+#include "stm32l4_sramheap.h"
+
+#ifdef CONFIG_STM32L4_FB
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Only one display with a single video plane is supported */
+
+#define STM32L4_FB_DISPLAY  0
+#define STM32L4_FB_PLANE    0
+
+#if defined(CONFIG_STM32L4_FB_RGB565)
+#  define STM32L4_FB_BPP    16
+#  define STM32L4_FB_FMT    FB_FMT_RGB16_565
+#  define STM32L4_FB_PF     DMA2D_PF_RGB565
+#elif defined(CONFIG_STM32L4_FB_RGB888)
+#  define STM32L4_FB_BPP    24
+#  define STM32L4_FB_FMT    FB_FMT_RGB24
+#  define STM32L4_FB_PF     DMA2D_PF_RGB888
+#else
+#  define STM32L4_FB_BPP    32
+#  define STM32L4_FB_FMT    FB_FMT_RGB32
+#  define STM32L4_FB_PF     DMA2D_PF_ARGB8888
+#endif
+
+/* The framebuffer goes to SRAM3 and the line buffers to SRAM1 when these
+ * have heaps of their own.
+ */
+
+#ifdef CONFIG_STM32L4_SRAM_HEAPS
+#  define stm32l4_fb_memalign(h,a,s) stm32l4_heap_memalign(h, a, s)
+#  define stm32l4_fb_free(m)         stm32l4_heap_free(m)
+#else
+#  define stm32l4_fb_memalign(h,a,s) kmm_memalign(a, s)
+#  define stm32l4_fb_free(m)         kmm_free(m)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The framebuffer lies in SRAM3 or in an external memory.  An updated area
+ * is flushed to the LCD in bands of CONFIG_STM32L4_FB_NLINES rows: DMA2D
+ * packs (and converts) the next band into one line buffer while the LCD
+ * driver sends the previous one from the other.
+ */
+
+struct stm32l4_fb_s
+{
+  struct fb_vtable_s vtable;        /* Must be first */
+  FAR struct lcd_dev_s *lcd;        /* The attached display */
+  struct lcd_planeinfo_s pinfo;     /* Plane of the attached display */
+  mutex_t lock;                     /* Serializes the flushes */
+  FAR uint8_t *fbmem;               /* The framebuffer */
+  FAR uint8_t *band[2];             /* Line buffers in the LCD format */
+  size_t fblen;                     /* Size of the framebuffer in bytes */
+  fb_coord_t xres;                  /* Horizontal resolution */
+  fb_coord_t yres;                  /* Vertical resolution */
+  fb_coord_t stride;                /* Length of a framebuffer row */
+  uint8_t lcdpf;                    /* DMA2D pixel format of the LCD */
+  bool initialized;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int stm32l4_fb_getvideoinfo(FAR struct fb_vtable_s *vtable,
+                                   FAR struct fb_videoinfo_s *vinfo);
+static int stm32l4_fb_getplaneinfo(FAR struct fb_vtable_s *vtable,
+                                   int planeno,
+                                   FAR struct fb_planeinfo_s *pinfo);
+static int stm32l4_fb_updatearea(FAR struct fb_vtable_s *vtable,
+                                 FAR const struct fb_area_s *area);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct stm32l4_fb_s g_stm32l4_fb =
+{
+  .vtable =
+    {
+      .getvideoinfo = stm32l4_fb_getvideoinfo,
+      .getplaneinfo = stm32l4_fb_getplaneinfo,
+      .updatearea   = stm32l4_fb_updatearea,
+    },
+  .lock   = NXMUTEX_INITIALIZER,
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4_fb_getvideoinfo
+ ****************************************************************************/
+
+static int stm32l4_fb_getvideoinfo(FAR struct fb_vtable_s *vtable,
+                                   FAR struct fb_videoinfo_s *vinfo)
+{
+  FAR struct stm32l4_fb_s *priv = (FAR struct stm32l4_fb_s *)vtable;
+
+  DEBUGASSERT(priv != NULL && vinfo != NULL);
+
+  memset(vinfo, 0, sizeof(struct fb_videoinfo_s));
+  vinfo->fmt     = STM32L4_FB_FMT;
+  vinfo->xres    = priv->xres;
+  vinfo->yres    = priv->yres;
+  vinfo->nplanes = 1;
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4_fb_getplaneinfo
+ ****************************************************************************/
+
+static int stm32l4_fb_getplaneinfo(FAR struct fb_vtable_s *vtable,
+                                   int planeno,
+                                   FAR struct fb_planeinfo_s *pinfo)
+{
+  FAR struct stm32l4_fb_s *priv = (FAR struct stm32l4_fb_s *)vtable;
+
+  DEBUGASSERT(priv != NULL && pinfo != NULL);
+
+  if (planeno != STM32L4_FB_PLANE)
+    {
+      return -EINVAL;
+    }
+
+  memset(pinfo, 0, sizeof(struct fb_planeinfo_s));
+  pinfo->fbmem   = priv->fbmem;
+  pinfo->fblen   = priv->fblen;
+  pinfo->stride  = priv->stride;
+  pinfo->display = STM32L4_FB_DISPLAY;
+  pinfo->bpp     = STM32L4_FB_BPP;
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4_fb_pack
+ *
+ * Description:
+ *   Start the DMA2D transfer that packs 'nrows' rows of an area of the
+ *   framebuffer, starting at row 'y', into a line buffer.
+ *
+ ****************************************************************************/
+
+static int stm32l4_fb_pack(FAR struct stm32l4_fb_s *priv,
+                           FAR uint8_t *band,
+                           FAR const struct fb_area_s *area,
+                           fb_coord_t y, fb_coord_t nrows)
+{
+  struct stm32l4_dma2d_surface_s dest;
+  struct stm32l4_dma2d_surface_s src;
+  struct fb_area_s rect;
+
+  src.mem     = priv->fbmem;
+  src.stride  = priv->stride;
+  src.fmt     = STM32L4_FB_PF;
+
+  dest.mem    = band;
+  dest.stride = area->w * (priv->pinfo.bpp >> 3);
+  dest.fmt    = priv->lcdpf;
+
+  rect.x      = 0;
+  rect.y      = 0;
+  rect.w      = area->w;
+  rect.h      = nrows;
+
+  return stm32l4_dma2d_copy(&dest, &rect, &src, area->x, y);
+}
+
+/****************************************************************************
+ * Name: stm32l4_fb_send
+ *
+ * Description:
+ *   Send a packed band to the LCD.
+ *
+ ****************************************************************************/
+
+static int stm32l4_fb_send(FAR struct stm32l4_fb_s *priv,
+                           FAR const uint8_t *band,
+                           FAR const struct fb_area_s *area,
+                           fb_coord_t y, fb_coord_t nrows)
+{
+  FAR struct lcd_planeinfo_s *pinfo = &priv->pinfo;
+  fb_coord_t stride = area->w * (pinfo->bpp >> 3);
+  fb_coord_t row;
+  int ret;
+
+  if (pinfo->putarea != NULL)
+    {
+      return pinfo->putarea(pinfo->dev, y, y + nrows - 1, area->x,
+                            area->x + area->w - 1, band, stride);
+    }
+
+  for (row = y; row < y + nrows; row++)
+    {
+      ret = pinfo->putrun(pinfo->dev, row, area->x, band, area->w);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      band += stride;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4_fb_flush
+ *
+ * Description:
+ *   Write a (clipped) area of the framebuffer to the LCD.  Any rendering by
+ *   DMA2D that is still in progress completes first, because DMA2D runs
+ *   its transfers in order.
+ *
+ ****************************************************************************/
+
+static int stm32l4_fb_flush(FAR struct stm32l4_fb_s *priv,
+                            FAR const struct fb_area_s *area)
+{
+  fb_coord_t y = area->y;
+  fb_coord_t yend = area->y + area->h;
+  fb_coord_t nrows;
+  fb_coord_t next;
+  int cur = 0;
+  int ret;
+
+  nrows = MIN(yend - y, CONFIG_STM32L4_FB_NLINES);
+  ret   = stm32l4_fb_pack(priv, priv->band[cur], area, y, nrows);
+
+  while (ret >= 0)
+    {
+      ret = stm32l4_dma2d_wait();
+      if (ret < 0)
+        {
+          break;
+        }
+
+      /* Start packing the next band before sending this one */
+
+      next = y + nrows;
+      if (next < yend)
+        {
+          ret = stm32l4_fb_pack(priv, priv->band[cur ^ 1], area, next,
+                                MIN(yend - next,
+                                    CONFIG_STM32L4_FB_NLINES));
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+
+      ret = stm32l4_fb_send(priv, priv->band[cur], area, y, nrows);
+      if (ret < 0 || next >= yend)
+        {
+          break;
+        }
+
+      y     = next;
+      nrows = MIN(yend - y, CONFIG_STM32L4_FB_NLINES);
+      cur  ^= 1;
+    }
+
+  /* Do not leave a transfer into the line buffers behind */
+
+  stm32l4_dma2d_wait();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: stm32l4_fb_updatearea
+ *
+ * Description:
+ *   FBIO_UPDATE: write the area that was changed to the LCD.  A NULL area
+ *   updates the whole display.
+ *
+ ****************************************************************************/
+
+static int stm32l4_fb_updatearea(FAR struct fb_vtable_s *vtable,
+                                 FAR const struct fb_area_s *area)
+{
+  FAR struct stm32l4_fb_s *priv = (FAR struct stm32l4_fb_s *)vtable;
+  FAR struct lcd_planeinfo_s *pinfo = &priv->pinfo;
+  struct fb_area_s rect;
+  int ret;
+
+  rect.x = 0;
+  rect.y = 0;
+  rect.w = priv->xres;
+  rect.h = priv->yres;
+
+  if (area != NULL)
+    {
+      if (area->x >= priv->xres || area->y >= priv->yres)
+        {
+          return OK;
+        }
+
+      rect.x = area->x;
+      rect.y = area->y;
+      rect.w = MIN(area->w, priv->xres - area->x);
+      rect.h = MIN(area->h, priv->yres - area->y);
+    }
+
+  if (rect.w == 0 || rect.h == 0)
+    {
+      return OK;
+    }
+
+  nxmutex_lock(&priv->lock);
+
+  ret = stm32l4_fb_flush(priv, &rect);
+  if (ret >= 0 && pinfo->redraw != NULL)
+    {
+      pinfo->redraw(pinfo->dev);
+    }
+
+  nxmutex_unlock(&priv->lock);
+
+  if (ret < 0)
+    {
+      gerr("ERROR: Failed to update the display: %d\n", ret);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_fbinitialize
+ *
+ * Description:
+ *   Initialize the LCD attached by the board, allocate the framebuffer and
+ *   the line buffers and clear the display.
+ *
+ * Input Parameters:
+ *   display - The display number; only display 0 is supported.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned success; a negated errno value is returned on any
+ *   failure.
+ *
+ ****************************************************************************/
+
+int up_fbinitialize(int display)
+{
+  FAR struct stm32l4_fb_s *priv = &g_stm32l4_fb;
+  struct fb_videoinfo_s vinfo;
+  size_t bandlen;
+  int ret;
+
+  if (display != STM32L4_FB_DISPLAY)
+    {
+      return -EINVAL;
+    }
+
+  if (priv->initialized)
+    {
+      return OK;
+    }
+
+  ret = stm32l4_dma2d_initialize();
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = board_lcd_initialize();
+  if (ret < 0)
+    {
+      gerr("ERROR: board_lcd_initialize failed: %d\n", ret);
+      return ret;
+    }
+
+  priv->lcd = board_lcd_getdev(display);
+  if (priv->lcd == NULL)
+    {
+      ret = -ENODEV;
+      goto errout_with_lcd;
+    }
+
+  ret = priv->lcd->getvideoinfo(priv->lcd, &vinfo);
+  if (ret >= 0)
+    {
+      ret = priv->lcd->getplaneinfo(priv->lcd, STM32L4_FB_PLANE,
+                                    &priv->pinfo);
+    }
+
+  if (ret < 0)
+    {
+      goto errout_with_lcd;
+    }
+
+  /* DMA2D converts the framebuffer to the pixel format of the LCD */
+
+  switch (priv->pinfo.bpp)
+    {
+      case 16:
+        priv->lcdpf = DMA2D_PF_RGB565;
+        break;
+
+      case 24:
+        priv->lcdpf = DMA2D_PF_RGB888;
+        break;
+
+      case 32:
+        priv->lcdpf = DMA2D_PF_ARGB8888;
+        break;
+
+      default:
+        gerr("ERROR: Unsupported LCD bpp: %d\n", priv->pinfo.bpp);
+        ret = -ENOSYS;
+        goto errout_with_lcd;
+    }
+
+  priv->xres   = vinfo.xres;
+  priv->yres   = vinfo.yres;
+  priv->stride = vinfo.xres * (STM32L4_FB_BPP >> 3);
+  priv->fblen  = (size_t)priv->stride * vinfo.yres;
+
+#if CONFIG_STM32L4_FB_BASE != 0
+  priv->fbmem  = (FAR uint8_t *)CONFIG_STM32L4_FB_BASE;
+#else
+  priv->fbmem  = stm32l4_fb_memalign(STM32L4_HEAP_BULK, sizeof(uint32_t),
+                                     priv->fblen);
+  if (priv->fbmem == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_lcd;
+    }
+#endif
+
+  /* The line buffers are read by the DMA of the LCD interface */
+
+  bandlen = (size_t)vinfo.xres * (priv->pinfo.bpp >> 3) *
+            CONFIG_STM32L4_FB_NLINES;
+
+  priv->band[0] = stm32l4_fb_memalign(STM32L4_HEAP_DMA, sizeof(uint32_t),
+                                      2 * bandlen);
+  if (priv->band[0] == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_fbmem;
+    }
+
+  priv->band[1] = priv->band[0] + bandlen;
+
+  memset(priv->fbmem, 0, priv->fblen);
+  priv->initialized = true;
+
+  stm32l4_fb_updatearea(&priv->vtable, NULL);
+  priv->lcd->setpower(priv->lcd, CONFIG_LCD_MAXPOWER);
+  return OK;
+
+errout_with_fbmem:
+#if CONFIG_STM32L4_FB_BASE == 0
+  stm32l4_fb_free(priv->fbmem);
+#endif
+  priv->fbmem = NULL;
+
+errout_with_lcd:
+  board_lcd_uninitialize();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: up_fbgetvplane
+ *
+ * Description:
+ *   Return a reference to the framebuffer object for the specified video
+ *   plane of the specified display.
+ *
+ ****************************************************************************/
+
+FAR struct fb_vtable_s *up_fbgetvplane(int display, int vplane)
+{
+  FAR struct stm32l4_fb_s *priv = &g_stm32l4_fb;
+
+  if (display != STM32L4_FB_DISPLAY || vplane != STM32L4_FB_PLANE ||
+      !priv->initialized)
+    {
+      return NULL;
+    }
+
+  return &priv->vtable;
+}
+
+/****************************************************************************
+ * Name: up_fbuninitialize
+ *
+ * Description:
+ *   Turn the display off and release the framebuffer.
+ *
+ ****************************************************************************/
+
+void up_fbuninitialize(int display)
+{
+  FAR struct stm32l4_fb_s *priv = &g_stm32l4_fb;
+
+  if (display != STM32L4_FB_DISPLAY || !priv->initialized)
+    {
+      return;
+    }
+
+  nxmutex_lock(&priv->lock);
+
+  priv->initialized = false;
+  priv->lcd->setpower(priv->lcd, 0);
+  board_lcd_uninitialize();
+
+  stm32l4_fb_free(priv->band[0]);
+#if CONFIG_STM32L4_FB_BASE == 0
+  stm32l4_fb_free(priv->fbmem);
+#endif
+  priv->fbmem = NULL;
+
+  nxmutex_unlock(&priv->lock);
+}
+
+#endif /* CONFIG_STM32L4_FB */
@@ -23,8 +23,13 @@
  *
  * Notes about this implementation:
  *  - HSI16 is automatically turned ON by MCU, if not enabled beforehand
- *  - Only Standard Programming is supported, no Fast Programming.
+ *  - up_progmem_write() uses Standard Programming.  Fast Programming is
+ *    available through stm32l4_flash_fastwrite() on a mass erased bank.
  *  - Low Power Modes are not permitted during write/erase
+ *  - With CONFIG_STM32L4_FLASH_INTERRUPT the end of each erase and program
+ *    operation is signalled by the FLASH interrupt.  The calling thread
+ *    sleeps meanwhile, so other threads keep running from the other bank
+ *    (read-while-write) without being stalled by busy-waiting.
  */
 
 /****************************************************************************
@@ -33,8 +38,12 @@
 
 #include <nuttx/config.h>
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/init.h>
+#include <nuttx/irq.h>
 #include <nuttx/progmem.h>
 #include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
 
 #include <assert.h>
 #include <debug.h>
@@ -46,6 +55,7 @@
 #include "stm32l4_rcc.h"
 #include "stm32l4_waste.h"
 #include "stm32l4_flash.h"
+#include "stm32l4_flashcache.h"
 #include "arm_internal.h"
 
 #if !(defined(CONFIG_STM32L4_STM32L4X3) || defined(CONFIG_STM32L4_STM32L4X5) || \
@@ -89,6 +99,22 @@
                             FLASH_SR_PGAERR | FLASH_SR_WRPERR | \
                             FLASH_SR_PROGERR)
 
+/* All errors for Fast Programming */
+
+#define FLASH_SR_FASTERRS  (FLASH_SR_ALLERRS | FLASH_SR_MISERR | \
+                            FLASH_SR_FASTERR)
+
+#define FLASH_ROW_SIZE     STM32L4_FLASH_ROWSIZE
+#define FLASH_ROW_WORDS    (FLASH_ROW_SIZE / 4)
+#define FLASH_ROW_MASK     (FLASH_ROW_SIZE - 1)
+
+/* Upper bound for an interrupt driven page erase or double-word program
+ * (the datasheet maximum is 24.5 ms for a page erase).  Should the interrupt
+ * not arrive, flash_wait() falls back to polling BSY.
+ */
+
+#define FLASH_TIMEOUT      MSEC2TICK(50)
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -96,10 +122,97 @@
 static mutex_t g_lock = NXMUTEX_INITIALIZER;
 static uint32_t g_page_buffer[FLASH_PAGE_WORDS];
 
+#ifdef CONFIG_STM32L4_FLASH_INTERRUPT
+static sem_t g_done = SEM_INITIALIZER(0);
+static bool g_irqattached;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_STM32L4_FLASH_INTERRUPT
+static int flash_interrupt(int irq, void *context, void *arg)
+{
+  uint32_t regval;
+
+  /* EOP is set when an operation completed successfully, OPERR when it
+   * failed.  Leave the detailed error flags for the caller.
+   */
+
+  regval = getreg32(STM32L4_FLASH_SR) & (FLASH_SR_EOP | FLASH_SR_OPERR);
+  if (regval != 0)
+    {
+      putreg32(regval, STM32L4_FLASH_SR);
+      nxsem_post(&g_done);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: flash_irqenable
+ *
+ * Description:
+ *   Select interrupt driven completion for the following operations, if
+ *   the caller is allowed to sleep.  Called with g_lock held.
+ *
+ ****************************************************************************/
+
+static void flash_irqenable(void)
+{
+  if (up_interrupt_context() || !OSINIT_OS_READY())
+    {
+      return;
+    }
+
+  if (!g_irqattached)
+    {
+      irq_attach(STM32L4_IRQ_FLASH, flash_interrupt, NULL);
+      up_enable_irq(STM32L4_IRQ_FLASH);
+      g_irqattached = true;
+    }
+
+  modifyreg32(STM32L4_FLASH_CR, 0, FLASH_CR_EOPIE | FLASH_CR_ERRIE);
+}
+
+static void flash_irqdisable(void)
+{
+  modifyreg32(STM32L4_FLASH_CR, FLASH_CR_EOPIE | FLASH_CR_ERRIE, 0);
+}
+#endif /* CONFIG_STM32L4_FLASH_INTERRUPT */
+
+/****************************************************************************
+ * Name: flash_wait
+ *
+ * Description:
+ *   Wait for the end of the current erase or program operation.
+ *
+ ****************************************************************************/
+
+static void flash_wait(void)
+{
+#ifdef CONFIG_STM32L4_FLASH_INTERRUPT
+  if ((getreg32(STM32L4_FLASH_CR) & FLASH_CR_EOPIE) != 0)
+    {
+      if (nxsem_tickwait_uninterruptible(&g_done, FLASH_TIMEOUT) < 0)
+        {
+          /* Do not let a late interrupt complete the next operation */
+
+          ferr("flash interrupt timeout, status: 0x%" PRIx32 "\n",
+               getreg32(STM32L4_FLASH_SR));
+          flash_irqdisable();
+          nxsem_reset(&g_done, 0);
+        }
+    }
+#endif
+
+  while (getreg32(STM32L4_FLASH_SR) & FLASH_SR_BSY)
+    {
+      stm32l4_waste();
+    }
+}
+
 static void flash_unlock(void)
 {
   while (getreg32(STM32L4_FLASH_SR) & FLASH_SR_BSY)
@@ -170,10 +283,7 @@ static inline void flash_erase(size_t page)
 
   modifyreg32(STM32L4_FLASH_CR, 0, FLASH_CR_START);
 
-  while (getreg32(STM32L4_FLASH_SR) & FLASH_SR_BSY)
-    {
-      stm32l4_waste();
-    }
+  flash_wait();
 
   modifyreg32(STM32L4_FLASH_CR, FLASH_CR_PAGE_ERASE, 0);
 }
@@ -183,17 +293,6 @@ static void data_cache_disable(void)
 {
   modifyreg32(STM32L4_FLASH_ACR, FLASH_ACR_DCEN, 0);
 }
-
-static void data_cache_enable(void)
-{
-  /* Reset data cache */
-
-  modifyreg32(STM32L4_FLASH_ACR, 0, FLASH_ACR_DCRST);
-
-  /* Enable data cache */
-
-  modifyreg32(STM32L4_FLASH_ACR, 0, FLASH_ACR_DCEN);
-}
 #endif /* defined(CONFIG_STM32L4_FLASH_WORKAROUND_DATA_CACHE_CORRUPTION_ON_RWW) */
 
 /****************************************************************************
@@ -360,8 +459,23 @@ ssize_t up_progmem_eraseblock(size_t block)
 
   flash_unlock();
 
+#if defined(CONFIG_STM32L4_FLASH_WORKAROUND_DATA_CACHE_CORRUPTION_ON_RWW)
+  data_cache_disable();
+#endif
+#ifdef CONFIG_STM32L4_FLASH_INTERRUPT
+  flash_irqenable();
+#endif
+
   flash_erase(block);
 
+#ifdef CONFIG_STM32L4_FLASH_INTERRUPT
+  flash_irqdisable();
+#endif
+
+  /* Drop cached contents of the modified flash and re-enable the caches */
+
+  stm32l4_flashcache_reset();
+
   flash_lock();
   nxmutex_unlock(&g_lock);
 
@@ -443,10 +557,19 @@ ssize_t up_progmem_write(size_t addr, const void *buf, size_t buflen)
       return (ssize_t)ret;
     }
 
-  /* Get flash ready and begin flashing. */
+  /* Get flash ready and begin flashing.  The data cache stays disabled for
+   * the whole transfer rather than being reset after every page.
+   */
 
   flash_unlock();
 
+#if defined(CONFIG_STM32L4_FLASH_WORKAROUND_DATA_CACHE_CORRUPTION_ON_RWW)
+  data_cache_disable();
+#endif
+#ifdef CONFIG_STM32L4_FLASH_INTERRUPT
+  flash_irqenable();
+#endif
+
   /* Loop until all of the data has been written */
 
   while (buflen > 0)
@@ -492,10 +615,6 @@ ssize_t up_progmem_write(size_t addr, const void *buf, size_t buflen)
 
       /* Write the page. Must be with double-words. */
 
-#if defined(CONFIG_STM32L4_FLASH_WORKAROUND_DATA_CACHE_CORRUPTION_ON_RWW)
-      data_cache_disable();
-#endif
-
       modifyreg32(STM32L4_FLASH_CR, 0, FLASH_CR_PG);
       set_pg_bit = true;
 
@@ -504,10 +623,7 @@ ssize_t up_progmem_write(size_t addr, const void *buf, size_t buflen)
           *dest++ = *src++;
           *dest++ = *src++;
 
-          while (getreg32(STM32L4_FLASH_SR) & FLASH_SR_BSY)
-            {
-              stm32l4_waste();
-            }
+          flash_wait();
 
           /* Verify */
 
@@ -528,10 +644,6 @@ ssize_t up_progmem_write(size_t addr, const void *buf, size_t buflen)
       modifyreg32(STM32L4_FLASH_CR, FLASH_CR_PG, 0);
       set_pg_bit = false;
 
-#if defined(CONFIG_STM32L4_FLASH_WORKAROUND_DATA_CACHE_CORRUPTION_ON_RWW)
-      data_cache_enable();
-#endif
-
       /* Adjust pointers and counts for the next time through the loop */
 
       written += xfrsize;
@@ -546,11 +658,16 @@ out:
   if (set_pg_bit)
     {
       modifyreg32(STM32L4_FLASH_CR, FLASH_CR_PG, 0);
-#if defined(CONFIG_STM32L4_FLASH_WORKAROUND_DATA_CACHE_CORRUPTION_ON_RWW)
-      data_cache_enable();
-#endif
     }
 
+#ifdef CONFIG_STM32L4_FLASH_INTERRUPT
+  flash_irqdisable();
+#endif
+
+  /* Drop cached contents of the modified flash and re-enable the caches */
+
+  stm32l4_flashcache_reset();
+
   /* If there was an error, clear all error flags in status register (rc_w1
    * register so do this by writing the error bits).
    */
@@ -568,6 +685,211 @@ out:
   return (ret == OK) ? written : ret;
 }
 
+#if defined(CONFIG_STM32L4_STM32L4X5) || \
+    defined(CONFIG_STM32L4_STM32L4X6) || \
+    defined(CONFIG_STM32L4_STM32L4XR)
+
+/****************************************************************************
+ * Name: stm32l4_flash_erasebank
+ *
+ * Description:
+ *   Mass erase one flash bank.
+ *
+ ****************************************************************************/
+
+int stm32l4_flash_erasebank(int bank)
+{
+  uint32_t mer;
+  int ret;
+
+  if (bank != 1 && bank != 2)
+    {
+      return -EINVAL;
+    }
+
+  mer = (bank == 1) ? FLASH_CR_MER1 : FLASH_CR_MER2;
+
+  ret = nxmutex_lock(&g_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  finfo("erase bank %d\n", bank);
+
+  flash_unlock();
+
+#if defined(CONFIG_STM32L4_FLASH_WORKAROUND_DATA_CACHE_CORRUPTION_ON_RWW)
+  data_cache_disable();
+#endif
+#ifdef CONFIG_STM32L4_FLASH_INTERRUPT
+  flash_irqenable();
+#endif
+
+  modifyreg32(STM32L4_FLASH_CR, 0, mer);
+  modifyreg32(STM32L4_FLASH_CR, 0, FLASH_CR_START);
+
+  flash_wait();
+
+  modifyreg32(STM32L4_FLASH_CR, mer, 0);
+
+#ifdef CONFIG_STM32L4_FLASH_INTERRUPT
+  flash_irqdisable();
+#endif
+
+  /* Drop cached contents of the modified flash and re-enable the caches */
+
+  stm32l4_flashcache_reset();
+
+  if (getreg32(STM32L4_FLASH_SR) & FLASH_SR_ALLERRS)
+    {
+      ret = (getreg32(STM32L4_FLASH_SR) & FLASH_SR_WRITE_PROTECTION_ERROR) ?
+            -EROFS : -EIO;
+
+      ferr("flash bank erase error: %d, status: 0x%" PRIx32 "\n",
+           ret, getreg32(STM32L4_FLASH_SR));
+
+      modifyreg32(STM32L4_FLASH_SR, 0, FLASH_SR_ALLERRS);
+    }
+
+  flash_lock();
+  nxmutex_unlock(&g_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: stm32l4_flash_fastwrite
+ *
+ * Description:
+ *   Program whole rows with Fast Programming.
+ *
+ ****************************************************************************/
+
+ssize_t stm32l4_flash_fastwrite(size_t addr, const void *buf, size_t buflen)
+{
+  volatile uint32_t *dest;
+  irqstate_t flags;
+  size_t written;
+  size_t xfrsize;
+  size_t offset;
+  uint32_t regval;
+  int i;
+  int ret = OK;
+
+  /* Check for valid address range and row alignment. */
+
+  offset = addr;
+  if (addr >= STM32L4_FLASH_BASE)
+    {
+      offset -= STM32L4_FLASH_BASE;
+    }
+  else
+    {
+      addr += STM32L4_FLASH_BASE;
+    }
+
+  if ((offset & FLASH_ROW_MASK) != 0)
+    {
+      return -EINVAL;
+    }
+
+  if (offset + buflen > STM32L4_FLASH_SIZE)
+    {
+      return -EFAULT;
+    }
+
+  ret = nxmutex_lock(&g_lock);
+  if (ret < 0)
+    {
+      return (ssize_t)ret;
+    }
+
+  flash_unlock();
+
+  /* Errors of a previous operation would abort fast programming */
+
+  modifyreg32(STM32L4_FLASH_SR, 0, FLASH_SR_FASTERRS);
+
+#if defined(CONFIG_STM32L4_FLASH_WORKAROUND_DATA_CACHE_CORRUPTION_ON_RWW)
+  data_cache_disable();
+#endif
+#ifdef CONFIG_STM32L4_FLASH_INTERRUPT
+  flash_irqenable();
+#endif
+
+  modifyreg32(STM32L4_FLASH_CR, 0, FLASH_CR_FSTPG);
+
+  for (written = 0; written < buflen; written += xfrsize)
+    {
+      /* Stage the row in RAM, so that the copy loop below cannot be too
+       * slow for the flash interface.
+       */
+
+      xfrsize = MIN((size_t)FLASH_ROW_SIZE, buflen - written);
+
+      memcpy(g_page_buffer, (const uint8_t *)buf + written, xfrsize);
+      if (xfrsize < FLASH_ROW_SIZE)
+        {
+          memset((uint8_t *)g_page_buffer + xfrsize, FLASH_ERASEDVALUE,
+                 FLASH_ROW_SIZE - xfrsize);
+        }
+
+      /* The row must be written with consecutive word writes and without
+       * interruption, otherwise it is aborted with MISERR.
+       */
+
+      dest  = (volatile uint32_t *)(addr + written);
+      flags = up_irq_save();
+
+      for (i = 0; i < FLASH_ROW_WORDS; i++)
+        {
+          dest[i] = g_page_buffer[i];
+        }
+
+      up_irq_restore(flags);
+
+      flash_wait();
+
+      regval = getreg32(STM32L4_FLASH_SR);
+      if (regval & FLASH_SR_FASTERRS)
+        {
+          ret = (regval & FLASH_SR_WRITE_PROTECTION_ERROR) ? -EROFS : -EIO;
+          break;
+        }
+
+      /* Verify */
+
+      if (memcmp((const void *)dest, g_page_buffer, FLASH_ROW_SIZE) != 0)
+        {
+          ret = -EIO;
+          break;
+        }
+    }
+
+  modifyreg32(STM32L4_FLASH_CR, FLASH_CR_FSTPG, 0);
+
+#ifdef CONFIG_STM32L4_FLASH_INTERRUPT
+  flash_irqdisable();
+#endif
+
+  /* Drop cached contents of the modified flash and re-enable the caches */
+
+  stm32l4_flashcache_reset();
+
+  if (ret != OK)
+    {
+      ferr("flash fast write error: %d, status: 0x%" PRIx32 "\n",
+           ret, getreg32(STM32L4_FLASH_SR));
+
+      modifyreg32(STM32L4_FLASH_SR, 0, FLASH_SR_FASTERRS);
+    }
+
+  flash_lock();
+  nxmutex_unlock(&g_lock);
+  return (ret == OK) ? written : ret;
+}
+#endif
+
 uint8_t up_progmem_erasestate(void)
 {
   return FLASH_ERASEDVALUE;
@@ -28,6 +28,23 @@
 #include <nuttx/config.h>
 #include "hardware/stm32l4_flash.h"
 
+#include <stddef.h>
+#include <sys/types.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Size of a fast programming row: 64 double-words on the STM32L4+, 32
+ * double-words otherwise.
+ */
+
+#if defined(CONFIG_STM32L4_STM32L4XR)
+#  define STM32L4_FLASH_ROWSIZE 512
+#else
+#  define STM32L4_FLASH_ROWSIZE 256
+#endif
+
 /****************************************************************************
  * Public Functions Prototypes
  ****************************************************************************/
@@ -54,4 +71,51 @@ int stm32l4_flash_unlock(void);
 
 uint32_t stm32l4_flash_user_optbytes(uint32_t clrbits, uint32_t setbits);
 
+#if defined(CONFIG_STM32L4_STM32L4X5) || \
+    defined(CONFIG_STM32L4_STM32L4X6) || \
+    defined(CONFIG_STM32L4_STM32L4XR)
+
+/****************************************************************************
+ * Name: stm32l4_flash_erasebank
+ *
+ * Description:
+ *   Mass erase one flash bank, usually in preparation of writing a firmware
+ *   image with stm32l4_flash_fastwrite().  The code calling this function
+ *   must not execute from the selected bank.
+ *
+ * Input Parameters:
+ *   bank - The bank to erase, 1 or 2
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int stm32l4_flash_erasebank(int bank);
+
+/****************************************************************************
+ * Name: stm32l4_flash_fastwrite
+ *
+ * Description:
+ *   Program data with fast programming, one row (STM32L4_FLASH_ROWSIZE
+ *   bytes) per operation instead of one double-word.  Only allowed into a
+ *   bank that has been mass erased with stm32l4_flash_erasebank() and is
+ *   not the bank the code runs from.  Each row is written once; a trailing
+ *   partial row is padded with the erased value.
+ *
+ * Input Parameters:
+ *   addr   - The destination address, aligned to STM32L4_FLASH_ROWSIZE
+ *   buf    - The data to program
+ *   buflen - The number of bytes to program
+ *
+ * Returned Value:
+ *   The number of bytes written on success; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+ssize_t stm32l4_flash_fastwrite(size_t addr, const void *buf, size_t buflen);
+
+#endif
+
 #endif /* __ARCH_ARM_SRC_STM32L4_STM32L4_FLASH_H */
@@ -0,0 +1,297 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_flashcache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/irq.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/kmalloc.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <stdint.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <arch/board/board.h>
+
+#include "arm_internal.h"
+#include "chip.h"
+#include "stm32l4_dvfs.h"
+#include "stm32l4_flashcache.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Size of the buffer holding the complete procfs text */
+
+#define FLASHCACHE_TEXTLEN 160
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_FLASHCACHE_PROCFS
+
+/* This structure describes one open "file" */
+
+struct flashcache_file_s
+{
+  struct procfs_file_s base;        /* Base open file structure */
+  unsigned int textsize;            /* Number of valid characters in text[] */
+  char text[FLASHCACHE_TEXTLEN];    /* Formatted file contents */
+};
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_FLASHCACHE_PROCFS
+static int flashcache_open(struct file *filep, const char *relpath,
+                           int oflags, mode_t mode);
+static int flashcache_close(struct file *filep);
+static ssize_t flashcache_read(struct file *filep, char *buffer,
+                               size_t buflen);
+static int flashcache_dup(const struct file *oldp, struct file *newp);
+static int flashcache_stat(const char *relpath, struct stat *buf);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Number of cache resets after flash erase or program operations */
+
+static uint32_t g_flashcache_resets;
+
+#ifdef CONFIG_STM32L4_FLASHCACHE_PROCFS
+static const struct procfs_operations g_flashcache_ops =
+{
+  flashcache_open,   /* open */
+  flashcache_close,  /* close */
+  flashcache_read,   /* read */
+  NULL,              /* write */
+  flashcache_dup,    /* dup */
+  NULL,              /* opendir */
+  NULL,              /* closedir */
+  NULL,              /* readdir */
+  NULL,              /* rewinddir */
+  flashcache_stat,   /* stat */
+};
+
+static const struct procfs_entry_s g_flashcache_procfs =
+{
+  "flashcache", &g_flashcache_ops
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_FLASHCACHE_PROCFS
+
+/****************************************************************************
+ * Name: flashcache_open
+ ****************************************************************************/
+
+static int flashcache_open(struct file *filep, const char *relpath,
+                           int oflags, mode_t mode)
+{
+  struct flashcache_file_s *attr;
+
+  /* PROCFS is read-only */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  attr = kmm_zalloc(sizeof(struct flashcache_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  filep->f_priv = (void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: flashcache_close
+ ****************************************************************************/
+
+static int flashcache_close(struct file *filep)
+{
+  struct flashcache_file_s *attr;
+
+  attr = (struct flashcache_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: flashcache_read
+ ****************************************************************************/
+
+static ssize_t flashcache_read(struct file *filep, char *buffer,
+                               size_t buflen)
+{
+  struct flashcache_file_s *attr;
+  uint32_t regval;
+  off_t offset;
+
+  attr = (struct flashcache_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Format the whole file on the first read, so that the contents stay
+   * consistent if the caller reads in several pieces.
+   */
+
+  if (filep->f_pos == 0)
+    {
+      regval = getreg32(STM32L4_FLASH_ACR);
+
+      attr->textsize =
+        snprintf(attr->text, FLASHCACHE_TEXTLEN,
+                 "ACR:      0x%08" PRIx32 "\n"
+                 "HCLK:     %" PRIu32 " Hz\n"
+                 "Latency:  %" PRIu32 " WS\n"
+                 "Prefetch: %s\n"
+                 "ICache:   %s\n"
+                 "DCache:   %s\n"
+                 "Resets:   %" PRIu32 "\n",
+                 regval,
+                 (uint32_t)stm32l4_dvfs_scale(STM32L4_HCLK_FREQUENCY),
+                 (regval & FLASH_ACR_LATENCY_MASK) >>
+                 FLASH_ACR_LATENCY_SHIFT,
+                 (regval & FLASH_ACR_PRFTEN) ? "on" : "off",
+                 (regval & FLASH_ACR_ICEN) ? "on" : "off",
+                 (regval & FLASH_ACR_DCEN) ? "on" : "off",
+                 g_flashcache_resets);
+
+      if (attr->textsize >= FLASHCACHE_TEXTLEN)
+        {
+          attr->textsize = FLASHCACHE_TEXTLEN - 1;
+        }
+    }
+
+  offset = filep->f_pos;
+  return procfs_memcpy(attr->text, attr->textsize, buffer, buflen,
+                       &offset);
+}
+
+/****************************************************************************
+ * Name: flashcache_dup
+ ****************************************************************************/
+
+static int flashcache_dup(const struct file *oldp, struct file *newp)
+{
+  struct flashcache_file_s *oldattr;
+  struct flashcache_file_s *newattr;
+
+  oldattr = (struct flashcache_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  newattr = kmm_malloc(sizeof(struct flashcache_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  memcpy(newattr, oldattr, sizeof(struct flashcache_file_s));
+  newp->f_priv = (void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: flashcache_stat
+ ****************************************************************************/
+
+static int flashcache_stat(const char *relpath, struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+#endif /* CONFIG_STM32L4_FLASHCACHE_PROCFS */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4_flashcache_reset
+ *
+ * Description:
+ *   Invalidate the flash instruction and data caches and re-enable them as
+ *   configured.
+ *
+ ****************************************************************************/
+
+void stm32l4_flashcache_reset(void)
+{
+  irqstate_t flags;
+
+  flags = up_irq_save();
+
+  /* The caches can only be reset while they are disabled */
+
+  modifyreg32(STM32L4_FLASH_ACR, FLASH_ACR_ICEN | FLASH_ACR_DCEN, 0);
+  modifyreg32(STM32L4_FLASH_ACR, 0, FLASH_ACR_ICRST | FLASH_ACR_DCRST);
+  modifyreg32(STM32L4_FLASH_ACR, FLASH_ACR_ICRST | FLASH_ACR_DCRST, 0);
+  modifyreg32(STM32L4_FLASH_ACR, 0,
+              STM32L4_FLASH_ACR_ICEN | STM32L4_FLASH_ACR_DCEN);
+
+  g_flashcache_resets++;
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: stm32l4_flashcache_procfs_register
+ *
+ * Description:
+ *   Register the "flashcache" procfs entry.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_FLASHCACHE_PROCFS
+int stm32l4_flashcache_procfs_register(void)
+{
+  return procfs_register(&g_flashcache_procfs);
+}
+#endif
@@ -0,0 +1,111 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_flashcache.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_SRC_STM32L4_STM32L4_FLASHCACHE_H
+#define __ARCH_ARM_SRC_STM32L4_STM32L4_FLASHCACHE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include "hardware/stm32l4_flash.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Flash accelerator bits of FLASH_ACR selected by the configuration.  The
+ * clock configuration ORs these into the wait states.
+ */
+
+#ifdef CONFIG_STM32L4_FLASH_PREFETCH
+#  define STM32L4_FLASH_ACR_PRFTEN FLASH_ACR_PRFTEN
+#else
+#  define STM32L4_FLASH_ACR_PRFTEN 0
+#endif
+
+#ifdef CONFIG_STM32L4_FLASH_ICACHE
+#  define STM32L4_FLASH_ACR_ICEN   FLASH_ACR_ICEN
+#else
+#  define STM32L4_FLASH_ACR_ICEN   0
+#endif
+
+#ifdef CONFIG_STM32L4_FLASH_DCACHE
+#  define STM32L4_FLASH_ACR_DCEN   FLASH_ACR_DCEN
+#else
+#  define STM32L4_FLASH_ACR_DCEN   0
+#endif
+
+#define STM32L4_FLASH_ACR_ACCEL    (STM32L4_FLASH_ACR_PRFTEN | \
+                                    STM32L4_FLASH_ACR_ICEN | \
+                                    STM32L4_FLASH_ACR_DCEN)
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifndef __ASSEMBLY__
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: stm32l4_flashcache_reset
+ *
+ * Description:
+ *   Invalidate the flash instruction and data caches and re-enable them as
+ *   configured.  Must be called after the flash has been erased or
+ *   programmed, since the caches may still hold the old contents.
+ *
+ ****************************************************************************/
+
+void stm32l4_flashcache_reset(void);
+
+/****************************************************************************
+ * Name: stm32l4_flashcache_procfs_register
+ *
+ * Description:
+ *   Register the procfs entry "flashcache" that shows the flash wait
+ *   states, the accelerator configuration and the number of cache resets.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_FLASHCACHE_PROCFS
+int stm32l4_flashcache_procfs_register(void);
+#endif
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __ASSEMBLY__ */
+#endif /* __ARCH_ARM_SRC_STM32L4_STM32L4_FLASHCACHE_H */
@@ -0,0 +1,1541 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_foc.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/analog/adc.h>
+
+#include <arch/irq.h>
+#include <arch/chip/chip.h>
+
+#include "arm_internal.h"
+#include "stm32l4_gpio.h"
+#include "stm32l4_pwm.h"
+#include "stm32l4_adc.h"
+#include "stm32l4_dbgmcu.h"
+#include "hardware/stm32l4_tim.h"
+
+#include "stm32l4_foc.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* This is the lower-half implementation for the STM32L4 FOC devices.
+ *
+ * A FOC device uses one advanced timer to generate a center-aligned PWM
+ * which controls the phase switches bridge.  Phase currents are sampled
+ * with the injected sequence of one ADC, triggered by CCR4 of the same
+ * timer just before the counter reaches ARR, that is in the middle of the
+ * V0 vector when all low-side switches are on and the current flows
+ * through the shunts.  The sampling instant is therefore locked to the PWM
+ * by hardware, independently of the interrupt latency.
+ *
+ * The end of the injected sequence interrupt (JEOS) reads the currents and
+ * calls the upper-half notifier, which runs the control loop at the PWM
+ * frequency or at a fraction of it.  The interrupt must be able to use OS
+ * services, so it runs at the highest priority that is still masked by the
+ * OS.
+ *
+ * ADC regular conversions are not used by the FOC and may be used for
+ * other tasks with DMA transfer; the ADC interrupt is reserved for the FOC.
+ *
+ * FOC0 uses TIM1 and ADC1, FOC1 uses TIM8 and ADC2.
+ */
+
+/* PWM lower-half ops and ADC lower-half ops must be enabled */
+
+#ifndef CONFIG_STM32L4_PWM_LL_OPS
+#  error PWM low-level operations interface must be enabled
+#endif
+#ifndef CONFIG_STM32L4_ADC_LL_OPS
+#  error ADC low-level operations interface must be enabled
+#endif
+
+/* We don't want start conversion during ADC setup */
+
+#ifndef CONFIG_STM32L4_ADC_NO_STARTUP_CONV
+#  error ADC startup conversion must be disabled
+#endif
+
+/* The ADC interrupt belongs to the FOC */
+
+#ifndef CONFIG_STM32L4_ADC_NOIRQ
+#  error Default ADC interrupts must be disabled
+#endif
+
+/* Tested only for 3-phase devices */
+
+#if CONFIG_MOTOR_FOC_PHASES != 3
+#  error Tested only for 3-phase devices
+#endif
+
+/* ADC1 and ADC2 share one interrupt vector where there is an ADC2 */
+
+#ifdef STM32L4_IRQ_ADC12
+#  define FOC_ADC_IRQ        (STM32L4_IRQ_ADC12)
+#else
+#  define FOC_ADC_IRQ        (STM32L4_IRQ_ADC1)
+#endif
+
+/* The highest priority that still allows the handler to use OS services */
+
+#define FOC_ADC_IRQ_PRIO     (NVIC_SYSH_DISABLE_PRIORITY)
+
+/* FOC0 always use TIMER1 for PWM and ADC1 for current sensing */
+
+#ifdef CONFIG_STM32L4_FOC_FOC0
+#  define FOC0_PWM           (1)
+#  define FOC0_PWM_BASE      (STM32L4_TIM1_BASE)
+#  define FOC0_PWM_FZ_BIT    (DBGMCU_APB2_TIM1STOP)
+#  define FOC0_ADC           (1)
+#  define FOC0_ADC_JEXT      (ADC_JSQR_JEXTEN_RISING | ADC_JEXTSEL_T1CC4)
+#  if CONFIG_STM32L4_TIM1_MODE != 2
+#    error TIM1 must be configured in center-aligned mode 1
+#  endif
+#  if PWM_TIM1_NCHANNELS != (CONFIG_MOTOR_FOC_PHASES + 1)
+#    error Invalid TIM1 channels configuration
+#  endif
+#  if CONFIG_STM32L4_ADC1_INJ_CHAN != CONFIG_MOTOR_FOC_SHUNTS
+#    error Invalid configuration for ADC1 injected channels
+#  endif
+#  ifndef ADC1_HAVE_JEXTCFG
+#    error ADC1 must support JEXTCFG
+#  endif
+#endif
+
+/* FOC1 always use TIMER8 for PWM and ADC2 for current sensing */
+
+#ifdef CONFIG_STM32L4_FOC_FOC1
+#  define FOC1_PWM           (8)
+#  define FOC1_PWM_BASE      (STM32L4_TIM8_BASE)
+#  define FOC1_PWM_FZ_BIT    (DBGMCU_APB2_TIM8STOP)
+#  define FOC1_ADC           (2)
+#  define FOC1_ADC_JEXT      (ADC_JSQR_JEXTEN_RISING | ADC_JEXTSEL_T8CC4)
+#  if CONFIG_STM32L4_TIM8_MODE != 2
+#    error TIM8 must be configured in center-aligned mode 1
+#  endif
+#  if PWM_TIM8_NCHANNELS != (CONFIG_MOTOR_FOC_PHASES + 1)
+#    error Invalid TIM8 channels configuration
+#  endif
+#  if CONFIG_STM32L4_ADC2_INJ_CHAN != CONFIG_MOTOR_FOC_SHUNTS
+#    error Invalid configuration for ADC2 injected channels
+#  endif
+#  ifndef ADC2_HAVE_JEXTCFG
+#    error ADC2 must support JEXTCFG
+#  endif
+#endif
+
+/* ADC trigger offset from ARR - must be greater than 0! */
+
+#define ADC_TRIGGER_OFFSET   (1)
+
+/* ADC interrupt used by the FOC: end of injected sequence */
+
+#define FOC_ADC_ISR_FOC      (ADC_ISR_JEOS)
+#define FOC_ADC_IER_FOC      (ADC_IER_JEOS)
+
+/* Helper macros ************************************************************/
+
+/* Get arch-specific FOC private part */
+
+#define STM32L4_FOC_PRIV_FROM_DEV_GET(d)          \
+  ((struct stm32l4_foc_priv_s *)(d)->lower->data)
+
+/* Get board-specific FOC data */
+
+#define STM32L4_FOC_BOARD_FROM_DEV_GET(d)         \
+  ((STM32L4_FOC_PRIV_FROM_DEV_GET(d))->board)
+
+/* Get arch-specific FOC devices */
+
+#define STM32L4_FOC_DEV_FROM_DEV_GET(d)           \
+  ((STM32L4_FOC_PRIV_FROM_DEV_GET(d))->dev)
+
+/* Get PWM device */
+
+#define PWM_FROM_FOC_DEV_GET(d) (STM32L4_FOC_DEV_FROM_DEV_GET(d)->pwm)
+
+/* Get ADC device */
+
+#define ADC_FROM_FOC_DEV_GET(d) (STM32L4_FOC_DEV_FROM_DEV_GET(d)->adc)
+
+/* Define PWM all outputs */
+
+#ifdef CONFIG_STM32L4_FOC_HAS_PWM_COMPLEMENTARY
+#  define PMW_OUTPUTS_ALL_COMP (STM32L4_PWM_OUT1N|  \
+                                STM32L4_PWM_OUT2N|  \
+                                STM32L4_PWM_OUT3N)
+#else
+#  define PMW_OUTPUTS_ALL_COMP (0)
+#endif
+
+#define PWM_OUTPUTS_ALL (STM32L4_PWM_OUT1|      \
+                         STM32L4_PWM_OUT2|      \
+                         STM32L4_PWM_OUT3|      \
+                         PMW_OUTPUTS_ALL_COMP|  \
+                         STM32L4_PWM_OUT4)
+
+/* Enable all PWM outputs at once (include CHAN4 for ADC trigger) */
+
+#define PWM_ALL_OUTPUTS_ENABLE(pwm, state)          \
+  PWM_OUTPUTS_ENABLE(pwm, PWM_OUTPUTS_ALL, state);
+
+/* Enable/disable ADC interrupts (FOC worker loop) */
+
+#define STM32L4_ADC_ENABLEINT(adc)  ADC_INT_ENABLE(adc, FOC_ADC_IER_FOC)
+#define STM32L4_ADC_DISABLEINT(adc) ADC_INT_DISABLE(adc, FOC_ADC_IER_FOC)
+
+/* ADC calibration samples */
+
+#define CAL_SAMPLES        (5000)
+
+/* ADC calibration frequency */
+
+#define CAL_FREQ           (10000)
+
+/* Define PWM modes to control H-bridge.
+ *
+ * Any H-bridge specific configuration can be done with PWM_CHxPOL
+ * and PWM_CHxIDLE configuration options
+ */
+
+#define PWM_MODE_FOC       STM32L4_CHANMODE_PWM1
+#define PWM_MODE_ADC_TRG   STM32L4_CHANMODE_PWM1
+#define PWM_MODE_HSLO_LSHI STM32L4_CHANMODE_OCREFHI
+#define PWM_MODE_HSHI_LSLO STM32L4_CHANMODE_OCREFLO
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* STM32L4 FOC devices.
+ * This structure gathers all low level drivers required by FOC device.
+ */
+
+struct stm32l4_foc_dev_s
+{
+  uint8_t                     pwm_inst; /* PWM timer instance */
+  uint8_t                     adc_inst; /* ADC instance */
+  uint32_t                    pwm_base; /* PWM timer base */
+  uint32_t                    jextval;  /* JEXT configuration */
+
+  struct stm32l4_pwm_dev_s   *pwm;      /* PWM device reference */
+  struct adc_dev_s           *adc_dev;  /* ADC device reference */
+  struct stm32_adc_dev_s     *adc;      /* STM32L4 ADC device reference */
+
+  /* Interrupt handler for FOC device */
+
+  int (*adc_isr)(struct foc_dev_s *dev);
+};
+
+/* STM32L4 FOC volatile data */
+
+struct stm32l4_foc_data_s
+{
+  foc_current_t curr[CONFIG_MOTOR_FOC_PHASES];        /* Current */
+  uint8_t       notifier_div;                         /* FOC notifier prescaler */
+  uint32_t      per;                                  /* PWM timer period (ARR) */
+  uint32_t      adcint_cntr;                          /* ADC interrupt counter */
+  uint32_t      curr_offset[CONFIG_MOTOR_FOC_SHUNTS]; /* ADC current offset */
+  int16_t       curr_raw[CONFIG_MOTOR_FOC_SHUNTS];    /* ADC current RAW */
+};
+
+/* STM32L4 FOC private */
+
+struct stm32l4_foc_priv_s
+{
+  /* Volatile data */
+
+  struct stm32l4_foc_data_s data;
+
+  /* ADC calbration done */
+
+  sem_t cal_done_sem;
+
+  /* STM32L4 FOC devices */
+
+  struct stm32l4_foc_dev_s *dev;
+
+  /* Board-specific data */
+
+  struct stm32l4_foc_board_s *board;
+
+  /* Upper-half FOC controller callbacks */
+
+  const struct foc_callbacks_s *cb;
+};
+
+/****************************************************************************
+ * Private Function Protototypes
+ ****************************************************************************/
+
+/* FOC lower-half operations */
+
+static int stm32l4_foc_configure(struct foc_dev_s *dev,
+                                 struct foc_cfg_s *cfg);
+static int stm32l4_foc_setup(struct foc_dev_s *dev);
+static int stm32l4_foc_shutdown(struct foc_dev_s *dev);
+static int stm32l4_foc_start(struct foc_dev_s *dev, bool state);
+static int stm32l4_foc_pwm_duty_set(struct foc_dev_s *dev,
+                                    foc_duty_t *duty);
+static int stm32l4_foc_pwm_off(struct foc_dev_s *dev, bool off);
+static int stm32l4_foc_ioctl(struct foc_dev_s *dev, int cmd,
+                             unsigned long arg);
+static int stm32l4_foc_bind(struct foc_dev_s *dev,
+                            struct foc_callbacks_s *cb);
+static int stm32l4_foc_fault_clear(struct foc_dev_s *dev);
+#ifdef CONFIG_MOTOR_FOC_TRACE
+static void stm32l4_foc_trace(struct foc_dev_s *dev, int type, bool state);
+#endif
+
+/* ADC handlers */
+
+static int stm32l4_foc_adc_handler(int irq, void *context, void *arg);
+static int stm32l4_foc_adc_calibration_handler(struct foc_dev_s *dev);
+static int stm32l4_foc_worker_handler(struct foc_dev_s *dev);
+
+/* Helpers */
+
+static void stm32l4_foc_curr_get(struct foc_dev_s *dev, int16_t *curr);
+static int stm32l4_foc_notifier_cfg(struct foc_dev_s *dev, uint32_t freq);
+static int stm32l4_foc_pwm_cfg(struct foc_dev_s *dev, uint32_t freq);
+static int stm32l4_foc_pwm_start(struct foc_dev_s *dev, bool state);
+static int stm32l4_foc_adc_start(struct foc_dev_s *dev, bool state);
+static int stm32l4_foc_calibration_start(struct foc_dev_s *dev);
+static int stm32l4_foc_pwm_freq_set(struct foc_dev_s *dev, uint32_t freq);
+static void stm32l4_foc_adc_trg_set(struct foc_dev_s *dev,
+                                    uint32_t offset);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The ADC interrupt is shared by all instances */
+
+static mutex_t g_stm32l4_foc_lock = NXMUTEX_INITIALIZER;
+static uint8_t g_stm32l4_foc_irqcntr;
+
+/* STM32L4 specific FOC data */
+
+static struct stm32l4_foc_dev_s  g_stm32l4_foc_dev[CONFIG_MOTOR_FOC_INST];
+static struct stm32l4_foc_priv_s g_stm32l4_foc_priv[CONFIG_MOTOR_FOC_INST];
+
+/* STM32L4 specific FOC ops */
+
+static struct foc_lower_ops_s g_stm32l4_foc_ops =
+{
+  .configure      = stm32l4_foc_configure,
+  .setup          = stm32l4_foc_setup,
+  .shutdown       = stm32l4_foc_shutdown,
+  .start          = stm32l4_foc_start,
+  .pwm_duty_set   = stm32l4_foc_pwm_duty_set,
+  .pwm_off        = stm32l4_foc_pwm_off,
+  .ioctl          = stm32l4_foc_ioctl,
+  .bind           = stm32l4_foc_bind,
+  .fault_clear    = stm32l4_foc_fault_clear,
+#ifdef CONFIG_MOTOR_FOC_TRACE
+  .trace          = stm32l4_foc_trace
+#endif
+};
+
+/* FOC lower-half */
+
+static struct foc_lower_s g_stm32l4_foc_lower[CONFIG_MOTOR_FOC_INST];
+
+/* FOC upper-half device data */
+
+static struct foc_dev_s g_foc_dev[CONFIG_MOTOR_FOC_INST];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#if (CONFIG_MOTOR_FOC_INST > 1)
+/****************************************************************************
+ * Name: stm32l4_foc_sync_all
+ *
+ * Description:
+ *   Synchronise all FOC PWM timers
+ *
+ ****************************************************************************/
+
+static void stm32l4_foc_sync_all(void)
+{
+  uint32_t egr_reg[CONFIG_MOTOR_FOC_INST];
+  int      i;
+
+  /* Get registers to write */
+
+  for (i = 0; i < CONFIG_MOTOR_FOC_INST; i += 1)
+    {
+      egr_reg[i] = (STM32L4_FOC_DEV_FROM_DEV_GET(&g_foc_dev[i])->pwm_base +
+                    STM32L4_GTIM_EGR_OFFSET);
+    }
+
+  /* Write all registers at once */
+
+  for (i = 0; i < CONFIG_MOTOR_FOC_INST; i += 1)
+    {
+      /* Force update event to reset CNTR */
+
+      putreg32(GTIM_EGR_UG, egr_reg[i]);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: stm32l4_foc_pwm_cfg
+ *
+ * Description:
+ *   PWM configuration for the FOC device
+ *
+ ****************************************************************************/
+
+static int stm32l4_foc_pwm_cfg(struct foc_dev_s *dev, uint32_t freq)
+{
+  struct stm32l4_foc_board_s *board = STM32L4_FOC_BOARD_FROM_DEV_GET(dev);
+  struct stm32l4_pwm_dev_s   *pwm   = PWM_FROM_FOC_DEV_GET(dev);
+  int                         ret   = OK;
+
+  DEBUGASSERT(board);
+  DEBUGASSERT(pwm);
+  DEBUGASSERT(freq > 0);
+
+  /* Set phases PWM frequency */
+
+  ret = stm32l4_foc_pwm_freq_set(dev, freq);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+#ifdef CONFIG_STM32L4_FOC_HAS_PWM_COMPLEMENTARY
+  /* Configure deadtime */
+
+  PWM_DT_UPDATE(pwm, (uint8_t)board->data->pwm_dt);
+#else
+  UNUSED(board);
+#endif
+
+  /* Configure PWM mode for PWM outputs */
+
+  PWM_MODE_UPDATE(pwm, STM32L4_PWM_CHAN1, PWM_MODE_FOC);
+  PWM_MODE_UPDATE(pwm, STM32L4_PWM_CHAN2, PWM_MODE_FOC);
+  PWM_MODE_UPDATE(pwm, STM32L4_PWM_CHAN3, PWM_MODE_FOC);
+
+  /* Dump PWM regs */
+
+  PWM_DUMP_REGS(pwm, NULL);
+
+errout:
+  return ret;
+}
+
+/****************************************************************************
+ * Name: stm32l4_foc_pwm_freq_set
+ *
+ * Description:
+ *   Configure the PWM frequency for the FOC device
+ *
+ ****************************************************************************/
+
+static int stm32l4_foc_pwm_freq_set(struct foc_dev_s *dev, uint32_t freq)
+{
+  struct stm32l4_foc_priv_s *priv = STM32L4_FOC_PRIV_FROM_DEV_GET(dev);
+  struct stm32l4_pwm_dev_s  *pwm  = PWM_FROM_FOC_DEV_GET(dev);
+  int                        ret  = OK;
+
+  DEBUGASSERT(priv);
+  DEBUGASSERT(pwm);
+  DEBUGASSERT(freq > 0);
+
+  /* Update the PWM frequency.
+   * IMPORTANT: must be x2 as the PWM is in center-aligned mode.
+   */
+
+  ret = PWM_FREQ_UPDATE(pwm, (freq * 2));
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  /* Store the PWM period to improve some future calculations */
+
+  priv->data.per = PWM_ARR_GET(pwm);
+
+errout:
+  return ret;
+}
+
+/****************************************************************************
+ * Name: stm32l4_foc_start
+ *
+ * Description:
+ *   Start or stop the FOC lower-half operations
+ *
+ ****************************************************************************/
+
+static int stm32l4_foc_start(struct foc_dev_s *dev, bool state)
+{
+  int ret = OK;
+
+  /* Start PWM */
+
+  ret = stm32l4_foc_pwm_start(dev, state);
+  if (ret < 0)
+    {
+      mtrerr("stm32l4_foc_pwm_start failed %d\n", ret);
+      goto errout;
+    }
+
+  /* Start ADC */
+
+  ret = stm32l4_foc_adc_start(dev, state);
+  if (ret < 0)
+    {
+      mtrerr("stm32l4_foc_adc_start failed %d\n", ret);
+      goto errout;
+    }
+
+errout:
+  return ret;
+}
+
+/****************************************************************************
+ * Name: stm32l4_foc_pwm_start
+ *
+ * Description:
+ *   Start or stop PWM
+ *
+ ****************************************************************************/
+
+static int stm32l4_foc_pwm_start(struct foc_dev_s *dev, bool state)
+{
+  struct stm32l4_foc_board_s *board = STM32L4_FOC_BOARD_FROM_DEV_GET(dev);
+  struct stm32l4_pwm_dev_s   *pwm   = PWM_FROM_FOC_DEV_GET(dev);
+
+  DEBUGASSERT(board);
+  DEBUGASSERT(pwm);
+
+  if (!dev->state.pwm_off)
+    {
+      /* Enable PWM outputs */
+
+      PWM_ALL_OUTPUTS_ENABLE(pwm, state);
+    }
+
+  /* Call board-specific logic */
+
+  board->ops->pwm_start(dev, state);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4_foc_adc_start
+ *
+ * Description:
+ *   Start or stop ADC
+ *
+ ****************************************************************************/
+
+static int stm32l4_foc_adc_start(struct foc_dev_s *dev, bool state)
+{
+  struct stm32l4_foc_dev_s *foc_dev = STM32L4_FOC_DEV_FROM_DEV_GET(dev);
+  struct stm32_adc_dev_s   *adc     = ADC_FROM_FOC_DEV_GET(dev);
+
+  DEBUGASSERT(foc_dev);
+  DEBUGASSERT(adc);
+
+  if (state == false)
+    {
+      /* Disable ADC interrupts */
+
+      STM32L4_ADC_DISABLEINT(adc);
+
+      /* Disable ADC injected conversion */
+
+      ADC_INJ_STARTCONV(adc, false);
+    }
+  else
+    {
+      /* Configure ADC injected trigger */
+
+      adc->llops->jextsel_set(adc, foc_dev->jextval);
+
+      /* Enable ADC interrupts */
+
+      STM32L4_ADC_ENABLEINT(adc);
+
+      /* Enable ADC injected conversion.  The conversions now wait for the
+       * PWM trigger.
+       */
+
+      ADC_INJ_STARTCONV(adc, true);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4_foc_adc_trg_set
+ *
+ * Description:
+ *   Configure ADC CCR4 trigger for FOC controller
+ *
+ ****************************************************************************/
+
+static void stm32l4_foc_adc_trg_set(struct foc_dev_s *dev, uint32_t offset)
+{
+  struct stm32l4_pwm_dev_s *pwm = PWM_FROM_FOC_DEV_GET(dev);
+
+  DEBUGASSERT(pwm);
+  DEBUGASSERT(offset > 0);
+
+  /* Configure PWM mode for ADC trigger
+   * NOTE:
+   *   For PWM mode 1 we have V7 when CRR=0 and V0 when CRR = ARR
+   *   For PWM mode 2 we have V7 when CRR=ARR and V0 when CRR = 0
+   */
+
+  PWM_MODE_UPDATE(pwm, STM32L4_PWM_CHAN4, PWM_MODE_ADC_TRG);
+
+  /* Set CCR4 */
+
+  PWM_CCR_UPDATE(pwm, STM32L4_PWM_CHAN4, offset);
+}
+
+/****************************************************************************
+ * Name: stm32l4_foc_configure
+ *
+ * Description:
+ *   Arch-specific FOC device configuration
+ *
+ ****************************************************************************/
+
+static int stm32l4_foc_configure(struct foc_dev_s *dev,
+                                 struct foc_cfg_s *cfg)
+{
+  struct stm32l4_foc_dev_s  *foc_dev = STM32L4_FOC_DEV_FROM_DEV_GET(dev);
+  struct stm32l4_foc_priv_s *priv    = STM32L4_FOC_PRIV_FROM_DEV_GET(dev);
+  int                        ret     = OK;
+
+  DEBUGASSERT(cfg);
+  DEBUGASSERT(priv);
+  DEBUGASSERT(cfg->pwm_freq > 0);
+  DEBUGASSERT(cfg->notifier_freq > 0);
+
+  /* Set ADC interrupt handler to FOC worker */
+
+  foc_dev->adc_isr = stm32l4_foc_worker_handler;
+
+  /* Configure PWM */
+
+  ret = stm32l4_foc_pwm_cfg(dev, cfg->pwm_freq);
+  if (ret < 0)
+    {
+      mtrerr("stm32l4_foc_pwm_cfg failed %d\n", ret);
+      goto errout;
+    }
+
+  /* Configure FOC notifier */
+
+  ret = stm32l4_foc_notifier_cfg(dev, cfg->notifier_freq);
+  if (ret < 0)
+    {
+      mtrerr("stm32l4_foc_notifier_cfg failed %d\n", ret);
+      goto errout;
+    }
+
+  /* Configure ADC trigger - must be after PWM frequency set */
+
+  DEBUGASSERT(priv->data.per != 0);
+
+  stm32l4_foc_adc_trg_set(dev, (priv->data.per - ADC_TRIGGER_OFFSET));
+
+  /* Reset ADC interrupts counter */
+
+  priv->data.adcint_cntr = 0;
+
+#if (CONFIG_MOTOR_FOC_INST > 1)
+  /* Sync all FOC PWM timers instances.
+   * IMPORTANT: This must be done after PWM frequency update !
+   */
+
+  stm32l4_foc_sync_all();
+#endif
+
+errout:
+  return ret;
+}
+
+/****************************************************************************
+ * Name: stm32l4_foc_setup
+ *
+ * Description:
+ *   Arch-specific FOC device setup
+ *
+ ****************************************************************************/
+
+static int stm32l4_foc_setup(struct foc_dev_s *dev)
+{
+  struct stm32l4_foc_dev_s   *foc_dev = STM32L4_FOC_DEV_FROM_DEV_GET(dev);
+  struct stm32l4_foc_board_s *board   = STM32L4_FOC_BOARD_FROM_DEV_GET(dev);
+  int                         ret     = OK;
+
+  DEBUGASSERT(foc_dev);
+  DEBUGASSERT(board);
+
+  /* Call board-specific setup - must be done before TIM enable */
+
+  ret = board->ops->setup(dev);
+  if (ret < 0)
+    {
+      mtrerr("board->setup failed %d\n", ret);
+      goto errout;
+    }
+
+  /* Setup ADC */
+
+  ret = foc_dev->adc_dev->ad_ops->ao_setup(foc_dev->adc_dev);
+  if (ret < 0)
+    {
+      mtrerr("ADC setup failed %d\n", ret);
+      goto errout;
+    }
+
+  /* Setup PWM */
+
+  PWM_SETUP(foc_dev->pwm);
+  PWM_TIM_ENABLE(foc_dev->pwm, true);
+
+  /* Stop ADC and PWM */
+
+  stm32l4_foc_pwm_start(dev, false);
+  stm32l4_foc_adc_start(dev, false);
+
+  /* Reset ADC handler */
+
+  foc_dev->adc_isr = NULL;
+
+  /* Attach the ADC interrupt handler with the first device */
+
+  ret = nxmutex_lock(&g_stm32l4_foc_lock);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (g_stm32l4_foc_irqcntr == 0)
+    {
+      ret = irq_attach(FOC_ADC_IRQ, stm32l4_foc_adc_handler, NULL);
+      if (ret < 0)
+        {
+          mtrerr("irq_attach failed: %d\n", ret);
+          nxmutex_unlock(&g_stm32l4_foc_lock);
+          goto errout;
+        }
+
+      up_prioritize_irq(FOC_ADC_IRQ, FOC_ADC_IRQ_PRIO);
+      up_enable_irq(FOC_ADC_IRQ);
+    }
+
+  g_stm32l4_foc_irqcntr += 1;
+  nxmutex_unlock(&g_stm32l4_foc_lock);
+
+  /* Get HW configuration */
+
+  dev->info.hw_cfg.pwm_dt_ns = board->data->pwm_dt_ns;
+  dev->info.hw_cfg.pwm_max   = board->data->duty_max;
+
+#ifdef CONFIG_MOTOR_FOC_TRACE
+  /* Initialize trace interface */
+
+  ret = board->ops->trace_init(dev);
+  if (ret < 0)
+    {
+      mtrerr("trace_init failed %d\n", ret);
+      goto errout;
+    }
+#endif
+
+  /* Start hardware calibration */
+
+  ret = stm32l4_foc_calibration_start(dev);
+  if (ret < 0)
+    {
+      mtrerr("stm32l4_foc_calibration_start failed %d\n", ret);
+      goto errout;
+    }
+
+  /* Dump ADC regs */
+
+  ADC_DUMP_REGS(foc_dev->adc);
+
+errout:
+  return ret;
+}
+
+/****************************************************************************
+ * Name: stm32l4_foc_shutdown
+ *
+ * Description:
+ *   Arch-specific FOC device shutdown
+ *
+ ****************************************************************************/
+
+static int stm32l4_foc_shutdown(struct foc_dev_s *dev)
+{
+  struct stm32l4_foc_dev_s   *foc_dev = STM32L4_FOC_DEV_FROM_DEV_GET(dev);
+  struct stm32l4_foc_board_s *board   = STM32L4_FOC_BOARD_FROM_DEV_GET(dev);
+  struct stm32l4_foc_priv_s  *priv    = STM32L4_FOC_PRIV_FROM_DEV_GET(dev);
+  int                         ret     = OK;
+
+  DEBUGASSERT(foc_dev);
+  DEBUGASSERT(board);
+  DEBUGASSERT(priv);
+
+  /* Disable PWM */
+
+  PWM_TIM_ENABLE(foc_dev->pwm, false);
+  PWM_SHUTDOWN(foc_dev->pwm);
+
+  /* Stop ADC conversions and reset ADC interrupt handler */
+
+  stm32l4_foc_adc_start(dev, false);
+  foc_dev->adc_isr = NULL;
+
+  /* Detach the ADC interrupt handler with the last device */
+
+  ret = nxmutex_lock(&g_stm32l4_foc_lock);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  g_stm32l4_foc_irqcntr -= 1;
+  if (g_stm32l4_foc_irqcntr == 0)
+    {
+      up_disable_irq(FOC_ADC_IRQ);
+      irq_detach(FOC_ADC_IRQ);
+    }
+
+  nxmutex_unlock(&g_stm32l4_foc_lock);
+
+  /* Deinitialize ADC */
+
+  foc_dev->adc_dev->ad_ops->ao_shutdown(foc_dev->adc_dev);
+
+  /* Call board-specific shutdown */
+
+  board->ops->shutdown(dev);
+
+  /* Reset STM32L4 FOC volatile data */
+
+  memset(&priv->data, 0, sizeof(struct stm32l4_foc_data_s));
+
+errout:
+  return ret;
+}
+
+/****************************************************************************
+ * Name: stm32l4_foc_ioctl
+ *
+ * Description:
+ *   Arch-specific FOC device IOCTL
+ *
+ ****************************************************************************/
+
+static int stm32l4_foc_ioctl(struct foc_dev_s *dev, int cmd,
+                             unsigned long arg)
+{
+  return -ENOTTY;
+}
+
+/****************************************************************************
+ * Name: stm32l4_foc_adc_calibration_handler
+ *
+ * Description:
+ *   ADC interrupt handler for FOC calibration
+ *
+ ****************************************************************************/
+
+static int stm32l4_foc_adc_calibration_handler(struct foc_dev_s *dev)
+{
+  struct stm32l4_foc_priv_s *priv = STM32L4_FOC_PRIV_FROM_DEV_GET(dev);
+  int                        i;
+
+  DEBUGASSERT(priv);
+
+  if (priv->data.adcint_cntr < CAL_SAMPLES)
+    {
+      /* Get raw current samples and sum them */
+
+      stm32l4_foc_curr_get(dev, priv->data.curr_raw);
+
+      for (i = 0; i < CONFIG_MOTOR_FOC_SHUNTS; i += 1)
+        {
+          priv->data.curr_offset[i] += priv->data.curr_raw[i];
+        }
+    }
+  else if (priv->data.adcint_cntr == CAL_SAMPLES)
+    {
+      /* Get average offset */
+
+      for (i = 0; i < CONFIG_MOTOR_FOC_SHUNTS; i += 1)
+        {
+          priv->data.curr_offset[i] =
+            (priv->data.curr_offset[i] / CAL_SAMPLES);
+        }
+
+      /* Post semaphore that calibration is done */
+
+      nxsem_post(&priv->cal_done_sem);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4_foc_adc_handler
+ *
+ * Description:
+ *   ADC interrupt handler
+ *
+ ****************************************************************************/
+
+static int stm32l4_foc_adc_handler(int irq, void *context, void *arg)
+{
+  struct foc_dev_s           *dev;
+  struct stm32l4_foc_priv_s  *priv;
+  struct stm32l4_foc_dev_s   *foc_dev;
+#ifdef CONFIG_MOTOR_FOC_TRACE
+  struct stm32l4_foc_board_s *board;
+#endif
+  uint32_t                    pending;
+  int                         ret = OK;
+  int                         i;
+
+  UNUSED(irq);
+  UNUSED(context);
+  UNUSED(arg);
+
+  /* Loop through all FOC instances, ADC1 and ADC2 share the interrupt */
+
+  for (i = 0; i < CONFIG_MOTOR_FOC_INST; i += 1)
+    {
+      dev     = &g_foc_dev[i];
+      foc_dev = STM32L4_FOC_DEV_FROM_DEV_GET(dev);
+      if (foc_dev == NULL || foc_dev->adc == NULL)
+        {
+          continue;
+        }
+
+      /* Only if end of injected sequence */
+
+      pending = ADC_INT_GET(foc_dev->adc);
+      if ((pending & FOC_ADC_ISR_FOC) == 0)
+        {
+          continue;
+        }
+
+      priv = STM32L4_FOC_PRIV_FROM_DEV_GET(dev);
+
+#ifdef CONFIG_MOTOR_FOC_TRACE
+      board = STM32L4_FOC_BOARD_FROM_DEV_GET(dev);
+      board->ops->trace(dev, FOC_TRACE_LOWER, true);
+#endif
+
+      /* Clear pending */
+
+      ADC_INT_ACK(foc_dev->adc, pending);
+
+      /* Call interrupt handler if registered */
+
+      if (foc_dev->adc_isr != NULL)
+        {
+          ret = foc_dev->adc_isr(dev);
+          if (ret < 0)
+            {
+              DEBUGPANIC();
+            }
+        }
+
+      /* Increase interrupt counter */
+
+      priv->data.adcint_cntr += 1;
+
+#ifdef CONFIG_MOTOR_FOC_TRACE
+      board->ops->trace(dev, FOC_TRACE_LOWER, false);
+#endif
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: stm32l4_foc_worker_handler
+ *
+ * Description:
+ *   Handle ADC conversion and do FOC device work.
+ *
+ ****************************************************************************/
+
+static int stm32l4_foc_worker_handler(struct foc_dev_s *dev)
+{
+  struct stm32l4_foc_priv_s  *priv  = STM32L4_FOC_PRIV_FROM_DEV_GET(dev);
+  struct stm32l4_foc_board_s *board = STM32L4_FOC_BOARD_FROM_DEV_GET(dev);
+  int                         ret   = OK;
+
+  DEBUGASSERT(priv);
+  DEBUGASSERT(board);
+  DEBUGASSERT(priv->cb);
+  DEBUGASSERT(priv->cb->notifier);
+
+  if (priv->data.adcint_cntr % priv->data.notifier_div == 0)
+    {
+      /* Get raw current samples */
+
+      stm32l4_foc_curr_get(dev, priv->data.curr_raw);
+
+      /* Get phase currents */
+
+      ret = board->ops->current_get(dev,
+                                    priv->data.curr_raw,
+                                    priv->data.curr);
+
+      /* Call upper-half worker callback */
+
+      priv->cb->notifier(dev, priv->data.curr, NULL);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: stm32l4_foc_calibration_start
+ *
+ * Description:
+ *   Start FOC hardware calibration (ADC offsets)
+ *
+ ****************************************************************************/
+
+static int stm32l4_foc_calibration_start(struct foc_dev_s *dev)
+{
+  struct stm32l4_foc_dev_s   *foc_dev = STM32L4_FOC_DEV_FROM_DEV_GET(dev);
+  struct stm32l4_foc_priv_s  *priv    = STM32L4_FOC_PRIV_FROM_DEV_GET(dev);
+  struct stm32l4_foc_board_s *board   = STM32L4_FOC_BOARD_FROM_DEV_GET(dev);
+  struct stm32l4_pwm_dev_s   *pwm     = PWM_FROM_FOC_DEV_GET(dev);
+  struct stm32_adc_dev_s     *adc     = ADC_FROM_FOC_DEV_GET(dev);
+  uint8_t                     i;
+  uint8_t                     ch;
+  int                         ret     = OK;
+
+  DEBUGASSERT(foc_dev);
+  DEBUGASSERT(priv);
+  DEBUGASSERT(board);
+  DEBUGASSERT(pwm);
+  DEBUGASSERT(adc);
+
+  /* Call board-specific */
+
+  board->ops->calibration(dev, true);
+
+  /* Force high side transistors to low state and
+   * low side tranisstors to high state
+   */
+
+  PWM_MODE_UPDATE(pwm, STM32L4_PWM_CHAN1, PWM_MODE_HSLO_LSHI);
+  PWM_MODE_UPDATE(pwm, STM32L4_PWM_CHAN2, PWM_MODE_HSLO_LSHI);
+  PWM_MODE_UPDATE(pwm, STM32L4_PWM_CHAN3, PWM_MODE_HSLO_LSHI);
+
+  /* Set PWM to trigger ADC */
+
+  ret = stm32l4_foc_pwm_freq_set(dev, CAL_FREQ);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  /* Configure ADC interrupt handler to calibration */
+
+  foc_dev->adc_isr = stm32l4_foc_adc_calibration_handler;
+
+  /* Configure ADC trigger - must be after PWM frequency set */
+
+  DEBUGASSERT(priv->data.per != 0);
+
+  stm32l4_foc_adc_trg_set(dev, (priv->data.per - ADC_TRIGGER_OFFSET));
+
+  /* Reset ADC interrupts counter */
+
+  priv->data.adcint_cntr = 0;
+
+  /* Start ADC and PWM */
+
+  stm32l4_foc_adc_start(dev, true);
+  stm32l4_foc_pwm_start(dev, true);
+
+  /* Wait for calibration done semaphore
+   * All work is done in adc_calibration_handler
+   */
+
+  ret = nxsem_wait_uninterruptible(&priv->cal_done_sem);
+
+  /* Stop ADC and PWM */
+
+  stm32l4_foc_pwm_start(dev, false);
+  stm32l4_foc_adc_start(dev, false);
+
+  /* Reset ADC interrupt handler */
+
+  foc_dev->adc_isr = NULL;
+
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  /* Set ADC hardware offset for current channels (only injected channels).
+   * The conversions now give signed values.
+   */
+
+  for (i = 0; i < CONFIG_MOTOR_FOC_SHUNTS; i += 1)
+    {
+      priv->data.curr_raw[i] = 0;
+
+      ch = board->data->adc_cfg->chan[board->data->adc_cfg->regch + i];
+      ADC_OFFSET_SET(adc, ch, i, priv->data.curr_offset[i]);
+    }
+
+  mtrinfo("ADC offset calibration - DONE!\n");
+
+errout:
+
+  /* Call board-specific */
+
+  board->ops->calibration(dev, false);
+
+  /* Reset ADC interrupts counter */
+
+  priv->data.adcint_cntr = 0;
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: stm32l4_foc_pwm_duty_set
+ *
+ * Description:
+ *   Set the 3-phase PWM duty cycle
+ *
+ ****************************************************************************/
+
+static int stm32l4_foc_pwm_duty_set(struct foc_dev_s *dev,
+                                    foc_duty_t *duty)
+{
+  struct stm32l4_foc_priv_s *priv    = STM32L4_FOC_PRIV_FROM_DEV_GET(dev);
+  struct stm32l4_foc_dev_s  *foc_dev = STM32L4_FOC_DEV_FROM_DEV_GET(dev);
+
+  DEBUGASSERT(duty);
+  DEBUGASSERT(priv);
+  DEBUGASSERT(foc_dev);
+  DEBUGASSERT(priv->data.per != 0);
+
+  /* Write directly to timer registers.
+   * We are not using the PWM_CCR_UPDATE interface as it is too slow
+   */
+
+  putreg32(b16toi(b16muli(duty[0], priv->data.per)),
+           foc_dev->pwm_base + STM32L4_GTIM_CCR1_OFFSET);
+  putreg32(b16toi(b16muli(duty[1], priv->data.per)),
+           foc_dev->pwm_base + STM32L4_GTIM_CCR2_OFFSET);
+  putreg32(b16toi(b16muli(duty[2], priv->data.per)),
+           foc_dev->pwm_base + STM32L4_GTIM_CCR3_OFFSET);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4_foc_pwm_off
+ *
+ * Description:
+ *   Set the 3-phase bridge switches in off state.
+ *
+ ****************************************************************************/
+
+static int stm32l4_foc_pwm_off(struct foc_dev_s *dev, bool off)
+{
+  struct stm32l4_pwm_dev_s *pwm = PWM_FROM_FOC_DEV_GET(dev);
+
+  if (off)
+    {
+      /* Force all transistors to low state */
+
+      PWM_MODE_UPDATE(pwm, STM32L4_PWM_CHAN1, PWM_MODE_HSHI_LSLO);
+      PWM_MODE_UPDATE(pwm, STM32L4_PWM_CHAN2, PWM_MODE_HSHI_LSLO);
+      PWM_MODE_UPDATE(pwm, STM32L4_PWM_CHAN3, PWM_MODE_HSHI_LSLO);
+
+      /* Disable complementary outputs */
+
+      PWM_OUTPUTS_ENABLE(pwm, PMW_OUTPUTS_ALL_COMP, false);
+    }
+  else
+    {
+      /* Restore FOC operation modes */
+
+      PWM_ALL_OUTPUTS_ENABLE(pwm, true);
+
+      PWM_MODE_UPDATE(pwm, STM32L4_PWM_CHAN1, PWM_MODE_FOC);
+      PWM_MODE_UPDATE(pwm, STM32L4_PWM_CHAN2, PWM_MODE_FOC);
+      PWM_MODE_UPDATE(pwm, STM32L4_PWM_CHAN3, PWM_MODE_FOC);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4_foc_curr_get
+ *
+ * Description:
+ *   Get current samples from ADC
+ *
+ ****************************************************************************/
+
+static void stm32l4_foc_curr_get(struct foc_dev_s *dev, int16_t *curr)
+{
+  struct stm32_adc_dev_s *adc = ADC_FROM_FOC_DEV_GET(dev);
+  int                     i;
+
+  DEBUGASSERT(adc);
+  DEBUGASSERT(curr);
+
+  /* We have ADC offset enabled for injected channels so this gives us
+   * signed values.
+   */
+
+  for (i = 0; i < CONFIG_MOTOR_FOC_SHUNTS; i += 1)
+    {
+      curr[i] = (int16_t)ADC_INJDATA_GET(adc, i);
+    }
+}
+
+/****************************************************************************
+ * Name: stm32l4_foc_notifier_cfg
+ *
+ * Description:
+ *   Configure FOC notifier
+ *
+ ****************************************************************************/
+
+static int stm32l4_foc_notifier_cfg(struct foc_dev_s *dev, uint32_t freq)
+{
+  struct stm32l4_foc_priv_s *priv = STM32L4_FOC_PRIV_FROM_DEV_GET(dev);
+
+  DEBUGASSERT(priv);
+  DEBUGASSERT(freq > 0);
+  DEBUGASSERT(dev->cfg.pwm_freq > 0);
+
+  /* The ADC interrupt comes every PWM period, the notifier frequency must
+   * be a fraction of the PWM frequency.
+   */
+
+  if (dev->cfg.pwm_freq % freq != 0 || dev->cfg.pwm_freq / freq > UINT8_MAX)
+    {
+      return -EINVAL;
+    }
+
+  priv->data.notifier_div = (dev->cfg.pwm_freq / freq);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4_foc_bind
+ *
+ * Description:
+ *   Bind lower-half FOC device with upper-half FOC logic
+ *
+ ****************************************************************************/
+
+static int stm32l4_foc_bind(struct foc_dev_s *dev,
+                            struct foc_callbacks_s *cb)
+{
+  struct stm32l4_foc_priv_s *priv = STM32L4_FOC_PRIV_FROM_DEV_GET(dev);
+
+  DEBUGASSERT(cb);
+  DEBUGASSERT(priv);
+  DEBUGASSERT(cb->notifier);
+
+  /* Bind upper-half FOC device callbacks */
+
+  priv->cb = cb;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4_foc_fault_clear
+ *
+ * Description:
+ *   Arch-specific fault clear
+ *
+ ****************************************************************************/
+
+static int stm32l4_foc_fault_clear(struct foc_dev_s *dev)
+{
+  struct stm32l4_foc_board_s *board = STM32L4_FOC_BOARD_FROM_DEV_GET(dev);
+
+  DEBUGASSERT(board);
+
+  return board->ops->fault_clear(dev);
+}
+
+#ifdef CONFIG_MOTOR_FOC_TRACE
+/****************************************************************************
+ * Name: stm32l4_foc_trace
+ *
+ * Description:
+ *   Arch-specific trace
+ *
+ ****************************************************************************/
+
+static void stm32l4_foc_trace(struct foc_dev_s *dev, int type, bool state)
+{
+  struct stm32l4_foc_board_s *board = STM32L4_FOC_BOARD_FROM_DEV_GET(dev);
+
+  DEBUGASSERT(board);
+
+  board->ops->trace(dev, type, state);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4_foc_initialize
+ *
+ * Description:
+ *   Initialize the FOC lower-half.
+ *
+ * Input Parameters:
+ *   inst  - FOC instance number
+ *   board - FOC board-specific data
+ *
+ * Returned Value:
+ *   Valid upper-half FOC device structure reference on success;
+ *   NULL on failure
+ *
+ ****************************************************************************/
+
+struct foc_dev_s *
+stm32l4_foc_initialize(int inst, struct stm32l4_foc_board_s *board)
+{
+  struct stm32l4_foc_adc_s  *adc_cfg;
+  struct foc_lower_s        *foc_lower;
+  struct stm32l4_foc_dev_s  *foc_dev;
+  struct stm32l4_foc_priv_s *foc_priv;
+  uint32_t                   pwm_base;
+  uint32_t                   jextval;
+  uint32_t                   pwmfzbit;
+  uint8_t                    pwm_inst;
+  uint8_t                    adc_inst;
+  int                        i;
+
+  DEBUGASSERT(board != NULL);
+  DEBUGASSERT(board->ops != NULL);
+  DEBUGASSERT(board->data != NULL);
+  DEBUGASSERT(board->data->adc_cfg != NULL);
+
+  /* Assert board-specific ops */
+
+  DEBUGASSERT(board->ops->setup);
+  DEBUGASSERT(board->ops->shutdown);
+  DEBUGASSERT(board->ops->calibration);
+  DEBUGASSERT(board->ops->fault_clear);
+  DEBUGASSERT(board->ops->pwm_start);
+  DEBUGASSERT(board->ops->current_get);
+#ifdef CONFIG_MOTOR_FOC_TRACE
+  DEBUGASSERT(board->ops->trace_init);
+  DEBUGASSERT(board->ops->trace);
+#endif
+
+  /* Get FOC instance configuration */
+
+  switch (inst)
+    {
+#ifdef CONFIG_STM32L4_FOC_FOC0
+      case 0:
+        {
+          pwm_inst = FOC0_PWM;
+          adc_inst = FOC0_ADC;
+          pwm_base = FOC0_PWM_BASE;
+          jextval  = FOC0_ADC_JEXT;
+          pwmfzbit = FOC0_PWM_FZ_BIT;
+          break;
+        }
+#endif
+
+#ifdef CONFIG_STM32L4_FOC_FOC1
+      case 1:
+        {
+          pwm_inst = FOC1_PWM;
+          adc_inst = FOC1_ADC;
+          pwm_base = FOC1_PWM_BASE;
+          jextval  = FOC1_ADC_JEXT;
+          pwmfzbit = FOC1_PWM_FZ_BIT;
+          break;
+        }
+#endif
+
+      default:
+        {
+          mtrerr("Unsupported STM32L4 FOC instance %d\n", inst);
+          set_errno(EINVAL);
+          return NULL;
+        }
+    }
+
+  if (inst >= CONFIG_MOTOR_FOC_INST)
+    {
+      set_errno(EINVAL);
+      return NULL;
+    }
+
+  /* Connect STM32L4 FOC private data with ops and data */
+
+  foc_lower        = &g_stm32l4_foc_lower[inst];
+  foc_priv         = &g_stm32l4_foc_priv[inst];
+  foc_dev          = &g_stm32l4_foc_dev[inst];
+
+  memset(foc_priv, 0, sizeof(struct stm32l4_foc_priv_s));
+
+  foc_lower->data  = foc_priv;
+  foc_lower->ops   = &g_stm32l4_foc_ops;
+  foc_priv->dev    = foc_dev;
+  foc_priv->board  = board;
+
+  /* Store STM32L4 FOC devices data */
+
+  foc_dev->adc_inst = adc_inst;
+  foc_dev->pwm_inst = pwm_inst;
+  foc_dev->pwm_base = pwm_base;
+  foc_dev->jextval  = jextval;
+
+  /* Get the advanced timer PWM interface */
+
+  foc_dev->pwm =
+    (struct stm32l4_pwm_dev_s *)stm32l4_pwminitialize(pwm_inst);
+  if (foc_dev->pwm == NULL)
+    {
+      mtrerr("Failed to get PWM%d interface\n", pwm_inst);
+      set_errno(EINVAL);
+      return NULL;
+    }
+
+  /* Make sure that we are using the appropriate ADC interface */
+
+  adc_cfg = board->data->adc_cfg;
+  if (adc_inst != adc_cfg->intf)
+    {
+      mtrerr("FOC ADC configuration doesn't match %d, %d\n",
+             adc_inst, adc_cfg->intf);
+      set_errno(EINVAL);
+      return NULL;
+    }
+
+  /* Configure pins as analog inputs for the selected channels */
+
+  for (i = 0; i < adc_cfg->nchan; i++)
+    {
+      stm32l4_configgpio(adc_cfg->pins[i]);
+    }
+
+  /* Get ADC instance */
+
+  foc_dev->adc_dev = stm32l4_adc_initialize(adc_cfg->intf, adc_cfg->chan,
+                                            adc_cfg->nchan);
+  if (foc_dev->adc_dev == NULL)
+    {
+      mtrerr("Failed to initialize FOC ADC%d interface\n", adc_cfg->intf);
+      set_errno(EINVAL);
+      return NULL;
+    }
+
+  foc_dev->adc = (struct stm32_adc_dev_s *)foc_dev->adc_dev->ad_priv;
+
+  /* Froze timer and reset outputs when core is halted */
+
+  modifyreg32(STM32_DBGMCU_APB2_FZ, 0, pwmfzbit);
+
+  /* Initialize calibration semaphore */
+
+  nxsem_init(&foc_priv->cal_done_sem, 0, 0);
+
+  /* Connect the lower-half device with the upper-half device */
+
+  g_foc_dev[inst].lower = foc_lower;
+
+  return &g_foc_dev[inst];
+}
+
+/****************************************************************************
+ * Name: stm32l4_foc_adcget
+ *
+ * Description:
+ *   Get a handler for ADC device associated with a given FOC device.
+ *
+ *   The FOC lower-half logic uses only injected ADC channels for operations.
+ *   The ADC interrupt is used by the FOC, so additional regular channels
+ *   can only be read with the DMA transfer.  With this function we can get
+ *   a handler to the ADC device and use it to register a standard ADC
+ *   character device.
+ *
+ * Input Parameters:
+ *   dev - a pointer to the upper-half FOC device
+ *
+ * Returned Value:
+ *   Valid ADC device structure reference on success; a NULL on failure
+ *
+ ****************************************************************************/
+
+struct adc_dev_s *stm32l4_foc_adcget(struct foc_dev_s *dev)
+{
+  struct stm32l4_foc_dev_s *foc_dev = STM32L4_FOC_DEV_FROM_DEV_GET(dev);
+
+  DEBUGASSERT(foc_dev);
+
+  return foc_dev->adc_dev;
+}
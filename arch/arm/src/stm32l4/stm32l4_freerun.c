@@ -27,12 +27,14 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include <assert.h>
 #include <errno.h>
 
 #include <nuttx/irq.h>
 #include <nuttx/clock.h>
 
+#include "stm32l4_gpio.h"
 #include "stm32l4_freerun.h"
 
 #ifdef CONFIG_STM32L4_FREERUN
@@ -41,6 +43,136 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: stm32l4_freerun_ticks
+ *
+ * Description:
+ *   Return the counter of the free-running timer extended with the
+ *   overflow count.
+ *
+ ****************************************************************************/
+
+static uint64_t stm32l4_freerun_ticks(struct stm32l4_freerun_s *freerun)
+{
+  uint32_t counter;
+  uint32_t verify;
+  uint32_t overflow;
+  int pending;
+  irqstate_t flags;
+
+  /* Temporarily disable the overflow counter.  NOTE that we have to be
+   * careful here because  stm32l4_tc_getpending() will reset the pending
+   * interrupt status.  If we do not handle the overflow here then, it will
+   * be lost.
+   */
+
+  flags    = enter_critical_section();
+
+  overflow = freerun->overflow;
+  counter  = STM32L4_TIM_GETCOUNTER(freerun->tch);
+  pending  = STM32L4_TIM_CHECKINT(freerun->tch, 0);
+  verify   = STM32L4_TIM_GETCOUNTER(freerun->tch);
+
+  /* If an interrupt was pending before we re-enabled interrupts,
+   * then the overflow needs to be incremented.
+   */
+
+  if (pending)
+    {
+      STM32L4_TIM_ACKINT(freerun->tch, 0);
+
+      /* Increment the overflow count and use the value of the
+       * guaranteed to be AFTER the overflow occurred.
+       */
+
+      overflow++;
+      counter = verify;
+
+      /* Update freerun overflow counter. */
+
+      freerun->overflow = overflow;
+    }
+
+  leave_critical_section(flags);
+
+  tmrinfo("counter=%lu (%lu) overflow=%lu, pending=%i\n",
+         (unsigned long)counter,  (unsigned long)verify,
+         (unsigned long)overflow, pending);
+
+  return ((uint64_t)overflow << 32) + counter;
+}
+
+/****************************************************************************
+ * Name: stm32l4_freerun_convert
+ *
+ * Description:
+ *   Convert a count of the free-running timer to a time.
+ *
+ ****************************************************************************/
+
+static void stm32l4_freerun_convert(struct stm32l4_freerun_s *freerun,
+                                    uint64_t ticks, struct timespec *ts)
+{
+  uint64_t usec;
+  uint32_t sec;
+
+  /* Convert the whole thing to units of microseconds.
+   *
+   *   frequency = ticks / second
+   *   seconds   = ticks * frequency
+   *   usecs     = (ticks * USEC_PER_SEC) / frequency;
+   */
+
+  usec = (ticks * USEC_PER_SEC) / freerun->frequency;
+
+  sec         = (uint32_t)(usec / USEC_PER_SEC);
+  ts->tv_sec  = sec;
+  ts->tv_nsec = (usec - (sec * USEC_PER_SEC)) * NSEC_PER_USEC;
+
+  tmrinfo("usec=%llu ts=(%u, %lu)\n",
+          usec, (unsigned long)ts->tv_sec, (unsigned long)ts->tv_nsec);
+}
+
+/****************************************************************************
+ * Name: stm32l4_freerun_captured
+ *
+ * Description:
+ *   Report the edges latched by the capture channels.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_FREERUN_CAPTURE
+static void stm32l4_freerun_captured(struct stm32l4_freerun_s *freerun)
+{
+  struct timespec ts;
+  uint32_t capture;
+  uint64_t now;
+  int ch;
+
+  for (ch = 1; ch <= 4; ch++)
+    {
+      if (freerun->capture[ch - 1] == NULL ||
+          !STM32L4_TIM_CHECKINT(freerun->tch, ch))
+        {
+          continue;
+        }
+
+      /* Reading the capture register clears the flag.  The edge is dated
+       * back from the extended counter now rather than paired with an
+       * overflow count, which may have moved on since the edge.
+       */
+
+      capture = STM32L4_TIM_GETCAPTURE(freerun->tch, ch);
+      now     = stm32l4_freerun_ticks(freerun);
+
+      stm32l4_freerun_convert(freerun,
+                              now - (uint32_t)((uint32_t)now - capture),
+                              &ts);
+      freerun->capture[ch - 1](freerun->arg[ch - 1], &ts);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: stm32l4_freerun_handler
  *
@@ -64,10 +196,24 @@ static int stm32l4_freerun_handler(int irq, void *context, void *arg)
   struct stm32l4_freerun_s *freerun =
                              (struct stm32l4_freerun_s *)arg;
 
-  DEBUGASSERT(freerun != NULL && freerun->overflow < UINT32_MAX);
-  freerun->overflow++;
+  DEBUGASSERT(freerun != NULL);
+
+  /* The overflow may already have been counted by
+   * stm32l4_freerun_ticks(), or the interrupt be that of a capture.
+   */
+
+  if (STM32L4_TIM_CHECKINT(freerun->tch, 0))
+    {
+      DEBUGASSERT(freerun->overflow < UINT32_MAX);
+      freerun->overflow++;
+
+      STM32L4_TIM_ACKINT(freerun->tch, 0);
+    }
+
+#ifdef CONFIG_STM32L4_FREERUN_CAPTURE
+  stm32l4_freerun_captured(freerun);
+#endif
 
-  STM32L4_TIM_ACKINT(freerun->tch, 0);
   return OK;
 }
 
@@ -124,6 +270,10 @@ int stm32l4_freerun_initialize(struct stm32l4_freerun_s *freerun,
   freerun->chan     = chan;
   freerun->overflow = 0;
 
+#ifdef CONFIG_STM32L4_FREERUN_CAPTURE
+  memset(freerun->capture, 0, sizeof(freerun->capture));
+#endif
+
   /* Set up to receive the callback when the counter overflow occurs */
 
   STM32L4_TIM_SETISR(freerun->tch, stm32l4_freerun_handler, freerun, 0);
@@ -163,77 +313,85 @@ int stm32l4_freerun_initialize(struct stm32l4_freerun_s *freerun,
 int stm32l4_freerun_counter(struct stm32l4_freerun_s *freerun,
                             struct timespec *ts)
 {
-  uint64_t usec;
-  uint32_t counter;
-  uint32_t verify;
-  uint32_t overflow;
-  uint32_t sec;
-  int pending;
-  irqstate_t flags;
-
   DEBUGASSERT(freerun && freerun->tch && ts);
 
-  /* Temporarily disable the overflow counter.  NOTE that we have to be
-   * careful here because  stm32l4_tc_getpending() will reset the pending
-   * interrupt status.  If we do not handle the overflow here then, it will
-   * be lost.
-   */
-
-  flags    = enter_critical_section();
+  tmrinfo("frequency=%u\n", freerun->frequency);
 
-  overflow = freerun->overflow;
-  counter  = STM32L4_TIM_GETCOUNTER(freerun->tch);
-  pending  = STM32L4_TIM_CHECKINT(freerun->tch, 0);
-  verify   = STM32L4_TIM_GETCOUNTER(freerun->tch);
+  stm32l4_freerun_convert(freerun, stm32l4_freerun_ticks(freerun), ts);
+  return OK;
+}
 
-  /* If an interrupt was pending before we re-enabled interrupts,
-   * then the overflow needs to be incremented.
-   */
+/****************************************************************************
+ * Name: stm32l4_freerun_capture
+ *
+ * Description:
+ *   Latch the counter of the free-running timer on the rising edges of the
+ *   input of one of its channels, and report the time of each edge from
+ *   the timer interrupt.
+ *
+ * Input Parameters:
+ *   freerun Caller allocated instance of the freerun state structure.  This
+ *           structure must have been previously initialized via a call to
+ *           stm32l4_freerun_initialize();
+ *   channel The timer channel, 1-4.
+ *   pincfg  The pin configuration of the channel input.
+ *   handler The callback, or NULL to stop reporting the edges.
+ *   arg     The argument of the callback.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
 
-  if (pending)
-    {
-      STM32L4_TIM_ACKINT(freerun->tch, 0);
+#ifdef CONFIG_STM32L4_FREERUN_CAPTURE
+int stm32l4_freerun_capture(struct stm32l4_freerun_s *freerun, int channel,
+                            uint32_t pincfg,
+                            stm32l4_freerun_capture_t handler, void *arg)
+{
+  irqstate_t flags;
+  int ret = OK;
 
-      /* Increment the overflow count and use the value of the
-       * guaranteed to be AFTER the overflow occurred.
-       */
+  DEBUGASSERT(freerun && freerun->tch);
 
-      overflow++;
-      counter = verify;
+  if (channel < 1 || channel > 4)
+    {
+      return -EINVAL;
+    }
 
-      /* Update freerun overflow counter. */
+  flags = enter_critical_section();
 
-      freerun->overflow = overflow;
+  if (handler == NULL)
+    {
+      STM32L4_TIM_DISABLEINT(freerun->tch, channel);
+      freerun->capture[channel - 1] = NULL;
+    }
+  else
+    {
+      ret = STM32L4_TIM_SETCHANNEL(freerun->tch, channel,
+                                   STM32L4_TIM_CH_INCAPTURE);
+      if (ret >= 0)
+        {
+          stm32l4_configgpio(pincfg);
+
+          freerun->capture[channel - 1] = handler;
+          freerun->arg[channel - 1]     = arg;
+
+          /* On TIM1 and TIM8 the capture interrupt has a vector of its
+           * own.
+           */
+
+          STM32L4_TIM_SETISR(freerun->tch, stm32l4_freerun_handler,
+                             freerun, channel);
+          STM32L4_TIM_ACKINT(freerun->tch, channel);
+          STM32L4_TIM_ENABLEINT(freerun->tch, channel);
+        }
     }
 
   leave_critical_section(flags);
-
-  tmrinfo("counter=%lu (%lu) overflow=%lu, pending=%i\n",
-         (unsigned long)counter,  (unsigned long)verify,
-         (unsigned long)overflow, pending);
-  tmrinfo("frequency=%u\n", freerun->frequency);
-
-  /* Convert the whole thing to units of microseconds.
-   *
-   *   frequency = ticks / second
-   *   seconds   = ticks * frequency
-   *   usecs     = (ticks * USEC_PER_SEC) / frequency;
-   */
-
-  usec = ((((uint64_t)overflow << 32) + (uint64_t)counter) * USEC_PER_SEC) /
-         freerun->frequency;
-
-  /* And return the value of the timer */
-
-  sec         = (uint32_t)(usec / USEC_PER_SEC);
-  ts->tv_sec  = sec;
-  ts->tv_nsec = (usec - (sec * USEC_PER_SEC)) * NSEC_PER_USEC;
-
-  tmrinfo("usec=%llu ts=(%u, %lu)\n",
-          usec, (unsigned long)ts->tv_sec, (unsigned long)ts->tv_nsec);
-
-  return OK;
+  return ret;
 }
+#endif
 
 /****************************************************************************
  * Name: stm32l4_freerun_uninitialize
@@ -254,10 +412,25 @@ int stm32l4_freerun_counter(struct stm32l4_freerun_s *freerun,
 
 int stm32l4_freerun_uninitialize(struct stm32l4_freerun_s *freerun)
 {
+#ifdef CONFIG_STM32L4_FREERUN_CAPTURE
+  int ch;
+
+#endif
   DEBUGASSERT(freerun && freerun->tch);
 
   /* Now we can disable the timer interrupt and disable the timer. */
 
+#ifdef CONFIG_STM32L4_FREERUN_CAPTURE
+  for (ch = 1; ch <= 4; ch++)
+    {
+      if (freerun->capture[ch - 1] != NULL)
+        {
+          STM32L4_TIM_DISABLEINT(freerun->tch, ch);
+          STM32L4_TIM_SETISR(freerun->tch, NULL, NULL, ch);
+        }
+    }
+#endif
+
   STM32L4_TIM_DISABLEINT(freerun->tch, 0);
   STM32L4_TIM_SETMODE(freerun->tch, STM32L4_TIM_MODE_DISABLED);
   STM32L4_TIM_SETISR(freerun->tch, NULL, NULL, 0);
@@ -39,6 +39,15 @@
  * Public Types
  ****************************************************************************/
 
+/* Called from the timer interrupt with the time of a captured edge, in
+ * the time base of stm32l4_freerun_counter().
+ */
+
+#ifdef CONFIG_STM32L4_FREERUN_CAPTURE
+typedef void (*stm32l4_freerun_capture_t)(void *arg,
+                                          const struct timespec *ts);
+#endif
+
 /* The freerun client must allocate an instance of this structure and called
  * stm32l4_freerun_initialize() before using the freerun facilities.  The
  * client should not access the contents of this structure directly since the
@@ -51,6 +60,10 @@ struct stm32l4_freerun_s
   uint32_t overflow;             /* Timer counter overflow */
   struct stm32l4_tim_dev_s *tch; /* Handle returned by stm32l4_tim_init() */
   uint32_t frequency;
+#ifdef CONFIG_STM32L4_FREERUN_CAPTURE
+  stm32l4_freerun_capture_t capture[4]; /* Callbacks of channels 1-4 */
+  void *arg[4];                         /* Their arguments */
+#endif
 };
 
 /****************************************************************************
@@ -133,6 +146,37 @@ int stm32l4_freerun_counter(struct stm32l4_freerun_s *freerun,
 
 int stm32l4_freerun_uninitialize(struct stm32l4_freerun_s *freerun);
 
+/****************************************************************************
+ * Name: stm32l4_freerun_capture
+ *
+ * Description:
+ *   Latch the counter of the free-running timer on the rising edges of the
+ *   input of one of its channels, and report the time of each edge from
+ *   the timer interrupt.  The time is that of the edge itself, whatever
+ *   the interrupt latency, to the resolution of the timer.
+ *
+ * Input Parameters:
+ *   freerun Caller allocated instance of the freerun state structure.  This
+ *           structure must have been previously initialized via a call to
+ *           stm32l4_freerun_initialize();
+ *   channel The timer channel, 1-4.
+ *   pincfg  The pin configuration of the channel input, for example
+ *           GPIO_TIM5_CH1IN_1.
+ *   handler The callback, or NULL to stop reporting the edges.
+ *   arg     The argument of the callback.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_FREERUN_CAPTURE
+int stm32l4_freerun_capture(struct stm32l4_freerun_s *freerun, int channel,
+                            uint32_t pincfg,
+                            stm32l4_freerun_capture_t handler, void *arg);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
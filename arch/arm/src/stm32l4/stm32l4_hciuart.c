@@ -0,0 +1,900 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_hciuart.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/bluetooth.h>
+#include <nuttx/wireless/bluetooth/bt_hci.h>
+#include <nuttx/wireless/bluetooth/bt_uart.h>
+
+#ifdef CONFIG_SERIAL_TERMIOS
+#  include <termios.h>
+#endif
+
+#include <arch/board/board.h>
+
+#include "arm_internal.h"
+#include "chip.h"
+#include "stm32l4_gpio.h"
+#include "stm32l4_uart.h"
+#include "stm32l4_dma.h"
+#include "stm32l4_dvfs.h"
+#include "stm32l4_hciuart.h"
+
+#ifdef CONFIG_STM32L4_HCIUART
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* DMA channels.  USART1 has alternate channels and, with the DMAMUX, all
+ * U[S]ARTs may use any channel; the board.h file makes the selection.
+ */
+
+#ifndef CONFIG_STM32L4_HAVE_DMAMUX
+#  ifndef DMAMAP_USART2_RX
+#    define DMAMAP_USART2_RX  DMACHAN_USART2_RX
+#    define DMAMAP_USART2_TX  DMACHAN_USART2_TX
+#  endif
+#  ifndef DMAMAP_USART3_RX
+#    define DMAMAP_USART3_RX  DMACHAN_USART3_RX
+#    define DMAMAP_USART3_TX  DMACHAN_USART3_TX
+#  endif
+#endif
+
+#if defined(CONFIG_STM32L4_USART1_HCIUART) && \
+    (!defined(DMAMAP_USART1_RX) || !defined(DMAMAP_USART1_TX))
+#  error "USART1 DMA channels not defined (DMAMAP_USART1_RX/TX)"
+#endif
+
+#if defined(CONFIG_STM32L4_USART2_HCIUART) && \
+    (!defined(DMAMAP_USART2_RX) || !defined(DMAMAP_USART2_TX))
+#  error "USART2 DMA channels not defined (DMAMAP_USART2_RX/TX)"
+#endif
+
+#if defined(CONFIG_STM32L4_USART3_HCIUART) && \
+    (!defined(DMAMAP_USART3_RX) || !defined(DMAMAP_USART3_TX))
+#  error "USART3 DMA channels not defined (DMAMAP_USART3_RX/TX)"
+#endif
+
+/* DMA control words.  Each receive stage sets DMA_CCR_MINC unless the
+ * bytes are discarded.
+ */
+
+#define HCIUART_RXDMA_CONTROL_WORD \
+              (DMA_CCR_PSIZE_8BITS   | \
+               DMA_CCR_MSIZE_8BITS   | \
+               DMA_CCR_PRIMED)
+
+#define HCIUART_TXDMA_CONTROL_WORD \
+              (DMA_CCR_DIR           | \
+               DMA_CCR_MINC          | \
+               DMA_CCR_PSIZE_8BITS   | \
+               DMA_CCR_MSIZE_8BITS   | \
+               DMA_CCR_PRIMED)
+
+/* A received packet is kept in a single IOB: the H4 packet type in the
+ * first byte, then the HCI header and the payload.  Larger packets are
+ * discarded.
+ */
+
+#define HCIUART_RXOFFSET  H4_HEADER_SIZE
+
+#if CONFIG_IOB_BUFSIZE < BLUETOOTH_MAX_FRAMELEN
+#  define HCIUART_MAXFRAME CONFIG_IOB_BUFSIZE
+#else
+#  define HCIUART_MAXFRAME BLUETOOTH_MAX_FRAMELEN
+#endif
+
+/* Delay before retrying to get an IOB for the receiver */
+
+#define HCIUART_RXRETRY   MSEC2TICK(10)
+
+#ifdef CONFIG_BLUETOOTH_UART_DUMP
+#  define BT_DUMP(m,b,l)  lib_dumpbuffer(m,b,l)
+#else
+#  define BT_DUMP(m,b,l)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Receiver states.  Each state but the last is one DMA transfer. */
+
+enum hciuart_rxstate_e
+{
+  HCIUART_RXTYPE = 0,               /* H4 packet type into the IOB */
+  HCIUART_RXHDR,                    /* HCI header into the IOB */
+  HCIUART_RXDATA,                   /* Payload into the IOB */
+  HCIUART_RXDISCARD,                /* Payload that is not passed on */
+  HCIUART_RXIDLE                    /* Stopped, or waiting for an IOB */
+};
+
+/* Constant configuration of one HCI UART */
+
+struct hciuart_config_s
+{
+  uint32_t usartbase;               /* Base address of USART registers */
+  uint32_t apbclock;                /* PCLK1 or PCLK2 frequency */
+  uint32_t baud;                    /* Initial BAUD */
+  uint32_t rxdma_channel;           /* Rx DMA channel */
+  uint32_t txdma_channel;           /* Tx DMA channel */
+  uint32_t tx_gpio;                 /* U[S]ART TX GPIO pin configuration */
+  uint32_t rx_gpio;                 /* U[S]ART RX GPIO pin configuration */
+  uint32_t cts_gpio;                /* U[S]ART CTS GPIO pin configuration */
+  uint32_t rts_gpio;                /* U[S]ART RTS GPIO pin configuration */
+};
+
+/* State of one HCI UART */
+
+struct hciuart_dev_s
+{
+  /* This structure must appear first so that this structure is cast
+   * compatible with struct bt_driver_s.
+   */
+
+  struct bt_driver_s drv;
+
+  const struct hciuart_config_s *config;
+  DMA_HANDLE rxdma;                 /* Rx DMA channel handle */
+  DMA_HANDLE txdma;                 /* Tx DMA channel handle */
+  uint32_t baud;                    /* Current BAUD */
+  bool initialized;                 /* USART and DMA are configured */
+  bool opened;                      /* The transport is open */
+
+  /* Receiver */
+
+  uint8_t rxstate;                  /* See enum hciuart_rxstate_e */
+  uint8_t rxhdrlen;                 /* Length of the current HCI header */
+  uint16_t rxlen;                   /* Length of the current payload */
+  uint8_t rxdiscard;                /* Sink of discarded payload bytes */
+  struct iob_s *rxiob;              /* IOB of the packet being received */
+  struct iob_s *rxhead;             /* Received packets, not yet passed */
+  struct iob_s *rxtail;
+  struct work_s rxwork;             /* Passes received packets on */
+
+  /* Transmitter */
+
+  mutex_t txlock;                   /* One packet is sent at a time */
+  sem_t txsem;                      /* Signals the end of Tx DMA */
+  bool txerror;                     /* Tx DMA failed */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void hciuart_rxcallback(DMA_HANDLE handle, uint8_t status,
+                               void *arg);
+static void hciuart_rxwork(void *arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_USART1_HCIUART
+static const struct hciuart_config_s g_hciusart1_config =
+{
+  .usartbase     = STM32L4_USART1_BASE,
+  .apbclock      = STM32L4_PCLK2_FREQUENCY,
+  .baud          = CONFIG_STM32L4_HCIUART1_BAUD,
+  .rxdma_channel = DMAMAP_USART1_RX,
+  .txdma_channel = DMAMAP_USART1_TX,
+  .tx_gpio       = GPIO_USART1_TX,
+  .rx_gpio       = GPIO_USART1_RX,
+  .cts_gpio      = GPIO_USART1_CTS,
+  .rts_gpio      = GPIO_USART1_RTS,
+};
+
+static struct hciuart_dev_s g_hciusart1_priv =
+{
+  .config        = &g_hciusart1_config,
+  .txlock        = NXMUTEX_INITIALIZER,
+  .txsem         = SEM_INITIALIZER(0),
+};
+#endif
+
+#ifdef CONFIG_STM32L4_USART2_HCIUART
+static const struct hciuart_config_s g_hciusart2_config =
+{
+  .usartbase     = STM32L4_USART2_BASE,
+  .apbclock      = STM32L4_PCLK1_FREQUENCY,
+  .baud          = CONFIG_STM32L4_HCIUART2_BAUD,
+  .rxdma_channel = DMAMAP_USART2_RX,
+  .txdma_channel = DMAMAP_USART2_TX,
+  .tx_gpio       = GPIO_USART2_TX,
+  .rx_gpio       = GPIO_USART2_RX,
+  .cts_gpio      = GPIO_USART2_CTS,
+  .rts_gpio      = GPIO_USART2_RTS,
+};
+
+static struct hciuart_dev_s g_hciusart2_priv =
+{
+  .config        = &g_hciusart2_config,
+  .txlock        = NXMUTEX_INITIALIZER,
+  .txsem         = SEM_INITIALIZER(0),
+};
+#endif
+
+#ifdef CONFIG_STM32L4_USART3_HCIUART
+static const struct hciuart_config_s g_hciusart3_config =
+{
+  .usartbase     = STM32L4_USART3_BASE,
+  .apbclock      = STM32L4_PCLK1_FREQUENCY,
+  .baud          = CONFIG_STM32L4_HCIUART3_BAUD,
+  .rxdma_channel = DMAMAP_USART3_RX,
+  .txdma_channel = DMAMAP_USART3_TX,
+  .tx_gpio       = GPIO_USART3_TX,
+  .rx_gpio       = GPIO_USART3_RX,
+  .cts_gpio      = GPIO_USART3_CTS,
+  .rts_gpio      = GPIO_USART3_RTS,
+};
+
+static struct hciuart_dev_s g_hciusart3_priv =
+{
+  .config        = &g_hciusart3_config,
+  .txlock        = NXMUTEX_INITIALIZER,
+  .txsem         = SEM_INITIALIZER(0),
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hciuart_getreg/hciuart_putreg
+ ****************************************************************************/
+
+static inline uint32_t hciuart_getreg(struct hciuart_dev_s *priv,
+                                      int offset)
+{
+  return getreg32(priv->config->usartbase + offset);
+}
+
+static inline void hciuart_putreg(struct hciuart_dev_s *priv, int offset,
+                                  uint32_t value)
+{
+  putreg32(value, priv->config->usartbase + offset);
+}
+
+/****************************************************************************
+ * Name: hciuart_setbaud
+ *
+ * Description:
+ *   Set the BAUD of the USART.  BRR may only be written while the USART is
+ *   disabled.
+ *
+ ****************************************************************************/
+
+static void hciuart_setbaud(struct hciuart_dev_s *priv, uint32_t baud)
+{
+  uint32_t usartdiv8;
+  uint32_t cr1;
+  uint32_t brr;
+
+  cr1 = hciuart_getreg(priv, STM32L4_USART_CR1_OFFSET);
+  hciuart_putreg(priv, STM32L4_USART_CR1_OFFSET, cr1 & ~USART_CR1_UE);
+
+  /* usartdiv8 = 2 * fCK / baud, as in stm32l4serial_setbaud_usart() */
+
+  usartdiv8 = ((stm32l4_dvfs_scale(priv->config->apbclock) << 1) +
+               (baud >> 1)) / baud;
+
+  if (usartdiv8 > 100)
+    {
+      brr  = (usartdiv8 + 1) >> 1;
+      cr1 &= ~USART_CR1_OVER8;
+    }
+  else
+    {
+      DEBUGASSERT(usartdiv8 >= 8);
+
+      brr  = (usartdiv8 & 0xfff0) | ((usartdiv8 & 0x000f) >> 1);
+      cr1 |= USART_CR1_OVER8;
+    }
+
+  hciuart_putreg(priv, STM32L4_USART_BRR_OFFSET, brr);
+  hciuart_putreg(priv, STM32L4_USART_CR1_OFFSET, cr1);
+  priv->baud = baud;
+}
+
+/****************************************************************************
+ * Name: hciuart_configure
+ *
+ * Description:
+ *   Configure the pins and the USART for 8N1 with RTS/CTS flow control and
+ *   DMA in both directions, and acquire the DMA channels.  The USART clock
+ *   was enabled by the RCC setup.
+ *
+ ****************************************************************************/
+
+static void hciuart_configure(struct hciuart_dev_s *priv)
+{
+  const struct hciuart_config_s *config = priv->config;
+  uint32_t regval;
+
+  stm32l4_configgpio(config->tx_gpio);
+  stm32l4_configgpio(config->rx_gpio);
+  stm32l4_configgpio(config->cts_gpio);
+  stm32l4_configgpio(config->rts_gpio);
+
+  /* Disable the USART, 8 data bits, no parity, no interrupts */
+
+  regval  = hciuart_getreg(priv, STM32L4_USART_CR1_OFFSET);
+  regval &= ~(USART_CR1_UE | USART_CR1_TE | USART_CR1_RE | USART_CR1_M0 |
+              USART_CR1_M1 | USART_CR1_PCE | USART_CR1_ALLINTS);
+  hciuart_putreg(priv, STM32L4_USART_CR1_OFFSET, regval);
+
+  /* HCI UART spec:  1 stop bit */
+
+  regval  = hciuart_getreg(priv, STM32L4_USART_CR2_OFFSET);
+  regval &= ~USART_CR2_STOP_MASK;
+  hciuart_putreg(priv, STM32L4_USART_CR2_OFFSET, regval);
+
+  /* Hardware flow control in both directions.  RTS is deasserted as soon as
+   * a byte waits in the receive register, which holds off the controller
+   * between the DMA transfers of a packet.  The receiver is never stopped
+   * by an overrun.
+   */
+
+  regval  = hciuart_getreg(priv, STM32L4_USART_CR3_OFFSET);
+  regval &= ~USART_CR3_EIE;
+  regval |= USART_CR3_RTSE | USART_CR3_CTSE | USART_CR3_OVRDIS |
+            USART_CR3_DMAR | USART_CR3_DMAT;
+  hciuart_putreg(priv, STM32L4_USART_CR3_OFFSET, regval);
+
+  hciuart_setbaud(priv, config->baud);
+
+  priv->rxdma = stm32l4_dmachannel(config->rxdma_channel);
+  priv->txdma = stm32l4_dmachannel(config->txdma_channel);
+  DEBUGASSERT(priv->rxdma != NULL && priv->txdma != NULL);
+
+  regval  = hciuart_getreg(priv, STM32L4_USART_CR1_OFFSET);
+  regval |= USART_CR1_UE | USART_CR1_TE | USART_CR1_RE;
+  hciuart_putreg(priv, STM32L4_USART_CR1_OFFSET, regval);
+
+  priv->rxstate     = HCIUART_RXIDLE;
+  priv->initialized = true;
+}
+
+/****************************************************************************
+ * Name: hciuart_rxdma
+ *
+ * Description:
+ *   Start the DMA transfer of the next receive stage.
+ *
+ ****************************************************************************/
+
+static void hciuart_rxdma(struct hciuart_dev_s *priv, uint8_t state,
+                          uint8_t *buffer, size_t len, bool minc)
+{
+  priv->rxstate = state;
+  stm32l4_dmasetup(priv->rxdma,
+                   priv->config->usartbase + STM32L4_USART_RDR_OFFSET,
+                   (uint32_t)buffer, len,
+                   HCIUART_RXDMA_CONTROL_WORD | (minc ? DMA_CCR_MINC : 0));
+  stm32l4_dmastart(priv->rxdma, hciuart_rxcallback, priv, false);
+}
+
+/****************************************************************************
+ * Name: hciuart_rxnext
+ *
+ * Description:
+ *   Start the reception of the next packet.  Without an IOB the receiver
+ *   stays idle and the controller is held off by RTS until rxwork finds
+ *   one.
+ *
+ * Assumptions:
+ *   Called from the Rx DMA interrupt or with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void hciuart_rxnext(struct hciuart_dev_s *priv)
+{
+  if (priv->rxiob == NULL)
+    {
+      priv->rxiob = iob_tryalloc(false);
+      if (priv->rxiob == NULL)
+        {
+          priv->rxstate = HCIUART_RXIDLE;
+
+          /* Queued work will retry anyway once it has run */
+
+          if (work_available(&priv->rxwork))
+            {
+              work_queue(HPWORK, &priv->rxwork, hciuart_rxwork, priv,
+                         HCIUART_RXRETRY);
+            }
+
+          return;
+        }
+    }
+
+  priv->rxiob->io_offset = HCIUART_RXOFFSET;
+  hciuart_rxdma(priv, HCIUART_RXTYPE, priv->rxiob->io_data, 1, true);
+}
+
+/****************************************************************************
+ * Name: hciuart_rxdone
+ *
+ * Description:
+ *   Queue the completely received packet for rxwork and start the next
+ *   one.
+ *
+ ****************************************************************************/
+
+static void hciuart_rxdone(struct hciuart_dev_s *priv)
+{
+  struct iob_s *iob = priv->rxiob;
+
+  iob->io_len    = HCIUART_RXOFFSET + priv->rxhdrlen + priv->rxlen;
+  iob->io_pktlen = iob->io_len;
+  iob->io_flink  = NULL;
+
+  if (priv->rxtail == NULL)
+    {
+      priv->rxhead = iob;
+    }
+  else
+    {
+      priv->rxtail->io_flink = iob;
+    }
+
+  priv->rxtail = iob;
+  priv->rxiob  = NULL;
+
+  if (work_available(&priv->rxwork))
+    {
+      work_queue(HPWORK, &priv->rxwork, hciuart_rxwork, priv, 0);
+    }
+
+  hciuart_rxnext(priv);
+}
+
+/****************************************************************************
+ * Name: hciuart_rxcallback
+ *
+ * Description:
+ *   Rx DMA completion.  The H4 framing is parsed here, one stage per
+ *   transfer: the packet type, the HCI header that holds the payload
+ *   length, then the payload itself, all directly into the IOB.
+ *
+ ****************************************************************************/
+
+static void hciuart_rxcallback(DMA_HANDLE handle, uint8_t status, void *arg)
+{
+  struct hciuart_dev_s *priv = (struct hciuart_dev_s *)arg;
+  uint8_t *data = priv->rxiob->io_data;
+  uint8_t *hdr = &data[HCIUART_RXOFFSET];
+
+  if ((status & DMA_STATUS_ERROR) != 0)
+    {
+      wlerr("ERROR: Rx DMA failed: %02x\n", status);
+      hciuart_rxnext(priv);
+      return;
+    }
+
+  switch (priv->rxstate)
+    {
+      case HCIUART_RXTYPE:
+        switch (data[0])
+          {
+            case H4_EVT:
+              priv->rxhdrlen = sizeof(struct bt_hci_evt_hdr_s);
+              break;
+
+            case H4_ACL:
+              priv->rxhdrlen = sizeof(struct bt_hci_acl_hdr_s);
+              break;
+
+            case H4_SCO:
+              priv->rxhdrlen = 3;
+              break;
+
+            case H4_ISO:
+              priv->rxhdrlen = 4;
+              break;
+
+            default:
+
+              /* Not the start of a packet: drop the byte to find the
+               * framing again.
+               */
+
+              wlwarn("WARNING: Unknown H4 type %u\n", data[0]);
+              hciuart_rxnext(priv);
+              return;
+          }
+
+        hciuart_rxdma(priv, HCIUART_RXHDR, hdr, priv->rxhdrlen, true);
+        break;
+
+      case HCIUART_RXHDR:
+        if (data[0] == H4_EVT)
+          {
+            priv->rxlen = hdr[1];
+          }
+        else if (data[0] == H4_SCO)
+          {
+            priv->rxlen = hdr[2];
+          }
+        else
+          {
+            priv->rxlen = (hdr[2] | ((uint16_t)hdr[3] << 8)) &
+                          (data[0] == H4_ISO ? 0x3fff : 0xffff);
+          }
+
+        if ((data[0] != H4_EVT && data[0] != H4_ACL) ||
+            HCIUART_RXOFFSET + priv->rxhdrlen + priv->rxlen >
+            HCIUART_MAXFRAME)
+          {
+            wlwarn("WARNING: Dropped H4 type %u len %u\n",
+                   data[0], priv->rxlen);
+
+            if (priv->rxlen > 0)
+              {
+                hciuart_rxdma(priv, HCIUART_RXDISCARD, &priv->rxdiscard,
+                              priv->rxlen, false);
+              }
+            else
+              {
+                hciuart_rxnext(priv);
+              }
+          }
+        else if (priv->rxlen > 0)
+          {
+            hciuart_rxdma(priv, HCIUART_RXDATA, hdr + priv->rxhdrlen,
+                          priv->rxlen, true);
+          }
+        else
+          {
+            hciuart_rxdone(priv);
+          }
+        break;
+
+      case HCIUART_RXDATA:
+        hciuart_rxdone(priv);
+        break;
+
+      default:
+        hciuart_rxnext(priv);
+        break;
+    }
+}
+
+/****************************************************************************
+ * Name: hciuart_rxwork
+ *
+ * Description:
+ *   Pass the received packets to the Bluetooth stack, handing the IOBs
+ *   over if it accepts them, and restart an idle receiver.
+ *
+ ****************************************************************************/
+
+static void hciuart_rxwork(void *arg)
+{
+  struct hciuart_dev_s *priv = (struct hciuart_dev_s *)arg;
+  enum bt_buf_type_e type;
+  struct iob_s *iob;
+  struct iob_s *next;
+  irqstate_t flags;
+  int ret;
+
+  flags        = enter_critical_section();
+  iob          = priv->rxhead;
+  priv->rxhead = NULL;
+  priv->rxtail = NULL;
+  leave_critical_section(flags);
+
+  for (; iob != NULL; iob = next)
+    {
+      next           = iob->io_flink;
+      iob->io_flink  = NULL;
+      type           = iob->io_data[0] == H4_EVT ? BT_EVT : BT_ACL_IN;
+
+      BT_DUMP("Received", iob->io_data, iob->io_len);
+
+      if (priv->drv.receive_iob != NULL)
+        {
+          ret = bt_netdev_receive_iob(&priv->drv, type, iob);
+          if (ret < 0)
+            {
+              wlerr("ERROR: Failed to pass packet: %d\n", ret);
+              iob_free(iob);
+            }
+        }
+      else
+        {
+          bt_netdev_receive(&priv->drv, type,
+                            &iob->io_data[iob->io_offset],
+                            iob->io_len - iob->io_offset);
+          iob_free(iob);
+        }
+    }
+
+  flags = enter_critical_section();
+  if (priv->opened && priv->rxstate == HCIUART_RXIDLE)
+    {
+      hciuart_rxnext(priv);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: hciuart_txcallback
+ ****************************************************************************/
+
+static void hciuart_txcallback(DMA_HANDLE handle, uint8_t status, void *arg)
+{
+  struct hciuart_dev_s *priv = (struct hciuart_dev_s *)arg;
+
+  priv->txerror = (status & DMA_STATUS_ERROR) != 0;
+  nxsem_post(&priv->txsem);
+}
+
+/****************************************************************************
+ * Name: hciuart_open
+ ****************************************************************************/
+
+static int hciuart_open(struct bt_driver_s *dev)
+{
+  struct hciuart_dev_s *priv = (struct hciuart_dev_s *)dev;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if (!priv->opened)
+    {
+      /* Drop a byte that arrived while closed */
+
+      hciuart_getreg(priv, STM32L4_USART_RDR_OFFSET);
+      hciuart_putreg(priv, STM32L4_USART_ICR_OFFSET, USART_ICR_ORECF);
+
+      priv->opened = true;
+      hciuart_rxnext(priv);
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hciuart_close
+ ****************************************************************************/
+
+static void hciuart_close(struct bt_driver_s *dev)
+{
+  struct hciuart_dev_s *priv = (struct hciuart_dev_s *)dev;
+  irqstate_t flags;
+  struct iob_s *iob;
+
+  flags = enter_critical_section();
+  stm32l4_dmastop(priv->rxdma);
+  priv->opened  = false;
+  priv->rxstate = HCIUART_RXIDLE;
+  leave_critical_section(flags);
+
+  work_cancel(HPWORK, &priv->rxwork);
+
+  if (priv->rxiob != NULL)
+    {
+      iob_free(priv->rxiob);
+      priv->rxiob = NULL;
+    }
+
+  while ((iob = priv->rxhead) != NULL)
+    {
+      priv->rxhead = iob->io_flink;
+      iob_free(iob);
+    }
+
+  priv->rxtail = NULL;
+}
+
+/****************************************************************************
+ * Name: hciuart_send
+ *
+ * Description:
+ *   Send one packet by DMA from the buffer of the caller, which reserved
+ *   head room for the H4 packet type.  Returns when the last byte has been
+ *   handed to the USART.
+ *
+ ****************************************************************************/
+
+static int hciuart_send(struct bt_driver_s *dev, enum bt_buf_type_e type,
+                        void *data, size_t len)
+{
+  struct hciuart_dev_s *priv = (struct hciuart_dev_s *)dev;
+  uint8_t *hdr = (uint8_t *)data - dev->head_reserve;
+  int ret;
+
+  if (type == BT_CMD)
+    {
+      *hdr = H4_CMD;
+    }
+  else if (type == BT_ACL_OUT)
+    {
+      *hdr = H4_ACL;
+    }
+  else if (type == BT_ISO_OUT)
+    {
+      *hdr = H4_ISO;
+    }
+  else
+    {
+      return -EINVAL;
+    }
+
+  len += H4_HEADER_SIZE;
+
+  BT_DUMP("Sending", hdr, len);
+
+  ret = nxmutex_lock(&priv->txlock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  stm32l4_dmasetup(priv->txdma,
+                   priv->config->usartbase + STM32L4_USART_TDR_OFFSET,
+                   (uint32_t)hdr, len, HCIUART_TXDMA_CONTROL_WORD);
+  stm32l4_dmastart(priv->txdma, hciuart_txcallback, priv, false);
+
+  nxsem_wait_uninterruptible(&priv->txsem);
+  ret = priv->txerror ? -EIO : OK;
+
+  nxmutex_unlock(&priv->txlock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: hciuart_ioctl
+ *
+ * Description:
+ *   TCGETS and TCSETS get and set the BAUD, e.g. after the vendor command
+ *   that raised the BAUD of the controller.  The other termios settings
+ *   are fixed by the HCI UART specification.
+ *
+ ****************************************************************************/
+
+static int hciuart_ioctl(struct bt_driver_s *dev, int cmd,
+                         unsigned long arg)
+{
+#ifdef CONFIG_SERIAL_TERMIOS
+  struct hciuart_dev_s *priv = (struct hciuart_dev_s *)dev;
+  struct termios *termiosp = (struct termios *)arg;
+  irqstate_t flags;
+
+  switch (cmd)
+    {
+      case TCGETS:
+        if (termiosp == NULL)
+          {
+            return -EINVAL;
+          }
+
+        termiosp->c_cflag = CS8 | CCTS_OFLOW | CRTS_IFLOW;
+        cfsetispeed(termiosp, priv->baud);
+        return OK;
+
+      case TCSETS:
+        if (termiosp == NULL || cfgetispeed(termiosp) == 0)
+          {
+            return -EINVAL;
+          }
+
+        flags = enter_critical_section();
+        hciuart_setbaud(priv, cfgetispeed(termiosp));
+        leave_critical_section(flags);
+        return OK;
+
+      default:
+        break;
+    }
+#endif
+
+  return -ENOTTY;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4_hciuart_instantiate
+ *
+ * Description:
+ *   Configure the USART selected as Bluetooth HCI-UART and return its
+ *   HCI transport.
+ *
+ * Input Parameters:
+ *   port - USART number, 1 to 3
+ *
+ * Returned Value:
+ *   The HCI transport on success; NULL if the USART is not configured as
+ *   HCI-UART.
+ *
+ ****************************************************************************/
+
+struct bt_driver_s *stm32l4_hciuart_instantiate(int port)
+{
+  struct hciuart_dev_s *priv;
+
+  switch (port)
+    {
+#ifdef CONFIG_STM32L4_USART1_HCIUART
+      case 1:
+        priv = &g_hciusart1_priv;
+        break;
+#endif
+
+#ifdef CONFIG_STM32L4_USART2_HCIUART
+      case 2:
+        priv = &g_hciusart2_priv;
+        break;
+#endif
+
+#ifdef CONFIG_STM32L4_USART3_HCIUART
+      case 3:
+        priv = &g_hciusart3_priv;
+        break;
+#endif
+
+      default:
+        wlerr("ERROR: USART%d is not an HCI-UART\n", port);
+        return NULL;
+    }
+
+  if (!priv->initialized)
+    {
+      priv->drv.head_reserve = H4_HEADER_SIZE;
+      priv->drv.open         = hciuart_open;
+      priv->drv.send         = hciuart_send;
+      priv->drv.close        = hciuart_close;
+      priv->drv.ioctl        = hciuart_ioctl;
+
+      hciuart_configure(priv);
+    }
+
+  return &priv->drv;
+}
+
+#endif /* CONFIG_STM32L4_HCIUART */
@@ -0,0 +1,60 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_hciuart.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_SRC_STM32L4_STM32L4_HCIUART_H
+#define __ARCH_ARM_SRC_STM32L4_STM32L4_HCIUART_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/wireless/bluetooth/bt_driver.h>
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4_hciuart_instantiate
+ *
+ * Description:
+ *   Configure the USART selected as Bluetooth HCI-UART and return its
+ *   HCI transport.  The board logic passes it to bt_netdev_register() or
+ *   to another Bluetooth driver consumer.
+ *
+ *   Received H4 packets are moved by DMA directly into IOBs and handed to
+ *   the consumer with receive_iob(), if provided; transmitted packets are
+ *   sent by DMA from the buffer of the caller.  Hardware RTS/CTS flow
+ *   control is required.
+ *
+ * Input Parameters:
+ *   port - USART number, 1 to 3
+ *
+ * Returned Value:
+ *   The HCI transport on success; NULL if the USART is not configured as
+ *   HCI-UART.
+ *
+ ****************************************************************************/
+
+struct bt_driver_s *stm32l4_hciuart_instantiate(int port);
+
+#endif /* __ARCH_ARM_SRC_STM32L4_STM32L4_HCIUART_H */
@@ -0,0 +1,208 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_hipri.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* OS-unaware ("zero latency") interrupts.
+ *
+ * With CONFIG_ARCH_HIPRI_INTERRUPT and CONFIG_ARMV7M_USEBASEPRI, critical
+ * sections only raise BASEPRI to NVIC_SYSH_DISABLE_PRIORITY.  An interrupt
+ * at NVIC_SYSH_HIGH_PRIORITY whose vector is installed directly in the RAM
+ * vector table (CONFIG_ARCH_RAMVECTORS) is therefore never masked by the OS
+ * and does not go through arm_doirq()/irq_dispatch(): the hardware jumps
+ * straight to the handler.
+ *
+ * The price is that such a handler must not call ANY OS interface (no
+ * semaphores, no work queues, no syslog) and must not share data with OS
+ * code other than through lock-free structures.  The mailbox below is a
+ * single-producer/single-consumer ring for that purpose: the high priority
+ * handler puts, an OS-aware context gets.  To wake a task, the handler rings
+ * a "doorbell", i.e. pends an otherwise unused, normal priority interrupt
+ * whose handler (attached with irq_attach() as usual) may post a semaphore.
+ */
+
+#ifndef __ARCH_ARM_SRC_STM32L4_STM32L4_HIPRI_H
+#define __ARCH_ARM_SRC_STM32L4_STM32L4_HIPRI_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/arch.h>
+
+#include <arch/irq.h>
+#include <arch/armv7-m/nvicpri.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "barriers.h"
+
+#ifdef CONFIG_ARCH_RAMVECTORS
+#  include "ram_vectors.h"
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Initializer for a mailbox using the uint32_t array 'b', whose number of
+ * elements must be a power of two.
+ */
+
+#define STM32L4_MBOX_INITIALIZER(b) \
+  { 0, 0, (sizeof(b) / sizeof((b)[0])) - 1, (b) }
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifndef __ASSEMBLY__
+
+/* Single-producer/single-consumer mailbox.  head is only written by the
+ * producer and tail only by the consumer; both run freely and are reduced
+ * modulo the size on access.
+ */
+
+struct stm32l4_mbox_s
+{
+  volatile uint32_t head;  /* Next slot to put, advanced by the producer */
+  volatile uint32_t tail;  /* Next slot to get, advanced by the consumer */
+  uint32_t mask;           /* Number of slots minus one */
+  uint32_t *slots;         /* Storage, a power of two number of words */
+};
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4_mbox_put
+ *
+ * Description:
+ *   Add one word to the mailbox.  Safe to call from an OS-unaware handler;
+ *   only one context may put into a given mailbox.
+ *
+ * Returned Value:
+ *   true if the word was stored; false if the mailbox was full.
+ *
+ ****************************************************************************/
+
+static inline bool stm32l4_mbox_put(struct stm32l4_mbox_s *mbox,
+                                    uint32_t value)
+{
+  uint32_t head = mbox->head;
+
+  if (head - mbox->tail > mbox->mask)
+    {
+      return false;
+    }
+
+  mbox->slots[head & mbox->mask] = value;
+
+  /* Publish the slot before the new head */
+
+  ARM_DMB();
+  mbox->head = head + 1;
+  return true;
+}
+
+/****************************************************************************
+ * Name: stm32l4_mbox_get
+ *
+ * Description:
+ *   Remove the oldest word from the mailbox.  Only one context may get
+ *   from a given mailbox.
+ *
+ * Returned Value:
+ *   true if a word was returned in 'value'; false if the mailbox was empty.
+ *
+ ****************************************************************************/
+
+static inline bool stm32l4_mbox_get(struct stm32l4_mbox_s *mbox,
+                                    uint32_t *value)
+{
+  uint32_t tail = mbox->tail;
+
+  if (tail == mbox->head)
+    {
+      return false;
+    }
+
+  ARM_DMB();
+  *value = mbox->slots[tail & mbox->mask];
+
+  /* Consume the slot before handing it back to the producer */
+
+  ARM_DMB();
+  mbox->tail = tail + 1;
+  return true;
+}
+
+/****************************************************************************
+ * Name: stm32l4_hipri_doorbell
+ *
+ * Description:
+ *   Pend the normal priority interrupt 'irq' by software, so that its
+ *   OS-aware handler runs as soon as the high priority handler returns and
+ *   no critical section is held.  The only OS-related call that is safe
+ *   from an OS-unaware handler.
+ *
+ ****************************************************************************/
+
+static inline void stm32l4_hipri_doorbell(int irq)
+{
+  up_trigger_irq(irq, 0);
+}
+
+#if defined(CONFIG_ARCH_HIPRI_INTERRUPT) && defined(CONFIG_ARCH_RAMVECTORS)
+
+/****************************************************************************
+ * Name: stm32l4_hipri_attach
+ *
+ * Description:
+ *   Install 'vector' directly in the RAM vector table for 'irq' and raise
+ *   the interrupt above the priority masked by critical sections.  The
+ *   interrupt still has to be enabled with up_enable_irq().
+ *
+ * Input Parameters:
+ *   irq    - The interrupt number
+ *   vector - The handler, called by the hardware without any OS wrapping
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static inline int stm32l4_hipri_attach(int irq, up_vector_t vector)
+{
+  int ret;
+
+  ret = arm_ramvec_attach(irq, vector);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return up_prioritize_irq(irq, NVIC_SYSH_HIGH_PRIORITY);
+}
+
+#endif /* CONFIG_ARCH_HIPRI_INTERRUPT && CONFIG_ARCH_RAMVECTORS */
+#endif /* __ASSEMBLY__ */
+#endif /* __ARCH_ARM_SRC_STM32L4_STM32L4_HIPRI_H */
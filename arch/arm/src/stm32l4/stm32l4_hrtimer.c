@@ -0,0 +1,348 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_hrtimer.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/timers/hrtimer.h>
+
+#include "stm32l4_tim.h"
+#include "stm32l4_hrtimer.h"
+
+#ifdef CONFIG_STM32L4_HRTIMER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if CONFIG_STM32L4_HRTIMER_TIMER != 2 && CONFIG_STM32L4_HRTIMER_TIMER != 5
+#  error "The high resolution timer needs the 32-bit TIM2 or TIM5"
+#endif
+
+#define HRT_CHANNEL  CONFIG_STM32L4_HRTIMER_CHANNEL
+#define HRT_NOALARM  UINT64_MAX
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The 32-bit counter is extended to 64 bits by counting its overflows.  An
+ * alarm beyond the current lap of the counter is armed by the overflow
+ * interrupt of its lap.
+ */
+
+struct stm32l4_hrtimer_s
+{
+  struct hrtimer_lowerhalf_s lower;  /* Must be first */
+  struct stm32l4_tim_dev_s *tch;     /* Handle returned by stm32l4_tim_init() */
+  uint32_t frequency;                /* Counter frequency */
+  uint32_t overflow;                 /* Counter overflows */
+  uint64_t alarm;                    /* Counter value of the alarm */
+  bool armed;                        /* The compare interrupt is enabled */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static uint64_t stm32l4_hrtimer_current(struct hrtimer_lowerhalf_s *lower);
+static int stm32l4_hrtimer_setalarm(struct hrtimer_lowerhalf_s *lower,
+                                    uint64_t ns);
+static void stm32l4_hrtimer_cancel(struct hrtimer_lowerhalf_s *lower);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct hrtimer_ops_s g_hrtimer_ops =
+{
+  .current  = stm32l4_hrtimer_current,
+  .setalarm = stm32l4_hrtimer_setalarm,
+  .cancel   = stm32l4_hrtimer_cancel,
+};
+
+static struct stm32l4_hrtimer_s g_hrtimer =
+{
+  .lower =
+  {
+    .ops   = &g_hrtimer_ops,
+  },
+  .alarm   = HRT_NOALARM,
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4_hrtimer_ticks
+ *
+ * Description:
+ *   Return the extended counter.  A pending overflow is included but left
+ *   to the interrupt, which must also arm the alarms of the new lap.
+ *
+ ****************************************************************************/
+
+static uint64_t stm32l4_hrtimer_ticks(struct stm32l4_hrtimer_s *priv)
+{
+  uint32_t overflow;
+  uint32_t counter;
+  irqstate_t flags;
+
+  flags    = enter_critical_section();
+  overflow = priv->overflow;
+  counter  = STM32L4_TIM_GETCOUNTER(priv->tch);
+
+  if (STM32L4_TIM_CHECKINT(priv->tch, 0))
+    {
+      /* Read again, the counter is known to be after the overflow */
+
+      counter = STM32L4_TIM_GETCOUNTER(priv->tch);
+      overflow++;
+    }
+
+  leave_critical_section(flags);
+  return ((uint64_t)overflow << 32) | counter;
+}
+
+/****************************************************************************
+ * Name: stm32l4_hrtimer_arm
+ *
+ * Description:
+ *   Enable the compare interrupt of the alarm if it falls in the current
+ *   lap of the counter.  Called with interrupts disabled.
+ *
+ * Returned Value:
+ *   Zero (OK), or -ETIME if the alarm time has already passed.
+ *
+ ****************************************************************************/
+
+static int stm32l4_hrtimer_arm(struct stm32l4_hrtimer_s *priv)
+{
+  uint64_t now = stm32l4_hrtimer_ticks(priv);
+
+  priv->armed = false;
+  STM32L4_TIM_DISABLEINT(priv->tch, HRT_CHANNEL);
+
+  if (priv->alarm <= now)
+    {
+      return -ETIME;
+    }
+
+  if ((priv->alarm >> 32) != (now >> 32))
+    {
+      return OK;
+    }
+
+  STM32L4_TIM_SETCOMPARE(priv->tch, HRT_CHANNEL, (uint32_t)priv->alarm);
+  STM32L4_TIM_ACKINT(priv->tch, HRT_CHANNEL);
+  STM32L4_TIM_ENABLEINT(priv->tch, HRT_CHANNEL);
+  priv->armed = true;
+
+  /* A counter that passed the compare value while it was written did not
+   * match it.
+   */
+
+  if (stm32l4_hrtimer_ticks(priv) >= priv->alarm &&
+      !STM32L4_TIM_CHECKINT(priv->tch, HRT_CHANNEL))
+    {
+      priv->armed = false;
+      STM32L4_TIM_DISABLEINT(priv->tch, HRT_CHANNEL);
+      return -ETIME;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4_hrtimer_handler
+ *
+ * Description:
+ *   Timer interrupt:  count the overflows, arm the alarm when its lap
+ *   begins and report it when it is reached.
+ *
+ ****************************************************************************/
+
+static int stm32l4_hrtimer_handler(int irq, void *context, void *arg)
+{
+  struct stm32l4_hrtimer_s *priv = (struct stm32l4_hrtimer_s *)arg;
+
+  if (STM32L4_TIM_CHECKINT(priv->tch, 0))
+    {
+      DEBUGASSERT(priv->overflow < UINT32_MAX);
+      priv->overflow++;
+
+      STM32L4_TIM_ACKINT(priv->tch, 0);
+    }
+
+  if (STM32L4_TIM_CHECKINT(priv->tch, HRT_CHANNEL))
+    {
+      STM32L4_TIM_ACKINT(priv->tch, HRT_CHANNEL);
+    }
+
+  if (priv->alarm == HRT_NOALARM ||
+      (stm32l4_hrtimer_ticks(priv) < priv->alarm &&
+       (priv->armed || stm32l4_hrtimer_arm(priv) == OK)))
+    {
+      return OK;
+    }
+
+  priv->alarm = HRT_NOALARM;
+  priv->armed = false;
+  STM32L4_TIM_DISABLEINT(priv->tch, HRT_CHANNEL);
+
+  hrtimer_expired();
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4_hrtimer_current
+ *
+ * Description:
+ *   Return the time of the counter in nanoseconds.
+ *
+ ****************************************************************************/
+
+static uint64_t stm32l4_hrtimer_current(struct hrtimer_lowerhalf_s *lower)
+{
+  struct stm32l4_hrtimer_s *priv = (struct stm32l4_hrtimer_s *)lower;
+  uint64_t ticks = stm32l4_hrtimer_ticks(priv);
+
+  /* Split the conversion so that it does not overflow */
+
+  return (ticks / priv->frequency) * NSEC_PER_SEC +
+         (ticks % priv->frequency) * NSEC_PER_SEC / priv->frequency;
+}
+
+/****************************************************************************
+ * Name: stm32l4_hrtimer_setalarm
+ *
+ * Description:
+ *   Set the alarm to the first counter value not before 'ns'.
+ *
+ ****************************************************************************/
+
+static int stm32l4_hrtimer_setalarm(struct hrtimer_lowerhalf_s *lower,
+                                    uint64_t ns)
+{
+  struct stm32l4_hrtimer_s *priv = (struct stm32l4_hrtimer_s *)lower;
+  irqstate_t flags;
+  int ret;
+
+  flags = enter_critical_section();
+
+  priv->alarm = (ns / NSEC_PER_SEC) * priv->frequency +
+                ((ns % NSEC_PER_SEC) * priv->frequency + NSEC_PER_SEC - 1) /
+                NSEC_PER_SEC;
+
+  ret = stm32l4_hrtimer_arm(priv);
+  if (ret < 0)
+    {
+      priv->alarm = HRT_NOALARM;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: stm32l4_hrtimer_cancel
+ ****************************************************************************/
+
+static void stm32l4_hrtimer_cancel(struct hrtimer_lowerhalf_s *lower)
+{
+  struct stm32l4_hrtimer_s *priv = (struct stm32l4_hrtimer_s *)lower;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  priv->alarm = HRT_NOALARM;
+  priv->armed = false;
+  STM32L4_TIM_DISABLEINT(priv->tch, HRT_CHANNEL);
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4_hrtimer_initialize
+ *
+ * Description:
+ *   Start the free-running timer and register it as the lower half of the
+ *   high resolution timers.
+ *
+ ****************************************************************************/
+
+int stm32l4_hrtimer_initialize(void)
+{
+  struct stm32l4_hrtimer_s *priv = &g_hrtimer;
+  int ret;
+
+  priv->tch = stm32l4_tim_init(CONFIG_STM32L4_HRTIMER_TIMER);
+  if (priv->tch == NULL)
+    {
+      tmrerr("ERROR: Failed to allocate TIM%d\n",
+             CONFIG_STM32L4_HRTIMER_TIMER);
+      return -EBUSY;
+    }
+
+  /* The prescaler may not reach the requested frequency exactly */
+
+  STM32L4_TIM_SETCLOCK(priv->tch, CONFIG_STM32L4_HRTIMER_FREQUENCY);
+  priv->frequency = STM32L4_TIM_GETCLOCK(priv->tch);
+
+  tmrinfo("TIM%d frequency=%" PRIu32 "\n",
+          CONFIG_STM32L4_HRTIMER_TIMER, priv->frequency);
+
+  STM32L4_TIM_SETISR(priv->tch, stm32l4_hrtimer_handler, priv, 0);
+  STM32L4_TIM_SETPERIOD(priv->tch, UINT32_MAX);
+
+  ret = hrtimer_register(&priv->lower);
+  if (ret < 0)
+    {
+      STM32L4_TIM_SETISR(priv->tch, NULL, NULL, 0);
+      stm32l4_tim_deinit(priv->tch);
+      priv->tch = NULL;
+      return ret;
+    }
+
+  STM32L4_TIM_SETMODE(priv->tch, STM32L4_TIM_MODE_UP);
+  STM32L4_TIM_ACKINT(priv->tch, 0);
+  STM32L4_TIM_ENABLEINT(priv->tch, 0);
+
+  return OK;
+}
+
+#endif /* CONFIG_STM32L4_HRTIMER */
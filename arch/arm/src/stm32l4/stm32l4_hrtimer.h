@@ -0,0 +1,73 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_hrtimer.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_SRC_STM32L4_STM32L4_HRTIMER_H
+#define __ARCH_ARM_SRC_STM32L4_STM32L4_HRTIMER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#ifdef CONFIG_STM32L4_HRTIMER
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifndef __ASSEMBLY__
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: stm32l4_hrtimer_initialize
+ *
+ * Description:
+ *   Start the free-running 32-bit timer CONFIG_STM32L4_HRTIMER_TIMER at
+ *   CONFIG_STM32L4_HRTIMER_FREQUENCY and register it as the lower half of
+ *   the high resolution timers, see include/nuttx/timers/hrtimer.h.  The
+ *   alarm uses the compare channel CONFIG_STM32L4_HRTIMER_CHANNEL.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int stm32l4_hrtimer_initialize(void);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __ASSEMBLY__ */
+#endif /* CONFIG_STM32L4_HRTIMER */
+#endif /* __ARCH_ARM_SRC_STM32L4_STM32L4_HRTIMER_H */
@@ -85,6 +85,8 @@
  *  - Interrupt based operation
  *  - RELOAD support
  *  - I2C_M_NOSTART support
+ *  - Optional per-bus DMA for messages of at least
+ *    CONFIG_STM32L4_I2C_DMATHRESHOLD bytes
  *
  * Test Environment:
  *  - STM32L451CEU6 based board with I2C slaves LIS2DH accelerometer and
@@ -279,13 +281,20 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/power/pm.h>
 #include <nuttx/i2c/i2c_master.h>
+#ifdef CONFIG_STM32L4_I2C_ASYNC
+#  include <nuttx/wqueue.h>
+#endif
 
 #include <arch/board/board.h>
 
 #include "arm_internal.h"
 #include "stm32l4_gpio.h"
 #include "stm32l4_rcc.h"
+#include "stm32l4_dvfs.h"
 #include "stm32l4_i2c.h"
+#ifdef CONFIG_STM32L4_I2C_DMA
+#  include "stm32l4_dma.h"
+#endif
 #include "stm32l4_waste.h"
 
 /* At least one I2C peripheral must be enabled */
@@ -356,6 +365,50 @@
 #  define CONFIG_I2C_NTRACE 32
 #endif
 
+/* DMA
+ *
+ * Messages of at least CONFIG_STM32L4_I2C_DMATHRESHOLD bytes are moved by
+ * DMA on buses with CONFIG_STM32L4_I2Cn_DMA enabled; the TC/TCR state
+ * machine below still drives START, RELOAD and STOP.  The board must
+ * provide DMACHAN_I2Cn_RX and DMACHAN_I2Cn_TX in board.h for those buses.
+ */
+
+#ifdef CONFIG_STM32L4_I2C_DMA
+#  if defined(CONFIG_STM32L4_I2C1_DMA) && \
+      (!defined(DMACHAN_I2C1_RX) || !defined(DMACHAN_I2C1_TX))
+#    error "I2C1 DMA channels not defined (DMACHAN_I2C1_RX/TX)"
+#  endif
+#  if defined(CONFIG_STM32L4_I2C2_DMA) && \
+      (!defined(DMACHAN_I2C2_RX) || !defined(DMACHAN_I2C2_TX))
+#    error "I2C2 DMA channels not defined (DMACHAN_I2C2_RX/TX)"
+#  endif
+#  if defined(CONFIG_STM32L4_I2C3_DMA) && \
+      (!defined(DMACHAN_I2C3_RX) || !defined(DMACHAN_I2C3_TX))
+#    error "I2C3 DMA channels not defined (DMACHAN_I2C3_RX/TX)"
+#  endif
+#  if defined(CONFIG_STM32L4_I2C4_DMA) && \
+      (!defined(DMACHAN_I2C4_RX) || !defined(DMACHAN_I2C4_TX))
+#    error "I2C4 DMA channels not defined (DMACHAN_I2C4_RX/TX)"
+#  endif
+
+#  ifndef CONFIG_STM32L4_I2C_DMATHRESHOLD
+#    define CONFIG_STM32L4_I2C_DMATHRESHOLD 8
+#  endif
+
+#  define I2C_RXDMA_CONFIG  (DMA_CCR_PRIMED | DMA_CCR_MSIZE_8BITS | \
+                             DMA_CCR_PSIZE_8BITS | DMA_CCR_MINC)
+#  define I2C_TXDMA_CONFIG  (DMA_CCR_PRIMED | DMA_CCR_MSIZE_8BITS | \
+                             DMA_CCR_PSIZE_8BITS | DMA_CCR_MINC | \
+                             DMA_CCR_DIR)
+
+#  define I2C_DMA_ACTIVE(p) ((p)->dma != NULL)
+#else
+#  define stm32l4_i2c_dmasetup(p)
+#  define stm32l4_i2c_dmaupdate(p)
+#  define stm32l4_i2c_dmastop(p)
+#  define I2C_DMA_ACTIVE(p) false
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -421,6 +474,10 @@ struct stm32l4_i2c_config_s
   uint32_t ev_irq;            /* Event IRQ */
   uint32_t er_irq;            /* Error IRQ */
 #endif
+#ifdef CONFIG_STM32L4_I2C_DMA
+  uint16_t rxdma_channel;     /* RX DMA channel/request, 0 if not used */
+  uint16_t txdma_channel;     /* TX DMA channel/request, 0 if not used */
+#endif
 };
 
 /* I2C Device Private Data */
@@ -445,6 +502,11 @@ struct stm32l4_i2c_priv_s
   int dcnt;                    /* Current message bytes remaining to transfer */
   uint16_t flags;              /* Current message flags */
   bool astart;                 /* START sent */
+#ifdef CONFIG_STM32L4_I2C_DMA
+  DMA_HANDLE rxdma;            /* RX DMA handle, NULL if DMA is not used */
+  DMA_HANDLE txdma;            /* TX DMA handle, NULL if DMA is not used */
+  DMA_HANDLE dma;              /* DMA moving the current message, or NULL */
+#endif
 
   /* I2C trace support */
 
@@ -462,6 +524,9 @@ struct stm32l4_i2c_priv_s
 #ifdef CONFIG_PM
   struct pm_callback_s pm_cb;  /* PM callbacks */
 #endif
+#ifdef CONFIG_STM32L4_DVFS
+  struct stm32l4_dvfs_callback_s dvfs_cb; /* Clock change callbacks */
+#endif
 };
 
 /* I2C Device, Instance */
@@ -512,6 +577,11 @@ void stm32l4_i2c_sendstart(struct stm32l4_i2c_priv_s *priv);
 static inline void stm32l4_i2c_sendstop(struct stm32l4_i2c_priv_s *priv);
 static inline
 uint32_t stm32l4_i2c_getstatus(struct stm32l4_i2c_priv_s *priv);
+#ifdef CONFIG_STM32L4_I2C_DMA
+static void stm32l4_i2c_dmasetup(struct stm32l4_i2c_priv_s *priv);
+static void stm32l4_i2c_dmaupdate(struct stm32l4_i2c_priv_s *priv);
+static void stm32l4_i2c_dmastop(struct stm32l4_i2c_priv_s *priv);
+#endif
 static int stm32l4_i2c_isr_process(struct stm32l4_i2c_priv_s *priv);
 #ifndef CONFIG_I2C_POLLED
 static int stm32l4_i2c_isr(int irq, void *context, void *arg);
@@ -526,10 +596,19 @@ static int stm32l4_i2c_transfer(struct i2c_master_s *dev,
 #ifdef CONFIG_I2C_RESET
 static int stm32l4_i2c_reset(struct i2c_master_s *dev);
 #endif
+#ifdef CONFIG_STM32L4_I2C_ASYNC
+static void stm32l4_i2c_worker(void *arg);
+#endif
 #ifdef CONFIG_PM
 static int stm32l4_i2c_pm_prepare(struct pm_callback_s *cb, int domain,
                                   enum pm_state_e pmstate);
 #endif
+#ifdef CONFIG_STM32L4_DVFS
+static int stm32l4_i2c_dvfs_prepare(struct stm32l4_dvfs_callback_s *cb,
+                                    uint32_t sysclk);
+static void stm32l4_i2c_dvfs_notify(struct stm32l4_dvfs_callback_s *cb,
+                                    uint32_t sysclk);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -545,7 +624,11 @@ static const struct stm32l4_i2c_config_s stm32l4_i2c1_config =
   .sda_pin    = GPIO_I2C1_SDA,
 #ifndef CONFIG_I2C_POLLED
   .ev_irq     = STM32L4_IRQ_I2C1EV,
-  .er_irq     = STM32L4_IRQ_I2C1ER
+  .er_irq     = STM32L4_IRQ_I2C1ER,
+#endif
+#ifdef CONFIG_STM32L4_I2C1_DMA
+  .rxdma_channel = DMACHAN_I2C1_RX,
+  .txdma_channel = DMACHAN_I2C1_TX,
 #endif
 };
 
@@ -568,6 +651,10 @@ static struct stm32l4_i2c_priv_s stm32l4_i2c1_priv =
 #ifdef CONFIG_PM
   .pm_cb.prepare = stm32l4_i2c_pm_prepare,
 #endif
+#ifdef CONFIG_STM32L4_DVFS
+  .dvfs_cb.prepare = stm32l4_i2c_dvfs_prepare,
+  .dvfs_cb.notify  = stm32l4_i2c_dvfs_notify,
+#endif
 };
 #endif
 
@@ -581,7 +668,11 @@ static const struct stm32l4_i2c_config_s stm32l4_i2c2_config =
   .sda_pin    = GPIO_I2C2_SDA,
 #ifndef CONFIG_I2C_POLLED
   .ev_irq     = STM32L4_IRQ_I2C2EV,
-  .er_irq     = STM32L4_IRQ_I2C2ER
+  .er_irq     = STM32L4_IRQ_I2C2ER,
+#endif
+#ifdef CONFIG_STM32L4_I2C2_DMA
+  .rxdma_channel = DMACHAN_I2C2_RX,
+  .txdma_channel = DMACHAN_I2C2_TX,
 #endif
 };
 
@@ -604,6 +695,10 @@ static struct stm32l4_i2c_priv_s stm32l4_i2c2_priv =
 #ifdef CONFIG_PM
   .pm_cb.prepare = stm32l4_i2c_pm_prepare,
 #endif
+#ifdef CONFIG_STM32L4_DVFS
+  .dvfs_cb.prepare = stm32l4_i2c_dvfs_prepare,
+  .dvfs_cb.notify  = stm32l4_i2c_dvfs_notify,
+#endif
 };
 #endif
 
@@ -617,7 +712,11 @@ static const struct stm32l4_i2c_config_s stm32l4_i2c3_config =
   .sda_pin    = GPIO_I2C3_SDA,
 #ifndef CONFIG_I2C_POLLED
   .ev_irq     = STM32L4_IRQ_I2C3EV,
-  .er_irq     = STM32L4_IRQ_I2C3ER
+  .er_irq     = STM32L4_IRQ_I2C3ER,
+#endif
+#ifdef CONFIG_STM32L4_I2C3_DMA
+  .rxdma_channel = DMACHAN_I2C3_RX,
+  .txdma_channel = DMACHAN_I2C3_TX,
 #endif
 };
 
@@ -640,6 +739,10 @@ static struct stm32l4_i2c_priv_s stm32l4_i2c3_priv =
 #ifdef CONFIG_PM
   .pm_cb.prepare = stm32l4_i2c_pm_prepare,
 #endif
+#ifdef CONFIG_STM32L4_DVFS
+  .dvfs_cb.prepare = stm32l4_i2c_dvfs_prepare,
+  .dvfs_cb.notify  = stm32l4_i2c_dvfs_notify,
+#endif
 };
 #endif
 
@@ -653,7 +756,11 @@ static const struct stm32l4_i2c_config_s stm32l4_i2c4_config =
   .sda_pin    = GPIO_I2C4_SDA,
 #ifndef CONFIG_I2C_POLLED
   .ev_irq     = STM32L4_IRQ_I2C4EV,
-  .er_irq     = STM32L4_IRQ_I2C4ER
+  .er_irq     = STM32L4_IRQ_I2C4ER,
+#endif
+#ifdef CONFIG_STM32L4_I2C4_DMA
+  .rxdma_channel = DMACHAN_I2C4_RX,
+  .txdma_channel = DMACHAN_I2C4_TX,
 #endif
 };
 
@@ -676,6 +783,10 @@ static struct stm32l4_i2c_priv_s stm32l4_i2c4_priv =
 #ifdef CONFIG_PM
   .pm_cb.prepare = stm32l4_i2c_pm_prepare,
 #endif
+#ifdef CONFIG_STM32L4_DVFS
+  .dvfs_cb.prepare = stm32l4_i2c_dvfs_prepare,
+  .dvfs_cb.notify  = stm32l4_i2c_dvfs_notify,
+#endif
 };
 #endif
 
@@ -1276,7 +1387,13 @@ static void stm32l4_i2c_setclock(struct stm32l4_i2c_priv_s *priv,
                                   I2C_CR1_PE, 0);
         }
 
-#if defined(STM32L4_I2C_USE_HSI16) || (STM32L4_PCLK1_FREQUENCY == 16000000)
+#if defined(STM32L4_I2C_USE_HSI16)
+      i2cclk_mhz = 16;
+#elif defined(CONFIG_STM32L4_DVFS)
+      /* PCLK1 follows the DVFS performance level */
+
+      i2cclk_mhz = stm32l4_dvfs_scale(STM32L4_PCLK1_FREQUENCY) / 1000000;
+#elif STM32L4_PCLK1_FREQUENCY == 16000000
       i2cclk_mhz = 16;
 #elif STM32L4_PCLK1_FREQUENCY == 48000000
       i2cclk_mhz = 48;
@@ -1431,6 +1548,49 @@ static void stm32l4_i2c_setclock(struct stm32l4_i2c_priv_s *priv,
               scl_l_period = 162;
             }
         }
+      else if (i2cclk_mhz == 24)
+        {
+          /*  The Speed and timing calculation are based on the following
+           *  fI2CCLK = PCLK and is 24 MHz (low DVFS level of a 120 MHz
+           *  board)
+           *  Analog filter is on,
+           *  Digital filter off
+           *  tPRESC is 250 ns for 10 and 100 KHz and 125 ns otherwise
+           */
+
+          if (frequency == 100000)
+            {
+              presc        = 5;
+              scl_delay    = 4;
+              sda_delay    = 2;
+              scl_h_period = 15;
+              scl_l_period = 19;
+            }
+          else if (frequency == 400000)
+            {
+              presc        = 2;
+              scl_delay    = 3;
+              sda_delay    = 2;
+              scl_h_period = 3;
+              scl_l_period = 9;
+            }
+          else if (frequency == 1000000)
+            {
+              presc        = 2;
+              scl_delay    = 1;
+              sda_delay    = 0;
+              scl_h_period = 1;
+              scl_l_period = 3;
+            }
+          else
+            {
+              presc        = 5;
+              scl_delay    = 4;
+              sda_delay    = 2;
+              scl_h_period = 195;
+              scl_l_period = 199;
+            }
+        }
       else if (i2cclk_mhz == 48)
         {
           if (frequency == 100000)
@@ -1552,6 +1712,10 @@ void stm32l4_i2c_sendstart(struct stm32l4_i2c_priv_s *priv)
       priv->astart = true;
     }
 
+  /* Hand the message payload to DMA if it is large enough */
+
+  stm32l4_i2c_dmasetup(priv);
+
   /* Enabling RELOAD allows the transfer of:
    *
    *  - individual messages with a payload exceeding 255 bytes
@@ -1675,6 +1839,129 @@ void stm32l4_i2c_clearinterrupts(struct stm32l4_i2c_priv_s *priv)
                           0, I2C_ICR_CLEARMASK);
 }
 
+/****************************************************************************
+ * Name: stm32l4_i2c_dmasetup
+ *
+ * Description:
+ *   Start DMA for the payload of the current message (ptr, dcnt, flags) if
+ *   the bus has DMA channels, the message is at least
+ *   CONFIG_STM32L4_I2C_DMATHRESHOLD bytes long and the buffer is DMA
+ *   capable.  The TXIS/RXNE interrupts are disabled while DMA serves the
+ *   requests; otherwise they are restored for interrupt driven transfer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_I2C_DMA
+static void stm32l4_i2c_dmasetup(struct stm32l4_i2c_priv_s *priv)
+{
+  DMA_HANDLE dma;
+  uint32_t paddr;
+  uint32_t ccr;
+  uint32_t dmaen;
+
+  /* Stop the DMA of the previous message, if any */
+
+  if (priv->dma != NULL)
+    {
+      stm32l4_i2c_dmastop(priv);
+#ifndef CONFIG_I2C_POLLED
+      stm32l4_i2c_modifyreg32(priv, STM32L4_I2C_CR1_OFFSET, 0,
+                              I2C_CR1_TXRX);
+#endif
+    }
+
+  if (priv->dcnt < CONFIG_STM32L4_I2C_DMATHRESHOLD)
+    {
+      return;
+    }
+
+  if ((priv->flags & I2C_M_READ) != 0)
+    {
+      dma   = priv->rxdma;
+      paddr = priv->config->base + STM32L4_I2C_RXDR_OFFSET;
+      ccr   = I2C_RXDMA_CONFIG;
+      dmaen = I2C_CR1_RXDMAEN;
+    }
+  else
+    {
+      dma   = priv->txdma;
+      paddr = priv->config->base + STM32L4_I2C_TXDR_OFFSET;
+      ccr   = I2C_TXDMA_CONFIG;
+      dmaen = I2C_CR1_TXDMAEN;
+    }
+
+  if (dma == NULL)
+    {
+      return;
+    }
+
+#ifdef CONFIG_STM32L4_DMACAPABLE
+  if (!stm32l4_dmacapable((uint32_t)priv->ptr, priv->dcnt, ccr))
+    {
+      return;
+    }
+#endif
+
+  i2cinfo("DMA: dcnt=%i flags=0x%04x\n", priv->dcnt, priv->flags);
+
+  /* The whole message is programmed at once; NBYTES/RELOAD handling in
+   * the TCR handler only paces the I2C side of the transfer.  Completion
+   * is detected through TC/TCR, so no DMA callback is needed.
+   */
+
+  stm32l4_dmasetup(dma, paddr, (uint32_t)priv->ptr, priv->dcnt, ccr);
+  stm32l4_i2c_modifyreg32(priv, STM32L4_I2C_CR1_OFFSET, I2C_CR1_TXRX,
+                          dmaen);
+  stm32l4_dmastart(dma, NULL, NULL, false);
+
+  priv->dma = dma;
+}
+#endif
+
+/****************************************************************************
+ * Name: stm32l4_i2c_dmaupdate
+ *
+ * Description:
+ *   On a TC or TCR event, update the byte count of the current message from
+ *   the DMA residual.  Reaching TC/TCR also proves that the address was
+ *   acknowledged, which the TXIS handler would otherwise record.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_I2C_DMA
+static void stm32l4_i2c_dmaupdate(struct stm32l4_i2c_priv_s *priv)
+{
+  if (priv->dma != NULL)
+    {
+      priv->dcnt   = stm32l4_dmaresidual(priv->dma);
+      priv->ptr    = priv->msgv->buffer + priv->msgv->length - priv->dcnt;
+      priv->astart = false;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: stm32l4_i2c_dmastop
+ *
+ * Description:
+ *   Stop the DMA of the current message, if any, and disable the DMA
+ *   requests of the peripheral.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_I2C_DMA
+static void stm32l4_i2c_dmastop(struct stm32l4_i2c_priv_s *priv)
+{
+  if (priv->dma != NULL)
+    {
+      stm32l4_dmastop(priv->dma);
+      stm32l4_i2c_modifyreg32(priv, STM32L4_I2C_CR1_OFFSET,
+                              I2C_CR1_RXDMAEN | I2C_CR1_TXDMAEN, 0);
+      priv->dma = NULL;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: stm32l4_i2c_isr_process
  *
@@ -1812,7 +2099,7 @@ static int stm32l4_i2c_isr_process(struct stm32l4_i2c_priv_s *priv)
    * the message have been transferred.
    */
 
-  else if ((priv->flags & (I2C_M_READ)) == 0 &&
+  else if ((priv->flags & (I2C_M_READ)) == 0 && !I2C_DMA_ACTIVE(priv) &&
            (status & (I2C_ISR_TXIS)) != 0)
     {
       /* TXIS interrupt occurred, address valid, ready to transmit */
@@ -1919,7 +2206,8 @@ static int stm32l4_i2c_isr_process(struct stm32l4_i2c_priv_s *priv)
    * RXNE events to continue until all bytes have been transferred.
    */
 
-  else if ((priv->flags & (I2C_M_READ)) != 0 && (status & I2C_ISR_RXNE) != 0)
+  else if ((priv->flags & (I2C_M_READ)) != 0 && !I2C_DMA_ACTIVE(priv) &&
+           (status & I2C_ISR_RXNE) != 0)
     {
       /* When read flag is set and the receive buffer is not empty
        * (RXNE is set) then the driver can read from the data register.
@@ -2011,6 +2299,10 @@ static int stm32l4_i2c_isr_process(struct stm32l4_i2c_priv_s *priv)
 
   else if ((status & I2C_ISR_TC) != 0)
     {
+      /* If DMA moved the message bytes, account for them now */
+
+      stm32l4_i2c_dmaupdate(priv);
+
       i2cinfo("TC: ENTER dcnt = %i msgc = %i status 0x%08" PRIx32 "\n",
               priv->dcnt, priv->msgc, status);
 
@@ -2109,6 +2401,8 @@ static int stm32l4_i2c_isr_process(struct stm32l4_i2c_priv_s *priv)
 
   else if ((status & I2C_ISR_TCR) != 0)
     {
+      stm32l4_i2c_dmaupdate(priv);
+
       i2cinfo("TCR: ENTER dcnt = %i msgc = %i status 0x%08" PRIx32 "\n",
               priv->dcnt, priv->msgc, status);
 
@@ -2130,6 +2424,8 @@ static int stm32l4_i2c_isr_process(struct stm32l4_i2c_priv_s *priv)
           priv->dcnt   = priv->msgv->length;
           priv->flags  = priv->msgv->flags;
 
+          stm32l4_i2c_dmasetup(priv);
+
           /* if this is the last message, disable reload so the
            * TC event fires next time.
            */
@@ -2266,6 +2562,8 @@ static int stm32l4_i2c_isr_process(struct stm32l4_i2c_priv_s *priv)
 
       priv->msgv = NULL;
 
+      stm32l4_i2c_dmastop(priv);
+
 #ifdef CONFIG_I2C_POLLED
       priv->intstate = INTSTATE_DONE;
 #else
@@ -2377,6 +2675,22 @@ static int stm32l4_i2c_init(struct stm32l4_i2c_priv_s *priv)
    * - Make clock source Kconfigurable (currently PCLK = 80 MHz)
    */
 
+#ifdef CONFIG_STM32L4_I2C_DMA
+  /* Allocate the DMA channels of this bus.  They are held while the bus
+   * is initialized.
+   */
+
+  if (priv->config->rxdma_channel != 0)
+    {
+      priv->rxdma = stm32l4_dmachannel(priv->config->rxdma_channel);
+    }
+
+  if (priv->config->txdma_channel != 0)
+    {
+      priv->txdma = stm32l4_dmachannel(priv->config->txdma_channel);
+    }
+#endif
+
   /* Force a frequency update */
 
   priv->frequency = 0;
@@ -2418,6 +2732,22 @@ static int stm32l4_i2c_deinit(struct stm32l4_i2c_priv_s *priv)
   irq_detach(priv->config->er_irq);
 #endif
 
+#ifdef CONFIG_STM32L4_I2C_DMA
+  /* Release the DMA channels */
+
+  if (priv->rxdma != NULL)
+    {
+      stm32l4_dmafree(priv->rxdma);
+      priv->rxdma = NULL;
+    }
+
+  if (priv->txdma != NULL)
+    {
+      stm32l4_dmafree(priv->txdma);
+      priv->txdma = NULL;
+    }
+#endif
+
   /* Disable clocking */
 
 #ifdef CONFIG_STM32L4_I2C4
@@ -2509,6 +2839,10 @@ static int stm32l4_i2c_process(struct i2c_master_s *dev,
 
   waitrc = stm32l4_i2c_sem_waitdone(priv);
 
+  /* Make sure that no DMA is left running after a timeout */
+
+  stm32l4_i2c_dmastop(priv);
+
   cr1 = stm32l4_i2c_getreg32(priv, STM32L4_I2C_CR1_OFFSET);
   cr2 = stm32l4_i2c_getreg32(priv, STM32L4_I2C_CR2_OFFSET);
 #if !defined(CONFIG_DEBUG_I2C)
@@ -2665,7 +2999,6 @@ static int stm32l4_i2c_process(struct i2c_master_s *dev,
   /* Dump the trace result */
 
   stm32l4_i2c_tracedump(priv);
-  nxmutex_unlock(&priv->lock);
 
   return -errval;
 }
@@ -2694,11 +3027,32 @@ static int stm32l4_i2c_transfer(struct i2c_master_s *dev,
   if (ret >= 0)
     {
       ret = stm32l4_i2c_process(dev, msgs, count);
+      nxmutex_unlock(&priv->lock);
     }
 
   return ret;
 }
 
+/****************************************************************************
+ * Name: stm32l4_i2c_worker
+ *
+ * Description:
+ *   Execute an asynchronous request on the HP work queue and report its
+ *   completion
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_I2C_ASYNC
+static void stm32l4_i2c_worker(void *arg)
+{
+  struct stm32l4_i2c_req_s *req = (struct stm32l4_i2c_req_s *)arg;
+
+  req->result = stm32l4_i2c_transfer_batch(req->dev, req->xfers,
+                                           req->nxfers);
+  req->callback(req, req->arg);
+}
+#endif
+
 /****************************************************************************
  * Name: stm32l4_i2c_reset
  *
@@ -2904,6 +3258,59 @@ static int stm32l4_i2c_pm_prepare(struct pm_callback_s *cb, int domain,
 }
 #endif
 
+/****************************************************************************
+ * Name: stm32l4_i2c_dvfs_prepare
+ *
+ * Description:
+ *   Refuse a SYSCLK change while the bus is locked for a transfer, or if
+ *   there are no timings for the resulting PCLK1.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_DVFS
+static int stm32l4_i2c_dvfs_prepare(struct stm32l4_dvfs_callback_s *cb,
+                                    uint32_t sysclk)
+{
+  struct stm32l4_i2c_priv_s *priv =
+                           (struct stm32l4_i2c_priv_s *)((char *)cb -
+                            offsetof(struct stm32l4_i2c_priv_s, dvfs_cb));
+#ifndef STM32L4_I2C_USE_HSI16
+  uint32_t i2cclk_mhz;
+
+  i2cclk_mhz = ((uint64_t)STM32L4_PCLK1_FREQUENCY * sysclk /
+                STM32L4_SYSCLK_FREQUENCY) / 1000000;
+  if (i2cclk_mhz != 16 && i2cclk_mhz != 24 && i2cclk_mhz != 48 &&
+      i2cclk_mhz != 80 && i2cclk_mhz != 120)
+    {
+      return -ENOTSUP;
+    }
+#endif
+
+  return nxmutex_is_locked(&priv->lock) ? -EBUSY : OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: stm32l4_i2c_dvfs_notify
+ *
+ * Description:
+ *   Force the bus timings to be recomputed for the new PCLK1 by the next
+ *   transfer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_DVFS
+static void stm32l4_i2c_dvfs_notify(struct stm32l4_dvfs_callback_s *cb,
+                                    uint32_t sysclk)
+{
+  struct stm32l4_i2c_priv_s *priv =
+                           (struct stm32l4_i2c_priv_s *)((char *)cb -
+                            offsetof(struct stm32l4_i2c_priv_s, dvfs_cb));
+
+  priv->frequency = 0;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -2974,6 +3381,11 @@ struct i2c_master_s *stm32l4_i2cbus_initialize(int port)
       /* Register to receive power management callbacks */
 
       DEBUGVERIFY(pm_register(&priv->pm_cb));
+#endif
+#ifdef CONFIG_STM32L4_DVFS
+      /* Register to follow PCLK1 frequency changes */
+
+      stm32l4_dvfs_register(&priv->dvfs_cb);
 #endif
     }
 
@@ -3016,6 +3428,9 @@ int stm32l4_i2cbus_uninitialize(struct i2c_master_s *dev)
 
   pm_unregister(&priv->pm_cb);
 #endif
+#ifdef CONFIG_STM32L4_DVFS
+  stm32l4_dvfs_unregister(&priv->dvfs_cb);
+#endif
 
   /* Disable power and other HW resource (GPIO's) */
 
@@ -3026,4 +3441,97 @@ int stm32l4_i2cbus_uninitialize(struct i2c_master_s *dev)
   return OK;
 }
 
+/****************************************************************************
+ * Name: stm32l4_i2c_transfer_batch
+ *
+ * Description:
+ *   Execute a list of I2C transactions while holding the bus lock
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_I2C_ASYNC
+int stm32l4_i2c_transfer_batch(struct i2c_master_s *dev,
+                               struct stm32l4_i2c_xfer_s *xfers,
+                               unsigned int nxfers)
+{
+  struct stm32l4_i2c_priv_s *priv;
+  unsigned int i;
+  int result = OK;
+  int ret;
+
+  DEBUGASSERT(dev);
+  priv = ((struct stm32l4_i2c_inst_s *)dev)->priv;
+
+  if (xfers == NULL || nxfers == 0)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Each transaction is framed by its own START and STOP, but the bus is
+   * not released to other users in between.  A failing device does not
+   * prevent the transactions that follow it from being executed.
+   */
+
+  for (i = 0; i < nxfers; i++)
+    {
+      if (xfers[i].msgv == NULL || xfers[i].msgc <= 0)
+        {
+          xfers[i].result = -EINVAL;
+        }
+      else
+        {
+          xfers[i].result = stm32l4_i2c_process(dev, xfers[i].msgv,
+                                                xfers[i].msgc);
+        }
+
+      if (xfers[i].result < 0 && result == OK)
+        {
+          result = xfers[i].result;
+        }
+    }
+
+  nxmutex_unlock(&priv->lock);
+  return result;
+}
+#endif
+
+/****************************************************************************
+ * Name: stm32l4_i2c_submit
+ *
+ * Description:
+ *   Queue an asynchronous request for execution on the HP work queue
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_I2C_ASYNC
+int stm32l4_i2c_submit(struct i2c_master_s *dev,
+                       struct stm32l4_i2c_req_s *req)
+{
+  DEBUGASSERT(dev != NULL && req != NULL);
+
+  if (req->callback == NULL || req->xfers == NULL || req->nxfers == 0)
+    {
+      return -EINVAL;
+    }
+
+  /* The request structure is owned by the driver until the callback runs */
+
+  if (!work_available(&req->work))
+    {
+      return -EBUSY;
+    }
+
+  req->dev    = dev;
+  req->result = -EINPROGRESS;
+
+  return work_queue(HPWORK, &req->work, stm32l4_i2c_worker, req, 0);
+}
+#endif
+
 #endif /* CONFIG_STM32L4_I2C1 || CONFIG_STM32L4_I2C2 || CONFIG_STM32L4_I2C3 || CONFIG_STM32L4_I2C4 */
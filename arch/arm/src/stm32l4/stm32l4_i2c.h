@@ -27,6 +27,9 @@
 
 #include <nuttx/config.h>
 #include <nuttx/i2c/i2c_master.h>
+#ifdef CONFIG_STM32L4_I2C_ASYNC
+#  include <nuttx/wqueue.h>
+#endif
 
 #include "chip.h"
 #include "hardware/stm32l4_i2c.h"
@@ -46,6 +49,47 @@
 #  endif
 #endif
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_I2C_ASYNC
+/* One I2C transaction: a message list framed by START and STOP, exactly as
+ * it would be passed to I2C_TRANSFER().  Messages may address different
+ * devices.
+ */
+
+struct stm32l4_i2c_xfer_s
+{
+  struct i2c_msg_s *msgv;             /* Messages of this transaction */
+  int               msgc;             /* Number of messages */
+  int               result;           /* OK or negated errno on completion */
+};
+
+/* Asynchronous request.  The caller fills in xfers, nxfers, callback and
+ * arg; the structure must stay valid and unmodified until the callback
+ * has been called.
+ */
+
+struct stm32l4_i2c_req_s;
+typedef void (*stm32l4_i2c_callback_t)(struct stm32l4_i2c_req_s *req,
+                                       void *arg);
+
+struct stm32l4_i2c_req_s
+{
+  struct stm32l4_i2c_xfer_s *xfers;  /* Transactions to execute in order */
+  unsigned int           nxfers;     /* Number of transactions */
+  stm32l4_i2c_callback_t callback;   /* Called on the HP work queue */
+  void                  *arg;        /* Argument passed to the callback */
+  int                    result;     /* First error, or OK */
+
+  /* Driver internal */
+
+  struct work_s          work;
+  struct i2c_master_s   *dev;
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -86,4 +130,51 @@ struct i2c_master_s *stm32l4_i2cbus_initialize(int port);
 
 int stm32l4_i2cbus_uninitialize(struct i2c_master_s *dev);
 
+/****************************************************************************
+ * Name: stm32l4_i2c_transfer_batch
+ *
+ * Description:
+ *   Execute a list of transactions back to back without releasing the bus
+ *   lock in between.  Every transaction is attempted; the result of each
+ *   is stored in its result field.
+ *
+ * Input Parameters:
+ *   dev    - Device structure as returned by stm32l4_i2cbus_initialize()
+ *   xfers  - Transactions to execute in order
+ *   nxfers - Number of transactions
+ *
+ * Returned Value:
+ *   OK if all transactions succeeded, otherwise the first negated errno
+ *   value reported.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_I2C_ASYNC
+int stm32l4_i2c_transfer_batch(struct i2c_master_s *dev,
+                               struct stm32l4_i2c_xfer_s *xfers,
+                               unsigned int nxfers);
+
+/****************************************************************************
+ * Name: stm32l4_i2c_submit
+ *
+ * Description:
+ *   Queue a request for asynchronous execution and return immediately.  The
+ *   transactions are executed as by stm32l4_i2c_transfer_batch() on the HP
+ *   work queue, and req->callback is then called from the same work queue
+ *   with req->result set.
+ *
+ * Input Parameters:
+ *   dev - Device structure as returned by stm32l4_i2cbus_initialize()
+ *   req - The request to execute
+ *
+ * Returned Value:
+ *   OK if the request was queued; -EINVAL for an incomplete request or
+ *   -EBUSY if req is still queued from a previous submission.
+ *
+ ****************************************************************************/
+
+int stm32l4_i2c_submit(struct i2c_master_s *dev,
+                       struct stm32l4_i2c_req_s *req);
+#endif
+
 #endif /* __ARCH_ARM_SRC_STM32L4_STM32L4_I2C_H */
@@ -34,6 +34,8 @@
 #include "chip.h"
 #include "stm32l4_pm.h"
 #include "stm32l4_rcc.h"
+#include "stm32l4_tickless.h"
+#include "hardware/stm32l4_pwr.h"
 #include "arm_internal.h"
 
 /****************************************************************************
@@ -52,6 +54,35 @@
 #  define END_IDLE()
 #endif
 
+/* A low power mode is only worth entering if the CPU can stay in it for
+ * at least this multiple of its wakeup latency.
+ */
+
+#ifdef CONFIG_STM32L4_IDLE_GOVERNOR
+#  define IDLE_RESIDENCY_FACTOR 2
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_IDLE_GOVERNOR
+/* Wakeup latency of each mode, including the clock restoration */
+
+static const uint32_t g_idle_latency[STM32L4_IDLEMODE_NMODES] =
+{
+  0,
+  CONFIG_STM32L4_IDLE_LPSLEEP_LATENCY,
+  CONFIG_STM32L4_IDLE_STOP0_LATENCY,
+  CONFIG_STM32L4_IDLE_STOP1_LATENCY,
+  CONFIG_STM32L4_IDLE_STOP2_LATENCY
+};
+
+/* Number of stm32l4_idle_stay() constraints held on each mode */
+
+static uint16_t g_idle_stay[STM32L4_IDLEMODE_NMODES];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -149,10 +180,180 @@ static void up_idlepm(void)
 #  define up_idlepm()
 #endif
 
+/****************************************************************************
+ * Name: up_idlegovernor
+ *
+ * Description:
+ *   Sleep in the deepest mode that (1) no driver has excluded with
+ *   stm32l4_idle_stay() and (2) is worth entering before the next alarm
+ *   of the tickless timer.  The alarm interrupt is raised early by the
+ *   wakeup latency of the chosen mode so that the alarm is not delayed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_IDLE_GOVERNOR
+static void up_idlegovernor(void)
+{
+  enum stm32l4_idlemode_e mode;
+  irqstate_t flags;
+  uint32_t remaining;
+  int i;
+
+  flags = enter_critical_section();
+
+  /* The deepest mode allowed by the driver constraints */
+
+  mode = STM32L4_IDLEMODE_STOP2;
+  for (i = STM32L4_IDLEMODE_SLEEP; i < STM32L4_IDLEMODE_STOP2; i++)
+    {
+      if (g_idle_stay[i] > 0)
+        {
+          mode = (enum stm32l4_idlemode_e)i;
+          break;
+        }
+    }
+
+  /* Back off to a shallower mode if the next alarm is too close */
+
+  remaining = stm32l4_tickless_remaining();
+  while (mode > STM32L4_IDLEMODE_SLEEP &&
+         remaining / IDLE_RESIDENCY_FACTOR < g_idle_latency[mode])
+    {
+      mode--;
+    }
+
+  if (mode > STM32L4_IDLEMODE_SLEEP)
+    {
+      stm32l4_tickless_wakeahead(g_idle_latency[mode]);
+    }
+
+  BEGIN_IDLE();
+
+  switch (mode)
+    {
+      case STM32L4_IDLEMODE_SLEEP:
+        asm("WFI");
+        break;
+
+      case STM32L4_IDLEMODE_LPSLEEP:
+
+        /* Run from 2 MHz MSI with the PLL off and the low-power regulator,
+         * then sleep.
+         */
+
+        stm32l4_pmlpr();
+        modifyreg32(STM32L4_RCC_CR, RCC_CR_PLLON, 0);
+
+        asm("WFI");
+
+        /* Leave low-power run before the clocks are raised again */
+
+        modifyreg32(STM32L4_PWR_CR1, PWR_CR1_LPR, 0);
+        while ((getreg32(STM32L4_PWR_SR2) & PWR_SR2_REGLPF) != 0)
+          {
+          }
+
+        stm32l4_clockenable();
+        break;
+
+      case STM32L4_IDLEMODE_STOP0:
+      case STM32L4_IDLEMODE_STOP1:
+        stm32l4_pmstop(mode == STM32L4_IDLEMODE_STOP1);
+        stm32l4_clockenable();
+        break;
+
+      case STM32L4_IDLEMODE_STOP2:
+        stm32l4_pmstop2();
+        stm32l4_clockenable();
+        break;
+
+      default:
+        break;
+    }
+
+  END_IDLE();
+
+  if (mode > STM32L4_IDLEMODE_SLEEP)
+    {
+      stm32l4_tickless_wakeahead(0);
+    }
+
+  /* The wakeup interrupt is taken here */
+
+  leave_critical_section(flags);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_STM32L4_IDLE_GOVERNOR
+/****************************************************************************
+ * Name: stm32l4_idle_stay
+ *
+ * Description:
+ *   Prevent the idle governor from entering any mode deeper than 'mode'.
+ *   Calls nest and must be balanced with stm32l4_idle_relax().
+ *
+ ****************************************************************************/
+
+void stm32l4_idle_stay(enum stm32l4_idlemode_e mode)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(mode < STM32L4_IDLEMODE_NMODES);
+
+  flags = enter_critical_section();
+  DEBUGASSERT(g_idle_stay[mode] < UINT16_MAX);
+  g_idle_stay[mode]++;
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: stm32l4_idle_relax
+ *
+ * Description:
+ *   Release a constraint taken with stm32l4_idle_stay().
+ *
+ ****************************************************************************/
+
+void stm32l4_idle_relax(enum stm32l4_idlemode_e mode)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(mode < STM32L4_IDLEMODE_NMODES);
+
+  flags = enter_critical_section();
+  DEBUGASSERT(g_idle_stay[mode] > 0);
+  g_idle_stay[mode]--;
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: stm32l4_idle_latencymode
+ *
+ * Description:
+ *   Return the deepest mode whose wakeup latency does not exceed 'usec'.
+ *
+ ****************************************************************************/
+
+enum stm32l4_idlemode_e stm32l4_idle_latencymode(uint32_t usec)
+{
+  int i;
+
+  for (i = STM32L4_IDLEMODE_NMODES - 1; i > STM32L4_IDLEMODE_SLEEP; i--)
+    {
+      if (g_idle_latency[i] <= usec)
+        {
+          break;
+        }
+    }
+
+  return (enum stm32l4_idlemode_e)i;
+}
+#endif
+
 /****************************************************************************
  * Name: up_idle
  *
@@ -183,10 +384,14 @@ void up_idle(void)
   /* Sleep until an interrupt occurs to save power. */
 
 #if !(defined(CONFIG_DEBUG_SYMBOLS) && defined(CONFIG_STM32L4_DISABLE_IDLE_SLEEP_DURING_DEBUG))
+#ifdef CONFIG_STM32L4_IDLE_GOVERNOR
+  up_idlegovernor();
+#else
   BEGIN_IDLE();
   asm("WFI");
   END_IDLE();
 #endif
+#endif
 
 #endif
 }
@@ -144,6 +144,7 @@ static int stm32l4_nmi(int irq, void *context, void *arg)
   return 0;
 }
 
+#ifndef CONFIG_SCHED_TASKLET
 static int stm32l4_pendsv(int irq, void *context, void *arg)
 {
   up_irq_save();
@@ -151,6 +152,7 @@ static int stm32l4_pendsv(int irq, void *context, void *arg)
   PANIC();
   return 0;
 }
+#endif
 
 static int stm32l4_dbgmonitor(int irq, void *context, void *arg)
 {
@@ -330,6 +332,12 @@ void up_irqinitialize(void)
   stm32l4_prioritize_syscall(NVIC_SYSH_SVCALL_PRIORITY);
 #endif
 
+#ifdef CONFIG_SCHED_TASKLET
+  /* PendSV runs the tasklets at the lowest priority */
+
+  arm_tasklet_initialize();
+#endif
+
   /* If the MPU is enabled, then attach and enable the Memory Management
    * Fault handler.
    */
@@ -348,7 +356,9 @@ void up_irqinitialize(void)
 #endif
   irq_attach(STM32L4_IRQ_BUSFAULT, arm_busfault, NULL);
   irq_attach(STM32L4_IRQ_USAGEFAULT, arm_usagefault, NULL);
+#ifndef CONFIG_SCHED_TASKLET
   irq_attach(STM32L4_IRQ_PENDSV, stm32l4_pendsv, NULL);
+#endif
   irq_attach(STM32L4_IRQ_DBGMONITOR, stm32l4_dbgmonitor, NULL);
   irq_attach(STM32L4_IRQ_RESERVED, stm32l4_reserved, NULL);
 #endif
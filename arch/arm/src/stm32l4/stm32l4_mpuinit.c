@@ -30,6 +30,8 @@
 #include <nuttx/userspace.h>
 
 #include "mpu.h"
+#include "chip.h"
+#include "hardware/stm32l4_memorymap.h"
 #include "stm32l4_mpuinit.h"
 
 #if defined(CONFIG_BUILD_PROTECTED) && defined(CONFIG_ARM_MPU)
@@ -87,3 +89,44 @@ void stm32l4_mpu_uheap(uintptr_t start, size_t size)
 }
 
 #endif /* CONFIG_BUILD_PROTECTED && CONFIG_ARM_MPU */
+
+#ifdef CONFIG_STM32L4_MPU_MEMMAP
+
+/****************************************************************************
+ * Name: stm32l4_mpu_memmap
+ *
+ * Description:
+ *   Program the memory attributes of the peripherals, SRAM2 and the PSRAM
+ *   and enable the MPU with the default memory map as background region.
+ *
+ ****************************************************************************/
+
+void stm32l4_mpu_memmap(void)
+{
+  /* Peripherals:  Device, shareable, never executed */
+
+  mpu_peripheral(STM32L4_PERIPH_BASE, 512 * 1024 * 1024);
+
+  /* SRAM2 at its code bus alias:  Normal, write-back, not shareable */
+
+  mpu_configure_region(STM32L4_SRAM2_BASE, STM32L4_SRAM2_SIZE,
+                       MPU_RASR_TEX_SO   | /* Normal with C/B     */
+                       MPU_RASR_C        | /* Cacheable           */
+                       MPU_RASR_B        | /* Bufferable          */
+                       MPU_RASR_AP_RWNO);  /* P:RW   U:None       */
+
+#ifdef CONFIG_STM32L4_MPU_PSRAM
+  /* PSRAM:  Normal, write-back, write-allocate, not shareable */
+
+  mpu_configure_region(CONFIG_STM32L4_MPU_PSRAM_BASE,
+                       CONFIG_STM32L4_MPU_PSRAM_SIZE,
+                       MPU_RASR_TEX_NOR  | /* Normal              */
+                       MPU_RASR_C        | /* Cacheable           */
+                       MPU_RASR_B        | /* Bufferable          */
+                       MPU_RASR_AP_RWNO);  /* P:RW   U:None       */
+#endif
+
+  mpu_control(true, false, true);
+}
+
+#endif /* CONFIG_STM32L4_MPU_MEMMAP */
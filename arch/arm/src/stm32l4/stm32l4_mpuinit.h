@@ -26,6 +26,35 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Attributes to place data in the fast SRAM2 section (zeroed at boot) or in
+ * the PSRAM (never initialized) with the MPU memory attribute map.
+ */
+
+#ifdef CONFIG_STM32L4_MPU_MEMMAP
+#  define sram2_fast_data locate_data(".sram2_fast")
+#  define psram_bss_data  locate_data(".psram_bss")
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_MPU_MEMMAP
+/* Section boundaries provided by the board linker script */
+
+extern uint8_t _ssram2_fast[];
+extern uint8_t _esram2_fast[];
+extern uint8_t _spsram_bss[];
+extern uint8_t _epsram_bss[];
+#endif
 
 /****************************************************************************
  * Public Functions Prototypes
@@ -60,4 +89,17 @@ void stm32l4_mpu_uheap(uintptr_t start, size_t size);
 #  define stm32l4_mpu_uheap(start,size)
 #endif
 
+/****************************************************************************
+ * Name: stm32l4_mpu_memmap
+ *
+ * Description:
+ *   Program the memory attributes of the peripherals, SRAM2 and the PSRAM
+ *   and enable the MPU.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_MPU_MEMMAP
+void stm32l4_mpu_memmap(void);
+#endif
+
 #endif /* __ARCH_ARM_SRC_STM32L4_STM32L4_MPUINIT_H */
@@ -0,0 +1,1723 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_octospi.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <arch/board/board.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/spi/qspi.h>
+
+#include "arm_internal.h"
+#include "barriers.h"
+
+#include "stm32l4_gpio.h"
+#include "stm32l4_octospi.h"
+#include "stm32l4_rcc.h"
+#include "hardware/stm32l4xrxx_octospi.h"
+#include "hardware/stm32l4_pinmap.h"
+
+#ifdef CONFIG_STM32L4_OCTOSPI
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* OCTOSPI memory synchronization */
+
+#define MEMORY_SYNC()     do { ARM_DSB(); ARM_ISB(); } while (0)
+
+/* Word alignment of buffers */
+
+#define ALIGN_MASK        3
+#define ALIGN_UP(n)       (((n)+ALIGN_MASK) & ~ALIGN_MASK)
+#define IS_ALIGNED(n)     (((uint32_t)(n) & ALIGN_MASK) == 0)
+
+/* Sanity check that board.h defines requisite OCTOSPI pinmap options.
+ * IO4-IO7 and DQS are optional; without IO4-IO7 only single, dual and quad
+ * transfers are possible.
+ */
+
+#ifdef CONFIG_STM32L4_OCTOSPI1
+#  if !defined(GPIO_OCTOSPI1_NCS) || !defined(GPIO_OCTOSPI1_CLK) || \
+      !defined(GPIO_OCTOSPI1_IO0) || !defined(GPIO_OCTOSPI1_IO1) || \
+      !defined(GPIO_OCTOSPI1_IO2) || !defined(GPIO_OCTOSPI1_IO3)
+#    error you must define GPIO_OCTOSPI1_NCS, _CLK and _IO0-_IO3 in your board.h
+#  endif
+#  if !defined(CONFIG_STM32L4_OCTOSPI1_FLASH_SIZE) || \
+      (CONFIG_STM32L4_OCTOSPI1_FLASH_SIZE & (CONFIG_STM32L4_OCTOSPI1_FLASH_SIZE - 1)) != 0
+#    error CONFIG_STM32L4_OCTOSPI1_FLASH_SIZE must be a power of two
+#  endif
+#endif
+
+#ifdef CONFIG_STM32L4_OCTOSPI2
+#  if !defined(GPIO_OCTOSPI2_NCS) || !defined(GPIO_OCTOSPI2_CLK) || \
+      !defined(GPIO_OCTOSPI2_IO0) || !defined(GPIO_OCTOSPI2_IO1) || \
+      !defined(GPIO_OCTOSPI2_IO2) || !defined(GPIO_OCTOSPI2_IO3)
+#    error you must define GPIO_OCTOSPI2_NCS, _CLK and _IO0-_IO3 in your board.h
+#  endif
+#  if !defined(CONFIG_STM32L4_OCTOSPI2_FLASH_SIZE) || \
+      (CONFIG_STM32L4_OCTOSPI2_FLASH_SIZE & (CONFIG_STM32L4_OCTOSPI2_FLASH_SIZE - 1)) != 0
+#    error CONFIG_STM32L4_OCTOSPI2_FLASH_SIZE must be a power of two
+#  endif
+#endif
+
+#ifndef CONFIG_STM32L4_OCTOSPI_FIFO_THESHOLD
+#  define CONFIG_STM32L4_OCTOSPI_FIFO_THESHOLD 4
+#endif
+
+#ifndef CONFIG_STM32L4_OCTOSPI_CSHT
+#  define CONFIG_STM32L4_OCTOSPI_CSHT 2
+#endif
+
+/* Clocking *****************************************************************/
+
+/* The OCTOSPI kernel clock is selected by RCC_CCIPR2[OSPISEL], SYSCLK after
+ * reset.  A board that selects another source must say so through
+ * BOARD_OCTOSPI_FREQUENCY.  The bus clock is the kernel clock divided by
+ * 1 to 256.
+ */
+
+#ifdef BOARD_OCTOSPI_FREQUENCY
+#  define STM32L4_OCTOSPI_CLOCK  BOARD_OCTOSPI_FREQUENCY
+#else
+#  define STM32L4_OCTOSPI_CLOCK  STM32L4_SYSCLK_FREQUENCY
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of one OCTOSPI controller */
+
+struct stm32l4_octospidev_s
+{
+  struct qspi_dev_s qspi;       /* Externally visible part of the QSPI interface */
+  uint32_t base;                /* OCTOSPI controller register base address */
+  uint32_t membase;             /* Base of the memory mapped window */
+  uint32_t flashsize;           /* Size of the attached device in bytes */
+  uint32_t frequency;           /* Requested clock frequency */
+  uint32_t actual;              /* Actual clock frequency */
+  uint8_t mode;                 /* Mode 0,3 */
+  uint8_t intf;                 /* OCTOSPI controller number (0 or 1) */
+  bool initialized;             /* TRUE: Controller has been initialized */
+  bool memmap;                  /* TRUE: Controller is in memory mapped mode */
+  bool octal;                   /* TRUE: IO4-IO7 are connected */
+  mutex_t lock;                 /* Assures mutually exclusive access */
+
+  /* Debug stuff */
+
+#ifdef CONFIG_STM32L4_OCTOSPI_REGDEBUG
+  bool     wrlast;              /* Last was a write */
+  uint32_t addresslast;         /* Last address */
+  uint32_t valuelast;           /* Last value */
+  int      ntimes;              /* Number of times */
+#endif
+};
+
+/* The OCTOSPI transaction specification
+ *
+ * This is mostly the values of the CCR, TCR, IR, AR, ABR and DLR, broken
+ * out into a C struct since these fields need to be considered at various
+ * phases of the transaction processing activity.
+ */
+
+struct octospi_xctnspec_s
+{
+  uint8_t instrmode;      /* 'instruction mode'; OCTOSPI_LINES_* */
+  uint8_t instrsize;      /* instruction size; OCTOSPI_SIZE_* */
+  uint32_t instr;         /* the Instruction, 8 or 16 bits */
+
+  uint8_t addrmode;       /* 'address mode'; OCTOSPI_LINES_* */
+  uint8_t addrsize;       /* address size (n - 1); 0, 1, 2, 3 */
+  uint32_t addr;          /* the address (if any) (1 to 4 bytes as per addrsize) */
+
+  uint8_t altbytesmode;   /* 'alt bytes mode'; OCTOSPI_LINES_* */
+  uint8_t altbytessize;   /* 'alt bytes' size (n - 1); 0, 1, 2, 3 */
+  uint32_t altbytes;      /* the 'alt bytes' (if any) */
+
+  uint8_t dummycycles;    /* number of Dummy Cycles; 0 - 31 */
+
+  uint8_t datamode;       /* 'data mode'; OCTOSPI_LINES_* */
+  uint32_t datasize;      /* number of data bytes */
+  void *buffer;           /* Data buffer */
+
+  bool isdtr;             /* true if 'double transfer rate' */
+  bool isdqs;             /* true if data is sampled with DQS */
+  bool issioo;            /* true if 'send instruction only once' mode */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Helpers */
+
+#ifdef CONFIG_STM32L4_OCTOSPI_REGDEBUG
+static bool     octospi_checkreg(struct stm32l4_octospidev_s *priv, bool wr,
+                  uint32_t value, uint32_t address);
+#else
+#  define       octospi_checkreg(priv,wr,value,address) (false)
+#endif
+
+static inline uint32_t octospi_getreg(struct stm32l4_octospidev_s *priv,
+                  unsigned int offset);
+static inline void octospi_putreg(struct stm32l4_octospidev_s *priv,
+                  uint32_t value, unsigned int offset);
+
+#ifdef CONFIG_DEBUG_SPI_INFO
+static void     octospi_dumpregs(struct stm32l4_octospidev_s *priv,
+                  const char *msg);
+#else
+#  define       octospi_dumpregs(priv,msg)
+#endif
+
+/* QSPI methods */
+
+static int      octospi_lock(struct qspi_dev_s *dev, bool lock);
+static uint32_t octospi_setfrequency(struct qspi_dev_s *dev,
+                  uint32_t frequency);
+static void     octospi_setmode(struct qspi_dev_s *dev,
+                  enum qspi_mode_e mode);
+static void     octospi_setbits(struct qspi_dev_s *dev, int nbits);
+static int      octospi_command(struct qspi_dev_s *dev,
+                  struct qspi_cmdinfo_s *cmdinfo);
+static int      octospi_memory(struct qspi_dev_s *dev,
+                  struct qspi_meminfo_s *meminfo);
+static void    *octospi_alloc(struct qspi_dev_s *dev, size_t buflen);
+static void     octospi_free(struct qspi_dev_s *dev, void *buffer);
+
+/* Initialization */
+
+static int      octospi_hw_initialize(struct stm32l4_octospidev_s *priv);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* OCTOSPI driver operations */
+
+static const struct qspi_ops_s g_octospiops =
+{
+  .lock              = octospi_lock,
+  .setfrequency      = octospi_setfrequency,
+  .setmode           = octospi_setmode,
+  .setbits           = octospi_setbits,
+#ifdef CONFIG_QSPI_HWFEATURES
+  .hwfeatures        = NULL,
+#endif
+  .command           = octospi_command,
+  .memory            = octospi_memory,
+  .alloc             = octospi_alloc,
+  .free              = octospi_free,
+};
+
+#ifdef CONFIG_STM32L4_OCTOSPI1
+static struct stm32l4_octospidev_s g_octospi1dev =
+{
+  .qspi              =
+  {
+    .ops             = &g_octospiops,
+  },
+  .base              = STM32L4_OCTOSPI1_BASE,
+  .membase           = STM32L4_OCTOSPI1_BANK,
+  .flashsize         = CONFIG_STM32L4_OCTOSPI1_FLASH_SIZE,
+  .intf              = 0,
+#ifdef GPIO_OCTOSPI1_IO7
+  .octal             = true,
+#endif
+  .lock              = NXMUTEX_INITIALIZER,
+};
+#endif
+
+#ifdef CONFIG_STM32L4_OCTOSPI2
+static struct stm32l4_octospidev_s g_octospi2dev =
+{
+  .qspi              =
+  {
+    .ops             = &g_octospiops,
+  },
+  .base              = STM32L4_OCTOSPI2_BASE,
+  .membase           = STM32L4_OCTOSPI2_BANK,
+  .flashsize         = CONFIG_STM32L4_OCTOSPI2_FLASH_SIZE,
+  .intf              = 1,
+#ifdef GPIO_OCTOSPI2_IO7
+  .octal             = true,
+#endif
+  .lock              = NXMUTEX_INITIALIZER,
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: octospi_checkreg
+ *
+ * Description:
+ *   Check if the current register access is a duplicate of the preceding.
+ *
+ * Input Parameters:
+ *   value   - The value to be written
+ *   address - The address of the register to write to
+ *
+ * Returned Value:
+ *   true:  This is the first register access of this type.
+ *   false: This is the same as the preceding register access.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_OCTOSPI_REGDEBUG
+static bool octospi_checkreg(struct stm32l4_octospidev_s *priv, bool wr,
+                             uint32_t value, uint32_t address)
+{
+  if (wr      == priv->wrlast &&     /* Same kind of access? */
+      value   == priv->valuelast &&  /* Same value? */
+      address == priv->addresslast)  /* Same address? */
+    {
+      /* Yes, then just keep a count of the number of times we did this. */
+
+      priv->ntimes++;
+      return false;
+    }
+  else
+    {
+      /* Did we do the previous operation more than once? */
+
+      if (priv->ntimes > 0)
+        {
+          /* Yes... show how many times we did it */
+
+          spiinfo("...[Repeats %d times]...\n", priv->ntimes);
+        }
+
+      /* Save information about the new access */
+
+      priv->wrlast      = wr;
+      priv->valuelast   = value;
+      priv->addresslast = address;
+      priv->ntimes      = 0;
+    }
+
+  /* Return true if this is the first time that we have done this operation */
+
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Name: octospi_getreg
+ *
+ * Description:
+ *  Read an OCTOSPI register
+ *
+ ****************************************************************************/
+
+static inline uint32_t octospi_getreg(struct stm32l4_octospidev_s *priv,
+                                      unsigned int offset)
+{
+  uint32_t address = priv->base + offset;
+  uint32_t value = getreg32(address);
+
+#ifdef CONFIG_STM32L4_OCTOSPI_REGDEBUG
+  if (octospi_checkreg(priv, false, value, address))
+    {
+      spiinfo("%08" PRIx32 "->%08" PRIx32 "\n", address, value);
+    }
+#endif
+
+  return value;
+}
+
+/****************************************************************************
+ * Name: octospi_putreg
+ *
+ * Description:
+ *  Write a value to an OCTOSPI register
+ *
+ ****************************************************************************/
+
+static inline void octospi_putreg(struct stm32l4_octospidev_s *priv,
+                                  uint32_t value, unsigned int offset)
+{
+  uint32_t address = priv->base + offset;
+
+#ifdef CONFIG_STM32L4_OCTOSPI_REGDEBUG
+  if (octospi_checkreg(priv, true, value, address))
+    {
+      spiinfo("%08" PRIx32 "<-%08" PRIx32 "\n", address, value);
+    }
+#endif
+
+  putreg32(value, address);
+}
+
+/****************************************************************************
+ * Name: octospi_dumpregs
+ *
+ * Description:
+ *   Dump the contents of the main OCTOSPI registers
+ *
+ * Input Parameters:
+ *   priv - The OCTOSPI controller to dump
+ *   msg - Message to print before the register data
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEBUG_SPI_INFO
+static void octospi_dumpregs(struct stm32l4_octospidev_s *priv,
+                             const char *msg)
+{
+  spiinfo("%s:\n", msg);
+  spiinfo("   CR:%08" PRIx32 "  DCR1:%08" PRIx32 "  DCR2:%08" PRIx32
+          "   SR:%08" PRIx32 "\n",
+          getreg32(priv->base + STM32L4_OCTOSPI_CR_OFFSET),
+          getreg32(priv->base + STM32L4_OCTOSPI_DCR1_OFFSET),
+          getreg32(priv->base + STM32L4_OCTOSPI_DCR2_OFFSET),
+          getreg32(priv->base + STM32L4_OCTOSPI_SR_OFFSET));
+  spiinfo("  CCR:%08" PRIx32 "   TCR:%08" PRIx32 "    IR:%08" PRIx32
+          "  DLR:%08" PRIx32 "\n",
+          getreg32(priv->base + STM32L4_OCTOSPI_CCR_OFFSET),
+          getreg32(priv->base + STM32L4_OCTOSPI_TCR_OFFSET),
+          getreg32(priv->base + STM32L4_OCTOSPI_IR_OFFSET),
+          getreg32(priv->base + STM32L4_OCTOSPI_DLR_OFFSET));
+  spiinfo("   AR:%08" PRIx32 "  LPTR:%08" PRIx32 "  P1CR:%08" PRIx32
+          " P2CR:%08" PRIx32 "\n",
+          getreg32(priv->base + STM32L4_OCTOSPI_AR_OFFSET),
+          getreg32(priv->base + STM32L4_OCTOSPI_LPTR_OFFSET),
+          getreg32(STM32L4_OCTOSPIM_P1CR),
+          getreg32(STM32L4_OCTOSPIM_P2CR));
+}
+#endif
+
+/****************************************************************************
+ * Name: octospi_addrsize
+ *
+ * Description:
+ *   Convert an address length in bytes to the ADSIZE encoding
+ *
+ * Input Parameters:
+ *   addrlen - Address length in bytes (1 to 4)
+ *
+ * Returned Value:
+ *   The ADSIZE value, or -EINVAL if the length is not supported
+ *
+ ****************************************************************************/
+
+static int octospi_addrsize(uint8_t addrlen)
+{
+  if (addrlen < 1 || addrlen > 4)
+    {
+      return -EINVAL;
+    }
+
+  return addrlen - 1;
+}
+
+/****************************************************************************
+ * Name: octospi_setupxctnfromcmd
+ *
+ * Description:
+ *   Setup our transaction descriptor from a command info structure
+ *
+ * Input Parameters:
+ *   xctn  - the transaction descriptor we setup
+ *   cmdinfo  - the command info (originating from the MTD device)
+ *
+ * Returned Value:
+ *   OK, or -errno if invalid
+ *
+ ****************************************************************************/
+
+static int octospi_setupxctnfromcmd(struct octospi_xctnspec_s *xctn,
+                                    const struct qspi_cmdinfo_s *cmdinfo)
+{
+  int ret;
+
+  DEBUGASSERT(xctn != NULL && cmdinfo != NULL);
+
+#ifdef CONFIG_DEBUG_SPI_INFO
+  spiinfo("Transfer:\n");
+  spiinfo("  flags: %02x\n", cmdinfo->flags);
+  spiinfo("  cmd: %04x\n", cmdinfo->cmd);
+
+  if (QSPICMD_ISADDRESS(cmdinfo->flags))
+    {
+      spiinfo("  address/length: %08lx/%d\n",
+              (unsigned long)cmdinfo->addr, cmdinfo->addrlen);
+    }
+
+  if (QSPICMD_ISDATA(cmdinfo->flags))
+    {
+      spiinfo("  %s Data:\n",
+              QSPICMD_ISWRITE(cmdinfo->flags) ? "Write" : "Read");
+      spiinfo("    buffer/length: %p/%d\n",
+              cmdinfo->buffer, cmdinfo->buflen);
+    }
+#endif
+
+  DEBUGASSERT(cmdinfo->cmd < 256);
+
+  memset(xctn, 0, sizeof(struct octospi_xctnspec_s));
+
+  /* Specify the instruction as per command info.  Commands use the same
+   * number of lines for all phases.
+   */
+
+  if (QSPICMD_ISIQUAD(cmdinfo->flags))
+    {
+      xctn->instrmode = OCTOSPI_LINES_QUAD;
+    }
+  else if (QSPICMD_ISIDUAL(cmdinfo->flags))
+    {
+      xctn->instrmode = OCTOSPI_LINES_DUAL;
+    }
+  else
+    {
+      xctn->instrmode = OCTOSPI_LINES_SINGLE;
+    }
+
+  xctn->instrsize = OCTOSPI_SIZE_8;
+  xctn->instr     = cmdinfo->cmd;
+
+  /* Specify the address size as needed */
+
+  if (QSPICMD_ISADDRESS(cmdinfo->flags))
+    {
+      ret = octospi_addrsize(cmdinfo->addrlen);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      xctn->addrmode = xctn->instrmode;
+      xctn->addrsize = ret;
+      xctn->addr     = cmdinfo->addr;
+    }
+
+  /* Specify the data as needed */
+
+  xctn->buffer = cmdinfo->buffer;
+  if (QSPICMD_ISDATA(cmdinfo->flags))
+    {
+      xctn->datamode = xctn->instrmode;
+      xctn->datasize = cmdinfo->buflen;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: octospi_setupxctnfrommem
+ *
+ * Description:
+ *   Setup our transaction descriptor from a memory info structure
+ *
+ * Input Parameters:
+ *   xctn  - the transaction descriptor we setup
+ *   meminfo  - the memory info (originating from the MTD device)
+ *   xflags - OCTOSPI_XIP_* options (memory mapped mode only)
+ *
+ * Returned Value:
+ *   OK, or -errno if invalid
+ *
+ ****************************************************************************/
+
+static int octospi_setupxctnfrommem(struct octospi_xctnspec_s *xctn,
+                                    const struct qspi_meminfo_s *meminfo,
+                                    uint32_t xflags)
+{
+  int ret;
+
+  DEBUGASSERT(xctn != NULL && meminfo != NULL);
+
+#ifdef CONFIG_DEBUG_SPI_INFO
+  spiinfo("Transfer:\n");
+  spiinfo("  flags: %02x xflags: %02" PRIx32 "\n", meminfo->flags, xflags);
+  spiinfo("  cmd: %04x\n", meminfo->cmd);
+  spiinfo("  address/length: %08lx/%d\n",
+          (unsigned long)meminfo->addr, meminfo->addrlen);
+  spiinfo("  %s Data:\n",
+          QSPIMEM_ISWRITE(meminfo->flags) ? "Write" : "Read");
+  spiinfo("    buffer/length: %p/%d\n", meminfo->buffer, meminfo->buflen);
+#endif
+
+  DEBUGASSERT(meminfo->cmd < 256);
+
+  memset(xctn, 0, sizeof(struct octospi_xctnspec_s));
+
+  ret = octospi_addrsize(meminfo->addrlen);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  xctn->addrsize    = ret;
+  xctn->addr        = meminfo->addr;
+  xctn->dummycycles = meminfo->dummies;
+  xctn->buffer      = meminfo->buffer;
+  xctn->datasize    = meminfo->buflen;
+  xctn->instrsize   = OCTOSPI_SIZE_8;
+  xctn->instr       = meminfo->cmd;
+
+  if ((xflags & OCTOSPI_XIP_OCTAL) != 0)
+    {
+      /* Octal (OPI) mode: every phase on eight lines */
+
+      xctn->instrmode = OCTOSPI_LINES_OCTAL;
+      xctn->addrmode  = OCTOSPI_LINES_OCTAL;
+      xctn->datamode  = OCTOSPI_LINES_OCTAL;
+    }
+  else
+    {
+      if (QSPIMEM_ISIQUAD(meminfo->flags))
+        {
+          xctn->instrmode = OCTOSPI_LINES_QUAD;
+        }
+      else if (QSPIMEM_ISIDUAL(meminfo->flags))
+        {
+          xctn->instrmode = OCTOSPI_LINES_DUAL;
+        }
+      else
+        {
+          xctn->instrmode = OCTOSPI_LINES_SINGLE;
+        }
+
+      if (QSPIMEM_ISQUADIO(meminfo->flags))
+        {
+          xctn->addrmode = OCTOSPI_LINES_QUAD;
+          xctn->datamode = OCTOSPI_LINES_QUAD;
+        }
+      else if (QSPIMEM_ISDUALIO(meminfo->flags))
+        {
+          xctn->addrmode = OCTOSPI_LINES_DUAL;
+          xctn->datamode = OCTOSPI_LINES_DUAL;
+        }
+      else
+        {
+          xctn->addrmode = OCTOSPI_LINES_SINGLE;
+          xctn->datamode = OCTOSPI_LINES_SINGLE;
+        }
+    }
+
+  if ((xflags & OCTOSPI_XIP_CMD16) != 0)
+    {
+      /* Instruction followed by its complement, as used by octal flash */
+
+      xctn->instrsize = OCTOSPI_SIZE_16;
+      xctn->instr     = ((uint32_t)meminfo->cmd << 8) |
+                        (~meminfo->cmd & 0xff);
+    }
+
+  xctn->isdtr = (xflags & OCTOSPI_XIP_DTR) != 0;
+  xctn->isdqs = (xflags & OCTOSPI_XIP_DQS) != 0;
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: octospi_waitstatusflags
+ *
+ * Description:
+ *   Spin wait for specified status flags to be set as desired
+ *
+ * Input Parameters:
+ *   priv  - The OCTOSPI controller
+ *   mask  - bits to check, can be multiple
+ *   polarity - true wait if any set, false to wait if all reset
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void octospi_waitstatusflags(struct stm32l4_octospidev_s *priv,
+                                    uint32_t mask, int polarity)
+{
+  if (polarity)
+    {
+      while ((octospi_getreg(priv, STM32L4_OCTOSPI_SR_OFFSET) & mask) == 0);
+    }
+  else
+    {
+      while ((octospi_getreg(priv, STM32L4_OCTOSPI_SR_OFFSET) & mask) != 0);
+    }
+}
+
+/****************************************************************************
+ * Name: octospi_abort
+ *
+ * Description:
+ *   Abort any transaction in progress and wait until the controller is idle
+ *
+ * Input Parameters:
+ *   priv  - The OCTOSPI controller
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void octospi_abort(struct stm32l4_octospidev_s *priv)
+{
+  uint32_t regval;
+
+  regval  = octospi_getreg(priv, STM32L4_OCTOSPI_CR_OFFSET);
+  regval |= OCTOSPI_CR_ABORT;
+  octospi_putreg(priv, regval, STM32L4_OCTOSPI_CR_OFFSET);
+
+  octospi_waitstatusflags(priv, OCTOSPI_SR_BUSY, 0);
+}
+
+/****************************************************************************
+ * Name: octospi_ccrvalue
+ *
+ * Description:
+ *   Build the CCR (or WCCR) value of a transaction descriptor
+ *
+ ****************************************************************************/
+
+static uint32_t octospi_ccrvalue(const struct octospi_xctnspec_s *xctn)
+{
+  uint32_t regval;
+
+  regval = OCTOSPI_CCR_IMODE(xctn->instrmode) |
+           OCTOSPI_CCR_ISIZE(xctn->instrsize) |
+           OCTOSPI_CCR_ADMODE(xctn->addrmode) |
+           OCTOSPI_CCR_ADSIZE(xctn->addrsize) |
+           OCTOSPI_CCR_ABMODE(xctn->altbytesmode) |
+           OCTOSPI_CCR_ABSIZE(xctn->altbytessize) |
+           OCTOSPI_CCR_DMODE(xctn->datamode);
+
+  if (xctn->isdtr)
+    {
+      /* The instruction phase is only sent in DTR in octal mode */
+
+      if (xctn->instrmode == OCTOSPI_LINES_OCTAL)
+        {
+          regval |= OCTOSPI_CCR_IDTR;
+        }
+
+      regval |= OCTOSPI_CCR_ADDTR | OCTOSPI_CCR_DDTR;
+      if (xctn->altbytesmode != OCTOSPI_LINES_NONE)
+        {
+          regval |= OCTOSPI_CCR_ABDTR;
+        }
+    }
+
+  if (xctn->isdqs)
+    {
+      regval |= OCTOSPI_CCR_DQSE;
+    }
+
+  if (xctn->issioo)
+    {
+      regval |= OCTOSPI_CCR_SIOO;
+    }
+
+  return regval;
+}
+
+/****************************************************************************
+ * Name: octospi_tcrvalue
+ *
+ * Description:
+ *   Build the TCR (or WTCR) value of a transaction descriptor
+ *
+ ****************************************************************************/
+
+static uint32_t octospi_tcrvalue(const struct octospi_xctnspec_s *xctn)
+{
+  uint32_t regval = OCTOSPI_TCR_DCYC(xctn->dummycycles);
+
+  /* Output data is held a quarter cycle longer in DTR mode to meet the
+   * memory hold time.
+   */
+
+  if (xctn->isdtr)
+    {
+      regval |= OCTOSPI_TCR_DHQC;
+    }
+
+  return regval;
+}
+
+/****************************************************************************
+ * Name: octospi_ccrconfig
+ *
+ * Description:
+ *   Do common Communications Configuration Register setup.  In indirect
+ *   mode the transfer starts on the write to AR (or to IR when there is no
+ *   address phase), so that is done last.
+ *
+ * Input Parameters:
+ *   priv  - The OCTOSPI controller
+ *   xctn  - the transaction descriptor; CCR setup
+ *   fctn  - 'functional mode'; OCTOSPI_FMODE_*
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void octospi_ccrconfig(struct stm32l4_octospidev_s *priv,
+                              struct octospi_xctnspec_s *xctn,
+                              uint8_t fctn)
+{
+  uint32_t regval;
+
+  /* Select the functional mode */
+
+  regval  = octospi_getreg(priv, STM32L4_OCTOSPI_CR_OFFSET);
+  regval &= ~OCTOSPI_CR_FMODE_MASK;
+  regval |= OCTOSPI_CR_FMODE(fctn);
+  octospi_putreg(priv, regval, STM32L4_OCTOSPI_CR_OFFSET);
+
+  /* If we have data, and it's not memory mapped, write the length */
+
+  if (xctn->datamode != OCTOSPI_LINES_NONE && fctn != OCTOSPI_FMODE_MEMMAP)
+    {
+      octospi_putreg(priv, xctn->datasize - 1, STM32L4_OCTOSPI_DLR_OFFSET);
+    }
+
+  /* If we have alternate bytes, stick them in now */
+
+  if (xctn->altbytesmode != OCTOSPI_LINES_NONE)
+    {
+      octospi_putreg(priv, xctn->altbytes, STM32L4_OCTOSPI_ABR_OFFSET);
+    }
+
+  octospi_putreg(priv, octospi_ccrvalue(xctn), STM32L4_OCTOSPI_CCR_OFFSET);
+  octospi_putreg(priv, octospi_tcrvalue(xctn), STM32L4_OCTOSPI_TCR_OFFSET);
+  octospi_putreg(priv, xctn->instr, STM32L4_OCTOSPI_IR_OFFSET);
+
+  /* If we have and need an address, set that now, too */
+
+  if (xctn->addrmode != OCTOSPI_LINES_NONE && fctn != OCTOSPI_FMODE_MEMMAP)
+    {
+      octospi_putreg(priv, xctn->addr, STM32L4_OCTOSPI_AR_OFFSET);
+    }
+}
+
+/****************************************************************************
+ * Name: octospi_receive_blocking
+ *
+ * Description:
+ *   Do common data receive in a blocking (status polling) way.  Whole words
+ *   are moved while at least four bytes remain and the buffer is aligned.
+ *
+ * Input Parameters:
+ *   priv  - The OCTOSPI controller
+ *   xctn  - the transaction descriptor
+ *
+ * Returned Value:
+ *   OK, or -errno on error
+ *
+ ****************************************************************************/
+
+static int octospi_receive_blocking(struct stm32l4_octospidev_s *priv,
+                                    struct octospi_xctnspec_s *xctn)
+{
+  uintptr_t datareg = priv->base + STM32L4_OCTOSPI_DR_OFFSET;
+  uint8_t *dest = (uint8_t *)xctn->buffer;
+  uint32_t remaining = xctn->datasize;
+
+  if (dest == NULL)
+    {
+      return -EINVAL;
+    }
+
+  while (remaining > 0)
+    {
+      /* Wait for FIFO threshold, or transfer complete, to read data */
+
+      octospi_waitstatusflags(priv, OCTOSPI_SR_FTF | OCTOSPI_SR_TCF, 1);
+
+      if (remaining >= 4 && IS_ALIGNED(dest))
+        {
+          *(uint32_t *)dest = getreg32(datareg);
+          dest      += 4;
+          remaining -= 4;
+        }
+      else
+        {
+          *dest++ = getreg8(datareg);
+          remaining--;
+        }
+    }
+
+  /* Wait for transfer complete, then clear it */
+
+  octospi_waitstatusflags(priv, OCTOSPI_SR_TCF, 1);
+  octospi_putreg(priv, OCTOSPI_FCR_CTCF, STM32L4_OCTOSPI_FCR_OFFSET);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: octospi_transmit_blocking
+ *
+ * Description:
+ *   Do common data transmit in a blocking (status polling) way
+ *
+ * Input Parameters:
+ *   priv  - The OCTOSPI controller
+ *   xctn  - the transaction descriptor
+ *
+ * Returned Value:
+ *   OK, or -errno on error
+ *
+ ****************************************************************************/
+
+static int octospi_transmit_blocking(struct stm32l4_octospidev_s *priv,
+                                     struct octospi_xctnspec_s *xctn)
+{
+  uintptr_t datareg = priv->base + STM32L4_OCTOSPI_DR_OFFSET;
+  const uint8_t *src = (const uint8_t *)xctn->buffer;
+  uint32_t remaining = xctn->datasize;
+
+  if (src == NULL)
+    {
+      return -EINVAL;
+    }
+
+  while (remaining > 0)
+    {
+      /* Wait for room in the FIFO to write data */
+
+      octospi_waitstatusflags(priv, OCTOSPI_SR_FTF, 1);
+
+      if (remaining >= 4 && IS_ALIGNED(src))
+        {
+          putreg32(*(const uint32_t *)src, datareg);
+          src       += 4;
+          remaining -= 4;
+        }
+      else
+        {
+          putreg8(*src++, datareg);
+          remaining--;
+        }
+    }
+
+  /* Wait for transfer complete, then clear it */
+
+  octospi_waitstatusflags(priv, OCTOSPI_SR_TCF, 1);
+  octospi_putreg(priv, OCTOSPI_FCR_CTCF, STM32L4_OCTOSPI_FCR_OFFSET);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: octospi_transfer
+ *
+ * Description:
+ *   Run one indirect mode transaction to completion
+ *
+ * Input Parameters:
+ *   priv  - The OCTOSPI controller
+ *   xctn  - the transaction descriptor
+ *   write - true: indirect write, false: indirect read
+ *
+ * Returned Value:
+ *   OK, or -errno on error
+ *
+ ****************************************************************************/
+
+static int octospi_transfer(struct stm32l4_octospidev_s *priv,
+                            struct octospi_xctnspec_s *xctn, bool write)
+{
+  int ret = OK;
+
+  /* Wait 'till non-busy and clear flags */
+
+  octospi_abort(priv);
+  octospi_putreg(priv, OCTOSPI_FCR_ALL, STM32L4_OCTOSPI_FCR_OFFSET);
+
+  /* Set up the communication configuration; this starts the transfer */
+
+  octospi_ccrconfig(priv, xctn,
+                    write ? OCTOSPI_FMODE_INDWR : OCTOSPI_FMODE_INDRD);
+
+  if (xctn->datamode != OCTOSPI_LINES_NONE)
+    {
+      DEBUGASSERT(xctn->buffer != NULL && xctn->datasize > 0);
+
+      if (write)
+        {
+          ret = octospi_transmit_blocking(priv, xctn);
+        }
+      else
+        {
+          ret = octospi_receive_blocking(priv, xctn);
+        }
+
+      MEMORY_SYNC();
+    }
+  else
+    {
+      octospi_waitstatusflags(priv, OCTOSPI_SR_TCF, 1);
+      octospi_putreg(priv, OCTOSPI_FCR_CTCF, STM32L4_OCTOSPI_FCR_OFFSET);
+    }
+
+  if ((octospi_getreg(priv, STM32L4_OCTOSPI_SR_OFFSET) &
+       OCTOSPI_SR_TEF) != 0)
+    {
+      octospi_putreg(priv, OCTOSPI_FCR_CTEF, STM32L4_OCTOSPI_FCR_OFFSET);
+      ret = -EIO;
+    }
+
+  octospi_waitstatusflags(priv, OCTOSPI_SR_BUSY, 0);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: octospi_lock
+ *
+ * Description:
+ *   Lock the OCTOSPI bus for exclusive access.  See the QSPI_LOCK
+ *   description in include/nuttx/spi/qspi.h.
+ *
+ * Input Parameters:
+ *   dev  - Device-specific state data
+ *   lock - true: Lock OCTOSPI bus, false: unlock OCTOSPI bus
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static int octospi_lock(struct qspi_dev_s *dev, bool lock)
+{
+  struct stm32l4_octospidev_s *priv = (struct stm32l4_octospidev_s *)dev;
+  int ret;
+
+  spiinfo("lock=%d\n", lock);
+  if (lock)
+    {
+      ret = nxmutex_lock(&priv->lock);
+    }
+  else
+    {
+      ret = nxmutex_unlock(&priv->lock);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: octospi_setfrequency
+ *
+ * Description:
+ *   Set the OCTOSPI frequency.
+ *
+ * Input Parameters:
+ *   dev -       Device-specific state data
+ *   frequency - The OCTOSPI frequency requested
+ *
+ * Returned Value:
+ *   Returns the actual frequency selected
+ *
+ ****************************************************************************/
+
+static uint32_t octospi_setfrequency(struct qspi_dev_s *dev,
+                                     uint32_t frequency)
+{
+  struct stm32l4_octospidev_s *priv = (struct stm32l4_octospidev_s *)dev;
+  uint32_t actual;
+  uint32_t prescaler;
+  uint32_t regval;
+
+  if (priv->memmap)
+    {
+      /* The caller will find out in their subsequent calls */
+
+      return 0;
+    }
+
+  spiinfo("frequency=%" PRId32 "\n", frequency);
+  DEBUGASSERT(priv && frequency > 0);
+
+  /* Check if the requested frequency is the same as the frequency
+   * selection
+   */
+
+  if (priv->frequency == frequency)
+    {
+      /* We are already at this frequency.  Return the actual. */
+
+      return priv->actual;
+    }
+
+  /* DCR2 can only be changed while the controller is not busy */
+
+  octospi_abort(priv);
+
+  /* The bus clock is STM32L4_OCTOSPI_CLOCK / prescaler, prescaler 1..256.
+   * 'frequency' is treated as a not-to-exceed value.
+   */
+
+  prescaler = (frequency + STM32L4_OCTOSPI_CLOCK - 1) / frequency;
+  if (prescaler < 1)
+    {
+      prescaler = 1;
+    }
+  else if (prescaler > 256)
+    {
+      prescaler = 256;
+    }
+
+  regval  = octospi_getreg(priv, STM32L4_OCTOSPI_DCR2_OFFSET);
+  regval &= ~OCTOSPI_DCR2_PRESCALER_MASK;
+  regval |= (prescaler - 1) << OCTOSPI_DCR2_PRESCALER_SHIFT;
+  octospi_putreg(priv, regval, STM32L4_OCTOSPI_DCR2_OFFSET);
+
+  actual = STM32L4_OCTOSPI_CLOCK / prescaler;
+
+  /* Save the frequency setting */
+
+  priv->frequency = frequency;
+  priv->actual    = actual;
+
+  spiinfo("Frequency %" PRId32 "->%" PRId32 "\n", frequency, actual);
+  return actual;
+}
+
+/****************************************************************************
+ * Name: octospi_setmode
+ *
+ * Description:
+ *   Set the OCTOSPI mode.  Only modes 0 and 3 are supported.
+ *
+ * Input Parameters:
+ *   dev -  Device-specific state data
+ *   mode - The QSPI mode requested
+ *
+ * Returned Value:
+ *   none
+ *
+ ****************************************************************************/
+
+static void octospi_setmode(struct qspi_dev_s *dev, enum qspi_mode_e mode)
+{
+  struct stm32l4_octospidev_s *priv = (struct stm32l4_octospidev_s *)dev;
+  uint32_t regval;
+
+  if (priv->memmap || mode == priv->mode)
+    {
+      return;
+    }
+
+  spiinfo("mode=%d\n", mode);
+
+  octospi_abort(priv);
+
+  regval  = octospi_getreg(priv, STM32L4_OCTOSPI_DCR1_OFFSET);
+  regval &= ~OCTOSPI_DCR1_CKMODE;
+
+  switch (mode)
+    {
+    case QSPIDEV_MODE0: /* CPOL=0; CPHA=0 */
+      break;
+
+    case QSPIDEV_MODE3: /* CPOL=1; CPHA=1 */
+      regval |= OCTOSPI_DCR1_CKMODE;
+      break;
+
+    case QSPIDEV_MODE1: /* CPOL=0; CPHA=1 */
+    case QSPIDEV_MODE2: /* CPOL=1; CPHA=0 */
+    default:
+      spiinfo("unsupported mode=%d\n", mode);
+      DEBUGPANIC();
+      return;
+    }
+
+  octospi_putreg(priv, regval, STM32L4_OCTOSPI_DCR1_OFFSET);
+  spiinfo("DCR1=%08" PRIx32 "\n", regval);
+
+  priv->mode = mode;
+}
+
+/****************************************************************************
+ * Name: octospi_setbits
+ *
+ * Description:
+ *   Set the number if bits per word.  Only 8 bits are supported.
+ *
+ * Input Parameters:
+ *   dev -  Device-specific state data
+ *   nbits - The number of bits requests
+ *
+ * Returned Value:
+ *   none
+ *
+ ****************************************************************************/
+
+static void octospi_setbits(struct qspi_dev_s *dev, int nbits)
+{
+  if (nbits != 8)
+    {
+      spiinfo("unsupported nbits=%d\n", nbits);
+      DEBUGPANIC();
+    }
+}
+
+/****************************************************************************
+ * Name: octospi_command
+ *
+ * Description:
+ *   Perform one OCTOSPI command transfer
+ *
+ * Input Parameters:
+ *   dev     - Device-specific state data
+ *   cmdinfo - Describes the command transfer to be performed.
+ *
+ * Returned Value:
+ *   Zero (OK) on SUCCESS, a negated errno on value of failure
+ *
+ ****************************************************************************/
+
+static int octospi_command(struct qspi_dev_s *dev,
+                           struct qspi_cmdinfo_s *cmdinfo)
+{
+  struct stm32l4_octospidev_s *priv = (struct stm32l4_octospidev_s *)dev;
+  struct octospi_xctnspec_s xctn;
+  int ret;
+
+  /* Reject commands issued while in memory mapped mode, which would
+   * automatically cancel the memory mapping.  You must exit the memory
+   * mapped mode first.
+   */
+
+  if (priv->memmap)
+    {
+      return -EBUSY;
+    }
+
+  ret = octospi_setupxctnfromcmd(&xctn, cmdinfo);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return octospi_transfer(priv, &xctn, QSPICMD_ISWRITE(cmdinfo->flags));
+}
+
+/****************************************************************************
+ * Name: octospi_memory
+ *
+ * Description:
+ *   Perform one OCTOSPI memory transfer
+ *
+ * Input Parameters:
+ *   dev     - Device-specific state data
+ *   meminfo - Describes the memory transfer to be performed.
+ *
+ * Returned Value:
+ *   Zero (OK) on SUCCESS, a negated errno on value of failure
+ *
+ ****************************************************************************/
+
+static int octospi_memory(struct qspi_dev_s *dev,
+                          struct qspi_meminfo_s *meminfo)
+{
+  struct stm32l4_octospidev_s *priv = (struct stm32l4_octospidev_s *)dev;
+  struct octospi_xctnspec_s xctn;
+  int ret;
+
+  if (priv->memmap)
+    {
+      return -EBUSY;
+    }
+
+  ret = octospi_setupxctnfrommem(&xctn, meminfo, 0);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return octospi_transfer(priv, &xctn, QSPIMEM_ISWRITE(meminfo->flags));
+}
+
+/****************************************************************************
+ * Name: octospi_alloc
+ *
+ * Description:
+ *   Allocate a buffer suitable for data transfer
+ *
+ * Input Parameters:
+ *   dev    - Device-specific state data
+ *   buflen - Buffer length to allocate in bytes
+ *
+ * Returned Value:
+ *   Address of the allocated memory on success; NULL is returned on any
+ *   failure.
+ *
+ ****************************************************************************/
+
+static void *octospi_alloc(struct qspi_dev_s *dev, size_t buflen)
+{
+  /* kmm_malloc() returns memory aligned to at least 32 bits, which lets
+   * the transfer loops move whole words.
+   */
+
+  return kmm_malloc(ALIGN_UP(buflen));
+}
+
+/****************************************************************************
+ * Name: octospi_free
+ *
+ * Description:
+ *   Free memory returned by QSPI_ALLOC
+ *
+ * Input Parameters:
+ *   dev    - Device-specific state data
+ *   buffer - Buffer previously allocated via QSPI_ALLOC
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+static void octospi_free(struct qspi_dev_s *dev, void *buffer)
+{
+  if (buffer)
+    {
+      kmm_free(buffer);
+    }
+}
+
+/****************************************************************************
+ * Name: octospi_ioportconfig
+ *
+ * Description:
+ *   Route the controller straight to the OCTOSPIM port of the same number
+ *   and configure the board pins.  This must be done while the controller
+ *   is disabled.
+ *
+ * Input Parameters:
+ *   priv - Device state structure.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void octospi_ioportconfig(struct stm32l4_octospidev_s *priv)
+{
+  uint32_t regval = OCTOSPIM_PCR_CLKEN | OCTOSPIM_PCR_NCSEN |
+                    OCTOSPIM_PCR_IOLEN;
+
+#ifdef CONFIG_STM32L4_OCTOSPI1
+  if (priv->intf == 0)
+    {
+      regval |= OCTOSPIM_PCR_IOLSRC(OCTOSPIM_IOSRC_OSPI1_LOW);
+
+#ifdef GPIO_OCTOSPI1_DQS
+      stm32l4_configgpio(GPIO_OCTOSPI1_DQS);
+      regval |= OCTOSPIM_PCR_DQSEN;
+#endif
+#ifdef GPIO_OCTOSPI1_IO7
+      stm32l4_configgpio(GPIO_OCTOSPI1_IO4);
+      stm32l4_configgpio(GPIO_OCTOSPI1_IO5);
+      stm32l4_configgpio(GPIO_OCTOSPI1_IO6);
+      stm32l4_configgpio(GPIO_OCTOSPI1_IO7);
+      regval |= OCTOSPIM_PCR_IOHEN |
+                OCTOSPIM_PCR_IOHSRC(OCTOSPIM_IOSRC_OSPI1_HIGH);
+#endif
+
+      stm32l4_configgpio(GPIO_OCTOSPI1_NCS);
+      stm32l4_configgpio(GPIO_OCTOSPI1_CLK);
+      stm32l4_configgpio(GPIO_OCTOSPI1_IO0);
+      stm32l4_configgpio(GPIO_OCTOSPI1_IO1);
+      stm32l4_configgpio(GPIO_OCTOSPI1_IO2);
+      stm32l4_configgpio(GPIO_OCTOSPI1_IO3);
+
+      putreg32(regval, STM32L4_OCTOSPIM_P1CR);
+    }
+#endif
+
+#ifdef CONFIG_STM32L4_OCTOSPI2
+  if (priv->intf == 1)
+    {
+      regval |= OCTOSPIM_PCR_CLKSRC | OCTOSPIM_PCR_NCSSRC |
+                OCTOSPIM_PCR_DQSSRC |
+                OCTOSPIM_PCR_IOLSRC(OCTOSPIM_IOSRC_OSPI2_LOW);
+
+#ifdef GPIO_OCTOSPI2_DQS
+      stm32l4_configgpio(GPIO_OCTOSPI2_DQS);
+      regval |= OCTOSPIM_PCR_DQSEN;
+#endif
+#ifdef GPIO_OCTOSPI2_IO7
+      stm32l4_configgpio(GPIO_OCTOSPI2_IO4);
+      stm32l4_configgpio(GPIO_OCTOSPI2_IO5);
+      stm32l4_configgpio(GPIO_OCTOSPI2_IO6);
+      stm32l4_configgpio(GPIO_OCTOSPI2_IO7);
+      regval |= OCTOSPIM_PCR_IOHEN |
+                OCTOSPIM_PCR_IOHSRC(OCTOSPIM_IOSRC_OSPI2_HIGH);
+#endif
+
+      stm32l4_configgpio(GPIO_OCTOSPI2_NCS);
+      stm32l4_configgpio(GPIO_OCTOSPI2_CLK);
+      stm32l4_configgpio(GPIO_OCTOSPI2_IO0);
+      stm32l4_configgpio(GPIO_OCTOSPI2_IO1);
+      stm32l4_configgpio(GPIO_OCTOSPI2_IO2);
+      stm32l4_configgpio(GPIO_OCTOSPI2_IO3);
+
+      putreg32(regval, STM32L4_OCTOSPIM_P2CR);
+    }
+#endif
+
+  /* Direct (non-multiplexed) mode */
+
+  modifyreg32(STM32L4_OCTOSPIM_CR, OCTOSPIM_CR_MUXEN, 0);
+}
+
+/****************************************************************************
+ * Name: octospi_hw_initialize
+ *
+ * Description:
+ *   Initialize the OCTOSPI peripheral from hardware reset.
+ *
+ * Input Parameters:
+ *   priv - Device state structure.
+ *
+ * Returned Value:
+ *   Zero (OK) on SUCCESS, a negated errno on value of failure
+ *
+ ****************************************************************************/
+
+static int octospi_hw_initialize(struct stm32l4_octospidev_s *priv)
+{
+  uint32_t nsize;
+  int nlog2size;
+
+  /* Disable the controller; the IO manager may only be changed while both
+   * controllers of a port are disabled.
+   */
+
+  octospi_putreg(priv, 0, STM32L4_OCTOSPI_CR_OFFSET);
+  octospi_waitstatusflags(priv, OCTOSPI_SR_BUSY, 0);
+
+  octospi_ioportconfig(priv);
+
+  /* Device size is 2^(DEVSIZE + 1) bytes */
+
+  nsize = priv->flashsize;
+  nlog2size = 31;
+  while ((nsize & 0x80000000) == 0)
+    {
+      nlog2size--;
+      nsize <<= 1;
+    }
+
+  octospi_putreg(priv, OCTOSPI_DCR1_MTYP_MICRON |
+                 OCTOSPI_DCR1_DEVSIZE(nlog2size - 1) |
+                 OCTOSPI_DCR1_CSHT(CONFIG_STM32L4_OCTOSPI_CSHT),
+                 STM32L4_OCTOSPI_DCR1_OFFSET);
+
+  /* Start at half the kernel clock until the client sets a frequency */
+
+  octospi_putreg(priv, 1 << OCTOSPI_DCR2_PRESCALER_SHIFT,
+                 STM32L4_OCTOSPI_DCR2_OFFSET);
+  octospi_putreg(priv, 0, STM32L4_OCTOSPI_DCR3_OFFSET);
+
+  priv->frequency = 0;
+  priv->actual    = STM32L4_OCTOSPI_CLOCK / 2;
+  priv->mode      = QSPIDEV_MODE0;
+
+  /* Configure the FIFO threshold, all interrupts disabled, and enable */
+
+  octospi_putreg(priv, OCTOSPI_FCR_ALL, STM32L4_OCTOSPI_FCR_OFFSET);
+  octospi_putreg(priv,
+                 OCTOSPI_CR_FTHRES(CONFIG_STM32L4_OCTOSPI_FIFO_THESHOLD) |
+                 OCTOSPI_CR_EN,
+                 STM32L4_OCTOSPI_CR_OFFSET);
+
+  octospi_dumpregs(priv, "After initialization");
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4_octospi_initialize
+ *
+ * Description:
+ *   Initialize the selected OCTOSPI port in indirect (command) mode
+ *
+ * Input Parameters:
+ *   intf - Interface number: 0 for OCTOSPI1, 1 for OCTOSPI2
+ *
+ * Returned Value:
+ *   Valid QSPI device structure reference on success; a NULL on failure
+ *
+ ****************************************************************************/
+
+struct qspi_dev_s *stm32l4_octospi_initialize(int intf)
+{
+  struct stm32l4_octospidev_s *priv;
+  uint32_t rstbit;
+  uint32_t enbit;
+  int ret;
+
+  spiinfo("intf: %d\n", intf);
+
+#ifdef CONFIG_STM32L4_OCTOSPI1
+  if (intf == 0)
+    {
+      priv   = &g_octospi1dev;
+      enbit  = RCC_AHB3ENR_OSPI1EN;
+      rstbit = RCC_AHB3RSTR_OSPI1RST;
+    }
+  else
+#endif
+#ifdef CONFIG_STM32L4_OCTOSPI2
+  if (intf == 1)
+    {
+      priv   = &g_octospi2dev;
+      enbit  = RCC_AHB3ENR_OSPI2EN;
+      rstbit = RCC_AHB3RSTR_OSPI2RST;
+    }
+  else
+#endif
+    {
+      spierr("ERROR: OCTOSPI%d not supported\n", intf + 1);
+      return NULL;
+    }
+
+  nxmutex_lock(&priv->lock);
+
+  if (!priv->initialized)
+    {
+      /* Enable clocking to the IO manager and the controller, then reset
+       * the controller.
+       */
+
+      modifyreg32(STM32L4_RCC_AHB2ENR, 0, RCC_AHB2ENR_OSPIMEN);
+      modifyreg32(STM32L4_RCC_AHB3ENR, 0, enbit);
+      modifyreg32(STM32L4_RCC_AHB3RSTR, 0, rstbit);
+      modifyreg32(STM32L4_RCC_AHB3RSTR, rstbit, 0);
+
+      ret = octospi_hw_initialize(priv);
+      if (ret < 0)
+        {
+          spierr("ERROR: Failed to initialize OCTOSPI hardware\n");
+          nxmutex_unlock(&priv->lock);
+          return NULL;
+        }
+
+      priv->initialized = true;
+      priv->memmap      = false;
+    }
+
+  nxmutex_unlock(&priv->lock);
+  return &priv->qspi;
+}
+
+/****************************************************************************
+ * Name: stm32l4_octospi_enter_memorymapped
+ *
+ * Description:
+ *   Put the OCTOSPI device into memory mapped mode
+ *
+ * Input Parameters:
+ *   dev    - OCTOSPI device
+ *   rdinfo - Read command, address size, dummy cycles and line flags
+ *   wrinfo - Write command for RAM devices, or NULL for read-only memory
+ *   lpto   - Number of cycles to wait to automatically de-assert CS
+ *   xflags - OCTOSPI_XIP_* options
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno on failure
+ *
+ ****************************************************************************/
+
+int stm32l4_octospi_enter_memorymapped(struct qspi_dev_s *dev,
+                                       const struct qspi_meminfo_s *rdinfo,
+                                       const struct qspi_meminfo_s *wrinfo,
+                                       uint32_t lpto, uint32_t xflags)
+{
+  struct stm32l4_octospidev_s *priv = (struct stm32l4_octospidev_s *)dev;
+  struct octospi_xctnspec_s xctn;
+  uint32_t regval;
+  int ret;
+
+  DEBUGASSERT(priv != NULL && rdinfo != NULL);
+
+  if ((xflags & OCTOSPI_XIP_OCTAL) != 0 && !priv->octal)
+    {
+      return -ENOTSUP;
+    }
+
+  ret = octospi_lock(dev, true);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (priv->memmap)
+    {
+      goto out;
+    }
+
+  ret = octospi_setupxctnfrommem(&xctn, rdinfo, xflags);
+  if (ret < 0)
+    {
+      goto out;
+    }
+
+  /* Abort anything in-progress */
+
+  octospi_abort(priv);
+  octospi_putreg(priv, OCTOSPI_FCR_ALL, STM32L4_OCTOSPI_FCR_OFFSET);
+
+  /* Select the memory type that defines the octal DTR byte order */
+
+  regval  = octospi_getreg(priv, STM32L4_OCTOSPI_DCR1_OFFSET);
+  regval &= ~OCTOSPI_DCR1_MTYP_MASK;
+  regval |= (xflags & OCTOSPI_XIP_MACRONIX) != 0 ?
+            OCTOSPI_DCR1_MTYP_MACRONIX : OCTOSPI_DCR1_MTYP_MICRON;
+  octospi_putreg(priv, regval, STM32L4_OCTOSPI_DCR1_OFFSET);
+
+  /* Set up the low-power timeout (automatically de-assert CS if memory is
+   * not accessed for a while), so that CS stays low between back-to-back
+   * cache line fills otherwise.
+   */
+
+  regval = octospi_getreg(priv, STM32L4_OCTOSPI_CR_OFFSET);
+  if (lpto > 0)
+    {
+      octospi_putreg(priv, lpto & OCTOSPI_LPTR_TIMEOUT_MASK,
+                     STM32L4_OCTOSPI_LPTR_OFFSET);
+      regval |= OCTOSPI_CR_TCEN;
+    }
+  else
+    {
+      regval &= ~OCTOSPI_CR_TCEN;
+    }
+
+  octospi_putreg(priv, regval, STM32L4_OCTOSPI_CR_OFFSET);
+
+  /* The write configuration must be in place before memory mapped mode is
+   * entered.
+   */
+
+  if (wrinfo != NULL)
+    {
+      struct octospi_xctnspec_s wxctn;
+
+      ret = octospi_setupxctnfrommem(&wxctn, wrinfo, xflags);
+      if (ret < 0)
+        {
+          goto out;
+        }
+
+      octospi_putreg(priv, octospi_ccrvalue(&wxctn),
+                     STM32L4_OCTOSPI_WCCR_OFFSET);
+      octospi_putreg(priv, octospi_tcrvalue(&wxctn),
+                     STM32L4_OCTOSPI_WTCR_OFFSET);
+      octospi_putreg(priv, wxctn.instr, STM32L4_OCTOSPI_WIR_OFFSET);
+    }
+
+  /* Set the read configuration; this enters memory mapped mode */
+
+  octospi_ccrconfig(priv, &xctn, OCTOSPI_FMODE_MEMMAP);
+  priv->memmap = true;
+
+  octospi_dumpregs(priv, "After memory mapped:");
+
+out:
+  octospi_lock(dev, false);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: stm32l4_octospi_exit_memorymapped
+ *
+ * Description:
+ *   Take the OCTOSPI device out of memory mapped mode
+ *
+ * Input Parameters:
+ *   dev - OCTOSPI device
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void stm32l4_octospi_exit_memorymapped(struct qspi_dev_s *dev)
+{
+  struct stm32l4_octospidev_s *priv = (struct stm32l4_octospidev_s *)dev;
+  uint32_t regval;
+
+  octospi_lock(dev, true);
+
+  /* Abort, then return to indirect mode */
+
+  octospi_abort(priv);
+
+  regval  = octospi_getreg(priv, STM32L4_OCTOSPI_CR_OFFSET);
+  regval &= ~(OCTOSPI_CR_FMODE_MASK | OCTOSPI_CR_TCEN);
+  octospi_putreg(priv, regval, STM32L4_OCTOSPI_CR_OFFSET);
+
+  priv->memmap = false;
+
+  octospi_lock(dev, false);
+}
+
+/****************************************************************************
+ * Name: stm32l4_octospi_membase
+ *
+ * Description:
+ *   Return the base address of the memory mapped window of the device
+ *
+ ****************************************************************************/
+
+uintptr_t stm32l4_octospi_membase(struct qspi_dev_s *dev)
+{
+  struct stm32l4_octospidev_s *priv = (struct stm32l4_octospidev_s *)dev;
+
+  return priv->membase;
+}
+
+#endif /* CONFIG_STM32L4_OCTOSPI */
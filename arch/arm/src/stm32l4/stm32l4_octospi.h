@@ -0,0 +1,192 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_octospi.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_SRC_STM32L4_STM32L4_OCTOSPI_H
+#define __ARCH_ARM_SRC_STM32L4_STM32L4_OCTOSPI_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "chip.h"
+
+#ifdef CONFIG_STM32L4_OCTOSPI
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Extra memory-mapped mode options that cannot be expressed with the
+ * generic qspi_meminfo_s flags.  These are passed as the 'xflags' argument
+ * of stm32l4_octospi_enter_memorymapped().
+ */
+
+#define OCTOSPI_XIP_OCTAL     (1 << 0)  /* Instruction, address and data on 8 lines */
+#define OCTOSPI_XIP_DTR       (1 << 1)  /* Double transfer rate on all phases */
+#define OCTOSPI_XIP_DQS       (1 << 2)  /* Sample read data with the DQS strobe */
+#define OCTOSPI_XIP_CMD16     (1 << 3)  /* 16-bit instruction: cmd followed by ~cmd */
+#define OCTOSPI_XIP_MACRONIX  (1 << 4)  /* Macronix D1/D0 byte order in octal DTR */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+#ifndef __ASSEMBLY__
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4_octospi_initialize
+ *
+ * Description:
+ *   Initialize the selected OCTOSPI port in indirect (command) mode
+ *
+ * Input Parameters:
+ *   intf - Interface number: 0 for OCTOSPI1, 1 for OCTOSPI2
+ *
+ * Returned Value:
+ *   Valid QSPI device structure reference on success; a NULL on failure
+ *
+ ****************************************************************************/
+
+struct qspi_dev_s;
+struct qspi_dev_s *stm32l4_octospi_initialize(int intf);
+
+/****************************************************************************
+ * Name: stm32l4_octospi_enter_memorymapped
+ *
+ * Description:
+ *   Put the OCTOSPI device into memory mapped mode.  Reads of the memory
+ *   window (STM32L4_OCTOSPIn_BANK) are then turned into read transactions
+ *   described by 'rdinfo'.  If 'wrinfo' is not NULL, writes to the window
+ *   are also accepted (PSRAM), described by 'wrinfo'.
+ *
+ * Input Parameters:
+ *   dev    - OCTOSPI device
+ *   rdinfo - Read command, address size, dummy cycles and line flags
+ *   wrinfo - Write command for RAM devices, or NULL for read-only memory
+ *   lpto   - Number of cycles to wait to automatically de-assert CS
+ *   xflags - OCTOSPI_XIP_* options
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno on failure
+ *
+ ****************************************************************************/
+
+int stm32l4_octospi_enter_memorymapped(struct qspi_dev_s *dev,
+                                       const struct qspi_meminfo_s *rdinfo,
+                                       const struct qspi_meminfo_s *wrinfo,
+                                       uint32_t lpto, uint32_t xflags);
+
+/****************************************************************************
+ * Name: stm32l4_octospi_exit_memorymapped
+ *
+ * Description:
+ *   Take the OCTOSPI device out of memory mapped mode
+ *
+ * Input Parameters:
+ *   dev - OCTOSPI device
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void stm32l4_octospi_exit_memorymapped(struct qspi_dev_s *dev);
+
+/****************************************************************************
+ * Name: stm32l4_octospi_membase
+ *
+ * Description:
+ *   Return the base address of the memory mapped window of the device
+ *
+ * Input Parameters:
+ *   dev - OCTOSPI device
+ *
+ * Returned Value:
+ *   The CPU address at which offset 0 of the external memory is mapped
+ *
+ ****************************************************************************/
+
+uintptr_t stm32l4_octospi_membase(struct qspi_dev_s *dev);
+
+/****************************************************************************
+ * Name: stm32l4_octospi_xipmtd
+ *
+ * Description:
+ *   Create a read-only MTD device over a region of the memory mapped window
+ *   of a flash memory.  The device must already be in memory mapped mode,
+ *   see stm32l4_octospi_enter_memorymapped().  Reads are served from the
+ *   window and the device answers BIOC_XIPBASE, so a ROMFS image mounted
+ *   on it (after register_mtddriver()) is read in place and its files can
+ *   be mmap()'ed or executed without copies.
+ *
+ * Input Parameters:
+ *   dev       - OCTOSPI device in memory mapped mode
+ *   offset    - Offset of the region in the external memory
+ *   size      - Size of the region, bytes
+ *   blocksize - Block size reported to the file system, a power of two
+ *               that divides offset and size
+ *
+ * Returned Value:
+ *   The MTD device on success; NULL on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_OCTOSPI_XIPMTD
+struct mtd_dev_s;
+struct mtd_dev_s *stm32l4_octospi_xipmtd(struct qspi_dev_s *dev,
+                                         off_t offset, size_t size,
+                                         size_t blocksize);
+#endif
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __ASSEMBLY__ */
+#endif /* CONFIG_STM32L4_OCTOSPI */
+#endif /* __ARCH_ARM_SRC_STM32L4_STM32L4_OCTOSPI_H */
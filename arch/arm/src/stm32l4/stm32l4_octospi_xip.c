@@ -0,0 +1,256 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_octospi_xip.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/mtd/mtd.h>
+#include <nuttx/spi/qspi.h>
+
+#include "stm32l4_octospi.h"
+
+#ifdef CONFIG_STM32L4_OCTOSPI_XIPMTD
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A read-only MTD over a part of the memory mapped window.  Reads are plain
+ * copies from the window and BIOC_XIPBASE returns the window address, so
+ * that a ROMFS mounted on it is accessed in place.
+ */
+
+struct octospi_xipmtd_s
+{
+  struct mtd_dev_s mtd;         /* MTD interface, must be first */
+  uintptr_t base;               /* CPU address of block 0 */
+  size_t    size;               /* Size of the region, bytes */
+  uint8_t   blkshift;           /* Log2 of the block size */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     xipmtd_erase(struct mtd_dev_s *dev, off_t startblock,
+                            size_t nblocks);
+static ssize_t xipmtd_bread(struct mtd_dev_s *dev, off_t startblock,
+                            size_t nblocks, uint8_t *buf);
+static ssize_t xipmtd_bwrite(struct mtd_dev_s *dev, off_t startblock,
+                             size_t nblocks, const uint8_t *buf);
+static ssize_t xipmtd_read(struct mtd_dev_s *dev, off_t offset,
+                           size_t nbytes, uint8_t *buffer);
+static int     xipmtd_ioctl(struct mtd_dev_s *dev, int cmd,
+                            unsigned long arg);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: xipmtd_erase and xipmtd_bwrite
+ *
+ * Description:
+ *   Writes through the window are not supported for flash memories: the
+ *   region must be programmed with the indirect mode MTD driver.
+ *
+ ****************************************************************************/
+
+static int xipmtd_erase(struct mtd_dev_s *dev, off_t startblock,
+                        size_t nblocks)
+{
+  return -EROFS;
+}
+
+static ssize_t xipmtd_bwrite(struct mtd_dev_s *dev, off_t startblock,
+                             size_t nblocks, const uint8_t *buf)
+{
+  return -EROFS;
+}
+
+/****************************************************************************
+ * Name: xipmtd_bread
+ ****************************************************************************/
+
+static ssize_t xipmtd_bread(struct mtd_dev_s *dev, off_t startblock,
+                            size_t nblocks, uint8_t *buf)
+{
+  struct octospi_xipmtd_s *priv = (struct octospi_xipmtd_s *)dev;
+  size_t total = priv->size >> priv->blkshift;
+
+  if (startblock < 0 || startblock >= total)
+    {
+      return 0;
+    }
+
+  if (nblocks > total - startblock)
+    {
+      nblocks = total - startblock;
+    }
+
+  memcpy(buf, (const void *)(priv->base + (startblock << priv->blkshift)),
+         nblocks << priv->blkshift);
+  return nblocks;
+}
+
+/****************************************************************************
+ * Name: xipmtd_read
+ ****************************************************************************/
+
+static ssize_t xipmtd_read(struct mtd_dev_s *dev, off_t offset,
+                           size_t nbytes, uint8_t *buffer)
+{
+  struct octospi_xipmtd_s *priv = (struct octospi_xipmtd_s *)dev;
+
+  if (offset < 0 || offset >= priv->size)
+    {
+      return 0;
+    }
+
+  if (nbytes > priv->size - offset)
+    {
+      nbytes = priv->size - offset;
+    }
+
+  memcpy(buffer, (const void *)(priv->base + offset), nbytes);
+  return nbytes;
+}
+
+/****************************************************************************
+ * Name: xipmtd_ioctl
+ ****************************************************************************/
+
+static int xipmtd_ioctl(struct mtd_dev_s *dev, int cmd, unsigned long arg)
+{
+  struct octospi_xipmtd_s *priv = (struct octospi_xipmtd_s *)dev;
+  int ret = -EINVAL;
+
+  switch (cmd)
+    {
+      case MTDIOC_GEOMETRY:
+        {
+          struct mtd_geometry_s *geo = (struct mtd_geometry_s *)arg;
+
+          if (geo != NULL)
+            {
+              memset(geo, 0, sizeof(*geo));
+              geo->blocksize    = 1 << priv->blkshift;
+              geo->erasesize    = 1 << priv->blkshift;
+              geo->neraseblocks = priv->size >> priv->blkshift;
+              ret               = OK;
+            }
+        }
+        break;
+
+      case BIOC_XIPBASE:
+        {
+          void **ppv = (void **)arg;
+
+          if (ppv != NULL)
+            {
+              *ppv = (void *)priv->base;
+              ret  = OK;
+            }
+        }
+        break;
+
+      case MTDIOC_ERASESTATE:
+        {
+          uint8_t *result = (uint8_t *)arg;
+
+          *result = 0xff;
+          ret     = OK;
+        }
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4_octospi_xipmtd
+ *
+ * Description:
+ *   Create a read-only MTD device over a region of the memory mapped window
+ *
+ ****************************************************************************/
+
+struct mtd_dev_s *stm32l4_octospi_xipmtd(struct qspi_dev_s *dev,
+                                         off_t offset, size_t size,
+                                         size_t blocksize)
+{
+  struct octospi_xipmtd_s *priv;
+  int blkshift;
+
+  DEBUGASSERT(dev != NULL && offset >= 0);
+
+  /* The block size must be a power of two that divides the region */
+
+  blkshift = blocksize > 0 ? ffs(blocksize) - 1 : -1;
+  if (blkshift < 0 || blocksize != (1 << blkshift) ||
+      (offset & (blocksize - 1)) != 0 || (size & (blocksize - 1)) != 0 ||
+      size == 0)
+    {
+      ferr("ERROR: Bad region %jd+%zu, block size %zu\n",
+           (intmax_t)offset, size, blocksize);
+      return NULL;
+    }
+
+  priv = kmm_zalloc(sizeof(struct octospi_xipmtd_s));
+  if (priv == NULL)
+    {
+      return NULL;
+    }
+
+  priv->mtd.erase  = xipmtd_erase;
+  priv->mtd.bread  = xipmtd_bread;
+  priv->mtd.bwrite = xipmtd_bwrite;
+  priv->mtd.read   = xipmtd_read;
+  priv->mtd.ioctl  = xipmtd_ioctl;
+  priv->mtd.name   = "octospixip";
+  priv->base       = stm32l4_octospi_membase(dev) + offset;
+  priv->size       = size;
+  priv->blkshift   = blkshift;
+
+  return &priv->mtd;
+}
+
+#endif /* CONFIG_STM32L4_OCTOSPI_XIPMTD */
@@ -1140,6 +1140,22 @@ static void stm32l4_txfifo_write(struct stm32l4_ep_s *privep,
 
   regaddr = STM32L4_OTGFS_DFIFO_DEP(privep->epphy);
 
+#ifdef CONFIG_STM32L4_OTGFS_BULKBATCH
+  /* Word-aligned buffers can be copied directly, one word at a time */
+
+  if (((uintptr_t)buf & 3) == 0)
+    {
+      uint32_t *src = (uint32_t *)buf;
+
+      for (i = 0; i < nwords; i++)
+        {
+          stm32l4_putreg(*src++, regaddr);
+        }
+
+      return;
+    }
+#endif
+
   /* Then transfer each word to the TxFIFO */
 
   for (i = 0; i < nwords; i++)
@@ -1262,6 +1278,39 @@ static void stm32l4_epin_transfer(struct stm32l4_ep_s *privep,
   stm32l4_txfifo_write(privep, buf, nbytes);
 }
 
+/****************************************************************************
+ * Name: stm32l4_epin_batchsize
+ *
+ * Description:
+ *   Return the number of bytes of a bulk IN request to send in the next
+ *   transfer:  Either all of the bytes left in the request if they fit
+ *   into the free TxFIFO space, or as many whole packets as will fit.  At
+ *   least one packet is always returned; if even that does not fit, the
+ *   caller will wait for the TxFIFO empty interrupt.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_OTGFS_BULKBATCH
+static int stm32l4_epin_batchsize(struct stm32l4_ep_s *privep,
+                                  int bytesleft)
+{
+  uint32_t regval;
+  int maxpacket = privep->ep.maxpacket;
+  int avail;
+
+  regval = stm32l4_getreg(STM32L4_OTGFS_DTXFSTS(privep->epphy));
+  avail  = (int)(regval & OTGFS_DTXFSTS_MASK) << 2;
+
+  if (bytesleft <= avail)
+    {
+      return bytesleft;
+    }
+
+  avail -= avail % maxpacket;
+  return avail > maxpacket ? avail : maxpacket;
+}
+#endif
+
 /****************************************************************************
  * Name: stm32l4_epin_request
  *
@@ -1351,6 +1400,10 @@ static void stm32l4_epin_request(struct stm32l4_usbdev_s *priv,
    * The documentation says that we can can multiple packets to the TxFIFO,
    * but it seems that we need to get the transfer complete event before
    * we can add the next (or maybe I have got something wrong?)
+   *
+   * With CONFIG_STM32L4_OTGFS_BULKBATCH, bulk endpoints instead program
+   * one multi-packet transfer covering all packets that fit in the TxFIFO
+   * and then wait for its transfer complete event.
    */
 
 #if 0
@@ -1380,15 +1433,29 @@ static void stm32l4_epin_request(struct stm32l4_usbdev_s *priv,
 
           if (nbytes >= privep->ep.maxpacket)
             {
-              nbytes =  privep->ep.maxpacket;
+#ifdef CONFIG_STM32L4_OTGFS_BULKBATCH
+              /* Bulk IN transfers may carry as many packets as will fit
+               * into the free space of the TxFIFO.
+               */
+
+              if (privep->eptype == USB_EP_ATTR_XFER_BULK)
+                {
+                  nbytes = stm32l4_epin_batchsize(privep, bytesleft);
+                }
+              else
+#endif
+                {
+                  nbytes = privep->ep.maxpacket;
+                }
 
-              /* Handle the case where this packet is exactly the
-               * maxpacketsize.  Do we need to send a zero-length packet
-               * in this case?
+              /* Handle the case where this transfer ends the request on
+               * an exact multiple of the maxpacketsize.  Do we need to
+               * send a zero-length packet in this case?
                */
 
-              if (bytesleft ==  privep->ep.maxpacket &&
-                 (privreq->req.flags & USBDEV_REQFLAGS_NULLPKT) != 0)
+              if (nbytes == bytesleft &&
+                  (bytesleft % privep->ep.maxpacket) == 0 &&
+                  (privreq->req.flags & USBDEV_REQFLAGS_NULLPKT) != 0)
                 {
                   /* The ZLP flag is set TRUE whenever we want to force
                    * the driver to send a zero-length-packet on the next
@@ -1519,11 +1586,35 @@ static void stm32l4_rxfifo_read(struct stm32l4_ep_s *privep,
 
   regaddr = STM32L4_OTGFS_DFIFO_DEP(EP0);
 
+#ifdef CONFIG_STM32L4_OTGFS_BULKBATCH
+  /* Copy whole words directly into a word-aligned buffer */
+
+  if (((uintptr_t)dest & 3) == 0)
+    {
+      uint32_t *dest32 = (uint32_t *)dest;
+
+      for (i = 0; i + 4 <= len; i += 4)
+        {
+          *dest32++ = stm32l4_getreg(regaddr);
+        }
+
+      dest = (uint8_t *)dest32;
+    }
+  else
+    {
+      i = 0;
+    }
+
+  /* Then read any remaining (or unaligned) data a byte at a time */
+
+  for (; i < len; i += 4)
+#else
   /* Read 32-bits and write 4 x 8-bits at time
    * (to avoid unaligned accesses)
    */
 
   for (i = 0; i < len; i += 4)
+#endif
     {
       union
       {
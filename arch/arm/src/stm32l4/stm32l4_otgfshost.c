@@ -82,6 +82,10 @@
  *    128
  *  CONFIG_STM32L4_OTGFS_SOFINTR - Enable SOF interrupts.  Why would you ever
  *    want to do that?
+ *  CONFIG_STM32L4_OTGFS_ASYNCH_PIPELINE - Queue asynchronous transfers per
+ *    endpoint and retry NAKed bulk transfers from the channel interrupt.
+ *  CONFIG_STM32L4_OTGFS_ASYNCH_DEPTH - Number of asynchronous transfers
+ *    that may be queued behind the active one.  Default 4
  *  CONFIG_STM32L4_USBHOST_REGDEBUG - Enable very low-level register access
  *    debug.  Depends on CONFIG_DEBUG.
  *  CONFIG_STM32L4_USBHOST_PKTDUMP - Dump all incoming and outgoing USB
@@ -118,6 +122,17 @@
 #  define CONFIG_STM32L4_OTGFS_DESCSIZE 128
 #endif
 
+/* Asynchronous transfer pipelining depends on CONFIG_USBHOST_ASYNCH */
+
+#ifndef CONFIG_USBHOST_ASYNCH
+#  undef CONFIG_STM32L4_OTGFS_ASYNCH_PIPELINE
+#endif
+
+#if defined(CONFIG_STM32L4_OTGFS_ASYNCH_PIPELINE) && \
+    !defined(CONFIG_STM32L4_OTGFS_ASYNCH_DEPTH)
+#  define CONFIG_STM32L4_OTGFS_ASYNCH_DEPTH 4
+#endif
+
 /* Register/packet debug depends on CONFIG_DEBUG */
 
 #ifndef CONFIG_DEBUG
@@ -176,6 +191,18 @@ enum stm32l4_chreason_e
   CHREASON_CANCELLED     /* Transfer cancelled */
 };
 
+/* One asynchronous transfer waiting for its channel */
+
+#ifdef CONFIG_STM32L4_OTGFS_ASYNCH_PIPELINE
+struct stm32l4_asynch_s
+{
+  uint8_t          *buffer;    /* Transfer buffer pointer */
+  size_t            buflen;    /* Transfer length */
+  usbhost_asynch_t  callback;  /* Transfer complete callback */
+  void             *arg;       /* Argument that accompanies the callback */
+};
+#endif
+
 /* This structure retains the state of one host channel.  NOTE: Since there
  * is only one channel operation active at a time, some of the fields in
  * in the structure could be moved in struct stm32l4_ubhost_s to achieve
@@ -209,6 +236,14 @@ struct stm32l4_chan_s
   usbhost_asynch_t  callback;  /* Transfer complete callback */
   void             *arg;       /* Argument that accompanies the callback */
 #endif
+#ifdef CONFIG_STM32L4_OTGFS_ASYNCH_PIPELINE
+  uint8_t          *asbuffer;  /* Start of the active asynch transfer */
+  size_t            asbuflen;  /* Length of the active asynch transfer */
+  size_t            asxfrd;    /* Bytes of it completed so far */
+  uint8_t           qhead;     /* Index of the oldest queued transfer */
+  uint8_t           qcount;    /* Number of queued transfers */
+  struct stm32l4_asynch_s queue[CONFIG_STM32L4_OTGFS_ASYNCH_DEPTH];
+#endif
 };
 
 /* A channel represents on uni-directional endpoint.  So, in the case of the
@@ -343,7 +378,8 @@ static int stm32l4_in_setup(struct stm32l4_usbhost_s *priv, int chidx);
 static ssize_t stm32l4_in_transfer(struct stm32l4_usbhost_s *priv,
                                    int chidx, uint8_t *buffer,
                                    size_t buflen);
-#ifdef CONFIG_USBHOST_ASYNCH
+#if defined(CONFIG_USBHOST_ASYNCH) && \
+    !defined(CONFIG_STM32L4_OTGFS_ASYNCH_PIPELINE)
 static void stm32l4_in_next(struct stm32l4_usbhost_s *priv,
                             struct stm32l4_chan_s *chan);
 static int stm32l4_in_asynch(struct stm32l4_usbhost_s *priv, int chidx,
@@ -354,13 +390,24 @@ static int stm32l4_out_setup(struct stm32l4_usbhost_s *priv, int chidx);
 static ssize_t stm32l4_out_transfer(struct stm32l4_usbhost_s *priv,
                                     int chidx, uint8_t *buffer,
                                     size_t buflen);
-#ifdef CONFIG_USBHOST_ASYNCH
+#if defined(CONFIG_USBHOST_ASYNCH) && \
+    !defined(CONFIG_STM32L4_OTGFS_ASYNCH_PIPELINE)
 static void stm32l4_out_next(struct stm32l4_usbhost_s *priv,
                              struct stm32l4_chan_s *chan);
 static int stm32l4_out_asynch(struct stm32l4_usbhost_s *priv, int chidx,
                               uint8_t *buffer, size_t buflen,
                               usbhost_asynch_t callback, void *arg);
 #endif
+#ifdef CONFIG_STM32L4_OTGFS_ASYNCH_PIPELINE
+static int stm32l4_asynch_start(struct stm32l4_usbhost_s *priv,
+                                struct stm32l4_chan_s *chan);
+static void stm32l4_asynch_next(struct stm32l4_usbhost_s *priv,
+                                struct stm32l4_chan_s *chan);
+static int stm32l4_asynch_submit(struct stm32l4_usbhost_s *priv,
+                                 struct stm32l4_chan_s *chan,
+                                 uint8_t *buffer, size_t buflen,
+                                 usbhost_asynch_t callback, void *arg);
+#endif
 
 /* Interrupt handling *******************************************************/
 
@@ -691,6 +738,12 @@ static void stm32l4_chan_free(struct stm32l4_usbhost_s *priv, int chidx)
 
   stm32l4_chan_halt(priv, chidx, CHREASON_FREED);
 
+#ifdef CONFIG_STM32L4_OTGFS_ASYNCH_PIPELINE
+  /* Drop any queued asynchronous transfers */
+
+  priv->chan[chidx].qcount = 0;
+#endif
+
   /* Mark the channel available */
 
   priv->chan[chidx].inuse = false;
@@ -1145,6 +1198,13 @@ static void stm32l4_chan_wakeup(struct stm32l4_usbhost_s *priv,
 
       else if (chan->callback)
         {
+#ifdef CONFIG_STM32L4_OTGFS_ASYNCH_PIPELINE
+          /* Continue, retry or complete the transfer and start the next
+           * queued one.
+           */
+
+          stm32l4_asynch_next(priv, chan);
+#else
           /* Handle continuation of IN/OUT pipes */
 
           if (chan->in)
@@ -1155,6 +1215,7 @@ static void stm32l4_chan_wakeup(struct stm32l4_usbhost_s *priv,
             {
               stm32l4_out_next(priv, chan);
             }
+#endif
         }
 #endif
     }
@@ -2001,7 +2062,8 @@ static ssize_t stm32l4_in_transfer(struct stm32l4_usbhost_s *priv,
  *
  ****************************************************************************/
 
-#ifdef CONFIG_USBHOST_ASYNCH
+#if defined(CONFIG_USBHOST_ASYNCH) && \
+    !defined(CONFIG_STM32L4_OTGFS_ASYNCH_PIPELINE)
 static void stm32l4_in_next(struct stm32l4_usbhost_s *priv,
                             struct stm32l4_chan_s *chan)
 {
@@ -2066,7 +2128,8 @@ static void stm32l4_in_next(struct stm32l4_usbhost_s *priv,
  *
  ****************************************************************************/
 
-#ifdef CONFIG_USBHOST_ASYNCH
+#if defined(CONFIG_USBHOST_ASYNCH) && \
+    !defined(CONFIG_STM32L4_OTGFS_ASYNCH_PIPELINE)
 static int stm32l4_in_asynch(struct stm32l4_usbhost_s *priv, int chidx,
                              uint8_t *buffer, size_t buflen,
                              usbhost_asynch_t callback, void *arg)
@@ -2292,7 +2355,8 @@ static ssize_t stm32l4_out_transfer(struct stm32l4_usbhost_s *priv,
  *
  ****************************************************************************/
 
-#ifdef CONFIG_USBHOST_ASYNCH
+#if defined(CONFIG_USBHOST_ASYNCH) && \
+    !defined(CONFIG_STM32L4_OTGFS_ASYNCH_PIPELINE)
 static void stm32l4_out_next(struct stm32l4_usbhost_s *priv,
                              struct stm32l4_chan_s *chan)
 {
@@ -2357,7 +2421,8 @@ static void stm32l4_out_next(struct stm32l4_usbhost_s *priv,
  *
  ****************************************************************************/
 
-#ifdef CONFIG_USBHOST_ASYNCH
+#if defined(CONFIG_USBHOST_ASYNCH) && \
+    !defined(CONFIG_STM32L4_OTGFS_ASYNCH_PIPELINE)
 static int stm32l4_out_asynch(struct stm32l4_usbhost_s *priv, int chidx,
                               uint8_t *buffer, size_t buflen,
                               usbhost_asynch_t callback, void *arg)
@@ -2393,6 +2458,257 @@ static int stm32l4_out_asynch(struct stm32l4_usbhost_s *priv, int chidx,
 }
 #endif
 
+/****************************************************************************
+ * Name: stm32l4_asynch_start
+ *
+ * Description:
+ *   Start the next chunk of the active asynchronous transfer at the current
+ *   offset.  Each chunk is limited to the number of packets that the
+ *   channel can transfer at once.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_OTGFS_ASYNCH_PIPELINE
+static int stm32l4_asynch_start(struct stm32l4_usbhost_s *priv,
+                                struct stm32l4_chan_s *chan)
+{
+  size_t remaining = chan->asbuflen - chan->asxfrd;
+
+  chan->buffer = chan->asbuffer + chan->asxfrd;
+  chan->buflen = MIN(remaining,
+                     (size_t)STM32L4_MAX_PKTCOUNT * chan->maxpacket);
+  chan->xfrd   = 0;
+
+  if (chan->in)
+    {
+      return stm32l4_in_setup(priv, chan->chidx);
+    }
+  else
+    {
+      return stm32l4_out_setup(priv, chan->chidx);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: stm32l4_asynch_next
+ *
+ * Description:
+ *   Called when a chunk of an asynchronous transfer halts.  Either continue
+ *   the transfer, retry it after a bulk NAK, or complete it.  On completion
+ *   the next queued transfer is started before the callback is performed so
+ *   that the endpoint is kept busy.
+ *
+ * Assumptions:
+ *   This function is always called from an interrupt handler
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_OTGFS_ASYNCH_PIPELINE
+static void stm32l4_asynch_next(struct stm32l4_usbhost_s *priv,
+                                struct stm32l4_chan_s *chan)
+{
+  struct stm32l4_asynch_s *xfr;
+  usbhost_asynch_t callback;
+  void *arg;
+  ssize_t nbytes;
+  uint32_t regval;
+  unsigned int npackets;
+  unsigned int acked;
+  int result;
+  int ret;
+
+  result = -(int)chan->result;
+  if (result == OK)
+    {
+      /* Account for the chunk.  A short IN packet ends the transfer. */
+
+      if (chan->in)
+        {
+          chan->asxfrd += chan->xfrd;
+          if (chan->xfrd < chan->buflen)
+            {
+              chan->asxfrd = chan->asbuflen;
+            }
+        }
+      else
+        {
+          chan->asxfrd += chan->buflen;
+        }
+
+      if (chan->asxfrd < chan->asbuflen)
+        {
+          ret = stm32l4_asynch_start(priv, chan);
+          if (ret >= 0)
+            {
+              return;
+            }
+
+          uerr("ERROR: stm32l4_asynch_start failed: %d\n", ret);
+          result = ret;
+        }
+    }
+  else if (result == -EAGAIN && chan->eptype == OTGFS_EPTYPE_BULK)
+    {
+      /* The device NAKed a bulk transfer.  Keep whatever part of the chunk
+       * was acknowledged and retry the remainder from here rather than
+       * failing back to the class driver.
+       */
+
+      if (chan->in)
+        {
+          chan->asxfrd += chan->xfrd;
+        }
+      else
+        {
+          /* Packets still pending in HCTSIZ were not acknowledged.  The
+           * DPID field holds the toggle for the first of them.
+           */
+
+          regval   = stm32l4_getreg(STM32L4_OTGFS_HCTSIZ(chan->chidx));
+          npackets = (chan->buflen + chan->maxpacket - 1) / chan->maxpacket;
+          acked    = npackets - ((regval & OTGFS_HCTSIZ_PKTCNT_MASK) >>
+                                 OTGFS_HCTSIZ_PKTCNT_SHIFT);
+
+          chan->asxfrd  += MIN(acked * chan->maxpacket, chan->buflen);
+          chan->outdata1 = ((regval & OTGFS_HCTSIZ_DPID_MASK) ==
+                            OTGFS_HCTSIZ_DPID_DATA1);
+
+          /* Discard the unsent data left in the Tx FIFO */
+
+          stm32l4_flush_txfifos(OTGFS_GRSTCTL_TXFNUM_HALL);
+        }
+
+      ret = stm32l4_asynch_start(priv, chan);
+      if (ret >= 0)
+        {
+          return;
+        }
+
+      uerr("ERROR: stm32l4_asynch_start failed: %d\n", ret);
+      result = ret;
+    }
+
+  /* The transfer is complete, with or without an error */
+
+  uvdbg("Transfer complete:  %d\n", result);
+
+  /* Extract the callback information */
+
+  callback       = chan->callback;
+  arg            = chan->arg;
+  nbytes         = result < 0 ? (ssize_t)result : (ssize_t)chan->asxfrd;
+
+  chan->callback = NULL;
+  chan->arg      = NULL;
+  chan->xfrd     = 0;
+
+  /* Start the next queued transfer before reporting this one */
+
+  while (chan->qcount > 0)
+    {
+      xfr          = &chan->queue[chan->qhead];
+      chan->qhead  = (chan->qhead + 1) % CONFIG_STM32L4_OTGFS_ASYNCH_DEPTH;
+      chan->qcount--;
+
+      chan->asbuffer = xfr->buffer;
+      chan->asbuflen = xfr->buflen;
+      chan->asxfrd   = 0;
+      chan->callback = xfr->callback;
+      chan->arg      = xfr->arg;
+
+      ret = stm32l4_asynch_start(priv, chan);
+      if (ret >= 0)
+        {
+          break;
+        }
+
+      uerr("ERROR: stm32l4_asynch_start failed: %d\n", ret);
+
+      chan->callback = NULL;
+      chan->arg      = NULL;
+      xfr->callback(xfr->arg, ret);
+    }
+
+  /* Then perform the callback */
+
+  callback(arg, nbytes);
+}
+#endif
+
+/****************************************************************************
+ * Name: stm32l4_asynch_submit
+ *
+ * Description:
+ *   Start an asynchronous transfer or, if one is already in progress on the
+ *   channel, queue it to be started when that one completes.
+ *
+ * Assumptions:
+ *   This function is never called from an interrupt handler
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_OTGFS_ASYNCH_PIPELINE
+static int stm32l4_asynch_submit(struct stm32l4_usbhost_s *priv,
+                                 struct stm32l4_chan_s *chan,
+                                 uint8_t *buffer, size_t buflen,
+                                 usbhost_asynch_t callback, void *arg)
+{
+  struct stm32l4_asynch_s *xfr;
+  irqstate_t flags;
+  int ret;
+
+  /* The completion interrupt may dequeue at any time */
+
+  flags = enter_critical_section();
+
+  if (chan->callback != NULL)
+    {
+      if (chan->qcount >= CONFIG_STM32L4_OTGFS_ASYNCH_DEPTH)
+        {
+          leave_critical_section(flags);
+          return -EBUSY;
+        }
+
+      xfr = &chan->queue[(chan->qhead + chan->qcount) %
+                         CONFIG_STM32L4_OTGFS_ASYNCH_DEPTH];
+      xfr->buffer   = buffer;
+      xfr->buflen   = buflen;
+      xfr->callback = callback;
+      xfr->arg      = arg;
+      chan->qcount++;
+
+      leave_critical_section(flags);
+      return OK;
+    }
+
+  /* Nothing in progress.  Set up for the transfer BEFORE starting it. */
+
+  chan->asbuffer = buffer;
+  chan->asbuflen = buflen;
+  chan->asxfrd   = 0;
+
+  ret = stm32l4_chan_asynchsetup(priv, chan, callback, arg);
+  if (ret < 0)
+    {
+      uerr("ERROR: stm32l4_chan_asynchsetup failed: %d\n", ret);
+    }
+  else
+    {
+      ret = stm32l4_asynch_start(priv, chan);
+      if (ret < 0)
+        {
+          uerr("ERROR: stm32l4_asynch_start failed: %d\n", ret);
+          chan->callback = NULL;
+          chan->arg      = NULL;
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: stm32l4_gint_wrpacket
  *
@@ -4710,6 +5026,9 @@ static ssize_t stm32l4_transfer(struct usbhost_driver_s *drvr,
  *
  *   Only one transfer may be queued; Neither this method nor the ctrlin or
  *   ctrlout methods can be called again until the transfer completes.
+ *   With CONFIG_STM32L4_OTGFS_ASYNCH_PIPELINE, up to
+ *   CONFIG_STM32L4_OTGFS_ASYNCH_DEPTH further transfers may be queued on
+ *   the endpoint while one is in progress.
  *
  * Input Parameters:
  *   drvr - The USB host driver instance obtained as a parameter from the
@@ -4755,6 +5074,12 @@ static int stm32l4_asynch(struct usbhost_driver_s *drvr, usbhost_ep_t ep,
       return ret;
     }
 
+#ifdef CONFIG_STM32L4_OTGFS_ASYNCH_PIPELINE
+  /* Start the transfer or queue it behind the one in progress */
+
+  ret = stm32l4_asynch_submit(priv, &priv->chan[chidx], buffer, buflen,
+                              callback, arg);
+#else
   /* Handle IN and OUT transfer slightly differently */
 
   if (priv->chan[chidx].in)
@@ -4765,6 +5090,7 @@ static int stm32l4_asynch(struct usbhost_driver_s *drvr, usbhost_ep_t ep,
     {
       ret = stm32l4_out_asynch(priv, chidx, buffer, buflen, callback, arg);
     }
+#endif
 
   nxmutex_unlock(&priv->lock);
   return ret;
@@ -4854,6 +5180,19 @@ static int stm32l4_cancel(struct usbhost_driver_s *drvr, usbhost_ep_t ep)
     }
 #endif
 
+#ifdef CONFIG_STM32L4_OTGFS_ASYNCH_PIPELINE
+  /* Cancel the queued transfers as well */
+
+  while (chan->qcount > 0)
+    {
+      struct stm32l4_asynch_s *xfr = &chan->queue[chan->qhead];
+
+      chan->qhead = (chan->qhead + 1) % CONFIG_STM32L4_OTGFS_ASYNCH_DEPTH;
+      chan->qcount--;
+      xfr->callback(xfr->arg, -ESHUTDOWN);
+    }
+#endif
+
   leave_critical_section(flags);
   return OK;
 }
@@ -28,15 +28,38 @@
 #include <nuttx/config.h>
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "chip.h"
 #include "arm_internal.h"
 
 /****************************************************************************
- * Public Function Prototypes
+ * Public Types
  ****************************************************************************/
 
 #ifndef __ASSEMBLY__
+
+#ifdef CONFIG_STM32L4_IDLE_GOVERNOR
+/* Low power modes available to the idle governor, from the shallowest to
+ * the deepest.  Each deeper mode saves more power but takes longer to wake
+ * up from.
+ */
+
+enum stm32l4_idlemode_e
+{
+  STM32L4_IDLEMODE_SLEEP = 0,  /* Sleep: CPU clock stopped */
+  STM32L4_IDLEMODE_LPSLEEP,    /* Low-power sleep: SYSCLK at 2 MHz MSI */
+  STM32L4_IDLEMODE_STOP0,      /* Stop 0: main regulator, clocks stopped */
+  STM32L4_IDLEMODE_STOP1,      /* Stop 1: low-power regulator */
+  STM32L4_IDLEMODE_STOP2,      /* Stop 2: most peripherals powered down */
+  STM32L4_IDLEMODE_NMODES
+};
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
 #ifdef __cplusplus
 #define EXTERN extern "C"
 extern "C"
@@ -140,6 +163,64 @@ void stm32l4_pmsleep(bool sleeponexit);
 
 int stm32l4_pmlpr(void);
 
+#ifdef CONFIG_STM32L4_IDLE_GOVERNOR
+/****************************************************************************
+ * Name: stm32l4_idle_stay
+ *
+ * Description:
+ *   Prevent the idle governor from entering any mode deeper than 'mode',
+ *   e.g. while a driver needs its clocks or has a wakeup latency budget.
+ *   Calls nest and must be balanced with stm32l4_idle_relax().  This is
+ *   the idle governor's counterpart of pm_stay().
+ *
+ * Input Parameters:
+ *   mode - The deepest mode that may still be entered.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   May be called from interrupt handlers.
+ *
+ ****************************************************************************/
+
+void stm32l4_idle_stay(enum stm32l4_idlemode_e mode);
+
+/****************************************************************************
+ * Name: stm32l4_idle_relax
+ *
+ * Description:
+ *   Release a constraint taken with stm32l4_idle_stay().
+ *
+ * Input Parameters:
+ *   mode - The mode passed to stm32l4_idle_stay().
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void stm32l4_idle_relax(enum stm32l4_idlemode_e mode);
+
+/****************************************************************************
+ * Name: stm32l4_idle_latencymode
+ *
+ * Description:
+ *   Return the deepest mode whose configured wakeup latency does not exceed
+ *   'usec'.  A driver with an interrupt latency budget passes the result to
+ *   stm32l4_idle_stay()/stm32l4_idle_relax().
+ *
+ * Input Parameters:
+ *   usec - Worst case tolerable wakeup latency in microseconds.
+ *
+ * Returned Value:
+ *   The deepest mode meeting the budget; STM32L4_IDLEMODE_SLEEP at least.
+ *
+ ****************************************************************************/
+
+enum stm32l4_idlemode_e stm32l4_idle_latencymode(uint32_t usec);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -0,0 +1,368 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_profile.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/param.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/fs/fs.h>
+
+#include "arm_internal.h"
+#include "stm32l4_tim.h"
+#include "stm32l4_profile.h"
+
+#ifdef CONFIG_STM32L4_PROFILE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PROFILE_SHIFT      CONFIG_STM32L4_PROFILE_SHIFT
+
+/* gmon.out layout:  The file header, then one histogram record made of a
+ * tag byte, the histogram header and the 16-bit bins.  All fields are in
+ * target byte order.
+ */
+
+#define GMON_MAGIC         "gmon"
+#define GMON_VERSION       1
+#define GMON_TAG_TIME_HIST 0
+
+#define GMON_HDR_SIZE      20               /* cookie, version, spare[3] */
+#define GMON_HIST_SIZE     32               /* low, high, size, rate, dimen */
+#define PROFILE_HDR_SIZE   (GMON_HDR_SIZE + 1 + GMON_HIST_SIZE)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct stm32l4_profile_s
+{
+  mutex_t lock;                     /* Serializes the file operations */
+  struct stm32l4_tim_dev_s *tim;    /* Sampling timer while running */
+  uintptr_t lowpc;                  /* Address of the first bin */
+  size_t nbins;                     /* Number of bins, 0 until started */
+  uint16_t *bins;                   /* Sample counts */
+  uint32_t missed;                  /* Samples outside of the text */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int stm32l4_profile_interrupt(int irq, void *context, void *arg);
+static ssize_t stm32l4_profile_read(struct file *filep, char *buffer,
+                                    size_t buflen);
+static ssize_t stm32l4_profile_write(struct file *filep,
+                                     const char *buffer, size_t buflen);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct stm32l4_profile_s g_profile =
+{
+  .lock = NXMUTEX_INITIALIZER,
+};
+
+static const struct file_operations g_profile_fops =
+{
+  NULL,                   /* open */
+  NULL,                   /* close */
+  stm32l4_profile_read,   /* read */
+  stm32l4_profile_write,  /* write */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4_profile_interrupt
+ *
+ * Description:
+ *   Count the PC of the interrupted context in its bin.  The bins saturate
+ *   instead of wrapping.
+ *
+ ****************************************************************************/
+
+static int stm32l4_profile_interrupt(int irq, void *context, void *arg)
+{
+  struct stm32l4_profile_s *priv = (struct stm32l4_profile_s *)arg;
+  uint32_t *regs = (uint32_t *)context;
+  size_t index;
+
+  index = (regs[REG_PC] - priv->lowpc) >> PROFILE_SHIFT;
+  if (index < priv->nbins)
+    {
+      if (priv->bins[index] < UINT16_MAX)
+        {
+          priv->bins[index]++;
+        }
+    }
+  else
+    {
+      priv->missed++;
+    }
+
+  STM32L4_TIM_ACKINT(priv->tim, 0);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4_profile_start
+ ****************************************************************************/
+
+static int stm32l4_profile_start(struct stm32l4_profile_s *priv)
+{
+  if (priv->tim != NULL)
+    {
+      return OK;
+    }
+
+  /* Allocate the histogram for the whole text on first use */
+
+  if (priv->bins == NULL)
+    {
+      size_t nbins = (((uintptr_t)_etext - (uintptr_t)_stext) >>
+                      PROFILE_SHIFT) + 1;
+
+      priv->bins = kmm_zalloc(nbins * sizeof(uint16_t));
+      if (priv->bins == NULL)
+        {
+          _err("ERROR: No memory for %zu bins\n", nbins);
+          return -ENOMEM;
+        }
+
+      priv->lowpc = (uintptr_t)_stext;
+      priv->nbins = nbins;
+    }
+
+  priv->tim = stm32l4_tim_init(CONFIG_STM32L4_PROFILE_TIMER);
+  if (priv->tim == NULL)
+    {
+      _err("ERROR: TIM%d is not available\n", CONFIG_STM32L4_PROFILE_TIMER);
+      return -EBUSY;
+    }
+
+  STM32L4_TIM_SETISR(priv->tim, stm32l4_profile_interrupt, priv, 0);
+  STM32L4_TIM_SETFREQ(priv->tim, CONFIG_STM32L4_PROFILE_FREQUENCY);
+  STM32L4_TIM_ACKINT(priv->tim, 0);
+  STM32L4_TIM_ENABLEINT(priv->tim, 0);
+  STM32L4_TIM_SETMODE(priv->tim, STM32L4_TIM_MODE_UP);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4_profile_stop
+ ****************************************************************************/
+
+static void stm32l4_profile_stop(struct stm32l4_profile_s *priv)
+{
+  if (priv->tim != NULL)
+    {
+      STM32L4_TIM_DISABLEINT(priv->tim, 0);
+      STM32L4_TIM_SETMODE(priv->tim, STM32L4_TIM_MODE_DISABLED);
+      STM32L4_TIM_SETISR(priv->tim, NULL, NULL, 0);
+      stm32l4_tim_deinit(priv->tim);
+      priv->tim = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: stm32l4_profile_header
+ *
+ * Description:
+ *   Format the gmon.out file header and the histogram record header.
+ *
+ ****************************************************************************/
+
+static void stm32l4_profile_header(struct stm32l4_profile_s *priv,
+                                   uint8_t *hdr)
+{
+  uint32_t lowpc  = priv->lowpc;
+  uint32_t highpc = priv->lowpc + (priv->nbins << PROFILE_SHIFT);
+  uint32_t nbins  = priv->nbins;
+  uint32_t value;
+
+  memset(hdr, 0, PROFILE_HDR_SIZE);
+
+  memcpy(hdr, GMON_MAGIC, 4);
+  value = GMON_VERSION;
+  memcpy(hdr + 4, &value, 4);
+  hdr += GMON_HDR_SIZE;
+
+  *hdr++ = GMON_TAG_TIME_HIST;
+
+  memcpy(hdr, &lowpc, 4);
+  memcpy(hdr + 4, &highpc, 4);
+  memcpy(hdr + 8, &nbins, 4);
+  value = CONFIG_STM32L4_PROFILE_FREQUENCY;
+  memcpy(hdr + 12, &value, 4);
+  memcpy(hdr + 16, "seconds", 7);
+  hdr[31] = 's';
+}
+
+/****************************************************************************
+ * Name: stm32l4_profile_read
+ *
+ * Description:
+ *   Return the gmon.out image.  The histogram should be read after
+ *   sampling has been stopped; otherwise it keeps changing while it is
+ *   read.
+ *
+ ****************************************************************************/
+
+static ssize_t stm32l4_profile_read(struct file *filep, char *buffer,
+                                    size_t buflen)
+{
+  struct stm32l4_profile_s *priv = filep->f_inode->i_private;
+  uint8_t hdr[PROFILE_HDR_SIZE];
+  size_t total;
+  size_t nread = 0;
+  size_t pos;
+  size_t len;
+  int ret;
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  total = PROFILE_HDR_SIZE + priv->nbins * sizeof(uint16_t);
+  pos   = filep->f_pos;
+
+  if (pos < PROFILE_HDR_SIZE)
+    {
+      stm32l4_profile_header(priv, hdr);
+
+      len = MIN(PROFILE_HDR_SIZE - pos, buflen);
+      memcpy(buffer, hdr + pos, len);
+      nread += len;
+      pos   += len;
+    }
+
+  if (pos < total && nread < buflen)
+    {
+      len = MIN(total - pos, buflen - nread);
+      memcpy(buffer + nread,
+             (uint8_t *)priv->bins + (pos - PROFILE_HDR_SIZE), len);
+      nread += len;
+    }
+
+  filep->f_pos += nread;
+  nxmutex_unlock(&priv->lock);
+  return nread;
+}
+
+/****************************************************************************
+ * Name: stm32l4_profile_write
+ *
+ * Description:
+ *   Accept the commands "start", "stop" and "reset".  Reset clears the
+ *   histogram but leaves the sampling state unchanged.
+ *
+ ****************************************************************************/
+
+static ssize_t stm32l4_profile_write(struct file *filep,
+                                     const char *buffer, size_t buflen)
+{
+  struct stm32l4_profile_s *priv = filep->f_inode->i_private;
+  irqstate_t flags;
+  size_t len = buflen;
+  int ret;
+
+  /* Ignore the trailing newline of "echo" */
+
+  while (len > 0 && isspace((unsigned char)buffer[len - 1]))
+    {
+      len--;
+    }
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (len == 5 && strncmp(buffer, "start", 5) == 0)
+    {
+      ret = stm32l4_profile_start(priv);
+    }
+  else if (len == 4 && strncmp(buffer, "stop", 4) == 0)
+    {
+      stm32l4_profile_stop(priv);
+      _info("%" PRIu32 " samples outside of the text\n", priv->missed);
+    }
+  else if (len == 5 && strncmp(buffer, "reset", 5) == 0)
+    {
+      flags = enter_critical_section();
+      if (priv->bins != NULL)
+        {
+          memset(priv->bins, 0, priv->nbins * sizeof(uint16_t));
+        }
+
+      priv->missed = 0;
+      leave_critical_section(flags);
+    }
+  else
+    {
+      ret = -EINVAL;
+    }
+
+  nxmutex_unlock(&priv->lock);
+  return ret < 0 ? ret : buflen;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4_profile_initialize
+ *
+ * Description:
+ *   Register the sampling profiler as /dev/profile.
+ *
+ ****************************************************************************/
+
+int stm32l4_profile_initialize(void)
+{
+  return register_driver("/dev/profile", &g_profile_fops, 0666, &g_profile);
+}
+
+#endif /* CONFIG_STM32L4_PROFILE */
@@ -0,0 +1,79 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_profile.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_SRC_STM32L4_STM32L4_PROFILE_H
+#define __ARCH_ARM_SRC_STM32L4_STM32L4_PROFILE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#ifdef CONFIG_STM32L4_PROFILE
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifndef __ASSEMBLY__
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: stm32l4_profile_initialize
+ *
+ * Description:
+ *   Register the sampling profiler as /dev/profile.  Sampling is
+ *   controlled by writing "start", "stop" or "reset" to the device.
+ *   Reading returns the PC histogram in the gmon.out format of gprof:
+ *
+ *     echo start >/dev/profile
+ *     ... run the workload ...
+ *     echo stop >/dev/profile
+ *     cp /dev/profile /mnt/sd/gmon.out
+ *
+ *   and on the host: arm-none-eabi-gprof -b nuttx gmon.out
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int stm32l4_profile_initialize(void);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __ASSEMBLY__ */
+#endif /* CONFIG_STM32L4_PROFILE */
+#endif /* __ARCH_ARM_SRC_STM32L4_STM32L4_PROFILE_H */
@@ -32,12 +32,14 @@
 #include <debug.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/timers/pwm.h>
 #include <arch/board/board.h>
 
 #include "arm_internal.h"
 #include "chip.h"
 #include "stm32l4_pwm.h"
+#include "stm32l4_dma.h"
 #include "stm32l4.h"
 
 /* This module then only compiles if there is at least one enabled timer
@@ -116,6 +118,16 @@
 #  endif
 #endif
 
+/* Sequence support.  The DMA request of the update event writes the
+ * CCR1.. registers of the next period through DMAR.
+ */
+
+#ifdef CONFIG_PWM_SEQUENCE
+#  define HAVE_PWM_SEQUENCE
+#  define PWM_SEQ_DBA        (STM32L4_GTIM_CCR1_OFFSET >> 2)
+#  define PWM_SEQ_MAXCHAN    4
+#endif
+
 /* Synchronisation support */
 
 #ifdef CONFIG_STM32L4_PWM_TRGO
@@ -208,6 +220,13 @@ struct stm32l4_pwmtimer_s
 #ifdef CONFIG_PWM_PULSECOUNT
   void *handle;                    /* Handle used for upper-half callback */
 #endif
+#ifdef HAVE_PWM_SEQUENCE
+  bool       seqdma;               /* The update event has a DMA request */
+  uint32_t   seqchan;              /* DMA request of the update event */
+  DMA_HANDLE dma;                  /* DMA of the running sequence */
+  void      *seqbuf;               /* CCR values of the running sequence */
+  void      *seqhandle;            /* Handle used for upper-half callback */
+#endif
 };
 
 /****************************************************************************
@@ -296,6 +315,11 @@ static int pwm_start(struct pwm_lowerhalf_s *dev,
 static int pwm_stop(struct pwm_lowerhalf_s *dev);
 static int pwm_ioctl(struct pwm_lowerhalf_s *dev,
                      int cmd, unsigned long arg);
+#ifdef HAVE_PWM_SEQUENCE
+static int pwm_sequence(struct pwm_lowerhalf_s *dev,
+                        const struct pwm_sequence_s *seq,
+                        void *handle);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -312,6 +336,9 @@ static const struct pwm_ops_s g_pwmops =
   .start       = pwm_start,
   .stop        = pwm_stop,
   .ioctl       = pwm_ioctl,
+#ifdef HAVE_PWM_SEQUENCE
+  .sequence    = pwm_sequence,
+#endif
 };
 
 #ifdef CONFIG_STM32L4_PWM_LL_OPS
@@ -500,6 +527,10 @@ static struct stm32l4_pwmtimer_s g_pwm1dev =
 #endif
   .base        = STM32L4_TIM1_BASE,
   .pclk        = STM32L4_APB2_TIM1_CLKIN,
+#if defined(HAVE_PWM_SEQUENCE) && defined(DMACHAN_TIM1_UP)
+  .seqdma      = true,
+  .seqchan     = DMACHAN_TIM1_UP,
+#endif
 };
 #endif /* CONFIG_STM32L4_TIM1_PWM */
 
@@ -599,6 +630,10 @@ static struct stm32l4_pwmtimer_s g_pwm2dev =
 #endif
   .base        = STM32L4_TIM2_BASE,
   .pclk        = STM32L4_APB1_TIM2_CLKIN,
+#if defined(HAVE_PWM_SEQUENCE) && defined(DMACHAN_TIM2_UP)
+  .seqdma      = true,
+  .seqchan     = DMACHAN_TIM2_UP,
+#endif
 };
 
 #endif /* CONFIG_STM32L4_TIM2_PWM */
@@ -699,6 +734,10 @@ static struct stm32l4_pwmtimer_s g_pwm3dev =
 #endif
   .base        = STM32L4_TIM3_BASE,
   .pclk        = STM32L4_APB1_TIM3_CLKIN,
+#if defined(HAVE_PWM_SEQUENCE) && defined(DMACHAN_TIM3_UP)
+  .seqdma      = true,
+  .seqchan     = DMACHAN_TIM3_UP,
+#endif
 };
 #endif /* CONFIG_STM32L4_TIM3_PWM */
 
@@ -798,6 +837,10 @@ static struct stm32l4_pwmtimer_s g_pwm4dev =
 #endif
   .base        = STM32L4_TIM4_BASE,
   .pclk        = STM32L4_APB1_TIM4_CLKIN,
+#if defined(HAVE_PWM_SEQUENCE) && defined(DMACHAN_TIM4_UP)
+  .seqdma      = true,
+  .seqchan     = DMACHAN_TIM4_UP,
+#endif
 };
 #endif /* CONFIG_STM32L4_TIM4_PWM */
 
@@ -895,6 +938,10 @@ static struct stm32l4_pwmtimer_s g_pwm5dev =
 #endif
   .base        = STM32L4_TIM5_BASE,
   .pclk        = STM32L4_APB1_TIM5_CLKIN,
+#if defined(HAVE_PWM_SEQUENCE) && defined(DMACHAN_TIM5_UP)
+  .seqdma      = true,
+  .seqchan     = DMACHAN_TIM5_UP,
+#endif
 };
 #endif /* CONFIG_STM32L4_TIM5_PWM */
 
@@ -1061,6 +1108,10 @@ static struct stm32l4_pwmtimer_s g_pwm8dev =
 #endif
   .base        = STM32L4_TIM8_BASE,
   .pclk        = STM32L4_APB2_TIM8_CLKIN,
+#if defined(HAVE_PWM_SEQUENCE) && defined(DMACHAN_TIM8_UP)
+  .seqdma      = true,
+  .seqchan     = DMACHAN_TIM8_UP,
+#endif
 };
 #endif /* CONFIG_STM32L4_TIM8_PWM */
 
@@ -1146,6 +1197,10 @@ static struct stm32l4_pwmtimer_s g_pwm15dev =
 #endif
   .base        = STM32L4_TIM15_BASE,
   .pclk        = STM32L4_APB2_TIM15_CLKIN,
+#if defined(HAVE_PWM_SEQUENCE) && defined(DMACHAN_TIM15_UP)
+  .seqdma      = true,
+  .seqchan     = DMACHAN_TIM15_UP,
+#endif
 };
 #endif /* CONFIG_STM32L4_TIM15_PWM */
 
@@ -1215,6 +1270,10 @@ static struct stm32l4_pwmtimer_s g_pwm16dev =
 #endif
   .base        = STM32L4_TIM16_BASE,
   .pclk        = STM32L4_APB2_TIM16_CLKIN,
+#if defined(HAVE_PWM_SEQUENCE) && defined(DMACHAN_TIM16_UP)
+  .seqdma      = true,
+  .seqchan     = DMACHAN_TIM16_UP,
+#endif
 };
 #endif /* CONFIG_STM32L4_TIM16_PWM */
 
@@ -1284,6 +1343,10 @@ static struct stm32l4_pwmtimer_s g_pwm17dev =
 #endif
   .base        = STM32L4_TIM17_BASE,
   .pclk        = STM32L4_APB2_TIM17_CLKIN,
+#if defined(HAVE_PWM_SEQUENCE) && defined(DMACHAN_TIM17_UP)
+  .seqdma      = true,
+  .seqchan     = DMACHAN_TIM17_UP,
+#endif
 };
 #endif /* CONFIG_STM32L4_TIM17_PWM */
 
@@ -3697,6 +3760,226 @@ errout:
   return ret;
 }
 
+#ifdef HAVE_PWM_SEQUENCE
+
+/****************************************************************************
+ * Name: pwm_seqrelease
+ *
+ * Description:
+ *   Stop the DMA of a sequence and release its channel and buffer.  The
+ *   output keeps the duty cycles last loaded.
+ *
+ * Input Parameters:
+ *   priv - A reference to the lower half PWM driver state structure
+ *
+ ****************************************************************************/
+
+static void pwm_seqrelease(struct stm32l4_pwmtimer_s *priv)
+{
+  pwm_modifyreg(priv, STM32L4_GTIM_DIER_OFFSET, GTIM_DIER_UDE, 0);
+  pwm_putreg(priv, STM32L4_GTIM_DCR_OFFSET, 0);
+
+  stm32l4_dmastop(priv->dma);
+  stm32l4_dmafree(priv->dma);
+  kmm_free(priv->seqbuf);
+
+  priv->dma    = NULL;
+  priv->seqbuf = NULL;
+}
+
+/****************************************************************************
+ * Name: pwm_seqcallback
+ *
+ * Description:
+ *   The DMA has written the CCR values of the last period of a sequence.
+ *
+ ****************************************************************************/
+
+static void pwm_seqcallback(DMA_HANDLE handle, uint8_t status, void *arg)
+{
+  struct stm32l4_pwmtimer_s *priv = (struct stm32l4_pwmtimer_s *)arg;
+
+  if ((status & DMA_STATUS_TEIF) != 0)
+    {
+      pwmerr("ERROR: TIM%u sequence DMA error\n", priv->timid);
+    }
+
+  if (priv->dma != NULL)
+    {
+      pwm_seqrelease(priv);
+      pwm_sequence_done(priv->seqhandle);
+    }
+}
+
+/****************************************************************************
+ * Name: pwm_sequence
+ *
+ * Description:
+ *   Start the pulsed output with a new duty cycle for each period.  The
+ *   duty cycles are converted to CCR values in a buffer of our own.  The
+ *   first period is written to the CCR registers; at each update event
+ *   the DMA then writes the following period to the preload registers
+ *   through DMAR, so that it applies from the next update event on.
+ *
+ * Input Parameters:
+ *   dev    - A reference to the lower half PWM driver state structure
+ *   seq    - The sequence of duty cycles
+ *   handle - Handle passed to pwm_sequence_done()
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure
+ *
+ ****************************************************************************/
+
+static int pwm_sequence(struct pwm_lowerhalf_s *dev,
+                        const struct pwm_sequence_s *seq,
+                        void *handle)
+{
+  struct stm32l4_pwmtimer_s *priv = (struct stm32l4_pwmtimer_s *)dev;
+  uint16_t *buf16;
+  uint32_t *buf32;
+  uint32_t  reload;
+  uint32_t  ccr;
+  uint32_t  src;
+  uint32_t  dmaccr;
+  size_t    ntotal;
+  size_t    count;
+  size_t    i;
+  bool      wide;
+  int       ret;
+
+  DEBUGASSERT(priv != NULL && seq != NULL);
+
+  if (!priv->seqdma)
+    {
+      pwmerr("ERROR: TIM%u has no update DMA request\n", priv->timid);
+      return -ENOSYS;
+    }
+
+  if (seq->nchannels > PWM_SEQ_MAXCHAN)
+    {
+      return -EINVAL;
+    }
+
+  if (priv->dma != NULL)
+    {
+      return -EBUSY;
+    }
+
+  /* The CCR registers of TIM2 and TIM5 are 32-bit wide */
+
+  wide   = priv->timtype == TIMTYPE_GENERAL32;
+  ntotal = (size_t)seq->nperiods * seq->nchannels;
+
+  priv->seqbuf = kmm_malloc(ntotal * (wide ? 4 : 2));
+  if (priv->seqbuf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  priv->dma = stm32l4_dmachannel(priv->seqchan);
+  if (priv->dma == NULL)
+    {
+      pwmerr("ERROR: TIM%u no DMA channel\n", priv->timid);
+      kmm_free(priv->seqbuf);
+      priv->seqbuf = NULL;
+      return -EBUSY;
+    }
+
+  ret = pwm_frequency_update(dev, seq->frequency);
+  if (ret < 0)
+    {
+      pwm_seqrelease(priv);
+      return ret;
+    }
+
+  /* Convert the duty cycles with the new reload value */
+
+  reload = pwm_arr_get(dev);
+  buf16  = (uint16_t *)priv->seqbuf;
+  buf32  = (uint32_t *)priv->seqbuf;
+
+  for (i = 0; i < ntotal; i++)
+    {
+      ccr = b16toi((uint64_t)seq->duty[i] * reload + b16HALF);
+      if (wide)
+        {
+          buf32[i] = ccr;
+        }
+      else
+        {
+          buf16[i] = (uint16_t)ccr;
+        }
+    }
+
+  /* Load the first period now */
+
+  for (i = 0; i < seq->nchannels; i++)
+    {
+      pwm_ccr_update(dev, i + 1, wide ? buf32[i] : buf16[i]);
+    }
+
+  /* The DMA starts with the second period.  A sequence of one period is
+   * written once more, so that its completion is still reported by the
+   * DMA.
+   */
+
+  if (seq->nperiods > 1)
+    {
+      src   = (uint32_t)priv->seqbuf + seq->nchannels * (wide ? 4 : 2);
+      count = ntotal - seq->nchannels;
+    }
+  else
+    {
+      src   = (uint32_t)priv->seqbuf;
+      count = ntotal;
+    }
+
+  dmaccr = DMA_CCR_DIR | DMA_CCR_MINC | DMA_CCR_PRIHI;
+  dmaccr |= wide ? (DMA_CCR_PSIZE_32BITS | DMA_CCR_MSIZE_32BITS) :
+                   (DMA_CCR_PSIZE_16BITS | DMA_CCR_MSIZE_16BITS);
+
+  pwm_putreg(priv, STM32L4_GTIM_DCR_OFFSET,
+             (PWM_SEQ_DBA << GTIM_DCR_DBA_SHIFT) |
+             ((seq->nchannels - 1) << GTIM_DCR_DBL_SHIFT));
+
+  priv->seqhandle = handle;
+  stm32l4_dmasetup(priv->dma, priv->base + STM32L4_GTIM_DMAR_OFFSET,
+                   src, count, dmaccr);
+  stm32l4_dmastart(priv->dma, pwm_seqcallback, priv, false);
+
+  pwm_modifyreg(priv, STM32L4_GTIM_DIER_OFFSET, 0, GTIM_DIER_UDE);
+
+#ifdef HAVE_ADVTIM
+  if (priv->timtype == TIMTYPE_ADVANCED ||
+      priv->timtype == TIMTYPE_COUNTUP16_N)
+    {
+      pwm_putreg(priv, STM32L4_ATIM_RCR_OFFSET, 0);
+    }
+#endif
+
+  /* The update event loads the first period and requests the second */
+
+  pwm_soft_update(dev);
+
+  ret = pwm_outputs_enable(dev, pwm_outputs_from_channels(priv), true);
+  if (ret < 0)
+    {
+      pwm_seqrelease(priv);
+      return ret;
+    }
+
+  pwm_timer_enable(dev, true);
+
+#ifndef CONFIG_PWM_PULSECOUNT
+  priv->frequency = seq->frequency;
+#endif
+
+  pwm_dumpregs(dev, "After starting sequence");
+  return OK;
+}
+#endif /* HAVE_PWM_SEQUENCE */
+
 /****************************************************************************
  * Name: pwm_setup
  *
@@ -4089,6 +4372,15 @@ static int pwm_stop(struct pwm_lowerhalf_s *dev)
   priv->frequency = 0;
 #endif
 
+#ifdef HAVE_PWM_SEQUENCE
+  /* Abort a running sequence */
+
+  if (priv->dma != NULL)
+    {
+      pwm_seqrelease(priv);
+    }
+#endif
+
   /* Disable further interrupts and stop the timer */
 
   pwm_putreg(priv, STM32L4_GTIM_DIER_OFFSET, 0);
@@ -86,6 +86,62 @@
 #  define HAVE_MIXEDWIDTH_TIMERS 1
 #endif
 
+/* Index inputs *************************************************************/
+
+#if defined(CONFIG_STM32L4_TIM1_QE_INDEX) || \
+    defined(CONFIG_STM32L4_TIM2_QE_INDEX) || \
+    defined(CONFIG_STM32L4_TIM3_QE_INDEX) || \
+    defined(CONFIG_STM32L4_TIM4_QE_INDEX) || \
+    defined(CONFIG_STM32L4_TIM5_QE_INDEX) || \
+    defined(CONFIG_STM32L4_TIM8_QE_INDEX)
+#  define HAVE_QE_INDEX 1
+#endif
+
+/* Interrupts are needed to extend 16-bit counters and to record the index;
+ * both keep a software offset to the position.
+ */
+
+#if defined(HAVE_16BIT_TIMERS) || defined(HAVE_QE_INDEX)
+#  define HAVE_QE_INTERRUPT 1
+#endif
+
+/* Velocity timers **********************************************************/
+
+#ifndef CONFIG_STM32L4_TIM1_QE_VELTIM
+#  define CONFIG_STM32L4_TIM1_QE_VELTIM 0
+#endif
+#ifndef CONFIG_STM32L4_TIM2_QE_VELTIM
+#  define CONFIG_STM32L4_TIM2_QE_VELTIM 0
+#endif
+#ifndef CONFIG_STM32L4_TIM3_QE_VELTIM
+#  define CONFIG_STM32L4_TIM3_QE_VELTIM 0
+#endif
+#ifndef CONFIG_STM32L4_TIM4_QE_VELTIM
+#  define CONFIG_STM32L4_TIM4_QE_VELTIM 0
+#endif
+#ifndef CONFIG_STM32L4_TIM5_QE_VELTIM
+#  define CONFIG_STM32L4_TIM5_QE_VELTIM 0
+#endif
+#ifndef CONFIG_STM32L4_TIM8_QE_VELTIM
+#  define CONFIG_STM32L4_TIM8_QE_VELTIM 0
+#endif
+
+#if (defined(CONFIG_STM32L4_TIM1_QE) && CONFIG_STM32L4_TIM1_QE_VELTIM != 0) || \
+    (defined(CONFIG_STM32L4_TIM2_QE) && CONFIG_STM32L4_TIM2_QE_VELTIM != 0) || \
+    (defined(CONFIG_STM32L4_TIM3_QE) && CONFIG_STM32L4_TIM3_QE_VELTIM != 0) || \
+    (defined(CONFIG_STM32L4_TIM4_QE) && CONFIG_STM32L4_TIM4_QE_VELTIM != 0) || \
+    (defined(CONFIG_STM32L4_TIM5_QE) && CONFIG_STM32L4_TIM5_QE_VELTIM != 0) || \
+    (defined(CONFIG_STM32L4_TIM8_QE) && CONFIG_STM32L4_TIM8_QE_VELTIM != 0)
+#  define HAVE_QE_VELOCITY 1
+#endif
+
+/* The velocity timer is reset by each rising edge of TI1 and captures the
+ * elapsed time in CCR1.  An overflow means that the encoder stopped; two
+ * more edges are then needed for a valid period.
+ */
+
+#define QE_VELVALID           2
+
 /* Input filter *************************************************************/
 
 #ifdef CONFIG_STM32L4_QENCODER_FILTER
@@ -185,6 +241,15 @@ struct stm32l4_qeconfig_s
   uint32_t ti2cfg;  /* TI2 input pin configuration (20-bit encoding) */
   uint32_t base;    /* Register base address */
   uint32_t psc;     /* Encoder pulses prescaler */
+#ifdef HAVE_QE_INDEX
+  uint8_t  ccirq;   /* Timer capture/compare IRQ */
+  uint32_t ti3cfg;  /* Index input pin configuration, zero if none */
+#endif
+#ifdef HAVE_QE_VELOCITY
+  uint8_t  veltim;  /* Velocity timer number, zero if none */
+  uint8_t  velitr;  /* Trigger input of the velocity timer */
+  uint32_t velclk;  /* Velocity timer frequency */
+#endif
 };
 
 /* Overall, RAM-based state structure */
@@ -203,9 +268,24 @@ struct stm32l4_lowerhalf_s
 
   bool             inuse;    /* True: The lower-half driver is in-use */
 
-#ifdef HAVE_16BIT_TIMERS
+#ifdef HAVE_QE_INTERRUPT
   volatile int32_t position; /* The current position offset */
 #endif
+
+#ifdef HAVE_QE_INDEX
+  bool             indexset; /* True: The index sets the position */
+  int32_t          indexoff; /* Position assigned to the index */
+  volatile int32_t indexpos; /* Position at the last index pulse */
+  volatile int16_t indexcnt; /* Number of index pulses */
+#endif
+
+#ifdef HAVE_QE_VELOCITY
+  struct stm32l4_tim_dev_s *vel; /* Velocity timer, NULL if none */
+  uint32_t         velbase;      /* Velocity timer register base */
+  uint32_t         velmask;      /* Velocity timer counter range */
+  uint32_t         period;       /* Last valid period in ticks */
+  uint8_t          velvalid;     /* Edges seen since the last overflow */
+#endif
 };
 
 /****************************************************************************
@@ -234,10 +314,24 @@ static struct stm32l4_lowerhalf_s *stm32l4_tim2lower(int tim);
 
 /* Interrupt handling */
 
-#ifdef HAVE_16BIT_TIMERS
+#ifdef HAVE_QE_INTERRUPT
+static bool stm32l4_needirq(struct stm32l4_lowerhalf_s *priv);
+static bool stm32l4_overflow(struct stm32l4_lowerhalf_s *priv,
+                             uint16_t status);
 static int stm32l4_interrupt(int irq, void *context, void *arg);
 #endif
 
+/* Sampling */
+
+static int32_t stm32l4_sample(struct stm32l4_lowerhalf_s *priv,
+                              struct stm32l4_qe_state_s *state);
+#ifdef HAVE_QE_VELOCITY
+static void stm32l4_velocity(struct stm32l4_lowerhalf_s *priv,
+                             struct stm32l4_qe_state_s *state);
+static int stm32l4_velsetup(struct stm32l4_lowerhalf_s *priv);
+static void stm32l4_velshutdown(struct stm32l4_lowerhalf_s *priv);
+#endif
+
 /* Lower-half Quadrature Encoder Driver Methods */
 
 static int stm32l4_setup(struct qe_lowerhalf_s *lower);
@@ -245,6 +339,9 @@ static int stm32l4_shutdown(struct qe_lowerhalf_s *lower);
 static int stm32l4_position(struct qe_lowerhalf_s *lower,
                             int32_t *pos);
 static int stm32l4_reset(struct qe_lowerhalf_s *lower);
+#ifdef HAVE_QE_INDEX
+static int stm32l4_setindex(struct qe_lowerhalf_s *lower, uint32_t pos);
+#endif
 static int stm32l4_ioctl(struct qe_lowerhalf_s *lower, int cmd,
                          unsigned long arg);
 
@@ -261,7 +358,11 @@ static const struct qe_ops_s g_qecallbacks =
   .position  = stm32l4_position,
   .setposmax = NULL,            /* not supported yet */
   .reset     = stm32l4_reset,
+#ifdef HAVE_QE_INDEX
+  .setindex  = stm32l4_setindex,
+#else
   .setindex  = NULL,            /* not supported yet */
+#endif
   .ioctl     = stm32l4_ioctl,
 };
 
@@ -279,6 +380,17 @@ static const struct stm32l4_qeconfig_s g_tim1config =
   .psc      = CONFIG_STM32L4_TIM1_QEPSC,
   .ti1cfg   = GPIO_TIM1_CH1IN,
   .ti2cfg   = GPIO_TIM1_CH2IN,
+#ifdef HAVE_QE_INDEX
+  .ccirq    = STM32L4_IRQ_TIM1CC,
+#ifdef CONFIG_STM32L4_TIM1_QE_INDEX
+  .ti3cfg   = GPIO_TIM1_CH3IN,
+#endif
+#endif
+#if defined(HAVE_QE_VELOCITY) && CONFIG_STM32L4_TIM1_QE_VELTIM != 0
+  .veltim   = CONFIG_STM32L4_TIM1_QE_VELTIM,
+  .velitr   = CONFIG_STM32L4_TIM1_QE_VELITR,
+  .velclk   = CONFIG_STM32L4_TIM1_QE_VELCLOCK,
+#endif
 };
 
 static struct stm32l4_lowerhalf_s g_tim1lower =
@@ -302,6 +414,17 @@ static const struct stm32l4_qeconfig_s g_tim2config =
   .psc      = CONFIG_STM32L4_TIM2_QEPSC,
   .ti1cfg   = GPIO_TIM2_CH1IN,
   .ti2cfg   = GPIO_TIM2_CH2IN,
+#ifdef HAVE_QE_INDEX
+  .ccirq    = STM32L4_IRQ_TIM2,
+#ifdef CONFIG_STM32L4_TIM2_QE_INDEX
+  .ti3cfg   = GPIO_TIM2_CH3IN,
+#endif
+#endif
+#if defined(HAVE_QE_VELOCITY) && CONFIG_STM32L4_TIM2_QE_VELTIM != 0
+  .veltim   = CONFIG_STM32L4_TIM2_QE_VELTIM,
+  .velitr   = CONFIG_STM32L4_TIM2_QE_VELITR,
+  .velclk   = CONFIG_STM32L4_TIM2_QE_VELCLOCK,
+#endif
 };
 
 static struct stm32l4_lowerhalf_s g_tim2lower =
@@ -325,6 +448,17 @@ static const struct stm32l4_qeconfig_s g_tim3config =
   .psc      = CONFIG_STM32L4_TIM3_QEPSC,
   .ti1cfg   = GPIO_TIM3_CH1IN,
   .ti2cfg   = GPIO_TIM3_CH2IN,
+#ifdef HAVE_QE_INDEX
+  .ccirq    = STM32L4_IRQ_TIM3,
+#ifdef CONFIG_STM32L4_TIM3_QE_INDEX
+  .ti3cfg   = GPIO_TIM3_CH3IN,
+#endif
+#endif
+#if defined(HAVE_QE_VELOCITY) && CONFIG_STM32L4_TIM3_QE_VELTIM != 0
+  .veltim   = CONFIG_STM32L4_TIM3_QE_VELTIM,
+  .velitr   = CONFIG_STM32L4_TIM3_QE_VELITR,
+  .velclk   = CONFIG_STM32L4_TIM3_QE_VELCLOCK,
+#endif
 };
 
 static struct stm32l4_lowerhalf_s g_tim3lower =
@@ -348,6 +482,17 @@ static const struct stm32l4_qeconfig_s g_tim4config =
   .psc      = CONFIG_STM32L4_TIM4_QEPSC,
   .ti1cfg   = GPIO_TIM4_CH1IN,
   .ti2cfg   = GPIO_TIM4_CH2IN,
+#ifdef HAVE_QE_INDEX
+  .ccirq    = STM32L4_IRQ_TIM4,
+#ifdef CONFIG_STM32L4_TIM4_QE_INDEX
+  .ti3cfg   = GPIO_TIM4_CH3IN,
+#endif
+#endif
+#if defined(HAVE_QE_VELOCITY) && CONFIG_STM32L4_TIM4_QE_VELTIM != 0
+  .veltim   = CONFIG_STM32L4_TIM4_QE_VELTIM,
+  .velitr   = CONFIG_STM32L4_TIM4_QE_VELITR,
+  .velclk   = CONFIG_STM32L4_TIM4_QE_VELCLOCK,
+#endif
 };
 
 static struct stm32l4_lowerhalf_s g_tim4lower =
@@ -371,6 +516,17 @@ static const struct stm32l4_qeconfig_s g_tim5config =
   .psc      = CONFIG_STM32L4_TIM5_QEPSC,
   .ti1cfg   = GPIO_TIM5_CH1IN,
   .ti2cfg   = GPIO_TIM5_CH2IN,
+#ifdef HAVE_QE_INDEX
+  .ccirq    = STM32L4_IRQ_TIM5,
+#ifdef CONFIG_STM32L4_TIM5_QE_INDEX
+  .ti3cfg   = GPIO_TIM5_CH3IN,
+#endif
+#endif
+#if defined(HAVE_QE_VELOCITY) && CONFIG_STM32L4_TIM5_QE_VELTIM != 0
+  .veltim   = CONFIG_STM32L4_TIM5_QE_VELTIM,
+  .velitr   = CONFIG_STM32L4_TIM5_QE_VELITR,
+  .velclk   = CONFIG_STM32L4_TIM5_QE_VELCLOCK,
+#endif
 };
 
 static struct stm32l4_lowerhalf_s g_tim5lower =
@@ -394,6 +550,17 @@ static const struct stm32l4_qeconfig_s g_tim8config =
   .psc      = CONFIG_STM32L4_TIM8_QEPSC,
   .ti1cfg   = GPIO_TIM8_CH1IN,
   .ti2cfg   = GPIO_TIM8_CH2IN,
+#ifdef HAVE_QE_INDEX
+  .ccirq    = STM32L4_IRQ_TIM8CC,
+#ifdef CONFIG_STM32L4_TIM8_QE_INDEX
+  .ti3cfg   = GPIO_TIM8_CH3IN,
+#endif
+#endif
+#if defined(HAVE_QE_VELOCITY) && CONFIG_STM32L4_TIM8_QE_VELTIM != 0
+  .veltim   = CONFIG_STM32L4_TIM8_QE_VELTIM,
+  .velitr   = CONFIG_STM32L4_TIM8_QE_VELITR,
+  .velclk   = CONFIG_STM32L4_TIM8_QE_VELCLOCK,
+#endif
 };
 
 static struct stm32l4_lowerhalf_s g_tim8lower =
@@ -602,50 +769,430 @@ static struct stm32l4_lowerhalf_s *stm32l4_tim2lower(int tim)
 }
 
 /****************************************************************************
- * Name: stm32l4_interrupt
+ * Name: stm32l4_needirq
  *
  * Description:
- *   Common timer interrupt handling.  NOTE: Only 16-bit timers require timer
- *   interrupts.
+ *   Return true if the timer needs its interrupts: 16-bit counters are
+ *   extended on each overflow and the index is recorded on each pulse.
  *
  ****************************************************************************/
 
+#ifdef HAVE_QE_INTERRUPT
+static bool stm32l4_needirq(struct stm32l4_lowerhalf_s *priv)
+{
+#ifdef HAVE_QE_INDEX
+  if (priv->config->ti3cfg != 0)
+    {
+      return true;
+    }
+#endif
+
+#if defined(HAVE_MIXEDWIDTH_TIMERS)
+  return priv->config->width != 32;
+#elif defined(HAVE_16BIT_TIMERS)
+  return true;
+#else
+  return false;
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: stm32l4_overflow
+ *
+ * Description:
+ *   Extend the position of a 16-bit timer if it overflowed.  Returns true
+ *   if it did.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_QE_INTERRUPT
+static bool stm32l4_overflow(struct stm32l4_lowerhalf_s *priv,
+                             uint16_t status)
+{
 #ifdef HAVE_16BIT_TIMERS
+#ifdef HAVE_MIXEDWIDTH_TIMERS
+  if (priv->config->width != 32 && (status & GTIM_SR_UIF) != 0)
+#else
+  if ((status & GTIM_SR_UIF) != 0)
+#endif
+    {
+      /* Clear the UIF interrupt bit */
+
+      stm32l4_putreg16(priv, STM32L4_GTIM_SR_OFFSET, ~GTIM_SR_UIF);
+
+      /* Check the direction bit in the CR1 register and add or subtract
+       * the maximum value, as appropriate.
+       */
+
+      if ((stm32l4_getreg16(priv, STM32L4_GTIM_CR1_OFFSET) &
+           ATIM_CR1_DIR) != 0)
+        {
+          priv->position -= (int32_t)0x0000ffff;
+        }
+      else
+        {
+          priv->position += (int32_t)0x0000ffff;
+        }
+
+      return true;
+    }
+#endif
+
+  return false;
+}
+#endif
+
+/****************************************************************************
+ * Name: stm32l4_interrupt
+ *
+ * Description:
+ *   Common timer interrupt handling.  The update interrupt is only used by
+ *   16-bit timers, the capture/compare 3 interrupt only with an index.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_QE_INTERRUPT
 static int stm32l4_interrupt(int irq, void *context, void *arg)
 {
   struct stm32l4_lowerhalf_s *priv =
                               (struct stm32l4_lowerhalf_s *)arg;
   uint16_t regval;
+#ifdef HAVE_QE_INDEX
+  uint32_t count;
+  uint32_t latch;
+  int32_t  delta;
+#endif
 
   DEBUGASSERT(priv != NULL);
 
-  /* Verify that this is an update interrupt.
-   * Nothing else is expected.
-   */
-
   regval = stm32l4_getreg16(priv, STM32L4_GTIM_SR_OFFSET);
-  DEBUGASSERT((regval & ATIM_SR_UIF) != 0);
+  stm32l4_overflow(priv, regval);
+
+#ifdef HAVE_QE_INDEX
+  if ((regval & GTIM_SR_CC3IF) != 0)
+    {
+      /* Reading CCR3 clears CC3IF */
+
+      latch = stm32l4_getreg32(priv, STM32L4_GTIM_CCR3_OFFSET);
+      stm32l4_putreg16(priv, STM32L4_GTIM_SR_OFFSET, ~GTIM_SR_CC3OF);
+
+      /* Sample the counter with no overflow pending, so that it is
+       * consistent with the position offset.  It moved on from the
+       * latched value by less than half its range since the capture.
+       */
+
+      do
+        {
+          count  = stm32l4_getreg32(priv, STM32L4_GTIM_CNT_OFFSET);
+          regval = stm32l4_getreg16(priv, STM32L4_GTIM_SR_OFFSET);
+        }
+      while (stm32l4_overflow(priv, regval));
+
+#if defined(HAVE_MIXEDWIDTH_TIMERS)
+      if (priv->config->width != 32)
+        {
+          delta = (int16_t)(count - latch);
+        }
+      else
+        {
+          delta = (int32_t)(count - latch);
+        }
+#elif defined(HAVE_16BIT_TIMERS)
+      delta = (int16_t)(count - latch);
+#else
+      delta = (int32_t)(count - latch);
+#endif
+
+      priv->indexpos = priv->position + (int32_t)count - delta;
+
+      /* Move the position so that the index reads as its set position */
+
+      if (priv->indexset)
+        {
+          priv->position += priv->indexoff - priv->indexpos;
+          priv->indexpos  = priv->indexoff;
+        }
+
+      priv->indexcnt++;
+    }
+#endif
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: stm32l4_sample
+ *
+ * Description:
+ *   Return the current position and, if 'state' is not NULL, sample the
+ *   velocity with it.
+ *
+ ****************************************************************************/
+
+static int32_t stm32l4_sample(struct stm32l4_lowerhalf_s *priv,
+                              struct stm32l4_qe_state_s *state)
+{
+  irqstate_t flags;
+  uint32_t count;
+#ifdef HAVE_QE_INTERRUPT
+  int32_t position;
+  int32_t verify;
+
+  /* Loop until we are certain that no interrupt occurred between samples */
+
+  do
+    {
+      /* Don't let another task preempt us until we get the measurement.
+       * The timer interrupt may still be processed
+       */
+
+      sched_lock();
+      position = priv->position;
+#endif
+
+      /* The counter and the velocity timer are sampled together */
+
+      flags = enter_critical_section();
+      count = stm32l4_getreg32(priv, STM32L4_GTIM_CNT_OFFSET);
+      if (state != NULL)
+        {
+#ifdef HAVE_QE_VELOCITY
+          stm32l4_velocity(priv, state);
+#else
+          state->velocity = 0;
+          state->period   = 0;
+#endif
+          state->timestamp = up_perf_gettime();
+        }
+
+      leave_critical_section(flags);
+
+#ifdef HAVE_QE_INTERRUPT
+      verify = priv->position;
+      sched_unlock();
+    }
+  while (position != verify);
+
+  return position + (int32_t)count;
+#else
+  return (int32_t)count;
+#endif
+}
+
+#ifdef HAVE_QE_VELOCITY
+/****************************************************************************
+ * Name: stm32l4_velocity
+ *
+ * Description:
+ *   Derive the velocity from the period measured by the velocity timer.
+ *   Reading CCR1 clears CC1IF, so CC1IF tells whether an edge arrived
+ *   since the last sample and CC1OF whether there were more.  The update
+ *   flag is only set when the velocity timer overflows.
+ *
+ * Assumptions:
+ *   Called in a critical section.
+ *
+ ****************************************************************************/
+
+static void stm32l4_velocity(struct stm32l4_lowerhalf_s *priv,
+                             struct stm32l4_qe_state_s *state)
+{
+  uint32_t base = priv->velbase;
+  uint32_t capture = 0;
+  uint32_t elapsed;
+  uint32_t period;
+  uint16_t regval;
+  uint8_t  edges = 0;
+  uint64_t rate;
+
+  state->velocity = 0;
+  state->period   = 0;
+
+  if (priv->vel == NULL)
+    {
+      return;
+    }
+
+  regval = getreg16(base + STM32L4_GTIM_SR_OFFSET);
+  if ((regval & GTIM_SR_CC1IF) != 0)
+    {
+      capture = getreg32(base + STM32L4_GTIM_CCR1_OFFSET) & priv->velmask;
+      edges   = (regval & GTIM_SR_CC1OF) != 0 ? 2 : 1;
+    }
+
+  elapsed = getreg32(base + STM32L4_GTIM_CNT_OFFSET) & priv->velmask;
+  putreg16(~(GTIM_SR_UIF | GTIM_SR_CC1OF), base + STM32L4_GTIM_SR_OFFSET);
+
+  if ((regval & GTIM_SR_UIF) != 0)
+    {
+      /* Stopped for at least a whole period of the velocity timer */
+
+      priv->velvalid = 0;
+      return;
+    }
 
-  /* Clear the UIF interrupt bit */
+  if (edges > 0)
+    {
+      priv->velvalid += edges;
+      if (priv->velvalid >= QE_VELVALID)
+        {
+          priv->velvalid = QE_VELVALID;
+          priv->period   = capture;
+        }
+    }
 
-  stm32l4_putreg16(priv, STM32L4_GTIM_SR_OFFSET, regval & ~GTIM_SR_UIF);
+  if (priv->velvalid < QE_VELVALID)
+    {
+      return;
+    }
 
-  /* Check the direction bit in the CR1 register and add or subtract the
-   * maximum value, as appropriate.
+  /* While the encoder slows down, the time since the last edge is a
+   * better estimate than the last period.
    */
 
-  regval = stm32l4_getreg16(priv, STM32L4_GTIM_CR1_OFFSET);
-  if ((regval & ATIM_CR1_DIR) != 0)
+  period = priv->period > elapsed ? priv->period : elapsed;
+  if (period == 0)
     {
-      priv->position -= (int32_t)0x0000ffff;
+      period = 1;
     }
-  else
+
+  /* The counter advances by 4 / (PSC + 1) per cycle of the A input */
+
+  rate = (uint64_t)4 * priv->config->velclk /
+         ((uint64_t)(priv->config->psc + 1) * period);
+
+  state->period   = period;
+  state->velocity = (int32_t)rate;
+  if ((stm32l4_getreg16(priv, STM32L4_GTIM_CR1_OFFSET) &
+       GTIM_CR1_DIR) != 0)
     {
-      priv->position += (int32_t)0x0000ffff;
+      state->velocity = -state->velocity;
     }
+}
+
+/****************************************************************************
+ * Name: stm32l4_velsetup
+ *
+ * Description:
+ *   Start the velocity timer.  The encoder timer sends a TRGO pulse on each
+ *   capture of TI1; the velocity timer captures its counter on that
+ *   trigger and is reset by it.
+ *
+ ****************************************************************************/
+
+static int stm32l4_velsetup(struct stm32l4_lowerhalf_s *priv)
+{
+  const struct stm32l4_qeconfig_s *config = priv->config;
+  uint32_t base;
+  uint32_t regval;
 
+  switch (config->veltim)
+    {
+      case 0:
+        return OK;
+#ifdef CONFIG_STM32L4_TIM1
+      case 1:
+        base = STM32L4_TIM1_BASE;
+        break;
+#endif
+#ifdef CONFIG_STM32L4_TIM2
+      case 2:
+        base = STM32L4_TIM2_BASE;
+        break;
+#endif
+#ifdef CONFIG_STM32L4_TIM3
+      case 3:
+        base = STM32L4_TIM3_BASE;
+        break;
+#endif
+#ifdef CONFIG_STM32L4_TIM4
+      case 4:
+        base = STM32L4_TIM4_BASE;
+        break;
+#endif
+#ifdef CONFIG_STM32L4_TIM5
+      case 5:
+        base = STM32L4_TIM5_BASE;
+        break;
+#endif
+#ifdef CONFIG_STM32L4_TIM8
+      case 8:
+        base = STM32L4_TIM8_BASE;
+        break;
+#endif
+#ifdef CONFIG_STM32L4_TIM15
+      case 15:
+        base = STM32L4_TIM15_BASE;
+        break;
+#endif
+      default:
+        snerr("ERROR: TIM%d cannot be a velocity timer\n", config->veltim);
+        return -EINVAL;
+    }
+
+  priv->vel = stm32l4_tim_init(config->veltim);
+  if (priv->vel == NULL)
+    {
+      return -EBUSY;
+    }
+
+  priv->velbase  = base;
+  priv->velmask  = (config->veltim == 2 || config->veltim == 5) ?
+                   0xffffffff : 0xffff;
+  priv->period   = 0;
+  priv->velvalid = 0;
+
+  STM32L4_TIM_SETCLOCK(priv->vel, config->velclk);
+  STM32L4_TIM_SETPERIOD(priv->vel, priv->velmask);
+
+  /* IC1 is mapped on TRC, the counter is reset by the trigger */
+
+  regval  = getreg32(base + STM32L4_GTIM_CCMR1_OFFSET);
+  regval &= ~(GTIM_CCMR1_CC1S_MASK | GTIM_CCMR1_IC1F_MASK |
+              GTIM_CCMR1_IC1PSC_MASK);
+  regval |= GTIM_CCMR_CCS_CCINTRC << GTIM_CCMR1_CC1S_SHIFT;
+  putreg32(regval, base + STM32L4_GTIM_CCMR1_OFFSET);
+  modifyreg16(base + STM32L4_GTIM_CCER_OFFSET,
+              GTIM_CCER_CC1P | GTIM_CCER_CC1NP, GTIM_CCER_CC1E);
+
+  regval  = getreg32(base + STM32L4_GTIM_SMCR_OFFSET);
+  regval &= ~(GTIM_SMCR_TS_MASK | GTIM_SMCR_SMS_MASK);
+  regval |= ((uint32_t)config->velitr << GTIM_SMCR_TS_SHIFT) |
+            GTIM_SMCR_RESET;
+  putreg32(regval, base + STM32L4_GTIM_SMCR_OFFSET);
+
+  /* Count, with only an overflow setting the update flag */
+
+  STM32L4_TIM_SETMODE(priv->vel, STM32L4_TIM_MODE_UP);
+  modifyreg16(base + STM32L4_GTIM_CR1_OFFSET, 0, GTIM_CR1_URS);
+  putreg16(0, base + STM32L4_GTIM_SR_OFFSET);
+
+  /* The encoder timer triggers on each capture of TI1 */
+
+  regval  = stm32l4_getreg16(priv, STM32L4_GTIM_CR2_OFFSET);
+  regval &= ~GTIM_CR2_MMS_MASK;
+  regval |= GTIM_CR2_MMS_COMPP;
+  stm32l4_putreg16(priv, STM32L4_GTIM_CR2_OFFSET, regval);
   return OK;
 }
+
+/****************************************************************************
+ * Name: stm32l4_velshutdown
+ ****************************************************************************/
+
+static void stm32l4_velshutdown(struct stm32l4_lowerhalf_s *priv)
+{
+  if (priv->vel != NULL)
+    {
+      putreg32(0, priv->velbase + STM32L4_GTIM_SMCR_OFFSET);
+      STM32L4_TIM_SETCHANNEL(priv->vel, 1, STM32L4_TIM_CH_DISABLED);
+      STM32L4_TIM_SETMODE(priv->vel, STM32L4_TIM_MODE_DISABLED);
+      stm32l4_tim_deinit(priv->vel);
+      priv->vel = NULL;
+    }
+}
 #endif
 
 /****************************************************************************
@@ -667,10 +1214,15 @@ static int stm32l4_setup(struct qe_lowerhalf_s *lower)
   uint32_t ccmr1;
   uint16_t ccer;
   uint16_t cr1;
-#ifdef HAVE_16BIT_TIMERS
+#ifdef HAVE_QE_INTERRUPT
   uint16_t regval;
+#endif
+#if defined(HAVE_QE_INTERRUPT) || defined(HAVE_QE_VELOCITY)
   int ret;
 #endif
+#ifdef HAVE_QE_INDEX
+  uint32_t ccmr2;
+#endif
 
   /* NOTE:
    * Clocking should have been enabled in the low-level RCC logic at boot-up
@@ -826,18 +1378,45 @@ static int stm32l4_setup(struct qe_lowerhalf_s *lower)
   ccmr1 |= (GTIM_CCMR_ICPSC_NOPSC << GTIM_CCMR1_IC2PSC_SHIFT);
   stm32l4_putreg32(priv, STM32L4_GTIM_CCMR1_OFFSET, ccmr1);
 
+#ifdef HAVE_QE_INDEX
+  /* TI3 Channel Configuration: CCR3 latches the counter on the rising
+   * edge of the index.
+   */
+
+  priv->indexpos = 0;
+  priv->indexcnt = 0;
+
+  if (priv->config->ti3cfg != 0)
+    {
+      stm32l4_configgpio(priv->config->ti3cfg);
+
+      ccer  = stm32l4_getreg16(priv, STM32L4_GTIM_CCER_OFFSET);
+      ccer &= ~GTIM_CCER_CC3E;
+      stm32l4_putreg16(priv, STM32L4_GTIM_CCER_OFFSET, ccer);
+
+      ccmr2  = stm32l4_getreg32(priv, STM32L4_GTIM_CCMR2_OFFSET);
+      ccmr2 &= ~(GTIM_CCMR2_CC3S_MASK | GTIM_CCMR2_IC3F_MASK |
+                 GTIM_CCMR2_IC3PSC_MASK);
+      ccmr2 |= GTIM_CCMR_CCS_CCIN1 << GTIM_CCMR2_CC3S_SHIFT;
+      ccmr2 |= STM32L4_QENCODER_ICF << GTIM_CCMR2_IC3F_SHIFT;
+      stm32l4_putreg32(priv, STM32L4_GTIM_CCMR2_OFFSET, ccmr2);
+
+      ccer &= ~(GTIM_CCER_CC3P | GTIM_CCER_CC3NP);
+      ccer |= GTIM_CCER_CC3E;
+      stm32l4_putreg16(priv, STM32L4_GTIM_CCER_OFFSET, ccer);
+    }
+#endif
+
   /* Disable the update interrupt */
 
   dier = stm32l4_getreg16(priv, STM32L4_GTIM_DIER_OFFSET);
-  dier &= ~GTIM_DIER_UIE;
+  dier &= ~(GTIM_DIER_UIE | GTIM_DIER_CC3IE);
   stm32l4_putreg16(priv, STM32L4_GTIM_DIER_OFFSET, dier);
 
-  /* There is no need for interrupts with 32-bit timers */
+  /* There is no need for interrupts with 32-bit timers without index */
 
-#ifdef HAVE_16BIT_TIMERS
-#ifdef HAVE_MIXEDWIDTH_TIMERS
-  if (priv->config->width != 32)
-#endif
+#ifdef HAVE_QE_INTERRUPT
+  if (stm32l4_needirq(priv))
     {
       /* Attach the interrupt handler */
 
@@ -851,6 +1430,23 @@ static int stm32l4_setup(struct qe_lowerhalf_s *lower)
       /* Enable the update/global interrupt at the NVIC */
 
       up_enable_irq(priv->config->irq);
+
+#ifdef HAVE_QE_INDEX
+      /* TIM1 and TIM8 have a separate capture/compare interrupt */
+
+      if (priv->config->ti3cfg != 0 &&
+          priv->config->ccirq != priv->config->irq)
+        {
+          ret = irq_attach(priv->config->ccirq, stm32l4_interrupt, priv);
+          if (ret < 0)
+            {
+              stm32l4_shutdown(lower);
+              return ret;
+            }
+
+          up_enable_irq(priv->config->ccirq);
+        }
+#endif
     }
 #endif
 
@@ -865,26 +1461,54 @@ static int stm32l4_setup(struct qe_lowerhalf_s *lower)
   cr1 &= ~GTIM_CR1_URS;
   stm32l4_putreg16(priv, STM32L4_GTIM_CR1_OFFSET, cr1);
 
-  /* There is no need for interrupts with 32-bit timers */
+  /* There is no need for interrupts with 32-bit timers without index */
 
-#ifdef HAVE_16BIT_TIMERS
-#ifdef HAVE_MIXEDWIDTH_TIMERS
-  if (priv->config->width != 32)
-#endif
+#ifdef HAVE_QE_INTERRUPT
+  if (stm32l4_needirq(priv))
     {
-      /* Clear any pending update interrupts */
+      /* Clear any pending update and index interrupts */
 
       regval = stm32l4_getreg16(priv, STM32L4_GTIM_SR_OFFSET);
-      stm32l4_putreg16(priv, STM32L4_GTIM_SR_OFFSET, regval & ~GTIM_SR_UIF);
+      stm32l4_putreg16(priv, STM32L4_GTIM_SR_OFFSET,
+                       regval & ~(GTIM_SR_UIF | GTIM_SR_CC3IF |
+                                  GTIM_SR_CC3OF));
 
-      /* Then enable the update interrupt */
+      /* Then enable the update interrupt of 16-bit timers and the index
+       * interrupt
+       */
 
       dier = stm32l4_getreg16(priv, STM32L4_GTIM_DIER_OFFSET);
+#if defined(HAVE_MIXEDWIDTH_TIMERS)
+      if (priv->config->width != 32)
+        {
+          dier |= GTIM_DIER_UIE;
+        }
+#elif defined(HAVE_16BIT_TIMERS)
       dier |= GTIM_DIER_UIE;
+#endif
+
+#ifdef HAVE_QE_INDEX
+      if (priv->config->ti3cfg != 0)
+        {
+          dier |= GTIM_DIER_CC3IE;
+        }
+#endif
+
       stm32l4_putreg16(priv, STM32L4_GTIM_DIER_OFFSET, dier);
     }
 #endif
 
+#ifdef HAVE_QE_VELOCITY
+  /* Start measuring the period of the A input */
+
+  ret = stm32l4_velsetup(priv);
+  if (ret < 0)
+    {
+      stm32l4_shutdown(lower);
+      return ret;
+    }
+#endif
+
   /* Enable the TIM Counter */
 
   cr1 = stm32l4_getreg16(priv, STM32L4_GTIM_CR1_OFFSET);
@@ -925,6 +1549,19 @@ static int stm32l4_shutdown(struct qe_lowerhalf_s *lower)
 
   irq_detach(priv->config->irq);
 
+#ifdef HAVE_QE_INDEX
+  if (priv->config->ti3cfg != 0 &&
+      priv->config->ccirq != priv->config->irq)
+    {
+      up_disable_irq(priv->config->ccirq);
+      irq_detach(priv->config->ccirq);
+    }
+#endif
+
+#ifdef HAVE_QE_VELOCITY
+  stm32l4_velshutdown(priv);
+#endif
+
   /* Disable interrupts momentary to stop any ongoing timer processing and
    * to prevent any concurrent access to the reset register.
    */
@@ -1007,6 +1644,19 @@ static int stm32l4_shutdown(struct qe_lowerhalf_s *lower)
   pincfg |= STM32L4_GPIO_INPUT_FLOAT;
 
   stm32l4_configgpio(pincfg);
+
+#ifdef HAVE_QE_INDEX
+  /* Put the index GPIO pin back to its default state */
+
+  if (priv->config->ti3cfg != 0)
+    {
+      pincfg  = priv->config->ti3cfg & (GPIO_PORT_MASK | GPIO_PIN_MASK);
+      pincfg |= STM32L4_GPIO_INPUT_FLOAT;
+
+      stm32l4_configgpio(pincfg);
+    }
+#endif
+
   return OK;
 }
 
@@ -1023,37 +1673,12 @@ static int stm32l4_position(struct qe_lowerhalf_s *lower,
 {
   struct stm32l4_lowerhalf_s *priv =
                               (struct stm32l4_lowerhalf_s *)lower;
-#ifdef HAVE_16BIT_TIMERS
-  int32_t position;
-  int32_t verify;
-  uint32_t count;
 
   DEBUGASSERT(lower && priv->inuse);
 
-  /* Loop until we are certain that no interrupt occurred between samples */
-
-  do
-    {
-      /* Don't let another task preempt us until we get the measurement.
-       * The timer interrupt may still be processed
-       */
-
-      sched_lock();
-      position = priv->position;
-      count    = stm32l4_getreg32(priv, STM32L4_GTIM_CNT_OFFSET);
-      verify   = priv->position;
-      sched_unlock();
-    }
-  while (position != verify);
-
   /* Return the position measurement */
 
-  *pos = position + (int32_t)count;
-#else
-  /* Return the counter value */
-
-  *pos = (int32_t)stm32l4_getreg32(priv, STM32L4_GTIM_CNT_OFFSET);
-#endif
+  *pos = stm32l4_sample(priv, NULL);
   return OK;
 }
 
@@ -1069,7 +1694,7 @@ static int stm32l4_reset(struct qe_lowerhalf_s *lower)
 {
   struct stm32l4_lowerhalf_s *priv =
                                  (struct stm32l4_lowerhalf_s *)lower;
-#ifdef HAVE_16BIT_TIMERS
+#ifdef HAVE_QE_INTERRUPT
   irqstate_t flags;
 
   sninfo("Resetting position to zero\n");
@@ -1094,6 +1719,38 @@ static int stm32l4_reset(struct qe_lowerhalf_s *lower)
   return OK;
 }
 
+/****************************************************************************
+ * Name: stm32l4_setindex
+ *
+ * Description:
+ *   Set the position that the index pulse is assigned.  Each index pulse
+ *   then corrects the position by the difference to the latched one.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_QE_INDEX
+static int stm32l4_setindex(struct qe_lowerhalf_s *lower, uint32_t pos)
+{
+  struct stm32l4_lowerhalf_s *priv =
+                              (struct stm32l4_lowerhalf_s *)lower;
+  irqstate_t flags;
+
+  DEBUGASSERT(lower && priv->inuse);
+
+  if (priv->config->ti3cfg == 0)
+    {
+      snerr("ERROR: TIM%d has no index input\n", priv->config->timid);
+      return -ENOTTY;
+    }
+
+  flags = enter_critical_section();
+  priv->indexoff = (int32_t)pos;
+  priv->indexset = true;
+  leave_critical_section(flags);
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: stm32l4_ioctl
  *
@@ -1105,11 +1762,63 @@ static int stm32l4_reset(struct qe_lowerhalf_s *lower)
 static int stm32l4_ioctl(struct qe_lowerhalf_s *lower,
                          int cmd, unsigned long arg)
 {
-  /* No ioctl commands supported */
+  struct stm32l4_lowerhalf_s *priv =
+                              (struct stm32l4_lowerhalf_s *)lower;
+  int ret = OK;
+
+  DEBUGASSERT(lower && priv->inuse);
+
+  switch (cmd)
+    {
+#ifdef HAVE_QE_INDEX
+      /* QEIOC_GETINDEX - Get the position at the last index pulse.
+       *   Argument: struct qe_index_s pointer
+       */
+
+      case QEIOC_GETINDEX:
+        {
+          struct qe_index_s *index = (struct qe_index_s *)arg;
+          irqstate_t flags;
+
+          DEBUGASSERT(index != NULL);
+          if (priv->config->ti3cfg == 0)
+            {
+              ret = -ENOTTY;
+              break;
+            }
+
+          index->qenc_pos = stm32l4_sample(priv, NULL);
+
+          flags = enter_critical_section();
+          index->indx_pos = priv->indexpos;
+          index->indx_cnt = priv->indexcnt;
+          leave_critical_section(flags);
+        }
+        break;
+#endif
 
-  /* TODO add an IOCTL to control the encoder pulse count prescaler */
+      /* QEIOC_GETSTATE - Sample the position and the velocity together.
+       *   Argument: struct stm32l4_qe_state_s pointer
+       */
+
+      case QEIOC_GETSTATE:
+        {
+          struct stm32l4_qe_state_s *state =
+            (struct stm32l4_qe_state_s *)arg;
+
+          DEBUGASSERT(state != NULL);
+          state->position = stm32l4_sample(priv, state);
+        }
+        break;
+
+      /* TODO add an IOCTL to control the encoder pulse count prescaler */
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
 
-  return -ENOTTY;
+  return ret;
 }
 
 /****************************************************************************
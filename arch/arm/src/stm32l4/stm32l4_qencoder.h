@@ -27,12 +27,16 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
+#include <nuttx/sensors/qencoder.h>
+
 #include "chip.h"
 
 #ifdef CONFIG_SENSORS_QENCODER
 
 /****************************************************************************
- * Included Files
+ * Pre-processor Definitions
  ****************************************************************************/
 
 /* Timer devices may be used for different purposes.  One special purpose is
@@ -100,8 +104,32 @@
 #  define CONFIG_STM32L4_TIM8_QECLKOUT 28000000
 #endif
 
+/* QEIOC_GETSTATE - Sample the position and the velocity together.
+ *   Argument: struct stm32l4_qe_state_s pointer.  The velocity fields are
+ *   zero if no velocity timer is configured for the encoder.
+ */
+
+#define QEIOC_GETSTATE     _QEIOC(QE_STM32L4_FIRST)
+
 /****************************************************************************
- * Included Files
+ * Public Types
+ ****************************************************************************/
+
+/* Result of QEIOC_GETSTATE.  The velocity is derived from the time between
+ * the last two rising edges of the A input, or from the time since the
+ * last edge if that is longer.
+ */
+
+struct stm32l4_qe_state_s
+{
+  int32_t  position;   /* Current position */
+  int32_t  velocity;   /* Counts per second, zero if stopped */
+  uint32_t period;     /* Velocity timer ticks per A cycle, zero if stopped */
+  uint32_t timestamp;  /* up_perf_gettime() when the state was sampled */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
  ****************************************************************************/
 
 /****************************************************************************
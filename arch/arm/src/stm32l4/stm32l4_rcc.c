@@ -35,9 +35,11 @@
 #include "chip.h"
 #include "stm32l4_rcc.h"
 #include "stm32l4_flash.h"
+#include "stm32l4_flashcache.h"
 #include "stm32l4.h"
 #include "stm32l4_waste.h"
 #include "stm32l4_rtc.h"
+#include "stm32l4_dvfs.h"
 
 /* Include chip-specific clocking initialization logic */
 
@@ -64,14 +66,158 @@
 
 #define HSERDY_TIMEOUT (100 * CONFIG_BOARD_LOOPSPERMSEC)
 
+/* Oscillators and PLLs restored by rcc_resumeclocks() */
+
+#define RCC_CR_OSCON   (RCC_CR_MSION | RCC_CR_HSION | RCC_CR_HSEON)
+#define RCC_CR_PLLSON  (RCC_CR_PLLON | RCC_CR_PLLSAI1ON | RCC_CR_PLLSAI2ON)
+#define RCC_CR_MSISEL  (RCC_CR_MSIRANGE_MASK | RCC_CR_MSIRGSEL)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#if defined(CONFIG_PM) || defined(CONFIG_STM32L4_IDLE_GOVERNOR)
+/* The clock tree left by stm32l4_clockconfig().  Stop modes retain all of
+ * the RCC and FLASH registers but they stop the PLLs and HSE and switch
+ * the system clock to MSI or HSI16, so restoring these few values is all
+ * that is needed to resume.
+ */
+
+struct rcc_resume_s
+{
+  uint32_t cr;                  /* Oscillators and PLLs on, MSI range */
+  uint32_t cfgr;                /* System clock switch */
+  uint32_t acr;                 /* Flash wait states */
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+#if defined(CONFIG_PM) || defined(CONFIG_STM32L4_IDLE_GOVERNOR)
+static struct rcc_resume_s g_rcc_resume;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: rcc_saveclocks
+ *
+ * Description:
+ *   Record the clock tree once stm32l4_clockconfig() has set it up.  When
+ *   the system clock comes from HSI16, directly or through the PLL, also
+ *   wake up from Stop on HSI16 so that it is already running.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_PM) || defined(CONFIG_STM32L4_IDLE_GOVERNOR)
+static void rcc_saveclocks(void)
+{
+  uint32_t sw;
+
+  g_rcc_resume.cr   = getreg32(STM32L4_RCC_CR);
+  g_rcc_resume.cfgr = getreg32(STM32L4_RCC_CFGR);
+  g_rcc_resume.acr  = getreg32(STM32L4_FLASH_ACR);
+
+  sw = g_rcc_resume.cfgr & RCC_CFGR_SW_MASK;
+  if (sw == RCC_CFGR_SW_HSI ||
+      (sw == RCC_CFGR_SW_PLL &&
+       (getreg32(STM32L4_RCC_PLLCFG) & RCC_PLLCFG_PLLSRC_MASK) ==
+       RCC_PLLCFG_PLLSRC_HSI))
+    {
+      modifyreg32(STM32L4_RCC_CFGR, 0, RCC_CFGR_STOPWUCK_HSI);
+    }
+}
+
+/****************************************************************************
+ * Name: rcc_enablewait
+ *
+ * Description:
+ *   Turn on the oscillators or PLLs in 'on' that are off and wait until
+ *   they are ready.  Each ready flag follows its enable bit, HSIKERON sits
+ *   in between for HSI16.
+ *
+ ****************************************************************************/
+
+static void rcc_enablewait(uint32_t on)
+{
+  uint32_t regval = getreg32(STM32L4_RCC_CR);
+  uint32_t rdy;
+
+  on &= ~regval;
+  if (on != 0)
+    {
+      rdy = ((on & ~RCC_CR_HSION) << 1) | ((on & RCC_CR_HSION) << 2);
+
+      putreg32(regval | on, STM32L4_RCC_CR);
+      while ((getreg32(STM32L4_RCC_CR) & rdy) != rdy)
+        {
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: rcc_resumeclocks
+ *
+ * Description:
+ *   Restore the clock tree recorded by rcc_saveclocks() with the minimum
+ *   number of register writes, instead of going through the whole clock
+ *   configuration again.
+ *
+ ****************************************************************************/
+
+static void rcc_resumeclocks(void)
+{
+  uint32_t regval;
+
+  /* Raise the flash wait states before the clock, if they were lowered */
+
+  if ((getreg32(STM32L4_FLASH_ACR) & FLASH_ACR_LATENCY_MASK) <
+      (g_rcc_resume.acr & FLASH_ACR_LATENCY_MASK))
+    {
+      putreg32(g_rcc_resume.acr, STM32L4_FLASH_ACR);
+      while ((getreg32(STM32L4_FLASH_ACR) & FLASH_ACR_LATENCY_MASK) !=
+             (g_rcc_resume.acr & FLASH_ACR_LATENCY_MASK))
+        {
+        }
+    }
+
+  /* The MSI range may only change while MSI is off or ready */
+
+  regval = getreg32(STM32L4_RCC_CR);
+  if ((regval & RCC_CR_MSISEL) != (g_rcc_resume.cr & RCC_CR_MSISEL) &&
+      ((regval & RCC_CR_MSIRDY) != 0 || (regval & RCC_CR_MSION) == 0))
+    {
+      regval &= ~RCC_CR_MSISEL;
+      regval |= g_rcc_resume.cr & RCC_CR_MSISEL;
+      putreg32(regval, STM32L4_RCC_CR);
+    }
+
+  /* The PLL inputs first, then the PLLs themselves */
+
+  rcc_enablewait(g_rcc_resume.cr & RCC_CR_OSCON);
+  rcc_enablewait(g_rcc_resume.cr & RCC_CR_PLLSON);
+
+  /* Finally switch the system clock back */
+
+  regval = getreg32(STM32L4_RCC_CFGR);
+  if ((regval & RCC_CFGR_SW_MASK) != (g_rcc_resume.cfgr & RCC_CFGR_SW_MASK))
+    {
+      regval &= ~RCC_CFGR_SW_MASK;
+      regval |= g_rcc_resume.cfgr & RCC_CFGR_SW_MASK;
+      putreg32(regval, STM32L4_RCC_CFGR);
+
+      while ((getreg32(STM32L4_RCC_CFGR) & RCC_CFGR_SWS_MASK) !=
+             (g_rcc_resume.cfgr & RCC_CFGR_SW_MASK) << RCC_CFGR_SWS_SHIFT)
+        {
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -199,6 +345,12 @@ void stm32l4_clockconfig(void)
   /* Enable peripheral clocking */
 
   rcc_enableperipherals();
+
+#if defined(CONFIG_PM) || defined(CONFIG_STM32L4_IDLE_GOVERNOR)
+  /* Remember the result for the fast wakeup path of stm32l4_clockenable() */
+
+  rcc_saveclocks();
+#endif
 }
 
 /****************************************************************************
@@ -227,9 +379,31 @@ void stm32l4_clockconfig(void)
  *
  ****************************************************************************/
 
-#ifdef CONFIG_PM
+#if defined(CONFIG_PM) || defined(CONFIG_STM32L4_IDLE_GOVERNOR)
 void stm32l4_clockenable(void)
 {
+#ifdef CONFIG_STM32L4_DVFS
+  /* Stop mode retained the voltage range of the low DVFS level; stay in
+   * that level.
+   */
+
+  if (stm32l4_dvfs_getlevel() == STM32L4_DVFS_LOW)
+    {
+      stm32l4_dvfs_resume();
+      return;
+    }
+#endif
+
+  /* Restore what stm32l4_clockconfig() set up, without computing it again
+   * and waiting more than for the oscillators and PLLs to restart.
+   */
+
+  if (g_rcc_resume.cr != 0)
+    {
+      rcc_resumeclocks();
+      return;
+    }
+
 #if defined(CONFIG_ARCH_BOARD_STM32L4_CUSTOM_CLOCKCONFIG)
 
   /* Invoke Board Custom Clock Configuration */
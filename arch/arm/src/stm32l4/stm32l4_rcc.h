@@ -143,7 +143,9 @@ void stm32l4_board_clockconfig(void);
  *
  *   This functional performs a subset of the operations performed by
  *   stm32l4_clockconfig():  It does not reset any devices, and it does not
- *   reset the currently enabled peripheral clocks.
+ *   reset the currently enabled peripheral clocks.  Once
+ *   stm32l4_clockconfig() has run, only the oscillators, the PLLs and the
+ *   system clock switch recorded then are restored.
  *
  *   If CONFIG_ARCH_BOARD_STM32L4_CUSTOM_CLOCKCONFIG is defined, then
  *   clocking will be enabled by an externally provided, board-specific
@@ -157,7 +159,7 @@ void stm32l4_board_clockconfig(void);
  *
  ****************************************************************************/
 
-#ifdef CONFIG_PM
+#if defined(CONFIG_PM) || defined(CONFIG_STM32L4_IDLE_GOVERNOR)
 void stm32l4_clockenable(void);
 #endif
 
@@ -22,6 +22,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <sys/param.h>
+#include <inttypes.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -34,6 +36,7 @@
 #include <nuttx/mutex.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/random.h>
 #include <nuttx/drivers/drivers.h>
 
 #include "hardware/stm32l4_rng.h"
@@ -42,6 +45,24 @@
 #if defined(CONFIG_STM32L4_RNG)
 #if defined(CONFIG_DEV_RANDOM) || defined(CONFIG_DEV_URANDOM_ARCH)
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define RNG_RING_MASK  (CONFIG_STM32L4_RNG_RING_WORDS - 1)
+
+#if (CONFIG_STM32L4_RNG_RING_WORDS & RNG_RING_MASK) != 0
+#  error CONFIG_STM32L4_RNG_RING_WORDS must be a power of two
+#endif
+
+#ifndef CONFIG_STM32L4_RNG_POOL_WORDS
+#  define CONFIG_STM32L4_RNG_POOL_WORDS 0
+#endif
+
+/* The entropy pool counts itself seeded from this many new words */
+
+#define RNG_POOL_SEED  128
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -50,12 +71,19 @@ static int stm32l4_rng_initialize(void);
 static int stm32l4_rnginterrupt(int irq, void *context, void *arg);
 static void stm32l4_rngenable(void);
 static void stm32l4_rngdisable(void);
+static void stm32l4_rngrefill(unsigned int feed);
 static ssize_t stm32l4_rngread(struct file *filep, char *buffer, size_t);
 
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* The interrupt keeps a ring of random words filled, and stops the RNG when
+ * the ring is full.  A read takes its words from the ring and only waits
+ * for what the ring is short of, which the interrupt then writes to the
+ * reader's buffer directly.
+ */
+
 struct rng_dev_s
 {
   mutex_t rd_devlock;   /* Threads can only exclusively access the RNG */
@@ -64,6 +92,14 @@ struct rng_dev_s
   size_t rd_buflen;
   uint32_t rd_lastval;
   bool rd_first;
+  bool rd_running;      /* The RNG and its interrupt are enabled */
+  uint32_t rd_ring[CONFIG_STM32L4_RNG_RING_WORDS];
+  volatile uint32_t rd_head;      /* Words put in the ring, by the ISR */
+  volatile uint32_t rd_tail;      /* Words taken from the ring, by read */
+  unsigned int rd_feed;           /* Words still due to the entropy pool */
+  volatile uint32_t rd_clockerrs; /* Clock errors (CECS) seen */
+  volatile uint32_t rd_seederrs;  /* Seed errors (SECS) seen */
+  uint32_t rd_reported;           /* Errors already reported */
 };
 
 /****************************************************************************
@@ -100,6 +136,9 @@ static int stm32l4_rng_initialize(void)
       return -EAGAIN;
     }
 
+  /* Seed the entropy pool and fill the ring ahead of the first read */
+
+  stm32l4_rngrefill(RNG_POOL_SEED);
   return OK;
 }
 
@@ -108,6 +147,7 @@ static void stm32l4_rngenable(void)
   uint32_t regval;
 
   g_rngdev.rd_first = true;
+  g_rngdev.rd_running = true;
 
   /* Enable generation and interrupts */
 
@@ -129,6 +169,34 @@ static void stm32l4_rngdisable(void)
   regval &= ~RNG_CR_IE;
   regval &= ~RNG_CR_RNGEN;
   putreg32(regval, STM32L4_RNG_CR);
+
+  g_rngdev.rd_running = false;
+}
+
+/****************************************************************************
+ * Name: stm32l4_rngrefill
+ *
+ * Description:
+ *   Start the RNG, if it is stopped, to give 'feed' words to the entropy
+ *   pool and then fill the ring.
+ *
+ ****************************************************************************/
+
+static void stm32l4_rngrefill(unsigned int feed)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  if (!g_rngdev.rd_running)
+    {
+#ifdef CONFIG_CRYPTO_RANDOM_POOL
+      g_rngdev.rd_feed = feed;
+#endif
+      stm32l4_rngenable();
+    }
+
+  leave_critical_section(flags);
 }
 
 static int stm32l4_rnginterrupt(int irq, void *context, void *arg)
@@ -141,6 +209,7 @@ static int stm32l4_rnginterrupt(int irq, void *context, void *arg)
     {
       /* Clear it, we will try again. */
 
+      g_rngdev.rd_clockerrs++;
       putreg32(rngsr & ~RNG_SR_CEIS, STM32L4_RNG_SR);
       return OK;
     }
@@ -149,18 +218,24 @@ static int stm32l4_rnginterrupt(int irq, void *context, void *arg)
     {
       uint32_t crval;
 
-      /* Clear seed error, then disable/enable the rng and try again. */
+      /* Clear seed error, then disable/enable the rng and try again.  The
+       * continuous test starts over too, as after the first enable.
+       */
 
+      g_rngdev.rd_seederrs++;
       putreg32(rngsr & ~RNG_SR_SEIS, STM32L4_RNG_SR);
       crval = getreg32(STM32L4_RNG_CR);
       crval &= ~RNG_CR_RNGEN;
       putreg32(crval, STM32L4_RNG_CR);
       crval |= RNG_CR_RNGEN;
       putreg32(crval, STM32L4_RNG_CR);
+      g_rngdev.rd_first = true;
       return OK;
     }
 
-  if (!(rngsr & RNG_SR_DRDY)) /* Data ready must be set */
+  /* Data ready must be set, with neither of the health tests failing */
+
+  if ((rngsr & (RNG_SR_DRDY | RNG_SR_CECS | RNG_SR_SECS)) != RNG_SR_DRDY)
     {
       /* This random value is not valid, we will try again. */
 
@@ -192,30 +267,53 @@ static int stm32l4_rnginterrupt(int irq, void *context, void *arg)
       return OK;
     }
 
-  /* If we get here, the random number is valid. */
+  /* If we get here, the random number is valid.  A waiting reader comes
+   * first, then the entropy pool, then the ring.
+   */
 
   g_rngdev.rd_lastval = data;
 
-  if (g_rngdev.rd_buflen >= 4)
-    {
-      g_rngdev.rd_buflen -= 4;
-      *(uint32_t *)&g_rngdev.rd_buf[g_rngdev.rd_buflen] = data;
-    }
-  else
+  if (g_rngdev.rd_buflen > 0)
     {
-      while (g_rngdev.rd_buflen > 0)
+      if (g_rngdev.rd_buflen >= 4)
+        {
+          g_rngdev.rd_buflen -= 4;
+          *(uint32_t *)&g_rngdev.rd_buf[g_rngdev.rd_buflen] = data;
+        }
+      else
+        {
+          while (g_rngdev.rd_buflen > 0)
+            {
+              g_rngdev.rd_buf[--g_rngdev.rd_buflen] = (char)data;
+              data >>= 8;
+            }
+        }
+
+      if (g_rngdev.rd_buflen == 0)
         {
-          g_rngdev.rd_buf[--g_rngdev.rd_buflen] = (char)data;
-          data >>= 8;
+          nxsem_post(&g_rngdev.rd_readsem);
         }
     }
+#ifdef CONFIG_CRYPTO_RANDOM_POOL
+  else if (g_rngdev.rd_feed > 0)
+    {
+      g_rngdev.rd_feed--;
+      up_rngaddentropy(RND_SRC_HW, &data, 1);
+    }
+#endif
+  else if (g_rngdev.rd_head - g_rngdev.rd_tail <
+           CONFIG_STM32L4_RNG_RING_WORDS)
+    {
+      g_rngdev.rd_ring[g_rngdev.rd_head & RNG_RING_MASK] = data;
+      g_rngdev.rd_head++;
+    }
 
-  if (g_rngdev.rd_buflen == 0)
+  if (g_rngdev.rd_buflen == 0 && g_rngdev.rd_feed == 0 &&
+      g_rngdev.rd_head - g_rngdev.rd_tail == CONFIG_STM32L4_RNG_RING_WORDS)
     {
-      /* Buffer filled, stop further interrupts. */
+      /* Everything filled, stop further interrupts. */
 
       stm32l4_rngdisable();
-      nxsem_post(&g_rngdev.rd_readsem);
     }
 
   return OK;
@@ -228,6 +326,11 @@ static int stm32l4_rnginterrupt(int irq, void *context, void *arg)
 static ssize_t stm32l4_rngread(struct file *filep,
                                char *buffer, size_t buflen)
 {
+  irqstate_t flags;
+  uint32_t errors;
+  uint32_t data;
+  size_t nread = 0;
+  size_t n;
   int ret;
 
   ret = nxmutex_lock(&g_rngdev.rd_devlock);
@@ -238,22 +341,60 @@ static ssize_t stm32l4_rngread(struct file *filep,
 
   /* We've got the device semaphore, proceed with reading */
 
-  /* Reset the operation semaphore with 0 for blocking until the
-   * buffer is filled from interrupts.
-   */
+  errors = g_rngdev.rd_clockerrs + g_rngdev.rd_seederrs;
+  if (errors != g_rngdev.rd_reported)
+    {
+      _warn("WARNING: RNG clock errors %" PRIu32 ", seed errors %" PRIu32
+            "\n", g_rngdev.rd_clockerrs, g_rngdev.rd_seederrs);
+      g_rngdev.rd_reported = errors;
+    }
 
-  nxsem_reset(&g_rngdev.rd_readsem, 0);
+  /* Take what the ring holds.  A word is used once, even in part. */
 
-  g_rngdev.rd_buflen = buflen;
-  g_rngdev.rd_buf = buffer;
+  while (nread < buflen && g_rngdev.rd_tail != g_rngdev.rd_head)
+    {
+      data = g_rngdev.rd_ring[g_rngdev.rd_tail & RNG_RING_MASK];
+      g_rngdev.rd_ring[g_rngdev.rd_tail & RNG_RING_MASK] = 0;
+      g_rngdev.rd_tail++;
 
-  /* Enable RNG with interrupts */
+      n = MIN(buflen - nread, sizeof(data));
+      memcpy(buffer + nread, &data, n);
+      nread += n;
+    }
+
+  if (nread < buflen)
+    {
+      /* Reset the operation semaphore with 0 for blocking until the
+       * rest of the buffer is filled from interrupts.
+       */
+
+      nxsem_reset(&g_rngdev.rd_readsem, 0);
 
-  stm32l4_rngenable();
+      flags = enter_critical_section();
 
-  /* Wait until the buffer is filled */
+      g_rngdev.rd_buflen = buflen - nread;
+      g_rngdev.rd_buf = buffer + nread;
+
+      /* Enable RNG with interrupts */
+
+      if (!g_rngdev.rd_running)
+        {
+          stm32l4_rngenable();
+        }
 
-  nxsem_wait(&g_rngdev.rd_readsem);
+      leave_critical_section(flags);
+
+      /* Wait until the buffer is filled */
+
+      nxsem_wait_uninterruptible(&g_rngdev.rd_readsem);
+    }
+
+  /* Fill the ring again in the background once it runs low */
+
+  if (g_rngdev.rd_head - g_rngdev.rd_tail < CONFIG_STM32L4_RNG_RING_LOW)
+    {
+      stm32l4_rngrefill(CONFIG_STM32L4_RNG_POOL_WORDS);
+    }
 
   /* Free RNG via the device mutex for next use */
 
@@ -43,6 +43,7 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -58,6 +59,7 @@
 #include <nuttx/mutex.h>
 #include <nuttx/semaphore.h>
 
+#include "arm_internal.h"
 #include "stm32l4_dma.h"
 #include "stm32l4_gpio.h"
 #include "stm32l4_sai.h"
@@ -100,6 +102,15 @@
 #  define CONFIG_STM32L4_SAI_MAXINFLIGHT         (16)
 #endif
 
+#ifndef CONFIG_STM32L4_SAI_TDM_SLOTS
+#  define CONFIG_STM32L4_SAI_TDM_SLOTS           (2)
+#endif
+
+/* The SAI frame length is limited to 256 bit clocks */
+
+#define SAI_MAX_FRAMELEN                         (256)
+#define SAI_MAX_SLOTS                            (16)
+
 #ifdef CONFIG_STM32L4_SAI_DMA
 /* SAI DMA priority */
 
@@ -121,6 +132,65 @@
 #  define SAI_TXDMA8_CONFIG    (SAI_DMA_PRIO|DMA_CCR_MSIZE_8BITS |DMA_CCR_PSIZE_8BITS |DMA_CCR_MINC|DMA_CCR_DIR)
 #  define SAI_TXDMA16_CONFIG   (SAI_DMA_PRIO|DMA_CCR_MSIZE_16BITS|DMA_CCR_PSIZE_16BITS|DMA_CCR_MINC|DMA_CCR_DIR)
 #  define SAI_TXDMA32_CONFIG   (SAI_DMA_PRIO|DMA_CCR_MSIZE_32BITS|DMA_CCR_PSIZE_32BITS|DMA_CCR_MINC|DMA_CCR_DIR)
+
+/* DMA requests.  On parts with a DMAMUX every block has a fixed request
+ * line; otherwise the board must select the DMA channel (DMACHAN_SAIx_y).
+ */
+
+#  if !defined(DMACHAN_SAI1_A) && defined(DMAMAP_SAI1_A_0)
+#    define DMACHAN_SAI1_A     DMAMAP_SAI1_A_0
+#  endif
+#  if !defined(DMACHAN_SAI1_B) && defined(DMAMAP_SAI1_B_0)
+#    define DMACHAN_SAI1_B     DMAMAP_SAI1_B_0
+#  endif
+#  if !defined(DMACHAN_SAI2_A) && defined(DMAMAP_SAI2_A_0)
+#    define DMACHAN_SAI2_A     DMAMAP_SAI2_A_0
+#  endif
+#  if !defined(DMACHAN_SAI2_B) && defined(DMAMAP_SAI2_B_0)
+#    define DMACHAN_SAI2_B     DMAMAP_SAI2_B_0
+#  endif
+#endif
+
+#ifdef CONFIG_STM32L4_SAI_CIRCULAR
+#  if CONFIG_STM32L4_SAI_CIRCULAR_HALFSIZE < 4 || \
+      CONFIG_STM32L4_SAI_CIRCULAR_HALFSIZE > 32767
+#    error "CONFIG_STM32L4_SAI_CIRCULAR_HALFSIZE is out of range"
+#  endif
+
+/* Number of consecutive ring halves without queued audio buffers before
+ * the circular transfer is stopped.  Two halves guarantee that the last
+ * samples have been shifted out before the DMA is disabled.
+ */
+
+#  define SAI_RING_IDLE_HALVES 2
+
+/* With the mapped ring mode of the audio upper half, the two halves of the
+ * ring are the periods that the application writes or reads in place.
+ */
+
+#  ifdef CONFIG_AUDIO_RING_MAPPING
+#    define SAI_RING_MAPPING 1
+#  endif
+#endif
+
+/* SAI2 may take its frame synchronization and bit clock from SAI1 block A.
+ * The SAI2 blocks are then slaves of the external (SAI1) synchronization.
+ */
+
+#ifdef CONFIG_STM32L4_SAI2_SYNC_WITH_SAI1
+#  define SAI2_A_SYNCEN        SAI_CR1_SYNCEN_EXTERNAL
+#  define SAI2_B_SYNCEN        SAI_CR1_SYNCEN_EXTERNAL
+#else
+#  ifdef CONFIG_STM32L4_SAI2_A_SYNC_WITH_B
+#    define SAI2_A_SYNCEN      SAI_CR1_SYNCEN_INTERNAL
+#  else
+#    define SAI2_A_SYNCEN      SAI_CR1_SYNCEN_ASYNCH
+#  endif
+#  ifdef CONFIG_STM32L4_SAI2_B_SYNC_WITH_A
+#    define SAI2_B_SYNCEN      SAI_CR1_SYNCEN_INTERNAL
+#  else
+#    define SAI2_B_SYNCEN      SAI_CR1_SYNCEN_ASYNCH
+#  endif
 #endif
 
 /****************************************************************************
@@ -136,6 +206,9 @@ struct sai_buffer_s
   uint32_t timeout;            /* The timeout value to use with transfers */
   void *arg;                   /* The argument to be returned with the callback */
   struct ap_buffer_s *apb;     /* The audio buffer */
+#ifdef CONFIG_STM32L4_SAI_CIRCULAR
+  apb_samp_t xfrd;             /* Bytes moved through the ring buffer */
+#endif
   int result;                  /* The result of the transfer */
 };
 
@@ -148,15 +221,34 @@ struct stm32l4_sai_s
   mutex_t lock;                /* Assures mutually exclusive access to SAI */
   uint32_t frequency;          /* SAI clock frequency */
   uint32_t syncen;             /* Synchronization setting */
+  uintptr_t gcr;               /* Global configuration register (or 0) */
+  uint32_t gcrval;             /* SYNCIN/SYNCOUT setting for the GCR */
 #ifdef CONFIG_STM32L4_SAI_DMA
   uint16_t dma_ch;             /* DMA channel number */
   DMA_HANDLE dma;              /* DMA channel handle */
   uint32_t dma_ccr;            /* DMA control register */
 #endif
   uint8_t datalen;             /* Data width */
+  uint8_t nslots;              /* Number of (TDM) slots in a frame */
   uint32_t samplerate;         /* Data sample rate */
   uint8_t rxenab:1;            /* True: RX transfers enabled */
   uint8_t txenab:1;            /* True: TX transfers enabled */
+#ifdef CONFIG_STM32L4_SAI_CIRCULAR
+  uint8_t running:1;           /* True: circular DMA is running */
+  uint8_t idle;                /* Consecutive ring halves without buffers */
+  uint16_t halfbytes;          /* Bytes in each half of the ring */
+  uint16_t halfxfers;          /* DMA transfers in each half of the ring */
+#ifdef SAI_RING_MAPPING
+  uint8_t mapped:1;            /* True: the ring is mapped by the user */
+  uint16_t period;             /* Requested half size (0: the default) */
+  i2s_callback_t ringcb;       /* Called as each half of the ring elapses */
+  void *ringarg;               /* The argument of ringcb */
+#endif
+
+  /* Two halves of the circular DMA buffer */
+
+  uint8_t ring[2 * CONFIG_STM32L4_SAI_CIRCULAR_HALFSIZE] aligned_data(4);
+#endif
   struct wdog_s dog;           /* Watchdog that handles timeouts */
   sq_queue_t pend;             /* A queue of pending transfers */
   sq_queue_t act;              /* A queue of active transfers */
@@ -192,11 +284,17 @@ static void     sai_buf_initialize(struct stm32l4_sai_s *priv);
 
 #ifdef CONFIG_STM32L4_SAI_DMA
 static void     sai_schedule(struct stm32l4_sai_s *priv, int result);
+#ifdef CONFIG_STM32L4_SAI_CIRCULAR
+static void     sai_ring_callback(DMA_HANDLE handle, uint8_t isr,
+                                  void *arg);
+#else
 static void     sai_dma_callback(DMA_HANDLE handle, uint8_t isr, void *arg);
 #endif
+#endif
 
 /* I2S methods */
 
+static int      sai_channels(struct i2s_dev_s *dev, uint8_t channels);
 static uint32_t sai_samplerate(struct i2s_dev_s *dev, uint32_t rate);
 static uint32_t sai_datawidth(struct i2s_dev_s *dev, int bits);
 static int      sai_receive(struct i2s_dev_s *dev, struct ap_buffer_s *apb,
@@ -204,6 +302,10 @@ static int      sai_receive(struct i2s_dev_s *dev, struct ap_buffer_s *apb,
 static int      sai_send(struct i2s_dev_s *dev, struct ap_buffer_s *apb,
                   i2s_callback_t callback, void *arg,
                   uint32_t timeout);
+#ifdef SAI_RING_MAPPING
+static int      sai_ioctl(struct i2s_dev_s *dev, int cmd,
+                  unsigned long arg);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -215,15 +317,21 @@ static const struct i2s_ops_s g_i2sops =
 {
   /* Receiver methods */
 
+  .i2s_rxchannels   = sai_channels,
   .i2s_rxsamplerate = sai_samplerate,
   .i2s_rxdatawidth  = sai_datawidth,
   .i2s_receive      = sai_receive,
 
   /* Transmitter methods */
 
+  .i2s_txchannels   = sai_channels,
   .i2s_txsamplerate = sai_samplerate,
   .i2s_txdatawidth  = sai_datawidth,
   .i2s_send         = sai_send,
+
+#ifdef SAI_RING_MAPPING
+  .i2s_ioctl        = sai_ioctl,
+#endif
 };
 
 /* SAI1 state */
@@ -236,14 +344,19 @@ static struct stm32l4_sai_s g_sai1a_priv =
   .lock        = NXMUTEX_INITIALIZER,
   .frequency   = STM32L4_SAI1_FREQUENCY,
 #ifdef CONFIG_STM32L4_SAI1_A_SYNC_WITH_B
-  .syncen      = SAI_CR1_SYNCEN_SYNC_INT,
+  .syncen      = SAI_CR1_SYNCEN_INTERNAL,
 #else
-  .syncen      = SAI_CR1_SYNCEN_ASYNC,
+  .syncen      = SAI_CR1_SYNCEN_ASYNCH,
+#endif
+#ifdef CONFIG_STM32L4_SAI2_SYNC_WITH_SAI1
+  .gcr         = STM32L4_SAI1_GCR,
+  .gcrval      = SAI_GCR_SYNCOUT(1),
 #endif
 #ifdef CONFIG_STM32L4_SAI_DMA
   .dma_ch      = DMACHAN_SAI1_A,
 #endif
   .datalen     = CONFIG_STM32L4_SAI_DEFAULT_DATALEN,
+  .nslots      = CONFIG_STM32L4_SAI_TDM_SLOTS,
   .samplerate  = CONFIG_STM32L4_SAI_DEFAULT_SAMPLERATE,
   .bufsem      = SEM_INITIALIZER(CONFIG_STM32L4_SAI_MAXINFLIGHT),
 };
@@ -257,14 +370,15 @@ static struct stm32l4_sai_s g_sai1b_priv =
   .lock        = NXMUTEX_INITIALIZER,
   .frequency   = STM32L4_SAI1_FREQUENCY,
 #ifdef CONFIG_STM32L4_SAI1_B_SYNC_WITH_A
-  .syncen      = SAI_CR1_SYNCEN_SYNC_INT,
+  .syncen      = SAI_CR1_SYNCEN_INTERNAL,
 #else
-  .syncen      = SAI_CR1_SYNCEN_ASYNC,
+  .syncen      = SAI_CR1_SYNCEN_ASYNCH,
 #endif
 #ifdef CONFIG_STM32L4_SAI_DMA
   .dma_ch      = DMACHAN_SAI1_B,
 #endif
   .datalen     = CONFIG_STM32L4_SAI_DEFAULT_DATALEN,
+  .nslots      = CONFIG_STM32L4_SAI_TDM_SLOTS,
   .samplerate  = CONFIG_STM32L4_SAI_DEFAULT_SAMPLERATE,
   .bufsem      = SEM_INITIALIZER(CONFIG_STM32L4_SAI_MAXINFLIGHT),
 };
@@ -279,15 +393,16 @@ static struct stm32l4_sai_s g_sai2a_priv =
   .base        = STM32L4_SAI2_A_BASE,
   .lock        = NXMUTEX_INITIALIZER,
   .frequency   = STM32L4_SAI2_FREQUENCY,
-#ifdef CONFIG_STM32L4_SAI2_A_SYNC_WITH_B
-  .syncen      = SAI_CR1_SYNCEN_SYNC_INT,
-#else
-  .syncen      = SAI_CR1_SYNCEN_ASYNC,
+  .syncen      = SAI2_A_SYNCEN,
+#ifdef CONFIG_STM32L4_SAI2_SYNC_WITH_SAI1
+  .gcr         = STM32L4_SAI2_GCR,
+  .gcrval      = SAI_GCR_SYNCIN(0),
 #endif
 #ifdef CONFIG_STM32L4_SAI_DMA
   .dma_ch      = DMACHAN_SAI2_A,
 #endif
   .datalen     = CONFIG_STM32L4_SAI_DEFAULT_DATALEN,
+  .nslots      = CONFIG_STM32L4_SAI_TDM_SLOTS,
   .samplerate  = CONFIG_STM32L4_SAI_DEFAULT_SAMPLERATE,
   .bufsem      = SEM_INITIALIZER(CONFIG_STM32L4_SAI_MAXINFLIGHT),
 };
@@ -300,15 +415,16 @@ static struct stm32l4_sai_s g_sai2b_priv =
   .base        = STM32L4_SAI2_B_BASE,
   .lock        = NXMUTEX_INITIALIZER,
   .frequency   = STM32L4_SAI2_FREQUENCY,
-#ifdef CONFIG_STM32L4_SAI2_B_SYNC_WITH_A
-  .syncen      = SAI_CR1_SYNCEN_SYNC_INT,
-#else
-  .syncen      = SAI_CR1_SYNCEN_ASYNC,
+  .syncen      = SAI2_B_SYNCEN,
+#ifdef CONFIG_STM32L4_SAI2_SYNC_WITH_SAI1
+  .gcr         = STM32L4_SAI2_GCR,
+  .gcrval      = SAI_GCR_SYNCIN(0),
 #endif
 #ifdef CONFIG_STM32L4_SAI_DMA
   .dma_ch      = DMACHAN_SAI2_B,
 #endif
   .datalen     = CONFIG_STM32L4_SAI_DEFAULT_DATALEN,
+  .nslots      = CONFIG_STM32L4_SAI_TDM_SLOTS,
   .samplerate  = CONFIG_STM32L4_SAI_DEFAULT_SAMPLERATE,
   .bufsem      = SEM_INITIALIZER(CONFIG_STM32L4_SAI_MAXINFLIGHT),
 };
@@ -336,7 +452,7 @@ static inline uint32_t sai_getbitrate(struct stm32l4_sai_s *priv)
 {
   /* Calculate the bitrate in Hz */
 
-  return priv->samplerate * priv->datalen;
+  return priv->samplerate * priv->datalen * priv->nslots;
 }
 
 /****************************************************************************
@@ -476,6 +592,52 @@ static void sai_mckdivider(struct stm32l4_sai_s *priv)
                 mckdiv << SAI_CR1_MCKDIV_SHIFT);
 }
 
+/****************************************************************************
+ * Name: sai_frameconfig
+ *
+ * Description:
+ *   Program the frame and slot registers from the current data width and
+ *   number of slots.  Two slots give a standard I2S frame with a channel
+ *   side identification on FS; any other number of slots gives a TDM frame
+ *   whose FS is a one bit clock wide start-of-frame pulse.
+ *
+ * Input Parameters:
+ *   priv - SAI device structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void sai_frameconfig(struct stm32l4_sai_s *priv)
+{
+  uint32_t frcr;
+
+  DEBUGASSERT(priv->nslots > 0 && priv->nslots <= SAI_MAX_SLOTS &&
+              priv->datalen * priv->nslots <= SAI_MAX_FRAMELEN);
+
+  frcr = SAI_FRCR_FRL(priv->datalen * priv->nslots);
+  if (priv->nslots == 2)
+    {
+      frcr |= SAI_FRCR_FSDEF_CHID | SAI_FRCR_FSALL(priv->datalen);
+    }
+  else
+    {
+      frcr |= SAI_FRCR_FSDEF_SF | SAI_FRCR_FSALL(1);
+    }
+
+  sai_modifyreg(priv, STM32L4_SAI_FRCR_OFFSET,
+                SAI_FRCR_FSDEF | SAI_FRCR_FSALL_MASK | SAI_FRCR_FRL_MASK,
+                frcr);
+
+  sai_modifyreg(priv, STM32L4_SAI_SLOTR_OFFSET,
+                SAI_SLOTR_FBOFF_MASK | SAI_SLOTR_SLOTSZ_MASK |
+                SAI_SLOTR_NBSLOT_MASK | SAI_SLOTR_SLOTEN_MASK,
+                SAI_SLOTR_FBOFF(0) | SAI_SLOTR_SLOTSZ_DATA |
+                SAI_SLOTR_NBSLOT(priv->nslots) |
+                SAI_SLOTR_SLOTEN((1 << priv->nslots) - 1));
+}
+
 /****************************************************************************
  * Name: sai_timeout
  *
@@ -493,6 +655,7 @@ static void sai_mckdivider(struct stm32l4_sai_s *priv)
  *
  ****************************************************************************/
 
+#ifndef CONFIG_STM32L4_SAI_CIRCULAR
 static void sai_timeout(wdparm_t arg)
 {
   struct stm32l4_sai_s *priv = (struct stm32l4_sai_s *)arg;
@@ -510,6 +673,7 @@ static void sai_timeout(wdparm_t arg)
 
   sai_schedule(priv, -ETIMEDOUT);
 }
+#endif
 
 /****************************************************************************
  * Name: sai_dma_setup
@@ -528,7 +692,7 @@ static void sai_timeout(wdparm_t arg)
  *
  ****************************************************************************/
 
-#ifdef CONFIG_STM32L4_SAI_DMA
+#if defined(CONFIG_STM32L4_SAI_DMA) && !defined(CONFIG_STM32L4_SAI_CIRCULAR)
 static int sai_dma_setup(struct stm32l4_sai_s *priv)
 {
   struct sai_buffer_s *bfcontainer;
@@ -691,6 +855,7 @@ static void sai_worker(void *arg)
 
   i2sinfo("act.head=%p done.head=%p\n", priv->act.head, priv->done.head);
 
+#ifndef CONFIG_STM32L4_SAI_CIRCULAR
   /* Check if IDLE */
 
   if (sq_empty(&priv->act))
@@ -705,6 +870,7 @@ static void sai_worker(void *arg)
 #endif
       leave_critical_section(flags);
     }
+#endif
 
   /* Process each buffer in the done queue */
 
@@ -812,7 +978,7 @@ static void sai_schedule(struct stm32l4_sai_s *priv, int result)
  *
  ****************************************************************************/
 
-#ifdef CONFIG_STM32L4_SAI_DMA
+#if defined(CONFIG_STM32L4_SAI_DMA) && !defined(CONFIG_STM32L4_SAI_CIRCULAR)
 static void sai_dma_callback(DMA_HANDLE handle, uint8_t isr, void *arg)
 {
   struct stm32l4_sai_s *priv = (struct stm32l4_sai_s *)arg;
@@ -828,6 +994,413 @@ static void sai_dma_callback(DMA_HANDLE handle, uint8_t isr, void *arg)
 }
 #endif
 
+/****************************************************************************
+ * Name: sai_ring_fill
+ *
+ * Description:
+ *   Copy the next pending TX data into one half of the ring buffer.  Audio
+ *   buffers that have been completely copied are moved to the done queue.
+ *   If the pending queue runs dry, the remainder of the half is filled with
+ *   silence so that the output never stalls.
+ *
+ * Input Parameters:
+ *   priv - SAI state instance
+ *   dest - The half of the ring buffer to fill
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_SAI_CIRCULAR
+static void sai_ring_fill(struct stm32l4_sai_s *priv, uint8_t *dest)
+{
+  struct sai_buffer_s *bfcontainer;
+  struct ap_buffer_s *apb;
+  size_t remaining = priv->halfbytes;
+  size_t nbytes;
+
+  while (remaining > 0 &&
+         (bfcontainer = (struct sai_buffer_s *)sq_peek(&priv->pend)) != NULL)
+    {
+      apb    = bfcontainer->apb;
+      nbytes = apb->nbytes - apb->curbyte - bfcontainer->xfrd;
+      if (nbytes > remaining)
+        {
+          nbytes = remaining;
+        }
+
+      memcpy(dest, &apb->samp[apb->curbyte + bfcontainer->xfrd], nbytes);
+      bfcontainer->xfrd += nbytes;
+      dest              += nbytes;
+      remaining         -= nbytes;
+
+      if (apb->curbyte + bfcontainer->xfrd >= apb->nbytes)
+        {
+          sq_remfirst(&priv->pend);
+          bfcontainer->result = OK;
+          sq_addlast((sq_entry_t *)bfcontainer, &priv->done);
+        }
+    }
+
+  if (remaining > 0)
+    {
+      memset(dest, 0, remaining);
+    }
+}
+
+/****************************************************************************
+ * Name: sai_ring_drain
+ *
+ * Description:
+ *   Copy one half of the ring buffer into the pending RX audio buffers.
+ *   Audio buffers that have been filled are moved to the done queue.  Data
+ *   for which no buffer is available is discarded.
+ *
+ * Input Parameters:
+ *   priv - SAI state instance
+ *   src  - The half of the ring buffer that has been received
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled
+ *
+ ****************************************************************************/
+
+static void sai_ring_drain(struct stm32l4_sai_s *priv, const uint8_t *src)
+{
+  struct sai_buffer_s *bfcontainer;
+  struct ap_buffer_s *apb;
+  size_t remaining = priv->halfbytes;
+  size_t nbytes;
+
+  while (remaining > 0 &&
+         (bfcontainer = (struct sai_buffer_s *)sq_peek(&priv->pend)) != NULL)
+    {
+      apb    = bfcontainer->apb;
+      nbytes = apb->nmaxbytes - apb->curbyte - bfcontainer->xfrd;
+      if (nbytes > remaining)
+        {
+          nbytes = remaining;
+        }
+
+      memcpy(&apb->samp[apb->curbyte + bfcontainer->xfrd], src, nbytes);
+      bfcontainer->xfrd += nbytes;
+      src               += nbytes;
+      remaining         -= nbytes;
+
+      if (apb->curbyte + bfcontainer->xfrd >= apb->nmaxbytes)
+        {
+          sq_remfirst(&priv->pend);
+          apb->nbytes         = apb->nmaxbytes;
+          bfcontainer->result = OK;
+          sq_addlast((sq_entry_t *)bfcontainer, &priv->done);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: sai_ring_stop
+ *
+ * Description:
+ *   Stop the circular DMA transfer and disable the SAI block.  Any buffers
+ *   still pending are completed with the provided result.
+ *
+ * Input Parameters:
+ *   priv   - SAI state instance
+ *   result - The result reported for buffers that are still pending
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled
+ *
+ ****************************************************************************/
+
+static void sai_ring_stop(struct stm32l4_sai_s *priv, int result)
+{
+  struct sai_buffer_s *bfcontainer;
+
+  stm32l4_dmastop(priv->dma);
+  sai_modifyreg(priv, STM32L4_SAI_CR1_OFFSET, SAI_CR1_SAIEN, 0);
+  sai_modifyreg(priv, STM32L4_SAI_CR2_OFFSET, 0, SAI_CR2_FFLUSH);
+
+  while ((bfcontainer = (struct sai_buffer_s *)
+                        sq_remfirst(&priv->pend)) != NULL)
+    {
+      bfcontainer->result = result;
+      sq_addlast((sq_entry_t *)bfcontainer, &priv->done);
+    }
+
+  priv->running = false;
+
+#ifdef SAI_RING_MAPPING
+  /* A mapped ring keeps its direction until it is unmapped */
+
+  if (priv->mapped)
+    {
+      return;
+    }
+#endif
+
+  priv->txenab  = false;
+  priv->rxenab  = false;
+}
+
+/****************************************************************************
+ * Name: sai_ring_halves
+ *
+ * Description:
+ *   Split the ring in two halves of a whole number of frames.  The halves
+ *   are CONFIG_STM32L4_SAI_CIRCULAR_HALFSIZE bytes at most, or the period
+ *   requested for a mapped ring if that is smaller.
+ *
+ * Input Parameters:
+ *   priv - SAI state instance
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure
+ *
+ ****************************************************************************/
+
+static int sai_ring_halves(struct stm32l4_sai_s *priv)
+{
+  unsigned int width = priv->datalen >> 3;
+  unsigned int frame = width * priv->nslots;
+  unsigned int size  = CONFIG_STM32L4_SAI_CIRCULAR_HALFSIZE;
+
+#ifdef SAI_RING_MAPPING
+  if (priv->mapped && priv->period > 0 && priv->period < size)
+    {
+      size = priv->period;
+    }
+#endif
+
+  priv->halfbytes = size - size % frame;
+  priv->halfxfers = priv->halfbytes / width;
+
+  if (priv->halfbytes == 0)
+    {
+      i2serr("ERROR: ring half smaller than one frame (%u bytes)\n", frame);
+      return -EINVAL;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sai_ring_start
+ *
+ * Description:
+ *   Start the continuous circular DMA transfer if it is not already
+ *   running.  The ring is split in two halves of a whole number of frames;
+ *   for TX both halves are primed from the pending queue before the DMA is
+ *   started.
+ *
+ * Input Parameters:
+ *   priv - SAI state instance
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure
+ *
+ * Assumptions:
+ *   Interrupts are disabled
+ *
+ ****************************************************************************/
+
+static int sai_ring_start(struct stm32l4_sai_s *priv)
+{
+  int ret;
+
+  if (priv->running)
+    {
+      return OK;
+    }
+
+  ret = sai_ring_halves(priv);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (priv->datalen)
+    {
+      case 8:
+        priv->dma_ccr = priv->txenab ? SAI_TXDMA8_CONFIG : SAI_RXDMA8_CONFIG;
+        break;
+
+      case 16:
+        priv->dma_ccr = priv->txenab ? SAI_TXDMA16_CONFIG :
+                                       SAI_RXDMA16_CONFIG;
+        break;
+
+      default:
+        priv->dma_ccr = priv->txenab ? SAI_TXDMA32_CONFIG :
+                                       SAI_RXDMA32_CONFIG;
+        break;
+    }
+
+  /* A mapped ring has already been primed by the application */
+
+#ifdef SAI_RING_MAPPING
+  if (priv->txenab && !priv->mapped)
+#else
+  if (priv->txenab)
+#endif
+    {
+      sai_ring_fill(priv, priv->ring);
+      sai_ring_fill(priv, &priv->ring[priv->halfbytes]);
+    }
+
+  stm32l4_dmasetup(priv->dma, priv->base + STM32L4_SAI_DR_OFFSET,
+                   (uint32_t)priv->ring, 2 * priv->halfxfers,
+                   priv->dma_ccr | DMA_CCR_CIRC);
+  stm32l4_dmastart(priv->dma, sai_ring_callback, priv, true);
+
+  priv->running = true;
+  priv->idle    = 0;
+
+  sai_modifyreg(priv, STM32L4_SAI_CR1_OFFSET, 0, SAI_CR1_SAIEN);
+
+  /* Buffers shorter than the ring may already be complete */
+
+  if (!sq_empty(&priv->done))
+    {
+      sai_schedule(priv, OK);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sai_ring_callback
+ *
+ * Description:
+ *   This callback function is invoked each time the circular DMA has
+ *   completed one half of the ring buffer.  The completed half is refilled
+ *   (TX) or emptied (RX) while the DMA continues with the other half, so
+ *   consecutive audio buffers are transferred without any gap.
+ *
+ * Input Parameters:
+ *   handle - The DMA handler
+ *   isr    - The interrupt status of the DMA transfer
+ *   arg    - A pointer to the SAI state instance
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void sai_ring_callback(DMA_HANDLE handle, uint8_t isr, void *arg)
+{
+  struct stm32l4_sai_s *priv = (struct stm32l4_sai_s *)arg;
+  unsigned int ready;
+  uint8_t *half;
+
+  DEBUGASSERT(priv);
+
+  if ((isr & DMA_CHAN_TEIF_BIT) != 0)
+    {
+      sai_ring_stop(priv, -EIO);
+#ifdef SAI_RING_MAPPING
+      if (priv->mapped)
+        {
+          priv->ringcb(&priv->dev, NULL, priv->ringarg, -EIO);
+          return;
+        }
+#endif
+
+      sai_schedule(priv, -EIO);
+      return;
+    }
+
+#ifdef SAI_RING_MAPPING
+  /* The user owns a mapped ring: just report the elapsed half */
+
+  if (priv->mapped)
+    {
+      priv->ringcb(&priv->dev, NULL, priv->ringarg, OK);
+      return;
+    }
+#endif
+
+  /* The DMA is now running in one half; the other one is ours */
+
+  ready = stm32l4_dmaresidual(handle) > priv->halfxfers ? 1 : 0;
+  half  = &priv->ring[ready * priv->halfbytes];
+
+  if (sq_empty(&priv->pend))
+    {
+      if (++priv->idle >= SAI_RING_IDLE_HALVES)
+        {
+          sai_ring_stop(priv, OK);
+          return;
+        }
+    }
+  else
+    {
+      priv->idle = 0;
+    }
+
+  if (priv->txenab)
+    {
+      sai_ring_fill(priv, half);
+    }
+  else
+    {
+      sai_ring_drain(priv, half);
+    }
+
+  if (!sq_empty(&priv->done))
+    {
+      sai_schedule(priv, OK);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: sai_channels
+ *
+ * Description:
+ *   Set the I2S RX/TX number of channels.  Each channel occupies one slot
+ *   of the audio frame; more than two channels select TDM framing.
+ *
+ * Input Parameters:
+ *   dev      - Device-specific state data
+ *   channels - The I2S numbers of channels
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int sai_channels(struct i2s_dev_s *dev, uint8_t channels)
+{
+  struct stm32l4_sai_s *priv = (struct stm32l4_sai_s *)dev;
+
+  DEBUGASSERT(priv);
+
+  if (channels < 1 || channels > SAI_MAX_SLOTS ||
+      priv->datalen * channels > SAI_MAX_FRAMELEN)
+    {
+      i2serr("ERROR: Unsupported number of channels: %d\n", channels);
+      return -EINVAL;
+    }
+
+  /* Save the new number of slots and update the frame */
+
+  priv->nslots = channels;
+  sai_frameconfig(priv);
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: sai_samplerate
  *
@@ -899,15 +1472,19 @@ static uint32_t sai_datawidth(struct i2s_dev_s *dev, int bits)
         return 0;
     }
 
-  sai_modifyreg(priv, STM32L4_SAI_CR1_OFFSET, SAI_CR1_DS_MASK, setbits);
+  if (bits * priv->nslots > SAI_MAX_FRAMELEN)
+    {
+      i2serr("ERROR: %d slots of %d bits exceed the frame length\n",
+             priv->nslots, bits);
+      return 0;
+    }
 
-  sai_modifyreg(priv, STM32L4_SAI_FRCR_OFFSET,
-                SAI_FRCR_FSALL_MASK | SAI_FRCR_FRL_MASK,
-                SAI_FRCR_FSALL(bits) | SAI_FRCR_FRL(bits * 2));
+  sai_modifyreg(priv, STM32L4_SAI_CR1_OFFSET, SAI_CR1_DS_MASK, setbits);
 
-  /* Save the new data width */
+  /* Save the new data width and update the frame */
 
   priv->datalen = bits;
+  sai_frameconfig(priv);
 
   return sai_getbitrate(priv);
 }
@@ -971,7 +1548,11 @@ static int sai_receive(struct i2s_dev_s *dev, struct ap_buffer_s *apb,
 
   /* Verify not already TX'ing */
 
+#ifdef SAI_RING_MAPPING
+  if (priv->txenab || priv->mapped)
+#else
   if (priv->txenab)
+#endif
     {
       i2serr("ERROR: SAI has no receiver\n");
       ret = -EAGAIN;
@@ -1003,7 +1584,9 @@ static int sai_receive(struct i2s_dev_s *dev, struct ap_buffer_s *apb,
    * progress, then this will do nothing.
    */
 
-#ifdef CONFIG_STM32L4_SAI_DMA
+#if defined(CONFIG_STM32L4_SAI_CIRCULAR)
+  ret = sai_ring_start(priv);
+#elif defined(CONFIG_STM32L4_SAI_DMA)
   ret = sai_dma_setup(priv);
 #endif
   DEBUGASSERT(ret == OK);
@@ -1076,7 +1659,11 @@ static int sai_send(struct i2s_dev_s *dev, struct ap_buffer_s *apb,
 
   /* Verify not already RX'ing */
 
+#ifdef SAI_RING_MAPPING
+  if (priv->rxenab || priv->mapped)
+#else
   if (priv->rxenab)
+#endif
     {
       i2serr("ERROR: SAI has no transmitter\n");
       ret = -EAGAIN;
@@ -1108,7 +1695,9 @@ static int sai_send(struct i2s_dev_s *dev, struct ap_buffer_s *apb,
    * progress, then this will do nothing.
    */
 
-#ifdef CONFIG_STM32L4_SAI_DMA
+#if defined(CONFIG_STM32L4_SAI_CIRCULAR)
+  ret = sai_ring_start(priv);
+#elif defined(CONFIG_STM32L4_SAI_DMA)
   ret = sai_dma_setup(priv);
 #endif
   DEBUGASSERT(ret == OK);
@@ -1122,6 +1711,138 @@ errout_with_lock:
   return ret;
 }
 
+/****************************************************************************
+ * Name: sai_ioctl
+ *
+ * Description:
+ *   Handle the mapped ring commands of the audio upper half.  While the
+ *   ring is mapped the DMA runs over it without audio buffers from
+ *   AUDIOIOC_START to AUDIOIOC_STOP and the callback of the mapping is
+ *   invoked from the DMA interrupt as each half elapses.
+ *
+ * Input Parameters:
+ *   dev - Device-specific state data
+ *   cmd - The AUDIOIOC_* command
+ *   arg - The argument of the command
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef SAI_RING_MAPPING
+static int sai_ioctl(struct i2s_dev_s *dev, int cmd, unsigned long arg)
+{
+  struct stm32l4_sai_s *priv = (struct stm32l4_sai_s *)dev;
+  struct i2s_ring_s *ring;
+  irqstate_t flags;
+  uint32_t mode;
+  int ret;
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (cmd)
+    {
+      case AUDIOIOC_MAPRING:
+        ring = (struct i2s_ring_s *)arg;
+        DEBUGASSERT(ring != NULL && ring->callback != NULL);
+
+        if (priv->mapped || priv->running || priv->txenab || priv->rxenab)
+          {
+            ret = -EBUSY;
+            break;
+          }
+
+        priv->mapped = true;
+        priv->period = ring->ring.period > UINT16_MAX ? 0 :
+                       ring->ring.period;
+
+        ret = sai_ring_halves(priv);
+        if (ret < 0)
+          {
+            priv->mapped = false;
+            break;
+          }
+
+        if (ring->playback)
+          {
+            mode = priv->syncen ? SAI_CR1_MODE_SLAVE_TX :
+                                  SAI_CR1_MODE_MASTER_TX;
+            priv->txenab = true;
+          }
+        else
+          {
+            mode = priv->syncen ? SAI_CR1_MODE_SLAVE_RX :
+                                  SAI_CR1_MODE_MASTER_RX;
+            priv->rxenab = true;
+          }
+
+        sai_modifyreg(priv, STM32L4_SAI_CR1_OFFSET, SAI_CR1_MODE_MASK, mode);
+
+        memset(priv->ring, 0, 2 * priv->halfbytes);
+        priv->ringcb      = ring->callback;
+        priv->ringarg     = ring->arg;
+
+        ring->ring.buffer = priv->ring;
+        ring->ring.size   = 2 * priv->halfbytes;
+        ring->ring.period = priv->halfbytes;
+        break;
+
+      case AUDIOIOC_UNMAPRING:
+        flags = enter_critical_section();
+        if (priv->running)
+          {
+            sai_ring_stop(priv, OK);
+          }
+
+        priv->mapped = false;
+        priv->txenab = false;
+        priv->rxenab = false;
+        leave_critical_section(flags);
+        break;
+
+      case AUDIOIOC_START:
+        if (priv->mapped)
+          {
+            flags = enter_critical_section();
+            ret   = sai_ring_start(priv);
+            leave_critical_section(flags);
+            break;
+          }
+
+        ret = -ENOTTY;
+        break;
+
+      case AUDIOIOC_STOP:
+        if (priv->mapped)
+          {
+            flags = enter_critical_section();
+            if (priv->running)
+              {
+                sai_ring_stop(priv, OK);
+              }
+
+            leave_critical_section(flags);
+            break;
+          }
+
+        ret = -ENOTTY;
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  nxmutex_unlock(&priv->lock);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: sai_buf_allocate
  *
@@ -1155,7 +1876,7 @@ static struct sai_buffer_s *sai_buf_allocate(struct stm32l4_sai_s *priv)
   ret = nxsem_wait_uninterruptible(&priv->bufsem);
   if (ret < 0)
     {
-      return ret;
+      return NULL;
     }
 
   /* Get the buffer from the head of the free list */
@@ -1279,18 +2000,20 @@ static void sai_portinitialize(struct stm32l4_sai_s *priv)
   sai_modifyreg(priv, STM32L4_SAI_CR1_OFFSET, SAI_CR1_SYNCEN_MASK,
                 priv->syncen);
 
+  /* Route the synchronization signals between SAI1 and SAI2 */
+
+  if (priv->gcr != 0)
+    {
+      modifyreg32(priv->gcr, SAI_GCR_SYNCIN_MASK | SAI_GCR_SYNCOUT_MASK,
+                  priv->gcrval);
+    }
+
   sai_modifyreg(priv, STM32L4_SAI_CR2_OFFSET, SAI_CR2_FTH_MASK,
                 SAI_CR2_FTH_1QF);
 
   sai_modifyreg(priv, STM32L4_SAI_FRCR_OFFSET,
-                SAI_FRCR_FSDEF | SAI_FRCR_FSPOL | SAI_FRCR_FSOFF,
-                SAI_FRCR_FSDEF_CHID | SAI_FRCR_FSPOL_LOW |
-                SAI_FRCR_FSOFF_BFB);
-
-  sai_modifyreg(priv, STM32L4_SAI_SLOTR_OFFSET,
-                SAI_SLOTR_NBSLOT_MASK | SAI_SLOTR_SLOTEN_MASK,
-                SAI_SLOTR_NBSLOT(2) | SAI_SLOTR_SLOTEN_0 |
-                SAI_SLOTR_SLOTEN_1);
+                SAI_FRCR_FSPOL | SAI_FRCR_FSOFF,
+                SAI_FRCR_FSPOL_LOW | SAI_FRCR_FSOFF_BFB);
 
   sai_dump_regs(priv, "After initialization");
 }
@@ -1361,7 +2084,8 @@ struct i2s_dev_s *stm32l4_sai_initialize(int intf)
           priv = &g_sai2a_priv;
 
           stm32l4_configgpio(GPIO_SAI2_SD_A);
-#  ifndef CONFIG_STM32L4_SAI2_A_SYNC_WITH_B
+#  if !defined(CONFIG_STM32L4_SAI2_A_SYNC_WITH_B) && \
+      !defined(CONFIG_STM32L4_SAI2_SYNC_WITH_SAI1)
           stm32l4_configgpio(GPIO_SAI2_FS_A);
           stm32l4_configgpio(GPIO_SAI2_SCK_A);
           stm32l4_configgpio(GPIO_SAI2_MCLK_A);
@@ -1377,7 +2101,8 @@ struct i2s_dev_s *stm32l4_sai_initialize(int intf)
           priv = &g_sai2b_priv;
 
           stm32l4_configgpio(GPIO_SAI2_SD_B);
-#  ifndef CONFIG_STM32L4_SAI2_B_SYNC_WITH_A
+#  if !defined(CONFIG_STM32L4_SAI2_B_SYNC_WITH_A) && \
+      !defined(CONFIG_STM32L4_SAI2_SYNC_WITH_SAI1)
           stm32l4_configgpio(GPIO_SAI2_FS_B);
           stm32l4_configgpio(GPIO_SAI2_SCK_B);
           stm32l4_configgpio(GPIO_SAI2_MCLK_B);
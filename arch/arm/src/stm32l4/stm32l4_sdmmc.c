@@ -72,6 +72,10 @@
  *   CONFIG_STM32L4_SDMMC_DMA - Enable SDMMC.  This is a marginally
  *    optional.  For most usages, SDMMC will cause data overruns if used
  *    without DMA.  NOTE the above system DMA configuration options.
+ *   CONFIG_STM32L4_SDMMC_IDMA - Use the SDMMC internal DMA of the STM32L4+
+ *     instead of a system DMA channel.  No DMA2 channel is then needed.
+ *   CONFIG_STM32L4_SDMMC_IDMA_BUFSIZE - Transfers longer than this are
+ *     performed in IDMA double-buffer mode.  Zero: single buffer mode only.
  *   CONFIG_SDMMC1/2_WIDTH_D1_ONLY - This may be selected to force the driver
  *     operate with only a single data line (the default is to use all
  *     4 SD data lines).
@@ -84,8 +88,10 @@
 
 #ifndef CONFIG_STM32L4_SDMMC_DMA
 #  warning "Large Non-DMA transfer may result in RX overrun failures"
+#  undef CONFIG_STM32L4_SDMMC_IDMA
 #else
-#  if !defined(CONFIG_STM32L4_DMA2) && !defined(CONFIG_STM32L4_DMAMUX)
+#  if !defined(CONFIG_STM32L4_DMA2) && !defined(CONFIG_STM32L4_DMAMUX) && \
+      !defined(CONFIG_STM32L4_SDMMC_IDMA)
 #    error "CONFIG_STM32L4_SDMMC_DMA support requires CONFIG_STM32L4_DMA2"
 #  endif
 #  ifndef CONFIG_SDIO_DMA
@@ -97,8 +103,23 @@
 #  error "Callback support requires CONFIG_SCHED_WORKQUEUE and CONFIG_SCHED_HPWORK"
 #endif
 
+/* Write complete detection.  The SDMMC of the STM32L4+ parts signals the
+ * end of the SDMMC_D0 busy that follows a command response (CMD12 after a
+ * multiple block write) with its own BUSYD0END interrupt, and its DPSM only
+ * reports the end of a single block write once the busy is over.  The
+ * other parts turn SDMMC_D0 into an EXTI input while waiting.
+ */
+
+#ifdef CONFIG_MMCSD_SDIOWAIT_WRCOMPLETE
+#  ifdef CONFIG_STM32L4_STM32L4XR
+#    define HAVE_SDMMC_BUSYD0END 1
+#  else
+#    define HAVE_SDMMC_D0EXTI 1
+#  endif
+#endif
+
 #ifdef CONFIG_STM32L4_SDMMC1
-#  ifdef CONFIG_STM32L4_SDMMC_DMA
+#  if defined(CONFIG_STM32L4_SDMMC_DMA) && !defined(CONFIG_STM32L4_SDMMC_IDMA)
 #    ifndef CONFIG_STM32L4_SDMMC1_DMAPRIO
 #        define CONFIG_STM32L4_SDMMC1_DMAPRIO DMA_SCR_PRIVERYHI
 #    endif
@@ -111,7 +132,7 @@
 #endif
 
 #ifdef CONFIG_STM32L4_SDMMC2
-#  ifdef CONFIG_STM32L4_SDMMC_DMA
+#  if defined(CONFIG_STM32L4_SDMMC_DMA) && !defined(CONFIG_STM32L4_SDMMC_IDMA)
 #    ifndef CONFIG_STM32L4_SDMMC2_DMAPRIO
 #        define CONFIG_STM32L4_SDMMC2_DMAPRIO DMA_SCR_PRIVERYHI
 #    endif
@@ -123,10 +144,27 @@
 #  endif
 #endif
 
+#ifdef CONFIG_STM32L4_SDMMC_IDMA
+#  ifndef CONFIG_STM32L4_SDMMC_IDMA_BUFSIZE
+#    define CONFIG_STM32L4_SDMMC_IDMA_BUFSIZE 0
+#  endif
+#  if (CONFIG_STM32L4_SDMMC_IDMA_BUFSIZE & 511) != 0 || \
+      CONFIG_STM32L4_SDMMC_IDMA_BUFSIZE > STM32_SDMMC_IDMABSIZE_MAX
+#    error "Illegal value for CONFIG_STM32L4_SDMMC_IDMA_BUFSIZE"
+#  endif
+#endif
+
 #if !defined(CONFIG_DEBUG_FS) || !defined(CONFIG_DEBUG_FEATURES)
 #  undef CONFIG_STM32L4_SDMMC_XFRDEBUG
 #endif
 
+/* The DMA registers can only be sampled when a system DMA channel is used */
+
+#if defined(CONFIG_DEBUG_DMA_INFO) && defined(CONFIG_STM32L4_SDMMC_DMA) && \
+    !defined(CONFIG_STM32L4_SDMMC_IDMA)
+#  define SDMMC_DMA_XFRDEBUG 1
+#endif
+
 /* Friendly CLKCR bit re-definitions ****************************************/
 
 #define STM32_CLKCR_RISINGEDGE    (0)
@@ -144,7 +182,9 @@
 /* Mode dependent settings.  These depend on clock divisor settings that must
  * be defined in the board-specific board.h header file:
  * STM32_SDMMC_INIT_CLKDIV, STM32_SDMMC_MMCXFR_CLKDIV, and
- * STM32_SDMMC_SDXFR_CLKDIV.
+ * STM32_SDMMC_SDXFR_CLKDIV.  A board whose SDMMC kernel clock allows up to
+ * 50MHz may also define STM32_SDMMC_HSXFR_CLKDIV (possibly as
+ * STM32_SDMMC_CLKCR_BYPASS) to let SD cards run in high speed mode.
  */
 
 #define STM32_CLCKCR_INIT           (STM32_SDMMC_INIT_CLKDIV      | \
@@ -159,6 +199,11 @@
 #define STM32_SDMMC_CLCKR_SDWIDEXFR (STM32_SDMMC_SDXFR_CLKDIV     | \
                                      STM32_SDMMC_CLKCR_EDGE | \
                                      STM32_SDMMC_CLKCR_WIDBUS_D4)
+#ifdef STM32_SDMMC_HSXFR_CLKDIV
+#  define STM32_SDMMC_CLCKR_SDHSXFR (STM32_SDMMC_HSXFR_CLKDIV     | \
+                                     STM32_SDMMC_CLKCR_EDGE | \
+                                     STM32_SDMMC_CLKCR_WIDBUS_D4)
+#endif
 
 /* Timing */
 
@@ -240,6 +285,10 @@
                                    STM32_SDMMC_MASK_TXUNDERRIE | \
                                    STM32_SDMMC_MASK_STBITERRIE)
 
+/* IDMA buffer transfer complete, only enabled in double-buffer mode */
+
+#define STM32_SDMMC_IDMADBL_MASK  (STM32_SDMMC_MASK_IDMABTCIE)
+
 /* Event waiting interrupt mask bits */
 
 #define STM32_SDMMC_CMDDONE_STA   (STM32_SDMMC_STA_CMDSENT)
@@ -266,12 +315,23 @@
                                    STM32_SDMMC_ICR_CMDRENDC  | \
                                    STM32_SDMMC_ICR_DBCKENDC)
 
-#define STM32_SDMMC_XFRDONE_ICR   (STM32_SDMMC_ICR_DATAENDC  | \
+#ifdef CONFIG_STM32L4_SDMMC_IDMA
+#  define STM32_SDMMC_XFRDONE_ICR (STM32_SDMMC_ICR_DATAENDC  | \
+                                   STM32_SDMMC_ICR_DCRCFAILC | \
+                                   STM32_SDMMC_ICR_DTIMEOUTC | \
+                                   STM32_SDMMC_ICR_RXOVERRC  | \
+                                   STM32_SDMMC_ICR_TXUNDERRC | \
+                                   STM32_SDMMC_ICR_DBCKENDC  | \
+                                   STM32_SDMMC_ICR_IDMATEC   | \
+                                   STM32_SDMMC_ICR_IDMABTCC)
+#else
+#  define STM32_SDMMC_XFRDONE_ICR (STM32_SDMMC_ICR_DATAENDC  | \
                                    STM32_SDMMC_ICR_DCRCFAILC | \
                                    STM32_SDMMC_ICR_DTIMEOUTC | \
                                    STM32_SDMMC_ICR_RXOVERRC  | \
                                    STM32_SDMMC_ICR_TXUNDERRC | \
                                    STM32_SDMMC_ICR_DBCKENDC)
+#endif
 
 #define STM32_SDMMC_WAITALL_ICR   (STM32_SDMMC_CMDDONE_ICR   | \
                                    STM32_SDMMC_RESPDONE_ICR  | \
@@ -316,10 +376,10 @@ struct stm32_dev_s
 
   uint32_t          base;
   int               nirq;
-#ifdef CONFIG_MMCSD_SDIOWAIT_WRCOMPLETE
+#ifdef HAVE_SDMMC_D0EXTI
   uint32_t          d0_gpio;
 #endif
-#ifdef CONFIG_STM32L4_SDMMC_DMA
+#if defined(CONFIG_STM32L4_SDMMC_DMA) && !defined(CONFIG_STM32L4_SDMMC_IDMA)
   uint32_t          dmapri;
 #endif
 
@@ -352,8 +412,13 @@ struct stm32_dev_s
 #ifdef CONFIG_STM32L4_SDMMC_DMA
   volatile uint8_t   xfrflags;        /* Used to synchronize SDMMC and DMA completion events */
   bool               dmamode;         /* true: DMA mode transfer */
+#ifdef CONFIG_STM32L4_SDMMC_IDMA
+  uint32_t           idmanext;        /* Next buffer for the idle IDMA base */
+  size_t             idmaleft;        /* Bytes not yet handed to the IDMA */
+#else
   DMA_HANDLE         dma;             /* Handle for DMA channel */
 #endif
+#endif
 };
 
 /* Register logging support */
@@ -375,7 +440,7 @@ struct stm32_sdioregs_s
 struct stm32_sampleregs_s
 {
   struct stm32_sdioregs_s sdio;
-#if defined(CONFIG_DEBUG_DMA_INFO) && defined(CONFIG_STM32L4_SDMMC_DMA)
+#ifdef SDMMC_DMA_XFRDEBUG
   struct stm32_dmaregs_s  dma;
 #endif
 };
@@ -414,8 +479,14 @@ static void stm32_dumpsamples(struct stm32_dev_s *priv);
 #endif
 
 #ifdef CONFIG_STM32L4_SDMMC_DMA
+#ifdef CONFIG_STM32L4_SDMMC_IDMA
+static void stm32_idmasetup(struct stm32_dev_s *priv, uint32_t buffer,
+                            size_t buflen);
+static void stm32_idmareload(struct stm32_dev_s *priv);
+#else
 static void stm32_dmacallback(DMA_HANDLE handle, uint8_t status, void *arg);
 #endif
+#endif
 
 /* Data Transfer Helpers ****************************************************/
 
@@ -434,7 +505,7 @@ static void stm32_endtransfer(struct stm32_dev_s *priv,
 /* Interrupt Handling *******************************************************/
 
 static int  stm32_sdmmc_interrupt(int irq, void *context, void *arg);
-#ifdef CONFIG_MMCSD_SDIOWAIT_WRCOMPLETE
+#ifdef HAVE_SDMMC_D0EXTI
 static int  stm32_sdmmc_rdyinterrupt(int irq, void *context, void *arg);
 #endif
 
@@ -561,7 +632,7 @@ struct stm32_dev_s g_sdmmcdev1 =
   },
   .base              = STM32L4_SDMMC1_BASE,
   .nirq              = STM32L4_IRQ_SDMMC1,
-#ifdef CONFIG_MMCSD_SDIOWAIT_WRCOMPLETE
+#ifdef HAVE_SDMMC_D0EXTI
   .d0_gpio           = GPIO_SDMMC1_D0,
 #endif
 #ifdef CONFIG_STM32L4_SDMMC1_DMAPRIO
@@ -615,7 +686,7 @@ struct stm32_dev_s g_sdmmcdev2 =
   },
   .base              = STM32_SDMMC2_BASE,
   .nirq              = STM32_IRQ_SDMMC2,
-#ifdef CONFIG_MMCSD_SDIOWAIT_WRCOMPLETE
+#ifdef HAVE_SDMMC_D0EXTI
   .d0_gpio           = GPIO_SDMMC2_D0,
 #endif
 #ifdef CONFIG_STM32L4_SDMMC2_DMAPRIO
@@ -739,7 +810,7 @@ static void stm32_configwaitints(struct stm32_dev_s *priv, uint32_t waitmask,
                                  sdio_eventset_t wkupevent)
 {
   irqstate_t flags;
-#ifdef CONFIG_MMCSD_SDIOWAIT_WRCOMPLETE
+#ifdef HAVE_SDMMC_D0EXTI
   int pinset;
 #endif
 
@@ -756,6 +827,11 @@ static void stm32_configwaitints(struct stm32_dev_s *priv, uint32_t waitmask,
 
       waitmask &= ~SDIOWAIT_WRCOMPLETE;
 
+#ifdef HAVE_SDMMC_BUSYD0END
+      /* Wake up on the end of busy interrupt of the SDMMC instead */
+
+      waitmask |= STM32_SDMMC_MASK_BUSYD0ENDIE;
+#else
       pinset = priv->d0_gpio & (GPIO_PORT_MASK | GPIO_PIN_MASK);
       pinset |= (GPIO_INPUT | GPIO_FLOAT | GPIO_EXTI);
 
@@ -763,8 +839,10 @@ static void stm32_configwaitints(struct stm32_dev_s *priv, uint32_t waitmask,
 
       stm32_gpiosetevent(pinset, true, false, false,
                          stm32_sdmmc_rdyinterrupt, priv);
+#endif
     }
 
+#ifdef HAVE_SDMMC_D0EXTI
   /* Disarm SDMMC_D0 ready and return it to SDMMC D0 */
 
   if ((wkupevent & SDIOWAIT_WRCOMPLETE) != 0)
@@ -772,6 +850,7 @@ static void stm32_configwaitints(struct stm32_dev_s *priv, uint32_t waitmask,
       stm32_gpiosetevent(priv->d0_gpio, false, false, false,
                          NULL, NULL);
     }
+#endif
 #endif
 
   priv->waitevents = waitevents;
@@ -890,7 +969,7 @@ static void stm32_sample(struct stm32_dev_s *priv, int index)
 {
   struct stm32_sampleregs_s *regs = &g_sampleregs[index];
 
-#if defined(CONFIG_DEBUG_DMA_INFO) && defined(CONFIG_STM32L4_SDMMC_DMA)
+#ifdef SDMMC_DMA_XFRDEBUG
   if (priv->dmamode)
     {
       stm32_dmasample(priv->dma, &regs->dma);
@@ -938,7 +1017,7 @@ static void stm32_dumpsample(struct stm32_dev_s *priv,
                              struct stm32_sampleregs_s *regs,
                              const char *msg)
 {
-#if defined(CONFIG_DEBUG_DMA_INFO) && defined(CONFIG_STM32L4_SDMMC_DMA)
+#ifdef SDMMC_DMA_XFRDEBUG
   if (priv->dmamode)
     {
       stm32_dmadump(priv->dma, &regs->dma, msg);
@@ -963,7 +1042,7 @@ static void stm32_dumpsamples(struct stm32_dev_s *priv)
   stm32_dumpsample(priv, &g_sampleregs[SAMPLENDX_BEFORE_SETUP],
                    "Before setup");
 
-#if defined(CONFIG_DEBUG_DMA_INFO) && defined(CONFIG_STM32L4_SDMMC_DMA)
+#ifdef SDMMC_DMA_XFRDEBUG
   if (priv->dmamode)
     {
       stm32_dumpsample(priv, &g_sampleregs[SAMPLENDX_BEFORE_ENABLE],
@@ -976,7 +1055,7 @@ static void stm32_dumpsamples(struct stm32_dev_s *priv)
   stm32_dumpsample(priv, &g_sampleregs[SAMPLENDX_END_TRANSFER],
                    "End of transfer");
 
-#if defined(CONFIG_DEBUG_DMA_INFO) && defined(CONFIG_STM32L4_SDMMC_DMA)
+#ifdef SDMMC_DMA_XFRDEBUG
   if (priv->dmamode)
     {
       stm32_dumpsample(priv, &g_sampleregs[SAMPLENDX_DMA_CALLBACK],
@@ -994,7 +1073,7 @@ static void stm32_dumpsamples(struct stm32_dev_s *priv)
  *
  ****************************************************************************/
 
-#ifdef CONFIG_STM32L4_SDMMC_DMA
+#if defined(CONFIG_STM32L4_SDMMC_DMA) && !defined(CONFIG_STM32L4_SDMMC_IDMA)
 static void stm32_dmacallback(DMA_HANDLE handle, uint8_t status, void *arg)
 {
   struct stm32_dev_s *priv = (struct stm32_dev_s *)arg;
@@ -1035,6 +1114,117 @@ static void stm32_dmacallback(DMA_HANDLE handle, uint8_t status, void *arg)
 }
 #endif
 
+/****************************************************************************
+ * Name: stm32_idmasetup
+ *
+ * Description:
+ *   Program the SDMMC internal DMA for the next data transfer.  Transfers
+ *   that fit in CONFIG_STM32L4_SDMMC_IDMA_BUFSIZE (or all transfers if that
+ *   is zero) use single buffer mode.  Longer transfers use double-buffer
+ *   mode with IDMABASE0 and IDMABASE1 walking through the buffer; the idle
+ *   base is re-armed by stm32_idmareload() from the buffer transfer
+ *   complete interrupt.
+ *
+ * Input Parameters:
+ *   priv   - Instance of the SDMMC private state structure.
+ *   buffer - The memory to DMA to or from
+ *   buflen - The size of the DMA transfer in bytes
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_SDMMC_IDMA
+static void stm32_idmasetup(struct stm32_dev_s *priv, uint32_t buffer,
+                            size_t buflen)
+{
+  DEBUGASSERT((buffer & 3) == 0);
+
+#if CONFIG_STM32L4_SDMMC_IDMA_BUFSIZE > 0
+  if (buflen > CONFIG_STM32L4_SDMMC_IDMA_BUFSIZE)
+    {
+      /* Double-buffer mode: arm both halves, then keep the remainder to be
+       * handed out one buffer at a time.
+       */
+
+      sdmmc_putreg32(priv, CONFIG_STM32L4_SDMMC_IDMA_BUFSIZE,
+                     STM32_SDMMC_IDMABSIZE_OFFSET);
+      sdmmc_putreg32(priv, buffer, STM32_SDMMC_IDMABASE0_OFFSET);
+      sdmmc_putreg32(priv, buffer + CONFIG_STM32L4_SDMMC_IDMA_BUFSIZE,
+                     STM32_SDMMC_IDMABASE1_OFFSET);
+
+      priv->idmanext = buffer + 2 * CONFIG_STM32L4_SDMMC_IDMA_BUFSIZE;
+      priv->idmaleft = buflen > 2 * CONFIG_STM32L4_SDMMC_IDMA_BUFSIZE ?
+                       buflen - 2 * CONFIG_STM32L4_SDMMC_IDMA_BUFSIZE : 0;
+
+      sdmmc_putreg32(priv, STM32_SDMMC_IDMACTRL_IDMAEN |
+                     STM32_SDMMC_IDMACTRL_IDMABMODE,
+                     STM32_SDMMC_IDMACTRL_OFFSET);
+      return;
+    }
+#endif
+
+  /* Single buffer mode: the IDMA follows DLEN through the whole buffer */
+
+  priv->idmanext = 0;
+  priv->idmaleft = 0;
+
+  sdmmc_putreg32(priv, buffer, STM32_SDMMC_IDMABASE0_OFFSET);
+  sdmmc_putreg32(priv, STM32_SDMMC_IDMACTRL_IDMAEN,
+                 STM32_SDMMC_IDMACTRL_OFFSET);
+}
+#endif
+
+/****************************************************************************
+ * Name: stm32_idmareload
+ *
+ * Description:
+ *   Called from the interrupt handler on IDMA buffer transfer complete in
+ *   double-buffer mode.  The IDMA has just switched to the other buffer,
+ *   so the one that completed is idle and can be pointed at the next part
+ *   of the caller's buffer.
+ *
+ * Input Parameters:
+ *   priv  - Instance of the SDMMC private state structure.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_SDMMC_IDMA
+static void stm32_idmareload(struct stm32_dev_s *priv)
+{
+#if CONFIG_STM32L4_SDMMC_IDMA_BUFSIZE > 0
+  uint32_t idmactrl;
+
+  sdmmc_putreg32(priv, STM32_SDMMC_ICR_IDMABTCC, STM32_SDMMC_ICR_OFFSET);
+
+  if (priv->idmaleft == 0)
+    {
+      return;
+    }
+
+  /* IDMABACT tells which buffer is now being used; the other one is free */
+
+  idmactrl = sdmmc_getreg32(priv, STM32_SDMMC_IDMACTRL_OFFSET);
+  if ((idmactrl & STM32_SDMMC_IDMACTRL_IDMABACT) != 0)
+    {
+      sdmmc_putreg32(priv, priv->idmanext, STM32_SDMMC_IDMABASE0_OFFSET);
+    }
+  else
+    {
+      sdmmc_putreg32(priv, priv->idmanext, STM32_SDMMC_IDMABASE1_OFFSET);
+    }
+
+  priv->idmanext += CONFIG_STM32L4_SDMMC_IDMA_BUFSIZE;
+  priv->idmaleft  = priv->idmaleft > CONFIG_STM32L4_SDMMC_IDMA_BUFSIZE ?
+                    priv->idmaleft - CONFIG_STM32L4_SDMMC_IDMA_BUFSIZE : 0;
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: stm32_log2
  *
@@ -1124,6 +1314,12 @@ static void stm32_datadisable(struct stm32_dev_s *priv)
               STM32_SDMMC_DCTRL_DTMODE | STM32_SDMMC_DCTRL_DMAEN |
               STM32_SDMMC_DCTRL_DBLOCKSIZE_MASK);
   sdmmc_putreg32(priv, regval, STM32_SDMMC_DCTRL_OFFSET);
+
+#ifdef CONFIG_STM32L4_SDMMC_IDMA
+  /* Disable the IDMA */
+
+  sdmmc_putreg32(priv, 0, STM32_SDMMC_IDMACTRL_OFFSET);
+#endif
 }
 
 /****************************************************************************
@@ -1365,7 +1561,11 @@ static void stm32_endtransfer(struct stm32_dev_s *priv,
        * terminates on an error condition).
        */
 
+#ifdef CONFIG_STM32L4_SDMMC_IDMA
+      sdmmc_putreg32(priv, 0, STM32_SDMMC_IDMACTRL_OFFSET);
+#else
       stm32l4_dmastop(priv->dma);
+#endif
     }
 #endif
 
@@ -1398,7 +1598,7 @@ static void stm32_endtransfer(struct stm32_dev_s *priv,
  *
  ****************************************************************************/
 
-#ifdef CONFIG_MMCSD_SDIOWAIT_WRCOMPLETE
+#ifdef HAVE_SDMMC_D0EXTI
 static int stm32_sdmmc_rdyinterrupt(int irq, void *context, void *arg)
 {
   struct stm32_dev_s *priv = (struct stm32_dev_s *)arg;
@@ -1472,6 +1672,14 @@ static int stm32_sdmmc_interrupt(int irq, void *context, void *arg)
                   stm32_sendfifo(priv);
                 }
             }
+#ifdef CONFIG_STM32L4_SDMMC_IDMA
+          else if ((pending & STM32_SDMMC_STA_IDMABTC) != 0)
+            {
+              /* One IDMA buffer is complete, re-arm it */
+
+              stm32_idmareload(priv);
+            }
+#endif
 
           /* Handle data end events */
 
@@ -1488,9 +1696,23 @@ static int stm32_sdmmc_interrupt(int irq, void *context, void *arg)
               if (priv->dmamode)
                 {
                   /* Yes.. Terminate the transfers only if the DMA has also
-                   * finished.
+                   * finished.  The IDMA has always drained the FIFO by the
+                   * time DATAEND is set, so there is no separate DMA event.
                    */
 
+#ifdef CONFIG_STM32L4_SDMMC_IDMA
+                  if ((sdmmc_getreg32(priv, STM32_SDMMC_STA_OFFSET) &
+                       STM32_SDMMC_STA_IDMATE) != 0)
+                    {
+                      mcerr("ERROR: IDMA transfer error, remaining: %d\n",
+                            priv->remaining);
+                      stm32_endtransfer(priv, SDIOWAIT_TRANSFERDONE |
+                                              SDIOWAIT_ERROR);
+                      continue;
+                    }
+
+                  priv->xfrflags |= SDMMC_DMADONE_FLAG;
+#endif
                   priv->xfrflags |= SDMMC_XFRDONE_FLAG;
                   if (priv->xfrflags == SDMMC_ALLDONE)
                     {
@@ -1605,6 +1827,25 @@ static int stm32_sdmmc_interrupt(int irq, void *context, void *arg)
                   stm32_endwait(priv, SDIOWAIT_CMDDONE);
                 }
             }
+
+#ifdef HAVE_SDMMC_BUSYD0END
+          /* Is this the end of the busy after a write? */
+
+          if ((pending & STM32_SDMMC_STA_BUSYD0END) != 0)
+            {
+              sdmmc_putreg32(priv, STM32_SDMMC_ICR_BUSYD0ENDC,
+                             STM32_SDMMC_ICR_OFFSET);
+
+              /* Is there a thread waiting for write complete? */
+
+              if ((priv->waitevents & SDIOWAIT_WRCOMPLETE) != 0)
+                {
+                  /* Yes.. wake the thread up */
+
+                  stm32_endwait(priv, SDIOWAIT_WRCOMPLETE);
+                }
+            }
+#endif
         }
     }
 
@@ -1730,6 +1971,12 @@ static sdio_capset_t stm32_capabilities(struct sdio_dev_s *dev)
     {
       caps |= SDIO_CAPS_1BIT_ONLY;
     }
+#ifdef STM32_SDMMC_HSXFR_CLKDIV
+  else
+    {
+      caps |= SDIO_CAPS_HSMODE;
+    }
+#endif
 
 #ifdef CONFIG_STM32L4_SDMMC_DMA
   caps |= SDIO_CAPS_DMASUPPORTED;
@@ -1822,6 +2069,17 @@ static void stm32_clock(struct sdio_dev_s *dev, enum sdio_clock_e rate)
         clckr = (STM32_SDMMC_CLKCR_MMCXFR | STM32_SDMMC_CLKCR_CLKEN);
         break;
 
+#ifdef STM32_SDMMC_HSXFR_CLKDIV
+      /* SD high speed clocking (wide 4-bit mode) */
+
+      case CLOCK_SD_TRANSFER_HS:
+        if (!priv->onebit)
+          {
+            clckr = (STM32_SDMMC_CLCKR_SDHSXFR | STM32_SDMMC_CLKCR_CLKEN);
+            break;
+          }
+#endif
+
       /* SD normal operation clocking (wide 4-bit mode) */
 
       case CLOCK_SD_TRANSFER_4BIT:
@@ -2118,7 +2376,11 @@ static int stm32_cancel(struct sdio_dev_s *dev)
        * terminates on an error condition.
        */
 
+#ifdef CONFIG_STM32L4_SDMMC_IDMA
+      sdmmc_putreg32(priv, 0, STM32_SDMMC_IDMACTRL_OFFSET);
+#else
       stm32l4_dmastop(priv->dma);
+#endif
     }
 #endif
 
@@ -2469,6 +2731,16 @@ static void stm32_waitenable(struct sdio_dev_s *dev,
   if ((eventset & SDIOWAIT_WRCOMPLETE) != 0)
     {
       waitmask = SDIOWAIT_WRCOMPLETE;
+
+#ifdef HAVE_SDMMC_BUSYD0END
+      /* Forget the end of busy of any earlier R1b command.  If the busy of
+       * this write already ended, stm32_eventwait() will find SDMMC_D0
+       * idle.
+       */
+
+      sdmmc_putreg32(priv, STM32_SDMMC_ICR_BUSYD0ENDC,
+                     STM32_SDMMC_ICR_OFFSET);
+#endif
     }
   else
 #endif
@@ -2578,12 +2850,20 @@ static sdio_eventset_t stm32_eventwait(struct sdio_dev_s *dev)
 #if defined(CONFIG_MMCSD_SDIOWAIT_WRCOMPLETE)
   if ((priv->waitevents & SDIOWAIT_WRCOMPLETE) != 0)
     {
+      bool ready;
+
       /* Atomically read pin to see if ready (true) and determine if ISR
        * fired.  If Pin is ready and if ISR did NOT fire end the wait here
        */
 
-      if (stm32_gpioread(priv->d0_gpio) &&
-         (priv->wkupevent & SDIOWAIT_WRCOMPLETE) == 0)
+#ifdef HAVE_SDMMC_BUSYD0END
+      ready = (sdmmc_getreg32(priv, STM32_SDMMC_STA_OFFSET) &
+               STM32_SDMMC_STA_BUSYD0) == 0;
+#else
+      ready = stm32_gpioread(priv->d0_gpio);
+#endif
+
+      if (ready && (priv->wkupevent & SDIOWAIT_WRCOMPLETE) == 0)
         {
           stm32_endwait(priv, SDIOWAIT_WRCOMPLETE);
         }
@@ -2739,6 +3019,15 @@ static int stm32_dmapreflight(struct sdio_dev_s *dev,
 
   DEBUGASSERT(priv != NULL && buffer != NULL && buflen > 0);
 
+#ifdef CONFIG_STM32L4_SDMMC_IDMA
+  /* IDMA access must be 32 bit aligned */
+
+  UNUSED(priv);
+  if (((uintptr_t)buffer & 3) != 0)
+    {
+      return -EFAULT;
+    }
+#else
   /* DMA must be possible to the buffer */
 
   if (!stm32l4_dmacapable((uintptr_t)buffer, (buflen + 3) >> 2,
@@ -2746,6 +3035,7 @@ static int stm32_dmapreflight(struct sdio_dev_s *dev,
     {
       return -EFAULT;
     }
+#endif
 
   return 0;
 }
@@ -2802,6 +3092,17 @@ static int stm32_dmarecvsetup(struct sdio_dev_s *dev,
   stm32_dataconfig(priv, SDMMC_DTIMER_DATATIMEOUT, buflen, dblocksize |
                    STM32_SDMMC_DCTRL_DTDIR);
 
+#ifdef CONFIG_STM32L4_SDMMC_IDMA
+  /* Configure the RX IDMA.  No system DMA channel is involved: the IDMA
+   * drains the FIFO and DATAEND signals completion of the whole transfer.
+   */
+
+  stm32_idmasetup(priv, (uint32_t)buffer, buflen);
+  stm32_sample(priv, SAMPLENDX_BEFORE_ENABLE);
+  stm32_configxfrints(priv, STM32_SDMMC_DMARECV_MASK |
+                      (priv->idmanext != 0 ? STM32_SDMMC_IDMADBL_MASK : 0));
+  stm32_sample(priv, SAMPLENDX_AFTER_SETUP);
+#else
   /* Configure the RX DMA */
 
   stm32_configxfrints(priv, STM32_SDMMC_DMARECV_MASK);
@@ -2817,6 +3118,7 @@ static int stm32_dmarecvsetup(struct sdio_dev_s *dev,
   stm32_sample(priv, SAMPLENDX_BEFORE_ENABLE);
   stm32l4_dmastart(priv->dma, stm32_dmacallback, priv, false);
   stm32_sample(priv, SAMPLENDX_AFTER_SETUP);
+#endif
 
   return OK;
 }
@@ -2871,6 +3173,18 @@ static int stm32_dmasendsetup(struct sdio_dev_s *dev,
   dblocksize = stm32_log2(buflen) << STM32_SDMMC_DCTRL_DBLOCKSIZE_SHIFT;
   stm32_dataconfig(priv, SDMMC_DTIMER_DATATIMEOUT, buflen, dblocksize);
 
+#ifdef CONFIG_STM32L4_SDMMC_IDMA
+  /* Configure the TX IDMA */
+
+  stm32_idmasetup(priv, (uint32_t)buffer, buflen);
+  stm32_sample(priv, SAMPLENDX_BEFORE_ENABLE);
+  stm32_sample(priv, SAMPLENDX_AFTER_SETUP);
+
+  /* Enable TX interrupts */
+
+  stm32_configxfrints(priv, STM32_SDMMC_DMASEND_MASK |
+                      (priv->idmanext != 0 ? STM32_SDMMC_IDMADBL_MASK : 0));
+#else
   /* Configure the TX DMA */
 
   stm32l4_dmasetup(priv->dma, priv->base + STM32_SDMMC_FIFO_OFFSET,
@@ -2889,6 +3203,7 @@ static int stm32_dmasendsetup(struct sdio_dev_s *dev,
   /* Enable TX interrupts */
 
   stm32_configxfrints(priv, STM32_SDMMC_DMASEND_MASK);
+#endif
 
   return OK;
 }
@@ -3018,7 +3333,7 @@ static void stm32_default(struct stm32_dev_s *priv)
 struct sdio_dev_s *sdio_initialize(int slotno)
 {
   struct stm32_dev_s *priv = NULL;
-#ifdef CONFIG_STM32L4_SDMMC_DMA
+#if defined(CONFIG_STM32L4_SDMMC_DMA) && !defined(CONFIG_STM32L4_SDMMC_IDMA)
   unsigned int dmachan;
 #endif
 
@@ -3029,7 +3344,7 @@ struct sdio_dev_s *sdio_initialize(int slotno)
 
       priv = &g_sdmmcdev1;
 
-#ifdef CONFIG_STM32L4_SDMMC_DMA
+#if defined(CONFIG_STM32L4_SDMMC_DMA) && !defined(CONFIG_STM32L4_SDMMC_IDMA)
       dmachan = SDMMC1_DMACHAN;
 #endif
 
@@ -3065,7 +3380,7 @@ struct sdio_dev_s *sdio_initialize(int slotno)
 
       priv = &g_sdmmcdev2;
 
-#ifdef CONFIG_STM32L4_SDMMC_DMA
+#if defined(CONFIG_STM32L4_SDMMC_DMA) && !defined(CONFIG_STM32L4_SDMMC_IDMA)
       dmachan = SDMMC2_DMACHAN;
 #endif
 
@@ -3100,7 +3415,7 @@ struct sdio_dev_s *sdio_initialize(int slotno)
       return NULL;
     }
 
-#ifdef CONFIG_STM32L4_SDMMC_DMA
+#if defined(CONFIG_STM32L4_SDMMC_DMA) && !defined(CONFIG_STM32L4_SDMMC_IDMA)
   /* Allocate a DMA channel */
 
   priv->dma = stm32l4_dmachannel(dmachan);
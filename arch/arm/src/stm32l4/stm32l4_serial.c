@@ -50,7 +50,9 @@
 #include "stm32l4_uart.h"
 #include "stm32l4_dma.h"
 #include "stm32l4_rcc.h"
+#include "stm32l4_dvfs.h"
 #include "arm_internal.h"
+#include "stm32l4.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -87,16 +89,23 @@
 #    endif
 #  endif
 
-/* Currently RS-485 support cannot be enabled when RXDMA is in use due to
- * lack of testing - RS-485 support was developed on STM32F1x
+/* RS-485 direction control through a GPIO depends on the TC interrupt of
+ * the character based path.  RXDMA needs the hardware driver enable.
  */
 
-#  if (defined(CONFIG_USART1_RXDMA) && defined(CONFIG_USART1_RS485)) || \
-      (defined(CONFIG_USART2_RXDMA) && defined(CONFIG_USART2_RS485)) || \
-      (defined(CONFIG_USART3_RXDMA) && defined(CONFIG_USART3_RS485)) || \
-      (defined(CONFIG_UART4_RXDMA) && defined(CONFIG_UART4_RS485))   || \
-      (defined(CONFIG_UART5_RXDMA) && defined(CONFIG_UART5_RS485))
-#    error "RXDMA and RS-485 cannot be enabled at the same time for the same U[S]ART"
+#  if (defined(CONFIG_LPUART1_RXDMA) && defined(CONFIG_LPUART1_RS485) && \
+       !defined(CONFIG_LPUART1_RS485_HWDE)) || \
+      (defined(CONFIG_USART1_RXDMA) && defined(CONFIG_USART1_RS485) && \
+       !defined(CONFIG_USART1_RS485_HWDE)) || \
+      (defined(CONFIG_USART2_RXDMA) && defined(CONFIG_USART2_RS485) && \
+       !defined(CONFIG_USART2_RS485_HWDE)) || \
+      (defined(CONFIG_USART3_RXDMA) && defined(CONFIG_USART3_RS485) && \
+       !defined(CONFIG_USART3_RS485_HWDE)) || \
+      (defined(CONFIG_UART4_RXDMA) && defined(CONFIG_UART4_RS485) && \
+       !defined(CONFIG_UART4_RS485_HWDE)) || \
+      (defined(CONFIG_UART5_RXDMA) && defined(CONFIG_UART5_RS485) && \
+       !defined(CONFIG_UART5_RS485_HWDE))
+#    error "RXDMA with RS-485 requires CONFIG_<port>_RS485_HWDE"
 #  endif
 
 /* For the L4, there are alternate DMA channels for USART1.
@@ -177,12 +186,136 @@
 
 #endif
 
+#ifdef SERIAL_HAVE_TXDMA
+
+/* Verify that DMA has been enabled and the DMA channel has been defined.
+ */
+
+#  if defined(CONFIG_USART2_TXDMA) || defined(CONFIG_USART3_TXDMA)
+#    if !defined(CONFIG_STM32L4_DMA1) && !defined(CONFIG_STM32L4_DMAMUX)
+#      error STM32L4 USART2/3 transmit DMA requires CONFIG_STM32L4_DMA1
+#    endif
+#  endif
+
+#  if defined(CONFIG_UART4_TXDMA) || defined(CONFIG_UART5_TXDMA)
+#    if !defined(CONFIG_STM32L4_DMA2) && !defined(CONFIG_STM32L4_DMAMUX)
+#      error STM32L4 UART4/5 transmit DMA requires CONFIG_STM32L4_DMA2
+#    endif
+#  endif
+
+/* RS-485 direction control through a GPIO relies on the TC interrupt of
+ * the character based transmit path.  TXDMA needs the hardware driver
+ * enable.
+ */
+
+#  if (defined(CONFIG_LPUART1_TXDMA) && defined(CONFIG_LPUART1_RS485) && \
+       !defined(CONFIG_LPUART1_RS485_HWDE)) || \
+      (defined(CONFIG_USART1_TXDMA) && defined(CONFIG_USART1_RS485) && \
+       !defined(CONFIG_USART1_RS485_HWDE)) || \
+      (defined(CONFIG_USART2_TXDMA) && defined(CONFIG_USART2_RS485) && \
+       !defined(CONFIG_USART2_RS485_HWDE)) || \
+      (defined(CONFIG_USART3_TXDMA) && defined(CONFIG_USART3_RS485) && \
+       !defined(CONFIG_USART3_RS485_HWDE)) || \
+      (defined(CONFIG_UART4_TXDMA) && defined(CONFIG_UART4_RS485) && \
+       !defined(CONFIG_UART4_RS485_HWDE)) || \
+      (defined(CONFIG_UART5_TXDMA) && defined(CONFIG_UART5_RS485) && \
+       !defined(CONFIG_UART5_RS485_HWDE))
+#    error "TXDMA with RS-485 requires CONFIG_<port>_RS485_HWDE"
+#  endif
+
+/* LPUART1 and USART1 have alternate DMA channels; the board.h file selects
+ * one.  With a DMAMUX every channel must be selected by board.h.
+ */
+
+#  if defined(CONFIG_LPUART1_TXDMA) && !defined(DMAMAP_LPUART1_TX)
+#    error "LPUART1 DMA channel not defined (DMAMAP_LPUART1_TX)"
+#  endif
+
+#  if defined(CONFIG_USART1_TXDMA) && !defined(DMAMAP_USART1_TX)
+#    error "USART1 DMA channel not defined (DMAMAP_USART1_TX)"
+#  endif
+
+#  ifndef CONFIG_STM32L4_HAVE_DMAMUX
+#    define DMAMAP_USART2_TX  DMACHAN_USART2_TX
+#    define DMAMAP_USART3_TX  DMACHAN_USART3_TX
+#    define DMAMAP_UART4_TX   DMACHAN_UART4_TX
+#    define DMAMAP_UART5_TX   DMACHAN_UART5_TX
+#  endif
+
+#  if defined(CONFIG_USART2_TXDMA) && !defined(DMAMAP_USART2_TX)
+#    error "USART2 DMA channel not defined (DMAMAP_USART2_TX)"
+#  endif
+
+#  if defined(CONFIG_USART3_TXDMA) && !defined(DMAMAP_USART3_TX)
+#    error "USART3 DMA channel not defined (DMAMAP_USART3_TX)"
+#  endif
+
+#  if defined(CONFIG_UART4_TXDMA) && !defined(DMAMAP_UART4_TX)
+#    error "UART4 DMA channel not defined (DMAMAP_UART4_TX)"
+#  endif
+
+#  if defined(CONFIG_UART5_TXDMA) && !defined(DMAMAP_UART5_TX)
+#    error "UART5 DMA channel not defined (DMAMAP_UART5_TX)"
+#  endif
+
+/* DMA priority */
+
+#  ifndef CONFIG_USART_TXDMAPRIO
+#    define CONFIG_USART_TXDMAPRIO  DMA_CCR_PRIMED
+#  endif
+#  if (CONFIG_USART_TXDMAPRIO & ~DMA_CCR_PL_MASK) != 0
+#    error "Illegal value for CONFIG_USART_TXDMAPRIO"
+#  endif
+
+/* DMA control word */
+
+#  define SERIAL_TXDMA_CONTROL_WORD    \
+              (DMA_CCR_DIR           | \
+               DMA_CCR_MINC          | \
+               DMA_CCR_PSIZE_8BITS   | \
+               DMA_CCR_MSIZE_8BITS   | \
+               CONFIG_USART_TXDMAPRIO)
+
+#endif
+
+/* Ports without Rx or Tx DMA leave the corresponding channel setting at
+ * zero.  No U[S]ART DMA request maps to zero.
+ */
+
+#define INVALID_SERIAL_DMA_CHANNEL 0
+
+/* RS-485 DE timing, in sample time units */
+
+#ifdef HAVE_RS485_HWDE
+#  ifndef CONFIG_STM32L4_SERIAL_RS485_DEAT
+#    define CONFIG_STM32L4_SERIAL_RS485_DEAT 0
+#  endif
+#  ifndef CONFIG_STM32L4_SERIAL_RS485_DEDT
+#    define CONFIG_STM32L4_SERIAL_RS485_DEDT 0
+#  endif
+#endif
+
+/* True if the RS-485 direction pin is a GPIO switched by software */
+
+#ifdef HAVE_RS485_HWDE
+#  define RS485_SWDIR(priv) \
+     ((priv)->rs485_dir_gpio != 0 && !(priv)->rs485_hwde)
+#elif defined(HAVE_RS485)
+#  define RS485_SWDIR(priv) ((priv)->rs485_dir_gpio != 0)
+#endif
+
 /* Power management definitions */
 
 #if defined(CONFIG_PM) && !defined(CONFIG_STM32L4_PM_SERIAL_ACTIVITY)
 #  define CONFIG_STM32L4_PM_SERIAL_ACTIVITY  10
 #endif
 
+/* DVFS support: the baud rate divider follows the APB clock */
+
+#if defined(CONFIG_STM32L4_DVFS) && !defined(CONFIG_SUPPRESS_UART_CONFIG)
+#  define SERIAL_HAVE_DVFS 1
+#endif
+
 /* Keep track if a Break was set
  *
  * Note:
@@ -253,6 +386,7 @@ struct stm32l4_serial_s
 #endif
 
   const uint8_t     irq;       /* IRQ associated with this USART */
+  const xcpt_t      isr;       /* Interrupt entry point of this USART */
   const uint32_t    apbclock;  /* PCLK 1 or 2 frequency */
   const uint32_t    usartbase; /* Base address of USART registers */
   const uint32_t    tx_gpio;   /* U[S]ART TX GPIO pin configuration */
@@ -280,10 +414,20 @@ struct stm32l4_serial_s
   char       *const rxfifo;    /* Receive DMA buffer */
 #endif
 
+  /* TX DMA state */
+
+#ifdef SERIAL_HAVE_TXDMA
+  const unsigned int txdma_channel; /* DMA channel assigned */
+  DMA_HANDLE        txdma;          /* currently-open transmit DMA stream */
+#endif
+
 #ifdef HAVE_RS485
   const uint32_t    rs485_dir_gpio;     /* U[S]ART RS-485 DIR GPIO pin configuration */
   const bool        rs485_dir_polarity; /* U[S]ART RS-485 DIR pin state for TX enabled */
 #endif
+#ifdef HAVE_RS485_HWDE
+  const bool        rs485_hwde;         /* DIR pin is the hardware DE output */
+#endif
 };
 
 /****************************************************************************
@@ -297,7 +441,24 @@ static int  stm32l4serial_setup(struct uart_dev_s *dev);
 static void stm32l4serial_shutdown(struct uart_dev_s *dev);
 static int  stm32l4serial_attach(struct uart_dev_s *dev);
 static void stm32l4serial_detach(struct uart_dev_s *dev);
-static int  up_interrupt(int irq, void *context, void *arg);
+#ifdef CONFIG_STM32L4_LPUART1_SERIALDRIVER
+static int  up_interrupt_lpuart1(int irq, void *context, void *arg);
+#endif
+#ifdef CONFIG_STM32L4_USART1_SERIALDRIVER
+static int  up_interrupt_usart1(int irq, void *context, void *arg);
+#endif
+#ifdef CONFIG_STM32L4_USART2_SERIALDRIVER
+static int  up_interrupt_usart2(int irq, void *context, void *arg);
+#endif
+#ifdef CONFIG_STM32L4_USART3_SERIALDRIVER
+static int  up_interrupt_usart3(int irq, void *context, void *arg);
+#endif
+#ifdef CONFIG_STM32L4_UART4_SERIALDRIVER
+static int  up_interrupt_uart4(int irq, void *context, void *arg);
+#endif
+#ifdef CONFIG_STM32L4_UART5_SERIALDRIVER
+static int  up_interrupt_uart5(int irq, void *context, void *arg);
+#endif
 static int  stm32l4serial_ioctl(struct file *filep, int cmd,
                                 unsigned long arg);
 #ifndef SERIAL_HAVE_ONLY_DMA
@@ -311,12 +472,26 @@ static bool stm32l4serial_rxflowcontrol(struct uart_dev_s *dev,
                                         unsigned int nbuffered, bool upper);
 #endif
 static void stm32l4serial_send(struct uart_dev_s *dev, int ch);
+#if defined(SERIAL_HAVE_NODMA_OPS) || defined(SERIAL_HAVE_RXDMA_OPS) || \
+    defined(CONFIG_STM32L4_SERIALBRK_BSDCOMPAT)
 static void stm32l4serial_txint(struct uart_dev_s *dev, bool enable);
+#endif
 static bool stm32l4serial_txready(struct uart_dev_s *dev);
 
-#ifdef SERIAL_HAVE_RXDMA
+#if defined(SERIAL_HAVE_RXDMA) || defined(SERIAL_HAVE_TXDMA)
 static int  stm32l4serial_dmasetup(struct uart_dev_s *dev);
 static void stm32l4serial_dmashutdown(struct uart_dev_s *dev);
+#endif
+
+#ifdef SERIAL_HAVE_TXDMA
+static void stm32l4serial_dmasend(struct uart_dev_s *dev);
+static void stm32l4serial_dmatxint(struct uart_dev_s *dev, bool enable);
+static void stm32l4serial_dmatxavail(struct uart_dev_s *dev);
+static void stm32l4serial_dmatxcallback(DMA_HANDLE handle, uint8_t status,
+                                        void *arg);
+#endif
+
+#ifdef SERIAL_HAVE_RXDMA
 static int  stm32l4serial_dmareceive(struct uart_dev_s *dev,
                                      unsigned int *status);
 static void stm32l4serial_dmareenable(struct stm32l4_serial_s *priv);
@@ -330,6 +505,11 @@ static void stm32l4serial_dmarxcallback(DMA_HANDLE handle, uint8_t status,
                                         void *arg);
 #endif
 
+#ifdef SERIAL_HAVE_RXDMA_IDLE
+static void stm32l4serial_dmarxblock(struct uart_dev_s *dev);
+static void stm32l4serial_dmarxfree(struct uart_dev_s *dev);
+#endif
+
 #ifdef CONFIG_PM
 static void stm32l4serial_setsuspend(struct uart_dev_s *dev, bool suspend);
 static void stm32l4serial_pm_setsuspend(bool suspend);
@@ -339,11 +519,18 @@ static int  stm32l4serial_pmprepare(struct pm_callback_s *cb, int domain,
                                     enum pm_state_e pmstate);
 #endif
 
+#ifdef SERIAL_HAVE_DVFS
+static int  stm32l4serial_dvfsprepare(struct stm32l4_dvfs_callback_s *cb,
+                                      uint32_t sysclk);
+static void stm32l4serial_dvfsnotify(struct stm32l4_dvfs_callback_s *cb,
+                                     uint32_t sysclk);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-#ifndef SERIAL_HAVE_ONLY_DMA
+#ifdef SERIAL_HAVE_NODMA_OPS
 static const struct uart_ops_s g_uart_ops =
 {
   .setup          = stm32l4serial_setup,
@@ -364,8 +551,8 @@ static const struct uart_ops_s g_uart_ops =
 };
 #endif
 
-#ifdef SERIAL_HAVE_RXDMA
-static const struct uart_ops_s g_uart_dma_ops =
+#ifdef SERIAL_HAVE_RXDMA_OPS
+static const struct uart_ops_s g_uart_rxdma_ops =
 {
   .setup          = stm32l4serial_dmasetup,
   .shutdown       = stm32l4serial_dmashutdown,
@@ -377,6 +564,10 @@ static const struct uart_ops_s g_uart_dma_ops =
   .rxavailable    = stm32l4serial_dmarxavailable,
 #ifdef CONFIG_SERIAL_IFLOWCONTROL
   .rxflowcontrol  = stm32l4serial_rxflowcontrol,
+#endif
+#ifdef SERIAL_HAVE_RXDMA_IDLE
+  .dmareceive     = stm32l4serial_dmarxblock,
+  .dmarxfree      = stm32l4serial_dmarxfree,
 #endif
   .send           = stm32l4serial_send,
   .txint          = stm32l4serial_txint,
@@ -385,6 +576,56 @@ static const struct uart_ops_s g_uart_dma_ops =
 };
 #endif
 
+#ifdef SERIAL_HAVE_TXDMA_OPS
+static const struct uart_ops_s g_uart_txdma_ops =
+{
+  .setup          = stm32l4serial_dmasetup,
+  .shutdown       = stm32l4serial_dmashutdown,
+  .attach         = stm32l4serial_attach,
+  .detach         = stm32l4serial_detach,
+  .ioctl          = stm32l4serial_ioctl,
+  .receive        = stm32l4serial_receive,
+  .rxint          = stm32l4serial_rxint,
+  .rxavailable    = stm32l4serial_rxavailable,
+#ifdef CONFIG_SERIAL_IFLOWCONTROL
+  .rxflowcontrol  = stm32l4serial_rxflowcontrol,
+#endif
+  .send           = stm32l4serial_send,
+  .txint          = stm32l4serial_dmatxint,
+  .txready        = stm32l4serial_txready,
+  .txempty        = stm32l4serial_txready,
+  .dmasend        = stm32l4serial_dmasend,
+  .dmatxavail     = stm32l4serial_dmatxavail,
+};
+#endif
+
+#ifdef SERIAL_HAVE_RXTXDMA_OPS
+static const struct uart_ops_s g_uart_rxtxdma_ops =
+{
+  .setup          = stm32l4serial_dmasetup,
+  .shutdown       = stm32l4serial_dmashutdown,
+  .attach         = stm32l4serial_attach,
+  .detach         = stm32l4serial_detach,
+  .ioctl          = stm32l4serial_ioctl,
+  .receive        = stm32l4serial_dmareceive,
+  .rxint          = stm32l4serial_dmarxint,
+  .rxavailable    = stm32l4serial_dmarxavailable,
+#ifdef CONFIG_SERIAL_IFLOWCONTROL
+  .rxflowcontrol  = stm32l4serial_rxflowcontrol,
+#endif
+#ifdef SERIAL_HAVE_RXDMA_IDLE
+  .dmareceive     = stm32l4serial_dmarxblock,
+  .dmarxfree      = stm32l4serial_dmarxfree,
+#endif
+  .send           = stm32l4serial_send,
+  .txint          = stm32l4serial_dmatxint,
+  .txready        = stm32l4serial_txready,
+  .txempty        = stm32l4serial_txready,
+  .dmasend        = stm32l4serial_dmasend,
+  .dmatxavail     = stm32l4serial_dmatxavail,
+};
+#endif
+
 /* I/O buffers */
 
 #ifdef CONFIG_STM32L4_LPUART1_SERIALDRIVER
@@ -455,8 +696,12 @@ static struct stm32l4_serial_s g_lpuart1priv =
         .size    = CONFIG_LPUART1_TXBUFSIZE,
         .buffer  = g_lpuart1txbuffer,
       },
-#  ifdef CONFIG_LPUART1_RXDMA
-      .ops       = &g_uart_dma_ops,
+#  if defined(CONFIG_LPUART1_RXDMA) && defined(CONFIG_LPUART1_TXDMA)
+      .ops       = &g_uart_rxtxdma_ops,
+#  elif defined(CONFIG_LPUART1_RXDMA)
+      .ops       = &g_uart_rxdma_ops,
+#  elif defined(CONFIG_LPUART1_TXDMA)
+      .ops       = &g_uart_txdma_ops,
 #  else
       .ops       = &g_uart_ops,
 #  endif
@@ -464,6 +709,7 @@ static struct stm32l4_serial_s g_lpuart1priv =
     },
 
   .irq           = STM32L4_IRQ_LPUART1,
+  .isr           = up_interrupt_lpuart1,
   .parity        = CONFIG_LPUART1_PARITY,
   .bits          = CONFIG_LPUART1_BITS,
   .stopbits2     = CONFIG_LPUART1_2STOP,
@@ -484,14 +730,20 @@ static struct stm32l4_serial_s g_lpuart1priv =
   .rxdma_channel = DMAMAP_LPUART1_RX,
   .rxfifo        = g_lpuart1rxfifo,
 #  endif
+#  ifdef CONFIG_LPUART1_TXDMA
+  .txdma_channel = DMAMAP_LPUART1_TX,
+#  endif
 
 #  ifdef CONFIG_LPUART1_RS485
   .rs485_dir_gpio = GPIO_LPUART1_RS485_DIR,
-#    if (CONFIG_USART1_RS485_DIR_POLARITY == 0)
+#    if (CONFIG_LPUART1_RS485_DIR_POLARITY == 0)
   .rs485_dir_polarity = false,
 #    else
   .rs485_dir_polarity = true,
 #    endif
+#    ifdef CONFIG_LPUART1_RS485_HWDE
+  .rs485_hwde = true,
+#    endif
 #  endif
 };
 #endif
@@ -516,8 +768,12 @@ static struct stm32l4_serial_s g_usart1priv =
         .size    = CONFIG_USART1_TXBUFSIZE,
         .buffer  = g_usart1txbuffer,
       },
-#  ifdef CONFIG_USART1_RXDMA
-      .ops       = &g_uart_dma_ops,
+#  if defined(CONFIG_USART1_RXDMA) && defined(CONFIG_USART1_TXDMA)
+      .ops       = &g_uart_rxtxdma_ops,
+#  elif defined(CONFIG_USART1_RXDMA)
+      .ops       = &g_uart_rxdma_ops,
+#  elif defined(CONFIG_USART1_TXDMA)
+      .ops       = &g_uart_txdma_ops,
 #  else
       .ops       = &g_uart_ops,
 #  endif
@@ -525,6 +781,7 @@ static struct stm32l4_serial_s g_usart1priv =
     },
 
   .irq           = STM32L4_IRQ_USART1,
+  .isr           = up_interrupt_usart1,
   .parity        = CONFIG_USART1_PARITY,
   .bits          = CONFIG_USART1_BITS,
   .stopbits2     = CONFIG_USART1_2STOP,
@@ -545,6 +802,9 @@ static struct stm32l4_serial_s g_usart1priv =
   .rxdma_channel = DMAMAP_USART1_RX,
   .rxfifo        = g_usart1rxfifo,
 #  endif
+#  ifdef CONFIG_USART1_TXDMA
+  .txdma_channel = DMAMAP_USART1_TX,
+#  endif
 
 #  ifdef CONFIG_USART1_RS485
   .rs485_dir_gpio = GPIO_USART1_RS485_DIR,
@@ -553,6 +813,9 @@ static struct stm32l4_serial_s g_usart1priv =
 #    else
   .rs485_dir_polarity = true,
 #    endif
+#    ifdef CONFIG_USART1_RS485_HWDE
+  .rs485_hwde = true,
+#    endif
 #  endif
 };
 #endif
@@ -577,8 +840,12 @@ static struct stm32l4_serial_s g_usart2priv =
         .size    = CONFIG_USART2_TXBUFSIZE,
         .buffer  = g_usart2txbuffer,
       },
-#  ifdef CONFIG_USART2_RXDMA
-      .ops       = &g_uart_dma_ops,
+#  if defined(CONFIG_USART2_RXDMA) && defined(CONFIG_USART2_TXDMA)
+      .ops       = &g_uart_rxtxdma_ops,
+#  elif defined(CONFIG_USART2_RXDMA)
+      .ops       = &g_uart_rxdma_ops,
+#  elif defined(CONFIG_USART2_TXDMA)
+      .ops       = &g_uart_txdma_ops,
 #  else
       .ops       = &g_uart_ops,
 #  endif
@@ -586,6 +853,7 @@ static struct stm32l4_serial_s g_usart2priv =
     },
 
   .irq           = STM32L4_IRQ_USART2,
+  .isr           = up_interrupt_usart2,
   .parity        = CONFIG_USART2_PARITY,
   .bits          = CONFIG_USART2_BITS,
   .stopbits2     = CONFIG_USART2_2STOP,
@@ -606,6 +874,9 @@ static struct stm32l4_serial_s g_usart2priv =
   .rxdma_channel = DMAMAP_USART2_RX,
   .rxfifo        = g_usart2rxfifo,
 #  endif
+#  ifdef CONFIG_USART2_TXDMA
+  .txdma_channel = DMAMAP_USART2_TX,
+#  endif
 
 #  ifdef CONFIG_USART2_RS485
   .rs485_dir_gpio = GPIO_USART2_RS485_DIR,
@@ -614,6 +885,9 @@ static struct stm32l4_serial_s g_usart2priv =
 #    else
   .rs485_dir_polarity = true,
 #    endif
+#    ifdef CONFIG_USART2_RS485_HWDE
+  .rs485_hwde = true,
+#    endif
 #  endif
 };
 #endif
@@ -638,8 +912,12 @@ static struct stm32l4_serial_s g_usart3priv =
         .size    = CONFIG_USART3_TXBUFSIZE,
         .buffer  = g_usart3txbuffer,
       },
-#  ifdef CONFIG_USART3_RXDMA
-      .ops       = &g_uart_dma_ops,
+#  if defined(CONFIG_USART3_RXDMA) && defined(CONFIG_USART3_TXDMA)
+      .ops       = &g_uart_rxtxdma_ops,
+#  elif defined(CONFIG_USART3_RXDMA)
+      .ops       = &g_uart_rxdma_ops,
+#  elif defined(CONFIG_USART3_TXDMA)
+      .ops       = &g_uart_txdma_ops,
 #  else
       .ops       = &g_uart_ops,
 #  endif
@@ -647,6 +925,7 @@ static struct stm32l4_serial_s g_usart3priv =
     },
 
   .irq           = STM32L4_IRQ_USART3,
+  .isr           = up_interrupt_usart3,
   .parity        = CONFIG_USART3_PARITY,
   .bits          = CONFIG_USART3_BITS,
   .stopbits2     = CONFIG_USART3_2STOP,
@@ -667,6 +946,9 @@ static struct stm32l4_serial_s g_usart3priv =
   .rxdma_channel = DMAMAP_USART3_RX,
   .rxfifo        = g_usart3rxfifo,
 #  endif
+#  ifdef CONFIG_USART3_TXDMA
+  .txdma_channel = DMAMAP_USART3_TX,
+#  endif
 
 #  ifdef CONFIG_USART3_RS485
   .rs485_dir_gpio = GPIO_USART3_RS485_DIR,
@@ -675,6 +957,9 @@ static struct stm32l4_serial_s g_usart3priv =
 #    else
   .rs485_dir_polarity = true,
 #    endif
+#    ifdef CONFIG_USART3_RS485_HWDE
+  .rs485_hwde = true,
+#    endif
 #  endif
 };
 #endif
@@ -699,8 +984,12 @@ static struct stm32l4_serial_s g_uart4priv =
         .size    = CONFIG_UART4_TXBUFSIZE,
         .buffer  = g_uart4txbuffer,
       },
-#  ifdef CONFIG_UART4_RXDMA
-      .ops       = &g_uart_dma_ops,
+#  if defined(CONFIG_UART4_RXDMA) && defined(CONFIG_UART4_TXDMA)
+      .ops       = &g_uart_rxtxdma_ops,
+#  elif defined(CONFIG_UART4_RXDMA)
+      .ops       = &g_uart_rxdma_ops,
+#  elif defined(CONFIG_UART4_TXDMA)
+      .ops       = &g_uart_txdma_ops,
 #  else
       .ops       = &g_uart_ops,
 #  endif
@@ -708,6 +997,7 @@ static struct stm32l4_serial_s g_uart4priv =
     },
 
   .irq           = STM32L4_IRQ_UART4,
+  .isr           = up_interrupt_uart4,
   .parity        = CONFIG_UART4_PARITY,
   .bits          = CONFIG_UART4_BITS,
   .stopbits2     = CONFIG_UART4_2STOP,
@@ -728,6 +1018,9 @@ static struct stm32l4_serial_s g_uart4priv =
   .rxdma_channel = DMAMAP_UART4_RX,
   .rxfifo        = g_uart4rxfifo,
 #  endif
+#  ifdef CONFIG_UART4_TXDMA
+  .txdma_channel = DMAMAP_UART4_TX,
+#  endif
 
 #  ifdef CONFIG_UART4_RS485
   .rs485_dir_gpio = GPIO_UART4_RS485_DIR,
@@ -736,6 +1029,9 @@ static struct stm32l4_serial_s g_uart4priv =
 #    else
   .rs485_dir_polarity = true,
 #    endif
+#    ifdef CONFIG_UART4_RS485_HWDE
+  .rs485_hwde = true,
+#    endif
 #  endif
 };
 #endif
@@ -760,8 +1056,12 @@ static struct stm32l4_serial_s g_uart5priv =
         .size   = CONFIG_UART5_TXBUFSIZE,
         .buffer = g_uart5txbuffer,
       },
-#  ifdef CONFIG_UART5_RXDMA
-      .ops      = &g_uart_dma_ops,
+#  if defined(CONFIG_UART5_RXDMA) && defined(CONFIG_UART5_TXDMA)
+      .ops      = &g_uart_rxtxdma_ops,
+#  elif defined(CONFIG_UART5_RXDMA)
+      .ops      = &g_uart_rxdma_ops,
+#  elif defined(CONFIG_UART5_TXDMA)
+      .ops      = &g_uart_txdma_ops,
 #  else
       .ops      = &g_uart_ops,
 #  endif
@@ -769,6 +1069,7 @@ static struct stm32l4_serial_s g_uart5priv =
     },
 
   .irq            = STM32L4_IRQ_UART5,
+  .isr            = up_interrupt_uart5,
   .parity         = CONFIG_UART5_PARITY,
   .bits           = CONFIG_UART5_BITS,
   .stopbits2      = CONFIG_UART5_2STOP,
@@ -789,6 +1090,9 @@ static struct stm32l4_serial_s g_uart5priv =
   .rxdma_channel = DMAMAP_UART5_RX,
   .rxfifo        = g_uart5rxfifo,
 #  endif
+#  ifdef CONFIG_UART5_TXDMA
+  .txdma_channel = DMAMAP_UART5_TX,
+#  endif
 
 #  ifdef CONFIG_UART5_RS485
   .rs485_dir_gpio = GPIO_UART5_RS485_DIR,
@@ -797,6 +1101,9 @@ static struct stm32l4_serial_s g_uart5priv =
 #    else
   .rs485_dir_polarity = true,
 #    endif
+#    ifdef CONFIG_UART5_RS485_HWDE
+  .rs485_hwde = true,
+#    endif
 #  endif
 };
 #endif
@@ -839,6 +1146,14 @@ static struct
   };
 #endif
 
+#ifdef SERIAL_HAVE_DVFS
+static struct stm32l4_dvfs_callback_s g_serialdvfs =
+{
+  .prepare = stm32l4serial_dvfsprepare,
+  .notify  = stm32l4serial_dvfsnotify,
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -1013,7 +1328,8 @@ static void stm32l4serial_setbaud_usart(struct stm32l4_serial_s *priv)
    *   usartdiv8 = 2 * fCK / baud
    */
 
-  usartdiv8 = ((priv->apbclock << 1) + (priv->baud >> 1)) / priv->baud;
+  usartdiv8 = ((stm32l4_dvfs_scale(priv->apbclock) << 1) +
+               (priv->baud >> 1)) / priv->baud;
 
   /* Baud rate for standard USART (SPI mode included):
    *
@@ -1081,7 +1397,8 @@ static void stm32l4serial_setbaud_lpuart(struct stm32l4_serial_s *priv)
    * 4096 x baud rate.
    */
 
-  brr = (((uint64_t)priv->apbclock << 8) + (priv->baud >> 1)) / priv->baud;
+  brr = (((uint64_t)stm32l4_dvfs_scale(priv->apbclock) << 8) +
+         (priv->baud >> 1)) / priv->baud;
   brr &= LPUART_BRR_MASK;
 
   if (brr < LPUART_BRR_MIN)
@@ -1244,7 +1561,7 @@ static void stm32l4serial_setsuspend(struct uart_dev_s *dev, bool suspend)
               USART_ISR_TC) == 0);
 
 #ifdef SERIAL_HAVE_RXDMA
-      if (priv->dev.ops == &g_uart_dma_ops && !priv->rxdmasusp)
+      if (priv->rxdma != NULL && !priv->rxdmasusp)
         {
 #ifdef CONFIG_SERIAL_IFLOWCONTROL
           if (priv->iflow && priv->rxdmanext == RXDMA_BUFFER_SIZE)
@@ -1267,7 +1584,7 @@ static void stm32l4serial_setsuspend(struct uart_dev_s *dev, bool suspend)
   else
     {
 #ifdef SERIAL_HAVE_RXDMA
-      if (priv->dev.ops == &g_uart_dma_ops && priv->rxdmasusp)
+      if (priv->rxdma != NULL && priv->rxdmasusp)
         {
 #ifdef CONFIG_SERIAL_IFLOWCONTROL
           if (priv->iflow)
@@ -1490,6 +1807,10 @@ static int stm32l4serial_setup(struct uart_dev_s *dev)
   if (priv->rs485_dir_gpio != 0)
     {
       stm32l4_configgpio(priv->rs485_dir_gpio);
+    }
+
+  if (RS485_SWDIR(priv))
+    {
       stm32l4_gpiowrite(priv->rs485_dir_gpio, !priv->rs485_dir_polarity);
     }
 #endif
@@ -1518,6 +1839,17 @@ static int stm32l4serial_setup(struct uart_dev_s *dev)
   regval  = stm32l4serial_getreg(priv, STM32L4_USART_CR1_OFFSET);
   regval &= ~(USART_CR1_TE | USART_CR1_RE | USART_CR1_ALLINTS);
 
+#ifdef HAVE_RS485_HWDE
+  /* Set the DE assertion and de-assertion times */
+
+  regval &= ~(USART_CR1_DEAT_MASK | USART_CR1_DEDT_MASK);
+  if (priv->rs485_hwde)
+    {
+      regval |= (CONFIG_STM32L4_SERIAL_RS485_DEAT << USART_CR1_DEAT_SHIFT) |
+                (CONFIG_STM32L4_SERIAL_RS485_DEDT << USART_CR1_DEDT_SHIFT);
+    }
+#endif
+
   stm32l4serial_putreg(priv, STM32L4_USART_CR1_OFFSET, regval);
 
   /* Configure CR3 */
@@ -1528,6 +1860,23 @@ static int stm32l4serial_setup(struct uart_dev_s *dev)
   regval &= ~(USART_CR3_CTSIE | USART_CR3_CTSE | USART_CR3_RTSE |
               USART_CR3_EIE);
 
+#ifdef HAVE_RS485_HWDE
+  /* Let the U[S]ART drive DE around every transmitted frame.  This works
+   * the same for interrupt and DMA driven transmission and needs no TC
+   * interrupt.
+   */
+
+  regval &= ~(USART_CR3_DEM | USART_CR3_DEP);
+  if (priv->rs485_hwde)
+    {
+      regval |= USART_CR3_DEM;
+      if (!priv->rs485_dir_polarity)
+        {
+          regval |= USART_CR3_DEP;
+        }
+    }
+#endif
+
   stm32l4serial_putreg(priv, STM32L4_USART_CR3_OFFSET, regval);
 
   /* Configure the USART line format and speed. */
@@ -1562,7 +1911,7 @@ static int stm32l4serial_setup(struct uart_dev_s *dev)
  *
  ****************************************************************************/
 
-#ifdef SERIAL_HAVE_RXDMA
+#if defined(SERIAL_HAVE_RXDMA) || defined(SERIAL_HAVE_TXDMA)
 static int stm32l4serial_dmasetup(struct uart_dev_s *dev)
 {
   struct stm32l4_serial_s *priv =
@@ -1581,67 +1930,42 @@ static int stm32l4serial_dmasetup(struct uart_dev_s *dev)
         }
     }
 
-  /* Acquire the DMA channel.  This should always succeed. */
+#ifdef SERIAL_HAVE_TXDMA
+  if (priv->txdma_channel != INVALID_SERIAL_DMA_CHANNEL)
+    {
+      /* Acquire the Tx DMA channel.  This should always succeed. */
 
-  priv->rxdma = stm32l4_dmachannel(priv->rxdma_channel);
+      priv->txdma = stm32l4_dmachannel(priv->txdma_channel);
 
-#ifdef CONFIG_SERIAL_IFLOWCONTROL
-  if (priv->iflow)
-    {
-      /* Configure for non-circular DMA reception into the RX FIFO */
+      /* Enable transmit DMA for the UART */
 
-      stm32l4_dmasetup(priv->rxdma,
-                     priv->usartbase + STM32L4_USART_RDR_OFFSET,
-                     (uint32_t)priv->rxfifo,
-                     RXDMA_BUFFER_SIZE,
-                     SERIAL_DMA_IFLOW_CONTROL_WORD);
+      regval  = stm32l4serial_getreg(priv, STM32L4_USART_CR3_OFFSET);
+      regval |= USART_CR3_DMAT;
+      stm32l4serial_putreg(priv, STM32L4_USART_CR3_OFFSET, regval);
     }
-  else
 #endif
-    {
-      /* Configure for circular DMA reception into the RX FIFO */
 
-      stm32l4_dmasetup(priv->rxdma,
-                     priv->usartbase + STM32L4_USART_RDR_OFFSET,
-                     (uint32_t)priv->rxfifo,
-                     RXDMA_BUFFER_SIZE,
-                     SERIAL_DMA_CONTROL_WORD);
-    }
-
-  /* Reset our DMA shadow pointer to match the address just
-   * programmed above.
-   */
+#ifdef SERIAL_HAVE_RXDMA
+  if (priv->rxdma_channel != INVALID_SERIAL_DMA_CHANNEL)
+    {
+      /* Acquire the Rx DMA channel.  This should always succeed. */
 
-  priv->rxdmanext = 0;
+      priv->rxdma = stm32l4_dmachannel(priv->rxdma_channel);
 
-  /* Enable receive DMA for the UART */
+      /* Enable receive DMA for the UART */
 
-  regval  = stm32l4serial_getreg(priv, STM32L4_USART_CR3_OFFSET);
-  regval |= USART_CR3_DMAR;
-  stm32l4serial_putreg(priv, STM32L4_USART_CR3_OFFSET, regval);
+      regval  = stm32l4serial_getreg(priv, STM32L4_USART_CR3_OFFSET);
+      regval |= USART_CR3_DMAR;
+      stm32l4serial_putreg(priv, STM32L4_USART_CR3_OFFSET, regval);
 
-#ifdef CONFIG_SERIAL_IFLOWCONTROL
-  if (priv->iflow)
-    {
-      /* Start the DMA channel, and arrange for callbacks at the full point
-       * in the FIFO. After buffer gets full, hardware flow-control kicks
-       * in and DMA transfer is stopped.
+      /* Configure and start reception into the RX FIFO: circular with
+       * callbacks at the half and full points, or, with input flow
+       * control, a single pass that stops when the FIFO is full.
        */
 
-      stm32l4_dmastart(priv->rxdma, stm32l4serial_dmarxcallback,
-                       (void *)priv, false);
+      stm32l4serial_dmareenable(priv);
     }
-  else
 #endif
-    {
-      /* Start the DMA channel, and arrange for callbacks at the half and
-       * full points in the FIFO.  This ensures that we have half a FIFO
-       * worth of time to claim bytes before they are overwritten.
-       */
-
-      stm32l4_dmastart(priv->rxdma, stm32l4serial_dmarxcallback,
-                       (void *)priv, true);
-    }
 
   return OK;
 }
@@ -1722,7 +2046,7 @@ static void stm32l4serial_shutdown(struct uart_dev_s *dev)
  *
  ****************************************************************************/
 
-#ifdef SERIAL_HAVE_RXDMA
+#if defined(SERIAL_HAVE_RXDMA) || defined(SERIAL_HAVE_TXDMA)
 static void stm32l4serial_dmashutdown(struct uart_dev_s *dev)
 {
   struct stm32l4_serial_s *priv =
@@ -1732,14 +2056,27 @@ static void stm32l4serial_dmashutdown(struct uart_dev_s *dev)
 
   stm32l4serial_shutdown(dev);
 
-  /* Stop the DMA channel */
+#ifdef SERIAL_HAVE_RXDMA
+  if (priv->rxdma != NULL)
+    {
+      /* Stop and release the Rx DMA channel */
 
-  stm32l4_dmastop(priv->rxdma);
+      stm32l4_dmastop(priv->rxdma);
+      stm32l4_dmafree(priv->rxdma);
+      priv->rxdma = NULL;
+    }
+#endif
 
-  /* Release the DMA channel */
+#ifdef SERIAL_HAVE_TXDMA
+  if (priv->txdma != NULL)
+    {
+      /* Stop and release the Tx DMA channel */
 
-  stm32l4_dmafree(priv->rxdma);
-  priv->rxdma = NULL;
+      stm32l4_dmastop(priv->txdma);
+      stm32l4_dmafree(priv->txdma);
+      priv->txdma = NULL;
+    }
+#endif
 }
 #endif
 
@@ -1767,7 +2104,7 @@ static int stm32l4serial_attach(struct uart_dev_s *dev)
 
   /* Attach and enable the IRQ */
 
-  ret = irq_attach(priv->irq, up_interrupt, priv);
+  ret = irq_attach(priv->irq, priv->isr, priv);
   if (ret == OK)
     {
       /* Enable the interrupt (RX and TX interrupts are still disabled
@@ -1808,16 +2145,19 @@ static void stm32l4serial_detach(struct uart_dev_s *dev)
  *   interrupt handling logic must be able to map the 'arg' to the
  *   appropriate uart_dev_s structure in order to call these functions.
  *
+ *   It is inlined into the interrupt entry point of each U(S)ART, which
+ *   passes its device and its register base as constants, so that the
+ *   status register is accessed from an immediate address instead of
+ *   through priv->usartbase.
+ *
  ****************************************************************************/
 
-static int up_interrupt(int irq, void *context, void *arg)
+static always_inline_function int up_interrupt(struct stm32l4_serial_s *priv,
+                                               uint32_t base)
 {
-  struct stm32l4_serial_s *priv = (struct stm32l4_serial_s *)arg;
   int  passes;
   bool handled;
 
-  DEBUGASSERT(priv != NULL);
-
   /* Report serial activity to the power management logic */
 
 #if defined(CONFIG_PM) && CONFIG_STM32L4_PM_SERIAL_ACTIVITY > 0
@@ -1835,14 +2175,15 @@ static int up_interrupt(int irq, void *context, void *arg)
 
       /* Get the masked USART status word. */
 
-      priv->sr = stm32l4serial_getreg(priv, STM32L4_USART_ISR_OFFSET);
+      priv->sr = getreg32(base + STM32L4_USART_ISR_OFFSET);
 
       /* USART interrupts:
        *
        * Enable             Status          Meaning             Usage
        * ------------------ --------------- ------------------- ----------
        * USART_CR1_IDLEIE   USART_ISR_IDLE   Idle Line
-       *                                     Detected           (not used)
+       *                                     Detected           (used only
+       *                                                         for Rx DMA)
        * USART_CR1_RXNEIE   USART_ISR_RXNE   Received Data
        *                                     Ready to be Read
        * "              "   USART_ISR_ORE    Overrun Error
@@ -1907,11 +2248,25 @@ static int up_interrupt(int irq, void *context, void *arg)
            * interrupt clear register (ICR).
            */
 
-          stm32l4serial_putreg(priv, STM32L4_USART_ICR_OFFSET,
-                               (USART_ICR_NCF | USART_ICR_ORECF |
-                                USART_ICR_FECF));
+          putreg32(USART_ICR_NCF | USART_ICR_ORECF | USART_ICR_FECF,
+                   base + STM32L4_USART_ICR_OFFSET);
         }
 
+#ifdef SERIAL_HAVE_RXDMA_IDLE
+      /* The line went idle after a frame.  Hand whatever the DMA has
+       * received so far to the upper half now instead of waiting for the
+       * next half or full point of the Rx DMA buffer.
+       */
+
+      if ((priv->sr & USART_ISR_IDLE) != 0 &&
+          (priv->ie & USART_CR1_IDLEIE) != 0)
+        {
+          putreg32(USART_ICR_IDLECF, base + STM32L4_USART_ICR_OFFSET);
+          stm32l4serial_dmarxcallback(priv->rxdma, 0, priv);
+          handled = true;
+        }
+#endif
+
       /* Handle outgoing, transmit bytes */
 
       if ((priv->sr & USART_ISR_TXE) != 0 &&
@@ -1927,6 +2282,62 @@ static int up_interrupt(int irq, void *context, void *arg)
   return OK;
 }
 
+/****************************************************************************
+ * Name: up_interrupt_<usart>
+ *
+ * Description:
+ *   The interrupt entry points of the U(S)ARTs.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_LPUART1_SERIALDRIVER
+isr_ramfunc static int up_interrupt_lpuart1(int irq, void *context,
+                                            void *arg)
+{
+  return up_interrupt(&g_lpuart1priv, STM32L4_LPUART1_BASE);
+}
+#endif
+
+#ifdef CONFIG_STM32L4_USART1_SERIALDRIVER
+isr_ramfunc static int up_interrupt_usart1(int irq, void *context,
+                                           void *arg)
+{
+  return up_interrupt(&g_usart1priv, STM32L4_USART1_BASE);
+}
+#endif
+
+#ifdef CONFIG_STM32L4_USART2_SERIALDRIVER
+isr_ramfunc static int up_interrupt_usart2(int irq, void *context,
+                                           void *arg)
+{
+  return up_interrupt(&g_usart2priv, STM32L4_USART2_BASE);
+}
+#endif
+
+#ifdef CONFIG_STM32L4_USART3_SERIALDRIVER
+isr_ramfunc static int up_interrupt_usart3(int irq, void *context,
+                                           void *arg)
+{
+  return up_interrupt(&g_usart3priv, STM32L4_USART3_BASE);
+}
+#endif
+
+#ifdef CONFIG_STM32L4_UART4_SERIALDRIVER
+isr_ramfunc static int up_interrupt_uart4(int irq, void *context,
+                                          void *arg)
+{
+  return up_interrupt(&g_uart4priv, STM32L4_UART4_BASE);
+}
+#endif
+
+#ifdef CONFIG_STM32L4_UART5_SERIALDRIVER
+isr_ramfunc static int up_interrupt_uart5(int irq, void *context,
+                                          void *arg)
+{
+  return up_interrupt(&g_uart5priv, STM32L4_UART5_BASE);
+}
+#endif
+
 /****************************************************************************
  * Name: stm32l4serial_ioctl
  *
@@ -2688,6 +3099,10 @@ static void stm32l4serial_dmarxint(struct uart_dev_s *dev, bool enable)
 {
   struct stm32l4_serial_s *priv =
       (struct stm32l4_serial_s *)dev->priv;
+#ifdef SERIAL_HAVE_RXDMA_IDLE
+  irqstate_t flags;
+  uint16_t ie;
+#endif
 
   /* En/disable DMA reception.
    *
@@ -2699,6 +3114,28 @@ static void stm32l4serial_dmarxint(struct uart_dev_s *dev, bool enable)
 
   priv->rxenable = enable;
 
+#ifdef SERIAL_HAVE_RXDMA_IDLE
+  /* Interrupt on idle line so that the tail of a frame is delivered
+   * without waiting for the next DMA event.
+   */
+
+  flags = enter_critical_section();
+  ie = priv->ie;
+  if (enable)
+    {
+      stm32l4serial_putreg(priv, STM32L4_USART_ICR_OFFSET,
+                           USART_ICR_IDLECF);
+      ie |= USART_CR1_IDLEIE;
+    }
+  else
+    {
+      ie &= ~USART_CR1_IDLEIE;
+    }
+
+  stm32l4serial_restoreusartint(priv, ie);
+  leave_critical_section(flags);
+#endif
+
 #ifdef CONFIG_SERIAL_IFLOWCONTROL
   if (priv->iflow)
     {
@@ -2732,6 +3169,119 @@ static bool stm32l4serial_dmarxavailable(struct uart_dev_s *dev)
 }
 #endif
 
+/****************************************************************************
+ * Name: stm32l4serial_dmacopy
+ *
+ * Description:
+ *   Move up to 'buflen' bytes received into the Rx DMA FIFO into 'buffer',
+ *   one contiguous run of the FIFO at a time.  Returns the number of bytes
+ *   moved.
+ *
+ ****************************************************************************/
+
+#ifdef SERIAL_HAVE_RXDMA_IDLE
+static size_t stm32l4serial_dmacopy(struct stm32l4_serial_s *priv,
+                                    char *buffer, size_t buflen)
+{
+  size_t nextrx = stm32l4serial_dmanextrx(priv);
+  size_t ncopied = 0;
+  size_t nrun;
+
+  if (nextrx == RXDMA_BUFFER_SIZE)
+    {
+      nextrx = 0;
+    }
+
+  while (ncopied < buflen && priv->rxdmanext != nextrx)
+    {
+      /* Copy up to the DMA write position, or to the end of the FIFO if
+       * the DMA has already wrapped.
+       */
+
+      if (nextrx > priv->rxdmanext)
+        {
+          nrun = nextrx - priv->rxdmanext;
+        }
+      else
+        {
+          nrun = RXDMA_BUFFER_SIZE - priv->rxdmanext;
+        }
+
+      if (nrun > buflen - ncopied)
+        {
+          nrun = buflen - ncopied;
+        }
+
+      memcpy(&buffer[ncopied], &priv->rxfifo[priv->rxdmanext], nrun);
+      ncopied         += nrun;
+      priv->rxdmanext += nrun;
+
+      if (priv->rxdmanext == RXDMA_BUFFER_SIZE)
+        {
+          priv->rxdmanext = 0;
+        }
+    }
+
+  return ncopied;
+}
+#endif
+
+/****************************************************************************
+ * Name: stm32l4serial_dmarxblock
+ *
+ * Description:
+ *   Called by uart_recvchars_dma() with up to two free regions of the
+ *   serial receive buffer.  Fill them from the Rx DMA FIFO and report the
+ *   result back to the upper half.
+ *
+ ****************************************************************************/
+
+#ifdef SERIAL_HAVE_RXDMA_IDLE
+static void stm32l4serial_dmarxblock(struct uart_dev_s *dev)
+{
+  struct stm32l4_serial_s *priv =
+      (struct stm32l4_serial_s *)dev->priv;
+  struct uart_dmaxfer_s *xfer = &dev->dmarx;
+  size_t nbytes;
+
+  nbytes = stm32l4serial_dmacopy(priv, xfer->buffer, xfer->length);
+  if (nbytes == xfer->length && xfer->nlength > 0)
+    {
+      nbytes += stm32l4serial_dmacopy(priv, xfer->nbuffer, xfer->nlength);
+    }
+
+  xfer->nbytes = nbytes;
+  uart_recvchars_done(dev);
+}
+#endif
+
+/****************************************************************************
+ * Name: stm32l4serial_dmarxfree
+ *
+ * Description:
+ *   Called by the upper half when space has been freed in the serial
+ *   receive buffer.  Deliver any data that was held back because the
+ *   buffer was full.
+ *
+ ****************************************************************************/
+
+#ifdef SERIAL_HAVE_RXDMA_IDLE
+static void stm32l4serial_dmarxfree(struct uart_dev_s *dev)
+{
+  struct stm32l4_serial_s *priv =
+      (struct stm32l4_serial_s *)dev->priv;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if (priv->rxenable && stm32l4serial_dmarxavailable(dev))
+    {
+      uart_recvchars_dma(dev);
+    }
+
+  leave_critical_section(flags);
+}
+#endif
+
 /****************************************************************************
  * Name: stm32l4serial_send
  *
@@ -2746,7 +3296,7 @@ static void stm32l4serial_send(struct uart_dev_s *dev, int ch)
       (struct stm32l4_serial_s *)dev->priv;
 
 #ifdef HAVE_RS485
-  if (priv->rs485_dir_gpio != 0)
+  if (RS485_SWDIR(priv))
     {
       stm32l4_gpiowrite(priv->rs485_dir_gpio, priv->rs485_dir_polarity);
     }
@@ -2763,6 +3313,8 @@ static void stm32l4serial_send(struct uart_dev_s *dev, int ch)
  *
  ****************************************************************************/
 
+#if defined(SERIAL_HAVE_NODMA_OPS) || defined(SERIAL_HAVE_RXDMA_OPS) || \
+    defined(CONFIG_STM32L4_SERIALBRK_BSDCOMPAT)
 static void stm32l4serial_txint(struct uart_dev_s *dev, bool enable)
 {
   struct stm32l4_serial_s *priv =
@@ -2795,7 +3347,7 @@ static void stm32l4serial_txint(struct uart_dev_s *dev, bool enable)
        */
 
 #  ifdef HAVE_RS485
-      if (priv->rs485_dir_gpio != 0)
+      if (RS485_SWDIR(priv))
         {
           ie |= USART_CR1_TCIE;
         }
@@ -2827,6 +3379,7 @@ static void stm32l4serial_txint(struct uart_dev_s *dev, bool enable)
 
   leave_critical_section(flags);
 }
+#endif
 
 /****************************************************************************
  * Name: stm32l4serial_txready
@@ -2844,6 +3397,137 @@ static bool stm32l4serial_txready(struct uart_dev_s *dev)
            USART_ISR_TXE) != 0);
 }
 
+/****************************************************************************
+ * Name: stm32l4serial_dmasend
+ *
+ * Description:
+ *   Called by uart_xmitchars_dma() to start transmitting the first
+ *   contiguous region of the TX buffer.  The second region, if any, is
+ *   started from the DMA completion callback.
+ *
+ ****************************************************************************/
+
+#ifdef SERIAL_HAVE_TXDMA
+static void stm32l4serial_dmasend(struct uart_dev_s *dev)
+{
+  struct stm32l4_serial_s *priv =
+      (struct stm32l4_serial_s *)dev->priv;
+
+  /* The channel must be disabled before it can be reprogrammed */
+
+  stm32l4_dmastop(priv->txdma);
+
+  dev->dmatx.nbytes = 0;
+
+  stm32l4_dmasetup(priv->txdma,
+                   priv->usartbase + STM32L4_USART_TDR_OFFSET,
+                   (uint32_t)dev->dmatx.buffer,
+                   dev->dmatx.length,
+                   SERIAL_TXDMA_CONTROL_WORD);
+
+  stm32l4_dmastart(priv->txdma, stm32l4serial_dmatxcallback,
+                   (void *)priv, false);
+}
+#endif
+
+/****************************************************************************
+ * Name: stm32l4serial_dmatxint
+ *
+ * Description:
+ *   Call to enable or disable TX interrupts.  With Tx DMA the U[S]ART
+ *   interrupts are not used for transmission; enabling simply kicks the
+ *   DMA if it is idle and data is waiting.
+ *
+ ****************************************************************************/
+
+#ifdef SERIAL_HAVE_TXDMA
+static void stm32l4serial_dmatxint(struct uart_dev_s *dev, bool enable)
+{
+  if (enable)
+    {
+      stm32l4serial_dmatxavail(dev);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: stm32l4serial_dmatxavail
+ *
+ * Description:
+ *   Called by the upper half when new data has been added to the TX buffer.
+ *
+ ****************************************************************************/
+
+#ifdef SERIAL_HAVE_TXDMA
+static void stm32l4serial_dmatxavail(struct uart_dev_s *dev)
+{
+  struct stm32l4_serial_s *priv =
+      (struct stm32l4_serial_s *)dev->priv;
+  irqstate_t flags;
+
+  /* Only start a new transfer when the DMA is idle; otherwise the
+   * completion callback picks up the new data.
+   */
+
+  flags = enter_critical_section();
+  if (priv->txdma != NULL && stm32l4_dmaresidual(priv->txdma) == 0)
+    {
+      uart_xmitchars_dma(dev);
+    }
+
+  leave_critical_section(flags);
+}
+#endif
+
+/****************************************************************************
+ * Name: stm32l4serial_dmatxcallback
+ *
+ * Description:
+ *   DMA completion callback.  Start the second region of a wrapped TX
+ *   buffer, or release the transmitted bytes and continue with whatever
+ *   has been queued in the meantime.
+ *
+ ****************************************************************************/
+
+#ifdef SERIAL_HAVE_TXDMA
+static void stm32l4serial_dmatxcallback(DMA_HANDLE handle, uint8_t status,
+                                        void *arg)
+{
+  struct stm32l4_serial_s *priv = (struct stm32l4_serial_s *)arg;
+  struct uart_dmaxfer_s *xfer = &priv->dev.dmatx;
+
+  if ((status & DMA_STATUS_TCIF) != 0)
+    {
+      xfer->nbytes += xfer->length;
+      if (xfer->nlength > 0)
+        {
+          /* Continue with the wrapped part of the TX buffer */
+
+          stm32l4_dmasetup(priv->txdma,
+                           priv->usartbase + STM32L4_USART_TDR_OFFSET,
+                           (uint32_t)xfer->nbuffer,
+                           xfer->nlength,
+                           SERIAL_TXDMA_CONTROL_WORD);
+
+          xfer->length  = xfer->nlength;
+          xfer->nlength = 0;
+
+          stm32l4_dmastart(priv->txdma, stm32l4serial_dmatxcallback,
+                           (void *)priv, false);
+          return;
+        }
+    }
+
+  /* Release the space in the TX buffer and wake up any writers */
+
+  uart_xmitchars_done(&priv->dev);
+
+  /* Send anything that was queued while this transfer was in progress */
+
+  uart_xmitchars_dma(&priv->dev);
+}
+#endif
+
 /****************************************************************************
  * Name: stm32l4serial_dmarxcallback
  *
@@ -2861,7 +3545,11 @@ static void stm32l4serial_dmarxcallback(DMA_HANDLE handle, uint8_t status,
 
   if (priv->rxenable && stm32l4serial_dmarxavailable(&priv->dev))
     {
+#ifdef SERIAL_HAVE_RXDMA_IDLE
+      uart_recvchars_dma(&priv->dev);
+#else
       uart_recvchars(&priv->dev);
+#endif
 
 #ifdef CONFIG_SERIAL_IFLOWCONTROL
       if (priv->iflow)
@@ -3066,6 +3754,90 @@ static int stm32l4serial_pmprepare(struct pm_callback_s *cb, int domain,
 }
 #endif
 
+/****************************************************************************
+ * Name: stm32l4serial_dvfsprepare
+ *
+ * Description:
+ *   Refuse a SYSCLK change while a character is being sent: it would be
+ *   garbled by the new baud rate.
+ *
+ ****************************************************************************/
+
+#ifdef SERIAL_HAVE_DVFS
+static int stm32l4serial_dvfsprepare(struct stm32l4_dvfs_callback_s *cb,
+                                     uint32_t sysclk)
+{
+  int n;
+
+  for (n = 0; n < STM32L4_NLPUART + STM32L4_NUSART + STM32L4_NUART; n++)
+    {
+      struct stm32l4_serial_s *priv = g_uart_devs[n];
+
+      if (!priv || !priv->initialized)
+        {
+          continue;
+        }
+
+      if (priv->dev.xmit.head != priv->dev.xmit.tail ||
+          (stm32l4serial_getreg(priv, STM32L4_USART_ISR_OFFSET) &
+           USART_ISR_TC) == 0)
+        {
+          return -EBUSY;
+        }
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: stm32l4serial_dvfsnotify
+ *
+ * Description:
+ *   Recompute the baud rate divider of every active port for the new APB
+ *   clock.  BRR can only be written while the U[S]ART is disabled.
+ *
+ ****************************************************************************/
+
+#ifdef SERIAL_HAVE_DVFS
+static void stm32l4serial_dvfsnotify(struct stm32l4_dvfs_callback_s *cb,
+                                     uint32_t sysclk)
+{
+  uint32_t cr1;
+  uint32_t cr1_ue;
+  int n;
+
+  for (n = 0; n < STM32L4_NLPUART + STM32L4_NUSART + STM32L4_NUART; n++)
+    {
+      struct stm32l4_serial_s *priv = g_uart_devs[n];
+
+      if (!priv || !priv->initialized)
+        {
+          continue;
+        }
+
+      cr1    = stm32l4serial_getreg(priv, STM32L4_USART_CR1_OFFSET);
+      cr1_ue = cr1 & USART_CR1_UE;
+      stm32l4serial_putreg(priv, STM32L4_USART_CR1_OFFSET,
+                           cr1 & ~USART_CR1_UE);
+
+#ifdef CONFIG_STM32L4_LPUART1_SERIALDRIVER
+      if (priv->usartbase == STM32L4_LPUART1_BASE)
+        {
+          stm32l4serial_setbaud_lpuart(priv);
+        }
+      else
+#endif
+        {
+          stm32l4serial_setbaud_usart(priv);
+        }
+
+      cr1 = stm32l4serial_getreg(priv, STM32L4_USART_CR1_OFFSET);
+      stm32l4serial_putreg(priv, STM32L4_USART_CR1_OFFSET, cr1 | cr1_ue);
+    }
+}
+#endif
+
 #endif /* HAVE_UART */
 #endif /* USE_SERIALDRIVER */
 
@@ -3137,6 +3909,12 @@ void arm_serialinit(void)
   UNUSED(ret);
 #endif
 
+#ifdef SERIAL_HAVE_DVFS
+  /* Register to follow SYSCLK frequency changes */
+
+  stm32l4_dvfs_register(&g_serialdvfs);
+#endif
+
   /* Register the console */
 
 #if CONSOLE_UART > 0
@@ -74,6 +74,7 @@
 #include "stm32l4.h"
 #include "stm32l4_gpio.h"
 #include "stm32l4_dma.h"
+#include "stm32l4_dvfs.h"
 #include "stm32l4_spi.h"
 
 #include <arch/board/board.h>
@@ -153,6 +154,15 @@ struct stm32l4_spidev_s
   sem_t            txsem;        /* Wait for TX DMA to complete */
   uint32_t         txccr;        /* DMA control register for TX transfers */
   uint32_t         rxccr;        /* DMA control register for RX transfers */
+#ifdef CONFIG_STM32L4_SPI_DMAQUEUE
+  volatile bool    batching;     /* A transfer batch is in progress */
+  int              batchres;     /* Result of the transfer batch */
+  unsigned int     nbatch;       /* Number of transfers left in the batch */
+
+  /* Current transfer of the batch */
+
+  const struct stm32l4_spi_xfer_s *batch;
+#endif
 #endif
   bool             initialized;  /* Has SPI interface been initialized */
   mutex_t          lock;         /* Held while chip is selected for mutual exclusion */
@@ -163,6 +173,9 @@ struct stm32l4_spidev_s
 #ifdef CONFIG_PM
   struct pm_callback_s pm_cb;    /* PM callbacks */
 #endif
+#ifdef CONFIG_STM32L4_DVFS
+  struct stm32l4_dvfs_callback_s dvfs_cb; /* Clock change callbacks */
+#endif
 };
 
 /****************************************************************************
@@ -203,6 +216,10 @@ static void        spi_dmatxsetup(struct stm32l4_spidev_s *priv,
 static inline void spi_dmarxstart(struct stm32l4_spidev_s *priv);
 static inline void spi_dmatxstart(struct stm32l4_spidev_s *priv);
 #endif
+#ifdef CONFIG_STM32L4_SPI_DMAQUEUE
+static void        spi_batchstart(struct stm32l4_spidev_s *priv);
+static void        spi_batchdone(struct stm32l4_spidev_s *priv, int result);
+#endif
 
 /* SPI methods */
 
@@ -241,10 +258,26 @@ static int         spi_pm_prepare(struct pm_callback_s *cb, int domain,
                                   enum pm_state_e pmstate);
 #endif
 
+/* DVFS interface */
+
+#ifdef CONFIG_STM32L4_DVFS
+static int         spi_dvfs_prepare(struct stm32l4_dvfs_callback_s *cb,
+                                    uint32_t sysclk);
+static void        spi_dvfs_notify(struct stm32l4_dvfs_callback_s *cb,
+                                   uint32_t sysclk);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+#ifdef CONFIG_STM32L4_SPI_DMAQUEUE
+/* Dummy data used for batch transfers without a TX or RX buffer */
+
+static uint16_t g_rxdummy = 0xffff;
+static const uint16_t g_txdummy = 0xffff;
+#endif
+
 #ifdef CONFIG_STM32L4_SPI1
 static const struct spi_ops_s g_spi1ops =
 {
@@ -300,6 +333,10 @@ static struct stm32l4_spidev_s g_spi1dev =
 #ifdef CONFIG_PM
   .pm_cb.prepare = spi_pm_prepare,
 #endif
+#ifdef CONFIG_STM32L4_DVFS
+  .dvfs_cb.prepare = spi_dvfs_prepare,
+  .dvfs_cb.notify  = spi_dvfs_notify,
+#endif
 };
 #endif
 
@@ -356,6 +393,10 @@ static struct stm32l4_spidev_s g_spi2dev =
 #ifdef CONFIG_PM
   .pm_cb.prepare = spi_pm_prepare,
 #endif
+#ifdef CONFIG_STM32L4_DVFS
+  .dvfs_cb.prepare = spi_dvfs_prepare,
+  .dvfs_cb.notify  = spi_dvfs_notify,
+#endif
 };
 #endif
 
@@ -412,6 +453,10 @@ static struct stm32l4_spidev_s g_spi3dev =
 #ifdef CONFIG_PM
   .pm_cb.prepare = spi_pm_prepare,
 #endif
+#ifdef CONFIG_STM32L4_DVFS
+  .dvfs_cb.prepare = spi_dvfs_prepare,
+  .dvfs_cb.notify  = spi_dvfs_notify,
+#endif
 };
 #endif
 
@@ -734,6 +779,35 @@ static void spi_dmarxcallback(DMA_HANDLE handle, uint8_t isr, void *arg)
 {
   struct stm32l4_spidev_s *priv = (struct stm32l4_spidev_s *)arg;
 
+#ifdef CONFIG_STM32L4_SPI_DMAQUEUE
+  /* RX completes last, so in a batch this ends the current transfer.
+   * Deselect the device and either start the next transfer or wake up the
+   * waiting task.
+   */
+
+  if (priv->batching)
+    {
+      SPI_SELECT(&priv->spidev, priv->batch->devid, false);
+
+      if ((isr & DMA_CHAN_TEIF_BIT) != 0)
+        {
+          stm32l4_dmastop(priv->txdma);
+          spi_batchdone(priv, -EIO);
+        }
+      else if (--priv->nbatch > 0)
+        {
+          priv->batch++;
+          spi_batchstart(priv);
+        }
+      else
+        {
+          spi_batchdone(priv, OK);
+        }
+
+      return;
+    }
+#endif
+
   /* Wake-up the SPI driver */
 
   priv->rxresult = isr | 0x080;  /* OR'ed with 0x80 to assure non-zero */
@@ -754,6 +828,25 @@ static void spi_dmatxcallback(DMA_HANDLE handle, uint8_t isr, void *arg)
 {
   struct stm32l4_spidev_s *priv = (struct stm32l4_spidev_s *)arg;
 
+#ifdef CONFIG_STM32L4_SPI_DMAQUEUE
+  /* In a batch only the RX completion advances the queue.  A TX error
+   * means RX will never complete, so abort the batch here.
+   */
+
+  if (priv->batching)
+    {
+      priv->txresult = isr | 0x080;
+      if ((isr & DMA_CHAN_TEIF_BIT) != 0)
+        {
+          stm32l4_dmastop(priv->rxdma);
+          SPI_SELECT(&priv->spidev, priv->batch->devid, false);
+          spi_batchdone(priv, -EIO);
+        }
+
+      return;
+    }
+#endif
+
   /* Wake-up the SPI driver */
 
   priv->txresult = isr | 0x080;  /* OR'ed with 0x80 to assure non-zero */
@@ -896,6 +989,54 @@ static inline void spi_dmatxstart(struct stm32l4_spidev_s *priv)
 }
 #endif
 
+/****************************************************************************
+ * Name: spi_batchstart
+ *
+ * Description:
+ *   Configure the bus for the current batch transfer, select the device and
+ *   start the RX and TX DMAs.  Called from the task for the first transfer
+ *   and from the RX DMA completion interrupt for the following ones.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_SPI_DMAQUEUE
+static void spi_batchstart(struct stm32l4_spidev_s *priv)
+{
+  const struct stm32l4_spi_xfer_s *xfer = priv->batch;
+  struct spi_dev_s *dev = &priv->spidev;
+
+  spi_setfrequency(dev, xfer->frequency);
+  spi_setmode(dev, (enum spi_mode_e)xfer->mode);
+  spi_setbits(dev, xfer->nbits);
+
+  SPI_SELECT(dev, xfer->devid, true);
+
+  spi_dmarxsetup(priv, xfer->rxbuffer, &g_rxdummy, xfer->nwords);
+  spi_dmatxsetup(priv, xfer->txbuffer, &g_txdummy, xfer->nwords);
+
+  spi_dmarxstart(priv);
+  spi_dmatxstart(priv);
+}
+#endif
+
+/****************************************************************************
+ * Name: spi_batchdone
+ *
+ * Description:
+ *   Finish the transfer batch and wake up the waiting task
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_SPI_DMAQUEUE
+static void spi_batchdone(struct stm32l4_spidev_s *priv, int result)
+{
+  priv->batchres = result;
+  priv->nbatch   = 0;
+  priv->rxresult = 0x80;
+  spi_dmarxwakeup(priv);
+}
+#endif
+
 /****************************************************************************
  * Name: spi_modifycr
  *
@@ -980,6 +1121,7 @@ static uint32_t spi_setfrequency(struct spi_dev_s *dev,
                                  uint32_t frequency)
 {
   struct stm32l4_spidev_s *priv = (struct stm32l4_spidev_s *)dev;
+  uint32_t spiclock = stm32l4_dvfs_scale(priv->spiclock);
   uint16_t setbits;
   uint32_t actual;
 
@@ -996,61 +1138,61 @@ static uint32_t spi_setfrequency(struct spi_dev_s *dev,
     {
       /* Choices are limited by PCLK frequency with a set of divisors */
 
-      if (frequency >= priv->spiclock >> 1)
+      if (frequency >= spiclock >> 1)
         {
           /* More than fPCLK/2.  This is as fast as we can go */
 
           setbits = SPI_CR1_FPCLCKd2; /* 000: fPCLK/2 */
-          actual = priv->spiclock >> 1;
+          actual = spiclock >> 1;
         }
-      else if (frequency >= priv->spiclock >> 2)
+      else if (frequency >= spiclock >> 2)
         {
           /* Between fPCLCK/2 and fPCLCK/4, pick the slower */
 
           setbits = SPI_CR1_FPCLCKd4; /* 001: fPCLK/4 */
-          actual = priv->spiclock >> 2;
+          actual = spiclock >> 2;
         }
-      else if (frequency >= priv->spiclock >> 3)
+      else if (frequency >= spiclock >> 3)
         {
           /* Between fPCLCK/4 and fPCLCK/8, pick the slower */
 
           setbits = SPI_CR1_FPCLCKd8; /* 010: fPCLK/8 */
-          actual = priv->spiclock >> 3;
+          actual = spiclock >> 3;
         }
-      else if (frequency >= priv->spiclock >> 4)
+      else if (frequency >= spiclock >> 4)
         {
           /* Between fPCLCK/8 and fPCLCK/16, pick the slower */
 
           setbits = SPI_CR1_FPCLCKd16; /* 011: fPCLK/16 */
-          actual = priv->spiclock >> 4;
+          actual = spiclock >> 4;
         }
-      else if (frequency >= priv->spiclock >> 5)
+      else if (frequency >= spiclock >> 5)
         {
           /* Between fPCLCK/16 and fPCLCK/32, pick the slower */
 
           setbits = SPI_CR1_FPCLCKd32; /* 100: fPCLK/32 */
-          actual = priv->spiclock >> 5;
+          actual = spiclock >> 5;
         }
-      else if (frequency >= priv->spiclock >> 6)
+      else if (frequency >= spiclock >> 6)
         {
           /* Between fPCLCK/32 and fPCLCK/64, pick the slower */
 
           setbits = SPI_CR1_FPCLCKd64; /*  101: fPCLK/64 */
-          actual = priv->spiclock >> 6;
+          actual = spiclock >> 6;
         }
-      else if (frequency >= priv->spiclock >> 7)
+      else if (frequency >= spiclock >> 7)
         {
           /* Between fPCLCK/64 and fPCLCK/128, pick the slower */
 
           setbits = SPI_CR1_FPCLCKd128; /* 110: fPCLK/128 */
-          actual = priv->spiclock >> 7;
+          actual = spiclock >> 7;
         }
       else
         {
           /* Less than fPCLK/128.  This is as slow as we can go */
 
           setbits = SPI_CR1_FPCLCKd256; /* 111: fPCLK/256 */
-          actual = priv->spiclock >> 8;
+          actual = spiclock >> 8;
         }
 
       spi_modifycr(STM32L4_SPI_CR1_OFFSET, priv, 0, SPI_CR1_SPE);
@@ -1698,6 +1840,49 @@ static int spi_pm_prepare(struct pm_callback_s *cb, int domain,
 }
 #endif
 
+/****************************************************************************
+ * Name: spi_dvfs_prepare
+ *
+ * Description:
+ *   Refuse a SYSCLK change while the bus is locked for a transfer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_DVFS
+static int spi_dvfs_prepare(struct stm32l4_dvfs_callback_s *cb,
+                            uint32_t sysclk)
+{
+  struct stm32l4_spidev_s *priv =
+    (struct stm32l4_spidev_s *)((char *)cb -
+                                offsetof(struct stm32l4_spidev_s, dvfs_cb));
+
+  return nxmutex_is_locked(&priv->lock) ? -EBUSY : OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: spi_dvfs_notify
+ *
+ * Description:
+ *   Reselect the baud rate prescaler for the requested frequency from the
+ *   new PCLK.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_DVFS
+static void spi_dvfs_notify(struct stm32l4_dvfs_callback_s *cb,
+                            uint32_t sysclk)
+{
+  struct stm32l4_spidev_s *priv =
+    (struct stm32l4_spidev_s *)((char *)cb -
+                                offsetof(struct stm32l4_spidev_s, dvfs_cb));
+  uint32_t frequency = priv->frequency;
+
+  priv->frequency = 0;
+  spi_setfrequency((struct spi_dev_s *)priv, frequency);
+}
+#endif
+
 /****************************************************************************
  * Name: spi_bus_initialize
  *
@@ -1782,6 +1967,12 @@ static void spi_bus_initialize(struct stm32l4_spidev_s *priv)
   DEBUGASSERT(ret == OK);
   UNUSED(ret);
 #endif
+
+#ifdef CONFIG_STM32L4_DVFS
+  /* Register to follow PCLK frequency changes */
+
+  stm32l4_dvfs_register(&priv->dvfs_cb);
+#endif
 }
 
 /****************************************************************************
@@ -1891,4 +2082,97 @@ struct spi_dev_s *stm32l4_spibus_initialize(int bus)
   return (struct spi_dev_s *)priv;
 }
 
+/****************************************************************************
+ * Name: stm32l4_spi_exchange_batch
+ *
+ * Description:
+ *   Execute a batch of chip-select framed DMA transfers back to back.  The
+ *   bus is locked for the whole batch and each following transfer is
+ *   started directly from the DMA completion interrupt of the previous one,
+ *   so the calling task is only woken once, when the whole batch is done.
+ *
+ * Input Parameters:
+ *   dev    - Device returned by stm32l4_spibus_initialize()
+ *   xfers  - Array of transfer descriptors; must remain valid until return
+ *   nxfers - Number of entries in xfers
+ *
+ * Returned Value:
+ *   Zero (OK) when all transfers completed; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_SPI_DMAQUEUE
+int stm32l4_spi_exchange_batch(struct spi_dev_s *dev,
+                               const struct stm32l4_spi_xfer_s *xfers,
+                               unsigned int nxfers)
+{
+  struct stm32l4_spidev_s *priv = (struct stm32l4_spidev_s *)dev;
+  unsigned int i;
+  int ret;
+
+  DEBUGASSERT(priv && priv->spibase);
+
+  if (xfers == NULL || nxfers == 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Validate all descriptors up front; nothing can be reported from the
+   * interrupt handler once the batch is running.
+   */
+
+  for (i = 0; i < nxfers; i++)
+    {
+      if (xfers[i].nwords == 0 || xfers[i].nbits < 4 ||
+          xfers[i].nbits > 16 || xfers[i].mode > SPIDEV_MODE3)
+        {
+          return -EINVAL;
+        }
+
+#ifdef CONFIG_STM32L4_DMACAPABLE
+      if ((xfers[i].txbuffer != NULL &&
+           !stm32l4_dmacapable((uint32_t)xfers[i].txbuffer, xfers[i].nwords,
+                               xfers[i].nbits > 8 ? SPI_TXDMA16_CONFIG :
+                                                    SPI_TXDMA8_CONFIG)) ||
+          (xfers[i].rxbuffer != NULL &&
+           !stm32l4_dmacapable((uint32_t)xfers[i].rxbuffer, xfers[i].nwords,
+                               xfers[i].nbits > 8 ? SPI_RXDMA16_CONFIG :
+                                                    SPI_RXDMA8_CONFIG)))
+        {
+          return -EFAULT;
+        }
+#endif
+    }
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  spiinfo("nxfers=%u\n", nxfers);
+
+  priv->batch    = xfers;
+  priv->nbatch   = nxfers;
+  priv->batchres = OK;
+  priv->batching = true;
+
+  spi_batchstart(priv);
+
+  /* Wait once for the whole batch */
+
+  ret = spi_dmarxwait(priv);
+  priv->batching = false;
+
+  if (ret >= 0)
+    {
+      ret = priv->batchres;
+    }
+
+  nxmutex_unlock(&priv->lock);
+  return ret;
+}
+#endif
+
 #endif /* CONFIG_STM32L4_SPI1 || CONFIG_STM32L4_SPI2 || CONFIG_STM32L4_SPI3 */
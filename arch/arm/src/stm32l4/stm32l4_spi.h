@@ -27,6 +27,9 @@
 
 #include <nuttx/config.h>
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include "chip.h"
 #include "hardware/stm32l4_spi.h"
 
@@ -51,6 +54,30 @@ extern "C"
 
 struct spi_dev_s;
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_SPI_DMAQUEUE
+/* One chip-select framed transfer in a DMA transaction batch.  The bus is
+ * reconfigured for each entry, the device is selected through the board
+ * select logic, txbuffer/rxbuffer are exchanged by DMA and the device is
+ * deselected again before the next entry is started.  Either buffer may be
+ * NULL, in which case dummy data is sent or received data is discarded.
+ */
+
+struct stm32l4_spi_xfer_s
+{
+  uint32_t    devid;      /* Device ID passed to the select method */
+  uint32_t    frequency;  /* SPI frequency for this transfer */
+  uint8_t     mode;       /* SPI mode (see enum spi_mode_e) */
+  uint8_t     nbits;      /* Number of bits per word (4-16) */
+  const void *txbuffer;   /* Data to send, or NULL */
+  void       *rxbuffer;   /* Buffer for received data, or NULL */
+  size_t      nwords;     /* Length of the transfer in words */
+};
+#endif
+
 /****************************************************************************
  * Public Functions Prototypes
  ****************************************************************************/
@@ -143,6 +170,36 @@ int stm32l4_spi3cmddata(struct spi_dev_s *dev, uint32_t devid, bool cmd);
  *
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: stm32l4_spi_exchange_batch
+ *
+ * Description:
+ *   Execute a batch of chip-select framed DMA transfers back to back.  The
+ *   bus is locked for the whole batch and each following transfer is
+ *   started directly from the DMA completion interrupt of the previous one,
+ *   so the calling task is only woken once, when the whole batch is done.
+ *
+ *   On return the bus is left configured for the last transfer; other users
+ *   of the bus reconfigure it after locking as usual.
+ *
+ * Input Parameters:
+ *   dev    - Device returned by stm32l4_spibus_initialize()
+ *   xfers  - Array of transfer descriptors; must remain valid until return
+ *   nxfers - Number of entries in xfers
+ *
+ * Returned Value:
+ *   Zero (OK) when all transfers completed; -EINVAL for an invalid
+ *   descriptor, -EFAULT if a buffer is not DMA capable, or -EIO if a DMA
+ *   error aborted the batch.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_SPI_DMAQUEUE
+int stm32l4_spi_exchange_batch(struct spi_dev_s *dev,
+                               const struct stm32l4_spi_xfer_s *xfers,
+                               unsigned int nxfers);
+#endif
+
 #ifdef CONFIG_SPI_CALLBACK
 #ifdef CONFIG_STM32L4_SPI1
 int stm32l4_spi1register(struct spi_dev_s *dev,
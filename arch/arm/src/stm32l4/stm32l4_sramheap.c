@@ -0,0 +1,145 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_sramheap.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mm.h>
+
+#include "stm32l4_sramheap.h"
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* Created by stm32l4_sramheap_initialize() from up_allocate_heap() */
+
+#ifdef HAVE_SRAM2_HEAP
+FAR struct mm_heap_s *g_sram2_heap;
+#endif
+
+#ifdef HAVE_SRAM3_HEAP
+FAR struct mm_heap_s *g_sram3_heap;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4_heap_select
+ *
+ * Description:
+ *   Return the heap that serves the hint, or NULL for the main heap.
+ *
+ ****************************************************************************/
+
+static FAR struct mm_heap_s *
+stm32l4_heap_select(enum stm32l4_heaphint_e hint)
+{
+  switch (hint)
+    {
+#ifdef HAVE_SRAM2_HEAP
+      case STM32L4_HEAP_FAST:
+        return g_sram2_heap;
+#endif
+
+#ifdef HAVE_SRAM3_HEAP
+      case STM32L4_HEAP_BULK:
+        return g_sram3_heap;
+#endif
+
+      default:
+        return NULL;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4_heap_malloc
+ ****************************************************************************/
+
+FAR void *stm32l4_heap_malloc(enum stm32l4_heaphint_e hint, size_t size)
+{
+  FAR struct mm_heap_s *heap = stm32l4_heap_select(hint);
+
+  return heap != NULL ? mm_malloc(heap, size) : kumm_malloc(size);
+}
+
+/****************************************************************************
+ * Name: stm32l4_heap_zalloc
+ ****************************************************************************/
+
+FAR void *stm32l4_heap_zalloc(enum stm32l4_heaphint_e hint, size_t size)
+{
+  FAR struct mm_heap_s *heap = stm32l4_heap_select(hint);
+
+  return heap != NULL ? mm_zalloc(heap, size) : kumm_zalloc(size);
+}
+
+/****************************************************************************
+ * Name: stm32l4_heap_memalign
+ ****************************************************************************/
+
+FAR void *stm32l4_heap_memalign(enum stm32l4_heaphint_e hint,
+                                size_t alignment, size_t size)
+{
+  FAR struct mm_heap_s *heap = stm32l4_heap_select(hint);
+
+  return heap != NULL ? mm_memalign(heap, alignment, size) :
+                        kumm_memalign(alignment, size);
+}
+
+/****************************************************************************
+ * Name: stm32l4_heap_free
+ ****************************************************************************/
+
+void stm32l4_heap_free(FAR void *mem)
+{
+  if (mem == NULL)
+    {
+      return;
+    }
+
+#ifdef HAVE_SRAM2_HEAP
+  if (g_sram2_heap != NULL && mm_heapmember(g_sram2_heap, mem))
+    {
+      mm_free(g_sram2_heap, mem);
+      return;
+    }
+#endif
+
+#ifdef HAVE_SRAM3_HEAP
+  if (g_sram3_heap != NULL && mm_heapmember(g_sram3_heap, mem))
+    {
+      mm_free(g_sram3_heap, mem);
+      return;
+    }
+#endif
+
+  kumm_free(mem);
+}
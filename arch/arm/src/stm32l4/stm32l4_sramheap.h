@@ -0,0 +1,161 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_sramheap.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_SRC_STM32L4_STM32L4_SRAMHEAP_H
+#define __ARCH_ARM_SRC_STM32L4_STM32L4_SRAMHEAP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+
+#include <nuttx/mm/mm.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Does the chip have an SRAM2 or SRAM3 heap of its own? */
+
+#ifdef CONFIG_STM32L4_SRAM_HEAPS
+#  ifdef CONFIG_STM32L4_SRAM2_HEAP
+#    define HAVE_SRAM2_HEAP 1
+#  endif
+#  ifdef CONFIG_STM32L4_SRAM3_HEAP
+#    define HAVE_SRAM3_HEAP 1
+#  endif
+#endif
+
+#ifndef __ASSEMBLY__
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Where an allocation should be placed:
+ *
+ *   STM32L4_HEAP_FAST - SRAM2.  It is on its own bus matrix port, so it is
+ *                       accessed in parallel with SRAM1, with no contention
+ *                       from DMA transfers to SRAM1.  For ISR data and
+ *                       latency critical state.
+ *   STM32L4_HEAP_DMA  - SRAM1, the main heap.  It is reachable by all bus
+ *                       masters at its system bus address.
+ *   STM32L4_HEAP_BULK - SRAM3 on the STM32L4+, for large buffers and caches
+ *                       that would fragment SRAM1.
+ *
+ * A hint whose SRAM has no heap of its own is served by the main heap.
+ */
+
+enum stm32l4_heaphint_e
+{
+  STM32L4_HEAP_FAST = 0,
+  STM32L4_HEAP_DMA,
+  STM32L4_HEAP_BULK
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#ifdef HAVE_SRAM2_HEAP
+EXTERN FAR struct mm_heap_s *g_sram2_heap;
+#endif
+
+#ifdef HAVE_SRAM3_HEAP
+EXTERN FAR struct mm_heap_s *g_sram3_heap;
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4_heap_malloc
+ *
+ * Description:
+ *   Allocate memory from the SRAM selected by the hint.  The allocation
+ *   does not fall back to another SRAM when the selected heap is exhausted,
+ *   so that the placement stays deterministic.
+ *
+ * Input Parameters:
+ *   hint - The kind of memory wanted (see enum stm32l4_heaphint_e)
+ *   size - The number of bytes to allocate
+ *
+ * Returned Value:
+ *   The allocated memory, or NULL if the selected heap has none left.
+ *
+ ****************************************************************************/
+
+FAR void *stm32l4_heap_malloc(enum stm32l4_heaphint_e hint, size_t size);
+
+/****************************************************************************
+ * Name: stm32l4_heap_zalloc
+ *
+ * Description:
+ *   Like stm32l4_heap_malloc(), but the memory is cleared.
+ *
+ ****************************************************************************/
+
+FAR void *stm32l4_heap_zalloc(enum stm32l4_heaphint_e hint, size_t size);
+
+/****************************************************************************
+ * Name: stm32l4_heap_memalign
+ *
+ * Description:
+ *   Like stm32l4_heap_malloc(), but the memory is aligned to 'alignment'
+ *   bytes, a power of two.
+ *
+ ****************************************************************************/
+
+FAR void *stm32l4_heap_memalign(enum stm32l4_heaphint_e hint,
+                                size_t alignment, size_t size);
+
+/****************************************************************************
+ * Name: stm32l4_heap_free
+ *
+ * Description:
+ *   Free memory returned by stm32l4_heap_malloc(), stm32l4_heap_zalloc()
+ *   or stm32l4_heap_memalign() to the heap that it came from.
+ *
+ * Input Parameters:
+ *   mem - The memory to free, may be NULL
+ *
+ ****************************************************************************/
+
+void stm32l4_heap_free(FAR void *mem);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ASSEMBLY__ */
+#endif /* __ARCH_ARM_SRC_STM32L4_STM32L4_SRAMHEAP_H */
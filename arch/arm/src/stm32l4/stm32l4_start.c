@@ -33,10 +33,13 @@
 
 #include "arm_internal.h"
 #include "nvic.h"
+#include "mpu.h"
+#include "itm_note.h"
 
 #include "stm32l4.h"
 #include "stm32l4_gpio.h"
 #include "stm32l4_userspace.h"
+#include "stm32l4_mpuinit.h"
 #include "stm32l4_start.h"
 
 /****************************************************************************
@@ -145,6 +148,22 @@ void __start(void)
     }
 #endif
 
+  /* Copy the RAM functions from FLASH to SRAM2.  The correct destination
+   * in SRAM2 is given by _sramfuncs and _eramfuncs.  The temporary
+   * location is in flash after the data initialization code at
+   * _framfuncs.  This must be done before any of them (memcpy() for
+   * example) may be called.
+   */
+
+#ifdef CONFIG_ARCH_RAMFUNCS
+  for (src = (const uint32_t *)_framfuncs,
+       dest = (uint32_t *)_sramfuncs; dest < (uint32_t *)_eramfuncs;
+      )
+    {
+      *dest++ = *src++;
+    }
+#endif
+
   /* Configure the UART so that we can get debug output as soon as possible */
 
   stm32l4_clockconfig();
@@ -162,6 +181,15 @@ void __start(void)
       *dest++ = 0;
     }
 
+#ifdef CONFIG_STM32L4_MPU_MEMMAP
+  /* Clear .sram2_fast as well */
+
+  for (dest = (uint32_t *)_ssram2_fast; dest < (uint32_t *)_esram2_fast; )
+    {
+      *dest++ = 0;
+    }
+#endif
+
   showprogress('B');
 
   /* Move the initialized data section from his temporary holding spot in
@@ -183,6 +211,17 @@ void __start(void)
   up_perf_init((void *)STM32_SYSCLK_FREQUENCY);
 #endif
 
+#ifdef CONFIG_ARMV7M_ITMNOTE
+  /* Route the asynchronous trace to PB3 (TRACESWO) and stream the sched
+   * notes there.
+   */
+
+  modifyreg32(STM32_DBGMCU_CR, DBGMCU_CR_TRACEMODE_MASK,
+              DBGMCU_CR_ASYNCH | DBGMCU_CR_TRACEIOEN);
+  stm32l4_configgpio(GPIO_JTDO_0);
+  itm_note_initialize();
+#endif
+
   /* Perform early serial initialization */
 
 #ifdef USE_EARLYSERIALINIT
@@ -201,6 +240,20 @@ void __start(void)
   showprogress('E');
 #endif
 
+#ifdef CONFIG_STM32L4_MPU_MEMMAP
+  /* Program the memory attributes */
+
+  stm32l4_mpu_memmap();
+#endif
+
+#ifdef CONFIG_ARMV7M_STACKGUARD
+  /* Reserve the stack guard region after the user-space regions, so that
+   * it takes precedence over them.
+   */
+
+  mpu_stackguard_initialize();
+#endif
+
   /* Initialize onboard resources */
 
   stm32l4_board_initialize();
@@ -78,6 +78,7 @@
 
 #include "stm32l4_oneshot.h"
 #include "stm32l4_freerun.h"
+#include "stm32l4_tickless.h"
 
 #ifdef CONFIG_SCHED_TICKLESS
 
@@ -336,4 +337,32 @@ int up_timer_start(const struct timespec *ts)
   return stm32l4_oneshot_start(&g_tickless.oneshot,
                                stm32l4_oneshot_handler, NULL, ts);
 }
+
+/****************************************************************************
+ * Name: stm32l4_tickless_capture
+ *
+ * Description:
+ *   Capture the edges of a channel input of the free-running timer, whose
+ *   count is the system time.
+ *
+ * Input Parameters:
+ *   channel - The channel of CONFIG_STM32L4_TICKLESS_FREERUN, 1-4.
+ *   pincfg  - The pin configuration of the channel input.
+ *   handler - The callback, or NULL to stop reporting the edges.
+ *   arg     - The argument of the callback.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_FREERUN_CAPTURE
+int stm32l4_tickless_capture(int channel, uint32_t pincfg,
+                             stm32l4_freerun_capture_t handler, void *arg)
+{
+  return stm32l4_freerun_capture(&g_tickless.freerun, channel, pincfg,
+                                 handler, arg);
+}
+#endif
 #endif /* CONFIG_SCHED_TICKLESS */
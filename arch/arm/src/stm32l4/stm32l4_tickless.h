@@ -0,0 +1,138 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_tickless.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_SRC_STM32L4_STM32L4_TICKLESS_H
+#define __ARCH_ARM_SRC_STM32L4_STM32L4_TICKLESS_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#if defined(CONFIG_STM32L4_TICKLESS_TIM) && \
+    defined(CONFIG_STM32L4_FREERUN_CAPTURE)
+#  include "stm32l4_freerun.h"
+#endif
+
+#if defined(CONFIG_STM32L4_TICKLESS_LPTIM) || \
+    (defined(CONFIG_STM32L4_TICKLESS_TIM) && \
+     defined(CONFIG_STM32L4_FREERUN_CAPTURE))
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifndef __ASSEMBLY__
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#ifdef CONFIG_STM32L4_TICKLESS_LPTIM
+
+/****************************************************************************
+ * Name: stm32l4_tickless_remaining
+ *
+ * Description:
+ *   Return the time until the pending alarm expires.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The time remaining in microseconds; zero if the alarm is already due
+ *   and UINT32_MAX if no alarm is pending (or it is further away than
+ *   that).
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+uint32_t stm32l4_tickless_remaining(void);
+
+/****************************************************************************
+ * Name: stm32l4_tickless_wakeahead
+ *
+ * Description:
+ *   Make the pending alarm interrupt fire 'usec' microseconds early, so
+ *   that a low power mode with that wakeup latency has been left by the
+ *   time the alarm is due.  The early interrupt does not expire the alarm;
+ *   it is reprogrammed for the exact time.  Call again with zero before
+ *   interrupts are re-enabled after wakeup.
+ *
+ * Input Parameters:
+ *   usec - The wakeup lead in microseconds.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void stm32l4_tickless_wakeahead(uint32_t usec);
+
+#else /* CONFIG_STM32L4_TICKLESS_TIM */
+
+/****************************************************************************
+ * Name: stm32l4_tickless_capture
+ *
+ * Description:
+ *   Capture the edges of a channel input of the free-running timer of the
+ *   OS, see stm32l4_freerun_capture().  The times are system times, the
+ *   time base of clock_systime_timespec() and sensor_get_timestamp(), so
+ *   a data-ready line can date the samples of a sensor without the jitter
+ *   of the interrupt and the work queue that reads them.
+ *
+ * Input Parameters:
+ *   channel - The channel of CONFIG_STM32L4_TICKLESS_FREERUN, 1-4.
+ *   pincfg  - The pin configuration of the channel input.
+ *   handler - The callback, or NULL to stop reporting the edges.
+ *   arg     - The argument of the callback.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int stm32l4_tickless_capture(int channel, uint32_t pincfg,
+                             stm32l4_freerun_capture_t handler, void *arg);
+
+#endif
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __ASSEMBLY__ */
+#endif /* CONFIG_STM32L4_TICKLESS_LPTIM || ... */
+#endif /* __ARCH_ARM_SRC_STM32L4_STM32L4_TICKLESS_H */
@@ -0,0 +1,698 @@
+/****************************************************************************
+ * arch/arm/src/stm32l4/stm32l4_tickless_lptim.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Tickless OS Support using an LPTIM.
+ *
+ * When CONFIG_SCHED_TICKLESS and CONFIG_SCHED_TICKLESS_ALARM are enabled,
+ * the platform specific code is expected to provide:
+ *
+ *   void up_timer_initialize(void): Initializes the timer facilities.
+ *   int up_timer_gettime(struct timespec *ts):  Returns the current
+ *     time from the platform specific time source.
+ *   int up_alarm_cancel(struct timespec *ts):  Cancels the alarm.
+ *   int up_alarm_start(const struct timespec *ts): Enables (or re-enables)
+ *     the alarm.
+ *
+ * This implementation keeps a single LPTIM free-running from LSE (or LSI)
+ * with the autoreload at 0xffff.  Unlike the general purpose timers used
+ * by stm32l4_tickless.c, the LPTIM keeps counting in the STOP modes (STOP2
+ * for LPTIM1, up to STOP1 for LPTIM2) and its interrupt wakes the MCU, so
+ * the OS can sleep for long intervals without losing time.
+ *
+ * The 16-bit counter is extended in software:  the autoreload match
+ * interrupt counts periods and a still-pending autoreload match is taken
+ * into account when the time is read.  The compare register provides the
+ * alarm.  The alarm is only programmed into the compare register in the
+ * period in which it expires; otherwise the compare register is parked at
+ * the autoreload value so that at most one interrupt is taken per period.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <arch/board/board.h>
+
+#include "arm_internal.h"
+#include "stm32l4_rcc.h"
+#include "stm32l4_exti.h"
+#include "stm32l4_tickless.h"
+#include "stm32l4.h"
+#include "hardware/stm32l4_lptim.h"
+
+#ifdef CONFIG_STM32L4_TICKLESS_LPTIM
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_SCHED_TICKLESS_ALARM
+#  error CONFIG_SCHED_TICKLESS_ALARM is required by the LPTIM tickless timer
+#endif
+
+/* Select the LPTIM instance */
+
+#if CONFIG_STM32L4_TICKLESS_LPTIM_TIMER == 1
+#  ifdef CONFIG_STM32L4_LPTIM1
+#    error CONFIG_STM32L4_LPTIM1 conflicts with the LPTIM1 tickless timer
+#  endif
+#  define LPTIM_BASE          STM32L4_LPTIM1_BASE
+#  define LPTIM_IRQ           STM32L4_IRQ_LPTIM1
+#  define LPTIM_EXTI          EXTI2_LPTIM1
+#  define LPTIM_APBENR        STM32L4_RCC_APB1ENR1
+#  define LPTIM_APBEN         RCC_APB1ENR1_LPTIM1EN
+#  define LPTIM_APBRSTR       STM32L4_RCC_APB1RSTR1
+#  define LPTIM_APBRST        RCC_APB1RSTR1_LPTIM1RST
+#  define LPTIM_CCIPR_MASK    RCC_CCIPR_LPTIM1SEL_MASK
+#  define LPTIM_CCIPR_LSE     RCC_CCIPR_LPTIM1SEL_LSE
+#  define LPTIM_CCIPR_LSI     RCC_CCIPR_LPTIM1SEL_LSI
+#elif CONFIG_STM32L4_TICKLESS_LPTIM_TIMER == 2
+#  ifdef CONFIG_STM32L4_LPTIM2
+#    error CONFIG_STM32L4_LPTIM2 conflicts with the LPTIM2 tickless timer
+#  endif
+#  define LPTIM_BASE          STM32L4_LPTIM2_BASE
+#  define LPTIM_IRQ           STM32L4_IRQ_LPTIM2
+#  define LPTIM_EXTI          EXTI2_LPTIM2
+#  define LPTIM_APBENR        STM32L4_RCC_APB1ENR2
+#  define LPTIM_APBEN         RCC_APB1ENR2_LPTIM2EN
+#  define LPTIM_APBRSTR       STM32L4_RCC_APB1RSTR2
+#  define LPTIM_APBRST        RCC_APB1RSTR2_LPTIM2RST
+#  define LPTIM_CCIPR_MASK    RCC_CCIPR_LPTIM2SEL_MASK
+#  define LPTIM_CCIPR_LSE     RCC_CCIPR_LPTIM2SEL_LSE
+#  define LPTIM_CCIPR_LSI     RCC_CCIPR_LPTIM2SEL_LSI
+#else
+#  error Invalid CONFIG_STM32L4_TICKLESS_LPTIM_TIMER
+#endif
+
+/* Select the kernel clock */
+
+#ifdef CONFIG_STM32L4_TICKLESS_LPTIM_LSI
+#  define LPTIM_CCIPR_CLK     LPTIM_CCIPR_LSI
+#  define LPTIM_CLKIN         STM32L4_LSI_FREQUENCY
+#else
+#  define LPTIM_CCIPR_CLK     LPTIM_CCIPR_LSE
+#  define LPTIM_CLKIN         STM32L4_LSE_FREQUENCY
+#endif
+
+/* Select the prescaler */
+
+#if CONFIG_STM32L4_TICKLESS_LPTIM_PRESCALER == 1
+#  define LPTIM_PRESC         LPTIM_CFGR_PRESCd1
+#elif CONFIG_STM32L4_TICKLESS_LPTIM_PRESCALER == 2
+#  define LPTIM_PRESC         LPTIM_CFGR_PRESCd2
+#elif CONFIG_STM32L4_TICKLESS_LPTIM_PRESCALER == 4
+#  define LPTIM_PRESC         LPTIM_CFGR_PRESCd4
+#elif CONFIG_STM32L4_TICKLESS_LPTIM_PRESCALER == 8
+#  define LPTIM_PRESC         LPTIM_CFGR_PRESCd8
+#elif CONFIG_STM32L4_TICKLESS_LPTIM_PRESCALER == 16
+#  define LPTIM_PRESC         LPTIM_CFGR_PRESCd16
+#elif CONFIG_STM32L4_TICKLESS_LPTIM_PRESCALER == 32
+#  define LPTIM_PRESC         LPTIM_CFGR_PRESCd32
+#elif CONFIG_STM32L4_TICKLESS_LPTIM_PRESCALER == 64
+#  define LPTIM_PRESC         LPTIM_CFGR_PRESCd64
+#elif CONFIG_STM32L4_TICKLESS_LPTIM_PRESCALER == 128
+#  define LPTIM_PRESC         LPTIM_CFGR_PRESCd128
+#else
+#  error CONFIG_STM32L4_TICKLESS_LPTIM_PRESCALER must be a power of 2 (1-128)
+#endif
+
+/* Counter frequency and geometry */
+
+#define LPTIM_FREQUENCY \
+  (LPTIM_CLKIN / CONFIG_STM32L4_TICKLESS_LPTIM_PRESCALER)
+#define LPTIM_MAXCOUNT        0xffff
+#define LPTIM_PERIOD_SHIFT    16
+#define LPTIM_HALFPERIOD      0x8000
+
+/* Minimum distance, in counts, between the current count and a newly
+ * programmed compare value.  A write to CMP takes up to two kernel clocks
+ * to reach the counter domain; closer matches could be missed.
+ */
+
+#define LPTIM_MINDELTA        3
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct stm32l4_tickless_s
+{
+  uint32_t periods;    /* Number of counter periods acknowledged */
+  uint16_t cmp;        /* Value last written to CMP */
+  bool     cmpbusy;    /* True: a CMP write has not completed yet */
+  bool     armed;      /* True: an alarm is pending */
+  uint64_t alarm;      /* Alarm time in counts since initialization */
+  uint32_t lead;       /* Counts to raise the alarm interrupt early by */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct stm32l4_tickless_s g_tickless;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4_lptim_getreg/putreg
+ ****************************************************************************/
+
+static inline uint32_t stm32l4_lptim_getreg(uint32_t offset)
+{
+  return getreg32(LPTIM_BASE + offset);
+}
+
+static inline void stm32l4_lptim_putreg(uint32_t offset, uint32_t value)
+{
+  putreg32(value, LPTIM_BASE + offset);
+}
+
+/****************************************************************************
+ * Name: stm32l4_lptim_getcounter
+ *
+ * Description:
+ *   Read CNT.  The counter runs from an asynchronous clock, so the value is
+ *   only reliable when two consecutive reads agree.
+ *
+ ****************************************************************************/
+
+static uint32_t stm32l4_lptim_getcounter(void)
+{
+  uint32_t prev;
+  uint32_t cnt;
+
+  cnt = stm32l4_lptim_getreg(STM32L4_LPTIM_CNT_OFFSET);
+  do
+    {
+      prev = cnt;
+      cnt  = stm32l4_lptim_getreg(STM32L4_LPTIM_CNT_OFFSET);
+    }
+  while (cnt != prev);
+
+  return cnt;
+}
+
+/****************************************************************************
+ * Name: stm32l4_lptim_now
+ *
+ * Description:
+ *   Return the number of counts since initialization.
+ *
+ *   ARRM is set while CNT equals the autoreload value, one count before CNT
+ *   returns to zero.  The count is therefore extended with CNT + 1, which
+ *   wraps at exactly the moment ARRM is raised.  The extended value is then
+ *   one greater than the true count, which is corrected on return.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static uint64_t stm32l4_lptim_now(void)
+{
+  uint32_t periods = g_tickless.periods;
+  uint32_t cnt;
+
+  cnt = (stm32l4_lptim_getcounter() + 1) & LPTIM_MAXCOUNT;
+
+  /* An autoreload match not yet handled by the interrupt belongs to this
+   * reading only if the counter has already been seen to wrap.
+   */
+
+  if ((stm32l4_lptim_getreg(STM32L4_LPTIM_ISR_OFFSET) &
+       LPTIM_ISR_ARRM) != 0 && cnt < LPTIM_HALFPERIOD)
+    {
+      periods++;
+    }
+
+  return (((uint64_t)periods << LPTIM_PERIOD_SHIFT) | cnt) - 1;
+}
+
+/****************************************************************************
+ * Name: stm32l4_lptim_ticks2ts/ts2ticks
+ *
+ * Description:
+ *   Convert between counts and timespec.  The whole-second part is
+ *   separated first so that the conversion is exact for any counter
+ *   frequency (e.g. LSI at 32 kHz) and does not accumulate drift.  Alarm
+ *   times are rounded up so that an alarm never expires early.
+ *
+ ****************************************************************************/
+
+static void stm32l4_lptim_ticks2ts(uint64_t ticks, struct timespec *ts)
+{
+  uint64_t rem = ticks % LPTIM_FREQUENCY;
+
+  ts->tv_sec  = (time_t)(ticks / LPTIM_FREQUENCY);
+  ts->tv_nsec = (long)((rem * NSEC_PER_SEC) / LPTIM_FREQUENCY);
+}
+
+static uint64_t stm32l4_lptim_ts2ticks(const struct timespec *ts)
+{
+  return (uint64_t)ts->tv_sec * LPTIM_FREQUENCY +
+         ((uint64_t)ts->tv_nsec * LPTIM_FREQUENCY + NSEC_PER_SEC - 1) /
+         NSEC_PER_SEC;
+}
+
+/****************************************************************************
+ * Name: stm32l4_lptim_setcmp
+ *
+ * Description:
+ *   Write a new compare value.  CMP may not be written again until the
+ *   previous write has been acknowledged with CMPOK.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void stm32l4_lptim_setcmp(uint16_t cmp)
+{
+  if (cmp == g_tickless.cmp)
+    {
+      return;
+    }
+
+  if (g_tickless.cmpbusy)
+    {
+      while ((stm32l4_lptim_getreg(STM32L4_LPTIM_ISR_OFFSET) &
+              LPTIM_ISR_CMPOK) == 0);
+    }
+
+  stm32l4_lptim_putreg(STM32L4_LPTIM_ICR_OFFSET, LPTIM_ICR_CMPOKCF);
+  stm32l4_lptim_putreg(STM32L4_LPTIM_CMP_OFFSET, cmp);
+
+  g_tickless.cmp     = cmp;
+  g_tickless.cmpbusy = true;
+}
+
+/****************************************************************************
+ * Name: stm32l4_lptim_prepare
+ *
+ * Description:
+ *   Program CMP for the pending alarm if it expires in the current counter
+ *   period.  Otherwise park CMP at the autoreload value; the autoreload
+ *   interrupt will call this again in the next period.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void stm32l4_lptim_prepare(void)
+{
+  uint64_t target;
+  uint64_t now;
+
+  if (!g_tickless.armed)
+    {
+      stm32l4_lptim_setcmp(LPTIM_MAXCOUNT);
+      return;
+    }
+
+  /* Wait for any CMP write in progress before sampling the counter, so
+   * that the margin below is not eaten by the wait.
+   */
+
+  if (g_tickless.cmpbusy)
+    {
+      while ((stm32l4_lptim_getreg(STM32L4_LPTIM_ISR_OFFSET) &
+              LPTIM_ISR_CMPOK) == 0);
+
+      g_tickless.cmpbusy = false;
+    }
+
+  now    = stm32l4_lptim_now();
+  target = g_tickless.alarm;
+  target = target > g_tickless.lead ? target - g_tickless.lead : 0;
+  if (target < now + LPTIM_MINDELTA)
+    {
+      target = now + LPTIM_MINDELTA;
+    }
+
+  /* Periods begin when CNT + 1 wraps (see stm32l4_lptim_now()) */
+
+  if (((target + 1) >> LPTIM_PERIOD_SHIFT) ==
+      ((now + 1) >> LPTIM_PERIOD_SHIFT))
+    {
+      stm32l4_lptim_setcmp((uint16_t)(target & LPTIM_MAXCOUNT));
+    }
+  else
+    {
+      stm32l4_lptim_setcmp(LPTIM_MAXCOUNT);
+    }
+}
+
+/****************************************************************************
+ * Name: stm32l4_lptim_interrupt
+ *
+ * Description:
+ *   LPTIM interrupt.  Counts counter periods and expires the alarm.
+ *
+ ****************************************************************************/
+
+isr_ramfunc static int stm32l4_lptim_interrupt(int irq, void *context,
+                                               void *arg)
+{
+  struct timespec ts;
+  irqstate_t flags;
+  uint32_t isr;
+  uint64_t now;
+
+  flags = enter_critical_section();
+
+  isr = stm32l4_lptim_getreg(STM32L4_LPTIM_ISR_OFFSET);
+
+  if ((isr & LPTIM_ISR_ARRM) != 0)
+    {
+      stm32l4_lptim_putreg(STM32L4_LPTIM_ICR_OFFSET, LPTIM_ICR_ARRMCF);
+      g_tickless.periods++;
+    }
+
+  if ((isr & LPTIM_ISR_CMPM) != 0)
+    {
+      stm32l4_lptim_putreg(STM32L4_LPTIM_ICR_OFFSET, LPTIM_ICR_CMPMCF);
+    }
+
+  if (g_tickless.armed)
+    {
+      now = stm32l4_lptim_now();
+      if (now >= g_tickless.alarm)
+        {
+          /* The alarm expired.  The scheduler will start the next one. */
+
+          g_tickless.armed = false;
+          stm32l4_lptim_ticks2ts(now, &ts);
+          nxsched_alarm_expiration(&ts);
+        }
+    }
+
+  /* Re-evaluate CMP for the new period or the next alarm */
+
+  stm32l4_lptim_prepare();
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_timer_initialize
+ *
+ * Description:
+ *   Initializes all platform-specific timer facilities.  This function is
+ *   called early in the initialization sequence by up_initialize().
+ *   On return, the current up-time should be available from
+ *   up_timer_gettime() and the alarm is ready for use (but not actively
+ *   timing).
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called early in the initialization sequence before any special
+ *   concurrency protections are required.
+ *
+ ****************************************************************************/
+
+void up_timer_initialize(void)
+{
+  /* Start the kernel clock and route it to the LPTIM */
+
+#ifdef CONFIG_STM32L4_TICKLESS_LPTIM_LSI
+  stm32l4_rcc_enablelsi();
+#else
+  stm32l4_rcc_enablelse();
+#endif
+
+  modifyreg32(STM32L4_RCC_CCIPR, LPTIM_CCIPR_MASK, LPTIM_CCIPR_CLK);
+
+  /* Enable and reset the LPTIM */
+
+  modifyreg32(LPTIM_APBENR, 0, LPTIM_APBEN);
+  modifyreg32(LPTIM_APBRSTR, 0, LPTIM_APBRST);
+  modifyreg32(LPTIM_APBRSTR, LPTIM_APBRST, 0);
+
+  /* CFGR and IER may only be written while the LPTIM is disabled */
+
+  stm32l4_lptim_putreg(STM32L4_LPTIM_CFGR_OFFSET, LPTIM_PRESC);
+  stm32l4_lptim_putreg(STM32L4_LPTIM_IER_OFFSET,
+                       LPTIM_IER_CMPMIE | LPTIM_IER_ARRMIE);
+
+  /* ARR and CMP may only be written while it is enabled */
+
+  stm32l4_lptim_putreg(STM32L4_LPTIM_CR_OFFSET, LPTIM_CR_ENABLE);
+
+  stm32l4_lptim_putreg(STM32L4_LPTIM_ARR_OFFSET, LPTIM_MAXCOUNT);
+  while ((stm32l4_lptim_getreg(STM32L4_LPTIM_ISR_OFFSET) &
+          LPTIM_ISR_ARROK) == 0);
+
+  stm32l4_lptim_putreg(STM32L4_LPTIM_CMP_OFFSET, LPTIM_MAXCOUNT);
+  while ((stm32l4_lptim_getreg(STM32L4_LPTIM_ISR_OFFSET) &
+          LPTIM_ISR_CMPOK) == 0);
+
+  stm32l4_lptim_putreg(STM32L4_LPTIM_ICR_OFFSET,
+                       LPTIM_ICR_ARROKCF | LPTIM_ICR_CMPOKCF |
+                       LPTIM_ICR_ARRMCF | LPTIM_ICR_CMPMCF);
+
+  g_tickless.periods = 0;
+  g_tickless.cmp     = LPTIM_MAXCOUNT;
+  g_tickless.cmpbusy = false;
+  g_tickless.armed   = false;
+  g_tickless.lead    = 0;
+
+  /* Let the LPTIM interrupt wake the MCU from STOP */
+
+  modifyreg32(STM32L4_EXTI2_IMR, 0, LPTIM_EXTI);
+
+  irq_attach(LPTIM_IRQ, stm32l4_lptim_interrupt, NULL);
+  up_enable_irq(LPTIM_IRQ);
+
+  /* Start counting */
+
+  stm32l4_lptim_putreg(STM32L4_LPTIM_CR_OFFSET,
+                       LPTIM_CR_ENABLE | LPTIM_CR_CNTSTRT);
+}
+
+/****************************************************************************
+ * Name: up_timer_gettime
+ *
+ * Description:
+ *   Return the elapsed time since power-up (or, more correctly, since
+ *   up_timer_initialize() was called).  This function is functionally
+ *   equivalent to:
+ *
+ *      int clock_gettime(clockid_t clockid, struct timespec *ts);
+ *
+ *   when clockid is CLOCK_MONOTONIC.
+ *
+ * Input Parameters:
+ *   ts - Provides the location in which to return the up-time.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int up_timer_gettime(struct timespec *ts)
+{
+  irqstate_t flags;
+  uint64_t now;
+
+  flags = enter_critical_section();
+  now   = stm32l4_lptim_now();
+  leave_critical_section(flags);
+
+  stm32l4_lptim_ticks2ts(now, ts);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: up_alarm_cancel
+ *
+ * Description:
+ *   Cancel the alarm and return the time of cancellation of the alarm.
+ *   nxsched_alarm_expiration() will not be called unless the alarm is
+ *   restarted with up_alarm_start().
+ *
+ *   CMP is left as it is; a stale compare match is discarded by the
+ *   interrupt handler, which then parks CMP.
+ *
+ * Input Parameters:
+ *   ts - Location to return the current time.  ts may be NULL.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.
+ *
+ ****************************************************************************/
+
+int up_alarm_cancel(struct timespec *ts)
+{
+  irqstate_t flags;
+  uint64_t now;
+
+  flags = enter_critical_section();
+
+  g_tickless.armed = false;
+  now = stm32l4_lptim_now();
+
+  leave_critical_section(flags);
+
+  if (ts != NULL)
+    {
+      stm32l4_lptim_ticks2ts(now, ts);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: up_alarm_start
+ *
+ * Description:
+ *   Start the alarm.  nxsched_alarm_expiration() will be called when the
+ *   alarm occurs (unless up_alarm_cancel is called to stop it).
+ *
+ * Input Parameters:
+ *   ts - The time in the future at the alarm is expected to occur.  When
+ *        the alarm occurs the timer logic will call
+ *        nxsched_alarm_expiration().
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.
+ *
+ ****************************************************************************/
+
+int up_alarm_start(const struct timespec *ts)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  g_tickless.alarm = stm32l4_lptim_ts2ticks(ts);
+  g_tickless.armed = true;
+  stm32l4_lptim_prepare();
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4_tickless_remaining
+ *
+ * Description:
+ *   Return the time until the pending alarm expires.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The time remaining in microseconds; zero if the alarm is already due
+ *   and UINT32_MAX if no alarm is pending (or it is further away than
+ *   that).
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+uint32_t stm32l4_tickless_remaining(void)
+{
+  uint64_t delta;
+  uint64_t sec;
+  uint64_t now;
+
+  if (!g_tickless.armed)
+    {
+      return UINT32_MAX;
+    }
+
+  now = stm32l4_lptim_now();
+  if (g_tickless.alarm <= now)
+    {
+      return 0;
+    }
+
+  delta = g_tickless.alarm - now;
+  sec   = delta / LPTIM_FREQUENCY;
+  if (sec >= UINT32_MAX / USEC_PER_SEC)
+    {
+      return UINT32_MAX;
+    }
+
+  return (uint32_t)(sec * USEC_PER_SEC +
+                    (delta % LPTIM_FREQUENCY) * USEC_PER_SEC /
+                    LPTIM_FREQUENCY);
+}
+
+/****************************************************************************
+ * Name: stm32l4_tickless_wakeahead
+ *
+ * Description:
+ *   Make the pending alarm interrupt fire 'usec' microseconds early, so
+ *   that a low power mode with that wakeup latency has been left by the
+ *   time the alarm is due.  The early interrupt does not expire the alarm;
+ *   it is reprogrammed for the exact time.  Call again with zero before
+ *   interrupts are re-enabled after wakeup.
+ *
+ * Input Parameters:
+ *   usec - The wakeup lead in microseconds.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void stm32l4_tickless_wakeahead(uint32_t usec)
+{
+  g_tickless.lead = (uint32_t)(((uint64_t)usec * LPTIM_FREQUENCY +
+                                USEC_PER_SEC - 1) / USEC_PER_SEC);
+
+  if (g_tickless.armed)
+    {
+      stm32l4_lptim_prepare();
+    }
+}
+
+#endif /* CONFIG_STM32L4_TICKLESS_LPTIM */
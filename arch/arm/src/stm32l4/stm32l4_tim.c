@@ -39,6 +39,7 @@
 #include "arm_internal.h"
 #include "stm32l4.h"
 #include "stm32l4_gpio.h"
+#include "stm32l4_dvfs.h"
 #include "stm32l4_tim.h"
 
 /****************************************************************************
@@ -210,6 +211,10 @@ struct stm32l4_tim_priv_s
   const struct stm32l4_tim_ops_s *ops;
   enum stm32l4_tim_mode_e mode;
   uint32_t base;                      /* TIMn base address */
+#ifdef CONFIG_STM32L4_DVFS
+  uint32_t freq;                      /* Last setfreq/setclock request */
+  bool clock;                         /* 'freq' is a counter clock */
+#endif
 };
 
 /****************************************************************************
@@ -276,6 +281,17 @@ static void stm32l4_tim_ackint(struct stm32l4_tim_dev_s *dev,
                                int source);
 static int stm32l4_tim_checkint(struct stm32l4_tim_dev_s *dev,
                                 int source);
+static void stm32l4_tim_enabledma(struct stm32l4_tim_dev_s *dev,
+                                  int source);
+static void stm32l4_tim_disabledma(struct stm32l4_tim_dev_s *dev,
+                                   int source);
+
+/* DVFS support */
+
+#ifdef CONFIG_STM32L4_DVFS
+static void stm32l4_tim_dvfsnotify(struct stm32l4_dvfs_callback_s *cb,
+                                   uint32_t sysclk);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -300,6 +316,8 @@ static const struct stm32l4_tim_ops_s stm32l4_tim_ops =
   .disableint = stm32l4_tim_disableint,
   .ackint     = stm32l4_tim_ackint,
   .checkint   = stm32l4_tim_checkint,
+  .enabledma  = stm32l4_tim_enabledma,
+  .disabledma = stm32l4_tim_disabledma,
   .dump_regs  = stm32l4_tim_dumpregs,
 };
 
@@ -401,6 +419,54 @@ struct stm32l4_tim_priv_s stm32l4_tim17_priv =
 };
 #endif
 
+#ifdef CONFIG_STM32L4_DVFS
+/* All timers, to be reprogrammed when SYSCLK changes */
+
+static struct stm32l4_tim_priv_s * const g_tim_devs[] =
+{
+#ifdef CONFIG_STM32L4_TIM1
+  &stm32l4_tim1_priv,
+#endif
+#ifdef CONFIG_STM32L4_TIM2
+  &stm32l4_tim2_priv,
+#endif
+#ifdef CONFIG_STM32L4_TIM3
+  &stm32l4_tim3_priv,
+#endif
+#ifdef CONFIG_STM32L4_TIM4
+  &stm32l4_tim4_priv,
+#endif
+#ifdef CONFIG_STM32L4_TIM5
+  &stm32l4_tim5_priv,
+#endif
+#ifdef CONFIG_STM32L4_TIM6
+  &stm32l4_tim6_priv,
+#endif
+#ifdef CONFIG_STM32L4_TIM7
+  &stm32l4_tim7_priv,
+#endif
+#ifdef CONFIG_STM32L4_TIM8
+  &stm32l4_tim8_priv,
+#endif
+#ifdef CONFIG_STM32L4_TIM15
+  &stm32l4_tim15_priv,
+#endif
+#ifdef CONFIG_STM32L4_TIM16
+  &stm32l4_tim16_priv,
+#endif
+#ifdef CONFIG_STM32L4_TIM17
+  &stm32l4_tim17_priv,
+#endif
+};
+
+static struct stm32l4_dvfs_callback_s g_tim_dvfs =
+{
+  .notify = stm32l4_tim_dvfsnotify,
+};
+
+static bool g_tim_dvfsregistered;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -695,6 +761,13 @@ static int stm32l4_tim_setfreq(struct stm32l4_tim_dev_s *dev,
 
   DEBUGASSERT(dev != NULL);
 
+#ifdef CONFIG_STM32L4_DVFS
+  /* Remember the request to redo it when SYSCLK changes */
+
+  ((struct stm32l4_tim_priv_s *)dev)->freq  = freq;
+  ((struct stm32l4_tim_priv_s *)dev)->clock = false;
+#endif
+
   /* Disable Timer? */
 
   if (freq == 0)
@@ -780,6 +853,10 @@ static int stm32l4_tim_setfreq(struct stm32l4_tim_dev_s *dev,
         return -EINVAL;
     }
 
+  /* The input clock follows the DVFS performance level */
+
+  freqin = stm32l4_dvfs_scale(freqin);
+
   /* Select a pre-scaler value for this timer using the input clock
    * frequency.
    *
@@ -854,6 +931,13 @@ static int stm32l4_tim_setclock(struct stm32l4_tim_dev_s *dev,
 
   DEBUGASSERT(dev != NULL);
 
+#ifdef CONFIG_STM32L4_DVFS
+  /* Remember the request to redo it when SYSCLK changes */
+
+  ((struct stm32l4_tim_priv_s *)dev)->freq  = freq;
+  ((struct stm32l4_tim_priv_s *)dev)->clock = true;
+#endif
+
   /* Disable Timer? */
 
   if (freq == 0)
@@ -939,6 +1023,10 @@ static int stm32l4_tim_setclock(struct stm32l4_tim_dev_s *dev,
         return -EINVAL;
     }
 
+  /* The input clock follows the DVFS performance level */
+
+  freqin = stm32l4_dvfs_scale(freqin);
+
   /* Select a pre-scaler value for this timer using the input clock
    * frequency.
    */
@@ -1050,6 +1138,8 @@ static uint32_t stm32l4_tim_getclock(struct stm32l4_tim_dev_s *dev)
         return -EINVAL;
     }
 
+  freqin = stm32l4_dvfs_scale(freqin);
+
   /* From chip datasheet, at page 1179. */
 
   clock = freqin / (stm32l4_getreg16(dev, STM32L4_GTIM_PSC_OFFSET) + 1);
@@ -1157,19 +1247,27 @@ static int stm32l4_tim_setchannel(struct stm32l4_tim_dev_s *dev,
 
   /* Decode configuration */
 
-  switch (mode & STM32L4_TIM_CH_MODE_MASK)
+  if (mode & STM32L4_TIM_CH_INCAPTURE)
     {
-      case STM32L4_TIM_CH_DISABLED:
-        break;
-
-      case STM32L4_TIM_CH_OUTPWM:
-        ccmr_val  =  (GTIM_CCMR_MODE_PWM1 << GTIM_CCMR1_OC1M_SHIFT) +
-                     GTIM_CCMR1_OC1PE;
-        ccer_val |= GTIM_CCER_CC1E << GTIM_CCER_CCXBASE(channel);
-        break;
-
-      default:
-        return -EINVAL;
+      ccmr_val  = GTIM_CCMR_CCS_CCIN1 << GTIM_CCMR1_CC1S_SHIFT;
+      ccer_val |= GTIM_CCER_CC1E << GTIM_CCER_CCXBASE(channel);
+    }
+  else
+    {
+      switch (mode & STM32L4_TIM_CH_MODE_MASK)
+        {
+          case STM32L4_TIM_CH_DISABLED:
+            break;
+
+          case STM32L4_TIM_CH_OUTPWM:
+            ccmr_val  =  (GTIM_CCMR_MODE_PWM1 << GTIM_CCMR1_OC1M_SHIFT) +
+                         GTIM_CCMR1_OC1PE;
+            ccer_val |= GTIM_CCER_CC1E << GTIM_CCER_CCXBASE(channel);
+            break;
+
+          default:
+            return -EINVAL;
+        }
     }
 
   /* Set polarity */
@@ -1198,6 +1296,15 @@ static int stm32l4_tim_setchannel(struct stm32l4_tim_dev_s *dev,
   stm32l4_putreg16(dev, ccmr_offset, ccmr_orig);
   stm32l4_putreg16(dev, STM32L4_GTIM_CCER_OFFSET, ccer_val);
 
+  /* The pin of an input is one of several alternatives, left to the
+   * caller.
+   */
+
+  if (mode & STM32L4_TIM_CH_INCAPTURE)
+    {
+      return OK;
+    }
+
   /* set GPIO */
 
   switch (((struct stm32l4_tim_priv_s *)dev)->base)
@@ -1577,13 +1684,13 @@ static int stm32l4_tim_setisr(struct stm32l4_tim_dev_s *dev,
   int vectorno;
 
   DEBUGASSERT(dev != NULL);
-  DEBUGASSERT(source == 0);
+  DEBUGASSERT(source >= 0 && source <= 4);
 
   switch (((struct stm32l4_tim_priv_s *)dev)->base)
     {
 #ifdef CONFIG_STM32L4_TIM1
       case STM32L4_TIM1_BASE:
-        vectorno = STM32L4_IRQ_TIM1UP;
+        vectorno = source ? STM32L4_IRQ_TIM1CC : STM32L4_IRQ_TIM1UP;
         break;
 #endif
 
@@ -1624,7 +1731,7 @@ static int stm32l4_tim_setisr(struct stm32l4_tim_dev_s *dev,
 
 #ifdef CONFIG_STM32L4_TIM8
       case STM32L4_TIM8_BASE:
-        vectorno = STM32L4_IRQ_TIM8UP;
+        vectorno = source ? STM32L4_IRQ_TIM8CC : STM32L4_IRQ_TIM8UP;
         break;
 #endif
 
@@ -1674,7 +1781,8 @@ static void stm32l4_tim_enableint(struct stm32l4_tim_dev_s *dev,
                                   int source)
 {
   DEBUGASSERT(dev != NULL);
-  stm32l4_modifyreg16(dev, STM32L4_GTIM_DIER_OFFSET, 0, GTIM_DIER_UIE);
+  stm32l4_modifyreg16(dev, STM32L4_GTIM_DIER_OFFSET, 0,
+                      GTIM_DIER_UIE << source);
 }
 
 /****************************************************************************
@@ -1685,7 +1793,8 @@ static void stm32l4_tim_disableint(struct stm32l4_tim_dev_s *dev,
                                    int source)
 {
   DEBUGASSERT(dev != NULL);
-  stm32l4_modifyreg16(dev, STM32L4_GTIM_DIER_OFFSET, GTIM_DIER_UIE, 0);
+  stm32l4_modifyreg16(dev, STM32L4_GTIM_DIER_OFFSET,
+                      GTIM_DIER_UIE << source, 0);
 }
 
 /****************************************************************************
@@ -1694,7 +1803,7 @@ static void stm32l4_tim_disableint(struct stm32l4_tim_dev_s *dev,
 
 static void stm32l4_tim_ackint(struct stm32l4_tim_dev_s *dev, int source)
 {
-  stm32l4_putreg16(dev, STM32L4_GTIM_SR_OFFSET, ~GTIM_SR_UIF);
+  stm32l4_putreg16(dev, STM32L4_GTIM_SR_OFFSET, ~(GTIM_SR_UIF << source));
 }
 
 /****************************************************************************
@@ -1705,8 +1814,70 @@ static int stm32l4_tim_checkint(struct stm32l4_tim_dev_s *dev,
                                 int source)
 {
   uint16_t regval = stm32l4_getreg16(dev, STM32L4_GTIM_SR_OFFSET);
-  return (regval & GTIM_SR_UIF) ? 1 : 0;
+  return (regval & (GTIM_SR_UIF << source)) ? 1 : 0;
+}
+
+/****************************************************************************
+ * Name: stm32l4_tim_enabledma
+ ****************************************************************************/
+
+static void stm32l4_tim_enabledma(struct stm32l4_tim_dev_s *dev,
+                                  int source)
+{
+  DEBUGASSERT(dev != NULL && source >= 0 && source <= 4);
+  stm32l4_modifyreg16(dev, STM32L4_GTIM_DIER_OFFSET, 0,
+                      GTIM_DIER_UDE << source);
+}
+
+/****************************************************************************
+ * Name: stm32l4_tim_disabledma
+ ****************************************************************************/
+
+static void stm32l4_tim_disabledma(struct stm32l4_tim_dev_s *dev,
+                                   int source)
+{
+  DEBUGASSERT(dev != NULL && source >= 0 && source <= 4);
+  stm32l4_modifyreg16(dev, STM32L4_GTIM_DIER_OFFSET,
+                      GTIM_DIER_UDE << source, 0);
+}
+
+/****************************************************************************
+ * Name: stm32l4_tim_dvfsnotify
+ *
+ * Description:
+ *   Recompute the prescaler (and the reload value, for setfreq()) of every
+ *   timer in use for the new timer input clocks.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_DVFS
+static void stm32l4_tim_dvfsnotify(struct stm32l4_dvfs_callback_s *cb,
+                                   uint32_t sysclk)
+{
+  struct stm32l4_tim_priv_s *priv;
+  unsigned int i;
+
+  for (i = 0; i < sizeof(g_tim_devs) / sizeof(g_tim_devs[0]); i++)
+    {
+      priv = g_tim_devs[i];
+
+      if (priv->freq == 0)
+        {
+          continue;
+        }
+
+      if (priv->clock)
+        {
+          stm32l4_tim_setclock((struct stm32l4_tim_dev_s *)priv,
+                               priv->freq);
+        }
+      else
+        {
+          stm32l4_tim_setfreq((struct stm32l4_tim_dev_s *)priv, priv->freq);
+        }
+    }
 }
+#endif
 
 /****************************************************************************
  * Pubic Functions
@@ -1720,6 +1891,16 @@ struct stm32l4_tim_dev_s *stm32l4_tim_init(int timer)
 {
   struct stm32l4_tim_dev_s *dev = NULL;
 
+#ifdef CONFIG_STM32L4_DVFS
+  /* Register to follow timer clock frequency changes */
+
+  if (!g_tim_dvfsregistered)
+    {
+      stm32l4_dvfs_register(&g_tim_dvfs);
+      g_tim_dvfsregistered = true;
+    }
+#endif
+
   /* Get structure and enable power */
 
   switch (timer)
@@ -1827,6 +2008,10 @@ int stm32l4_tim_deinit(struct stm32l4_tim_dev_s *dev)
 {
   DEBUGASSERT(dev != NULL);
 
+#ifdef CONFIG_STM32L4_DVFS
+  ((struct stm32l4_tim_priv_s *)dev)->freq = 0;
+#endif
+
   /* Disable power */
 
   switch (((struct stm32l4_tim_priv_s *)dev)->base)
@@ -51,6 +51,8 @@
 #define STM32L4_TIM_DISABLEINT(d,s)       ((d)->ops->disableint(d,s))
 #define STM32L4_TIM_ACKINT(d,s)           ((d)->ops->ackint(d,s))
 #define STM32L4_TIM_CHECKINT(d,s)         ((d)->ops->checkint(d,s))
+#define STM32L4_TIM_ENABLEDMA(d,s)        ((d)->ops->enabledma(d,s))
+#define STM32L4_TIM_DISABLEDMA(d,s)       ((d)->ops->disabledma(d,s))
 #define STM32L4_TIM_ENABLE(d)             ((d)->ops->enable(d))
 #define STM32L4_TIM_DISABLE(d)            ((d)->ops->disable(d))
 #define STM32L4_TIM_DUMPREGS(d)           ((d)->ops->dump_regs(d))
@@ -138,10 +140,16 @@ enum stm32l4_tim_channel_e
   STM32L4_TIM_CH_OUTCOMPARE     = 0x06,
 #endif
 
+  /* Input Capture Modes: the counter is latched on the rising (or, with
+   * POLARITY_NEG, falling) edges of the channel input.  The caller
+   * configures the pin.
+   */
+
+  STM32L4_TIM_CH_INCAPTURE      = 0x10,
+
   /* TODO other modes ... as PWM capture, ENCODER and Hall Sensor */
 
 #if 0
-  STM32L4_TIM_CH_INCAPTURE      = 0x10,
   STM32L4_TIM_CH_INPWM          = 0x20
   STM32L4_TIM_CH_DRIVE_OC       = open collector mode
 #endif
@@ -172,7 +180,9 @@ struct stm32l4_tim_ops_s
                      uint32_t compare);
   int  (*getcapture)(struct stm32l4_tim_dev_s *dev, uint8_t channel);
 
-  /* Timer interrupts */
+  /* Timer interrupts.  Source 0 is the update (overflow) interrupt and
+   * sources 1-4 the capture/compare interrupts of channels 1-4.
+   */
 
   int  (*setisr)(struct stm32l4_tim_dev_s *dev,
                  xcpt_t handler, void *arg, int source);
@@ -181,6 +191,13 @@ struct stm32l4_tim_ops_s
   void (*ackint)(struct stm32l4_tim_dev_s *dev, int source);
   int  (*checkint)(struct stm32l4_tim_dev_s *dev, int source);
 
+  /* DMA requests, with the same sources as the interrupts: the update or a
+   * capture/compare event of channels 1-4 triggers one transfer.
+   */
+
+  void (*enabledma)(struct stm32l4_tim_dev_s *dev, int source);
+  void (*disabledma)(struct stm32l4_tim_dev_s *dev, int source);
+
   /* Debug */
 
   void (*dump_regs)(struct stm32l4_tim_dev_s *dev);
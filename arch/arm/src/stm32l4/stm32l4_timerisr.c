@@ -35,6 +35,7 @@
 #include "arm_internal.h"
 #include "chip.h"
 #include "stm32l4.h"
+#include "stm32l4_dvfs.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -68,6 +69,26 @@
 #  error SYSTICK_RELOAD exceeds the range of the RELOAD register
 #endif
 
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_DVFS
+static void stm32l4_timer_dvfsnotify(struct stm32l4_dvfs_callback_s *cb,
+                                     uint32_t sysclk);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_DVFS
+static struct stm32l4_dvfs_callback_s g_timer_dvfs =
+{
+  .notify = stm32l4_timer_dvfsnotify,
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -81,7 +102,8 @@
  *
  ****************************************************************************/
 
-static int stm32l4_timerisr(int irq, uint32_t *regs, void *arg)
+isr_ramfunc static int stm32l4_timerisr(int irq, uint32_t *regs,
+                                        void *arg)
 {
   /* Process timer interrupt */
 
@@ -89,6 +111,24 @@ static int stm32l4_timerisr(int irq, uint32_t *regs, void *arg)
   return 0;
 }
 
+/****************************************************************************
+ * Function:  stm32l4_timer_dvfsnotify
+ *
+ * Description:
+ *   Rescale the SysTick reload value to the new HCLK frequency.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32L4_DVFS
+static void stm32l4_timer_dvfsnotify(struct stm32l4_dvfs_callback_s *cb,
+                                     uint32_t sysclk)
+{
+  /* The new value takes effect when the current tick ends */
+
+  putreg32(stm32l4_dvfs_scale(SYSTICK_RELOAD + 1) - 1, NVIC_SYSTICK_RELOAD);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -133,6 +173,12 @@ void up_timer_initialize(void)
 
   irq_attach(STM32L4_IRQ_SYSTICK, (xcpt_t)stm32l4_timerisr, NULL);
 
+#ifdef CONFIG_STM32L4_DVFS
+  /* Follow HCLK frequency changes */
+
+  stm32l4_dvfs_register(&g_timer_dvfs);
+#endif
+
   /* Enable SysTick interrupts */
 
   putreg32((NVIC_SYSTICK_CTRL_CLKSOURCE | NVIC_SYSTICK_CTRL_TICKINT |
@@ -171,32 +171,44 @@
 #  undef CONFIG_USART3_RXDMA
 #  undef CONFIG_UART4_RXDMA
 #  undef CONFIG_UART5_RXDMA
+#  undef CONFIG_LPUART1_TXDMA
+#  undef CONFIG_USART1_TXDMA
+#  undef CONFIG_USART2_TXDMA
+#  undef CONFIG_USART3_TXDMA
+#  undef CONFIG_UART4_TXDMA
+#  undef CONFIG_UART5_TXDMA
 #endif
 
 /* Disable the DMA configuration on all unused USARTs */
 
 #ifndef CONFIG_STM32L4_LPUART1_SERIALDRIVER
 #  undef CONFIG_LPUART1_RXDMA
+#  undef CONFIG_LPUART1_TXDMA
 #endif
 
 #ifndef CONFIG_STM32L4_USART1_SERIALDRIVER
 #  undef CONFIG_USART1_RXDMA
+#  undef CONFIG_USART1_TXDMA
 #endif
 
 #ifndef CONFIG_STM32L4_USART2_SERIALDRIVER
 #  undef CONFIG_USART2_RXDMA
+#  undef CONFIG_USART2_TXDMA
 #endif
 
 #ifndef CONFIG_STM32L4_USART3_SERIALDRIVER
 #  undef CONFIG_USART3_RXDMA
+#  undef CONFIG_USART3_TXDMA
 #endif
 
 #ifndef CONFIG_STM32L4_UART4_SERIALDRIVER
 #  undef CONFIG_UART4_RXDMA
+#  undef CONFIG_UART4_TXDMA
 #endif
 
 #ifndef CONFIG_STM32L4_UART5_SERIALDRIVER
 #  undef CONFIG_UART5_RXDMA
+#  undef CONFIG_UART5_TXDMA
 #endif
 
 /* Is DMA available on any (enabled) USART? */
@@ -208,24 +220,120 @@
 #  define SERIAL_HAVE_RXDMA 1
 #endif
 
+/* Is Tx DMA available on any (enabled) USART? */
+
+#undef SERIAL_HAVE_TXDMA
+#if defined(CONFIG_LPUART1_TXDMA) || defined(CONFIG_USART1_TXDMA) || \
+    defined(CONFIG_USART2_TXDMA)  || defined(CONFIG_USART3_TXDMA) || \
+    defined(CONFIG_UART4_TXDMA)   || defined(CONFIG_UART5_TXDMA)
+#  define SERIAL_HAVE_TXDMA 1
+#endif
+
+/* Which combinations of Rx and Tx DMA are in use?  One set of serial
+ * operations is built for each combination.
+ */
+
+#undef SERIAL_HAVE_NODMA_OPS
+#undef SERIAL_HAVE_RXDMA_OPS
+#undef SERIAL_HAVE_TXDMA_OPS
+#undef SERIAL_HAVE_RXTXDMA_OPS
+
+#ifdef CONFIG_STM32L4_LPUART1_SERIALDRIVER
+#  if defined(CONFIG_LPUART1_RXDMA) && defined(CONFIG_LPUART1_TXDMA)
+#    define SERIAL_HAVE_RXTXDMA_OPS 1
+#  elif defined(CONFIG_LPUART1_RXDMA)
+#    define SERIAL_HAVE_RXDMA_OPS 1
+#  elif defined(CONFIG_LPUART1_TXDMA)
+#    define SERIAL_HAVE_TXDMA_OPS 1
+#  else
+#    define SERIAL_HAVE_NODMA_OPS 1
+#  endif
+#endif
+
+#ifdef CONFIG_STM32L4_USART1_SERIALDRIVER
+#  if defined(CONFIG_USART1_RXDMA) && defined(CONFIG_USART1_TXDMA)
+#    define SERIAL_HAVE_RXTXDMA_OPS 1
+#  elif defined(CONFIG_USART1_RXDMA)
+#    define SERIAL_HAVE_RXDMA_OPS 1
+#  elif defined(CONFIG_USART1_TXDMA)
+#    define SERIAL_HAVE_TXDMA_OPS 1
+#  else
+#    define SERIAL_HAVE_NODMA_OPS 1
+#  endif
+#endif
+
+#ifdef CONFIG_STM32L4_USART2_SERIALDRIVER
+#  if defined(CONFIG_USART2_RXDMA) && defined(CONFIG_USART2_TXDMA)
+#    define SERIAL_HAVE_RXTXDMA_OPS 1
+#  elif defined(CONFIG_USART2_RXDMA)
+#    define SERIAL_HAVE_RXDMA_OPS 1
+#  elif defined(CONFIG_USART2_TXDMA)
+#    define SERIAL_HAVE_TXDMA_OPS 1
+#  else
+#    define SERIAL_HAVE_NODMA_OPS 1
+#  endif
+#endif
+
+#ifdef CONFIG_STM32L4_USART3_SERIALDRIVER
+#  if defined(CONFIG_USART3_RXDMA) && defined(CONFIG_USART3_TXDMA)
+#    define SERIAL_HAVE_RXTXDMA_OPS 1
+#  elif defined(CONFIG_USART3_RXDMA)
+#    define SERIAL_HAVE_RXDMA_OPS 1
+#  elif defined(CONFIG_USART3_TXDMA)
+#    define SERIAL_HAVE_TXDMA_OPS 1
+#  else
+#    define SERIAL_HAVE_NODMA_OPS 1
+#  endif
+#endif
+
+#ifdef CONFIG_STM32L4_UART4_SERIALDRIVER
+#  if defined(CONFIG_UART4_RXDMA) && defined(CONFIG_UART4_TXDMA)
+#    define SERIAL_HAVE_RXTXDMA_OPS 1
+#  elif defined(CONFIG_UART4_RXDMA)
+#    define SERIAL_HAVE_RXDMA_OPS 1
+#  elif defined(CONFIG_UART4_TXDMA)
+#    define SERIAL_HAVE_TXDMA_OPS 1
+#  else
+#    define SERIAL_HAVE_NODMA_OPS 1
+#  endif
+#endif
+
+#ifdef CONFIG_STM32L4_UART5_SERIALDRIVER
+#  if defined(CONFIG_UART5_RXDMA) && defined(CONFIG_UART5_TXDMA)
+#    define SERIAL_HAVE_RXTXDMA_OPS 1
+#  elif defined(CONFIG_UART5_RXDMA)
+#    define SERIAL_HAVE_RXDMA_OPS 1
+#  elif defined(CONFIG_UART5_TXDMA)
+#    define SERIAL_HAVE_TXDMA_OPS 1
+#  else
+#    define SERIAL_HAVE_NODMA_OPS 1
+#  endif
+#endif
+
 /* Is DMA used on the console UART? */
 
 #undef SERIAL_HAVE_CONSOLE_DMA
-#if defined(CONFIG_LPUART1_SERIAL_CONSOLE) && defined(CONFIG_LPUART1_RXDMA)
+#if defined(CONFIG_LPUART1_SERIAL_CONSOLE) && \
+    (defined(CONFIG_LPUART1_RXDMA) || defined(CONFIG_LPUART1_TXDMA))
 #  define SERIAL_HAVE_CONSOLE_DMA 1
-#elif defined(CONFIG_USART1_SERIAL_CONSOLE) && defined(CONFIG_USART1_RXDMA)
+#elif defined(CONFIG_USART1_SERIAL_CONSOLE) && \
+    (defined(CONFIG_USART1_RXDMA) || defined(CONFIG_USART1_TXDMA))
 #  define SERIAL_HAVE_CONSOLE_DMA 1
-#elif defined(CONFIG_USART2_SERIAL_CONSOLE) && defined(CONFIG_USART2_RXDMA)
+#elif defined(CONFIG_USART2_SERIAL_CONSOLE) && \
+    (defined(CONFIG_USART2_RXDMA) || defined(CONFIG_USART2_TXDMA))
 #  define SERIAL_HAVE_CONSOLE_DMA 1
-#elif defined(CONFIG_USART3_SERIAL_CONSOLE) && defined(CONFIG_USART3_RXDMA)
+#elif defined(CONFIG_USART3_SERIAL_CONSOLE) && \
+    (defined(CONFIG_USART3_RXDMA) || defined(CONFIG_USART3_TXDMA))
 #  define SERIAL_HAVE_CONSOLE_DMA 1
-#elif defined(CONFIG_UART4_SERIAL_CONSOLE) && defined(CONFIG_UART4_RXDMA)
+#elif defined(CONFIG_UART4_SERIAL_CONSOLE) && \
+    (defined(CONFIG_UART4_RXDMA) || defined(CONFIG_UART4_TXDMA))
 #  define SERIAL_HAVE_CONSOLE_DMA 1
-#elif defined(CONFIG_UART5_SERIAL_CONSOLE) && defined(CONFIG_UART5_RXDMA)
+#elif defined(CONFIG_UART5_SERIAL_CONSOLE) && \
+    (defined(CONFIG_UART5_RXDMA) || defined(CONFIG_UART5_TXDMA))
 #  define SERIAL_HAVE_CONSOLE_DMA 1
 #endif
 
-/* Is DMA used on all (enabled) USARTs */
+/* Is Rx DMA used on all (enabled) USARTs */
 
 #define SERIAL_HAVE_ONLY_DMA 1
 #if defined(CONFIG_STM32L4_LPUART1_SERIALDRIVER) && !defined(CONFIG_LPUART1_RXDMA)
@@ -250,12 +358,37 @@
 #  define HAVE_RS485 1
 #endif
 
+/* Is RS-485 with hardware driver enable used? */
+
+#if defined(CONFIG_LPUART1_RS485_HWDE) || defined(CONFIG_USART1_RS485_HWDE) || \
+    defined(CONFIG_USART2_RS485_HWDE)  || defined(CONFIG_USART3_RS485_HWDE) || \
+    defined(CONFIG_UART4_RS485_HWDE)   || defined(CONFIG_UART5_RS485_HWDE)
+#  define HAVE_RS485_HWDE 1
+#endif
+
+/* Is idle-line driven Rx DMA used? */
+
+#undef SERIAL_HAVE_RXDMA_IDLE
+#if defined(SERIAL_HAVE_RXDMA) && defined(CONFIG_STM32L4_SERIAL_RXDMA_IDLE)
+#  define SERIAL_HAVE_RXDMA_IDLE 1
+#endif
+
 #ifdef HAVE_RS485
-#  define USART_CR1_USED_INTS    (USART_CR1_RXNEIE | USART_CR1_TXEIE | USART_CR1_PEIE | USART_CR1_TCIE)
+#  define USART_CR1_RS485_INTS   USART_CR1_TCIE
+#else
+#  define USART_CR1_RS485_INTS   0
+#endif
+
+#ifdef SERIAL_HAVE_RXDMA_IDLE
+#  define USART_CR1_IDLE_INTS    USART_CR1_IDLEIE
 #else
-#  define USART_CR1_USED_INTS    (USART_CR1_RXNEIE | USART_CR1_TXEIE | USART_CR1_PEIE)
+#  define USART_CR1_IDLE_INTS    0
 #endif
 
+#define USART_CR1_USED_INTS      (USART_CR1_RXNEIE | USART_CR1_TXEIE | \
+                                  USART_CR1_PEIE | USART_CR1_RS485_INTS | \
+                                  USART_CR1_IDLE_INTS)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -39,6 +39,7 @@
 #include "sched/sched.h"
 #include "chip.h"
 #include "stm32l4_dma.h"
+#include "stm32l4_dmamem.h"
 #include "stm32l4.h"
 
 /****************************************************************************
@@ -246,7 +247,8 @@ static void stm32l4_dmachandisable(struct stm32l4_dma_s *dmach)
  *
  ****************************************************************************/
 
-static int stm32l4_dmainterrupt(int irq, void *context, void *arg)
+isr_ramfunc static int stm32l4_dmainterrupt(int irq, void *context,
+                                            void *arg)
 {
   struct stm32l4_dma_s *dmach;
   uint32_t isr;
@@ -334,6 +336,15 @@ void weak_function arm_dma_initialize(void)
 
       up_enable_irq(dmach->irq);
     }
+
+#ifdef CONFIG_STM32L4_DMAMEM
+  /* Set up the pool of DMA buffers shared by the drivers */
+
+  if (stm32l4_dmamem_initialize() < 0)
+    {
+      dmaerr("ERROR: DMA buffer pool not available\n");
+    }
+#endif
 }
 
 /****************************************************************************
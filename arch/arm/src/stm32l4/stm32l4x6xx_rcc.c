@@ -676,12 +676,7 @@ static void stm32l4_stdclockconfig(void)
    * and freq
    */
 
-#ifdef CONFIG_STM32L4_FLASH_PREFETCH
-  regval = (FLASH_ACR_LATENCY_4 | FLASH_ACR_ICEN | FLASH_ACR_DCEN |
-            FLASH_ACR_PRFTEN);
-#else
-  regval = (FLASH_ACR_LATENCY_4 | FLASH_ACR_ICEN | FLASH_ACR_DCEN);
-#endif
+  regval = (FLASH_ACR_LATENCY_4 | STM32L4_FLASH_ACR_ACCEL);
   putreg32(regval, STM32L4_FLASH_ACR);
 
   /* Wait until the requested number of wait states is set */
@@ -38,6 +38,8 @@
 #include "arm_internal.h"
 #include "sched/sched.h"
 #include "stm32l4_dma.h"
+#include "stm32l4_dmamem.h"
+#include "stm32l4.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -106,12 +108,18 @@ struct stm32l4_dmach_s
 {
   bool             used;         /* Channel in use */
   uint8_t          dmamux_req;   /* Configured DMAMUX input request */
+  uint32_t         dmamux_sync;  /* DMAMUX synchronization settings */
   uint8_t          ctrl;         /* DMA controller */
   uint8_t          chan;         /* DMA channel channel id */
   uint8_t          irq;          /* DMA channel IRQ number */
   uint8_t          shift;        /* IFCR bit shift value */
   uint32_t         base;         /* DMA register channel base address */
+  uint16_t         halfsize;     /* Transfers per half buffer (0 = single) */
   dma_callback_t   callback;     /* Callback invoked when the DMA completes */
+  dma_dblcallback_t dblcallback; /* Callback invoked in double-buffer mode */
+  const struct iovec *sgiov;     /* Next segment of a scatter-gather list */
+  uint8_t          sgleft;       /* Segments left after the current one */
+  uint8_t          sgshift;      /* log2 of the memory transfer size */
   void             *arg;         /* Argument passed to callback function */
 };
 
@@ -173,6 +181,8 @@ static void stm32l4_dma12_setup(DMA_HANDLE handle, uint32_t paddr,
 static void stm32l4_dma12_start(DMA_HANDLE handle, dma_callback_t callback,
                                 void *arg, bool half);
 static size_t stm32l4_dma12_residual(DMA_HANDLE handle);
+static unsigned int stm32l4_dma12_current(DMA_CHANNEL dmachan);
+static void stm32l4_dma12_sgnext(DMA_CHANNEL dmachan);
 #ifdef CONFIG_DEBUG_DMA_INFO
 static void stm32l4_dma12_sample(DMA_HANDLE handle,
                                  struct stm32l4_dmaregs_s *regs);
@@ -190,8 +200,8 @@ static uint32_t dmachan_getreg(DMA_CHANNEL dmachan, uint32_t offset);
 static void dmachan_putreg(DMA_CHANNEL dmachan, uint32_t offset,
                            uint32_t value);
 static void dmamux_putreg(DMA_MUX dmamux, uint32_t offset, uint32_t value);
-#ifdef CONFIG_DEBUG_DMA_INFO
 static uint32_t dmamux_getreg(DMA_MUX dmamux, uint32_t offset);
+#ifdef CONFIG_DEBUG_DMA_INFO
 static void stm32l4_dmamux_sample(DMA_MUX dmamux, uint8_t chan,
                                   struct stm32l4_dmaregs_s *regs);
 static void stm32l4_dmamux_dump(DMA_MUX dmamux, uint8_t channel,
@@ -262,6 +272,10 @@ static const struct stm32l4_dmamux_s g_dmamux[DMAMUX_NUM] =
     }
 };
 
+/* Request generators claimed by stm32l4_dmamux_reqgen_start() */
+
+static uint8_t g_reqgen_busy;
+
 /* This array describes the state of each controller */
 
 static const struct stm32l4_dma_s g_dma[DMA_NCHANNELS] =
@@ -514,12 +528,10 @@ static void dmamux_putreg(DMA_MUX dmamux, uint32_t offset, uint32_t value)
  *
  ****************************************************************************/
 
-#ifdef CONFIG_DEBUG_DMA_INFO
 static uint32_t dmamux_getreg(DMA_MUX dmamux, uint32_t offset)
 {
   return getreg32(dmamux->base + offset);
 }
-#endif
 
 /****************************************************************************
  * Name: stm32l4_dma_channel_get
@@ -609,7 +621,8 @@ static void stm32l4_dma12_disable(DMA_CHANNEL dmachan)
  *
  ****************************************************************************/
 
-static int stm32l4_dma12_interrupt(int irq, void *context, void *arg)
+isr_ramfunc static int stm32l4_dma12_interrupt(int irq, void *context,
+                                               void *arg)
 {
   DMA_CHANNEL dmachan;
   uint32_t isr;
@@ -655,9 +668,33 @@ static int stm32l4_dma12_interrupt(int irq, void *context, void *arg)
   isr = dmabase_getreg(dmachan, STM32L4_DMA_ISR_OFFSET) &
         DMA_ISR_CHAN_MASK(dmachan->chan);
 
-  /* Invoke the callback */
+  /* In scatter-gather mode, a segment that completed without error is
+   * followed by the next one; the callback only sees the end of the list.
+   */
+
+  if (dmachan->sgleft > 0 &&
+      (isr & DMA_ISR_TCIF(dmachan->chan)) != 0 &&
+      (isr & DMA_ISR_TEIF(dmachan->chan)) == 0)
+    {
+      dmabase_putreg(dmachan, STM32L4_DMA_IFCR_OFFSET, isr);
+      stm32l4_dma12_sgnext(dmachan);
+      return OK;
+    }
+
+  /* Invoke the callback.  In double-buffer mode, the half that is ready
+   * is always the one that the DMA is not currently filling.  This remains
+   * true even if the interrupt was serviced so late that both the HTIF and
+   * TCIF flags are set; the caller can detect that overrun from status.
+   */
 
-  if (dmachan->callback)
+  if (dmachan->dblcallback)
+    {
+      dmachan->dblcallback(dmachan,
+                           isr >> DMA_ISR_CHAN_SHIFT(dmachan->chan),
+                           1 - stm32l4_dma12_current(dmachan),
+                           dmachan->arg);
+    }
+  else if (dmachan->callback)
     {
       dmachan->callback(dmachan, isr >> DMA_ISR_CHAN_SHIFT(dmachan->chan),
                         dmachan->arg);
@@ -817,6 +854,49 @@ static size_t stm32l4_dma12_residual(DMA_HANDLE handle)
   return dmachan_getreg(dmachan, STM32L4_DMACHAN_CNDTR_OFFSET);
 }
 
+/****************************************************************************
+ * Name: stm32l4_dma12_current
+ *
+ * Description:
+ *   Return the half buffer (0 or 1) that a double-buffered channel is
+ *   currently transferring.  CNDTR counts down from twice the half size
+ *   and is reloaded when the transfer wraps.
+ *
+ ****************************************************************************/
+
+static unsigned int stm32l4_dma12_current(DMA_CHANNEL dmachan)
+{
+  uint32_t cndtr = dmachan_getreg(dmachan, STM32L4_DMACHAN_CNDTR_OFFSET);
+
+  return cndtr > dmachan->halfsize ? 0 : 1;
+}
+
+/****************************************************************************
+ * Name: stm32l4_dma12_sgnext
+ *
+ * Description:
+ *   Restart a channel on the next segment of its scatter-gather list.
+ *   CMAR and CNDTR can only be written while the channel is disabled; the
+ *   peripheral keeps its request asserted meanwhile, so no data is lost.
+ *
+ ****************************************************************************/
+
+static void stm32l4_dma12_sgnext(DMA_CHANNEL dmachan)
+{
+  const struct iovec *iov = dmachan->sgiov++;
+  uint32_t ccr;
+
+  dmachan->sgleft--;
+
+  ccr = dmachan_getreg(dmachan, STM32L4_DMACHAN_CCR_OFFSET);
+  dmachan_putreg(dmachan, STM32L4_DMACHAN_CCR_OFFSET, ccr & ~DMA_CCR_EN);
+  dmachan_putreg(dmachan, STM32L4_DMACHAN_CMAR_OFFSET,
+                 (uint32_t)(uintptr_t)iov->iov_base);
+  dmachan_putreg(dmachan, STM32L4_DMACHAN_CNDTR_OFFSET,
+                 iov->iov_len >> dmachan->sgshift);
+  dmachan_putreg(dmachan, STM32L4_DMACHAN_CCR_OFFSET, ccr);
+}
+
 /****************************************************************************
  * Name: stm32l4_dma12_sample
  ****************************************************************************/
@@ -982,6 +1062,15 @@ void weak_function arm_dma_initialize(void)
 
       up_enable_irq(dmachan->irq);
     }
+
+#ifdef CONFIG_STM32L4_DMAMEM
+  /* Set up the pool of DMA buffers shared by the drivers */
+
+  if (stm32l4_dmamem_initialize() < 0)
+    {
+      dmaerr("ERROR: DMA buffer pool not available\n");
+    }
+#endif
 }
 
 /****************************************************************************
@@ -1115,6 +1204,7 @@ void stm32l4_dmafree(DMA_HANDLE handle)
   flags = enter_critical_section();
   dmachan->used = false;
   dmachan->dmamux_req = 0;
+  dmachan->dmamux_sync = 0;
   leave_critical_section(flags);
 }
 
@@ -1139,9 +1229,147 @@ void stm32l4_dmasetup(DMA_HANDLE handle, uint32_t paddr, uint32_t maddr,
   controller = dmachan->ctrl;
   DEBUGASSERT(controller >= DMA1 && controller <= DMA2);
 
+  dmachan->halfsize    = 0;
+  dmachan->dblcallback = NULL;
+  dmachan->sgleft      = 0;
+
   g_dma_ops[controller].dma_setup(handle, paddr, maddr, ntransfers, ccr);
 }
 
+/****************************************************************************
+ * Name: stm32l4_dmadblbuf_setup
+ *
+ * Description:
+ *   Configure a channel for circular double-buffer operation.  The memory
+ *   at 'maddr' holds two consecutive half buffers of 'halfsize' transfers
+ *   each.
+ *
+ ****************************************************************************/
+
+void stm32l4_dmadblbuf_setup(DMA_HANDLE handle, uint32_t paddr,
+                             uint32_t maddr, size_t halfsize, uint32_t ccr)
+{
+  DMA_CHANNEL dmachan = (DMA_CHANNEL)handle;
+  uint8_t controller;
+
+  DEBUGASSERT(handle != NULL);
+  DEBUGASSERT(halfsize > 0 && 2 * halfsize < 65536);
+
+  /* Get DMA controller */
+
+  controller = dmachan->ctrl;
+  DEBUGASSERT(controller >= DMA1 && controller <= DMA2);
+
+  dmachan->halfsize    = halfsize;
+  dmachan->dblcallback = NULL;
+  dmachan->sgleft      = 0;
+
+  g_dma_ops[controller].dma_setup(handle, paddr, maddr, 2 * halfsize,
+                                  ccr | DMA_CCR_CIRC);
+}
+
+/****************************************************************************
+ * Name: stm32l4_dmadblbuf_start
+ *
+ * Description:
+ *   Start a transfer configured by stm32l4_dmadblbuf_setup().  The
+ *   callback is invoked each time one of the halves has been completed.
+ *
+ ****************************************************************************/
+
+void stm32l4_dmadblbuf_start(DMA_HANDLE handle, dma_dblcallback_t callback,
+                             void *arg)
+{
+  DMA_CHANNEL dmachan = (DMA_CHANNEL)handle;
+
+  DEBUGASSERT(handle != NULL && dmachan->halfsize != 0);
+
+  /* The DMAMUX routing and the channel enable are the same as for a
+   * single transfer; only the interrupt dispatch differs.
+   */
+
+  dmachan->dblcallback = callback;
+  stm32l4_dmastart(handle, NULL, arg, true);
+}
+
+/****************************************************************************
+ * Name: stm32l4_dmadblbuf_current
+ *
+ * Description:
+ *   Return the half buffer (0 or 1) that the DMA is currently
+ *   transferring.  The other half is owned by the CPU.
+ *
+ ****************************************************************************/
+
+unsigned int stm32l4_dmadblbuf_current(DMA_HANDLE handle)
+{
+  DMA_CHANNEL dmachan = (DMA_CHANNEL)handle;
+
+  DEBUGASSERT(handle != NULL && dmachan->halfsize != 0);
+
+  return stm32l4_dma12_current(dmachan);
+}
+
+/****************************************************************************
+ * Name: stm32l4_dmasg_start
+ *
+ * Description:
+ *   Start a transfer over a list of memory segments.  The first segment is
+ *   set up here, the others are chained from the transfer complete
+ *   interrupt and the callback is invoked once, after the last one.
+ *
+ ****************************************************************************/
+
+int stm32l4_dmasg_start(DMA_HANDLE handle, uint32_t paddr,
+                        const struct iovec *iov, int iovcnt, uint32_t ccr,
+                        dma_callback_t callback, void *arg)
+{
+  DMA_CHANNEL dmachan = (DMA_CHANNEL)handle;
+  uint8_t controller;
+  uint8_t shift;
+  int i;
+
+  DEBUGASSERT(handle != NULL && iov != NULL);
+
+  /* Each segment must be a whole number of memory transfers that fits in
+   * CNDTR.  A circular transfer would never reach the next segment.
+   */
+
+  shift = (ccr & DMA_CCR_MSIZE_MASK) >> DMA_CCR_MSIZE_SHIFT;
+  if (iovcnt < 1 || iovcnt > UINT8_MAX + 1 || (ccr & DMA_CCR_CIRC) != 0)
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      if (iov[i].iov_len == 0 ||
+          (iov[i].iov_len & ((1 << shift) - 1)) != 0 ||
+          (iov[i].iov_len >> shift) >= 65536)
+        {
+          return -EINVAL;
+        }
+    }
+
+  /* Get DMA controller */
+
+  controller = dmachan->ctrl;
+  DEBUGASSERT(controller >= DMA1 && controller <= DMA2);
+
+  dmachan->halfsize    = 0;
+  dmachan->dblcallback = NULL;
+  dmachan->sgiov       = &iov[1];
+  dmachan->sgleft      = iovcnt - 1;
+  dmachan->sgshift     = shift;
+
+  g_dma_ops[controller].dma_setup(handle, paddr,
+                                  (uint32_t)(uintptr_t)iov[0].iov_base,
+                                  iov[0].iov_len >> shift, ccr);
+
+  stm32l4_dmastart(handle, callback, arg, false);
+  return OK;
+}
+
 /****************************************************************************
  * Name: stm32l4_dmastart
  *
@@ -1183,7 +1411,8 @@ void stm32l4_dmastart(DMA_HANDLE handle, dma_callback_t callback, void *arg,
 
   /* DMAMUX Set DMA channel source */
 
-  regval = dmachan->dmamux_req << DMAMUX_CCR_DMAREQID_SHIFT;
+  regval = (dmachan->dmamux_req << DMAMUX_CCR_DMAREQID_SHIFT) |
+           dmachan->dmamux_sync;
   dmamux_putreg(dmamux, STM32L4_DMAMUX_CXCR_OFFSET(dmamux_chan), regval);
 
   /* Enable DMA channel */
@@ -1191,6 +1420,145 @@ void stm32l4_dmastart(DMA_HANDLE handle, dma_callback_t callback, void *arg,
   g_dma_ops[controller].dma_start(handle, callback, arg, half);
 }
 
+/****************************************************************************
+ * Name: stm32l4_dmasync
+ *
+ * Description:
+ *   Gate the DMA requests of a channel on a DMAMUX synchronization input.
+ *   The setting takes effect at the next stm32l4_dmastart().
+ *
+ ****************************************************************************/
+
+int stm32l4_dmasync(DMA_HANDLE handle, uint8_t syncid, uint8_t pol,
+                    unsigned int nbreq, bool event)
+{
+  DMA_CHANNEL dmachan = (DMA_CHANNEL)handle;
+  uint32_t sync = 0;
+
+  DEBUGASSERT(handle != NULL);
+
+  if (nbreq < 1 || nbreq > DMAMUX1_NBREQ_MAX ||
+      pol > DMAMUX_POL_BOTH || syncid > DMAMUX1_SIG_LTDC_LINE)
+    {
+      return -EINVAL;
+    }
+
+  if (pol != DMAMUX_POL_NONE)
+    {
+      sync |= DMAMUX_CCR_SE | DMAMUX_CCR_SPOL(pol) |
+              DMAMUX_CCR_SYNCID(syncid);
+    }
+
+  if (event)
+    {
+      sync |= DMAMUX_CCR_EGE;
+    }
+
+  if (sync != 0)
+    {
+      sync |= DMAMUX_CCR_NBREQ(nbreq);
+    }
+
+  dmachan->dmamux_sync = sync;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4_dmamux_reqgen_start
+ *
+ * Description:
+ *   Start a DMAMUX request generator.  Every selected edge on the trigger
+ *   input 'sigid' produces 'nbreq' DMA requests on the DMAMUX1_REQ_GENn
+ *   request line.
+ *
+ ****************************************************************************/
+
+int stm32l4_dmamux_reqgen_start(unsigned int gen, uint8_t sigid,
+                                uint8_t pol, unsigned int nbreq)
+{
+  DMA_MUX dmamux = &g_dmamux[DMAMUX1];
+  irqstate_t flags;
+  uint32_t regval;
+
+  if (gen >= DMAMUX1_NREQGEN || nbreq < 1 || nbreq > DMAMUX1_NBREQ_MAX ||
+      pol == DMAMUX_POL_NONE || pol > DMAMUX_POL_BOTH ||
+      sigid > DMAMUX1_SIG_LTDC_LINE)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  if ((g_reqgen_busy & (1 << gen)) != 0)
+    {
+      leave_critical_section(flags);
+      return -EBUSY;
+    }
+
+  g_reqgen_busy |= 1 << gen;
+  leave_critical_section(flags);
+
+  /* GNBREQ may only be changed while the generator is disabled */
+
+  regval = DMAMUX_RGCR_SIGID(sigid) | DMAMUX_RGCR_GPOL(pol) |
+           DMAMUX_RGCR_GNBREQ(nbreq);
+  dmamux_putreg(dmamux, STM32L4_DMAMUX_RGXCR_OFFSET(gen), regval);
+  dmamux_putreg(dmamux, STM32L4_DMAMUX_RGCFR_OFFSET, DMAMUX_RGCFR_COF(gen));
+  dmamux_putreg(dmamux, STM32L4_DMAMUX_RGXCR_OFFSET(gen),
+                regval | DMAMUX_RGCR_GE);
+
+  dmainfo("REQ_GEN%u: sigid=%u pol=%u nbreq=%u\n", gen, sigid, pol,
+          nbreq);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32l4_dmamux_reqgen_stop
+ *
+ * Description:
+ *   Stop and release a request generator.
+ *
+ ****************************************************************************/
+
+void stm32l4_dmamux_reqgen_stop(unsigned int gen)
+{
+  DMA_MUX dmamux = &g_dmamux[DMAMUX1];
+  irqstate_t flags;
+
+  DEBUGASSERT(gen < DMAMUX1_NREQGEN);
+
+  dmamux_putreg(dmamux, STM32L4_DMAMUX_RGXCR_OFFSET(gen), 0);
+
+  flags = enter_critical_section();
+  g_reqgen_busy &= ~(1 << gen);
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: stm32l4_dmamux_reqgen_overrun
+ *
+ * Description:
+ *   Return true (and clear the flag) if a trigger arrived on the request
+ *   generator before the DMA had served all requests of the previous one.
+ *
+ ****************************************************************************/
+
+bool stm32l4_dmamux_reqgen_overrun(unsigned int gen)
+{
+  DMA_MUX dmamux = &g_dmamux[DMAMUX1];
+
+  DEBUGASSERT(gen < DMAMUX1_NREQGEN);
+
+  if ((dmamux_getreg(dmamux, STM32L4_DMAMUX_RGSR_OFFSET) &
+       DMAMUX_RGSR_OF(gen)) != 0)
+    {
+      dmamux_putreg(dmamux, STM32L4_DMAMUX_RGCFR_OFFSET,
+                    DMAMUX_RGCFR_COF(gen));
+      return true;
+    }
+
+  return false;
+}
+
 /****************************************************************************
  * Name: stm32l4_dmastop
  *
@@ -1226,6 +1594,9 @@ void stm32l4_dmastop(DMA_HANDLE handle)
   /* Disable DMA channel */
 
   g_dma_ops[controller].dma_disable(dmachan);
+  dmachan->halfsize    = 0;
+  dmachan->dblcallback = NULL;
+  dmachan->sgleft      = 0;
 
   /* DMAMUX Clear DMA channel source */
 
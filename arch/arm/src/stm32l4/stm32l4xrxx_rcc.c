@@ -920,11 +920,7 @@ static void stm32l4_stdclockconfig(void)
 
       /* Enable FLASH prefetch, instruction cache and data cache */
 
-#ifdef CONFIG_STM32L4_FLASH_PREFETCH
-      regval |= (FLASH_ACR_ICEN | FLASH_ACR_DCEN | FLASH_ACR_PRFTEN);
-#else
-      regval |= (FLASH_ACR_ICEN | FLASH_ACR_DCEN);
-#endif
+      regval |= STM32L4_FLASH_ACR_ACCEL;
       putreg32(regval, STM32L4_FLASH_ACR);
 
       /* Select the main PLL as system clock source */
@@ -154,6 +154,26 @@ struct mm_heap_s *mm_initialize(const char *name,
   return heap;
 }
 
+/****************************************************************************
+ * Name: mm_initialize_heap
+ *
+ * Description:
+ *   Initialize a heap like mm_initialize().  The host heap is never checked
+ *   by KASan, so there are no further options.
+ *
+ * Input Parameters:
+ *   config - The description of the heap
+ *
+ * Returned Value:
+ *   Return the address of a new heap instance.
+ *
+ ****************************************************************************/
+
+struct mm_heap_s *mm_initialize_heap(const struct mm_heap_config_s *config)
+{
+  return mm_initialize(config->name, config->start, config->size);
+}
+
 /****************************************************************************
  * Name: mm_addregion
  *
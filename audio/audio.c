@@ -32,6 +32,7 @@
 #include <unistd.h>
 #include <string.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
@@ -76,6 +77,13 @@ struct audio_upperhalf_s
   mutex_t           lock;             /* Supports mutual exclusion */
   FAR struct audio_lowerhalf_s *dev;  /* lower-half state */
   struct file      *usermq;           /* User mode app's message queue */
+#ifdef CONFIG_AUDIO_RING_MAPPING
+  bool              mapped;           /* True: mapped ring mode */
+  struct audio_ring_s ring;           /* The ring of the lower half */
+  volatile uint32_t periods;          /* Periods elapsed since mapping */
+  uint32_t          seen;             /* Period count last read */
+  FAR struct pollfd *fds;             /* The poll waiter */
+#endif
 };
 
 /****************************************************************************
@@ -93,6 +101,13 @@ static ssize_t  audio_write(FAR struct file *filep,
 static int      audio_ioctl(FAR struct file *filep,
                             int cmd,
                             unsigned long arg);
+#ifdef CONFIG_AUDIO_RING_MAPPING
+static int      audio_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
+static int      audio_poll(FAR struct file *filep,
+                           FAR struct pollfd *fds,
+                           bool setup);
+#endif
 #ifdef CONFIG_AUDIO_MULTI_SESSION
 static int      audio_start(FAR struct audio_upperhalf_s *upper,
                             FAR void *session);
@@ -121,6 +136,11 @@ static const struct file_operations g_audioops =
   audio_write, /* write */
   NULL,        /* seek */
   audio_ioctl, /* ioctl */
+#ifdef CONFIG_AUDIO_RING_MAPPING
+  audio_mmap,  /* mmap */
+  NULL,        /* truncate */
+  audio_poll,  /* poll */
+#endif
 };
 
 /****************************************************************************
@@ -223,6 +243,14 @@ static int audio_close(FAR struct file *filep)
       DEBUGASSERT(lower->ops->shutdown != NULL);
       audinfo("calling shutdown\n");
 
+#ifdef CONFIG_AUDIO_RING_MAPPING
+      if (upper->mapped)
+        {
+          lower->ops->ioctl(lower, AUDIOIOC_UNMAPRING, 0);
+          upper->mapped = false;
+        }
+#endif
+
       lower->ops->shutdown(lower);
       upper->usermq = NULL;
     }
@@ -252,6 +280,25 @@ static ssize_t audio_read(FAR struct file *filep,
 
   /* TODO: Should we check permissions here? */
 
+#ifdef CONFIG_AUDIO_RING_MAPPING
+  /* In mapped ring mode a read returns the number of elapsed periods */
+
+  if (upper->mapped)
+    {
+      uint32_t periods;
+
+      if (buflen < sizeof(uint32_t))
+        {
+          return -EINVAL;
+        }
+
+      periods     = upper->periods;
+      upper->seen = periods;
+      memcpy(buffer, &periods, sizeof(uint32_t));
+      return sizeof(uint32_t);
+    }
+#endif
+
   /* Audio read operations get passed directly to the lower-level */
 
   if (lower->ops->read != NULL)
@@ -646,6 +693,59 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_AUDIO_RING_MAPPING
+      /* AUDIOIOC_MAPRING - Switch to the mapped ring mode
+       *
+       *   ioctl argument:  pointer to an audio_ring_s structure
+       */
+
+      case AUDIOIOC_MAPRING:
+        {
+          FAR struct audio_ring_s *ring =
+            (FAR struct audio_ring_s *)((uintptr_t)arg);
+
+          audinfo("AUDIOIOC_MAPRING\n");
+          DEBUGASSERT(lower->ops->ioctl != NULL);
+
+          if (upper->started || upper->mapped)
+            {
+              ret = -EBUSY;
+              break;
+            }
+
+          ret = lower->ops->ioctl(lower, AUDIOIOC_MAPRING, arg);
+          if (ret >= 0)
+            {
+              DEBUGASSERT(ring->period > 0 && ring->size >= ring->period);
+              upper->ring    = *ring;
+              upper->periods = 0;
+              upper->seen    = 0;
+              upper->mapped  = true;
+            }
+        }
+        break;
+
+      /* AUDIOIOC_UNMAPRING - Leave the mapped ring mode
+       *
+       *   ioctl argument:  None
+       */
+
+      case AUDIOIOC_UNMAPRING:
+        {
+          audinfo("AUDIOIOC_UNMAPRING\n");
+          DEBUGASSERT(lower->ops->ioctl != NULL);
+
+          ret = OK;
+          if (upper->mapped)
+            {
+              ret = lower->ops->ioctl(lower, AUDIOIOC_UNMAPRING, arg);
+              upper->mapped  = false;
+              upper->started = false;
+            }
+        }
+        break;
+#endif
+
       /* Any unrecognized IOCTL commands might be
        * platform-specific ioctl commands
        */
@@ -663,6 +763,82 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   return ret;
 }
 
+/****************************************************************************
+ * Name: audio_mmap
+ *
+ * Description:
+ *   Map the DMA ring of a device in mapped ring mode.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_RING_MAPPING
+static int audio_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct audio_upperhalf_s *upper = inode->i_private;
+
+  if (!upper->mapped)
+    {
+      return -ENODEV;
+    }
+
+  if (map->offset >= 0 && map->offset < upper->ring.size &&
+      map->length && map->offset + map->length <= upper->ring.size)
+    {
+      map->vaddr = (FAR char *)upper->ring.buffer + map->offset;
+      return OK;
+    }
+
+  return -EINVAL;
+}
+
+/****************************************************************************
+ * Name: audio_poll
+ *
+ * Description:
+ *   Wait for the next period of the mapped ring.  The device is ready
+ *   while there are periods that have elapsed since the last read.
+ *
+ ****************************************************************************/
+
+static int audio_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                      bool setup)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct audio_upperhalf_s *upper = inode->i_private;
+  irqstate_t flags;
+  int ret = OK;
+
+  flags = enter_critical_section();
+
+  if (setup)
+    {
+      if (upper->fds != NULL)
+        {
+          ret = -EBUSY;
+        }
+      else
+        {
+          upper->fds = fds;
+          fds->priv  = &upper->fds;
+
+          if (upper->mapped && upper->periods != upper->seen)
+            {
+              poll_notify(&upper->fds, 1, POLLIN | POLLOUT);
+            }
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      upper->fds = NULL;
+      fds->priv  = NULL;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: audio_dequeuebuffer
  *
@@ -878,6 +1054,24 @@ static void audio_callback(FAR void *handle, uint16_t reason,
         }
         break;
 
+#ifdef CONFIG_AUDIO_RING_MAPPING
+      /* A period of the mapped ring has elapsed */
+
+      case AUDIO_CALLBACK_PERIOD:
+        {
+          if (status == OK)
+            {
+              upper->periods++;
+              poll_notify(&upper->fds, 1, POLLIN | POLLOUT);
+            }
+          else
+            {
+              poll_notify(&upper->fds, 1, POLLERR);
+            }
+        }
+        break;
+#endif
+
       default:
         {
           auderr("ERROR: Unknown callback reason code %d\n", reason);
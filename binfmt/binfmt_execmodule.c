@@ -242,11 +242,9 @@ int exec_module(FAR struct binary_s *binp,
     }
 
 #ifdef CONFIG_PIC
-  /* Add the D-Space address as the PIC base address.  By convention, this
-   * must be the first allocated address space.
-   */
+  /* Add the D-Space address as the PIC base address */
 
-  tcb->cmn.dspace = binp->alloc[0];
+  tcb->cmn.dspace = binp->dspace;
 
   /* Re-initialize the task's initial state to account for the new PIC base */
 
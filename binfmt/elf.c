@@ -289,6 +289,19 @@ static int elf_loadbinary(FAR struct binary_s *binp,
 
       binp->entrypt = (main_t)(loadinfo.ehdr.e_entry);
     }
+#ifdef CONFIG_ELF_XIP
+  else if (loadinfo.ehdr.e_type == ET_DYN)
+    {
+      ret = elf_xipbind(&loadinfo, exports, nexports);
+      if (ret != 0)
+        {
+          berr("Failed to bind symbols program binary: %d\n", ret);
+          goto errout_with_load;
+        }
+
+      binp->entrypt = (main_t)(loadinfo.textbias + loadinfo.ehdr.e_entry);
+    }
+#endif
 
   else
     {
@@ -319,6 +332,10 @@ static int elf_loadbinary(FAR struct binary_s *binp,
 #else
   binp->alloc[0] = (FAR void *)loadinfo.textalloc;
   binp->alloc[1] = (FAR void *)loadinfo.dataalloc;
+#  ifdef CONFIG_ELF_XIP
+  binp->dspace   = loadinfo.dspace;
+  loadinfo.dspace = NULL;
+#  endif
 #  ifdef CONFIG_BINFMT_CONSTRUCTORS
   binp->alloc[2] = loadinfo.ctoralloc;
   binp->alloc[3] = loadinfo.dtoralloc;
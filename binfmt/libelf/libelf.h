@@ -340,4 +340,48 @@ int elf_addrenv_restore(FAR struct elf_loadinfo_s *loadinfo);
 
 void elf_addrenv_free(FAR struct elf_loadinfo_s *loadinfo);
 
+/****************************************************************************
+ * Name: elf_xipload
+ *
+ * Description:
+ *   Load a position-independent module (ET_DYN) that is in memory-mapped
+ *   storage.  Its read-only sections are executed in place and only its
+ *   writable sections are copied to RAM.
+ *
+ * Input Parameters:
+ *   loadinfo - Load state information
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_XIP
+int elf_xipload(FAR struct elf_loadinfo_s *loadinfo);
+#endif
+
+/****************************************************************************
+ * Name: elf_xipbind
+ *
+ * Description:
+ *   Perform the dynamic relocations of a module loaded by elf_xipload(),
+ *   using the exported symbol values provided by 'exports'.
+ *
+ * Input Parameters:
+ *   loadinfo - Load state information
+ *   exports  - The symbols exported to the module
+ *   nexports - The number of symbols in exports
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_XIP
+int elf_xipbind(FAR struct elf_loadinfo_s *loadinfo,
+                FAR const struct symtab_s *exports, int nexports);
+#endif
+
 #endif /* __BINFMT_LIBELF_LIBELF_H */
@@ -350,6 +350,22 @@ int elf_load(FAR struct elf_loadinfo_s *loadinfo)
       goto errout_with_buffers;
     }
 
+#ifdef CONFIG_ELF_XIP
+  /* A position-independent module is executed in place */
+
+  if (loadinfo->ehdr.e_type == ET_DYN)
+    {
+      ret = elf_xipload(loadinfo);
+      if (ret < 0)
+        {
+          berr("ERROR: elf_xipload failed: %d\n", ret);
+          goto errout_with_buffers;
+        }
+
+      return OK;
+    }
+#endif
+
   /* Determine total size to allocate */
 
   elf_elfsize(loadinfo);
@@ -72,6 +72,16 @@ int elf_unload(FAR struct elf_loadinfo_s *loadinfo)
 
   elf_addrenv_free(loadinfo);
 
+#ifdef CONFIG_ELF_XIP
+  /* Release the PIC base that was not given to a task */
+
+  if (loadinfo->dspace != NULL)
+    {
+      kmm_free(loadinfo->dspace);
+      loadinfo->dspace = NULL;
+    }
+#endif
+
   /* Release memory used to hold static constructors and destructors */
 
 #ifdef CONFIG_BINFMT_CONSTRUCTORS
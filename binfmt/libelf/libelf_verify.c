@@ -86,7 +86,11 @@ int elf_verifyheader(FAR const Elf_Ehdr *ehdr)
 
   /* Verify that this is a relocatable file */
 
-  if (ehdr->e_type != ET_REL && ehdr->e_type != ET_EXEC)
+  if (ehdr->e_type != ET_REL && ehdr->e_type != ET_EXEC
+#ifdef CONFIG_ELF_XIP
+      && ehdr->e_type != ET_DYN
+#endif
+     )
     {
       berr("Not a relocatable or executable file: e_type=%d\n",
            ehdr->e_type);
@@ -0,0 +1,433 @@
+/****************************************************************************
+ * binfmt/libelf/libelf_xip.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/elf.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/symtab.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/binfmt/elf.h>
+
+#include "libelf.h"
+
+#ifdef CONFIG_ELF_XIP
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: elf_xipaddr
+ *
+ * Description:
+ *   Return the run-time address of a link address of the module, or 0 if
+ *   it is outside of the module.  The end of the sections is accepted, as
+ *   it is the value of symbols like __init_array_end.
+ *
+ ****************************************************************************/
+
+static uintptr_t elf_xipaddr(FAR struct elf_loadinfo_s *loadinfo,
+                             Elf_Addr vaddr)
+{
+  if (loadinfo->datasize > 0 &&
+      vaddr - loadinfo->datavaddr <= loadinfo->datasize)
+    {
+      return loadinfo->dataalloc + (vaddr - loadinfo->datavaddr);
+    }
+
+  if (vaddr - loadinfo->textvaddr <= loadinfo->textspan)
+    {
+      return vaddr + loadinfo->textbias;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: elf_xipsymvalue
+ *
+ * Description:
+ *   Set st_value of a symbol of the dynamic symbol table to its run-time
+ *   value.  Undefined symbols are looked up in the exports; the undefined
+ *   weak ones that are not exported get 0.
+ *
+ ****************************************************************************/
+
+static int elf_xipsymvalue(FAR struct elf_loadinfo_s *loadinfo,
+                           FAR Elf_Sym *sym, FAR const char *strtab,
+                           FAR const struct symtab_s *exports, int nexports)
+{
+  FAR const struct symtab_s *symbol;
+
+  switch (sym->st_shndx)
+    {
+    case SHN_COMMON:
+      return -ENOSYS;
+
+    case SHN_ABS:
+      break;
+
+    case SHN_UNDEF:
+      symbol = symtab_findbyname(exports, strtab + sym->st_name, nexports);
+      if (symbol != NULL)
+        {
+          sym->st_value = (uintptr_t)symbol->sym_value;
+        }
+      else if (ELF_ST_BIND(sym->st_info) == STB_WEAK)
+        {
+          sym->st_value = 0;
+        }
+      else
+        {
+          berr("ERROR: Exported symbol \"%s\" not found\n",
+               strtab + sym->st_name);
+          return -ENOENT;
+        }
+      break;
+
+    default:
+      sym->st_value = elf_xipaddr(loadinfo, sym->st_value);
+      break;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: elf_xiprelocate
+ *
+ * Description:
+ *   Perform the relocations of a dynamic relocation section.  They are
+ *   read from the mapped file, and must all be in the writable sections.
+ *
+ ****************************************************************************/
+
+static int elf_xiprelocate(FAR struct elf_loadinfo_s *loadinfo,
+                           FAR const Elf_Shdr *relsec,
+                           FAR const struct symtab_s *exports, int nexports)
+{
+  FAR const Elf_Shdr *symsec = &loadinfo->shdr[relsec->sh_link];
+  FAR const Elf_Sym *symtab;
+  FAR const char *strtab;
+  FAR const Elf_Rela *rela;
+  bool hasaddend;
+  size_t entsize;
+  size_t nsyms;
+  size_t i;
+  Elf_Sym sym;
+  uintptr_t addr;
+  Elf_Addr target;
+  int symidx;
+  int ret;
+
+  symtab = (FAR const Elf_Sym *)(loadinfo->xipimage + symsec->sh_offset);
+  strtab = (FAR const char *)loadinfo->xipimage +
+           loadinfo->shdr[symsec->sh_link].sh_offset;
+  nsyms  = symsec->sh_size / sizeof(Elf_Sym);
+
+  hasaddend = relsec->sh_type == SHT_RELA;
+  entsize   = hasaddend ? sizeof(Elf_Rela) : sizeof(Elf_Rel);
+
+  for (i = 0; i < relsec->sh_size / entsize; i++)
+    {
+      /* Elf_Rel is the beginning of Elf_Rela */
+
+      rela = (FAR const Elf_Rela *)(loadinfo->xipimage +
+                                    relsec->sh_offset + i * entsize);
+
+      if (loadinfo->datasize < sizeof(Elf_Addr) ||
+          rela->r_offset - loadinfo->datavaddr >
+          loadinfo->datasize - sizeof(Elf_Addr))
+        {
+          berr("ERROR: Relocation %zu at %08lx is not in writable data\n",
+               i, (unsigned long)rela->r_offset);
+          return -ENOEXEC;
+        }
+
+      addr   = loadinfo->dataalloc + (rela->r_offset - loadinfo->datavaddr);
+      symidx = ELF_R_SYM(rela->r_info);
+
+      if (symidx == 0)
+        {
+          /* A relative relocation: the link address of the target is the
+           * addend.  The text and the data are not moved by the same
+           * amount, so the target is given as the symbol value, which
+           * up_relocate() stores.
+           */
+
+          target = hasaddend ? rela->r_addend : *(FAR Elf_Addr *)addr;
+
+          memset(&sym, 0, sizeof(sym));
+          sym.st_shndx = SHN_ABS;
+          sym.st_value = elf_xipaddr(loadinfo, target);
+        }
+      else
+        {
+          if (symidx >= nsyms)
+            {
+              return -EINVAL;
+            }
+
+          memcpy(&sym, &symtab[symidx], sizeof(sym));
+          ret = elf_xipsymvalue(loadinfo, &sym, strtab, exports, nexports);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      if (hasaddend)
+        {
+          ret = up_relocateadd(rela, &sym, addr);
+        }
+      else
+        {
+          ret = up_relocate((FAR const Elf_Rel *)rela, &sym, addr);
+        }
+
+      if (ret < 0)
+        {
+          berr("ERROR: Relocation %zu failed: %d\n", i, ret);
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: elf_xipload
+ *
+ * Description:
+ *   Load a position-independent module that is in memory-mapped storage.
+ *   Its read-only sections are executed in place and only its writable
+ *   sections are copied to RAM.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.  -ENOEXEC is returned if the file cannot be executed in place.
+ *
+ ****************************************************************************/
+
+int elf_xipload(FAR struct elf_loadinfo_s *loadinfo)
+{
+  FAR struct dspace_s *dspace;
+  FAR const void *image;
+  Elf_Addr textvaddr = (Elf_Addr)-1;
+  Elf_Addr datavaddr = (Elf_Addr)-1;
+  Elf_Addr textend = 0;
+  Elf_Addr dataend = 0;
+  uintptr_t bias;
+  uintptr_t addr;
+  bool hastext = false;
+  int ret;
+  int i;
+
+  ret = file_xipmap(&loadinfo->file, 0, loadinfo->filelen, &image);
+  if (ret < 0)
+    {
+      berr("ERROR: The file is not in memory that can be executed\n");
+      return -ENOEXEC;
+    }
+
+  loadinfo->xipimage = image;
+
+  /* The read-only sections keep the layout that they have in the file, so
+   * they must all be moved by the same amount.  The writable ones keep the
+   * layout that they are linked at.
+   */
+
+  for (i = 0; i < loadinfo->ehdr.e_shnum; i++)
+    {
+      FAR Elf_Shdr *shdr = &loadinfo->shdr[i];
+
+      if ((shdr->sh_flags & SHF_ALLOC) == 0)
+        {
+          continue;
+        }
+
+      if ((shdr->sh_flags & SHF_WRITE) != 0)
+        {
+          datavaddr = MIN(datavaddr, shdr->sh_addr);
+          dataend   = MAX(dataend, shdr->sh_addr + shdr->sh_size);
+          if (loadinfo->dataalign < shdr->sh_addralign)
+            {
+              loadinfo->dataalign = shdr->sh_addralign;
+            }
+
+          continue;
+        }
+
+      bias = (uintptr_t)image + shdr->sh_offset - shdr->sh_addr;
+      if (shdr->sh_type == SHT_NOBITS ||
+          (hastext && bias != loadinfo->textbias) ||
+          (shdr->sh_addralign > 1 && (bias & (shdr->sh_addralign - 1))))
+        {
+          berr("ERROR: Section %d cannot be executed in place\n", i);
+          return -ENOEXEC;
+        }
+
+      loadinfo->textbias = bias;
+      hastext   = true;
+      textvaddr = MIN(textvaddr, shdr->sh_addr);
+      textend   = MAX(textend, shdr->sh_addr + shdr->sh_size);
+    }
+
+  if (!hastext)
+    {
+      return -ENOEXEC;
+    }
+
+  loadinfo->textvaddr = textvaddr;
+  loadinfo->textspan  = textend - textvaddr;
+
+  if (dataend > 0)
+    {
+      loadinfo->datavaddr = datavaddr;
+      loadinfo->datasize  = dataend - datavaddr;
+      loadinfo->dataalloc = (uintptr_t)
+        kumm_memalign(MAX(loadinfo->dataalign, sizeof(uintptr_t)),
+                      loadinfo->datasize);
+      if (loadinfo->dataalloc == 0)
+        {
+          return -ENOMEM;
+        }
+
+      memset((FAR void *)loadinfo->dataalloc, 0, loadinfo->datasize);
+    }
+
+  /* Copy the writable sections and set the run-time address of all */
+
+  binfo("Sections in place at %p:\n", image);
+
+  for (i = 0; i < loadinfo->ehdr.e_shnum; i++)
+    {
+      FAR Elf_Shdr *shdr = &loadinfo->shdr[i];
+
+      if ((shdr->sh_flags & SHF_ALLOC) == 0)
+        {
+          continue;
+        }
+
+      if ((shdr->sh_flags & SHF_WRITE) != 0)
+        {
+          addr = loadinfo->dataalloc + (shdr->sh_addr - datavaddr);
+          if (shdr->sh_type != SHT_NOBITS)
+            {
+              memcpy((FAR void *)addr, loadinfo->xipimage + shdr->sh_offset,
+                     shdr->sh_size);
+            }
+        }
+      else
+        {
+          addr = shdr->sh_addr + loadinfo->textbias;
+        }
+
+      binfo("%d. %08lx->%08lx\n", i,
+            (unsigned long)shdr->sh_addr, (unsigned long)addr);
+
+      shdr->sh_addr = addr;
+    }
+
+  /* The code addresses its data through the GOT, whose address is given
+   * to the module in the PIC base register.
+   */
+
+  i = elf_findsection(loadinfo, ".got");
+  if (i >= 0)
+    {
+      dspace = kmm_malloc(sizeof(struct dspace_s));
+      if (dspace == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      dspace->crefs    = 1;
+      dspace->region   = (FAR uint8_t *)loadinfo->shdr[i].sh_addr;
+      loadinfo->dspace = dspace;
+    }
+
+#ifdef CONFIG_ELF_EXIDX_SECTNAME
+  i = elf_findsection(loadinfo, CONFIG_ELF_EXIDX_SECTNAME);
+  if (i >= 0)
+    {
+      up_init_exidx(loadinfo->shdr[i].sh_addr, loadinfo->shdr[i].sh_size);
+    }
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: elf_xipbind
+ *
+ * Description:
+ *   Perform the dynamic relocations of a module loaded by elf_xipload().
+ *   They only patch the GOT and the data, so their number is that of the
+ *   pointers of the module, not of its references.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int elf_xipbind(FAR struct elf_loadinfo_s *loadinfo,
+                FAR const struct symtab_s *exports, int nexports)
+{
+  FAR Elf_Shdr *shdr;
+  int ret = OK;
+  int i;
+
+  for (i = 1; i < loadinfo->ehdr.e_shnum && ret >= 0; i++)
+    {
+      shdr = &loadinfo->shdr[i];
+      if ((shdr->sh_type == SHT_REL || shdr->sh_type == SHT_RELA) &&
+          shdr->sh_link < loadinfo->ehdr.e_shnum &&
+          loadinfo->shdr[shdr->sh_link].sh_type == SHT_DYNSYM)
+        {
+          ret = elf_xiprelocate(loadinfo, shdr, exports, nexports);
+        }
+    }
+
+  up_coherent_dcache(loadinfo->dataalloc, loadinfo->datasize);
+  return ret;
+}
+
+#endif /* CONFIG_ELF_XIP */
@@ -195,6 +195,7 @@ static int nxflat_loadbinary(FAR struct binary_s *binp,
 #  warning "REVISIT"
 #else
   binp->alloc[0]  = (FAR void *)loadinfo.dspace;
+  binp->dspace    = loadinfo.dspace;
 #endif
 
 #ifdef CONFIG_ARCH_ADDRENV
@@ -141,6 +141,17 @@ int stm32l4_adc_setup(void)
       return ret;
     }
 
+#ifdef CONFIG_STM32L4_ADC1_STREAM
+  /* Register the DMA streaming device at "/dev/adcstream0" */
+
+  ret = stm32l4_adc_stream_register("/dev/adcstream0", 1);
+  if (ret < 0)
+    {
+      aerr("ERROR: stm32l4_adc_stream_register failed: %d\n", ret);
+      return ret;
+    }
+#endif
+
   return OK;
 }
 
@@ -85,6 +85,17 @@ int stm32l4_can_setup(void)
       return ret;
     }
 
+#ifdef CONFIG_STM32L4_CAN_RXRING
+  /* Register the timestamped RX ring at "/dev/canraw0" */
+
+  ret = stm32l4can_rxring_register("/dev/canraw0", CAN_PORT);
+  if (ret < 0)
+    {
+      canerr("ERROR: stm32l4can_rxring_register failed: %d\n", ret);
+      return ret;
+    }
+#endif
+
   return OK;
 #else
   return -ENODEV;
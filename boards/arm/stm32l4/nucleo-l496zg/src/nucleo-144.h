@@ -197,14 +197,12 @@ int stm32_spidev_bus_test(void);
  *
  ****************************************************************************/
 
-void stm32_dma_alloc_init(void);
-
 #if defined (CONFIG_FAT_DMAMEMORY)
 int stm32_dma_alloc_init(void);
 #endif
 
 /****************************************************************************
- * Name: stm32_sdio_initialize
+ * Name: stm32l4_sdio_initialize
  *
  * Description:
  *   Called at application startup time to initialize the SCMMC
@@ -213,7 +211,7 @@ int stm32_dma_alloc_init(void);
  ****************************************************************************/
 
 #ifdef CONFIG_MMCSD
-int stm32_sdio_initialize(void);
+int stm32l4_sdio_initialize(void);
 #endif
 
 /****************************************************************************
@@ -29,11 +29,34 @@
 #include <syslog.h>
 
 #include "nucleo-144.h"
+#include <nuttx/board_initcall.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/leds/userled.h>
 
 #include "stm32l4_i2c.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The drivers that are slow to come up, or not needed by the console, are
+ * started in the background with CONFIG_BOARD_INITCALL.
+ */
+
+#if defined(CONFIG_BOARD_INITCALL) && \
+    (defined(CONFIG_ADC) || defined(CONFIG_DAC) || \
+     defined(CONFIG_MMCSD) || defined(CONFIG_I2C))
+#  define HAVE_INITCALLS 1
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_I2C
+static int stm32_i2c_setup(void);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -51,6 +74,100 @@ struct i2c_master_s *i2c3;
 struct i2c_master_s *i2c4;
 #endif
 
+#ifdef HAVE_INITCALLS
+/* The deferred steps.  The DFSDM filters are registered as ADC devices
+ * after those of the ADC.
+ */
+
+enum
+{
+#ifdef CONFIG_ADC
+  INITCALL_ADC,
+#ifdef CONFIG_STM32L4_DFSDM
+  INITCALL_DFSDM,
+#endif
+#endif
+#ifdef CONFIG_DAC
+  INITCALL_DAC,
+#endif
+#ifdef CONFIG_MMCSD
+  INITCALL_SDIO,
+#endif
+#ifdef CONFIG_I2C
+  INITCALL_I2C,
+#endif
+  INITCALL_NSTEPS
+};
+
+static struct board_initcall_s g_initcalls[INITCALL_NSTEPS] =
+{
+#ifdef CONFIG_ADC
+  [INITCALL_ADC] = BOARD_INITCALL("adc", stm32_adc_setup, 0, 0),
+#ifdef CONFIG_STM32L4_DFSDM
+  [INITCALL_DFSDM] = BOARD_INITCALL("dfsdm", stm32_dfsdm_setup, 0,
+                                    BOARD_INITCALL_DEP(INITCALL_ADC)),
+#endif
+#endif
+#ifdef CONFIG_DAC
+  [INITCALL_DAC] = BOARD_INITCALL("dac", stm32_dac_setup, 0, 0),
+#endif
+#ifdef CONFIG_MMCSD
+  [INITCALL_SDIO] = BOARD_INITCALL("sdio", stm32l4_sdio_initialize, 0, 0),
+#endif
+#ifdef CONFIG_I2C
+  [INITCALL_I2C] = BOARD_INITCALL("i2c", stm32_i2c_setup, 0, 0),
+#endif
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32_i2c_setup
+ *
+ * Description:
+ *   Initialize the I2C buses and register their character drivers.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_I2C
+static int stm32_i2c_setup(void)
+{
+  /* REVISIT: this is ugly! */
+
+#if defined(CONFIG_STM32L4_I2C1)
+  i2c1 = stm32l4_i2cbus_initialize(1);
+#endif
+#if defined(CONFIG_STM32L4_I2C2)
+  i2c2 = stm32l4_i2cbus_initialize(2);
+#endif
+#if defined(CONFIG_STM32L4_I2C3)
+  i2c3 = stm32l4_i2cbus_initialize(3);
+#endif
+#if defined(CONFIG_STM32L4_I2C4)
+  i2c4 = stm32l4_i2cbus_initialize(4);
+#endif
+#ifdef CONFIG_I2C_DRIVER
+#if defined(CONFIG_STM32L4_I2C1)
+  i2c_register(i2c1, 1);
+#endif
+#if defined(CONFIG_STM32L4_I2C2)
+  i2c_register(i2c2, 2);
+#endif
+#if defined(CONFIG_STM32L4_I2C3)
+  i2c_register(i2c3, 3);
+#endif
+#if defined(CONFIG_STM32L4_I2C4)
+  i2c_register(i2c4, 4);
+#endif
+#endif
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -105,6 +222,7 @@ int board_app_initialize(uintptr_t arg)
     }
 #endif
 
+#ifndef HAVE_INITCALLS
 #ifdef CONFIG_ADC
   /* Initialize ADC and register the ADC driver. */
 
@@ -135,6 +253,7 @@ int board_app_initialize(uintptr_t arg)
       syslog(LOG_ERR, "ERROR: stm32_dac_setup failed: %d\n", ret);
     }
 #endif
+#endif /* !HAVE_INITCALLS */
 
 #if defined(CONFIG_FAT_DMAMEMORY)
   if (stm32_dma_alloc_init() < 0)
@@ -155,6 +274,18 @@ int board_app_initialize(uintptr_t arg)
     }
 #endif
 
+#ifdef HAVE_INITCALLS
+  /* Bring up the slow drivers in the background, so that the console
+   * does not wait for the SD card or the I2C buses.
+   */
+
+  ret = board_initcall_start(g_initcalls, INITCALL_NSTEPS);
+  if (ret < 0)
+    {
+      syslog(LOG_ERR, "ERROR: board_initcall_start failed: %d\n", ret);
+      return ret;
+    }
+#else
 #if defined(CONFIG_MMCSD)
   /* Configure SDIO */
 
@@ -171,35 +302,9 @@ int board_app_initialize(uintptr_t arg)
 #if defined(CONFIG_I2C)
   /* Configure I2C */
 
-  /* REVISIT: this is ugly! */
-
-#if defined(CONFIG_STM32L4_I2C1)
-  i2c1 = stm32l4_i2cbus_initialize(1);
-#endif
-#if defined(CONFIG_STM32L4_I2C2)
-  i2c2 = stm32l4_i2cbus_initialize(2);
-#endif
-#if defined(CONFIG_STM32L4_I2C3)
-  i2c3 = stm32l4_i2cbus_initialize(3);
-#endif
-#if defined(CONFIG_STM32L4_I2C4)
-  i2c4 = stm32l4_i2cbus_initialize(4);
-#endif
-#ifdef CONFIG_I2C_DRIVER
-#if defined(CONFIG_STM32L4_I2C1)
-  i2c_register(i2c1, 1);
-#endif
-#if defined(CONFIG_STM32L4_I2C2)
-  i2c_register(i2c2, 2);
-#endif
-#if defined(CONFIG_STM32L4_I2C3)
-  i2c_register(i2c3, 3);
-#endif
-#if defined(CONFIG_STM32L4_I2C4)
-  i2c_register(i2c4, 4);
-#endif
+  stm32_i2c_setup();
 #endif
-#endif /* CONFIG_I2C */
+#endif /* HAVE_INITCALLS */
 
   UNUSED(ret);
   return OK;
@@ -43,6 +43,7 @@
 #include <nuttx/mm/gran.h>
 
 #include "nucleo-144.h"
+#include "stm32l4_dmamem.h"
 
 #if defined(CONFIG_FAT_DMAMEMORY)
 
@@ -54,12 +55,17 @@
 #  error microSD DMA support requires CONFIG_GRAN
 #endif
 
-#define BOARD_DMA_ALLOC_POOL_SIZE (8*512)
+/* The FAT buffers come from the shared DMA buffer pool if there is one */
+
+#ifndef CONFIG_STM32L4_DMAMEM
+#  define BOARD_DMA_ALLOC_POOL_SIZE (8*512)
+#endif
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+#ifndef CONFIG_STM32L4_DMAMEM
 static GRAN_HANDLE dma_allocator;
 
 /* The DMA heap size constrains the total number of things that can be
@@ -75,6 +81,7 @@ static GRAN_HANDLE dma_allocator;
 
 static
 uint8_t g_dma_heap[BOARD_DMA_ALLOC_POOL_SIZE] aligned_data(64);
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -91,6 +98,11 @@ uint8_t g_dma_heap[BOARD_DMA_ALLOC_POOL_SIZE] aligned_data(64);
 
 int stm32_dma_alloc_init(void)
 {
+#ifdef CONFIG_STM32L4_DMAMEM
+  /* The shared pool has been set up by arm_dma_initialize() */
+
+  return OK;
+#else
   dma_allocator = gran_initialize(g_dma_heap,
                                   sizeof(g_dma_heap),
                                   7,  /* 128B granule - must be > alignment (XXX bug?) */
@@ -102,18 +114,27 @@ int stm32_dma_alloc_init(void)
     }
 
   return OK;
+#endif
 }
 
 /* DMA-aware allocator stubs for the FAT filesystem. */
 
 void *fat_dma_alloc(size_t size)
 {
+#ifdef CONFIG_STM32L4_DMAMEM
+  return stm32l4_dmamem_alloc(STM32L4_DMAMEM_SDMMC, size);
+#else
   return gran_alloc(dma_allocator, size);
+#endif
 }
 
 void fat_dma_free(void *memory, size_t size)
 {
+#ifdef CONFIG_STM32L4_DMAMEM
+  stm32l4_dmamem_free(STM32L4_DMAMEM_SDMMC, memory, size);
+#else
   gran_free(dma_allocator, memory, size);
+#endif
 }
 
 #endif /* CONFIG_FAT_DMAMEMORY */
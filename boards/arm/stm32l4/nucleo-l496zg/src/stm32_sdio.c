@@ -94,7 +94,7 @@ static int stm32l4_ncd_interrupt(int irq, void *context)
  ****************************************************************************/
 
 /****************************************************************************
- * Name: stm32_sdio_initialize
+ * Name: stm32l4_sdio_initialize
  *
  * Description:
  *   Initialize SDIO-based MMC/SD card support
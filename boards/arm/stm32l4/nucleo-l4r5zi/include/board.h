@@ -0,0 +1,371 @@
+/****************************************************************************
+ * boards/arm/stm32l4/nucleo-l4r5zi/include/board.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __BOARDS_ARM_STM32L4_NUCLEO_L4R5ZI_INCLUDE_BOARD_H
+#define __BOARDS_ARM_STM32L4_NUCLEO_L4R5ZI_INCLUDE_BOARD_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#ifndef __ASSEMBLY__
+#  include <stdint.h>
+#endif
+
+/* Do not include STM32 L4 header files here */
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Clocking *****************************************************************/
+
+/* The Nucleo-L4R5ZI board provides the following clock sources:
+ *
+ *   MCO: 8 MHz from MCO output of ST-LINK (not connected by default)
+ *   X2:  32.768 KHz crystal for LSE
+ *   X3:  HSE crystal oscillator (not provided)
+ *
+ * So we have these clock source available within the STM32
+ *
+ *   HSI: 16 MHz RC factory-trimmed
+ *   LSI: 32 KHz RC
+ *   MSI: 4 MHz RC, automatically trimmed against the LSE
+ *   LSE: 32.768 kHz
+ *
+ * The system clock is derived from the MSI through the main PLL and runs at
+ * the 120 MHz maximum of the L4+ family.  stm32l4xrxx_rcc.c switches the
+ * regulator into range 1 boost mode whenever STM32L4_SYSCLK_FREQUENCY is
+ * above 80 MHz.
+ */
+
+#define STM32L4_HSI_FREQUENCY     16000000ul
+#define STM32L4_LSI_FREQUENCY     32000
+#define STM32L4_LSE_FREQUENCY     32768
+#define STM32L4_HSE_FREQUENCY     8000000ul  /* 8 MHz from MCO output */
+
+#define STM32L4_SYSCLK_FREQUENCY  120000000ul
+#define BOARD_AHB_FREQUENCY       STM32L4_SYSCLK_FREQUENCY
+
+#define STM32L4_BOARD_USEMSI      1
+#define STM32L4_BOARD_MSIRANGE    RCC_CR_MSIRANGE_4M
+
+/* Prescaler common to all PLL inputs; will be 1 */
+
+#define STM32L4_PLLCFG_PLLM             RCC_PLLCFG_PLLM(1)
+
+/* 'main' PLL config; we use this to generate our system clock via the R
+ *  output.  We set it up as 4 MHz / 1 * 60 / 2 = 120 MHz
+ */
+
+#define STM32L4_PLLCFG_PLLN             RCC_PLLCFG_PLLN(60)
+#define STM32L4_PLLCFG_PLLP             0
+#undef  STM32L4_PLLCFG_PLLP_ENABLED
+#define STM32L4_PLLCFG_PLLQ             RCC_PLLCFG_PLLQ_2
+#define STM32L4_PLLCFG_PLLQ_ENABLED
+#define STM32L4_PLLCFG_PLLR             RCC_PLLCFG_PLLR_2
+#define STM32L4_PLLCFG_PLLR_ENABLED
+
+/* 'SAIPLL1' is used to generate the 48 MHz clock, since we can't
+ * do that with the main PLL's N value.  We set N = 24, and enable
+ * the Q output (ultimately for CLK48) with /2.  So,
+ * 4 MHz / 1 * 24 / 2 = 48 MHz
+ */
+
+#define STM32L4_PLLSAI1CFG_PLLN         RCC_PLLSAI1CFG_PLLN(24)
+#define STM32L4_PLLSAI1CFG_PLLP         0
+#undef  STM32L4_PLLSAI1CFG_PLLP_ENABLED
+#define STM32L4_PLLSAI1CFG_PLLQ         RCC_PLLSAI1CFG_PLLQ_2
+#define STM32L4_PLLSAI1CFG_PLLQ_ENABLED
+#define STM32L4_PLLSAI1CFG_PLLR         0
+#undef  STM32L4_PLLSAI1CFG_PLLR_ENABLED
+
+/* 'SAIPLL2' is not used in this application */
+
+#define STM32L4_PLLSAI2CFG_PLLN         RCC_PLLSAI2CFG_PLLN(8)
+#define STM32L4_PLLSAI2CFG_PLLP         0
+#undef  STM32L4_PLLSAI2CFG_PLLP_ENABLED
+#define STM32L4_PLLSAI2CFG_PLLR         0
+#undef  STM32L4_PLLSAI2CFG_PLLR_ENABLED
+
+/* CLK48 will come from PLLSAI1 (implicitly Q) */
+
+#if defined(CONFIG_STM32L4_OTGFS) || defined(STM32L4_SDMMC) || defined(CONFIG_STM32L4_RNG)
+#  define STM32L4_USE_CLK48       1
+#  define STM32L4_CLK48_SEL       RCC_CCIPR_CLK48SEL_PLLSAI1
+#  define STM32L4_HSI48_SYNCSRC   SYNCSRC_NONE
+#endif
+
+/* Enable the LSE oscillator, used automatically trim the MSI, and for RTC */
+
+#define STM32L4_USE_LSE           1
+
+/* Use the HSI16 for I2C so that the bus timing does not depend on SYSCLK */
+
+#define STM32L4_I2C_USE_HSI16     1
+
+/* AHB clock (HCLK) is SYSCLK (120MHz) */
+
+#define STM32L4_RCC_CFGR_HPRE     RCC_CFGR_HPRE_SYSCLK      /* HCLK  = SYSCLK / 1 */
+#define STM32L4_HCLK_FREQUENCY    STM32L4_SYSCLK_FREQUENCY
+
+/* APB1 clock (PCLK1) is HCLK/1 (120MHz) */
+
+#define STM32L4_RCC_CFGR_PPRE1    RCC_CFGR_PPRE1_HCLK       /* PCLK1 = HCLK / 1 */
+#define STM32L4_PCLK1_FREQUENCY   (STM32L4_HCLK_FREQUENCY / 1)
+
+/* Timers driven from APB1 run at PCLK1 since the APB1 prescaler is 1 */
+
+#define STM32L4_APB1_TIM2_CLKIN   (STM32L4_PCLK1_FREQUENCY)
+#define STM32L4_APB1_TIM3_CLKIN   (STM32L4_PCLK1_FREQUENCY)
+#define STM32L4_APB1_TIM4_CLKIN   (STM32L4_PCLK1_FREQUENCY)
+#define STM32L4_APB1_TIM5_CLKIN   (STM32L4_PCLK1_FREQUENCY)
+#define STM32L4_APB1_TIM6_CLKIN   (STM32L4_PCLK1_FREQUENCY)
+#define STM32L4_APB1_TIM7_CLKIN   (STM32L4_PCLK1_FREQUENCY)
+
+/* APB2 clock (PCLK2) is HCLK (120MHz) */
+
+#define STM32L4_RCC_CFGR_PPRE2    RCC_CFGR_PPRE2_HCLK       /* PCLK2 = HCLK / 1 */
+#define STM32L4_PCLK2_FREQUENCY   (STM32L4_HCLK_FREQUENCY / 1)
+
+/* Timers driven from APB2 run at PCLK2 since the APB2 prescaler is 1 */
+
+#define STM32L4_APB2_TIM1_CLKIN   (STM32L4_PCLK2_FREQUENCY)
+#define STM32L4_APB2_TIM8_CLKIN   (STM32L4_PCLK2_FREQUENCY)
+#define STM32L4_APB2_TIM15_CLKIN  (STM32L4_PCLK2_FREQUENCY)
+#define STM32L4_APB2_TIM16_CLKIN  (STM32L4_PCLK2_FREQUENCY)
+#define STM32L4_APB2_TIM17_CLKIN  (STM32L4_PCLK2_FREQUENCY)
+
+/* Timer Frequencies.
+ * Note: TIM1,8,15,16,17 are on APB2, others on APB1
+ */
+
+#define BOARD_TIM1_FREQUENCY    STM32L4_HCLK_FREQUENCY
+#define BOARD_TIM2_FREQUENCY    STM32L4_HCLK_FREQUENCY
+#define BOARD_TIM3_FREQUENCY    STM32L4_HCLK_FREQUENCY
+#define BOARD_TIM4_FREQUENCY    STM32L4_HCLK_FREQUENCY
+#define BOARD_TIM5_FREQUENCY    STM32L4_HCLK_FREQUENCY
+#define BOARD_TIM6_FREQUENCY    STM32L4_HCLK_FREQUENCY
+#define BOARD_TIM7_FREQUENCY    STM32L4_HCLK_FREQUENCY
+#define BOARD_TIM8_FREQUENCY    STM32L4_HCLK_FREQUENCY
+#define BOARD_TIM15_FREQUENCY   STM32L4_HCLK_FREQUENCY
+#define BOARD_TIM16_FREQUENCY   STM32L4_HCLK_FREQUENCY
+#define BOARD_TIM17_FREQUENCY   STM32L4_HCLK_FREQUENCY
+#define BOARD_LPTIM1_FREQUENCY  STM32L4_HCLK_FREQUENCY
+#define BOARD_LPTIM2_FREQUENCY  STM32L4_HCLK_FREQUENCY
+
+/* FLASH wait states
+ *
+ *  --------- ---------- -----------
+ *  VCORE     MAX SYSCLK WAIT STATES
+ *  --------- ---------- -----------
+ *  Range 1     20 MHz     0
+ *  boost       40 MHz     1
+ *              60 MHz     2
+ *              80 MHz     3
+ *             100 MHz     4
+ *             120 MHz     5
+ *  --------- ---------- -----------
+ *
+ * The ART accelerator (CONFIG_STM32L4_FLASH_PREFETCH plus the always-on
+ * instruction and data caches) hides most of these wait states for
+ * sequential code.
+ */
+
+#define BOARD_FLASH_WAITSTATES    5
+
+/* SDMMC dividers.
+ *
+ * SDMMCCLK=48MHz, SDMMC_CK=SDMMCCLK/(118+2)=400 KHz
+ */
+
+#define STM32_SDMMC_INIT_CLKDIV         (118 << STM32_SDMMC_CLKCR_CLKDIV_SHIFT)
+
+/* DMA ON:  SDMMCCLK=48MHz, SDMMC_CK=SDMMCCLK/(1+2)=16 MHz
+ * DMA OFF: SDMMCCLK=48MHz, SDMMC_CK=SDMMCCLK/(2+2)=12 MHz
+ */
+
+#ifdef CONFIG_SDIO_DMA
+#  define STM32_SDMMC_MMCXFR_CLKDIV     (1 << STM32_SDMMC_CLKCR_CLKDIV_SHIFT)
+#  define STM32_SDMMC_SDXFR_CLKDIV      (1 << STM32_SDMMC_CLKCR_CLKDIV_SHIFT)
+#else
+#  define STM32_SDMMC_MMCXFR_CLKDIV     (2 << STM32_SDMMC_CLKCR_CLKDIV_SHIFT)
+#  define STM32_SDMMC_SDXFR_CLKDIV      (2 << STM32_SDMMC_CLKCR_CLKDIV_SHIFT)
+#endif
+
+/* LED definitions **********************************************************/
+
+/* The Nucleo-L4R5ZI board has numerous LEDs but only three, LD1 a Green LED,
+ * LD2 a Blue LED and LD3 a Red LED, that can be controlled by software.
+ * The following definitions assume the default Solder Bridges are installed.
+ *
+ * If CONFIG_ARCH_LEDS is not defined, then the user can control the LEDs
+ * in any way.
+ * The following definitions are used to access individual LEDs.
+ */
+
+/* LED index values for use with board_userled() */
+
+#define BOARD_LED1        0
+#define BOARD_LED2        1
+#define BOARD_LED3        2
+#define BOARD_NLEDS       3
+
+#define BOARD_LED_GREEN   BOARD_LED1
+#define BOARD_LED_BLUE    BOARD_LED2
+#define BOARD_LED_RED     BOARD_LED3
+
+/* LED bits for use with board_userled_all() */
+
+#define BOARD_LED1_BIT    (1 << BOARD_LED1)
+#define BOARD_LED2_BIT    (1 << BOARD_LED2)
+#define BOARD_LED3_BIT    (1 << BOARD_LED3)
+
+/* If CONFIG_ARCH_LEDS is defined, the usage by the board port is defined in
+ * include/board.h and src/stm32_autoleds.c. The LEDs are used to encode
+ * OS-related events as follows:
+ *
+ *
+ *   SYMBOL                     Meaning                      LED state
+ *                                                        Red   Green Blue
+ *   ----------------------  --------------------------  ------ ------ ----
+ */
+
+#define LED_STARTED        0 /* NuttX has been started   OFF    OFF   OFF  */
+#define LED_HEAPALLOCATE   1 /* Heap has been allocated  OFF    OFF   ON   */
+#define LED_IRQSENABLED    2 /* Interrupts enabled       OFF    ON    OFF  */
+#define LED_STACKCREATED   3 /* Idle stack created       OFF    ON    ON   */
+#define LED_INIRQ          4 /* In an interrupt          N/C    N/C   GLOW */
+#define LED_SIGNAL         5 /* In a signal handler      N/C    GLOW  N/C  */
+#define LED_ASSERTION      6 /* An assertion failed      GLOW   N/C   GLOW */
+#define LED_PANIC          7 /* The system has crashed   Blink  OFF   N/C  */
+#define LED_IDLE           8 /* MCU is is sleep mode     ON     OFF   OFF  */
+
+/* Thus if the Green LED is statically on, NuttX has successfully booted and
+ * is, apparently, running normally.  If the Red LED is flashing at
+ * approximately 2Hz, then a fatal error has been detected and the system
+ * has halted.
+ */
+
+/* Button definitions *******************************************************/
+
+/* The Nucleo-L4R5ZI supports one button:  Pushbutton B1, labeled "User", is
+ * connected to GPIO PC13.
+ * A high value will be sensed when the button is depressed.
+ */
+
+#define BUTTON_USER        0
+#define NUM_BUTTONS        1
+#define BUTTON_USER_BIT    (1 << BUTTON_USER)
+
+/* Alternate function pin selections ****************************************/
+
+/* LPUART1 is connected to the ST-LINK Virtual COM port on PG7 and PG8. */
+
+#define GPIO_LPUART1_TX    GPIO_LPUART1_TX_3
+#define GPIO_LPUART1_RX    GPIO_LPUART1_RX_3
+
+/* USART2 and USART3 on the ST Zio connector */
+
+#define GPIO_USART2_TX     GPIO_USART2_TX_2
+#define GPIO_USART2_RX     GPIO_USART2_RX_2
+#define GPIO_USART3_TX     GPIO_USART3_TX_4
+#define GPIO_USART3_RX     GPIO_USART3_RX_4
+
+/* SPI
+ *
+ *  PA6   SPI1_MISO CN12-13
+ *  PA7   SPI1_MOSI CN12-15
+ *  PA5   SPI1_SCK  CN12-11
+ */
+
+#define GPIO_SPI1_MISO     GPIO_SPI1_MISO_1
+#define GPIO_SPI1_MOSI     GPIO_SPI1_MOSI_1
+#define GPIO_SPI1_SCK      GPIO_SPI1_SCK_1
+
+/* I2C
+ *
+ *  PB8   I2C1_SCL CN12-3
+ *  PB9   I2C1_SDA CN12-5
+ */
+
+#define GPIO_I2C1_SCL      GPIO_I2C1_SCL_2
+#define GPIO_I2C1_SDA      GPIO_I2C1_SDA_2
+
+/* DMA channels *************************************************************/
+
+/* All requests are routed through DMAMUX1.  The console and the Zio USARTs
+ * receive on DMA1 so that DMA2 remains free for SDMMC, SPI and ADC.
+ */
+
+#define DMAMAP_LPUART1_RX  DMAMAP_LPUART1_RX_0
+#define DMAMAP_LPUART1_TX  DMAMAP_LPUART1_TX_0
+#define DMAMAP_USART2_RX   DMAMAP_USART2_RX_0
+#define DMAMAP_USART2_TX   DMAMAP_USART2_TX_0
+#define DMAMAP_USART3_RX   DMAMAP_USART3_RX_0
+#define DMAMAP_USART3_TX   DMAMAP_USART3_TX_0
+
+#define DMACHAN_SPI1_RX    DMAMAP_SPI1_RX_1
+#define DMACHAN_SPI1_TX    DMAMAP_SPI1_TX_1
+
+#define DMACHAN_I2C1_RX    DMAMAP_I2C1_RX_0
+#define DMACHAN_I2C1_TX    DMAMAP_I2C1_TX_0
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifndef __ASSEMBLY__
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32l4_board_initialize
+ *
+ * Description:
+ *   All STM32 architectures must provide the following entry point.  This
+ *   entry point is called early in the initialization -- after all memory
+ *   has been configured and mapped but before any devices have been
+ *   initialized.
+ *
+ ****************************************************************************/
+
+void stm32l4_board_initialize(void);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __ASSEMBLY__ */
+#endif /* __BOARDS_ARM_STM32L4_NUCLEO_L4R5ZI_INCLUDE_BOARD_H */
@@ -0,0 +1,549 @@
+/****************************************************************************
+ * boards/arm/stm32l4/nucleo-l4r5zi/src/stm32_ctxsw.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Scheduler and IPC benchmark suite.
+ *
+ * Each test collects CONFIG_NUCLEOL4R5ZI_CTXSW_NSAMPLES samples of the DWT
+ * cycle counter (up_perf_gettime()) and reports min/avg/max and the 50th,
+ * 90th and 99th percentiles:
+ *
+ *   switch      Two threads of the same priority hand a pair of semaphores
+ *               back and forth; half the round trip is one blocking context
+ *               switch including the sem_post()/sem_wait() around it.  Run
+ *               once with threads that never execute an FP instruction and
+ *               once with threads that do, which shows what
+ *               CONFIG_ARMV7M_LAZYFPU saves for tasks that do not use the
+ *               FPU.
+ *   wakeup      From sem_post() until a higher priority thread blocked in
+ *               sem_wait() runs.
+ *   mqueue      mq_send() and mq_receive() round trip through a thread of
+ *               the same priority.
+ *   mutex       From pthread_mutex_unlock() until a higher priority thread
+ *               blocked in pthread_mutex_lock() owns the mutex.
+ *   lock        One uncontended lock and unlock of an nxmutex, a pthread
+ *               mutex and a semaphore, including the two reads of the
+ *               cycle counter.  Run with and without CONFIG_SEM_FASTPATH
+ *               to see what the atomic fast path saves.
+ *
+ * The samples include the interrupts that happen to hit them, which is what
+ * the maximum and the high percentiles show.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <fcntl.h>
+#include <mqueue.h>
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/mutex.h>
+
+#include <arch/board/board.h>
+
+#include "nucleo-l4r5zi.h"
+
+#ifdef CONFIG_NUCLEOL4R5ZI_CTXSW
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_ARCH_PERF_EVENTS
+#  error CONFIG_ARCH_PERF_EVENTS is required
+#endif
+
+#define CTXSW_NSAMPLES CONFIG_NUCLEOL4R5ZI_CTXSW_NSAMPLES
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct ctxsw_s
+{
+  sem_t ping;                       /* switch: posted by ctxsw_main */
+  sem_t pong;                       /* switch: posted by the partner */
+  sem_t wake;                       /* wakeup: posted by ctxsw_main */
+  sem_t go;                         /* mutex: start the contender */
+  pthread_mutex_t mutex;            /* mutex: the contended mutex */
+  mutex_t nxlock;                   /* lock: the nxmutex */
+  pthread_mutex_t plock;            /* lock: the pthread mutex */
+  sem_t slock;                      /* lock: the semaphore */
+#ifndef CONFIG_DISABLE_MQUEUE
+  mqd_t req;                        /* mqueue: requests to the partner */
+  mqd_t rsp;                        /* mqueue: responses from the partner */
+#endif
+  volatile unsigned long stamp;     /* Start time set by ctxsw_main */
+  volatile unsigned long delta;     /* Sample taken by the helper thread */
+  volatile bool fpu;                /* switch: execute FP instructions */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct ctxsw_s g_ctxsw =
+{
+  .ping  = SEM_INITIALIZER(0),
+  .pong  = SEM_INITIALIZER(0),
+  .wake  = SEM_INITIALIZER(0),
+  .go    = SEM_INITIALIZER(0),
+  .mutex  = PTHREAD_MUTEX_INITIALIZER,
+  .nxlock = NXMUTEX_INITIALIZER,
+  .plock  = PTHREAD_MUTEX_INITIALIZER,
+  .slock  = SEM_INITIALIZER(1),
+};
+
+static unsigned long g_samples[CTXSW_NSAMPLES];
+
+static volatile float g_fpdummy;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ctxsw_usefpu
+ *
+ * Description:
+ *   Execute an FP instruction, so that the calling thread gets an FP
+ *   context.
+ *
+ ****************************************************************************/
+
+static void ctxsw_usefpu(void)
+{
+  g_fpdummy = g_fpdummy * 0.5f + 1.0f;
+}
+
+/****************************************************************************
+ * Name: ctxsw_compare
+ *
+ * Description:
+ *   qsort() comparison of two samples.
+ *
+ ****************************************************************************/
+
+static int ctxsw_compare(const void *a, const void *b)
+{
+  unsigned long sa = *(const unsigned long *)a;
+  unsigned long sb = *(const unsigned long *)b;
+
+  return sa < sb ? -1 : sa > sb;
+}
+
+/****************************************************************************
+ * Name: ctxsw_report
+ *
+ * Description:
+ *   Print the statistics of the samples of one test.
+ *
+ ****************************************************************************/
+
+static void ctxsw_report(const char *name)
+{
+  unsigned long long sum = 0;
+  int i;
+
+  qsort(g_samples, CTXSW_NSAMPLES, sizeof(g_samples[0]), ctxsw_compare);
+
+  for (i = 0; i < CTXSW_NSAMPLES; i++)
+    {
+      sum += g_samples[i];
+    }
+
+  printf("%-12s %7lu %7lu %7lu %7lu %7lu %7lu\n", name,
+         g_samples[0], (unsigned long)(sum / CTXSW_NSAMPLES),
+         g_samples[CTXSW_NSAMPLES * 50 / 100],
+         g_samples[CTXSW_NSAMPLES * 90 / 100],
+         g_samples[CTXSW_NSAMPLES * 99 / 100],
+         g_samples[CTXSW_NSAMPLES - 1]);
+}
+
+/****************************************************************************
+ * Name: ctxsw_thread
+ *
+ * Description:
+ *   Start a helper thread at the given priority.
+ *
+ ****************************************************************************/
+
+static int ctxsw_thread(int priority, pthread_startroutine_t entry)
+{
+  struct sched_param param;
+  pthread_attr_t attr;
+  pthread_t thread;
+  int ret;
+
+  pthread_attr_init(&attr);
+  pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+  param.sched_priority = priority;
+  pthread_attr_setschedparam(&attr, &param);
+
+  ret = pthread_create(&thread, &attr, entry, NULL);
+  pthread_attr_destroy(&attr);
+  if (ret != 0)
+    {
+      fprintf(stderr, "ctxsw_main: ERROR: pthread_create failed: %d\n",
+              ret);
+      return -ret;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ctxsw_partner
+ *
+ * Description:
+ *   switch: answers each ping with a pong.
+ *
+ ****************************************************************************/
+
+static void *ctxsw_partner(void *arg)
+{
+  for (; ; )
+    {
+      sem_wait(&g_ctxsw.ping);
+
+      if (g_ctxsw.fpu)
+        {
+          ctxsw_usefpu();
+        }
+
+      sem_post(&g_ctxsw.pong);
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: ctxsw_switch
+ ****************************************************************************/
+
+static void ctxsw_switch(bool fpu)
+{
+  unsigned long start;
+  int i;
+
+  g_ctxsw.fpu = fpu;
+
+  for (i = 0; i < CTXSW_NSAMPLES; i++)
+    {
+      if (fpu)
+        {
+          ctxsw_usefpu();
+        }
+
+      start = up_perf_gettime();
+      sem_post(&g_ctxsw.ping);
+      sem_wait(&g_ctxsw.pong);
+      g_samples[i] = (up_perf_gettime() - start) / 2;
+    }
+
+  ctxsw_report(fpu ? "switch/fpu" : "switch");
+}
+
+/****************************************************************************
+ * Name: ctxsw_waiter
+ *
+ * Description:
+ *   wakeup: takes the time at which it returns from sem_wait().
+ *
+ ****************************************************************************/
+
+static void *ctxsw_waiter(void *arg)
+{
+  for (; ; )
+    {
+      sem_wait(&g_ctxsw.wake);
+      g_ctxsw.delta = up_perf_gettime() - g_ctxsw.stamp;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: ctxsw_wakeup
+ ****************************************************************************/
+
+static void ctxsw_wakeup(void)
+{
+  int i;
+
+  /* The waiter preempts us within sem_post() and is blocked again when it
+   * returns.
+   */
+
+  for (i = 0; i < CTXSW_NSAMPLES; i++)
+    {
+      g_ctxsw.stamp = up_perf_gettime();
+      sem_post(&g_ctxsw.wake);
+      g_samples[i] = g_ctxsw.delta;
+    }
+
+  ctxsw_report("wakeup");
+}
+
+#ifndef CONFIG_DISABLE_MQUEUE
+/****************************************************************************
+ * Name: ctxsw_server
+ *
+ * Description:
+ *   mqueue: answers each request with a response.
+ *
+ ****************************************************************************/
+
+static void *ctxsw_server(void *arg)
+{
+  uint32_t msg;
+
+  for (; ; )
+    {
+      if (mq_receive(g_ctxsw.req, (char *)&msg, sizeof(msg), NULL) ==
+          sizeof(msg))
+        {
+          mq_send(g_ctxsw.rsp, (const char *)&msg, sizeof(msg), 0);
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: ctxsw_mqueue
+ ****************************************************************************/
+
+static int ctxsw_mqueue(int priority)
+{
+  struct mq_attr attr;
+  unsigned long start;
+  uint32_t msg;
+  int ret;
+  int i;
+
+  attr.mq_maxmsg  = 1;
+  attr.mq_msgsize = sizeof(msg);
+  attr.mq_flags   = 0;
+
+  g_ctxsw.req = mq_open("/ctxsw_req", O_RDWR | O_CREAT, 0666, &attr);
+  g_ctxsw.rsp = mq_open("/ctxsw_rsp", O_RDWR | O_CREAT, 0666, &attr);
+  if (g_ctxsw.req == (mqd_t)-1 || g_ctxsw.rsp == (mqd_t)-1)
+    {
+      fprintf(stderr, "ctxsw_main: ERROR: mq_open failed\n");
+      return ERROR;
+    }
+
+  ret = ctxsw_thread(priority, ctxsw_server);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < CTXSW_NSAMPLES; i++)
+    {
+      msg   = i;
+      start = up_perf_gettime();
+      mq_send(g_ctxsw.req, (const char *)&msg, sizeof(msg), 0);
+      mq_receive(g_ctxsw.rsp, (char *)&msg, sizeof(msg), NULL);
+      g_samples[i] = up_perf_gettime() - start;
+    }
+
+  ctxsw_report("mqueue");
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: ctxsw_contender
+ *
+ * Description:
+ *   mutex: blocks on the mutex held by ctxsw_main and takes the time at
+ *   which it gets it.
+ *
+ ****************************************************************************/
+
+static void *ctxsw_contender(void *arg)
+{
+  for (; ; )
+    {
+      sem_wait(&g_ctxsw.go);
+      pthread_mutex_lock(&g_ctxsw.mutex);
+      g_ctxsw.delta = up_perf_gettime() - g_ctxsw.stamp;
+      pthread_mutex_unlock(&g_ctxsw.mutex);
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: ctxsw_mutex
+ ****************************************************************************/
+
+static void ctxsw_mutex(void)
+{
+  int i;
+
+  for (i = 0; i < CTXSW_NSAMPLES; i++)
+    {
+      /* The contender preempts us within sem_post() and blocks on the
+       * mutex, then again within pthread_mutex_unlock() to take it.
+       */
+
+      pthread_mutex_lock(&g_ctxsw.mutex);
+      sem_post(&g_ctxsw.go);
+
+      g_ctxsw.stamp = up_perf_gettime();
+      pthread_mutex_unlock(&g_ctxsw.mutex);
+      g_samples[i] = g_ctxsw.delta;
+    }
+
+  ctxsw_report("mutex");
+}
+
+/****************************************************************************
+ * Name: ctxsw_lock
+ ****************************************************************************/
+
+static void ctxsw_lock(void)
+{
+  unsigned long start;
+  int i;
+
+  for (i = 0; i < CTXSW_NSAMPLES; i++)
+    {
+      start = up_perf_gettime();
+      nxmutex_lock(&g_ctxsw.nxlock);
+      nxmutex_unlock(&g_ctxsw.nxlock);
+      g_samples[i] = up_perf_gettime() - start;
+    }
+
+  ctxsw_report("lock/nxmutex");
+
+  for (i = 0; i < CTXSW_NSAMPLES; i++)
+    {
+      start = up_perf_gettime();
+      pthread_mutex_lock(&g_ctxsw.plock);
+      pthread_mutex_unlock(&g_ctxsw.plock);
+      g_samples[i] = up_perf_gettime() - start;
+    }
+
+  ctxsw_report("lock/pthread");
+
+  for (i = 0; i < CTXSW_NSAMPLES; i++)
+    {
+      start = up_perf_gettime();
+      sem_wait(&g_ctxsw.slock);
+      sem_post(&g_ctxsw.slock);
+      g_samples[i] = up_perf_gettime() - start;
+    }
+
+  ctxsw_report("lock/sem");
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ctxsw_main
+ *
+ * Description:
+ *   Main entry point in into the scheduler and IPC benchmark suite.
+ *
+ ****************************************************************************/
+
+int ctxsw_main(int argc, char *argv[])
+{
+  struct sched_param param;
+  int priority;
+  int ret;
+
+  printf("ctxsw_main: Started, lazy FPU context save %s, semaphore fast "
+         "path %s\n",
+#ifdef CONFIG_ARMV7M_LAZYFPU
+         "enabled",
+#else
+         "disabled",
+#endif
+#ifdef CONFIG_SEM_FASTPATH
+         "enabled"
+#else
+         "disabled"
+#endif
+         );
+
+  up_perf_init((void *)STM32L4_SYSCLK_FREQUENCY);
+
+  sched_getparam(0, &param);
+  priority = param.sched_priority;
+
+  /* Start the helpers: the ones at our priority are only reached by
+   * blocking, the higher priority ones preempt us.
+   */
+
+  ret = ctxsw_thread(priority, ctxsw_partner);
+  if (ret >= 0)
+    {
+      ret = ctxsw_thread(priority + 1, ctxsw_waiter);
+    }
+
+  if (ret >= 0)
+    {
+      ret = ctxsw_thread(priority + 1, ctxsw_contender);
+    }
+
+  if (ret < 0)
+    {
+      return EXIT_FAILURE;
+    }
+
+  printf("%d samples, cycles at %lu Hz:\n", CTXSW_NSAMPLES,
+         up_perf_getfreq());
+  printf("%-12s %7s %7s %7s %7s %7s %7s\n",
+         "test", "min", "avg", "p50", "p90", "p99", "max");
+
+  /* Integer only first: once a thread used the FPU it keeps its FP
+   * context.
+   */
+
+  ctxsw_switch(false);
+  ctxsw_wakeup();
+  ctxsw_mutex();
+  ctxsw_lock();
+#ifndef CONFIG_DISABLE_MQUEUE
+  ctxsw_mqueue(priority);
+#endif
+  ctxsw_switch(true);
+
+  fflush(stdout);
+  return EXIT_SUCCESS;
+}
+
+#endif /* CONFIG_NUCLEOL4R5ZI_CTXSW */
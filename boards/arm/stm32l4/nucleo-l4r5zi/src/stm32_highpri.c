@@ -0,0 +1,287 @@
+/****************************************************************************
+ * boards/arm/stm32l4/nucleo-l4r5zi/src/stm32_highpri.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Interrupt latency benchmark for OS-unaware, high priority interrupts.
+ *
+ * TIM6 counts at its full input clock and raises an update interrupt at
+ * CONFIG_NUCLEOL4R5ZI_HIGHPRI_RATE.  The handler is installed directly in
+ * the RAM vector table above the priority masked by critical sections, so
+ * the counter value read on entry is the interrupt latency in timer clocks.
+ * The samples are passed to this thread through a lock-free mailbox and a
+ * doorbell interrupt (TIM7, unused otherwise).  The thread deliberately
+ * holds critical sections meanwhile to show that they do not delay the high
+ * priority interrupt.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/semaphore.h>
+
+#include <arch/board/board.h>
+
+#include "arm_internal.h"
+#include "stm32l4_hipri.h"
+#include "stm32l4_tim.h"
+
+#include "nucleo-l4r5zi.h"
+
+#ifdef CONFIG_NUCLEOL4R5ZI_HIGHPRI
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_ARCH_HIPRI_INTERRUPT
+#  error CONFIG_ARCH_HIPRI_INTERRUPT is required
+#endif
+
+#ifndef CONFIG_ARCH_RAMVECTORS
+#  error CONFIG_ARCH_RAMVECTORS is required
+#endif
+
+#ifndef CONFIG_ARMV7M_USEBASEPRI
+#  error CONFIG_ARMV7M_USEBASEPRI is required
+#endif
+
+#ifdef CONFIG_STM32L4_TIM7
+#  error TIM7 is used as doorbell interrupt and must not be enabled
+#endif
+
+#define HIGHPRI_CLKIN      BOARD_TIM6_FREQUENCY
+#define HIGHPRI_PERIOD     (HIGHPRI_CLKIN / CONFIG_NUCLEOL4R5ZI_HIGHPRI_RATE)
+#define HIGHPRI_DOORBELL   STM32L4_IRQ_TIM7
+
+/* Number of mailbox slots, a power of two */
+
+#define HIGHPRI_NSLOTS     64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct highpri_s
+{
+  struct stm32l4_tim_dev_s *dev;    /* TIM6 driver instance */
+  struct stm32l4_mbox_s mbox;       /* Latency samples from the handler */
+  volatile uint32_t dropped;        /* Samples lost on a full mailbox */
+  sem_t sem;                        /* Posted by the doorbell interrupt */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uint32_t g_slots[HIGHPRI_NSLOTS];
+
+static struct highpri_s g_highpri =
+{
+  .mbox = STM32L4_MBOX_INITIALIZER(g_slots),
+  .sem  = SEM_INITIALIZER(0),
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tim6_handler
+ *
+ * Description:
+ *   The high priority TIM6 handler.  Entered directly from the vector
+ *   table; must not use any OS interface.
+ *
+ ****************************************************************************/
+
+static void tim6_handler(void)
+{
+  uint32_t latency;
+
+  /* The counter restarted from zero at the update event */
+
+  latency = getreg32(STM32L4_TIM6_CNT);
+  putreg32(0, STM32L4_TIM6_SR);
+
+  if (!stm32l4_mbox_put(&g_highpri.mbox, latency))
+    {
+      g_highpri.dropped++;
+    }
+
+  stm32l4_hipri_doorbell(HIGHPRI_DOORBELL);
+}
+
+/****************************************************************************
+ * Name: highpri_doorbell
+ *
+ * Description:
+ *   The normal priority doorbell interrupt, back under OS control.
+ *
+ ****************************************************************************/
+
+static int highpri_doorbell(int irq, void *context, void *arg)
+{
+  nxsem_post(&g_highpri.sem);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: highpri_main
+ *
+ * Description:
+ *   Main entry point in into the high priority interrupt benchmark.
+ *
+ ****************************************************************************/
+
+int highpri_main(int argc, char *argv[])
+{
+  struct stm32l4_tim_dev_s *dev;
+  irqstate_t flags;
+  clock_t start;
+  uint64_t sum;
+  uint32_t count;
+  uint32_t minlat;
+  uint32_t maxlat;
+  uint32_t latency;
+  uint32_t seconds;
+  int ret;
+
+  printf("highpri_main: Started\n");
+
+  /* Configure basic timer TIM6 to count at its input clock */
+
+  dev = stm32l4_tim_init(6);
+  if (!dev)
+    {
+      fprintf(stderr, "highpri_main: ERROR: stm32l4_tim_init(6) failed\n");
+      return EXIT_FAILURE;
+    }
+
+  g_highpri.dev = dev;
+
+  STM32L4_TIM_SETCLOCK(dev, HIGHPRI_CLKIN);
+  STM32L4_TIM_SETPERIOD(dev, HIGHPRI_PERIOD - 1);
+  printf("TIM6 CLKIN=%" PRIu32 " Hz, period=%" PRIu32 " cycles, "
+         "rate=%d Hz\n", (uint32_t)HIGHPRI_CLKIN, (uint32_t)HIGHPRI_PERIOD,
+         CONFIG_NUCLEOL4R5ZI_HIGHPRI_RATE);
+
+  /* Attach the normal priority doorbell */
+
+  ret = irq_attach(HIGHPRI_DOORBELL, highpri_doorbell, NULL);
+  if (ret < 0)
+    {
+      fprintf(stderr, "highpri_main: ERROR: irq_attach failed: %d\n", ret);
+      return EXIT_FAILURE;
+    }
+
+  up_enable_irq(HIGHPRI_DOORBELL);
+
+  /* Install the TIM6 vector above the critical section priority */
+
+  ret = stm32l4_hipri_attach(STM32L4_IRQ_TIM6, tim6_handler);
+  if (ret < 0)
+    {
+      fprintf(stderr,
+              "highpri_main: ERROR: stm32l4_hipri_attach failed: %d\n",
+              ret);
+      return EXIT_FAILURE;
+    }
+
+  up_enable_irq(STM32L4_IRQ_TIM6);
+  STM32L4_TIM_ENABLEINT(dev, BTIM_DIER_UIE);
+  STM32L4_TIM_ENABLE(dev);
+
+  /* Collect the samples */
+
+  seconds = 0;
+  for (; ; )
+    {
+      sum    = 0;
+      count  = 0;
+      minlat = UINT32_MAX;
+      maxlat = 0;
+      start  = clock_systime_ticks();
+
+      while (clock_systime_ticks() - start < TICK_PER_SEC)
+        {
+          nxsem_wait_uninterruptible(&g_highpri.sem);
+
+          while (stm32l4_mbox_get(&g_highpri.mbox, &latency))
+            {
+              sum += latency;
+              count++;
+
+              if (latency < minlat)
+                {
+                  minlat = latency;
+                }
+
+              if (latency > maxlat)
+                {
+                  maxlat = latency;
+                }
+            }
+
+          /* Load the system with critical sections.  They mask the doorbell
+           * but not the high priority interrupt.
+           */
+
+          flags = enter_critical_section();
+          up_udelay(CONFIG_NUCLEOL4R5ZI_HIGHPRI_CRITSEC);
+          leave_critical_section(flags);
+        }
+
+      seconds++;
+      printf("Elapsed time: %" PRIu32 " seconds\n", seconds);
+
+      if (count > 0)
+        {
+          printf("  Samples: %" PRIu32 ", dropped: %" PRIu32 "\n",
+                 count, g_highpri.dropped);
+          printf("  Latency: min %" PRIu32 " max %" PRIu32 " avg %" PRIu32
+                 " cycles, max %" PRIu32 " ns\n\n",
+                 minlat, maxlat, (uint32_t)(sum / count),
+                 (uint32_t)((uint64_t)maxlat * 1000000000ull /
+                            HIGHPRI_CLKIN));
+        }
+
+      fflush(stdout);
+    }
+
+  return EXIT_SUCCESS;
+}
+
+#endif /* CONFIG_NUCLEOL4R5ZI_HIGHPRI */
@@ -0,0 +1,285 @@
+/****************************************************************************
+ * boards/board_initcall.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/board_initcall.h>
+#include <nuttx/clock.h>
+#include <nuttx/init.h>
+#include <nuttx/spinlock.h>
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct board_initcall_s *g_initcalls; /* The active table */
+static int g_ninitcalls;                         /* Its number of steps */
+static uint32_t g_initstarted;                   /* Steps queued or skipped */
+static uint32_t g_initdone;                      /* Steps finished */
+static uint32_t g_initfailed;                    /* Steps failed or skipped */
+static spinlock_t g_initlock;
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void board_initcall_worker(FAR void *arg);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: board_initcall_schedule
+ *
+ * Description:
+ *   Queue the steps that have become ready and skip those whose
+ *   dependencies failed.
+ *
+ ****************************************************************************/
+
+static void board_initcall_schedule(void)
+{
+  FAR struct board_initcall_s *call;
+  irqstate_t flags;
+  uint32_t skipped = 0;
+  uint32_t ready = 0;
+  uint32_t bit;
+  uint8_t lowest;
+  bool changed;
+  int i;
+
+  flags = spin_lock_irqsave(&g_initlock);
+
+  do
+    {
+      /* Only the lowest level with unfinished steps may run */
+
+      lowest = UINT8_MAX;
+      for (i = 0; i < g_ninitcalls; i++)
+        {
+          if ((g_initdone & BOARD_INITCALL_DEP(i)) == 0 &&
+              g_initcalls[i].level < lowest)
+            {
+              lowest = g_initcalls[i].level;
+            }
+        }
+
+      changed = false;
+      for (i = 0; i < g_ninitcalls; i++)
+        {
+          call = &g_initcalls[i];
+          bit  = BOARD_INITCALL_DEP(i);
+
+          if ((g_initstarted & bit) != 0 || call->level > lowest)
+            {
+              continue;
+            }
+
+          if ((call->deps & g_initfailed) != 0)
+            {
+              /* Finishing a skipped step may release others */
+
+              call->result   = -ENODEV;
+              g_initstarted |= bit;
+              g_initdone    |= bit;
+              g_initfailed  |= bit;
+              skipped       |= bit;
+              changed        = true;
+            }
+          else if ((call->deps & ~g_initdone) == 0)
+            {
+              g_initstarted |= bit;
+              ready         |= bit;
+            }
+        }
+    }
+  while (changed);
+
+  spin_unlock_irqrestore(&g_initlock, flags);
+
+  for (i = 0; i < g_ninitcalls; i++)
+    {
+      call = &g_initcalls[i];
+      bit  = BOARD_INITCALL_DEP(i);
+
+      if ((skipped & bit) != 0)
+        {
+          binfo("%s: skipped\n", call->name);
+          nxsem_post(&call->done);
+        }
+      else if ((ready & bit) != 0)
+        {
+          work_queue(LPWORK, &call->work, board_initcall_worker, call, 0);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: board_initcall_worker
+ *
+ * Description:
+ *   Run one step on a low priority worker thread.
+ *
+ ****************************************************************************/
+
+static void board_initcall_worker(FAR void *arg)
+{
+  FAR struct board_initcall_s *call = arg;
+  irqstate_t flags;
+  clock_t start;
+  uint32_t bit;
+#ifdef CONFIG_SCHED_BOOTTRACE
+  unsigned long perf = up_perf_gettime();
+#endif
+
+  bit   = BOARD_INITCALL_DEP(call - g_initcalls);
+  start = clock_systime_ticks();
+
+  call->result = call->func();
+
+#ifdef CONFIG_SCHED_BOOTTRACE
+  boottrace_record(call->name, perf);
+#endif
+
+  binfo("%s: %d after %lu ms\n", call->name, call->result,
+        (unsigned long)TICK2MSEC(clock_systime_ticks() - start));
+
+  if (call->result < 0)
+    {
+      berr("ERROR: %s failed: %d\n", call->name, call->result);
+    }
+
+  flags = spin_lock_irqsave(&g_initlock);
+  g_initdone |= bit;
+  if (call->result < 0)
+    {
+      g_initfailed |= bit;
+    }
+
+  spin_unlock_irqrestore(&g_initlock, flags);
+
+  nxsem_post(&call->done);
+  board_initcall_schedule();
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: board_initcall_start
+ *
+ * Description:
+ *   Start the deferred initialization steps of the board.
+ *
+ ****************************************************************************/
+
+int board_initcall_start(FAR struct board_initcall_s *calls, int ncalls)
+{
+  int i;
+
+  if (calls == NULL || ncalls <= 0 || ncalls > BOARD_INITCALL_MAX)
+    {
+      return -EINVAL;
+    }
+
+  /* Every dependency must be an earlier step of no higher level, so that
+   * the table cannot deadlock.
+   */
+
+  for (i = 0; i < ncalls; i++)
+    {
+      uint32_t deps = calls[i].deps;
+      int j;
+
+      if (calls[i].func == NULL ||
+          (deps & ~(BOARD_INITCALL_DEP(i) - 1)) != 0)
+        {
+          return -EINVAL;
+        }
+
+      for (j = 0; j < i; j++)
+        {
+          if ((deps & BOARD_INITCALL_DEP(j)) != 0 &&
+              calls[j].level > calls[i].level)
+            {
+              return -EINVAL;
+            }
+        }
+    }
+
+  if (g_initcalls != NULL &&
+      g_initdone != (uint32_t)(((uint64_t)1 << g_ninitcalls) - 1))
+    {
+      return -EBUSY;
+    }
+
+  for (i = 0; i < ncalls; i++)
+    {
+      nxsem_init(&calls[i].done, 0, 0);
+      calls[i].result = -EINPROGRESS;
+    }
+
+  g_initcalls   = calls;
+  g_ninitcalls  = ncalls;
+  g_initstarted = 0;
+  g_initdone    = 0;
+  g_initfailed  = 0;
+
+  board_initcall_schedule();
+  return OK;
+}
+
+/****************************************************************************
+ * Name: board_initcall_wait
+ *
+ * Description:
+ *   Wait until a step of the active table has finished.
+ *
+ ****************************************************************************/
+
+int board_initcall_wait(FAR struct board_initcall_s *call)
+{
+  int ret;
+
+  DEBUGASSERT(g_initcalls != NULL && call >= g_initcalls &&
+              call < g_initcalls + g_ninitcalls);
+
+  /* Pass the count on to the next waiter */
+
+  ret = nxsem_wait_uninterruptible(&call->done);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  nxsem_post(&call->done);
+  return call->result;
+}
@@ -30,7 +30,9 @@
 #include <errno.h>
 #include <assert.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/board.h>
+#include <nuttx/init.h>
 #include <nuttx/lib/modlib.h>
 #include <nuttx/binfmt/symtab.h>
 #include <nuttx/drivers/ramdisk.h>
@@ -366,7 +368,15 @@ int boardctl(unsigned int cmd, uintptr_t arg)
 
       case BOARDIOC_INIT:
         {
+#ifdef CONFIG_SCHED_BOOTTRACE
+          unsigned long start = up_perf_gettime();
+#endif
+
           ret = board_app_initialize(arg);
+
+#ifdef CONFIG_SCHED_BOOTTRACE
+          boottrace_record("board_app_initialize", start);
+#endif
         }
         break;
 
@@ -0,0 +1,191 @@
+/****************************************************************************
+ * boards/compbench.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Compression benchmark.
+ *
+ * The LZF, LZ4 and heatshrink compressed streams that are enabled compress
+ * CONFIG_BOARD_COMPBENCH_SIZE bytes of generated log lines, written in
+ * chunks of 128 bytes and followed by one flush, into a null stream.  The
+ * cost is measured with up_perf_gettime() (CPU cycles on ARMv7-M), per
+ * stream and per input byte, and the ratio is the compressed size in
+ * percent of the input.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/streams.h>
+
+#include "perfsuite.h"
+
+#ifdef CONFIG_BOARD_COMPBENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define COMPBENCH_SIZE   CONFIG_BOARD_COMPBENCH_SIZE
+#define COMPBENCH_CHUNK  128
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static char g_compbench_input[COMPBENCH_SIZE];
+
+#ifdef CONFIG_LIBC_LZF
+static struct lib_lzfoutstream_s g_compbench_lzf;
+#endif
+#ifdef CONFIG_STREAM_LZ4
+static struct lib_lz4outstream_s g_compbench_lz4;
+#endif
+#ifdef CONFIG_STREAM_HEATSHRINK
+static struct lib_hsoutstream_s g_compbench_hs;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: compbench_fill
+ *
+ * Description:
+ *   Fill the input with log lines whose fields change from line to line.
+ *
+ ****************************************************************************/
+
+static void compbench_fill(void)
+{
+  unsigned int seed = 0x2545f491;
+  size_t len = 0;
+  char line[96];
+  int n;
+  int i;
+
+  for (i = 0; len < COMPBENCH_SIZE; i++)
+    {
+      seed ^= seed << 13;
+      seed ^= seed >> 17;
+      seed ^= seed << 5;
+
+      n = snprintf(line, sizeof(line),
+                   "[%6d.%03d] sensor%u: temp=%u.%02u rssi=-%u state=%s\n",
+                   i * 13 / 10, (i * 137) % 1000, seed % 8,
+                   20 + seed % 5, (seed >> 8) % 100, 40 + (seed >> 16) % 50,
+                   seed & 0x100 ? "OK" : "IDLE");
+      if (n > COMPBENCH_SIZE - len)
+        {
+          n = COMPBENCH_SIZE - len;
+        }
+
+      memcpy(&g_compbench_input[len], line, n);
+      len += n;
+    }
+}
+
+/****************************************************************************
+ * Name: compbench_run
+ *
+ * Description:
+ *   Compress the input through one stream and print the result.
+ *
+ ****************************************************************************/
+
+static void compbench_run(FAR const char *name,
+                          FAR struct lib_outstream_s *stream,
+                          FAR struct lib_outstream_s *null)
+{
+  unsigned long start;
+  unsigned long cost;
+  size_t i;
+
+  start = up_perf_gettime();
+  for (i = 0; i < COMPBENCH_SIZE; i += COMPBENCH_CHUNK)
+    {
+      lib_stream_puts(stream, &g_compbench_input[i],
+                      COMPBENCH_SIZE - i < COMPBENCH_CHUNK ?
+                      COMPBENCH_SIZE - i : COMPBENCH_CHUNK);
+    }
+
+  lib_stream_flush(stream);
+  cost = up_perf_gettime() - start;
+
+  printf("%-10s %8d %5d%% %10lu %6lu\n", name, null->nput,
+         null->nput * 100 / COMPBENCH_SIZE, cost, cost / COMPBENCH_SIZE);
+  perfsuite_result("comp", "perf", cost, "%s", name);
+  perfsuite_result("comp", "bytes", null->nput, "%s/size", name);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: compbench_main
+ *
+ * Description:
+ *   Main entry point into the compression benchmark.  Can be used as
+ *   CONFIG_INIT_ENTRYPOINT.
+ *
+ ****************************************************************************/
+
+int compbench_main(int argc, FAR char *argv[])
+{
+  struct lib_outstream_s null;
+
+  compbench_fill();
+
+  printf("compbench_main: %d bytes, costs in up_perf_gettime() units "
+         "at %lu Hz\n", COMPBENCH_SIZE, up_perf_getfreq());
+  printf("%-10s %8s %6s %10s %6s\n",
+         "stream", "output", "ratio", "cost", "/byte");
+
+#ifdef CONFIG_LIBC_LZF
+  lib_nulloutstream(&null);
+  lib_lzfoutstream(&g_compbench_lzf, &null);
+  compbench_run("lzf", &g_compbench_lzf.public, &null);
+#endif
+
+#ifdef CONFIG_STREAM_LZ4
+  lib_nulloutstream(&null);
+  lib_lz4outstream(&g_compbench_lz4, &null);
+  compbench_run("lz4", &g_compbench_lz4.public, &null);
+#endif
+
+#ifdef CONFIG_STREAM_HEATSHRINK
+  lib_nulloutstream(&null);
+  lib_hsoutstream(&g_compbench_hs, &null);
+  compbench_run("heatshrink", &g_compbench_hs.public, &null);
+#endif
+
+  fflush(stdout);
+  return EXIT_SUCCESS;
+}
+
+#endif /* CONFIG_BOARD_COMPBENCH */
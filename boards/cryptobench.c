@@ -0,0 +1,337 @@
+/****************************************************************************
+ * boards/cryptobench.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Cryptography benchmark.
+ *
+ * Each of the AES, GHASH, AES-GCM, ChaCha20, Poly1305, ChaCha20-Poly1305
+ * and SHA-256 primitives of crypto/ processes a buffer of
+ * CONFIG_BOARD_CRYPTOBENCH_SIZE bytes several times.  The best cost is
+ * measured with up_perf_gettime() (CPU cycles on ARMv7-M) and printed per
+ * byte, so that the CRYPTO_* options that select faster implementations
+ * can be compared.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/param.h>
+
+#include <nuttx/arch.h>
+
+#include <crypto/aes.h>
+#include <crypto/chachapoly.h>
+#include <crypto/gmac.h>
+#include <crypto/poly1305.h>
+#include <crypto/rijndael.h>
+#include <crypto/sha2.h>
+
+#include "perfsuite.h"
+
+#ifdef CONFIG_BOARD_CRYPTOBENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CRYPTOBENCH_SIZE   CONFIG_BOARD_CRYPTOBENCH_SIZE
+#define CRYPTOBENCH_LOOPS  4
+#define CRYPTOBENCH_BLOCK  16
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct cryptobench_s
+{
+  FAR const char *name;
+  CODE void (*run)(FAR uint8_t *buf, size_t len);
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void cryptobench_aes(FAR uint8_t *buf, size_t len);
+static void cryptobench_rijndael(FAR uint8_t *buf, size_t len);
+static void cryptobench_ghash(FAR uint8_t *buf, size_t len);
+static void cryptobench_gcm(FAR uint8_t *buf, size_t len);
+static void cryptobench_chacha(FAR uint8_t *buf, size_t len);
+static void cryptobench_poly1305(FAR uint8_t *buf, size_t len);
+static void cryptobench_chapoly(FAR uint8_t *buf, size_t len);
+static void cryptobench_sha256(FAR uint8_t *buf, size_t len);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const uint8_t g_cryptobench_key[CHACHA20_KEYSIZE + CHACHA20_SALT] =
+{
+  0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe,
+  0x2b, 0x73, 0xae, 0xf0, 0x85, 0x7d, 0x77, 0x81,
+  0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61, 0x08, 0xd7,
+  0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4,
+  0x00, 0x00, 0x00, 0x4a
+};
+
+static const struct cryptobench_s g_cryptobench[] =
+{
+  { "aes-ct",      cryptobench_aes      },
+  { "aes-table",   cryptobench_rijndael },
+  { "ghash",       cryptobench_ghash    },
+  { "aes-gcm",     cryptobench_gcm      },
+  { "chacha20",    cryptobench_chacha   },
+  { "poly1305",    cryptobench_poly1305 },
+  { "chapoly",     cryptobench_chapoly  },
+  { "sha256",      cryptobench_sha256   },
+};
+
+static uint8_t g_cryptobench_buf[CRYPTOBENCH_SIZE];
+static uint8_t g_cryptobench_out[CRYPTOBENCH_SIZE];
+
+static AES_CTX g_cryptobench_aes;
+static rijndael_ctx g_cryptobench_rijndael;
+static AES_GMAC_CTX g_cryptobench_gmac;
+static struct chacha20_ctx g_cryptobench_chacha;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cryptobench_aes
+ *
+ * Description:
+ *   Encrypt the buffer with the bit-sliced AES-256 of aes.c, in ECB mode.
+ *
+ ****************************************************************************/
+
+static void cryptobench_aes(FAR uint8_t *buf, size_t len)
+{
+  aes_encrypt_ecb(&g_cryptobench_aes, buf, g_cryptobench_out,
+                  len / CRYPTOBENCH_BLOCK);
+}
+
+/****************************************************************************
+ * Name: cryptobench_rijndael
+ *
+ * Description:
+ *   Encrypt the buffer with the T-table AES-256 of rijndael.c.
+ *
+ ****************************************************************************/
+
+static void cryptobench_rijndael(FAR uint8_t *buf, size_t len)
+{
+  size_t i;
+
+  for (i = 0; i + CRYPTOBENCH_BLOCK <= len; i += CRYPTOBENCH_BLOCK)
+    {
+      rijndael_encrypt(&g_cryptobench_rijndael, &buf[i],
+                       &g_cryptobench_out[i]);
+    }
+}
+
+/****************************************************************************
+ * Name: cryptobench_ghash
+ *
+ * Description:
+ *   Hash the buffer with the GHASH selected by CONFIG_CRYPTO_GHASH_CTMUL.
+ *
+ ****************************************************************************/
+
+static void cryptobench_ghash(FAR uint8_t *buf, size_t len)
+{
+  (*ghash_update)(&g_cryptobench_gmac.ghash, buf,
+                  len & ~(GMAC_BLOCK_LEN - 1));
+}
+
+/****************************************************************************
+ * Name: cryptobench_gcm
+ *
+ * Description:
+ *   Encrypt the buffer with AES-256 in counter mode and hash the result,
+ *   which is the work of AES-GCM for each byte of payload.
+ *
+ ****************************************************************************/
+
+static void cryptobench_gcm(FAR uint8_t *buf, size_t len)
+{
+  uint8_t ctr[CRYPTOBENCH_BLOCK];
+  uint8_t ks[CRYPTOBENCH_BLOCK];
+  size_t i;
+  int j;
+
+  memset(ctr, 0, sizeof(ctr));
+  len &= ~(CRYPTOBENCH_BLOCK - 1);
+
+  for (i = 0; i < len; i += CRYPTOBENCH_BLOCK)
+    {
+      ctr[CRYPTOBENCH_BLOCK - 1]++;
+      aes_encrypt(&g_cryptobench_aes, ctr, ks);
+      for (j = 0; j < CRYPTOBENCH_BLOCK; j++)
+        {
+          g_cryptobench_out[i + j] = buf[i + j] ^ ks[j];
+        }
+    }
+
+  (*ghash_update)(&g_cryptobench_gmac.ghash, g_cryptobench_out, len);
+}
+
+/****************************************************************************
+ * Name: cryptobench_chacha
+ *
+ * Description:
+ *   Encrypt the buffer in place with ChaCha20.
+ *
+ ****************************************************************************/
+
+static void cryptobench_chacha(FAR uint8_t *buf, size_t len)
+{
+  size_t i;
+
+  for (i = 0; i + CHACHA20_BLOCK_LEN <= len; i += CHACHA20_BLOCK_LEN)
+    {
+      chacha20_crypt((caddr_t)&g_cryptobench_chacha, &buf[i]);
+    }
+}
+
+/****************************************************************************
+ * Name: cryptobench_poly1305
+ *
+ * Description:
+ *   Authenticate the buffer with Poly1305.
+ *
+ ****************************************************************************/
+
+static void cryptobench_poly1305(FAR uint8_t *buf, size_t len)
+{
+  poly1305_state state;
+  uint8_t tag[POLY1305_TAGLEN];
+
+  poly1305_init(&state, g_cryptobench_key);
+  poly1305_update(&state, buf, len);
+  poly1305_finish(&state, tag);
+}
+
+/****************************************************************************
+ * Name: cryptobench_chapoly
+ *
+ * Description:
+ *   Encrypt and authenticate the buffer with ChaCha20-Poly1305.
+ *
+ ****************************************************************************/
+
+static void cryptobench_chapoly(FAR uint8_t *buf, size_t len)
+{
+  chacha20poly1305_encrypt(g_cryptobench_out, buf,
+                           len - CHACHA20POLY1305_AUTHTAG_SIZE,
+                           NULL, 0, 1, g_cryptobench_key);
+}
+
+/****************************************************************************
+ * Name: cryptobench_sha256
+ *
+ * Description:
+ *   Hash the buffer with SHA-256.
+ *
+ ****************************************************************************/
+
+static void cryptobench_sha256(FAR uint8_t *buf, size_t len)
+{
+  uint8_t digest[SHA256_DIGEST_LENGTH];
+  SHA2_CTX ctx;
+
+  sha256init(&ctx);
+  sha256update(&ctx, buf, len);
+  sha256final(digest, &ctx);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cryptobench_main
+ *
+ * Description:
+ *   Main entry point into the cryptography benchmark.  Can be used as
+ *   CONFIG_INIT_ENTRYPOINT.
+ *
+ ****************************************************************************/
+
+int cryptobench_main(int argc, FAR char *argv[])
+{
+  unsigned long start;
+  unsigned long cost;
+  unsigned long best;
+  size_t i;
+  int j;
+
+  for (i = 0; i < CRYPTOBENCH_SIZE; i++)
+    {
+      g_cryptobench_buf[i] = (uint8_t)(i * 167 + 13);
+    }
+
+  aes_setkey(&g_cryptobench_aes, g_cryptobench_key, 32);
+  rijndael_set_key_enc_only(&g_cryptobench_rijndael, g_cryptobench_key,
+                            256);
+  aes_gmac_init(&g_cryptobench_gmac);
+  aes_gmac_setkey(&g_cryptobench_gmac, g_cryptobench_key, 36);
+  chacha20_setkey(&g_cryptobench_chacha, (FAR uint8_t *)g_cryptobench_key,
+                  sizeof(g_cryptobench_key));
+  chacha20_reinit((caddr_t)&g_cryptobench_chacha, g_cryptobench_out);
+
+  printf("cryptobench_main: %d bytes, costs in up_perf_gettime() units "
+         "at %lu Hz, best of %d\n",
+         CRYPTOBENCH_SIZE, up_perf_getfreq(), CRYPTOBENCH_LOOPS);
+  printf("%-10s %10s %8s\n", "primitive", "cost", "/byte");
+
+  for (i = 0; i < nitems(g_cryptobench); i++)
+    {
+      best = ~0ul;
+      for (j = 0; j < CRYPTOBENCH_LOOPS; j++)
+        {
+          start = up_perf_gettime();
+          g_cryptobench[i].run(g_cryptobench_buf, CRYPTOBENCH_SIZE);
+          cost = up_perf_gettime() - start;
+          if (cost < best)
+            {
+              best = cost;
+            }
+        }
+
+      printf("%-10s %10lu %5lu.%02lu\n", g_cryptobench[i].name, best,
+             best / CRYPTOBENCH_SIZE,
+             best % CRYPTOBENCH_SIZE * 100 / CRYPTOBENCH_SIZE);
+      perfsuite_result("crypto", "perf", best, "%s/%d",
+                       g_cryptobench[i].name, CRYPTOBENCH_SIZE);
+    }
+
+  fflush(stdout);
+  return EXIT_SUCCESS;
+}
+
+#endif /* CONFIG_BOARD_CRYPTOBENCH */
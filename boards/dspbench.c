@@ -0,0 +1,787 @@
+/****************************************************************************
+ * boards/dspbench.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Digital signal processing benchmark.
+ *
+ * The libdsp kernels that use B16_MAC2, the b16 Clarke and Park transforms
+ * and svm3_b16(), and the float and b16 FIR, biquad cascade and moving
+ * average block filters process CONFIG_BOARD_DSPBENCH_COUNT pseudo-random
+ * samples.  Each is compared with scalar code that does the same work one
+ * sample and one rounded product at a time, as libdsp did before.  The
+ * cost of the best of DSPBENCH_ROUNDS runs is measured with
+ * up_perf_gettime() (CPU cycles on ARMv7-M) and printed per sample.  The
+ * error is the largest difference between the two outputs, in b16 units
+ * for the fixed point code and in units of 2^-24 for the float code.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <dsp.h>
+#include <dspb16.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include <nuttx/arch.h>
+
+#include "perfsuite.h"
+
+#ifdef CONFIG_BOARD_DSPBENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define DSPBENCH_COUNT    CONFIG_BOARD_DSPBENCH_COUNT
+#define DSPBENCH_NTAPS    CONFIG_BOARD_DSPBENCH_NTAPS
+#define DSPBENCH_NSTAGES  4
+#define DSPBENCH_ROUNDS   8
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct dspbench_test_s
+{
+  FAR const char *name;  /* Name of the test */
+  CODE void (*lib)(void);
+  CODE void (*scalar)(void);
+  bool b16;              /* True if the outputs are b16 */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void dspbench_clarke_b16(void);
+static void dspbench_clarke_b16_scalar(void);
+static void dspbench_park_b16(void);
+static void dspbench_park_b16_scalar(void);
+static void dspbench_svm3_b16(void);
+static void dspbench_svm3_b16_scalar(void);
+static void dspbench_fir(void);
+static void dspbench_fir_scalar(void);
+static void dspbench_fir_b16(void);
+static void dspbench_fir_b16_scalar(void);
+static void dspbench_biquad(void);
+static void dspbench_biquad_scalar(void);
+static void dspbench_biquad_b16(void);
+static void dspbench_biquad_b16_scalar(void);
+static void dspbench_mavg(void);
+static void dspbench_mavg_scalar(void);
+static void dspbench_mavg_b16(void);
+static void dspbench_mavg_b16_scalar(void);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct dspbench_test_s g_dspbench[] =
+{
+  {
+    "clarke_b16", dspbench_clarke_b16, dspbench_clarke_b16_scalar, true
+  },
+  {
+    "park_b16", dspbench_park_b16, dspbench_park_b16_scalar, true
+  },
+  {
+    "svm3_b16", dspbench_svm3_b16, dspbench_svm3_b16_scalar, true
+  },
+  {
+    "fir", dspbench_fir, dspbench_fir_scalar, false
+  },
+  {
+    "fir_b16", dspbench_fir_b16, dspbench_fir_b16_scalar, true
+  },
+  {
+    "biquad", dspbench_biquad, dspbench_biquad_scalar, false
+  },
+  {
+    "biquad_b16", dspbench_biquad_b16, dspbench_biquad_b16_scalar, true
+  },
+  {
+    "mavg", dspbench_mavg, dspbench_mavg_scalar, false
+  },
+  {
+    "mavg_b16", dspbench_mavg_b16, dspbench_mavg_b16_scalar, true
+  }
+};
+
+/* Low pass biquad, cut-off at a tenth of the sample rate */
+
+static const float g_dspbench_biquad[5] =
+{
+  0.0675f, 0.1349f, 0.0675f, -1.1430f, 0.4128f
+};
+
+/* Inputs in <-0.5, 0.5> */
+
+static float g_dspbench_in[DSPBENCH_COUNT];
+static b16_t g_dspbench_in_b16[DSPBENCH_COUNT];
+static phase_angle_b16_t g_dspbench_angle[DSPBENCH_COUNT];
+
+/* Coefficients */
+
+static float g_dspbench_fircoef[DSPBENCH_NTAPS];
+static b16_t g_dspbench_fircoef_b16[DSPBENCH_NTAPS];
+static float g_dspbench_bqcoef[5 * DSPBENCH_NSTAGES];
+static b16_t g_dspbench_bqcoef_b16[5 * DSPBENCH_NSTAGES];
+
+/* Filter state */
+
+static float g_dspbench_state[2 * DSPBENCH_NTAPS];
+static b16_t g_dspbench_state_b16[2 * DSPBENCH_NTAPS];
+
+/* Outputs of libdsp, [0], and of the scalar code, [1] */
+
+static float g_dspbench_out[2][2 * DSPBENCH_COUNT];
+static b16_t g_dspbench_out_b16[2][2 * DSPBENCH_COUNT];
+
+static uint32_t g_dspbench_seed;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t dspbench_rand(void)
+{
+  g_dspbench_seed ^= g_dspbench_seed << 13;
+  g_dspbench_seed ^= g_dspbench_seed >> 17;
+  g_dspbench_seed ^= g_dspbench_seed << 5;
+  return g_dspbench_seed;
+}
+
+/****************************************************************************
+ * Name: dspbench_setup
+ *
+ * Description:
+ *   Generate the inputs, the phase angles and the filter coefficients.
+ *
+ ****************************************************************************/
+
+static void dspbench_setup(void)
+{
+  float sum = 0.0f;
+  int i;
+
+  g_dspbench_seed = 0x2545f491;
+  for (i = 0; i < DSPBENCH_COUNT; i++)
+    {
+      g_dspbench_in[i] = (float)(dspbench_rand() & 0xffff) / 65536.0f -
+                         0.5f;
+      g_dspbench_in_b16[i] = ftob16(g_dspbench_in[i]);
+
+      phase_angle_update_b16(&g_dspbench_angle[i],
+                             ftob16(2.0f * M_PI_F * i / DSPBENCH_COUNT));
+    }
+
+  /* Triangular FIR window with a gain of one */
+
+  for (i = 0; i < DSPBENCH_NTAPS; i++)
+    {
+      g_dspbench_fircoef[i] = MIN(i + 1, DSPBENCH_NTAPS - i);
+      sum += g_dspbench_fircoef[i];
+    }
+
+  for (i = 0; i < DSPBENCH_NTAPS; i++)
+    {
+      g_dspbench_fircoef[i] /= sum;
+      g_dspbench_fircoef_b16[i] = ftob16(g_dspbench_fircoef[i]);
+    }
+
+  for (i = 0; i < 5 * DSPBENCH_NSTAGES; i++)
+    {
+      g_dspbench_bqcoef[i] = g_dspbench_biquad[i % 5];
+      g_dspbench_bqcoef_b16[i] = ftob16(g_dspbench_biquad[i % 5]);
+    }
+}
+
+/****************************************************************************
+ * Name: dspbench_clarke_b16
+ *
+ * Description:
+ *   The Clarke transform, with B16_MAC2 and with two rounded products.
+ *
+ ****************************************************************************/
+
+static void dspbench_clarke_b16(void)
+{
+  FAR b16_t *out = g_dspbench_out_b16[0];
+  abc_frame_b16_t abc;
+  ab_frame_b16_t ab;
+  int i;
+
+  for (i = 0; i < DSPBENCH_COUNT; i++)
+    {
+      abc.a = g_dspbench_in_b16[i];
+      abc.b = g_dspbench_in_b16[DSPBENCH_COUNT - 1 - i];
+      clarke_transform_b16(&abc, &ab);
+      out[2 * i]     = ab.a;
+      out[2 * i + 1] = ab.b;
+    }
+}
+
+static void dspbench_clarke_b16_scalar(void)
+{
+  FAR b16_t *out = g_dspbench_out_b16[1];
+  abc_frame_b16_t abc;
+  ab_frame_b16_t ab;
+  int i;
+
+  for (i = 0; i < DSPBENCH_COUNT; i++)
+    {
+      abc.a = g_dspbench_in_b16[i];
+      abc.b = g_dspbench_in_b16[DSPBENCH_COUNT - 1 - i];
+      ab.a  = abc.a;
+      ab.b  = b16mulb16(ONE_BY_SQRT3_B16, abc.a) +
+              b16mulb16(TWO_BY_SQRT3_B16, abc.b);
+      out[2 * i]     = ab.a;
+      out[2 * i + 1] = ab.b;
+    }
+}
+
+/****************************************************************************
+ * Name: dspbench_park_b16
+ *
+ * Description:
+ *   The Park transform, with B16_MAC2 and with two rounded products.
+ *
+ ****************************************************************************/
+
+static void dspbench_park_b16(void)
+{
+  FAR b16_t *out = g_dspbench_out_b16[0];
+  ab_frame_b16_t ab;
+  dq_frame_b16_t dq;
+  int i;
+
+  for (i = 0; i < DSPBENCH_COUNT; i++)
+    {
+      ab.a = g_dspbench_in_b16[i];
+      ab.b = g_dspbench_in_b16[DSPBENCH_COUNT - 1 - i];
+      park_transform_b16(&g_dspbench_angle[i], &ab, &dq);
+      out[2 * i]     = dq.d;
+      out[2 * i + 1] = dq.q;
+    }
+}
+
+static void dspbench_park_b16_scalar(void)
+{
+  FAR b16_t *out = g_dspbench_out_b16[1];
+  FAR phase_angle_b16_t *angle;
+  ab_frame_b16_t ab;
+  dq_frame_b16_t dq;
+  int i;
+
+  for (i = 0; i < DSPBENCH_COUNT; i++)
+    {
+      angle = &g_dspbench_angle[i];
+      ab.a  = g_dspbench_in_b16[i];
+      ab.b  = g_dspbench_in_b16[DSPBENCH_COUNT - 1 - i];
+      dq.d  = b16mulb16(angle->cos, ab.a) + b16mulb16(angle->sin, ab.b);
+      dq.q  = b16mulb16(angle->cos, ab.b) - b16mulb16(angle->sin, ab.a);
+      out[2 * i]     = dq.d;
+      out[2 * i + 1] = dq.q;
+    }
+}
+
+/****************************************************************************
+ * Name: dspbench_svm3_b16
+ *
+ * Description:
+ *   Space vector modulation of vectors of magnitude up to 0.7, with
+ *   svm3_b16() and with the auxiliary frame and the duty cycles computed
+ *   from rounded products.
+ *
+ ****************************************************************************/
+
+static void dspbench_svm3_b16(void)
+{
+  FAR b16_t *out = g_dspbench_out_b16[0];
+  struct svm3_state_b16_s s;
+  ab_frame_b16_t ab;
+  int i;
+
+  svm3_init_b16(&s);
+  for (i = 0; i < DSPBENCH_COUNT; i++)
+    {
+      ab.a = g_dspbench_in_b16[i];
+      ab.b = g_dspbench_in_b16[DSPBENCH_COUNT - 1 - i];
+      svm3_b16(&s, &ab);
+      out[2 * i]     = s.d_u;
+      out[2 * i + 1] = s.d_v + s.d_w;
+    }
+}
+
+static void dspbench_svm3_b16_scalar(void)
+{
+  FAR b16_t *out = g_dspbench_out_b16[1];
+  abc_frame_b16_t ijk;
+  b16_t t0;
+  b16_t t1;
+  b16_t t2;
+  b16_t u;
+  b16_t v;
+  b16_t w;
+  int i;
+
+  for (i = 0; i < DSPBENCH_COUNT; i++)
+    {
+      ijk.b = g_dspbench_in_b16[DSPBENCH_COUNT - 1 - i];
+      ijk.a = b16mulb16(-b16HALF, ijk.b) +
+              b16mulb16(SQRT3_BY_TWO_B16, g_dspbench_in_b16[i]);
+      ijk.c = -ijk.b - ijk.a;
+
+      /* The sector selects the active vectors.  u, v and w say which of
+       * T1 + T2, T1 or T2 and nothing each phase gets on top of the null
+       * vector time.
+       */
+
+      if (ijk.c <= 0)
+        {
+          if (ijk.a <= 0)
+            {
+              t1 = -ijk.c;
+              t2 = -ijk.a;
+              u  = t1;
+              v  = t1 + t2;
+              w  = 0;
+            }
+          else if (ijk.b <= 0)
+            {
+              t1 = -ijk.b;
+              t2 = -ijk.c;
+              u  = t1 + t2;
+              v  = 0;
+              w  = t1;
+            }
+          else
+            {
+              t1 = ijk.a;
+              t2 = ijk.b;
+              u  = t1 + t2;
+              v  = t2;
+              w  = 0;
+            }
+        }
+      else if (ijk.a <= 0)
+        {
+          if (ijk.b <= 0)
+            {
+              t1 = -ijk.a;
+              t2 = -ijk.b;
+              u  = 0;
+              v  = t1;
+              w  = t1 + t2;
+            }
+          else
+            {
+              t1 = ijk.b;
+              t2 = ijk.c;
+              u  = 0;
+              v  = t1 + t2;
+              w  = t2;
+            }
+        }
+      else
+        {
+          t1 = ijk.c;
+          t2 = ijk.a;
+          u  = t2;
+          v  = 0;
+          w  = t1 + t2;
+        }
+
+      t0 = b16ONE - t1 - t2;
+
+      out[2 * i]     = u + b16mulb16(t0, b16HALF);
+      out[2 * i + 1] = v + b16mulb16(t0, b16HALF) +
+                       w + b16mulb16(t0, b16HALF);
+    }
+}
+
+/****************************************************************************
+ * Name: dspbench_fir
+ *
+ * Description:
+ *   The FIR filter, on the block and one sample at a time on a circular
+ *   delay line.
+ *
+ ****************************************************************************/
+
+static void dspbench_fir(void)
+{
+  struct fir_filter_f32_s fir;
+
+  fir_filter_init(&fir, g_dspbench_fircoef, g_dspbench_state,
+                  DSPBENCH_NTAPS);
+  fir_filter(&fir, g_dspbench_in, g_dspbench_out[0], DSPBENCH_COUNT);
+}
+
+static void dspbench_fir_scalar(void)
+{
+  FAR float *delay = g_dspbench_state;
+  float acc;
+  int pos = 0;
+  int idx;
+  int i;
+  int k;
+
+  memset(delay, 0, DSPBENCH_NTAPS * sizeof(float));
+  for (i = 0; i < DSPBENCH_COUNT; i++)
+    {
+      delay[pos] = g_dspbench_in[i];
+      idx = pos;
+      acc = 0.0f;
+
+      for (k = 0; k < DSPBENCH_NTAPS; k++)
+        {
+          acc += g_dspbench_fircoef[k] * delay[idx];
+          idx  = (idx == 0 ? DSPBENCH_NTAPS : idx) - 1;
+        }
+
+      pos = pos + 1 == DSPBENCH_NTAPS ? 0 : pos + 1;
+      g_dspbench_out[1][i] = acc;
+    }
+}
+
+static void dspbench_fir_b16(void)
+{
+  struct fir_filter_b16_s fir;
+
+  fir_filter_init_b16(&fir, g_dspbench_fircoef_b16, g_dspbench_state_b16,
+                      DSPBENCH_NTAPS);
+  fir_filter_b16(&fir, g_dspbench_in_b16, g_dspbench_out_b16[0],
+                 DSPBENCH_COUNT);
+}
+
+static void dspbench_fir_b16_scalar(void)
+{
+  FAR b16_t *delay = g_dspbench_state_b16;
+  b16_t acc;
+  int pos = 0;
+  int idx;
+  int i;
+  int k;
+
+  memset(delay, 0, DSPBENCH_NTAPS * sizeof(b16_t));
+  for (i = 0; i < DSPBENCH_COUNT; i++)
+    {
+      delay[pos] = g_dspbench_in_b16[i];
+      idx = pos;
+      acc = 0;
+
+      for (k = 0; k < DSPBENCH_NTAPS; k++)
+        {
+          acc += b16mulb16(g_dspbench_fircoef_b16[k], delay[idx]);
+          idx  = (idx == 0 ? DSPBENCH_NTAPS : idx) - 1;
+        }
+
+      pos = pos + 1 == DSPBENCH_NTAPS ? 0 : pos + 1;
+      g_dspbench_out_b16[1][i] = acc;
+    }
+}
+
+/****************************************************************************
+ * Name: dspbench_biquad
+ *
+ * Description:
+ *   The biquad cascade, one stage at a time over the block and one sample
+ *   at a time through all stages.
+ *
+ ****************************************************************************/
+
+static void dspbench_biquad(void)
+{
+  struct biquad_f32_s bq;
+
+  biquad_init(&bq, g_dspbench_bqcoef, g_dspbench_state, DSPBENCH_NSTAGES);
+  biquad_cascade(&bq, g_dspbench_in, g_dspbench_out[0], DSPBENCH_COUNT);
+}
+
+static void dspbench_biquad_scalar(void)
+{
+  FAR const float *c;
+  FAR float *d;
+  float x;
+  float y;
+  int stage;
+  int i;
+
+  memset(g_dspbench_state, 0, sizeof(g_dspbench_state));
+  for (i = 0; i < DSPBENCH_COUNT; i++)
+    {
+      c = g_dspbench_bqcoef;
+      d = g_dspbench_state;
+      x = g_dspbench_in[i];
+
+      for (stage = 0; stage < DSPBENCH_NSTAGES; stage++)
+        {
+          y    = c[0] * x + d[0];
+          d[0] = c[1] * x - c[3] * y + d[1];
+          d[1] = c[2] * x - c[4] * y;
+          x    = y;
+          c   += 5;
+          d   += 2;
+        }
+
+      g_dspbench_out[1][i] = x;
+    }
+}
+
+static void dspbench_biquad_b16(void)
+{
+  struct biquad_b16_s bq;
+
+  biquad_init_b16(&bq, g_dspbench_bqcoef_b16, g_dspbench_state_b16,
+                  DSPBENCH_NSTAGES);
+  biquad_cascade_b16(&bq, g_dspbench_in_b16, g_dspbench_out_b16[0],
+                     DSPBENCH_COUNT);
+}
+
+static void dspbench_biquad_b16_scalar(void)
+{
+  FAR const b16_t *c;
+  FAR b16_t *d;
+  b16_t x;
+  b16_t y;
+  int stage;
+  int i;
+
+  memset(g_dspbench_state_b16, 0, sizeof(g_dspbench_state_b16));
+  for (i = 0; i < DSPBENCH_COUNT; i++)
+    {
+      c = g_dspbench_bqcoef_b16;
+      d = g_dspbench_state_b16;
+      x = g_dspbench_in_b16[i];
+
+      for (stage = 0; stage < DSPBENCH_NSTAGES; stage++)
+        {
+          y = b16mulb16(c[0], x) + b16mulb16(c[1], d[0]) +
+              b16mulb16(c[2], d[1]) - b16mulb16(c[3], d[2]) -
+              b16mulb16(c[4], d[3]);
+
+          d[1] = d[0];
+          d[0] = x;
+          d[3] = d[2];
+          d[2] = y;
+          x    = y;
+          c   += 5;
+          d   += 4;
+        }
+
+      g_dspbench_out_b16[1][i] = x;
+    }
+}
+
+/****************************************************************************
+ * Name: dspbench_mavg
+ *
+ * Description:
+ *   The moving average over DSPBENCH_NTAPS samples, with a running sum
+ *   over the block and summing the window for every sample.
+ *
+ ****************************************************************************/
+
+static void dspbench_mavg(void)
+{
+  struct mavg_filter_f32_s mavg;
+
+  mavg_filter_init(&mavg, g_dspbench_state, DSPBENCH_NTAPS);
+  mavg_filter(&mavg, g_dspbench_in, g_dspbench_out[0], DSPBENCH_COUNT);
+}
+
+static void dspbench_mavg_scalar(void)
+{
+  FAR float *win = g_dspbench_state;
+  float sum;
+  int pos = 0;
+  int i;
+  int k;
+
+  memset(win, 0, DSPBENCH_NTAPS * sizeof(float));
+  for (i = 0; i < DSPBENCH_COUNT; i++)
+    {
+      win[pos] = g_dspbench_in[i];
+      pos = pos + 1 == DSPBENCH_NTAPS ? 0 : pos + 1;
+
+      for (sum = 0.0f, k = 0; k < DSPBENCH_NTAPS; k++)
+        {
+          sum += win[k];
+        }
+
+      g_dspbench_out[1][i] = sum / DSPBENCH_NTAPS;
+    }
+}
+
+static void dspbench_mavg_b16(void)
+{
+  struct mavg_filter_b16_s mavg;
+
+  mavg_filter_init_b16(&mavg, g_dspbench_state_b16, DSPBENCH_NTAPS);
+  mavg_filter_b16(&mavg, g_dspbench_in_b16, g_dspbench_out_b16[0],
+                  DSPBENCH_COUNT);
+}
+
+static void dspbench_mavg_b16_scalar(void)
+{
+  FAR b16_t *win = g_dspbench_state_b16;
+  b16_t sum;
+  int pos = 0;
+  int i;
+  int k;
+
+  memset(win, 0, DSPBENCH_NTAPS * sizeof(b16_t));
+  for (i = 0; i < DSPBENCH_COUNT; i++)
+    {
+      win[pos] = g_dspbench_in_b16[i];
+      pos = pos + 1 == DSPBENCH_NTAPS ? 0 : pos + 1;
+
+      for (sum = 0, k = 0; k < DSPBENCH_NTAPS; k++)
+        {
+          sum += win[k];
+        }
+
+      g_dspbench_out_b16[1][i] = sum / DSPBENCH_NTAPS;
+    }
+}
+
+/****************************************************************************
+ * Name: dspbench_run
+ *
+ * Description:
+ *   Return the cost of the fastest of DSPBENCH_ROUNDS runs of a function.
+ *
+ ****************************************************************************/
+
+static unsigned long dspbench_run(CODE void (*run)(void))
+{
+  unsigned long best = ULONG_MAX;
+  unsigned long start;
+  unsigned long cost;
+  int i;
+
+  for (i = 0; i < DSPBENCH_ROUNDS; i++)
+    {
+      start = up_perf_gettime();
+      run();
+      cost = up_perf_gettime() - start;
+
+      if (cost < best)
+        {
+          best = cost;
+        }
+    }
+
+  return best;
+}
+
+/****************************************************************************
+ * Name: dspbench_error
+ *
+ * Description:
+ *   Return the largest difference between the outputs of libdsp and of
+ *   the scalar code.
+ *
+ ****************************************************************************/
+
+static unsigned long dspbench_error(bool b16)
+{
+  unsigned long err = 0;
+  unsigned long d;
+  float f;
+  int i;
+
+  for (i = 0; i < 2 * DSPBENCH_COUNT; i++)
+    {
+      if (b16)
+        {
+          d = labs((long)g_dspbench_out_b16[0][i] -
+                   g_dspbench_out_b16[1][i]);
+        }
+      else
+        {
+          f = g_dspbench_out[0][i] - g_dspbench_out[1][i];
+          d = (unsigned long)((f < 0.0f ? -f : f) * 16777216.0f);
+        }
+
+      err = MAX(err, d);
+    }
+
+  return err;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dspbench_main
+ *
+ * Description:
+ *   Main entry point into the digital signal processing benchmark.  Can be
+ *   used as CONFIG_INIT_ENTRYPOINT.
+ *
+ ****************************************************************************/
+
+int dspbench_main(int argc, FAR char *argv[])
+{
+  FAR const struct dspbench_test_s *test;
+  unsigned long lcost;
+  unsigned long scost;
+  int i;
+
+  dspbench_setup();
+
+  printf("dspbench_main: %d samples, %d taps, %d biquads, costs per sample "
+         "in up_perf_gettime() units at %lu Hz\n", DSPBENCH_COUNT,
+         DSPBENCH_NTAPS, DSPBENCH_NSTAGES, up_perf_getfreq());
+  printf("%-12s %8s %8s %6s\n", "kernel", "libdsp", "scalar", "error");
+
+  for (i = 0; i < nitems(g_dspbench); i++)
+    {
+      test = &g_dspbench[i];
+
+      memset(g_dspbench_out, 0, sizeof(g_dspbench_out));
+      memset(g_dspbench_out_b16, 0, sizeof(g_dspbench_out_b16));
+
+      lcost = dspbench_run(test->lib) / DSPBENCH_COUNT;
+      scost = dspbench_run(test->scalar) / DSPBENCH_COUNT;
+
+      printf("%-12s %8lu %8lu %6lu\n", test->name, lcost, scost,
+             dspbench_error(test->b16));
+      perfsuite_result("dsp", "perf", lcost, "%s/libdsp", test->name);
+      perfsuite_result("dsp", "perf", scost, "%s/scalar", test->name);
+    }
+
+  fflush(stdout);
+  return EXIT_SUCCESS;
+}
+
+#endif /* CONFIG_BOARD_DSPBENCH */
@@ -0,0 +1,347 @@
+/****************************************************************************
+ * boards/libmbench.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Single precision math library benchmark.
+ *
+ * Every function is called on CONFIG_BOARD_LIBMBENCH_COUNT pseudo-random
+ * arguments from the range that is typical for signal processing and
+ * sensor fusion, CONFIG_BOARD_LIBMBENCH_ROUNDS times over.  The cost of a
+ * call is measured with up_perf_gettime() (CPU cycles on ARMv7-M) and
+ * includes the loop, which the "none" line measures alone.  The error is
+ * the largest distance, in units in the last place of the result, to the
+ * double precision function of the same library over the arguments.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <float.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/compiler.h>
+
+#include "perfsuite.h"
+
+#ifdef CONFIG_BOARD_LIBMBENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LIBMBENCH_COUNT   CONFIG_BOARD_LIBMBENCH_COUNT
+#define LIBMBENCH_ROUNDS  CONFIG_BOARD_LIBMBENCH_ROUNDS
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One benchmarked function and the arguments it is called with */
+
+struct libmbench_s
+{
+  FAR const char *name;
+  float (*fn)(float x, float y);
+  double (*ref)(double x, double y);
+  float xmin;             /* Range of the first argument */
+  float xmax;
+  bool  xlog;             /* Logarithmic distribution of the first argument */
+  bool  binary;           /* Second argument in [-1, 1] */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static float libmbench_nonef(float x, float y);
+static float libmbench_sinf(float x, float y);
+static float libmbench_cosf(float x, float y);
+static float libmbench_expf(float x, float y);
+static float libmbench_logf(float x, float y);
+static float libmbench_atan2f(float x, float y);
+static float libmbench_sqrtf(float x, float y);
+static double libmbench_sin(double x, double y);
+static double libmbench_cos(double x, double y);
+static double libmbench_exp(double x, double y);
+static double libmbench_log(double x, double y);
+static double libmbench_atan2(double x, double y);
+static double libmbench_sqrt(double x, double y);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct libmbench_s g_libmbench[] =
+{
+  { "none", libmbench_nonef, NULL, -10.0f, 10.0f, false, false },
+  { "sinf", libmbench_sinf, libmbench_sin, -10.0f, 10.0f, false, false },
+  { "cosf", libmbench_cosf, libmbench_cos, -10.0f, 10.0f, false, false },
+  { "expf", libmbench_expf, libmbench_exp, -20.0f, 20.0f, false, false },
+  { "logf", libmbench_logf, libmbench_log, -16.0f, 16.0f, true, false },
+  { "atan2f", libmbench_atan2f, libmbench_atan2, -1.0f, 1.0f, false, true },
+  { "sqrtf", libmbench_sqrtf, libmbench_sqrt, -16.0f, 16.0f, true, false },
+};
+
+static float g_xarg[LIBMBENCH_COUNT];
+static float g_yarg[LIBMBENCH_COUNT];
+static volatile float g_sink;
+static uint32_t g_seed;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* The benchmarked functions behind one signature.  They are not inlined so
+ * that the library calls stay calls.
+ */
+
+static noinline_function float libmbench_nonef(float x, float y)
+{
+  return x;
+}
+
+static noinline_function float libmbench_sinf(float x, float y)
+{
+  return sinf(x);
+}
+
+static noinline_function float libmbench_cosf(float x, float y)
+{
+  return cosf(x);
+}
+
+static noinline_function float libmbench_expf(float x, float y)
+{
+  return expf(x);
+}
+
+static noinline_function float libmbench_logf(float x, float y)
+{
+  return logf(x);
+}
+
+static noinline_function float libmbench_atan2f(float x, float y)
+{
+  return atan2f(y, x);
+}
+
+static noinline_function float libmbench_sqrtf(float x, float y)
+{
+  return sqrtf(x);
+}
+
+static double libmbench_sin(double x, double y)
+{
+  return sin(x);
+}
+
+static double libmbench_cos(double x, double y)
+{
+  return cos(x);
+}
+
+static double libmbench_exp(double x, double y)
+{
+  return exp(x);
+}
+
+static double libmbench_log(double x, double y)
+{
+  return log(x);
+}
+
+static double libmbench_atan2(double x, double y)
+{
+  return atan2(y, x);
+}
+
+static double libmbench_sqrt(double x, double y)
+{
+  return sqrt(x);
+}
+
+/****************************************************************************
+ * Name: libmbench_rand
+ *
+ * Description:
+ *   Return a pseudo-random float in [0, 1).  The sequence is the same on
+ *   every run and does not depend on the math library.
+ *
+ ****************************************************************************/
+
+static float libmbench_rand(void)
+{
+  g_seed = g_seed * 1664525 + 1013904223;
+  return (float)(g_seed >> 8) * (1.0f / 16777216.0f);
+}
+
+/****************************************************************************
+ * Name: libmbench_args
+ *
+ * Description:
+ *   Fill the argument arrays for one function.
+ *
+ ****************************************************************************/
+
+static void libmbench_args(FAR const struct libmbench_s *bench)
+{
+  float x;
+  int i;
+
+  g_seed = 1;
+  for (i = 0; i < LIBMBENCH_COUNT; i++)
+    {
+      x = bench->xmin + (bench->xmax - bench->xmin) * libmbench_rand();
+      if (bench->xlog)
+        {
+          /* A random mantissa in [1, 2) times 2^x */
+
+          x = ldexpf(1.0f + libmbench_rand(), (int)x);
+        }
+
+      g_xarg[i] = x;
+      g_yarg[i] = bench->binary ? 2.0f * libmbench_rand() - 1.0f : 0.0f;
+    }
+}
+
+/****************************************************************************
+ * Name: libmbench_ulps
+ *
+ * Description:
+ *   Return the largest error over the arguments in units in the last
+ *   place of the single precision result.
+ *
+ ****************************************************************************/
+
+static double libmbench_ulps(FAR const struct libmbench_s *bench)
+{
+  double maxerr = 0.0;
+  double err;
+  double ref;
+  int exp;
+  int i;
+
+  for (i = 0; i < LIBMBENCH_COUNT; i++)
+    {
+      ref = bench->ref(g_xarg[i], g_yarg[i]);
+      frexp(ref, &exp);
+      if (exp < FLT_MIN_EXP)
+        {
+          exp = FLT_MIN_EXP;
+        }
+
+      err = fabs(bench->fn(g_xarg[i], g_yarg[i]) - ref) /
+            ldexp(1.0, exp - FLT_MANT_DIG);
+      if (err > maxerr)
+        {
+          maxerr = err;
+        }
+    }
+
+  return maxerr;
+}
+
+/****************************************************************************
+ * Name: libmbench_run
+ *
+ * Description:
+ *   Measure and print one function.
+ *
+ ****************************************************************************/
+
+static void libmbench_run(FAR const struct libmbench_s *bench)
+{
+  unsigned long start;
+  unsigned long elapsed;
+  float sink = 0.0f;
+  int round;
+  int i;
+
+  libmbench_args(bench);
+
+  start = up_perf_gettime();
+  for (round = 0; round < LIBMBENCH_ROUNDS; round++)
+    {
+      for (i = 0; i < LIBMBENCH_COUNT; i++)
+        {
+          sink += bench->fn(g_xarg[i], g_yarg[i]);
+        }
+    }
+
+  elapsed = up_perf_gettime() - start;
+  g_sink  = sink;
+
+  printf("%-8s %10lu", bench->name,
+         (unsigned long)((uint64_t)elapsed /
+                         ((uint64_t)LIBMBENCH_ROUNDS * LIBMBENCH_COUNT)));
+  perfsuite_result("libm", "perf",
+                   (unsigned long)((uint64_t)elapsed /
+                                   ((uint64_t)LIBMBENCH_ROUNDS *
+                                    LIBMBENCH_COUNT)),
+                   "%s", bench->name);
+
+  if (bench->ref != NULL)
+    {
+      printf(" %10.2f", libmbench_ulps(bench));
+    }
+
+  printf("\n");
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: libmbench_main
+ *
+ * Description:
+ *   Main entry point into the math library benchmark.  Can be used as
+ *   CONFIG_INIT_ENTRYPOINT.
+ *
+ ****************************************************************************/
+
+int libmbench_main(int argc, FAR char *argv[])
+{
+  int i;
+
+  printf("libmbench_main: %d calls, costs in up_perf_gettime() units "
+         "at %lu Hz\n", LIBMBENCH_ROUNDS * LIBMBENCH_COUNT,
+         up_perf_getfreq());
+  printf("%-8s %10s %10s\n", "function", "cost/call", "max ulp");
+
+  for (i = 0; i < sizeof(g_libmbench) / sizeof(g_libmbench[0]); i++)
+    {
+      libmbench_run(&g_libmbench[i]);
+    }
+
+  fflush(stdout);
+  return EXIT_SUCCESS;
+}
+
+#endif /* CONFIG_BOARD_LIBMBENCH */
@@ -0,0 +1,242 @@
+/****************************************************************************
+ * boards/mallocbench.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Heap allocator benchmark.
+ *
+ * CONFIG_BOARD_MALLOCBENCH_COUNT operations on the
+ * CONFIG_BOARD_MALLOCBENCH_SLOTS slots of the selected heap: a pseudo-random
+ * slot is freed if it holds a block, otherwise a block of a pseudo-random
+ * size up to CONFIG_BOARD_MALLOCBENCH_MAXSIZE bytes is allocated into it.
+ * Every malloc() and free() is timed on its own with up_perf_gettime() (CPU
+ * cycles from the DWT on ARMv7-M), and the median, the 90th and the 99th
+ * percentile and the worst case of each are reported.  The worst case
+ * includes any interrupt taken during the call.  The heap manager is the
+ * one that is configured, mm_heap or TLSF, so the two are compared by
+ * running the benchmark once with each.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+
+#include "perfsuite.h"
+
+#ifdef CONFIG_BOARD_MALLOCBENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MALLOCBENCH_COUNT    CONFIG_BOARD_MALLOCBENCH_COUNT
+#define MALLOCBENCH_SLOTS    CONFIG_BOARD_MALLOCBENCH_SLOTS
+#define MALLOCBENCH_MAXSIZE  CONFIG_BOARD_MALLOCBENCH_MAXSIZE
+
+#ifdef CONFIG_BOARD_MALLOCBENCH_KMM
+#  define MALLOCBENCH_HEAP     "kmm"
+#  define mallocbench_malloc   kmm_malloc
+#  define mallocbench_free     kmm_free
+#else
+#  define MALLOCBENCH_HEAP     "umm"
+#  define mallocbench_malloc   malloc
+#  define mallocbench_free     free
+#endif
+
+#if defined(CONFIG_MM_TLSF_MANAGER)
+#  define MALLOCBENCH_MANAGER  "tlsf"
+#elif defined(CONFIG_MM_DEFAULT_MANAGER)
+#  define MALLOCBENCH_MANAGER  "mm_heap"
+#else
+#  define MALLOCBENCH_MANAGER  "custom"
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct mallocbench_stats_s
+{
+  uint32_t cost[MALLOCBENCH_COUNT]; /* Cost of every call */
+  int ncalls;                       /* Number of calls */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR void *g_mallocbench_slot[MALLOCBENCH_SLOTS];
+static struct mallocbench_stats_s g_mallocbench_malloc;
+static struct mallocbench_stats_s g_mallocbench_free;
+static uint32_t g_mallocbench_seed;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t mallocbench_rand(void)
+{
+  g_mallocbench_seed ^= g_mallocbench_seed << 13;
+  g_mallocbench_seed ^= g_mallocbench_seed >> 17;
+  g_mallocbench_seed ^= g_mallocbench_seed << 5;
+  return g_mallocbench_seed;
+}
+
+static int mallocbench_compar(FAR const void *a, FAR const void *b)
+{
+  uint32_t x = *(FAR const uint32_t *)a;
+  uint32_t y = *(FAR const uint32_t *)b;
+
+  return x < y ? -1 : x > y;
+}
+
+/****************************************************************************
+ * Name: mallocbench_report
+ *
+ * Description:
+ *   Sort the costs of one kind of call and report their percentiles and
+ *   their worst case.
+ *
+ ****************************************************************************/
+
+static void mallocbench_report(FAR const char *name,
+                               FAR struct mallocbench_stats_s *stats)
+{
+  FAR const uint32_t *cost = stats->cost;
+  int n = stats->ncalls;
+
+  if (n == 0)
+    {
+      return;
+    }
+
+  qsort(stats->cost, n, sizeof(uint32_t), mallocbench_compar);
+
+  printf("%-8s %6d %8" PRIu32 " %8" PRIu32 " %8" PRIu32 " %8" PRIu32
+         " %8" PRIu32 "\n", name, n, cost[0], cost[n / 2],
+         cost[n * 90 / 100], cost[n * 99 / 100], cost[n - 1]);
+
+  perfsuite_result("malloc", "perf", cost[n / 2], "%s/%s/%s/p50",
+                   MALLOCBENCH_MANAGER, MALLOCBENCH_HEAP, name);
+  perfsuite_result("malloc", "perf", cost[n * 99 / 100], "%s/%s/%s/p99",
+                   MALLOCBENCH_MANAGER, MALLOCBENCH_HEAP, name);
+  perfsuite_result("malloc", "perf", cost[n - 1], "%s/%s/%s/max",
+                   MALLOCBENCH_MANAGER, MALLOCBENCH_HEAP, name);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mallocbench_main
+ *
+ * Description:
+ *   Main entry point into the heap allocator benchmark.  Can be used as
+ *   CONFIG_INIT_ENTRYPOINT.
+ *
+ ****************************************************************************/
+
+int mallocbench_main(int argc, FAR char *argv[])
+{
+  FAR struct mallocbench_stats_s *stats;
+  unsigned long start;
+  unsigned long cost;
+  unsigned long nfail = 0;
+  size_t size;
+  int slot;
+  int i;
+
+  printf("mallocbench_main: %s heap, %s manager, %d operations on %d "
+         "slots of up to %d bytes, costs in up_perf_gettime() units at %lu "
+         "Hz\n", MALLOCBENCH_HEAP, MALLOCBENCH_MANAGER, MALLOCBENCH_COUNT,
+         MALLOCBENCH_SLOTS, MALLOCBENCH_MAXSIZE, up_perf_getfreq());
+
+  g_mallocbench_seed = 0x2545f491;
+  g_mallocbench_malloc.ncalls = 0;
+  g_mallocbench_free.ncalls = 0;
+  memset(g_mallocbench_slot, 0, sizeof(g_mallocbench_slot));
+
+  for (i = 0; i < MALLOCBENCH_COUNT; i++)
+    {
+      slot = mallocbench_rand() % MALLOCBENCH_SLOTS;
+      if (g_mallocbench_slot[slot] != NULL)
+        {
+          stats = &g_mallocbench_free;
+
+          start = up_perf_gettime();
+          mallocbench_free(g_mallocbench_slot[slot]);
+          cost = up_perf_gettime() - start;
+
+          g_mallocbench_slot[slot] = NULL;
+        }
+      else
+        {
+          stats = &g_mallocbench_malloc;
+          size  = 1 + mallocbench_rand() % MALLOCBENCH_MAXSIZE;
+
+          start = up_perf_gettime();
+          g_mallocbench_slot[slot] = mallocbench_malloc(size);
+          cost = up_perf_gettime() - start;
+
+          if (g_mallocbench_slot[slot] == NULL)
+            {
+              nfail++;
+            }
+        }
+
+      stats->cost[stats->ncalls++] = cost;
+    }
+
+  for (slot = 0; slot < MALLOCBENCH_SLOTS; slot++)
+    {
+      if (g_mallocbench_slot[slot] != NULL)
+        {
+          mallocbench_free(g_mallocbench_slot[slot]);
+          g_mallocbench_slot[slot] = NULL;
+        }
+    }
+
+  printf("%-8s %6s %8s %8s %8s %8s %8s\n",
+         "call", "count", "min", "p50", "p90", "p99", "max");
+  mallocbench_report("malloc", &g_mallocbench_malloc);
+  mallocbench_report("free", &g_mallocbench_free);
+
+  if (nfail > 0)
+    {
+      printf("mallocbench_main: ERROR: %lu allocations failed\n", nfail);
+    }
+
+  fflush(stdout);
+  return nfail == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+#endif /* CONFIG_BOARD_MALLOCBENCH */
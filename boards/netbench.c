@@ -0,0 +1,663 @@
+/****************************************************************************
+ * boards/netbench.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Network stack benchmark over the local loopback device.
+ *
+ * The tests run a client in the calling thread against a server thread,
+ * both on 127.0.0.1, so that the results only depend on the stack and the
+ * CPU:
+ *
+ *   tcp         Stream CONFIG_BOARD_NETBENCH_TCPBYTES bytes to a sink and
+ *               report the throughput.
+ *   udp         CONFIG_BOARD_NETBENCH_ROUNDS request-response exchanges of
+ *               one datagram each way.
+ *   accept      CONFIG_BOARD_NETBENCH_ROUNDS connect()/accept()/close()
+ *               sequences.
+ *
+ * Rates are measured with CLOCK_MONOTONIC.  The cost of a round trip or
+ * connection is measured with up_perf_gettime() (CPU cycles on ARMv7-M).
+ * With CONFIG_NET_STATISTICS_PERF the receive processing time per packet
+ * that the stack accounts is reported as well, which also sees the
+ * traffic of the TUN and other devices.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/net/netstats.h>
+
+#include "perfsuite.h"
+
+#ifdef CONFIG_BOARD_NETBENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NETBENCH_BUFSIZE  1024
+#define NETBENCH_UDPSIZE  64
+
+/* A server gives up after one second without traffic */
+
+#define NETBENCH_TIMEOUT  1000
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The cost of the operations of one test, in up_perf_gettime() units */
+
+struct netbench_cost_s
+{
+  unsigned long min;
+  unsigned long max;
+  uint64_t      sum;
+  uint32_t      count;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uint8_t g_txbuf[NETBENCH_BUFSIZE];
+static uint8_t g_rxbuf[NETBENCH_BUFSIZE];
+
+#ifdef CONFIG_NET_STATISTICS_PERF
+static struct netperf_stats_s g_perfstart;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netbench_addr
+ ****************************************************************************/
+
+static void netbench_addr(FAR struct sockaddr_in *addr)
+{
+  memset(addr, 0, sizeof(*addr));
+  addr->sin_family      = AF_INET;
+  addr->sin_port        = HTONS(CONFIG_BOARD_NETBENCH_PORT);
+  addr->sin_addr.s_addr = HTONL(INADDR_LOOPBACK);
+}
+
+/****************************************************************************
+ * Name: netbench_server
+ *
+ * Description:
+ *   Create the socket of a server, bound and for SOCK_STREAM listening, so
+ *   that the client can connect as soon as this returns.
+ *
+ ****************************************************************************/
+
+static int netbench_server(int type)
+{
+  struct sockaddr_in addr;
+  struct timeval tv;
+  int reuse = 1;
+  int fd;
+
+  fd = socket(AF_INET, type, 0);
+  if (fd < 0)
+    {
+      fprintf(stderr, "netbench_main: ERROR: socket failed: %d\n", errno);
+      return -1;
+    }
+
+  tv.tv_sec  = NETBENCH_TIMEOUT / MSEC_PER_SEC;
+  tv.tv_usec = 0;
+
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+  netbench_addr(&addr);
+  if (bind(fd, (FAR struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+      (type == SOCK_STREAM && listen(fd, CONFIG_BOARD_NETBENCH_BACKLOG) < 0))
+    {
+      fprintf(stderr, "netbench_main: ERROR: bind/listen failed: %d\n",
+              errno);
+      close(fd);
+      return -1;
+    }
+
+  return fd;
+}
+
+/****************************************************************************
+ * Name: netbench_accept1
+ *
+ * Description:
+ *   Accept a connection, giving up after NETBENCH_TIMEOUT as accept() does
+ *   not follow SO_RCVTIMEO.
+ *
+ ****************************************************************************/
+
+static int netbench_accept1(int lfd)
+{
+  struct pollfd fds;
+
+  fds.fd     = lfd;
+  fds.events = POLLIN;
+
+  if (poll(&fds, 1, NETBENCH_TIMEOUT) <= 0)
+    {
+      return -1;
+    }
+
+  return accept(lfd, NULL, NULL);
+}
+
+/****************************************************************************
+ * Name: netbench_connect
+ ****************************************************************************/
+
+static int netbench_connect(int type)
+{
+  struct sockaddr_in addr;
+  int fd;
+
+  fd = socket(AF_INET, type, 0);
+  if (fd < 0)
+    {
+      return -1;
+    }
+
+  netbench_addr(&addr);
+  if (connect(fd, (FAR struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+      close(fd);
+      return -1;
+    }
+
+  return fd;
+}
+
+/****************************************************************************
+ * Name: netbench_thread
+ *
+ * Description:
+ *   Start a server thread that is passed its socket.
+ *
+ ****************************************************************************/
+
+static int netbench_thread(FAR pthread_t *thread,
+                           pthread_startroutine_t entry, int fd)
+{
+  int ret;
+
+  ret = pthread_create(thread, NULL, entry, (FAR void *)(intptr_t)fd);
+  if (ret != 0)
+    {
+      fprintf(stderr, "netbench_main: ERROR: pthread_create failed: %d\n",
+              ret);
+      return -ret;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netbench_now
+ *
+ * Description:
+ *   Return the time in nanoseconds.
+ *
+ ****************************************************************************/
+
+static uint64_t netbench_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: netbench_rate
+ *
+ * Description:
+ *   Return the number of events per second.
+ *
+ ****************************************************************************/
+
+static unsigned long netbench_rate(uint64_t count, uint64_t elapsed)
+{
+  return elapsed > 0 ? (unsigned long)(count * NSEC_PER_SEC / elapsed) : 0;
+}
+
+/****************************************************************************
+ * Name: netbench_sample
+ ****************************************************************************/
+
+static void netbench_sample(FAR struct netbench_cost_s *cost,
+                            unsigned long start)
+{
+  unsigned long elapsed = up_perf_gettime() - start;
+
+  if (cost->count == 0 || elapsed < cost->min)
+    {
+      cost->min = elapsed;
+    }
+
+  if (elapsed > cost->max)
+    {
+      cost->max = elapsed;
+    }
+
+  cost->sum += elapsed;
+  cost->count++;
+}
+
+/****************************************************************************
+ * Name: netbench_start
+ *
+ * Description:
+ *   Take a snapshot of the packet processing statistics of the stack.
+ *
+ ****************************************************************************/
+
+static void netbench_start(void)
+{
+#ifdef CONFIG_NET_STATISTICS_PERF
+  g_perfstart = g_netstats.perf;
+#endif
+}
+
+/****************************************************************************
+ * Name: netbench_report
+ *
+ * Description:
+ *   Print the results of one test.
+ *
+ ****************************************************************************/
+
+static void netbench_report(FAR const char *name, uint64_t elapsed,
+                            uint64_t bytes,
+                            FAR const struct netbench_cost_s *cost)
+{
+#ifdef CONFIG_NET_STATISTICS_PERF
+  uint32_t rxpkts = g_netstats.perf.rxpkts - g_perfstart.rxpkts;
+#endif
+
+  printf("%-8s %10lu B/s", name, netbench_rate(bytes, elapsed));
+  if (bytes > 0)
+    {
+      perfsuite_result("net", "B/s", netbench_rate(bytes, elapsed), "%s",
+                       name);
+    }
+
+  if (cost != NULL && cost->count > 0)
+    {
+      printf(" %8lu op/s %8lu %8lu %8lu",
+             netbench_rate(cost->count, elapsed), cost->min,
+             (unsigned long)(cost->sum / cost->count), cost->max);
+      perfsuite_result("net", "op/s", netbench_rate(cost->count, elapsed),
+                       "%s/rate", name);
+      perfsuite_result("net", "perf", cost->min, "%s/min", name);
+    }
+
+#ifdef CONFIG_NET_STATISTICS_PERF
+  if (rxpkts > 0)
+    {
+      printf(" | %8lu pkt/s %8lu/pkt", netbench_rate(rxpkts, elapsed),
+             (unsigned long)((g_netstats.perf.rxtime -
+                              g_perfstart.rxtime) / rxpkts));
+      perfsuite_result("net", "perf",
+                       (unsigned long)((g_netstats.perf.rxtime -
+                                        g_perfstart.rxtime) / rxpkts),
+                       "%s/pkt", name);
+    }
+#endif
+
+  printf("\n");
+}
+
+/****************************************************************************
+ * Name: netbench_sink
+ *
+ * Description:
+ *   tcp: accept one connection and read it to the end.
+ *
+ ****************************************************************************/
+
+static FAR void *netbench_sink(FAR void *arg)
+{
+  int fd = netbench_accept1((int)(intptr_t)arg);
+
+  if (fd >= 0)
+    {
+      while (recv(fd, g_rxbuf, sizeof(g_rxbuf), 0) > 0)
+        {
+        }
+
+      close(fd);
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: netbench_tcp
+ ****************************************************************************/
+
+static void netbench_tcp(void)
+{
+  pthread_t thread;
+  uint64_t start;
+  uint64_t sent = 0;
+  ssize_t nsent;
+  int lfd;
+  int fd;
+
+  lfd = netbench_server(SOCK_STREAM);
+  if (lfd < 0 || netbench_thread(&thread, netbench_sink, lfd) < 0)
+    {
+      goto errout;
+    }
+
+  fd = netbench_connect(SOCK_STREAM);
+  if (fd < 0)
+    {
+      fprintf(stderr, "netbench_main: ERROR: connect failed: %d\n", errno);
+      pthread_join(thread, NULL);
+      goto errout;
+    }
+
+  netbench_start();
+  start = netbench_now();
+
+  while (sent < CONFIG_BOARD_NETBENCH_TCPBYTES)
+    {
+      nsent = send(fd, g_txbuf, sizeof(g_txbuf), 0);
+      if (nsent <= 0)
+        {
+          fprintf(stderr, "netbench_main: ERROR: send failed: %d\n", errno);
+          break;
+        }
+
+      sent += nsent;
+    }
+
+  /* The transfer is complete when the sink has read the end */
+
+  close(fd);
+  pthread_join(thread, NULL);
+
+  netbench_report("tcp", netbench_now() - start, sent, NULL);
+
+errout:
+  if (lfd >= 0)
+    {
+      close(lfd);
+    }
+}
+
+/****************************************************************************
+ * Name: netbench_echo
+ *
+ * Description:
+ *   udp: answer each request with its copy until no more arrive.
+ *
+ ****************************************************************************/
+
+static FAR void *netbench_echo(FAR void *arg)
+{
+  struct sockaddr_in from;
+  socklen_t fromlen;
+  int fd = (int)(intptr_t)arg;
+  ssize_t nrecv;
+
+  for (; ; )
+    {
+      fromlen = sizeof(from);
+      nrecv   = recvfrom(fd, g_rxbuf, NETBENCH_UDPSIZE, 0,
+                         (FAR struct sockaddr *)&from, &fromlen);
+      if (nrecv <= 0)
+        {
+          break;
+        }
+
+      sendto(fd, g_rxbuf, nrecv, 0, (FAR struct sockaddr *)&from, fromlen);
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: netbench_udp
+ ****************************************************************************/
+
+static void netbench_udp(void)
+{
+  struct netbench_cost_s cost;
+  struct timeval tv;
+  pthread_t thread;
+  unsigned long stamp;
+  uint64_t start;
+  uint64_t elapsed;
+  int lost = 0;
+  int sfd;
+  int fd;
+  int i;
+
+  sfd = netbench_server(SOCK_DGRAM);
+  if (sfd < 0)
+    {
+      return;
+    }
+
+  if (netbench_thread(&thread, netbench_echo, sfd) < 0)
+    {
+      close(sfd);
+      return;
+    }
+
+  fd = netbench_connect(SOCK_DGRAM);
+  if (fd < 0)
+    {
+      fprintf(stderr, "netbench_main: ERROR: connect failed: %d\n", errno);
+      goto errout;
+    }
+
+  /* The client gives up on a lost datagram as the server does */
+
+  tv.tv_sec  = NETBENCH_TIMEOUT / MSEC_PER_SEC;
+  tv.tv_usec = 0;
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+  memset(&cost, 0, sizeof(cost));
+  netbench_start();
+  start = netbench_now();
+
+  for (i = 0; i < CONFIG_BOARD_NETBENCH_ROUNDS; i++)
+    {
+      stamp = up_perf_gettime();
+      if (send(fd, g_txbuf, NETBENCH_UDPSIZE, 0) < 0 ||
+          recv(fd, g_txbuf, NETBENCH_UDPSIZE, 0) <= 0)
+        {
+          lost++;
+          continue;
+        }
+
+      netbench_sample(&cost, stamp);
+    }
+
+  elapsed = netbench_now() - start;
+  close(fd);
+
+  netbench_report("udp", elapsed, 2ull * NETBENCH_UDPSIZE * cost.count,
+                  &cost);
+  if (lost > 0)
+    {
+      printf("udp: %d exchanges lost\n", lost);
+    }
+
+errout:
+
+  /* The server stops once no more requests arrive */
+
+  pthread_join(thread, NULL);
+  close(sfd);
+}
+
+/****************************************************************************
+ * Name: netbench_acceptor
+ *
+ * Description:
+ *   accept: accept and close the connections of the test.
+ *
+ ****************************************************************************/
+
+static FAR void *netbench_acceptor(FAR void *arg)
+{
+  int lfd = (int)(intptr_t)arg;
+  int fd;
+  int i;
+
+  for (i = 0; i < CONFIG_BOARD_NETBENCH_ROUNDS; i++)
+    {
+      fd = netbench_accept1(lfd);
+      if (fd < 0)
+        {
+          break;
+        }
+
+      close(fd);
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: netbench_accept
+ ****************************************************************************/
+
+static void netbench_accept(void)
+{
+  struct netbench_cost_s cost;
+  pthread_t thread;
+  unsigned long stamp;
+  uint64_t start;
+  uint64_t elapsed;
+  int lfd;
+  int fd;
+  int i;
+
+  lfd = netbench_server(SOCK_STREAM);
+  if (lfd < 0)
+    {
+      return;
+    }
+
+  if (netbench_thread(&thread, netbench_acceptor, lfd) < 0)
+    {
+      close(lfd);
+      return;
+    }
+
+  memset(&cost, 0, sizeof(cost));
+  netbench_start();
+  start = netbench_now();
+
+  for (i = 0; i < CONFIG_BOARD_NETBENCH_ROUNDS; i++)
+    {
+      stamp = up_perf_gettime();
+      fd = netbench_connect(SOCK_STREAM);
+      if (fd < 0)
+        {
+          fprintf(stderr, "netbench_main: ERROR: connect %d failed: %d\n",
+                  i, errno);
+          break;
+        }
+
+      close(fd);
+      netbench_sample(&cost, stamp);
+    }
+
+  elapsed = netbench_now() - start;
+
+  /* The acceptor stops once no more connections arrive */
+
+  pthread_join(thread, NULL);
+  close(lfd);
+
+  netbench_report("accept", elapsed, 0, &cost);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netbench_main
+ *
+ * Description:
+ *   Main entry point into the network stack benchmark.  Can be used as
+ *   CONFIG_INIT_ENTRYPOINT.
+ *
+ ****************************************************************************/
+
+int netbench_main(int argc, FAR char *argv[])
+{
+  int i;
+
+  for (i = 0; i < NETBENCH_BUFSIZE; i++)
+    {
+      g_txbuf[i] = i;
+    }
+
+  printf("netbench_main: loopback, costs in up_perf_gettime() units "
+         "at %lu Hz\n", up_perf_getfreq());
+  printf("%-8s %14s %13s %8s %8s %8s", "test", "throughput", "rate",
+         "min", "avg", "max");
+#ifdef CONFIG_NET_STATISTICS_PERF
+  printf(" | %14s %12s", "stack rx", "cost");
+#endif
+  printf("\n");
+
+  netbench_tcp();
+  netbench_udp();
+  netbench_accept();
+
+  fflush(stdout);
+  return EXIT_SUCCESS;
+}
+
+#endif /* CONFIG_BOARD_NETBENCH */
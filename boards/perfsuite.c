@@ -0,0 +1,606 @@
+/****************************************************************************
+ * boards/perfsuite.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Performance regression suite.
+ *
+ * perfsuite_main() runs the benchmarks of this directory that are enabled
+ * and tests of its own, always with the same amount of work, and prints
+ * all results as one JSON document:
+ *
+ *   {"perfsuite": 1, "board": "sim", "release": "12.4.0", ...,
+ *    "perf_freq": 1000000000, "results": [
+ *     {"bench": "mm", "test": "malloc/32", "unit": "perf", "value": 52},
+ *     ...
+ *   ]}
+ *
+ * "perf" values are in up_perf_gettime() units at perf_freq Hz (CPU
+ * cycles on ARMv7-M).  The text tables of the benchmarks go to /dev/null
+ * while they run; each of them reports its numbers with
+ * perfsuite_result() instead.  tools/perfsuite.py extracts the document
+ * from a console log and compares two runs.
+ *
+ * The own tests report the cost of one operation, the best of
+ * CONFIG_BOARD_PERFSUITE_ROUNDS batches of CONFIG_BOARD_PERFSUITE_BATCH:
+ *
+ *   sched     pingpong: sem_post()/sem_wait() round trip between two
+ *             threads, i.e. two context switches
+ *             yield: sched_yield() without another ready thread
+ *             pthread: pthread_create() and pthread_join()
+ *   mm        malloc/N: malloc() and free() of N bytes, the frees after
+ *             all allocations of the batch
+ *   mempool   alloc/64: mempool_alloc() and mempool_free()
+ *   iob       alloc: iob_tryalloc() and iob_free()
+ *             copyin/1024: iob_trycopyin() of 1 KiB and iob_free_chain()
+ *   circbuf   write_read/64: circbuf_write() and circbuf_read()
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <sys/utsname.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/mm/circbuf.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/mm/mempool.h>
+
+#include "perfsuite.h"
+
+#ifdef CONFIG_BOARD_PERFSUITE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PERFSUITE_ROUNDS  CONFIG_BOARD_PERFSUITE_ROUNDS
+#define PERFSUITE_BATCH   CONFIG_BOARD_PERFSUITE_BATCH
+
+#define PERFSUITE_BUFSIZE 1024
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One own test.  run() performs n operations and returns the
+ * up_perf_gettime() time they took, without its setup.
+ */
+
+struct perfsuite_test_s
+{
+  FAR const char *bench;
+  FAR const char *test;
+  CODE unsigned long (*run)(uintptr_t arg, int n);
+  uintptr_t arg;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static unsigned long perfsuite_pingpong(uintptr_t arg, int n);
+static unsigned long perfsuite_yield(uintptr_t arg, int n);
+static unsigned long perfsuite_pthread(uintptr_t arg, int n);
+static unsigned long perfsuite_malloc(uintptr_t arg, int n);
+static unsigned long perfsuite_mempool(uintptr_t arg, int n);
+#ifdef CONFIG_MM_IOB
+static unsigned long perfsuite_iob(uintptr_t arg, int n);
+static unsigned long perfsuite_copyin(uintptr_t arg, int n);
+#endif
+static unsigned long perfsuite_circbuf(uintptr_t arg, int n);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct perfsuite_test_s g_perfsuite[] =
+{
+  { "sched", "pingpong", perfsuite_pingpong, 0 },
+  { "sched", "yield", perfsuite_yield, 0 },
+  { "sched", "pthread", perfsuite_pthread, 0 },
+  { "mm", "malloc/32", perfsuite_malloc, 32 },
+  { "mm", "malloc/256", perfsuite_malloc, 256 },
+  { "mm", "malloc/2048", perfsuite_malloc, 2048 },
+  { "mempool", "alloc/64", perfsuite_mempool, 64 },
+#ifdef CONFIG_MM_IOB
+  { "iob", "alloc", perfsuite_iob, 0 },
+  { "iob", "copyin/1024", perfsuite_copyin, 1024 },
+#endif
+  { "circbuf", "write_read/64", perfsuite_circbuf, 64 },
+};
+
+static FAR void *g_perfsuite_blocks[PERFSUITE_BATCH];
+static uint8_t g_perfsuite_buf[PERFSUITE_BUFSIZE];
+static sem_t g_perfsuite_ping;
+static sem_t g_perfsuite_pong;
+
+/* The console while the suite runs, -1 otherwise */
+
+static int g_perfsuite_fd = -1;
+static int g_perfsuite_nresults;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: perfsuite_partner
+ *
+ * Description:
+ *   pingpong: answer each ping with a pong.
+ *
+ ****************************************************************************/
+
+static FAR void *perfsuite_partner(FAR void *arg)
+{
+  int n = (int)(intptr_t)arg;
+  int i;
+
+  for (i = 0; i < n; i++)
+    {
+      sem_wait(&g_perfsuite_ping);
+      sem_post(&g_perfsuite_pong);
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: perfsuite_pingpong
+ ****************************************************************************/
+
+static unsigned long perfsuite_pingpong(uintptr_t arg, int n)
+{
+  struct sched_param param;
+  unsigned long start;
+  unsigned long elapsed;
+  pthread_attr_t attr;
+  pthread_t thread;
+  int ret;
+  int i;
+
+  sem_init(&g_perfsuite_ping, 0, 0);
+  sem_init(&g_perfsuite_pong, 0, 0);
+
+  /* The partner has the priority of the caller, so each wait switches */
+
+  sched_getparam(0, &param);
+  pthread_attr_init(&attr);
+  pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+  pthread_attr_setschedparam(&attr, &param);
+
+  ret = pthread_create(&thread, &attr, perfsuite_partner,
+                       (FAR void *)(intptr_t)n);
+  pthread_attr_destroy(&attr);
+  if (ret != 0)
+    {
+      return 0;
+    }
+
+  start = up_perf_gettime();
+  for (i = 0; i < n; i++)
+    {
+      sem_post(&g_perfsuite_ping);
+      sem_wait(&g_perfsuite_pong);
+    }
+
+  elapsed = up_perf_gettime() - start;
+
+  pthread_join(thread, NULL);
+  sem_destroy(&g_perfsuite_ping);
+  sem_destroy(&g_perfsuite_pong);
+  return elapsed;
+}
+
+/****************************************************************************
+ * Name: perfsuite_yield
+ ****************************************************************************/
+
+static unsigned long perfsuite_yield(uintptr_t arg, int n)
+{
+  unsigned long start = up_perf_gettime();
+  int i;
+
+  for (i = 0; i < n; i++)
+    {
+      sched_yield();
+    }
+
+  return up_perf_gettime() - start;
+}
+
+/****************************************************************************
+ * Name: perfsuite_nop
+ *
+ * Description:
+ *   pthread: the thread that is created and joined.
+ *
+ ****************************************************************************/
+
+static FAR void *perfsuite_nop(FAR void *arg)
+{
+  return arg;
+}
+
+/****************************************************************************
+ * Name: perfsuite_pthread
+ ****************************************************************************/
+
+static unsigned long perfsuite_pthread(uintptr_t arg, int n)
+{
+  unsigned long start = up_perf_gettime();
+  pthread_t thread;
+  int i;
+
+  for (i = 0; i < n; i++)
+    {
+      if (pthread_create(&thread, NULL, perfsuite_nop, NULL) == 0)
+        {
+          pthread_join(thread, NULL);
+        }
+    }
+
+  return up_perf_gettime() - start;
+}
+
+/****************************************************************************
+ * Name: perfsuite_malloc
+ ****************************************************************************/
+
+static unsigned long perfsuite_malloc(uintptr_t arg, int n)
+{
+  unsigned long start = up_perf_gettime();
+  int i;
+
+  for (i = 0; i < n; i++)
+    {
+      g_perfsuite_blocks[i] = malloc(arg);
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      free(g_perfsuite_blocks[i]);
+    }
+
+  return up_perf_gettime() - start;
+}
+
+/****************************************************************************
+ * Name: perfsuite_poolalloc/perfsuite_poolfree
+ *
+ * Description:
+ *   mempool: the memory of the pool comes from the heap.
+ *
+ ****************************************************************************/
+
+static FAR void *perfsuite_poolalloc(FAR struct mempool_s *pool,
+                                     size_t size)
+{
+  return malloc(size);
+}
+
+static void perfsuite_poolfree(FAR struct mempool_s *pool, FAR void *addr)
+{
+  free(addr);
+}
+
+/****************************************************************************
+ * Name: perfsuite_mempool
+ ****************************************************************************/
+
+static unsigned long perfsuite_mempool(uintptr_t arg, int n)
+{
+  struct mempool_s pool;
+  unsigned long start;
+  unsigned long elapsed;
+  int i;
+
+  /* The pool holds all blocks of the batch from the start */
+
+  memset(&pool, 0, sizeof(pool));
+  pool.blocksize   = arg;
+  pool.initialsize = n * MEMPOOL_REALBLOCKSIZE(&pool) + sizeof(sq_entry_t);
+  pool.alloc       = perfsuite_poolalloc;
+  pool.free        = perfsuite_poolfree;
+
+  if (mempool_init(&pool, "perfsuite") < 0)
+    {
+      return 0;
+    }
+
+  start = up_perf_gettime();
+  for (i = 0; i < n; i++)
+    {
+      g_perfsuite_blocks[i] = mempool_alloc(&pool);
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      mempool_free(&pool, g_perfsuite_blocks[i]);
+    }
+
+  elapsed = up_perf_gettime() - start;
+
+  mempool_deinit(&pool);
+  return elapsed;
+}
+
+#ifdef CONFIG_MM_IOB
+/****************************************************************************
+ * Name: perfsuite_iob
+ ****************************************************************************/
+
+static unsigned long perfsuite_iob(uintptr_t arg, int n)
+{
+  unsigned long start = up_perf_gettime();
+  FAR struct iob_s *iob;
+  int i;
+
+  for (i = 0; i < n; i++)
+    {
+      iob = iob_tryalloc(false);
+      if (iob != NULL)
+        {
+          iob_free(iob);
+        }
+    }
+
+  return up_perf_gettime() - start;
+}
+
+/****************************************************************************
+ * Name: perfsuite_copyin
+ ****************************************************************************/
+
+static unsigned long perfsuite_copyin(uintptr_t arg, int n)
+{
+  unsigned long start = up_perf_gettime();
+  FAR struct iob_s *iob;
+  int i;
+
+  for (i = 0; i < n; i++)
+    {
+      iob = iob_tryalloc(false);
+      if (iob != NULL)
+        {
+          iob_trycopyin(iob, g_perfsuite_buf, arg, 0, false);
+          iob_free_chain(iob);
+        }
+    }
+
+  return up_perf_gettime() - start;
+}
+#endif
+
+/****************************************************************************
+ * Name: perfsuite_circbuf
+ ****************************************************************************/
+
+static unsigned long perfsuite_circbuf(uintptr_t arg, int n)
+{
+  struct circbuf_s circ;
+  unsigned long start;
+  unsigned long elapsed;
+  int i;
+
+  if (circbuf_init(&circ, NULL, 4 * arg) < 0)
+    {
+      return 0;
+    }
+
+  start = up_perf_gettime();
+  for (i = 0; i < n; i++)
+    {
+      circbuf_write(&circ, g_perfsuite_buf, arg);
+      circbuf_read(&circ, g_perfsuite_buf, arg);
+    }
+
+  elapsed = up_perf_gettime() - start;
+
+  circbuf_uninit(&circ);
+  return elapsed;
+}
+
+/****************************************************************************
+ * Name: perfsuite_test
+ *
+ * Description:
+ *   Run an own test and report its best cost per operation.
+ *
+ ****************************************************************************/
+
+static void perfsuite_test(FAR const struct perfsuite_test_s *test)
+{
+  unsigned long best = ~0ul;
+  unsigned long cost;
+  int i;
+
+  for (i = 0; i < PERFSUITE_ROUNDS; i++)
+    {
+      cost = test->run(test->arg, PERFSUITE_BATCH);
+      if (cost < best)
+        {
+          best = cost;
+        }
+    }
+
+  perfsuite_result(test->bench, "perf", best / PERFSUITE_BATCH, "%s",
+                   test->test);
+}
+
+/****************************************************************************
+ * Name: perfsuite_bench
+ *
+ * Description:
+ *   Run a benchmark of this directory with its console output discarded,
+ *   and report its exit status.
+ *
+ ****************************************************************************/
+
+static void perfsuite_bench(FAR const char *bench, main_t entry)
+{
+  FAR char *argv[2];
+  int nullfd;
+  int ret;
+
+  argv[0] = (FAR char *)bench;
+  argv[1] = NULL;
+
+  fflush(stdout);
+  nullfd = open("/dev/null", O_WRONLY);
+  if (nullfd >= 0)
+    {
+      dup2(nullfd, STDOUT_FILENO);
+      close(nullfd);
+    }
+
+  ret = entry(1, argv);
+
+  fflush(stdout);
+  dup2(g_perfsuite_fd, STDOUT_FILENO);
+
+  perfsuite_result(bench, "status", ret, "exit");
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: perfsuite_result
+ *
+ * Description:
+ *   Add one result of a benchmark to the JSON document of perfsuite_main().
+ *
+ ****************************************************************************/
+
+void perfsuite_result(FAR const char *bench, FAR const char *unit,
+                      unsigned long value, FAR const char *fmt, ...)
+{
+  char test[48];
+  va_list ap;
+
+  if (g_perfsuite_fd < 0)
+    {
+      return;
+    }
+
+  va_start(ap, fmt);
+  vsnprintf(test, sizeof(test), fmt, ap);
+  va_end(ap);
+
+  dprintf(g_perfsuite_fd,
+          "%s\n  {\"bench\": \"%s\", \"test\": \"%s\", \"unit\": \"%s\", "
+          "\"value\": %lu}", g_perfsuite_nresults > 0 ? "," : "",
+          bench, test, unit, value);
+  g_perfsuite_nresults++;
+}
+
+/****************************************************************************
+ * Name: perfsuite_main
+ *
+ * Description:
+ *   Main entry point into the performance regression suite.  Can be used
+ *   as CONFIG_INIT_ENTRYPOINT.
+ *
+ ****************************************************************************/
+
+int perfsuite_main(int argc, FAR char *argv[])
+{
+  struct utsname name;
+  int i;
+
+  for (i = 0; i < PERFSUITE_BUFSIZE; i++)
+    {
+      g_perfsuite_buf[i] = i;
+    }
+
+  fflush(stdout);
+  g_perfsuite_fd = dup(STDOUT_FILENO);
+  if (g_perfsuite_fd < 0)
+    {
+      fprintf(stderr, "perfsuite_main: ERROR: dup failed\n");
+      return EXIT_FAILURE;
+    }
+
+  uname(&name);
+  g_perfsuite_nresults = 0;
+
+  dprintf(g_perfsuite_fd,
+          "{\"perfsuite\": 1, \"board\": \"%s\", \"release\": \"%s\", "
+          "\"version\": \"%s\", \"perf_freq\": %lu, \"results\": [",
+          CONFIG_ARCH_BOARD, name.release, name.version,
+          up_perf_getfreq());
+
+  for (i = 0; i < nitems(g_perfsuite); i++)
+    {
+      perfsuite_test(&g_perfsuite[i]);
+    }
+
+#ifdef CONFIG_BOARD_STRBENCH
+  perfsuite_bench("str", strbench_main);
+#endif
+#ifdef CONFIG_BOARD_PRINTFBENCH
+  perfsuite_bench("printf", printfbench_main);
+#endif
+#ifdef CONFIG_BOARD_LIBMBENCH
+  perfsuite_bench("libm", libmbench_main);
+#endif
+#ifdef CONFIG_BOARD_SORTBENCH
+  perfsuite_bench("sort", sortbench_main);
+#endif
+#ifdef CONFIG_BOARD_COMPBENCH
+  perfsuite_bench("comp", compbench_main);
+#endif
+#ifdef CONFIG_BOARD_CRYPTOBENCH
+  perfsuite_bench("crypto", cryptobench_main);
+#endif
+#ifdef CONFIG_BOARD_MALLOCBENCH
+  perfsuite_bench("malloc", mallocbench_main);
+#endif
+#ifdef CONFIG_BOARD_DSPBENCH
+  perfsuite_bench("dsp", dspbench_main);
+#endif
+#ifdef CONFIG_BOARD_NETBENCH
+  perfsuite_bench("net", netbench_main);
+#endif
+
+  dprintf(g_perfsuite_fd, "\n]}\n");
+
+  close(g_perfsuite_fd);
+  g_perfsuite_fd = -1;
+  return EXIT_SUCCESS;
+}
+
+#endif /* CONFIG_BOARD_PERFSUITE */
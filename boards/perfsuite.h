@@ -0,0 +1,80 @@
+/****************************************************************************
+ * boards/perfsuite.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __BOARDS_PERFSUITE_H
+#define __BOARDS_PERFSUITE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/compiler.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_BOARD_PERFSUITE
+#  define perfsuite_result(bench, unit, value, ...)
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_BOARD_PERFSUITE
+
+/****************************************************************************
+ * Name: perfsuite_result
+ *
+ * Description:
+ *   Add one result of a benchmark to the JSON document of perfsuite_main().
+ *   Does nothing when the benchmark is not run by perfsuite_main().
+ *
+ * Input Parameters:
+ *   bench - The benchmark, e.g. "str"
+ *   unit  - "perf" for up_perf_gettime() units, lower is better, a rate
+ *           ending in "/s", higher is better, or another count
+ *   value - The result
+ *   fmt   - Format of the name of the test within the benchmark
+ *
+ ****************************************************************************/
+
+void perfsuite_result(FAR const char *bench, FAR const char *unit,
+                      unsigned long value, FAR const char *fmt, ...)
+                      printf_like(4, 5);
+
+#endif
+
+/* The benchmarks run by perfsuite_main() */
+
+int netbench_main(int argc, FAR char *argv[]);
+int libmbench_main(int argc, FAR char *argv[]);
+int strbench_main(int argc, FAR char *argv[]);
+int printfbench_main(int argc, FAR char *argv[]);
+int sortbench_main(int argc, FAR char *argv[]);
+int compbench_main(int argc, FAR char *argv[]);
+int cryptobench_main(int argc, FAR char *argv[]);
+int mallocbench_main(int argc, FAR char *argv[]);
+int dspbench_main(int argc, FAR char *argv[]);
+
+#endif /* __BOARDS_PERFSUITE_H */
@@ -0,0 +1,225 @@
+/****************************************************************************
+ * boards/printfbench.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* printf() engine benchmark.
+ *
+ * Every format is converted CONFIG_BOARD_PRINTFBENCH_ROUNDS times with
+ * snprintf() into a buffer, so that only the conversion is measured and
+ * not the output device.  The cost is measured with up_perf_gettime()
+ * (CPU cycles on ARMv7-M), per call and per conversion in the format.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/param.h>
+
+#include <nuttx/arch.h>
+
+#include "perfsuite.h"
+
+#ifdef CONFIG_BOARD_PRINTFBENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PRINTFBENCH_ROUNDS  CONFIG_BOARD_PRINTFBENCH_ROUNDS
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One benchmarked format */
+
+struct printfbench_s
+{
+  FAR const char *name;
+  int nconv;                         /* Conversions in the format */
+  int (*fn)(FAR char *buf, size_t size, int round);
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int printfbench_text(FAR char *buf, size_t size, int round);
+static int printfbench_d(FAR char *buf, size_t size, int round);
+static int printfbench_x(FAR char *buf, size_t size, int round);
+static int printfbench_s(FAR char *buf, size_t size, int round);
+static int printfbench_mixed(FAR char *buf, size_t size, int round);
+#ifdef CONFIG_LIBC_LONG_LONG
+static int printfbench_lld(FAR char *buf, size_t size, int round);
+#endif
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+static int printfbench_f(FAR char *buf, size_t size, int round);
+static int printfbench_e(FAR char *buf, size_t size, int round);
+static int printfbench_g(FAR char *buf, size_t size, int round);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct printfbench_s g_printfbench[] =
+{
+  { "text", 1, printfbench_text },
+  { "%d", 1, printfbench_d },
+  { "%08x", 1, printfbench_x },
+  { "%s", 1, printfbench_s },
+  { "%s=%d,%u", 3, printfbench_mixed },
+#ifdef CONFIG_LIBC_LONG_LONG
+  { "%lld", 1, printfbench_lld },
+#endif
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+  { "%.3f", 1, printfbench_f },
+  { "%e", 1, printfbench_e },
+  { "%g", 1, printfbench_g },
+#endif
+};
+
+static volatile int g_sink;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* The benchmarked formats.  The arguments change with the round so that
+ * the number of digits varies.
+ */
+
+static int printfbench_text(FAR char *buf, size_t size, int round)
+{
+  return snprintf(buf, size, "a line of text without conversions\n");
+}
+
+static int printfbench_d(FAR char *buf, size_t size, int round)
+{
+  return snprintf(buf, size, "%d", round * 7919 - 4000000);
+}
+
+static int printfbench_x(FAR char *buf, size_t size, int round)
+{
+  return snprintf(buf, size, "%08x", (unsigned int)round * 2654435761u);
+}
+
+static int printfbench_s(FAR char *buf, size_t size, int round)
+{
+  return snprintf(buf, size, "%s", "a short string");
+}
+
+static int printfbench_mixed(FAR char *buf, size_t size, int round)
+{
+  return snprintf(buf, size, "%s=%d,%u\n", "value", round, round * 13);
+}
+
+#ifdef CONFIG_LIBC_LONG_LONG
+static int printfbench_lld(FAR char *buf, size_t size, int round)
+{
+  return snprintf(buf, size, "%lld", (long long)round * 1000000007ll);
+}
+#endif
+
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+static int printfbench_f(FAR char *buf, size_t size, int round)
+{
+  return snprintf(buf, size, "%.3f", round * 1.37);
+}
+
+static int printfbench_e(FAR char *buf, size_t size, int round)
+{
+  return snprintf(buf, size, "%e", round * 6.02e23);
+}
+
+static int printfbench_g(FAR char *buf, size_t size, int round)
+{
+  return snprintf(buf, size, "%g", round / 7.0);
+}
+#endif
+
+/****************************************************************************
+ * Name: printfbench_run
+ *
+ * Description:
+ *   Measure and print one format.
+ *
+ ****************************************************************************/
+
+static void printfbench_run(FAR const struct printfbench_s *bench)
+{
+  unsigned long start;
+  unsigned long elapsed;
+  char buf[64];
+  int sink = 0;
+  int round;
+
+  start = up_perf_gettime();
+  for (round = 0; round < PRINTFBENCH_ROUNDS; round++)
+    {
+      sink += bench->fn(buf, sizeof(buf), round);
+    }
+
+  elapsed = up_perf_gettime() - start;
+  g_sink  = sink;
+
+  printf("%-10s %8lu %8lu\n", bench->name, elapsed / PRINTFBENCH_ROUNDS,
+         elapsed / PRINTFBENCH_ROUNDS / bench->nconv);
+  perfsuite_result("printf", "perf", elapsed / PRINTFBENCH_ROUNDS, "%s",
+                   bench->name);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: printfbench_main
+ *
+ * Description:
+ *   Main entry point into the printf() engine benchmark.  Can be used as
+ *   CONFIG_INIT_ENTRYPOINT.
+ *
+ ****************************************************************************/
+
+int printfbench_main(int argc, FAR char *argv[])
+{
+  int i;
+
+  printf("printfbench_main: %d calls, costs in up_perf_gettime() units "
+         "at %lu Hz\n", PRINTFBENCH_ROUNDS, up_perf_getfreq());
+  printf("%-10s %8s %8s\n", "format", "call", "conv");
+
+  for (i = 0; i < nitems(g_printfbench); i++)
+    {
+      printfbench_run(&g_printfbench[i]);
+    }
+
+  fflush(stdout);
+  return EXIT_SUCCESS;
+}
+
+#endif /* CONFIG_BOARD_PRINTFBENCH */
@@ -0,0 +1,220 @@
+/****************************************************************************
+ * boards/sortbench.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Sort benchmark.
+ *
+ * qsort() and radixsort32() sort CONFIG_BOARD_SORTBENCH_COUNT uint32_t
+ * keys that are sorted, reverse sorted, sorted with one percent of the
+ * keys swapped, and random.  The cost is measured with up_perf_gettime()
+ * (CPU cycles on ARMv7-M), per sort and per key, and includes the copy of
+ * the input into the sorted array.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include <nuttx/arch.h>
+
+#include "perfsuite.h"
+
+#ifdef CONFIG_BOARD_SORTBENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SORTBENCH_COUNT  CONFIG_BOARD_SORTBENCH_COUNT
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const char *g_sortbench_input[] =
+{
+  "sorted", "reverse", "nearly", "random"
+};
+
+static uint32_t g_sortbench_src[SORTBENCH_COUNT];
+static uint32_t g_sortbench_buf[SORTBENCH_COUNT];
+static uint32_t g_sortbench_tmp[SORTBENCH_COUNT];
+static uint32_t g_sortbench_seed;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t sortbench_rand(void)
+{
+  g_sortbench_seed ^= g_sortbench_seed << 13;
+  g_sortbench_seed ^= g_sortbench_seed >> 17;
+  g_sortbench_seed ^= g_sortbench_seed << 5;
+  return g_sortbench_seed;
+}
+
+static int sortbench_compar(FAR const void *a, FAR const void *b)
+{
+  uint32_t x = *(FAR const uint32_t *)a;
+  uint32_t y = *(FAR const uint32_t *)b;
+
+  return x < y ? -1 : x > y;
+}
+
+/****************************************************************************
+ * Name: sortbench_fill
+ *
+ * Description:
+ *   Fill the input array with one of the input kinds.
+ *
+ ****************************************************************************/
+
+static void sortbench_fill(int kind)
+{
+  uint32_t tmp;
+  int i;
+  int j;
+
+  g_sortbench_seed = 0x2545f491;
+  for (i = 0; i < SORTBENCH_COUNT; i++)
+    {
+      switch (kind)
+        {
+          case 0:
+          case 2:
+            g_sortbench_src[i] = i * 16;
+            break;
+
+          case 1:
+            g_sortbench_src[i] = (SORTBENCH_COUNT - i) * 16;
+            break;
+
+          default:
+            g_sortbench_src[i] = sortbench_rand();
+            break;
+        }
+    }
+
+  if (kind == 2)
+    {
+      for (i = 0; i < SORTBENCH_COUNT / 100; i++)
+        {
+          j   = sortbench_rand() % SORTBENCH_COUNT;
+          tmp = g_sortbench_src[i * 100];
+          g_sortbench_src[i * 100] = g_sortbench_src[j];
+          g_sortbench_src[j] = tmp;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: sortbench_check
+ *
+ * Description:
+ *   Return true if the sorted array is in order.
+ *
+ ****************************************************************************/
+
+static bool sortbench_check(void)
+{
+  int i;
+
+  for (i = 1; i < SORTBENCH_COUNT; i++)
+    {
+      if (g_sortbench_buf[i - 1] > g_sortbench_buf[i])
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sortbench_main
+ *
+ * Description:
+ *   Main entry point into the sort benchmark.  Can be used as
+ *   CONFIG_INIT_ENTRYPOINT.
+ *
+ ****************************************************************************/
+
+int sortbench_main(int argc, FAR char *argv[])
+{
+  unsigned long start;
+  unsigned long qcost;
+  unsigned long rcost;
+  bool ok = true;
+  int i;
+
+  printf("sortbench_main: %d keys, costs in up_perf_gettime() units "
+         "at %lu Hz\n", SORTBENCH_COUNT, up_perf_getfreq());
+  printf("%-8s %10s %6s %10s %6s\n",
+         "input", "qsort", "/key", "radix", "/key");
+
+  for (i = 0; i < nitems(g_sortbench_input); i++)
+    {
+      sortbench_fill(i);
+
+      start = up_perf_gettime();
+      memcpy(g_sortbench_buf, g_sortbench_src, sizeof(g_sortbench_buf));
+      qsort(g_sortbench_buf, SORTBENCH_COUNT, sizeof(uint32_t),
+            sortbench_compar);
+      qcost = up_perf_gettime() - start;
+      ok &= sortbench_check();
+
+      start = up_perf_gettime();
+      memcpy(g_sortbench_buf, g_sortbench_src, sizeof(g_sortbench_buf));
+      radixsort32(g_sortbench_buf, SORTBENCH_COUNT, sizeof(uint32_t), 0,
+                  g_sortbench_tmp);
+      rcost = up_perf_gettime() - start;
+      ok &= sortbench_check();
+
+      printf("%-8s %10lu %6lu %10lu %6lu\n", g_sortbench_input[i],
+             qcost, qcost / SORTBENCH_COUNT, rcost, rcost / SORTBENCH_COUNT);
+      perfsuite_result("sort", "perf", qcost, "qsort/%s",
+                       g_sortbench_input[i]);
+      perfsuite_result("sort", "perf", rcost, "radix/%s",
+                       g_sortbench_input[i]);
+    }
+
+  if (!ok)
+    {
+      printf("sortbench_main: ERROR: an array was not sorted\n");
+    }
+
+  fflush(stdout);
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+#endif /* CONFIG_BOARD_SORTBENCH */
@@ -0,0 +1,305 @@
+/****************************************************************************
+ * boards/strbench.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* String function benchmark.
+ *
+ * Every function is called CONFIG_BOARD_STRBENCH_ROUNDS times on buffers
+ * of several lengths, with both buffers word aligned and with the first
+ * buffer one byte and the second three bytes off.  The call does not
+ * stop early: the buffers are equal, the searched byte does not occur and
+ * the strings end at the given length.  The cost is measured with
+ * up_perf_gettime() (CPU cycles on ARMv7-M) and includes the loop, which
+ * the "none" line measures alone.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/compiler.h>
+
+#include "perfsuite.h"
+
+#ifdef CONFIG_BOARD_STRBENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define STRBENCH_ROUNDS  CONFIG_BOARD_STRBENCH_ROUNDS
+#define STRBENCH_MAXLEN  256
+#define STRBENCH_CHAR    'z'    /* Never in the buffers */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One benchmarked function */
+
+struct strbench_s
+{
+  FAR const char *name;
+  uintptr_t (*fn)(FAR const char *s1, FAR const char *s2, size_t n);
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static uintptr_t strbench_none(FAR const char *s1, FAR const char *s2,
+                               size_t n);
+static uintptr_t strbench_memchr(FAR const char *s1, FAR const char *s2,
+                                 size_t n);
+static uintptr_t strbench_memcmp(FAR const char *s1, FAR const char *s2,
+                                 size_t n);
+static uintptr_t strbench_memrchr(FAR const char *s1, FAR const char *s2,
+                                  size_t n);
+static uintptr_t strbench_strchr(FAR const char *s1, FAR const char *s2,
+                                 size_t n);
+static uintptr_t strbench_strcmp(FAR const char *s1, FAR const char *s2,
+                                 size_t n);
+static uintptr_t strbench_strlen(FAR const char *s1, FAR const char *s2,
+                                 size_t n);
+static uintptr_t strbench_strncmp(FAR const char *s1, FAR const char *s2,
+                                  size_t n);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct strbench_s g_strbench[] =
+{
+  { "none", strbench_none },
+  { "memchr", strbench_memchr },
+  { "memcmp", strbench_memcmp },
+  { "memrchr", strbench_memrchr },
+  { "strchr", strbench_strchr },
+  { "strcmp", strbench_strcmp },
+  { "strlen", strbench_strlen },
+  { "strncmp", strbench_strncmp },
+};
+
+static const size_t g_strbench_len[] =
+{
+  4, 16, 64, STRBENCH_MAXLEN
+};
+
+/* Offsets of the first and of the second buffer from word alignment */
+
+static const uint8_t g_strbench_off[][2] =
+{
+  {
+    0, 0
+  },
+  {
+    1, 3
+  }
+};
+
+static aligned_data(8) char g_buf1[STRBENCH_MAXLEN + 8];
+static aligned_data(8) char g_buf2[STRBENCH_MAXLEN + 8];
+static volatile uintptr_t g_sink;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* The benchmarked functions behind one signature.  They are not inlined so
+ * that the library calls stay calls.
+ */
+
+static noinline_function uintptr_t strbench_none(FAR const char *s1,
+                                                 FAR const char *s2,
+                                                 size_t n)
+{
+  return n;
+}
+
+static noinline_function uintptr_t strbench_memchr(FAR const char *s1,
+                                                   FAR const char *s2,
+                                                   size_t n)
+{
+  return (uintptr_t)memchr(s1, STRBENCH_CHAR, n);
+}
+
+static noinline_function uintptr_t strbench_memcmp(FAR const char *s1,
+                                                   FAR const char *s2,
+                                                   size_t n)
+{
+  return memcmp(s1, s2, n);
+}
+
+static noinline_function uintptr_t strbench_memrchr(FAR const char *s1,
+                                                    FAR const char *s2,
+                                                    size_t n)
+{
+  return (uintptr_t)memrchr(s1, STRBENCH_CHAR, n);
+}
+
+static noinline_function uintptr_t strbench_strchr(FAR const char *s1,
+                                                   FAR const char *s2,
+                                                   size_t n)
+{
+  return (uintptr_t)strchr(s1, STRBENCH_CHAR);
+}
+
+static noinline_function uintptr_t strbench_strcmp(FAR const char *s1,
+                                                   FAR const char *s2,
+                                                   size_t n)
+{
+  return strcmp(s1, s2);
+}
+
+static noinline_function uintptr_t strbench_strlen(FAR const char *s1,
+                                                   FAR const char *s2,
+                                                   size_t n)
+{
+  return strlen(s1);
+}
+
+static noinline_function uintptr_t strbench_strncmp(FAR const char *s1,
+                                                    FAR const char *s2,
+                                                    size_t n)
+{
+  return strncmp(s1, s2, n + 1);
+}
+
+/****************************************************************************
+ * Name: strbench_fill
+ *
+ * Description:
+ *   Fill a buffer with a string of n bytes at an offset.
+ *
+ ****************************************************************************/
+
+static FAR char *strbench_fill(FAR char *buf, size_t off, size_t n)
+{
+  size_t i;
+
+  memset(buf, 0, STRBENCH_MAXLEN + 8);
+  for (i = 0; i < n; i++)
+    {
+      buf[off + i] = 'a' + i % 25;
+    }
+
+  return buf + off;
+}
+
+/****************************************************************************
+ * Name: strbench_run
+ *
+ * Description:
+ *   Measure and print one function for every length and alignment.
+ *
+ ****************************************************************************/
+
+static void strbench_run(FAR const struct strbench_s *bench)
+{
+  unsigned long start;
+  unsigned long elapsed;
+  uintptr_t sink = 0;
+  FAR char *s1;
+  FAR char *s2;
+  size_t n;
+  int round;
+  int i;
+  int j;
+
+  printf("%-8s", bench->name);
+
+  for (i = 0; i < nitems(g_strbench_len); i++)
+    {
+      for (j = 0; j < nitems(g_strbench_off); j++)
+        {
+          n  = g_strbench_len[i];
+          s1 = strbench_fill(g_buf1, g_strbench_off[j][0], n);
+          s2 = strbench_fill(g_buf2, g_strbench_off[j][1], n);
+
+          start = up_perf_gettime();
+          for (round = 0; round < STRBENCH_ROUNDS; round++)
+            {
+              sink += bench->fn(s1, s2, n);
+            }
+
+          elapsed = up_perf_gettime() - start;
+          printf(" %8lu", elapsed / STRBENCH_ROUNDS);
+          perfsuite_result("str", "perf", elapsed / STRBENCH_ROUNDS,
+                           "%s/%zu/%u:%u", bench->name, n,
+                           g_strbench_off[j][0], g_strbench_off[j][1]);
+        }
+    }
+
+  g_sink = sink;
+  printf("\n");
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: strbench_main
+ *
+ * Description:
+ *   Main entry point into the string function benchmark.  Can be used as
+ *   CONFIG_INIT_ENTRYPOINT.
+ *
+ ****************************************************************************/
+
+int strbench_main(int argc, FAR char *argv[])
+{
+  int i;
+  int j;
+
+  printf("strbench_main: %d calls, costs in up_perf_gettime() units "
+         "at %lu Hz\n", STRBENCH_ROUNDS, up_perf_getfreq());
+
+  printf("%-8s", "length");
+  for (i = 0; i < nitems(g_strbench_len); i++)
+    {
+      for (j = 0; j < nitems(g_strbench_off); j++)
+        {
+          printf(" %4zu/%u:%u", g_strbench_len[i],
+                 g_strbench_off[j][0], g_strbench_off[j][1]);
+        }
+    }
+
+  printf("\n");
+
+  for (i = 0; i < nitems(g_strbench); i++)
+    {
+      strbench_run(&g_strbench[i]);
+    }
+
+  fflush(stdout);
+  return EXIT_SUCCESS;
+}
+
+#endif /* CONFIG_BOARD_STRBENCH */
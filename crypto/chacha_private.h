@@ -29,6 +29,28 @@ chacha_ctx;
 #define ROTL32(v, n) \
   (U32V((v) << (n)) | ((v) >> (32 - (n))))
 
+/* A little-endian core that allows unaligned accesses moves the words in
+ * one load or store each.  memcpy() keeps the compiler from pairing them
+ * into the multiple transfers that do need alignment.
+ */
+
+#ifdef CONFIG_CRYPTO_CHACHA_WORD_ACCESS
+#define U8TO32_LITTLE(p) chacha_load32(p)
+#define U32TO8_LITTLE(p, v) chacha_store32(p, v)
+
+static inline uint32_t chacha_load32(FAR const void *p)
+{
+  uint32_t v;
+
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline void chacha_store32(FAR void *p, uint32_t v)
+{
+  memcpy(p, &v, sizeof(v));
+}
+#else
 #define U8TO32_LITTLE(p) \
     (((uint32_t)((p)[0])) | \
     ((uint32_t)((p)[1]) << 8) | \
@@ -42,6 +64,7 @@ chacha_ctx;
     (p)[2] = U8V((v) >> 16); \
     (p)[3] = U8V((v) >> 24); \
   } while (0)
+#endif
 
 #define ROTATE(v, c) (ROTL32(v, c))
 #define XOR(v, w) ((v) ^ (w))
@@ -43,10 +43,17 @@
 #include <errno.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/crypto/crypto.h>
 #include <nuttx/drivers/drivers.h>
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+#  include <nuttx/queue.h>
+#  include <nuttx/semaphore.h>
+#  include <nuttx/wqueue.h>
+#endif
+
 #include <crypto/xform.h>
 #include <crypto/cryptodev.h>
 #include <crypto/cryptosoft.h>
@@ -89,12 +96,42 @@ struct csession
   caddr_t mackey;
   int mackeylen;
   int error;
+
+  /* The request of the session, kept from one operation to the next */
+
+  FAR struct cryptop *crp;
 };
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+struct cryptodev_batch_s
+{
+  sq_entry_t node;
+  struct crypt_mop mop;
+};
+#endif
+
 struct fcrypt
 {
   TAILQ_HEAD(csessionlist, csession) csessions;
   int sesn;
+  mutex_t lock;
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  /* Queued batches run on the low priority work queue and are moved to
+   * 'done' when complete.  'queued' is set while the work is scheduled
+   * or running, and 'exited' is posted by the work when it finds that the
+   * file is being closed.
+   */
+
+  struct work_s work;
+  sem_t exited;
+  sq_queue_t pending;
+  sq_queue_t done;
+  int nbatch;
+  bool queued;
+  bool closing;
+  FAR struct pollfd *fds[CONFIG_CRYPTO_CRYPTODEV_NPOLLWAITERS];
+#endif
 };
 
 /****************************************************************************
@@ -109,6 +146,8 @@ static ssize_t cryptof_write(FAR struct file *filep,
                              FAR const char *buffer, size_t len);
 static int cryptof_ioctl(FAR struct file *filep,
                          int cmd, unsigned long arg);
+static int cryptof_doioctl(FAR struct fcrypt *fcr,
+                           int cmd, unsigned long arg);
 static int cryptof_poll(FAR struct file *filep,
                         struct pollfd *fds, bool setup);
 static int cryptof_close(FAR struct file *filep);
@@ -178,6 +217,17 @@ int cryptodev_dokey(FAR struct crypt_kop *kop, FAR struct crparam *kvp);
 int cryptodev_cb(FAR struct cryptop *);
 int cryptodevkey_cb(FAR struct cryptkop *);
 
+static void cryptodev_resetreq(FAR struct cryptop *crp);
+static void cryptodev_nop(FAR struct fcrypt *fcr,
+                          FAR struct crypt_n_op *nop);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+static void cryptodev_worker(FAR void *arg);
+static int cryptodev_submit(FAR struct fcrypt *fcr,
+                            FAR struct crypt_mop *mop);
+static int cryptodev_fetch(FAR struct fcrypt *fcr,
+                           FAR struct crypt_mop *mop);
+#endif
+
 /* ARGSUSED */
 
 static ssize_t cryptof_read(FAR struct file *filep,
@@ -198,17 +248,35 @@ static ssize_t cryptof_write(FAR struct file *filep,
 
 static int cryptof_ioctl(FAR struct file *filep,
                          int cmd, unsigned long arg)
+{
+  FAR struct fcrypt *fcr = filep->f_priv;
+  int error;
+
+  /* The sessions are shared with the asynchronous operations and with
+   * the other threads that use the file.
+   */
+
+  nxmutex_lock(&fcr->lock);
+  error = cryptof_doioctl(fcr, cmd, arg);
+  nxmutex_unlock(&fcr->lock);
+
+  return error;
+}
+
+static int cryptof_doioctl(FAR struct fcrypt *fcr,
+                           int cmd, unsigned long arg)
 {
   struct cryptoini cria;
   struct cryptoini crie;
-  FAR struct fcrypt *fcr = filep->f_priv;
   FAR struct csession *cse;
   FAR struct session_op *sop;
   FAR struct crypt_op *cop;
+  FAR struct crypt_mop *mop;
   bool txform = false;
   bool thash = false;
   uint64_t sid;
   uint32_t ses;
+  uint32_t i;
   int error = 0;
 
   switch (cmd)
@@ -357,6 +425,27 @@ bail:
 
         error = cryptodev_op(cse, cop);
         break;
+      case CIOCNCRYPTM:
+        mop = (FAR struct crypt_mop *)arg;
+        if (mop->count == 0 || mop->reqs == NULL)
+          {
+            return -EINVAL;
+          }
+
+        for (i = 0; i < mop->count; i++)
+          {
+            cryptodev_nop(fcr, &mop->reqs[i]);
+          }
+
+        break;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+      case CIOCASYNCCRYPTM:
+        error = cryptodev_submit(fcr, (FAR struct crypt_mop *)arg);
+        break;
+      case CIOCASYNCFETCH:
+        error = cryptodev_fetch(fcr, (FAR struct crypt_mop *)arg);
+        break;
+#endif
       case CIOCKEY:
         error = cryptodev_key((FAR struct crypt_kop *)arg);
         break;
@@ -392,13 +481,24 @@ int cryptodev_op(FAR struct csession *cse,
         }
     }
 
-  /* number of requests, not logical and */
+  /* number of requests, not logical and.  The request is allocated by the
+   * first operation of the session and reused by the next ones.
+   */
 
-  crp = crypto_getreq(cse->txform + cse->thash);
+  crp = cse->crp;
   if (crp == NULL)
     {
-      error = -ENOMEM;
-      goto bail;
+      crp = crypto_getreq(cse->txform + cse->thash);
+      if (crp == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      cse->crp = crp;
+    }
+  else
+    {
+      cryptodev_resetreq(crp);
     }
 
   if (cse->thash)
@@ -547,14 +647,186 @@ processed:
     }
 
 bail:
-  if (crp)
+  return error;
+}
+
+/****************************************************************************
+ * Name: cryptodev_resetreq
+ *
+ * Description:
+ *   Return a request and its descriptors to the state that
+ *   crypto_getreq() allocates them in.
+ *
+ ****************************************************************************/
+
+static void cryptodev_resetreq(FAR struct cryptop *crp)
+{
+  FAR struct cryptodesc *desc = crp->crp_desc;
+  FAR struct cryptodesc *next;
+  FAR struct cryptodesc *crd;
+
+  for (crd = desc; crd != NULL; crd = next)
     {
-      crypto_freereq(crp);
+      next = crd->crd_next;
+      bzero(crd, sizeof(struct cryptodesc));
+      crd->crd_next = next;
     }
 
-  return error;
+  bzero(crp, sizeof(struct cryptop));
+  crp->crp_desc = desc;
+}
+
+/****************************************************************************
+ * Name: cryptodev_nop
+ *
+ * Description:
+ *   Run one operation of a batch and return its result in its status.
+ *   Called with the lock of the file held.
+ *
+ ****************************************************************************/
+
+static void cryptodev_nop(FAR struct fcrypt *fcr,
+                          FAR struct crypt_n_op *nop)
+{
+  FAR struct csession *cse;
+
+  cse = csefind(fcr, nop->cop.ses);
+  if (cse == NULL)
+    {
+      nop->status = -EINVAL;
+    }
+  else
+    {
+      nop->status = cryptodev_op(cse, &nop->cop);
+    }
 }
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+
+/****************************************************************************
+ * Name: cryptodev_worker
+ *
+ * Description:
+ *   Run the queued batches of a file on the work queue.  The lock is
+ *   released between two operations so that the ioctls of the file do not
+ *   wait for a whole batch.
+ *
+ ****************************************************************************/
+
+static void cryptodev_worker(FAR void *arg)
+{
+  FAR struct fcrypt *fcr = arg;
+  FAR struct cryptodev_batch_s *batch;
+  bool closing;
+  uint32_t i;
+
+  nxmutex_lock(&fcr->lock);
+
+  while (!fcr->closing &&
+         (batch = (FAR struct cryptodev_batch_s *)
+                  sq_peek(&fcr->pending)) != NULL)
+    {
+      for (i = 0; i < batch->mop.count && !fcr->closing; i++)
+        {
+          cryptodev_nop(fcr, &batch->mop.reqs[i]);
+
+          nxmutex_unlock(&fcr->lock);
+          nxmutex_lock(&fcr->lock);
+        }
+
+      sq_remfirst(&fcr->pending);
+      sq_addlast(&batch->node, &fcr->done);
+      poll_notify(fcr->fds, CONFIG_CRYPTO_CRYPTODEV_NPOLLWAITERS, POLLIN);
+    }
+
+  fcr->queued = false;
+  closing = fcr->closing;
+  nxmutex_unlock(&fcr->lock);
+
+  if (closing)
+    {
+      nxsem_post(&fcr->exited);
+    }
+}
+
+/****************************************************************************
+ * Name: cryptodev_submit
+ *
+ * Description:
+ *   Queue a batch of operations on the work queue.  poll() reports POLLIN
+ *   when a batch is complete.
+ *
+ ****************************************************************************/
+
+static int cryptodev_submit(FAR struct fcrypt *fcr,
+                            FAR struct crypt_mop *mop)
+{
+  FAR struct cryptodev_batch_s *batch;
+
+  if (mop->count == 0 || mop->reqs == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (fcr->nbatch >= CONFIG_CRYPTO_CRYPTODEV_ASYNC_DEPTH)
+    {
+      return -EBUSY;
+    }
+
+  batch = kmm_malloc(sizeof(struct cryptodev_batch_s));
+  if (batch == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  batch->mop = *mop;
+  sq_addlast(&batch->node, &fcr->pending);
+  fcr->nbatch++;
+
+  if (!fcr->queued)
+    {
+      fcr->queued = true;
+      work_queue(LPWORK, &fcr->work, cryptodev_worker, fcr, 0);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cryptodev_fetch
+ *
+ * Description:
+ *   Take the oldest complete batch.  The status of each of its operations
+ *   has been set.
+ *
+ * Returned Value:
+ *   OK, or -EAGAIN if no batch is complete.
+ *
+ ****************************************************************************/
+
+static int cryptodev_fetch(FAR struct fcrypt *fcr,
+                           FAR struct crypt_mop *mop)
+{
+  FAR struct cryptodev_batch_s *batch;
+
+  batch = (FAR struct cryptodev_batch_s *)sq_remfirst(&fcr->done);
+  if (batch == NULL)
+    {
+      return -EAGAIN;
+    }
+
+  *mop = batch->mop;
+  kmm_free(batch);
+
+  if (fcr->nbatch-- == CONFIG_CRYPTO_CRYPTODEV_ASYNC_DEPTH)
+    {
+      poll_notify(fcr->fds, CONFIG_CRYPTO_CRYPTODEV_NPOLLWAITERS, POLLOUT);
+    }
+
+  return OK;
+}
+#endif /* CONFIG_CRYPTO_CRYPTODEV_ASYNC */
+
 int cryptodev_key(FAR struct crypt_kop *kop)
 {
   FAR struct cryptkop *krp = NULL;
@@ -681,7 +953,56 @@ fail:
 static int cryptof_poll(FAR struct file *filep,
                         struct pollfd *fds, bool setup)
 {
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  FAR struct fcrypt *fcr = filep->f_priv;
+  pollevent_t eventset = 0;
+  int ret = OK;
+  int i;
+
+  nxmutex_lock(&fcr->lock);
+
+  if (setup)
+    {
+      for (i = 0; i < CONFIG_CRYPTO_CRYPTODEV_NPOLLWAITERS; i++)
+        {
+          if (fcr->fds[i] == NULL)
+            {
+              fcr->fds[i] = fds;
+              fds->priv = &fcr->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_CRYPTO_CRYPTODEV_NPOLLWAITERS)
+        {
+          ret = -EBUSY;
+          goto out;
+        }
+
+      if (!sq_empty(&fcr->done))
+        {
+          eventset |= POLLIN;
+        }
+
+      if (fcr->nbatch < CONFIG_CRYPTO_CRYPTODEV_ASYNC_DEPTH)
+        {
+          eventset |= POLLOUT;
+        }
+
+      poll_notify(&fds, 1, eventset);
+    }
+  else if (fds->priv != NULL)
+    {
+      *(FAR struct pollfd **)fds->priv = NULL;
+      fds->priv = NULL;
+    }
+
+out:
+  nxmutex_unlock(&fcr->lock);
+  return ret;
+#else
   return 0;
+#endif
 }
 
 /* ARGSUSED */
@@ -690,6 +1011,34 @@ static int cryptof_close(FAR struct file *filep)
 {
   FAR struct fcrypt *fcr = filep->f_priv;
   FAR struct csession *cse;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  FAR sq_entry_t *batch;
+  bool wait;
+
+  /* Stop the work, waiting for it if it has already started */
+
+  nxmutex_lock(&fcr->lock);
+  fcr->closing = true;
+  wait = fcr->queued && work_cancel(LPWORK, &fcr->work) < 0;
+  nxmutex_unlock(&fcr->lock);
+
+  if (wait)
+    {
+      nxsem_wait_uninterruptible(&fcr->exited);
+    }
+
+  while ((batch = sq_remfirst(&fcr->pending)) != NULL)
+    {
+      kmm_free(batch);
+    }
+
+  while ((batch = sq_remfirst(&fcr->done)) != NULL)
+    {
+      kmm_free(batch);
+    }
+
+  nxsem_destroy(&fcr->exited);
+#endif
 
   while ((cse = TAILQ_FIRST(&fcr->csessions)))
     {
@@ -697,6 +1046,7 @@ static int cryptof_close(FAR struct file *filep)
       (void)csefree(cse);
     }
 
+    nxmutex_destroy(&fcr->lock);
     kmm_free(fcr);
     filep->f_priv = NULL;
 
@@ -739,13 +1089,28 @@ static int cryptoioctl(FAR struct file *filep, int cmd, unsigned long arg)
   switch (cmd)
     {
       case CRIOGET:
-        fcr = kmm_malloc(sizeof(struct fcrypt));
+        fcr = kmm_zalloc(sizeof(struct fcrypt));
+        if (fcr == NULL)
+          {
+            return -ENOMEM;
+          }
+
         TAILQ_INIT(&fcr->csessions);
+        nxmutex_init(&fcr->lock);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+        nxsem_init(&fcr->exited, 0, 0);
+        sq_init(&fcr->pending);
+        sq_init(&fcr->done);
+#endif
 
         fd = file_allocate(&g_cryptoinode, 0,
                            0, fcr, 0, true);
         if (fd < 0)
           {
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+            nxsem_destroy(&fcr->exited);
+#endif
+            nxmutex_destroy(&fcr->lock);
             kmm_free(fcr);
             return fd;
           }
@@ -819,6 +1184,7 @@ FAR struct csession *csecreate(FAR struct fcrypt *fcr, uint64_t sid,
       cse->txform = txform;
       cse->thash = thash;
       cse->error = 0;
+      cse->crp = NULL;
       cseadd(fcr, cse);
     }
 
@@ -830,6 +1196,7 @@ int csefree(FAR struct csession *cse)
   int error;
 
   error = crypto_freesession(cse->sid);
+  crypto_freereq(cse->crp);
   if (cse->key)
     {
       kmm_free(cse->key);
@@ -34,18 +34,154 @@
 #include <crypto/aes.h>
 #include <crypto/gmac.h>
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_CRYPTO_GHASH_CTMUL
+
+/* Carry-less 32 x 32 -> 64 bit multiplication by integer multiplication
+ * with holes: the bits of each operand are split over four words with
+ * three zero bits between them, which take the carries of the products.
+ * There are no branches or table lookups, so the time taken does not
+ * depend on the data on a core with a constant time multiplier, such as
+ * the Cortex-M4.
+ */
+
+static uint64_t ghash_bmul32(uint32_t x, uint32_t y)
+{
+  uint32_t x0 = x & 0x11111111;
+  uint32_t x1 = x & 0x22222222;
+  uint32_t x2 = x & 0x44444444;
+  uint32_t x3 = x & 0x88888888;
+  uint32_t y0 = y & 0x11111111;
+  uint32_t y1 = y & 0x22222222;
+  uint32_t y2 = y & 0x44444444;
+  uint32_t y3 = y & 0x88888888;
+  uint64_t z0;
+  uint64_t z1;
+  uint64_t z2;
+  uint64_t z3;
+
+  z0 = ((uint64_t)x0 * y0) ^ ((uint64_t)x1 * y3) ^
+       ((uint64_t)x2 * y2) ^ ((uint64_t)x3 * y1);
+  z1 = ((uint64_t)x0 * y1) ^ ((uint64_t)x1 * y0) ^
+       ((uint64_t)x2 * y3) ^ ((uint64_t)x3 * y2);
+  z2 = ((uint64_t)x0 * y2) ^ ((uint64_t)x1 * y1) ^
+       ((uint64_t)x2 * y0) ^ ((uint64_t)x3 * y3);
+  z3 = ((uint64_t)x0 * y3) ^ ((uint64_t)x1 * y2) ^
+       ((uint64_t)x2 * y1) ^ ((uint64_t)x3 * y0);
+
+  return (z0 & 0x1111111111111111ull) | (z1 & 0x2222222222222222ull) |
+         (z2 & 0x4444444444444444ull) | (z3 & 0x8888888888888888ull);
+}
+
+/* Carry-less 64 x 64 -> 128 bit multiplication, Karatsuba */
+
+static void ghash_bmul64(uint64_t x, uint64_t y, FAR uint64_t *r)
+{
+  uint32_t x0 = (uint32_t)x;
+  uint32_t x1 = (uint32_t)(x >> 32);
+  uint32_t y0 = (uint32_t)y;
+  uint32_t y1 = (uint32_t)(y >> 32);
+  uint64_t lo;
+  uint64_t hi;
+  uint64_t mid;
+
+  lo  = ghash_bmul32(x0, y0);
+  hi  = ghash_bmul32(x1, y1);
+  mid = ghash_bmul32(x0 ^ x1, y0 ^ y1) ^ lo ^ hi;
+
+  r[0] = lo ^ (mid << 32);
+  r[1] = hi ^ (mid >> 32);
+}
+
+/* x = x * h in GF(2^128) with the field elements in polynomial order, bit
+ * i of the 128 bits being the coefficient of x^i.  Karatsuba again, then
+ * reduction by x^128 + x^7 + x^2 + x + 1.
+ */
+
+static void ghash_mul(FAR uint64_t *x, FAR const uint64_t *h)
+{
+  uint64_t l[2];
+  uint64_t m[2];
+  uint64_t u[2];
+  uint64_t c[4];
+  uint64_t e;
+
+  ghash_bmul64(x[0], h[0], l);
+  ghash_bmul64(x[1], h[1], u);
+  ghash_bmul64(x[0] ^ x[1], h[0] ^ h[1], m);
+
+  c[0] = l[0];
+  c[1] = l[1] ^ m[0] ^ l[0] ^ u[0];
+  c[2] = u[0] ^ m[1] ^ l[1] ^ u[1];
+  c[3] = u[1];
+
+  e     = (c[3] >> 63) ^ (c[3] >> 62) ^ (c[3] >> 57);
+  c[2] ^= e;
+
+  x[0] = c[0] ^ c[2] ^ (c[2] << 1) ^ (c[2] << 2) ^ (c[2] << 7);
+  x[1] = c[1] ^ c[3] ^ (c[3] << 1 | c[2] >> 63) ^
+         (c[3] << 2 | c[2] >> 62) ^ (c[3] << 7 | c[2] >> 57);
+}
+
+/* GHASH numbers the bits of each byte from the most significant one.
+ * Reversing the bits of every byte of a little-endian load puts the
+ * coefficient of x^i at bit i.
+ */
+
+static uint64_t ghash_rbit8(uint64_t v)
+{
+  v = ((v >> 1) & 0x5555555555555555ull) |
+      ((v & 0x5555555555555555ull) << 1);
+  v = ((v >> 2) & 0x3333333333333333ull) |
+      ((v & 0x3333333333333333ull) << 2);
+  v = ((v >> 4) & 0x0f0f0f0f0f0f0f0full) |
+      ((v & 0x0f0f0f0f0f0f0f0full) << 4);
+  return v;
+}
+
+static void ghash_load(FAR const uint8_t *p, FAR uint64_t *v)
+{
+  uint64_t w[2];
+
+  memcpy(w, p, sizeof(w));
+  v[0] = ghash_rbit8(le64toh(w[0]));
+  v[1] = ghash_rbit8(le64toh(w[1]));
+}
+
+static void ghash_store(FAR uint8_t *p, FAR const uint64_t *v)
+{
+  uint64_t w[2];
+  w[0] = htole64(ghash_rbit8(v[0]));
+  w[1] = htole64(ghash_rbit8(v[1]));
+  memcpy(p, w, sizeof(w));
+}
+
+#endif /* CONFIG_CRYPTO_GHASH_CTMUL */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 void ghash_gfmul(FAR uint32_t *, FAR uint32_t *, FAR uint32_t *);
 void ghash_update_mi(FAR GHASH_CTX *, FAR uint8_t *, size_t);
+#ifdef CONFIG_CRYPTO_GHASH_CTMUL
+void ghash_update_ctmul(FAR GHASH_CTX *, FAR uint8_t *, size_t);
+#endif
 
 /* Allow overriding with optimized MD function */
 
+#ifdef CONFIG_CRYPTO_GHASH_CTMUL
+CODE void (*ghash_update)(FAR GHASH_CTX *,
+                          FAR uint8_t *,
+                          size_t) = ghash_update_ctmul;
+#else
 CODE void (*ghash_update)(FAR GHASH_CTX *,
                           FAR uint8_t *,
                           size_t) = ghash_update_mi;
+#endif
 
 /* Computes a block multiplication in the GF(2^128) */
 
@@ -116,6 +252,33 @@ void ghash_update_mi(FAR GHASH_CTX *ctx, FAR uint8_t *X, size_t len)
   bcopy(ctx->S, ctx->Z, GMAC_BLOCK_LEN);
 }
 
+#ifdef CONFIG_CRYPTO_GHASH_CTMUL
+void ghash_update_ctmul(FAR GHASH_CTX *ctx, FAR uint8_t *X, size_t len)
+{
+  uint64_t h[2];
+  uint64_t y[2];
+  uint64_t x[2];
+  size_t i;
+
+  ghash_load(ctx->H, h);
+  ghash_load(ctx->Z, y);
+
+  for (i = 0; i < len / GMAC_BLOCK_LEN; i++)
+    {
+      ghash_load(X, x);
+      y[0] ^= x[0];
+      y[1] ^= x[1];
+      ghash_mul(y, h);
+      X += GMAC_BLOCK_LEN;
+    }
+
+  ghash_store(ctx->S, y);
+  bcopy(ctx->S, ctx->Z, GMAC_BLOCK_LEN);
+
+  explicit_bzero(h, sizeof(h));
+}
+#endif
+
 #define AESCTR_NONCESIZE 4
 
 void aes_gmac_init(FAR void *xctx)
@@ -35,7 +35,11 @@
 
 #include <crypto/rijndael.h>
 
-#undef FULL_UNROLL
+#ifdef CONFIG_CRYPTO_AES_UNROLL
+#  define FULL_UNROLL
+#else
+#  undef FULL_UNROLL
+#endif
 
 /* TE0[x] = S [x].[02, 01, 01, 03];
  * TE1[x] = S [x].[03, 02, 01, 01];
@@ -57,7 +57,8 @@
  */
 
 #ifndef SMALL_KERNEL
-#  if defined(__amd64__) || defined(__i386__)
+#  if defined(__amd64__) || defined(__i386__) || \
+      defined(CONFIG_CRYPTO_SHA2_UNROLL)
 #    define SHA2_UNROLL_TRANSFORM
 #  endif
 #endif
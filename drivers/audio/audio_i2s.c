@@ -94,6 +94,11 @@ static int audio_i2s_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
 static void audio_i2s_callback(struct i2s_dev_s *dev,
                                FAR struct ap_buffer_s *apb, FAR void *arg,
                                int result);
+#ifdef CONFIG_AUDIO_RING_MAPPING
+static void audio_i2s_period(struct i2s_dev_s *dev,
+                             FAR struct ap_buffer_s *apb, FAR void *arg,
+                             int result);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -356,6 +361,30 @@ static int audio_i2s_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
   FAR struct audio_i2s_s *audio_i2s = (struct audio_i2s_s *)dev;
   FAR struct i2s_dev_s *i2s = audio_i2s->i2s;
 
+#ifdef CONFIG_AUDIO_RING_MAPPING
+  /* Route the period notifications of the mapped ring to the upper half */
+
+  if (cmd == AUDIOIOC_MAPRING)
+    {
+      FAR struct audio_ring_s *desc = (FAR struct audio_ring_s *)arg;
+      struct i2s_ring_s ring;
+      int ret;
+
+      ring.ring     = *desc;
+      ring.playback = audio_i2s->playback;
+      ring.callback = audio_i2s_period;
+      ring.arg      = audio_i2s;
+
+      ret = I2S_IOCTL(i2s, cmd, (unsigned long)&ring);
+      if (ret >= 0)
+        {
+          *desc = ring.ring;
+        }
+
+      return ret;
+    }
+#endif
+
   return I2S_IOCTL(i2s, cmd, arg);
 }
 
@@ -413,6 +442,23 @@ static void audio_i2s_callback(struct i2s_dev_s *dev,
     }
 }
 
+#ifdef CONFIG_AUDIO_RING_MAPPING
+static void audio_i2s_period(struct i2s_dev_s *dev,
+                             FAR struct ap_buffer_s *apb,
+                             FAR void *arg, int result)
+{
+  FAR struct audio_i2s_s *audio_i2s = arg;
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  audio_i2s->dev.upper(audio_i2s->dev.priv, AUDIO_CALLBACK_PERIOD, NULL,
+                       result, NULL);
+#else
+  audio_i2s->dev.upper(audio_i2s->dev.priv, AUDIO_CALLBACK_PERIOD, NULL,
+                       result);
+#endif
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
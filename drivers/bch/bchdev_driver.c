@@ -27,6 +27,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 
 #include <unistd.h>
 #include <string.h>
@@ -65,6 +66,10 @@ static int     bch_poll(FAR struct file *filep, FAR struct pollfd *fds,
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
 static int     bch_unlink(FAR struct inode *inode);
 #endif
+static ssize_t bch_readv(FAR struct file *filep,
+                 FAR const struct iovec *iov, int iovcnt);
+static ssize_t bch_writev(FAR struct file *filep,
+                 FAR const struct iovec *iov, int iovcnt);
 
 /****************************************************************************
  * Public Data
@@ -84,6 +89,8 @@ const struct file_operations g_bch_fops =
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   , bch_unlink /* unlink */
 #endif
+  , bch_readv  /* readv */
+  , bch_writev /* writev */
 };
 
 /****************************************************************************
@@ -347,6 +354,106 @@ static ssize_t bch_write(FAR struct file *filep, FAR const char *buffer,
   return ret;
 }
 
+/****************************************************************************
+ * Name: bch_readv
+ *
+ * Description:
+ *   Read all the buffers under one hold of the lock, so that the transfer
+ *   is not interleaved with other accesses and contiguous segments share
+ *   the sector held in the BCH buffer.
+ *
+ ****************************************************************************/
+
+static ssize_t bch_readv(FAR struct file *filep,
+                         FAR const struct iovec *iov, int iovcnt)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct bchlib_s *bch;
+  ssize_t ntotal = 0;
+  ssize_t ret;
+  int i;
+
+  DEBUGASSERT(inode->i_private);
+  bch = inode->i_private;
+
+  ret = nxmutex_lock(&bch->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      ret = bchlib_read(bch, iov[i].iov_base, filep->f_pos, iov[i].iov_len);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      filep->f_pos += ret;
+      ntotal       += ret;
+
+      /* Stop at the end of the device */
+
+      if ((size_t)ret < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  nxmutex_unlock(&bch->lock);
+  return ntotal > 0 || ret >= 0 ? ntotal : ret;
+}
+
+/****************************************************************************
+ * Name: bch_writev
+ ****************************************************************************/
+
+static ssize_t bch_writev(FAR struct file *filep,
+                          FAR const struct iovec *iov, int iovcnt)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct bchlib_s *bch;
+  ssize_t ntotal = 0;
+  ssize_t ret;
+  int i;
+
+  DEBUGASSERT(inode->i_private);
+  bch = inode->i_private;
+
+  if (bch->readonly)
+    {
+      return -EACCES;
+    }
+
+  ret = nxmutex_lock(&bch->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      ret = bchlib_write(bch, iov[i].iov_base, filep->f_pos,
+                         iov[i].iov_len);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      filep->f_pos += ret;
+      ntotal       += ret;
+
+      if ((size_t)ret < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  nxmutex_unlock(&bch->lock);
+  return ntotal > 0 || ret >= 0 ? ntotal : ret;
+}
+
 /****************************************************************************
  * Name: bch_ioctl
  *
@@ -428,6 +535,48 @@ static int bch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#if defined(CONFIG_FS_BLOCK_ASYNC) && !defined(CONFIG_BCH_ENCRYPTION)
+      /* Start an asynchronous transfer on the contained block driver.  The
+       * sector buffer is written back first so that the transfer sees the
+       * data written through the character device, and it is discarded
+       * before a write so that later reads do not return stale data.
+       */
+
+      case BIOC_SUBMIT:
+        {
+          FAR struct blk_request_s *req =
+            (FAR struct blk_request_s *)((uintptr_t)arg);
+          FAR struct inode *bchinode = bch->inode;
+
+          if (req == NULL || bchinode->u.i_bops->submit == NULL)
+            {
+              break;
+            }
+
+          ret = nxmutex_lock(&bch->lock);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          if (req->write && bch->readonly)
+            {
+              ret = -EACCES;
+            }
+          else
+            {
+              ret = bchlib_flushsector(bch, req->write);
+              if (ret >= 0)
+                {
+                  ret = bchinode->u.i_bops->submit(bchinode, req);
+                }
+            }
+
+          nxmutex_unlock(&bch->lock);
+        }
+        break;
+#endif
+
 #ifdef CONFIG_BCH_ENCRYPTION
       /* This is a request to set the encryption key? */
 
@@ -29,6 +29,7 @@
 #include <nuttx/drivers/rpmsgblk.h>
 #include <nuttx/fs/loop.h>
 #include <nuttx/fs/smart.h>
+#include <nuttx/init.h>
 #include <nuttx/fs/loopmtd.h>
 #include <nuttx/input/uinput.h>
 #include <nuttx/mtd/mtd.h>
@@ -71,51 +72,63 @@ void drivers_initialize(void)
   /* Register devices */
 
   syslog_initialize();
+  BOOTTRACE_STAGE("syslog_initialize");
 
 #ifdef CONFIG_SERIAL_RTT
   serial_rtt_initialize();
+  BOOTTRACE_STAGE("serial_rtt_initialize");
 #endif
 
 #if defined(CONFIG_DEV_NULL)
   devnull_register();   /* Standard /dev/null */
+  BOOTTRACE_STAGE("devnull_register");
 #endif
 
 #if defined(CONFIG_DEV_RANDOM)
   devrandom_register(); /* Standard /dev/random */
+  BOOTTRACE_STAGE("devrandom_register");
 #endif
 
 #if defined(CONFIG_DEV_URANDOM)
   devurandom_register();   /* Standard /dev/urandom */
+  BOOTTRACE_STAGE("devurandom_register");
 #endif
 
 #if defined(CONFIG_DEV_ZERO)
   devzero_register();   /* Standard /dev/zero */
+  BOOTTRACE_STAGE("devzero_register");
 #endif
 
 #if defined(CONFIG_DEV_LOOP)
   loop_register();      /* Standard /dev/loop */
+  BOOTTRACE_STAGE("loop_register");
 #endif
 
 #if defined(CONFIG_DEV_ASCII)
   devascii_register();  /* Non-standard /dev/ascii */
+  BOOTTRACE_STAGE("devascii_register");
 #endif
 
 #if defined(CONFIG_DRIVERS_NOTE)
   note_initialize();    /* Non-standard /dev/note */
+  BOOTTRACE_STAGE("note_initialize");
 #endif
 
 #if defined(CONFIG_CLK_RPMSG)
   clk_rpmsg_server_initialize();
+  BOOTTRACE_STAGE("clk_rpmsg_server_initialize");
 #endif
 
 #if defined(CONFIG_REGULATOR_RPMSG)
   regulator_rpmsg_server_init();
+  BOOTTRACE_STAGE("regulator_rpmsg_server_init");
 #endif
 
   /* Initialize the serial device driver */
 
 #ifdef CONFIG_RPMSG_UART
   rpmsg_serialinit();
+  BOOTTRACE_STAGE("rpmsg_serialinit");
 #endif
 
   /* Initialize the console device driver (if it is other than the standard
@@ -124,92 +137,112 @@ void drivers_initialize(void)
 
 #if defined(CONFIG_LWL_CONSOLE)
   lwlconsole_init();
+  BOOTTRACE_STAGE("lwlconsole_init");
 #elif defined(CONFIG_CONSOLE_SYSLOG)
   syslog_console_init();
+  BOOTTRACE_STAGE("syslog_console_init");
 #endif
 
 #ifdef CONFIG_PSEUDOTERM_SUSV1
   /* Register the master pseudo-terminal multiplexor device */
 
   ptmx_register();
+  BOOTTRACE_STAGE("ptmx_register");
 #endif
 
 #if defined(CONFIG_CRYPTO)
   /* Initialize the HW crypto and /dev/crypto */
 
   up_cryptoinitialize();
+  BOOTTRACE_STAGE("up_cryptoinitialize");
 #endif
 
 #ifdef CONFIG_CRYPTO_CRYPTODEV
   devcrypto_register();
+  BOOTTRACE_STAGE("devcrypto_register");
 #endif
 
 #ifdef CONFIG_UINPUT_TOUCH
   uinput_touch_initialize();
+  BOOTTRACE_STAGE("uinput_touch_initialize");
 #endif
 
 #ifdef CONFIG_UINPUT_BUTTONS
   uinput_button_initialize();
+  BOOTTRACE_STAGE("uinput_button_initialize");
 #endif
 
 #ifdef CONFIG_UINPUT_KEYBOARD
   uinput_keyboard_initialize();
+  BOOTTRACE_STAGE("uinput_keyboard_initialize");
 #endif
 
 #ifdef CONFIG_NET_LOOPBACK
   /* Initialize the local loopback device */
 
   localhost_initialize();
+  BOOTTRACE_STAGE("localhost_initialize");
 #endif
 
 #ifdef CONFIG_NET_TUN
   /* Initialize the TUN device */
 
   tun_initialize();
+  BOOTTRACE_STAGE("tun_initialize");
 #endif
 
 #ifdef CONFIG_NETDEV_TELNET
   /* Initialize the Telnet session factory */
 
   telnet_initialize();
+  BOOTTRACE_STAGE("telnet_initialize");
 #endif
 
 #ifdef CONFIG_USENSOR
   usensor_initialize();
+  BOOTTRACE_STAGE("usensor_initialize");
 #endif
 
 #ifdef CONFIG_SENSORS_RPMSG
   sensor_rpmsg_initialize();
+  BOOTTRACE_STAGE("sensor_rpmsg_initialize");
 #endif
 
 #ifdef CONFIG_DEV_RPMSG_SERVER
   rpmsgdev_server_init();
+  BOOTTRACE_STAGE("rpmsgdev_server_init");
 #endif
 
 #ifdef CONFIG_BLK_RPMSG_SERVER
   rpmsgblk_server_init();
+  BOOTTRACE_STAGE("rpmsgblk_server_init");
 #endif
 
 #ifdef CONFIG_RPMSGMTD_SERVER
   rpmsgmtd_server_init();
+  BOOTTRACE_STAGE("rpmsgmtd_server_init");
 #endif
 
 #ifdef CONFIG_NET_USRSOCK_RPMSG_SERVER
   /* Initialize the user socket rpmsg server */
 
   usrsock_rpmsg_server_initialize();
+  BOOTTRACE_STAGE("usrsock_rpmsg_server_initialize");
 #endif
 
 #ifdef CONFIG_SMART_DEV_LOOP
   smart_loop_register_driver();
+  BOOTTRACE_STAGE("smart_loop_register_driver");
 #endif
 
 #ifdef CONFIG_MTD_LOOP
   mtd_loop_register();
+  BOOTTRACE_STAGE("mtd_loop_register");
 #endif
 
 #ifdef CONFIG_DRIVERS_VIRTIO
   virtio_register_drivers();
+  BOOTTRACE_STAGE("virtio_register_drivers");
 #endif
 
   drivers_trace_end();
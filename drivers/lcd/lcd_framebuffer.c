@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <stdint.h>
 #include <string.h>
 #include <assert.h>
@@ -32,6 +33,9 @@
 
 #include <nuttx/board.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/lcd/lcd.h>
 #include <nuttx/video/fb.h>
 
@@ -49,6 +53,18 @@
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_LCD_FRAMEBUFFER_DIRTY
+/* A dirty rectangle of the framebuffer, corners inclusive */
+
+struct lcdfb_rect_s
+{
+  fb_coord_t x0;
+  fb_coord_t y0;
+  fb_coord_t x1;
+  fb_coord_t y1;
+};
+#endif
+
 /* This structure describes the LCD framebuffer */
 
 struct lcdfb_dev_s
@@ -63,6 +79,14 @@ struct lcdfb_dev_s
   fb_coord_t yres;                  /* Vertical resolution in pixel rows */
   fb_coord_t stride;                /* Width of a row in bytes */
   uint8_t display;                  /* Display number */
+
+#ifdef CONFIG_LCD_FRAMEBUFFER_DIRTY
+  struct work_s work;               /* Flushes the dirty rectangles */
+  mutex_t flush;                    /* Held while the LCD is written */
+  spinlock_t lock;                  /* Protects the dirty rectangles */
+  uint8_t ndirty;                   /* Number of dirty rectangles */
+  struct lcdfb_rect_s dirty[CONFIG_LCD_FRAMEBUFFER_NDIRTY];
+#endif
 };
 
 /****************************************************************************
@@ -151,11 +175,192 @@ static FAR struct lcdfb_dev_s *lcdfb_find(int display)
   return NULL;
 }
 
+/****************************************************************************
+ * Name: lcdfb_putrect
+ *
+ * Description:
+ *   Write a rectangle of the framebuffer to the LCD.
+ *
+ ****************************************************************************/
+
+static int lcdfb_putrect(FAR struct lcdfb_dev_s *priv, fb_coord_t startx,
+                         fb_coord_t starty, fb_coord_t endx,
+                         fb_coord_t endy)
+{
+  FAR struct lcd_planeinfo_s *pinfo = &priv->pinfo;
+  FAR uint8_t *run;
+  fb_coord_t row;
+  fb_coord_t width;
+  int ret;
+
+  /* Get the starting position in the framebuffer */
+
+  run  = priv->fbmem + starty * priv->stride;
+  run += (startx * pinfo->bpp + 7) >> 3;
+
+  if (pinfo->putarea != NULL)
+    {
+      /* Each Driver's callback function putarea may be optimized by checking
+       * if it is a full screen/full row mode or not.
+       * In case of full screen/row mode the memory layout of drivers memory
+       * and data provided to putarea function may be (or not, it depends of
+       * display and driver implementation) identical.
+       * Identical memory layout let us to use:
+       * - memcopy (if there is shadow buffer in driver implementation)
+       * - apply DMA channel to transfer data to driver memory.
+       */
+
+      ret = pinfo->putarea(pinfo->dev, starty, endy, startx, endx,
+                           run, priv->stride);
+      if (ret < 0)
+        {
+          lcderr("Failed to update area");
+          return ret;
+        }
+    }
+  else
+    {
+      width = endx - startx + 1;
+
+      for (row = starty; row <= endy; row++)
+        {
+          ret = pinfo->putrun(pinfo->dev, row, startx, run, width);
+          if (ret < 0)
+            {
+              lcderr("Failed to update row");
+              return ret;
+            }
+
+          run += priv->stride;
+        }
+    }
+
+  return OK;
+}
+
+#ifdef CONFIG_LCD_FRAMEBUFFER_DIRTY
+
+/****************************************************************************
+ * Name: lcdfb_rectarea
+ ****************************************************************************/
+
+static uint32_t lcdfb_rectarea(FAR const struct lcdfb_rect_s *rect)
+{
+  return (uint32_t)(rect->x1 - rect->x0 + 1) * (rect->y1 - rect->y0 + 1);
+}
+
+/****************************************************************************
+ * Name: lcdfb_rectunion
+ ****************************************************************************/
+
+static void lcdfb_rectunion(FAR struct lcdfb_rect_s *dest,
+                            FAR const struct lcdfb_rect_s *rect1,
+                            FAR const struct lcdfb_rect_s *rect2)
+{
+  dest->x0 = MIN(rect1->x0, rect2->x0);
+  dest->y0 = MIN(rect1->y0, rect2->y0);
+  dest->x1 = MAX(rect1->x1, rect2->x1);
+  dest->y1 = MAX(rect1->y1, rect2->y1);
+}
+
+/****************************************************************************
+ * Name: lcdfb_adddirty
+ *
+ * Description:
+ *   Add a rectangle to the dirty rectangles.  It is merged with a dirty
+ *   rectangle when their bounding box has no more pixels than both of them
+ *   together, which includes any rectangle that contains or overlaps it
+ *   largely.  When no rectangle is free, it is merged with the one that
+ *   grows least.
+ *
+ ****************************************************************************/
+
+static void lcdfb_adddirty(FAR struct lcdfb_dev_s *priv,
+                           FAR const struct lcdfb_rect_s *rect)
+{
+  struct lcdfb_rect_s merged;
+  uint32_t growth;
+  uint32_t best = UINT32_MAX;
+  uint32_t area = lcdfb_rectarea(rect);
+  int ndx = -1;
+  int i;
+
+  for (i = 0; i < priv->ndirty; i++)
+    {
+      lcdfb_rectunion(&merged, &priv->dirty[i], rect);
+      growth = lcdfb_rectarea(&merged) - lcdfb_rectarea(&priv->dirty[i]);
+      if (growth <= area)
+        {
+          priv->dirty[i] = merged;
+          return;
+        }
+
+      if (growth < best)
+        {
+          best = growth;
+          ndx  = i;
+        }
+    }
+
+  if (priv->ndirty < CONFIG_LCD_FRAMEBUFFER_NDIRTY)
+    {
+      priv->dirty[priv->ndirty++] = *rect;
+    }
+  else
+    {
+      lcdfb_rectunion(&priv->dirty[ndx], &priv->dirty[ndx], rect);
+    }
+}
+
+/****************************************************************************
+ * Name: lcdfb_flushworker
+ *
+ * Description:
+ *   Write the dirty rectangles to the LCD.  Areas that are updated while
+ *   the LCD is written collect in the list again and queue a new flush.
+ *
+ ****************************************************************************/
+
+static void lcdfb_flushworker(FAR void *arg)
+{
+  FAR struct lcdfb_dev_s *priv = arg;
+  FAR struct lcd_planeinfo_s *pinfo = &priv->pinfo;
+  struct lcdfb_rect_s dirty[CONFIG_LCD_FRAMEBUFFER_NDIRTY];
+  irqstate_t flags;
+  int ndirty;
+  int i;
+
+  nxmutex_lock(&priv->flush);
+
+  flags  = spin_lock_irqsave(&priv->lock);
+  ndirty = priv->ndirty;
+  memcpy(dirty, priv->dirty, ndirty * sizeof(struct lcdfb_rect_s));
+  priv->ndirty = 0;
+  spin_unlock_irqrestore(&priv->lock, flags);
+
+  for (i = 0; i < ndirty; i++)
+    {
+      lcdfb_putrect(priv, dirty[i].x0, dirty[i].y0,
+                    dirty[i].x1, dirty[i].y1);
+    }
+
+  if (ndirty > 0 && pinfo->redraw != NULL)
+    {
+      pinfo->redraw(pinfo->dev);
+    }
+
+  nxmutex_unlock(&priv->flush);
+}
+#endif
+
 /****************************************************************************
  * Name: lcdfb_updateearea
  *
  * Description:
- * Update the LCD when there is a change to the framebuffer.
+ * Update the LCD when there is a change to the framebuffer.  With
+ * CONFIG_LCD_FRAMEBUFFER_DIRTY the area is only recorded as dirty and
+ * written to the LCD by the low priority work queue, so that consecutive
+ * updates of close areas are sent once.
  *
  ****************************************************************************/
 
@@ -164,14 +369,16 @@ static int lcdfb_updateearea(FAR struct fb_vtable_s *vtable,
 {
   FAR struct lcdfb_dev_s *priv = (FAR struct lcdfb_dev_s *)vtable;
   FAR struct lcd_planeinfo_s *pinfo = &priv->pinfo;
-  FAR uint8_t *run = priv->fbmem;
-  fb_coord_t row;
   fb_coord_t startx = 0;
   fb_coord_t endx = priv->xres - 1;
-  fb_coord_t width = priv->xres;
   fb_coord_t starty = 0;
   fb_coord_t endy = priv->yres - 1;
+#ifdef CONFIG_LCD_FRAMEBUFFER_DIRTY
+  struct lcdfb_rect_s rect;
+  irqstate_t flags;
+#else
   int ret;
+#endif
 
   if (area != NULL)
     {
@@ -211,54 +418,39 @@ static int lcdfb_updateearea(FAR struct fb_vtable_s *vtable,
           unsigned int pixperbyte = 8 / pinfo->bpp;
           startx &= ~(pixperbyte - 1);
         }
-
-      /* Get the starting position in the framebuffer */
-
-      run  = priv->fbmem + starty * priv->stride;
-      run += (startx * pinfo->bpp + 7) >> 3;
     }
 
-  if (pinfo->putarea != NULL)
+#ifdef CONFIG_LCD_FRAMEBUFFER_DIRTY
+  if (endx < startx || endy < starty)
     {
-      /* Each Driver's callback function putarea may be optimized by checking
-       * if it is a full screen/full row mode or not.
-       * In case of full screen/row mode the memory layout of drivers memory
-       * and data provided to putarea function may be (or not, it depends of
-       * display and driver implementation) identical.
-       * Identical memory layout let us to use:
-       * - memcopy (if there is shadow buffer in driver implementation)
-       * - apply DMA channel to transfer data to driver memory.
-       */
-
-      ret = pinfo->putarea(pinfo->dev, starty, endy, startx, endx,
-                           run, priv->stride);
-      if (ret < 0)
-        {
-          lcderr("Failed to update area");
-          return ret;
-        }
+      return OK;
     }
-  else
-    {
-      width = endx - startx + 1;
 
-      for (row = starty; row <= endy; row++)
-        {
-          ret = pinfo->putrun(pinfo->dev, row, startx, run, width);
-          if (ret < 0)
-            {
-              lcderr("Failed to update row");
-              return ret;
-            }
+  rect.x0 = startx;
+  rect.y0 = starty;
+  rect.x1 = endx;
+  rect.y1 = endy;
 
-          run += priv->stride;
-        }
+  flags = spin_lock_irqsave(&priv->lock);
+  lcdfb_adddirty(priv, &rect);
+  spin_unlock_irqrestore(&priv->lock, flags);
+
+  if (work_available(&priv->work))
+    {
+      work_queue(LPWORK, &priv->work, lcdfb_flushworker, priv, 0);
+    }
+#else
+  ret = lcdfb_putrect(priv, startx, starty, endx, endy);
+  if (ret < 0)
+    {
+      return ret;
     }
 
   if (pinfo->redraw != NULL)
     {
       pinfo->redraw(pinfo->dev);
     }
+#endif
 
   return OK;
 }
@@ -582,6 +774,10 @@ int up_fbinitialize(int display)
   priv->vtable.setpower     = lcdfb_setpower,
   priv->vtable.ioctl        = lcdfb_ioctl,
 
+#ifdef CONFIG_LCD_FRAMEBUFFER_DIRTY
+  nxmutex_init(&priv->flush);
+#endif
+
 #ifdef CONFIG_LCD_EXTERNINIT
   /* Use external graphics driver initialization */
 
@@ -678,6 +874,9 @@ errout_with_lcd:
 #endif
 
 errout_with_state:
+#ifdef CONFIG_LCD_FRAMEBUFFER_DIRTY
+  nxmutex_destroy(&priv->flush);
+#endif
   kmm_free(priv);
   return ret;
 }
@@ -767,6 +966,15 @@ void up_fbuninitialize(int display)
           board_lcd_uninitialize();
 #endif
 
+#ifdef CONFIG_LCD_FRAMEBUFFER_DIRTY
+          /* Drop the pending flush and wait for one in progress */
+
+          work_cancel(LPWORK, &priv->work);
+          nxmutex_lock(&priv->flush);
+          nxmutex_unlock(&priv->flush);
+          nxmutex_destroy(&priv->flush);
+#endif
+
           /* Free the frame buffer allocation */
 
           kmm_free(priv->fbmem);
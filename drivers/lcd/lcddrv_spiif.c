@@ -26,6 +26,7 @@
 
 #include <sys/types.h>
 #include <stdbool.h>
+#include <string.h>
 #include <errno.h>
 #include <debug.h>
 #include <sys/stat.h>
@@ -34,9 +35,19 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/spi/spi.h>
 #include <nuttx/lcd/lcddrv_spiif.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_LCD_LCDDRV_SPIIF_ASYNC
+#  define LCDDRV_SPIIF_NWORDS (CONFIG_LCD_LCDDRV_SPIIF_BUFSIZE / 2)
+#endif
+
 /****************************************************************************
  * Private Type Definition
  ****************************************************************************/
@@ -50,8 +61,92 @@ struct lcddrv_spiif_lcd_s
   /* Reference to spi device structure */
 
   struct spi_dev_s *spi;
+
+#ifdef CONFIG_LCD_LCDDRV_SPIIF_ASYNC
+  /* Pixel words are collected in one line buffer while the other one is
+   * sent by the worker.  'idle' is posted when no transfer is in flight.
+   */
+
+  struct work_s work;
+  sem_t idle;
+  uint8_t fill;                       /* Line buffer being filled */
+  uint8_t send;                       /* Line buffer being sent */
+  uint16_t nwords[2];
+  uint16_t buf[2][LCDDRV_SPIIF_NWORDS];
+#endif
 };
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_LCD_LCDDRV_SPIIF_ASYNC
+
+/****************************************************************************
+ * Name: lcddrv_spiif_worker
+ *
+ * Description:
+ *   Send a full line buffer.  SPI_SNDBLOCK is served by DMA where the SPI
+ *   driver supports it.
+ *
+ ****************************************************************************/
+
+static void lcddrv_spiif_worker(FAR void *arg)
+{
+  FAR struct lcddrv_spiif_lcd_s *priv = arg;
+
+  SPI_SETBITS(priv->spi, 16);
+  SPI_SNDBLOCK(priv->spi, priv->buf[priv->send],
+               priv->nwords[priv->send]);
+  SPI_SETBITS(priv->spi, 8);
+
+  nxsem_post(&priv->idle);
+}
+
+/****************************************************************************
+ * Name: lcddrv_spiif_submit
+ *
+ * Description:
+ *   Hand the line buffer being filled to the worker and continue with the
+ *   other one, once its transfer has completed.
+ *
+ ****************************************************************************/
+
+static void lcddrv_spiif_submit(FAR struct lcddrv_spiif_lcd_s *priv)
+{
+  nxsem_wait_uninterruptible(&priv->idle);
+
+  priv->send = priv->fill;
+  work_queue(LPWORK, &priv->work, lcddrv_spiif_worker, priv, 0);
+
+  priv->fill ^= 1;
+  priv->nwords[priv->fill] = 0;
+}
+
+/****************************************************************************
+ * Name: lcddrv_spiif_drain
+ *
+ * Description:
+ *   Send the pixel words that are still buffered and wait until the bus is
+ *   idle.  Must precede any other transfer on the bus.
+ *
+ ****************************************************************************/
+
+static void lcddrv_spiif_drain(FAR struct lcddrv_spiif_lcd_s *priv)
+{
+  if (priv->nwords[priv->fill] > 0)
+    {
+      lcddrv_spiif_submit(priv);
+    }
+
+  nxsem_wait_uninterruptible(&priv->idle);
+  nxsem_post(&priv->idle);
+}
+
+#else
+#  define lcddrv_spiif_drain(priv)
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -115,6 +210,7 @@ static void lcddrv_spiif_deselect(FAR struct lcddrv_lcd_s *lcd)
 {
   FAR struct lcddrv_spiif_lcd_s *priv = (FAR struct lcddrv_spiif_lcd_s *)lcd;
 
+  lcddrv_spiif_drain(priv);
   SPI_CMDDATA(priv->spi, SPIDEV_DISPLAY(0), false);
   SPI_SELECT(priv->spi, SPIDEV_DISPLAY(0), false);
   SPI_LOCK(priv->spi, false);
@@ -124,7 +220,10 @@ static void lcddrv_spiif_deselect(FAR struct lcddrv_lcd_s *lcd)
  * Name: lcddrv_spiif_sendmulti
  *
  * Description:
- *   Send a number of pixel words to the lcd driver gram.
+ *   Send a number of pixel words to the lcd driver gram.  With
+ *   CONFIG_LCD_LCDDRV_SPIIF_ASYNC the words are only copied to a line
+ *   buffer, which is sent in the background once it is full or before the
+ *   next command.
  *
  * Input Parameters:
  *   lcd    - Reference to the lcddrv_lcd_s driver structure
@@ -139,16 +238,34 @@ static void lcddrv_spiif_deselect(FAR struct lcddrv_lcd_s *lcd)
 static int lcddrv_spiif_sendmulti(FAR struct lcddrv_lcd_s *lcd,
                                   FAR const uint16_t *wd, uint32_t nwords)
 {
-  uint32_t t;
   FAR struct lcddrv_spiif_lcd_s *priv = (FAR struct lcddrv_spiif_lcd_s *)lcd;
+#ifdef CONFIG_LCD_LCDDRV_SPIIF_ASYNC
+  uint32_t n;
 
-  SPI_SETBITS(priv->spi, 16);
-  for (t = 0; t < nwords; t++)
+  while (nwords > 0)
     {
-      SPI_SEND(priv->spi, *wd++);
+      n = LCDDRV_SPIIF_NWORDS - priv->nwords[priv->fill];
+      if (n > nwords)
+        {
+          n = nwords;
+        }
+
+      memcpy(&priv->buf[priv->fill][priv->nwords[priv->fill]], wd,
+             n * sizeof(uint16_t));
+      priv->nwords[priv->fill] += n;
+      wd     += n;
+      nwords -= n;
+
+      if (priv->nwords[priv->fill] == LCDDRV_SPIIF_NWORDS)
+        {
+          lcddrv_spiif_submit(priv);
+        }
     }
-
+#else
+  SPI_SETBITS(priv->spi, 16);
+  SPI_SNDBLOCK(priv->spi, wd, nwords);
   SPI_SETBITS(priv->spi, 8);
+#endif
 
   return OK;
 };
@@ -174,6 +291,7 @@ static int lcddrv_spiif_recv(FAR struct lcddrv_lcd_s *lcd,
   FAR struct lcddrv_spiif_lcd_s *priv = (FAR struct lcddrv_spiif_lcd_s *)lcd;
 
   lcdinfo("param=%04x\n", param);
+  lcddrv_spiif_drain(priv);
   SPI_RECVBLOCK(priv->spi, param, 1);
   return OK;
 }
@@ -199,6 +317,7 @@ static int lcddrv_spiif_send(FAR struct lcddrv_lcd_s *lcd,
   uint8_t r;
   FAR struct lcddrv_spiif_lcd_s *priv = (FAR struct lcddrv_spiif_lcd_s *)lcd;
 
+  lcddrv_spiif_drain(priv);
   r = SPI_SEND(priv->spi, param);
   return r;
 }
@@ -225,6 +344,7 @@ static int lcddrv_spiif_sendcmd(FAR struct lcddrv_lcd_s *lcd,
   FAR struct lcddrv_spiif_lcd_s *priv = (FAR struct lcddrv_spiif_lcd_s *)lcd;
 
   lcdinfo("param=%04x\n", param);
+  lcddrv_spiif_drain(priv);
   SPI_CMDDATA(priv->spi, SPIDEV_DISPLAY(0), true);
   r = SPI_SEND(priv->spi, param);
   SPI_CMDDATA(priv->spi, SPIDEV_DISPLAY(0), false);
@@ -253,6 +373,7 @@ static int lcddrv_spiif_recvmulti(FAR struct lcddrv_lcd_s *lcd,
   FAR struct lcddrv_spiif_lcd_s *priv = (FAR struct lcddrv_spiif_lcd_s *)lcd;
 
   lcdinfo("wd=%p, nwords=%d\n", wd, nwords);
+  lcddrv_spiif_drain(priv);
   SPI_SETBITS(priv->spi, 16);
   SPI_RECVBLOCK(priv->spi, wd, nwords);
   SPI_SETBITS(priv->spi, 8);
@@ -298,6 +419,10 @@ FAR struct lcddrv_lcd_s *lcddrv_spiif_initialize(FAR struct spi_dev_s *spi)
   SPI_SETFREQUENCY(spi, CONFIG_LCD_LCDDRV_SPEED);
   SPI_SETBITS(spi, 8);
 
+#ifdef CONFIG_LCD_LCDDRV_SPIIF_ASYNC
+  nxsem_init(&priv->idle, 0, 1);
+#endif
+
   /* Hook in our driver routines */
 
   priv->dev.select      = lcddrv_spiif_select;
@@ -82,6 +82,7 @@
  */
 
 #define MMCSD_SCR_DATADELAY     (100)      /* Wait up to 100MS to get SCR */
+#define MMCSD_SWITCH_DATADELAY  (100)      /* Wait up to 100MS to get switch status */
 #define MMCSD_BLOCK_RDATADELAY  (100)      /* Wait up to 100MS to get one data block */
 
 /* Wait timeout to write one data block */
@@ -119,6 +120,11 @@ struct mmcsd_state_s
   uint8_t wrprotect:1;             /* true: Card is write protected (from CSD) */
   uint8_t locked:1;                /* true: Media is locked (from R1) */
   uint8_t dsrimp:1;                /* true: card supports CMD4/DSR setting (from CSD) */
+  uint8_t switchfn:1;              /* true: card supports CMD6/SWITCH_FUNC (from SCR) */
+  uint8_t highspeed:1;             /* true: SD high speed clocking selected */
+#ifdef CONFIG_MMCSD_SDIO_CMD23
+  uint8_t cmd23:1;                 /* true: card supports CMD23/SET_BLOCK_COUNT (from SCR) */
+#endif
 #ifdef CONFIG_SDIO_DMA
   uint8_t dma:1;                   /* true: hardware supports DMA */
 #endif
@@ -135,6 +141,10 @@ struct mmcsd_state_s
   uint8_t  blockshift;             /* Log2 of blocksize */
   uint16_t blocksize;              /* Read block length (== block size) */
   uint32_t nblocks;                /* Number of blocks */
+
+#ifdef CONFIG_FS_BLOCK_ASYNC
+  struct blk_queue_s queue;        /* Asynchronous transfer requests */
+#endif
 };
 
 /****************************************************************************
@@ -179,6 +189,10 @@ static int     mmcsd_eventwait(FAR struct mmcsd_state_s *priv,
 static int     mmcsd_transferready(FAR struct mmcsd_state_s *priv);
 #if MMCSD_MULTIBLOCK_LIMIT != 1
 static int     mmcsd_stoptransmission(FAR struct mmcsd_state_s *priv);
+#ifdef CONFIG_MMCSD_SDIO_CMD23
+static int     mmcsd_setblockcount(FAR struct mmcsd_state_s *priv,
+                                   size_t nblocks);
+#endif
 #endif
 static int     mmcsd_setblocklen(FAR struct mmcsd_state_s *priv,
                                  uint32_t blocklen);
@@ -213,11 +227,18 @@ static int     mmcsd_geometry(FAR struct inode *inode,
                               FAR struct geometry *geometry);
 static int     mmcsd_ioctl(FAR struct inode *inode, int cmd,
                            unsigned long arg);
+#ifdef CONFIG_FS_BLOCK_ASYNC
+static int     mmcsd_submit(FAR struct inode *inode,
+                            FAR struct blk_request_s *req);
+#endif
 
 /* Initialization/uninitialization/reset ************************************/
 
 static void    mmcsd_mediachange(FAR void *arg);
 static int     mmcsd_widebus(FAR struct mmcsd_state_s *priv);
+static int     mmcsd_switchfunc(FAR struct mmcsd_state_s *priv,
+                                uint32_t arg, FAR uint8_t *status);
+static int     mmcsd_sdhighspeed(FAR struct mmcsd_state_s *priv);
 #ifdef CONFIG_MMCSD_MMCSUPPORT
 static int     mmcsd_mmcinitialize(FAR struct mmcsd_state_s *priv);
 static int     mmcsd_read_csd(FAR struct mmcsd_state_s *priv);
@@ -247,6 +268,12 @@ static const struct block_operations g_bops =
   mmcsd_write,    /* write    */
   mmcsd_geometry, /* geometry */
   mmcsd_ioctl     /* ioctl    */
+#ifdef CONFIG_FS_BLOCK_ASYNC
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL          /* unlink   */
+#endif
+  , mmcsd_submit  /* submit   */
+#endif
 };
 
 /****************************************************************************
@@ -969,8 +996,8 @@ static void mmcsd_decode_cid(FAR struct mmcsd_state_s *priv, uint32_t cid[4])
  * Name: mmcsd_decode_scr
  *
  * Description:
- *   Show the contents of the SD Configuration Register (SCR).  The only
- *   value retained is:  priv->buswidth;
+ *   Show the contents of the SD Configuration Register (SCR).  The values
+ *   retained are:  priv->buswidth, priv->switchfn and priv->cmd23;
  *
  ****************************************************************************/
 
@@ -986,13 +1013,22 @@ static void mmcsd_decode_scr(FAR struct mmcsd_state_s *priv, uint32_t scr[2])
    *   DATA_STATE_AFTER_ERASE 55:55 1-bit erase status
    *   SD_SECURITY            54:52 3-bit SD security support level
    *   SD_BUS_WIDTHS          51:48 4-bit bus width indicator
-   *   Reserved               47:32 16-bit SD reserved space
+   *   Reserved               47:34 14-bit SD reserved space
+   *   CMD_SUPPORT            33:32 2-bit command support bits
    */
 
 #ifdef CONFIG_ENDIAN_BIG  /* Card transfers SCR in big-endian order */
   priv->buswidth     = (scr[0] >> 16) & 15;
+  priv->switchfn     = ((scr[0] >> 24) & 15) >= MMCSD_SCR_SDSPEC_1_10;
+#ifdef CONFIG_MMCSD_SDIO_CMD23
+  priv->cmd23        = (scr[0] & MMCSD_SCR_CMDSUPPORT_CMD23) != 0;
+#endif
 #else
   priv->buswidth     = (scr[0] >> 8) & 15;
+  priv->switchfn     = (scr[0] & 15) >= MMCSD_SCR_SDSPEC_1_10;
+#ifdef CONFIG_MMCSD_SDIO_CMD23
+  priv->cmd23        = ((scr[0] >> 24) & MMCSD_SCR_CMDSUPPORT_CMD23) != 0;
+#endif
 #endif
 
 #ifdef CONFIG_DEBUG_FS_INFO
@@ -1323,6 +1359,35 @@ static int mmcsd_stoptransmission(FAR struct mmcsd_state_s *priv)
 
   return ret;
 }
+
+/****************************************************************************
+ * Name: mmcsd_setblockcount
+ *
+ * Description:
+ *   Send SET_BLOCK_COUNT so that the following multiple block transfer is
+ *   closed-ended and needs no STOP_TRANSMISSION.  It must immediately
+ *   precede the CMD18 or CMD25.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MMCSD_SDIO_CMD23
+static int mmcsd_setblockcount(FAR struct mmcsd_state_s *priv,
+                               size_t nblocks)
+{
+  int ret;
+
+  /* Send CMD23, SET_BLOCK_COUNT, and verify good R1 return status */
+
+  mmcsd_sendcmdpoll(priv, MMCSD_CMD23, nblocks);
+  ret = mmcsd_recv_r1(priv, MMCSD_CMD23);
+  if (ret != OK)
+    {
+      ferr("ERROR: mmcsd_recv_r1 for CMD23 failed: %d\n", ret);
+    }
+
+  return ret;
+}
+#endif
 #endif
 
 /****************************************************************************
@@ -1601,6 +1666,20 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_state_s *priv,
       SDIO_RECVSETUP(priv->dev, buffer, nbytes);
     }
 
+#ifdef CONFIG_MMCSD_SDIO_CMD23
+  /* Tell the card how many blocks follow if it supports CMD23 */
+
+  if (priv->cmd23)
+    {
+      ret = mmcsd_setblockcount(priv, nblocks);
+      if (ret != OK)
+        {
+          SDIO_CANCEL(priv->dev);
+          return ret;
+        }
+    }
+#endif
+
   /* Send CMD18, READ_MULT_BLOCK: Read a block of the size selected by
    * the mmcsd_setblocklen() and verify that good R1 status is returned
    */
@@ -1623,13 +1702,17 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_state_s *priv,
       return ret;
     }
 
-  /* Send STOP_TRANSMISSION */
-
-  ret = mmcsd_stoptransmission(priv);
+  /* Send STOP_TRANSMISSION, unless the transfer was closed-ended */
 
-  if (ret != OK)
+#ifdef CONFIG_MMCSD_SDIO_CMD23
+  if (!priv->cmd23)
+#endif
     {
-      ferr("ERROR: mmcsd_stoptransmission failed: %d\n", ret);
+      ret = mmcsd_stoptransmission(priv);
+      if (ret != OK)
+        {
+          ferr("ERROR: mmcsd_stoptransmission failed: %d\n", ret);
+        }
     }
 
   /* On success, return the number of blocks read */
@@ -1928,6 +2011,19 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
 
   if ((priv->caps & SDIO_CAPS_DMABEFOREWRITE) == 0)
     {
+#ifdef CONFIG_MMCSD_SDIO_CMD23
+      /* Tell the card how many blocks follow if it supports CMD23 */
+
+      if (priv->cmd23)
+        {
+          ret = mmcsd_setblockcount(priv, nblocks);
+          if (ret != OK)
+            {
+              return ret;
+            }
+        }
+#endif
+
       /* Send CMD25, WRITE_MULTIPLE_BLOCK, and verify that good R1 status
        * is returned
        */
@@ -1969,6 +2065,18 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
 
   if ((priv->caps & SDIO_CAPS_DMABEFOREWRITE) != 0)
     {
+#ifdef CONFIG_MMCSD_SDIO_CMD23
+      if (priv->cmd23)
+        {
+          ret = mmcsd_setblockcount(priv, nblocks);
+          if (ret != OK)
+            {
+              SDIO_CANCEL(priv->dev);
+              return ret;
+            }
+        }
+#endif
+
       /* Send CMD25, WRITE_MULTIPLE_BLOCK, and verify that good R1 status
        * is returned
        */
@@ -1997,9 +2105,21 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
        */
     }
 
-  /* Send STOP_TRANSMISSION */
+  /* Send STOP_TRANSMISSION.  A closed-ended transfer only needs it to get
+   * the card out of the Receive-data State after an error.
+   */
+
+#ifdef CONFIG_MMCSD_SDIO_CMD23
+  if (priv->cmd23 && evret == OK)
+    {
+      ret = OK;
+    }
+  else
+#endif
+    {
+      ret = mmcsd_stoptransmission(priv);
+    }
 
-  ret = mmcsd_stoptransmission(priv);
   if (evret != OK)
     {
       return evret;
@@ -2399,6 +2519,34 @@ static int mmcsd_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
   return ret;
 }
 
+/****************************************************************************
+ * Name: mmcsd_submit
+ *
+ * Description:
+ *   Queue an asynchronous transfer.  The requests are run in order by the
+ *   queue thread of the slot, which leaves the caller and the low priority
+ *   work queue free while the card is busy.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLOCK_ASYNC
+static int mmcsd_submit(FAR struct inode *inode,
+                        FAR struct blk_request_s *req)
+{
+  FAR struct mmcsd_state_s *priv;
+
+  DEBUGASSERT(inode->i_private);
+  priv = inode->i_private;
+
+  if (IS_EMPTY(priv))
+    {
+      return -ENODEV;
+    }
+
+  return blk_queue_submit(&priv->queue, inode, req);
+}
+#endif
+
 /****************************************************************************
  * Initialization/uninitialization/reset
  ****************************************************************************/
@@ -2623,6 +2771,137 @@ static int mmcsd_widebus(FAR struct mmcsd_state_s *priv)
   return OK;
 }
 
+/****************************************************************************
+ * Name: mmcsd_switchfunc
+ *
+ * Description:
+ *   Send CMD6 (SWITCH_FUNC) to an SD card and receive the 64-byte switch
+ *   function status.
+ *
+ * Returned Value:
+ *   OK on success; a negated ernno on failure.
+ *
+ ****************************************************************************/
+
+static int mmcsd_switchfunc(FAR struct mmcsd_state_s *priv,
+                            uint32_t arg, FAR uint8_t *status)
+{
+  int ret;
+
+  /* Set Block Size To 64 Bytes */
+
+  ret = mmcsd_setblocklen(priv, MMCSD_SWITCH_STATUS_SIZE);
+  if (ret != OK)
+    {
+      ferr("ERROR: mmcsd_setblocklen failed: %d\n", ret);
+      return ret;
+    }
+
+  /* Setup up to receive data with interrupt mode */
+
+  SDIO_BLOCKSETUP(priv->dev, MMCSD_SWITCH_STATUS_SIZE, 1);
+  SDIO_RECVSETUP(priv->dev, status, MMCSD_SWITCH_STATUS_SIZE);
+
+  SDIO_WAITENABLE(priv->dev,
+                  SDIOWAIT_TRANSFERDONE | SDIOWAIT_TIMEOUT | SDIOWAIT_ERROR,
+                  MMCSD_SWITCH_DATADELAY);
+
+  /* Send CMD6 SWITCH_FUNC to start data receipt */
+
+  mmcsd_sendcmdpoll(priv, SD_CMD6, arg);
+  ret = mmcsd_recv_r1(priv, SD_CMD6);
+  if (ret != OK)
+    {
+      ferr("ERROR: RECVR1 for CMD6 failed: %d\n", ret);
+      SDIO_CANCEL(priv->dev);
+      return ret;
+    }
+
+  /* Wait for data to be transferred */
+
+  ret = mmcsd_eventwait(priv, SDIOWAIT_TIMEOUT | SDIOWAIT_ERROR);
+  if (ret != OK)
+    {
+      ferr("ERROR: mmcsd_eventwait for CMD6 status failed: %d\n", ret);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mmcsd_sdhighspeed
+ *
+ * Description:
+ *  An SD card has been inserted and wide bus operation has been selected.
+ *  Switch the card to high speed (SDR25) mode and raise the SDIO clock if
+ *  both the card and the SDIO driver support it.  The faster UHS-I modes
+ *  (SDR50 and up) need 1.8V signalling and are not negotiated.
+ *
+ * Returned Value:
+ *   OK if the card was switched or stays at the default speed; a negated
+ *   errno if the negotiation failed.
+ *
+ ****************************************************************************/
+
+static int mmcsd_sdhighspeed(FAR struct mmcsd_state_s *priv)
+{
+  uint8_t status[MMCSD_SWITCH_STATUS_SIZE] aligned_data(4);
+  int ret;
+
+  if (!IS_SD(priv->type) || !priv->widebus || !priv->switchfn ||
+      (priv->caps & SDIO_CAPS_HSMODE) == 0)
+    {
+      return OK;
+    }
+
+  /* Ask whether the card supports high speed in access mode group 1 */
+
+  ret = mmcsd_switchfunc(priv, MMCSD_SWITCH_MODE_CHECK |
+                         MMCSD_SWITCH_NOCHANGE | MMCSD_SWITCH_GROUP1_HS,
+                         status);
+  if (ret != OK)
+    {
+      return ret;
+    }
+
+  if ((status[MMCSD_SWITCH_GROUP1_SUPPORT] &
+       (1 << MMCSD_SWITCH_GROUP1_HS)) == 0 ||
+      (status[MMCSD_SWITCH_GROUP1_RESULT] & MMCSD_SWITCH_GROUP1_MASK) !=
+      MMCSD_SWITCH_GROUP1_HS)
+    {
+      finfo("Card does not support high speed mode\n");
+      return OK;
+    }
+
+  /* Then switch to it */
+
+  ret = mmcsd_switchfunc(priv, MMCSD_SWITCH_MODE_SET |
+                         MMCSD_SWITCH_NOCHANGE | MMCSD_SWITCH_GROUP1_HS,
+                         status);
+  if (ret != OK)
+    {
+      return ret;
+    }
+
+  if ((status[MMCSD_SWITCH_GROUP1_RESULT] & MMCSD_SWITCH_GROUP1_MASK) !=
+      MMCSD_SWITCH_GROUP1_HS)
+    {
+      ferr("ERROR: Card refused high speed mode\n");
+      return -EIO;
+    }
+
+  /* The card changes its timing within 8 clocks of the end of the status
+   * block.  Only now may the clock be raised.
+   */
+
+  finfo("High speed mode selected\n");
+  SDIO_CLOCK(priv->dev, CLOCK_SD_TRANSFER_HS);
+  priv->highspeed = true;
+
+  nxsig_usleep(MMCSD_CLK_DELAY);
+  return OK;
+}
+
 /****************************************************************************
  * Name: mmcsd_mmcinitialize
  *
@@ -3434,11 +3713,16 @@ static int mmcsd_sdinitialize(FAR struct mmcsd_state_s *priv)
         }
     }
 
-  /* TODO: If wide-bus selected, then send CMD6 to see if the card supports
-   * high speed mode.  A new SDIO method will be needed to set high speed
-   * mode.
+  /* If wide-bus selected, then send CMD6 to see if the card supports
+   * high speed mode and switch to it.
    */
 
+  ret = mmcsd_sdhighspeed(priv);
+  if (ret != OK)
+    {
+      fwarn("WARNING: Failed to select high speed mode: %d\n", ret);
+    }
+
   return OK;
 }
 
@@ -3982,6 +4266,7 @@ static int mmcsd_removed(FAR struct mmcsd_state_s *priv)
   priv->buswidth     = MMCSD_SCR_BUSWIDTH_1BIT;
   SDIO_WIDEBUS(priv->dev, false);
   priv->widebus      = false;
+  priv->highspeed    = false;
   mmcsd_widebus(priv);
 
   /* Disable clocking to the card */
@@ -4146,6 +4431,9 @@ int mmcsd_slotinitialize(int minor, FAR struct sdio_dev_s *dev)
 
   memset(priv, 0, sizeof(struct mmcsd_state_s));
   nxmutex_init(&priv->lock);
+#ifdef CONFIG_FS_BLOCK_ASYNC
+  blk_queue_initialize(&priv->queue);
+#endif
 
   /* Bind the MMCSD driver to the MMCSD state structure */
 
@@ -4202,6 +4490,9 @@ int mmcsd_slotinitialize(int minor, FAR struct sdio_dev_s *dev)
 errout_with_hwinit:
   mmcsd_hwuninitialize(priv);
 errout_with_alloc:
+#ifdef CONFIG_FS_BLOCK_ASYNC
+  blk_queue_uninitialize(&priv->queue);
+#endif
   nxmutex_destroy(&priv->lock);
   kmm_free(priv);
   return ret;
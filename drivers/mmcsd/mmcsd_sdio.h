@@ -78,6 +78,24 @@
 #define MMCSD_ACMD6_BUSWIDTH_1      ((uint32_t)0)          /* Bus width = 1-bit */
 #define MMCSD_ACMD6_BUSWIDTH_4      ((uint32_t)2)          /* Bus width = 4-bit */
 
+/* CMD6 (SD SWITCH_FUNC) argument.  Each 4-bit field selects the function
+ * of one group; 0xf keeps the current function of that group.
+ */
+
+#define MMCSD_SWITCH_MODE_CHECK     ((uint32_t)0 << 31)    /* Bit 31=0: Query the functions */
+#define MMCSD_SWITCH_MODE_SET       ((uint32_t)1 << 31)    /* Bit 31=1: Switch the functions */
+#define MMCSD_SWITCH_NOCHANGE       ((uint32_t)0x00fffff0) /* Bits 4-23: Keep groups 2-6 */
+#define MMCSD_SWITCH_GROUP1_SHIFT   (0)                    /* Bits 0-3: Access mode */
+#define MMCSD_SWITCH_GROUP1_MASK    ((uint32_t)0x0f << MMCSD_SWITCH_GROUP1_SHIFT)
+#  define MMCSD_SWITCH_GROUP1_DS    ((uint32_t)0x00 << MMCSD_SWITCH_GROUP1_SHIFT) /* Default speed */
+#  define MMCSD_SWITCH_GROUP1_HS    ((uint32_t)0x01 << MMCSD_SWITCH_GROUP1_SHIFT) /* High speed */
+
+/* CMD6 switch function status, 512 bits sent most significant byte first */
+
+#define MMCSD_SWITCH_STATUS_SIZE    (64)
+#define MMCSD_SWITCH_GROUP1_SUPPORT (13)                   /* Byte 13: Bits 407-400, functions 7-0 */
+#define MMCSD_SWITCH_GROUP1_RESULT  (16)                   /* Byte 16: Bits 379-376, selected function */
+
 /* ACMD41 argument */
 
 #define MMCSD_ACMD41_VOLTAGEWINDOW_34_33 ((uint32_t)1 << 21)
@@ -203,6 +221,9 @@
 #define MMCSD_SCR_BUSWIDTH_4BIT     (4)
 #define MMCSD_SCR_BUSWIDTH_8BIT     (8)
 
+#define MMCSD_SCR_SDSPEC_1_10       (1)                    /* CMD6 supported from here on */
+#define MMCSD_SCR_CMDSUPPORT_CMD23  (2)                    /* SET_BLOCK_COUNT supported */
+
 /* Last 4 bytes of the 48-bit R7 response */
 
 #define MMCSD_R7VERSION_SHIFT       (28)                   /* Bits 28-31: Command version number */
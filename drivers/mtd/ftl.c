@@ -80,6 +80,11 @@ struct ftl_struct_s
 
   FAR off_t            *lptable;
   off_t                 lpcount;
+
+#ifdef CONFIG_FS_BLOCK_ASYNC
+  mutex_t               lock;     /* Serializes the queue thread with BCH */
+  struct blk_queue_s    queue;    /* Asynchronous transfer requests */
+#endif
 };
 
 /****************************************************************************
@@ -104,6 +109,10 @@ static int     ftl_ioctl(FAR struct inode *inode, int cmd,
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
 static int     ftl_unlink(FAR struct inode *inode);
 #endif
+#ifdef CONFIG_FS_BLOCK_ASYNC
+static int     ftl_submit(FAR struct inode *inode,
+                 FAR struct blk_request_s *req);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -120,6 +129,9 @@ static const struct block_operations g_bops =
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   , ftl_unlink  /* unlink   */
 #endif
+#ifdef CONFIG_FS_BLOCK_ASYNC
+  , ftl_submit  /* submit   */
+#endif
 };
 
 /****************************************************************************
@@ -247,6 +259,10 @@ static int ftl_close(FAR struct inode *inode)
           kmm_free(dev->eblock);
         }
 
+#ifdef CONFIG_FS_BLOCK_ASYNC
+      blk_queue_uninitialize(&dev->queue);
+      nxmutex_destroy(&dev->lock);
+#endif
       kmm_free(dev);
     }
 
@@ -439,17 +455,31 @@ static ssize_t ftl_read(FAR struct inode *inode, unsigned char *buffer,
                         blkcnt_t start_sector, unsigned int nsectors)
 {
   FAR struct ftl_struct_s *dev;
+  ssize_t ret;
 
   finfo("sector: %" PRIuOFF " nsectors: %u\n", start_sector, nsectors);
 
   DEBUGASSERT(inode->i_private);
 
   dev = inode->i_private;
+#ifdef CONFIG_FS_BLOCK_ASYNC
+  ret = nxmutex_lock(&dev->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
 #ifdef FTL_HAVE_RWBUFFER
-  return rwb_read(&dev->rwb, start_sector, nsectors, buffer);
+  ret = rwb_read(&dev->rwb, start_sector, nsectors, buffer);
 #else
-  return ftl_reload(dev, buffer, start_sector, nsectors);
+  ret = ftl_reload(dev, buffer, start_sector, nsectors);
 #endif
+
+#ifdef CONFIG_FS_BLOCK_ASYNC
+  nxmutex_unlock(&dev->lock);
+#endif
+  return ret;
 }
 
 /****************************************************************************
@@ -657,16 +687,30 @@ static ssize_t ftl_write(FAR struct inode *inode,
                          blkcnt_t start_sector, unsigned int nsectors)
 {
   struct ftl_struct_s *dev;
+  ssize_t ret;
 
   finfo("sector: %" PRIuOFF " nsectors: %u\n", start_sector, nsectors);
 
   DEBUGASSERT(inode->i_private);
   dev = inode->i_private;
+#ifdef CONFIG_FS_BLOCK_ASYNC
+  ret = nxmutex_lock(&dev->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
 #ifdef FTL_HAVE_RWBUFFER
-  return rwb_write(&dev->rwb, start_sector, nsectors, buffer);
+  ret = rwb_write(&dev->rwb, start_sector, nsectors, buffer);
 #else
-  return ftl_flush(dev, buffer, start_sector, nsectors);
+  ret = ftl_flush(dev, buffer, start_sector, nsectors);
 #endif
+
+#ifdef CONFIG_FS_BLOCK_ASYNC
+  nxmutex_unlock(&dev->lock);
+#endif
+  return ret;
 }
 
 /****************************************************************************
@@ -770,6 +814,10 @@ static int ftl_unlink(FAR struct inode *inode)
           kmm_free(dev->eblock);
         }
 
+#ifdef CONFIG_FS_BLOCK_ASYNC
+      blk_queue_uninitialize(&dev->queue);
+      nxmutex_destroy(&dev->lock);
+#endif
       kmm_free(dev);
     }
 
@@ -777,6 +825,25 @@ static int ftl_unlink(FAR struct inode *inode)
 }
 #endif
 
+/****************************************************************************
+ * Name: ftl_submit
+ *
+ * Description: Queue an asynchronous transfer
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLOCK_ASYNC
+static int ftl_submit(FAR struct inode *inode, FAR struct blk_request_s *req)
+{
+  FAR struct ftl_struct_s *dev;
+
+  DEBUGASSERT(inode->i_private);
+  dev = inode->i_private;
+
+  return blk_queue_submit(&dev->queue, inode, req);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -862,6 +929,11 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
         }
 #endif
 
+#ifdef CONFIG_FS_BLOCK_ASYNC
+      nxmutex_init(&dev->lock);
+      blk_queue_initialize(&dev->queue);
+#endif
+
       if (MTD_ISBAD(dev->mtd, 0) != -ENOSYS)
         {
           ret = ftl_init_map(dev);
@@ -881,6 +953,10 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
 out:
 #ifdef FTL_HAVE_RWBUFFER
           rwb_uninitialize(&dev->rwb);
+#endif
+#ifdef CONFIG_FS_BLOCK_ASYNC
+          blk_queue_uninitialize(&dev->queue);
+          nxmutex_destroy(&dev->lock);
 #endif
           kmm_free(dev);
         }
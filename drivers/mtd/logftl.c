@@ -0,0 +1,1129 @@
+/****************************************************************************
+ * drivers/mtd/logftl.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mtd/mtd.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+
+#ifdef CONFIG_MTD_LOGFTL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* On the media, each erase block starts with a header followed by one
+ * 32-bit entry per data page, that holds the logical sector stored in the
+ * page.  The header and the entries fill the first 'nhdr' pages, the data
+ * pages follow.  Erased flash reads as all ones, so fields are programmed
+ * once each:
+ *
+ *   - magic and erase count right after the block is erased;
+ *   - the sequence number when the block starts to be written;
+ *   - an entry after the data of its page has been programmed.
+ *
+ * The blocks are replayed in sequence order when the FTL is opened, so the
+ * last copy of a logical sector wins.
+ */
+
+#define LOGFTL_MAGIC          0x4c46544c
+#define LOGFTL_UNMAPPED       UINT32_MAX
+#define LOGFTL_NONE           UINT32_MAX
+
+#define LOGFTL_OFF_MAGIC      0
+#define LOGFTL_OFF_ERASECOUNT 4
+#define LOGFTL_OFF_SEQ        8
+#define LOGFTL_OFF_ENTRY(n)   (12 + 4 * (n))
+
+/* Block states */
+
+#define LOGFTL_DIRTY          0  /* Must be erased before use */
+#define LOGFTL_FREE           1  /* Erased, has a header but no sequence */
+#define LOGFTL_ACTIVE         2  /* Being written */
+#define LOGFTL_FULL           3  /* No more pages will be written */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct logftl_block_s
+{
+  uint32_t erasecount;            /* Number of times the block was erased */
+  uint32_t seq;                   /* Sequence number when written */
+  uint16_t valid;                 /* Pages that hold the current copy */
+  uint16_t used;                  /* Data pages programmed or skipped */
+  uint8_t  state;                 /* See LOGFTL_* states */
+};
+
+struct logftl_dev_s
+{
+  FAR struct mtd_dev_s *mtd;      /* Contained MTD interface */
+  struct mtd_geometry_s geo;      /* Device geometry */
+  mutex_t  lock;                  /* Serializes all the accesses */
+  uint16_t blkper;                /* Pages per erase block */
+  uint16_t nhdr;                  /* Pages holding the header */
+  uint16_t ndata;                 /* Data pages per erase block */
+  uint16_t refs;                  /* Number of references */
+  bool     unlinked;              /* The driver has been unlinked */
+  uint32_t nblocks;               /* Number of erase blocks */
+  uint32_t nsectors;              /* Number of logical sectors */
+  uint32_t nfree;                 /* Blocks in the LOGFTL_FREE state */
+  uint32_t ndirty;                /* Blocks in the LOGFTL_DIRTY state */
+  uint32_t seq;                   /* Next sequence number */
+  uint32_t active;                /* The block being written or NONE */
+  FAR uint32_t *map;              /* Logical sector to physical page */
+  FAR struct logftl_block_s *blocks;
+  FAR uint8_t *hdrbuf;            /* Header pages of one block */
+  FAR uint8_t *pagebuf;           /* One page for relocations */
+#ifdef CONFIG_MTD_LOGFTL_BGERASE
+  struct work_s work;             /* Background erase and collection */
+  sem_t    gcstopped;             /* Posted when a stopped worker ends */
+  bool     gcqueued;              /* The work is queued or running */
+  bool     gcstop;                /* Stop the background work */
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     logftl_open(FAR struct inode *inode);
+static int     logftl_close(FAR struct inode *inode);
+static ssize_t logftl_read(FAR struct inode *inode,
+                 FAR unsigned char *buffer, blkcnt_t start_sector,
+                 unsigned int nsectors);
+static ssize_t logftl_write(FAR struct inode *inode,
+                 FAR const unsigned char *buffer, blkcnt_t start_sector,
+                 unsigned int nsectors);
+static int     logftl_geometry(FAR struct inode *inode,
+                 FAR struct geometry *geometry);
+static int     logftl_ioctl(FAR struct inode *inode, int cmd,
+                 unsigned long arg);
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int     logftl_unlink(FAR struct inode *inode);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct block_operations g_logftl_bops =
+{
+  logftl_open,     /* open     */
+  logftl_close,    /* close    */
+  logftl_read,     /* read     */
+  logftl_write,    /* write    */
+  logftl_geometry, /* geometry */
+  logftl_ioctl     /* ioctl    */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , logftl_unlink  /* unlink   */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: logftl_program
+ *
+ * Description:
+ *   Program a 32-bit field of the header of a block.
+ *
+ ****************************************************************************/
+
+static int logftl_program(FAR struct logftl_dev_s *dev, uint32_t block,
+                          off_t offset, uint32_t value)
+{
+  ssize_t ret;
+
+  ret = MTD_WRITE(dev->mtd, (off_t)block * dev->geo.erasesize + offset,
+                  sizeof(value), (FAR const uint8_t *)&value);
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: logftl_readhdr
+ *
+ * Description:
+ *   Read the header pages of a block into hdrbuf.
+ *
+ ****************************************************************************/
+
+static int logftl_readhdr(FAR struct logftl_dev_s *dev, uint32_t block,
+                          uint16_t npages)
+{
+  ssize_t ret;
+
+  ret = MTD_BREAD(dev->mtd, block * dev->blkper, npages, dev->hdrbuf);
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: logftl_field
+ ****************************************************************************/
+
+static uint32_t logftl_field(FAR struct logftl_dev_s *dev, off_t offset)
+{
+  uint32_t value;
+
+  memcpy(&value, dev->hdrbuf + offset, sizeof(value));
+  return value;
+}
+
+/****************************************************************************
+ * Name: logftl_erase
+ *
+ * Description:
+ *   Erase a block that holds no current data and write its header.
+ *
+ ****************************************************************************/
+
+static int logftl_erase(FAR struct logftl_dev_s *dev, uint32_t block)
+{
+  FAR struct logftl_block_s *blk = &dev->blocks[block];
+  int ret;
+
+  DEBUGASSERT(blk->valid == 0 && block != dev->active);
+
+  if (blk->state == LOGFTL_FREE)
+    {
+      dev->nfree--;
+    }
+  else if (blk->state == LOGFTL_DIRTY)
+    {
+      dev->ndirty--;
+    }
+
+  blk->state = LOGFTL_DIRTY;
+  blk->used  = 0;
+  blk->seq   = LOGFTL_UNMAPPED;
+  dev->ndirty++;
+
+  ret = MTD_ERASE(dev->mtd, block, 1);
+  if (ret < 0)
+    {
+      ferr("ERROR: Erase of block %" PRIu32 " failed: %d\n", block, ret);
+      return ret;
+    }
+
+  blk->erasecount++;
+  ret = logftl_program(dev, block, LOGFTL_OFF_ERASECOUNT, blk->erasecount);
+  if (ret >= 0)
+    {
+      ret = logftl_program(dev, block, LOGFTL_OFF_MAGIC, LOGFTL_MAGIC);
+    }
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  blk->state = LOGFTL_FREE;
+  dev->ndirty--;
+  dev->nfree++;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: logftl_victim
+ *
+ * Description:
+ *   Select the full block to collect: normally the one with the fewest
+ *   current pages, but the least worn one holding static data when the
+ *   wear has become too uneven.
+ *
+ ****************************************************************************/
+
+static uint32_t logftl_victim(FAR struct logftl_dev_s *dev)
+{
+  FAR struct logftl_block_s *blk;
+  uint32_t maxerase = 0;
+  uint32_t victim = LOGFTL_NONE;
+  uint32_t cold = LOGFTL_NONE;
+  uint32_t i;
+
+  for (i = 0; i < dev->nblocks; i++)
+    {
+      blk = &dev->blocks[i];
+      if (blk->erasecount > maxerase)
+        {
+          maxerase = blk->erasecount;
+        }
+
+      if (blk->state != LOGFTL_FULL)
+        {
+          continue;
+        }
+
+      if (victim == LOGFTL_NONE || blk->valid < dev->blocks[victim].valid ||
+          (blk->valid == dev->blocks[victim].valid &&
+           blk->erasecount < dev->blocks[victim].erasecount))
+        {
+          victim = i;
+        }
+
+      if (cold == LOGFTL_NONE ||
+          blk->erasecount < dev->blocks[cold].erasecount)
+        {
+          cold = i;
+        }
+    }
+
+  if (cold != LOGFTL_NONE && dev->blocks[victim].valid > 0 &&
+      maxerase - dev->blocks[cold].erasecount >
+      CONFIG_MTD_LOGFTL_WEARLEVEL)
+    {
+      victim = cold;
+    }
+
+  return victim;
+}
+
+static int logftl_writepage(FAR struct logftl_dev_s *dev, uint32_t lsn,
+                            FAR const uint8_t *data, bool gc);
+
+/****************************************************************************
+ * Name: logftl_collect
+ *
+ * Description:
+ *   Make one more block free: erase a dirty block if there is one,
+ *   otherwise move the current pages of a victim to the active block and
+ *   erase the victim.
+ *
+ ****************************************************************************/
+
+static int logftl_collect(FAR struct logftl_dev_s *dev)
+{
+  uint32_t victim;
+  uint32_t page;
+  uint32_t lsn;
+  uint16_t i;
+  int ret;
+
+  if (dev->ndirty > 0)
+    {
+      for (victim = 0; victim < dev->nblocks; victim++)
+        {
+          if (dev->blocks[victim].state == LOGFTL_DIRTY)
+            {
+              return logftl_erase(dev, victim);
+            }
+        }
+    }
+
+  victim = logftl_victim(dev);
+  if (victim == LOGFTL_NONE)
+    {
+      return -ENOSPC;
+    }
+
+  if (dev->blocks[victim].valid > 0)
+    {
+      ret = logftl_readhdr(dev, victim, dev->nhdr);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      for (i = 0; i < dev->blocks[victim].used &&
+                  dev->blocks[victim].valid > 0; i++)
+        {
+          lsn  = logftl_field(dev, LOGFTL_OFF_ENTRY(i));
+          page = victim * dev->blkper + dev->nhdr + i;
+          if (lsn >= dev->nsectors || dev->map[lsn] != page)
+            {
+              continue;
+            }
+
+          ret = MTD_BREAD(dev->mtd, page, 1, dev->pagebuf);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          ret = logftl_writepage(dev, lsn, dev->pagebuf, true);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return logftl_erase(dev, victim);
+}
+
+/****************************************************************************
+ * Name: logftl_allocpage
+ *
+ * Description:
+ *   Return the next free data page of the active block, opening the least
+ *   worn free block when needed.  The last free block is kept for garbage
+ *   collection ('gc' true); ordinary writes collect first.
+ *
+ ****************************************************************************/
+
+static int logftl_allocpage(FAR struct logftl_dev_s *dev, bool gc,
+                            FAR uint32_t *page)
+{
+  FAR struct logftl_block_s *blk;
+  uint32_t retries = dev->nblocks;
+  uint32_t block;
+  uint32_t i;
+  int ret;
+
+  while (retries-- > 0)
+    {
+      if (dev->active != LOGFTL_NONE)
+        {
+          blk = &dev->blocks[dev->active];
+          if (blk->used < dev->ndata)
+            {
+              *page = dev->active * dev->blkper + dev->nhdr + blk->used++;
+              return OK;
+            }
+
+          blk->state  = LOGFTL_FULL;
+          dev->active = LOGFTL_NONE;
+        }
+
+      if (dev->nfree > 1 || (gc && dev->nfree > 0))
+        {
+          block = LOGFTL_NONE;
+          for (i = 0; i < dev->nblocks; i++)
+            {
+              if (dev->blocks[i].state == LOGFTL_FREE &&
+                  (block == LOGFTL_NONE || dev->blocks[i].erasecount <
+                                           dev->blocks[block].erasecount))
+                {
+                  block = i;
+                }
+            }
+
+          DEBUGASSERT(block != LOGFTL_NONE);
+
+          ret = logftl_program(dev, block, LOGFTL_OFF_SEQ, dev->seq);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          blk         = &dev->blocks[block];
+          blk->seq    = dev->seq++;
+          blk->state  = LOGFTL_ACTIVE;
+          dev->active = block;
+          dev->nfree--;
+          continue;
+        }
+
+      if (gc)
+        {
+          return -ENOSPC;
+        }
+
+      ret = logftl_collect(dev);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return -ENOSPC;
+}
+
+/****************************************************************************
+ * Name: logftl_writepage
+ *
+ * Description:
+ *   Write a logical sector to a new page: program the data, then the entry
+ *   that makes it the current copy.
+ *
+ ****************************************************************************/
+
+static int logftl_writepage(FAR struct logftl_dev_s *dev, uint32_t lsn,
+                            FAR const uint8_t *data, bool gc)
+{
+  uint32_t block;
+  uint32_t page;
+  uint32_t old;
+  ssize_t nwritten;
+  int ret;
+
+  ret = logftl_allocpage(dev, gc, &page);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  block = page / dev->blkper;
+
+  nwritten = MTD_BWRITE(dev->mtd, page, 1, data);
+  if (nwritten < 0)
+    {
+      return nwritten;
+    }
+
+  ret = logftl_program(dev, block,
+                       LOGFTL_OFF_ENTRY(page % dev->blkper - dev->nhdr),
+                       lsn);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  old = dev->map[lsn];
+  if (old != LOGFTL_UNMAPPED)
+    {
+      dev->blocks[old / dev->blkper].valid--;
+    }
+
+  dev->map[lsn] = page;
+  dev->blocks[block].valid++;
+  return OK;
+}
+
+#ifdef CONFIG_MTD_LOGFTL_BGERASE
+
+/****************************************************************************
+ * Name: logftl_worker
+ *
+ * Description:
+ *   Erase dirty blocks and collect blocks that are at least half stale
+ *   until enough blocks are free, dropping the lock between steps.
+ *
+ ****************************************************************************/
+
+static void logftl_worker(FAR void *arg)
+{
+  FAR struct logftl_dev_s *dev = arg;
+  irqstate_t flags;
+  uint32_t victim;
+  uint32_t steps;
+  bool stop;
+  int ret;
+
+  for (steps = 0; steps < dev->nblocks && !dev->gcstop; steps++)
+    {
+      nxmutex_lock(&dev->lock);
+
+      ret = -EAGAIN;
+      if (dev->ndirty > 0)
+        {
+          ret = logftl_collect(dev);
+        }
+      else if (dev->nfree < CONFIG_MTD_LOGFTL_NSPARES)
+        {
+          victim = logftl_victim(dev);
+          if (victim != LOGFTL_NONE &&
+              dev->blocks[victim].valid <= dev->ndata / 2)
+            {
+              ret = logftl_collect(dev);
+            }
+        }
+
+      nxmutex_unlock(&dev->lock);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  /* logftl_unlink() waits for us if we were running */
+
+  flags         = enter_critical_section();
+  stop          = dev->gcstop;
+  dev->gcqueued = false;
+  leave_critical_section(flags);
+
+  if (stop)
+    {
+      nxsem_post(&dev->gcstopped);
+    }
+}
+
+/****************************************************************************
+ * Name: logftl_kick
+ *
+ * Description:
+ *   Queue the background work if blocks are waiting to be erased or free
+ *   blocks are getting scarce.
+ *
+ ****************************************************************************/
+
+static void logftl_kick(FAR struct logftl_dev_s *dev)
+{
+  irqstate_t flags;
+
+  if (dev->ndirty == 0 && dev->nfree >= CONFIG_MTD_LOGFTL_NSPARES)
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+  if (!dev->gcqueued && !dev->gcstop)
+    {
+      dev->gcqueued = true;
+      work_queue(LPWORK, &dev->work, logftl_worker, dev, 0);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: logftl_stop
+ ****************************************************************************/
+
+static void logftl_stop(FAR struct logftl_dev_s *dev)
+{
+  irqstate_t flags;
+  bool wait;
+
+  flags       = enter_critical_section();
+  dev->gcstop = true;
+  if (work_cancel(LPWORK, &dev->work) >= 0)
+    {
+      dev->gcqueued = false;
+    }
+
+  wait = dev->gcqueued;
+  leave_critical_section(flags);
+
+  if (wait)
+    {
+      nxsem_wait_uninterruptible(&dev->gcstopped);
+    }
+}
+
+#else
+#  define logftl_kick(dev)
+#  define logftl_stop(dev)
+#endif /* CONFIG_MTD_LOGFTL_BGERASE */
+
+/****************************************************************************
+ * Name: logftl_free
+ ****************************************************************************/
+
+static void logftl_free(FAR struct logftl_dev_s *dev)
+{
+  logftl_stop(dev);
+
+#ifdef CONFIG_MTD_LOGFTL_BGERASE
+  nxsem_destroy(&dev->gcstopped);
+#endif
+  nxmutex_destroy(&dev->lock);
+  kmm_free(dev->map);
+  kmm_free(dev->blocks);
+  kmm_free(dev->hdrbuf);
+  kmm_free(dev->pagebuf);
+  kmm_free(dev);
+}
+
+/****************************************************************************
+ * Name: logftl_compare
+ ****************************************************************************/
+
+static int logftl_compare(FAR const void *a, FAR const void *b)
+{
+  uint32_t seqa = ((FAR const uint32_t *)a)[0];
+  uint32_t seqb = ((FAR const uint32_t *)b)[0];
+
+  return seqa < seqb ? -1 : seqa > seqb;
+}
+
+/****************************************************************************
+ * Name: logftl_scan
+ *
+ * Description:
+ *   Rebuild the map and the block states from the media.  Blocks that were
+ *   being written are closed: a page after the last entry may have been
+ *   torn by a power loss.
+ *
+ ****************************************************************************/
+
+static int logftl_scan(FAR struct logftl_dev_s *dev)
+{
+  FAR struct logftl_block_s *blk;
+  FAR uint32_t *order;
+  uint64_t erasesum = 0;
+  uint32_t nknown = 0;
+  uint32_t nused = 0;
+  uint32_t block;
+  uint32_t page;
+  uint32_t lsn;
+  uint32_t i;
+  uint16_t j;
+  int ret;
+
+  memset(dev->map, 0xff, dev->nsectors * sizeof(uint32_t));
+
+  /* Pairs of (sequence, block) of the written blocks */
+
+  order = kmm_malloc(dev->nblocks * 2 * sizeof(uint32_t));
+  if (order == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (block = 0; block < dev->nblocks; block++)
+    {
+      blk = &dev->blocks[block];
+      ret = logftl_readhdr(dev, block, 1);
+      if (ret < 0)
+        {
+          goto out;
+        }
+
+      blk->seq = LOGFTL_UNMAPPED;
+      if (logftl_field(dev, LOGFTL_OFF_MAGIC) != LOGFTL_MAGIC)
+        {
+          blk->state = LOGFTL_DIRTY;
+          dev->ndirty++;
+          continue;
+        }
+
+      blk->erasecount = logftl_field(dev, LOGFTL_OFF_ERASECOUNT);
+      erasesum       += blk->erasecount;
+      nknown++;
+
+      blk->seq = logftl_field(dev, LOGFTL_OFF_SEQ);
+      if (blk->seq == LOGFTL_UNMAPPED)
+        {
+          blk->state = LOGFTL_FREE;
+          dev->nfree++;
+        }
+      else
+        {
+          blk->state = LOGFTL_FULL;
+          blk->used  = dev->ndata;
+          order[2 * nused]     = blk->seq;
+          order[2 * nused + 1] = block;
+          nused++;
+
+          if (blk->seq >= dev->seq)
+            {
+              dev->seq = blk->seq + 1;
+            }
+        }
+    }
+
+  /* Blocks of unknown wear are assumed to be average */
+
+  for (block = 0; block < dev->nblocks; block++)
+    {
+      if (dev->blocks[block].state == LOGFTL_DIRTY)
+        {
+          dev->blocks[block].erasecount = nknown ? erasesum / nknown : 0;
+        }
+    }
+
+  /* Replay the written blocks from the oldest */
+
+  qsort(order, nused, 2 * sizeof(uint32_t), logftl_compare);
+
+  for (i = 0; i < nused; i++)
+    {
+      block = order[2 * i + 1];
+      ret   = logftl_readhdr(dev, block, dev->nhdr);
+      if (ret < 0)
+        {
+          goto out;
+        }
+
+      for (j = 0; j < dev->ndata; j++)
+        {
+          lsn = logftl_field(dev, LOGFTL_OFF_ENTRY(j));
+          if (lsn == LOGFTL_UNMAPPED)
+            {
+              break;
+            }
+
+          if (lsn >= dev->nsectors)
+            {
+              continue;
+            }
+
+          page = block * dev->blkper + dev->nhdr + j;
+          if (dev->map[lsn] != LOGFTL_UNMAPPED)
+            {
+              dev->blocks[dev->map[lsn] / dev->blkper].valid--;
+            }
+
+          dev->map[lsn] = page;
+          dev->blocks[block].valid++;
+        }
+    }
+
+  /* Writes need two free blocks, erase more now if needed */
+
+  ret = OK;
+  while (dev->nfree < 2 && ret >= 0)
+    {
+      ret = logftl_collect(dev);
+    }
+
+out:
+  kmm_free(order);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: logftl_open
+ ****************************************************************************/
+
+static int logftl_open(FAR struct inode *inode)
+{
+  FAR struct logftl_dev_s *dev = inode->i_private;
+
+  nxmutex_lock(&dev->lock);
+  dev->refs++;
+  nxmutex_unlock(&dev->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: logftl_close
+ ****************************************************************************/
+
+static int logftl_close(FAR struct inode *inode)
+{
+  FAR struct logftl_dev_s *dev = inode->i_private;
+
+  nxmutex_lock(&dev->lock);
+  dev->refs--;
+  nxmutex_unlock(&dev->lock);
+
+  if (dev->refs == 0 && dev->unlinked)
+    {
+      logftl_free(dev);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: logftl_read
+ *
+ * Description:
+ *   Read the specified number of sectors.  Sectors never written read as
+ *   erased flash.
+ *
+ ****************************************************************************/
+
+static ssize_t logftl_read(FAR struct inode *inode,
+                           FAR unsigned char *buffer,
+                           blkcnt_t start_sector, unsigned int nsectors)
+{
+  FAR struct logftl_dev_s *dev = inode->i_private;
+  unsigned int nread;
+  uint32_t page;
+  ssize_t ret = OK;
+
+  if (start_sector >= dev->nsectors)
+    {
+      return -EINVAL;
+    }
+
+  if (nsectors > dev->nsectors - start_sector)
+    {
+      nsectors = dev->nsectors - start_sector;
+    }
+
+  nxmutex_lock(&dev->lock);
+
+  for (nread = 0; nread < nsectors; nread++)
+    {
+      page = dev->map[start_sector + nread];
+      if (page == LOGFTL_UNMAPPED)
+        {
+          memset(buffer, 0xff, dev->geo.blocksize);
+        }
+      else
+        {
+          ret = MTD_BREAD(dev->mtd, page, 1, buffer);
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+
+      buffer += dev->geo.blocksize;
+    }
+
+  nxmutex_unlock(&dev->lock);
+  return nread > 0 ? nread : ret;
+}
+
+/****************************************************************************
+ * Name: logftl_write
+ *
+ * Description:
+ *   Write each sector to a fresh page: no erase or read-modify-write is
+ *   needed until free blocks run out.
+ *
+ ****************************************************************************/
+
+static ssize_t logftl_write(FAR struct inode *inode,
+                            FAR const unsigned char *buffer,
+                            blkcnt_t start_sector, unsigned int nsectors)
+{
+  FAR struct logftl_dev_s *dev = inode->i_private;
+  unsigned int nwritten;
+  int ret = OK;
+
+  if (start_sector >= dev->nsectors)
+    {
+      return -EINVAL;
+    }
+
+  if (nsectors > dev->nsectors - start_sector)
+    {
+      nsectors = dev->nsectors - start_sector;
+    }
+
+  nxmutex_lock(&dev->lock);
+
+  for (nwritten = 0; nwritten < nsectors; nwritten++)
+    {
+      ret = logftl_writepage(dev, start_sector + nwritten, buffer, false);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      buffer += dev->geo.blocksize;
+    }
+
+  logftl_kick(dev);
+  nxmutex_unlock(&dev->lock);
+  return nwritten > 0 ? nwritten : ret;
+}
+
+/****************************************************************************
+ * Name: logftl_geometry
+ ****************************************************************************/
+
+static int logftl_geometry(FAR struct inode *inode,
+                           FAR struct geometry *geometry)
+{
+  FAR struct logftl_dev_s *dev = inode->i_private;
+
+  if (geometry == NULL)
+    {
+      return -EINVAL;
+    }
+
+  memset(geometry, 0, sizeof(*geometry));
+  geometry->geo_available    = true;
+  geometry->geo_mediachanged = false;
+  geometry->geo_writeenabled = true;
+  geometry->geo_nsectors     = dev->nsectors;
+  geometry->geo_sectorsize   = dev->geo.blocksize;
+  strlcpy(geometry->geo_model, dev->geo.model, sizeof(geometry->geo_model));
+  return OK;
+}
+
+/****************************************************************************
+ * Name: logftl_ioctl
+ *
+ * Description:
+ *   Nothing is buffered, so BIOC_FLUSH has nothing to do.  The MTD commands
+ *   are not passed through: erasing the media behind the FTL would corrupt
+ *   it.
+ *
+ ****************************************************************************/
+
+static int logftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
+{
+  return cmd == BIOC_FLUSH ? OK : -ENOTTY;
+}
+
+/****************************************************************************
+ * Name: logftl_unlink
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int logftl_unlink(FAR struct inode *inode)
+{
+  FAR struct logftl_dev_s *dev = inode->i_private;
+
+  nxmutex_lock(&dev->lock);
+  dev->unlinked = true;
+  nxmutex_unlock(&dev->lock);
+
+  if (dev->refs == 0)
+    {
+      logftl_free(dev);
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: logftl_initialize_by_path
+ *
+ * Description:
+ *   Initialize to provide a log-structured FTL block driver over an MTD
+ *   interface
+ *
+ ****************************************************************************/
+
+int logftl_initialize_by_path(FAR const char *path,
+                              FAR struct mtd_dev_s *mtd)
+{
+  FAR struct logftl_dev_s *dev;
+  int ret;
+
+  if (path == NULL || mtd == NULL || mtd->write == NULL)
+    {
+      return -EINVAL;
+    }
+
+  dev = kmm_zalloc(sizeof(struct logftl_dev_s));
+  if (dev == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxmutex_init(&dev->lock);
+#ifdef CONFIG_MTD_LOGFTL_BGERASE
+  nxsem_init(&dev->gcstopped, 0, 0);
+#endif
+
+  dev->mtd    = mtd;
+  dev->active = LOGFTL_NONE;
+
+  ret = MTD_IOCTL(mtd, MTDIOC_GEOMETRY,
+                  (unsigned long)((uintptr_t)&dev->geo));
+  if (ret < 0)
+    {
+      ferr("ERROR: MTD ioctl(MTDIOC_GEOMETRY) failed: %d\n", ret);
+      goto errout;
+    }
+
+  /* The header pages hold 12 bytes and one entry per remaining page */
+
+  dev->blkper  = dev->geo.erasesize / dev->geo.blocksize;
+  dev->nblocks = dev->geo.neraseblocks;
+  for (dev->nhdr = 1; dev->nhdr < dev->blkper; dev->nhdr++)
+    {
+      if (LOGFTL_OFF_ENTRY(dev->blkper - dev->nhdr) <=
+          dev->nhdr * dev->geo.blocksize)
+        {
+          break;
+        }
+    }
+
+  dev->ndata = dev->blkper - dev->nhdr;
+  if (dev->ndata == 0 || dev->nblocks <= CONFIG_MTD_LOGFTL_NSPARES)
+    {
+      ferr("ERROR: Geometry not supported\n");
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  dev->nsectors = (dev->nblocks - CONFIG_MTD_LOGFTL_NSPARES) * dev->ndata;
+
+  dev->map     = kmm_malloc(dev->nsectors * sizeof(uint32_t));
+  dev->blocks  = kmm_zalloc(dev->nblocks * sizeof(struct logftl_block_s));
+  dev->hdrbuf  = kmm_malloc(dev->nhdr * dev->geo.blocksize);
+  dev->pagebuf = kmm_malloc(dev->geo.blocksize);
+  if (dev->map == NULL || dev->blocks == NULL || dev->hdrbuf == NULL ||
+      dev->pagebuf == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  ret = logftl_scan(dev);
+  if (ret < 0)
+    {
+      ferr("ERROR: Scan failed: %d\n", ret);
+      goto errout;
+    }
+
+  finfo("%" PRIu32 " sectors, %" PRIu32 " free and %" PRIu32
+        " dirty blocks\n", dev->nsectors, dev->nfree, dev->ndirty);
+
+  ret = register_blockdriver(path, &g_logftl_bops, 0666, dev);
+  if (ret < 0)
+    {
+      ferr("ERROR: register_blockdriver failed: %d\n", ret);
+      goto errout;
+    }
+
+  logftl_kick(dev);
+  return OK;
+
+errout:
+  logftl_free(dev);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: logftl_initialize
+ *
+ * Description:
+ *   Initialize to provide a log-structured FTL block driver over an MTD
+ *   interface, registered as /dev/mtdblockN
+ *
+ ****************************************************************************/
+
+int logftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
+{
+  char path[PATH_MAX];
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (minor < 0 || minor > 255)
+    {
+      return -EINVAL;
+    }
+#endif
+
+  snprintf(path, sizeof(path), "/dev/mtdblock%d", minor);
+  return logftl_initialize_by_path(path, mtd);
+}
+
+#endif /* CONFIG_MTD_LOGFTL */
@@ -230,8 +230,9 @@ static int mx25rxx_write_page(struct mx25rxx_dev_s *priv,
                               off_t address,
                               size_t buflen);
 static int mx25rxx_erase_sector(struct mx25rxx_dev_s *priv, off_t sector);
-#if 0 /* FIXME:  Not used */
-static int mx25rxx_erase_block(struct mx25rxx_dev_s *priv, off_t block);
+#ifndef CONFIG_MX25RXX_SECTOR512
+static int mx25rxx_erase_block(struct mx25rxx_dev_s *priv, off_t sector,
+                               uint8_t cmd);
 #endif
 static int mx25rxx_erase_chip(struct mx25rxx_dev_s *priv);
 
@@ -461,23 +462,25 @@ int mx25rxx_erase_sector(struct mx25rxx_dev_s *priv, off_t sector)
   return OK;
 }
 
-#if 0 /* FIXME:  Not used */
-int mx25rxx_erase_block(struct mx25rxx_dev_s *priv, off_t block)
+#ifndef CONFIG_MX25RXX_SECTOR512
+int mx25rxx_erase_block(struct mx25rxx_dev_s *priv, off_t sector,
+                        uint8_t cmd)
 {
   uint8_t status;
 
-  finfo("block: %08lx\n", (unsigned long)block);
+  finfo("sector: %08lx cmd: %02x\n", (unsigned long)sector, cmd);
 
-  /* Send the 64k block erase command */
+  /* Send the 32k or 64k block erase command */
 
   mx25rxx_write_enable(priv, true);
-  mx25rxx_command_address(priv->qspi, MX25R_BE64, block << 16, 3);
+  mx25rxx_command_address(priv->qspi, cmd,
+                          (off_t)sector << priv->sectorshift, 3);
 
   /* Wait for erasure to finish */
 
   do
     {
-      nxsig_usleep(300 * 1000);
+      nxsig_usleep(cmd == MX25R_BE64 ? 300 * 1000 : 150 * 1000);
       mx25rxx_read_status(priv);
       status = priv->cmdbuf[0];
     }
@@ -564,6 +567,9 @@ int mx25rxx_erase(FAR struct mtd_dev_s *dev,
   size_t blocksleft = nblocks;
 #ifdef CONFIG_MX25RXX_SECTOR512
   int ret;
+#else
+  size_t count;
+  uint8_t cmd;
 #endif
 
   finfo("startblock: %08lx nblocks: %d\n", (long)startblock, (int)nblocks);
@@ -572,19 +578,15 @@ int mx25rxx_erase(FAR struct mtd_dev_s *dev,
 
   mx25rxx_lock(priv->qspi, false);
 
+#ifdef CONFIG_MX25RXX_SECTOR512
   while (blocksleft-- > 0)
     {
       /* Erase each sector */
 
-#ifdef CONFIG_MX25RXX_SECTOR512
       mx25rxx_erase_cache(priv, startblock);
-#else
-      mx25rxx_erase_sector(priv, startblock);
-#endif
       startblock++;
     }
 
-#ifdef CONFIG_MX25RXX_SECTOR512
   /* Flush the last erase block left in the cache */
 
   ret = mx25rxx_flush_cache(priv);
@@ -592,35 +594,47 @@ int mx25rxx_erase(FAR struct mtd_dev_s *dev,
     {
       nblocks = ret;
     }
-#endif
+#else
+  /* Erasing the whole part is much faster with a single chip erase */
+
+  if (startblock == 0 && nblocks == priv->nsectors)
+    {
+      mx25rxx_erase_chip(priv);
+      blocksleft = 0;
+    }
 
-#if 0
-  /* FIXME: use mx25rxx_erase_block in case CONFIG_MX25RXX_SECTOR512 is
-   * not configured to speed up block erase.
+  /* Otherwise erase the range with the largest erase unit that is aligned
+   * and fits in what is left of it.
    */
 
-  unsigned int sectorsperblock = (64 * 1024) >> priv->sectorshift;
   while (blocksleft > 0)
     {
-      /* Check if current block is aligned on 64k block to speed up erase */
+      count = (64 * 1024) >> priv->sectorshift;
+      cmd   = MX25R_BE64;
 
-      if (((startblock & (sectorsperblock - 1)) == 0) &&
-          (blocksleft >= sectorsperblock))
+      if ((startblock & (count - 1)) != 0 || blocksleft < count)
         {
-          /* Erase 64k block */
+          count = (32 * 1024) >> priv->sectorshift;
+          cmd   = MX25R_BE32;
 
-          mx25rxx_erase_block(priv, startblock >> (16 - priv->sectorshift));
-          startblock += sectorsperblock;
-          blocksleft -= sectorsperblock;
+          if ((startblock & (count - 1)) != 0 || blocksleft < count)
+            {
+              count = 1;
+              cmd   = MX25R_SE;
+            }
         }
-      else
-        {
-          /* Erase each sector */
 
+      if (cmd == MX25R_SE)
+        {
           mx25rxx_erase_sector(priv, startblock);
-          startblock++;
-          blocksleft--;
         }
+      else
+        {
+          mx25rxx_erase_block(priv, startblock, cmd);
+        }
+
+      startblock += count;
+      blocksleft -= count;
     }
 #endif
 
@@ -142,6 +142,12 @@
 #define SMART_WEARFLAGS_FORCE_REORG         0x01
 #define SMART_WEARFLAGS_WRITE_NEEDED        0x02
 
+#define SMART_CKPT_MAGIC          "SMCP"
+#define SMART_CKPT_VERSION        1
+#define SMART_CKPT_DIRTY          (CONFIG_SMARTFS_ERASEDSTATE ^ 0xff)
+#define SMART_CKPT_MAPSIZE(d)     ((d)->totalsectors * sizeof(uint16_t) + \
+                                   ((d)->neraseblocks << 1))
+
 #define SET_BITMAP(m, n) do { (m)[(n) / 8] |= 1 << ((n) % 8); } while (0)
 #define CLR_BITMAP(m, n) do { (m)[(n) / 8] &= ~(1 << ((n) % 8)); } while (0)
 #define ISSET_BITMAP(m, n) ((m)[(n) / 8] & (1 << ((n) % 8)))
@@ -239,6 +245,26 @@ struct smart_allocsector_s
 };
 #endif
 
+/* Header of the sector map checkpoint.  The checkpoint area starts with
+ * the header block, followed by the journal with one byte per erase block
+ * and by the sector map, the release counts and the free counts exactly as
+ * they are laid out in RAM.  The header is written last.
+ */
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+struct smart_ckpt_header_s
+{
+  uint8_t               magic[4];         /* SMART_CKPT_MAGIC */
+  uint16_t              version;          /* SMART_CKPT_VERSION */
+  uint16_t              sectorsize;       /* Sector size of the map */
+  uint16_t              totalsectors;     /* Number of entries of the map */
+  uint16_t              neraseblocks;     /* Number of erase blocks */
+  uint16_t              freesectors;      /* Total number of free sectors */
+  uint16_t              releasesectors;   /* Total number of released sectors */
+  uint32_t              crc;              /* CRC-32 of the above and the map */
+};
+#endif
+
 struct smart_struct_s
 {
   FAR struct mtd_dev_s *mtd;              /* Contained MTD interface */
@@ -290,6 +316,14 @@ struct smart_struct_s
   uint16_t              cache_lastphys;   /* Keep the physical sector number also */
   uint16_t              cache_nextbirth;  /* Sector cache aging value */
 #endif
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  uint32_t              ckptblock;        /* First erase block of the checkpoint */
+  uint16_t              ckptndirty;       /* Blocks modified since the checkpoint */
+  bool                  ckptvalid;        /* The checkpoint on the device is valid */
+  FAR uint8_t          *ckptdirty;        /* Bitmap of the journaled erase blocks */
+  FAR uint8_t          *ckptreplay;       /* Bitmap of the blocks to scan again */
+  FAR uint8_t          *ckptbuf;          /* One MTD block for checkpoint I/O */
+#endif
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
   FAR uint8_t          *erasecounts;      /* Number of erases for each erase block */
 #endif
@@ -444,7 +478,15 @@ static int     smart_relocate_static_data(FAR struct smart_struct_s *dev,
 #endif
 
 static int     smart_relocate_sector(FAR struct smart_struct_s *dev,
-                 uint16_t oldsector, uint16_t newsector);
+                 uint16_t oldsector, uint16_t newsector, bool release);
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static void    smart_ckpt_mark(FAR struct smart_struct_s *dev,
+                 uint16_t block);
+static int     smart_ckpt_flush(FAR struct smart_struct_s *dev);
+#else
+#  define smart_ckpt_mark(dev, block)
+#endif
 
 #ifdef CONFIG_MTD_SMART_FSCK
 static int     smart_fsck(FAR struct smart_struct_s *dev);
@@ -511,7 +553,26 @@ static int smart_open(FAR struct inode *inode)
 
 static int smart_close(FAR struct inode *inode)
 {
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  FAR struct smart_struct_s *dev;
+
+  DEBUGASSERT(inode->i_private);
+
+#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
+  dev = ((FAR struct smart_multiroot_device_s *)inode->i_private)->dev;
+#else
+  dev = inode->i_private;
+#endif
+#endif
+
   finfo("Entry\n");
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* Save the sector map so that the next mount does not scan the device */
+
+  smart_ckpt_flush(dev);
+#endif
+
   return OK;
 }
 
@@ -982,6 +1043,7 @@ static ssize_t smart_write(FAR struct inode *inode,
           /* Erase the erase block */
 
           eraseblock = alignedblock / mtdblkspererase;
+          smart_ckpt_mark(dev, eraseblock);
           ret = MTD_ERASE(dev->mtd, eraseblock, 1);
           if (ret < 0)
             {
@@ -1011,6 +1073,7 @@ static ssize_t smart_write(FAR struct inode *inode,
 
       finfo("Write MTD block %" PRIdOFF " from offset %" PRIdOFF "\n",
             nextblock, offset);
+      smart_ckpt_mark(dev, nextblock / mtdblkspererase);
       nxfrd = MTD_BWRITE(dev->mtd, nextblock, blkstowrite, &buffer[offset]);
       if (nxfrd != blkstowrite)
         {
@@ -1399,6 +1462,8 @@ static ssize_t smart_bytewrite(FAR struct smart_struct_s *dev, size_t offset,
 {
   ssize_t       ret;
 
+  smart_ckpt_mark(dev, offset / dev->geo.erasesize);
+
 #ifdef CONFIG_MTD_BYTE_WRITE
   /* Check if the underlying MTD device supports write */
 
@@ -1456,6 +1521,397 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: smart_ckpt_mapblock
+ *
+ * Description: Returns the first MTD block of the checkpoint area and the
+ *              MTD block where the sector map is saved, if the area is
+ *              large enough for the map.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_ckpt_mapblock(FAR struct smart_struct_s *dev,
+                               FAR off_t *hdrblock, FAR off_t *mapblock)
+{
+  uint32_t blkspererase = dev->geo.erasesize / dev->geo.blocksize;
+  uint32_t journal;
+  uint32_t map;
+
+  journal = (dev->neraseblocks + dev->geo.blocksize - 1) /
+            dev->geo.blocksize;
+  map     = (SMART_CKPT_MAPSIZE(dev) + dev->geo.blocksize - 1) /
+            dev->geo.blocksize;
+
+  if (dev->ckptbuf == NULL ||
+      1 + journal + map > CONFIG_MTD_SMART_CHECKPOINT_NBLOCKS * blkspererase)
+    {
+      return -ENOSPC;
+    }
+
+  *hdrblock = (off_t)dev->ckptblock * blkspererase;
+  *mapblock = *hdrblock + 1 + journal;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: smart_ckpt_bytewrite
+ *
+ * Description: Programs one byte of the checkpoint area, using the same
+ *              methods as smart_bytewrite() but the checkpoint buffer, so
+ *              that the sector in the read/write buffer is left untouched.
+ *
+ ****************************************************************************/
+
+static int smart_ckpt_bytewrite(FAR struct smart_struct_s *dev,
+                                off_t offset, uint8_t value)
+{
+  off_t block;
+  ssize_t ret;
+
+#ifdef CONFIG_MTD_BYTE_WRITE
+  if (dev->mtd->write != NULL)
+    {
+      ret = dev->mtd->write(dev->mtd, offset, 1, &value);
+      return ret < 0 ? ret : OK;
+    }
+#endif
+
+  block = offset / dev->geo.blocksize;
+  ret   = MTD_BREAD(dev->mtd, block, 1, dev->ckptbuf);
+  if (ret != 1)
+    {
+      return ret < 0 ? ret : -EIO;
+    }
+
+  dev->ckptbuf[offset - block * dev->geo.blocksize] = value;
+
+  ret = MTD_BWRITE(dev->mtd, block, 1, dev->ckptbuf);
+  if (ret != 1)
+    {
+      return ret < 0 ? ret : -EIO;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: smart_ckpt_mark
+ *
+ * Description: Records in the journal that an erase block is about to be
+ *              modified, so that the next scan does not trust what the
+ *              checkpoint says about it.  Must be called before the first
+ *              erase or program of the block after a checkpoint.  If the
+ *              journal can't be written, the checkpoint is dropped.
+ *
+ ****************************************************************************/
+
+static void smart_ckpt_mark(FAR struct smart_struct_s *dev, uint16_t block)
+{
+  off_t hdrblock;
+  off_t mapblock;
+  int ret;
+
+  if (!dev->ckptvalid || ISSET_BITMAP(dev->ckptdirty, block))
+    {
+      return;
+    }
+
+  DEBUGASSERT(block < dev->neraseblocks);
+
+  SET_BITMAP(dev->ckptdirty, block);
+  dev->ckptndirty++;
+
+  smart_ckpt_mapblock(dev, &hdrblock, &mapblock);
+  ret = smart_ckpt_bytewrite(dev, (hdrblock + 1) * dev->geo.blocksize +
+                             block, SMART_CKPT_DIRTY);
+  if (ret < 0)
+    {
+      ferr("ERROR: Error %d journaling block %d, dropping checkpoint\n",
+           ret, block);
+
+      /* Spoil the magic of the header */
+
+      dev->ckptvalid = false;
+      smart_ckpt_bytewrite(dev, hdrblock * dev->geo.blocksize,
+                           SMART_CKPT_DIRTY);
+    }
+}
+
+/****************************************************************************
+ * Name: smart_ckpt_load
+ *
+ * Description: Reads the sector map, the free and release counts from the
+ *              checkpoint and the list of erase blocks modified since then
+ *              from the journal.
+ *
+ ****************************************************************************/
+
+static int smart_ckpt_load(FAR struct smart_struct_s *dev)
+{
+  struct smart_ckpt_header_s header;
+  size_t mapsize = SMART_CKPT_MAPSIZE(dev);
+  off_t hdrblock;
+  off_t mapblock;
+  uint32_t crc;
+  uint16_t block;
+  ssize_t ret;
+
+  dev->ckptvalid = false;
+
+  ret = smart_ckpt_mapblock(dev, &hdrblock, &mapblock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = MTD_BREAD(dev->mtd, hdrblock, 1, dev->ckptbuf);
+  if (ret != 1)
+    {
+      return ret < 0 ? ret : -EIO;
+    }
+
+  memcpy(&header, dev->ckptbuf, sizeof(header));
+  if (memcmp(header.magic, SMART_CKPT_MAGIC, sizeof(header.magic)) != 0 ||
+      header.version != SMART_CKPT_VERSION ||
+      header.sectorsize != dev->sectorsize ||
+      header.totalsectors != dev->totalsectors ||
+      header.neraseblocks != dev->neraseblocks)
+    {
+      return -ENOENT;
+    }
+
+  ret = MTD_READ(dev->mtd, mapblock * dev->geo.blocksize, mapsize,
+                 (FAR uint8_t *)dev->smap);
+  if (ret != mapsize)
+    {
+      return ret < 0 ? ret : -EIO;
+    }
+
+  crc = crc32((FAR const uint8_t *)&header,
+              offsetof(struct smart_ckpt_header_s, crc));
+  crc = crc32part((FAR const uint8_t *)dev->smap, mapsize, crc);
+  if (crc != header.crc)
+    {
+      fwarn("WARNING: Bad checkpoint CRC\n");
+      return -EINVAL;
+    }
+
+  /* Read the journal */
+
+  memset(dev->ckptdirty, 0, (dev->neraseblocks + 7) >> 3);
+  dev->ckptndirty = 0;
+
+  for (block = 0; block < dev->neraseblocks; block++)
+    {
+      if (block % dev->geo.blocksize == 0)
+        {
+          ret = MTD_BREAD(dev->mtd, hdrblock + 1 +
+                          block / dev->geo.blocksize, 1, dev->ckptbuf);
+          if (ret != 1)
+            {
+              return ret < 0 ? ret : -EIO;
+            }
+        }
+
+      if (dev->ckptbuf[block % dev->geo.blocksize] !=
+          CONFIG_SMARTFS_ERASEDSTATE)
+        {
+          SET_BITMAP(dev->ckptdirty, block);
+          dev->ckptndirty++;
+        }
+    }
+
+  memcpy(dev->ckptreplay, dev->ckptdirty, (dev->neraseblocks + 7) >> 3);
+
+  dev->freesectors    = header.freesectors;
+  dev->releasesectors = header.releasesectors;
+  dev->ckptvalid      = true;
+
+  finfo("Checkpoint loaded, %d blocks to scan\n", dev->ckptndirty);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: smart_ckpt_replay
+ *
+ * Description: Drops from the loaded map and counts everything that
+ *              belongs to the erase blocks modified since the checkpoint,
+ *              so that smart_scan() can scan them again.  Logical sector
+ *              zero is always scanned again for the format information.
+ *
+ * Returned Value:
+ *   The physical sector of logical sector zero if it has to be scanned in
+ *   addition to the modified blocks, 0xffff otherwise.
+ *
+ ****************************************************************************/
+
+static uint16_t smart_ckpt_replay(FAR struct smart_struct_s *dev)
+{
+  uint16_t prerelease;
+  uint16_t sector;
+  uint16_t block;
+  uint16_t phys0;
+
+  for (block = 0; block < dev->neraseblocks; block++)
+    {
+      if (!ISSET_BITMAP(dev->ckptreplay, block))
+        {
+          continue;
+        }
+
+      if (block == dev->neraseblocks - 1 && dev->totalsectors == 65534)
+        {
+          prerelease = 2;
+        }
+      else
+        {
+          prerelease = 0;
+        }
+
+      dev->freesectors        += dev->availsectperblk - prerelease -
+                                 dev->freecount[block];
+      dev->releasesectors     -= dev->releasecount[block] - prerelease;
+      dev->freecount[block]    = dev->availsectperblk - prerelease;
+      dev->releasecount[block] = prerelease;
+    }
+
+  for (sector = 0; sector < dev->totalsectors; sector++)
+    {
+      if (dev->smap[sector] != 0xffff &&
+          ISSET_BITMAP(dev->ckptreplay,
+                       dev->smap[sector] / dev->sectorsperblk))
+        {
+          dev->smap[sector] = 0xffff;
+        }
+    }
+
+  phys0 = dev->smap[0];
+  if (phys0 != 0xffff)
+    {
+      dev->smap[0] = 0xffff;
+      dev->freecount[phys0 / dev->sectorsperblk]++;
+      dev->freesectors++;
+    }
+
+  return phys0;
+}
+
+/****************************************************************************
+ * Name: smart_ckpt_write
+ *
+ * Description: Saves the sector map and the free and release counts in the
+ *              checkpoint area and starts a new, empty journal.
+ *
+ ****************************************************************************/
+
+static int smart_ckpt_write(FAR struct smart_struct_s *dev)
+{
+  FAR struct smart_ckpt_header_s *header;
+  size_t mapsize = SMART_CKPT_MAPSIZE(dev);
+  size_t nfull;
+  off_t hdrblock;
+  off_t mapblock;
+  ssize_t ret;
+
+  ret = smart_ckpt_mapblock(dev, &hdrblock, &mapblock);
+  if (ret < 0)
+    {
+      fwarn("WARNING: No room for the checkpoint\n");
+      return ret;
+    }
+
+  dev->ckptvalid = false;
+
+  ret = MTD_ERASE(dev->mtd, dev->ckptblock,
+                  CONFIG_MTD_SMART_CHECKPOINT_NBLOCKS);
+  if (ret < 0)
+    {
+      ferr("ERROR: Error %zd erasing the checkpoint\n", -ret);
+      return ret;
+    }
+
+  /* Write the map, the last partial block through the checkpoint buffer */
+
+  nfull = mapsize / dev->geo.blocksize;
+  if (nfull > 0)
+    {
+      ret = MTD_BWRITE(dev->mtd, mapblock, nfull,
+                       (FAR const uint8_t *)dev->smap);
+      if (ret != nfull)
+        {
+          goto errout;
+        }
+    }
+
+  if (mapsize > nfull * dev->geo.blocksize)
+    {
+      memset(dev->ckptbuf, CONFIG_SMARTFS_ERASEDSTATE, dev->geo.blocksize);
+      memcpy(dev->ckptbuf, (FAR const uint8_t *)dev->smap +
+             nfull * dev->geo.blocksize,
+             mapsize - nfull * dev->geo.blocksize);
+
+      ret = MTD_BWRITE(dev->mtd, mapblock + nfull, 1, dev->ckptbuf);
+      if (ret != 1)
+        {
+          goto errout;
+        }
+    }
+
+  /* Commit the checkpoint by writing its header */
+
+  memset(dev->ckptbuf, CONFIG_SMARTFS_ERASEDSTATE, dev->geo.blocksize);
+  header = (FAR struct smart_ckpt_header_s *)dev->ckptbuf;
+  memcpy(header->magic, SMART_CKPT_MAGIC, sizeof(header->magic));
+  header->version        = SMART_CKPT_VERSION;
+  header->sectorsize     = dev->sectorsize;
+  header->totalsectors   = dev->totalsectors;
+  header->neraseblocks   = dev->neraseblocks;
+  header->freesectors    = dev->freesectors;
+  header->releasesectors = dev->releasesectors;
+  header->crc            = crc32part((FAR const uint8_t *)dev->smap, mapsize,
+                                     crc32((FAR const uint8_t *)header,
+                                     offsetof(struct smart_ckpt_header_s,
+                                              crc)));
+
+  ret = MTD_BWRITE(dev->mtd, hdrblock, 1, dev->ckptbuf);
+  if (ret != 1)
+    {
+      goto errout;
+    }
+
+  memset(dev->ckptdirty, 0, (dev->neraseblocks + 7) >> 3);
+  dev->ckptndirty = 0;
+  dev->ckptvalid  = true;
+
+  finfo("Checkpoint written\n");
+  return OK;
+
+errout:
+  ferr("ERROR: Error %zd writing the checkpoint\n", ret);
+  return ret < 0 ? ret : -EIO;
+}
+
+/****************************************************************************
+ * Name: smart_ckpt_flush
+ *
+ * Description: Writes a new checkpoint if the device was modified since the
+ *              last one.
+ *
+ ****************************************************************************/
+
+static int smart_ckpt_flush(FAR struct smart_struct_s *dev)
+{
+  if (dev->formatstatus != SMART_FMT_STAT_FORMATTED ||
+      (dev->ckptvalid && dev->ckptndirty == 0))
+    {
+      return OK;
+    }
+
+  return smart_ckpt_write(dev);
+}
+#endif /* CONFIG_MTD_SMART_CHECKPOINT */
+
 /****************************************************************************
  * Name: smart_add_sector_to_cache
  *
@@ -1950,6 +2406,10 @@ static int smart_scan(FAR struct smart_struct_s *dev)
   uint16_t  seq2;
   uint16_t  seqwrap;
   struct    smart_sect_header_s header;
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  bool      replay = false;
+  uint16_t  phys0 = 0xffff;
+#endif
 #ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
   int       dupsector;
   uint16_t  duplogsector;
@@ -2032,6 +2492,20 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 
   totalsectors        = dev->totalsectors;
   dev->formatstatus   = SMART_FMT_STAT_NOFMT;
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* With a valid checkpoint, only the erase blocks modified since it was
+   * written need to be scanned.
+   */
+
+  if (smart_ckpt_load(dev) == OK)
+    {
+      phys0  = smart_ckpt_replay(dev);
+      replay = true;
+      goto scan;
+    }
+#endif
+
   dev->freesectors    = dev->availsectperblk * dev->geo.neraseblocks;
   dev->releasesectors = 0;
 
@@ -2073,12 +2547,24 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 
   /* Now scan the MTD device */
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+scan:
+#endif
+
   /* At first, set the loser sector as the invalid value */
 
   loser = totalsectors;
 
   for (sector = 0; sector < totalsectors; sector++)
     {
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+      if (replay && sector != phys0 &&
+          !ISSET_BITMAP(dev->ckptreplay, sector / dev->sectorsperblk))
+        {
+          continue;
+        }
+#endif
+
       finfo("Scan sector %d\n", sector);
 
       winner = sector;
@@ -2463,6 +2949,16 @@ static int smart_scan(FAR struct smart_struct_s *dev)
               ferr("ERROR: Error %d releasing duplicate sector\n", -ret);
               goto err_out;
             }
+
+          /* The loser was counted as committed, now it is released */
+
+          dev->releasesectors++;
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+          smart_add_count(dev, dev->releasecount,
+                          loser / dev->sectorsperblk, 1);
+#else
+          dev->releasecount[loser / dev->sectorsperblk]++;
+#endif
         }
 
       /* Test if this sector is loser of duplicate logical sector */
@@ -2539,7 +3035,7 @@ static int smart_scan(FAR struct smart_struct_s *dev)
               dev->mtdblkspersector * dev->geo.blocksize -
               SMART_WEAR_LEVEL_FORMAT_SIG);
 
-          smart_relocate_sector(dev, sector, newsector);
+          smart_relocate_sector(dev, sector, newsector, true);
 
           /* Update the free and release sector counts */
 
@@ -2573,6 +3069,11 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 
   smart_read_wearstatus(dev);
 #endif
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* Save the map just built, so that the next scan is a short one */
+
+  smart_ckpt_flush(dev);
+#endif
 
   finfo("SMART Scan\n");
   finfo("   Erase size:   %10d\n", dev->sectorsperblk * dev->sectorsize);
@@ -2715,6 +3216,7 @@ static void smart_erase_block_if_empty(FAR struct smart_struct_s *dev,
       dev->unusedsectors += freecount;
       dev->blockerases++;
 #endif
+      smart_ckpt_mark(dev, block);
       MTD_ERASE(dev->mtd, block, 1);
 
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
@@ -2980,7 +3482,8 @@ static int smart_relocate_static_data(FAR struct smart_struct_s *dev,
 
               /* Relocate the sector data */
 
-              if ((ret = smart_relocate_sector(dev, sector, newsector)) < 0)
+              ret = smart_relocate_sector(dev, sector, newsector, false);
+              if (ret < 0)
                 {
                   goto errout;
                 }
@@ -3154,7 +3657,11 @@ static inline int smart_llformat(FAR struct smart_struct_s *dev,
       return -EINVAL;
     }
 
-  /* Erase the MTD device */
+  /* Erase the MTD device.  This erases the checkpoint too. */
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  dev->ckptvalid = false;
+#endif
 
   ret = MTD_IOCTL(dev->mtd, MTDIOC_BULKERASE, 0);
   if (ret < 0)
@@ -3327,11 +3834,17 @@ static inline int smart_llformat(FAR struct smart_struct_s *dev,
  * Name: smart_relocate_sector
  *
  * Description:  Relocates the specified sector to the new sector location.
+ *               The old sector is only released if 'release' is set.  When
+ *               a whole erase block is relocated before it is erased, the
+ *               old copies are left alone: the new copies have a higher
+ *               sequence number and win over them in smart_scan() should
+ *               the erase not complete.
  *
  ****************************************************************************/
 
 static int smart_relocate_sector(FAR struct smart_struct_s *dev,
-                                 uint16_t oldsector, uint16_t newsector)
+                                 uint16_t oldsector, uint16_t newsector,
+                                 bool release)
 {
   size_t offset;
   FAR struct smart_sect_header_s *header;
@@ -3395,6 +3908,7 @@ static int smart_relocate_sector(FAR struct smart_struct_s *dev,
 
   /* Write the data to the new physical sector location */
 
+  smart_ckpt_mark(dev, newsector / dev->sectorsperblk);
   ret = MTD_BWRITE(dev->mtd, newsector * dev->mtdblkspersector,
                    dev->mtdblkspersector, (FAR uint8_t *) dev->rwbuffer);
   if (ret != dev->mtdblkspersector)
@@ -3413,6 +3927,7 @@ static int smart_relocate_sector(FAR struct smart_struct_s *dev,
 
   /* Write the data to the new physical sector location */
 
+  smart_ckpt_mark(dev, newsector / dev->sectorsperblk);
   ret = MTD_BWRITE(dev->mtd, newsector * dev->mtdblkspersector,
                    dev->mtdblkspersector, (FAR uint8_t *) dev->rwbuffer);
   if (ret != dev->mtdblkspersector)
@@ -3438,6 +3953,11 @@ static int smart_relocate_sector(FAR struct smart_struct_s *dev,
     }
 #endif /* CONFIG_MTD_SMART_ENABLE_CRC */
 
+  if (!release)
+    {
+      return OK;
+    }
+
   /* Release the old physical sector */
 
 #if CONFIG_SMARTFS_ERASEDSTATE == 0xff
@@ -3614,7 +4134,7 @@ static int smart_relocate_block(FAR struct smart_struct_s *dev,
 
           /* Relocate the sector data */
 
-          if ((ret = smart_relocate_sector(dev, x, newsector)) < 0)
+          if ((ret = smart_relocate_sector(dev, x, newsector, false)) < 0)
             {
               goto errout;
             }
@@ -3639,6 +4159,7 @@ static int smart_relocate_block(FAR struct smart_struct_s *dev,
 
   /* Now erase the erase block */
 
+  smart_ckpt_mark(dev, block);
   MTD_ERASE(dev->mtd, block, 1);
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
   dev->unusedsectors += freecount;
@@ -3983,6 +4504,7 @@ retry:
 
           if (1 == dev->availsectperblk)
             {
+              smart_ckpt_mark(dev, allocblock);
               MTD_ERASE(dev->mtd, allocblock, 1);
               physicalsector = i;
               dev->lastallocblock = allocblock;
@@ -4004,6 +4526,48 @@ retry:
   return physicalsector;
 }
 
+/****************************************************************************
+ * Name: smart_mostreleased
+ *
+ * Description:  Returns the erase block with the most released sectors, or
+ *               0xffff if no block has any.
+ *
+ ****************************************************************************/
+
+static uint16_t smart_mostreleased(FAR struct smart_struct_s *dev,
+                                   FAR uint16_t *releasemax)
+{
+  uint16_t collectblock = 0xffff;
+  uint16_t count;
+  int x;
+
+  *releasemax = 0;
+  for (x = 0; x < dev->neraseblocks; x++)
+    {
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+      /* Don't collect blocks that have been worn completely */
+
+      if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD)
+        {
+          continue;
+        }
+#endif
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+      count = smart_get_count(dev, dev->releasecount, x);
+#else
+      count = dev->releasecount[x];
+#endif
+      if (count > *releasemax)
+        {
+          *releasemax = count;
+          collectblock = x;
+        }
+    }
+
+  return collectblock;
+}
+
 /****************************************************************************
  * Name: smart_garbagecollect
  *
@@ -4018,11 +4582,7 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
   uint16_t collectblock;
   uint16_t releasemax;
   bool collect = TRUE;
-  int x;
   int ret;
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-  uint8_t count;
-#endif
 
   while (collect)
     {
@@ -4051,34 +4611,7 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
         {
           /* Find the block with the most released sectors */
 
-          collectblock = 0xffff;
-          releasemax = 0;
-          for (x = 0; x < dev->neraseblocks; x++)
-            {
-#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
-              /* Don't collect blocks that have been worn completely */
-
-              if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD)
-                {
-                  continue;
-                }
-#endif
-
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-              count = smart_get_count(dev, dev->releasecount, x);
-              if (count > releasemax)
-                {
-                  releasemax = count;
-                  collectblock = x;
-                }
-#else
-              if (dev->releasecount[x] > releasemax)
-                {
-                  releasemax = dev->releasecount[x];
-                  collectblock = x;
-                }
-#endif
-            }
+          collectblock = smart_mostreleased(dev, &releasemax);
 
 #if 0
           releasemax = smart_get_count(dev, dev->releasecount, collectblock);
@@ -4136,6 +4669,55 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: smart_idlecollect
+ *
+ * Description:  Garbage collect up to 'maxblocks' erase blocks ahead of
+ *               need, while the file system is idle.  Only blocks in which
+ *               at least half of the sectors are released are collected,
+ *               so that little live data is moved for each block that
+ *               becomes free.  A block must also be left for the
+ *               collection that allocations may still need.
+ *
+ * Returned Value:
+ *   The number of blocks collected, or a negated errno value.
+ *
+ ****************************************************************************/
+
+static int smart_idlecollect(FAR struct smart_struct_s *dev,
+                             unsigned long maxblocks)
+{
+  uint16_t collectblock;
+  uint16_t releasemax;
+  int ncollected = 0;
+  int ret;
+
+  while (ncollected < maxblocks)
+    {
+      collectblock = smart_mostreleased(dev, &releasemax);
+      if (collectblock == 0xffff ||
+          releasemax < (dev->availsectperblk + 1) / 2 ||
+          dev->freesectors < dev->availsectperblk - releasemax +
+                             dev->sectorsperblk + 4)
+        {
+          break;
+        }
+
+      finfo("Idle collecting block %d, released=%d\n",
+            collectblock, releasemax);
+
+      ret = smart_relocate_block(dev, collectblock);
+      if (ret != OK)
+        {
+          return ret;
+        }
+
+      ncollected++;
+    }
+
+  return ncollected;
+}
+
 /****************************************************************************
  * Name: smart_write_wearstatus
  *
@@ -4471,6 +5053,7 @@ static int smart_write_alloc_sector(FAR struct smart_struct_s *dev,
 
 #ifndef CONFIG_MTD_SMART_ENABLE_CRC
   finfo("Write MTD block %d\n", physical * dev->mtdblkspersector);
+  smart_ckpt_mark(dev, physical / dev->sectorsperblk);
   ret = MTD_BWRITE(dev->mtd, physical * dev->mtdblkspersector, 1,
       (FAR uint8_t *) dev->rwbuffer);
   if (ret != 1)
@@ -4828,6 +5411,7 @@ static int smart_writesector(FAR struct smart_struct_s *dev,
     {
       /* Write the entire sector to the new physical location, uncommitted. */
 
+      smart_ckpt_mark(dev, physsector / dev->sectorsperblk);
       ret = MTD_BWRITE(dev->mtd, physsector * dev->mtdblkspersector,
               dev->mtdblkspersector, (FAR uint8_t *) dev->rwbuffer);
       if (ret != dev->mtdblkspersector)
@@ -4915,6 +5499,7 @@ static int smart_writesector(FAR struct smart_struct_s *dev,
 #ifdef CONFIG_MTD_SMART_ENABLE_CRC
       /* Write the entire sector to FLASH when CRC enabled */
 
+      smart_ckpt_mark(dev, physsector / dev->sectorsperblk);
       ret = MTD_BWRITE(dev->mtd, physsector * dev->mtdblkspersector,
               dev->mtdblkspersector, (FAR uint8_t *) dev->rwbuffer);
       if (ret != dev->mtdblkspersector)
@@ -5544,6 +6129,22 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       ret = smart_freesector(dev, arg);
       goto ok_out;
 
+    case BIOC_IDLECOLLECT:
+
+      /* Garbage collect ahead of need */
+
+      ret = smart_idlecollect(dev, arg);
+      goto ok_out;
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+    case BIOC_FLUSH:
+
+      /* Checkpoint the sector map */
+
+      ret = smart_ckpt_flush(dev);
+      goto ok_out;
+#endif
+
     case BIOC_WRITESECT:
 
       /* Write to the sector */
@@ -6011,7 +6612,7 @@ static int smart_fsck_directory(FAR struct smart_struct_s *dev,
 
       memcpy(dev->rwbuffer, rwbuffer, dev->sectorsize);
 
-      ret = smart_relocate_sector(dev, physsector, newsector);
+      ret = smart_relocate_sector(dev, physsector, newsector, true);
       if (ret < 0)
         {
           ret = -EIO;
@@ -6185,6 +6786,31 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd,
           goto errout;
         }
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+      /* Reserve the erase blocks at the end of the device for the
+       * checkpoint, together with the journal bitmaps.
+       */
+
+      if (dev->geo.neraseblocks > CONFIG_MTD_SMART_CHECKPOINT_NBLOCKS)
+        {
+          dev->geo.neraseblocks -= CONFIG_MTD_SMART_CHECKPOINT_NBLOCKS;
+          dev->ckptblock         = dev->geo.neraseblocks;
+          dev->ckptbuf           = (FAR uint8_t *)
+            smart_malloc(dev, dev->geo.blocksize +
+                         2 * ((dev->geo.neraseblocks + 7) >> 3),
+                         "Checkpoint");
+          if (dev->ckptbuf == NULL)
+            {
+              ret = -ENOMEM;
+              goto errout;
+            }
+
+          dev->ckptdirty  = dev->ckptbuf + dev->geo.blocksize;
+          dev->ckptreplay = dev->ckptdirty +
+                            ((dev->geo.neraseblocks + 7) >> 3);
+        }
+#endif
+
       /* Set the sector size to the default for now */
 
       dev->sectorsize = 0;
@@ -6309,6 +6935,9 @@ errout:
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
   smart_free(dev, dev->erasecounts);
 #endif
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  smart_free(dev, dev->ckptbuf);
+#endif
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
   if (rootdirdev)
     {
@@ -39,6 +39,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/signal.h>
 #include <nuttx/fs/ioctl.h>
@@ -80,8 +81,11 @@
 #define W25_FRDD                   0x3b    /* Fast read, dual output         */
 #define W25_PP                     0x02    /* Program page                   */
 #define W25_BE                     0xd8    /* Block Erase (64KB)             */
+#define W25_BE32                   0x52    /* Block Erase (32KB), not W25X   */
 #define W25_SE                     0x20    /* Sector erase (4KB)             */
 #define W25_CE                     0xc7    /* Chip erase                     */
+#define W25_EPS                    0x75    /* Erase suspend, not W25X        */
+#define W25_EPR                    0x7a    /* Erase resume, not W25X         */
 #define W25_PD                     0xb9    /* Power down                     */
 #define W25_PURDID                 0xab    /* Release PD, Device ID          */
 #define W25_RDMFID                 0x90    /* Read Manufacturer / Device     */
@@ -183,6 +187,18 @@
 #define W25_SECTOR_SIZE            (1 << 12) /* Sector size 1 << 12 = 4Kb */
 #define W25_PAGE_SHIFT             8         /* Sector size 1 << 8 = 256b */
 #define W25_PAGE_SIZE              (1 << 8)  /* Sector size 1 << 8 = 256b */
+#define W25_BLOCK32_SHIFT          15        /* Block size 1 << 15 = 32Kb */
+#define W25_BLOCK64_SHIFT          16        /* Block size 1 << 16 = 64Kb */
+
+/* The W25X parts have neither the 32Kb block erase nor erase suspend */
+
+#define W25_IS_W25X(p)             ((p)->memory == W25X_JEDEC_MEMORY_TYPE)
+
+/* Time a resumed erase runs before it may be suspended again, in
+ * microseconds.  Without it, back-to-back reads could stall the erase.
+ */
+
+#define W25_RESUME_DELAY           100
 
 #ifdef CONFIG_W25_SECTOR512                  /* Simulate a 512 byte sector */
 #  define W25_SECTOR512_SHIFT      9         /* Sector size 1 << 9 = 512 bytes */
@@ -224,6 +240,7 @@ struct w25_dev_s
   struct mtd_dev_s      mtd;         /* MTD interface */
   FAR struct spi_dev_s *spi;         /* Saved SPI interface instance */
   uint16_t              nsectors;    /* Number of erase sectors */
+  uint8_t               memory;      /* JEDEC memory type */
   uint8_t               prev_instr;  /* Previous instruction given to W25 device */
 
 #if defined(CONFIG_W25_SECTOR512) && !defined(CONFIG_W25_READONLY)
@@ -245,14 +262,19 @@ static inline int w25_readid(FAR struct w25_dev_s *priv);
 #ifndef CONFIG_W25_READONLY
 static void w25_unprotect(FAR struct w25_dev_s *priv);
 #endif
+static uint8_t w25_rdsr(FAR struct w25_dev_s *priv);
 static uint8_t w25_waitwritecomplete(FAR struct w25_dev_s *priv);
+#ifdef CONFIG_W25_ERASE_SUSPEND
+static uint8_t w25_erasesuspend(FAR struct w25_dev_s *priv);
+static void w25_eraseresume(FAR struct w25_dev_s *priv, uint8_t instr);
+#endif
 static inline void w25_wren(FAR struct w25_dev_s *priv);
 static inline void w25_wrdi(FAR struct w25_dev_s *priv);
 static bool w25_is_erased(struct w25_dev_s *priv,
                           off_t address,
                           off_t size);
 static void w25_sectorerase(FAR struct w25_dev_s *priv,
-                            off_t offset);
+                            off_t sector, uint8_t instr);
 static inline int w25_chiperase(FAR struct w25_dev_s *priv);
 static void w25_byteread(FAR struct w25_dev_s *priv,
                          FAR uint8_t *buffer,
@@ -407,6 +429,8 @@ static inline int w25_readid(struct w25_dev_s *priv)
        * W25Q80BV
        */
 
+      priv->memory = memory;
+
       if (capacity == W25_JEDEC_CAPACITY_8MBIT)
         {
            priv->nsectors = NSECTORS_8MBIT;
@@ -508,6 +532,34 @@ static void w25_unprotect(FAR struct w25_dev_s *priv)
 }
 #endif
 
+/****************************************************************************
+ * Name: w25_rdsr
+ ****************************************************************************/
+
+static uint8_t w25_rdsr(FAR struct w25_dev_s *priv)
+{
+  uint8_t status;
+
+  /* Select this FLASH part */
+
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), true);
+
+  /* Send "Read Status Register (RDSR)" command */
+
+  SPI_SEND(priv->spi, W25_RDSR);
+
+  /* Send a dummy byte to generate the clock needed to shift out the
+   * status
+   */
+
+  status = SPI_SEND(priv->spi, W25_DUMMY);
+
+  /* Deselect the FLASH */
+
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+  return status;
+}
+
 /****************************************************************************
  * Name: w25_waitwritecomplete
  ****************************************************************************/
@@ -525,23 +577,7 @@ static uint8_t w25_waitwritecomplete(struct w25_dev_s *priv)
 
   do
     {
-      /* Select this FLASH part */
-
-      SPI_SELECT(priv->spi, SPIDEV_FLASH(0), true);
-
-      /* Send "Read Status Register (RDSR)" command */
-
-      SPI_SEND(priv->spi, W25_RDSR);
-
-      /* Send a dummy byte to generate the clock needed to shift out the
-       * status
-       */
-
-      status = SPI_SEND(priv->spi, W25_DUMMY);
-
-      /* Deselect the FLASH */
-
-      SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+      status = w25_rdsr(priv);
 
       /* Given that writing could take up to few tens of milliseconds, and
        * erasing could take more.  The following short delay in the "busy"
@@ -562,6 +598,65 @@ static uint8_t w25_waitwritecomplete(struct w25_dev_s *priv)
   return status;
 }
 
+/****************************************************************************
+ * Name: w25_erasesuspend
+ *
+ * Description:
+ *   Suspend the sector or block erase in progress, if any, so that the
+ *   array can be read.  The SPI bus must stay locked until the erase is
+ *   resumed by w25_eraseresume(), so that nobody else sees the suspended
+ *   state.
+ *
+ * Returned Value:
+ *   The instruction of the suspended erase, or zero if none was suspended.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_W25_ERASE_SUSPEND
+static uint8_t w25_erasesuspend(FAR struct w25_dev_s *priv)
+{
+  uint8_t instr = priv->prev_instr;
+
+  if (W25_IS_W25X(priv) ||
+      (instr != W25_SE && instr != W25_BE32 && instr != W25_BE) ||
+      (w25_rdsr(priv) & W25_SR_BUSY) == 0)
+    {
+      return 0;
+    }
+
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), true);
+  SPI_SEND(priv->spi, W25_EPS);
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+
+  /* The erase is suspended within some tens of microseconds.  BUSY is
+   * also cleared if the erase was completed in the meantime, then the
+   * resume has no effect.
+   */
+
+  priv->prev_instr = W25_EPS;
+  while ((w25_rdsr(priv) & W25_SR_BUSY) != 0);
+
+  finfo("Suspended %02x\n", instr);
+  return instr;
+}
+
+/****************************************************************************
+ * Name: w25_eraseresume
+ ****************************************************************************/
+
+static void w25_eraseresume(FAR struct w25_dev_s *priv, uint8_t instr)
+{
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), true);
+  SPI_SEND(priv->spi, W25_EPR);
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+
+  /* Later instructions have to wait for the erase again */
+
+  priv->prev_instr = instr;
+  up_udelay(W25_RESUME_DELAY);
+}
+#endif
+
 /****************************************************************************
  * Name:  w25_wren
  ****************************************************************************/
@@ -651,17 +746,27 @@ static bool w25_is_erased(struct w25_dev_s *priv, off_t address, off_t size)
 
 /****************************************************************************
  * Name:  w25_sectorerase
+ *
+ * Description:
+ *   Erase the 4Kb sector, or the 32Kb or 64Kb block, starting at 'sector'
+ *   with 'instr', one of W25_SE, W25_BE32 or W25_BE.
+ *
  ****************************************************************************/
 
-static void w25_sectorerase(struct w25_dev_s *priv, off_t sector)
+static void w25_sectorerase(struct w25_dev_s *priv, off_t sector,
+                            uint8_t instr)
 {
   off_t address = sector << W25_SECTOR_SHIFT;
+  off_t size;
+
+  finfo("sector: %08lx instr: %02x\n", (long)sector, instr);
 
-  finfo("sector: %08lx\n", (long)sector);
+  size = instr == W25_BE   ? (1 << W25_BLOCK64_SHIFT) :
+         instr == W25_BE32 ? (1 << W25_BLOCK32_SHIFT) : W25_SECTOR_SIZE;
 
   /* Check if sector is already erased. */
 
-  if (w25_is_erased(priv, address, W25_SECTOR_SIZE))
+  if (w25_is_erased(priv, address, size))
     {
       /* Sector already in erased state, so skip erase. */
 
@@ -680,10 +785,10 @@ static void w25_sectorerase(struct w25_dev_s *priv, off_t sector)
 
   SPI_SELECT(priv->spi, SPIDEV_FLASH(0), true);
 
-  /* Send the "Sector Erase (SE)" instruction */
+  /* Send the "Sector Erase (SE)" or "Block Erase (BE)" instruction */
 
-  SPI_SEND(priv->spi, W25_SE);
-  priv->prev_instr = W25_SE;
+  SPI_SEND(priv->spi, instr);
+  priv->prev_instr = instr;
 
   /* Send the sector address high byte first. Only the most significant bits
    * (those corresponding to the sector) have any meaning.
@@ -737,10 +842,19 @@ static inline int w25_chiperase(struct w25_dev_s *priv)
 static void w25_byteread(FAR struct w25_dev_s *priv, FAR uint8_t *buffer,
                            off_t address, size_t nbytes)
 {
+#ifdef CONFIG_W25_ERASE_SUSPEND
+  uint8_t suspended;
+#endif
   uint8_t status;
 
   finfo("address: %08lx nbytes: %d\n", (long)address, (int)nbytes);
 
+#ifdef CONFIG_W25_ERASE_SUSPEND
+  /* Do not wait for an erase, suspend it during the read */
+
+  suspended = w25_erasesuspend(priv);
+#endif
+
   /* Wait for any preceding write or erase operation to complete. */
 
   status = w25_waitwritecomplete(priv);
@@ -783,6 +897,13 @@ static void w25_byteread(FAR struct w25_dev_s *priv, FAR uint8_t *buffer,
   /* Deselect the FLASH */
 
   SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+
+#ifdef CONFIG_W25_ERASE_SUSPEND
+  if (suspended != 0)
+    {
+      w25_eraseresume(priv, suspended);
+    }
+#endif
 }
 
 /****************************************************************************
@@ -1003,7 +1124,7 @@ static void w25_cacheerase(struct w25_dev_s *priv, off_t sector)
       off_t esectno  = sector >> (W25_SECTOR_SHIFT - W25_SECTOR512_SHIFT);
       finfo("sector: %ld esectno: %d\n", sector, esectno);
 
-      w25_sectorerase(priv, esectno);
+      w25_sectorerase(priv, esectno, W25_SE);
       SET_ERASED(priv);
     }
 
@@ -1048,7 +1169,7 @@ static void w25_cachewrite(FAR struct w25_dev_s *priv,
                            (W25_SECTOR_SHIFT - W25_SECTOR512_SHIFT);
           finfo("sector: %ld esectno: %d\n", sector, esectno);
 
-          w25_sectorerase(priv, esectno);
+          w25_sectorerase(priv, esectno, W25_SE);
           SET_ERASED(priv);
         }
 
@@ -1082,6 +1203,10 @@ static int w25_erase(FAR struct mtd_dev_s *dev,
 #else
   FAR struct w25_dev_s *priv = (FAR struct w25_dev_s *)dev;
   size_t blocksleft = nblocks;
+#ifndef CONFIG_W25_SECTOR512
+  size_t count;
+  uint8_t instr;
+#endif
 
   finfo("startblock: %08lx nblocks: %d\n", (long)startblock, (int)nblocks);
 
@@ -1089,22 +1214,54 @@ static int w25_erase(FAR struct mtd_dev_s *dev,
 
   w25_lock(priv->spi);
 
+#ifdef CONFIG_W25_SECTOR512
   while (blocksleft-- > 0)
     {
       /* Erase each sector */
 
-#ifdef CONFIG_W25_SECTOR512
       w25_cacheerase(priv, startblock);
-#else
-      w25_sectorerase(priv, startblock);
-#endif
       startblock++;
     }
 
-#ifdef CONFIG_W25_SECTOR512
   /* Flush the last erase block left in the cache */
 
   w25_cacheflush(priv);
+#else
+  /* Erasing the whole part is much faster with a single chip erase */
+
+  if (startblock == 0 && nblocks == priv->nsectors)
+    {
+      w25_chiperase(priv);
+      blocksleft = 0;
+    }
+
+  /* Otherwise erase the range with the largest erase unit that is aligned
+   * and fits in what is left of it, a 64Kb or 32Kb block erase takes far
+   * less time than erasing its 4Kb sectors one by one.
+   */
+
+  while (blocksleft > 0)
+    {
+      count = 1 << (W25_BLOCK64_SHIFT - W25_SECTOR_SHIFT);
+      instr = W25_BE;
+
+      if ((startblock & (count - 1)) != 0 || blocksleft < count)
+        {
+          count = 1 << (W25_BLOCK32_SHIFT - W25_SECTOR_SHIFT);
+          instr = W25_BE32;
+
+          if (W25_IS_W25X(priv) ||
+              (startblock & (count - 1)) != 0 || blocksleft < count)
+            {
+              count = 1;
+              instr = W25_SE;
+            }
+        }
+
+      w25_sectorerase(priv, startblock, instr);
+      startblock += count;
+      blocksleft -= count;
+    }
 #endif
 
   w25_unlock(priv->spi);
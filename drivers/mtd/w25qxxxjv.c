@@ -390,7 +390,7 @@ static int  w25qxxxjv_unprotect(FAR struct w25qxxxjv_dev_s *priv,
 static bool w25qxxxjv_isprotected(FAR struct w25qxxxjv_dev_s *priv,
               uint8_t status, off_t address);
 static int  w25qxxxjv_erase_sector(FAR struct w25qxxxjv_dev_s *priv,
-                                   off_t offset);
+                                   off_t offset, uint8_t cmd);
 static int  w25qxxxjv_erase_chip(FAR struct w25qxxxjv_dev_s *priv);
 static int  w25qxxxjv_read_byte(FAR struct w25qxxxjv_dev_s *priv,
                                 FAR uint8_t *buffer,
@@ -937,15 +937,21 @@ static bool w25qxxxjv_isprotected(FAR struct w25qxxxjv_dev_s *priv,
 
 /****************************************************************************
  * Name:  w25qxxxjv_erase_sector
+ *
+ * Description:
+ *   Erase the sector, or the 32 or 64 kB block, starting at 'sector' with
+ *   'cmd', one of the W25QXXXJV_SECTOR_ERASE or W25QXXXJV_BLOCK_ERASE_32K/
+ *   64K commands.
+ *
  ****************************************************************************/
 
 static int w25qxxxjv_erase_sector(FAR struct w25qxxxjv_dev_s *priv,
-                                  off_t sector)
+                                  off_t sector, uint8_t cmd)
 {
   off_t address;
   uint8_t status;
 
-  finfo("sector: %08" PRIxOFF "\n", sector);
+  finfo("sector: %08" PRIxOFF " cmd: %02x\n", sector, cmd);
 
   /* Get the address associated with the sector */
 
@@ -972,16 +978,26 @@ static int w25qxxxjv_erase_sector(FAR struct w25qxxxjv_dev_s *priv,
       return -EACCES;
     }
 
-  /* Send the sector erase command */
+  /* Send the sector or block erase command */
 
   w25qxxxjv_write_enable(priv);
-  w25qxxxjv_command_address(priv->qspi,
-                            W25QXXXJV_SECTOR_ERASE,
-                            address, priv->addresslen);
+  w25qxxxjv_command_address(priv->qspi, cmd, address, priv->addresslen);
 
-  /* Wait for erasure to finish */
+  /* Wait for erasure to finish.  A block erase takes hundreds of
+   * milliseconds, do not spin during all of that time.
+   */
 
-  while ((w25qxxxjv_read_status(priv) & STATUS_BUSY_MASK) != 0);
+  if (cmd == W25QXXXJV_SECTOR_ERASE)
+    {
+      while ((w25qxxxjv_read_status(priv) & STATUS_BUSY_MASK) != 0);
+    }
+  else
+    {
+      while ((w25qxxxjv_read_status(priv) & STATUS_BUSY_MASK) != 0)
+        {
+          nxsig_usleep(1000);
+        }
+    }
 
   return OK;
 }
@@ -1248,7 +1264,8 @@ static void w25qxxxjv_erase_cache(FAR struct w25qxxxjv_dev_s *priv,
           (priv->sectorshift - W25QXXXJV_SECTOR512_SHIFT);
       finfo("sector: %" PRIdOFF " esectno: %" PRIdOFF "\n", sector, esectno);
 
-      DEBUGVERIFY(w25qxxxjv_erase_sector(priv, esectno));
+      DEBUGVERIFY(w25qxxxjv_erase_sector(priv, esectno,
+                                         W25QXXXJV_SECTOR_ERASE));
       SET_ERASED(priv);
     }
 
@@ -1294,7 +1311,8 @@ static int w25qxxxjv_write_cache(FAR struct w25qxxxjv_dev_s *priv,
           finfo("sector: %" PRIdOFF " esectno: %" PRIdOFF "\n",
                 sector, esectno);
 
-          ret = w25qxxxjv_erase_sector(priv, esectno);
+          ret = w25qxxxjv_erase_sector(priv, esectno,
+                                       W25QXXXJV_SECTOR_ERASE);
           if (ret < 0)
             {
               ferr("ERROR: w25qxxxjv_erase_sector failed: %d\n", ret);
@@ -1332,6 +1350,9 @@ static int w25qxxxjv_erase(FAR struct mtd_dev_s *dev, off_t startblock,
   size_t blocksleft = nblocks;
 #ifdef CONFIG_W25QXXXJV_SECTOR512
   int ret;
+#else
+  size_t count;
+  uint8_t cmd;
 #endif
 
   finfo("startblock: %08" PRIxOFF " nblocks: %d\n",
@@ -1341,17 +1362,51 @@ static int w25qxxxjv_erase(FAR struct mtd_dev_s *dev, off_t startblock,
 
   w25qxxxjv_lock(priv->qspi);
 
+#ifdef CONFIG_W25QXXXJV_SECTOR512
   while (blocksleft-- > 0)
     {
       /* Erase each sector */
 
-#ifdef CONFIG_W25QXXXJV_SECTOR512
       w25qxxxjv_erase_cache(priv, startblock);
-#else
-      w25qxxxjv_erase_sector(priv, startblock);
-#endif
       startblock++;
     }
+#else
+  /* The whole part is erased at once with a chip erase, unless it is made
+   * of several dies or some of it is protected.
+   */
+
+  if (startblock == 0 && nblocks == priv->nsectors &&
+      priv->numofdies == 0 && w25qxxxjv_erase_chip(priv) == OK)
+    {
+      blocksleft = 0;
+    }
+
+  /* Otherwise erase the range with the largest erase unit that is aligned
+   * and fits in what is left of it.
+   */
+
+  while (blocksleft > 0)
+    {
+      count = (64 * 1024) >> priv->sectorshift;
+      cmd   = W25QXXXJV_BLOCK_ERASE_64K;
+
+      if ((startblock & (count - 1)) != 0 || blocksleft < count)
+        {
+          count = (32 * 1024) >> priv->sectorshift;
+          cmd   = W25QXXXJV_BLOCK_ERASE_32K;
+
+          if ((startblock & (count - 1)) != 0 || blocksleft < count)
+            {
+              count = 1;
+              cmd   = W25QXXXJV_SECTOR_ERASE;
+            }
+        }
+
+      w25qxxxjv_erase_sector(priv, startblock, cmd);
+      startblock += count;
+      blocksleft -= count;
+    }
+#endif
 
 #ifdef CONFIG_W25QXXXJV_SECTOR512
   /* Flush the last erase block left in the cache */
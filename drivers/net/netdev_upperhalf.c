@@ -440,6 +440,15 @@ static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
       pkt_input(dev);
 #endif
 
+#ifdef CONFIG_NETDEV_GRO
+      /* Merge in-order TCP segments, the held one is passed on below */
+
+      if (netdev_gro_receive(dev, eth_input))
+        {
+          continue;
+        }
+#endif
+
       switch (dev->d_lltype)
         {
 #ifdef CONFIG_NET_LOOPBACK
@@ -467,6 +476,10 @@ static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
           break;
         }
     }
+
+#ifdef CONFIG_NETDEV_GRO
+  netdev_gro_flush(dev, eth_input);
+#endif
 }
 
 /****************************************************************************
@@ -49,6 +49,13 @@
 #  error "Maximum channel number exceeds. "
 #endif
 
+/* The mode flags tested inline by sched_note.h:  all clear if the
+ * instrumentation is disabled.
+ */
+
+#define NOTE_ACTIVE(flag) \
+  (((flag) & NOTE_FILTER_MODE_FLAG_ENABLE) != 0 ? (flag) : 0)
+
 #define note_add(drv, note, notelen)                                         \
   ((drv)->ops->add(drv, note, notelen))
 #define note_start(drv, tcb)                                                 \
@@ -187,6 +194,15 @@ static struct note_taskname_s g_note_taskname;
 static spinlock_t g_note_lock;
 #endif
 
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_FILTER
+volatile unsigned int g_note_active =
+  NOTE_ACTIVE(CONFIG_SCHED_INSTRUMENTATION_FILTER_DEFAULT_MODE);
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -731,7 +747,7 @@ void sched_note_stop(FAR struct tcb_s *tcb)
 }
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SWITCH
-void sched_note_suspend(FAR struct tcb_s *tcb)
+void (sched_note_suspend)(FAR struct tcb_s *tcb)
 {
   struct note_suspend_s note;
   FAR struct note_driver_s **driver;
@@ -770,7 +786,7 @@ void sched_note_suspend(FAR struct tcb_s *tcb)
     }
 }
 
-void sched_note_resume(FAR struct tcb_s *tcb)
+void (sched_note_resume)(FAR struct tcb_s *tcb)
 {
   struct note_resume_s note;
   FAR struct note_driver_s **driver;
@@ -1045,7 +1061,7 @@ void sched_note_cpu_resumed(FAR struct tcb_s *tcb)
 #endif
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION_PREEMPTION
-void sched_note_premption(FAR struct tcb_s *tcb, bool locked)
+void (sched_note_premption)(FAR struct tcb_s *tcb, bool locked)
 {
   struct note_preempt_s note;
   FAR struct note_driver_s **driver;
@@ -1087,7 +1103,7 @@ void sched_note_premption(FAR struct tcb_s *tcb, bool locked)
 #endif
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION_CSECTION
-void sched_note_csection(FAR struct tcb_s *tcb, bool enter)
+void (sched_note_csection)(FAR struct tcb_s *tcb, bool enter)
 {
   struct note_csection_s note;
   FAR struct note_driver_s **driver;
@@ -1146,9 +1162,9 @@ void sched_note_csection(FAR struct tcb_s *tcb, bool enter)
  ****************************************************************************/
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
-void sched_note_spinlock(FAR struct tcb_s *tcb,
-                         FAR volatile spinlock_t *spinlock,
-                         int type)
+void (sched_note_spinlock)(FAR struct tcb_s *tcb,
+                           FAR volatile spinlock_t *spinlock,
+                           int type)
 {
   struct note_spinlock_s note;
   FAR struct note_driver_s **driver;
@@ -1190,7 +1206,7 @@ void sched_note_spinlock(FAR struct tcb_s *tcb,
 #endif
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SYSCALL
-void sched_note_syscall_enter(int nr, int argc, ...)
+void (sched_note_syscall_enter)(int nr, int argc, ...)
 {
   struct note_syscall_enter_s note;
   FAR struct note_driver_s **driver;
@@ -1265,7 +1281,7 @@ void sched_note_syscall_enter(int nr, int argc, ...)
     va_end(ap);
 }
 
-void sched_note_syscall_leave(int nr, uintptr_t result)
+void (sched_note_syscall_leave)(int nr, uintptr_t result)
 {
   struct note_syscall_leave_s note;
   FAR struct note_driver_s **driver;
@@ -1311,7 +1327,7 @@ void sched_note_syscall_leave(int nr, uintptr_t result)
 #endif
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION_IRQHANDLER
-void sched_note_irqhandler(int irq, FAR void *handler, bool enter)
+void (sched_note_irqhandler)(int irq, FAR void *handler, bool enter)
 {
   struct note_irqhandler_s note;
   FAR struct note_driver_s **driver;
@@ -1353,7 +1369,7 @@ void sched_note_irqhandler(int irq, FAR void *handler, bool enter)
 #endif
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION_DUMP
-void sched_note_string_ip(uint32_t tag, uintptr_t ip, FAR const char *buf)
+void (sched_note_string_ip)(uint32_t tag, uintptr_t ip, FAR const char *buf)
 {
   FAR struct note_string_s *note;
   uint8_t data[255];
@@ -1403,8 +1419,8 @@ void sched_note_string_ip(uint32_t tag, uintptr_t ip, FAR const char *buf)
     }
 }
 
-void sched_note_dump_ip(uint32_t tag, uintptr_t ip, uint8_t event,
-                        FAR const void *buf, size_t len)
+void (sched_note_dump_ip)(uint32_t tag, uintptr_t ip, uint8_t event,
+                          FAR const void *buf, size_t len)
 {
   FAR struct note_binary_s *note;
   FAR struct note_driver_s **driver;
@@ -1455,8 +1471,8 @@ void sched_note_dump_ip(uint32_t tag, uintptr_t ip, uint8_t event,
     }
 }
 
-void sched_note_vprintf_ip(uint32_t tag, uintptr_t ip,
-                           FAR const char *fmt, va_list va)
+void (sched_note_vprintf_ip)(uint32_t tag, uintptr_t ip,
+                             FAR const char *fmt, va_list va)
 {
   FAR struct note_string_s *note;
   uint8_t data[255];
@@ -1509,8 +1525,8 @@ void sched_note_vprintf_ip(uint32_t tag, uintptr_t ip,
     }
 }
 
-void sched_note_vbprintf_ip(uint32_t tag, uintptr_t ip, uint8_t event,
-                            FAR const char *fmt, va_list va)
+void (sched_note_vbprintf_ip)(uint32_t tag, uintptr_t ip, uint8_t event,
+                              FAR const char *fmt, va_list va)
 {
   FAR struct note_binary_s *note;
   FAR struct note_driver_s **driver;
@@ -1728,8 +1744,8 @@ void sched_note_vbprintf_ip(uint32_t tag, uintptr_t ip, uint8_t event,
     }
 }
 
-void sched_note_printf_ip(uint32_t tag, uintptr_t ip,
-                          FAR const char *fmt, ...)
+void (sched_note_printf_ip)(uint32_t tag, uintptr_t ip,
+                            FAR const char *fmt, ...)
 {
   va_list va;
   va_start(va, fmt);
@@ -1737,8 +1753,8 @@ void sched_note_printf_ip(uint32_t tag, uintptr_t ip,
   va_end(va);
 }
 
-void sched_note_bprintf_ip(uint32_t tag, uintptr_t ip, uint8_t event,
-                           FAR const char *fmt, ...)
+void (sched_note_bprintf_ip)(uint32_t tag, uintptr_t ip, uint8_t event,
+                             FAR const char *fmt, ...)
 {
   va_list va;
   va_start(va, fmt);
@@ -1784,6 +1800,7 @@ void sched_note_filter_mode(FAR struct note_filter_mode_s *oldm,
   if (newm != NULL)
     {
       g_note_filter.mode = *newm;
+      g_note_active = NOTE_ACTIVE(newm->flag);
     }
 
   spin_unlock_irqrestore_wo_note(&g_note_lock, irq_mask);
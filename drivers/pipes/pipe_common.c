@@ -27,6 +27,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/ioctl.h>
+#include <sys/param.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
@@ -78,6 +79,400 @@ static void pipecommon_wakeup(FAR sem_t *sem)
     }
 }
 
+/****************************************************************************
+ * Name: pipecommon_waitdata
+ *
+ * Description:
+ *   Wait for data in the pipe, with d_bflock held.
+ *
+ * Returned Value:
+ *   1 if there is data, with d_bflock still held; otherwise, with d_bflock
+ *   released, zero at the end of file or a negated errno value.
+ *
+ ****************************************************************************/
+
+static int pipecommon_waitdata(FAR struct file *filep,
+                               FAR struct pipe_dev_s *dev)
+{
+  int ret;
+
+  while (circbuf_is_empty(&dev->d_buffer))
+    {
+      /* If there are no writers on the pipe, then return end of file */
+
+      if (dev->d_nwriters <= 0)
+        {
+          nxmutex_unlock(&dev->d_bflock);
+          return 0;
+        }
+
+      /* If O_NONBLOCK was set, then return EGAIN */
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          nxmutex_unlock(&dev->d_bflock);
+          return -EAGAIN;
+        }
+
+      /* Otherwise, wait for something to be written to the pipe */
+
+      nxmutex_unlock(&dev->d_bflock);
+      ret = nxsem_wait(&dev->d_rdsem);
+
+      if (ret < 0 || (ret = nxmutex_lock(&dev->d_bflock)) < 0)
+        {
+          /* May fail because a signal was received or if the task was
+           * canceled.
+           */
+
+          return ret;
+        }
+    }
+
+  return 1;
+}
+
+/****************************************************************************
+ * Name: pipecommon_readdone
+ *
+ * Description:
+ *   Notify the writers that data was removed from the pipe.
+ *
+ ****************************************************************************/
+
+static void pipecommon_readdone(FAR struct pipe_dev_s *dev)
+{
+  /* Notify all poll/select waiters that they can write to the
+   * FIFO when buffer can accept more than d_polloutthrd bytes.
+   */
+
+  if (circbuf_used(&dev->d_buffer) <= (dev->d_bufsize - dev->d_polloutthrd))
+    {
+      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLOUT);
+    }
+
+  /* Notify all waiting writers that bytes have been removed from the
+   * buffer.
+   */
+
+  pipecommon_wakeup(&dev->d_wrsem);
+}
+
+/****************************************************************************
+ * Name: pipecommon_writedone
+ *
+ * Description:
+ *   Notify the readers that data was added to the pipe.
+ *
+ ****************************************************************************/
+
+static void pipecommon_writedone(FAR struct pipe_dev_s *dev)
+{
+  /* Notify all poll/select waiters that they can read from the FIFO when
+   * buffer used exceeds poll threshold.
+   */
+
+  if (circbuf_used(&dev->d_buffer) > dev->d_pollinthrd)
+    {
+      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLIN);
+    }
+
+  /* Notify all of the waiting readers that more data is available */
+
+  pipecommon_wakeup(&dev->d_rdsem);
+}
+
+/****************************************************************************
+ * Name: pipecommon_dowrite
+ *
+ * Description:
+ *   Write to the pipe, with d_wrlock held.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_dowrite(FAR struct file *filep,
+                                  FAR struct pipe_dev_s *dev,
+                                  FAR const char *buffer, size_t len)
+{
+  ssize_t nwritten = 0;
+  ssize_t last;
+  int     ret;
+
+  /* Make sure that we have exclusive access to the device structure */
+
+  ret = nxmutex_lock(&dev->d_bflock);
+  if (ret < 0)
+    {
+      /* May fail because a signal was received or if the task was
+       * canceled.
+       */
+
+      return ret;
+    }
+
+  /* Loop until all of the bytes have been written */
+
+  last = 0;
+  for (; ; )
+    {
+      /* REVISIT:  "If all file descriptors referring to the read end of a
+       * pipe have been closed, then a write will cause a SIGPIPE signal to
+       * be generated for the calling process.  If the calling process is
+       * ignoring this signal, then write(2) fails with the error EPIPE."
+       */
+
+      if (dev->d_nreaders <= 0)
+        {
+          nxmutex_unlock(&dev->d_bflock);
+          return nwritten == 0 ? -EPIPE : nwritten;
+        }
+
+      /* Would the next write overflow the circular buffer?  A write that
+       * fits in the buffer waits for room for all of it, so that it is
+       * copied at once and the readers are woken once.
+       */
+
+      if (len <= dev->d_bufsize ?
+          circbuf_space(&dev->d_buffer) >= len - nwritten :
+          !circbuf_is_full(&dev->d_buffer))
+        {
+          /* Loop until all of the bytes have been written */
+
+          nwritten += circbuf_write(&dev->d_buffer,
+                                    buffer + nwritten, len - nwritten);
+
+          if ((size_t)nwritten == len)
+            {
+              pipecommon_writedone(dev);
+
+              /* Return the number of bytes written */
+
+              nxmutex_unlock(&dev->d_bflock);
+              return len;
+            }
+        }
+      else
+        {
+          /* There is not enough room for the next byte.  Was anything
+           * written in this pass?
+           */
+
+          if (last < nwritten)
+            {
+              /* Notify all poll/select waiters that they can read from the
+               * FIFO.
+               */
+
+              poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLIN);
+
+              /* Yes.. Notify all of the waiting readers that more data is
+               * available.
+               */
+
+              pipecommon_wakeup(&dev->d_rdsem);
+            }
+
+          last = nwritten;
+
+          /* If O_NONBLOCK was set, then return partial bytes written or
+           * EGAIN.
+           */
+
+          if (filep->f_oflags & O_NONBLOCK)
+            {
+              if (nwritten == 0)
+                {
+                  nwritten = -EAGAIN;
+                }
+
+              nxmutex_unlock(&dev->d_bflock);
+              return nwritten;
+            }
+
+          /* There is more to be written.. wait for data to be removed from
+           * the pipe
+           */
+
+          nxmutex_unlock(&dev->d_bflock);
+          ret = nxsem_wait(&dev->d_wrsem);
+          if (ret < 0 || (ret = nxmutex_lock(&dev->d_bflock)) < 0)
+            {
+              /* Either call nxsem_wait may fail because a signal was
+               * received or if the task was canceled.
+               */
+
+              return nwritten == 0 ? (ssize_t)ret : nwritten;
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_splice
+ *
+ * Description:
+ *   Move data between the pipe buffer and another file without an
+ *   intermediate buffer: the other file reads into or writes from the
+ *   circular buffer directly.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_splice(FAR struct file *filep,
+                                 FAR struct pipe_dev_s *dev,
+                                 FAR struct pipe_splice_s *splice)
+{
+  FAR struct file *other = splice->filep;
+  ssize_t nxfer = 0;
+  ssize_t ret;
+  size_t size;
+  FAR void *ptr;
+
+  if (other == NULL || other->f_inode == filep->f_inode)
+    {
+      return -EINVAL;
+    }
+
+  if (splice->size == 0)
+    {
+      return 0;
+    }
+
+  if (splice->out)
+    {
+      /* From the pipe to the other file, like a read of the pipe */
+
+      if ((filep->f_oflags & O_RDOK) == 0)
+        {
+          return -EBADF;
+        }
+
+      ret = nxmutex_lock(&dev->d_bflock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = pipecommon_waitdata(filep, dev);
+      if (ret <= 0)
+        {
+          return ret;
+        }
+
+      while ((size_t)nxfer < splice->size &&
+             (ptr = circbuf_get_readptr(&dev->d_buffer, &size)) != NULL &&
+             size > 0)
+        {
+          size = MIN(size, splice->size - nxfer);
+          ret  = file_write(other, ptr, size);
+          if (ret <= 0)
+            {
+              break;
+            }
+
+          circbuf_readcommit(&dev->d_buffer, ret);
+          nxfer += ret;
+          if ((size_t)ret < size)
+            {
+              break;
+            }
+        }
+
+      if (nxfer > 0)
+        {
+          pipecommon_readdone(dev);
+        }
+
+      nxmutex_unlock(&dev->d_bflock);
+      return nxfer > 0 ? nxfer : ret;
+    }
+
+  /* From the other file to the pipe, like a write of the pipe */
+
+  if ((filep->f_oflags & O_WROK) == 0)
+    {
+      return -EBADF;
+    }
+
+  if (filep->f_oflags & O_NONBLOCK)
+    {
+      ret = nxmutex_trylock(&dev->d_wrlock);
+      if (ret == -EBUSY)
+        {
+          ret = -EAGAIN;
+        }
+    }
+  else
+    {
+      ret = nxmutex_lock(&dev->d_wrlock);
+    }
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = nxmutex_lock(&dev->d_bflock);
+  if (ret < 0)
+    {
+      goto errout_with_wrlock;
+    }
+
+  /* Wait for room in the pipe */
+
+  while (circbuf_is_full(&dev->d_buffer) || dev->d_nreaders <= 0)
+    {
+      if (dev->d_nreaders <= 0)
+        {
+          ret = -EPIPE;
+          goto errout_with_bflock;
+        }
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          ret = -EAGAIN;
+          goto errout_with_bflock;
+        }
+
+      nxmutex_unlock(&dev->d_bflock);
+      ret = nxsem_wait(&dev->d_wrsem);
+      if (ret < 0 || (ret = nxmutex_lock(&dev->d_bflock)) < 0)
+        {
+          goto errout_with_wrlock;
+        }
+    }
+
+  while ((size_t)nxfer < splice->size &&
+         (ptr = circbuf_get_writeptr(&dev->d_buffer, &size)) != NULL &&
+         size > 0)
+    {
+      size = MIN(size, splice->size - nxfer);
+      ret  = file_read(other, ptr, size);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      circbuf_writecommit(&dev->d_buffer, ret);
+      nxfer += ret;
+      if ((size_t)ret < size)
+        {
+          break;
+        }
+    }
+
+  if (nxfer > 0)
+    {
+      pipecommon_writedone(dev);
+      ret = nxfer;
+    }
+
+errout_with_bflock:
+  nxmutex_unlock(&dev->d_bflock);
+errout_with_wrlock:
+  nxmutex_unlock(&dev->d_wrlock);
+  return ret;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -101,6 +496,7 @@ FAR struct pipe_dev_s *pipecommon_allocdev(size_t bufsize)
 
       memset(dev, 0, sizeof(struct pipe_dev_s));
       nxmutex_init(&dev->d_bflock);
+      nxmutex_init(&dev->d_wrlock);
       nxsem_init(&dev->d_rdsem, 0, 0);
       nxsem_init(&dev->d_wrsem, 0, 0);
       dev->d_bufsize = bufsize;
@@ -116,6 +512,7 @@ FAR struct pipe_dev_s *pipecommon_allocdev(size_t bufsize)
 void pipecommon_freedev(FAR struct pipe_dev_s *dev)
 {
   nxmutex_destroy(&dev->d_bflock);
+  nxmutex_destroy(&dev->d_wrlock);
   nxsem_destroy(&dev->d_rdsem);
   nxsem_destroy(&dev->d_wrsem);
   kmm_free(dev);
@@ -434,37 +831,10 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
   /* If the pipe is empty, then wait for something to be written to it */
 
-  while (circbuf_is_empty(&dev->d_buffer))
+  ret = pipecommon_waitdata(filep, dev);
+  if (ret <= 0)
     {
-      /* If there are no writers on the pipe, then return end of file */
-
-      if (dev->d_nwriters <= 0)
-        {
-          nxmutex_unlock(&dev->d_bflock);
-          return 0;
-        }
-
-      /* If O_NONBLOCK was set, then return EGAIN */
-
-      if (filep->f_oflags & O_NONBLOCK)
-        {
-          nxmutex_unlock(&dev->d_bflock);
-          return -EAGAIN;
-        }
-
-      /* Otherwise, wait for something to be written to the pipe */
-
-      nxmutex_unlock(&dev->d_bflock);
-      ret = nxsem_wait(&dev->d_rdsem);
-
-      if (ret < 0 || (ret = nxmutex_lock(&dev->d_bflock)) < 0)
-        {
-          /* May fail because a signal was received or if the task was
-           * canceled.
-           */
-
-          return ret;
-        }
+      return ret;
     }
 
   /* Then return whatever is available in the pipe (which is at least one
@@ -472,21 +842,7 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
    */
 
   nread = circbuf_read(&dev->d_buffer, buffer, len);
-
-  /* Notify all poll/select waiters that they can write to the
-   * FIFO when buffer can accept more than d_polloutthrd bytes.
-   */
-
-  if (circbuf_used(&dev->d_buffer) <= (dev->d_bufsize - dev->d_polloutthrd))
-    {
-      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLOUT);
-    }
-
-  /* Notify all waiting writers that bytes have been removed from the
-   * buffer.
-   */
-
-  pipecommon_wakeup(&dev->d_wrsem);
+  pipecommon_readdone(dev);
 
   nxmutex_unlock(&dev->d_bflock);
   pipe_dumpbuffer("From PIPE:", buffer, nread);
@@ -502,8 +858,7 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
 {
   FAR struct inode      *inode    = filep->f_inode;
   FAR struct pipe_dev_s *dev      = inode->i_private;
-  ssize_t                nwritten = 0;
-  ssize_t                last;
+  ssize_t                nwritten;
   int                    ret;
 
   DEBUGASSERT(dev);
@@ -531,122 +886,31 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
 
   DEBUGASSERT(up_interrupt_context() == false);
 
-  /* Make sure that we have exclusive access to the device structure */
-
-  ret = nxmutex_lock(&dev->d_bflock);
-  if (ret < 0)
-    {
-      /* May fail because a signal was received or if the task was
-       * canceled.
-       */
-
-      return ret;
-    }
-
-  /* Loop until all of the bytes have been written */
+  /* One writer at a time, so that the data of a write is not interleaved
+   * with other writes even when it does not fit in the buffer.
+   */
 
-  last = 0;
-  for (; ; )
+  if (filep->f_oflags & O_NONBLOCK)
     {
-      /* REVISIT:  "If all file descriptors referring to the read end of a
-       * pipe have been closed, then a write will cause a SIGPIPE signal to
-       * be generated for the calling process.  If the calling process is
-       * ignoring this signal, then write(2) fails with the error EPIPE."
-       */
-
-      if (dev->d_nreaders <= 0)
+      ret = nxmutex_trylock(&dev->d_wrlock);
+      if (ret == -EBUSY)
         {
-          nxmutex_unlock(&dev->d_bflock);
-          return nwritten == 0 ? -EPIPE : nwritten;
+          ret = -EAGAIN;
         }
+    }
+  else
+    {
+      ret = nxmutex_lock(&dev->d_wrlock);
+    }
 
-      /* Would the next write overflow the circular buffer? */
-
-      if (!circbuf_is_full(&dev->d_buffer))
-        {
-          /* Loop until all of the bytes have been written */
-
-          nwritten += circbuf_write(&dev->d_buffer,
-                                    buffer + nwritten, len - nwritten);
-
-          if ((size_t)nwritten == len)
-            {
-              /* Notify all poll/select waiters that they can read from the
-               * FIFO when buffer used exceeds poll threshold.
-               */
-
-              if (circbuf_used(&dev->d_buffer) > dev->d_pollinthrd)
-                {
-                  poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS,
-                              POLLIN);
-                }
-
-              /* Yes.. Notify all of the waiting readers that more data is
-               * available.
-               */
-
-              pipecommon_wakeup(&dev->d_rdsem);
-
-              /* Return the number of bytes written */
-
-              nxmutex_unlock(&dev->d_bflock);
-              return len;
-            }
-        }
-      else
-        {
-          /* There is not enough room for the next byte.  Was anything
-           * written in this pass?
-           */
-
-          if (last < nwritten)
-            {
-              /* Notify all poll/select waiters that they can read from the
-               * FIFO.
-               */
-
-              poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLIN);
-
-              /* Yes.. Notify all of the waiting readers that more data is
-               * available.
-               */
-
-              pipecommon_wakeup(&dev->d_rdsem);
-            }
-
-          last = nwritten;
-
-          /* If O_NONBLOCK was set, then return partial bytes written or
-           * EGAIN.
-           */
-
-          if (filep->f_oflags & O_NONBLOCK)
-            {
-              if (nwritten == 0)
-                {
-                  nwritten = -EAGAIN;
-                }
-
-              nxmutex_unlock(&dev->d_bflock);
-              return nwritten;
-            }
-
-          /* There is more to be written.. wait for data to be removed from
-           * the pipe
-           */
-
-          nxmutex_unlock(&dev->d_bflock);
-          ret = nxsem_wait(&dev->d_wrsem);
-          if (ret < 0 || (ret = nxmutex_lock(&dev->d_bflock)) < 0)
-            {
-              /* Either call nxsem_wait may fail because a signal was
-               * received or if the task was canceled.
-               */
-
-              return nwritten == 0 ? (ssize_t)ret : nwritten;
-            }
-        }
+  if (ret < 0)
+    {
+      return ret;
     }
+
+  nwritten = pipecommon_dowrite(filep, dev, buffer, len);
+  nxmutex_unlock(&dev->d_wrlock);
+  return nwritten;
 }
 
 /****************************************************************************
@@ -787,6 +1051,33 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
     }
 #endif
 
+  /* The byte counts need no lock: only one reader and one writer at a time
+   * update the buffer under d_bflock and the circbuf indices are ordered.
+   */
+
+  switch (cmd)
+    {
+      case FIONWRITE:  /* Number of bytes waiting in send queue */
+      case FIONREAD:   /* Number of bytes available for reading */
+        *(FAR int *)((uintptr_t)arg) = circbuf_used(&dev->d_buffer);
+        return OK;
+
+      case FIONSPACE:  /* Free space in buffer */
+        *(FAR int *)((uintptr_t)arg) = circbuf_space(&dev->d_buffer);
+        return OK;
+
+      /* The splice takes the locks itself, it may block */
+
+      case PIPEIOC_SPLICE:
+        DEBUGASSERT(arg != 0);
+        return pipecommon_splice(filep, dev,
+                                 (FAR struct pipe_splice_s *)
+                                 ((uintptr_t)arg));
+
+      default:
+        break;
+    }
+
   ret = nxmutex_lock(&dev->d_bflock);
   if (ret < 0)
     {
@@ -848,23 +1139,6 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
-      case FIONWRITE:  /* Number of bytes waiting in send queue */
-      case FIONREAD:   /* Number of bytes available for reading */
-        {
-          *(FAR int *)((uintptr_t)arg) = circbuf_used(&dev->d_buffer);
-          ret = 0;
-        }
-        break;
-
-      /* Free space in buffer */
-
-      case FIONSPACE:
-        {
-          *(FAR int *)((uintptr_t)arg) = circbuf_space(&dev->d_buffer);
-          ret = 0;
-        }
-        break;
-
       case BIOC_FLUSH:
         ret = -EINVAL;
         break;
@@ -37,6 +37,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/power/battery_charger.h>
 #include <nuttx/power/battery_ioctl.h>
+#include <nuttx/wqueue.h>
 
 /* This driver requires:
  *
@@ -134,6 +135,58 @@ static int battery_charger_notify(FAR struct battery_charger_priv_s *priv,
   return OK;
 }
 
+#ifdef CONFIG_BATTERY_CHARGER_ALERT
+/****************************************************************************
+ * Name: battery_charger_worker
+ *
+ * Description:
+ *   Read the charger after an alert and report the values that changed.
+ *
+ ****************************************************************************/
+
+static void battery_charger_worker(FAR void *arg)
+{
+  FAR struct battery_charger_dev_s *dev = arg;
+  FAR const struct battery_charger_operations_s *ops = dev->ops;
+  uint32_t mask = 0;
+  bool online;
+  int value;
+
+  if (nxmutex_lock(&dev->batlock) < 0)
+    {
+      return;
+    }
+
+  if (ops->state != NULL && ops->state(dev, &value) >= 0 &&
+      value != dev->state)
+    {
+      dev->state = value;
+      mask |= BATTERY_STATE_CHANGED;
+    }
+
+  if (ops->health != NULL && ops->health(dev, &value) >= 0 &&
+      value != dev->health)
+    {
+      dev->health = value;
+      mask |= BATTERY_HEALTH_CHANGED;
+    }
+
+  if (ops->online != NULL && ops->online(dev, &online) >= 0 &&
+      online != dev->online)
+    {
+      dev->online = online;
+      mask |= BATTERY_ONLINE_CHANGED;
+    }
+
+  nxmutex_unlock(&dev->batlock);
+
+  if (mask != 0)
+    {
+      battery_charger_changed(dev, mask);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: bat_charger_open
  *
@@ -496,6 +549,24 @@ int battery_charger_changed(FAR struct battery_charger_dev_s *dev,
   return OK;
 }
 
+/****************************************************************************
+ * Name: battery_charger_alert
+ ****************************************************************************/
+
+#ifdef CONFIG_BATTERY_CHARGER_ALERT
+int battery_charger_alert(FAR struct battery_charger_dev_s *dev)
+{
+  /* Alerts that arrive before the charger was read are merged */
+
+  if (!work_available(&dev->work))
+    {
+      return OK;
+    }
+
+  return work_queue(LPWORK, &dev->work, battery_charger_worker, dev, 0);
+}
+#endif
+
 /****************************************************************************
  * Name: battery_charger_register
  *
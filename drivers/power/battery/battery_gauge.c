@@ -37,6 +37,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/power/battery_gauge.h>
 #include <nuttx/power/battery_ioctl.h>
+#include <nuttx/wqueue.h>
 
 /* This driver requires:
  *
@@ -136,6 +137,100 @@ static int battery_gauge_notify(FAR struct battery_gauge_priv_s *priv,
   return OK;
 }
 
+#ifdef CONFIG_BATTERY_GAUGE_ALERT
+/****************************************************************************
+ * Name: battery_gauge_moved
+ *
+ * Description:
+ *   Return true if a value moved by at least the threshold since it was
+ *   last reported; a zero threshold reports any change.
+ *
+ ****************************************************************************/
+
+static bool battery_gauge_moved(b16_t value, b16_t last, b16_t threshold)
+{
+  b16_t delta = value > last ? value - last : last - value;
+
+  return threshold > 0 ? delta >= threshold : delta != 0;
+}
+
+/****************************************************************************
+ * Name: battery_gauge_worker
+ *
+ * Description:
+ *   Read the gauge after an alert and report the values that changed.
+ *
+ ****************************************************************************/
+
+static void battery_gauge_worker(FAR void *arg)
+{
+  FAR struct battery_gauge_dev_s *dev = arg;
+  FAR const struct battery_gauge_operations_s *ops = dev->ops;
+  uint32_t mask = 0;
+  b16_t value16;
+  b8_t value8;
+  bool online;
+  int state;
+
+  if (nxmutex_lock(&dev->batlock) < 0)
+    {
+      return;
+    }
+
+  if (ops->state != NULL && ops->state(dev, &state) >= 0 &&
+      state != dev->state)
+    {
+      dev->state = state;
+      mask |= BATTERY_STATE_CHANGED;
+    }
+
+  if (ops->online != NULL && ops->online(dev, &online) >= 0 &&
+      online != dev->online)
+    {
+      dev->online = online;
+      mask |= BATTERY_ONLINE_CHANGED;
+    }
+
+  if (ops->voltage != NULL && ops->voltage(dev, &value16) >= 0 &&
+      battery_gauge_moved(value16, dev->voltage,
+                          dev->thresholds.voltage))
+    {
+      dev->voltage = value16;
+      mask |= BATTERY_VOLTAGE_CHANGED;
+    }
+
+  if (ops->capacity != NULL && ops->capacity(dev, &value16) >= 0 &&
+      battery_gauge_moved(value16, dev->capacity,
+                          dev->thresholds.capacity))
+    {
+      dev->capacity = value16;
+      mask |= BATTERY_CAPACITY_CHANGED;
+    }
+
+  if (ops->current != NULL && ops->current(dev, &value16) >= 0 &&
+      battery_gauge_moved(value16, dev->current,
+                          dev->thresholds.current))
+    {
+      dev->current = value16;
+      mask |= BATTERY_CURRENT_CHANGED;
+    }
+
+  if (ops->temp != NULL && ops->temp(dev, &value8) >= 0 &&
+      battery_gauge_moved(value8, dev->temp, dev->thresholds.temperature))
+    {
+      dev->temp = value8;
+      mask |= BATTERY_TEMPERATURE_CHANGED;
+    }
+
+  nxmutex_unlock(&dev->batlock);
+
+  if (mask != 0)
+    {
+      battery_gauge_changed(dev, mask);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: bat_gauge_open
  *
@@ -359,6 +454,20 @@ static int bat_gauge_ioctl(FAR struct file *filep,
         }
         break;
 
+#ifdef CONFIG_BATTERY_GAUGE_ALERT
+      case BATIOC_SET_THRESHOLDS:
+        {
+          FAR const struct batio_thresholds_s *ptr =
+            (FAR const struct batio_thresholds_s *)((uintptr_t)arg);
+          if (ptr)
+            {
+              dev->thresholds = *ptr;
+              ret = OK;
+            }
+        }
+        break;
+#endif
+
       default:
         _err("ERROR: Unrecognized cmd: %d\n", cmd);
         ret = -ENOTTY;
@@ -454,6 +563,24 @@ int battery_gauge_changed(FAR struct battery_gauge_dev_s *dev,
   return OK;
 }
 
+/****************************************************************************
+ * Name: battery_gauge_alert
+ ****************************************************************************/
+
+#ifdef CONFIG_BATTERY_GAUGE_ALERT
+int battery_gauge_alert(FAR struct battery_gauge_dev_s *dev)
+{
+  /* Alerts that arrive before the gauge was read are merged */
+
+  if (!work_available(&dev->work))
+    {
+      return OK;
+    }
+
+  return work_queue(LPWORK, &dev->work, battery_gauge_worker, dev, 0);
+}
+#endif
+
 /****************************************************************************
  * Name: battery_gauge_register
  *
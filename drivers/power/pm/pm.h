@@ -57,6 +57,10 @@ struct pm_domain_s
 
   struct dq_queue_s wakelock[PM_COUNT];
 
+  /* The wakeup latency constraints, see pm_qos_add() */
+
+  struct dq_queue_s qos;
+
 #ifdef CONFIG_PM_PROCFS
   struct dq_queue_s wakelockall;
   struct timespec start;
@@ -56,14 +56,33 @@
 
 int pm_register(FAR struct pm_callback_s *callbacks)
 {
+  FAR dq_entry_t *entry;
   irqstate_t flags;
 
   DEBUGASSERT(callbacks);
 
-  /* Add the new entry to the end of the list of registered callbacks */
+  /* Add the new entry after the last registered callback of the same or a
+   * lower priority, the list is kept in increasing priority.
+   */
 
   flags = pm_lock(&g_pmglobals.reglock);
-  dq_addlast(&callbacks->entry, &g_pmglobals.registry);
+
+  for (entry = dq_tail(&g_pmglobals.registry);
+       entry != NULL && ((FAR struct pm_callback_s *)entry)->priority >
+                        callbacks->priority;
+       entry = dq_prev(entry))
+    {
+    }
+
+  if (entry != NULL)
+    {
+      dq_addafter(entry, &callbacks->entry, &g_pmglobals.registry);
+    }
+  else
+    {
+      dq_addfirst(&callbacks->entry, &g_pmglobals.registry);
+    }
+
   pm_unlock(&g_pmglobals.reglock, flags);
 
   return 0;
@@ -0,0 +1,247 @@
+/****************************************************************************
+ * drivers/power/pm/residency_governor.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <sched.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/wdog.h>
+#include <nuttx/power/pm.h>
+
+#include "pm.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define RESIDENCY_SHIFT   CONFIG_PM_GOVERNOR_RESIDENCY_SHIFT
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The wakeup latency and the target residency of a state */
+
+struct pm_residency_state_s
+{
+  uint32_t latency;                   /* Time to leave the state (us) */
+  uint32_t residency;                 /* Shortest worthwhile stay (us) */
+};
+
+struct pm_residency_domain_s
+{
+  uint64_t entry;                     /* Time the IDLE loop last went idle */
+  uint32_t deadline;                  /* The next timer expiration then */
+  uint32_t average;                   /* Average measured idle time (us) */
+};
+
+struct pm_residency_governor_s
+{
+  struct pm_residency_domain_s domain_states[CONFIG_PM_NDOMAINS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* PM governor methods */
+
+static enum pm_state_e residency_governor_checkstate(int domain);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct pm_governor_s g_residency_governor_ops =
+{
+  NULL,                           /* initialize */
+  NULL,                           /* deinitialize */
+  NULL,                           /* statechanged */
+  residency_governor_checkstate,  /* checkstate */
+  NULL,                           /* activity */
+  NULL                            /* priv */
+};
+
+static const struct pm_residency_state_s g_residency_states[PM_COUNT] =
+{
+  { 0, 0 },
+  { CONFIG_PM_GOVERNOR_IDLE_LATENCY, CONFIG_PM_GOVERNOR_IDLE_RESIDENCY },
+  { CONFIG_PM_GOVERNOR_STANDBY_LATENCY,
+    CONFIG_PM_GOVERNOR_STANDBY_RESIDENCY },
+  { CONFIG_PM_GOVERNOR_SLEEP_LATENCY, CONFIG_PM_GOVERNOR_SLEEP_RESIDENCY }
+};
+
+static struct pm_residency_governor_s g_pm_residency_governor;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: residency_governor_now
+ *
+ * Description:
+ *   Return the system time in microseconds.
+ *
+ ****************************************************************************/
+
+static uint64_t residency_governor_now(void)
+{
+  struct timespec ts;
+
+  clock_systime_timespec(&ts);
+  return (uint64_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+}
+
+/****************************************************************************
+ * Name: residency_governor_deadline
+ *
+ * Description:
+ *   Return the time until the next watchdog timer expires in microseconds,
+ *   UINT32_MAX if there is none or it is farther away.
+ *
+ ****************************************************************************/
+
+static uint32_t residency_governor_deadline(void)
+{
+  sclock_t delay = wd_nextdelay();
+
+  if (delay < 0 || delay >= UINT32_MAX / USEC_PER_TICK)
+    {
+      return UINT32_MAX;
+    }
+
+  return TICK2USEC((uint32_t)delay);
+}
+
+/****************************************************************************
+ * Name: residency_governor_checkstate
+ *
+ * Description:
+ *   Called by the IDLE loop each time the CPU goes idle.  The time since
+ *   the previous call, no longer than the timer deadline of then, is the
+ *   length of the previous idle period and feeds the average idle time.
+ *   Wakeups by other interrupts make it shorter than the deadlines.  The
+ *   idle time predicted is the next deadline, or the average if shorter.
+ *
+ ****************************************************************************/
+
+static enum pm_state_e residency_governor_checkstate(int domain)
+{
+  FAR struct pm_residency_domain_s *pdomstate;
+  FAR struct pm_domain_s *pdom;
+  uint32_t predicted;
+  uint32_t deadline;
+  uint32_t latency;
+  uint64_t now;
+  int64_t sample;
+  irqstate_t flags;
+  int state;
+
+  pdomstate = &g_pm_residency_governor.domain_states[domain];
+  pdom = &g_pmglobals.domain[domain];
+  state = PM_NORMAL;
+
+  deadline  = residency_governor_deadline();
+  predicted = deadline;
+
+  /* Only the calls of the IDLE loop delimit idle periods, not those of
+   * pm_auto_updatestate() on behalf of activity.
+   */
+
+  if (sched_idletask())
+    {
+      now = residency_governor_now();
+      if (pdomstate->entry != 0)
+        {
+          sample = now - pdomstate->entry;
+          if (sample > pdomstate->deadline)
+            {
+              sample = pdomstate->deadline;
+            }
+
+          sample -= pdomstate->average;
+          pdomstate->average += sample / (1 << RESIDENCY_SHIFT);
+        }
+
+      pdomstate->entry    = now;
+      pdomstate->deadline = deadline;
+
+      if (pdomstate->average < predicted)
+        {
+          predicted = pdomstate->average;
+        }
+    }
+
+  latency = pm_qos_latency(domain);
+
+  /* We disable interrupts since pm_stay()/pm_relax() could be simultaneously
+   * invoked, which modifies the stay count which we are about to read
+   */
+
+  flags = pm_domain_lock(domain);
+
+  /* Find the lowest power-level which is not locked, meets the latency
+   * constraints and is worth entering.
+   */
+
+  while (dq_empty(&pdom->wakelock[state]) && state < (PM_COUNT - 1) &&
+         g_residency_states[state + 1].latency <= latency &&
+         g_residency_states[state + 1].latency <= predicted &&
+         g_residency_states[state + 1].residency <= predicted)
+    {
+      state++;
+    }
+
+  pm_domain_unlock(domain, flags);
+
+  return state;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_residency_governor_initialize
+ *
+ * Description:
+ *   Return the residency governor instance.
+ *
+ * Returned Value:
+ *   A pointer to the governor struct. Otherwise NULL is returned on error.
+ *
+ ****************************************************************************/
+
+FAR const struct pm_governor_s *pm_residency_governor_initialize(void)
+{
+  return &g_residency_governor_ops;
+}
@@ -25,6 +25,7 @@
 #include <nuttx/config.h>
 
 #include <stdlib.h>
+#include <string.h>
 #include <fixedmath.h>
 #include <assert.h>
 #include <errno.h>
@@ -193,6 +194,21 @@
 #define GYRO_ODR_1600HZ       (0x0C)
 #define GYRO_ODR_3200HZ       (0x0D)
 
+/* Register 0x47 - FIFO_CONFIG_1 */
+
+#define FIFO_GYR_EN           (1 << 7)
+#define FIFO_ACC_EN           (1 << 6)
+
+/* A frame of the FIFO in headerless mode: gyro then accel data, which is
+ * the layout of the head of struct accel_gyro_st_s
+ */
+
+#define BMI160_FIFO_FRAME     12
+
+/* Sensor time ticks (39.0625 us) between two samples at the 100Hz ODR */
+
+#define BMI160_SAMPLE_TICKS   256
+
 /* Register 0x7b STEP_CONFIG_1 */
 
 #define STEP_CNT_EN           (1 << 3)
@@ -208,6 +224,7 @@
 #define MAG_PM_SUSPEND        (0x18)
 #define MAG_PM_NORMAL         (0x19)
 #define MAG_PM_LOWPOWER       (0x1A)
+#define FIFO_FLUSH            (0xB0)
 
 /****************************************************************************
  * Private Types
@@ -224,6 +241,7 @@ struct bmi160_dev_s
   FAR struct spi_dev_s *spi;    /* SPI interface */
 
 #endif
+  bool fifo;                    /* Samples are read from the FIFO */
 };
 
 /****************************************************************************
@@ -591,6 +609,63 @@ static int bmi160_close(FAR struct file *filep)
   return OK;
 }
 
+/****************************************************************************
+ * Name: bmi160_read_fifo
+ *
+ * Description:
+ *   Read up to n samples from the FIFO in one burst, oldest first, with the
+ *   sensor time that each of them was taken at.
+ *
+ ****************************************************************************/
+
+static ssize_t bmi160_read_fifo(FAR struct bmi160_dev_s *priv,
+                                FAR struct accel_gyro_st_s *p, size_t n)
+{
+  uint8_t regs[BMI160_FIFO_LENGTH_1 - BMI160_SENSORTIME_0 + 1];
+  uint32_t now;
+  size_t avail;
+  size_t i;
+
+  /* Read the sensor time and the FIFO length in one burst, so that the
+   * newest frame in the FIFO is the last sample before that time.
+   */
+
+  bmi160_getregs(priv, BMI160_SENSORTIME_0, regs, sizeof(regs));
+  now = regs[0] | (uint32_t)regs[1] << 8 | (uint32_t)regs[2] << 16;
+  now &= ~(BMI160_SAMPLE_TICKS - 1);
+
+  avail = (regs[BMI160_FIFO_LENGTH_0 - BMI160_SENSORTIME_0] |
+           (regs[BMI160_FIFO_LENGTH_1 - BMI160_SENSORTIME_0] & 0x07) << 8) /
+          BMI160_FIFO_FRAME;
+  if (avail == 0)
+    {
+      return -ENODATA;
+    }
+
+  if (n > avail)
+    {
+      n = avail;
+    }
+
+  /* Read the oldest frames in one burst at the start of the buffer, then
+   * move each frame to its sample from the last one and give it the time
+   * it was taken at, counted back from the newest frame.
+   */
+
+  bmi160_getregs(priv, BMI160_FIFO_DATA, (FAR uint8_t *)p,
+                 n * BMI160_FIFO_FRAME);
+
+  for (i = n; i-- > 0; )
+    {
+      memmove(&p[i], (FAR uint8_t *)p + i * BMI160_FIFO_FRAME,
+              BMI160_FIFO_FRAME);
+      p[i].sensor_time = (now - (avail - 1 - i) * BMI160_SAMPLE_TICKS) &
+                         0xffffff;
+    }
+
+  return n * sizeof(struct accel_gyro_st_s);
+}
+
 /****************************************************************************
  * Name: bmi160_read
  *
@@ -612,6 +687,12 @@ static ssize_t bmi160_read(FAR struct file *filep, FAR char *buffer,
       return 0;
     }
 
+  if (priv->fifo)
+    {
+      return bmi160_read_fifo(priv, p,
+                              len / sizeof(struct accel_gyro_st_s));
+    }
+
   bmi160_getregs(priv, BMI160_DATA_8, (FAR uint8_t *)buffer, 15);
 
   /* Adjust sensing time into 24 bit */
@@ -621,6 +702,24 @@ static ssize_t bmi160_read(FAR struct file *filep, FAR char *buffer,
   return len;
 }
 
+/****************************************************************************
+ * Name: bmi160_enable_fifo
+ *
+ * Description:
+ *   Store the gyro and accel samples in the FIFO, or stop doing so.
+ *
+ ****************************************************************************/
+
+static void bmi160_enable_fifo(FAR struct bmi160_dev_s *priv, bool enable)
+{
+  bmi160_putreg8(priv, BMI160_FIFO_CONFIG_1,
+                 enable ? FIFO_GYR_EN | FIFO_ACC_EN : 0);
+  bmi160_putreg8(priv, BMI160_CMD, FIFO_FLUSH);
+  priv->fifo = enable;
+
+  sninfo("FIFO %sabled.\n", enable ? "en" : "dis");
+}
+
 static void bmi160_enable_stepcounter(FAR struct bmi160_dev_s *priv,
                                       int enable)
 {
@@ -677,6 +776,16 @@ static int bmi160_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+      /* Read the samples from the FIFO, as many as the buffer of read()
+       * holds in one burst.  Arg: bool value
+       */
+
+      case SNIOC_ENABLEFIFO:
+        {
+          bmi160_enable_fifo(priv, arg != 0);
+        }
+        break;
+
       default:
         snerr("Unrecognized cmd: %d\n", cmd);
         ret = -ENOTTY;
@@ -745,6 +854,8 @@ int bmi160_register(FAR const char *devpath, FAR struct spi_dev_s *dev)
       return -ENOMEM;
     }
 
+  priv->fifo = false;
+
 #ifdef CONFIG_SENSORS_BMI160_I2C
   priv->i2c = dev;
   priv->addr = BMI160_I2C_ADDR;
@@ -304,7 +304,7 @@ static const struct file_operations g_mpu_fops =
 
 static int __mpu_read_reg_spi(FAR struct mpu_dev_s *dev,
                               enum mpu_regaddr_e reg_addr,
-                              FAR uint8_t *buf, uint8_t len)
+                              FAR uint8_t *buf, size_t len)
 {
   int ret;
   FAR struct spi_dev_s *spi = dev->config.spi;
@@ -338,12 +338,9 @@ static int __mpu_read_reg_spi(FAR struct mpu_dev_s *dev,
 
   SPI_SEND(spi, reg_addr | MPU_REG_READ);
 
-  /* Clock in the data. */
+  /* Clock in the data, in one block that the SPI master may DMA. */
 
-  while (0 != len--)
-    {
-      *buf++ = (uint8_t) (SPI_SEND(spi, 0xff));
-    }
+  SPI_RECVBLOCK(spi, buf, len);
 
   /* Deselect the chip, release the SPI master. */
 
@@ -402,7 +399,7 @@ static int __mpu_write_reg_spi(FAR struct mpu_dev_s *dev,
 
 static int __mpu_read_reg_i2c(FAR struct mpu_dev_s *dev,
                               uint8_t reg_addr,
-                              FAR uint8_t *buf, uint8_t len)
+                              FAR uint8_t *buf, size_t len)
 {
   int ret;
   struct i2c_msg_s msg[2];
@@ -470,7 +467,7 @@ static int __mpu_write_reg_i2c(FAR struct mpu_dev_s *dev,
 
 static inline int __mpu_read_reg(FAR struct mpu_dev_s *dev,
                                  enum mpu_regaddr_e reg_addr,
-                                 FAR uint8_t *buf, uint8_t len)
+                                 FAR uint8_t *buf, size_t len)
 {
 #ifdef CONFIG_MPU60X0_SPI
   /* If we're wired to SPI, use that function. */
@@ -729,6 +726,41 @@ static inline int __mpu_read_fifo_count(FAR struct mpu_dev_s *dev,
   return ret;
 }
 
+/* Reads as many whole samples as are both queued in the FIFO and fit in
+ * @buf, oldest first, in a single burst.  The samples were taken one
+ * sample period (see SNIOC_READ_SAMPLE_RATE) apart.
+ *
+ * Returns number of bytes read, -EAGAIN if no sample is queued, or
+ * a negative errno.
+ */
+
+static ssize_t __mpu_read_fifo(FAR struct mpu_dev_s *dev,
+                               FAR char *buf, size_t len)
+{
+  uint16_t count;
+  int ret;
+
+  ret = __mpu_read_fifo_count(dev, &count);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (len > count)
+    {
+      len = count;
+    }
+
+  len -= len % sizeof(struct sensor_data_s);
+  if (len == 0)
+    {
+      return -EAGAIN;
+    }
+
+  ret = __mpu_read_reg(dev, FIFO_R_W, (FAR uint8_t *)buf, len);
+  return ret < 0 ? ret : len;
+}
+
 /* Enables or disables FIFO loading a specific sensor.
  * It may receive a OR combination of multiple sensors.
  * Example:
@@ -936,6 +968,18 @@ static ssize_t mpu_read(FAR struct file *filep, FAR char *buf, size_t len)
 
   nxmutex_lock(&dev->lock);
 
+  /* A read of whole samples from the FIFO takes as many of them as are
+   * queued in one burst, straight into the caller's buffer.
+   */
+
+  if (dev->fifo_enabled && !dev->bufpos && len >= 2 * sizeof(dev->buf))
+    {
+      ssize_t ret = __mpu_read_fifo(dev, buf, len);
+
+      nxmutex_unlock(&dev->lock);
+      return ret;
+    }
+
   /* Populate the register cache if it seems empty. */
 
   if (!dev->bufpos)
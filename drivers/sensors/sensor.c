@@ -28,6 +28,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
+#include <strings.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
@@ -39,6 +40,7 @@
 #include <nuttx/mm/circbuf.h>
 #include <nuttx/mutex.h>
 #include <nuttx/sensors/sensor.h>
+#include <nuttx/spinlock.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -51,6 +53,17 @@
 #define DEVNAME_UNCAL       "_uncal"
 #define TIMING_BUF_ESIZE    (sizeof(unsigned long))
 
+/* The events of the mapped ring follow its head */
+
+#define RING_OFFSET         ((sizeof(struct sensor_ring_s) + 7) & ~7)
+
+/* Without SMP only the compiler may reorder the writes to the ring */
+
+#ifndef CONFIG_SPINLOCK
+#  undef  SP_DMB
+#  define SP_DMB()          __asm__ __volatile__ ("" : : : "memory")
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -78,6 +91,9 @@ struct sensor_user_s
                                 */
   sem_t            buffersem;  /* Wakeup user waiting for data in circular buffer */
   size_t           bufferpos;  /* The index of user generation in buffer */
+#ifdef CONFIG_SENSORS_MMAP
+  int              cursor;     /* The index of the mapped cursor, or -1 */
+#endif
 
   /* The subscriber info
    * Support multi advertisers to subscribe their own data when they
@@ -97,6 +113,10 @@ struct sensor_upperhalf_s
   struct circbuf_s   buffer;             /* The circular buffer of data */
   rmutex_t           lock;               /* Manages exclusive access to file operations */
   struct list_node   userlist;           /* List of users */
+#ifdef CONFIG_SENSORS_MMAP
+  FAR struct sensor_ring_s *ring;        /* The ring holding the buffer */
+  uint32_t           cursors;            /* The mapped cursors in use */
+#endif
 };
 
 /****************************************************************************
@@ -115,6 +135,10 @@ static int     sensor_ioctl(FAR struct file *filep, int cmd,
                             unsigned long arg);
 static int     sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
                            bool setup);
+#ifdef CONFIG_SENSORS_MMAP
+static int     sensor_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
+#endif
 static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
                                  size_t bytes);
 
@@ -169,7 +193,11 @@ static const struct file_operations g_sensor_fops =
   sensor_write,   /* write */
   NULL,           /* seek  */
   sensor_ioctl,   /* ioctl */
+#ifdef CONFIG_SENSORS_MMAP
+  sensor_mmap,    /* mmap */
+#else
   NULL,           /* mmap */
+#endif
   NULL,           /* truncate */
   sensor_poll     /* poll  */
 };
@@ -344,11 +372,69 @@ static void sensor_generate_timing(FAR struct sensor_upperhalf_s *upper,
     }
 }
 
+static int sensor_buffer_init(FAR struct sensor_upperhalf_s *upper)
+{
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  FAR void *base = NULL;
+  size_t size = lower->nbuffer * upper->state.esize;
+  int ret;
+
+  if (circbuf_is_init(&upper->buffer))
+    {
+      return OK;
+    }
+
+#ifdef CONFIG_SENSORS_MMAP
+  /* The buffer is the slots of the ring, which mmap() maps */
+
+  upper->ring = kmm_zalloc(RING_OFFSET + size);
+  if (upper->ring == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  upper->ring->nbuffer = lower->nbuffer;
+  upper->ring->esize   = upper->state.esize;
+  upper->ring->offset  = RING_OFFSET;
+  base = (FAR char *)upper->ring + RING_OFFSET;
+#endif
+
+  ret = circbuf_init(&upper->buffer, base, size);
+  if (ret >= 0)
+    {
+      ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
+                         TIMING_BUF_ESIZE);
+      if (ret < 0)
+        {
+          circbuf_uninit(&upper->buffer);
+        }
+    }
+
+#ifdef CONFIG_SENSORS_MMAP
+  if (ret < 0)
+    {
+      kmm_free(upper->ring);
+      upper->ring = NULL;
+    }
+#endif
+
+  return ret;
+}
+
 static bool sensor_is_updated(FAR struct sensor_upperhalf_s *upper,
                               FAR struct sensor_user_s *user)
 {
   long delta = upper->state.generation - user->state.generation;
 
+#ifdef CONFIG_SENSORS_MMAP
+  /* A mapped user consumes the events in place and tells how far */
+
+  if (user->cursor >= 0)
+    {
+      return upper->ring->head != upper->ring->cursor[user->cursor];
+    }
+#endif
+
   if (delta <= 0)
     {
       return false;
@@ -569,6 +655,9 @@ static int sensor_open(FAR struct file *filep)
 
   user->state.interval = ULONG_MAX;
   user->state.esize = upper->state.esize;
+#ifdef CONFIG_SENSORS_MMAP
+  user->cursor = -1;
+#endif
   nxsem_init(&user->buffersem, 0, 0);
   list_add_tail(&upper->userlist, &user->node);
 
@@ -625,6 +714,13 @@ static int sensor_close(FAR struct file *filep)
       upper->state.nadvertisers--;
     }
 
+#ifdef CONFIG_SENSORS_MMAP
+  if (user->cursor >= 0)
+    {
+      upper->cursors &= ~(1u << user->cursor);
+    }
+#endif
+
   list_delete(&user->node);
   sensor_update_latency(filep, upper, user, ULONG_MAX);
   sensor_update_interval(filep, upper, user, ULONG_MAX);
@@ -653,6 +749,15 @@ static ssize_t sensor_read(FAR struct file *filep, FAR char *buffer,
       return -EINVAL;
     }
 
+  /* Polling an idle sensor doesn't contend with the pushing side: the
+   * buffer indices are ordered, so emptiness can be checked unlocked.
+   */
+
+  if (!lower->ops->fetch && circbuf_is_empty(&upper->buffer))
+    {
+      return -ENODATA;
+    }
+
   nxrmutex_lock(&upper->lock);
   if (lower->ops->fetch)
     {
@@ -835,6 +940,36 @@ static int sensor_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_SENSORS_MMAP
+      case SNIOC_MMAP_CURSOR:
+        {
+          nxrmutex_lock(&upper->lock);
+          ret = sensor_buffer_init(upper);
+          if (ret >= 0 && user->cursor < 0)
+            {
+              if (upper->cursors == (uint32_t)
+                  ((1ull << CONFIG_SENSORS_MMAP_NCURSORS) - 1))
+                {
+                  ret = -ENOSPC;
+                }
+              else
+                {
+                  user->cursor = ffs(~upper->cursors) - 1;
+                  upper->cursors |= 1u << user->cursor;
+                  upper->ring->cursor[user->cursor] = upper->ring->head;
+                }
+            }
+
+          if (ret >= 0)
+            {
+              *(FAR int *)(uintptr_t)arg = user->cursor;
+            }
+
+          nxrmutex_unlock(&upper->lock);
+        }
+        break;
+#endif
+
       default:
 
         /* Lowerhalf driver process other cmd. */
@@ -918,11 +1053,42 @@ errout:
   return ret;
 }
 
+#ifdef CONFIG_SENSORS_MMAP
+static int sensor_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  size_t size;
+  int ret;
+
+  nxrmutex_lock(&upper->lock);
+  ret = sensor_buffer_init(upper);
+  if (ret >= 0)
+    {
+      /* Map the head of the ring and the slots of the events */
+
+      size = RING_OFFSET + upper->buffer.size;
+      if (map->offset >= 0 && map->offset < size &&
+          map->length && map->offset + map->length <= size)
+        {
+          map->vaddr = (FAR char *)upper->ring + map->offset;
+        }
+      else
+        {
+          ret = -EINVAL;
+        }
+    }
+
+  nxrmutex_unlock(&upper->lock);
+  return ret;
+}
+#endif
+
 static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
                                  size_t bytes)
 {
   FAR struct sensor_upperhalf_s *upper = priv;
-  FAR struct sensor_lowerhalf_s *lower = upper->lower;
   FAR struct sensor_user_s *user;
   unsigned long envcount;
   int semcount;
@@ -935,29 +1101,33 @@ static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
     }
 
   nxrmutex_lock(&upper->lock);
-  if (!circbuf_is_init(&upper->buffer))
-    {
-      /* Initialize sensor buffer when data is first generated */
 
-      ret = circbuf_init(&upper->buffer, NULL, lower->nbuffer *
-                         upper->state.esize);
-      if (ret < 0)
-        {
-          nxrmutex_unlock(&upper->lock);
-          return ret;
-        }
+  /* Initialize sensor buffer when data is first generated */
 
-      ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
-                         TIMING_BUF_ESIZE);
-      if (ret < 0)
-        {
-          circbuf_uninit(&upper->buffer);
-          nxrmutex_unlock(&upper->lock);
-          return ret;
-        }
+  ret = sensor_buffer_init(upper);
+  if (ret < 0)
+    {
+      nxrmutex_unlock(&upper->lock);
+      return ret;
     }
 
+#ifdef CONFIG_SENSORS_MMAP
+  /* Tell the readers in place which slots are being overwritten */
+
+  upper->ring->claim = upper->ring->head + envcount;
+  SP_DMB();
+#endif
+
   circbuf_overwrite(&upper->buffer, data, bytes);
+
+#ifdef CONFIG_SENSORS_MMAP
+  upper->ring->last = ((upper->buffer.head % upper->buffer.size) /
+                       upper->state.esize + upper->ring->nbuffer - 1) %
+                      upper->ring->nbuffer;
+  SP_DMB();
+  upper->ring->head = upper->ring->claim;
+#endif
+
   sensor_generate_timing(upper, envcount);
   list_for_every_entry(&upper->userlist, user, struct sensor_user_s, node)
     {
@@ -1212,5 +1382,9 @@ void sensor_custom_unregister(FAR struct sensor_lowerhalf_s *lower,
       circbuf_uninit(&upper->timing);
     }
 
+#ifdef CONFIG_SENSORS_MMAP
+  kmm_free(upper->ring);
+#endif
+
   kmm_free(upper);
 }
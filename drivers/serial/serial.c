@@ -27,6 +27,7 @@
 #include <ctype.h>
 #include <sys/types.h>
 #include <sys/param.h>
+#include <sys/uio.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <time.h>
@@ -108,6 +109,8 @@ static ssize_t uart_read(FAR struct file *filep,
 static ssize_t uart_write(FAR struct file *filep,
                           FAR const char *buffer,
                           size_t buflen);
+static ssize_t uart_writev(FAR struct file *filep,
+                           FAR const struct iovec *iov, int iovcnt);
 static int     uart_ioctl(FAR struct file *filep,
                           int cmd, unsigned long arg);
 static int     uart_poll(FAR struct file *filep,
@@ -137,7 +140,12 @@ static const struct file_operations g_serialops =
   uart_ioctl, /* ioctl */
   NULL,       /* mmap */
   NULL,       /* truncate */
-  uart_poll   /* poll */
+  uart_poll,  /* poll */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  NULL,       /* unlink */
+#endif
+  NULL,       /* readv */
+  uart_writev /* writev */
 };
 
 #ifdef CONFIG_TTY_LAUNCH
@@ -1169,6 +1177,110 @@ static ssize_t uart_read(FAR struct file *filep,
   return recvd;
 }
 
+/****************************************************************************
+ * Name: uart_copyxmit
+ *
+ * Description:
+ *   Copy user data to the transmit buffer, with output post-processing.
+ *   Called with xmit.lock held and the TX interrupt disabled.
+ *
+ * Returned Value:
+ *   The number of bytes copied, or a negated errno value if none could be.
+ *
+ ****************************************************************************/
+
+static ssize_t uart_copyxmit(FAR uart_dev_t *dev, FAR const char *buffer,
+                             size_t buflen, bool oktoblock)
+{
+  ssize_t nwritten = buflen;
+  int     ret;
+  char    ch;
+
+  /* Loop while we still have data to copy to the transmit buffer.
+   * we add data to the head of the buffer; uart_xmitchars takes the
+   * data from the end of the buffer.
+   */
+
+  for (; buflen; buflen--)
+    {
+      ch  = *buffer++;
+      ret = OK;
+
+      /* Do output post-processing */
+
+      if ((dev->tc_oflag & OPOST) != 0)
+        {
+          /* Mapping CR to NL? */
+
+          if ((ch == '\r') && (dev->tc_oflag & OCRNL) != 0)
+            {
+              ch = '\n';
+            }
+
+          /* Are we interested in newline processing? */
+
+          if ((ch == '\n') && (dev->tc_oflag & (ONLCR | ONLRET)) != 0)
+            {
+              ret = uart_putxmitchar(dev, '\r', oktoblock);
+            }
+
+          /* Specifically not handled:
+           *
+           * OXTABS - primarily a full-screen terminal optimization
+           * ONOEOT - Unix interoperability hack
+           * OLCUC  - Not specified by POSIX
+           * ONOCR  - low-speed interactive optimization
+           */
+        }
+
+      /* Put the character into the transmit buffer */
+
+      if (ret >= 0)
+        {
+          ret = uart_putxmitchar(dev, ch, oktoblock);
+        }
+
+      /* uart_putxmitchar() might return an error under one of two
+       * conditions:  (1) The wait for buffer space might have been
+       * interrupted by a signal (ret should be -EINTR), (2) if
+       * CONFIG_SERIAL_REMOVABLE is defined, then uart_putxmitchar()
+       * might also return if the serial device was disconnected
+       * (with -ENOTCONN), or (3) if O_NONBLOCK is specified, then
+       * then uart_putxmitchar() might return -EAGAIN if the output
+       * TX buffer is full.
+       */
+
+      if (ret < 0)
+        {
+          /* POSIX requires that we return -1 and errno set if no data was
+           * transferred.  Otherwise, we return the number of bytes in the
+           * interrupted transfer.
+           */
+
+          if (buflen < (size_t)nwritten)
+            {
+              /* Some data was transferred.  Return the number of bytes that
+               * were successfully transferred.
+               */
+
+              nwritten -= buflen;
+            }
+          else
+            {
+              /* No data was transferred. Return the negated errno value.
+               * The VFS layer will set the errno value appropriately).
+               */
+
+              nwritten = ret;
+            }
+
+          break;
+        }
+    }
+
+  return nwritten;
+}
+
 /****************************************************************************
  * Name: uart_write
  ****************************************************************************/
@@ -1178,10 +1290,9 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
 {
   FAR struct inode *inode    = filep->f_inode;
   FAR uart_dev_t   *dev      = inode->i_private;
-  ssize_t           nwritten = buflen;
+  ssize_t           nwritten;
   bool              oktoblock;
   int               ret;
-  char              ch;
 
   /* We may receive serial writes through this path from interrupt handlers
    * and from debug output in the IDLE task!  In these cases, we will need to
@@ -1237,91 +1348,102 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
     }
 #endif
 
-  /* Can the following loop block, waiting for space in the TX
-   * buffer?
-   */
+  /* Can the copy block, waiting for space in the TX buffer? */
 
   oktoblock = ((filep->f_oflags & O_NONBLOCK) == 0);
 
-  /* Loop while we still have data to copy to the transmit buffer.
-   * we add data to the head of the buffer; uart_xmitchars takes the
-   * data from the end of the buffer.
+  /* Copy the data to the head of the transmit buffer; uart_xmitchars
+   * takes the data from the end of the buffer.
    */
 
   uart_disabletxint(dev);
-  for (; buflen; buflen--)
+  nwritten = uart_copyxmit(dev, buffer, buflen, oktoblock);
+
+  if (dev->xmit.head != dev->xmit.tail)
     {
-      ch  = *buffer++;
-      ret = OK;
+#ifdef CONFIG_SERIAL_TXDMA
+      uart_dmatxavail(dev);
+#endif
+      uart_enabletxint(dev);
+    }
 
-      /* Do output post-processing */
+  nxmutex_unlock(&dev->xmit.lock);
+  return nwritten;
+}
 
-      if ((dev->tc_oflag & OPOST) != 0)
-        {
-          /* Mapping CR to NL? */
+/****************************************************************************
+ * Name: uart_writev
+ *
+ * Description:
+ *   Copy all the buffers to the transmit buffer under one hold of
+ *   xmit.lock, so the output of other writers cannot come in between, and
+ *   start the transmission once.
+ *
+ ****************************************************************************/
 
-          if ((ch == '\r') && (dev->tc_oflag & OCRNL) != 0)
-            {
-              ch = '\n';
-            }
+static ssize_t uart_writev(FAR struct file *filep,
+                           FAR const struct iovec *iov, int iovcnt)
+{
+  FAR struct inode *inode  = filep->f_inode;
+  FAR uart_dev_t   *dev    = inode->i_private;
+  ssize_t           ntotal = 0;
+  ssize_t           nwritten;
+  bool              oktoblock;
+  int               ret;
+  int               i;
 
-          /* Are we interested in newline processing? */
+  /* Interrupt handlers and the IDLE task write synchronously */
 
-          if ((ch == '\n') && (dev->tc_oflag & (ONLCR | ONLRET)) != 0)
+  if (up_interrupt_context() || sched_idletask())
+    {
+      for (i = 0; i < iovcnt; i++)
+        {
+          nwritten = uart_write(filep, iov[i].iov_base, iov[i].iov_len);
+          if (nwritten < 0)
             {
-              ret = uart_putxmitchar(dev, '\r', oktoblock);
+              return ntotal > 0 ? ntotal : nwritten;
             }
 
-          /* Specifically not handled:
-           *
-           * OXTABS - primarily a full-screen terminal optimization
-           * ONOEOT - Unix interoperability hack
-           * OLCUC  - Not specified by POSIX
-           * ONOCR  - low-speed interactive optimization
-           */
+          ntotal += nwritten;
         }
 
-      /* Put the character into the transmit buffer */
+      return ntotal;
+    }
 
-      if (ret >= 0)
-        {
-          ret = uart_putxmitchar(dev, ch, oktoblock);
-        }
+  ret = nxmutex_lock(&dev->xmit.lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
 
-      /* uart_putxmitchar() might return an error under one of two
-       * conditions:  (1) The wait for buffer space might have been
-       * interrupted by a signal (ret should be -EINTR), (2) if
-       * CONFIG_SERIAL_REMOVABLE is defined, then uart_putxmitchar()
-       * might also return if the serial device was disconnected
-       * (with -ENOTCONN), or (3) if O_NONBLOCK is specified, then
-       * then uart_putxmitchar() might return -EAGAIN if the output
-       * TX buffer is full.
-       */
+#ifdef CONFIG_SERIAL_REMOVABLE
+  if (dev->disconnected)
+    {
+      nxmutex_unlock(&dev->xmit.lock);
+      return -ENOTCONN;
+    }
+#endif
 
-      if (ret < 0)
-        {
-          /* POSIX requires that we return -1 and errno set if no data was
-           * transferred.  Otherwise, we return the number of bytes in the
-           * interrupted transfer.
-           */
+  oktoblock = ((filep->f_oflags & O_NONBLOCK) == 0);
 
-          if (buflen < (size_t)nwritten)
+  uart_disabletxint(dev);
+  for (i = 0; i < iovcnt; i++)
+    {
+      nwritten = uart_copyxmit(dev, iov[i].iov_base, iov[i].iov_len,
+                               oktoblock);
+      if (nwritten < 0)
+        {
+          if (ntotal == 0)
             {
-              /* Some data was transferred.  Return the number of bytes that
-               * were successfully transferred.
-               */
-
-              nwritten -= buflen;
+              ntotal = nwritten;
             }
-          else
-            {
-              /* No data was transferred. Return the negated errno value.
-               * The VFS layer will set the errno value appropriately).
-               */
 
-              nwritten = ret;
-            }
+          break;
+        }
 
+      ntotal += nwritten;
+      if ((size_t)nwritten < iov[i].iov_len)
+        {
           break;
         }
     }
@@ -1335,7 +1457,7 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
     }
 
   nxmutex_unlock(&dev->xmit.lock);
-  return nwritten;
+  return ntotal;
 }
 
 /****************************************************************************
@@ -121,10 +121,11 @@ static const struct file_operations g_ramlogfops =
 };
 
 /* This is the pre-allocated buffer used for the console RAM log and/or
- * for the syslogging function.
+ * for the syslogging function.  With CONFIG_RAMLOG_LOCKLESS, the system
+ * RAM log is provided by ramlog_lockless.c instead.
  */
 
-#ifdef CONFIG_RAMLOG_SYSLOG
+#if defined(CONFIG_RAMLOG_SYSLOG) && !defined(CONFIG_RAMLOG_LOCKLESS)
 #  ifdef RAMLOG_BUFFER_SECTION
 static char g_sysbuffer[CONFIG_RAMLOG_BUFSIZE]
                        locate_data(RAMLOG_BUFFER_SECTION);
@@ -221,7 +222,7 @@ static void ramlog_pollnotify(FAR struct ramlog_dev_s *priv,
  *
  ****************************************************************************/
 
-#ifdef CONFIG_RAMLOG_SYSLOG
+#if defined(CONFIG_RAMLOG_SYSLOG) && !defined(CONFIG_RAMLOG_LOCKLESS)
 static void ramlog_initbuf(void)
 {
   FAR struct ramlog_dev_s *priv = &g_sysdev;
@@ -291,7 +292,7 @@ static int ramlog_addchar(FAR struct ramlog_dev_s *priv, char ch)
   irqstate_t flags;
   size_t nexthead;
 
-#ifdef CONFIG_RAMLOG_SYSLOG
+#if defined(CONFIG_RAMLOG_SYSLOG) && !defined(CONFIG_RAMLOG_LOCKLESS)
   if (priv == &g_sysdev)
     {
       ramlog_initbuf();
@@ -834,7 +835,7 @@ int ramlog_register(FAR const char *devpath, FAR char *buffer, size_t buflen)
  *
  ****************************************************************************/
 
-#ifdef CONFIG_RAMLOG_SYSLOG
+#if defined(CONFIG_RAMLOG_SYSLOG) && !defined(CONFIG_RAMLOG_LOCKLESS)
 void ramlog_syslog_register(void)
 {
   /* Register the syslog character driver */
@@ -851,7 +852,7 @@ void ramlog_syslog_register(void)
  *
  ****************************************************************************/
 
-#ifdef CONFIG_RAMLOG_SYSLOG
+#if defined(CONFIG_RAMLOG_SYSLOG) && !defined(CONFIG_RAMLOG_LOCKLESS)
 int ramlog_putc(FAR struct syslog_channel_s *channel, int ch)
 {
   FAR struct ramlog_dev_s *priv = &g_sysdev;
@@ -0,0 +1,658 @@
+/****************************************************************************
+ * drivers/syslog/ramlog_lockless.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The lock-free system RAM log.
+ *
+ * Writers append binary records: a writer reserves the space of its record
+ * by advancing the head position with a compare-and-swap, fills the record
+ * and then publishes it by storing its position in the record header.  No
+ * lock or critical section is taken, so the log may be written from
+ * interrupt handlers and from several CPUs at once.
+ *
+ * The head and tail are free running positions; a record is found at its
+ * position modulo the buffer size, which is a power of two.  A record never
+ * wraps around the end of the buffer: a padding record fills the end
+ * instead.  Since the position of a record differs between two laps of the
+ * buffer, a stale header left by an older record is never taken for a
+ * published one.
+ *
+ * The timestamps are formatted, and the CR/LF processing is done, by the
+ * reader.  The reader consumes a record by advancing the tail with a
+ * compare-and-swap after it has copied the record; if that fails, the
+ * record was overwritten meanwhile and the copy is discarded.
+ *
+ * The buffer and its positions are meant to be placed in a section that is
+ * not initialized on boot, so that the log survives a reset.  The log is
+ * reset on the first write after boot if it is not consistent.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/ioctl.h>
+#include <sys/param.h>
+#include <sys/boardctl.h>
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/mutex.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/syslog/ramlog.h>
+#include <nuttx/compiler.h>
+
+#ifdef CONFIG_RAMLOG_LOCKLESS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define RAMLOG_MAGIC        0x524c4f47  /* "RLOG" */
+
+#define RAMLOG_ALIGN        8
+#define RAMLOG_ALIGNUP(n)   (((n) + RAMLOG_ALIGN - 1) & ~(RAMLOG_ALIGN - 1))
+
+#define RAMLOG_HDRSIZE      sizeof(struct ramlog_rec_s)
+
+/* A record and the padding before it must fit in the power of two that
+ * is used, which is more than half of RAMLOG_BUFSIZE.  A record of up to
+ * a quarter of RAMLOG_BUFSIZE always does.
+ */
+
+#if CONFIG_RAMLOG_BUFSIZE < 128
+#  error CONFIG_RAMLOG_BUFSIZE is too small for CONFIG_RAMLOG_LOCKLESS
+#endif
+
+#define RAMLOG_MAXRECORD    MIN(CONFIG_RAMLOG_LOCKLESS_MAXRECORD, \
+                                (CONFIG_RAMLOG_BUFSIZE / 4 & \
+                                 ~(RAMLOG_ALIGN - 1)) - RAMLOG_HDRSIZE)
+#define RAMLOG_REC(b,p)     ((FAR struct ramlog_rec_s *) \
+                             &(b)->data[(p) & ((b)->size - 1)])
+
+/* Record flags */
+
+#define RAMLOG_REC_PAD      (1 << 0)    /* Fills the end of the buffer */
+
+/* A formatted record: time stamp and text with CR/LF expansion */
+
+#define RAMLOG_LINESIZE     (24 + 2 * RAMLOG_MAXRECORD)
+
+/* States of g_ramlogstate */
+
+#define RAMLOG_UNCHECKED    0
+#define RAMLOG_CHECKING     1
+#define RAMLOG_READY        2
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The header of a record.  Only the first three fields of a padding record
+ * are written, so that a padding record fits in RAMLOG_ALIGN bytes.
+ */
+
+struct ramlog_rec_s
+{
+  atomic_uint pos;               /* The record position, once published */
+  uint16_t    len;               /* Length of the text */
+  uint16_t    flags;             /* See RAMLOG_REC_* */
+  uint64_t    ticks;             /* The system time of the write */
+};
+
+/* The log itself, which survives a reset */
+
+struct ramlog_buf_s
+{
+  uint32_t    magic;             /* RAMLOG_MAGIC if valid */
+  uint32_t    size;              /* Size of data[], a power of two */
+  atomic_uint head;              /* Position of the next reservation */
+  atomic_uint tail;              /* Position of the oldest record */
+  atomic_uint dropped;           /* Records that did not fit */
+  uint8_t     data[CONFIG_RAMLOG_BUFSIZE] aligned_data(RAMLOG_ALIGN);
+};
+
+/* The state of the readers */
+
+struct ramlog_reader_s
+{
+  mutex_t     lock;              /* Serializes the readers */
+  bool        linestart;         /* The next record starts a line */
+  size_t      nline;             /* Length of line[] */
+  size_t      offset;            /* Bytes of line[] already returned */
+  char        line[RAMLOG_LINESIZE];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static ssize_t ramlog_file_read(FAR struct file *filep, FAR char *buffer,
+                                size_t buflen);
+static ssize_t ramlog_file_write(FAR struct file *filep,
+                                 FAR const char *buffer, size_t buflen);
+static int     ramlog_file_ioctl(FAR struct file *filep, int cmd,
+                                 unsigned long arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_ramlogfops =
+{
+  NULL,              /* open */
+  NULL,              /* close */
+  ramlog_file_read,  /* read */
+  ramlog_file_write, /* write */
+  NULL,              /* seek */
+  ramlog_file_ioctl, /* ioctl */
+};
+
+#ifdef RAMLOG_BUFFER_SECTION
+static struct ramlog_buf_s g_ramlogbuf locate_data(RAMLOG_BUFFER_SECTION);
+#else
+static struct ramlog_buf_s g_ramlogbuf;
+#endif
+
+/* Checking the log once per boot is the only serialized step of a write */
+
+static atomic_int g_ramlogstate;
+
+static struct ramlog_reader_s g_ramlogreader =
+{
+  NXMUTEX_INITIALIZER,           /* lock */
+  true                           /* linestart */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ramlog_initbuf
+ *
+ * Description:
+ *   Check on the first write after boot that the log left in RAM is
+ *   consistent, and reset it otherwise.
+ *
+ * Returned Value:
+ *   True if the log may be written.
+ *
+ ****************************************************************************/
+
+static bool ramlog_initbuf(void)
+{
+  FAR struct ramlog_buf_s *buf = &g_ramlogbuf;
+#ifdef CONFIG_BOARDCTL_RESET_CAUSE
+  struct boardioc_reset_cause_s cause;
+#endif
+  int state = RAMLOG_UNCHECKED;
+  bool reset = false;
+  uint32_t size;
+
+  if (atomic_load(&g_ramlogstate) == RAMLOG_READY)
+    {
+      return true;
+    }
+
+  /* A write that races with the check is dropped */
+
+  if (!atomic_compare_exchange_strong(&g_ramlogstate, &state,
+                                      RAMLOG_CHECKING))
+    {
+      return state == RAMLOG_READY;
+    }
+
+  size = 1;
+  while (size <= CONFIG_RAMLOG_BUFSIZE / 2)
+    {
+      size <<= 1;
+    }
+
+#ifdef CONFIG_BOARDCTL_RESET_CAUSE
+  memset(&cause, 0, sizeof(cause));
+  if (boardctl(BOARDIOC_RESET_CAUSE, (uintptr_t)&cause) >= 0 &&
+      cause.cause == BOARDIOC_RESETCAUSE_SYS_CHIPPOR)
+    {
+      reset = true;
+    }
+#endif
+
+  if (reset || buf->magic != RAMLOG_MAGIC || buf->size != size ||
+      atomic_load(&buf->head) - atomic_load(&buf->tail) > size)
+    {
+      buf->size = size;
+      atomic_store(&buf->head, 0);
+      atomic_store(&buf->tail, 0);
+      atomic_store(&buf->dropped, 0);
+      buf->magic = RAMLOG_MAGIC;
+    }
+
+  atomic_store(&g_ramlogstate, RAMLOG_READY);
+  return true;
+}
+
+/****************************************************************************
+ * Name: ramlog_recsize
+ *
+ * Description:
+ *   Return the space taken by the record at 'pos'.
+ *
+ ****************************************************************************/
+
+static uint32_t ramlog_recsize(FAR struct ramlog_buf_s *buf, uint32_t pos,
+                               uint16_t len, uint16_t flags)
+{
+  if (flags & RAMLOG_REC_PAD)
+    {
+      return buf->size - (pos & (buf->size - 1));
+    }
+
+  return RAMLOG_ALIGNUP(RAMLOG_HDRSIZE + len);
+}
+
+/****************************************************************************
+ * Name: ramlog_droptail
+ *
+ * Description:
+ *   Drop the oldest record to make room.
+ *
+ * Returned Value:
+ *   False if the oldest record is not published yet and cannot be dropped.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RAMLOG_OVERWRITE
+static bool ramlog_droptail(FAR struct ramlog_buf_s *buf, uint32_t tail)
+{
+  FAR struct ramlog_rec_s *rec = RAMLOG_REC(buf, tail);
+  uint32_t size;
+
+  if (atomic_load_explicit(&rec->pos, memory_order_acquire) != tail)
+    {
+      return false;
+    }
+
+  /* The size is wrong if the record was dropped and overwritten meanwhile,
+   * but then the tail has moved and the exchange fails.
+   */
+
+  size = ramlog_recsize(buf, tail, rec->len, rec->flags);
+  atomic_compare_exchange_strong(&buf->tail, &tail, tail + size);
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Name: ramlog_addrec
+ *
+ * Description:
+ *   Append one record.  May be called from any context.
+ *
+ ****************************************************************************/
+
+static int ramlog_addrec(FAR struct ramlog_buf_s *buf,
+                         FAR const char *text, size_t len)
+{
+  FAR struct ramlog_rec_s *rec;
+  uint32_t total = RAMLOG_ALIGNUP(RAMLOG_HDRSIZE + len);
+  uint32_t head;
+  uint32_t tail;
+  uint32_t pad;
+  uint32_t off;
+
+  /* Reserve the record, and padding up to the end of the buffer if the
+   * record does not fit before it.  The tail is read first, so that it is
+   * never ahead of the head.
+   */
+
+  for (; ; )
+    {
+      tail = atomic_load(&buf->tail);
+      head = atomic_load(&buf->head);
+      off  = head & (buf->size - 1);
+      pad  = off + total > buf->size ? buf->size - off : 0;
+
+      if (head + pad + total - tail > buf->size)
+        {
+#ifdef CONFIG_RAMLOG_OVERWRITE
+          if (ramlog_droptail(buf, tail))
+            {
+              continue;
+            }
+#endif
+
+          atomic_fetch_add(&buf->dropped, 1);
+          return -EBUSY;
+        }
+
+      if (atomic_compare_exchange_weak(&buf->head, &head,
+                                       head + pad + total))
+        {
+          break;
+        }
+    }
+
+  if (pad > 0)
+    {
+      rec        = RAMLOG_REC(buf, head);
+      rec->len   = 0;
+      rec->flags = RAMLOG_REC_PAD;
+      atomic_store_explicit(&rec->pos, head, memory_order_release);
+      head      += pad;
+    }
+
+  rec        = RAMLOG_REC(buf, head);
+  rec->len   = len;
+  rec->flags = 0;
+  rec->ticks = clock_systime_ticks();
+  memcpy(rec + 1, text, len);
+
+  /* Publish the record */
+
+  atomic_store_explicit(&rec->pos, head, memory_order_release);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ramlog_addbuf
+ ****************************************************************************/
+
+static ssize_t ramlog_addbuf(FAR const char *buffer, size_t len)
+{
+  size_t nwritten;
+  size_t n;
+
+  if (!ramlog_initbuf())
+    {
+      return len;
+    }
+
+  /* Long writes are split in several records */
+
+  for (nwritten = 0; nwritten < len; nwritten += n)
+    {
+      n = MIN(len - nwritten, RAMLOG_MAXRECORD);
+      if (ramlog_addrec(&g_ramlogbuf, buffer + nwritten, n) < 0)
+        {
+          break;
+        }
+    }
+
+  /* We always have to return the number of bytes requested and NOT the
+   * number of bytes that were actually written.  Otherwise, callers
+   * probably retry, causing same error condition again.
+   */
+
+  return len;
+}
+
+/****************************************************************************
+ * Name: ramlog_format
+ *
+ * Description:
+ *   Format a record in the line buffer of the reader: the time stamp if the
+ *   record starts a line, then the text.
+ *
+ ****************************************************************************/
+
+static size_t ramlog_format(FAR struct ramlog_reader_s *reader,
+                            FAR const struct ramlog_rec_s *rec,
+                            uint16_t len)
+{
+  FAR const char *text = (FAR const char *)(rec + 1);
+  FAR char *line = reader->line;
+  uint64_t ticks = rec->ticks;
+  size_t nline = 0;
+  uint16_t i;
+
+  /* The length of a record that is being overwritten may be anything */
+
+  len = MIN(len, RAMLOG_MAXRECORD);
+
+  if (reader->linestart)
+    {
+      nline = snprintf(line, RAMLOG_LINESIZE, "[%5lu.%06lu] ",
+                       (unsigned long)(ticks / TICK_PER_SEC),
+                       (unsigned long)TICK2USEC(ticks % TICK_PER_SEC));
+    }
+
+  for (i = 0; i < len; i++)
+    {
+#ifdef CONFIG_RAMLOG_CRLF
+      /* Ignore carriage returns, pre-pend one before a linefeed */
+
+      if (text[i] == '\r')
+        {
+          continue;
+        }
+
+      if (text[i] == '\n')
+        {
+          line[nline++] = '\r';
+        }
+#endif
+
+      line[nline++] = text[i];
+    }
+
+  reader->linestart = len > 0 && text[len - 1] == '\n';
+  return nline;
+}
+
+/****************************************************************************
+ * Name: ramlog_file_read
+ ****************************************************************************/
+
+static ssize_t ramlog_file_read(FAR struct file *filep, FAR char *buffer,
+                                size_t len)
+{
+  FAR struct ramlog_reader_s *reader = &g_ramlogreader;
+  FAR struct ramlog_buf_s *buf = &g_ramlogbuf;
+  FAR struct ramlog_rec_s *rec;
+  unsigned int dropped;
+  uint32_t tail;
+  uint32_t size;
+  uint16_t flags;
+  uint16_t rlen;
+  size_t nread = 0;
+  size_t nline;
+  bool linestart;
+  int ret;
+
+  if (!ramlog_initbuf())
+    {
+      return 0;
+    }
+
+  ret = nxmutex_lock(&reader->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (nread < len)
+    {
+      /* Return what is left of the last formatted record first */
+
+      if (reader->offset < reader->nline)
+        {
+          nline = MIN(len - nread, reader->nline - reader->offset);
+          memcpy(buffer + nread, reader->line + reader->offset, nline);
+          reader->offset += nline;
+          nread          += nline;
+          continue;
+        }
+
+      reader->nline  = 0;
+      reader->offset = 0;
+
+      dropped = atomic_exchange(&buf->dropped, 0);
+      if (dropped > 0)
+        {
+          reader->nline = snprintf(reader->line, RAMLOG_LINESIZE,
+                                   "%s*** %u records dropped\n",
+                                   reader->linestart ? "" : "\n", dropped);
+          reader->linestart = true;
+          continue;
+        }
+
+      tail = atomic_load(&buf->tail);
+      if (tail == atomic_load(&buf->head))
+        {
+          break;
+        }
+
+      /* Stop at a record that is not published yet */
+
+      rec = RAMLOG_REC(buf, tail);
+      if (atomic_load_explicit(&rec->pos, memory_order_acquire) != tail)
+        {
+          break;
+        }
+
+      rlen      = rec->len;
+      flags     = rec->flags;
+      linestart = reader->linestart;
+      nline     = 0;
+
+      if ((flags & RAMLOG_REC_PAD) == 0)
+        {
+          nline = ramlog_format(reader, rec, rlen);
+        }
+
+      /* Consume the record.  If the tail has moved, the record was dropped
+       * by a writer meanwhile and the copy may be corrupt.
+       */
+
+      size = ramlog_recsize(buf, tail, rlen, flags);
+      if (atomic_compare_exchange_strong(&buf->tail, &tail, tail + size))
+        {
+          reader->nline = nline;
+        }
+      else
+        {
+          reader->linestart = linestart;
+        }
+    }
+
+  nxmutex_unlock(&reader->lock);
+  return nread;
+}
+
+/****************************************************************************
+ * Name: ramlog_file_write
+ ****************************************************************************/
+
+static ssize_t ramlog_file_write(FAR struct file *filep,
+                                 FAR const char *buffer, size_t len)
+{
+  return ramlog_addbuf(buffer, len);
+}
+
+/****************************************************************************
+ * Name: ramlog_file_ioctl
+ ****************************************************************************/
+
+static int ramlog_file_ioctl(FAR struct file *filep, int cmd,
+                             unsigned long arg)
+{
+  FAR struct ramlog_buf_s *buf = &g_ramlogbuf;
+
+  switch (cmd)
+    {
+      /* The size of the records, not of their formatted text */
+
+      case FIONREAD:
+        if (!ramlog_initbuf())
+          {
+            *(FAR int *)((uintptr_t)arg) = 0;
+          }
+        else
+          {
+            *(FAR int *)((uintptr_t)arg) =
+              atomic_load(&buf->head) - atomic_load(&buf->tail);
+          }
+
+        return OK;
+
+      default:
+        return -ENOTTY;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ramlog_syslog_register
+ *
+ * Description:
+ *   Register the lock-free RAM logging device at the path specified by
+ *   CONFIG_SYSLOG_DEVPATH.
+ *
+ ****************************************************************************/
+
+void ramlog_syslog_register(void)
+{
+  register_driver(CONFIG_SYSLOG_DEVPATH, &g_ramlogfops, 0666, NULL);
+}
+
+/****************************************************************************
+ * Name: ramlog_putc
+ *
+ * Description:
+ *   This is the low-level system logging interface.  Each character is a
+ *   record; SYSLOG_BUFFER should be enabled so that whole messages are
+ *   passed to ramlog_write() instead.
+ *
+ ****************************************************************************/
+
+int ramlog_putc(FAR struct syslog_channel_s *channel, int ch)
+{
+  char c = ch;
+
+  UNUSED(channel);
+
+  ramlog_addbuf(&c, 1);
+  return ch;
+}
+
+ssize_t ramlog_write(FAR struct syslog_channel_s *channel,
+                     FAR const char *buffer, size_t buflen)
+{
+  UNUSED(channel);
+
+  return ramlog_addbuf(buffer, buflen);
+}
+
+#endif /* CONFIG_RAMLOG_LOCKLESS */
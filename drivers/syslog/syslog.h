@@ -224,6 +224,46 @@ int syslog_add_intbuffer(int ch);
 int syslog_flush_intbuffer(bool force);
 #endif
 
+/****************************************************************************
+ * Name: syslog_deferred
+ *
+ * Description:
+ *   Store a message with the arguments that its format string takes, to be
+ *   formatted later by the work queue.  Strings are copied, the format
+ *   string itself is not and must stay valid.  May be called from any
+ *   context.
+ *
+ * Input Parameters:
+ *   priority - The priority of the message
+ *   fmt      - The format string
+ *   ap       - The arguments
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOSPC if the message was dropped because the
+ *   buffer is full.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_deferred(int priority, FAR const IPTR char *fmt,
+                    FAR va_list *ap);
+#endif
+
+/****************************************************************************
+ * Name: syslog_flush_deferred
+ *
+ * Description:
+ *   Format the stored messages to the SYSLOG channels.
+ *
+ * Assumptions:
+ *   Interrupts may or may not be disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+void syslog_flush_deferred(void);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
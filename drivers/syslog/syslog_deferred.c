@@ -0,0 +1,739 @@
+/****************************************************************************
+ * drivers/syslog/syslog_deferred.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/param.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include <syslog.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/streams.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/syslog/syslog.h>
+
+#include "syslog.h"
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LPWORK
+#  define SYSLOG_DEFERRED_WORK LPWORK
+#else
+#  define SYSLOG_DEFERRED_WORK HPWORK
+#endif
+
+#define SYSLOG_DEFERRED_HDRSIZE sizeof(struct syslog_deferred_s)
+
+/* Pack or unpack one argument of the given type.  The arguments are not
+ * aligned in the record.
+ */
+
+#define SYSLOG_PACK(type) \
+  do \
+    { \
+      type v_ = va_arg(*ap, type); \
+      if (next + sizeof(type) > end) \
+        { \
+          goto done; \
+        } \
+      memcpy(next, &v_, sizeof(type)); \
+      next += sizeof(type); \
+    } \
+  while (0)
+
+#define SYSLOG_UNPACK(type) \
+  do \
+    { \
+      type v_; \
+      if (args + sizeof(type) > end) \
+        { \
+          goto truncated; \
+        } \
+      memcpy(&v_, args, sizeof(type)); \
+      args += sizeof(type); \
+      if (spec.nstar == 0) \
+        { \
+          ret += lib_sprintf_internal(stream, specbuf, v_); \
+        } \
+      else if (spec.nstar == 1) \
+        { \
+          ret += lib_sprintf_internal(stream, specbuf, star[0], v_); \
+        } \
+      else \
+        { \
+          ret += lib_sprintf_internal(stream, specbuf, star[0], star[1], \
+                                      v_); \
+        } \
+    } \
+  while (0)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The header of a message in the buffer.  The arguments that the format
+ * string takes follow it, strings are copied with their terminator.
+ */
+
+struct syslog_deferred_s
+{
+  uint16_t len;                     /* Size, header included */
+  uint8_t  priority;                /* Priority of the message */
+  uint8_t  cpu;                     /* The CPU that logged it */
+  pid_t    pid;                     /* The thread that logged it */
+  clock_t  ticks;                   /* The system time of the message */
+  FAR const IPTR char *fmt;         /* The format string */
+};
+
+/* A conversion specification of the format string */
+
+struct syslog_spec_s
+{
+  char     conv;                    /* Conversion character, 0 at the end */
+  char     length;                  /* Length modifier, see syslog_parse */
+  uint8_t  nstar;                   /* Number of '*' width and precision */
+  uint8_t  speclen;                 /* Length of the specification */
+};
+
+/* The buffer of the messages that wait to be formatted */
+
+struct syslog_deferredbuf_s
+{
+  spinlock_t  lock;                 /* Protects the buffer */
+  size_t      head;                 /* Where the next message goes */
+  size_t      tail;                 /* The oldest message */
+  size_t      used;                 /* Bytes in the buffer */
+  unsigned    dropped;              /* Messages that did not fit */
+  struct work_s work;               /* Formats the messages */
+  uint8_t     buffer[CONFIG_SYSLOG_DEFERRED_BUFSIZE];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct syslog_deferredbuf_s g_syslog_deferred;
+
+#ifdef CONFIG_SYSLOG_PRIORITY
+static FAR const char * const g_priority_str[] =
+  {
+    "EMERG", "ALERT", "CRIT", "ERROR",
+    "WARN", "NOTICE", "INFO", "DEBUG"
+  };
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_parse
+ *
+ * Description:
+ *   Parse the conversion specification at 'fmt', which points to a '%'.
+ *   The length modifiers hh and ll are returned as 'H' and 'q'.
+ *
+ * Returned Value:
+ *   The rest of the format string.
+ *
+ ****************************************************************************/
+
+static FAR const char *syslog_parse(FAR const char *fmt,
+                                    FAR struct syslog_spec_s *spec)
+{
+  FAR const char *p = fmt + 1;
+
+  spec->nstar  = 0;
+  spec->length = 0;
+
+  while (*p != '\0' && strchr("-+ #0'", *p) != NULL)
+    {
+      p++;
+    }
+
+  if (*p == '*')
+    {
+      spec->nstar++;
+      p++;
+    }
+
+  while (*p >= '0' && *p <= '9')
+    {
+      p++;
+    }
+
+  if (*p == '.')
+    {
+      p++;
+      if (*p == '*')
+        {
+          spec->nstar++;
+          p++;
+        }
+
+      while (*p >= '0' && *p <= '9')
+        {
+          p++;
+        }
+    }
+
+  if (*p == 'h' || *p == 'l')
+    {
+      spec->length = *p++;
+      if (*p == spec->length)
+        {
+          spec->length = spec->length == 'h' ? 'H' : 'q';
+          p++;
+        }
+    }
+  else if (*p == 'j' || *p == 'z' || *p == 't' || *p == 'L')
+    {
+      spec->length = *p++;
+    }
+
+  spec->conv = *p;
+  if (*p != '\0')
+    {
+      p++;
+    }
+
+  spec->speclen = p - fmt;
+  return p;
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_pack
+ *
+ * Description:
+ *   Copy the arguments that the format string takes to the record.
+ *
+ * Returned Value:
+ *   The end of the arguments in the record.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *syslog_deferred_pack(FAR const char *fmt,
+                                         FAR va_list *ap,
+                                         FAR uint8_t *next,
+                                         FAR uint8_t *end)
+{
+  struct syslog_spec_s spec;
+  FAR const char *str;
+  size_t len;
+  int i;
+
+  while ((fmt = strchr(fmt, '%')) != NULL)
+    {
+      fmt = syslog_parse(fmt, &spec);
+
+      for (i = 0; i < spec.nstar; i++)
+        {
+          SYSLOG_PACK(int);
+        }
+
+      switch (spec.conv)
+        {
+          case 'd':
+          case 'i':
+          case 'o':
+          case 'u':
+          case 'x':
+          case 'X':
+            switch (spec.length)
+              {
+                case 'l':
+                  SYSLOG_PACK(long);
+                  break;
+
+#ifdef CONFIG_HAVE_LONG_LONG
+                case 'q':
+                  SYSLOG_PACK(long long);
+                  break;
+#endif
+
+                case 'j':
+                  SYSLOG_PACK(intmax_t);
+                  break;
+
+                case 'z':
+                  SYSLOG_PACK(size_t);
+                  break;
+
+                case 't':
+                  SYSLOG_PACK(ptrdiff_t);
+                  break;
+
+                default:
+                  SYSLOG_PACK(int);
+                  break;
+              }
+            break;
+
+          case 'c':
+            SYSLOG_PACK(int);
+            break;
+
+          case 'p':
+            SYSLOG_PACK(FAR void *);
+            break;
+
+#ifdef CONFIG_HAVE_DOUBLE
+          case 'a':
+          case 'A':
+          case 'e':
+          case 'E':
+          case 'f':
+          case 'F':
+          case 'g':
+          case 'G':
+#  ifdef CONFIG_HAVE_LONG_DOUBLE
+            if (spec.length == 'L')
+              {
+                SYSLOG_PACK(long double);
+                break;
+              }
+#  endif
+
+            SYSLOG_PACK(double);
+            break;
+#endif
+
+          /* The string may not live until it is formatted: copy it */
+
+          case 's':
+            str = va_arg(*ap, FAR const char *);
+            if (str == NULL)
+              {
+                str = "(null)";
+              }
+
+            if (next >= end)
+              {
+                goto done;
+              }
+
+            len = strnlen(str, end - next - 1);
+            memcpy(next, str, len);
+            next[len] = '\0';
+            next += len + 1;
+            break;
+
+          /* Nothing can be stored through %n later */
+
+          case 'n':
+            va_arg(*ap, FAR void *);
+            break;
+
+          case '\0':
+            goto done;
+
+          default:
+            break;
+        }
+    }
+
+done:
+  return next;
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_format
+ *
+ * Description:
+ *   Format a message as nx_vsyslog() would have.
+ *
+ ****************************************************************************/
+
+static int syslog_deferred_format(FAR struct lib_outstream_s *stream,
+                                  FAR const struct syslog_deferred_s *rec)
+{
+  FAR const uint8_t *args = (FAR const uint8_t *)(rec + 1);
+  FAR const uint8_t *end = (FAR const uint8_t *)rec + rec->len;
+  FAR const char *fmt = rec->fmt;
+  FAR const char *next;
+  struct syslog_spec_s spec;
+  char specbuf[16];
+  int star[2];
+  int ret = 0;
+  int i;
+
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  struct timespec ts;
+
+  clock_ticks2time((sclock_t)rec->ticks, &ts);
+  ret += lib_sprintf_internal(stream, "[%5jd.%06ld] ", (uintmax_t)ts.tv_sec,
+                              ts.tv_nsec / NSEC_PER_USEC);
+#endif
+
+#ifdef CONFIG_SMP
+  ret += lib_sprintf_internal(stream, "[CPU%d] ", rec->cpu);
+#endif
+
+#ifdef CONFIG_SYSLOG_PROCESSID
+  ret += lib_sprintf_internal(stream, "[%2d] ", rec->pid);
+#endif
+
+#ifdef CONFIG_SYSLOG_PRIORITY
+  ret += lib_sprintf_internal(stream, "[%6s] ",
+                              g_priority_str[rec->priority]);
+#endif
+
+#ifdef CONFIG_SYSLOG_PREFIX
+  ret += lib_sprintf_internal(stream, "[%s] ", CONFIG_SYSLOG_PREFIX_STRING);
+#endif
+
+  while (*fmt != '\0')
+    {
+      /* The text up to the next conversion */
+
+      next = strchr(fmt, '%');
+      if (next == NULL)
+        {
+          next = fmt + strlen(fmt);
+        }
+
+      if (next > fmt)
+        {
+          lib_stream_puts(stream, fmt, next - fmt);
+          ret += next - fmt;
+        }
+
+      if (*next == '\0')
+        {
+          break;
+        }
+
+      fmt = syslog_parse(next, &spec);
+      if (spec.speclen >= sizeof(specbuf))
+        {
+          goto truncated;
+        }
+
+      memcpy(specbuf, next, spec.speclen);
+      specbuf[spec.speclen] = '\0';
+
+      for (i = 0; i < spec.nstar; i++)
+        {
+          if (args + sizeof(int) > end)
+            {
+              goto truncated;
+            }
+
+          memcpy(&star[i], args, sizeof(int));
+          args += sizeof(int);
+        }
+
+      switch (spec.conv)
+        {
+          case 'd':
+          case 'i':
+          case 'o':
+          case 'u':
+          case 'x':
+          case 'X':
+            switch (spec.length)
+              {
+                case 'l':
+                  SYSLOG_UNPACK(long);
+                  break;
+
+#ifdef CONFIG_HAVE_LONG_LONG
+                case 'q':
+                  SYSLOG_UNPACK(long long);
+                  break;
+#endif
+
+                case 'j':
+                  SYSLOG_UNPACK(intmax_t);
+                  break;
+
+                case 'z':
+                  SYSLOG_UNPACK(size_t);
+                  break;
+
+                case 't':
+                  SYSLOG_UNPACK(ptrdiff_t);
+                  break;
+
+                default:
+                  SYSLOG_UNPACK(int);
+                  break;
+              }
+            break;
+
+          case 'c':
+            SYSLOG_UNPACK(int);
+            break;
+
+          case 'p':
+            SYSLOG_UNPACK(FAR void *);
+            break;
+
+#ifdef CONFIG_HAVE_DOUBLE
+          case 'a':
+          case 'A':
+          case 'e':
+          case 'E':
+          case 'f':
+          case 'F':
+          case 'g':
+          case 'G':
+#  ifdef CONFIG_HAVE_LONG_DOUBLE
+            if (spec.length == 'L')
+              {
+                SYSLOG_UNPACK(long double);
+                break;
+              }
+#  endif
+
+            SYSLOG_UNPACK(double);
+            break;
+#endif
+
+          case 's':
+            {
+              FAR const char *str = (FAR const char *)args;
+
+              if (args >= end)
+                {
+                  goto truncated;
+                }
+
+              args += strnlen(str, end - args) + 1;
+              if (spec.nstar == 0)
+                {
+                  ret += lib_sprintf_internal(stream, specbuf, str);
+                }
+              else if (spec.nstar == 1)
+                {
+                  ret += lib_sprintf_internal(stream, specbuf, star[0],
+                                              str);
+                }
+              else
+                {
+                  ret += lib_sprintf_internal(stream, specbuf, star[0],
+                                              star[1], str);
+                }
+            }
+            break;
+
+          case '%':
+            lib_stream_putc(stream, '%');
+            ret++;
+            break;
+
+          default:
+            break;
+        }
+    }
+
+  return ret;
+
+truncated:
+  ret += lib_sprintf_internal(stream, "[truncated]\n");
+  return ret;
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_copy
+ *
+ * Description:
+ *   Copy from or to the circular buffer, with the lock held.
+ *
+ ****************************************************************************/
+
+static void syslog_deferred_copy(FAR struct syslog_deferredbuf_s *db,
+                                 size_t pos, FAR void *data, size_t len,
+                                 bool get)
+{
+  size_t n = MIN(len, CONFIG_SYSLOG_DEFERRED_BUFSIZE - pos);
+
+  if (get)
+    {
+      memcpy(data, &db->buffer[pos], n);
+      memcpy((FAR uint8_t *)data + n, db->buffer, len - n);
+    }
+  else
+    {
+      memcpy(&db->buffer[pos], data, n);
+      memcpy(db->buffer, (FAR uint8_t *)data + n, len - n);
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_worker
+ *
+ * Description:
+ *   Format the messages in the buffer.
+ *
+ ****************************************************************************/
+
+static void syslog_deferred_worker(FAR void *arg)
+{
+  syslog_flush_deferred();
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_deferred
+ *
+ * Description:
+ *   Store a message, to be formatted later.  See syslog.h.
+ *
+ ****************************************************************************/
+
+int syslog_deferred(int priority, FAR const IPTR char *fmt,
+                    FAR va_list *ap)
+{
+  FAR struct syslog_deferredbuf_s *db = &g_syslog_deferred;
+  FAR struct syslog_deferred_s *rec;
+  union
+    {
+      struct syslog_deferred_s hdr;
+      uint8_t data[CONFIG_SYSLOG_DEFERRED_MAXRECORD];
+    }
+
+  msg;
+  irqstate_t flags;
+  FAR uint8_t *end;
+  int ret = 0;
+
+  rec           = &msg.hdr;
+  rec->priority = priority;
+  rec->cpu      = up_cpu_index();
+  rec->pid      = nxsched_gettid();
+  rec->ticks    = clock_systime_ticks();
+  rec->fmt      = fmt;
+
+  end = syslog_deferred_pack(fmt, ap, msg.data + SYSLOG_DEFERRED_HDRSIZE,
+                             msg.data + sizeof(msg.data));
+  rec->len = end - msg.data;
+
+  flags = spin_lock_irqsave(&db->lock);
+
+  if (db->used + rec->len > CONFIG_SYSLOG_DEFERRED_BUFSIZE)
+    {
+      db->dropped++;
+      ret = -ENOSPC;
+    }
+  else
+    {
+      syslog_deferred_copy(db, db->head, rec, rec->len, false);
+      db->head  = (db->head + rec->len) % CONFIG_SYSLOG_DEFERRED_BUFSIZE;
+      db->used += rec->len;
+    }
+
+  if (work_available(&db->work))
+    {
+      work_queue(SYSLOG_DEFERRED_WORK, &db->work, syslog_deferred_worker,
+                 NULL, 0);
+    }
+
+  spin_unlock_irqrestore(&db->lock, flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: syslog_flush_deferred
+ *
+ * Description:
+ *   Format the stored messages to the SYSLOG channels.  See syslog.h.
+ *
+ ****************************************************************************/
+
+void syslog_flush_deferred(void)
+{
+  FAR struct syslog_deferredbuf_s *db = &g_syslog_deferred;
+  struct lib_syslograwstream_s stream;
+  union
+    {
+      struct syslog_deferred_s hdr;
+      uint8_t data[CONFIG_SYSLOG_DEFERRED_MAXRECORD];
+    }
+
+  msg;
+  irqstate_t flags;
+  unsigned dropped;
+  uint16_t len;
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&db->lock);
+
+      dropped     = db->dropped;
+      db->dropped = 0;
+      len         = 0;
+
+      if (db->used > 0)
+        {
+          syslog_deferred_copy(db, db->tail, &len, sizeof(len), true);
+          syslog_deferred_copy(db, db->tail, msg.data, len, true);
+          db->tail  = (db->tail + len) % CONFIG_SYSLOG_DEFERRED_BUFSIZE;
+          db->used -= len;
+        }
+
+      spin_unlock_irqrestore(&db->lock, flags);
+
+      if (len == 0 && dropped == 0)
+        {
+          break;
+        }
+
+      lib_syslograwstream_open(&stream);
+
+      if (dropped > 0)
+        {
+          lib_sprintf_internal(&stream.public, "[%u messages dropped]\n",
+                               dropped);
+        }
+
+      if (len > 0)
+        {
+          syslog_deferred_format(&stream.public, &msg.hdr);
+          if (stream.last_ch != '\n')
+            {
+              lib_stream_putc(&stream.public, '\n');
+            }
+        }
+
+      lib_syslograwstream_close(&stream);
+    }
+}
+
+#endif /* CONFIG_SYSLOG_DEFERRED */
@@ -74,6 +74,12 @@ int syslog_flush(void)
   syslog_flush_intbuffer(true);
 #endif
 
+#ifdef CONFIG_SYSLOG_DEFERRED
+  /* Format the messages that are still waiting for the work queue */
+
+  syslog_flush_deferred();
+#endif
+
   for (i = 0; i < CONFIG_SYSLOG_MAX_CHANNELS; i++)
     {
       FAR struct syslog_channel_s *channel = g_syslog_channel[i];
@@ -94,6 +94,15 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #  endif
 #endif
 
+#ifdef CONFIG_SYSLOG_DEFERRED
+  /* Leave the formatting to the work queue once it runs */
+
+  if (OSINIT_OS_READY())
+    {
+      return syslog_deferred(priority, fmt, ap);
+    }
+#endif
+
   /* Wrap the low-level output in a stream object and let lib_vsprintf
    * do the work.
    */
@@ -216,7 +216,10 @@ errout:
  * Name: cap_read
  *
  * Description:
- *   A dummy read method.  This is provided only to satisfy the VFS layer.
+ *   Return the timestamps of the captured edges as an array of uint32_t,
+ *   if the lower half records them.  Otherwise there is nothing to read.
+ *   The lower half serializes the readers, so the upper half lock is not
+ *   held while waiting for edges.
  *
  ****************************************************************************/
 
@@ -224,9 +227,32 @@ static ssize_t cap_read(FAR struct file *filep,
                        FAR char *buffer,
                        size_t buflen)
 {
-  /* Return zero -- usually meaning end-of-file */
+  FAR struct inode           *inode = filep->f_inode;
+  FAR struct cap_upperhalf_s *upper = inode->i_private;
+  FAR struct cap_lowerhalf_s *lower = upper->lower;
+  ssize_t                     nedges;
+
+  if (lower->ops->read == NULL)
+    {
+      /* Return zero -- usually meaning end-of-file */
+
+      return 0;
+    }
+
+  if (buflen < sizeof(uint32_t))
+    {
+      return -EINVAL;
+    }
+
+  nedges = lower->ops->read(lower, (FAR uint32_t *)buffer,
+                            buflen / sizeof(uint32_t),
+                            (filep->f_oflags & O_NONBLOCK) != 0);
+  if (nedges < 0)
+    {
+      return nedges;
+    }
 
-  return 0;
+  return nedges * sizeof(uint32_t);
 }
 
 /****************************************************************************
@@ -287,8 +313,9 @@ static int cap_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       case CAPIOC_DUTYCYCLE:
         {
           FAR uint8_t *ptr = (FAR uint8_t *)((uintptr_t)arg);
-          DEBUGASSERT(lower->ops->getduty != NULL && ptr);
-          ret = lower->ops->getduty(lower, ptr);
+          DEBUGASSERT(ptr);
+          ret = lower->ops->getduty != NULL ?
+                lower->ops->getduty(lower, ptr) : -ENOTTY;
         }
         break;
 
@@ -299,8 +326,9 @@ static int cap_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       case CAPIOC_FREQUENCE:
         {
           FAR uint32_t *ptr = (FAR uint32_t *)((uintptr_t)arg);
-          DEBUGASSERT(lower->ops->getfreq != NULL && ptr);
-          ret = lower->ops->getfreq(lower, ptr);
+          DEBUGASSERT(ptr);
+          ret = lower->ops->getfreq != NULL ?
+                lower->ops->getfreq(lower, ptr) : -ENOTTY;
         }
         break;
 
@@ -0,0 +1,290 @@
+/****************************************************************************
+ * drivers/timers/hrtimer.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/spinlock.h>
+#include <nuttx/timers/hrtimer.h>
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct hrtimer_lowerhalf_s *g_hrtimer_lower;
+static struct list_node g_hrtimer_list = LIST_INITIAL_VALUE(g_hrtimer_list);
+static spinlock_t g_hrtimer_lock = SP_UNLOCKED;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_insert
+ *
+ * Description:
+ *   Queue a timer after the pending timers that do not expire later.
+ *
+ ****************************************************************************/
+
+static void hrtimer_insert(FAR struct hrtimer_s *timer)
+{
+  FAR struct hrtimer_s *next;
+
+  list_for_every_entry(&g_hrtimer_list, next, struct hrtimer_s, node)
+    {
+      if (next->expired > timer->expired)
+        {
+          list_add_before(&next->node, &timer->node);
+          return;
+        }
+    }
+
+  list_add_tail(&g_hrtimer_list, &timer->node);
+}
+
+/****************************************************************************
+ * Name: hrtimer_process
+ *
+ * Description:
+ *   Call back the expired timers, then set the alarm of the first pending
+ *   one.  The lock is held on entry and exit but released around the
+ *   callbacks.
+ *
+ ****************************************************************************/
+
+static void hrtimer_process(FAR irqstate_t *flags)
+{
+  FAR struct hrtimer_lowerhalf_s *lower = g_hrtimer_lower;
+  FAR struct hrtimer_s *timer;
+  uint64_t period;
+
+  for (; ; )
+    {
+      timer = list_peek_head_type(&g_hrtimer_list, struct hrtimer_s, node);
+      if (timer == NULL)
+        {
+          lower->ops->cancel(lower);
+          return;
+        }
+
+      /* The alarm may be too late to be set if the time is close */
+
+      if (timer->expired > lower->ops->current(lower) &&
+          lower->ops->setalarm(lower, timer->expired) != -ETIME)
+        {
+          return;
+        }
+
+      list_delete(&timer->node);
+      spin_unlock_irqrestore(&g_hrtimer_lock, *flags);
+
+      period = timer->callback(timer);
+
+      *flags = spin_lock_irqsave(&g_hrtimer_lock);
+
+      /* Periodic timers keep their phase.  The callback may also have
+       * restarted the timer itself.
+       */
+
+      if (period > 0 && !list_in_list(&timer->node))
+        {
+          timer->expired += period;
+          hrtimer_insert(timer);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_register
+ *
+ * Description:
+ *   Install the lower half that provides the time base and the alarm of
+ *   the high resolution timers.
+ *
+ ****************************************************************************/
+
+int hrtimer_register(FAR struct hrtimer_lowerhalf_s *lower)
+{
+  irqstate_t flags;
+  int ret = OK;
+
+  DEBUGASSERT(lower != NULL && lower->ops != NULL);
+
+  flags = spin_lock_irqsave(&g_hrtimer_lock);
+  if (g_hrtimer_lower != NULL)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      g_hrtimer_lower = lower;
+    }
+
+  spin_unlock_irqrestore(&g_hrtimer_lock, flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: hrtimer_gettime
+ *
+ * Description:
+ *   Return the current time of the high resolution timers in nanoseconds.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_gettime(void)
+{
+  FAR struct hrtimer_lowerhalf_s *lower = g_hrtimer_lower;
+  irqstate_t flags;
+  uint64_t ns;
+
+  if (lower == NULL)
+    {
+      return 0;
+    }
+
+  flags = spin_lock_irqsave(&g_hrtimer_lock);
+  ns = lower->ops->current(lower);
+  spin_unlock_irqrestore(&g_hrtimer_lock, flags);
+
+  return ns;
+}
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   Start or restart a timer.
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *timer, hrtimer_callback_t callback,
+                  FAR void *arg, uint64_t ns, enum hrtimer_mode_e mode)
+{
+  FAR struct hrtimer_lowerhalf_s *lower = g_hrtimer_lower;
+  irqstate_t flags;
+
+  DEBUGASSERT(timer != NULL && callback != NULL);
+
+  if (lower == NULL)
+    {
+      return -ENODEV;
+    }
+
+  flags = spin_lock_irqsave(&g_hrtimer_lock);
+
+  if (list_in_list(&timer->node))
+    {
+      list_delete(&timer->node);
+    }
+
+  timer->callback = callback;
+  timer->arg      = arg;
+  timer->expired  = ns;
+
+  if (mode == HRTIMER_MODE_REL)
+    {
+      timer->expired += lower->ops->current(lower);
+    }
+
+  hrtimer_insert(timer);
+
+  /* Only a new first timer changes the alarm */
+
+  if (list_peek_head(&g_hrtimer_list) == &timer->node)
+    {
+      hrtimer_process(&flags);
+    }
+
+  spin_unlock_irqrestore(&g_hrtimer_lock, flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ *
+ * Description:
+ *   Stop a timer.
+ *
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *timer)
+{
+  irqstate_t flags;
+  bool first;
+
+  DEBUGASSERT(timer != NULL);
+
+  flags = spin_lock_irqsave(&g_hrtimer_lock);
+
+  if (!list_in_list(&timer->node))
+    {
+      spin_unlock_irqrestore(&g_hrtimer_lock, flags);
+      return -EALREADY;
+    }
+
+  first = list_peek_head(&g_hrtimer_list) == &timer->node;
+  list_delete(&timer->node);
+
+  /* The alarm of the removed timer is replaced by that of the next */
+
+  if (first)
+    {
+      hrtimer_process(&flags);
+    }
+
+  spin_unlock_irqrestore(&g_hrtimer_lock, flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hrtimer_expired
+ *
+ * Description:
+ *   Called by the lower half from its interrupt when the alarm is reached.
+ *
+ ****************************************************************************/
+
+void hrtimer_expired(void)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(g_hrtimer_lower != NULL);
+
+  flags = spin_lock_irqsave(&g_hrtimer_lock);
+  hrtimer_process(&flags);
+  spin_unlock_irqrestore(&g_hrtimer_lock, flags);
+}
+
+#endif /* CONFIG_HRTIMER */
@@ -59,14 +59,15 @@ struct pwm_upperhalf_s
                                      * been opened */
   volatile bool     started;        /* True: pulsed output is being
                                      * generated */
-#ifdef CONFIG_PWM_PULSECOUNT
+#if defined(CONFIG_PWM_PULSECOUNT) || defined(CONFIG_PWM_SEQUENCE)
   volatile bool     waiting;        /* True: Caller is waiting for the pulse
-                                     * count to expire */
+                                     * count to expire or the sequence to
+                                     * complete */
 #endif
   mutex_t           lock;           /* Supports mutual exclusion */
-#ifdef CONFIG_PWM_PULSECOUNT
+#if defined(CONFIG_PWM_PULSECOUNT) || defined(CONFIG_PWM_SEQUENCE)
   sem_t             waitsem;        /* Used to wait for the pulse count to
-                                     * expire */
+                                     * expire or the sequence to complete */
 #endif
   struct pwm_info_s info;           /* Pulsed output characteristics */
   FAR struct pwm_lowerhalf_s *dev;  /* lower-half state */
@@ -87,6 +88,11 @@ static ssize_t pwm_write(FAR struct file *filep, FAR const char *buffer,
                          size_t buflen);
 static int     pwm_start(FAR struct pwm_upperhalf_s *upper,
                          unsigned int oflags);
+#ifdef CONFIG_PWM_SEQUENCE
+static int     pwm_sequence(FAR struct pwm_upperhalf_s *upper,
+                            FAR const struct pwm_sequence_s *seq,
+                            unsigned int oflags);
+#endif
 static int     pwm_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 
 /****************************************************************************
@@ -407,6 +413,69 @@ static int pwm_start(FAR struct pwm_upperhalf_s *upper, unsigned int oflags)
 }
 #endif
 
+/****************************************************************************
+ * Name: pwm_sequence
+ *
+ * Description:
+ *   Handle the PWMIOC_SETSEQUENCE ioctl command
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PWM_SEQUENCE
+static int pwm_sequence(FAR struct pwm_upperhalf_s *upper,
+                        FAR const struct pwm_sequence_s *seq,
+                        unsigned int oflags)
+{
+  FAR struct pwm_lowerhalf_s *lower;
+  irqstate_t flags;
+  int ret;
+
+  DEBUGASSERT(upper != NULL);
+  lower = upper->dev;
+  DEBUGASSERT(lower != NULL && lower->ops->sequence != NULL);
+
+  if (seq == NULL || seq->duty == NULL || seq->frequency == 0 ||
+      seq->nperiods == 0 || seq->nchannels == 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Disable interrupts so that the sequence cannot complete before the
+   * waiting flag is in place.
+   */
+
+  flags = enter_critical_section();
+
+  upper->waiting = (oflags & O_NONBLOCK) == 0;
+
+  ret = lower->ops->sequence(lower, seq, upper);
+  if (ret == OK)
+    {
+      upper->started        = true;
+      upper->info.frequency = seq->frequency;
+
+      /* Wait until we are awakened by pwm_sequence_done() */
+
+      while (upper->waiting)
+        {
+          ret = nxsem_wait_uninterruptible(&upper->waitsem);
+          if (ret < 0)
+            {
+              upper->waiting = false;
+            }
+        }
+    }
+  else
+    {
+      pwminfo("sequence failed: %d\n", ret);
+      upper->waiting = false;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: pwm_ioctl
  *
@@ -523,7 +592,7 @@ static int pwm_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
             {
               ret = lower->ops->stop(lower);
               upper->started = false;
-#ifdef CONFIG_PWM_PULSECOUNT
+#if defined(CONFIG_PWM_PULSECOUNT) || defined(CONFIG_PWM_SEQUENCE)
               if (upper->waiting)
                 {
                   upper->waiting = false;
@@ -533,6 +602,30 @@ static int pwm_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_PWM_SEQUENCE
+      /* PWMIOC_SETSEQUENCE - Start the pulsed output with a sequence of
+       *   duty cycles.
+       *
+       *   ioctl argument:  A read-only reference to struct pwm_sequence_s
+       */
+
+      case PWMIOC_SETSEQUENCE:
+        {
+          FAR const struct pwm_sequence_s *seq =
+            (FAR const struct pwm_sequence_s *)((uintptr_t)arg);
+
+          if (lower->ops->sequence == NULL)
+            {
+              ret = -ENOTTY;
+            }
+          else
+            {
+              ret = pwm_sequence(upper, seq, filep->f_oflags);
+            }
+        }
+        break;
+#endif
+
       /* Any unrecognized IOCTL commands might be platform-specific ioctl
        * commands.
        */
@@ -598,7 +691,7 @@ int pwm_register(FAR const char *path, FAR struct pwm_lowerhalf_s *dev)
    */
 
   nxmutex_init(&upper->lock);
-#ifdef CONFIG_PWM_PULSECOUNT
+#if defined(CONFIG_PWM_PULSECOUNT) || defined(CONFIG_PWM_SEQUENCE)
   nxsem_init(&upper->waitsem, 0, 0);
 #endif
 
@@ -675,4 +768,38 @@ void pwm_expired(FAR void *handle)
 }
 #endif
 
+/****************************************************************************
+ * Name: pwm_sequence_done
+ *
+ * Description:
+ *   Called by the lower half when the last period of a sequence has been
+ *   loaded.  The pulsed output continues.
+ *
+ * Input Parameters:
+ *   handle - This is the handle that was provided to the lower-half
+ *     sequence() method.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PWM_SEQUENCE
+void pwm_sequence_done(FAR void *handle)
+{
+  FAR struct pwm_upperhalf_s *upper = (FAR struct pwm_upperhalf_s *)handle;
+
+  pwminfo("waiting: %d\n", upper->waiting);
+
+  if (upper->waiting)
+    {
+      upper->waiting = false;
+      nxsem_post(&upper->waitsem);
+    }
+}
+#endif
+
 #endif /* CONFIG_PWM */
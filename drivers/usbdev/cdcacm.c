@@ -33,10 +33,16 @@
 #include <string.h>
 #include <assert.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
 #include <debug.h>
 
 #include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/queue.h>
 #include <nuttx/wdog.h>
 #include <nuttx/arch.h>
@@ -125,10 +131,24 @@ struct cdcacm_dev_s
   struct cdcacm_wrreq_s wrreqs[CONFIG_CDCACM_NWRREQS];
   struct cdcacm_rdreq_s rdreqs[CONFIG_CDCACM_NRDREQS];
 
+#ifdef CONFIG_CDCACM_ZEROCOPY
+  /* Zero-copy character driver state.  read() and write() work directly
+   * on the request buffers in rxpending and txfree.
+   */
+
+  mutex_t rdlock;                      /* Serializes readers */
+  mutex_t wrlock;                      /* Serializes writers */
+  sem_t rdsem;                         /* Wakes a reader waiting for data */
+  sem_t wrsem;                         /* Wakes a writer waiting for a request */
+  bool rdwait;                         /* True: A reader waits on rdsem */
+  bool wrwait;                         /* True: A writer waits on wrsem */
+  FAR struct pollfd *fds[CONFIG_CDCACM_NPOLLWAITERS];
+#else
   /* Serial I/O buffers */
 
   char rxbuffer[CONFIG_CDCACM_RXBUFSIZE];
   char txbuffer[CONFIG_CDCACM_TXBUFSIZE];
+#endif
 };
 
 /* The internal version of the class driver */
@@ -223,6 +243,21 @@ static bool    cdcuart_rxflowcontrol(FAR struct uart_dev_s *dev,
 static void    cdcuart_txint(FAR struct uart_dev_s *dev, bool enable);
 static bool    cdcuart_txempty(FAR struct uart_dev_s *dev);
 
+/* Zero-copy Character Driver Operations ************************************/
+
+#ifdef CONFIG_CDCACM_ZEROCOPY
+static void    cdcacm_zcwakeup(FAR struct cdcacm_dev_s *priv,
+                 pollevent_t eventset);
+static ssize_t cdcacm_zcread(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static ssize_t cdcacm_zcwrite(FAR struct file *filep,
+                 FAR const char *buffer, size_t buflen);
+static int     cdcacm_zcioctl(FAR struct file *filep, int cmd,
+                 unsigned long arg);
+static int     cdcacm_zcpoll(FAR struct file *filep, FAR struct pollfd *fds,
+                 bool setup);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -275,6 +310,23 @@ static const struct uart_ops_s g_uartops =
   cdcuart_txempty        /* txempty */
 };
 
+/* Zero-copy character driver ***********************************************/
+
+#ifdef CONFIG_CDCACM_ZEROCOPY
+static const struct file_operations g_zcfops =
+{
+  NULL,                  /* open */
+  NULL,                  /* close */
+  cdcacm_zcread,         /* read */
+  cdcacm_zcwrite,        /* write */
+  NULL,                  /* seek */
+  cdcacm_zcioctl,        /* ioctl */
+  NULL,                  /* mmap */
+  NULL,                  /* truncate */
+  cdcacm_zcpoll          /* poll */
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -624,7 +676,7 @@ static int cdcacm_requeue_rdrequest(FAR struct cdcacm_dev_s *priv,
   /* Requeue the read request */
 
   ep       = priv->epbulkout;
-  req->len = ep->maxpacket;
+  req->len = MAX(CONFIG_CDCACM_BULKOUT_REQLEN, ep->maxpacket);
   ret      = EP_SUBMIT(ep, req);
   if (ret != OK)
     {
@@ -856,6 +908,26 @@ errout_with_flags:
 }
 #endif
 
+/****************************************************************************
+ * Name: cdcacm_connected
+ *
+ * Description:
+ *   Inform the registered character driver (the upper half serial driver
+ *   or the zero-copy driver) that the USB connection was made or lost.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_REMOVABLE
+static void cdcacm_connected(FAR struct cdcacm_dev_s *priv, bool connected)
+{
+#ifdef CONFIG_CDCACM_ZEROCOPY
+  cdcacm_zcwakeup(priv, connected ? POLLOUT : (POLLERR | POLLHUP));
+#else
+  uart_connected(&priv->serdev, connected);
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: cdcacm_resetconfig
  *
@@ -879,7 +951,7 @@ static void cdcacm_resetconfig(FAR struct cdcacm_dev_s *priv)
        */
 
 #ifdef CONFIG_SERIAL_REMOVABLE
-      uart_connected(&priv->serdev, false);
+      cdcacm_connected(priv, false);
 #endif
 
       /* Disable endpoints.  This should force completion of all pending
@@ -1055,7 +1127,7 @@ static int cdcacm_setconfig(FAR struct cdcacm_dev_s *priv, uint8_t config)
   /* Inform the "upper half" driver that we are "open for business" */
 
 #ifdef CONFIG_SERIAL_REMOVABLE
-  uart_connected(&priv->serdev, true);
+  cdcacm_connected(priv, true);
 #endif
 
   return OK;
@@ -1132,11 +1204,17 @@ static void cdcacm_rdcomplete(FAR struct usbdev_ep_s *ep,
         rdcontainer->offset = 0;
         sq_addlast((FAR sq_entry_t *)rdcontainer, &priv->rxpending);
 
+#ifdef CONFIG_CDCACM_ZEROCOPY
+        /* The packet stays in the request buffer until it is read */
+
+        cdcacm_zcwakeup(priv, POLLIN);
+#else
         /* Then process all pending RX packet starting at the head of the
          * list
          */
 
         cdcacm_release_rxpending(priv);
+#endif
       }
       break;
 
@@ -1206,7 +1284,13 @@ static void cdcacm_wrcomplete(FAR struct usbdev_ep_s *ep,
     case OK: /* Normal completion */
       {
         usbtrace(TRACE_CLASSWRCOMPLETE, priv->nwrq);
+#ifdef CONFIG_CDCACM_ZEROCOPY
+        flags = enter_critical_section();
+        cdcacm_zcwakeup(priv, POLLOUT);
+        leave_critical_section(flags);
+#else
         cdcacm_sndpacket(priv);
+#endif
       }
       break;
 
@@ -1323,7 +1407,9 @@ static int cdcacm_bind(FAR struct usbdevclass_driver_s *driver,
 
   priv->epbulkout->priv = priv;
 
-  /* Pre-allocate read requests.  The buffer size is one full packet. */
+  /* Pre-allocate read requests.  The buffer size is one full packet or
+   * the configured request size, whichever is larger.
+   */
 
 #ifdef CONFIG_USBDEV_DUALSPEED
   reqlen = CONFIG_CDCACM_EPBULKOUT_HSSIZE;
@@ -1331,6 +1417,11 @@ static int cdcacm_bind(FAR struct usbdevclass_driver_s *driver,
   reqlen = CONFIG_CDCACM_EPBULKOUT_FSSIZE;
 #endif
 
+  if (CONFIG_CDCACM_BULKOUT_REQLEN > reqlen)
+    {
+      reqlen = CONFIG_CDCACM_BULKOUT_REQLEN;
+    }
+
   for (i = 0; i < CONFIG_CDCACM_NRDREQS; i++)
     {
       rdcontainer      = &priv->rdreqs[i];
@@ -1984,7 +2075,7 @@ static void cdcacm_disconnect(FAR struct usbdevclass_driver_s *driver,
 
   flags = enter_critical_section();
 #ifdef CONFIG_SERIAL_REMOVABLE
-  uart_connected(&priv->serdev, false);
+  cdcacm_connected(priv, false);
 #endif
 
   /* Reset the configuration */
@@ -2036,7 +2127,7 @@ static void cdcacm_suspend(FAR struct usbdevclass_driver_s *driver,
 
   /* And let the "upper half" driver now that we are suspended */
 
-  uart_connected(&priv->serdev, false);
+  cdcacm_connected(priv, false);
 }
 #endif
 
@@ -2074,7 +2165,7 @@ static void cdcacm_resume(FAR struct usbdevclass_driver_s *driver,
     {
       /* Yes.. let the "upper half" know that have resumed */
 
-      uart_connected(&priv->serdev, true);
+      cdcacm_connected(priv, true);
     }
 }
 #endif
@@ -2800,6 +2891,390 @@ static bool cdcuart_txempty(FAR struct uart_dev_s *dev)
   return priv->nwrq >= CONFIG_CDCACM_NWRREQS;
 }
 
+/****************************************************************************
+ * Zero-copy Character Driver Methods
+ ****************************************************************************/
+
+#ifdef CONFIG_CDCACM_ZEROCOPY
+
+/****************************************************************************
+ * Name: cdcacm_zcwakeup
+ *
+ * Description:
+ *   Wake up the waiting reader and/or writer and notify poll() waiters of
+ *   the events in eventset.  A POLLHUP wakes up both so that they can see
+ *   that the connection was lost.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void cdcacm_zcwakeup(FAR struct cdcacm_dev_s *priv,
+                            pollevent_t eventset)
+{
+  if ((eventset & (POLLIN | POLLHUP)) != 0 && priv->rdwait)
+    {
+      priv->rdwait = false;
+      nxsem_post(&priv->rdsem);
+    }
+
+  if ((eventset & (POLLOUT | POLLHUP)) != 0 && priv->wrwait)
+    {
+      priv->wrwait = false;
+      nxsem_post(&priv->wrsem);
+    }
+
+  poll_notify(priv->fds, CONFIG_CDCACM_NPOLLWAITERS, eventset);
+}
+
+/****************************************************************************
+ * Name: cdcacm_zcread
+ *
+ * Description:
+ *   Copy received data straight out of the pending read requests into the
+ *   caller's buffer.  Each request is returned to the bulk OUT endpoint as
+ *   soon as it has been consumed.  Blocks until at least one packet has
+ *   been received unless O_NONBLOCK is set.
+ *
+ ****************************************************************************/
+
+static ssize_t cdcacm_zcread(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct cdcacm_dev_s *priv = inode->i_private;
+  FAR struct cdcacm_rdreq_s *rdcontainer;
+  FAR struct usbdev_req_s *req;
+  irqstate_t flags;
+  size_t nread = 0;
+  size_t nbytes;
+  int ret;
+
+  ret = nxmutex_lock(&priv->rdlock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Wait for a received packet.  Data already received is still returned
+   * after the connection was lost.
+   */
+
+  flags = enter_critical_section();
+  while (sq_empty(&priv->rxpending))
+    {
+      if (priv->config == CDCACM_CONFIGIDNONE)
+        {
+          ret = -EPIPE;
+          goto errout_with_flags;
+        }
+
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          ret = -EAGAIN;
+          goto errout_with_flags;
+        }
+
+      priv->rdwait = true;
+      ret = nxsem_wait(&priv->rdsem);
+      if (ret < 0)
+        {
+          priv->rdwait = false;
+          goto errout_with_flags;
+        }
+    }
+
+  leave_critical_section(flags);
+
+  /* Drain as many pending packets as fit into the caller's buffer.  Only
+   * this reader removes containers from the head of rxpending, so the
+   * copy itself can run with interrupts enabled.
+   */
+
+  while (nread < buflen)
+    {
+      flags       = enter_critical_section();
+      rdcontainer = (FAR struct cdcacm_rdreq_s *)sq_peek(&priv->rxpending);
+      leave_critical_section(flags);
+
+      if (rdcontainer == NULL)
+        {
+          break;
+        }
+
+      req    = rdcontainer->req;
+      nbytes = MIN(buflen - nread, req->xfrd - rdcontainer->offset);
+
+      memcpy(&buffer[nread], &req->buf[rdcontainer->offset], nbytes);
+      rdcontainer->offset += nbytes;
+      nread               += nbytes;
+
+      if (rdcontainer->offset >= req->xfrd)
+        {
+          /* The packet was consumed, give the request back to the DCD */
+
+          flags = enter_critical_section();
+          sq_remfirst(&priv->rxpending);
+          cdcacm_requeue_rdrequest(priv, rdcontainer);
+          leave_critical_section(flags);
+        }
+    }
+
+  nxmutex_unlock(&priv->rdlock);
+  return nread;
+
+errout_with_flags:
+  leave_critical_section(flags);
+  nxmutex_unlock(&priv->rdlock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cdcacm_zcwrite
+ *
+ * Description:
+ *   Copy the caller's data straight into free write requests and submit
+ *   them to the bulk IN endpoint, one request per CDCACM_BULKIN_REQLEN
+ *   bytes.  Blocks for free requests unless O_NONBLOCK is set, in which
+ *   case a partial count may be returned.
+ *
+ ****************************************************************************/
+
+static ssize_t cdcacm_zcwrite(FAR struct file *filep,
+                              FAR const char *buffer, size_t buflen)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct cdcacm_dev_s *priv = inode->i_private;
+  FAR struct cdcacm_wrreq_s *wrcontainer = NULL;
+  FAR struct usbdev_req_s *req;
+  FAR struct usbdev_ep_s *ep;
+  irqstate_t flags;
+  size_t nsent = 0;
+  size_t nbytes;
+  int ret;
+
+  ret = nxmutex_lock(&priv->wrlock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (nsent < buflen)
+    {
+      /* Get a free write request */
+
+      flags = enter_critical_section();
+      for (; ; )
+        {
+          if (priv->config == CDCACM_CONFIGIDNONE)
+            {
+              ret = -EPIPE;
+              break;
+            }
+
+          wrcontainer = (FAR struct cdcacm_wrreq_s *)
+            sq_remfirst(&priv->txfree);
+          if (wrcontainer != NULL)
+            {
+              priv->nwrq--;
+              ret = OK;
+              break;
+            }
+
+          if ((filep->f_oflags & O_NONBLOCK) != 0)
+            {
+              ret = -EAGAIN;
+              break;
+            }
+
+          priv->wrwait = true;
+          ret = nxsem_wait(&priv->wrsem);
+          if (ret < 0)
+            {
+              priv->wrwait = false;
+              break;
+            }
+        }
+
+      leave_critical_section(flags);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      /* Fill the request directly from the user buffer and send it */
+
+      ep     = priv->epbulkin;
+      req    = wrcontainer->req;
+      nbytes = MIN(buflen - nsent,
+                   MAX(CONFIG_CDCACM_BULKIN_REQLEN, ep->maxpacket));
+
+      memcpy(req->buf, &buffer[nsent], nbytes);
+
+      req->len   = nbytes;
+      req->priv  = wrcontainer;
+      req->flags = USBDEV_REQFLAGS_NULLPKT;
+      ret        = EP_SUBMIT(ep, req);
+      if (ret < 0)
+        {
+          usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_SUBMITFAIL),
+                   (uint16_t)-ret);
+
+          flags = enter_critical_section();
+          sq_addlast((FAR sq_entry_t *)wrcontainer, &priv->txfree);
+          priv->nwrq++;
+          leave_critical_section(flags);
+          break;
+        }
+
+      nsent += nbytes;
+    }
+
+  nxmutex_unlock(&priv->wrlock);
+  return nsent > 0 ? (ssize_t)nsent : ret;
+}
+
+/****************************************************************************
+ * Name: cdcacm_zcioctl
+ *
+ * Description:
+ *   The zero-copy device has no termios settings.  Only FIONREAD (bytes
+ *   waiting in received requests) and FIONSPACE (bytes that can be
+ *   written without blocking) are supported.
+ *
+ ****************************************************************************/
+
+static int cdcacm_zcioctl(FAR struct file *filep, int cmd,
+                          unsigned long arg)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct cdcacm_dev_s *priv = inode->i_private;
+  FAR struct cdcacm_rdreq_s *rdcontainer;
+  FAR int *count = (FAR int *)((uintptr_t)arg);
+  irqstate_t flags;
+  int ret = OK;
+
+  if (count == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  switch (cmd)
+    {
+      case FIONREAD:
+        {
+          *count = 0;
+          for (rdcontainer = (FAR struct cdcacm_rdreq_s *)
+                 sq_peek(&priv->rxpending);
+               rdcontainer != NULL;
+               rdcontainer = rdcontainer->flink)
+            {
+              *count += rdcontainer->req->xfrd - rdcontainer->offset;
+            }
+        }
+        break;
+
+      case FIONSPACE:
+        {
+          *count = 0;
+          if (priv->config != CDCACM_CONFIGIDNONE)
+            {
+              *count = priv->nwrq *
+                       MAX(CONFIG_CDCACM_BULKIN_REQLEN,
+                           priv->epbulkin->maxpacket);
+            }
+        }
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cdcacm_zcpoll
+ *
+ * Description:
+ *   POLLIN when a received packet is pending, POLLOUT when a write request
+ *   is free.
+ *
+ ****************************************************************************/
+
+static int cdcacm_zcpoll(FAR struct file *filep, FAR struct pollfd *fds,
+                         bool setup)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct cdcacm_dev_s *priv = inode->i_private;
+  pollevent_t eventset;
+  irqstate_t flags;
+  int ret = OK;
+  int i;
+
+  flags = enter_critical_section();
+
+  if (!setup)
+    {
+      /* This is a request to tear down the poll */
+
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      if (slot != NULL)
+        {
+          *slot     = NULL;
+          fds->priv = NULL;
+        }
+
+      goto errout;
+    }
+
+  /* Find an available slot for the poll structure reference */
+
+  for (i = 0; i < CONFIG_CDCACM_NPOLLWAITERS; i++)
+    {
+      if (priv->fds[i] == NULL)
+        {
+          priv->fds[i] = fds;
+          fds->priv    = &priv->fds[i];
+          break;
+        }
+    }
+
+  if (i >= CONFIG_CDCACM_NPOLLWAITERS)
+    {
+      fds->priv = NULL;
+      ret       = -EBUSY;
+      goto errout;
+    }
+
+  eventset = 0;
+  if (!sq_empty(&priv->rxpending))
+    {
+      eventset |= POLLIN;
+    }
+
+  if (priv->config == CDCACM_CONFIGIDNONE)
+    {
+      eventset |= POLLHUP;
+    }
+  else if (!sq_empty(&priv->txfree))
+    {
+      eventset |= POLLOUT;
+    }
+
+  poll_notify(priv->fds, CONFIG_CDCACM_NPOLLWAITERS, eventset);
+
+errout:
+  leave_critical_section(flags);
+  return ret;
+}
+#endif /* CONFIG_CDCACM_ZEROCOPY */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -2886,10 +3361,12 @@ int cdcacm_classobject(int minor, FAR struct usbdev_devinfo_s *devinfo,
 #ifdef CONFIG_SERIAL_REMOVABLE
   priv->serdev.disconnected = true;
 #endif
+#ifndef CONFIG_CDCACM_ZEROCOPY
   priv->serdev.recv.size    = CONFIG_CDCACM_RXBUFSIZE;
   priv->serdev.recv.buffer  = priv->rxbuffer;
   priv->serdev.xmit.size    = CONFIG_CDCACM_TXBUFSIZE;
   priv->serdev.xmit.buffer  = priv->txbuffer;
+#endif
   priv->serdev.ops          = &g_uartops;
   priv->serdev.priv         = priv;
 
@@ -2923,7 +3400,16 @@ int cdcacm_classobject(int minor, FAR struct usbdev_devinfo_s *devinfo,
   /* Register the CDC/ACM TTY device */
 
   snprintf(devname, CDCACM_DEVNAME_SIZE, CDCACM_DEVNAME_FORMAT, minor);
+#ifdef CONFIG_CDCACM_ZEROCOPY
+  nxmutex_init(&priv->rdlock);
+  nxmutex_init(&priv->wrlock);
+  nxsem_init(&priv->rdsem, 0, 0);
+  nxsem_init(&priv->wrsem, 0, 0);
+
+  ret = register_driver(devname, &g_zcfops, 0666, priv);
+#else
   ret = uart_register(devname, &priv->serdev);
+#endif
   if (ret < 0)
     {
       usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_UARTREGISTER),
@@ -2935,6 +3421,13 @@ int cdcacm_classobject(int minor, FAR struct usbdev_devinfo_s *devinfo,
   return OK;
 
 errout_with_class:
+#ifdef CONFIG_CDCACM_ZEROCOPY
+  nxmutex_destroy(&priv->rdlock);
+  nxmutex_destroy(&priv->wrlock);
+  nxsem_destroy(&priv->rdsem);
+  nxsem_destroy(&priv->wrsem);
+#endif
+
   kmm_free(alloc);
   return ret;
 }
@@ -3069,6 +3562,12 @@ void cdcacm_uninitialize(FAR void *handle)
        */
 
       wd_cancel(&priv->rxfailsafe);
+#ifdef CONFIG_CDCACM_ZEROCOPY
+      nxmutex_destroy(&priv->rdlock);
+      nxmutex_destroy(&priv->wrlock);
+      nxsem_destroy(&priv->rdsem);
+      nxsem_destroy(&priv->wrsem);
+#endif
       kmm_free(priv);
       return;
     }
@@ -3101,6 +3600,12 @@ void cdcacm_uninitialize(FAR void *handle)
   /* And free the memory resources. */
 
   wd_cancel(&priv->rxfailsafe);
+#ifdef CONFIG_CDCACM_ZEROCOPY
+  nxmutex_destroy(&priv->rdlock);
+  nxmutex_destroy(&priv->wrlock);
+  nxsem_destroy(&priv->rdsem);
+  nxsem_destroy(&priv->wrsem);
+#endif
   kmm_free(priv);
 
 #else
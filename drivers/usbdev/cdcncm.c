@@ -0,0 +1,2897 @@
+/****************************************************************************
+ * drivers/usbdev/cdcncm.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* References:
+ *   [NCM1.0] Universal Serial Bus - Communications Class - Subclass
+ *            Specification for Network Control Model Devices - Rev 1.0
+ *            (Errata 1)
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <arpa/inet.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/irq.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/usb/usbdev.h>
+#include <nuttx/usb/cdc.h>
+#include <nuttx/usb/usbdev_trace.h>
+
+#ifdef CONFIG_NET_PKT
+#  include <nuttx/net/pkt.h>
+#endif
+
+#ifdef CONFIG_BOARD_USBDEV_SERIALSTR
+#include <nuttx/board.h>
+#endif
+
+#include "cdcncm.h"
+
+#ifdef CONFIG_NET_CDCNCM
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Work queue support is required. */
+
+#if !defined(CONFIG_SCHED_WORKQUEUE)
+#  error Work queue support is required in this configuration (CONFIG_SCHED_WORKQUEUE)
+#endif
+
+/* The low priority work queue is preferred.  If it is not enabled, LPWORK
+ * will be the same as HPWORK. NOTE: Use of the high priority work queue will
+ * have a negative impact on interrupt handling latency and overall system
+ * performance.  This should be avoided.
+ */
+
+#define ETHWORK LPWORK
+
+/* CONFIG_CDCNCM_NINTERFACES determines the number of physical interfaces
+ * that will be supported.
+ */
+
+#ifndef CONFIG_CDCNCM_NINTERFACES
+#  define CONFIG_CDCNCM_NINTERFACES 1
+#endif
+
+/* The NTB size is bounded by the 16-bit length of a USB request */
+
+#if CONFIG_CDCNCM_NTB_MAXSIZE < CDCNCM_NTB_MINSIZE || \
+    CONFIG_CDCNCM_NTB_MAXSIZE > 65535
+#  error CONFIG_CDCNCM_NTB_MAXSIZE must be in the range 2048-65535
+#endif
+
+/* TX timeout = 1 minute */
+
+#define CDCNCM_TXTIMEOUT (60*CLK_TCK)
+
+/* Largest Ethernet frame handled by the driver */
+
+#define CDCNCM_MAXFRAME   (CONFIG_NET_ETH_PKTSIZE)
+
+#define CDCNCM_ALIGN(n)   (((n) + CDCNCM_NTB_ALIGN - 1) & \
+                           ~(CDCNCM_NTB_ALIGN - 1))
+
+/* Link notifications sent once the host selects the data interface */
+
+#define CDCNCM_NOTIFY_NONE    0
+#define CDCNCM_NOTIFY_CONNECT 1
+#define CDCNCM_NOTIFY_SPEED   2
+
+/* This is a helper pointer for accessing the contents of Ethernet header */
+
+#define BUF ((FAR struct eth_hdr_s *)NETLLBUF)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The cdcncm_driver_s encapsulates all state information for a single
+ * hardware interface
+ */
+
+struct cdcncm_driver_s
+{
+  /* USB CDC-NCM device */
+
+  struct usbdevclass_driver_s  usbdev;      /* USB device class vtable */
+  struct usbdev_devinfo_s      devinfo;
+  FAR struct usbdev_req_s     *ctrlreq;     /* Allocated control request */
+  FAR struct usbdev_ep_s      *epint;       /* Interrupt IN endpoint */
+  FAR struct usbdev_ep_s      *epbulkin;    /* Bulk IN endpoint */
+  FAR struct usbdev_ep_s      *epbulkout;   /* Bulk OUT endpoint */
+  uint8_t                      config;      /* Selected configuration number */
+
+  FAR struct usbdev_req_s     *notifyreq;   /* Interrupt IN request */
+  uint8_t                      notify;      /* Next link notification */
+
+  /* Read requests for OUT NTBs and write requests for IN NTBs */
+
+  FAR struct usbdev_req_s     *rdreq[CDCNCM_NRDREQS];
+  uint8_t                      rxpending;   /* Set of rdreq[] holding an NTB */
+  uint8_t                      rxnext;      /* Next rdreq[] to complete */
+
+  FAR struct usbdev_req_s     *wrreq[CDCNCM_NWRREQS];
+  uint8_t                      wrfree;      /* Set of idle wrreq[] */
+  sem_t                        wrreq_idle;  /* Counts the idle wrreq[] */
+  bool                         txdone;      /* Did a write request complete? */
+
+  /* The IN NTB being filled.  The NTH is written at the start of txreq,
+   * the datagrams follow and their pointer table is kept in txdpe[] until
+   * the NDP is appended when the NTB is sent.
+   */
+
+  FAR struct usbdev_req_s     *txreq;       /* NULL if no NTB is open */
+  uint16_t                     txlen;       /* Bytes used in txreq */
+  uint16_t                     txseq;       /* wSequence of the next NTB */
+  uint16_t                     ntbinsize;   /* dwNtbInMaxSize set by the host */
+  uint8_t                      ntxdgrams;   /* Datagrams in txreq */
+  uint16_t                     txdpe[CONFIG_CDCNCM_NTB_MAXDGRAMS][2];
+
+  /* Network device */
+
+  bool                         bifup;       /* true:ifup false:ifdown */
+  struct work_s                irqwork;     /* For deferring interrupt work
+                                             * to the work queue */
+  struct work_s                pollwork;    /* For deferring poll work to
+                                             * the work queue */
+
+  /* This holds the information visible to the NuttX network */
+
+  struct net_driver_s          dev;         /* Interface understood by the
+                                             * network */
+  bool                         registered;  /* netdev is currently registered */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Network Device ***********************************************************/
+
+/* Common TX logic */
+
+static int  cdcncm_txbegin(FAR struct cdcncm_driver_s *self, bool wait);
+static void cdcncm_txflush(FAR struct cdcncm_driver_s *self);
+static int  cdcncm_transmit(FAR struct cdcncm_driver_s *self, bool wait);
+static int  cdcncm_txpoll(FAR struct net_driver_s *dev);
+static void cdcncm_poll(FAR struct cdcncm_driver_s *self);
+
+/* Interrupt handling */
+
+static void cdcncm_reply(struct cdcncm_driver_s *priv);
+static void cdcncm_input(FAR struct cdcncm_driver_s *self,
+              FAR const uint8_t *frame, uint16_t len);
+static void cdcncm_receive(FAR struct cdcncm_driver_s *self,
+              FAR struct usbdev_req_s *req);
+static void cdcncm_txdone(FAR struct cdcncm_driver_s *priv);
+
+static void cdcncm_interrupt_work(FAR void *arg);
+
+/* NuttX callback functions */
+
+static int  cdcncm_ifup(FAR struct net_driver_s *dev);
+static int  cdcncm_ifdown(FAR struct net_driver_s *dev);
+
+static void cdcncm_txavail_work(FAR void *arg);
+static int  cdcncm_txavail(FAR struct net_driver_s *dev);
+
+#if defined(CONFIG_NET_MCASTGROUP) || defined(CONFIG_NET_ICMPv6)
+static int  cdcncm_addmac(FAR struct net_driver_s *dev,
+              FAR const uint8_t *mac);
+#ifdef CONFIG_NET_MCASTGROUP
+static int  cdcncm_rmmac(FAR struct net_driver_s *dev,
+              FAR const uint8_t *mac);
+#endif
+#ifdef CONFIG_NET_ICMPv6
+static void cdcncm_ipv6multicast(FAR struct cdcncm_driver_s *priv);
+#endif
+#endif
+#ifdef CONFIG_NETDEV_IOCTL
+static int  cdcncm_ioctl(FAR struct net_driver_s *dev, int cmd,
+              unsigned long arg);
+#endif
+
+/* USB Device Class Driver **************************************************/
+
+/* USB Device Class methods */
+
+static int  cdcncm_bind(FAR struct usbdevclass_driver_s *driver,
+              FAR struct usbdev_s *dev);
+
+static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
+              FAR struct usbdev_s *dev);
+
+static int  cdcncm_setup(FAR struct usbdevclass_driver_s *driver,
+              FAR struct usbdev_s *dev, FAR const struct usb_ctrlreq_s *ctrl,
+              FAR uint8_t *dataout, size_t outlen);
+
+static void cdcncm_disconnect(FAR struct usbdevclass_driver_s *driver,
+                              FAR struct usbdev_s *dev);
+
+/* USB Device Class helpers */
+
+static void cdcncm_ep0incomplete(FAR struct usbdev_ep_s *ep,
+              FAR struct usbdev_req_s *req);
+static void cdcncm_rdcomplete(FAR struct usbdev_ep_s *ep,
+              FAR struct usbdev_req_s *req);
+static void cdcncm_wrcomplete(FAR struct usbdev_ep_s *ep,
+              FAR struct usbdev_req_s *req);
+static void cdcncm_notifycomplete(FAR struct usbdev_ep_s *ep,
+              FAR struct usbdev_req_s *req);
+
+static void cdcncm_mkepdesc(int epidx,
+              FAR struct usb_epdesc_s *epdesc,
+              FAR struct usbdev_devinfo_s *devinfo, bool hispeed);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* USB Device Class Methods */
+
+static const struct usbdevclass_driverops_s g_usbdevops =
+{
+  cdcncm_bind,
+  cdcncm_unbind,
+  cdcncm_setup,
+  cdcncm_disconnect,
+  NULL,
+  NULL
+};
+
+#ifndef CONFIG_CDCNCM_COMPOSITE
+static const struct usb_devdesc_s g_devdesc =
+{
+  USB_SIZEOF_DEVDESC,
+  USB_DESC_TYPE_DEVICE,
+  {
+    LSBYTE(0x0200),
+    MSBYTE(0x0200)
+  },
+  USB_CLASS_CDC,
+  CDC_SUBCLASS_NCM,
+  CDC_PROTO_NONE,
+  CONFIG_CDCNCM_EP0MAXPACKET,
+  {
+    LSBYTE(CONFIG_CDCNCM_VENDORID),
+    MSBYTE(CONFIG_CDCNCM_VENDORID)
+  },
+  {
+    LSBYTE(CONFIG_CDCNCM_PRODUCTID),
+    MSBYTE(CONFIG_CDCNCM_PRODUCTID)
+  },
+  {
+    LSBYTE(CDCNCM_VERSIONNO),
+    MSBYTE(CDCNCM_VERSIONNO)
+  },
+  CDCNCM_MANUFACTURERSTRID,
+  CDCNCM_PRODUCTSTRID,
+  CDCNCM_SERIALSTRID,
+  CDCNCM_NCONFIGS
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cdcncm_putle16 and cdcncm_putle32
+ *
+ * Description:
+ *   Store a little-endian value into an NCM structure.
+ *
+ ****************************************************************************/
+
+static void cdcncm_putle16(FAR uint8_t *dest, uint16_t val)
+{
+  dest[0] = LSBYTE(val);
+  dest[1] = MSBYTE(val);
+}
+
+static void cdcncm_putle32(FAR uint8_t *dest, uint32_t val)
+{
+  cdcncm_putle16(dest, (uint16_t)val);
+  cdcncm_putle16(dest + 2, (uint16_t)(val >> 16));
+}
+
+/****************************************************************************
+ * Name: cdcncm_wrrelease
+ *
+ * Description:
+ *   Return a write request to the set of idle requests.  This function
+ *   may execute in the context of an interrupt handler.
+ *
+ ****************************************************************************/
+
+static void cdcncm_wrrelease(FAR struct cdcncm_driver_s *self,
+                             FAR struct usbdev_req_s *req)
+{
+  irqstate_t flags;
+  int rc;
+
+  flags = enter_critical_section();
+  self->wrfree |= 1 << (uintptr_t)req->priv;
+  leave_critical_section(flags);
+
+  rc = nxsem_post(&self->wrreq_idle);
+  if (rc != OK)
+    {
+      nerr("nxsem_post failed! rc: %d\n", rc);
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_txbusy
+ *
+ * Description:
+ *   Return true if an IN NTB is being transferred on the bulk IN endpoint.
+ *
+ ****************************************************************************/
+
+static bool cdcncm_txbusy(FAR struct cdcncm_driver_s *self)
+{
+  uint8_t idle = self->wrfree;
+
+  if (self->txreq != NULL)
+    {
+      idle |= 1 << (uintptr_t)self->txreq->priv;
+    }
+
+  return idle != (1 << CDCNCM_NWRREQS) - 1;
+}
+
+/****************************************************************************
+ * Name: cdcncm_txfits
+ *
+ * Description:
+ *   Check if a datagram of 'len' bytes still fits into the open NTB along
+ *   with the NDP that describes it.
+ *
+ ****************************************************************************/
+
+static bool cdcncm_txfits(FAR struct cdcncm_driver_s *self, uint16_t len)
+{
+  uint32_t end;
+
+  if (self->ntxdgrams >= CONFIG_CDCNCM_NTB_MAXDGRAMS)
+    {
+      return false;
+    }
+
+  end = CDCNCM_ALIGN(CDCNCM_ALIGN((uint32_t)self->txlen) + len) +
+        SIZEOF_NCM_NDP16(self->ntxdgrams + 2);
+
+  return end <= self->ntbinsize;
+}
+
+/****************************************************************************
+ * Name: cdcncm_txbegin
+ *
+ * Description:
+ *   Open a new IN NTB in an idle write request.
+ *
+ * Input Parameters:
+ *   self - Reference to the driver state structure
+ *   wait - Wait for a transfer to complete if no write request is idle
+ *
+ * Returned Value:
+ *   OK on success; a negated errno on failure
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int cdcncm_txbegin(FAR struct cdcncm_driver_s *self, bool wait)
+{
+  irqstate_t flags;
+  int ret;
+  int i;
+
+  DEBUGASSERT(self->txreq == NULL);
+
+  if (wait)
+    {
+      ret = nxsem_tickwait_uninterruptible(&self->wrreq_idle,
+                                           CDCNCM_TXTIMEOUT);
+    }
+  else
+    {
+      ret = nxsem_trywait(&self->wrreq_idle);
+    }
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  flags = enter_critical_section();
+  for (i = 0; i < CDCNCM_NWRREQS - 1; i++)
+    {
+      if ((self->wrfree & (1 << i)) != 0)
+        {
+          break;
+        }
+    }
+
+  DEBUGASSERT((self->wrfree & (1 << i)) != 0);
+  self->wrfree &= ~(1 << i);
+  leave_critical_section(flags);
+
+  self->txreq     = self->wrreq[i];
+  self->txlen     = SIZEOF_NCM_NTH16;
+  self->ntxdgrams = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cdcncm_txflush
+ *
+ * Description:
+ *   Complete the open NTB with its NTH and NDP and start its transfer.
+ *
+ * Input Parameters:
+ *   self - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void cdcncm_txflush(FAR struct cdcncm_driver_s *self)
+{
+  FAR struct usbdev_req_s *req = self->txreq;
+  FAR struct cdc_ncm_nth16_s *nth;
+  FAR struct cdc_ncm_ndp16_s *ndp;
+  FAR uint8_t *dpe;
+  uint16_t ndpoff;
+  uint16_t ndplen;
+  int ret;
+  int i;
+
+  if (req == NULL || self->ntxdgrams == 0)
+    {
+      return;
+    }
+
+  /* The NDP follows the datagrams.  Its table ends with a zero entry. */
+
+  ndpoff = CDCNCM_ALIGN(self->txlen);
+  ndplen = SIZEOF_NCM_NDP16(self->ntxdgrams + 1);
+
+  ndp = (FAR struct cdc_ncm_ndp16_s *)(req->buf + ndpoff);
+  cdcncm_putle32(ndp->sign, NCM_NDP16_NOCRC_SIGN);
+  cdcncm_putle16(ndp->len, ndplen);
+  cdcncm_putle16(ndp->next, 0);
+
+  dpe = ndp->dpe[0];
+  for (i = 0; i < self->ntxdgrams; i++, dpe += 4)
+    {
+      cdcncm_putle16(dpe, self->txdpe[i][0]);
+      cdcncm_putle16(dpe + 2, self->txdpe[i][1]);
+    }
+
+  memset(dpe, 0, 4);
+
+  nth = (FAR struct cdc_ncm_nth16_s *)req->buf;
+  cdcncm_putle32(nth->sign, NCM_NTH16_SIGNATURE);
+  cdcncm_putle16(nth->hdrlen, SIZEOF_NCM_NTH16);
+  cdcncm_putle16(nth->seq, self->txseq++);
+  cdcncm_putle16(nth->blklen, ndpoff + ndplen);
+  cdcncm_putle16(nth->ndpindex, ndpoff);
+
+  /* An NTB shorter than dwNtbInMaxSize is terminated by a short packet */
+
+  req->len   = ndpoff + ndplen;
+  req->flags = req->len < self->ntbinsize ? USBDEV_REQFLAGS_NULLPKT : 0;
+
+  self->txreq = NULL;
+
+  ret = EP_SUBMIT(self->epbulkin, req);
+  if (ret < 0)
+    {
+      nerr("ERROR: EP_SUBMIT failed: %d\n", ret);
+      NETDEV_TXERRORS(&self->dev);
+      cdcncm_wrrelease(self, req);
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_transmit
+ *
+ * Description:
+ *   Add the frame in d_iob to the open NTB, opening a new one if there is
+ *   none or the frame does not fit.  The NTB is sent by cdcncm_txflush().
+ *
+ * Input Parameters:
+ *   self - Reference to the driver state structure
+ *   wait - Wait for a write request if a new NTB is needed and none is idle
+ *
+ * Returned Value:
+ *   OK on success; a negated errno on failure
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int cdcncm_transmit(FAR struct cdcncm_driver_s *self, bool wait)
+{
+  FAR struct net_driver_s *dev = &self->dev;
+  uint16_t off;
+  int ret;
+
+  if (self->txreq != NULL && !cdcncm_txfits(self, dev->d_len))
+    {
+      cdcncm_txflush(self);
+    }
+
+  if (self->txreq == NULL)
+    {
+      ret = cdcncm_txbegin(self, wait);
+      if (ret < 0)
+        {
+          NETDEV_TXERRORS(dev);
+          return ret;
+        }
+    }
+
+  /* Increment statistics */
+
+  NETDEV_TXPACKETS(dev);
+
+  /* Copy the frame, link layer header included, from the IOB chain into
+   * the NTB.  This is the only copy on the way to the bus.
+   */
+
+  off = CDCNCM_ALIGN(self->txlen);
+  iob_copyout(self->txreq->buf + off, dev->d_iob, dev->d_len,
+              -NET_LL_HDRLEN(dev));
+
+  self->txdpe[self->ntxdgrams][0] = off;
+  self->txdpe[self->ntxdgrams][1] = dev->d_len;
+  self->ntxdgrams++;
+  self->txlen = off + dev->d_len;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cdcncm_txpoll
+ *
+ * Description:
+ *   The transmitter is available, check if the network has any outgoing
+ *   packets ready to send.  This is a callback from devif_poll().
+ *   devif_poll() may be called:
+ *
+ *   1. When the preceding TX packet send is complete,
+ *   2. When the preceding TX packet send times out and the interface is
+ *      reset
+ *   3. During normal TX polling
+ *
+ *   On entry the open NTB has room for a full-size frame.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   OK on success; a negated errno on failure
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int cdcncm_txpoll(FAR struct net_driver_s *dev)
+{
+  FAR struct cdcncm_driver_s *priv =
+    (FAR struct cdcncm_driver_s *)dev->d_private;
+
+  /* Add the packet to the NTB */
+
+  if (dev->d_len > 0)
+    {
+      cdcncm_transmit(priv, false);
+    }
+
+  /* Continue the poll as long as the NTB, or a new one, has room for
+   * another full-size frame.
+   */
+
+  if (!cdcncm_txfits(priv, CDCNCM_MAXFRAME))
+    {
+      cdcncm_txflush(priv);
+      if (cdcncm_txbegin(priv, false) < 0)
+        {
+          return 1;
+        }
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: cdcncm_poll
+ *
+ * Description:
+ *   Poll the network for outgoing frames.  The NTB is sent at once if the
+ *   bulk IN endpoint is idle.  Otherwise it is kept open and sent when the
+ *   transfer in progress completes, so that the frames queued meanwhile
+ *   share one transfer.
+ *
+ * Input Parameters:
+ *   self - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void cdcncm_poll(FAR struct cdcncm_driver_s *self)
+{
+  if (self->txreq != NULL && !cdcncm_txfits(self, CDCNCM_MAXFRAME))
+    {
+      cdcncm_txflush(self);
+    }
+
+  if (self->txreq != NULL || cdcncm_txbegin(self, false) == OK)
+    {
+      devif_poll(&self->dev, cdcncm_txpoll);
+    }
+
+  if (!cdcncm_txbusy(self))
+    {
+      cdcncm_txflush(self);
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_reply
+ *
+ * Description:
+ *   After a packet has been received and dispatched to the network, it
+ *   may return return with an outgoing packet.  This function checks for
+ *   that case and performs the transmission if necessary.
+ *
+ * Input Parameters:
+ *   priv - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void cdcncm_reply(struct cdcncm_driver_s *priv)
+{
+  /* If the packet dispatch resulted in data that should be sent out on the
+   * network, the field d_len will set to a value > 0.
+   */
+
+  if (priv->dev.d_len > 0)
+    {
+      /* And add the packet to the NTB */
+
+      cdcncm_transmit(priv, true);
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_input
+ *
+ * Description:
+ *   Pass one datagram of a received NTB to the network.
+ *
+ * Input Parameters:
+ *   self  - Reference to the driver state structure
+ *   frame - The Ethernet frame in the NTB
+ *   len   - The length of the frame
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void cdcncm_input(FAR struct cdcncm_driver_s *self,
+                         FAR const uint8_t *frame, uint16_t len)
+{
+  FAR struct net_driver_s *dev = &self->dev;
+  FAR struct iob_s *iob;
+
+  /* Check if the packet is a valid size for the network buffer
+   * configuration.
+   */
+
+  if (len < ETH_HDRLEN || len > CDCNCM_MAXFRAME)
+    {
+      NETDEV_RXERRORS(dev);
+      return;
+    }
+
+  /* Copy the frame straight into an IOB chain.  The Ethernet header goes
+   * to the guard space in front of the network layer data.
+   */
+
+  iob = iob_tryalloc(false);
+  if (iob == NULL)
+    {
+      NETDEV_RXDROPPED(dev);
+      return;
+    }
+
+  iob_reserve(iob, CONFIG_NET_LL_GUARDSIZE);
+  if (iob_trycopyin(iob, frame, len, -NET_LL_HDRLEN(dev), false) != len)
+    {
+      iob_free_chain(iob);
+      NETDEV_RXDROPPED(dev);
+      return;
+    }
+
+  netdev_iob_replace(dev, iob);
+  dev->d_len = len;
+
+  NETDEV_RXPACKETS(dev);
+
+#ifdef CONFIG_NET_PKT
+  /* When packet sockets are enabled, feed the frame into the tap */
+
+  pkt_input(dev);
+#endif
+
+  /* We only accept IP packets of the configured type and ARP packets */
+
+#ifdef CONFIG_NET_IPv4
+  if (BUF->type == HTONS(ETHTYPE_IP))
+    {
+      ninfo("IPv4 frame\n");
+      NETDEV_RXIPV4(dev);
+
+      /* Receive an IPv4 packet from the network device */
+
+      ipv4_input(dev);
+
+      /* Check for a reply to the IPv4 packet */
+
+      cdcncm_reply(self);
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if (BUF->type == HTONS(ETHTYPE_IP6))
+    {
+      ninfo("IPv6 frame\n");
+      NETDEV_RXIPV6(dev);
+
+      /* Dispatch IPv6 packet to the network layer */
+
+      ipv6_input(dev);
+
+      /* Check for a reply to the IPv6 packet */
+
+      cdcncm_reply(self);
+    }
+  else
+#endif
+#ifdef CONFIG_NET_ARP
+  if (BUF->type == HTONS(ETHTYPE_ARP))
+    {
+      /* Dispatch ARP packet to the network layer */
+
+      arp_input(dev);
+      NETDEV_RXARP(dev);
+
+      /* If the above function invocation resulted in data that should be
+       * sent out on the network, d_len field will set to a value > 0.
+       */
+
+      cdcncm_reply(self);
+    }
+  else
+#endif
+    {
+      NETDEV_RXDROPPED(dev);
+    }
+
+  /* Return the buffer, leaving the device in IOB mode for devif_poll() */
+
+  netdev_iob_release(dev);
+}
+
+/****************************************************************************
+ * Name: cdcncm_receive
+ *
+ * Description:
+ *   An NTB was received on the bulk OUT endpoint.  Walk its NDPs and pass
+ *   each datagram to the network.
+ *
+ * Input Parameters:
+ *   self - Reference to the driver state structure
+ *   req  - The read request holding the NTB
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void cdcncm_receive(FAR struct cdcncm_driver_s *self,
+                           FAR struct usbdev_req_s *req)
+{
+  FAR const struct cdc_ncm_nth16_s *nth;
+  FAR const struct cdc_ncm_ndp16_s *ndp;
+  FAR const uint8_t *dpe;
+  FAR const uint8_t *end;
+  uint16_t ndpoff;
+  uint16_t ndplen;
+  uint16_t dgoff;
+  uint16_t dglen;
+  uint16_t len;
+  int nndps;
+
+  /* Check the NTH.  A zero wBlockLength means that the NTB extends to the
+   * end of the transfer.
+   */
+
+  nth = (FAR const struct cdc_ncm_nth16_s *)req->buf;
+  len = req->xfrd;
+
+  if (len < SIZEOF_NCM_NTH16 ||
+      GETUINT32(nth->sign) != NCM_NTH16_SIGNATURE ||
+      GETUINT16(nth->hdrlen) != SIZEOF_NCM_NTH16 ||
+      GETUINT16(nth->blklen) > len)
+    {
+      nwarn("WARNING: Bad NTH16, length %u\n", len);
+      NETDEV_RXERRORS(&self->dev);
+      return;
+    }
+
+  if (GETUINT16(nth->blklen) != 0)
+    {
+      len = GETUINT16(nth->blklen);
+    }
+
+  /* Walk the chain of NDPs */
+
+  ndpoff = GETUINT16(nth->ndpindex);
+  for (nndps = 0; ndpoff != 0 && nndps < CDCNCM_MAXNDPS; nndps++)
+    {
+      if ((uint32_t)ndpoff + SIZEOF_NCM_NDP16(2) > len)
+        {
+          break;
+        }
+
+      ndp    = (FAR const struct cdc_ncm_ndp16_s *)(req->buf + ndpoff);
+      ndplen = GETUINT16(ndp->len);
+
+      if (GETUINT32(ndp->sign) != NCM_NDP16_NOCRC_SIGN ||
+          ndplen < SIZEOF_NCM_NDP16(2) || (uint32_t)ndpoff + ndplen > len)
+        {
+          break;
+        }
+
+      /* The table ends with a zero entry or with the NDP */
+
+      end = (FAR const uint8_t *)ndp + ndplen;
+      for (dpe = ndp->dpe[0]; dpe + 4 <= end; dpe += 4)
+        {
+          FAR const uint8_t *dplen = dpe + 2;
+
+          dgoff = GETUINT16(dpe);
+          dglen = GETUINT16(dplen);
+
+          if (dgoff == 0 || dglen == 0)
+            {
+              break;
+            }
+
+          if ((uint32_t)dgoff + dglen > len)
+            {
+              NETDEV_RXERRORS(&self->dev);
+              continue;
+            }
+
+          cdcncm_input(self, req->buf + dgoff, dglen);
+        }
+
+      ndpoff = GETUINT16(ndp->next);
+    }
+
+  if (ndpoff != 0)
+    {
+      nwarn("WARNING: Bad NDP16 at %u\n", ndpoff);
+      NETDEV_RXERRORS(&self->dev);
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_txdone
+ *
+ * Description:
+ *   An interrupt was received indicating that the last TX packet(s) is done
+ *
+ * Input Parameters:
+ *   priv - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void cdcncm_txdone(FAR struct cdcncm_driver_s *priv)
+{
+  /* Check for errors and update statistics */
+
+  NETDEV_TXDONE(&priv->dev);
+
+  /* In any event, poll the network for new TX data.  This also sends the
+   * NTB that was filled during the transfer.
+   */
+
+  cdcncm_poll(priv);
+}
+
+/****************************************************************************
+ * Name: cdcncm_interrupt_work
+ *
+ * Description:
+ *   Perform interrupt related work from the worker thread
+ *
+ * Input Parameters:
+ *   arg - The argument passed when work_queue() was called.
+ *
+ * Returned Value:
+ *   OK on success
+ *
+ * Assumptions:
+ *   Runs on a worker thread.
+ *
+ ****************************************************************************/
+
+static void cdcncm_interrupt_work(FAR void *arg)
+{
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)arg;
+  FAR struct usbdev_req_s *req;
+  irqstate_t flags;
+
+  /* Lock the network and serialize driver operations if necessary.
+   * NOTE: Serialization is only required in the case where the driver work
+   * is performed on an LP worker thread and where more than one LP worker
+   * thread has been configured.
+   */
+
+  net_lock();
+
+  /* Process the received NTBs in the order in which the read requests
+   * were queued, then give them back to the bulk OUT endpoint.
+   */
+
+  while ((self->rxpending & (1 << self->rxnext)) != 0)
+    {
+      req = self->rdreq[self->rxnext];
+      if (req->result == OK)
+        {
+          cdcncm_receive(self, req);
+        }
+
+      flags = enter_critical_section();
+      self->rxpending &= ~(1 << self->rxnext);
+      EP_SUBMIT(self->epbulkout, req);
+      leave_critical_section(flags);
+
+      self->rxnext = (self->rxnext + 1) % CDCNCM_NRDREQS;
+    }
+
+  /* Check if a packet transmission just completed.  If so, call
+   * cdcncm_txdone. This may disable further Tx interrupts if there
+   * are no pending transmissions.
+   */
+
+  if (self->txdone)
+    {
+      flags = enter_critical_section();
+      self->txdone = false;
+      leave_critical_section(flags);
+
+      cdcncm_txdone(self);
+    }
+
+  /* Send the replies to the received frames unless a transfer is already
+   * in progress.
+   */
+
+  else if (!cdcncm_txbusy(self))
+    {
+      cdcncm_txflush(self);
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: cdcncm_ifup
+ *
+ * Description:
+ *   NuttX Callback: Bring up the Ethernet interface when an IP address is
+ *   provided
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int cdcncm_ifup(FAR struct net_driver_s *dev)
+{
+  FAR struct cdcncm_driver_s *priv =
+    (FAR struct cdcncm_driver_s *)dev->d_private;
+
+#ifdef CONFIG_NET_IPv4
+  ninfo("Bringing up: %u.%u.%u.%u\n",
+        ip4_addr1(dev->d_ipaddr), ip4_addr2(dev->d_ipaddr),
+        ip4_addr3(dev->d_ipaddr), ip4_addr4(dev->d_ipaddr));
+#endif
+#ifdef CONFIG_NET_IPv6
+  ninfo("Bringing up: %04x:%04x:%04x:%04x:%04x:%04x:%04x:%04x\n",
+        dev->d_ipv6addr[0], dev->d_ipv6addr[1], dev->d_ipv6addr[2],
+        dev->d_ipv6addr[3], dev->d_ipv6addr[4], dev->d_ipv6addr[5],
+        dev->d_ipv6addr[6], dev->d_ipv6addr[7]);
+#endif
+
+  /* Initialize PHYs, Ethernet interface, and setup up Ethernet interrupts */
+
+  /* Instantiate MAC address from priv->dev.d_mac.ether.ether_addr_octet */
+
+#ifdef CONFIG_NET_ICMPv6
+  /* Set up IPv6 multicast address filtering */
+
+  cdcncm_ipv6multicast(priv);
+#endif
+
+  priv->bifup = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cdcncm_ifdown
+ *
+ * Description:
+ *   NuttX Callback: Stop the interface.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int cdcncm_ifdown(FAR struct net_driver_s *dev)
+{
+  FAR struct cdcncm_driver_s *priv =
+    (FAR struct cdcncm_driver_s *)dev->d_private;
+  irqstate_t flags;
+
+  /* Disable the Ethernet interrupt */
+
+  flags = enter_critical_section();
+
+  /* Put the EMAC in its reset, non-operational state.  This should be
+   * a known configuration that will guarantee the cdcncm_ifup() always
+   * successfully brings the interface back up.
+   */
+
+  /* Mark the device "down" */
+
+  priv->bifup = false;
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cdcncm_txavail_work
+ *
+ * Description:
+ *   Perform an out-of-cycle poll on the worker thread.
+ *
+ * Input Parameters:
+ *   arg - Reference to the NuttX driver state structure (cast to void*)
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Runs on a work queue thread.
+ *
+ ****************************************************************************/
+
+static void cdcncm_txavail_work(FAR void *arg)
+{
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)arg;
+
+  /* Lock the network and serialize driver operations if necessary.
+   * NOTE: Serialization is only required in the case where the driver work
+   * is performed on an LP worker thread and where more than one LP worker
+   * thread has been configured.
+   */
+
+  net_lock();
+
+  /* Ignore the notification if the interface is not yet up */
+
+  if (self->bifup)
+    {
+      cdcncm_poll(self);
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: cdcncm_txavail
+ *
+ * Description:
+ *   Driver callback invoked when new TX data is available.  This is a
+ *   stimulus perform an out-of-cycle poll and, thereby, reduce the TX
+ *   latency.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int cdcncm_txavail(FAR struct net_driver_s *dev)
+{
+  FAR struct cdcncm_driver_s *priv =
+    (FAR struct cdcncm_driver_s *)dev->d_private;
+
+  /* Is our single work structure available?  It may not be if there are
+   * pending interrupt actions and we will have to ignore the Tx
+   * availability action.
+   */
+
+  if (work_available(&priv->pollwork))
+    {
+      /* Schedule to serialize the poll on the worker thread. */
+
+      work_queue(ETHWORK, &priv->pollwork, cdcncm_txavail_work, priv, 0);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cdcncm_addmac
+ *
+ * Description:
+ *   NuttX Callback: Add the specified MAC address to the hardware multicast
+ *   address filtering
+ *
+ * Input Parameters:
+ *   dev  - Reference to the NuttX driver state structure
+ *   mac  - The MAC address to be added
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_MCASTGROUP) || defined(CONFIG_NET_ICMPv6)
+static int cdcncm_addmac(FAR struct net_driver_s *dev,
+                         FAR const uint8_t *mac)
+{
+  FAR struct cdcncm_driver_s *priv =
+    (FAR struct cdcncm_driver_s *)dev->d_private;
+
+  /* Add the MAC address to the hardware multicast routing table */
+
+  UNUSED(priv); /* Not yet implemented */
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: cdcncm_rmmac
+ *
+ * Description:
+ *   NuttX Callback: Remove the specified MAC address from the hardware
+ *   multicast address filtering
+ *
+ * Input Parameters:
+ *   dev  - Reference to the NuttX driver state structure
+ *   mac  - The MAC address to be removed
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_MCASTGROUP
+static int cdcncm_rmmac(FAR struct net_driver_s *dev, FAR const uint8_t *mac)
+{
+  FAR struct cdcncm_driver_s *priv =
+    (FAR struct cdcncm_driver_s *)dev->d_private;
+
+  /* Add the MAC address to the hardware multicast routing table */
+
+  UNUSED(priv); /* Not yet implemented */
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: cdcncm_ipv6multicast
+ *
+ * Description:
+ *   Configure the IPv6 multicast MAC address.
+ *
+ * Input Parameters:
+ *   priv - A reference to the private driver state structure
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ICMPv6
+static void cdcncm_ipv6multicast(FAR struct cdcncm_driver_s *priv)
+{
+  FAR struct net_driver_s *dev;
+  uint16_t tmp16;
+  uint8_t mac[6];
+
+  /* For ICMPv6, we need to add the IPv6 multicast address
+   *
+   * For IPv6 multicast addresses, the Ethernet MAC is derived by
+   * the four low-order octets OR'ed with the MAC 33:33:00:00:00:00,
+   * so for example the IPv6 address FF02:DEAD:BEEF::1:3 would map
+   * to the Ethernet MAC address 33:33:00:01:00:03.
+   *
+   * NOTES:  This appears correct for the ICMPv6 Router Solicitation
+   * Message, but the ICMPv6 Neighbor Solicitation message seems to
+   * use 33:33:ff:01:00:03.
+   */
+
+  mac[0] = 0x33;
+  mac[1] = 0x33;
+
+  dev    = &priv->dev;
+  tmp16  = dev->d_ipv6addr[6];
+  mac[2] = 0xff;
+  mac[3] = tmp16 >> 8;
+
+  tmp16  = dev->d_ipv6addr[7];
+  mac[4] = tmp16 & 0xff;
+  mac[5] = tmp16 >> 8;
+
+  ninfo("IPv6 Multicast: %02x:%02x:%02x:%02x:%02x:%02x\n",
+        mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+
+  cdcncm_addmac(dev, mac);
+
+#ifdef CONFIG_NET_ICMPv6_AUTOCONF
+  /* Add the IPv6 all link-local nodes Ethernet address.  This is the
+   * address that we expect to receive ICMPv6 Router Advertisement
+   * packets.
+   */
+
+  cdcncm_addmac(dev, g_ipv6_ethallnodes.ether_addr_octet);
+
+#endif /* CONFIG_NET_ICMPv6_AUTOCONF */
+
+#ifdef CONFIG_NET_ICMPv6_ROUTER
+  /* Add the IPv6 all link-local routers Ethernet address.  This is the
+   * address that we expect to receive ICMPv6 Router Solicitation
+   * packets.
+   */
+
+  cdcncm_addmac(dev, g_ipv6_ethallrouters.ether_addr_octet);
+
+#endif /* CONFIG_NET_ICMPv6_ROUTER */
+}
+#endif /* CONFIG_NET_ICMPv6 */
+
+/****************************************************************************
+ * Name: cdcncm_ioctl
+ *
+ * Description:
+ *   Handle network IOCTL commands directed to this device.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *   cmd - The IOCTL command
+ *   arg - The argument for the IOCTL command
+ *
+ * Returned Value:
+ *   OK on success; Negated errno on failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_IOCTL
+static int cdcncm_ioctl(FAR struct net_driver_s *dev, int cmd,
+                      unsigned long arg)
+{
+  /* Decode and dispatch the driver-specific IOCTL command */
+
+  switch (cmd)
+    {
+      /* Add cases here to support the IOCTL commands */
+
+      default:
+        nerr("ERROR: Unrecognized IOCTL command: %d\n", cmd);
+        return -ENOTTY;  /* Special return value for this case */
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * USB Device Class Helpers
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cdcncm_ep0incomplete
+ *
+ * Description:
+ *   Handle completion of EP0 control operations
+ *
+ ****************************************************************************/
+
+static void cdcncm_ep0incomplete(FAR struct usbdev_ep_s *ep,
+                                 FAR struct usbdev_req_s *req)
+{
+  if (req->result || req->xfrd != req->len)
+    {
+      uerr("result: %hd, xfrd: %hu\n", req->result, req->xfrd);
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_rdcomplete
+ *
+ * Description:
+ *   Handle completion of read request on the bulk OUT endpoint.
+ *
+ ****************************************************************************/
+
+static void cdcncm_rdcomplete(FAR struct usbdev_ep_s *ep,
+                              FAR struct usbdev_req_s *req)
+{
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)ep->priv;
+
+  uinfo("buf: %p, flags 0x%hhx, len %hu, xfrd %hu, result %hd\n",
+        req->buf, req->flags, req->len, req->xfrd, req->result);
+
+  switch (req->result)
+    {
+      case -ESHUTDOWN:  /* Disconnection */
+        break;
+
+      default: /* Some other error occurred */
+        uerr("req->result: %hd\n", req->result);
+
+        /* The request is requeued by the worker so that the requests stay
+         * in order.
+         */
+
+        /* Fall through */
+
+      case 0:  /* Normal completion */
+        {
+          self->rxpending |= 1 << (uintptr_t)req->priv;
+          work_queue(ETHWORK, &self->irqwork,
+                     cdcncm_interrupt_work, self, 0);
+        }
+        break;
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_wrcomplete
+ *
+ * Description:
+ *   Handle completion of write request.  This function probably executes
+ *   in the context of an interrupt handler.
+ *
+ ****************************************************************************/
+
+static void cdcncm_wrcomplete(FAR struct usbdev_ep_s *ep,
+                              FAR struct usbdev_req_s *req)
+{
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)ep->priv;
+
+  uinfo("buf: %p, flags 0x%hhx, len %hu, xfrd %hu, result %hd\n",
+        req->buf, req->flags, req->len, req->xfrd, req->result);
+
+  /* The USB device write request is available for upcoming NTBs again. */
+
+  cdcncm_wrrelease(self, req);
+
+  /* Inform the network layer that an NTB was transmitted. */
+
+  self->txdone = true;
+  work_queue(ETHWORK, &self->irqwork, cdcncm_interrupt_work, self, 0);
+}
+
+/****************************************************************************
+ * Name: cdcncm_notify
+ *
+ * Description:
+ *   Send the pending link notification on the interrupt IN endpoint.  The
+ *   host keeps the link down until it has seen NetworkConnection followed
+ *   by ConnectionSpeedChange.  This function may execute in the context of
+ *   an interrupt handler.
+ *
+ ****************************************************************************/
+
+static void cdcncm_notify(FAR struct cdcncm_driver_s *self)
+{
+  FAR struct usbdev_req_s *req = self->notifyreq;
+  FAR struct cdc_notification_s *notify;
+  FAR struct cdc_speedchange_s *speed;
+  uint32_t bitrate;
+  uint16_t len = 0;
+
+  notify = (FAR struct cdc_notification_s *)req->buf;
+  notify->type = USB_REQ_DIR_IN | USB_REQ_TYPE_CLASS |
+                 USB_REQ_RECIPIENT_INTERFACE;
+  cdcncm_putle16(notify->index, self->devinfo.ifnobase);
+
+  switch (self->notify)
+    {
+      case CDCNCM_NOTIFY_CONNECT:
+        notify->notification = ECM_NETWORK_CONNECTION;
+        cdcncm_putle16(notify->value, 1);
+        break;
+
+      case CDCNCM_NOTIFY_SPEED:
+        bitrate = self->usbdev.speed == USB_SPEED_HIGH ?
+                  480000000 : 12000000;
+
+        speed = (FAR struct cdc_speedchange_s *)notify->data;
+        cdcncm_putle32(speed->us, bitrate);
+        cdcncm_putle32(speed->ds, bitrate);
+
+        notify->notification = ECM_SPEED_CHANGE;
+        cdcncm_putle16(notify->value, 0);
+        len = sizeof(struct cdc_speedchange_s);
+        break;
+
+      default:
+        return;
+    }
+
+  cdcncm_putle16(notify->len, len);
+
+  req->len   = SIZEOF_NOTIFICATION_S(len);
+  req->flags = 0;
+
+  if (EP_SUBMIT(self->epint, req) < 0)
+    {
+      self->notify = CDCNCM_NOTIFY_NONE;
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_notifycomplete
+ *
+ * Description:
+ *   Handle completion of a notification on the interrupt IN endpoint.
+ *
+ ****************************************************************************/
+
+static void cdcncm_notifycomplete(FAR struct usbdev_ep_s *ep,
+                                  FAR struct usbdev_req_s *req)
+{
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)ep->priv;
+
+  if (req->result != OK || self->notify == CDCNCM_NOTIFY_SPEED)
+    {
+      self->notify = CDCNCM_NOTIFY_NONE;
+    }
+  else
+    {
+      self->notify = CDCNCM_NOTIFY_SPEED;
+      cdcncm_notify(self);
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_resetconfig
+ *
+ * Description:
+ *   Mark the device as not configured and disable all endpoints.
+ *
+ ****************************************************************************/
+
+static void cdcncm_resetconfig(FAR struct cdcncm_driver_s *self)
+{
+  /* Are we configured? */
+
+  if (self->config != CDCNCM_CONFIGID_NONE)
+    {
+      /* Yes.. but not anymore */
+
+      self->config = CDCNCM_CONFIGID_NONE;
+
+      /* Inform the networking layer that the link is down */
+
+      self->dev.d_ifdown(&self->dev);
+
+      /* Disable endpoints.  This should force completion of all pending
+       * transfers.
+       */
+
+      EP_DISABLE(self->epint);
+      EP_DISABLE(self->epbulkin);
+      EP_DISABLE(self->epbulkout);
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_setconfig
+ *
+ *   Set the device configuration by allocating and configuring endpoints and
+ *   by allocating and queue read and write requests.
+ *
+ ****************************************************************************/
+
+static int cdcncm_setconfig(FAR struct cdcncm_driver_s *self, uint8_t config)
+{
+  struct usb_epdesc_s epdesc;
+  int ret = OK;
+  int i;
+
+  if (config == self->config)
+    {
+      return OK;
+    }
+
+  cdcncm_resetconfig(self);
+
+  if (config == CDCNCM_CONFIGID_NONE)
+    {
+      return OK;
+    }
+
+  if (config != CDCNCM_CONFIGID)
+    {
+      return -EINVAL;
+    }
+
+  cdcncm_mkepdesc(CDCNCM_EP_INTIN_IDX, &epdesc, &self->devinfo, false);
+  ret = EP_CONFIGURE(self->epint, &epdesc, false);
+
+  if (ret < 0)
+    {
+      goto error;
+    }
+
+  self->epint->priv = self;
+
+  bool is_high_speed = (self->usbdev.speed == USB_SPEED_HIGH);
+  cdcncm_mkepdesc(CDCNCM_EP_BULKIN_IDX,
+                  &epdesc, &self->devinfo, is_high_speed);
+  ret = EP_CONFIGURE(self->epbulkin, &epdesc, false);
+
+  if (ret < 0)
+    {
+      goto error;
+    }
+
+  self->epbulkin->priv = self;
+
+  cdcncm_mkepdesc(CDCNCM_EP_BULKOUT_IDX,
+                  &epdesc, &self->devinfo, is_high_speed);
+  ret = EP_CONFIGURE(self->epbulkout, &epdesc, true);
+
+  if (ret < 0)
+    {
+      goto error;
+    }
+
+  self->epbulkout->priv = self;
+
+  /* Queue read requests in the bulk OUT endpoint */
+
+  self->rxpending = 0;
+  self->rxnext    = 0;
+
+  for (i = 0; i < CDCNCM_NRDREQS; i++)
+    {
+      ret = EP_SUBMIT(self->epbulkout, self->rdreq[i]);
+      if (ret != OK)
+        {
+          uerr("EP_SUBMIT failed. ret %d\n", ret);
+          goto error;
+        }
+    }
+
+  /* Start over with the largest IN NTBs until the host asks otherwise */
+
+  self->ntbinsize = CONFIG_CDCNCM_NTB_MAXSIZE;
+  self->txseq     = 0;
+
+  /* We are successfully configured */
+
+  self->config = config;
+
+  /* Set client's MAC address */
+
+  memcpy(self->dev.d_mac.ether.ether_addr_octet,
+         "\x00\xe0\xde\xad\xbe\xef", IFHWADDRLEN);
+
+  /* Report link up to networking layer */
+
+  if (self->dev.d_ifup(&self->dev) == OK)
+    {
+      self->dev.d_flags |= IFF_UP;
+    }
+
+  return OK;
+
+error:
+  cdcncm_resetconfig(self);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cdcncm_setinterface
+ *
+ ****************************************************************************/
+
+static int cdcncm_setinterface(FAR struct cdcncm_driver_s *self,
+                               uint16_t interface, uint16_t altsetting)
+{
+  irqstate_t flags;
+
+  uinfo("interface: %hu, altsetting: %hu\n", interface, altsetting);
+
+  /* The host selects the alternate setting of the data interface with the
+   * bulk endpoints when it starts the link.  Report the link to it.
+   */
+
+  if (self->config != CDCNCM_CONFIGID_NONE &&
+      interface == self->devinfo.ifnobase + 1 && altsetting == 1)
+    {
+      flags = enter_critical_section();
+      if (self->notify == CDCNCM_NOTIFY_NONE)
+        {
+          self->notify = CDCNCM_NOTIFY_CONNECT;
+          cdcncm_notify(self);
+        }
+
+      leave_critical_section(flags);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cdcncm_mkstrdesc
+ *
+ * Description:
+ *   Construct a string descriptor
+ *
+ ****************************************************************************/
+
+static int cdcncm_mkstrdesc(uint8_t id, FAR struct usb_strdesc_s *strdesc)
+{
+  FAR uint8_t *data = (FAR uint8_t *)(strdesc + 1);
+  FAR const char *str;
+  int len;
+  int ndata;
+  int i;
+
+  switch (id)
+    {
+#ifndef CONFIG_CDCNCM_COMPOSITE
+    case 0:
+      {
+        /* Descriptor 0 is the language id */
+
+        strdesc->len  = 4;
+        strdesc->type = USB_DESC_TYPE_STRING;
+        data[0] = LSBYTE(CDCNCM_STR_LANGUAGE);
+        data[1] = MSBYTE(CDCNCM_STR_LANGUAGE);
+        return 4;
+      }
+
+    case CDCNCM_MANUFACTURERSTRID:
+      str = CONFIG_CDCNCM_VENDORSTR;
+      break;
+
+    case CDCNCM_PRODUCTSTRID:
+      str = CONFIG_CDCNCM_PRODUCTSTR;
+      break;
+
+    case CDCNCM_SERIALSTRID:
+#ifdef CONFIG_BOARD_USBDEV_SERIALSTR
+      str = board_usbdev_serialstr();
+#else
+      str = "0";
+#endif
+      break;
+
+    case CDCNCM_CONFIGSTRID:
+      str = "Default";
+      break;
+#endif
+
+    case CDCNCM_MACSTRID:
+      str = "020000112233";
+      break;
+
+    default:
+      uwarn("Unknown string descriptor index: %d\n", id);
+      return -EINVAL;
+    }
+
+  /* The string is utf16-le.  The poor man's utf-8 to utf16-le
+   * conversion below will only handle 7-bit en-us ascii
+   */
+
+  len = strlen(str);
+  if (len > (CDCNCM_MAXSTRLEN / 2))
+    {
+      len = (CDCNCM_MAXSTRLEN / 2);
+    }
+
+  for (i = 0, ndata = 0; i < len; i++, ndata += 2)
+    {
+      data[ndata]     = str[i];
+      data[ndata + 1] = 0;
+    }
+
+  strdesc->len  = ndata + 2;
+  strdesc->type = USB_DESC_TYPE_STRING;
+  return strdesc->len;
+}
+
+/****************************************************************************
+ * Name: cdcncm_mkepdesc
+ *
+ * Description:
+ *   Construct the endpoint descriptor
+ *
+ ****************************************************************************/
+
+static void cdcncm_mkepdesc(int epidx,
+                            FAR struct usb_epdesc_s *epdesc,
+                            FAR struct usbdev_devinfo_s *devinfo,
+                            bool hispeed)
+{
+  uint16_t intin_mxpktsz   = CONFIG_CDCNCM_EPINTIN_FSSIZE;
+  uint16_t bulkout_mxpktsz = CONFIG_CDCNCM_EPBULKOUT_FSSIZE;
+  uint16_t bulkin_mxpktsz  = CONFIG_CDCNCM_EPBULKIN_FSSIZE;
+
+#ifdef CONFIG_USBDEV_DUALSPEED
+  if (hispeed)
+    {
+      intin_mxpktsz   = CONFIG_CDCNCM_EPINTIN_HSSIZE;
+      bulkout_mxpktsz = CONFIG_CDCNCM_EPBULKOUT_HSSIZE;
+      bulkin_mxpktsz  = CONFIG_CDCNCM_EPBULKIN_HSSIZE;
+    }
+#else
+  UNUSED(hispeed);
+#endif
+
+  epdesc->len  = USB_SIZEOF_EPDESC;            /* Descriptor length */
+  epdesc->type = USB_DESC_TYPE_ENDPOINT;       /* Descriptor type */
+
+  switch (epidx)
+    {
+      case CDCNCM_EP_INTIN_IDX:  /* Interrupt IN endpoint */
+        {
+          epdesc->addr            = USB_DIR_IN |
+                                    devinfo->epno[CDCNCM_EP_INTIN_IDX];
+          epdesc->attr            = USB_EP_ATTR_XFER_INT;
+          epdesc->mxpacketsize[0] = LSBYTE(intin_mxpktsz);
+          epdesc->mxpacketsize[1] = MSBYTE(intin_mxpktsz);
+          epdesc->interval        = 5;
+        }
+        break;
+
+      case CDCNCM_EP_BULKIN_IDX:
+        {
+          epdesc->addr            = USB_DIR_IN |
+                                    devinfo->epno[CDCNCM_EP_BULKIN_IDX];
+          epdesc->attr            = USB_EP_ATTR_XFER_BULK;
+          epdesc->mxpacketsize[0] = LSBYTE(bulkin_mxpktsz);
+          epdesc->mxpacketsize[1] = MSBYTE(bulkin_mxpktsz);
+          epdesc->interval        = 0;
+        }
+        break;
+
+      case CDCNCM_EP_BULKOUT_IDX:
+        {
+          epdesc->addr            = USB_DIR_OUT |
+                                    devinfo->epno[CDCNCM_EP_BULKOUT_IDX];
+          epdesc->attr            = USB_EP_ATTR_XFER_BULK;
+          epdesc->mxpacketsize[0] = LSBYTE(bulkout_mxpktsz);
+          epdesc->mxpacketsize[1] = MSBYTE(bulkout_mxpktsz);
+          epdesc->interval        = 0;
+        }
+        break;
+
+      default:
+        DEBUGPANIC();
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_mkcfgdesc
+ *
+ * Description:
+ *   Construct the config descriptor
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_USBDEV_DUALSPEED
+static int16_t cdcncm_mkcfgdesc(FAR uint8_t *desc,
+                                FAR struct usbdev_devinfo_s *devinfo,
+                                uint8_t speed, uint8_t type)
+#else
+static int16_t cdcncm_mkcfgdesc(FAR uint8_t *desc,
+                                FAR struct usbdev_devinfo_s *devinfo)
+#endif
+{
+  FAR struct usb_cfgdesc_s *cfgdesc = NULL;
+  int16_t len = 0;
+  bool is_high_speed = false;
+
+#ifdef CONFIG_USBDEV_DUALSPEED
+  is_high_speed = (speed == USB_SPEED_HIGH);
+
+  /* Check for switches between high and full speed */
+
+  if (type == USB_DESC_TYPE_OTHERSPEEDCONFIG)
+    {
+      is_high_speed = !is_high_speed;
+    }
+#endif
+
+#ifndef CONFIG_CDCNCM_COMPOSITE
+  if (desc)
+    {
+      cfgdesc = (FAR struct usb_cfgdesc_s *)desc;
+      cfgdesc->len         = USB_SIZEOF_CFGDESC;
+      cfgdesc->type        = USB_DESC_TYPE_CONFIG;
+      cfgdesc->ninterfaces = CDCNCM_NINTERFACES;
+      cfgdesc->cfgvalue    = CDCNCM_CONFIGID;
+      cfgdesc->icfg        = devinfo->strbase + CDCNCM_CONFIGSTRID;
+      cfgdesc->attr        = USB_CONFIG_ATTR_ONE | CDCNCM_SELFPOWERED |
+                             CDCNCM_REMOTEWAKEUP;
+      cfgdesc->mxpower     = (CONFIG_USBDEV_MAXPOWER + 1) / 2;
+
+      desc += USB_SIZEOF_CFGDESC;
+    }
+
+  len += USB_SIZEOF_CFGDESC;
+
+#elif defined(CONFIG_COMPOSITE_IAD)
+
+  /* Interface association descriptor */
+
+  if (desc)
+    {
+      FAR struct usb_iaddesc_s *iaddesc = (FAR struct usb_iaddesc_s *)desc;
+
+      iaddesc->len       = USB_SIZEOF_IADDESC;                  /* Descriptor length */
+      iaddesc->type      = USB_DESC_TYPE_INTERFACEASSOCIATION;  /* Descriptor type */
+      iaddesc->firstif   = devinfo->ifnobase;                   /* Number of first interface of the function */
+      iaddesc->nifs      = devinfo->ninterfaces;                /* Number of interfaces associated with the function */
+      iaddesc->classid   = USB_CLASS_CDC;                       /* Class code */
+      iaddesc->subclass  = CDC_SUBCLASS_NCM;                    /* Sub-class code */
+      iaddesc->protocol  = CDC_PROTO_NONE;                      /* Protocol code */
+      iaddesc->ifunction = 0;                                   /* Index to string identifying the function */
+
+      desc += USB_SIZEOF_IADDESC;
+    }
+
+  len += USB_SIZEOF_IADDESC;
+#endif
+
+  /* Communications Class Interface */
+
+  if (desc)
+    {
+      FAR struct usb_ifdesc_s *ifdesc = (FAR struct usb_ifdesc_s *)desc;
+
+      ifdesc->len      = USB_SIZEOF_IFDESC;
+      ifdesc->type     = USB_DESC_TYPE_INTERFACE;
+      ifdesc->ifno     = devinfo->ifnobase;
+      ifdesc->alt      = 0;
+      ifdesc->neps     = 1;
+      ifdesc->classid  = USB_CLASS_CDC;
+      ifdesc->subclass = CDC_SUBCLASS_NCM;
+      ifdesc->protocol = CDC_PROTO_NONE;
+      ifdesc->iif      = 0;
+
+      desc += USB_SIZEOF_IFDESC;
+    }
+
+  len += USB_SIZEOF_IFDESC;
+
+  if (desc)
+    {
+      FAR struct cdc_hdr_funcdesc_s *hdrdesc;
+
+      hdrdesc = (FAR struct cdc_hdr_funcdesc_s *)desc;
+      hdrdesc->size    = SIZEOF_HDR_FUNCDESC;
+      hdrdesc->type    = USB_DESC_TYPE_CSINTERFACE;
+      hdrdesc->subtype = CDC_DSUBTYPE_HDR;
+      hdrdesc->cdc[0]  = LSBYTE(0x0110);
+      hdrdesc->cdc[1]  = MSBYTE(0x0110);
+
+      desc += SIZEOF_HDR_FUNCDESC;
+    }
+
+  len += SIZEOF_HDR_FUNCDESC;
+
+  if (desc)
+    {
+      FAR struct cdc_union_funcdesc_s *uniondesc;
+
+      uniondesc = (FAR struct cdc_union_funcdesc_s *)desc;
+      uniondesc->size = SIZEOF_UNION_FUNCDESC(1);
+      uniondesc->type = USB_DESC_TYPE_CSINTERFACE;
+      uniondesc->subtype = CDC_DSUBTYPE_UNION;
+      uniondesc->master = devinfo->ifnobase;
+      uniondesc->slave[0] = devinfo->ifnobase + 1;
+
+      desc += SIZEOF_UNION_FUNCDESC(1);
+    }
+
+  len += SIZEOF_UNION_FUNCDESC(1);
+
+  if (desc)
+    {
+      FAR struct cdc_ecm_funcdesc_s *ecmdesc;
+
+      ecmdesc = (FAR struct cdc_ecm_funcdesc_s *)desc;
+      ecmdesc->size       = SIZEOF_ECM_FUNCDESC;
+      ecmdesc->type       = USB_DESC_TYPE_CSINTERFACE;
+      ecmdesc->subtype    = CDC_DSUBTYPE_ECM;
+      ecmdesc->mac        = devinfo->strbase + CDCNCM_MACSTRID;
+      ecmdesc->stats[0]   = 0;
+      ecmdesc->stats[1]   = 0;
+      ecmdesc->stats[2]   = 0;
+      ecmdesc->stats[3]   = 0;
+      ecmdesc->maxseg[0]  = LSBYTE(CONFIG_NET_ETH_PKTSIZE);
+      ecmdesc->maxseg[1]  = MSBYTE(CONFIG_NET_ETH_PKTSIZE);
+      ecmdesc->nmcflts[0] = LSBYTE(0);
+      ecmdesc->nmcflts[1] = MSBYTE(0);
+      ecmdesc->npwrflts   = 0;
+
+      desc += SIZEOF_ECM_FUNCDESC;
+    }
+
+  len += SIZEOF_ECM_FUNCDESC;
+
+  if (desc)
+    {
+      FAR struct cdc_ncm_funcdesc_s *ncmdesc;
+
+      ncmdesc = (FAR struct cdc_ncm_funcdesc_s *)desc;
+      ncmdesc->size       = SIZEOF_NCM_FUNCDESC;
+      ncmdesc->type       = USB_DESC_TYPE_CSINTERFACE;
+      ncmdesc->subtype    = CDC_DSUBTYPE_NCM;
+      ncmdesc->version[0] = LSBYTE(CDCNCM_NCMVERSIONNO);
+      ncmdesc->version[1] = MSBYTE(CDCNCM_NCMVERSIONNO);
+      ncmdesc->caps       = NCM_NCAP_ETH_FILTER;
+
+      desc += SIZEOF_NCM_FUNCDESC;
+    }
+
+  len += SIZEOF_NCM_FUNCDESC;
+
+  if (desc)
+    {
+      FAR struct usb_epdesc_s *epdesc = (FAR struct usb_epdesc_s *)desc;
+
+      cdcncm_mkepdesc(CDCNCM_EP_INTIN_IDX, epdesc, devinfo, false);
+      desc += USB_SIZEOF_EPDESC;
+    }
+
+  len += USB_SIZEOF_EPDESC;
+
+  /* Data Class Interface */
+
+  if (desc)
+    {
+      FAR struct usb_ifdesc_s *ifdesc = (FAR struct usb_ifdesc_s *)desc;
+
+      ifdesc = (FAR struct usb_ifdesc_s *)desc;
+      ifdesc->len      = USB_SIZEOF_IFDESC;
+      ifdesc->type     = USB_DESC_TYPE_INTERFACE;
+      ifdesc->ifno     = devinfo->ifnobase + 1;
+      ifdesc->alt      = 0;
+      ifdesc->neps     = 0;
+      ifdesc->classid  = USB_CLASS_CDC_DATA;
+      ifdesc->subclass = CDC_DATA_SUBCLASS_NONE;
+      ifdesc->protocol = CDC_DATA_PROTO_NCMNTB;
+      ifdesc->iif      = 0;
+
+      desc += USB_SIZEOF_IFDESC;
+    }
+
+  len += USB_SIZEOF_IFDESC;
+
+  if (desc)
+    {
+      FAR struct usb_ifdesc_s *ifdesc = (FAR struct usb_ifdesc_s *)desc;
+
+      ifdesc = (FAR struct usb_ifdesc_s *)desc;
+      ifdesc->len      = USB_SIZEOF_IFDESC;
+      ifdesc->type     = USB_DESC_TYPE_INTERFACE;
+      ifdesc->ifno     = devinfo->ifnobase + 1;
+      ifdesc->alt      = 1;
+      ifdesc->neps     = 2;
+      ifdesc->classid  = USB_CLASS_CDC_DATA;
+      ifdesc->subclass = CDC_DATA_SUBCLASS_NONE;
+      ifdesc->protocol = CDC_DATA_PROTO_NCMNTB;
+      ifdesc->iif      = 0;
+
+      desc += USB_SIZEOF_IFDESC;
+    }
+
+  len += USB_SIZEOF_IFDESC;
+
+  if (desc)
+    {
+      FAR struct usb_epdesc_s *epdesc = (FAR struct usb_epdesc_s *)desc;
+
+      cdcncm_mkepdesc(CDCNCM_EP_BULKIN_IDX, epdesc, devinfo, is_high_speed);
+      desc += USB_SIZEOF_EPDESC;
+    }
+
+  len += USB_SIZEOF_EPDESC;
+
+  if (desc)
+    {
+      FAR struct usb_epdesc_s *epdesc = (FAR struct usb_epdesc_s *)desc;
+
+      cdcncm_mkepdesc(CDCNCM_EP_BULKOUT_IDX, epdesc, devinfo, is_high_speed);
+      desc += USB_SIZEOF_EPDESC;
+    }
+
+  len += USB_SIZEOF_EPDESC;
+
+  if (cfgdesc)
+    {
+      cfgdesc->totallen[0] = LSBYTE(len);
+      cfgdesc->totallen[1] = MSBYTE(len);
+    }
+
+  DEBUGASSERT(len <= CDCNCM_MXDESCLEN);
+  return len;
+}
+
+/****************************************************************************
+ * Name: cdcncm_getdescriptor
+ *
+ * Description:
+ *   Copy the USB CDC-NCM Device USB Descriptor of a given Type and a given
+ *   Index into the provided Descriptor Buffer.
+ *
+ * Input Parameter:
+ *   drvr  - The USB Device Fuzzer Driver instance.
+ *   type  - The Type of USB Descriptor requested.
+ *   index - The Index of the USB Descriptor requested.
+ *   desc  - The USB Descriptor is copied into this buffer, which must be at
+ *           least CDCNCM_MXDESCLEN bytes wide.
+ *
+ * Returned Value:
+ *   The size in bytes of the requested USB Descriptor or a negated errno in
+ *   case of failure.
+ *
+ ****************************************************************************/
+
+static int cdcncm_getdescriptor(FAR struct cdcncm_driver_s *self,
+                                uint8_t type, uint8_t index, FAR void *desc)
+{
+  uinfo("type: 0x%02hhx, index: 0x%02hhx\n", type, index);
+
+  switch (type)
+    {
+#ifndef CONFIG_CDCNCM_COMPOSITE
+    case USB_DESC_TYPE_DEVICE:
+      {
+        memcpy(desc, &g_devdesc, sizeof(g_devdesc));
+        return (int)sizeof(g_devdesc);
+      }
+      break;
+#endif
+
+#ifdef CONFIG_USBDEV_DUALSPEED
+    case USB_DESC_TYPE_OTHERSPEEDCONFIG:
+#endif /* CONFIG_USBDEV_DUALSPEED */
+    case USB_DESC_TYPE_CONFIG:
+      {
+#ifdef CONFIG_USBDEV_DUALSPEED
+        return cdcncm_mkcfgdesc((FAR uint8_t *)desc, &self->devinfo,
+                                self->usbdev.speed, type);
+#else
+        return cdcncm_mkcfgdesc((FAR uint8_t *)desc, &self->devinfo);
+#endif
+      }
+      break;
+
+    case USB_DESC_TYPE_STRING:
+      {
+        return cdcncm_mkstrdesc(index, (FAR struct usb_strdesc_s *)desc);
+      }
+      break;
+
+    default:
+      uwarn("Unsupported descriptor type: 0x%02hhx\n", type);
+      break;
+    }
+
+  return -ENOTSUP;
+}
+
+/****************************************************************************
+ * USB Device Class Methods
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cdcncm_bind
+ *
+ * Description:
+ *   Invoked when the driver is bound to an USB device
+ *
+ ****************************************************************************/
+
+static int cdcncm_bind(FAR struct usbdevclass_driver_s *driver,
+                       FAR struct usbdev_s *dev)
+{
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)driver;
+  int ret = OK;
+  int i;
+
+  uinfo("\n");
+
+#ifndef CONFIG_CDCNCM_COMPOSITE
+  dev->ep0->priv = self;
+#endif
+
+  /* Preallocate control request */
+
+  self->ctrlreq = usbdev_allocreq(dev->ep0, CDCNCM_MXDESCLEN);
+
+  if (self->ctrlreq == NULL)
+    {
+      ret = -ENOMEM;
+      goto error;
+    }
+
+  self->ctrlreq->callback = cdcncm_ep0incomplete;
+
+  self->epint     = DEV_ALLOCEP(dev,
+                                USB_DIR_IN |
+                                self->devinfo.epno[CDCNCM_EP_INTIN_IDX],
+                                true, USB_EP_ATTR_XFER_INT);
+  self->epbulkin  = DEV_ALLOCEP(dev,
+                                USB_DIR_IN |
+                                self->devinfo.epno[CDCNCM_EP_BULKIN_IDX],
+                                true, USB_EP_ATTR_XFER_BULK);
+  self->epbulkout = DEV_ALLOCEP(dev,
+                                USB_DIR_OUT |
+                                self->devinfo.epno[CDCNCM_EP_BULKOUT_IDX],
+                                false, USB_EP_ATTR_XFER_BULK);
+
+  if (!self->epint || !self->epbulkin || !self->epbulkout)
+    {
+      uerr("Failed to allocate endpoints!\n");
+      ret = -ENODEV;
+      goto error;
+    }
+
+  self->epint->priv     = self;
+  self->epbulkin->priv  = self;
+  self->epbulkout->priv = self;
+
+  /* Pre-allocate the notification request */
+
+  self->notifyreq =
+    usbdev_allocreq(self->epint,
+                    SIZEOF_NOTIFICATION_S(sizeof(struct cdc_speedchange_s)));
+  if (self->notifyreq == NULL)
+    {
+      uerr("Out of memory\n");
+      ret = -ENOMEM;
+      goto error;
+    }
+
+  self->notifyreq->callback = cdcncm_notifycomplete;
+
+  /* Pre-allocate read and write requests.  The buffer size is one full
+   * NTB.  req->priv holds the index of the request.
+   */
+
+  for (i = 0; i < CDCNCM_NRDREQS; i++)
+    {
+      self->rdreq[i] = usbdev_allocreq(self->epbulkout,
+                                       CONFIG_CDCNCM_NTB_MAXSIZE);
+      if (self->rdreq[i] == NULL)
+        {
+          uerr("Out of memory\n");
+          ret = -ENOMEM;
+          goto error;
+        }
+
+      self->rdreq[i]->callback = cdcncm_rdcomplete;
+      self->rdreq[i]->priv     = (FAR void *)(uintptr_t)i;
+    }
+
+  for (i = 0; i < CDCNCM_NWRREQS; i++)
+    {
+      self->wrreq[i] = usbdev_allocreq(self->epbulkin,
+                                       CONFIG_CDCNCM_NTB_MAXSIZE);
+      if (self->wrreq[i] == NULL)
+        {
+          uerr("Out of memory\n");
+          ret = -ENOMEM;
+          goto error;
+        }
+
+      self->wrreq[i]->callback = cdcncm_wrcomplete;
+      self->wrreq[i]->priv     = (FAR void *)(uintptr_t)i;
+    }
+
+  /* The write requests just allocated are available now. */
+
+  ret = nxsem_init(&self->wrreq_idle, 0, CDCNCM_NWRREQS);
+
+  if (ret != OK)
+    {
+      uerr("nxsem_init failed. ret: %d\n", ret);
+      goto error;
+    }
+
+  self->wrfree    = (1 << CDCNCM_NWRREQS) - 1;
+  self->txreq     = NULL;
+  self->ntbinsize = CONFIG_CDCNCM_NTB_MAXSIZE;
+  self->txdone    = false;
+  self->dev.d_len = 0;
+
+#ifndef CONFIG_CDCNCM_COMPOSITE
+#ifdef CONFIG_USBDEV_SELFPOWERED
+  DEV_SETSELFPOWERED(dev);
+#endif
+
+  /* And pull-up the data line for the soft connect function (unless we are
+   * part of a composite device)
+   */
+
+  DEV_CONNECT(dev);
+#endif
+  return OK;
+
+error:
+  uerr("cdcncm_bind failed! ret: %d\n", ret);
+  cdcncm_unbind(driver, dev);
+  return ret;
+}
+
+static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
+                          FAR struct usbdev_s *dev)
+{
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)driver;
+  int i;
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (!driver || !dev)
+    {
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_INVALIDARG), 0);
+      return;
+    }
+#endif
+
+  /* Make sure that the endpoints have been unconfigured.  If
+   * we were terminated gracefully, then the configuration should
+   * already have been reset.  If not, then calling cdcacm_resetconfig
+   * should cause the endpoints to immediately terminate all
+   * transfers and return the requests to us (with result == -ESHUTDOWN)
+   */
+
+  cdcncm_resetconfig(self);
+  up_mdelay(50);
+
+  /* Free the notification request and the interrupt IN endpoint */
+
+  if (self->notifyreq != NULL)
+    {
+      usbdev_freereq(self->epint, self->notifyreq);
+      self->notifyreq = NULL;
+    }
+
+  if (self->epint)
+    {
+      DEV_FREEEP(dev, self->epint);
+      self->epint = NULL;
+    }
+
+  /* Free the pre-allocated control request */
+
+  if (self->ctrlreq != NULL)
+    {
+      usbdev_freereq(dev->ep0, self->ctrlreq);
+      self->ctrlreq = NULL;
+    }
+
+  /* Free pre-allocated read requests (which should all have
+   * been returned to the free list at this time -- we don't check)
+   */
+
+  for (i = 0; i < CDCNCM_NRDREQS; i++)
+    {
+      if (self->rdreq[i] != NULL)
+        {
+          usbdev_freereq(self->epbulkout, self->rdreq[i]);
+          self->rdreq[i] = NULL;
+        }
+    }
+
+  /* Free the bulk OUT endpoint */
+
+  if (self->epbulkout)
+    {
+      DEV_FREEEP(dev, self->epbulkout);
+      self->epbulkout = NULL;
+    }
+
+  /* Free write requests that are not in use (which should be all
+   * of them)
+   */
+
+  self->txreq = NULL;
+
+  for (i = 0; i < CDCNCM_NWRREQS; i++)
+    {
+      if (self->wrreq[i] != NULL)
+        {
+          usbdev_freereq(self->epbulkin, self->wrreq[i]);
+          self->wrreq[i] = NULL;
+        }
+    }
+
+  /* Free the bulk IN endpoint */
+
+  if (self->epbulkin)
+    {
+      DEV_FREEEP(dev, self->epbulkin);
+      self->epbulkin = NULL;
+    }
+
+  /* Clear out all data in the buffer */
+
+  self->dev.d_len = 0;
+}
+
+static int cdcncm_setup(FAR struct usbdevclass_driver_s *driver,
+                        FAR struct usbdev_s *dev,
+                        FAR const struct usb_ctrlreq_s *ctrl,
+                        FAR uint8_t *dataout,
+                        size_t outlen)
+{
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)driver;
+  uint16_t value = GETUINT16(ctrl->value);
+  uint16_t index = GETUINT16(ctrl->index);
+  uint16_t len = GETUINT16(ctrl->len);
+  int ret = -EOPNOTSUPP;
+
+  uinfo("\n");
+
+  if ((ctrl->type & USB_REQ_TYPE_MASK) == USB_REQ_TYPE_STANDARD)
+    {
+      switch (ctrl->req)
+        {
+          case USB_REQ_GETDESCRIPTOR:
+            {
+              uint8_t descindex = ctrl->value[0];
+              uint8_t desctype  = ctrl->value[1];
+
+              ret = cdcncm_getdescriptor(self, desctype, descindex,
+                                         self->ctrlreq->buf);
+            }
+            break;
+
+          case USB_REQ_SETCONFIGURATION:
+            ret = cdcncm_setconfig(self, value);
+            break;
+
+          case USB_REQ_SETINTERFACE:
+            ret = cdcncm_setinterface(self, index, value);
+            break;
+
+          default:
+            uwarn("Unsupported standard req: 0x%02hhx\n", ctrl->req);
+            break;
+        }
+    }
+  else if ((ctrl->type & USB_REQ_TYPE_MASK) == USB_REQ_TYPE_CLASS)
+    {
+      switch (ctrl->req)
+        {
+          case ECM_SET_PACKET_FILTER:
+
+            /* SetEthernetPacketFilter is advertised in the NCM functional
+             * descriptor, but it is still ok to always operate in
+             * promiscuous mode and rely on the host to do the filtering.
+             * This is especially true for our case:
+             *   A simulated point-to-point connection.
+             */
+
+            uinfo("ECM_SET_PACKET_FILTER wValue: 0x%04hx, wIndex: 0x%04hx\n",
+                  GETUINT16(ctrl->value), GETUINT16(ctrl->index));
+
+            ret = OK;
+            break;
+
+          case NCM_GET_NTB_PARAMETERS:
+            {
+              FAR struct cdc_ncm_ntbparams_s *params =
+                (FAR struct cdc_ncm_ntbparams_s *)self->ctrlreq->buf;
+
+              memset(params, 0, SIZEOF_NCM_NTBPARAMS);
+              cdcncm_putle16(params->len, SIZEOF_NCM_NTBPARAMS);
+              cdcncm_putle16(params->formats, NCM_NTB16_SUPPORTED);
+              cdcncm_putle32(params->insize, CONFIG_CDCNCM_NTB_MAXSIZE);
+              cdcncm_putle16(params->indiv, CDCNCM_NTB_ALIGN);
+              cdcncm_putle16(params->inalign, CDCNCM_NTB_ALIGN);
+              cdcncm_putle32(params->outsize, CONFIG_CDCNCM_NTB_MAXSIZE);
+              cdcncm_putle16(params->outdiv, CDCNCM_NTB_ALIGN);
+              cdcncm_putle16(params->outalign, CDCNCM_NTB_ALIGN);
+
+              ret = SIZEOF_NCM_NTBPARAMS;
+            }
+            break;
+
+          case NCM_GET_NTB_FORMAT:
+            cdcncm_putle16(self->ctrlreq->buf, NCM_NTB16_FORMAT);
+            ret = 2;
+            break;
+
+          case NCM_SET_NTB_FORMAT:
+
+            /* Only NTB-16 is supported */
+
+            ret = value == NCM_NTB16_FORMAT ? OK : -EINVAL;
+            break;
+
+          case NCM_GET_NTB_INPUT_SIZE:
+            cdcncm_putle32(self->ctrlreq->buf, self->ntbinsize);
+            ret = 4;
+            break;
+
+          case NCM_SET_NTB_INPUT_SIZE:
+
+            /* Not all device controller drivers provide the EP0 OUT data
+             * with the setup command.  The largest size is kept then.
+             */
+
+            ret = OK;
+            if (dataout != NULL && len >= 4 && outlen >= 4)
+              {
+                uint32_t size = GETUINT32(dataout);
+
+                if (size < CDCNCM_NTB_MINSIZE)
+                  {
+                    ret = -EINVAL;
+                  }
+                else
+                  {
+                    self->ntbinsize = MIN(size, CONFIG_CDCNCM_NTB_MAXSIZE);
+                  }
+              }
+
+            uinfo("NCM_SET_NTB_INPUT_SIZE: %u\n", self->ntbinsize);
+            break;
+
+          default:
+            uwarn("Unsupported class req: 0x%02hhx\n", ctrl->req);
+            break;
+        }
+    }
+  else
+    {
+      uwarn("Unsupported type: 0x%02hhx\n", ctrl->type);
+    }
+
+  if (ret >= 0)
+    {
+      FAR struct usbdev_req_s *ctrlreq = self->ctrlreq;
+
+      ctrlreq->len   = MIN(len, ret);
+      ctrlreq->flags = USBDEV_REQFLAGS_NULLPKT;
+
+      ret = EP_SUBMIT(dev->ep0, ctrlreq);
+      uinfo("EP_SUBMIT ret: %d\n", ret);
+
+      if (ret < 0)
+        {
+          ctrlreq->result = OK;
+          cdcncm_ep0incomplete(dev->ep0, ctrlreq);
+        }
+    }
+
+  return ret;
+}
+
+static void cdcncm_disconnect(FAR struct usbdevclass_driver_s *driver,
+                              FAR struct usbdev_s *dev)
+{
+  uinfo("\n");
+}
+
+/****************************************************************************
+ * Name: cdcncm_classobject
+ *
+ * Description:
+ *   Register USB CDC/NCM and return the class object.
+ *
+ * Returned Value:
+ *   A pointer to the allocated class object (NULL on failure).
+ *
+ ****************************************************************************/
+
+static int cdcncm_classobject(int minor,
+                              FAR struct usbdev_devinfo_s *devinfo,
+                              FAR struct usbdevclass_driver_s **classdev)
+{
+  FAR struct cdcncm_driver_s *self;
+  int ret;
+
+  /* Initialize the driver structure */
+
+  self = kmm_zalloc(sizeof(struct cdcncm_driver_s));
+  if (!self)
+    {
+      nerr("Out of memory!\n");
+      return -ENOMEM;
+    }
+
+  /* Network device initialization */
+
+  /* d_buf stays NULL: frames are exchanged with the network in IOB chains
+   * and copied once between them and the NTBs.
+   */
+
+  self->dev.d_ifup    = cdcncm_ifup;     /* I/F up (new IP address) callback */
+  self->dev.d_ifdown  = cdcncm_ifdown;   /* I/F down callback */
+  self->dev.d_txavail = cdcncm_txavail;  /* New TX data callback */
+#ifdef CONFIG_NET_MCASTGROUP
+  self->dev.d_addmac  = cdcncm_addmac;   /* Add multicast MAC address */
+  self->dev.d_rmmac   = cdcncm_rmmac;    /* Remove multicast MAC address */
+#endif
+#ifdef CONFIG_NETDEV_IOCTL
+  self->dev.d_ioctl   = cdcncm_ioctl;    /* Handle network IOCTL commands */
+#endif
+  self->dev.d_private = self;            /* Used to recover private state from dev */
+
+  /* USB device initialization */
+
+#ifdef CONFIG_USBDEV_DUALSPEED
+  self->usbdev.speed  = USB_SPEED_HIGH;
+#else
+  self->usbdev.speed  = USB_SPEED_FULL;
+#endif
+  self->usbdev.ops    = &g_usbdevops;
+
+  memcpy(&self->devinfo, devinfo, sizeof(struct usbdev_devinfo_s));
+
+  /* Put the interface in the down state.  This usually amounts to resetting
+   * the device and/or calling cdcncm_ifdown().
+   */
+
+  cdcncm_ifdown(&self->dev);
+
+  /* Read the MAC address from the hardware into
+   * priv->dev.d_mac.ether.ether_addr_octet
+   * Applies only if the Ethernet MAC has its own internal address.
+   */
+
+  memcpy(self->dev.d_mac.ether.ether_addr_octet,
+         "\x00\xe0\xde\xad\xbe\xef", IFHWADDRLEN);
+
+  /* Register the device with the OS so that socket IOCTLs can be performed */
+
+  ret = netdev_register(&self->dev, NET_LL_ETHERNET);
+  if (ret < 0)
+    {
+      nerr("netdev_register failed. ret: %d\n", ret);
+      return ret;
+    }
+
+  self->registered = true;
+
+  *classdev = (FAR struct usbdevclass_driver_s *)self;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cdcncm_uninitialize
+ *
+ * Description:
+ *   Un-initialize the USB CDC/NCM class driver.  This function is used
+ *   internally by the USB composite driver to uninitialize the CDC/NCM
+ *   driver.  This same interface is available (with an untyped input
+ *   parameter) when the CDC/NCM driver is used standalone.
+ *
+ * Input Parameters:
+ *   There is one parameter, it differs in typing depending upon whether the
+ *   CDC/NCM driver is an internal part of a composite device, or a
+ *   standalone USB driver:
+ *
+ *     classdev - The class object returned by cdcacm_classobject()
+ *     handle   - The opaque handle representing the class object returned by
+ *                a previous call to cdcacm_initialize().
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CDCNCM_COMPOSITE
+void cdcncm_uninitialize(FAR struct usbdevclass_driver_s *classdev)
+#else
+void cdcncm_uninitialize(FAR void *handle)
+#endif
+{
+#ifdef CONFIG_CDCNCM_COMPOSITE
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)classdev;
+#else
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)handle;
+#endif
+  int ret;
+
+#ifdef CONFIG_CDCNCM_COMPOSITE
+  /* Check for pass 2 uninitialization.  We did most of the work on the
+   * first pass uninitialization.
+   */
+
+  if (!self->registered)
+    {
+      /* In this second and final pass, all that remains to be done is to
+       * free the memory resources.
+       */
+
+      kmm_free(self);
+      return;
+    }
+#endif
+
+  /* Un-register the CDC/NCM netdev device */
+
+  ret = netdev_unregister(&self->dev);
+  if (ret < 0)
+    {
+      nerr("ERROR: netdev_unregister failed. ret: %d\n", ret);
+    }
+
+  /* For the case of the composite driver, there is a two pass
+   * uninitialization sequence.  We cannot yet free the driver structure.
+   * We will do that on the second pass.  We mark the fact that we have
+   * already uninitialized by setting the registered flag to false.
+   * If/when we are called again, then we will free the memory resources.
+   */
+
+  self->registered = false; /* Successfully unregistered netdev */
+
+  /* Unregister the driver (unless we are a part of a composite device).  The
+   * device unregister logic will (1) return all of the requests to us then
+   * (2) call the unbind method.
+   *
+   * The same thing will happen in the composite case except that: (1) the
+   * composite driver will call usbdev_unregister() which will (2) return the
+   * requests for all members of the composite, and (3) call the unbind
+   * method in the composite device which will (4) call the unbind method
+   * for this device.
+   */
+
+#ifndef CONFIG_CDCNCM_COMPOSITE
+  usbdev_unregister(&self->usbdev);
+
+  /* And free the driver structure */
+
+  kmm_free(self);
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cdcncm_initialize
+ *
+ * Description:
+ *   Register CDC/NCM USB device interface. Register the corresponding
+ *   network driver to NuttX and bring up the network.
+ *
+ * Input Parameters:
+ *   minor - Device minor number.
+ *   handle - An optional opaque reference to the CDC/NCM class object that
+ *     may subsequently be used with cdcncm_uninitialize().
+ *
+ * Returned Value:
+ *   Zero (OK) means that the driver was successfully registered.  On any
+ *   failure, a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_CDCNCM_COMPOSITE
+int cdcncm_initialize(int minor, FAR void **handle)
+{
+  FAR struct usbdevclass_driver_s *drvr = NULL;
+  struct usbdev_devinfo_s devinfo;
+  int ret;
+
+  memset(&devinfo, 0, sizeof(struct usbdev_devinfo_s));
+  devinfo.ninterfaces                 = CDCNCM_NINTERFACES;
+  devinfo.nstrings                    = CDCNCM_NSTRIDS;
+  devinfo.nendpoints                  = CDCNCM_NUM_EPS;
+  devinfo.epno[CDCNCM_EP_INTIN_IDX]   = CONFIG_CDCNCM_EPINTIN;
+  devinfo.epno[CDCNCM_EP_BULKIN_IDX]  = CONFIG_CDCNCM_EPBULKIN;
+  devinfo.epno[CDCNCM_EP_BULKOUT_IDX] = CONFIG_CDCNCM_EPBULKOUT;
+
+  ret = cdcncm_classobject(minor, &devinfo, &drvr);
+  if (ret == OK)
+    {
+      ret = usbdev_register(drvr);
+      if (ret < 0)
+        {
+          uinfo("usbdev_register failed. ret %d\n", ret);
+        }
+    }
+
+  if (handle)
+    {
+      *handle = (FAR void *)drvr;
+    }
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: cdcncm_get_composite_devdesc
+ *
+ * Description:
+ *   Helper function to fill in some constants into the composite
+ *   configuration struct.
+ *
+ * Input Parameters:
+ *     dev - Pointer to the configuration struct we should fill
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CDCNCM_COMPOSITE
+void cdcncm_get_composite_devdesc(struct composite_devdesc_s *dev)
+{
+  memset(dev, 0, sizeof(struct composite_devdesc_s));
+
+  /* The callback functions for the CDC/NCM class.
+   *
+   * classobject() and uninitialize() must be provided by board-specific
+   * logic
+   */
+
+  dev->mkconfdesc   = cdcncm_mkcfgdesc;
+  dev->mkstrdesc    = cdcncm_mkstrdesc;
+  dev->classobject  = cdcncm_classobject;
+  dev->uninitialize = cdcncm_uninitialize;
+
+  dev->nconfigs     = CDCNCM_NCONFIGS; /* Number of configurations supported  */
+  dev->configid     = CDCNCM_CONFIGID; /* The only supported configuration ID */
+
+  /* Let the construction function calculate the size of config descriptor */
+
+#ifdef CONFIG_USBDEV_DUALSPEED
+  dev->cfgdescsize  = cdcncm_mkcfgdesc(NULL, NULL, USB_SPEED_UNKNOWN, 0);
+#else
+  dev->cfgdescsize  = cdcncm_mkcfgdesc(NULL, NULL);
+#endif
+
+  /* Board-specific logic must provide the device minor */
+
+  /* Interfaces.
+   *
+   * ifnobase must be provided by board-specific logic
+   */
+
+  dev->devinfo.ninterfaces = CDCNCM_NINTERFACES; /* Number of interfaces in the configuration */
+
+  /* Strings.
+   *
+   * strbase must be provided by board-specific logic
+   */
+
+  dev->devinfo.nstrings    = CDCNCM_NSTRIDS + 1;     /* Number of Strings */
+
+  /* Endpoints.
+   *
+   * Endpoint numbers must be provided by board-specific logic.
+   */
+
+  dev->devinfo.nendpoints  = CDCNCM_NUM_EPS;
+}
+#endif /* CONFIG_CDCNCM_COMPOSITE */
+
+#endif /* CONFIG_NET_CDCNCM */
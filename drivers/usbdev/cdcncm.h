@@ -0,0 +1,77 @@
+/****************************************************************************
+ * drivers/usbdev/cdcncm.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __DRIVERS_USBDEV_CDCNCM_H
+#define __DRIVERS_USBDEV_CDCNCM_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+#include <sys/param.h>
+
+#include <nuttx/usb/cdcncm.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CDCNCM_VERSIONNO         (0x0100)
+#define CDCNCM_MXDESCLEN         (100)
+#define CDCNCM_MAXSTRLEN         (CDCNCM_MXDESCLEN - 2)
+#define CDCNCM_NCONFIGS          (1)
+#define CDCNCM_NINTERFACES       (2)
+#define CDCNCM_NUM_EPS           (3)
+
+#define CDCNCM_MANUFACTURERSTRID (1)
+#define CDCNCM_PRODUCTSTRID      (2)
+#define CDCNCM_SERIALSTRID       (3)
+#define CDCNCM_CONFIGSTRID       (4)
+#define CDCNCM_MACSTRID          (5)
+#define CDCNCM_NSTRIDS           (5)
+
+#define CDCNCM_STR_LANGUAGE      (0x0409) /* en-us */
+
+#define CDCNCM_CONFIGID_NONE     (0)
+#define CDCNCM_CONFIGID          (1)
+
+#define CDCNCM_SELFPOWERED       (0)
+#define CDCNCM_REMOTEWAKEUP      (0)
+
+/* NTB format.  IN datagrams and NDPs are aligned to four bytes, which is
+ * also what the hosts use for OUT NTBs.
+ */
+
+#define CDCNCM_NCMVERSIONNO      (0x0100)
+#define CDCNCM_NTB_ALIGN         (4)
+#define CDCNCM_NTB_MINSIZE       (2048) /* Smallest dwNtbInMaxSize allowed */
+#define CDCNCM_MAXNDPS           (8)    /* NDPs followed in one OUT NTB */
+
+/* Number of USB requests on each bulk endpoint.  With two requests an NTB
+ * is filled while the previous one is on the bus.
+ */
+
+#define CDCNCM_NRDREQS           (2)
+#define CDCNCM_NWRREQS           (2)
+
+#endif /* __DRIVERS_USBDEV_CDCNCM_H */
@@ -79,10 +79,33 @@
 #  define CONFIG_RNDIS_NWRREQS  (2)
 #endif
 
+#ifndef CONFIG_RNDIS_MAXPKTPERXFER
+#  define CONFIG_RNDIS_MAXPKTPERXFER (1)
+#endif
+
 #define RNDIS_PACKET_HDR_SIZE   (sizeof(struct rndis_packet_msg))
 #define CONFIG_RNDIS_BULKIN_REQLEN \
   (CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE + RNDIS_PACKET_HDR_SIZE)
-#define CONFIG_RNDIS_BULKOUT_REQLEN CONFIG_RNDIS_BULKIN_REQLEN
+
+/* Packet messages are aligned to 4 bytes (2^pktalign) within a transfer.
+ * RNDIS_XFRSIZE is the MaxTransferSize that is reported to the host.
+ */
+
+#define RNDIS_ALIGN(n)          (((n) + 3) & ~3)
+#define RNDIS_MSGMAXLEN         RNDIS_ALIGN((4 + 44 + 22) + RNDIS_BUFFER_SIZE)
+#define RNDIS_XFRSIZE           (CONFIG_RNDIS_MAXPKTPERXFER * RNDIS_MSGMAXLEN)
+
+#if CONFIG_RNDIS_MAXPKTPERXFER > 1
+/* The read request takes a whole transfer plus the single byte that the
+ * host appends to a transfer that is a multiple of the packet size.  The
+ * write requests are linear buffers that packet messages are gathered in.
+ */
+
+#  define CONFIG_RNDIS_BULKOUT_REQLEN (((RNDIS_XFRSIZE / 512) + 1) * 512)
+#  define RNDIS_TXBUFSIZE       MAX(CONFIG_RNDIS_BULKIN_REQLEN, RNDIS_XFRSIZE)
+#else
+#  define CONFIG_RNDIS_BULKOUT_REQLEN CONFIG_RNDIS_BULKIN_REQLEN
+#endif
 
 static_assert(CONFIG_NET_LL_GUARDSIZE >= RNDIS_PACKET_HDR_SIZE + ETH_HDRLEN,
              "CONFIG_NET_LL_GUARDSIZE cannot be less than ETH_HDRLEN"
@@ -135,6 +158,7 @@ struct rndis_req_s
   FAR struct usbdev_req_s *req;    /* The contained request */
   FAR struct iob_s        *iob;    /* IOB offload */
   FAR uint8_t             *buf;    /* Use malloc buffer when config IOB_LEN < CONFIG_RNDIS_BULKIN_REQLEN */
+  uint8_t                  npkts;  /* Number of packet messages gathered in buf */
 };
 
 /* This structure describes the internal state of the driver */
@@ -169,6 +193,10 @@ struct rndis_dev_s
   size_t current_rx_datagram_size;       /* Total number of bytes of the current RX datagram */
   size_t current_rx_datagram_offset;     /* Offset of current RX datagram */
   size_t current_rx_msglen;              /* Length of the entire message to be received */
+  FAR uint8_t *rx_resume;                /* Messages that follow the one being dispatched */
+  size_t rx_resumelen;                   /* Number of bytes at rx_resume */
+  uint32_t host_xfrsize;                 /* MaxTransferSize of the host */
+  uint8_t ntxpending;                    /* Write requests submitted to bulk IN endpoint */
   bool rdreq_submitted;                  /* Indicates if the read request is submitted */
   bool rx_blocked;                       /* Indicates if we can receive packets on bulk in endpoint */
   bool connected;                        /* Connection status indicator */
@@ -232,8 +260,10 @@ struct rndis_oid_value_s
 static int rndis_ifup(FAR struct net_driver_s *dev);
 static int rndis_ifdown(FAR struct net_driver_s *dev);
 static int rndis_txavail(FAR struct net_driver_s *dev);
-static int rndis_transmit(FAR struct rndis_dev_s *priv);
+static int rndis_transmit(FAR struct rndis_dev_s *priv, bool gather);
 static int rndis_txpoll(FAR struct net_driver_s *dev);
+static int rndis_recvpacket(FAR struct rndis_dev_s *priv,
+                            FAR uint8_t *reqbuf, size_t reqlen);
 
 /* usbclass callbacks */
 
@@ -524,7 +554,11 @@ static int rndis_submit_rdreq(FAR struct rndis_dev_s *priv)
 
   if (!priv->rdreq_submitted && !priv->rx_blocked)
     {
+#if CONFIG_RNDIS_MAXPKTPERXFER > 1
+      priv->rdreq->len = CONFIG_RNDIS_BULKOUT_REQLEN;
+#else
       priv->rdreq->len = priv->epbulkout->maxpacket;
+#endif
       ret = EP_SUBMIT(priv->epbulkout, priv->rdreq);
       if (ret != OK)
         {
@@ -675,6 +709,7 @@ static void rndis_freewrreq(FAR struct rndis_dev_s *priv,
       req->iob = NULL;
     }
 
+  req->npkts = 0;
   sq_addlast((FAR sq_entry_t *)req, &priv->reqlist);
   rndis_submit_rdreq(priv);
 }
@@ -737,6 +772,7 @@ static void rndis_sendnetreq(FAR struct rndis_dev_s *priv)
   EP_SUBMIT(priv->epbulkin, priv->net_req->req);
 
   priv->net_req            = NULL;
+  priv->ntxpending++;
   leave_critical_section(flags);
 }
 
@@ -764,6 +800,41 @@ static void rndis_freenetreq(FAR struct rndis_dev_s *priv)
   leave_critical_section(flags);
 }
 
+/****************************************************************************
+ * Name: rndis_flushnetreq
+ *
+ * Description:
+ *   Releases the request buffer held by the network.  A buffer that holds
+ *   gathered packet messages is submitted if the bulk IN endpoint is idle
+ *   or 'force' is set.  Otherwise it stays with the network and is sent
+ *   when the transfer in progress completes.
+ *
+ * Input Parameters:
+ *   priv: pointer to RNDIS device driver structure
+ *   force: submit gathered packet messages even if the endpoint is busy
+ *
+ * Assumptions:
+ *   Caller holds the network lock
+ *
+ ****************************************************************************/
+
+static void rndis_flushnetreq(FAR struct rndis_dev_s *priv, bool force)
+{
+  if (priv->net_req == NULL)
+    {
+      return;
+    }
+
+  if (priv->net_req->npkts == 0)
+    {
+      rndis_freenetreq(priv);
+    }
+  else if (force || priv->ntxpending == 0)
+    {
+      rndis_sendnetreq(priv);
+    }
+}
+
 /****************************************************************************
  * Name: rndis_iob2buf
  *
@@ -938,6 +1009,83 @@ static uint16_t rndis_fillrequest(FAR struct rndis_dev_s *priv,
   return req->req->len;
 }
 
+#if CONFIG_RNDIS_MAXPKTPERXFER > 1
+/****************************************************************************
+ * Name: rndis_txlimit
+ *
+ * Description:
+ *   Returns the number of bytes that one transfer to the host may carry.
+ *
+ * Input Parameters:
+ *   priv: pointer to RNDIS device driver structure
+ *
+ ****************************************************************************/
+
+static size_t rndis_txlimit(FAR struct rndis_dev_s *priv)
+{
+  return MIN(priv->host_xfrsize, RNDIS_TXBUFSIZE);
+}
+
+/****************************************************************************
+ * Name: rndis_aggregate
+ *
+ * Description:
+ *   Copies the packet in the network buffer behind the packet messages
+ *   already gathered in the request buffer.  Packets are only gathered
+ *   while another transfer is in progress on the bulk IN endpoint, so a
+ *   packet for an idle endpoint is still sent straight from its IOB.
+ *
+ * Input Parameters:
+ *   priv: pointer to RNDIS device driver structure
+ *   req: the request whose buffer we should fill
+ *
+ * Returned Value:
+ *   true if the packet was added to the request; false if it should be
+ *   sent on its own
+ *
+ * Assumptions:
+ *   Caller holds the network lock
+ *
+ ****************************************************************************/
+
+static bool rndis_aggregate(FAR struct rndis_dev_s *priv,
+                            FAR struct rndis_req_s *req)
+{
+  FAR struct rndis_packet_msg *msg;
+  size_t datalen;
+
+  if (req->npkts == 0)
+    {
+      if (priv->ntxpending == 0 ||
+          rndis_txlimit(priv) < 2 * RNDIS_MSGMAXLEN)
+        {
+          return false;
+        }
+
+      req->req->buf = req->buf;
+      req->req->len = 0;
+    }
+
+  datalen = MIN(priv->netdev.d_len, RNDIS_BUFFER_SIZE);
+  msg     = (FAR struct rndis_packet_msg *)&req->buf[req->req->len];
+  memset(msg, 0, RNDIS_PACKET_HDR_SIZE);
+
+  msg->msgtype    = RNDIS_PACKET_MSG;
+  msg->msglen     = RNDIS_ALIGN(RNDIS_PACKET_HDR_SIZE + datalen);
+  msg->dataoffset = RNDIS_PACKET_HDR_SIZE - 8;
+  msg->datalen    = datalen;
+
+  iob_copyout((FAR uint8_t *)msg + RNDIS_PACKET_HDR_SIZE,
+              priv->netdev.d_iob, datalen,
+              -NET_LL_HDRLEN(&priv->netdev));
+
+  req->req->flags = USBDEV_REQFLAGS_NULLPKT;
+  req->req->len  += msg->msglen;
+  req->npkts++;
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Name: rndis_rxdispatch
  *
@@ -956,6 +1104,13 @@ static void rndis_rxdispatch(FAR void *arg)
   irqstate_t flags;
 
   net_lock();
+
+  /* The RX buffer is handed to the network in place of the request that
+   * packets are being gathered in.
+   */
+
+  rndis_flushnetreq(priv, true);
+
   flags = enter_critical_section();
   rndis_giverxreq(priv);
   priv->netdev.d_len = priv->current_rx_datagram_size;
@@ -980,7 +1135,7 @@ static void rndis_rxdispatch(FAR void *arg)
         {
           /* And send the packet */
 
-          rndis_transmit(priv);
+          rndis_transmit(priv, false);
         }
     }
   else
@@ -998,7 +1153,7 @@ static void rndis_rxdispatch(FAR void *arg)
         {
           /* And send the packet */
 
-          rndis_transmit(priv);
+          rndis_transmit(priv, false);
         }
     }
   else
@@ -1012,7 +1167,7 @@ static void rndis_rxdispatch(FAR void *arg)
 
       if (priv->netdev.d_len > 0)
         {
-          rndis_transmit(priv);
+          rndis_transmit(priv, false);
         }
     }
   else
@@ -1025,13 +1180,30 @@ static void rndis_rxdispatch(FAR void *arg)
     }
 
   priv->current_rx_datagram_size = 0;
-  rndis_unblock_rx(priv);
 
   if (priv->net_req != NULL)
     {
       rndis_freenetreq(priv);
     }
 
+  /* Continue with the packet messages that followed in the same transfer
+   * before the read request is submitted again.
+   */
+
+  flags = enter_critical_section();
+  rndis_unblock_rx(priv);
+
+  if (priv->rx_resumelen > 0)
+    {
+      size_t len = priv->rx_resumelen;
+
+      priv->rx_resumelen = 0;
+      rndis_recvpacket(priv, priv->rx_resume, len);
+    }
+
+  rndis_submit_rdreq(priv);
+  leave_critical_section(flags);
+
   net_unlock();
 }
 
@@ -1059,24 +1231,41 @@ static int rndis_txpoll(FAR struct net_driver_s *dev)
       return -EBUSY;
     }
 
-  return rndis_transmit(priv);
+  return rndis_transmit(priv, true);
 }
 
 /****************************************************************************
  * Name: rndis_transmit
  *
  * Description:
- *   Start hardware transmission.
+ *   Start hardware transmission.  If 'gather' is set, the packet may be
+ *   added to the packet messages gathered for the next transfer instead.
  *
  ****************************************************************************/
 
-static int rndis_transmit(FAR struct rndis_dev_s *priv)
+static int rndis_transmit(FAR struct rndis_dev_s *priv, bool gather)
 {
   int ret = OK;
 
   /* Queue the packet */
 
-  rndis_fillrequest(priv, priv->net_req);
+#if CONFIG_RNDIS_MAXPKTPERXFER > 1
+  if (gather && rndis_aggregate(priv, priv->net_req))
+    {
+      /* Keep gathering while another full-size message fits */
+
+      if (priv->net_req->npkts < CONFIG_RNDIS_MAXPKTPERXFER &&
+          priv->net_req->req->len + RNDIS_MSGMAXLEN <= rndis_txlimit(priv))
+        {
+          return OK;
+        }
+    }
+  else
+#endif
+    {
+      rndis_fillrequest(priv, priv->net_req);
+    }
+
   rndis_sendnetreq(priv);
 
   if (!rndis_allocnetreq(priv))
@@ -1127,13 +1316,10 @@ static void rndis_txavail_work(FAR void *arg)
 
   net_lock();
 
-  if (rndis_allocnetreq(priv))
+  if (priv->net_req != NULL || rndis_allocnetreq(priv))
     {
       devif_poll(&priv->netdev, rndis_txpoll);
-      if (priv->net_req != NULL)
-        {
-          rndis_freenetreq(priv);
-        }
+      rndis_flushnetreq(priv, false);
     }
 
   net_unlock();
@@ -1165,15 +1351,24 @@ static int rndis_txavail(FAR struct net_driver_s *dev)
  * Name: rndis_recvpacket
  *
  * Description:
- *   Handles a USB packet arriving on the data bulk out endpoint.
+ *   Handles data arriving on the data bulk out endpoint.  A transfer may
+ *   carry several packet messages and a message may span several reads.
+ *   When a complete datagram has been received, it is dispatched to the
+ *   network and the rest of the buffer is kept in rx_resume until the
+ *   dispatch is done.
+ *
+ * Returned Value:
+ *   OK if all data was consumed; -EBUSY if a datagram was dispatched or
+ *   the device is not connected; -ENOMEM if no RX buffer is available.
  *
  * Assumptions:
- *   Called from the USB interrupt handler with interrupts disabled.
+ *   Called from the USB interrupt handler or the RX dispatch worker with
+ *   interrupts disabled.
  *
  ****************************************************************************/
 
-static inline int rndis_recvpacket(FAR struct rndis_dev_s *priv,
-                                   FAR uint8_t *reqbuf, uint16_t reqlen)
+static int rndis_recvpacket(FAR struct rndis_dev_s *priv,
+                            FAR uint8_t *reqbuf, size_t reqlen)
 {
   if (!rndis_allocrxreq(priv))
     {
@@ -1185,97 +1380,96 @@ static inline int rndis_recvpacket(FAR struct rndis_dev_s *priv,
       return -EBUSY;
     }
 
-  if (!priv->current_rx_datagram_size)
+  while (reqlen > 0)
     {
-      if (reqlen < 16)
-        {
-          /* Packet too small to contain a message header */
-        }
-      else
-        {
-          /* The packet contains a RNDIS packet message header */
+      size_t index;
+      size_t first;
+      size_t last;
+      size_t len;
 
+      if (priv->current_rx_msglen == 0)
+        {
           FAR struct rndis_packet_msg *msg =
             (FAR struct rndis_packet_msg *)reqbuf;
-          if (msg->msgtype == RNDIS_PACKET_MSG)
-            {
-              priv->current_rx_received = reqlen;
-              priv->current_rx_datagram_size = msg->datalen;
-              priv->current_rx_msglen = msg->msglen;
-
-              /* According to RNDIS-over-USB send, if the message length is a
-               * multiple of endpoint max packet size, the host must send an
-               * additional single-byte zero packet. Take that in account
-               * here.
-               */
-
-              if (!(priv->current_rx_msglen % priv->epbulkout->maxpacket))
-                {
-                  priv->current_rx_msglen += 1;
-                }
 
-              /* Data offset is defined as an offset from the beginning of
-               * the offset field itself
+          if (reqlen < RNDIS_PACKET_HDR_SIZE)
+            {
+              /* Too small to contain a message header; this is the
+               * padding byte that ends a transfer that is a multiple of
+               * the endpoint max packet size.
                */
 
-              priv->current_rx_datagram_offset = msg->dataoffset + 8;
-              if (priv->current_rx_datagram_offset < reqlen)
-                {
-                  iob_trycopyin(priv->rx_req->iob,
-                                &reqbuf[priv->current_rx_datagram_offset],
-                                reqlen - priv->current_rx_datagram_offset,
-                                -NET_LL_HDRLEN(&priv->netdev), false);
-                }
+              break;
             }
-          else
+
+          if (msg->msgtype != RNDIS_PACKET_MSG ||
+              msg->msglen < RNDIS_PACKET_HDR_SIZE)
             {
-              uerr("Unknown RNDIS message type %" PRIu32 "\n", msg->msgtype);
+              uerr("Unknown RNDIS message type %" PRIu32 "\n",
+                   msg->msgtype);
+              break;
             }
-        }
-    }
-  else
-    {
-      if (priv->current_rx_received >= priv->current_rx_datagram_offset &&
-          priv->current_rx_received <= priv->current_rx_datagram_size +
-          priv->current_rx_datagram_offset)
-        {
-          size_t index = priv->current_rx_received -
-                         priv->current_rx_datagram_offset;
-          size_t copysize = MIN(reqlen,
-                                priv->current_rx_datagram_size - index);
 
-          /* Check if the received packet exceeds request buffer */
+          priv->current_rx_received = 0;
+          priv->current_rx_msglen = msg->msglen;
 
-          if ((index + copysize) <= CONFIG_NET_ETH_PKTSIZE)
-            {
-              iob_trycopyin(priv->rx_req->iob, reqbuf, copysize,
-                            priv->rx_req->iob->io_pktlen, false);
-            }
-          else
+          /* Data offset is defined as an offset from the beginning of
+           * the offset field itself
+           */
+
+          priv->current_rx_datagram_offset = msg->dataoffset + 8;
+          priv->current_rx_datagram_size = msg->datalen;
+
+          /* Check for a usable packet length (4 added for the CRC) */
+
+          if (priv->current_rx_datagram_size >
+              (CONFIG_NET_ETH_PKTSIZE + 4) ||
+              priv->current_rx_datagram_size <= (ETH_HDRLEN + 4) ||
+              priv->current_rx_datagram_offset +
+              priv->current_rx_datagram_size > priv->current_rx_msglen)
             {
-              uerr("The packet exceeds request buffer (reqlen=%d)\n",
-                   reqlen);
+              uerr("ERROR: Bad packet size dropped (%zu)\n",
+                   priv->current_rx_datagram_size);
+              NETDEV_RXERRORS(&priv->netdev);
+              priv->current_rx_datagram_size = 0;
             }
         }
-      priv->current_rx_received += reqlen;
-    }
 
-  if (priv->current_rx_received >= priv->current_rx_msglen)
-    {
-      /* Check for a usable packet length (4 added for the CRC) */
+      /* Copy the part of the datagram that is in this buffer */
+
+      len   = MIN(reqlen,
+                  priv->current_rx_msglen - priv->current_rx_received);
+      index = priv->current_rx_received;
+      first = MAX(index, priv->current_rx_datagram_offset);
+      last  = MIN(index + len, priv->current_rx_datagram_offset +
+                               priv->current_rx_datagram_size);
 
-      if (priv->current_rx_datagram_size > (CONFIG_NET_ETH_PKTSIZE + 4) ||
-          priv->current_rx_datagram_size <= (ETH_HDRLEN + 4))
+      if (first < last)
         {
-          uerr("ERROR: Bad packet size dropped (%zu)\n",
-               priv->current_rx_datagram_size);
-          NETDEV_RXERRORS(&priv->netdev);
-          priv->current_rx_datagram_size = 0;
+          iob_trycopyin(priv->rx_req->iob, &reqbuf[first - index],
+                        last - first,
+                        first - priv->current_rx_datagram_offset -
+                        NET_LL_HDRLEN(&priv->netdev), false);
         }
-      else
+
+      priv->current_rx_received += len;
+      reqbuf += len;
+      reqlen -= len;
+
+      if (priv->current_rx_received < priv->current_rx_msglen)
+        {
+          continue;
+        }
+
+      priv->current_rx_msglen = 0;
+
+      if (priv->current_rx_datagram_size > 0)
         {
           int ret;
 
+          priv->rx_resume    = reqbuf;
+          priv->rx_resumelen = reqlen;
+
           DEBUGASSERT(work_available(&priv->rxwork));
           ret = work_queue(ETHWORK, &priv->rxwork, rndis_rxdispatch,
                            priv, 0);
@@ -1400,6 +1594,8 @@ static int rndis_handle_control_message(FAR struct rndis_dev_s *priv,
     {
       case RNDIS_INITIALIZE_MSG:
         {
+          FAR struct rndis_initialize_msg *req =
+            (FAR struct rndis_initialize_msg *)dataout;
           FAR struct rndis_initialize_cmplt *resp;
           size_t respsize = sizeof(struct rndis_initialize_cmplt);
 
@@ -1413,10 +1609,14 @@ static int rndis_handle_control_message(FAR struct rndis_dev_s *priv,
           resp->minor      = RNDIS_MINOR_VERSION;
           resp->devflags   = RNDIS_DEVICEFLAGS;
           resp->medium     = RNDIS_MEDIUM_802_3;
-          resp->pktperxfer = 1;
-          resp->xfrsize    = (4 + 44 + 22) + RNDIS_BUFFER_SIZE;
+          resp->pktperxfer = CONFIG_RNDIS_MAXPKTPERXFER;
+          resp->xfrsize    = RNDIS_XFRSIZE;
           resp->pktalign   = 2;
 
+          /* Transfers to the host may be as large as the host accepts */
+
+          priv->host_xfrsize = req->xfrsize;
+
           rndis_send_encapsulated_response(priv, respsize);
         }
         break;
@@ -1425,6 +1625,7 @@ static int rndis_handle_control_message(FAR struct rndis_dev_s *priv,
         {
           priv->response_queue_words = 0;
           priv->connected = false;
+          priv->host_xfrsize = 0;
         }
         break;
 
@@ -1711,7 +1912,12 @@ static void rndis_wrcomplete(FAR struct usbdev_ep_s *ep,
 
   flags = enter_critical_section();
   rndis_freewrreq(priv, reqcontainer);
-  if (rndis_hasfreereqs(priv))
+  priv->ntxpending--;
+
+  /* Poll for more packets, or send those gathered meanwhile */
+
+  if (rndis_hasfreereqs(priv) ||
+      (priv->net_req != NULL && priv->net_req->npkts > 0))
     {
       rndis_txavail(&priv->netdev);
     }
@@ -2185,6 +2391,9 @@ static int usbclass_bind(FAR struct usbdevclass_driver_s *driver,
    * size.
    */
 
+#if CONFIG_RNDIS_MAXPKTPERXFER > 1
+  reqlen = RNDIS_TXBUFSIZE;
+#else
   if (CONFIG_IOB_BUFSIZE >= CONFIG_RNDIS_BULKIN_REQLEN)
     {
       reqlen = 0;
@@ -2193,6 +2402,7 @@ static int usbclass_bind(FAR struct usbdevclass_driver_s *driver,
     {
       reqlen = CONFIG_RNDIS_BULKIN_REQLEN;
     }
+#endif
 
   for (i = 0; i < CONFIG_RNDIS_NWRREQS; i++)
     {
@@ -0,0 +1,1159 @@
+/****************************************************************************
+ * drivers/usbdev/uac2.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* This is a USB Audio Class 2.0 speaker function for the composite device.
+ *
+ * The function has an audio control interface describing a fixed clock,
+ * a USB streaming input terminal and a speaker output terminal, and an
+ * audio streaming interface whose alternate setting 1 holds an
+ * asynchronous isochronous OUT endpoint and its explicit feedback IN
+ * endpoint.
+ *
+ * The OUT packets are received directly into audio pipeline buffers,
+ * which are sent to an I2S device once they hold USBUAC2_BUFFER_MS frames
+ * of audio.  The I2S device runs from its own clock, so the host is told
+ * through the feedback endpoint how many samples to send per frame.  As
+ * the I2S drivers only report the consumption of whole buffers, the drift
+ * between the two clocks is measured through the amount of audio waiting
+ * for the I2S device: a PI controller keeps it at half of the buffers, and
+ * its integral term settles at the drift of the I2S clock.
+ *
+ * Reference: "Universal Serial Bus Device Class Definition for Audio
+ * Devices, Release 2.0, May 31, 2006"
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <debug.h>
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/queue.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/audio/audio.h>
+#include <nuttx/audio/i2s.h>
+#include <nuttx/usb/usb.h>
+#include <nuttx/usb/audio.h>
+#include <nuttx/usb/composite.h>
+#include <nuttx/usb/usbdev.h>
+#include <nuttx/usb/usbdev_trace.h>
+#include <nuttx/usb/uac2.h>
+
+/****************************************************************************
+ * Pre-processor definitions
+ ****************************************************************************/
+
+/* Release number of the audio class specification (BCD) */
+
+#define UAC2_BCDADC           0x0200
+
+/* Interfaces, relative to the interface base of the function */
+
+#define UAC2_IFNO_AC          0
+#define UAC2_IFNO_AS          1
+#define UAC2_NINTERFACES      2
+
+/* Endpoints, index into devinfo.epno[] */
+
+#define UAC2_EP_OUT_IDX       0
+#define UAC2_EP_FB_IDX        1
+#define UAC2_NENDPOINTS       2
+
+/* Entities of the audio function */
+
+#define UAC2_CLOCKID          1
+#define UAC2_INTERMID         2
+#define UAC2_OUTTERMID        3
+
+/* Strings, relative to the string base of the function */
+
+#define UAC2_IFSTRID          1
+#define UAC2_NSTRINGS         1
+
+/* Stream geometry */
+
+#define UAC2_FRAMEBYTES       (CONFIG_USBUAC2_NCHANNELS * \
+                               CONFIG_USBUAC2_SUBSLOTSIZE)
+#define UAC2_MXPACKET         (((CONFIG_USBUAC2_SAMPLERATE + 999) / 1000 + \
+                                1) * UAC2_FRAMEBYTES)
+#define UAC2_PERIODBYTES      (CONFIG_USBUAC2_SAMPLERATE / 1000 * \
+                               CONFIG_USBUAC2_BUFFER_MS * UAC2_FRAMEBYTES)
+#define UAC2_BUFSIZE          (UAC2_PERIODBYTES + UAC2_MXPACKET)
+
+#if CONFIG_USBUAC2_NCHANNELS == 1
+#  define UAC2_CHANCONFIG     0
+#else
+#  define UAC2_CHANCONFIG     (ADC_LOCATION_FL | ADC_LOCATION_FR)
+#endif
+
+/* The feedback is the number of samples per frame in 10.14 format.  The
+ * controller keeps the audio waiting for the I2S device at UAC2_TARGET
+ * samples; UAC2_AVGSHIFT selects the averaging of the level over frames,
+ * since it moves by a whole buffer each time the I2S device takes one.
+ */
+
+#define UAC2_FBNOMINAL        (((uint32_t)CONFIG_USBUAC2_SAMPLERATE << 14) / \
+                               1000)
+#define UAC2_FBMAXDEV         (1 << 13)   /* Half a sample per frame */
+#define UAC2_TARGET           (CONFIG_USBUAC2_NBUFFERS / 2 * \
+                               CONFIG_USBUAC2_BUFFER_MS * \
+                               CONFIG_USBUAC2_SAMPLERATE / 1000)
+#define UAC2_AVGSHIFT         6
+#define UAC2_KP               8
+#define UAC2_KI               256
+#define UAC2_INTEGMAX         (1 << 20)
+
+/* Size of the preallocated control request buffer */
+
+#define UAC2_MXDESCLEN        sizeof(struct uac2_cfgdesc_s)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* USB configuration descriptor of the function */
+
+struct uac2_cfgdesc_s
+{
+  struct usb_iaddesc_s        iad;      /* Interface association */
+  struct usb_ifdesc_s         acif;     /* Audio control interface */
+  struct adc_ac_ifdesc_s      achdr;    /* Class-specific AC header */
+  struct adc_clksrc_desc_s    clksrc;   /* Clock source */
+  struct adc_interm_desc_s    interm;   /* USB streaming input terminal */
+  struct adc_outterm_desc_s   outterm;  /* Speaker output terminal */
+  struct usb_ifdesc_s         asif0;    /* Streaming interface, idle */
+  struct usb_ifdesc_s         asif1;    /* Streaming interface, active */
+  struct adc_as_ifdesc_s      asgen;    /* Class-specific AS general */
+  struct adc_t1_format_desc_s format;   /* Type I format */
+  struct usb_epdesc_s         epout;    /* Isochronous data endpoint */
+  struct adc_audio_epdesc_s   csep;     /* Class-specific data endpoint */
+  struct usb_epdesc_s         epfb;     /* Isochronous feedback endpoint */
+};
+
+struct uac2_driver_s
+{
+  struct usbdevclass_driver_s drvr;
+  struct usbdev_devinfo_s  devinfo;
+  FAR struct usbdev_req_s *ctrlreq;    /* Preallocated control request */
+  FAR struct usbdev_ep_s  *epout;      /* Isochronous data endpoint */
+  FAR struct usbdev_ep_s  *epfb;       /* Isochronous feedback endpoint */
+  FAR struct usbdev_req_s *rdreq;      /* Request receiving into the buffers */
+  FAR struct usbdev_req_s *fbreq;      /* Request sending the feedback */
+  FAR struct i2s_dev_s    *i2s;        /* The I2S device playing the audio */
+  FAR uint8_t             *scratch;    /* Packets dropped on overrun */
+  FAR struct ap_buffer_s  *cur;        /* Buffer being received into */
+  dq_queue_t               freeq;      /* Buffers available for reception */
+  dq_queue_t               readyq;     /* Full buffers not yet sent */
+  struct work_s            work;       /* Sends the full buffers */
+  uint32_t                 queued;     /* Bytes in readyq and in the I2S */
+  int32_t                  avg;        /* Averaged level, in 1/64 samples */
+  int32_t                  integ;      /* Integral term of the feedback */
+  uint8_t                  alt;        /* Current streaming alt setting */
+  bool                     streaming;  /* Alternate setting 1 is active */
+  bool                     started;    /* Buffers are sent to the I2S */
+  FAR struct ap_buffer_s  *apb[CONFIG_USBUAC2_NBUFFERS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* usbclass callbacks */
+
+static int  usbclass_setup(FAR struct usbdevclass_driver_s *driver,
+                           FAR struct usbdev_s *dev,
+                           FAR const struct usb_ctrlreq_s *ctrl,
+                           FAR uint8_t *dataout, size_t outlen);
+static int  usbclass_bind(FAR struct usbdevclass_driver_s *driver,
+                          FAR struct usbdev_s *dev);
+static void usbclass_unbind(FAR struct usbdevclass_driver_s *driver,
+                            FAR struct usbdev_s *dev);
+static void usbclass_disconnect(FAR struct usbdevclass_driver_s *driver,
+                                FAR struct usbdev_s *dev);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* USB driver operations */
+
+static const struct usbdevclass_driverops_s g_uac2_driverops =
+{
+  &usbclass_bind,
+  &usbclass_unbind,
+  &usbclass_setup,
+  &usbclass_disconnect,
+  NULL,
+  NULL
+};
+
+static const struct uac2_cfgdesc_s g_uac2_cfgdesc =
+{
+  {
+    .len         = USB_SIZEOF_IADDESC,
+    .type        = USB_DESC_TYPE_INTERFACEASSOCIATION,
+    .firstif     = 0,
+    .nifs        = UAC2_NINTERFACES,
+    .classid     = ADC_IAD_CLASS,
+    .subclass    = ADC_IAD_SUBCLASS,
+    .protocol    = ADC_IAD_PROTOCOL,
+    .ifunction   = 0
+  },
+  {
+    .len         = USB_SIZEOF_IFDESC,
+    .type        = USB_DESC_TYPE_INTERFACE,
+    .ifno        = UAC2_IFNO_AC,
+    .alt         = 0,
+    .neps        = 0,
+    .classid     = ADC_ACIF_CLASS,
+    .subclass    = ADC_ACIF_SUBCLASS,
+    .protocol    = ADC_ACIF_PROTOCOL,
+    .iif         = 0
+  },
+  {
+    .ac_len      = USB_SIZEOF_ADC_AC_IFDESC,
+    .ac_type     = ADC_CS_INTERFACE,
+    .ac_subtype  = ADC_AC_HEADER,
+    .ac_adc      =
+      {
+        LSBYTE(UAC2_BCDADC),
+        MSBYTE(UAC2_BCDADC)
+      },
+    .ac_category = ADC_CATEGORY_SPEAKER,
+    .ac_totallen =
+      {
+        USB_SIZEOF_ADC_AC_IFDESC + USB_SIZEOF_ADC_CLKSRC_DESC +
+        USB_SIZEOF_ADC_INTERM_DESC + USB_SIZEOF_ADC_OUTTERM_DESC,
+        0
+      },
+    .ac_controls = 0
+  },
+  {
+    .cs_len      = USB_SIZEOF_ADC_CLKSRC_DESC,
+    .cs_type     = ADC_CS_INTERFACE,
+    .cs_subtype  = ADC_AC_CLOCK_SOURCE,
+    .cs_clockid  = UAC2_CLOCKID,
+    .cs_attr     = ADC_CLKSRC_INTERNAL_FIXED,
+    .cs_controls = 0x05, /* Frequency and validity read-only */
+    .cs_termid   = 0,
+    .cs_clksrc   = 0
+  },
+  {
+    .it_len      = USB_SIZEOF_ADC_INTERM_DESC,
+    .it_type     = ADC_CS_INTERFACE,
+    .it_subtype  = ADC_AC_INPUT_TERMINAL,
+    .it_termid   = UAC2_INTERMID,
+    .it_termtype =
+      {
+        LSBYTE(ADC_TERMINAL_STREAMING),
+        MSBYTE(ADC_TERMINAL_STREAMING)
+      },
+    .it_outterm  = 0,
+    .it_csrcid   = UAC2_CLOCKID,
+    .it_nchan    = CONFIG_USBUAC2_NCHANNELS,
+    .it_config   =
+      {
+        UAC2_CHANCONFIG, 0, 0, 0
+      },
+    .it_names    = 0,
+    .it_controls =
+      {
+        0, 0
+      },
+    .it_interm   = 0
+  },
+  {
+    .ot_len      = USB_SIZEOF_ADC_OUTTERM_DESC,
+    .ot_type     = ADC_CS_INTERFACE,
+    .ot_subtype  = ADC_AC_OUTPUT_TERMINAL,
+    .ot_termid   = UAC2_OUTTERMID,
+    .ot_termtype =
+      {
+        LSBYTE(ADC_OUTTERM_SPEAKER),
+        MSBYTE(ADC_OUTTERM_SPEAKER)
+      },
+    .ot_interm   = 0,
+    .ot_srcid    = UAC2_INTERMID,
+    .ot_csrcid   = UAC2_CLOCKID,
+    .ot_controls =
+      {
+        0, 0
+      },
+    .ot_outterm  = 0
+  },
+  {
+    .len         = USB_SIZEOF_IFDESC,
+    .type        = USB_DESC_TYPE_INTERFACE,
+    .ifno        = UAC2_IFNO_AS,
+    .alt         = 0,
+    .neps        = 0,
+    .classid     = ADC_ASIF_CLASS,
+    .subclass    = ADC_ASIF_SUBCLASS,
+    .protocol    = ADC_ASIF_PROTOCOL,
+    .iif         = 0
+  },
+  {
+    .len         = USB_SIZEOF_IFDESC,
+    .type        = USB_DESC_TYPE_INTERFACE,
+    .ifno        = UAC2_IFNO_AS,
+    .alt         = 1,
+    .neps        = UAC2_NENDPOINTS,
+    .classid     = ADC_ASIF_CLASS,
+    .subclass    = ADC_ASIF_SUBCLASS,
+    .protocol    = ADC_ASIF_PROTOCOL,
+    .iif         = 0
+  },
+  {
+    .as_len      = USB_SIZEOF_ADC_AS_IFDESC,
+    .as_type     = ADC_CS_INTERFACE,
+    .as_subtype  = ADC_AS_GENERAL,
+    .as_terminal = UAC2_INTERMID,
+    .as_controls = 0,
+    .as_format   = ADC_FORMAT_TYPEI,
+    .as_formats  =
+      {
+        ADC_FORMAT_TYPEI_PCM, 0, 0, 0
+      },
+    .as_nchan    = CONFIG_USBUAC2_NCHANNELS,
+    .as_config   =
+      {
+        UAC2_CHANCONFIG, 0, 0, 0
+      },
+    .as_names    = 0
+  },
+  {
+    .t1_len        = USB_SIZEOF_ADC_T1_FORMAT_DESC,
+    .t1_type       = ADC_CS_INTERFACE,
+    .t1_subtype    = ADC_AS_FORMAT_TYPE,
+    .t1_fmttype    = ADC_FORMAT_TYPEI,
+    .t1_size       = CONFIG_USBUAC2_SUBSLOTSIZE,
+    .fl_resolution = CONFIG_USBUAC2_RESOLUTION
+  },
+  {
+    .len         = USB_SIZEOF_EPDESC,
+    .type        = USB_DESC_TYPE_ENDPOINT,
+    .addr        = USB_DIR_OUT,
+    .attr        = USB_EP_ATTR_XFER_ISOC | USB_EP_ATTR_ASYNC,
+    .mxpacketsize =
+      {
+        LSBYTE(UAC2_MXPACKET),
+        MSBYTE(UAC2_MXPACKET)
+      },
+    .interval    = 1
+  },
+  {
+    .ae_len      = USB_SIZEOF_ADC_AUDIO_EPDESC,
+    .ae_type     = ADC_CS_ENDPOINT,
+    .ae_subtype  = ADC_EPTYPE_GENERAL,
+    .ae_attr     = 0,
+    .ae_controls = 0,
+    .ae_units    = 0,
+    .ae_delay    =
+      {
+        0, 0
+      }
+  },
+  {
+    .len         = USB_SIZEOF_EPDESC,
+    .type        = USB_DESC_TYPE_ENDPOINT,
+    .addr        = USB_DIR_IN,
+    .attr        = USB_EP_ATTR_XFER_ISOC | USB_EP_ATTR_NO_SYNC |
+                   USB_EP_ATTR_USAGE_FEEDBACK,
+    .mxpacketsize =
+      {
+        3, 0
+      },
+    .interval    = 1
+  }
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void usbclass_ep0incomplete(FAR struct usbdev_ep_s *ep,
+                                   FAR struct usbdev_req_s *req)
+{
+}
+
+/****************************************************************************
+ * Name: uac2_feedback
+ *
+ * Description:
+ *   Compute the number of samples per frame asked from the host, from the
+ *   number of samples waiting for the I2S device.
+ *
+ ****************************************************************************/
+
+static uint32_t uac2_feedback(FAR struct uac2_driver_s *priv, int32_t level)
+{
+  int32_t err;
+  int32_t fb;
+
+  priv->avg += level - (priv->avg >> UAC2_AVGSHIFT);
+  err = UAC2_TARGET - (priv->avg >> UAC2_AVGSHIFT);
+
+  priv->integ += err;
+  if (priv->integ > UAC2_INTEGMAX)
+    {
+      priv->integ = UAC2_INTEGMAX;
+    }
+  else if (priv->integ < -UAC2_INTEGMAX)
+    {
+      priv->integ = -UAC2_INTEGMAX;
+    }
+
+  fb = err * UAC2_KP + priv->integ / UAC2_KI;
+  if (fb > UAC2_FBMAXDEV)
+    {
+      fb = UAC2_FBMAXDEV;
+    }
+  else if (fb < -UAC2_FBMAXDEV)
+    {
+      fb = -UAC2_FBMAXDEV;
+    }
+
+  return UAC2_FBNOMINAL + fb;
+}
+
+/****************************************************************************
+ * Name: uac2_i2scallback
+ *
+ * Description:
+ *   The I2S device is done with a buffer, make it available for reception.
+ *
+ ****************************************************************************/
+
+static void uac2_i2scallback(FAR struct i2s_dev_s *dev,
+                             FAR struct ap_buffer_s *apb, FAR void *arg,
+                             int result)
+{
+  FAR struct uac2_driver_s *priv = arg;
+  irqstate_t flags;
+
+  if (result < 0)
+    {
+      uwarn("I2S transfer failed: %d\n", result);
+    }
+
+  flags = enter_critical_section();
+
+  priv->queued -= apb->nbytes;
+  if (priv->queued == 0)
+    {
+      /* The I2S device ran dry, buffer again before restarting */
+
+      priv->started = false;
+    }
+
+  dq_addlast(&apb->dq_entry, &priv->freeq);
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: uac2_sendworker
+ *
+ * Description:
+ *   Send the full buffers to the I2S device.  I2S_SEND may block, so this
+ *   runs on the high priority work queue rather than in the completion of
+ *   the OUT requests.
+ *
+ ****************************************************************************/
+
+static void uac2_sendworker(FAR void *arg)
+{
+  FAR struct uac2_driver_s *priv = arg;
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+  int ret;
+
+  flags = enter_critical_section();
+  while (priv->started &&
+         (apb = (FAR struct ap_buffer_s *)dq_remfirst(&priv->readyq)) !=
+         NULL)
+    {
+      leave_critical_section(flags);
+
+      ret = I2S_SEND(priv->i2s, apb, uac2_i2scallback, priv, 0);
+
+      flags = enter_critical_section();
+      if (ret < 0)
+        {
+          uerr("I2S_SEND failed: %d\n", ret);
+          priv->queued -= apb->nbytes;
+          dq_addlast(&apb->dq_entry, &priv->freeq);
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: uac2_rdcomplete
+ *
+ * Description:
+ *   An OUT packet was received into the current buffer.  Hand the buffer
+ *   over once it holds a period, and receive the next packet right behind
+ *   the last one.  Interrupt context.
+ *
+ ****************************************************************************/
+
+static void uac2_rdcomplete(FAR struct usbdev_ep_s *ep,
+                            FAR struct usbdev_req_s *req)
+{
+  FAR struct uac2_driver_s *priv = ep->priv;
+  FAR struct ap_buffer_s *apb = priv->cur;
+
+  if (req->result == -ESHUTDOWN || !priv->streaming)
+    {
+      return;
+    }
+
+  if (req->result == OK && apb != NULL)
+    {
+      apb->nbytes += req->xfrd - req->xfrd % UAC2_FRAMEBYTES;
+      if (apb->nbytes >= UAC2_PERIODBYTES)
+        {
+          dq_addlast(&apb->dq_entry, &priv->readyq);
+          priv->queued += apb->nbytes;
+          priv->cur     = NULL;
+
+          if (!priv->started &&
+              priv->queued >= UAC2_TARGET * UAC2_FRAMEBYTES)
+            {
+              priv->started = true;
+            }
+
+          if (priv->started && work_available(&priv->work))
+            {
+              work_queue(HPWORK, &priv->work, uac2_sendworker, priv, 0);
+            }
+        }
+    }
+
+  if (priv->cur == NULL)
+    {
+      apb = (FAR struct ap_buffer_s *)dq_remfirst(&priv->freeq);
+      if (apb != NULL)
+        {
+          apb->nbytes  = 0;
+          apb->curbyte = 0;
+        }
+
+      priv->cur = apb;
+    }
+
+  /* Without a buffer the packets are dropped until one is returned */
+
+  req->buf = apb != NULL ? &apb->samp[apb->nbytes] : priv->scratch;
+  req->len = UAC2_MXPACKET;
+  EP_SUBMIT(ep, req);
+}
+
+/****************************************************************************
+ * Name: uac2_fbcomplete
+ *
+ * Description:
+ *   The host took the feedback, send the next value.  Interrupt context.
+ *
+ ****************************************************************************/
+
+static void uac2_fbcomplete(FAR struct usbdev_ep_s *ep,
+                            FAR struct usbdev_req_s *req)
+{
+  FAR struct uac2_driver_s *priv = ep->priv;
+  uint32_t level;
+  uint32_t fb;
+
+  if (req->result == -ESHUTDOWN || !priv->streaming)
+    {
+      return;
+    }
+
+  level = priv->queued;
+  if (priv->cur != NULL)
+    {
+      level += priv->cur->nbytes;
+    }
+
+  fb = uac2_feedback(priv, level / UAC2_FRAMEBYTES);
+
+  req->buf[0] = fb & 0xff;
+  req->buf[1] = (fb >> 8) & 0xff;
+  req->buf[2] = (fb >> 16) & 0xff;
+  req->len    = 3;
+  EP_SUBMIT(ep, req);
+}
+
+/****************************************************************************
+ * Name: uac2_stopstream
+ *
+ * Description:
+ *   Leave alternate setting 1: disable the endpoints and drop the audio
+ *   that was not sent yet.  The buffers owned by the I2S device come back
+ *   through its callback.
+ *
+ ****************************************************************************/
+
+static void uac2_stopstream(FAR struct uac2_driver_s *priv)
+{
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  priv->alt = 0;
+  if (priv->streaming)
+    {
+      priv->streaming = false;
+      priv->started   = false;
+
+      EP_DISABLE(priv->epout);
+      EP_DISABLE(priv->epfb);
+
+      if (priv->cur != NULL)
+        {
+          dq_addlast(&priv->cur->dq_entry, &priv->freeq);
+          priv->cur = NULL;
+        }
+
+      while ((apb = (FAR struct ap_buffer_s *)dq_remfirst(&priv->readyq)) !=
+             NULL)
+        {
+          priv->queued -= apb->nbytes;
+          dq_addlast(&apb->dq_entry, &priv->freeq);
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: uac2_startstream
+ *
+ * Description:
+ *   Enter alternate setting 1: configure the endpoints and queue the first
+ *   OUT and feedback requests.
+ *
+ ****************************************************************************/
+
+static int uac2_startstream(FAR struct uac2_driver_s *priv)
+{
+  struct usb_epdesc_s epdesc;
+  irqstate_t flags;
+  int ret;
+
+  if (priv->streaming)
+    {
+      return OK;
+    }
+
+  epdesc       = g_uac2_cfgdesc.epout;
+  epdesc.addr |= priv->devinfo.epno[UAC2_EP_OUT_IDX];
+  ret = EP_CONFIGURE(priv->epout, &epdesc, false);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  epdesc       = g_uac2_cfgdesc.epfb;
+  epdesc.addr |= priv->devinfo.epno[UAC2_EP_FB_IDX];
+  ret = EP_CONFIGURE(priv->epfb, &epdesc, true);
+  if (ret < 0)
+    {
+      EP_DISABLE(priv->epout);
+      return ret;
+    }
+
+  flags = enter_critical_section();
+
+  priv->avg       = UAC2_TARGET << UAC2_AVGSHIFT;
+  priv->integ     = 0;
+  priv->started   = false;
+  priv->streaming = true;
+  priv->alt       = 1;
+
+  /* The completion handlers take a buffer and fill in the requests */
+
+  priv->rdreq->result = -EAGAIN;
+  uac2_rdcomplete(priv->epout, priv->rdreq);
+
+  priv->fbreq->result = OK;
+  uac2_fbcomplete(priv->epfb, priv->fbreq);
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+static int16_t uac2_mkcfgdesc(FAR uint8_t *buf,
+                              FAR struct usbdev_devinfo_s *devinfo)
+{
+  FAR struct uac2_cfgdesc_s *dest = (FAR struct uac2_cfgdesc_s *)buf;
+
+  *dest = g_uac2_cfgdesc;
+  dest->iad.firstif   += devinfo->ifnobase;
+  dest->iad.ifunction  = devinfo->strbase + UAC2_IFSTRID;
+  dest->acif.ifno     += devinfo->ifnobase;
+  dest->acif.iif       = devinfo->strbase + UAC2_IFSTRID;
+  dest->asif0.ifno    += devinfo->ifnobase;
+  dest->asif1.ifno    += devinfo->ifnobase;
+  dest->epout.addr    |= devinfo->epno[UAC2_EP_OUT_IDX];
+  dest->epfb.addr     |= devinfo->epno[UAC2_EP_FB_IDX];
+
+  return sizeof(g_uac2_cfgdesc);
+}
+
+#ifdef CONFIG_USBDEV_DUALSPEED
+static int16_t usbclass_mkcfgdesc(FAR uint8_t *buf,
+                                  FAR struct usbdev_devinfo_s *devinfo,
+                                  uint8_t speed, uint8_t type)
+#else
+static int16_t usbclass_mkcfgdesc(FAR uint8_t *buf,
+                                  FAR struct usbdev_devinfo_s *devinfo)
+#endif
+{
+  /* The function only has full speed descriptors */
+
+  return uac2_mkcfgdesc(buf, devinfo);
+}
+
+static int usbclass_mkstrdesc(uint8_t id, FAR struct usb_strdesc_s *strdesc)
+{
+  FAR uint8_t *data = (FAR uint8_t *)(strdesc + 1);
+  FAR const char *str;
+  int len;
+  int i;
+
+  if (id == UAC2_IFSTRID)
+    {
+      str = CONFIG_USBUAC2_INTERFACE_NAME;
+    }
+  else
+    {
+      return -EINVAL;
+    }
+
+  /* The string is utf16-le.  Only 7-bit ascii is handled. */
+
+  len = strlen(str);
+  for (i = 0; i < len; i++)
+    {
+      data[2 * i]     = str[i];
+      data[2 * i + 1] = 0;
+    }
+
+  strdesc->len  = 2 + 2 * len;
+  strdesc->type = USB_DESC_TYPE_STRING;
+  return strdesc->len;
+}
+
+/****************************************************************************
+ * Name: uac2_classreq
+ *
+ * Description:
+ *   Handle the class requests of the audio control interface.  Only the
+ *   fixed clock source has controls.
+ *
+ ****************************************************************************/
+
+static int uac2_classreq(FAR struct uac2_driver_s *priv,
+                         FAR const struct usb_ctrlreq_s *ctrl,
+                         FAR uint8_t *dataout, size_t outlen)
+{
+  FAR uint8_t *buf = priv->ctrlreq->buf;
+  uint32_t rate = CONFIG_USBUAC2_SAMPLERATE;
+  bool in = (ctrl->type & USB_REQ_DIR_IN) != 0;
+  uint8_t cs = ctrl->value[1];
+
+  if (ctrl->index[0] != priv->devinfo.ifnobase + UAC2_IFNO_AC ||
+      ctrl->index[1] != UAC2_CLOCKID)
+    {
+      return -EOPNOTSUPP;
+    }
+
+  if (cs == ADC_CS_CONTROL_SAM_FREQ && ctrl->req == ADC_REQUEST_CUR)
+    {
+      if (!in)
+        {
+          /* The host may set the only rate there is */
+
+          if (dataout == NULL || outlen < 4 || GETUINT32(dataout) != rate)
+            {
+              return -EINVAL;
+            }
+
+          return 0;
+        }
+
+      buf[0] = rate & 0xff;
+      buf[1] = (rate >> 8) & 0xff;
+      buf[2] = (rate >> 16) & 0xff;
+      buf[3] = rate >> 24;
+      return USB_SIZEOF_ADC_L3_CURPARM;
+    }
+  else if (cs == ADC_CS_CONTROL_SAM_FREQ && ctrl->req == ADC_REQUEST_RANGE &&
+           in)
+    {
+      FAR struct adc_l3_rangeparm_s *range =
+        (FAR struct adc_l3_rangeparm_s *)buf;
+      int i;
+
+      range->l3_nranges[0] = 1;
+      range->l3_nranges[1] = 0;
+      for (i = 0; i < 4; i++)
+        {
+          range->l3_subrange[0].l3_min[i] = (rate >> (8 * i)) & 0xff;
+          range->l3_subrange[0].l3_max[i] = (rate >> (8 * i)) & 0xff;
+          range->l3_subrange[0].l3_res[i] = 0;
+        }
+
+      return USB_SIZEOF_ADC_L3_RANGEPARM(1);
+    }
+  else if (cs == ADC_CS_CONTROL_CLOCK_VALID &&
+           ctrl->req == ADC_REQUEST_CUR && in)
+    {
+      buf[0] = 1;
+      return USB_SIZEOF_ADC_LI_CURPARM;
+    }
+
+  return -EOPNOTSUPP;
+}
+
+static int  usbclass_setup(FAR struct usbdevclass_driver_s *driver,
+                           FAR struct usbdev_s *dev,
+                           FAR const struct usb_ctrlreq_s *ctrl,
+                           FAR uint8_t *dataout, size_t outlen)
+{
+  FAR struct uac2_driver_s *priv = (FAR struct uac2_driver_s *)driver;
+  FAR struct usbdev_req_s *ctrlreq = priv->ctrlreq;
+  uint16_t value;
+  uint16_t index;
+  uint16_t len;
+  int ret = -EOPNOTSUPP;
+
+  value = GETUINT16(ctrl->value);
+  index = GETUINT16(ctrl->index);
+  len   = GETUINT16(ctrl->len);
+
+  usbtrace(TRACE_CLASSSETUP, ctrl->req);
+  uinfo("type=%02x req=%02x value=%04x index=%04x len=%04x\n",
+        ctrl->type, ctrl->req, value, index, len);
+
+  if ((ctrl->type & USB_REQ_TYPE_MASK) == USB_REQ_TYPE_STANDARD)
+    {
+      if (ctrl->req == USB_REQ_GETDESCRIPTOR)
+        {
+          if (ctrl->value[1] == USB_DESC_TYPE_CONFIG)
+            {
+              ret = uac2_mkcfgdesc(ctrlreq->buf, &priv->devinfo);
+            }
+          else if (ctrl->value[1] == USB_DESC_TYPE_STRING)
+            {
+              ret = usbclass_mkstrdesc(ctrl->value[0],
+                               (FAR struct usb_strdesc_s *)ctrlreq->buf);
+            }
+        }
+      else if (ctrl->req == USB_REQ_SETCONFIGURATION)
+        {
+          if (value == 0)
+            {
+              uac2_stopstream(priv);
+            }
+
+          return 0; /* Composite driver will send the reply */
+        }
+      else if (ctrl->req == USB_REQ_SETINTERFACE)
+        {
+          if (index == priv->devinfo.ifnobase + UAC2_IFNO_AC)
+            {
+              ret = value == 0 ? 0 : -EINVAL;
+            }
+          else if (index == priv->devinfo.ifnobase + UAC2_IFNO_AS)
+            {
+              if (value == 0)
+                {
+                  uac2_stopstream(priv);
+                  ret = 0;
+                }
+              else if (value == 1)
+                {
+                  ret = uac2_startstream(priv);
+                }
+              else
+                {
+                  ret = -EINVAL;
+                }
+            }
+        }
+      else if (ctrl->req == USB_REQ_GETINTERFACE)
+        {
+          *(FAR uint8_t *)ctrlreq->buf =
+            index == priv->devinfo.ifnobase + UAC2_IFNO_AS ? priv->alt : 0;
+          ret = 1;
+        }
+    }
+  else if ((ctrl->type & USB_REQ_TYPE_MASK) == USB_REQ_TYPE_CLASS &&
+           (ctrl->type & USB_REQ_RECIPIENT_MASK) ==
+           USB_REQ_RECIPIENT_INTERFACE)
+    {
+      ret = uac2_classreq(priv, ctrl, dataout, outlen);
+    }
+
+  /* Respond to the setup command if data was returned.  On an error return
+   * value (ret < 0), the USB driver will stall.
+   */
+
+  if (ret >= 0)
+    {
+      ctrlreq->len   = (len < ret) ? len : ret;
+      ctrlreq->flags = USBDEV_REQFLAGS_NULLPKT;
+      ret            = composite_ep0submit(driver, dev, ctrlreq, ctrl);
+      if (ret < 0)
+        {
+          usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_EPRESPQ), (uint16_t)-ret);
+          ctrlreq->result = OK;
+        }
+    }
+
+  return ret;
+}
+
+static int  usbclass_bind(FAR struct usbdevclass_driver_s *driver,
+                          FAR struct usbdev_s *dev)
+{
+  FAR struct uac2_driver_s *priv = (FAR struct uac2_driver_s *)driver;
+  int ret = -ENOMEM;
+
+  priv->ctrlreq = usbdev_allocreq(dev->ep0, UAC2_MXDESCLEN);
+  if (priv->ctrlreq == NULL)
+    {
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_ALLOCCTRLREQ), 0);
+      goto error;
+    }
+
+  priv->ctrlreq->callback = usbclass_ep0incomplete;
+
+  priv->epout = DEV_ALLOCEP(dev,
+                            USB_DIR_OUT |
+                            priv->devinfo.epno[UAC2_EP_OUT_IDX],
+                            false, USB_EP_ATTR_XFER_ISOC);
+  priv->epfb  = DEV_ALLOCEP(dev,
+                            USB_DIR_IN |
+                            priv->devinfo.epno[UAC2_EP_FB_IDX],
+                            true, USB_EP_ATTR_XFER_ISOC);
+  if (priv->epout == NULL || priv->epfb == NULL)
+    {
+      uerr("Failed to allocate endpoints!\n");
+      ret = -ENODEV;
+      goto error;
+    }
+
+  priv->epout->priv = priv;
+  priv->epfb->priv  = priv;
+
+  /* The OUT request receives straight into the audio buffers.  Its own
+   * buffer only takes the packets dropped when no audio buffer is free.
+   */
+
+  priv->rdreq = usbdev_allocreq(priv->epout, UAC2_MXPACKET);
+  if (priv->rdreq == NULL)
+    {
+      goto error;
+    }
+
+  priv->scratch         = priv->rdreq->buf;
+  priv->rdreq->flags    = 0;
+  priv->rdreq->callback = uac2_rdcomplete;
+
+  priv->fbreq = usbdev_allocreq(priv->epfb, 4);
+  if (priv->fbreq == NULL)
+    {
+      goto error;
+    }
+
+  priv->fbreq->callback = uac2_fbcomplete;
+  return OK;
+
+error:
+  uerr("uac2 bind failed! ret: %d\n", ret);
+  usbclass_unbind(driver, dev);
+  return ret;
+}
+
+static void usbclass_unbind(FAR struct usbdevclass_driver_s *driver,
+                            FAR struct usbdev_s *dev)
+{
+  FAR struct uac2_driver_s *priv = (FAR struct uac2_driver_s *)driver;
+
+  uac2_stopstream(priv);
+
+  if (priv->fbreq != NULL)
+    {
+      usbdev_freereq(priv->epfb, priv->fbreq);
+      priv->fbreq = NULL;
+    }
+
+  if (priv->rdreq != NULL)
+    {
+      priv->rdreq->buf = priv->scratch;
+      usbdev_freereq(priv->epout, priv->rdreq);
+      priv->rdreq = NULL;
+    }
+
+  if (priv->epfb != NULL)
+    {
+      DEV_FREEEP(dev, priv->epfb);
+      priv->epfb = NULL;
+    }
+
+  if (priv->epout != NULL)
+    {
+      DEV_FREEEP(dev, priv->epout);
+      priv->epout = NULL;
+    }
+
+  if (priv->ctrlreq != NULL)
+    {
+      usbdev_freereq(dev->ep0, priv->ctrlreq);
+      priv->ctrlreq = NULL;
+    }
+}
+
+static void usbclass_disconnect(FAR struct usbdevclass_driver_s *driver,
+                                FAR struct usbdev_s *dev)
+{
+  FAR struct uac2_driver_s *priv = (FAR struct uac2_driver_s *)driver;
+
+  uac2_stopstream(priv);
+}
+
+/****************************************************************************
+ * Name: usbclass_uninitialize
+ *
+ * Description:
+ *   Free allocated memory
+ *
+ ****************************************************************************/
+
+static void usbclass_uninitialize(FAR struct usbdevclass_driver_s *classdev)
+{
+  FAR struct uac2_driver_s *priv = (FAR struct uac2_driver_s *)classdev;
+  int i;
+
+  for (i = 0; i < CONFIG_USBUAC2_NBUFFERS; i++)
+    {
+      if (priv->apb[i] != NULL)
+        {
+          apb_free(priv->apb[i]);
+        }
+    }
+
+  kmm_free(priv);
+}
+
+/****************************************************************************
+ * Name: usbclass_classobject
+ *
+ * Description:
+ *   Allocate the class object with its audio buffers and set up the I2S
+ *   device for the format of the stream.
+ *
+ * Returned Value:
+ *   0 on success, negative error code on failure.
+ *
+ ****************************************************************************/
+
+static int usbclass_classobject(int minor,
+                                FAR struct usbdev_devinfo_s *devinfo,
+                                FAR struct usbdevclass_driver_s **classdev)
+{
+  FAR struct uac2_driver_s *priv;
+  struct audio_buf_desc_s desc;
+  int ret;
+  int i;
+
+  priv = kmm_zalloc(sizeof(struct uac2_driver_s));
+  if (priv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  priv->drvr.speed = USB_SPEED_FULL;
+  priv->drvr.ops   = &g_uac2_driverops;
+  priv->devinfo    = *devinfo;
+
+  priv->i2s = board_uac2_i2sdev(minor);
+  if (priv->i2s == NULL)
+    {
+      uerr("No I2S device for UAC2 %d\n", minor);
+      ret = -ENODEV;
+      goto error;
+    }
+
+  I2S_TXCHANNELS(priv->i2s, CONFIG_USBUAC2_NCHANNELS);
+  I2S_TXSAMPLERATE(priv->i2s, CONFIG_USBUAC2_SAMPLERATE);
+  I2S_TXDATAWIDTH(priv->i2s, 8 * CONFIG_USBUAC2_SUBSLOTSIZE);
+
+  for (i = 0; i < CONFIG_USBUAC2_NBUFFERS; i++)
+    {
+      desc.numbytes   = UAC2_BUFSIZE;
+      desc.u.pbuffer  = &priv->apb[i];
+      ret = apb_alloc(&desc);
+      if (ret < 0)
+        {
+          goto error;
+        }
+
+      dq_addlast(&priv->apb[i]->dq_entry, &priv->freeq);
+    }
+
+  *classdev = &priv->drvr;
+  return OK;
+
+error:
+  usbclass_uninitialize(&priv->drvr);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+void usbdev_uac2_get_composite_devdesc(FAR struct composite_devdesc_s *dev)
+{
+  memset(dev, 0, sizeof(struct composite_devdesc_s));
+
+  dev->mkconfdesc          = usbclass_mkcfgdesc;
+  dev->mkstrdesc           = usbclass_mkstrdesc;
+  dev->classobject         = usbclass_classobject;
+  dev->uninitialize        = usbclass_uninitialize;
+  dev->nconfigs            = 1;
+  dev->configid            = 0;
+  dev->cfgdescsize         = sizeof(g_uac2_cfgdesc);
+  dev->devinfo.ninterfaces = UAC2_NINTERFACES;
+  dev->devinfo.nstrings    = UAC2_NSTRINGS;
+  dev->devinfo.nendpoints  = UAC2_NENDPOINTS;
+}
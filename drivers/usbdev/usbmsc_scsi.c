@@ -164,6 +164,9 @@ static inline int usbmsc_setupcmd(FAR struct usbmsc_dev_s *priv,
 
 static int    usbmsc_idlestate(FAR struct usbmsc_dev_s *priv);
 static int    usbmsc_cmdparsestate(FAR struct usbmsc_dev_s *priv);
+#ifdef CONFIG_USBMSC_RDPIPELINE
+static int    usbmsc_cmdreadpipeline(FAR struct usbmsc_dev_s *priv);
+#endif
 static int    usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv);
 static int    usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv);
 static int    usbmsc_cmdfinishstate(FAR struct usbmsc_dev_s *priv);
@@ -2202,6 +2205,107 @@ static int usbmsc_cmdparsestate(FAR struct usbmsc_dev_s *priv)
   return ret;
 }
 
+/****************************************************************************
+ * Name: usbmsc_cmdreadpipeline
+ *
+ * Description:
+ *   Pipelined version of usbmsc_cmdreadstate used when a bulk IN request
+ *   can hold at least one whole sector.  Sectors are read by the block
+ *   driver directly into the next free write request, which is submitted
+ *   at once.  The block driver then reads the following sectors into the
+ *   next request while the previous ones are still being sent;  so up to
+ *   CONFIG_USBMSC_NWRREQS request buffers are in flight and the media and
+ *   the USB bus run concurrently.
+ *
+ * Returned Value:
+ *   Same as usbmsc_cmdreadstate:  -ENOMEM when all write requests are in
+ *   flight (the worker is awakened again when one is returned), OK when
+ *   the command is fully processed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_USBMSC_RDPIPELINE
+static int usbmsc_cmdreadpipeline(FAR struct usbmsc_dev_s *priv)
+{
+  FAR struct usbmsc_lun_s *lun = priv->lun;
+  FAR struct usbmsc_req_s *privreq;
+  FAR struct usbdev_req_s *req;
+  irqstate_t flags;
+  uint32_t nsectors;
+  ssize_t nread;
+  int ret;
+
+  while (priv->u.xfrlen > 0)
+    {
+      usbtrace(TRACE_CLASSSTATE(USBMSC_CLASSSTATE_CMDREAD), priv->u.xfrlen);
+
+      /* Get the next free write request.  If all of them are in flight,
+       * stay in the CMDREAD state until one is returned.
+       */
+
+      flags   = enter_critical_section();
+      privreq = (FAR struct usbmsc_req_s *)sq_remfirst(&priv->wrreqlist);
+      leave_critical_section(flags);
+
+      if (!privreq)
+        {
+          usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADWRRQEMPTY), 0);
+          return -ENOMEM;
+        }
+
+      /* Read as many whole sectors as fit into the request buffer */
+
+      req      = privreq->req;
+      nsectors = MIN(priv->u.xfrlen,
+                     CONFIG_USBMSC_BULKINREQLEN / lun->sectorsize);
+
+      nread = USBMSC_DRVR_READ(lun, req->buf, priv->sector, nsectors);
+      if (nread < 0)
+        {
+          usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADREADFAIL),
+                   -nread);
+          lun->sd     = SCSI_KCQME_UNRRE1;
+          lun->sdinfo = priv->sector;
+
+          flags = enter_critical_section();
+          sq_addfirst((FAR sq_entry_t *)privreq, &priv->wrreqlist);
+          leave_critical_section(flags);
+          break;
+        }
+
+      /* And submit the request to the bulk IN endpoint */
+
+      req->len      = nsectors * lun->sectorsize;
+      req->priv     = privreq;
+      req->callback = usbmsc_wrcomplete;
+      req->flags    = 0;
+
+      ret           = EP_SUBMIT(priv->epbulkin, req);
+      if (ret != OK)
+        {
+          usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADSUBMIT),
+                   (uint16_t)-ret);
+          lun->sd     = SCSI_KCQME_UNRRE1;
+          lun->sdinfo = priv->sector;
+
+          flags = enter_critical_section();
+          sq_addfirst((FAR sq_entry_t *)privreq, &priv->wrreqlist);
+          leave_critical_section(flags);
+          break;
+        }
+
+      priv->residue  -= req->len;
+      priv->u.xfrlen -= nsectors;
+      priv->sector   += nsectors;
+    }
+
+  usbtrace(TRACE_CLASSSTATE(USBMSC_CLASSSTATE_CMDREADCMDFINISH),
+           priv->u.xfrlen);
+  priv->thstate  = USBMSC_STATE_CMDFINISH;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: usbmsc_cmdreadstate
  *
@@ -2240,6 +2344,15 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
   int nbytes;
   int ret;
 
+#ifdef CONFIG_USBMSC_RDPIPELINE
+  /* Read straight into the request buffers if they hold whole sectors */
+
+  if (CONFIG_USBMSC_BULKINREQLEN >= lun->sectorsize)
+    {
+      return usbmsc_cmdreadpipeline(priv);
+    }
+#endif
+
   /* Loop transferring data until either (1) all of the data has been
    * transferred, or (2) we have used up all of the write requests that we
    * have available.
@@ -39,7 +39,10 @@
 #include <arch/irq.h>
 
 #include <nuttx/random.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/mm/map.h>
 #include <nuttx/mutex.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/usrsock.h>
@@ -52,6 +55,27 @@
 #  define CONFIG_NET_USRSOCKDEV_NPOLLWAITERS 1
 #endif
 
+#ifdef CONFIG_NET_USRSOCKDEV_SHMRING
+#  if CONFIG_NET_USRSOCKDEV_SHMRING_SIZE % USRSOCK_SHMRING_ALIGN != 0
+#    error CONFIG_NET_USRSOCKDEV_SHMRING_SIZE must be a multiple of 4
+#  endif
+
+/* The mapping is the ring heads followed by the two record areas */
+
+#  define USRSOCKDEV_SHM_SIZE \
+     (sizeof(struct usrsock_shm_s) + 2 * CONFIG_NET_USRSOCKDEV_SHMRING_SIZE)
+
+#  define USRSOCKDEV_SHM_RECLEN(b, o) \
+     (*(FAR volatile uint32_t *)((FAR uint8_t *)(b) + (o)))
+
+/* Without SMP only the compiler may reorder the accesses to the rings */
+
+#  ifndef CONFIG_SPINLOCK
+#    undef  SP_DMB
+#    define SP_DMB()  __asm__ __volatile__ ("" : : : "memory")
+#  endif
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -66,6 +90,9 @@ struct usrsockdev_s
     int                     iovcnt; /* Number of request buffers */
     size_t                  pos;    /* Reader position on request buffer */
   } req;
+#ifdef CONFIG_NET_USRSOCKDEV_SHMRING
+  FAR struct usrsock_shm_s *shm;    /* Rings mapped by the daemon */
+#endif
   FAR struct pollfd *pollfds[CONFIG_NET_USRSOCKDEV_NPOLLWAITERS];
 };
 
@@ -84,6 +111,14 @@ static ssize_t usrsockdev_write(FAR struct file *filep,
 static off_t usrsockdev_seek(FAR struct file *filep, off_t offset,
                              int whence);
 
+#ifdef CONFIG_NET_USRSOCKDEV_SHMRING
+static int usrsockdev_ioctl(FAR struct file *filep, int cmd,
+                            unsigned long arg);
+
+static int usrsockdev_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
+#endif
+
 static int usrsockdev_open(FAR struct file *filep);
 
 static int usrsockdev_close(FAR struct file *filep);
@@ -102,8 +137,13 @@ static const struct file_operations g_usrsockdevops =
   usrsockdev_read,    /* read */
   usrsockdev_write,   /* write */
   usrsockdev_seek,    /* seek */
+#ifdef CONFIG_NET_USRSOCKDEV_SHMRING
+  usrsockdev_ioctl,   /* ioctl */
+  usrsockdev_mmap,    /* mmap */
+#else
   NULL,               /* ioctl */
   NULL,               /* mmap */
+#endif
   NULL,               /* truncate */
   usrsockdev_poll     /* poll */
 };
@@ -133,6 +173,189 @@ static bool usrsockdev_is_opened(FAR struct usrsockdev_s *dev)
   return ret;
 }
 
+/****************************************************************************
+ * Name: usrsockdev_handle
+ *
+ * Description:
+ *   Handle a buffer written by the daemon.  The buffer may carry several
+ *   responses and events back to back, each one with its data.
+ *
+ * Returned Value:
+ *   The number of bytes handled, or a negated errno value if the first
+ *   message was rejected.
+ *
+ ****************************************************************************/
+
+static ssize_t usrsockdev_handle(FAR struct usrsockdev_s *dev,
+                                 FAR const char *buffer, size_t len)
+{
+  bool req_done = false;
+  ssize_t ret = 0;
+  size_t pos = 0;
+
+  while (pos < len)
+    {
+      ret = usrsock_response(buffer + pos, len - pos, &req_done);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      pos += ret;
+    }
+
+  if (req_done && dev->req.iov)
+    {
+      dev->req.iov = NULL;
+      dev->req.pos = 0;
+      dev->req.iovcnt = 0;
+    }
+
+  return pos > 0 ? pos : ret;
+}
+
+#ifdef CONFIG_NET_USRSOCKDEV_SHMRING
+/****************************************************************************
+ * Name: usrsockdev_shm_put
+ *
+ * Description:
+ *   Queue a request with its payload in the request ring.
+ *
+ * Returned Value:
+ *   True if queued; false if the ring is not mapped or has no room, then
+ *   the request is passed through read().
+ *
+ ****************************************************************************/
+
+static bool usrsockdev_shm_put(FAR struct usrsockdev_s *dev,
+                               FAR const struct iovec *iov, int iovcnt)
+{
+  FAR struct usrsock_shmring_s *ring;
+  FAR uint8_t *base;
+  uint32_t space;
+  uint32_t head;
+  uint32_t tail;
+  uint32_t need;
+  size_t len = 0;
+  int i;
+
+  if (dev->shm == NULL)
+    {
+      return false;
+    }
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      len += iov[i].iov_len;
+    }
+
+  ring = &dev->shm->req;
+  base = (FAR uint8_t *)dev->shm + ring->offset;
+  need = USRSOCK_SHMRING_RECLEN(len);
+  head = ring->head;
+  tail = ring->tail;
+
+  /* Keep one slot free so that a full ring never looks empty */
+
+  if (head >= tail)
+    {
+      space = ring->size - head;
+      if (space < need || (space == need && tail == 0))
+        {
+          if (tail <= need)
+            {
+              return false;
+            }
+
+          USRSOCKDEV_SHM_RECLEN(base, head) = USRSOCK_SHMRING_WRAP;
+          head = 0;
+        }
+    }
+  else if (tail - head <= need)
+    {
+      return false;
+    }
+
+  USRSOCKDEV_SHM_RECLEN(base, head) = len;
+  usrsock_iovec_get(base + head + sizeof(uint32_t), len, iov, iovcnt, 0,
+                    NULL);
+
+  head += need;
+  if (head == ring->size)
+    {
+      head = 0;
+    }
+
+  /* The record must be visible before the new head */
+
+  SP_DMB();
+  ring->head = head;
+  return true;
+}
+
+/****************************************************************************
+ * Name: usrsockdev_shm_flush
+ *
+ * Description:
+ *   Handle the records that the daemon queued in the response ring.
+ *
+ * Returned Value:
+ *   The number of records handled, or a negated errno value if the ring
+ *   is corrupted.
+ *
+ ****************************************************************************/
+
+static int usrsockdev_shm_flush(FAR struct usrsockdev_s *dev)
+{
+  FAR struct usrsock_shmring_s *ring = &dev->shm->resp;
+  FAR uint8_t *base = (FAR uint8_t *)dev->shm + ring->offset;
+  uint32_t tail;
+  uint32_t len;
+  int nrec = 0;
+
+  while ((tail = ring->tail) != ring->head)
+    {
+      SP_DMB();
+
+      if (tail >= ring->size)
+        {
+          nerr("corrupted response ring at %" PRIu32 "\n", tail);
+          return -EINVAL;
+        }
+
+      len = USRSOCKDEV_SHM_RECLEN(base, tail);
+      if (len == USRSOCK_SHMRING_WRAP)
+        {
+          ring->tail = 0;
+          continue;
+        }
+
+      if (len > ring->size - tail - sizeof(uint32_t))
+        {
+          nerr("corrupted response ring at %" PRIu32 "\n", tail);
+          return -EINVAL;
+        }
+
+      usrsockdev_handle(dev, (FAR const char *)base + tail +
+                        sizeof(uint32_t), len);
+
+      tail += USRSOCK_SHMRING_RECLEN(len);
+      if (tail == ring->size)
+        {
+          tail = 0;
+        }
+
+      /* The record is consumed before the daemon may reuse it */
+
+      SP_DMB();
+      ring->tail = tail;
+      nrec++;
+    }
+
+  return nrec;
+}
+#endif
+
 /****************************************************************************
  * Name: usrsockdev_read
  ****************************************************************************/
@@ -270,7 +493,6 @@ static ssize_t usrsockdev_write(FAR struct file *filep,
 {
   FAR struct inode *inode = filep->f_inode;
   FAR struct usrsockdev_s *dev;
-  bool req_done = false;
   ssize_t ret = 0;
 
   if (len == 0)
@@ -293,17 +515,107 @@ static ssize_t usrsockdev_write(FAR struct file *filep,
       return ret;
     }
 
-  ret = usrsock_response(buffer, len, &req_done);
-  if (req_done && dev->req.iov)
+  ret = usrsockdev_handle(dev, buffer, len);
+
+  nxmutex_unlock(&dev->devlock);
+  return ret;
+}
+
+#ifdef CONFIG_NET_USRSOCKDEV_SHMRING
+/****************************************************************************
+ * Name: usrsockdev_ioctl
+ ****************************************************************************/
+
+static int usrsockdev_ioctl(FAR struct file *filep, int cmd,
+                            unsigned long arg)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct usrsockdev_s *dev;
+  int ret;
+
+  dev = inode->i_private;
+
+  DEBUGASSERT(dev);
+
+  ret = nxmutex_lock(&dev->devlock);
+  if (ret < 0)
     {
-      dev->req.iov = NULL;
-      dev->req.pos = 0;
-      dev->req.iovcnt = 0;
+      return ret;
+    }
+
+  switch (cmd)
+    {
+      case USRSOCKIOC_SHMFLUSH:
+        ret = dev->shm != NULL ? usrsockdev_shm_flush(dev) : -ENXIO;
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  nxmutex_unlock(&dev->devlock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: usrsockdev_mmap
+ *
+ * Description:
+ *   Map the shared-memory rings.  They are allocated by the first mapping
+ *   and requests are queued in them from then on, until the daemon closes
+ *   the device.
+ *
+ ****************************************************************************/
+
+static int usrsockdev_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct usrsockdev_s *dev;
+  FAR struct usrsock_shm_s *shm;
+  int ret;
+
+  dev = inode->i_private;
+
+  DEBUGASSERT(dev);
+
+  if (map->offset != 0 || map->length == 0 ||
+      map->length > USRSOCKDEV_SHM_SIZE)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&dev->devlock);
+  if (ret < 0)
+    {
+      return ret;
     }
 
+  shm = dev->shm;
+  if (shm == NULL)
+    {
+      shm = kumm_zalloc(USRSOCKDEV_SHM_SIZE);
+      if (shm == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout;
+        }
+
+      shm->req.offset  = sizeof(struct usrsock_shm_s);
+      shm->req.size    = CONFIG_NET_USRSOCKDEV_SHMRING_SIZE;
+      shm->resp.offset = shm->req.offset + shm->req.size;
+      shm->resp.size   = CONFIG_NET_USRSOCKDEV_SHMRING_SIZE;
+      dev->shm         = shm;
+    }
+
+  map->vaddr = shm;
+
+errout:
   nxmutex_unlock(&dev->devlock);
   return ret;
 }
+#endif
 
 /****************************************************************************
  * Name: usrsockdev_open
@@ -380,6 +692,14 @@ static int usrsockdev_close(FAR struct file *filep)
   dev->req.iovcnt = 0;
   dev->req.pos = 0;
 
+#ifdef CONFIG_NET_USRSOCKDEV_SHMRING
+  if (dev->shm != NULL)
+    {
+      kumm_free(dev->shm);
+      dev->shm = NULL;
+    }
+#endif
+
   nxmutex_unlock(&dev->devlock);
   usrsock_abort();
 
@@ -458,6 +778,13 @@ static int usrsockdev_poll(FAR struct file *filep, FAR struct pollfd *fds,
           eventset |= POLLIN;
         }
 
+#ifdef CONFIG_NET_USRSOCKDEV_SHMRING
+      if (dev->shm != NULL && dev->shm->req.head != dev->shm->req.tail)
+        {
+          eventset |= POLLIN;
+        }
+#endif
+
       poll_notify(dev->pollfds, nitems(dev->pollfds), eventset);
     }
   else
@@ -502,10 +829,15 @@ int usrsock_request(FAR struct iovec *iov, unsigned int iovcnt)
 
   if (usrsockdev_is_opened(dev))
     {
-      DEBUGASSERT(dev->req.iov == NULL);
-      dev->req.iov = iov;
-      dev->req.pos = 0;
-      dev->req.iovcnt = iovcnt;
+#ifdef CONFIG_NET_USRSOCKDEV_SHMRING
+      if (!usrsockdev_shm_put(dev, iov, iovcnt))
+#endif
+        {
+          DEBUGASSERT(dev->req.iov == NULL);
+          dev->req.iov = iov;
+          dev->req.pos = 0;
+          dev->req.iovcnt = iovcnt;
+        }
 
       /* Notify daemon of new request. */
 
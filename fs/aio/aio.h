@@ -31,6 +31,7 @@
 #include <string.h>
 #include <aio.h>
 
+#include <nuttx/fs/fs.h>
 #include <nuttx/queue.h>
 #include <nuttx/wqueue.h>
 
@@ -68,6 +69,9 @@ struct aio_container_s
 #ifdef CONFIG_PRIORITY_INHERITANCE
   uint8_t aioc_prio;               /* Priority of the waiting task */
 #endif
+#ifdef CONFIG_FS_BLOCK_ASYNC
+  struct blk_request_s aioc_req;   /* Used to submit the I/O to the driver */
+#endif
 };
 
 /****************************************************************************
@@ -220,6 +224,29 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
 
 int aio_queue(FAR struct aio_container_s *aioc, worker_t worker);
 
+/****************************************************************************
+ * Name: aio_submit
+ *
+ * Description:
+ *   Submit the I/O directly to a block driver that supports asynchronous
+ *   transfers (see CONFIG_FS_BLOCK_ASYNC), bypassing the work queue.  Only
+ *   sector aligned transfers on BCH character devices qualify.
+ *
+ * Input Parameters:
+ *   aioc  - The AIO container
+ *   write - True for aio_write(), false for aio_read()
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O was submitted; the container may have been
+ *   released already.  A negated errno value if the I/O must be queued
+ *   with aio_queue() instead.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLOCK_ASYNC
+int aio_submit(FAR struct aio_container_s *aioc, bool write);
+#endif
+
 /****************************************************************************
  * Name: aio_signal
  *
@@ -266,6 +266,15 @@ int aio_read(FAR struct aiocb *aiocbp)
       return ERROR;
     }
 
+#ifdef CONFIG_FS_BLOCK_ASYNC
+  /* Sector aligned transfers on block devices go straight to the driver */
+
+  if (aio_submit(aioc, false) >= 0)
+    {
+      return OK;
+    }
+#endif
+
   /* Defer the work to the worker thread */
 
   ret = aio_queue(aioc, aio_read_worker);
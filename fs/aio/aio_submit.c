@@ -0,0 +1,153 @@
+/****************************************************************************
+ * fs/aio/aio_submit.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/ioctl.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <aio.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+
+#include "aio/aio.h"
+
+#if defined(CONFIG_FS_AIO) && defined(CONFIG_FS_BLOCK_ASYNC)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_submit_complete
+ *
+ * Description:
+ *   Called by the driver, on its own thread, when the transfer has ended.
+ *   It finishes the I/O like the worker of aio_read() or aio_write() does.
+ *
+ ****************************************************************************/
+
+static void aio_submit_complete(FAR struct blk_request_s *req,
+                                ssize_t result)
+{
+  FAR struct aio_container_s *aioc = req->priv;
+  FAR struct aiocb *aiocbp;
+  unsigned int nsectors;
+  pid_t pid;
+
+  DEBUGASSERT(aioc && aioc->aioc_aiocbp);
+
+  nsectors = req->nsectors;
+  pid      = aioc->aioc_pid;
+  aiocbp   = aioc_decant(aioc);
+
+  /* The driver counts sectors, the caller bytes */
+
+  if (result > 0)
+    {
+      result *= aiocbp->aio_nbytes / nsectors;
+    }
+  else if (result < 0)
+    {
+      ferr("ERROR: I/O failed: %zd\n", result);
+    }
+
+  aiocbp->aio_result = result;
+  aio_signal(pid, aiocbp);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_submit
+ *
+ * Description:
+ *   Submit the I/O directly to a block driver that supports asynchronous
+ *   transfers.
+ *
+ ****************************************************************************/
+
+int aio_submit(FAR struct aio_container_s *aioc, bool write)
+{
+  FAR struct blk_request_s *req = &aioc->aioc_req;
+  FAR struct aiocb *aiocbp = aioc->aioc_aiocbp;
+  struct geometry geo;
+  blkcnt_t sector;
+  int ret;
+
+  /* Only BCH character devices answer BIOC_GEOMETRY */
+
+  ret = file_ioctl(aioc->aioc_filep, BIOC_GEOMETRY,
+                   (unsigned long)((uintptr_t)&geo));
+  if (ret < 0 || !geo.geo_available || geo.geo_sectorsize == 0)
+    {
+      return -ENOTTY;
+    }
+
+  /* The driver transfers whole sectors to and from the caller's buffer.
+   * Anything else, transfers past the end of the media and appends keep
+   * the file semantics of the work queue path.
+   */
+
+  if (aiocbp->aio_nbytes == 0 ||
+      aiocbp->aio_offset % geo.geo_sectorsize != 0 ||
+      aiocbp->aio_nbytes % geo.geo_sectorsize != 0)
+    {
+      return -ENOTTY;
+    }
+
+  sector = aiocbp->aio_offset / geo.geo_sectorsize;
+  if (sector + aiocbp->aio_nbytes / geo.geo_sectorsize > geo.geo_nsectors)
+    {
+      return -ENOTTY;
+    }
+
+  if (write &&
+      (file_fcntl(aioc->aioc_filep, F_GETFL) & O_APPEND) != 0)
+    {
+      return -ENOTTY;
+    }
+
+  req->buffer       = (FAR unsigned char *)aiocbp->aio_buf;
+  req->start_sector = sector;
+  req->nsectors     = aiocbp->aio_nbytes / geo.geo_sectorsize;
+  req->write        = write;
+  req->complete     = aio_submit_complete;
+  req->priv         = aioc;
+
+  /* On success the container belongs to aio_submit_complete(), which may
+   * already have run.
+   */
+
+  return file_ioctl(aioc->aioc_filep, BIOC_SUBMIT,
+                    (unsigned long)((uintptr_t)req));
+}
+
+#endif /* CONFIG_FS_AIO && CONFIG_FS_BLOCK_ASYNC */
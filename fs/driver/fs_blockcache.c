@@ -0,0 +1,957 @@
+/****************************************************************************
+ * fs/driver/fs_blockcache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/mount.h>
+#include <sys/stat.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/lib/lib.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/queue.h>
+
+#include "driver/driver.h"
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_BLOCKCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BLOCKCACHE_NPAGES \
+  (CONFIG_FS_BLOCKCACHE_SIZE / CONFIG_FS_BLOCKCACHE_SECTORSIZE)
+
+/* Transfers of more sectors than this are not kept in the cache, so that
+ * streaming a large file does not evict everything else.
+ */
+
+#define BLOCKCACHE_MAXRUN     (BLOCKCACHE_NPAGES / 4)
+
+#define BLOCKCACHE_NBUCKETS   32
+#define BLOCKCACHE_HASH(d, s) \
+  ((((uintptr_t)(d) >> 4) + (uintptr_t)(s)) & (BLOCKCACHE_NBUCKETS - 1))
+
+#define BLOCKCACHE_DATA(p) \
+  (g_blockcache_data + ((p) - g_blockcache_pages) * \
+   CONFIG_FS_BLOCKCACHE_SECTORSIZE)
+
+#define BLOCKCACHE_LINELEN    80
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct blockcache_dev_s;
+
+/* One cached sector.  Every page is on the LRU list, most recently used
+ * first; pages in use are also on a hash chain.
+ */
+
+struct blockcache_page_s
+{
+  dq_entry_t lru;                         /* LRU list */
+  FAR struct blockcache_page_s *hnext;    /* Hash chain */
+  FAR struct blockcache_dev_s *dev;       /* Owner, NULL if the page is free */
+  blkcnt_t sector;                        /* Sector of the owner */
+  bool dirty;                             /* Not yet written to the owner */
+};
+
+/* One cached block device */
+
+struct blockcache_dev_s
+{
+  FAR struct blockcache_dev_s *flink;     /* List of cached devices */
+  FAR struct inode *parent;               /* The cached block driver */
+  FAR char *path;                         /* Path of the cache inode */
+  size_t sectorsize;                      /* Sector size of the parent */
+  uint32_t npages;                        /* Pages held by the device */
+  uint32_t hits;                          /* Sectors read from the cache */
+  uint32_t misses;                        /* Sectors read from the parent */
+  uint32_t writes;                        /* Sectors written by the user */
+  uint32_t writebacks;                    /* Dirty sectors written back */
+};
+
+#if !defined(CONFIG_FS_PROCFS_EXCLUDE_BLOCKCACHE) && defined(CONFIG_FS_PROCFS)
+struct blockcache_file_s
+{
+  struct procfs_file_s base;              /* Base open file structure */
+  char line[BLOCKCACHE_LINELEN];          /* Buffer for formatted lines */
+};
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     blockcache_open(FAR struct inode *inode);
+static int     blockcache_close(FAR struct inode *inode);
+static ssize_t blockcache_read(FAR struct inode *inode,
+                 FAR unsigned char *buffer, blkcnt_t start_sector,
+                 unsigned int nsectors);
+static ssize_t blockcache_write(FAR struct inode *inode,
+                 FAR const unsigned char *buffer, blkcnt_t start_sector,
+                 unsigned int nsectors);
+static int     blockcache_geometry(FAR struct inode *inode,
+                 FAR struct geometry *geometry);
+static int     blockcache_ioctl(FAR struct inode *inode, int cmd,
+                 unsigned long arg);
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int     blockcache_unlink(FAR struct inode *inode);
+#endif
+
+#if !defined(CONFIG_FS_PROCFS_EXCLUDE_BLOCKCACHE) && defined(CONFIG_FS_PROCFS)
+static int     blockcache_procfs_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     blockcache_procfs_close(FAR struct file *filep);
+static ssize_t blockcache_procfs_read(FAR struct file *filep,
+                 FAR char *buffer, size_t buflen);
+static int     blockcache_procfs_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     blockcache_procfs_stat(FAR const char *relpath,
+                 FAR struct stat *buf);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct block_operations g_blockcache_bops =
+{
+  blockcache_open,     /* open     */
+  blockcache_close,    /* close    */
+  blockcache_read,     /* read     */
+  blockcache_write,    /* write    */
+  blockcache_geometry, /* geometry */
+  blockcache_ioctl     /* ioctl    */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , blockcache_unlink  /* unlink   */
+#endif
+};
+
+/* The page pool shared by all cached devices.  It is allocated when the
+ * first device is registered.
+ */
+
+static mutex_t g_blockcache_lock = NXMUTEX_INITIALIZER;
+static FAR struct blockcache_page_s *g_blockcache_pages;
+static FAR uint8_t *g_blockcache_data;
+static FAR struct blockcache_page_s *g_blockcache_hash[BLOCKCACHE_NBUCKETS];
+static dq_queue_t g_blockcache_lru;
+static FAR struct blockcache_dev_s *g_blockcache_devs;
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#if !defined(CONFIG_FS_PROCFS_EXCLUDE_BLOCKCACHE) && defined(CONFIG_FS_PROCFS)
+/* See fs/procfs/fs_procfs.c -- this structure is explicitly externed there */
+
+const struct procfs_operations g_blockcache_operations =
+{
+  blockcache_procfs_open,  /* open */
+  blockcache_procfs_close, /* close */
+  blockcache_procfs_read,  /* read */
+  NULL,                    /* write */
+  blockcache_procfs_dup,   /* dup */
+  NULL,                    /* opendir */
+  NULL,                    /* closedir */
+  NULL,                    /* readdir */
+  NULL,                    /* rewinddir */
+  blockcache_procfs_stat   /* stat */
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blockcache_find
+ *
+ * Description:
+ *   Return the page that holds a sector of a device, or NULL.
+ *
+ ****************************************************************************/
+
+static FAR struct blockcache_page_s *
+blockcache_find(FAR struct blockcache_dev_s *dev, blkcnt_t sector)
+{
+  FAR struct blockcache_page_s *page;
+
+  for (page = g_blockcache_hash[BLOCKCACHE_HASH(dev, sector)];
+       page != NULL; page = page->hnext)
+    {
+      if (page->dev == dev && page->sector == sector)
+        {
+          break;
+        }
+    }
+
+  return page;
+}
+
+/****************************************************************************
+ * Name: blockcache_touch
+ *
+ * Description:
+ *   Make a page the most recently used one.
+ *
+ ****************************************************************************/
+
+static void blockcache_touch(FAR struct blockcache_page_s *page)
+{
+  dq_rem(&page->lru, &g_blockcache_lru);
+  dq_addfirst(&page->lru, &g_blockcache_lru);
+}
+
+/****************************************************************************
+ * Name: blockcache_writeback
+ *
+ * Description:
+ *   Write a dirty page to its device.
+ *
+ ****************************************************************************/
+
+static int blockcache_writeback(FAR struct blockcache_page_s *page)
+{
+  FAR struct blockcache_dev_s *dev = page->dev;
+  ssize_t ret;
+
+  ret = dev->parent->u.i_bops->write(dev->parent, BLOCKCACHE_DATA(page),
+                                     page->sector, 1);
+  if (ret < 0)
+    {
+      ferr("ERROR: Write back of sector %jd failed: %zd\n",
+           (intmax_t)page->sector, ret);
+      return ret;
+    }
+
+  page->dirty = false;
+  dev->writebacks++;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: blockcache_release
+ *
+ * Description:
+ *   Take a page from its device and make it the least recently used one.
+ *
+ ****************************************************************************/
+
+static void blockcache_release(FAR struct blockcache_page_s *page)
+{
+  FAR struct blockcache_page_s **pprev;
+
+  pprev = &g_blockcache_hash[BLOCKCACHE_HASH(page->dev, page->sector)];
+  while (*pprev != page)
+    {
+      pprev = &(*pprev)->hnext;
+    }
+
+  *pprev = page->hnext;
+
+  page->dev->npages--;
+  page->dev   = NULL;
+  page->hnext = NULL;
+  page->dirty = false;
+
+  dq_rem(&page->lru, &g_blockcache_lru);
+  dq_addlast(&page->lru, &g_blockcache_lru);
+}
+
+/****************************************************************************
+ * Name: blockcache_insert
+ *
+ * Description:
+ *   Recycle the least recently used page to hold a sector of a device.  A
+ *   dirty page is written back first; the data of a page whose write back
+ *   fails is lost, like on a failing write through.
+ *
+ ****************************************************************************/
+
+static FAR struct blockcache_page_s *
+blockcache_insert(FAR struct blockcache_dev_s *dev, blkcnt_t sector,
+                  FAR const uint8_t *data)
+{
+  FAR struct blockcache_page_s *page;
+  int ndx;
+
+  page = (FAR struct blockcache_page_s *)dq_tail(&g_blockcache_lru);
+  if (page->dev != NULL)
+    {
+      if (page->dirty)
+        {
+          blockcache_writeback(page);
+        }
+
+      blockcache_release(page);
+    }
+
+  ndx          = BLOCKCACHE_HASH(dev, sector);
+  page->dev    = dev;
+  page->sector = sector;
+  page->hnext  = g_blockcache_hash[ndx];
+  g_blockcache_hash[ndx] = page;
+  dev->npages++;
+
+  memcpy(BLOCKCACHE_DATA(page), data, dev->sectorsize);
+  blockcache_touch(page);
+  return page;
+}
+
+/****************************************************************************
+ * Name: blockcache_flush
+ *
+ * Description:
+ *   Write back the dirty pages of a device and, if 'invalidate' is true,
+ *   give all of its pages back to the pool.
+ *
+ ****************************************************************************/
+
+static int blockcache_flush(FAR struct blockcache_dev_s *dev,
+                            bool invalidate)
+{
+  FAR struct blockcache_page_s *page;
+  int ret = OK;
+  int i;
+
+  for (i = 0; i < BLOCKCACHE_NPAGES && dev->npages > 0; i++)
+    {
+      page = &g_blockcache_pages[i];
+      if (page->dev != dev)
+        {
+          continue;
+        }
+
+      if (page->dirty)
+        {
+          int tmp = blockcache_writeback(page);
+          if (tmp < 0)
+            {
+              ret = tmp;
+            }
+        }
+
+      if (invalidate)
+        {
+          blockcache_release(page);
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blockcache_open
+ ****************************************************************************/
+
+static int blockcache_open(FAR struct inode *inode)
+{
+  FAR struct blockcache_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+  int ret = OK;
+
+  if (parent->u.i_bops->open)
+    {
+      ret = parent->u.i_bops->open(parent);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blockcache_close
+ ****************************************************************************/
+
+static int blockcache_close(FAR struct inode *inode)
+{
+  FAR struct blockcache_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+  int ret;
+
+  ret = nxmutex_lock(&g_blockcache_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  blockcache_flush(dev, false);
+  nxmutex_unlock(&g_blockcache_lock);
+
+  if (parent->u.i_bops->close)
+    {
+      ret = parent->u.i_bops->close(parent);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blockcache_read
+ *
+ * Description:
+ *   Copy the cached sectors and read each run of missing sectors from the
+ *   parent with one request, straight into the user buffer.
+ *
+ ****************************************************************************/
+
+static ssize_t blockcache_read(FAR struct inode *inode,
+                               FAR unsigned char *buffer,
+                               blkcnt_t start_sector, unsigned int nsectors)
+{
+  FAR struct blockcache_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+  FAR struct blockcache_page_s *page;
+  unsigned int nread = 0;
+  unsigned int nrun;
+  ssize_t ret;
+
+  ret = nxmutex_lock(&g_blockcache_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (nread < nsectors)
+    {
+      page = blockcache_find(dev, start_sector + nread);
+      if (page != NULL)
+        {
+          memcpy(buffer + nread * dev->sectorsize, BLOCKCACHE_DATA(page),
+                 dev->sectorsize);
+          blockcache_touch(page);
+          dev->hits++;
+          nread++;
+          continue;
+        }
+
+      for (nrun = 1; nread + nrun < nsectors; nrun++)
+        {
+          if (blockcache_find(dev, start_sector + nread + nrun) != NULL)
+            {
+              break;
+            }
+        }
+
+      ret = parent->u.i_bops->read(parent,
+                                   buffer + nread * dev->sectorsize,
+                                   start_sector + nread, nrun);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      nrun = ret;
+      dev->misses += nrun;
+
+      if (nrun <= BLOCKCACHE_MAXRUN)
+        {
+          unsigned int i;
+
+          for (i = 0; i < nrun; i++)
+            {
+              blockcache_insert(dev, start_sector + nread + i,
+                                buffer + (nread + i) * dev->sectorsize);
+            }
+        }
+
+      nread += nrun;
+    }
+
+  nxmutex_unlock(&g_blockcache_lock);
+  return nread > 0 ? nread : ret;
+}
+
+/****************************************************************************
+ * Name: blockcache_write
+ ****************************************************************************/
+
+static ssize_t blockcache_write(FAR struct inode *inode,
+                                FAR const unsigned char *buffer,
+                                blkcnt_t start_sector,
+                                unsigned int nsectors)
+{
+  FAR struct blockcache_dev_s *dev = inode->i_private;
+  FAR struct blockcache_page_s *page;
+  FAR const unsigned char *src;
+  unsigned int i;
+  ssize_t ret;
+
+  ret = nxmutex_lock(&g_blockcache_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+#ifdef CONFIG_FS_BLOCKCACHE_WRITEBACK
+  if (nsectors <= BLOCKCACHE_MAXRUN)
+    {
+      /* Keep the data in the cache until it is evicted or flushed */
+
+      for (i = 0; i < nsectors; i++)
+        {
+          src  = buffer + i * dev->sectorsize;
+          page = blockcache_find(dev, start_sector + i);
+          if (page != NULL)
+            {
+              memcpy(BLOCKCACHE_DATA(page), src, dev->sectorsize);
+              blockcache_touch(page);
+            }
+          else
+            {
+              page = blockcache_insert(dev, start_sector + i, src);
+            }
+
+          page->dirty = true;
+        }
+
+      dev->writes += nsectors;
+      nxmutex_unlock(&g_blockcache_lock);
+      return nsectors;
+    }
+#endif
+
+  ret = dev->parent->u.i_bops->write(dev->parent, buffer, start_sector,
+                                     nsectors);
+  if (ret > 0)
+    {
+      /* Keep the cache coherent and small writes in it */
+
+      for (i = 0; i < ret; i++)
+        {
+          src  = buffer + i * dev->sectorsize;
+          page = blockcache_find(dev, start_sector + i);
+          if (page != NULL)
+            {
+              memcpy(BLOCKCACHE_DATA(page), src, dev->sectorsize);
+              page->dirty = false;
+              blockcache_touch(page);
+            }
+          else if (ret <= BLOCKCACHE_MAXRUN)
+            {
+              blockcache_insert(dev, start_sector + i, src);
+            }
+        }
+
+      dev->writes += ret;
+    }
+
+  nxmutex_unlock(&g_blockcache_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blockcache_geometry
+ *
+ * Description:
+ *   Return the geometry of the parent.  The cache of a device whose media
+ *   has changed is dropped.
+ *
+ ****************************************************************************/
+
+static int blockcache_geometry(FAR struct inode *inode,
+                               FAR struct geometry *geometry)
+{
+  FAR struct blockcache_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+  FAR struct blockcache_page_s *page;
+  int ret;
+  int i;
+
+  ret = parent->u.i_bops->geometry(parent, geometry);
+  if (ret >= 0 && (geometry->geo_mediachanged || !geometry->geo_available))
+    {
+      ret = nxmutex_lock(&g_blockcache_lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      for (i = 0; i < BLOCKCACHE_NPAGES && dev->npages > 0; i++)
+        {
+          page = &g_blockcache_pages[i];
+          if (page->dev == dev)
+            {
+              blockcache_release(page);
+            }
+        }
+
+      nxmutex_unlock(&g_blockcache_lock);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blockcache_ioctl
+ ****************************************************************************/
+
+static int blockcache_ioctl(FAR struct inode *inode, int cmd,
+                            unsigned long arg)
+{
+  FAR struct blockcache_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+  int ret;
+
+  if (cmd == BIOC_FLUSH)
+    {
+      ret = nxmutex_lock(&g_blockcache_lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = blockcache_flush(dev, false);
+      nxmutex_unlock(&g_blockcache_lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (parent->u.i_bops->ioctl == NULL)
+    {
+      return cmd == BIOC_FLUSH ? OK : -ENOTTY;
+    }
+
+  ret = parent->u.i_bops->ioctl(parent, cmd, arg);
+  if (cmd == BIOC_FLUSH && ret == -ENOTTY)
+    {
+      ret = OK;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blockcache_unlink
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int blockcache_unlink(FAR struct inode *inode)
+{
+  FAR struct blockcache_dev_s *dev = inode->i_private;
+  FAR struct blockcache_dev_s **pprev;
+
+  nxmutex_lock(&g_blockcache_lock);
+
+  blockcache_flush(dev, true);
+
+  for (pprev = &g_blockcache_devs; *pprev != dev;
+       pprev = &(*pprev)->flink)
+    {
+    }
+
+  *pprev = dev->flink;
+
+  nxmutex_unlock(&g_blockcache_lock);
+
+  inode_release(dev->parent);
+  lib_free(dev->path);
+  kmm_free(dev);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: blockcache_initpool
+ ****************************************************************************/
+
+static int blockcache_initpool(void)
+{
+  int i;
+
+  if (g_blockcache_pages != NULL)
+    {
+      return OK;
+    }
+
+  g_blockcache_data = kmm_malloc(CONFIG_FS_BLOCKCACHE_SIZE);
+  if (g_blockcache_data == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  g_blockcache_pages = kmm_zalloc(BLOCKCACHE_NPAGES *
+                                  sizeof(struct blockcache_page_s));
+  if (g_blockcache_pages == NULL)
+    {
+      kmm_free(g_blockcache_data);
+      g_blockcache_data = NULL;
+      return -ENOMEM;
+    }
+
+  dq_init(&g_blockcache_lru);
+  for (i = 0; i < BLOCKCACHE_NPAGES; i++)
+    {
+      dq_addlast(&g_blockcache_pages[i].lru, &g_blockcache_lru);
+    }
+
+  return OK;
+}
+
+#if !defined(CONFIG_FS_PROCFS_EXCLUDE_BLOCKCACHE) && defined(CONFIG_FS_PROCFS)
+
+/****************************************************************************
+ * Name: blockcache_procfs_open
+ ****************************************************************************/
+
+static int blockcache_procfs_open(FAR struct file *filep,
+                                  FAR const char *relpath,
+                                  int oflags, mode_t mode)
+{
+  FAR struct blockcache_file_s *procfile;
+
+  /* PROCFS is read-only */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  procfile = kmm_zalloc(sizeof(struct blockcache_file_s));
+  if (procfile == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  filep->f_priv = procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: blockcache_procfs_close
+ ****************************************************************************/
+
+static int blockcache_procfs_close(FAR struct file *filep)
+{
+  kmm_free(filep->f_priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: blockcache_procfs_read
+ *
+ * Description:
+ *   One line with the size of the pool, then one line per cached device.
+ *
+ ****************************************************************************/
+
+static ssize_t blockcache_procfs_read(FAR struct file *filep,
+                                      FAR char *buffer, size_t buflen)
+{
+  FAR struct blockcache_file_s *procfile = filep->f_priv;
+  FAR struct blockcache_dev_s *dev;
+  size_t totalsize = 0;
+  size_t linesize;
+  size_t copysize;
+  off_t offset = filep->f_pos;
+  int ret;
+
+  DEBUGASSERT(procfile != NULL);
+
+  ret = nxmutex_lock(&g_blockcache_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  linesize  = procfs_snprintf(procfile->line, BLOCKCACHE_LINELEN,
+                              "Pages: %d of %d bytes\n"
+                              "%-16s%8s%10s%10s%10s%10s\n",
+                              BLOCKCACHE_NPAGES,
+                              CONFIG_FS_BLOCKCACHE_SECTORSIZE,
+                              "DEVICE", "PAGES", "HITS", "MISSES",
+                              "WRITES", "WBACKS");
+  copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                            &offset);
+  totalsize = copysize;
+
+  for (dev = g_blockcache_devs; dev != NULL && totalsize < buflen;
+       dev = dev->flink)
+    {
+      linesize   = procfs_snprintf(procfile->line, BLOCKCACHE_LINELEN,
+                                   "%-16s%8" PRIu32 "%10" PRIu32
+                                   "%10" PRIu32 "%10" PRIu32
+                                   "%10" PRIu32 "\n",
+                                   dev->path, dev->npages, dev->hits,
+                                   dev->misses, dev->writes,
+                                   dev->writebacks);
+      copysize   = procfs_memcpy(procfile->line, linesize,
+                                 buffer + totalsize, buflen - totalsize,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  nxmutex_unlock(&g_blockcache_lock);
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: blockcache_procfs_dup
+ ****************************************************************************/
+
+static int blockcache_procfs_dup(FAR const struct file *oldp,
+                                 FAR struct file *newp)
+{
+  FAR struct blockcache_file_s *newattr;
+
+  newattr = kmm_malloc(sizeof(struct blockcache_file_s));
+  if (newattr == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(newattr, oldp->f_priv, sizeof(struct blockcache_file_s));
+  newp->f_priv = newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: blockcache_procfs_stat
+ ****************************************************************************/
+
+static int blockcache_procfs_stat(FAR const char *relpath,
+                                  FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_FS_PROCFS_EXCLUDE_BLOCKCACHE && CONFIG_FS_PROCFS */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: register_blockcache
+ *
+ * Description:
+ *   Register a block driver that caches the sectors of another block driver
+ *   in the shared page pool.
+ *
+ ****************************************************************************/
+
+int register_blockcache(FAR const char *path, mode_t mode,
+                        FAR const char *parent)
+{
+  FAR struct blockcache_dev_s *dev;
+  FAR struct inode *inode;
+  struct geometry geo;
+  int ret;
+
+  ret = find_blockdriver(parent,
+                         (mode & (S_IWOTH | S_IWGRP | S_IWUSR)) ?
+                         0 : MS_RDONLY, &inode);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = inode->u.i_bops->geometry(inode, &geo);
+  if (ret < 0)
+    {
+      goto errout_release;
+    }
+
+  if (geo.geo_sectorsize == 0 ||
+      geo.geo_sectorsize > CONFIG_FS_BLOCKCACHE_SECTORSIZE)
+    {
+      ferr("ERROR: Sector size %zu not supported\n",
+           (size_t)geo.geo_sectorsize);
+      ret = -EINVAL;
+      goto errout_release;
+    }
+
+  dev = kmm_zalloc(sizeof(struct blockcache_dev_s));
+  if (dev == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_release;
+    }
+
+  dev->parent     = inode;
+  dev->sectorsize = geo.geo_sectorsize;
+  dev->path       = strdup(path);
+  if (dev->path == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_free;
+    }
+
+  ret = nxmutex_lock(&g_blockcache_lock);
+  if (ret < 0)
+    {
+      goto errout_free;
+    }
+
+  ret = blockcache_initpool();
+  if (ret >= 0)
+    {
+      ret = register_blockdriver(path, &g_blockcache_bops, mode, dev);
+    }
+
+  if (ret >= 0)
+    {
+      dev->flink        = g_blockcache_devs;
+      g_blockcache_devs = dev;
+    }
+
+  nxmutex_unlock(&g_blockcache_lock);
+  if (ret < 0)
+    {
+      goto errout_free;
+    }
+
+  return OK;
+
+errout_free:
+  lib_free(dev->path);
+  kmm_free(dev);
+
+errout_release:
+  inode_release(inode);
+  return ret;
+}
+
+#endif /* CONFIG_FS_BLOCKCACHE */
@@ -0,0 +1,243 @@
+/****************************************************************************
+ * fs/driver/fs_blockqueue.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+
+#ifdef CONFIG_FS_BLOCK_ASYNC
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blk_queue_thread
+ *
+ * Description:
+ *   Run the requests of one queue until it is stopped and empty.
+ *
+ ****************************************************************************/
+
+static int blk_queue_thread(int argc, FAR char *argv[])
+{
+  FAR const struct block_operations *bops;
+  FAR struct blk_request_s *req;
+  FAR struct blk_queue_s *queue;
+  FAR struct inode *inode;
+  ssize_t result;
+
+  queue = (FAR struct blk_queue_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
+  inode = queue->inode;
+  bops  = inode->u.i_bops;
+
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&queue->sem);
+
+      nxmutex_lock(&queue->lock);
+      req = queue->head;
+      if (req != NULL)
+        {
+          queue->head = req->flink;
+          if (queue->head == NULL)
+            {
+              queue->tail = NULL;
+            }
+        }
+      else if (queue->stop)
+        {
+          nxmutex_unlock(&queue->lock);
+          break;
+        }
+
+      nxmutex_unlock(&queue->lock);
+
+      if (req == NULL)
+        {
+          continue;
+        }
+
+      if (req->write)
+        {
+          result = bops->write(inode, req->buffer, req->start_sector,
+                               req->nsectors);
+        }
+      else
+        {
+          result = bops->read(inode, req->buffer, req->start_sector,
+                              req->nsectors);
+        }
+
+      if (result < 0)
+        {
+          ferr("ERROR: %s of sector %" PRIuOFF " failed: %zd\n",
+               req->write ? "write" : "read",
+               (off_t)req->start_sector, result);
+        }
+
+      /* The request may be freed by its owner from here on */
+
+      req->complete(req, result);
+    }
+
+  nxsem_post(&queue->exitsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blk_queue_initialize
+ *
+ * Description:
+ *   Initialize a request queue.  The thread is created by the first
+ *   request.
+ *
+ ****************************************************************************/
+
+void blk_queue_initialize(FAR struct blk_queue_s *queue)
+{
+  memset(queue, 0, sizeof(*queue));
+  nxmutex_init(&queue->lock);
+  nxsem_init(&queue->sem, 0, 0);
+  nxsem_init(&queue->exitsem, 0, 0);
+}
+
+/****************************************************************************
+ * Name: blk_queue_submit
+ *
+ * Description:
+ *   Queue a request to be run by the thread of the queue.
+ *
+ ****************************************************************************/
+
+int blk_queue_submit(FAR struct blk_queue_s *queue, FAR struct inode *inode,
+                     FAR struct blk_request_s *req)
+{
+  FAR char *argv[2];
+  char arg1[32];
+  int ret;
+
+  DEBUGASSERT(queue != NULL && inode != NULL && req != NULL &&
+              req->complete != NULL);
+
+  ret = nxmutex_lock(&queue->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (queue->stop)
+    {
+      ret = -ENODEV;
+      goto errout_with_lock;
+    }
+
+  if (queue->pid <= 0)
+    {
+      queue->inode = inode;
+
+      snprintf(arg1, sizeof(arg1), "%p", queue);
+      argv[0] = arg1;
+      argv[1] = NULL;
+
+      ret = kthread_create("blkq", CONFIG_FS_BLOCK_ASYNC_PRIORITY,
+                           CONFIG_FS_BLOCK_ASYNC_STACKSIZE,
+                           blk_queue_thread, argv);
+      if (ret < 0)
+        {
+          ferr("ERROR: Failed to start the queue thread: %d\n", ret);
+          goto errout_with_lock;
+        }
+
+      queue->pid = ret;
+    }
+
+  DEBUGASSERT(queue->inode == inode);
+
+  req->flink = NULL;
+  if (queue->tail != NULL)
+    {
+      queue->tail->flink = req;
+    }
+  else
+    {
+      queue->head = req;
+    }
+
+  queue->tail = req;
+  nxmutex_unlock(&queue->lock);
+
+  nxsem_post(&queue->sem);
+  return OK;
+
+errout_with_lock:
+  nxmutex_unlock(&queue->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blk_queue_uninitialize
+ *
+ * Description:
+ *   Let the thread finish the queued requests and exit, then release the
+ *   queue.
+ *
+ ****************************************************************************/
+
+void blk_queue_uninitialize(FAR struct blk_queue_s *queue)
+{
+  pid_t pid;
+
+  nxmutex_lock(&queue->lock);
+  queue->stop = true;
+  pid         = queue->pid;
+  nxmutex_unlock(&queue->lock);
+
+  if (pid > 0)
+    {
+      nxsem_post(&queue->sem);
+      nxsem_wait_uninterruptible(&queue->exitsem);
+    }
+
+  nxsem_destroy(&queue->exitsem);
+  nxsem_destroy(&queue->sem);
+  nxmutex_destroy(&queue->lock);
+}
+
+#endif /* CONFIG_FS_BLOCK_ASYNC */
@@ -729,6 +729,7 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
 
 #ifndef CONFIG_FAT_FORCE_INDIRECT
   unsigned int nsectors;
+  int32_t ncontig;
   bool force_indirect = false;
 #endif
 
@@ -864,13 +865,24 @@ fat_write_restart:
            * buffer without using our tiny read buffer.
            *
            * Limit the number of sectors that we write on this time
-           * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * through the loop to the remaining sectors in this cluster and
+           * in the whole clusters that follow it on the volume.
            */
 
+          ncontig = 0;
           if (nsectors > ff->ff_sectorsincluster)
             {
-              nsectors = ff->ff_sectorsincluster;
+              ncontig = fat_contiguous(fs, ff->ff_currentcluster,
+                                       (nsectors - ff->ff_sectorsincluster) /
+                                       fs->fs_fatsecperclus);
+              if (ncontig < 0)
+                {
+                  ret = ncontig;
+                  goto errout_with_lock;
+                }
+
+              nsectors = ff->ff_sectorsincluster +
+                         ncontig * fs->fs_fatsecperclus;
             }
 
           /* We are not sure of the state of the sector cache so the
@@ -906,7 +918,18 @@ fat_write_restart:
               goto errout_with_lock;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
+          if (ncontig > 0)
+            {
+              /* The write ended on the boundary of the last cluster */
+
+              ff->ff_currentcluster  += ncontig;
+              ff->ff_sectorsincluster = 0;
+            }
+          else
+            {
+              ff->ff_sectorsincluster -= nsectors;
+            }
+
           ff->ff_currentsector    += nsectors;
           writesize                = nsectors * fs->fs_hwsectorsize;
           ff->ff_bflags           |= FFBUFF_MODIFIED;
@@ -2270,6 +2293,20 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
         }
     }
 
+#ifdef CONFIG_FAT_FREEMAP
+  /* Stop the scan of the FAT */
+
+  fat_freemap_uninitialize(fs);
+#endif
+
+#ifdef CONFIG_FAT_SECTORCACHE
+  /* Write back and release the sector cache while the block driver is
+   * still open.
+   */
+
+  fat_cache_uninitialize(fs);
+#endif
+
   /* Unmount ... close the block driver */
 
   if (fs->fs_blkdriver)
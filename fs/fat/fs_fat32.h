@@ -853,6 +853,18 @@
  * Public Types
  ****************************************************************************/
 
+/* The sector cache of a mountpoint, see fs_fat32cache.c */
+
+#ifdef CONFIG_FAT_SECTORCACHE
+struct fat_cache_s;
+#endif
+
+/* The free cluster map of a mountpoint, see fs_fat32freemap.c */
+
+#ifdef CONFIG_FAT_FREEMAP
+struct fat_freemap_s;
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of
  * this structure is retained as inode private data on each mountpoint that
  * is mounted with a fat32 filesystem.
@@ -887,6 +899,12 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one
                                     * sector from the device */
+#ifdef CONFIG_FAT_SECTORCACHE
+  FAR struct fat_cache_s *fs_cache; /* Sector cache, NULL if not available */
+#endif
+#ifdef CONFIG_FAT_FREEMAP
+  FAR struct fat_freemap_s *fs_freemap; /* Free cluster map, or NULL */
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -1034,6 +1052,36 @@ EXTERN int    fat_hwread(FAR struct fat_mountpt_s *fs, FAR uint8_t *buffer,
                          off_t sector, unsigned int nsectors);
 EXTERN int    fat_hwwrite(FAR struct fat_mountpt_s *fs, FAR uint8_t *buffer,
                           off_t sector, unsigned int nsectors);
+EXTERN int    fat_blkread(FAR struct fat_mountpt_s *fs, FAR uint8_t *buffer,
+                          off_t sector, unsigned int nsectors);
+EXTERN int    fat_blkwrite(FAR struct fat_mountpt_s *fs, FAR uint8_t *buffer,
+                           off_t sector, unsigned int nsectors);
+
+/* Sector cache between fat_hwread()/fat_hwwrite() and the block driver */
+
+#ifdef CONFIG_FAT_SECTORCACHE
+EXTERN int    fat_cache_initialize(FAR struct fat_mountpt_s *fs);
+EXTERN int    fat_cache_uninitialize(FAR struct fat_mountpt_s *fs);
+EXTERN int    fat_cache_flush(FAR struct fat_mountpt_s *fs);
+EXTERN int    fat_cache_read(FAR struct fat_mountpt_s *fs,
+                             FAR uint8_t *buffer, off_t sector,
+                             unsigned int nsectors);
+EXTERN int    fat_cache_write(FAR struct fat_mountpt_s *fs,
+                              FAR uint8_t *buffer, off_t sector,
+                              unsigned int nsectors);
+#endif
+
+/* Free cluster map built in the background after mount */
+
+#ifdef CONFIG_FAT_FREEMAP
+EXTERN int    fat_freemap_initialize(FAR struct fat_mountpt_s *fs);
+EXTERN void   fat_freemap_uninitialize(FAR struct fat_mountpt_s *fs);
+EXTERN int    fat_freemap_finish(FAR struct fat_mountpt_s *fs);
+EXTERN void   fat_freemap_update(FAR struct fat_mountpt_s *fs,
+                                 uint32_t cluster, bool isfree);
+EXTERN uint32_t fat_freemap_skip(FAR struct fat_mountpt_s *fs,
+                                 uint32_t cluster);
+#endif
 
 /* Cluster / cluster chain access helpers */
 
@@ -1047,6 +1095,8 @@ EXTERN int    fat_removechain(FAR struct fat_mountpt_s *fs,
                               uint32_t cluster);
 EXTERN int32_t fat_extendchain(FAR struct fat_mountpt_s *fs,
                                uint32_t cluster);
+EXTERN int32_t fat_contiguous(FAR struct fat_mountpt_s *fs,
+                              uint32_t cluster, uint32_t nclusters);
 
 #define fat_createchain(fs) fat_extendchain(fs, 0)
 
@@ -0,0 +1,745 @@
+/****************************************************************************
+ * fs/fat/fs_fat32cache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+
+#include "fs_fat32.h"
+
+#ifdef CONFIG_FAT_SECTORCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FAT_CACHE_NWINDOW   CONFIG_FAT_SECTORCACHE_DATA
+
+/* A mask of the 'n' low bits of a window bitmap */
+
+#define FAT_CACHE_MASK(n)   ((n) >= 32 ? UINT32_MAX : ((1u << (n)) - 1))
+
+/* The parts of the cache.  Sectors that are not cached at all are the
+ * reserved sectors, which are only accessed at mount and for the FSINFO
+ * update, and the copies of the FAT, which are only ever written.
+ */
+
+#define FAT_CACHE_FAT       0
+#define FAT_CACHE_DIR       1
+#define FAT_CACHE_DATA      2
+#define FAT_CACHE_BYPASS    3
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One separately cached sector of the FAT or directory part */
+
+struct fat_cacheway_s
+{
+  FAR uint8_t *cw_buffer;       /* The sector data */
+  off_t        cw_sector;       /* The sector held, or -1 */
+  uint32_t     cw_stamp;        /* Time of the last use, for LRU */
+  bool         cw_dirty;        /* Must be written back */
+};
+
+struct fat_cache_s
+{
+  struct fat_cacheway_s fc_fat[CONFIG_FAT_SECTORCACHE_FAT];
+  struct fat_cacheway_s fc_dir[CONFIG_FAT_SECTORCACHE_DIR];
+  uint32_t     fc_stamp;        /* Incremented on each use of a way */
+
+  /* The data part is a window of consecutive sectors, so that a run of
+   * them is read or written with one request.
+   */
+
+  FAR uint8_t *fc_window;       /* FAT_CACHE_NWINDOW sectors */
+  off_t        fc_base;         /* The first sector of the window */
+  off_t        fc_lastread;     /* The last data sector read */
+  uint32_t     fc_valid;        /* One bit per sector that holds data */
+  uint32_t     fc_dirty;        /* One bit per sector to write back */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fat_cache_part
+ *
+ * Description:
+ *   Return the part of the cache for a sector.  In the data area, the
+ *   sectors that go through fs_buffer are directory sectors and all the
+ *   others belong to files.
+ *
+ ****************************************************************************/
+
+static int fat_cache_part(FAR struct fat_mountpt_s *fs,
+                          FAR const uint8_t *buffer, off_t sector)
+{
+  if (sector < fs->fs_fatbase)
+    {
+      return FAT_CACHE_BYPASS;
+    }
+  else if (sector < fs->fs_fatbase + fs->fs_nfatsects)
+    {
+      return FAT_CACHE_FAT;
+    }
+  else if (sector < fs->fs_fatbase +
+                    (off_t)fs->fs_fatnumfats * fs->fs_nfatsects)
+    {
+      return FAT_CACHE_BYPASS;
+    }
+  else if (sector < fs->fs_database || buffer == fs->fs_buffer)
+    {
+      return FAT_CACHE_DIR;
+    }
+
+  return FAT_CACHE_DATA;
+}
+
+/****************************************************************************
+ * Name: fat_cache_ways
+ *
+ * Description:
+ *   Return the ways of the FAT or the directory part.
+ *
+ ****************************************************************************/
+
+static FAR struct fat_cacheway_s *fat_cache_ways(FAR struct fat_cache_s *fc,
+                                                 int part, FAR int *nways)
+{
+  if (part == FAT_CACHE_FAT)
+    {
+      *nways = CONFIG_FAT_SECTORCACHE_FAT;
+      return fc->fc_fat;
+    }
+
+  *nways = CONFIG_FAT_SECTORCACHE_DIR;
+  return fc->fc_dir;
+}
+
+/****************************************************************************
+ * Name: fat_cache_writeway
+ *
+ * Description:
+ *   Write back one way if it is dirty.
+ *
+ ****************************************************************************/
+
+static int fat_cache_writeway(FAR struct fat_mountpt_s *fs,
+                              FAR struct fat_cacheway_s *way)
+{
+  int ret;
+
+  if (!way->cw_dirty)
+    {
+      return OK;
+    }
+
+  ret = fat_blkwrite(fs, way->cw_buffer, way->cw_sector, 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  way->cw_dirty = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_cache_flushwindow
+ *
+ * Description:
+ *   Write back the dirty sectors of the data window, each run of
+ *   consecutive dirty sectors with one request.
+ *
+ ****************************************************************************/
+
+static int fat_cache_flushwindow(FAR struct fat_mountpt_s *fs)
+{
+  FAR struct fat_cache_s *fc = fs->fs_cache;
+  unsigned int first;
+  unsigned int last;
+  int ret;
+
+  for (first = 0; first < FAT_CACHE_NWINDOW && fc->fc_dirty != 0; )
+    {
+      if ((fc->fc_dirty & (1u << first)) == 0)
+        {
+          first++;
+          continue;
+        }
+
+      for (last = first + 1;
+           last < FAT_CACHE_NWINDOW && (fc->fc_dirty & (1u << last)) != 0;
+           last++);
+
+      ret = fat_blkwrite(fs, &fc->fc_window[first * fs->fs_hwsectorsize],
+                         fc->fc_base + first, last - first);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      fc->fc_dirty &= ~(FAT_CACHE_MASK(last - first) << first);
+      first = last;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_cache_movewindow
+ *
+ * Description:
+ *   Make the data window start at 'sector' unless it already covers it.
+ *
+ ****************************************************************************/
+
+static int fat_cache_movewindow(FAR struct fat_mountpt_s *fs, off_t sector)
+{
+  FAR struct fat_cache_s *fc = fs->fs_cache;
+  int ret;
+
+  if (sector >= fc->fc_base && sector < fc->fc_base + FAT_CACHE_NWINDOW)
+    {
+      return OK;
+    }
+
+  ret = fat_cache_flushwindow(fs);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  fc->fc_base  = sector;
+  fc->fc_valid = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_cache_overlay
+ *
+ * Description:
+ *   Copy the dirty sectors that the parts other than 'part' hold in the
+ *   range into 'buffer', which has just been read from the media.  A
+ *   sector that is read through another part than the one that wrote it
+ *   then does not see stale data.
+ *
+ ****************************************************************************/
+
+static void fat_cache_overlay(FAR struct fat_mountpt_s *fs,
+                              FAR uint8_t *buffer, off_t sector,
+                              unsigned int nsectors, int part)
+{
+  FAR struct fat_cache_s *fc = fs->fs_cache;
+  FAR struct fat_cacheway_s *ways;
+  unsigned int ndx;
+  off_t wsector;
+  int nways;
+  int p;
+  int i;
+
+  for (p = FAT_CACHE_FAT; p <= FAT_CACHE_DIR; p++)
+    {
+      if (p == part)
+        {
+          continue;
+        }
+
+      ways = fat_cache_ways(fc, p, &nways);
+      for (i = 0; i < nways; i++)
+        {
+          if (ways[i].cw_dirty && ways[i].cw_sector >= sector &&
+              ways[i].cw_sector < sector + nsectors)
+            {
+              memcpy(&buffer[(ways[i].cw_sector - sector) *
+                             fs->fs_hwsectorsize],
+                     ways[i].cw_buffer, fs->fs_hwsectorsize);
+            }
+        }
+    }
+
+  if (part != FAT_CACHE_DATA)
+    {
+      for (ndx = 0; ndx < FAT_CACHE_NWINDOW && fc->fc_dirty != 0; ndx++)
+        {
+          wsector = fc->fc_base + ndx;
+          if ((fc->fc_dirty & (1u << ndx)) != 0 && wsector >= sector &&
+              wsector < sector + nsectors)
+            {
+              memcpy(&buffer[(wsector - sector) * fs->fs_hwsectorsize],
+                     &fc->fc_window[ndx * fs->fs_hwsectorsize],
+                     fs->fs_hwsectorsize);
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: fat_cache_discard
+ *
+ * Description:
+ *   Forget the sectors in the range that the parts other than 'part' hold,
+ *   because they are being overwritten.
+ *
+ ****************************************************************************/
+
+static void fat_cache_discard(FAR struct fat_mountpt_s *fs, off_t sector,
+                              unsigned int nsectors, int part)
+{
+  FAR struct fat_cache_s *fc = fs->fs_cache;
+  FAR struct fat_cacheway_s *ways;
+  unsigned int ndx;
+  off_t wsector;
+  int nways;
+  int p;
+  int i;
+
+  for (p = FAT_CACHE_FAT; p <= FAT_CACHE_DIR; p++)
+    {
+      if (p == part)
+        {
+          continue;
+        }
+
+      ways = fat_cache_ways(fc, p, &nways);
+      for (i = 0; i < nways; i++)
+        {
+          if (ways[i].cw_sector >= sector &&
+              ways[i].cw_sector < sector + nsectors)
+            {
+              ways[i].cw_sector = -1;
+              ways[i].cw_dirty  = false;
+            }
+        }
+    }
+
+  if (part != FAT_CACHE_DATA)
+    {
+      for (ndx = 0; ndx < FAT_CACHE_NWINDOW && fc->fc_valid != 0; ndx++)
+        {
+          wsector = fc->fc_base + ndx;
+          if (wsector >= sector && wsector < sector + nsectors)
+            {
+              fc->fc_valid &= ~(1u << ndx);
+              fc->fc_dirty &= ~(1u << ndx);
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: fat_cache_getway
+ *
+ * Description:
+ *   Return the way that holds 'sector' in the FAT or directory part.  If
+ *   there is none, the least recently used way is written back and given
+ *   to the sector and, if 'fill' is set, the sector is read into it.
+ *
+ ****************************************************************************/
+
+static int fat_cache_getway(FAR struct fat_mountpt_s *fs, int part,
+                            off_t sector, bool fill,
+                            FAR struct fat_cacheway_s **result)
+{
+  FAR struct fat_cache_s *fc = fs->fs_cache;
+  FAR struct fat_cacheway_s *ways;
+  FAR struct fat_cacheway_s *way = NULL;
+  int nways;
+  int ret;
+  int i;
+
+  ways = fat_cache_ways(fc, part, &nways);
+  for (i = 0; i < nways; i++)
+    {
+      if (ways[i].cw_sector == sector)
+        {
+          way = &ways[i];
+          goto found;
+        }
+
+      if (way == NULL || ways[i].cw_sector < 0 ||
+          (way->cw_sector >= 0 &&
+           (int32_t)(ways[i].cw_stamp - way->cw_stamp) < 0))
+        {
+          way = &ways[i];
+        }
+    }
+
+  /* Replace the least recently used (or an unused) way */
+
+  ret = fat_cache_writeway(fs, way);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  way->cw_sector = -1;
+  if (fill)
+    {
+      ret = fat_blkread(fs, way->cw_buffer, sector, 1);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      fat_cache_overlay(fs, way->cw_buffer, sector, 1, part);
+    }
+
+  way->cw_sector = sector;
+
+found:
+  way->cw_stamp = ++fc->fc_stamp;
+  *result = way;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_cache_readwindow
+ *
+ * Description:
+ *   Read one data sector through the window.  A miss right after the
+ *   previous sector read is taken as a sequential read; the sectors that
+ *   follow in the window are then read ahead with the same request.
+ *
+ ****************************************************************************/
+
+static int fat_cache_readwindow(FAR struct fat_mountpt_s *fs,
+                                FAR uint8_t *buffer, off_t sector)
+{
+  FAR struct fat_cache_s *fc = fs->fs_cache;
+  unsigned int ndx;
+  unsigned int n;
+  int ret;
+
+  ret = fat_cache_movewindow(fs, sector);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ndx = sector - fc->fc_base;
+  if ((fc->fc_valid & (1u << ndx)) == 0)
+    {
+      n = 1;
+      if (sector == fc->fc_lastread + 1)
+        {
+          while (ndx + n < FAT_CACHE_NWINDOW &&
+                 (fc->fc_valid & (1u << (ndx + n))) == 0 &&
+                 sector + n < fs->fs_hwnsectors)
+            {
+              n++;
+            }
+        }
+
+      ret = fat_blkread(fs, &fc->fc_window[ndx * fs->fs_hwsectorsize],
+                        sector, n);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      fat_cache_overlay(fs, &fc->fc_window[ndx * fs->fs_hwsectorsize],
+                        sector, n, FAT_CACHE_DATA);
+      fc->fc_valid |= FAT_CACHE_MASK(n) << ndx;
+    }
+
+  memcpy(buffer, &fc->fc_window[ndx * fs->fs_hwsectorsize],
+         fs->fs_hwsectorsize);
+  fc->fc_lastread = sector;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_cache_writewindow
+ *
+ * Description:
+ *   Write one data sector into the window.  It reaches the media with the
+ *   sectors next to it when the window moves or is flushed.
+ *
+ ****************************************************************************/
+
+static int fat_cache_writewindow(FAR struct fat_mountpt_s *fs,
+                                 FAR const uint8_t *buffer, off_t sector)
+{
+  FAR struct fat_cache_s *fc = fs->fs_cache;
+  unsigned int ndx;
+  int ret;
+
+  ret = fat_cache_movewindow(fs, sector);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ndx = sector - fc->fc_base;
+  memcpy(&fc->fc_window[ndx * fs->fs_hwsectorsize], buffer,
+         fs->fs_hwsectorsize);
+  fc->fc_valid |= 1u << ndx;
+  fc->fc_dirty |= 1u << ndx;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_cache_free
+ *
+ * Description:
+ *   Release the memory of the cache.
+ *
+ ****************************************************************************/
+
+static void fat_cache_free(FAR struct fat_mountpt_s *fs)
+{
+  FAR struct fat_cache_s *fc = fs->fs_cache;
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_SECTORCACHE_FAT; i++)
+    {
+      if (fc->fc_fat[i].cw_buffer)
+        {
+          fat_io_free(fc->fc_fat[i].cw_buffer, fs->fs_hwsectorsize);
+        }
+    }
+
+  for (i = 0; i < CONFIG_FAT_SECTORCACHE_DIR; i++)
+    {
+      if (fc->fc_dir[i].cw_buffer)
+        {
+          fat_io_free(fc->fc_dir[i].cw_buffer, fs->fs_hwsectorsize);
+        }
+    }
+
+  if (fc->fc_window)
+    {
+      fat_io_free(fc->fc_window, FAT_CACHE_NWINDOW * fs->fs_hwsectorsize);
+    }
+
+  kmm_free(fc);
+  fs->fs_cache = NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fat_cache_initialize
+ *
+ * Description:
+ *   Allocate the sector cache of a mountpoint.  Called once the layout of
+ *   the volume is known.
+ *
+ ****************************************************************************/
+
+int fat_cache_initialize(FAR struct fat_mountpt_s *fs)
+{
+  FAR struct fat_cache_s *fc;
+  bool nomem = false;
+  int i;
+
+  fc = kmm_zalloc(sizeof(struct fat_cache_s));
+  if (fc == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  fs->fs_cache = fc;
+
+  for (i = 0; i < CONFIG_FAT_SECTORCACHE_FAT; i++)
+    {
+      fc->fc_fat[i].cw_sector = -1;
+      fc->fc_fat[i].cw_buffer = fat_io_alloc(fs->fs_hwsectorsize);
+      nomem |= fc->fc_fat[i].cw_buffer == NULL;
+    }
+
+  for (i = 0; i < CONFIG_FAT_SECTORCACHE_DIR; i++)
+    {
+      fc->fc_dir[i].cw_sector = -1;
+      fc->fc_dir[i].cw_buffer = fat_io_alloc(fs->fs_hwsectorsize);
+      nomem |= fc->fc_dir[i].cw_buffer == NULL;
+    }
+
+  fc->fc_window   = fat_io_alloc(FAT_CACHE_NWINDOW * fs->fs_hwsectorsize);
+  fc->fc_lastread = -2;
+  nomem |= fc->fc_window == NULL;
+
+  if (nomem)
+    {
+      fat_cache_free(fs);
+      return -ENOMEM;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_cache_uninitialize
+ *
+ * Description:
+ *   Write back and release the sector cache of a mountpoint, if it has one.
+ *
+ ****************************************************************************/
+
+int fat_cache_uninitialize(FAR struct fat_mountpt_s *fs)
+{
+  int ret;
+
+  if (fs->fs_cache == NULL)
+    {
+      return OK;
+    }
+
+  ret = fat_cache_flush(fs);
+  fat_cache_free(fs);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fat_cache_flush
+ *
+ * Description:
+ *   Write back all dirty sectors:  the file data first, then the FAT and
+ *   last the directory entries that point to them.
+ *
+ ****************************************************************************/
+
+int fat_cache_flush(FAR struct fat_mountpt_s *fs)
+{
+  FAR struct fat_cache_s *fc = fs->fs_cache;
+  int ret;
+  int i;
+
+  ret = fat_cache_flushwindow(fs);
+
+  for (i = 0; ret >= 0 && i < CONFIG_FAT_SECTORCACHE_FAT; i++)
+    {
+      ret = fat_cache_writeway(fs, &fc->fc_fat[i]);
+    }
+
+  for (i = 0; ret >= 0 && i < CONFIG_FAT_SECTORCACHE_DIR; i++)
+    {
+      ret = fat_cache_writeway(fs, &fc->fc_dir[i]);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fat_cache_read
+ *
+ * Description:
+ *   Read sectors through the cache.  Multi-sector reads go to the media
+ *   directly; only the dirty cached sectors are copied over them.
+ *
+ ****************************************************************************/
+
+int fat_cache_read(FAR struct fat_mountpt_s *fs, FAR uint8_t *buffer,
+                   off_t sector, unsigned int nsectors)
+{
+  FAR struct fat_cacheway_s *way;
+  int part;
+  int ret;
+
+  part = nsectors == 1 ? fat_cache_part(fs, buffer, sector) :
+                         FAT_CACHE_BYPASS;
+
+  if (part == FAT_CACHE_DATA)
+    {
+      return fat_cache_readwindow(fs, buffer, sector);
+    }
+  else if (part != FAT_CACHE_BYPASS)
+    {
+      ret = fat_cache_getway(fs, part, sector, true, &way);
+      if (ret >= 0)
+        {
+          memcpy(buffer, way->cw_buffer, fs->fs_hwsectorsize);
+        }
+
+      return ret;
+    }
+
+  ret = fat_blkread(fs, buffer, sector, nsectors);
+  if (ret >= 0)
+    {
+      fat_cache_overlay(fs, buffer, sector, nsectors, FAT_CACHE_BYPASS);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fat_cache_write
+ *
+ * Description:
+ *   Write sectors through the cache.  Single sectors are kept until they
+ *   are evicted or flushed; multi-sector writes go to the media directly
+ *   and replace what the cache holds for them.
+ *
+ ****************************************************************************/
+
+int fat_cache_write(FAR struct fat_mountpt_s *fs, FAR uint8_t *buffer,
+                    off_t sector, unsigned int nsectors)
+{
+  FAR struct fat_cacheway_s *way;
+  int part;
+  int ret;
+
+  part = nsectors == 1 ? fat_cache_part(fs, buffer, sector) :
+                         FAT_CACHE_BYPASS;
+
+  /* The other parts must not write back an older copy later */
+
+  fat_cache_discard(fs, sector, nsectors, part);
+
+  if (part == FAT_CACHE_DATA)
+    {
+      return fat_cache_writewindow(fs, buffer, sector);
+    }
+  else if (part != FAT_CACHE_BYPASS)
+    {
+      ret = fat_cache_getway(fs, part, sector, false, &way);
+      if (ret >= 0)
+        {
+          memcpy(way->cw_buffer, buffer, fs->fs_hwsectorsize);
+          way->cw_dirty = true;
+        }
+
+      return ret;
+    }
+
+  return fat_blkwrite(fs, buffer, sector, nsectors);
+}
+
+#endif /* CONFIG_FAT_SECTORCACHE */
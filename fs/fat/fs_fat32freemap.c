@@ -0,0 +1,406 @@
+/****************************************************************************
+ * fs/fat/fs_fat32freemap.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
+
+#include "fs_fat32.h"
+
+#ifdef CONFIG_FAT_FREEMAP
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The bits of fm_map tell which FAT sectors may hold free clusters.  They
+ * all start set; the scan clears the bits of the full sectors and freeing
+ * a cluster sets the bit of its sector again.  So a clear bit means that
+ * the sector is full, while a set bit is only a hint.
+ */
+
+struct fat_freemap_s
+{
+  struct work_s fm_work;       /* Runs the scan */
+  sem_t    fm_stopped;         /* Posted by the scan when it sees fm_stop */
+  uint32_t fm_nsectors;        /* FAT sectors that hold cluster entries */
+  uint32_t fm_next;            /* The next FAT sector to scan */
+  uint32_t fm_nfree;           /* Free clusters in the scanned sectors */
+  uint16_t fm_persector;       /* Cluster entries per FAT sector */
+  bool     fm_queued;          /* The scan is queued or about to run */
+  bool     fm_stop;            /* The volume is being unmounted */
+  uint8_t  fm_map[1];          /* One bit per FAT sector */
+};
+
+#define SIZEOF_FAT_FREEMAP_S(n) \
+  (sizeof(struct fat_freemap_s) + ((n) + 7) / 8 - 1)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void fat_freemap_worker(FAR void *arg);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fat_freemap_scansector
+ *
+ * Description:
+ *   Count the free clusters in the next FAT sector and update its bit.
+ *   Called with the volume locked.
+ *
+ ****************************************************************************/
+
+static int fat_freemap_scansector(FAR struct fat_mountpt_s *fs)
+{
+  FAR struct fat_freemap_s *fm = fs->fs_freemap;
+  uint32_t cluster;
+  uint32_t last;
+  uint32_t nfree = 0;
+  unsigned int offset;
+  int ret;
+
+  ret = fat_fscacheread(fs, fs->fs_fatbase + fm->fm_next);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Examine the entries of the sector that are data clusters */
+
+  cluster = fm->fm_next * fm->fm_persector;
+  last    = cluster + fm->fm_persector;
+  if (last > fs->fs_nclusters)
+    {
+      last = fs->fs_nclusters;
+    }
+
+  if (cluster < 2)
+    {
+      cluster = 2;
+    }
+
+  for (; cluster < last; cluster++)
+    {
+      offset = cluster % fm->fm_persector;
+      if (fs->fs_type == FSTYPE_FAT16)
+        {
+          nfree += FAT_GETFAT16(fs->fs_buffer, offset * 2) == 0;
+        }
+      else
+        {
+          nfree += FAT_GETFAT32(fs->fs_buffer, offset * 4) == 0;
+        }
+    }
+
+  if (nfree == 0)
+    {
+      fm->fm_map[fm->fm_next >> 3] &= ~(1 << (fm->fm_next & 7));
+    }
+
+  fm->fm_nfree += nfree;
+  fm->fm_next++;
+
+  /* Once the whole FAT has been scanned, the count is exact and it is the
+   * one that is kept up to date from now on.
+   */
+
+  if (fm->fm_next >= fm->fm_nsectors)
+    {
+      fs->fs_fsifreecount = fm->fm_nfree;
+      if (fs->fs_type == FSTYPE_FAT32)
+        {
+          fs->fs_fsidirty = true;
+        }
+
+      finfo("%" PRIu32 " free clusters\n", fm->fm_nfree);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_freemap_worker
+ *
+ * Description:
+ *   Scan a few FAT sectors and queue the next step.
+ *
+ ****************************************************************************/
+
+static void fat_freemap_worker(FAR void *arg)
+{
+  FAR struct fat_mountpt_s *fs = arg;
+  FAR struct fat_freemap_s *fm = fs->fs_freemap;
+  int ret;
+  int i;
+
+  ret = nxmutex_lock(&fs->fs_lock);
+  if (ret < 0)
+    {
+      work_queue(LPWORK, &fm->fm_work, fat_freemap_worker, fs, 1);
+      return;
+    }
+
+  fm->fm_queued = false;
+  if (fm->fm_stop)
+    {
+      nxmutex_unlock(&fs->fs_lock);
+      nxsem_post(&fm->fm_stopped);
+      return;
+    }
+
+  for (i = 0; i < CONFIG_FAT_FREEMAP_BATCH &&
+              fm->fm_next < fm->fm_nsectors; i++)
+    {
+      ret = fat_freemap_scansector(fs);
+      if (ret < 0)
+        {
+          /* Leave the rest to fat_freemap_finish() */
+
+          ferr("ERROR: FAT scan failed: %d\n", ret);
+          break;
+        }
+    }
+
+  if (ret >= 0 && fm->fm_next < fm->fm_nsectors)
+    {
+      fm->fm_queued = true;
+      work_queue(LPWORK, &fm->fm_work, fat_freemap_worker, fs, 0);
+    }
+
+  nxmutex_unlock(&fs->fs_lock);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fat_freemap_initialize
+ *
+ * Description:
+ *   Allocate the free cluster map of a mounted volume and start scanning
+ *   the FAT in the background.  Called with the volume locked.
+ *
+ * Returned Value:
+ *   Zero (OK) if the scan was started; -ENOSYS for FAT12 volumes or
+ *   -ENOMEM.  The free clusters are then counted the usual way.
+ *
+ ****************************************************************************/
+
+int fat_freemap_initialize(FAR struct fat_mountpt_s *fs)
+{
+  FAR struct fat_freemap_s *fm;
+  uint32_t nsectors;
+  uint16_t persector;
+
+  if (fs->fs_type == FSTYPE_FAT12)
+    {
+      return -ENOSYS;
+    }
+
+  persector = fs->fs_hwsectorsize / (fs->fs_type == FSTYPE_FAT16 ? 2 : 4);
+  nsectors  = (fs->fs_nclusters + persector - 1) / persector;
+  if (nsectors > fs->fs_nfatsects)
+    {
+      nsectors = fs->fs_nfatsects;
+    }
+
+  fm = kmm_malloc(SIZEOF_FAT_FREEMAP_S(nsectors));
+  if (fm == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memset(fm, 0, sizeof(struct fat_freemap_s));
+  memset(fm->fm_map, 0xff, (nsectors + 7) / 8);
+  nxsem_init(&fm->fm_stopped, 0, 0);
+  fm->fm_nsectors  = nsectors;
+  fm->fm_persector = persector;
+  fs->fs_freemap   = fm;
+
+#ifdef CONFIG_FAT_COMPUTE_FSINFO
+  /* The count in FSINFO is not trusted, it is replaced by the result of
+   * the scan.
+   */
+
+  fs->fs_fsifreecount = 0xffffffff;
+#endif
+
+  fm->fm_queued = true;
+  work_queue(LPWORK, &fm->fm_work, fat_freemap_worker, fs, 0);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_freemap_uninitialize
+ *
+ * Description:
+ *   Stop the scan and release the free cluster map.  Called with the
+ *   volume locked; the lock is dropped while waiting for a scan step that
+ *   is about to run.
+ *
+ ****************************************************************************/
+
+void fat_freemap_uninitialize(FAR struct fat_mountpt_s *fs)
+{
+  FAR struct fat_freemap_s *fm = fs->fs_freemap;
+
+  if (fm == NULL)
+    {
+      return;
+    }
+
+  fm->fm_stop = true;
+  if (fm->fm_queued && work_cancel(LPWORK, &fm->fm_work) < 0)
+    {
+      /* The worker has been dequeued and waits for the lock */
+
+      nxmutex_unlock(&fs->fs_lock);
+      nxsem_wait_uninterruptible(&fm->fm_stopped);
+      nxmutex_lock(&fs->fs_lock);
+    }
+
+  nxsem_destroy(&fm->fm_stopped);
+  kmm_free(fm);
+  fs->fs_freemap = NULL;
+}
+
+/****************************************************************************
+ * Name: fat_freemap_finish
+ *
+ * Description:
+ *   Scan the rest of the FAT now, so that the free cluster count is known.
+ *   Called with the volume locked.
+ *
+ ****************************************************************************/
+
+int fat_freemap_finish(FAR struct fat_mountpt_s *fs)
+{
+  FAR struct fat_freemap_s *fm = fs->fs_freemap;
+  int ret;
+
+  while (fm->fm_next < fm->fm_nsectors)
+    {
+      ret = fat_freemap_scansector(fs);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_freemap_update
+ *
+ * Description:
+ *   Account for a cluster that has been allocated or freed.
+ *
+ ****************************************************************************/
+
+void fat_freemap_update(FAR struct fat_mountpt_s *fs, uint32_t cluster,
+                        bool isfree)
+{
+  FAR struct fat_freemap_s *fm = fs->fs_freemap;
+  uint32_t sector;
+
+  if (fm == NULL)
+    {
+      return;
+    }
+
+  sector = cluster / fm->fm_persector;
+  if (isfree)
+    {
+      fm->fm_map[sector >> 3] |= 1 << (sector & 7);
+    }
+
+  /* The sectors that are not scanned yet are counted when they are.  After
+   * the scan, the caller updates fs_fsifreecount.
+   */
+
+  if (sector < fm->fm_next && fm->fm_next < fm->fm_nsectors)
+    {
+      if (isfree)
+        {
+          fm->fm_nfree++;
+        }
+      else
+        {
+          fm->fm_nfree--;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: fat_freemap_skip
+ *
+ * Description:
+ *   Return the first cluster from 'cluster' on that is not in a FAT sector
+ *   known to be full.  The result may be beyond the last cluster.
+ *
+ ****************************************************************************/
+
+uint32_t fat_freemap_skip(FAR struct fat_mountpt_s *fs, uint32_t cluster)
+{
+  FAR struct fat_freemap_s *fm = fs->fs_freemap;
+  uint32_t sector;
+  uint32_t first;
+
+  if (fm == NULL)
+    {
+      return cluster;
+    }
+
+  first = cluster / fm->fm_persector;
+  for (sector = first; sector < fm->fm_next; sector++)
+    {
+      if ((fm->fm_map[sector >> 3] & (1 << (sector & 7))) != 0)
+        {
+          break;
+        }
+    }
+
+  return sector == first ? cluster : sector * fm->fm_persector;
+}
+
+#endif /* CONFIG_FAT_FREEMAP */
@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <inttypes.h>
 #include <stdint.h>
@@ -42,6 +43,14 @@
 #include "inode/inode.h"
 #include "fs_fat32.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Most sectors cleared with one write when a file is zero-extended */
+
+#define FAT_ZEROS_NSECTORS 8
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -619,16 +628,38 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
         }
     }
 
-  /* Enforce computation of free clusters if configured */
+#ifdef CONFIG_FAT_SECTORCACHE
+  /* Now that the layout is known, set up the sector cache.  The volume is
+   * still usable without it.
+   */
 
-#ifdef CONFIG_FAT_COMPUTE_FSINFO
-  ret = fat_computefreeclusters(fs);
-  if (ret != OK)
+  ret = fat_cache_initialize(fs);
+  if (ret < 0)
     {
-      goto errout_with_buffer;
+      fwarn("WARNING: No sector cache: %d\n", ret);
     }
 #endif
 
+#ifdef CONFIG_FAT_FREEMAP
+  /* Count the free clusters in the background, so that the mount does not
+   * wait for the whole FAT to be read.
+   */
+
+  ret = fat_freemap_initialize(fs);
+  if (ret < 0)
+#endif
+    {
+      /* Enforce computation of free clusters if configured */
+
+#ifdef CONFIG_FAT_COMPUTE_FSINFO
+      ret = fat_computefreeclusters(fs);
+      if (ret != OK)
+        {
+          goto errout_with_buffer;
+        }
+#endif
+    }
+
   /* We did it! */
 
   finfo("FAT%d:\n", fs->fs_type == 0 ? 12 : fs->fs_type == 1  ? 16 : 32);
@@ -651,6 +682,9 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   return OK;
 
 errout_with_buffer:
+#ifdef CONFIG_FAT_SECTORCACHE
+  fat_cache_uninitialize(fs);
+#endif
   fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
   fs->fs_buffer = NULL;
 
@@ -714,6 +748,49 @@ int fat_checkmount(struct fat_mountpt_s *fs)
 
 int fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
                unsigned int nsectors)
+{
+#ifdef CONFIG_FAT_SECTORCACHE
+  if (fs && fs->fs_cache)
+    {
+      return fat_cache_read(fs, buffer, sector, nsectors);
+    }
+#endif
+
+  return fat_blkread(fs, buffer, sector, nsectors);
+}
+
+/****************************************************************************
+ * Name: fat_hwwrite
+ *
+ * Description:
+ *   Write the sector buffer to the specified sector
+ *
+ ****************************************************************************/
+
+int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
+                unsigned int nsectors)
+{
+#ifdef CONFIG_FAT_SECTORCACHE
+  if (fs && fs->fs_cache)
+    {
+      return fat_cache_write(fs, buffer, sector, nsectors);
+    }
+#endif
+
+  return fat_blkwrite(fs, buffer, sector, nsectors);
+}
+
+/****************************************************************************
+ * Name: fat_blkread
+ *
+ * Description:
+ *   Read the specified sectors from the block driver, bypassing the sector
+ *   cache
+ *
+ ****************************************************************************/
+
+int fat_blkread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
+                unsigned int nsectors)
 {
   int ret = -ENODEV;
   if (fs && fs->fs_blkdriver)
@@ -738,15 +815,16 @@ int fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
 }
 
 /****************************************************************************
- * Name: fat_hwwrite
+ * Name: fat_blkwrite
  *
  * Description:
- *   Write the sector buffer to the specified sector
+ *   Write the specified sectors to the block driver, bypassing the sector
+ *   cache
  *
  ****************************************************************************/
 
-int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
-                unsigned int nsectors)
+int fat_blkwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
+                 unsigned int nsectors)
 {
   int ret = -ENODEV;
   if (fs && fs->fs_blkdriver)
@@ -1141,6 +1219,10 @@ int fat_removechain(struct fat_mountpt_s *fs, uint32_t cluster)
           fs->fs_fsidirty = true;
         }
 
+#ifdef CONFIG_FAT_FREEMAP
+      fat_freemap_update(fs, cluster, true);
+#endif
+
       /* Then set up to remove the next cluster */
 
       cluster = nextcluster;
@@ -1166,6 +1248,9 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
   off_t    startsector;
   uint32_t newcluster;
   uint32_t startcluster;
+#ifdef CONFIG_FAT_FREEMAP
+  uint32_t skipcluster;
+#endif
   int      ret;
 
   /* The special value 0 is used when the new chain should start */
@@ -1245,6 +1330,24 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
             }
         }
 
+#ifdef CONFIG_FAT_FREEMAP
+      /* Skip the clusters of the FAT sectors that are known to be full */
+
+      skipcluster = fat_freemap_skip(fs, newcluster);
+      if (skipcluster != newcluster)
+        {
+          if (newcluster < startcluster && skipcluster > startcluster)
+            {
+              /* The search has wrapped around past the start cluster */
+
+              return 0;
+            }
+
+          newcluster = skipcluster - 1;
+          continue;
+        }
+#endif
+
       /* We have a candidate cluster.  Check if the cluster number is
        * mapped to a group of sectors.
        */
@@ -1307,11 +1410,95 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
       fs->fs_fsidirty = true;
     }
 
+#ifdef CONFIG_FAT_FREEMAP
+  fat_freemap_update(fs, newcluster, false);
+#endif
+
   /* Return then number of the new cluster that was added to the chain */
 
   return newcluster;
 }
 
+/****************************************************************************
+ * Name: fat_contiguous
+ *
+ * Description:
+ *   Return how many of the up to 'nclusters' clusters that follow
+ *   'cluster' in its chain are also the next clusters on the volume, so
+ *   that the whole run can be transferred with one request.  Where the
+ *   chain ends, it is extended with the next clusters on the volume for as
+ *   long as they are free.
+ *
+ * Returned Value:
+ *   <0:error, otherwise the number of contiguous clusters after 'cluster'
+ *
+ ****************************************************************************/
+
+int32_t fat_contiguous(FAR struct fat_mountpt_s *fs, uint32_t cluster,
+                       uint32_t nclusters)
+{
+  uint32_t ncontig;
+  off_t next;
+  int ret;
+
+  for (ncontig = 0; ncontig < nclusters; ncontig++, cluster++)
+    {
+      next = fat_getcluster(fs, cluster);
+      if (next < 0)
+        {
+          return next;
+        }
+      else if (next == cluster + 1)
+        {
+          continue;
+        }
+      else if (next < fs->fs_nclusters || cluster + 1 >= fs->fs_nclusters)
+        {
+          /* The chain continues elsewhere or the volume ends here */
+
+          break;
+        }
+
+      /* This is the end of the chain.  Append the next cluster if it is
+       * free.
+       */
+
+      next = fat_getcluster(fs, cluster + 1);
+      if (next < 0)
+        {
+          return next;
+        }
+      else if (next != 0)
+        {
+          break;
+        }
+
+      ret = fat_putcluster(fs, cluster + 1, 0x0fffffff);
+      if (ret >= 0)
+        {
+          ret = fat_putcluster(fs, cluster, cluster + 1);
+        }
+
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      fs->fs_fsinextfree = cluster + 1;
+      if (fs->fs_fsifreecount != 0xffffffff)
+        {
+          fs->fs_fsifreecount--;
+          fs->fs_fsidirty = true;
+        }
+
+#ifdef CONFIG_FAT_FREEMAP
+      fat_freemap_update(fs, cluster + 1, false);
+#endif
+    }
+
+  return ncontig;
+}
+
 /****************************************************************************
  * Name: fat_nextdirentry
  *
@@ -1586,12 +1773,15 @@ int fat_dirshrink(struct fat_mountpt_s *fs, FAR uint8_t *direntry,
 int fat_dirextend(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff,
                   off_t length)
 {
+  FAR uint8_t *zeros = NULL;
+  unsigned int nzeros = 0;
+  unsigned int nsectors;
   int32_t cluster;
   off_t remaining;
   off_t pos;
   unsigned int zerosize;
   int sectndx;
-  int ret;
+  int ret = OK;
 
   /* We are extending the file.  This is essentially the same as a write
    * except that (1) we write zeros and (2) we don't update the file
@@ -1634,6 +1824,21 @@ int fat_dirextend(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff,
   sectndx   = pos & SEC_NDXMASK(fs);
   remaining = length - pos;
 
+  /* Whole sectors are cleared a few at a time from a zeroed buffer rather
+   * than one by one through the file's sector cache.  Without the buffer
+   * everything goes through the sector cache.
+   */
+
+  if (remaining >= 2 * fs->fs_hwsectorsize)
+    {
+      nzeros = MIN(fs->fs_fatsecperclus, FAT_ZEROS_NSECTORS);
+      zeros  = fat_io_alloc(nzeros * fs->fs_hwsectorsize);
+      if (zeros != NULL)
+        {
+          memset(zeros, 0, nzeros * fs->fs_hwsectorsize);
+        }
+    }
+
   while (remaining > 0)
     {
       /* Check if the current write stream has incremented to the next
@@ -1652,11 +1857,13 @@ int fat_dirextend(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff,
 
           if (cluster < 0)
             {
-              return (int)cluster;
+              ret = (int)cluster;
+              goto errout;
             }
           else if (cluster < 2 || cluster >= fs->fs_nclusters)
             {
-              return -ENOSPC;
+              ret = -ENOSPC;
+              goto errout;
             }
 
           /* Setup to zero the first sector from the new cluster */
@@ -1666,6 +1873,37 @@ int fat_dirextend(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff,
           ff->ff_currentsector    = fat_cluster2sector(fs, cluster);
         }
 
+      nsectors = MIN(remaining / fs->fs_hwsectorsize,
+                     ff->ff_sectorsincluster);
+      nsectors = MIN(nsectors, nzeros);
+
+      if (zeros != NULL && sectndx == 0 && nsectors > 0)
+        {
+          /* Write back and forget the cached sector, it may be one of
+           * those that are cleared.
+           */
+
+          ret = fat_ffcacheinvalidate(fs, ff);
+          if (ret < 0)
+            {
+              goto errout;
+            }
+
+          ret = fat_hwwrite(fs, zeros, ff->ff_currentsector, nsectors);
+          if (ret < 0)
+            {
+              goto errout;
+            }
+
+          ff->ff_sectorsincluster -= nsectors;
+          ff->ff_currentsector    += nsectors;
+          ff->ff_bflags           |= FFBUFF_MODIFIED;
+
+          pos       += nsectors * fs->fs_hwsectorsize;
+          remaining -= nsectors * fs->fs_hwsectorsize;
+          continue;
+        }
+
       /* Decide whether we are performing a read-modify-write
        * operation, in which case we have to read the existing sector
        * into the buffer first.
@@ -1688,7 +1926,7 @@ int fat_dirextend(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff,
           ret = fat_ffcacheflush(fs, ff);
           if (ret < 0)
             {
-              return ret;
+              goto errout;
             }
 
           /* Now mark the clean cache buffer as the current sector. */
@@ -1704,7 +1942,7 @@ int fat_dirextend(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff,
           ret = fat_ffcacheread(fs, ff, ff->ff_currentsector);
           if (ret < 0)
             {
-              return ret;
+              goto errout;
             }
         }
 
@@ -1744,7 +1982,14 @@ int fat_dirextend(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff,
   /* The truncation has completed without error.  Update the file size */
 
   ff->ff_size = length;
-  return OK;
+
+errout:
+  if (zeros != NULL)
+    {
+      fat_io_free(zeros, nzeros * fs->fs_hwsectorsize);
+    }
+
+  return ret;
 }
 
 /****************************************************************************
@@ -2011,6 +2256,15 @@ int fat_updatefsinfo(struct fat_mountpt_s *fs)
         }
     }
 
+#ifdef CONFIG_FAT_SECTORCACHE
+  /* Then write back everything that the sector cache holds */
+
+  if (ret == OK && fs->fs_cache)
+    {
+      ret = fat_cache_flush(fs);
+    }
+#endif
+
   return ret;
 }
 
@@ -2024,9 +2278,19 @@ int fat_updatefsinfo(struct fat_mountpt_s *fs)
 
 int fat_computefreeclusters(struct fat_mountpt_s *fs)
 {
+  uint32_t nfreeclusters = 0;
+
+#ifdef CONFIG_FAT_FREEMAP
+  /* Finish the background scan, which sets the count */
+
+  if (fs->fs_freemap != NULL)
+    {
+      return fat_freemap_finish(fs);
+    }
+#endif
+
   /* We have to count the number of free clusters */
 
-  uint32_t nfreeclusters = 0;
   if (fs->fs_type == FSTYPE_FAT12)
     {
       off_t sector;
@@ -36,6 +36,7 @@
 #include <nuttx/cancelpt.h>
 #include <nuttx/mutex.h>
 #include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
 
 #ifdef CONFIG_FDSAN
 #  include <android/fdsan.h>
@@ -47,6 +48,24 @@
 
 #include "inode/inode.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The most rows that a file list can have */
+
+#define FILES_MAXROWS (OPEN_MAX / CONFIG_NFILE_DESCRIPTORS_PER_BLOCK)
+
+/* Orders the initialization of a row before its publication for the
+ * lookups running on the other CPUs.
+ */
+
+#ifdef CONFIG_SPINLOCK
+#  define FILES_DMB() SP_DMB()
+#else
+#  define FILES_DMB()
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -58,6 +77,7 @@
 static int files_extend(FAR struct filelist *list, size_t row)
 {
   FAR struct file **tmp;
+  FAR struct file *files;
   int i;
 
   if (row <= list->fl_rows)
@@ -70,32 +90,46 @@ static int files_extend(FAR struct filelist *list, size_t row)
       return -EMFILE;
     }
 
-  tmp = kmm_realloc(list->fl_files, sizeof(FAR struct file *) * row);
-  DEBUGASSERT(tmp);
+  /* The array of rows is allocated once with room for all the rows, so
+   * that fs_getfilep() can index it without the list lock: neither the
+   * array nor a row is moved or freed before the list is released.
+   */
+
+  tmp = list->fl_files;
   if (tmp == NULL)
     {
-      return -ENFILE;
+      tmp = kmm_zalloc(sizeof(FAR struct file *) * FILES_MAXROWS);
+      DEBUGASSERT(tmp);
+      if (tmp == NULL)
+        {
+          return -ENFILE;
+        }
+
+      FILES_DMB();
+      list->fl_files = tmp;
     }
 
-  i = list->fl_rows;
-  do
+  for (i = list->fl_rows; i < row; i++)
     {
-      tmp[i] = kmm_zalloc(sizeof(struct file) *
-                          CONFIG_NFILE_DESCRIPTORS_PER_BLOCK);
-      if (tmp[i] == NULL)
+      files = kmm_zalloc(sizeof(struct file) *
+                         CONFIG_NFILE_DESCRIPTORS_PER_BLOCK);
+      if (files == NULL)
         {
           while (--i >= list->fl_rows)
             {
               kmm_free(tmp[i]);
+              tmp[i] = NULL;
             }
 
-          kmm_free(tmp);
           return -ENFILE;
         }
+
+      /* Publish the row only once it is cleared */
+
+      FILES_DMB();
+      tmp[i] = files;
     }
-  while (++i < row);
 
-  list->fl_files = tmp;
   list->fl_rows = row;
 
   /* Note: If assertion occurs, the fl_rows has a overflow.
@@ -416,8 +450,8 @@ out:
 
 int fs_getfilep(int fd, FAR struct file **filep)
 {
+  FAR struct file *volatile *rows;
   FAR struct filelist *list;
-  int ret;
 
 #ifdef CONFIG_FDCHECK
   fd = fdcheck_restore(fd);
@@ -439,36 +473,32 @@ int fs_getfilep(int fd, FAR struct file **filep)
       return -EAGAIN;
     }
 
-  if (fd < 0 || fd >= list->fl_rows * CONFIG_NFILE_DESCRIPTORS_PER_BLOCK)
-    {
-      return -EBADF;
-    }
-
-  /* The descriptor is in a valid range to file descriptor... Get the
-   * thread-specific file list.
+  /* The lookup takes no lock.  The array of rows and the rows never move
+   * (see files_extend()), so a row that is seen is valid and an unseen row
+   * means a descriptor that is not allocated yet.  Like with the lock, a
+   * descriptor closed by another thread may be closed right after it has
+   * been returned.
    */
 
-  /* And return the file pointer from the list */
-
-  ret = nxmutex_lock(&list->fl_lock);
-  if (ret < 0)
+  rows = list->fl_files;
+  if (fd < 0 || fd >= FILES_MAXROWS * CONFIG_NFILE_DESCRIPTORS_PER_BLOCK ||
+      rows == NULL || rows[fd / CONFIG_NFILE_DESCRIPTORS_PER_BLOCK] == NULL)
     {
-      return ret;
+      return -EBADF;
     }
 
-  *filep = &list->fl_files[fd / CONFIG_NFILE_DESCRIPTORS_PER_BLOCK]
-                          [fd % CONFIG_NFILE_DESCRIPTORS_PER_BLOCK];
+  *filep = &rows[fd / CONFIG_NFILE_DESCRIPTORS_PER_BLOCK]
+                [fd % CONFIG_NFILE_DESCRIPTORS_PER_BLOCK];
 
   /* if f_inode is NULL, fd was closed */
 
   if (!(*filep)->f_inode)
     {
       *filep = NULL;
-      ret = -EBADF;
+      return -EBADF;
     }
 
-  nxmutex_unlock(&list->fl_lock);
-  return ret;
+  return OK;
 }
 
 /****************************************************************************
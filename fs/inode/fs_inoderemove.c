@@ -96,6 +96,7 @@ FAR struct inode *inode_unlink(FAR const char *path)
 
       node->i_peer   = NULL;
       node->i_parent = NULL;
+      inode_hash_invalidate();
     }
 
   RELEASE_SEARCH(&desc);
@@ -105,6 +105,8 @@ static void inode_insert(FAR struct inode *node,
                          FAR struct inode *peer,
                          FAR struct inode *parent)
 {
+  inode_hash_invalidate();
+
   /* If peer is non-null, then new node simply goes to the right
    * of that peer node.
    */
@@ -24,6 +24,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -35,6 +37,34 @@
 
 #include "inode/inode.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_PSEUDOFS_HASH
+#  define INODE_HASH_MASK (CONFIG_PSEUDOFS_HASH_NENTRIES - 1)
+
+#  if (CONFIG_PSEUDOFS_HASH_NENTRIES & INODE_HASH_MASK) != 0
+#    error CONFIG_PSEUDOFS_HASH_NENTRIES must be a power of two
+#  endif
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_PSEUDOFS_HASH
+/* The result of a successful search of a full path, see _inode_search() */
+
+struct inode_hash_s
+{
+  uint32_t hash;             /* Hash of the path */
+  FAR struct inode *node;    /* The inode found, NULL if the entry is free */
+  FAR struct inode *peer;    /* Node to the "left" of the inode */
+  FAR struct inode *parent;  /* Node "above" the inode */
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -53,10 +83,99 @@ static FAR const char *_inode_getcwd(void);
 
 FAR struct inode *g_root_inode = NULL;
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_PSEUDOFS_HASH
+/* Direct mapped cache of the recent searches, protected by the inode lock
+ * like the tree itself.
+ */
+
+static struct inode_hash_s g_inode_hash[CONFIG_PSEUDOFS_HASH_NENTRIES];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_PSEUDOFS_HASH
+/****************************************************************************
+ * Name: inode_hash_path
+ *
+ * Description:
+ *   Return the FNV-1a hash and the length of an absolute path.  Only paths
+ *   in canonical form, without empty, '.' or '..' segments and without a
+ *   trailing '/', are hashed, so that a path is known to name the inode
+ *   whose ancestors have the names of its segments.
+ *
+ * Returned Value:
+ *   True if the path was hashed.
+ *
+ ****************************************************************************/
+
+static bool inode_hash_path(FAR const char *path, FAR uint32_t *hash,
+                            FAR size_t *len)
+{
+  FAR const char *ptr = path;
+  uint32_t value = 2166136261u;
+
+  while (*ptr != '\0')
+    {
+      if (*ptr == '/' &&
+          (ptr[1] == '/' || ptr[1] == '\0' ||
+           (ptr[1] == '.' && (ptr[2] == '/' || ptr[2] == '\0' ||
+                              (ptr[2] == '.' &&
+                               (ptr[3] == '/' || ptr[3] == '\0'))))))
+        {
+          return false;
+        }
+
+      value = (value ^ (uint8_t)*ptr++) * 16777619u;
+    }
+
+  *hash = value;
+  *len  = ptr - path;
+  return true;
+}
+
+/****************************************************************************
+ * Name: inode_hash_verify
+ *
+ * Description:
+ *   Check that a canonical path names an inode, by matching its segments
+ *   from the last one with the names of the inode and of its ancestors.
+ *   This leaves out the inodes that were reached through soft links.
+ *
+ ****************************************************************************/
+
+static bool inode_hash_verify(FAR const char *path, size_t len,
+                              FAR struct inode *node)
+{
+  FAR const char *end = path + len;
+  size_t nlen;
+
+  for (; node != g_root_inode; node = node->i_parent)
+    {
+      if (node == NULL || node->i_name[0] == '\0')
+        {
+          return false;
+        }
+
+      nlen = strlen(node->i_name);
+      if ((size_t)(end - path) < nlen + 1 || *(end - nlen - 1) != '/' ||
+          memcmp(end - nlen, node->i_name, nlen) != 0)
+        {
+          return false;
+        }
+
+      end -= nlen + 1;
+    }
+
+  return end == path;
+}
+#endif
+
 /****************************************************************************
  * Name: _inode_compare
  *
@@ -223,6 +342,13 @@ static int _inode_search(FAR struct inode_search_s *desc)
   FAR struct inode *left    = NULL;
   FAR struct inode *above   = NULL;
   FAR const char   *relpath = NULL;
+#ifdef CONFIG_PSEUDOFS_HASH
+  FAR struct inode_hash_s *entry = NULL;
+  FAR const char *path;
+  bool hashed;
+  uint32_t hash;
+  size_t len;
+#endif
   int ret = -ENOENT;
 
   /* Get the search path, skipping over the leading '/'.  The leading '/' is
@@ -237,6 +363,27 @@ static int _inode_search(FAR struct inode_search_s *desc)
       return -EINVAL;
     }
 
+#ifdef CONFIG_PSEUDOFS_HASH
+  /* Try the result of an earlier search of the same path first */
+
+  path   = name;
+  hashed = inode_hash_path(path, &hash, &len);
+  if (hashed)
+    {
+      entry = &g_inode_hash[hash & INODE_HASH_MASK];
+      if (entry->node != NULL && entry->hash == hash &&
+          inode_hash_verify(path, len, entry->node))
+        {
+          desc->path    = path + len;
+          desc->node    = entry->node;
+          desc->peer    = entry->peer;
+          desc->parent  = entry->parent;
+          desc->relpath = path + len;
+          return OK;
+        }
+    }
+#endif
+
   /* Traverse the pseudo file system node tree until either (1) all nodes
    * have been examined without finding the matching node, or (2) the
    * matching node is found.
@@ -409,6 +556,19 @@ static int _inode_search(FAR struct inode_search_s *desc)
    *   (4) When the node matching the full path is found
    */
 
+#ifdef CONFIG_PSEUDOFS_HASH
+  /* Remember the searches that consumed the whole path in the tree */
+
+  if (ret == OK && hashed && *name == '\0' && relpath == name &&
+      inode_hash_verify(path, len, node))
+    {
+      entry->hash   = hash;
+      entry->node   = node;
+      entry->peer   = left;
+      entry->parent = above;
+    }
+#endif
+
   desc->path    = name;
   desc->node    = node;
   desc->peer    = left;
@@ -530,6 +690,26 @@ int inode_search(FAR struct inode_search_s *desc)
   return ret;
 }
 
+/****************************************************************************
+ * Name: inode_hash_invalidate
+ *
+ * Description:
+ *   Forget the results of the earlier searches.  Called when an inode is
+ *   inserted in or removed from the tree, since that may change the node
+ *   found for a path or its peer.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PSEUDOFS_HASH
+void inode_hash_invalidate(void)
+{
+  memset(g_inode_hash, 0, sizeof(g_inode_hash));
+}
+#endif
+
 /****************************************************************************
  * Name: inode_nextname
  *
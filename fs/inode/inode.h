@@ -291,6 +291,21 @@ int inode_getpath(FAR struct inode *node, FAR char *path, size_t len);
 
 void inode_free(FAR struct inode *node);
 
+/****************************************************************************
+ * Name: inode_hash_invalidate
+ *
+ * Description:
+ *   Forget the cached results of inode_search().  Called whenever the tree
+ *   is modified.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PSEUDOFS_HASH
+void inode_hash_invalidate(void);
+#else
+#  define inode_hash_invalidate()
+#endif
+
 /****************************************************************************
  * Name: inode_nextname
  *
@@ -26,9 +26,13 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/fs/littlefs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/mutex.h>
@@ -61,6 +65,10 @@ struct littlefs_file_s
 {
   struct lfs_file       file;
   int                   refs;
+#if CONFIG_FS_LITTLEFS_FILE_CACHES > 0
+  struct lfs_file_config cfg;    /* Points to the shared cache, if any */
+  int                   cache;   /* Index of the shared cache, or -1 */
+#endif
 };
 
 /* This structure represents the overall mountpoint state. An instance of
@@ -75,6 +83,11 @@ struct littlefs_mountpt_s
   struct mtd_geometry_s geo;
   struct lfs_config     cfg;
   struct lfs            lfs;
+  struct littlefs_stats_s stats;
+#if CONFIG_FS_LITTLEFS_FILE_CACHES > 0
+  FAR uint8_t          *caches;    /* The shared file caches */
+  uint32_t              cachefree; /* One bit per free shared cache */
+#endif
 };
 
 /****************************************************************************
@@ -274,6 +287,60 @@ static int littlefs_convert_oflags(int oflags)
   return ret;
 }
 
+/****************************************************************************
+ * Name: littlefs_cache_alloc
+ *
+ * Description:
+ *   Give a file one of the shared caches, if one is free.  Otherwise
+ *   littlefs allocates the cache from the heap.  Called with the volume
+ *   locked.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_LITTLEFS_FILE_CACHES > 0
+static void littlefs_cache_alloc(FAR struct littlefs_mountpt_s *fs,
+                                 FAR struct littlefs_file_s *priv)
+{
+  memset(&priv->cfg, 0, sizeof(priv->cfg));
+  priv->cache = -1;
+
+  if (fs->cachefree == 0)
+    {
+      fs->stats.cachemisses++;
+      return;
+    }
+
+  priv->cache       = ffs(fs->cachefree) - 1;
+  priv->cfg.buffer  = fs->caches + priv->cache * fs->cfg.cache_size;
+  fs->cachefree    &= ~(1u << priv->cache);
+
+  if (++fs->stats.cachesinuse > fs->stats.cachespeak)
+    {
+      fs->stats.cachespeak = fs->stats.cachesinuse;
+    }
+}
+
+/****************************************************************************
+ * Name: littlefs_cache_free
+ *
+ * Description:
+ *   Return the shared cache of a file that has been closed.  Called with
+ *   the volume locked.
+ *
+ ****************************************************************************/
+
+static void littlefs_cache_free(FAR struct littlefs_mountpt_s *fs,
+                                FAR struct littlefs_file_s *priv)
+{
+  if (priv->cache >= 0)
+    {
+      fs->cachefree |= 1u << priv->cache;
+      fs->stats.cachesinuse--;
+      priv->cache = -1;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: littlefs_open
  ****************************************************************************/
@@ -314,8 +381,15 @@ static int littlefs_open(FAR struct file *filep, FAR const char *relpath,
   /* Try to open the file */
 
   oflags = littlefs_convert_oflags(oflags);
+#if CONFIG_FS_LITTLEFS_FILE_CACHES > 0
+  littlefs_cache_alloc(fs, priv);
+  ret = littlefs_convert_result(lfs_file_opencfg(&fs->lfs, &priv->file,
+                                                 relpath, oflags,
+                                                 &priv->cfg));
+#else
   ret = littlefs_convert_result(lfs_file_open(&fs->lfs, &priv->file,
                                               relpath, oflags));
+#endif
   if (ret < 0)
     {
       /* Error opening file */
@@ -356,6 +430,9 @@ static int littlefs_open(FAR struct file *filep, FAR const char *relpath,
 errout_with_file:
   lfs_file_close(&fs->lfs, &priv->file);
 errout:
+#if CONFIG_FS_LITTLEFS_FILE_CACHES > 0
+  littlefs_cache_free(fs, priv);
+#endif
   nxmutex_unlock(&fs->lock);
 errlock:
   kmm_free(priv);
@@ -390,6 +467,9 @@ static int littlefs_close(FAR struct file *filep)
   if (--priv->refs <= 0)
     {
       ret = littlefs_convert_result(lfs_file_close(&fs->lfs, &priv->file));
+#if CONFIG_FS_LITTLEFS_FILE_CACHES > 0
+      littlefs_cache_free(fs, priv);
+#endif
     }
 
   nxmutex_unlock(&fs->lock);
@@ -551,6 +631,54 @@ static int littlefs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   fs    = inode->i_private;
   drv   = fs->drv;
 
+  if (cmd == FIOC_LFSSTATS)
+    {
+      FAR struct littlefs_stats_s *stats =
+        (FAR struct littlefs_stats_s *)((uintptr_t)arg);
+      int ret;
+
+      if (stats == NULL)
+        {
+          return -EINVAL;
+        }
+
+      ret = nxmutex_lock(&fs->lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      *stats                = fs->stats;
+      stats->lookahead_off  = fs->lfs.free.off;
+      stats->lookahead_size = fs->lfs.free.size;
+      stats->lookahead_next = fs->lfs.free.i;
+      stats->lookahead_ack  = fs->lfs.free.ack;
+      stats->block_count    = fs->cfg.block_count;
+      nxmutex_unlock(&fs->lock);
+      return OK;
+    }
+
+#if LFS_VERSION >= 0x00020008
+  if (cmd == FIOC_GCSTEP)
+    {
+      int ret;
+
+      /* Compact metadata and refill the lookahead window now, so that the
+       * next writes do not have to.
+       */
+
+      ret = nxmutex_lock(&fs->lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = littlefs_convert_result(lfs_fs_gc(&fs->lfs));
+      nxmutex_unlock(&fs->lock);
+      return ret;
+    }
+#endif
+
   if (INODE_IS_MTD(drv))
     {
       return MTD_IOCTL(drv->u.i_mtd, cmd, arg);
@@ -911,6 +1039,9 @@ static int littlefs_read_block(FAR const struct lfs_config *c,
   FAR struct inode *drv = fs->drv;
   int ret;
 
+  fs->stats.nreads++;
+  fs->stats.readbytes += size;
+
   block = (block * c->block_size + off) / geo->blocksize;
   size  = size / geo->blocksize;
 
@@ -939,6 +1070,9 @@ static int littlefs_write_block(FAR const struct lfs_config *c,
   FAR struct inode *drv = fs->drv;
   int ret;
 
+  fs->stats.nprogs++;
+  fs->stats.progbytes += size;
+
   block = (block * c->block_size + off) / geo->blocksize;
   size  = size / geo->blocksize;
 
@@ -965,6 +1099,8 @@ static int littlefs_erase_block(FAR const struct lfs_config *c,
   FAR struct inode *drv = fs->drv;
   int ret = OK;
 
+  fs->stats.nerases++;
+
   if (INODE_IS_MTD(drv))
     {
       FAR struct mtd_geometry_s *geo = &fs->geo;
@@ -987,6 +1123,8 @@ static int littlefs_sync_block(FAR const struct lfs_config *c)
   FAR struct inode *drv = fs->drv;
   int ret;
 
+  fs->stats.nsyncs++;
+
   if (INODE_IS_MTD(drv))
     {
       ret = MTD_IOCTL(drv->u.i_mtd, BIOC_FLUSH, 0);
@@ -1006,6 +1144,62 @@ static int littlefs_sync_block(FAR const struct lfs_config *c)
   return ret == -ENOTTY ? OK : ret;
 }
 
+/****************************************************************************
+ * Name: littlefs_parse_options
+ *
+ * Description:
+ *   Parse the comma separated mount options:  forceformat, autoformat,
+ *   metadata_max=<bytes> and, with littlefs 2.9 or later,
+ *   compact_thresh=<bytes>.  Unknown options are ignored.
+ *
+ ****************************************************************************/
+
+static void littlefs_parse_options(FAR struct littlefs_mountpt_s *fs,
+                                   FAR const char *data,
+                                   FAR bool *forceformat,
+                                   FAR bool *autoformat)
+{
+  char options[64];
+  FAR char *saveptr;
+  FAR char *option;
+
+  *forceformat = false;
+  *autoformat  = false;
+
+  if (data == NULL)
+    {
+      return;
+    }
+
+  strlcpy(options, data, sizeof(options));
+  for (option = strtok_r(options, ",", &saveptr); option != NULL;
+       option = strtok_r(NULL, ",", &saveptr))
+    {
+      if (strcmp(option, "forceformat") == 0)
+        {
+          *forceformat = true;
+        }
+      else if (strcmp(option, "autoformat") == 0)
+        {
+          *autoformat = true;
+        }
+      else if (strncmp(option, "metadata_max=", 13) == 0)
+        {
+          fs->cfg.metadata_max = strtoul(&option[13], NULL, 0);
+        }
+#if LFS_VERSION >= 0x00020009
+      else if (strncmp(option, "compact_thresh=", 15) == 0)
+        {
+          fs->cfg.compact_thresh = strtoul(&option[15], NULL, 0);
+        }
+#endif
+      else
+        {
+          fwarn("WARNING: Unknown option %s\n", option);
+        }
+    }
+}
+
 /****************************************************************************
  * Name: littlefs_bind
  ****************************************************************************/
@@ -1014,6 +1208,8 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
                          FAR void **handle)
 {
   FAR struct littlefs_mountpt_s *fs;
+  bool forceformat;
+  bool autoformat;
   int ret;
 
   /* Open the block driver */
@@ -1114,13 +1310,32 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
   fs->cfg.lookahead_size = CONFIG_FS_LITTLEFS_LOOKAHEAD_SIZE;
 #endif
 
+  fs->cfg.metadata_max   = CONFIG_FS_LITTLEFS_METADATA_MAX;
+
+  littlefs_parse_options(fs, data, &forceformat, &autoformat);
+
+#if CONFIG_FS_LITTLEFS_FILE_CACHES > 0
+  /* Allocate the file caches that the open files share */
+
+  fs->caches = kmm_malloc(CONFIG_FS_LITTLEFS_FILE_CACHES *
+                          fs->cfg.cache_size);
+  if (fs->caches == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_fs;
+    }
+
+  fs->cachefree      = UINT32_MAX >> (32 - CONFIG_FS_LITTLEFS_FILE_CACHES);
+  fs->stats.ncaches  = CONFIG_FS_LITTLEFS_FILE_CACHES;
+#endif
+
   /* Then get information about the littlefs filesystem on the devices
    * managed by this driver.
    */
 
   /* Force format the device if -o forceformat */
 
-  if (data && strcmp(data, "forceformat") == 0)
+  if (forceformat)
     {
       ret = littlefs_convert_result(lfs_format(&fs->lfs, &fs->cfg));
       if (ret < 0)
@@ -1134,7 +1349,7 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
     {
       /* Auto format the device if -o autoformat */
 
-      if (ret != -EFAULT || !data || strcmp(data, "autoformat"))
+      if (ret != -EFAULT || !autoformat)
         {
           goto errout_with_fs;
         }
@@ -1158,6 +1373,9 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
   return OK;
 
 errout_with_fs:
+#if CONFIG_FS_LITTLEFS_FILE_CACHES > 0
+  kmm_free(fs->caches);
+#endif
   nxmutex_destroy(&fs->lock);
   kmm_free(fs);
 errout_with_block:
@@ -1217,6 +1435,9 @@ static int littlefs_unbind(FAR void *handle, FAR struct inode **driver,
 
       /* Release the mountpoint private data */
 
+#if CONFIG_FS_LITTLEFS_FILE_CACHES > 0
+      kmm_free(fs->caches);
+#endif
       nxmutex_destroy(&fs->lock);
       kmm_free(fs);
     }
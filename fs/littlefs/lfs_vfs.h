@@ -26,4 +26,16 @@
 #undef LFS_UTIL_H
 
 #include <debug.h>
+#include <nuttx/crc32.h>
 #include "littlefs/lfs_util.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The CRC of littlefs is the reflected CRC-32 without the final inversion,
+ * which crc32part() computes, with the chip's CRC unit when there is one.
+ * This replaces the byte-wise lfs_crc() of lfs_util.c.
+ */
+
+#define lfs_crc(crc, buffer, size) crc32part(buffer, size, crc)
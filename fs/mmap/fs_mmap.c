@@ -28,6 +28,7 @@
 #include <sys/mman.h>
 #include <sys/ioctl.h>
 #include <stdint.h>
+#include <string.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <debug.h>
@@ -187,6 +188,50 @@ int file_mmap(FAR struct file *filep, FAR void *start, size_t length,
                     prot, flags, offset, true, mapped);
 }
 
+/****************************************************************************
+ * Name: file_xipmap
+ *
+ * Description:
+ *   Return the address at which a part of the file can be read in place.
+ *   Only mappings that the file system or driver provides without any
+ *   resource to release are accepted.
+ *
+ ****************************************************************************/
+
+int file_xipmap(FAR struct file *filep, off_t offset, size_t length,
+                FAR const void **mapped)
+{
+  struct mm_map_entry_s entry;
+  int ret;
+
+  if (filep->f_inode == NULL || filep->f_inode->u.i_ops->mmap == NULL ||
+      (filep->f_oflags & O_RDOK) == 0 || length == 0)
+    {
+      return -ENOTTY;
+    }
+
+  memset(&entry, 0, sizeof(entry));
+  entry.length = length;
+  entry.offset = offset;
+  entry.prot   = PROT_READ;
+  entry.flags  = MAP_SHARED;
+
+  ret = filep->f_inode->u.i_ops->mmap(filep, &entry);
+  if (ret < 0)
+    {
+      return -ENOTTY;
+    }
+
+  if (entry.munmap != NULL)
+    {
+      entry.munmap(NULL, &entry, entry.vaddr, entry.length);
+      return -ENOTTY;
+    }
+
+  *mapped = entry.vaddr;
+  return OK;
+}
+
 /****************************************************************************
  * Name: mmap
  *
@@ -124,7 +124,7 @@ static int nxmq_file_poll(FAR struct file *filep,
 
       /* Immediately notify on any of the requested events */
 
-      if (msgq->nmsgs < msgq->maxmsgs)
+      if (MQ_NMSGS(msgq) < msgq->maxmsgs)
         {
           eventset |= POLLOUT;
         }
@@ -52,9 +52,11 @@
  * External Definitions
  ****************************************************************************/
 
+extern const struct procfs_operations g_boottime_operations;
 extern const struct procfs_operations g_cpuinfo_operations;
 extern const struct procfs_operations g_cpuload_operations;
 extern const struct procfs_operations g_critmon_operations;
+extern const struct procfs_operations g_critsites_operations;
 extern const struct procfs_operations g_fdt_operations;
 extern const struct procfs_operations g_iobinfo_operations;
 extern const struct procfs_operations g_irq_operations;
@@ -64,6 +66,7 @@ extern const struct procfs_operations g_mempool_operations;
 extern const struct procfs_operations g_module_operations;
 extern const struct procfs_operations g_pm_operations;
 extern const struct procfs_operations g_proc_operations;
+extern const struct procfs_operations g_statbin_operations;
 extern const struct procfs_operations g_tcbinfo_operations;
 extern const struct procfs_operations g_uptime_operations;
 extern const struct procfs_operations g_version_operations;
@@ -74,11 +77,13 @@ extern const struct procfs_operations g_version_operations;
  * configuration.
  */
 
+extern const struct procfs_operations g_blockcache_operations;
 extern const struct procfs_operations g_mount_operations;
 extern const struct procfs_operations g_net_operations;
 extern const struct procfs_operations g_netroute_operations;
 extern const struct procfs_operations g_part_operations;
 extern const struct procfs_operations g_smartfs_operations;
+extern const struct procfs_operations g_syscall_operations;
 
 /****************************************************************************
  * Private Types
@@ -97,6 +102,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "[0-9]*",       &g_proc_operations,     PROCFS_DIR_TYPE    },
 #endif
 
+#ifdef CONFIG_SCHED_BOOTTRACE
+  { "boottime",     &g_boottime_operations, PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_ARCH_HAVE_CPUINFO) && !defined(CONFIG_FS_PROCFS_EXCLUDE_CPUINFO)
   { "cpuinfo",      &g_cpuinfo_operations,  PROCFS_FILE_TYPE   },
 #endif
@@ -109,10 +118,18 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "critmon",      &g_critmon_operations,  PROCFS_FILE_TYPE   },
 #endif
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HOTSPOT
+  { "critsites",    &g_critsites_operations, PROCFS_FILE_TYPE  },
+#endif
+
 #if defined(CONFIG_DEVICE_TREE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_FDT)
   { "fdt",          &g_fdt_operations,      PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_FS_BLOCKCACHE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_BLOCKCACHE)
+  { "fs/blockcache", &g_blockcache_operations, PROCFS_FILE_TYPE },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_BLOCKS
   { "fs/blocks",    &g_mount_operations,    PROCFS_FILE_TYPE   },
 #endif
@@ -175,6 +192,14 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "self/**",      &g_proc_operations,     PROCFS_UNKOWN_TYPE },
 #endif
 
+#ifndef CONFIG_FS_PROCFS_EXCLUDE_STATBIN
+  { "stat.bin",     &g_statbin_operations,  PROCFS_FILE_TYPE   },
+#endif
+
+#ifdef CONFIG_SYSCALL_STATS
+  { "syscalls",     &g_syscall_operations,  PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_ARCH_HAVE_TCBINFO) && !defined(CONFIG_FS_PROCFS_EXCLUDE_TCBINFO)
   { "tcbinfo",      &g_tcbinfo_operations,  PROCFS_FILE_TYPE   },
 #endif
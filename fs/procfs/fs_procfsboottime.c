@@ -0,0 +1,313 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsboottime.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/init.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_SCHED_BOOTTRACE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define BOOTTIME_LINELEN 80
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct boottime_file_s
+{
+  struct procfs_file_s base;                 /* Base open file structure */
+  uint32_t dropped;                          /* Stages that did not fit */
+  int nentries;                              /* Number of valid entries */
+  struct boottrace_s entries[CONFIG_SCHED_BOOTTRACE_NENTRIES];
+  char line[BOOTTIME_LINELEN];               /* Buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     boottime_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     boottime_close(FAR struct file *filep);
+static ssize_t boottime_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     boottime_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     boottime_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_boottime_operations =
+{
+  boottime_open,      /* open */
+  boottime_close,     /* close */
+  boottime_read,      /* read */
+  NULL,               /* write */
+
+  boottime_dup,       /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  boottime_stat       /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: boottime_usec
+ *
+ * Description:
+ *   Convert an up_perf_gettime() count to microseconds.
+ *
+ ****************************************************************************/
+
+static unsigned long boottime_usec(unsigned long count)
+{
+  return (uint64_t)count * USEC_PER_SEC / up_perf_getfreq();
+}
+
+/****************************************************************************
+ * Name: boottime_open
+ ****************************************************************************/
+
+static int boottime_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct boottime_file_s *attr;
+  irqstate_t flags;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = kmm_zalloc(sizeof(struct boottime_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Take a snapshot, the deferred board steps may still be adding */
+
+  flags = enter_critical_section();
+  attr->nentries = g_nboottrace;
+  attr->dropped  = g_boottrace_dropped;
+  memcpy(attr->entries, g_boottrace,
+         attr->nentries * sizeof(struct boottrace_s));
+  leave_critical_section(flags);
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: boottime_close
+ ****************************************************************************/
+
+static int boottime_close(FAR struct file *filep)
+{
+  FAR struct boottime_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct boottime_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: boottime_read
+ ****************************************************************************/
+
+static ssize_t boottime_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct boottime_file_s *attr;
+  FAR const struct boottrace_s *entry;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct boottime_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  offset = filep->f_pos;
+
+  linesize  = procfs_snprintf(attr->line, BOOTTIME_LINELEN,
+                              "%-24s %10s %10s %10s\n",
+                              "STAGE", "START(us)", "END(us)", "TIME(us)");
+  copysize  = procfs_memcpy(attr->line, linesize, buffer, buflen, &offset);
+  totalsize = copysize;
+
+  for (i = 0; i < attr->nentries && totalsize < buflen; i++)
+    {
+      entry    = &attr->entries[i];
+      linesize = procfs_snprintf(attr->line, BOOTTIME_LINELEN,
+                                 "%-24.24s %10lu %10lu %10lu\n",
+                                 entry->name,
+                                 boottime_usec(entry->start),
+                                 boottime_usec(entry->end),
+                                 boottime_usec(entry->end - entry->start));
+      copysize = procfs_memcpy(attr->line, linesize, buffer + totalsize,
+                               buflen - totalsize, &offset);
+
+      totalsize += copysize;
+    }
+
+  if (attr->dropped > 0 && totalsize < buflen)
+    {
+      linesize   = procfs_snprintf(attr->line, BOOTTIME_LINELEN,
+                                   "%" PRIu32 " stages dropped\n",
+                                   attr->dropped);
+      copysize   = procfs_memcpy(attr->line, linesize, buffer + totalsize,
+                                 buflen - totalsize, &offset);
+      totalsize += copysize;
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: boottime_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int boottime_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct boottime_file_s *oldattr;
+  FAR struct boottime_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct boottime_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = kmm_malloc(sizeof(struct boottime_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct boottime_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: boottime_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int boottime_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "boottime" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_SCHED_BOOTTRACE */
@@ -55,7 +55,7 @@
  * to handle the longest line generated by this logic.
  */
 
-#define CPULOAD_LINELEN 16
+#define CPULOAD_LINELEN 32
 
 /****************************************************************************
  * Private Types
@@ -203,6 +203,9 @@ static ssize_t cpuload_read(FAR struct file *filep, FAR char *buffer,
     {
       uint32_t total = 0;
       uint32_t active = 0;
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+      uint32_t irq;
+#endif
       uint32_t intpart;
       uint32_t fracpart;
 
@@ -221,12 +224,18 @@ static ssize_t cpuload_read(FAR struct file *filep, FAR char *buffer,
         }
 
       total = cpuloads[0].total;
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+      irq = cpuloads[0].irq;
+#endif
 #else
       struct cpuload_s cpuload;
 
       DEBUGVERIFY(clock_cpuload(0, &cpuload));
       active = cpuload.active;
       total = cpuload.total;
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+      irq = cpuload.irq;
+#endif
 #endif
 
       if (active > total)
@@ -242,7 +251,7 @@ static ssize_t cpuload_read(FAR struct file *filep, FAR char *buffer,
         {
           uint32_t tmp;
 
-          tmp      = 1000 - (1000 * active) / total;
+          tmp      = 1000 - (1000 * (uint64_t)active) / total;
           intpart  = tmp / 10;
           fracpart = tmp - 10 * intpart;
         }
@@ -252,9 +261,27 @@ static ssize_t cpuload_read(FAR struct file *filep, FAR char *buffer,
           fracpart = 0;
         }
 
-      linesize = procfs_snprintf(attr->line, CPULOAD_LINELEN,
-                                 "%3" PRId32 ".%01" PRId32 "%%\n",
-                                 intpart, fracpart);
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+      /* Show which part of the load was spent in interrupt handlers */
+
+      if (total > 0)
+        {
+          uint32_t tmp;
+
+          tmp = (1000 * (uint64_t)irq) / total;
+          linesize = procfs_snprintf(attr->line, CPULOAD_LINELEN,
+                                     "%3" PRId32 ".%01" PRId32 "%% "
+                                     "(irq %3" PRId32 ".%01" PRId32 "%%)\n",
+                                     intpart, fracpart,
+                                     tmp / 10, tmp % 10);
+        }
+      else
+#endif
+        {
+          linesize = procfs_snprintf(attr->line, CPULOAD_LINELEN,
+                                     "%3" PRId32 ".%01" PRId32 "%%\n",
+                                     intpart, fracpart);
+        }
 
       /* Save the linesize in case we are re-entered with f_pos > 0 */
 
@@ -0,0 +1,450 @@
+/****************************************************************************
+ * fs/procfs/fs_procfscritsites.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_SCHED_CRITMONITOR_HOTSPOT)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define CRITSITES_LINELEN 80
+
+#define CRITSITES_NSITES  CONFIG_SCHED_CRITMONITOR_HOTSPOT_NSITES
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One table as captured when the file was opened */
+
+struct critsites_table_s
+{
+  uint32_t dropped;                          /* Number of replaced sites */
+  int nsites;                                /* Number of valid sites */
+  struct critmon_site_s sites[CRITSITES_NSITES];
+};
+
+/* This structure describes one open "file" */
+
+struct critsites_file_s
+{
+  struct procfs_file_s base;                 /* Base open file structure */
+  struct critsites_table_s premp;            /* Pre-emption disabled */
+  struct critsites_table_s crit;             /* Critical sections */
+  char line[CRITSITES_LINELEN];              /* Buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     critsites_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     critsites_close(FAR struct file *filep);
+static ssize_t critsites_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static ssize_t critsites_write(FAR struct file *filep,
+                 FAR const char *buffer, size_t buflen);
+static int     critsites_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     critsites_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_critsites_operations =
+{
+  critsites_open,     /* open */
+  critsites_close,    /* close */
+  critsites_read,     /* read */
+  critsites_write,    /* write */
+
+  critsites_dup,      /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  critsites_stat      /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: critsites_snapshot
+ *
+ * Description:
+ *   Copy the used entries of one call site table.
+ *
+ ****************************************************************************/
+
+static void critsites_snapshot(FAR struct critsites_table_s *table,
+                               FAR const struct critmon_site_s *sites,
+                               uint32_t dropped)
+{
+  int i;
+
+  table->dropped = dropped;
+  table->nsites  = 0;
+
+  for (i = 0; i < CRITSITES_NSITES; i++)
+    {
+      if (sites[i].caller != NULL)
+        {
+          table->sites[table->nsites++] = sites[i];
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: critsites_rank
+ *
+ * Description:
+ *   Return the index of the n-th most expensive site of a table, ranked by
+ *   the longest region or by the total time.  The tables are small, so a
+ *   selection by counting the more expensive sites is sufficient.
+ *
+ ****************************************************************************/
+
+static int critsites_rank(FAR const struct critsites_table_s *table,
+                          int n, bool bytotal)
+{
+  int i;
+  int j;
+
+  for (i = 0; i < table->nsites; i++)
+    {
+      FAR const struct critmon_site_s *site = &table->sites[i];
+      int rank = 0;
+
+      for (j = 0; j < table->nsites; j++)
+        {
+          FAR const struct critmon_site_s *other = &table->sites[j];
+          uint64_t cost  = bytotal ? site->total : site->max;
+          uint64_t ocost = bytotal ? other->total : other->max;
+
+          /* Ties are broken by the position in the table */
+
+          if (ocost > cost || (ocost == cost && j < i))
+            {
+              rank++;
+            }
+        }
+
+      if (rank == n)
+        {
+          return i;
+        }
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Name: critsites_convert
+ *
+ * Description:
+ *   Convert a 64-bit up_perf_gettime() count to seconds and nanoseconds.
+ *
+ ****************************************************************************/
+
+static void critsites_convert(uint64_t elapsed, FAR unsigned long *sec,
+                              FAR unsigned long *nsec)
+{
+  unsigned long freq = up_perf_getfreq();
+
+  *sec  = elapsed / freq;
+  *nsec = (elapsed % freq) * NSEC_PER_SEC / freq;
+}
+
+/****************************************************************************
+ * Name: critsites_read_table
+ ****************************************************************************/
+
+static size_t critsites_read_table(FAR struct critsites_file_s *attr,
+                                   FAR const struct critsites_table_s *table,
+                                   FAR const char *name, bool bytotal,
+                                   FAR char *buffer, size_t buflen,
+                                   FAR off_t *offset)
+{
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  int n;
+
+  linesize = procfs_snprintf(attr->line, CRITSITES_LINELEN,
+                             "%s by %s (%" PRIu32 " dropped):\n"
+                             "CALLER          COUNT          MAX"
+                             "            TOTAL\n",
+                             name, bytotal ? "total" : "max",
+                             table->dropped);
+  copysize  = procfs_memcpy(attr->line, linesize, buffer, buflen, offset);
+  totalsize = copysize;
+
+  for (n = 0; n < table->nsites && totalsize < buflen; n++)
+    {
+      FAR const struct critmon_site_s *site;
+      unsigned long maxsec;
+      unsigned long maxnsec;
+      unsigned long totsec;
+      unsigned long totnsec;
+
+      site = &table->sites[critsites_rank(table, n, bytotal)];
+      critsites_convert(site->max, &maxsec, &maxnsec);
+      critsites_convert(site->total, &totsec, &totnsec);
+
+      linesize = procfs_snprintf(attr->line, CRITSITES_LINELEN,
+                                 "%p %10" PRIu32 " %lu.%09lu %lu.%09lu\n",
+                                 site->caller, site->count,
+                                 maxsec, maxnsec, totsec, totnsec);
+      copysize = procfs_memcpy(attr->line, linesize, buffer + totalsize,
+                               buflen - totalsize, offset);
+
+      totalsize += copysize;
+    }
+
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: critsites_open
+ ****************************************************************************/
+
+static int critsites_open(FAR struct file *filep, FAR const char *relpath,
+                          int oflags, mode_t mode)
+{
+  FAR struct critsites_file_s *attr;
+  irqstate_t flags;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* Writing clears the tables, reading reports them */
+
+  if ((oflags & O_RDWR) == 0)
+    {
+      ferr("ERROR: No read or write access requested\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = kmm_zalloc(sizeof(struct critsites_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Take a consistent snapshot, so that the output of successive reads
+   * belongs together.
+   */
+
+  flags = enter_critical_section();
+  critsites_snapshot(&attr->premp, g_premp_sites, g_premp_sites_dropped);
+  critsites_snapshot(&attr->crit, g_crit_sites, g_crit_sites_dropped);
+  leave_critical_section(flags);
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: critsites_close
+ ****************************************************************************/
+
+static int critsites_close(FAR struct file *filep)
+{
+  FAR struct critsites_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct critsites_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: critsites_read
+ ****************************************************************************/
+
+static ssize_t critsites_read(FAR struct file *filep, FAR char *buffer,
+                              size_t buflen)
+{
+  FAR struct critsites_file_s *attr;
+  off_t offset;
+  size_t ret;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct critsites_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  offset = filep->f_pos;
+
+  ret  = critsites_read_table(attr, &attr->crit, "csection", false,
+                              buffer, buflen, &offset);
+  ret += critsites_read_table(attr, &attr->crit, "csection", true,
+                              buffer + ret, buflen - ret, &offset);
+  ret += critsites_read_table(attr, &attr->premp, "preemption", false,
+                              buffer + ret, buflen - ret, &offset);
+  ret += critsites_read_table(attr, &attr->premp, "preemption", true,
+                              buffer + ret, buflen - ret, &offset);
+
+  filep->f_pos += ret;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: critsites_write
+ *
+ * Description:
+ *   Clear both call site tables.  The data written is ignored.
+ *
+ ****************************************************************************/
+
+static ssize_t critsites_write(FAR struct file *filep,
+                               FAR const char *buffer, size_t buflen)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  memset(g_premp_sites, 0, sizeof(g_premp_sites));
+  memset(g_crit_sites, 0, sizeof(g_crit_sites));
+  g_premp_sites_dropped = 0;
+  g_crit_sites_dropped  = 0;
+  leave_critical_section(flags);
+
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: critsites_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int critsites_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct critsites_file_s *oldattr;
+  FAR struct critsites_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct critsites_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = kmm_malloc(sizeof(struct critsites_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct critsites_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: critsites_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int critsites_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "critsites" is a regular file that is cleared by writing to it */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_SCHED_CRITMONITOR_HOTSPOT */
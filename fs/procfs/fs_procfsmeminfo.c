@@ -69,6 +69,10 @@ struct meminfo_file_s
   struct procfs_file_s base;      /* Base open file structure */
   unsigned int linesize;          /* Number of valid characters in line[] */
   char line[MEMINFO_LINELEN];     /* Pre-allocated buffer for formatted lines */
+#ifdef CONFIG_FS_PROCFS_MEMINFO_OWNER
+  int npids;                      /* Number of entries in pid[] */
+  pid_t pid[CONFIG_FS_PROCFS_MAX_TASKS];
+#endif
 };
 
 #if defined(CONFIG_ARCH_HAVE_PROGMEM) && defined(CONFIG_FS_PROCFS_INCLUDE_PROGMEM)
@@ -219,6 +223,22 @@ static void meminfo_progmem(FAR struct progmem_info_s *progmem)
 }
 #endif
 
+/****************************************************************************
+ * Name: meminfo_enum
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_PROCFS_MEMINFO_OWNER
+static void meminfo_enum(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  FAR struct meminfo_file_s *procfile = arg;
+
+  if (procfile->npids < CONFIG_FS_PROCFS_MAX_TASKS)
+    {
+      procfile->pid[procfile->npids++] = tcb->pid;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: meminfo_open
  ****************************************************************************/
@@ -239,6 +259,12 @@ static int meminfo_open(FAR struct file *filep, FAR const char *relpath,
       return -ENOMEM;
     }
 
+#ifdef CONFIG_FS_PROCFS_MEMINFO_OWNER
+  /* Take the list of owners now so that all reads show the same tasks */
+
+  nxsched_foreach(meminfo_enum, procfile);
+#endif
+
   /* Save the attributes as the open-specific state in filep->f_priv */
 
   filep->f_priv = procfile;
@@ -329,6 +355,124 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
         }
     }
 
+#ifdef CONFIG_MM_HEAP_FRAGINFO
+  /* Followed by the low watermark, the fragmentation and the free chunk
+   * histogram of each heap.  The histogram lists the lower size bound and
+   * the number of free chunks of each bin that is not empty.
+   */
+
+  for (entry = g_procfs_meminfo; entry != NULL; entry = entry->next)
+    {
+      if (buflen > 0)
+        {
+          struct mm_fraginfo_s finfo;
+          int ndx;
+
+          buffer    += copysize;
+          buflen    -= copysize;
+
+          mm_fraginfo(entry->heap, &finfo);
+          linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                       "%12s: lowfree %lu frag %u.%u%%"
+                                       " bins",
+                                       entry->name,
+                                       (unsigned long)finfo.lowfree,
+                                       finfo.fragindex / 10,
+                                       finfo.fragindex % 10);
+
+          for (ndx = 0; ndx < finfo.nbins; ndx++)
+            {
+              unsigned long binsize = 1ul << (finfo.minshift + ndx);
+
+              if (finfo.nchunks[ndx] == 0)
+                {
+                  continue;
+                }
+
+              linesize += procfs_snprintf(procfile->line + linesize,
+                                          MEMINFO_LINELEN - linesize,
+                                          binsize >= 1024 ?
+                                          " %luk:%lu" : " %lu:%lu",
+                                          binsize >= 1024 ?
+                                          binsize >> 10 : binsize,
+                                          (unsigned long)
+                                          finfo.nchunks[ndx]);
+            }
+
+          linesize  += procfs_snprintf(procfile->line + linesize,
+                                       MEMINFO_LINELEN - linesize, "\n");
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+        }
+    }
+#endif
+
+#ifdef CONFIG_FS_PROCFS_MEMINFO_OWNER
+  /* Followed by the memory that each task holds in each heap, and the
+   * memory of the tasks that have exited.  With the heap mempool the
+   * blocks served by the pools are counted for their owners, so the sum
+   * may be less than 'used', which includes the pool chunks.
+   */
+
+  for (entry = g_procfs_meminfo; entry != NULL; entry = entry->next)
+    {
+      int i;
+
+      for (i = 0; i <= procfile->npids && buflen > 0; i++)
+        {
+          struct mallinfo_task info;
+          struct malltask task;
+          FAR const char *name;
+
+          if (i < procfile->npids)
+            {
+              FAR struct tcb_s *tcb;
+
+              task.pid = procfile->pid[i];
+              tcb = nxsched_get_tcb(task.pid);
+              if (tcb == NULL)
+                {
+                  continue;
+                }
+
+#if CONFIG_TASK_NAME_SIZE > 0
+              name = tcb->name;
+#else
+              name = "";
+#endif
+            }
+          else
+            {
+              task.pid = PID_MM_LEAK;
+              name     = "(exited)";
+            }
+
+          task.seqmin = 0;
+          task.seqmax = ULONG_MAX;
+          info = mm_mallinfo_task(entry->heap, &task);
+          if (info.aordblks == 0)
+            {
+              continue;
+            }
+
+          buffer    += copysize;
+          buflen    -= copysize;
+
+          linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                       "%12s:%6d %-16s%11lu%7lu\n",
+                                       entry->name,
+                                       i < procfile->npids ? task.pid : -1,
+                                       name,
+                                       (unsigned long)info.uordblks,
+                                       (unsigned long)info.aordblks);
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+        }
+    }
+#endif
+
 #ifdef CONFIG_MM_PGALLOC
   if (buflen > 0)
     {
@@ -689,4 +833,43 @@ void procfs_unregister_meminfo(FAR struct procfs_meminfo_entry_s *entry)
         }
     }
 }
+
+/****************************************************************************
+ * Name: procfs_meminfo_snapshot
+ *
+ * Description:
+ *   Return the statistics of the heaps registered for meminfo in binary
+ *   form, for /proc/stat.bin.
+ *
+ ****************************************************************************/
+
+size_t procfs_meminfo_snapshot(FAR struct procfs_statbin_heap_s *heaps,
+                               size_t nheaps)
+{
+  FAR const struct procfs_meminfo_entry_s *entry;
+  struct mallinfo minfo;
+  size_t count = 0;
+
+  for (entry = g_procfs_meminfo; entry != NULL; entry = entry->next)
+    {
+      if (heaps != NULL && count < nheaps)
+        {
+          FAR struct procfs_statbin_heap_s *heap = &heaps[count];
+
+          minfo = mm_mallinfo(entry->heap);
+
+          strlcpy(heap->name, entry->name, sizeof(heap->name));
+          heap->arena    = minfo.arena;
+          heap->uordblks = minfo.uordblks;
+          heap->fordblks = minfo.fordblks;
+          heap->mxordblk = minfo.mxordblk;
+          heap->aordblks = minfo.aordblks;
+          heap->ordblks  = minfo.ordblks;
+        }
+
+      count++;
+    }
+
+  return count;
+}
 #endif /* !CONFIG_FS_PROCFS_EXCLUDE_MEMINFO */
@@ -154,7 +154,7 @@ struct proc_envinfo_s
 
 static FAR const char *g_policy[4] =
 {
-  "SCHED_FIFO", "SCHED_RR", "SCHED_SPORADIC"
+  "SCHED_FIFO", "SCHED_RR", "SCHED_SPORADIC", "SCHED_DEADLINE"
 };
 
 /****************************************************************************
@@ -732,7 +732,7 @@ static ssize_t proc_loadavg(FAR struct proc_file_s *procfile,
     {
       uint32_t tmp;
 
-      tmp      = (1000 * cpuload.active) / cpuload.total;
+      tmp      = (1000 * (uint64_t)cpuload.active) / cpuload.total;
       intpart  = tmp / 10;
       fracpart = tmp - 10 * intpart;
     }
@@ -0,0 +1,467 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsstatbin.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/param.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#ifndef CONFIG_FS_PROCFS_EXCLUDE_STATBIN
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Room for the threads that are created between counting the threads and
+ * collecting them.
+ */
+
+#define STATBIN_SPARE_TASKS 4
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct statbin_file_s
+{
+  struct procfs_file_s base;         /* Base open file structure */
+  FAR uint8_t *snapshot;             /* The last snapshot */
+  size_t size;                       /* Size of the snapshot */
+};
+
+/* The state of one collection of the threads */
+
+struct statbin_collect_s
+{
+  FAR struct procfs_statbin_task_s *tasks;
+  size_t ntasks;
+  size_t capacity;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     statbin_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     statbin_close(FAR struct file *filep);
+static ssize_t statbin_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+
+static int     statbin_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+
+static int     statbin_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_statbin_operations =
+{
+  statbin_open,      /* open */
+  statbin_close,     /* close */
+  statbin_read,      /* read */
+  NULL,              /* write */
+
+  statbin_dup,       /* dup */
+
+  NULL,              /* opendir */
+  NULL,              /* closedir */
+  NULL,              /* readdir */
+  NULL,              /* rewinddir */
+
+  statbin_stat       /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: statbin_count
+ ****************************************************************************/
+
+static void statbin_count(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  (*(FAR size_t *)arg)++;
+}
+
+/****************************************************************************
+ * Name: statbin_collect
+ *
+ * Description:
+ *   Record the fields of a thread that can be read at once.  Called in a
+ *   critical section for each thread.
+ *
+ ****************************************************************************/
+
+static void statbin_collect(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  FAR struct statbin_collect_s *collect = arg;
+  FAR struct procfs_statbin_task_s *task;
+
+  if (collect->ntasks >= collect->capacity)
+    {
+      return;
+    }
+
+  task = &collect->tasks[collect->ntasks++];
+
+#if CONFIG_TASK_NAME_SIZE > 0
+  strlcpy(task->name, tcb->name, sizeof(task->name));
+#endif
+
+  task->pid          = tcb->pid;
+  task->group        = tcb->group != NULL ? tcb->group->tg_pid : tcb->pid;
+  task->flags        = tcb->flags;
+  task->state        = tcb->task_state;
+  task->priority     = tcb->sched_priority;
+  task->basepriority = tcb->base_priority;
+  task->stacksize    = tcb->adj_stack_size;
+}
+
+/****************************************************************************
+ * Name: statbin_sample
+ *
+ * Description:
+ *   Add the fields of a thread that take longer to compute.  They are
+ *   sampled per thread so that interrupts are not held off for the whole
+ *   collection.
+ *
+ ****************************************************************************/
+
+static void statbin_sample(FAR struct procfs_statbin_task_s *task)
+{
+#ifdef CONFIG_SCHED_CPULOAD
+  struct cpuload_s cpuload;
+#endif
+#ifdef CONFIG_STACK_COLORATION
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  tcb = nxsched_get_tcb(task->pid);
+  if (tcb != NULL)
+    {
+      task->stackused = up_check_tcbstack(tcb);
+    }
+
+  leave_critical_section(flags);
+#endif
+
+#ifdef CONFIG_SCHED_CPULOAD
+  if (clock_cpuload(task->pid, &cpuload) >= 0)
+    {
+      task->cputotal  = cpuload.total;
+      task->cpuactive = cpuload.active;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: statbin_snapshot
+ *
+ * Description:
+ *   Replace the snapshot of an open file with a new one.
+ *
+ ****************************************************************************/
+
+static int statbin_snapshot(FAR struct statbin_file_s *attr)
+{
+  FAR struct procfs_statbin_hdr_s *hdr;
+  FAR struct procfs_statbin_heap_s *heaps;
+  struct statbin_collect_s collect;
+  FAR uint8_t *snapshot;
+  size_t nheaps = 0;
+  size_t ntasks = 0;
+  size_t i;
+
+  /* Size the snapshot */
+
+#ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMINFO
+  nheaps = procfs_meminfo_snapshot(NULL, 0);
+#endif
+  nxsched_foreach(statbin_count, &ntasks);
+  ntasks += STATBIN_SPARE_TASKS;
+
+  snapshot = kmm_zalloc(sizeof(struct procfs_statbin_hdr_s) +
+                        nheaps * sizeof(struct procfs_statbin_heap_s) +
+                        ntasks * sizeof(struct procfs_statbin_task_s));
+  if (snapshot == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  hdr   = (FAR struct procfs_statbin_hdr_s *)snapshot;
+  heaps = (FAR struct procfs_statbin_heap_s *)(hdr + 1);
+
+#ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMINFO
+  nheaps = MIN(nheaps, procfs_meminfo_snapshot(heaps, nheaps));
+#endif
+
+  /* Collect the threads in one pass, then complete them one by one */
+
+  collect.tasks    = (FAR struct procfs_statbin_task_s *)(heaps + nheaps);
+  collect.ntasks   = 0;
+  collect.capacity = MIN(ntasks, UINT16_MAX);
+
+  hdr->uptime = clock_systime_ticks();
+  nxsched_foreach(statbin_collect, &collect);
+
+  for (i = 0; i < collect.ntasks; i++)
+    {
+      statbin_sample(&collect.tasks[i]);
+    }
+
+  hdr->magic       = PROCFS_STATBIN_MAGIC;
+  hdr->version     = PROCFS_STATBIN_VERSION;
+  hdr->hdrsize     = sizeof(struct procfs_statbin_hdr_s);
+  hdr->heapsize    = sizeof(struct procfs_statbin_heap_s);
+  hdr->tasksize    = sizeof(struct procfs_statbin_task_s);
+  hdr->nheaps      = nheaps;
+  hdr->ntasks      = collect.ntasks;
+  hdr->tickspersec = CLOCKS_PER_SEC;
+
+  if (attr->snapshot != NULL)
+    {
+      kmm_free(attr->snapshot);
+    }
+
+  attr->snapshot = snapshot;
+  attr->size     = (FAR uint8_t *)(collect.tasks + collect.ntasks) -
+                   snapshot;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: statbin_open
+ ****************************************************************************/
+
+static int statbin_open(FAR struct file *filep, FAR const char *relpath,
+                        int oflags, mode_t mode)
+{
+  FAR struct statbin_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = kmm_zalloc(sizeof(struct statbin_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: statbin_close
+ ****************************************************************************/
+
+static int statbin_close(FAR struct file *filep)
+{
+  FAR struct statbin_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct statbin_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the snapshot and the file attributes structure */
+
+  if (attr->snapshot != NULL)
+    {
+      kmm_free(attr->snapshot);
+    }
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: statbin_read
+ *
+ * Description:
+ *   A read at offset zero takes a new snapshot; the following reads return
+ *   the rest of it.  A poller can keep the file open and read it from the
+ *   start with pread() each time.
+ *
+ ****************************************************************************/
+
+static ssize_t statbin_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct statbin_file_s *attr;
+  off_t offset;
+  ssize_t ret;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct statbin_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  if (filep->f_pos == 0)
+    {
+      ret = statbin_snapshot(attr);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (attr->snapshot == NULL)
+    {
+      return 0;
+    }
+
+  /* Transfer the snapshot to user receive buffer */
+
+  offset = filep->f_pos;
+  ret = procfs_memcpy((FAR const char *)attr->snapshot, attr->size,
+                      buffer, buflen, &offset);
+
+  /* Update the file offset */
+
+  if (ret > 0)
+    {
+      filep->f_pos += ret;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: statbin_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int statbin_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct statbin_file_s *oldattr;
+  FAR struct statbin_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct statbin_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = kmm_zalloc(sizeof(struct statbin_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The new file gets its own copy of the snapshot */
+
+  if (oldattr->snapshot != NULL)
+    {
+      newattr->snapshot = kmm_malloc(oldattr->size);
+      if (newattr->snapshot == NULL)
+        {
+          kmm_free(newattr);
+          return -ENOMEM;
+        }
+
+      memcpy(newattr->snapshot, oldattr->snapshot, oldattr->size);
+      newattr->size = oldattr->size;
+    }
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: statbin_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int statbin_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "stat.bin" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* CONFIG_FS_PROCFS_EXCLUDE_STATBIN */
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
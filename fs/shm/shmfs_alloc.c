@@ -25,9 +25,47 @@
 #include <stdbool.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/pgalloc.h>
+#include <nuttx/mm/mm.h>
 
 #include "shm/shmfs.h"
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_SHMFS_HEAP
+/* The heap of the shared memory, created by the first allocation */
+
+static FAR struct mm_heap_s *g_shmfs_heap;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shmfs_heap
+ *
+ * Description:
+ *   Return the heap of the shared memory.  Called with the inode lock held,
+ *   which serializes the creation of the heap.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_SHMFS_HEAP
+static FAR struct mm_heap_s *shmfs_heap(void)
+{
+  if (g_shmfs_heap == NULL)
+    {
+      g_shmfs_heap = mm_initialize("shmfs",
+                                   (FAR void *)CONFIG_FS_SHMFS_HEAP_BASE,
+                                   CONFIG_FS_SHMFS_HEAP_SIZE);
+    }
+
+  return g_shmfs_heap;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -37,7 +75,30 @@ FAR struct shmfs_object_s *shmfs_alloc_object(size_t length)
   FAR struct shmfs_object_s *object;
   bool allocated = false;
 
-#if defined(CONFIG_BUILD_FLAT)
+#if defined(CONFIG_FS_SHMFS_HEAP)
+  /* With a dedicated heap, allocate the shm object in kernel heap and the
+   * shared memory in the dedicated heap.  The memory has the same address
+   * in every task.
+   */
+
+  FAR struct mm_heap_s *heap;
+
+  object = kmm_zalloc(sizeof(struct shmfs_object_s));
+  if (object)
+    {
+      heap = shmfs_heap();
+      if (heap)
+        {
+          object->paddr = mm_zalloc(heap, length);
+        }
+
+      if (object->paddr)
+        {
+          allocated = true;
+        }
+    }
+
+#elif defined(CONFIG_BUILD_FLAT)
   /* in FLAT build, allocate the object metadata and the data in the same
    * chunk in kernel heap
    */
@@ -121,7 +182,12 @@ void shmfs_free_object(FAR struct shmfs_object_s *object)
 
   if (object)
     {
-#if defined (CONFIG_BUILD_PROTECTED)
+#if defined(CONFIG_FS_SHMFS_HEAP)
+      if (object->paddr)
+        {
+          mm_free(g_shmfs_heap, object->paddr);
+        }
+#elif defined (CONFIG_BUILD_PROTECTED)
       kumm_free(object->paddr);
 #elif defined(CONFIG_BUILD_KERNEL)
       pages = &object->paddr;
@@ -33,6 +33,8 @@
 
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/fs/smart.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -326,6 +328,12 @@ struct smartfs_mountpt_s
   FAR char                     *fs_rwbuffer;   /* Read/Write working buffer */
   FAR char                     *fs_workbuffer; /* Working buffer */
   uint8_t                       fs_rootsector; /* Root directory sector num */
+#ifdef CONFIG_SMARTFS_IDLE_GC
+  struct work_s                 fs_gcwork;     /* Background collection */
+  sem_t                         fs_gcstopped;  /* Posted when it has stopped */
+  bool                          fs_gcstop;     /* Stop the collection */
+  unsigned int                  fs_gcblocks;   /* Blocks per interval */
+#endif
 };
 
 /****************************************************************************
@@ -36,6 +36,8 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
@@ -996,9 +998,33 @@ static off_t smartfs_seek(FAR struct file *filep, off_t offset, int whence)
 
 static int smartfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
-  /* We don't use any ioctls */
+  FAR struct smartfs_mountpt_s *fs;
+  int ret;
+
+  DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
+  fs = filep->f_inode->i_private;
+
+  switch (cmd)
+    {
+      case FIOC_GCSTEP:
+        ret = nxmutex_lock(&g_lock);
+        if (ret >= 0)
+          {
+            ret = FS_IOCTL(fs, BIOC_IDLECOLLECT, arg);
+            nxmutex_unlock(&g_lock);
+          }
+
+        return ret;
+
+#ifdef CONFIG_SMARTFS_IDLE_GC
+      case FIOC_GCLIMIT:
+        fs->fs_gcblocks = arg;
+        return OK;
+#endif
 
-  return -ENOSYS;
+      default:
+        return -ENOSYS;
+    }
 }
 
 /****************************************************************************
@@ -1460,6 +1486,83 @@ static int smartfs_rewinddir(FAR struct inode *mountpt,
   return 0;
 }
 
+/****************************************************************************
+ * Name: smartfs_gcworker
+ *
+ * Description: Collect a few erase blocks if no other operation holds the
+ *   file system, then check again after the interval.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMARTFS_IDLE_GC
+static void smartfs_gcworker(FAR void *arg)
+{
+  FAR struct smartfs_mountpt_s *fs = arg;
+  irqstate_t flags;
+  bool stop;
+
+  if (nxmutex_trylock(&g_lock) >= 0)
+    {
+      if (!fs->fs_gcstop && fs->fs_gcblocks > 0)
+        {
+          FS_IOCTL(fs, BIOC_IDLECOLLECT, fs->fs_gcblocks);
+        }
+
+      nxmutex_unlock(&g_lock);
+    }
+
+  /* smartfs_gcstop() waits for us unless the work is queued again */
+
+  flags = enter_critical_section();
+  stop  = fs->fs_gcstop;
+  if (!stop)
+    {
+      work_queue(LPWORK, &fs->fs_gcwork, smartfs_gcworker, fs,
+                 MSEC2TICK(CONFIG_SMARTFS_IDLE_GC_INTERVAL));
+    }
+
+  leave_critical_section(flags);
+
+  if (stop)
+    {
+      nxsem_post(&fs->fs_gcstopped);
+    }
+}
+
+/****************************************************************************
+ * Name: smartfs_gcstart and smartfs_gcstop
+ *
+ * Description: Start and stop the background collection of a mount.
+ *   smartfs_gcstop() must not be called with g_lock held.
+ *
+ ****************************************************************************/
+
+static void smartfs_gcstart(FAR struct smartfs_mountpt_s *fs)
+{
+  fs->fs_gcstop = false;
+  work_queue(LPWORK, &fs->fs_gcwork, smartfs_gcworker, fs,
+             MSEC2TICK(CONFIG_SMARTFS_IDLE_GC_INTERVAL));
+}
+
+static void smartfs_gcstop(FAR struct smartfs_mountpt_s *fs)
+{
+  irqstate_t flags;
+  int ret;
+
+  flags = enter_critical_section();
+  fs->fs_gcstop = true;
+  ret = work_cancel(LPWORK, &fs->fs_gcwork);
+  leave_critical_section(flags);
+
+  if (ret < 0)
+    {
+      /* The worker is running */
+
+      nxsem_wait_uninterruptible(&fs->fs_gcstopped);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: smartfs_bind
  *
@@ -1524,6 +1627,12 @@ static int smartfs_bind(FAR struct inode *blkdriver, FAR const void *data,
       return ret;
     }
 
+#ifdef CONFIG_SMARTFS_IDLE_GC
+  nxsem_init(&fs->fs_gcstopped, 0, 0);
+  fs->fs_gcblocks = CONFIG_SMARTFS_IDLE_GC_BLOCKS;
+  smartfs_gcstart(fs);
+#endif
+
   *handle = fs;
   nxmutex_unlock(&g_lock);
   return OK;
@@ -1548,6 +1657,12 @@ static int smartfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
       return -EINVAL;
     }
 
+#ifdef CONFIG_SMARTFS_IDLE_GC
+  /* Stop the background collection before taking the lock that it uses */
+
+  smartfs_gcstop(fs);
+#endif
+
   /* Check if there are sill any files opened on the filesystem. */
 
   ret = OK; /* Assume success */
@@ -1555,6 +1670,9 @@ static int smartfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
   ret = nxmutex_lock(&g_lock);
   if (ret < 0)
     {
+#ifdef CONFIG_SMARTFS_IDLE_GC
+      smartfs_gcstart(fs);
+#endif
       return ret;
     }
 
@@ -1563,6 +1681,9 @@ static int smartfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
       /* We cannot unmount now.. there are open files */
 
       nxmutex_unlock(&g_lock);
+#ifdef CONFIG_SMARTFS_IDLE_GC
+      smartfs_gcstart(fs);
+#endif
 
       /* This implementation currently only supports unmounting if there are
        * no open file references.
@@ -1578,6 +1699,9 @@ static int smartfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
     }
 
   nxmutex_unlock(&g_lock);
+#ifdef CONFIG_SMARTFS_IDLE_GC
+  nxsem_destroy(&fs->fs_gcstopped);
+#endif
   kmm_free(fs);
   return ret;
 }
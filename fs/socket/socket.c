@@ -32,6 +32,7 @@
 #include <sys/socket.h>
 #include <assert.h>
 #include <fcntl.h>
+#include <string.h>
 #include <errno.h>
 #include <debug.h>
 
@@ -47,6 +48,8 @@ static ssize_t sock_file_read(FAR struct file *filep, FAR char *buffer,
                               size_t buflen);
 static ssize_t sock_file_write(FAR struct file *filep,
                                FAR const char *buffer, size_t buflen);
+static ssize_t sock_file_writev(FAR struct file *filep,
+                                FAR const struct iovec *iov, int iovcnt);
 static int sock_file_ioctl(FAR struct file *filep, int cmd,
                            unsigned long arg);
 static int sock_file_poll(FAR struct file *filep, struct pollfd *fds,
@@ -67,7 +70,12 @@ static const struct file_operations g_sock_fileops =
   sock_file_ioctl,    /* ioctl */
   NULL,               /* mmap */
   sock_file_truncate, /* truncate */
-  sock_file_poll      /* poll */
+  sock_file_poll,     /* poll */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  NULL,               /* unlink */
+#endif
+  NULL,               /* readv */
+  sock_file_writev    /* writev */
 };
 
 static struct inode g_sock_inode =
@@ -129,6 +137,22 @@ static ssize_t sock_file_write(FAR struct file *filep,
   return psock_send(filep->f_priv, buffer, buflen, 0);
 }
 
+static ssize_t sock_file_writev(FAR struct file *filep,
+                                FAR const struct iovec *iov, int iovcnt)
+{
+  struct msghdr msg;
+
+  /* Gather the buffers into one message, so a stream socket can send them
+   * in one segment instead of one per buffer.
+   */
+
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov    = (FAR struct iovec *)iov;
+  msg.msg_iovlen = iovcnt;
+
+  return psock_sendmsg(filep->f_priv, &msg, 0);
+}
+
 static int sock_file_ioctl(FAR struct file *filep, int cmd,
                            unsigned long arg)
 {
@@ -26,6 +26,7 @@
 
 #include <sys/stat.h>
 #include <sys/statfs.h>
+#include <sys/param.h>
 #include <stdint.h>
 #include <string.h>
 #include <fcntl.h>
@@ -49,9 +50,8 @@
 #  warning CONFIG_FS_TMPFS_DIRECTORY_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
-#if CONFIG_FS_TMPFS_FILE_FREEGUARD <= CONFIG_FS_TMPFS_FILE_ALLOCGUARD
-#  warning CONFIG_FS_TMPFS_FILE_FREEGUARD needs to be > ALLOCGUARD
-#endif
+#define TMPFS_PAGESIZE       CONFIG_FS_TMPFS_FILE_PAGESIZE
+#define TMPFS_NPAGES(size)   (((size) + TMPFS_PAGESIZE - 1) / TMPFS_PAGESIZE)
 
 #define tmpfs_lock(fs) \
            nxrmutex_lock(&fs->tfs_lock)
@@ -89,8 +89,14 @@ struct tmpfs_dir_s
 
 static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
               unsigned int nentries);
-static int  tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
+static void tmpfs_free_pages(FAR struct tmpfs_file_s *tfo, size_t npages);
+static int  tmpfs_resize_file(FAR struct tmpfs_file_s *tfo,
               size_t newsize);
+static void tmpfs_copyin(FAR struct tmpfs_file_s *tfo, size_t offset,
+              FAR const uint8_t *buffer, size_t buflen);
+static void tmpfs_copyout(FAR struct tmpfs_file_s *tfo, size_t offset,
+              FAR uint8_t *buffer, size_t buflen);
+static int  tmpfs_coalesce_file(FAR struct tmpfs_file_s *tfo);
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_release_file(FAR struct tmpfs_file_s *tfo);
@@ -258,60 +264,198 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
 }
 
 /****************************************************************************
- * Name: tmpfs_realloc_file
+ * Name: tmpfs_free_pages
+ *
+ * Description:
+ *   Release the pages of a file from 'npages' on.  The pages of the slab
+ *   are only released together, when the file has no pages left.
+ *
  ****************************************************************************/
 
-static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
-                              size_t newsize)
+static void tmpfs_free_pages(FAR struct tmpfs_file_s *tfo, size_t npages)
 {
-  FAR uint8_t *newdata;
-  size_t allocsize;
-  size_t delta;
+  while (tfo->tfo_npages > MAX(npages, tfo->tfo_nslab))
+    {
+      kmm_free(tfo->tfo_pages[--tfo->tfo_npages]);
+      tfo->tfo_alloc -= TMPFS_PAGESIZE;
+    }
+
+  if (npages == 0)
+    {
+      kmm_free(tfo->tfo_slab);
+      kmm_free(tfo->tfo_pages);
+
+      tfo->tfo_alloc    = 0;
+      tfo->tfo_npages   = 0;
+      tfo->tfo_maxpages = 0;
+      tfo->tfo_nslab    = 0;
+      tfo->tfo_pages    = NULL;
+      tfo->tfo_slab     = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_resize_file
+ *
+ * Description:
+ *   Set the size of a file, adding or releasing pages as needed.  The data
+ *   never moves, so growing a file costs a page allocation at most and the
+ *   existing mappings stay valid.  Pages are not released while the file
+ *   is mapped.
+ *
+ ****************************************************************************/
 
-  /* Are we growing or shrinking the object? */
+static int tmpfs_resize_file(FAR struct tmpfs_file_s *tfo,
+                             size_t newsize)
+{
+  FAR uint8_t **newpages;
+  FAR uint8_t *page;
+  size_t npages;
+  size_t maxpages;
 
-  if (newsize <= tfo->tfo_alloc)
+  npages = TMPFS_NPAGES(newsize);
+  if (npages > tfo->tfo_npages)
     {
-      /* Shrinking ... Shrink unconditionally if the size is shrinking to
-       * zero.
+      /* Grow the page table geometrically, so that it is rarely
+       * reallocated.
        */
 
-      if (newsize > 0)
+      if (npages > tfo->tfo_maxpages)
         {
-          /* Otherwise, don't realloc unless the object has shrunk by a
-           * lot.
-           */
-
-          delta = tfo->tfo_alloc - newsize;
-          if (delta <= CONFIG_FS_TMPFS_FILE_FREEGUARD)
+          maxpages = MAX(npages, 2 * tfo->tfo_maxpages);
+          newpages = kmm_realloc(tfo->tfo_pages,
+                                 maxpages * sizeof(FAR uint8_t *));
+          if (newpages == NULL)
             {
-              /* Hasn't shrunk enough.. Return doing nothing for now */
+              return -ENOMEM;
+            }
+
+          tfo->tfo_pages    = newpages;
+          tfo->tfo_maxpages = maxpages;
+        }
 
-              tfo->tfo_size = newsize;
-              return OK;
+      while (tfo->tfo_npages < npages)
+        {
+          page = kmm_malloc(TMPFS_PAGESIZE);
+          if (page == NULL)
+            {
+              return -ENOMEM;
             }
+
+          tfo->tfo_pages[tfo->tfo_npages++] = page;
+          tfo->tfo_alloc += TMPFS_PAGESIZE;
         }
     }
+  else if (tfo->tfo_nmaps == 0)
+    {
+      tmpfs_free_pages(tfo, npages);
+    }
 
-  /* Added some additional amount to the new size to account frequent
-   * reallocations.
-   */
+  tfo->tfo_size = newsize;
+  return OK;
+}
 
-  allocsize = newsize + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
+/****************************************************************************
+ * Name: tmpfs_copyin
+ *
+ * Description:
+ *   Copy data into the pages of a file, or zero them if 'buffer' is NULL.
+ *   The range must be within the file.
+ *
+ ****************************************************************************/
 
-  /* Realloc the file object */
+static void tmpfs_copyin(FAR struct tmpfs_file_s *tfo, size_t offset,
+                         FAR const uint8_t *buffer, size_t buflen)
+{
+  FAR uint8_t *page;
+  size_t nbytes;
 
-  newdata = kmm_realloc(tfo->tfo_data, allocsize);
-  if (newdata == NULL)
+  while (buflen > 0)
+    {
+      page   = tfo->tfo_pages[offset / TMPFS_PAGESIZE] +
+               offset % TMPFS_PAGESIZE;
+      nbytes = MIN(buflen, TMPFS_PAGESIZE - offset % TMPFS_PAGESIZE);
+
+      if (buffer != NULL)
+        {
+          memcpy(page, buffer, nbytes);
+          buffer += nbytes;
+        }
+      else
+        {
+          memset(page, 0, nbytes);
+        }
+
+      offset += nbytes;
+      buflen -= nbytes;
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_copyout
+ *
+ * Description:
+ *   Copy data from the pages of a file.  The range must be within the
+ *   file.
+ *
+ ****************************************************************************/
+
+static void tmpfs_copyout(FAR struct tmpfs_file_s *tfo, size_t offset,
+                          FAR uint8_t *buffer, size_t buflen)
+{
+  size_t nbytes;
+
+  while (buflen > 0)
+    {
+      nbytes = MIN(buflen, TMPFS_PAGESIZE - offset % TMPFS_PAGESIZE);
+      memcpy(buffer, tfo->tfo_pages[offset / TMPFS_PAGESIZE] +
+                     offset % TMPFS_PAGESIZE, nbytes);
+
+      buffer += nbytes;
+      offset += nbytes;
+      buflen -= nbytes;
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_coalesce_file
+ *
+ * Description:
+ *   Move all the pages of a file to one contiguous slab, so that a mapping
+ *   may span several pages.  Only possible while the file is not mapped.
+ *
+ ****************************************************************************/
+
+static int tmpfs_coalesce_file(FAR struct tmpfs_file_s *tfo)
+{
+  FAR uint8_t *slab;
+  size_t i;
+
+  if (tfo->tfo_nmaps > 0)
+    {
+      return -EBUSY;
+    }
+
+  slab = kmm_malloc(tfo->tfo_npages * TMPFS_PAGESIZE);
+  if (slab == NULL)
     {
       return -ENOMEM;
     }
 
-  /* Return the new address of the reallocated file object */
+  for (i = 0; i < tfo->tfo_npages; i++)
+    {
+      memcpy(slab + i * TMPFS_PAGESIZE, tfo->tfo_pages[i], TMPFS_PAGESIZE);
+      if (i >= tfo->tfo_nslab)
+        {
+          kmm_free(tfo->tfo_pages[i]);
+        }
+
+      tfo->tfo_pages[i] = slab + i * TMPFS_PAGESIZE;
+    }
 
-  tfo->tfo_alloc = allocsize;
-  tfo->tfo_size  = newsize;
-  tfo->tfo_data  = newdata;
+  kmm_free(tfo->tfo_slab);
+  tfo->tfo_slab  = slab;
+  tfo->tfo_nslab = tfo->tfo_npages;
   return OK;
 }
 
@@ -352,7 +496,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
     {
       tmpfs_unlock_file(tfo);
       nxrmutex_destroy(&tfo->tfo_lock);
-      kmm_free(tfo->tfo_data);
+      tmpfs_free_pages(tfo, 0);
       kmm_free(tfo);
     }
 
@@ -543,12 +687,17 @@ static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
    * locked with one reference count.
    */
 
-  tfo->tfo_alloc = 0;
-  tfo->tfo_type  = TMPFS_REGULAR;
-  tfo->tfo_refs  = 1;
-  tfo->tfo_flags = 0;
-  tfo->tfo_size  = 0;
-  tfo->tfo_data  = NULL;
+  tfo->tfo_alloc    = 0;
+  tfo->tfo_type     = TMPFS_REGULAR;
+  tfo->tfo_refs     = 1;
+  tfo->tfo_flags    = 0;
+  tfo->tfo_nmaps    = 0;
+  tfo->tfo_size     = 0;
+  tfo->tfo_npages   = 0;
+  tfo->tfo_maxpages = 0;
+  tfo->tfo_nslab    = 0;
+  tfo->tfo_pages    = NULL;
+  tfo->tfo_slab     = NULL;
 
   nxrmutex_init(&tfo->tfo_lock);
   tmpfs_lock_file(tfo);
@@ -1175,7 +1324,7 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
           return TMPFS_UNLINKED;
         }
 
-      kmm_free(tfo->tfo_data);
+      tmpfs_free_pages(tfo, 0);
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
     {
@@ -1348,7 +1497,7 @@ static int tmpfs_open(FAR struct file *filep, FAR const char *relpath,
 
           if (tfo->tfo_size > 0)
             {
-              ret = tmpfs_realloc_file(tfo, 0);
+              ret = tmpfs_resize_file(tfo, 0);
               if (ret < 0)
                 {
                   goto errout_with_filelock;
@@ -1496,15 +1645,8 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Copy data from the memory object to the user buffer */
 
-  if (tfo->tfo_data != NULL)
-    {
-      memcpy(buffer, &tfo->tfo_data[startpos], nread);
-      filep->f_pos += nread;
-    }
-  else
-    {
-      DEBUGASSERT(tfo->tfo_size == 0 && nread == 0);
-    }
+  tmpfs_copyout(tfo, startpos, (FAR uint8_t *)buffer, nread);
+  filep->f_pos += nread;
 
   /* Release the lock on the file */
 
@@ -1523,6 +1665,7 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
   ssize_t nwritten;
   off_t startpos;
   off_t endpos;
+  size_t oldsize;
   int ret;
 
   finfo("filep: %p buffer: %p buflen: %lu\n",
@@ -1549,27 +1692,28 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 
   if (endpos > tfo->tfo_size)
     {
-      /* Reallocate the file to handle the write past the end of the file. */
+      /* Add pages to handle the write past the end of the file. */
 
-      ret = tmpfs_realloc_file(tfo, (size_t)endpos);
+      oldsize = tfo->tfo_size;
+      ret = tmpfs_resize_file(tfo, (size_t)endpos);
       if (ret < 0)
         {
           goto errout_with_lock;
         }
-    }
 
-  /* Copy data from the memory object to the user buffer */
+      /* A write beyond the end of the file leaves a hole of zeroes */
 
-  if (tfo->tfo_data != NULL)
-    {
-      memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
-      filep->f_pos += nwritten;
-    }
-  else
-    {
-      DEBUGASSERT(tfo->tfo_size == 0 && nwritten == 0);
+      if (startpos > oldsize)
+        {
+          tmpfs_copyin(tfo, oldsize, NULL, startpos - oldsize);
+        }
     }
 
+  /* Copy data from the user buffer to the memory object */
+
+  tmpfs_copyin(tfo, startpos, (FAR const uint8_t *)buffer, nwritten);
+  filep->f_pos += nwritten;
+
   /* Release the lock on the file */
 
   tmpfs_unlock_file(tfo);
@@ -1654,7 +1798,12 @@ static int tmpfs_unmap(FAR struct task_group_s *group,
       ret = mm_map_remove(get_group_mm(group), entry);
       if (ret >= 0)
         {
-          ret = tmpfs_release_file(tfo);
+          ret = tmpfs_lock_file(tfo);
+          if (ret >= 0)
+            {
+              tfo->tfo_nmaps--;
+              tmpfs_release_lockedfile(tfo);
+            }
         }
     }
 
@@ -1666,7 +1815,7 @@ static int tmpfs_unmap(FAR struct task_group_s *group,
     {
       entry->length = offset;
       tmpfs_lock_file(tfo);
-      ret = tmpfs_realloc_file(tfo, offset);
+      ret = tmpfs_resize_file(tfo, offset);
       tmpfs_unlock_file(tfo);
     }
 
@@ -1676,7 +1825,9 @@ static int tmpfs_unmap(FAR struct task_group_s *group,
 static int tmpfs_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
 {
   FAR struct tmpfs_file_s *tfo;
-  int ret = -EINVAL;
+  size_t first;
+  size_t last;
+  int ret;
 
   DEBUGASSERT(filep->f_priv != NULL);
 
@@ -1686,22 +1837,56 @@ static int tmpfs_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
 
   DEBUGASSERT(tfo != NULL);
 
-  if (map->offset >= 0 && map->offset < tfo->tfo_size &&
-      map->length && map->offset + map->length <= tfo->tfo_size)
+  ret = tmpfs_lock_file(tfo);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (map->offset < 0 || map->offset >= tfo->tfo_size ||
+      map->length == 0 || map->offset + map->length > tfo->tfo_size)
     {
-      map->vaddr = tfo->tfo_data + map->offset;
-      map->priv.p = tfo;
-      map->munmap = tmpfs_unmap;
-      ret = mm_map_add(get_current_mm(), map);
+      ret = -EINVAL;
+      goto errout_with_lock;
+    }
 
-      if (ret >= 0)
+  /* The file data is mapped in place.  A range within one page or within
+   * the slab is contiguous already; otherwise the pages are moved to a new
+   * slab first.
+   */
+
+  first = map->offset / TMPFS_PAGESIZE;
+  last  = (map->offset + map->length - 1) / TMPFS_PAGESIZE;
+
+  if (first == last)
+    {
+      map->vaddr = tfo->tfo_pages[first] + map->offset % TMPFS_PAGESIZE;
+    }
+  else
+    {
+      if (last >= tfo->tfo_nslab)
         {
-          tmpfs_lock_file(tfo);
-          tfo->tfo_refs++;
-          tmpfs_unlock_file(tfo);
+          ret = tmpfs_coalesce_file(tfo);
+          if (ret < 0)
+            {
+              goto errout_with_lock;
+            }
         }
+
+      map->vaddr = tfo->tfo_slab + map->offset;
     }
 
+  map->priv.p = tfo;
+  map->munmap = tmpfs_unmap;
+  ret = mm_map_add(get_current_mm(), map);
+  if (ret >= 0)
+    {
+      tfo->tfo_refs++;
+      tfo->tfo_nmaps++;
+    }
+
+errout_with_lock:
+  tmpfs_unlock_file(tfo);
   return ret;
 }
 
@@ -1824,9 +2009,9 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
   oldsize = tfo->tfo_size;
   if (oldsize != length)
     {
-      /* The size is changing.. up or down.  Reallocate the file memory. */
+      /* The size is changing.. up or down.  Add or release pages. */
 
-      ret = tmpfs_realloc_file(tfo, (size_t)length);
+      ret = tmpfs_resize_file(tfo, (size_t)length);
       if (ret < 0)
         {
           goto errout_with_lock;
@@ -1838,7 +2023,7 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
 
       if (length > oldsize)
         {
-          memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
+          tmpfs_copyin(tfo, oldsize, NULL, length - oldsize);
         }
 
       ret = OK;
@@ -2282,7 +2467,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   else
     {
       nxrmutex_destroy(&tfo->tfo_lock);
-      kmm_free(tfo->tfo_data);
+      tmpfs_free_pages(tfo, 0);
       kmm_free(tfo);
     }
 
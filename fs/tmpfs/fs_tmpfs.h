@@ -119,11 +119,20 @@ struct tmpfs_file_s
   uint8_t  tfo_type;     /* See enum tmpfs_objtype_e */
   uint8_t  tfo_refs;     /* Reference count */
 
-  /* Remaining fields are unique to a directory object */
-
-  uint8_t       tfo_flags; /* See TFO_FLAG_* definitions */
-  size_t        tfo_size;  /* Valid file size */
-  FAR uint8_t  *tfo_data;  /* File data starts here */
+  /* Remaining fields are unique to a file object.  The data is held in
+   * pages of CONFIG_FS_TMPFS_FILE_PAGESIZE bytes, so that a growing file
+   * never moves.  The first tfo_nslab pages are carved from one contiguous
+   * allocation, made when a mapping spans several pages.
+   */
+
+  uint8_t       tfo_flags;    /* See TFO_FLAG_* definitions */
+  uint16_t      tfo_nmaps;    /* Number of mappings of the file */
+  size_t        tfo_size;     /* Valid file size */
+  size_t        tfo_npages;   /* Number of allocated pages */
+  size_t        tfo_maxpages; /* Capacity of tfo_pages */
+  size_t        tfo_nslab;    /* Number of pages in tfo_slab */
+  FAR uint8_t **tfo_pages;    /* The pages, in file order */
+  FAR uint8_t  *tfo_slab;     /* Contiguous memory of the first pages */
 };
 
 /* This structure represents one instance of a TMPFS file system */
@@ -35,6 +35,7 @@
 
 #include <nuttx/clock.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/list.h>
 #include <nuttx/mutex.h>
@@ -46,9 +47,14 @@
  * Private Types
  ****************************************************************************/
 
+struct epoll_head_s;
+
 struct epoll_node_s
 {
   struct list_node      node;
+  struct list_node      rnode;    /* Links the node in the ready list */
+  FAR struct epoll_head_s *eph;   /* The epoll instance of the node */
+  bool                  notified; /* The node is in the ready list */
   epoll_data_t          data;
   struct pollfd         pfd;
 };
@@ -64,10 +70,18 @@ struct epoll_head_s
   struct list_node      setup;    /* The setup list, store all the setuped
                                    * epoll node.
                                    */
-  struct list_node      teardown; /* The teardown list, store all the epoll
-                                   * node notified after epoll_wait finish,
-                                   * these epoll node should be setup again
-                                   * to check the pending poll notification.
+  struct list_node      teardown; /* The teardown list, store all the level
+                                   * triggered epoll node notified after
+                                   * epoll_wait finish, these epoll node
+                                   * should be setup again to check the
+                                   * pending poll notification.
+                                   */
+  struct list_node      ready;    /* The ready list, store the setuped epoll
+                                   * node notified by the drivers, in the
+                                   * order of notification.  It is modified
+                                   * by the poll callbacks, so it is
+                                   * protected by a critical section, not by
+                                   * the lock.
                                    */
   struct list_node      oneshot;  /* The oneshot list, store all the epoll
                                    * node notified after epoll_wait and with
@@ -131,6 +145,78 @@ static struct inode g_epoll_inode =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: epoll_default_cb
+ *
+ * Description:
+ *   The poll callback of the epoll nodes.  Called by poll_notify(), maybe
+ *   from an interrupt handler: queue the node in the ready list and wake
+ *   up epoll_wait().
+ *
+ ****************************************************************************/
+
+static void epoll_default_cb(FAR struct pollfd *fds)
+{
+  FAR epoll_node_t *epn = (FAR epoll_node_t *)fds->arg;
+  FAR epoll_head_t *eph = epn->eph;
+  irqstate_t flags;
+  int semcount = 0;
+
+  flags = enter_critical_section();
+  if (!epn->notified)
+    {
+      epn->notified = true;
+      list_add_tail(&eph->ready, &epn->rnode);
+    }
+
+  leave_critical_section(flags);
+
+  nxsem_get_value(&eph->sem, &semcount);
+  if (semcount < 1)
+    {
+      nxsem_post(&eph->sem);
+    }
+}
+
+/****************************************************************************
+ * Name: epoll_unready
+ *
+ * Description:
+ *   Remove a node that has been torn down from the ready list.
+ *
+ ****************************************************************************/
+
+static void epoll_unready(FAR epoll_head_t *eph, FAR epoll_node_t *epn)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if (epn->notified)
+    {
+      epn->notified = false;
+      list_delete(&epn->rnode);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: epoll_isready
+ *
+ * Description:
+ *   Return true if events are pending, so that epoll_wait() need not wait.
+ *   Stale posts of the semaphore are consumed first: an event notified
+ *   after the check posts it again.
+ *
+ ****************************************************************************/
+
+static bool epoll_isready(FAR epoll_head_t *eph)
+{
+  while (nxsem_trywait(&eph->sem) >= 0);
+
+  return !list_is_empty(&eph->ready);
+}
+
 static FAR epoll_head_t *epoll_head_from_fd(int fd)
 {
   FAR struct file *filep;
@@ -238,6 +324,7 @@ static int epoll_do_create(int size, int flags)
 
   list_initialize(&eph->setup);
   list_initialize(&eph->teardown);
+  list_initialize(&eph->ready);
   list_initialize(&eph->oneshot);
   list_initialize(&eph->extend);
   list_initialize(&eph->free);
@@ -300,31 +387,54 @@ static int epoll_setup(FAR epoll_head_t *eph)
 static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
                           int maxevents)
 {
-  FAR epoll_node_t *tepn;
   FAR epoll_node_t *epn;
+  pollevent_t revents;
+  irqstate_t flags;
   int i = 0;
 
   nxmutex_lock(&eph->lock);
 
-  list_for_every_entry_safe(&eph->setup, epn, tepn, epoll_node_t, node)
+  /* Only the notified nodes are visited.  Edge triggered nodes stay setup
+   * and are queued again by their next notification; the others are torn
+   * down and setup again by the next epoll_wait(), which queues them again
+   * if they are still ready.
+   */
+
+  flags = enter_critical_section();
+  while (i < maxevents && !list_is_empty(&eph->ready))
     {
-      if (epn->pfd.revents != 0 && i < maxevents)
+      epn = container_of(list_remove_head(&eph->ready), epoll_node_t,
+                         rnode);
+      epn->notified    = false;
+      revents          = epn->pfd.revents;
+      epn->pfd.revents = 0;
+      leave_critical_section(flags);
+
+      if (revents != 0)
         {
           evs[i].data     = epn->data;
-          evs[i++].events = epn->pfd.revents;
-          poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
-          list_delete(&epn->node);
-          if ((epn->pfd.events & EPOLLONESHOT) != 0)
-            {
-              list_add_tail(&eph->oneshot, &epn->node);
-            }
-          else
+          evs[i++].events = revents;
+
+          if ((epn->pfd.events & (EPOLLET | EPOLLONESHOT)) != EPOLLET)
             {
-              list_add_tail(&eph->teardown, &epn->node);
+              poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
+              epoll_unready(eph, epn);
+              list_delete(&epn->node);
+              if ((epn->pfd.events & EPOLLONESHOT) != 0)
+                {
+                  list_add_tail(&eph->oneshot, &epn->node);
+                }
+              else
+                {
+                  list_add_tail(&eph->teardown, &epn->node);
+                }
             }
         }
+
+      flags = enter_critical_section();
     }
 
+  leave_critical_section(flags);
   nxmutex_unlock(&eph->lock);
   return i;
 }
@@ -475,9 +585,11 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
         epn->data        = ev->data;
         epn->pfd.events  = ev->events;
         epn->pfd.fd      = fd;
-        epn->pfd.arg     = &eph->sem;
-        epn->pfd.cb      = poll_default_cb;
+        epn->pfd.arg     = epn;
+        epn->pfd.cb      = epoll_default_cb;
         epn->pfd.revents = 0;
+        epn->eph         = eph;
+        epn->notified    = false;
 
         ret = poll_fdsetup(fd, &epn->pfd, true);
         if (ret < 0)
@@ -496,6 +608,7 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
             if (epn->pfd.fd == fd)
               {
                 poll_fdsetup(fd, &epn->pfd, false);
+                epoll_unready(eph, epn);
                 list_delete(&epn->node);
                 list_add_tail(&eph->free, &epn->node);
                 goto out;
@@ -533,6 +646,7 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
                 if (epn->pfd.events != ev->events)
                   {
                     poll_fdsetup(fd, &epn->pfd, false);
+                    epoll_unready(eph, epn);
 
                     epn->data        = ev->data;
                     epn->pfd.events  = ev->events;
@@ -640,7 +754,7 @@ int epoll_pwait(int epfd, FAR struct epoll_event *evs,
 
   nxsig_procmask(SIG_SETMASK, sigmask, &oldsigmask);
 
-  if (timeout == 0)
+  if (timeout == 0 || epoll_isready(eph))
     {
       ret = OK;
     }
@@ -712,7 +826,7 @@ int epoll_wait(int epfd, FAR struct epoll_event *evs,
 
   /* Wait the poll ready */
 
-  if (timeout == 0)
+  if (timeout == 0 || epoll_isready(eph))
     {
       ret = OK;
     }
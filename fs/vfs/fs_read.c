@@ -32,6 +32,7 @@
 #include <errno.h>
 
 #include <nuttx/cancelpt.h>
+#include <nuttx/trace.h>
 
 #include "inode/inode.h"
 
@@ -89,9 +90,11 @@ ssize_t file_read(FAR struct file *filep, FAR void *buf, size_t nbytes)
        * signature and position in the operations vtable.
        */
 
+      fs_trace_begin();
       ret = (int)inode->u.i_ops->read(filep,
                                      (FAR char *)buf,
                                      (size_t)nbytes);
+      fs_trace_end();
     }
 
   /* Return the number of bytes read (or possibly an error code) */
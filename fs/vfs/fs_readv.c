@@ -0,0 +1,215 @@
+/****************************************************************************
+ * fs/vfs/fs_readv.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+
+#include "inode/inode.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_readv
+ *
+ * Description:
+ *   file_readv() is an internal OS interface.  It is functionally similar
+ *   to the standard readv() interface except:
+ *
+ *    - It does not modify the errno variable,
+ *    - It is not a cancellation point,
+ *    - It accepts a file structure instance instead of file descriptor.
+ *
+ *   Drivers that provide the readv method fill all the buffers in one
+ *   transaction.  Otherwise each buffer is filled with file_read() in turn,
+ *   as far as the data goes.
+ *
+ * Input Parameters:
+ *   filep  - File structure instance
+ *   iov    - The buffers to fill, in order
+ *   iovcnt - Number of buffers
+ *
+ * Returned Value:
+ *   The number of bytes read on success, 0 on an end-of-file condition, or
+ *   a negated errno value if nothing could be read.
+ *
+ ****************************************************************************/
+
+ssize_t file_readv(FAR struct file *filep, FAR const struct iovec *iov,
+                   int iovcnt)
+{
+  FAR struct inode *inode;
+  FAR uint8_t *buffer;
+  size_t remaining;
+  ssize_t ntotal;
+  ssize_t nread;
+  int i;
+
+  DEBUGASSERT(filep);
+  inode = filep->f_inode;
+
+  if (iovcnt < 0 || (iov == NULL && iovcnt > 0))
+    {
+      return -EINVAL;
+    }
+
+  /* Was this file opened for read access? */
+
+  if ((filep->f_oflags & O_RDOK) == 0)
+    {
+      return -EACCES;
+    }
+
+  /* Let the driver do the whole transfer if it can.  Mountpoints share the
+   * operations vtable only up to the truncate method.
+   */
+
+  if (inode != NULL && !INODE_IS_MOUNTPT(inode) &&
+      inode->u.i_ops != NULL && inode->u.i_ops->readv != NULL)
+    {
+      return inode->u.i_ops->readv(filep, iov, iovcnt);
+    }
+
+  /* Process each entry in the struct iovec array */
+
+  for (i = 0, ntotal = 0; i < iovcnt; i++)
+    {
+      buffer    = iov[i].iov_base;
+      remaining = iov[i].iov_len;
+
+      /* Read repeatedly as necessary to fill the buffer */
+
+      while (remaining > 0)
+        {
+          nread = file_read(filep, buffer, remaining);
+          if (nread < 0)
+            {
+              return ntotal > 0 ? ntotal : nread;
+            }
+
+          /* Check for an end-of-file condition */
+
+          else if (nread == 0)
+            {
+              return ntotal;
+            }
+
+          buffer    += nread;
+          remaining -= nread;
+          ntotal    += nread;
+        }
+    }
+
+  return ntotal;
+}
+
+/****************************************************************************
+ * Name: nx_readv
+ *
+ * Description:
+ *   nx_readv() is an internal OS interface.  It is functionally similar to
+ *   the standard readv() interface except:
+ *
+ *    - It does not modify the errno variable, and
+ *    - It is not a cancellation point.
+ *
+ * Input Parameters:
+ *   fd     - File descriptor to read from
+ *   iov    - The buffers to fill, in order
+ *   iovcnt - Number of buffers
+ *
+ * Returned Value:
+ *   The number of bytes read on success, 0 on an end-of-file condition, or
+ *   a negated errno value if nothing could be read.
+ *
+ ****************************************************************************/
+
+ssize_t nx_readv(int fd, FAR const struct iovec *iov, int iovcnt)
+{
+  FAR struct file *filep;
+  ssize_t ret;
+
+  /* First, get the file structure.  Note that on failure,
+   * fs_getfilep() will return the errno.
+   */
+
+  ret = (ssize_t)fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Then let file_readv do all of the work. */
+
+  return file_readv(filep, iov, iovcnt);
+}
+
+/****************************************************************************
+ * Name: readv
+ *
+ * Description:
+ *   The standard, POSIX readv interface.  The readv() function places the
+ *   input data into the 'iovcnt' buffers specified by the members of the
+ *   'iov' array: iov[0], iov[1], ..., iov[iovcnt-1].
+ *
+ * Input Parameters:
+ *   fd     - File descriptor to read from
+ *   iov    - The buffers to fill, in order
+ *   iovcnt - Number of buffers
+ *
+ * Returned Value:
+ *   The number of bytes read on success, 0 on an end-of-file condition, or
+ *   -1 on failure with errno set appropriately.
+ *
+ ****************************************************************************/
+
+ssize_t readv(int fd, FAR const struct iovec *iov, int iovcnt)
+{
+  ssize_t ret;
+
+  /* readv() is a cancellation point */
+
+  enter_cancellation_point();
+
+  /* Let nx_readv() do the real work */
+
+  ret = nx_readv(fd, iov, iovcnt);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
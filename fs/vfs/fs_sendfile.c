@@ -25,17 +25,146 @@
 #include <nuttx/config.h>
 
 #include <sys/sendfile.h>
+#include <sys/stat.h>
 #include <stdbool.h>
 #include <errno.h>
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/net/net.h>
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: copyfile_xip
+ *
+ * Description:
+ *   Write the data of a file that can be read in place, e.g. on an XIP
+ *   ROMFS, directly from the medium without an intermediate buffer.
+ *
+ * Returned Value:
+ *   The number of bytes transferred or a negated errno value; -ENOTTY if
+ *   the input file cannot be read in place.
+ *
+ ****************************************************************************/
+
+static ssize_t copyfile_xip(FAR struct file *outfile,
+                            FAR struct file *infile, size_t count)
+{
+  FAR const void *mapped;
+  FAR const uint8_t *wrbuffer;
+  ssize_t nbyteswritten;
+  size_t ntransferred;
+  struct stat st;
+  off_t pos;
+
+  pos = file_seek(infile, 0, SEEK_CUR);
+  if (pos < 0 || file_fstat(infile, &st) < 0 || !S_ISREG(st.st_mode))
+    {
+      return -ENOTTY;
+    }
+
+  if (pos >= st.st_size)
+    {
+      return 0;
+    }
+
+  if (count > st.st_size - pos)
+    {
+      count = st.st_size - pos;
+    }
+
+  if (file_xipmap(infile, pos, count, &mapped) < 0)
+    {
+      return -ENOTTY;
+    }
+
+  wrbuffer = mapped;
+  for (ntransferred = 0; ntransferred < count; )
+    {
+      nbyteswritten = file_write(outfile, wrbuffer + ntransferred,
+                                 count - ntransferred);
+      if (nbyteswritten >= 0)
+        {
+          ntransferred += nbyteswritten;
+        }
+      else if (nbyteswritten != -EINTR || ntransferred == 0)
+        {
+          return nbyteswritten;
+        }
+    }
+
+  /* Leave the file position after the data, as reading would have */
+
+  file_seek(infile, pos + ntransferred, SEEK_SET);
+  return ntransferred;
+}
+
+/****************************************************************************
+ * Name: copyfile_splice
+ *
+ * Description:
+ *   Transfer data between a pipe or FIFO and another file through the pipe
+ *   buffer, without an intermediate buffer.
+ *
+ * Returned Value:
+ *   The number of bytes transferred or a negated errno value; -ENOTTY if
+ *   neither or both files are pipes.
+ *
+ ****************************************************************************/
+
+static ssize_t copyfile_splice(FAR struct file *outfile,
+                               FAR struct file *infile, size_t count)
+{
+  struct pipe_splice_s splice;
+  FAR struct file *pipe;
+  size_t ntransferred;
+  ssize_t nbytes;
+
+  if (INODE_IS_PIPE(infile->f_inode) == INODE_IS_PIPE(outfile->f_inode))
+    {
+      return -ENOTTY;
+    }
+
+  if (INODE_IS_PIPE(infile->f_inode))
+    {
+      pipe         = infile;
+      splice.filep = outfile;
+      splice.out   = true;
+    }
+  else
+    {
+      pipe         = outfile;
+      splice.filep = infile;
+      splice.out   = false;
+    }
+
+  for (ntransferred = 0; ntransferred < count; )
+    {
+      splice.size = count - ntransferred;
+      nbytes = file_ioctl(pipe, PIPEIOC_SPLICE,
+                          (unsigned long)((uintptr_t)&splice));
+      if (nbytes < 0)
+        {
+          /* Return what was transferred before the error */
+
+          return ntransferred > 0 ? ntransferred : nbytes;
+        }
+      else if (nbytes == 0)
+        {
+          break;
+        }
+
+      ntransferred += nbytes;
+    }
+
+  return ntransferred;
+}
+
 static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
                         off_t *offset, size_t count)
 {
@@ -70,6 +199,24 @@ static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
         }
     }
 
+  /* Files that can be read in place need no I/O buffer */
+
+  nbyteswritten = copyfile_xip(outfile, infile, count);
+  if (nbyteswritten != -ENOTTY)
+    {
+      ntransferred = nbyteswritten;
+      goto out;
+    }
+
+  /* Pipes move the data through their own buffer */
+
+  nbyteswritten = copyfile_splice(outfile, infile, count);
+  if (nbyteswritten != -ENOTTY)
+    {
+      ntransferred = nbyteswritten;
+      goto out;
+    }
+
   /* Allocate an I/O buffer */
 
   iobuffer = kmm_malloc(CONFIG_SENDFILE_BUFSIZE);
@@ -197,6 +344,8 @@ static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
 
   kmm_free(iobuffer);
 
+out:
+
   /* Return the current file position */
 
   if (offset)
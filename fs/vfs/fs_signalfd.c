@@ -28,12 +28,14 @@
 #include <assert.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <string.h>
 
 #include <debug.h>
 
 #include <nuttx/mutex.h>
 #include <nuttx/signal.h>
 
+#include <sys/param.h>
 #include <sys/signalfd.h>
 
 #include "inode/inode.h"
@@ -42,6 +44,10 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* The number of signals taken from the pending list at a time by read() */
+
+#define SIGNALFD_BATCH 8
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -159,15 +165,34 @@ static int signalfd_file_close(FAR struct file *filep)
   return OK;
 }
 
+static void signalfd_convert(FAR struct signalfd_siginfo *siginfo,
+                             FAR const struct siginfo *info)
+{
+  memset(siginfo, 0, sizeof(*siginfo));
+  siginfo->ssi_signo   = info->si_signo;
+  siginfo->ssi_errno   = info->si_errno;
+  siginfo->ssi_code    = info->si_code;
+#ifdef CONFIG_SCHED_HAVE_PARENT
+  siginfo->ssi_pid     = info->si_pid;
+  siginfo->ssi_status  = info->si_status;
+#endif
+#ifdef CONFIG_SIG_RTCOALESCE
+  siginfo->ssi_overrun = info->si_overrun;
+#endif
+  siginfo->ssi_int     = info->si_value.sival_int;
+  siginfo->ssi_ptr     = (uint64_t)(uintptr_t)info->si_value.sival_ptr;
+}
+
 static ssize_t signalfd_file_read(FAR struct file *filep,
                                   FAR char *buffer, size_t len)
 {
   FAR struct signalfd_priv_s *dev = filep->f_priv;
   FAR struct signalfd_siginfo *siginfo;
-  struct siginfo info;
-  sigset_t pendmask;
+  struct siginfo info[SIGNALFD_BATCH];
   ssize_t ret;
   int count;
+  int n;
+  int i;
 
   count = len / sizeof(struct signalfd_siginfo);
   if (buffer == NULL || count == 0)
@@ -175,48 +200,43 @@ static ssize_t signalfd_file_read(FAR struct file *filep,
       return -EINVAL;
     }
 
-  pendmask = nxsig_pendingset(NULL);
-  sigandset(&pendmask, &pendmask, &dev->sigmask);
-  if (sigisemptyset(&pendmask))
+  n = nxsig_dequeue(&dev->sigmask, info, MIN(count, SIGNALFD_BATCH));
+  if (n == 0)
     {
       if (filep->f_oflags & O_NONBLOCK)
         {
           return -EAGAIN;
         }
-      else
+
+      /* Nothing was pending, wait for the first signal */
+
+      ret = nxsig_waitinfo(&dev->sigmask, &info[0]);
+      if (ret < 0)
         {
-          pendmask = dev->sigmask;
+          return ret;
         }
+
+      n = 1;
     }
 
+  /* Return the pending signals, taking them a batch at a time instead of
+   * waiting for them one by one.
+   */
+
   siginfo = (FAR struct signalfd_siginfo *)buffer;
-  do
+  while (n > 0)
     {
-      ret = nxsig_waitinfo(&pendmask, &info);
-      if (ret < 0)
+      for (i = 0; i < n; i++)
         {
-          goto errout;
+          signalfd_convert(siginfo++, &info[i]);
         }
 
-      memset(siginfo, 0, sizeof(*siginfo));
-      siginfo->ssi_signo  = info.si_signo;
-      siginfo->ssi_errno  = info.si_errno;
-      siginfo->ssi_code   = info.si_code;
-#ifdef CONFIG_SCHED_HAVE_PARENT
-      siginfo->ssi_pid    = info.si_pid;
-      siginfo->ssi_status = info.si_status;
-#endif
-      siginfo->ssi_int    = info.si_value.sival_int;
-      siginfo->ssi_ptr    = (uint64_t)(uintptr_t)info.si_value.sival_ptr;
-      siginfo++;
-      pendmask = nxsig_pendingset(NULL);
-      sigandset(&pendmask, &pendmask, &dev->sigmask);
+      count -= n;
+      n = count > 0 ?
+          nxsig_dequeue(&dev->sigmask, info, MIN(count, SIGNALFD_BATCH)) : 0;
     }
-  while (--count != 0 && !sigisemptyset(&pendmask));
 
-errout:
-  len = (FAR char *)siginfo - buffer;
-  return len > 0 ? len : ret;
+  return (FAR char *)siginfo - buffer;
 }
 
 static int signalfd_file_poll(FAR struct file *filep,
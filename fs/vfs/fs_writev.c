@@ -0,0 +1,208 @@
+/****************************************************************************
+ * fs/vfs/fs_writev.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+
+#include "inode/inode.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_writev
+ *
+ * Description:
+ *   file_writev() is an internal OS interface.  It is functionally similar
+ *   to the standard writev() interface except:
+ *
+ *    - It does not modify the errno variable,
+ *    - It is not a cancellation point,
+ *    - It accepts a file structure instance instead of file descriptor.
+ *
+ *   Drivers that provide the writev method send all the buffers in one
+ *   transaction.  Otherwise each buffer is written with file_write() in
+ *   turn.
+ *
+ * Input Parameters:
+ *   filep  - Instance of struct file to use with the write
+ *   iov    - The buffers to write, in order
+ *   iovcnt - Number of buffers
+ *
+ * Returned Value:
+ *   The number of bytes written on success, or a negated errno value if
+ *   nothing could be written.
+ *
+ ****************************************************************************/
+
+ssize_t file_writev(FAR struct file *filep, FAR const struct iovec *iov,
+                    int iovcnt)
+{
+  FAR struct inode *inode;
+  FAR const uint8_t *buffer;
+  size_t remaining;
+  ssize_t nwritten;
+  ssize_t ntotal;
+  int i;
+
+  DEBUGASSERT(filep);
+  inode = filep->f_inode;
+
+  if (iovcnt < 0 || (iov == NULL && iovcnt > 0))
+    {
+      return -EINVAL;
+    }
+
+  /* Was this file opened for write access? */
+
+  if ((filep->f_oflags & O_WROK) == 0)
+    {
+      return -EACCES;
+    }
+
+  /* Let the driver do the whole transfer if it can.  Mountpoints share the
+   * operations vtable only up to the truncate method.
+   */
+
+  if (inode != NULL && !INODE_IS_MOUNTPT(inode) &&
+      inode->u.i_ops != NULL && inode->u.i_ops->writev != NULL)
+    {
+      return inode->u.i_ops->writev(filep, iov, iovcnt);
+    }
+
+  /* Process each entry in the struct iovec array */
+
+  for (i = 0, ntotal = 0; i < iovcnt; i++)
+    {
+      buffer    = iov[i].iov_base;
+      remaining = iov[i].iov_len;
+
+      /* Write repeatedly as necessary to write the entire buffer */
+
+      while (remaining > 0)
+        {
+          nwritten = file_write(filep, buffer, remaining);
+          if (nwritten < 0)
+            {
+              return ntotal > 0 ? ntotal : nwritten;
+            }
+
+          buffer    += nwritten;
+          remaining -= nwritten;
+          ntotal    += nwritten;
+        }
+    }
+
+  return ntotal;
+}
+
+/****************************************************************************
+ * Name: nx_writev
+ *
+ * Description:
+ *   nx_writev() is an internal OS interface.  It is functionally similar to
+ *   the standard writev() interface except:
+ *
+ *    - It does not modify the errno variable, and
+ *    - It is not a cancellation point.
+ *
+ * Input Parameters:
+ *   fd     - file descriptor (or socket descriptor) to write to
+ *   iov    - The buffers to write, in order
+ *   iovcnt - Number of buffers
+ *
+ * Returned Value:
+ *   The number of bytes written on success, or a negated errno value if
+ *   nothing could be written.
+ *
+ ****************************************************************************/
+
+ssize_t nx_writev(int fd, FAR const struct iovec *iov, int iovcnt)
+{
+  FAR struct file *filep;
+  ssize_t ret;
+
+  /* First, get the file structure.
+   * Note that fs_getfilep() will return the errno on failure.
+   */
+
+  ret = (ssize_t)fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Then let file_writev do all of the work. */
+
+  return file_writev(filep, iov, iovcnt);
+}
+
+/****************************************************************************
+ * Name: writev
+ *
+ * Description:
+ *   The standard, POSIX writev interface.  The writev() function gathers
+ *   the output data from the 'iovcnt' buffers specified by the members of
+ *   the 'iov' array: iov[0], iov[1], ..., iov[iovcnt-1].
+ *
+ * Input Parameters:
+ *   fd     - file descriptor (or socket descriptor) to write to
+ *   iov    - The buffers to write, in order
+ *   iovcnt - Number of buffers
+ *
+ * Returned Value:
+ *   The number of bytes written on success, or -1 on failure with errno set
+ *   appropriately.
+ *
+ ****************************************************************************/
+
+ssize_t writev(int fd, FAR const struct iovec *iov, int iovcnt)
+{
+  ssize_t ret;
+
+  /* writev() is a cancellation point */
+
+  enter_cancellation_point();
+
+  /* Let nx_writev() do all of the work */
+
+  ret = nx_writev(fd, iov, iovcnt);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
@@ -175,6 +175,13 @@ struct nxbe_plane_s
 
   NX_DRIVERTYPE *driver;
   NX_PLANEINFOTYPE pinfo;
+
+#ifdef CONFIG_NX_DAMAGE
+  /* Display updates that have not been reported to the driver yet */
+
+  uint8_t ndamage;
+  struct nxgl_rect_s damage[CONFIG_NX_DAMAGE_NRECTS];
+#endif
 };
 
 /* Clipping *****************************************************************/
@@ -308,10 +315,47 @@ int nxbe_colormap(FAR NX_DRIVERTYPE *dev);
  ****************************************************************************/
 
 #ifdef CONFIG_NX_UPDATE
-void nxbe_notify_rectangle(FAR NX_DRIVERTYPE *dev,
+void nxbe_notify_rectangle(FAR struct nxbe_plane_s *plane,
                            FAR const struct nxgl_rect_s *rect);
 #endif
 
+#ifdef CONFIG_NX_DAMAGE
+/****************************************************************************
+ * Name: nxbe_damage_add
+ *
+ * Description:
+ *   Record an updated rectangle of a plane.  It is reported to the driver
+ *   by the next nxbe_damage_flush(), merged with the other rectangles that
+ *   it overlaps.
+ *
+ ****************************************************************************/
+
+void nxbe_damage_add(FAR struct nxbe_plane_s *plane,
+                     FAR const struct nxgl_rect_s *rect);
+
+/****************************************************************************
+ * Name: nxbe_damage_pending
+ *
+ * Description:
+ *   Return true if any plane has updates that have not been reported.
+ *
+ ****************************************************************************/
+
+bool nxbe_damage_pending(FAR struct nxbe_state_s *be);
+
+/****************************************************************************
+ * Name: nxbe_damage_flush
+ *
+ * Description:
+ *   Report the recorded updates of all planes to the driver.  The NX server
+ *   calls this once per CONFIG_NX_DAMAGE_INTERVAL milliseconds while
+ *   updates are pending.
+ *
+ ****************************************************************************/
+
+void nxbe_damage_flush(FAR struct nxbe_state_s *be);
+#endif
+
 /****************************************************************************
  * Name: nx_configure
  *
@@ -0,0 +1,179 @@
+/****************************************************************************
+ * graphics/nxbe/nxbe_damage.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/nx/nxglib.h>
+
+#include "nxbe.h"
+
+#ifdef CONFIG_NX_DAMAGE
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbe_damage_area
+ *
+ * Description:
+ *   Return the number of pixels in a rectangle.
+ *
+ ****************************************************************************/
+
+static uint32_t nxbe_damage_area(FAR const struct nxgl_rect_s *rect)
+{
+  return (uint32_t)(rect->pt2.x - rect->pt1.x + 1) *
+         (uint32_t)(rect->pt2.y - rect->pt1.y + 1);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbe_damage_add
+ *
+ * Description:
+ *   Record an updated rectangle of a plane.  The rectangle is merged with
+ *   a recorded one if their bounding box has no more pixels than the two
+ *   of them separately, which is true of any overlapping or adjoining
+ *   pair with a common edge.  When all slots are used, it is merged with
+ *   the rectangle that grows least.
+ *
+ ****************************************************************************/
+
+void nxbe_damage_add(FAR struct nxbe_plane_s *plane,
+                     FAR const struct nxgl_rect_s *rect)
+{
+  struct nxgl_rect_s merged;
+  uint32_t area;
+  uint32_t growth;
+  uint32_t best = UINT32_MAX;
+  int ndx = 0;
+  int i;
+
+  if (nxgl_nullrect(rect))
+    {
+      return;
+    }
+
+  area = nxbe_damage_area(rect);
+
+  for (i = 0; i < plane->ndamage; i++)
+    {
+      nxgl_rectunion(&merged, &plane->damage[i], rect);
+      growth = nxbe_damage_area(&merged) -
+               nxbe_damage_area(&plane->damage[i]);
+      if (growth <= area)
+        {
+          nxgl_rectcopy(&plane->damage[i], &merged);
+          return;
+        }
+
+      if (growth < best)
+        {
+          best = growth;
+          ndx  = i;
+        }
+    }
+
+  if (plane->ndamage < CONFIG_NX_DAMAGE_NRECTS)
+    {
+      nxgl_rectcopy(&plane->damage[plane->ndamage++], rect);
+    }
+  else
+    {
+      nxgl_rectunion(&plane->damage[ndx], &plane->damage[ndx], rect);
+    }
+}
+
+/****************************************************************************
+ * Name: nxbe_damage_pending
+ *
+ * Description:
+ *   Return true if any plane has updates that have not been reported.
+ *
+ ****************************************************************************/
+
+bool nxbe_damage_pending(FAR struct nxbe_state_s *be)
+{
+  int i;
+
+  for (i = 0; i < be->vinfo.nplanes; i++)
+    {
+      if (be->plane[i].ndamage > 0)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: nxbe_damage_flush
+ *
+ * Description:
+ *   Report the recorded updates of all planes to the driver.
+ *
+ ****************************************************************************/
+
+void nxbe_damage_flush(FAR struct nxbe_state_s *be)
+{
+  FAR struct nxbe_plane_s *plane;
+  struct fb_area_s area;
+  int i;
+  int j;
+
+  for (i = 0; i < be->vinfo.nplanes; i++)
+    {
+      plane = &be->plane[i];
+      if (plane->ndamage == 0)
+        {
+          continue;
+        }
+
+#ifdef CONFIG_NX_HWACCEL
+      /* The driver will read the framebuffer, so any accelerated rendering
+       * must be complete first.
+       */
+
+      up_fbsync(&plane->pinfo);
+#endif
+
+      for (j = 0; j < plane->ndamage; j++)
+        {
+          nxgl_rect2area(&area, &plane->damage[j]);
+          plane->driver->updatearea(plane->driver, &area);
+        }
+
+      plane->ndamage = 0;
+    }
+}
+
+#endif /* CONFIG_NX_DAMAGE */
@@ -95,7 +95,7 @@ static void nxbe_clipmovesrc(FAR struct nxbe_clipops_s *cops,
        * rectangle has changed.
        */
 
-      nxbe_notify_rectangle(plane->driver, &update);
+      nxbe_notify_rectangle(plane, &update);
 #endif
     }
 }
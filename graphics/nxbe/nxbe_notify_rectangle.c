@@ -54,12 +54,26 @@
  ****************************************************************************/
 
 #ifdef CONFIG_NX_UPDATE
-void nxbe_notify_rectangle(FAR NX_DRIVERTYPE *dev,
+void nxbe_notify_rectangle(FAR struct nxbe_plane_s *plane,
                            FAR const struct nxgl_rect_s *rect)
 {
+#ifdef CONFIG_NX_DAMAGE
+  /* Batch the updates; the server reports them once per frame */
+
+  nxbe_damage_add(plane, rect);
+#else
   struct fb_area_s area;
 
+#ifdef CONFIG_NX_HWACCEL
+  /* The external module will read the framebuffer, so any accelerated
+   * rendering must be complete first.
+   */
+
+  up_fbsync(&plane->pinfo);
+#endif
+
   nxgl_rect2area(&area, rect);
-  dev->updatearea(dev, &area);
+  plane->driver->updatearea(plane->driver, &area);
+#endif
 }
 #endif
@@ -108,6 +108,7 @@ void NXGL_FUNCNAME(nxglib_cursor_backup, NXGLIB_SUFFIX)
 
       /* Get the source and destination addresses */
 
+      NXGL_FBSYNC(&plane->pinfo);
       fbmem  = (FAR uint8_t *)plane->pinfo.fbmem;
       sline  = (FAR uint8_t *)fbmem + sstride * intersection.pt1.y +
                 NXGL_SCALEX(intersection.pt1.x);
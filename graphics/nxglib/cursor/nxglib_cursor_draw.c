@@ -157,6 +157,7 @@ void NXGL_FUNCNAME(nxglib_cursor_draw, NXGLIB_SUFFIX)
        * pixel greater than or equal to 8.
        */
 
+      NXGL_FBSYNC(&plane->pinfo);
       fbmem  = (FAR uint8_t *)plane->pinfo.fbmem;
       sline  = be->cursor.image + sstride * origin.y + (origin.x >> 2);
       dline  = (FAR uint8_t *)fbmem + dstride * intersection.pt1.y +
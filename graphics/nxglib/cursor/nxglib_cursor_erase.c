@@ -107,6 +107,7 @@ void NXGL_FUNCNAME(nxglib_cursor_erase, NXGLIB_SUFFIX)
 
       /* Get the source and destination addresses */
 
+      NXGL_FBSYNC(&plane->pinfo);
       fbmem  = (FAR uint8_t *)plane->pinfo.fbmem;
       sline  = (FAR uint8_t *)be->cursor.bkgd + sstride * origin.y +
                 NXGL_SCALEX(origin.x);
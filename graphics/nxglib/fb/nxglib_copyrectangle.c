@@ -106,6 +106,23 @@ void NXGL_FUNCNAME(nxgl_copyrectangle, NXGLIB_SUFFIX)
   dline = pinfo->fbmem + dest->pt1.y * deststride +
           NXGL_SCALEX(dest->pt1.x);
 
+#if defined(CONFIG_NX_HWACCEL) && NXGLIB_BITSPERPIXEL >= 8
+  /* Let the accelerator copy large images */
+
+  if (width * rows >= CONFIG_NX_HWACCEL_MINPIXELS)
+    {
+      struct fb_area_s area;
+
+      nxgl_rect2area(&area, dest);
+      if (up_fbcopyarea(pinfo, &area, sline, srcstride) >= 0)
+        {
+          return;
+        }
+    }
+#endif
+
+  NXGL_FBSYNC(pinfo);
+
   while (rows--)
     {
 #if NXGLIB_BITSPERPIXEL < 8
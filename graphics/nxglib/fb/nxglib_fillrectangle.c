@@ -84,6 +84,26 @@ void NXGL_FUNCNAME(nxgl_fillrectangle, NXGLIB_SUFFIX)
 
   line   = pinfo->fbmem + rect->pt1.y * stride + NXGL_SCALEX(rect->pt1.x);
 
+#if defined(CONFIG_NX_HWACCEL) && NXGLIB_BITSPERPIXEL >= 8
+  /* Let the accelerator fill large rectangles.  The fill proceeds in the
+   * background; it is waited for the next time that the CPU touches the
+   * framebuffer.
+   */
+
+  if (width * rows >= CONFIG_NX_HWACCEL_MINPIXELS)
+    {
+      struct fb_area_s area;
+
+      nxgl_rect2area(&area, rect);
+      if (up_fbfillarea(pinfo, &area, color) >= 0)
+        {
+          return;
+        }
+    }
+#endif
+
+  NXGL_FBSYNC(pinfo);
+
 #if NXGLIB_BITSPERPIXEL < 8
 #  ifdef CONFIG_NX_PACKEDMSFIRST
 
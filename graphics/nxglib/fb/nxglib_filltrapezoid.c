@@ -155,6 +155,10 @@ void NXGL_FUNCNAME(nxgl_filltrapezoid, NXGLIB_SUFFIX)
       nrows  = y2 - y1 + 1;
     }
 
+  /* Wait for any accelerated rendering into the framebuffer */
+
+  NXGL_FBSYNC(pinfo);
+
   /* Get the address of the first byte on the first line */
 
   line = pinfo->fbmem + y1 * stride ;
@@ -145,6 +145,10 @@ void NXGL_FUNCNAME(nxgl_getrectangle, NXGLIB_SUFFIX)
 #  endif
 #endif
 
+  /* Wait for any accelerated rendering into the framebuffer */
+
+  NXGL_FBSYNC(pinfo);
+
   /* sline = address of the first pixel in the top row of the source in
    * framebuffer memory
    */
@@ -147,6 +147,10 @@ void NXGL_FUNCNAME(nxgl_moverectangle, NXGLIB_SUFFIX)
 #  endif
 #endif
 
+  /* Wait for any accelerated rendering into the framebuffer */
+
+  NXGL_FBSYNC(pinfo);
+
   /* sline = address of the first pixel in the top row of the source in
    * framebuffer memory
    */
@@ -160,6 +164,29 @@ void NXGL_FUNCNAME(nxgl_moverectangle, NXGLIB_SUFFIX)
 
   dline = pinfo->fbmem + offset->y * stride + NXGL_SCALEX(offset->x);
 
+#if defined(CONFIG_NX_HWACCEL) && NXGLIB_BITSPERPIXEL >= 8
+  /* Let the accelerator move large regions upward, as when a text window
+   * scrolls.  It copies from the top down, so each source row is read
+   * before it can be overwritten.
+   */
+
+  if (offset->y < rect->pt1.y &&
+      width * rows >= CONFIG_NX_HWACCEL_MINPIXELS)
+    {
+      struct fb_area_s area;
+
+      area.x = offset->x;
+      area.y = offset->y;
+      area.w = width;
+      area.h = rows;
+
+      if (up_fbcopyarea(pinfo, &area, sline, stride) >= 0)
+        {
+          return;
+        }
+    }
+#endif
+
   /* Case 1:  Is the destination position above the displayed position?
    * If the destination position is less then then the src address, then the
    * destination is offset to a position below (and or to the left) of the
@@ -68,6 +68,10 @@ void NXGL_FUNCNAME(nxgl_setpixel, NXGLIB_SUFFIX)
   FAR NXGL_PIXEL_T *pixel;
 #endif
 
+  /* Wait for any accelerated rendering into the framebuffer */
+
+  NXGL_FBSYNC(pinfo);
+
   /* Get the address of the first byte of the pixel to write */
 
   dest = pinfo->fbmem + pos->y * pinfo->stride + NXGL_SCALEX(pos->x);
@@ -31,6 +31,10 @@
 
 #include <nuttx/nx/nxglib.h>
 
+#ifdef CONFIG_NX_HWACCEL
+#  include <nuttx/video/fb.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -49,6 +53,17 @@
 #  undef CONFIG_NX_ANTIALIASING
 #endif
 
+/* When rendering is accelerated, the accelerator may still be writing the
+ * framebuffer.  Software rendering must wait for it before accessing
+ * framebuffer memory.
+ */
+
+#ifdef CONFIG_NX_HWACCEL
+#  define NXGL_FBSYNC(pinfo)       up_fbsync(pinfo)
+#else
+#  define NXGL_FBSYNC(pinfo)
+#endif
+
 /* Set up bit blit macros for this BPP */
 
 #if NXGLIB_BITSPERPIXEL == 1
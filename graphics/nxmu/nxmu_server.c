@@ -28,12 +28,14 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 #include <mqueue.h>
 #include <fcntl.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/mqueue.h>
 #include <nuttx/nx/nx.h>
 
@@ -270,6 +272,10 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
   struct nxmu_state_s    nxmu;
   FAR struct nxsvrmsg_s *msg;
   char                   buffer[NX_MXSVRMSGLEN];
+#ifdef CONFIG_NX_DAMAGE
+  struct timespec        deadline;
+  bool                   damaged = false;
+#endif
   int                    nbytes;
   int                    ret;
 
@@ -295,9 +301,43 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
 
   for (; ; )
     {
-      /* Receive the next server message */
+#ifdef CONFIG_NX_DAMAGE
+      /* Report the display updates batched since the first of them once
+       * the frame interval has passed.
+       */
+
+      if (nxbe_damage_pending(&nxmu.be))
+        {
+          if (!damaged)
+            {
+              clock_gettime(CLOCK_REALTIME, &deadline);
+              deadline.tv_nsec += CONFIG_NX_DAMAGE_INTERVAL * NSEC_PER_MSEC;
+              if (deadline.tv_nsec >= NSEC_PER_SEC)
+                {
+                  deadline.tv_sec  += deadline.tv_nsec / NSEC_PER_SEC;
+                  deadline.tv_nsec %= NSEC_PER_SEC;
+                }
+
+              damaged = true;
+            }
+
+          nbytes = nxmq_timedreceive(nxmu.conn.crdmq, buffer,
+                                     NX_MXSVRMSGLEN, 0, &deadline);
+          if (nbytes == -ETIMEDOUT)
+            {
+              nxbe_damage_flush(&nxmu.be);
+              damaged = false;
+              continue;
+            }
+        }
+      else
+#endif
+        {
+          /* Receive the next server message */
+
+          nbytes = nxmq_receive(nxmu.conn.crdmq, buffer, NX_MXSVRMSGLEN, 0);
+        }
 
-      nbytes = nxmq_receive(nxmu.conn.crdmq, buffer, NX_MXSVRMSGLEN, 0);
       if (nbytes < 0)
         {
           if (nbytes != -EINTR)
@@ -332,6 +332,25 @@ struct crypt_op
   caddr_t iv;
 };
 
+/* One operation of a batch */
+
+struct crypt_n_op
+{
+  struct crypt_op cop;
+  uint32_t reqid;     /* not used by the driver */
+  int status;         /* returns: OK or a negated errno value */
+};
+
+/* ioctl parameter to submit or to fetch a batch of operations.  The buffers
+ * of an asynchronous batch must stay valid until it is fetched.
+ */
+
+struct crypt_mop
+{
+  uint32_t count;     /* number of operations */
+  FAR struct crypt_n_op *reqs;
+};
+
 /* hamc buffer, software & hardware need it */
 
 extern const uint8_t hmac_ipad_buffer[HMAC_MAX_BLOCK_LEN];
@@ -352,6 +371,9 @@ extern const uint8_t hmac_opad_buffer[HMAC_MAX_BLOCK_LEN];
 #define CIOCCRYPT               103
 #define CIOCKEY                 104
 #define CIOCASYMFEAT            105
+#define CIOCNCRYPTM             106 /* Run a batch of operations */
+#define CIOCASYNCCRYPTM         107 /* Queue a batch of operations */
+#define CIOCASYNCFETCH          108 /* Take the oldest completed batch */
 
 int crypto_newsession(FAR uint64_t *, FAR struct cryptoini *, int);
 int crypto_freesession(uint64_t);
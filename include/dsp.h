@@ -455,6 +455,36 @@ struct avg_filter_data_s
   float k;             /* k counter */
 };
 
+/* FIR filter */
+
+struct fir_filter_f32_s
+{
+  FAR const float *coeffs; /* ntaps coefficients */
+  FAR float       *state;  /* 2 * ntaps delay line */
+  uint16_t         ntaps;  /* Number of taps */
+  uint16_t         pos;    /* Position of the newest sample */
+};
+
+/* Cascade of biquad filters */
+
+struct biquad_f32_s
+{
+  FAR const float *coeffs;  /* b0, b1, b2, a1, a2 of each stage */
+  FAR float       *state;   /* 2 values per stage */
+  uint8_t          nstages; /* Number of stages */
+};
+
+/* Moving average filter */
+
+struct mavg_filter_f32_s
+{
+  FAR float *buf;        /* Window of len samples */
+  float      sum;        /* Running sum of the window */
+  float      one_by_len; /* One by len */
+  uint16_t   len;        /* Length of the window */
+  uint16_t   pos;        /* Position of the oldest sample */
+};
+
 /****************************************************************************
  * Public Functions Prototypes
  ****************************************************************************/
@@ -615,6 +645,22 @@ void avg_filter_data_init(FAR struct avg_filter_data_s *data,
                           float prev_avg, float k);
 float avg_filter(FAR struct avg_filter_data_s *data, float x);
 
+/* Block filters */
+
+void fir_filter_init(FAR struct fir_filter_f32_s *fir,
+                     FAR const float *coeffs, FAR float *state,
+                     uint16_t ntaps);
+void fir_filter(FAR struct fir_filter_f32_s *fir, FAR const float *in,
+                FAR float *out, size_t n);
+void biquad_init(FAR struct biquad_f32_s *bq, FAR const float *coeffs,
+                 FAR float *state, uint8_t nstages);
+void biquad_cascade(FAR struct biquad_f32_s *bq, FAR const float *in,
+                    FAR float *out, size_t n);
+void mavg_filter_init(FAR struct mavg_filter_f32_s *mavg, FAR float *buf,
+                      uint16_t len);
+void mavg_filter(FAR struct mavg_filter_f32_s *mavg, FAR const float *in,
+                 FAR float *out, size_t n);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
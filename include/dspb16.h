@@ -123,6 +123,25 @@
 
 #define SVM3_BASE_VOLTAGE_GET_B16(vbus) (b16mulb16(vbus, SQRT3_BY_THREE_B16))
 
+/****************************************************************************
+ * Name: B16_MAC2
+ *
+ * Description:
+ *   Sum of two products: a*b + c*d.
+ *
+ *   With a 64-bit type both products are accumulated at full precision and
+ *   rounded once, which the compiler maps to a SMULL/SMLAL pair on ARMv7-M
+ *   instead of two multiplies, two roundings and an add.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HAVE_LONG_LONG
+#  define B16_MAC2(a, b, c, d) \
+     ((b16_t)b32tob16((b32_t)(a) * (b) + (b32_t)(c) * (d)))
+#else
+#  define B16_MAC2(a, b, c, d) (b16mulb16(a, b) + b16mulb16(c, d))
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -425,6 +444,39 @@ struct pmsm_model_ext_b16_s
   b16_t load;                /* Motor model load torque */
 };
 
+/* FIR filter */
+
+struct fir_filter_b16_s
+{
+  FAR const b16_t *coeffs; /* ntaps coefficients */
+  FAR b16_t       *state;  /* 2 * ntaps delay line */
+  uint16_t         ntaps;  /* Number of taps */
+  uint16_t         pos;    /* Position of the newest sample */
+};
+
+/* Cascade of biquad filters */
+
+struct biquad_b16_s
+{
+  FAR const b16_t *coeffs;  /* b0, b1, b2, a1, a2 of each stage */
+  FAR b16_t       *state;   /* x1, x2, y1, y2 of each stage */
+  uint8_t          nstages; /* Number of stages */
+};
+
+/* Moving average filter */
+
+struct mavg_filter_b16_s
+{
+  FAR b16_t *buf;        /* Window of len samples */
+#ifdef CONFIG_HAVE_LONG_LONG
+  b32_t      sum;        /* Running sum of the window */
+#else
+  b16_t      sum;        /* Running sum of the window */
+#endif
+  uint16_t   len;        /* Length of the window */
+  uint16_t   pos;        /* Position of the oldest sample */
+};
+
 /* PMSM motor model */
 
 struct pmsm_model_b16_s
@@ -596,6 +648,22 @@ int pmsm_model_elec_b16(FAR struct pmsm_model_b16_s *model,
                         FAR ab_frame_b16_t *vab);
 int pmsm_model_mech_b16(FAR struct pmsm_model_b16_s *model, b16_t load);
 
+/* Block filters */
+
+void fir_filter_init_b16(FAR struct fir_filter_b16_s *fir,
+                         FAR const b16_t *coeffs, FAR b16_t *state,
+                         uint16_t ntaps);
+void fir_filter_b16(FAR struct fir_filter_b16_s *fir, FAR const b16_t *in,
+                    FAR b16_t *out, size_t n);
+void biquad_init_b16(FAR struct biquad_b16_s *bq, FAR const b16_t *coeffs,
+                     FAR b16_t *state, uint8_t nstages);
+void biquad_cascade_b16(FAR struct biquad_b16_s *bq, FAR const b16_t *in,
+                        FAR b16_t *out, size_t n);
+void mavg_filter_init_b16(FAR struct mavg_filter_b16_s *mavg,
+                          FAR b16_t *buf, uint16_t len);
+void mavg_filter_b16(FAR struct mavg_filter_b16_s *mavg,
+                     FAR const b16_t *in, FAR b16_t *out, size_t n);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -34,6 +34,13 @@
 
 #define MQ_NONBLOCK O_NONBLOCK
 
+/* Non-standard: mq_flags of the mq_open() attributes that creates the
+ * queue, pre-allocate a pool of mq_maxmsg messages for this queue
+ * (requires CONFIG_MQ_LOAN).
+ */
+
+#define MQ_POOL     (1l << 30)
+
 /****************************************************************************
  * Public Type Declarations
  ****************************************************************************/
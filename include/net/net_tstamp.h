@@ -0,0 +1,105 @@
+/****************************************************************************
+ * include/net/net_tstamp.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NET_NET_TSTAMP_H
+#define __INCLUDE_NET_NET_TSTAMP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <time.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Flags of the SO_TIMESTAMPING socket option.  The TX and RX flags select
+ * which timestamps are generated, SOFTWARE and RAW_HARDWARE select which
+ * of them are reported in the SCM_TIMESTAMPING control message.
+ */
+
+#define SOF_TIMESTAMPING_TX_HARDWARE  (1 << 0) /* Transmit time of the NIC */
+#define SOF_TIMESTAMPING_TX_SOFTWARE  (1 << 1) /* Time of hand-off to the NIC */
+#define SOF_TIMESTAMPING_RX_HARDWARE  (1 << 2) /* Receive time of the NIC */
+#define SOF_TIMESTAMPING_RX_SOFTWARE  (1 << 3) /* Time of arrival in the stack */
+#define SOF_TIMESTAMPING_SOFTWARE     (1 << 4) /* Report software timestamps */
+#define SOF_TIMESTAMPING_RAW_HARDWARE (1 << 6) /* Report hardware timestamps */
+
+#define SOF_TIMESTAMPING_MASK \
+  (SOF_TIMESTAMPING_TX_HARDWARE | SOF_TIMESTAMPING_TX_SOFTWARE | \
+   SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RX_SOFTWARE | \
+   SOF_TIMESTAMPING_SOFTWARE | SOF_TIMESTAMPING_RAW_HARDWARE)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Payload of the SCM_TIMESTAMPING control message: ts[0] holds the
+ * software timestamp, ts[2] the hardware timestamp and ts[1] is unused.
+ * A timestamp that is not available is zero.
+ */
+
+struct scm_timestamping
+{
+  struct timespec ts[3];
+};
+
+/* Transmit timestamping modes of struct hwtstamp_config */
+
+enum hwtstamp_tx_types
+{
+  HWTSTAMP_TX_OFF = 0,                 /* No transmit timestamps */
+  HWTSTAMP_TX_ON                       /* Timestamp the packets that ask */
+};
+
+/* Receive filters of struct hwtstamp_config */
+
+enum hwtstamp_rx_filters
+{
+  HWTSTAMP_FILTER_NONE = 0,            /* No receive timestamps */
+  HWTSTAMP_FILTER_ALL,                 /* Timestamp all packets */
+  HWTSTAMP_FILTER_SOME,                /* Some packets, at least those asked */
+  HWTSTAMP_FILTER_PTP_V1_L4_EVENT,     /* PTPv1 UDP event packets */
+  HWTSTAMP_FILTER_PTP_V1_L4_SYNC,      /* PTPv1 UDP Sync */
+  HWTSTAMP_FILTER_PTP_V1_L4_DELAY_REQ, /* PTPv1 UDP Delay_Req */
+  HWTSTAMP_FILTER_PTP_V2_L4_EVENT,     /* PTPv2 UDP event packets */
+  HWTSTAMP_FILTER_PTP_V2_L4_SYNC,      /* PTPv2 UDP Sync */
+  HWTSTAMP_FILTER_PTP_V2_L4_DELAY_REQ, /* PTPv2 UDP Delay_Req */
+  HWTSTAMP_FILTER_PTP_V2_L2_EVENT,     /* PTPv2 Ethernet event packets */
+  HWTSTAMP_FILTER_PTP_V2_L2_SYNC,      /* PTPv2 Ethernet Sync */
+  HWTSTAMP_FILTER_PTP_V2_L2_DELAY_REQ, /* PTPv2 Ethernet Delay_Req */
+  HWTSTAMP_FILTER_PTP_V2_EVENT,        /* PTPv2 event packets of any layer */
+  HWTSTAMP_FILTER_PTP_V2_SYNC,         /* PTPv2 Sync of any layer */
+  HWTSTAMP_FILTER_PTP_V2_DELAY_REQ     /* PTPv2 Delay_Req of any layer */
+};
+
+/* The hardware timestamping configuration of a network device, passed
+ * through ifr_data with the SIOCSHWTSTAMP and SIOCGHWTSTAMP ioctls.
+ */
+
+struct hwtstamp_config
+{
+  int flags;                           /* Reserved, must be zero */
+  int tx_type;                         /* See enum hwtstamp_tx_types */
+  int rx_filter;                       /* See enum hwtstamp_rx_filters */
+};
+
+#endif /* __INCLUDE_NET_NET_TSTAMP_H */
@@ -56,4 +56,8 @@
                                            * Argument: max retry count */
 #define TCP_MAXSEG    (__SO_PROTOCOL + 4) /* The maximum segment size */
 
+/* Select the congestion control algorithm.  Argument: name string */
+
+#define TCP_CONGESTION (__SO_PROTOCOL + 5)
+
 #endif /* __INCLUDE_NETINET_TCP_H */
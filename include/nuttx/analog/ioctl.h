@@ -89,10 +89,10 @@
 #define AN_ADS7828_FIRST (AN_LMP92001_FIRST + AN_LMP92001_NCMDS)
 #define AN_ADS7828_NCMDS 6
 
-/* See arch/arm/src/stm32l4/stm32l4_adc.h */
+/* See arch/arm/src/stm32l4/stm32l4_adc.h and stm32l4_dac.h */
 
 #define AN_STM32L4_FIRST (AN_ADS7828_FIRST + AN_ADS7828_NCMDS)
-#define AN_STM32L4_NCMDS 2
+#define AN_STM32L4_NCMDS 8
 
 /* See include/nuttx/analog/max1161x.h */
 
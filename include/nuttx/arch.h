@@ -1552,6 +1552,21 @@ void up_affinity_irq(int irq, cpu_set_t cpuset);
 void up_trigger_irq(int irq, cpu_set_t cpuset);
 #endif
 
+/****************************************************************************
+ * Name: up_trigger_tasklet
+ *
+ * Description:
+ *   Pend the lowest priority software interrupt whose handler calls
+ *   tasklet_run().  The tasklets then run after all other pending
+ *   interrupts, before returning to thread mode.  May be called with the
+ *   interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TASKLET
+void up_trigger_tasklet(void);
+#endif
+
 /****************************************************************************
  * Name: up_prioritize_irq
  *
@@ -2698,6 +2713,43 @@ unsigned long up_perf_gettime(void);
 unsigned long up_perf_getfreq(void);
 void up_perf_convert(unsigned long elapsed, FAR struct timespec *ts);
 
+/****************************************************************************
+ * Name: up_irq_timestamp
+ *
+ * Description:
+ *   Return the up_perf_gettime() value recorded by the architecture on
+ *   entry to the interrupt being processed, before any registers were
+ *   saved.  Only valid in interrupt context.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_IRQ_TIMESTAMP
+unsigned long up_irq_timestamp(void);
+#endif
+
+/****************************************************************************
+ * Name: up_crc32part and up_crc16part
+ *
+ * Description:
+ *   Continue the CRC calculation of crc32part() (bit-reflected, polynomial
+ *   0x04c11db7) or crc16part() (polynomial 0x1021) with the CRC unit.
+ *
+ * Input Parameters:
+ *   src - The data
+ *   len - The number of bytes
+ *   crc - The CRC so far, updated on success
+ *
+ * Returned Value:
+ *   OK, or a negated errno value if the unit cannot be used now, in which
+ *   case *crc is unchanged and the caller computes the CRC in software.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_CRC
+int up_crc32part(FAR const uint8_t *src, size_t len, FAR uint32_t *crc);
+int up_crc16part(FAR const uint8_t *src, size_t len, FAR uint16_t *crc);
+#endif
+
 /****************************************************************************
  * Name: up_show_cpuinfo
  *
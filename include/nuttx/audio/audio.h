@@ -92,6 +92,23 @@
  * AUDIOIOC_STOP - Stop Audio streaming
  *
  *   ioctl argument:  None
+ *
+ * AUDIOIOC_MAPRING - Switch the device to mapped ring mode
+ *
+ *   ioctl argument:  Pointer to an audio_ring_s structure.  The "period"
+ *                    field holds the requested period in bytes (zero for
+ *                    the driver default).  On return the structure
+ *                    describes the DMA ring that the transfer runs over.
+ *                    The ring may then be mapped with mmap(); after
+ *                    AUDIOIOC_START the device moves samples between the
+ *                    ring and the hardware continuously and each elapsed
+ *                    period makes the device readable with poll().  A
+ *                    read() returns the number of elapsed periods as a
+ *                    uint32_t.  No audio buffers are used in this mode.
+ *
+ * AUDIOIOC_UNMAPRING - Leave the mapped ring mode
+ *
+ *   ioctl argument:  None
  */
 
 #define AUDIOIOC_GETCAPS            _AUDIOIOC(1)
@@ -114,6 +131,8 @@
 #define AUDIOIOC_SETPARAMTER        _AUDIOIOC(18)
 #define AUDIOIOC_GETLATENCY         _AUDIOIOC(19)
 #define AUDIOIOC_FLUSH              _AUDIOIOC(20)
+#define AUDIOIOC_MAPRING            _AUDIOIOC(21)
+#define AUDIOIOC_UNMAPRING          _AUDIOIOC(22)
 
 /* Audio Device Types *******************************************************/
 
@@ -320,6 +339,7 @@
 #define AUDIO_CALLBACK_IOERR        0x02
 #define AUDIO_CALLBACK_COMPLETE     0x03
 #define AUDIO_CALLBACK_MESSAGE      0x04
+#define AUDIO_CALLBACK_PERIOD       0x05  /* A period of the mapped ring elapsed */
 
 /* Audio Pipeline Buffer (AP Buffer) flags **********************************/
 
@@ -513,6 +533,19 @@ struct audio_buf_desc_s
   } u;
 };
 
+/* Description of the DMA ring of a device in mapped ring mode, used with
+ * the AUDIOIOC_MAPRING ioctl.  The ring holds size / period periods that
+ * the hardware transfers one after the other; period n (counted from
+ * zero) occupies the bytes at (n % (size / period)) * period.
+ */
+
+struct audio_ring_s
+{
+  FAR void            *buffer;            /* Start of the ring */
+  uint32_t            size;               /* Size of the ring in bytes */
+  uint32_t            period;             /* Bytes per period */
+};
+
 /* Typedef for lower-level to upper-level callback for buffer dequeuing */
 
 #ifdef CONFIG_AUDIO_MULTI_SESSION
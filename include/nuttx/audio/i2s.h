@@ -297,6 +297,20 @@ struct i2s_dev_s;
 typedef CODE void (*i2s_callback_t)(FAR struct i2s_dev_s *dev,
                    FAR struct ap_buffer_s *apb, FAR void *arg, int result);
 
+/* The argument of the AUDIOIOC_MAPRING command of I2S_IOCTL.  The driver
+ * describes its DMA ring in 'ring' and then calls 'callback' with a NULL
+ * audio buffer each time a period has elapsed, possibly from the DMA
+ * interrupt.
+ */
+
+struct i2s_ring_s
+{
+  struct audio_ring_s ring;    /* In: requested period; out: the ring */
+  bool playback;               /* True: transmit, false: receive */
+  i2s_callback_t callback;     /* Period callback */
+  FAR void *arg;               /* Argument of the callback */
+};
+
 /* The I2S vtable */
 
 struct i2s_ops_s
@@ -67,6 +67,9 @@ struct binary_s
   main_t entrypt;                      /* Entry point into a program module */
   FAR void *mapped;                    /* Memory-mapped, address space */
   FAR void *alloc[BINFMT_NALLOC];      /* Allocated address spaces */
+#ifdef CONFIG_PIC
+  FAR struct dspace_s *dspace;         /* PIC base of the module, or NULL */
+#endif
 
 #ifdef CONFIG_BINFMT_CONSTRUCTORS
   /* Constructors/destructors */
@@ -117,6 +117,24 @@ struct elf_loadinfo_s
   FAR addrenv_t     *oldenv;     /* Saved address environment */
 #endif
 
+  /* Execution in place.
+   *
+   * A position-independent module (ET_DYN) runs its read-only sections
+   * from xipimage, where the file is mapped, at textbias from their link
+   * addresses.  Its writable sections are copied to dataalloc with the
+   * layout that they are linked at, from datavaddr.  dspace holds the
+   * address of the GOT, which is loaded into the PIC base register.
+   */
+
+#ifdef CONFIG_ELF_XIP
+  FAR const uint8_t *xipimage;   /* Address of the mapped file */
+  uintptr_t          textbias;   /* Run-time minus link address of .text */
+  Elf_Addr           textvaddr;  /* Link address of the read-only sections */
+  size_t             textspan;   /* Extent of the read-only sections */
+  Elf_Addr           datavaddr;  /* Link address of the writable sections */
+  FAR struct dspace_s *dspace;   /* PIC base of the module */
+#endif
+
   uint16_t           symtabidx;  /* Symbol table section index */
   uint16_t           strtabidx;  /* String table section index */
   uint16_t           buflen;     /* size of iobuffer[] */
@@ -0,0 +1,138 @@
+/****************************************************************************
+ * include/nuttx/board_initcall.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_BOARD_INITCALL_H
+#define __INCLUDE_NUTTX_BOARD_INITCALL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+
+#ifdef CONFIG_BOARD_INITCALL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The largest number of calls in one table (deps is a bit set) */
+
+#define BOARD_INITCALL_MAX    32
+
+/* Dependency on entry n of the same table */
+
+#define BOARD_INITCALL_DEP(n) (UINT32_C(1) << (n))
+
+/* Initializer of a table entry */
+
+#define BOARD_INITCALL(n, f, l, d) \
+  { .name = (n), .func = (f), .level = (l), .deps = (d) }
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One deferred initialization step of the board.  A step runs on a low
+ * priority worker thread once all steps of lower levels have finished and
+ * all the steps named in 'deps' have succeeded; if one of them failed the
+ * step is skipped and its result is -ENODEV.  Steps that are ready at the
+ * same time run in parallel on the CONFIG_SCHED_LPNTHREADS workers.
+ */
+
+struct board_initcall_s
+{
+  FAR const char *name;        /* Name of the step for the log */
+  CODE int (*func)(void);      /* The step; returns OK or a negated errno */
+  uint8_t level;               /* Runs after all steps of lower levels */
+  uint32_t deps;               /* BOARD_INITCALL_DEP() of earlier steps */
+
+  /* Private to board_initcall_start() */
+
+  struct work_s work;          /* For the worker thread */
+  sem_t done;                  /* Posted when the step has finished */
+  int result;                  /* The return value of func */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: board_initcall_start
+ *
+ * Description:
+ *   Start the deferred initialization steps of the board and return
+ *   without waiting for them, typically from board_app_initialize() once
+ *   the console is up.  Only one table can be active.
+ *
+ * Input Parameters:
+ *   calls  - The table of steps, which must stay valid until they finish.
+ *            A step may only depend on earlier steps of the same or a lower
+ *            level.
+ *   ncalls - The number of steps, at most BOARD_INITCALL_MAX
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   an invalid table or if a table is already active.
+ *
+ ****************************************************************************/
+
+int board_initcall_start(FAR struct board_initcall_s *calls, int ncalls);
+
+/****************************************************************************
+ * Name: board_initcall_wait
+ *
+ * Description:
+ *   Wait until a step of the active table has finished, e.g. before the
+ *   first use of the device it brings up.
+ *
+ * Input Parameters:
+ *   call - The step to wait for
+ *
+ * Returned Value:
+ *   The result of the step: OK, the negated errno it returned, or -ENODEV
+ *   if it was skipped.
+ *
+ ****************************************************************************/
+
+int board_initcall_wait(FAR struct board_initcall_s *call);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_BOARD_INITCALL */
+#endif /* __INCLUDE_NUTTX_BOARD_INITCALL_H */
@@ -279,6 +279,9 @@ struct cpuload_s
 {
   volatile uint32_t total;   /* Total number of clock ticks */
   volatile uint32_t active;  /* Number of ticks while this thread was active */
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+  volatile uint32_t irq;     /* Number of ticks spent in interrupt handlers */
+#endif
 };
 #endif
 
@@ -293,6 +296,22 @@ typedef int64_t sclock_t;
 typedef int32_t sclock_t;
 #endif
 
+/* The time page is written by the kernel on every tick and read by the
+ * clock_gettime() of the user space C library, which then needs no system
+ * call for CLOCK_MONOTONIC, CLOCK_BOOTTIME and CLOCK_REALTIME.  seq is odd
+ * while the page is being written; a reader retries until it sees the same
+ * even value before and after reading the other fields.
+ */
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+struct clock_timepage_s
+{
+  volatile uint32_t seq;          /* Odd while the page is written */
+  volatile clock_t ticks;         /* The system timer counter */
+  struct timespec basetime;       /* CLOCK_REALTIME at tick zero */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -532,6 +551,22 @@ void clock_resynchronize(FAR struct timespec *rtc_diff);
 clock_t clock_systime_ticks(void);
 #endif
 
+/****************************************************************************
+ * Name: clock_timepage
+ *
+ * Description:
+ *   Return the time page.  This is the system call that the C library makes
+ *   once to find the page.
+ *
+ * Returned Value:
+ *   The time page, or NULL if it could not be allocated.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+FAR const struct clock_timepage_s *clock_timepage(void);
+#endif
+
 /****************************************************************************
  * Name: clock_time2ticks
  *
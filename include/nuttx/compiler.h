@@ -250,6 +250,10 @@
 
 #  define nosanitize_undefined __attribute__((no_sanitize("undefined")))
 
+/* The return address of the current function (x = 0) or of its callers */
+
+#  define return_address(x) __builtin_return_address(x)
+
 /* The nostackprotect_function attribute disables stack protection in
  * sensitive functions, e.g., stack coloration routines.
  */
@@ -993,6 +997,10 @@
 
 #endif
 
+#ifndef return_address
+#  define return_address(x) 0
+#endif
+
 #ifndef CONFIG_HAVE_LONG_LONG
 #  undef CONFIG_FS_LARGEFILE
 #endif
@@ -0,0 +1,180 @@
+/****************************************************************************
+ * include/nuttx/event.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_EVENT_H
+#define __INCLUDE_NUTTX_EVENT_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/list.h>
+
+#ifdef CONFIG_SCHED_EVENTS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Flags of nxevent_wait(), nxevent_tickwait() and nxevent_trywait() */
+
+#define NXEVENT_WAIT_ANY      0          /* Wait for any of the events */
+#define NXEVENT_WAIT_ALL      (1 << 0)   /* Wait for all of the events */
+#define NXEVENT_WAIT_NOCLEAR  (1 << 1)   /* Leave the received events set */
+
+#define NXEVENT_INITIALIZER(event, events) \
+  {LIST_INITIAL_VALUE((event).waitlist), (events)}
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+typedef uint32_t nxevent_mask_t;
+
+/* An event group: a set of event bits and the tasks waiting for them */
+
+struct nxevent_s
+{
+  struct list_node waitlist;       /* Waiting tasks, see event/event.h */
+  volatile nxevent_mask_t events;  /* Events that are set */
+};
+
+typedef struct nxevent_s nxevent_t;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: nxevent_init
+ *
+ * Description:
+ *   Initialize an event group.
+ *
+ * Input Parameters:
+ *   event  - The event group
+ *   events - The events that are initially set
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int nxevent_init(FAR nxevent_t *event, nxevent_mask_t events);
+
+/****************************************************************************
+ * Name: nxevent_destroy
+ *
+ * Description:
+ *   Destroy an event group.  No task may be waiting for it.
+ *
+ * Input Parameters:
+ *   event - The event group
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int nxevent_destroy(FAR nxevent_t *event);
+
+/****************************************************************************
+ * Name: nxevent_post
+ *
+ * Description:
+ *   Set events and wake up every task whose wait condition is now met.
+ *   May be called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   event  - The event group
+ *   events - The events to set
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int nxevent_post(FAR nxevent_t *event, nxevent_mask_t events);
+
+/****************************************************************************
+ * Name: nxevent_clear
+ *
+ * Description:
+ *   Clear events.  May be called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   event  - The event group
+ *   events - The events to clear
+ *
+ * Returned Value:
+ *   The events that were set before they were cleared.
+ *
+ ****************************************************************************/
+
+nxevent_mask_t nxevent_clear(FAR nxevent_t *event, nxevent_mask_t events);
+
+/****************************************************************************
+ * Name: nxevent_wait, nxevent_tickwait and nxevent_trywait
+ *
+ * Description:
+ *   Wait until any (NXEVENT_WAIT_ANY) or all (NXEVENT_WAIT_ALL) of the
+ *   events are set.  The received events are cleared unless
+ *   NXEVENT_WAIT_NOCLEAR is given.  nxevent_tickwait() gives up after
+ *   'delay' ticks and nxevent_trywait() does not wait at all.  Every task
+ *   whose condition is met by the same post receives the events.
+ *
+ * Input Parameters:
+ *   event  - The event group
+ *   events - The events to wait for
+ *   eflags - NXEVENT_WAIT_* flags
+ *   delay  - Maximum time to wait, in clock ticks
+ *
+ * Returned Value:
+ *   The received events, that is the waited-for events that were set.
+ *   Zero if the wait timed out or the condition was not met.
+ *
+ ****************************************************************************/
+
+nxevent_mask_t nxevent_wait(FAR nxevent_t *event, nxevent_mask_t events,
+                            int eflags);
+nxevent_mask_t nxevent_tickwait(FAR nxevent_t *event, nxevent_mask_t events,
+                                int eflags, uint32_t delay);
+nxevent_mask_t nxevent_trywait(FAR nxevent_t *event, nxevent_mask_t events,
+                               int eflags);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_SCHED_EVENTS */
+#endif /* __INCLUDE_NUTTX_EVENT_H */
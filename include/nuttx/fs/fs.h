@@ -172,6 +172,7 @@ struct inode;
 struct stat;
 struct statfs;
 struct pollfd;
+struct iovec;
 struct mtd_dev_s;
 struct tcb_s;
 
@@ -229,6 +230,16 @@ struct file_operations
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   CODE int     (*unlink)(FAR struct inode *inode);
 #endif
+
+  /* Optional vectored transfers, used by readv() and writev() to move all
+   * the buffers in one driver transaction.  Without them, each buffer is
+   * transferred with read() or write() in turn.
+   */
+
+  CODE ssize_t (*readv)(FAR struct file *filep, FAR const struct iovec *iov,
+                        int iovcnt);
+  CODE ssize_t (*writev)(FAR struct file *filep,
+                         FAR const struct iovec *iov, int iovcnt);
 };
 
 /* This structure provides information about the state of a block driver */
@@ -268,6 +279,47 @@ struct partition_info_s
  */
 
 struct inode;
+
+#ifdef CONFIG_FS_BLOCK_ASYNC
+/* An asynchronous block transfer, see the submit method below.  The
+ * structure belongs to the driver from submit() until complete() is called;
+ * complete() may free it.
+ */
+
+struct blk_request_s;
+typedef CODE void (*blk_complete_t)(FAR struct blk_request_s *req,
+                                    ssize_t result);
+
+struct blk_request_s
+{
+  FAR struct blk_request_s *flink;  /* Used by the driver while queued */
+  FAR unsigned char *buffer;        /* Data to write or buffer to read into */
+  blkcnt_t start_sector;            /* First sector of the transfer */
+  unsigned int nsectors;            /* Number of sectors */
+  bool write;                       /* True to write, false to read */
+  blk_complete_t complete;          /* Called once, from a thread, with the
+                                     * number of sectors transferred or a
+                                     * negated errno value */
+  FAR void *priv;                   /* For use by the submitter */
+};
+
+/* A queue of requests served by a thread of its own, with the synchronous
+ * read and write methods of the driver.  See blk_queue_submit().
+ */
+
+struct blk_queue_s
+{
+  FAR struct blk_request_s *head;   /* Pending requests, oldest first */
+  FAR struct blk_request_s *tail;   /* Last pending request */
+  FAR struct inode *inode;          /* The driver that runs the requests */
+  mutex_t lock;                     /* Protects the list */
+  sem_t sem;                        /* Posted for each request and on stop */
+  sem_t exitsem;                    /* Posted when the thread exits */
+  pid_t pid;                        /* The thread, 0 until it is started */
+  bool stop;                        /* The queue is being torn down */
+};
+#endif
+
 struct block_operations
 {
   CODE int     (*open)(FAR struct inode *inode);
@@ -283,6 +335,15 @@ struct block_operations
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   CODE int     (*unlink)(FAR struct inode *inode);
 #endif
+#ifdef CONFIG_FS_BLOCK_ASYNC
+  /* Start a transfer and return at once.  On success, req->complete() is
+   * called when the transfer ends, possibly before submit() returns.  On
+   * failure it is not called.  Optional.
+   */
+
+  CODE int     (*submit)(FAR struct inode *inode,
+                         FAR struct blk_request_s *req);
+#endif
 };
 
 /* This structure is provided by a filesystem to describe a mount point.
@@ -632,6 +693,87 @@ int register_blockpartition(FAR const char *partition,
                             off_t firstsector, off_t nsectors);
 #endif
 
+/****************************************************************************
+ * Name: register_blockcache
+ *
+ * Description:
+ *   Register a block driver inode at 'path' that caches the sectors of the
+ *   block driver at 'parent' in the page pool shared by all cached devices
+ *   (see CONFIG_FS_BLOCKCACHE).  The cache is written back when the device
+ *   is closed or on BIOC_FLUSH, and dropped when the media changes.
+ *
+ * Input Parameters:
+ *   path   - The path to the cache inode
+ *   mode   - Access mode; the parent must be writable if any write bit is
+ *            set
+ *   parent - The path to the cached block driver
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure:
+ *
+ *   EINVAL - The sector size of the parent exceeds the page size
+ *   EEXIST - An inode already exists at 'path'
+ *   ENOMEM - Failed to allocate the device or the page pool
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLOCKCACHE
+int register_blockcache(FAR const char *path, mode_t mode,
+                        FAR const char *parent);
+#endif
+
+/****************************************************************************
+ * Name: blk_queue_initialize
+ *
+ * Description:
+ *   Initialize a request queue for a block driver that implements the
+ *   submit method with blk_queue_submit().  The thread that serves the
+ *   queue is created by the first request.
+ *
+ * Input Parameters:
+ *   queue - The queue to initialize
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLOCK_ASYNC
+void blk_queue_initialize(FAR struct blk_queue_s *queue);
+
+/****************************************************************************
+ * Name: blk_queue_submit
+ *
+ * Description:
+ *   Queue a request.  The requests of a queue are run in order by its
+ *   thread, with the read and write methods of the driver, so a driver
+ *   gets asynchronous transfers without changes to its I/O path.
+ *
+ * Input Parameters:
+ *   queue - The queue of the driver
+ *   inode - The inode of the driver
+ *   req   - The request
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was queued; a negated errno value if the
+ *   thread could not be created or the queue is being torn down.
+ *
+ ****************************************************************************/
+
+int blk_queue_submit(FAR struct blk_queue_s *queue, FAR struct inode *inode,
+                     FAR struct blk_request_s *req);
+
+/****************************************************************************
+ * Name: blk_queue_uninitialize
+ *
+ * Description:
+ *   Run the requests still queued, stop the thread and release the queue.
+ *
+ * Input Parameters:
+ *   queue - The queue to release
+ *
+ ****************************************************************************/
+
+void blk_queue_uninitialize(FAR struct blk_queue_s *queue);
+#endif
+
 /****************************************************************************
  * Name: unregister_driver
  *
@@ -1248,6 +1390,49 @@ ssize_t file_read(FAR struct file *filep, FAR void *buf, size_t nbytes);
 
 ssize_t nx_read(int fd, FAR void *buf, size_t nbytes);
 
+/****************************************************************************
+ * Name: file_readv
+ *
+ * Description:
+ *   Equivalent to the standard readv() function except that it accepts a
+ *   struct file instance instead of a file descriptor, does not modify the
+ *   errno variable and is not a cancellation point.
+ *
+ * Input Parameters:
+ *   filep  - File structure instance
+ *   iov    - The buffers to fill, in order
+ *   iovcnt - Number of buffers
+ *
+ * Returned Value:
+ *   The number of bytes read on success, 0 on an end-of-file condition, or
+ *   a negated errno value if nothing could be read.
+ *
+ ****************************************************************************/
+
+ssize_t file_readv(FAR struct file *filep, FAR const struct iovec *iov,
+                   int iovcnt);
+
+/****************************************************************************
+ * Name: nx_readv
+ *
+ * Description:
+ *   nx_readv() is an internal OS function equivalent to readv() except
+ *   that it does not modify the errno variable and is not a cancellation
+ *   point.
+ *
+ * Input Parameters:
+ *   fd     - File descriptor to read from
+ *   iov    - The buffers to fill, in order
+ *   iovcnt - Number of buffers
+ *
+ * Returned Value:
+ *   The number of bytes read on success, 0 on an end-of-file condition, or
+ *   a negated errno value if nothing could be read.
+ *
+ ****************************************************************************/
+
+ssize_t nx_readv(int fd, FAR const struct iovec *iov, int iovcnt);
+
 /****************************************************************************
  * Name: file_write
  *
@@ -1304,6 +1489,49 @@ ssize_t file_write(FAR struct file *filep, FAR const void *buf,
 
 ssize_t nx_write(int fd, FAR const void *buf, size_t nbytes);
 
+/****************************************************************************
+ * Name: file_writev
+ *
+ * Description:
+ *   Equivalent to the standard writev() function except that it accepts a
+ *   struct file instance instead of a file descriptor, does not modify the
+ *   errno variable and is not a cancellation point.
+ *
+ * Input Parameters:
+ *   filep  - Instance of struct file to use with the write
+ *   iov    - The buffers to write, in order
+ *   iovcnt - Number of buffers
+ *
+ * Returned Value:
+ *   The number of bytes written on success, or a negated errno value if
+ *   nothing could be written.
+ *
+ ****************************************************************************/
+
+ssize_t file_writev(FAR struct file *filep, FAR const struct iovec *iov,
+                    int iovcnt);
+
+/****************************************************************************
+ * Name: nx_writev
+ *
+ * Description:
+ *   nx_writev() is an internal OS function equivalent to writev() except
+ *   that it does not modify the errno variable and is not a cancellation
+ *   point.
+ *
+ * Input Parameters:
+ *   fd     - file descriptor (or socket descriptor) to write to
+ *   iov    - The buffers to write, in order
+ *   iovcnt - Number of buffers
+ *
+ * Returned Value:
+ *   The number of bytes written on success, or a negated errno value if
+ *   nothing could be written.
+ *
+ ****************************************************************************/
+
+ssize_t nx_writev(int fd, FAR const struct iovec *iov, int iovcnt);
+
 /****************************************************************************
  * Name: file_pread
  *
@@ -1407,6 +1635,23 @@ int file_truncate(FAR struct file *filep, off_t length);
 int file_mmap(FAR struct file *filep, FAR void *start, size_t length,
               int prot, int flags, off_t offset, FAR void **mapped);
 
+/****************************************************************************
+ * Name: file_xipmap
+ *
+ * Description:
+ *   Return the address at which 'length' bytes of the file at 'offset' can
+ *   be read in place, for example a ROMFS file on a medium that supports
+ *   BIOC_XIPBASE.  Unlike file_mmap(), this never falls back to copying
+ *   the file into RAM and needs no munmap().
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOTTY if the file cannot be read in place.
+ *
+ ****************************************************************************/
+
+int file_xipmap(FAR struct file *filep, off_t offset, size_t length,
+                FAR const void **mapped);
+
 /****************************************************************************
  * Name: file_mummap
  *
@@ -27,6 +27,7 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdbool.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -97,6 +98,7 @@
 #define _CELLIOCBASE    (0x3800) /* Cellular device ioctl commands */
 #define _MIPIDSIBASE    (0x3900) /* Mipidsi device ioctl commands */
 #define _SYSLOGBASE     (0x3c00) /* Syslog device ioctl commands */
+#define _USRSOCKBASE    (0x3d00) /* Usrsock device ioctl commands */
 #define _WLIOCBASE      (0x8b00) /* Wireless modules ioctl network commands */
 
 /* boardctl() commands share the same number space */
@@ -198,6 +200,21 @@
                                            */
 #endif
 
+#define FIOC_LFSSTATS   _FIOC(0x0010)     /* IN:  FAR struct littlefs_stats_s *
+                                           * OUT: The statistics of the
+                                           *      littlefs volume of the file
+                                           */
+#define FIOC_GCSTEP     _FIOC(0x0011)     /* IN:  Most units (e.g. erase blocks)
+                                           *      to garbage collect now
+                                           * OUT: None (ioctl return value is
+                                           *      the number collected)
+                                           */
+#define FIOC_GCLIMIT    _FIOC(0x0012)     /* IN:  Most units that background
+                                           *      garbage collection may collect
+                                           *      each time, zero to disable it
+                                           * OUT: None
+                                           */
+
 /* NuttX file system ioctl definitions **************************************/
 
 #define _DIOCVALID(c)   (_IOC_TYPE(c)==_DIOCBASE)
@@ -311,6 +328,18 @@
                                            *      to return sector numbers.
                                            * OUT: Data return in user-provided
                                            *      buffer. */
+#define BIOC_IDLECOLLECT _BIOC(0x0011)    /* Garbage collect SMART flash erase
+                                           * blocks ahead of need.
+                                           * IN:  Most erase blocks to collect
+                                           * OUT: None (ioctl return value is the
+                                           *      number of blocks collected). */
+#define BIOC_SUBMIT     _BIOC(0x0012)     /* Start an asynchronous transfer on
+                                           * the block driver behind a BCH
+                                           * character device.
+                                           * IN:  Pointer to a struct
+                                           *      blk_request_s
+                                           * OUT: None.  -ENOTTY if the driver
+                                           *      has no submit method. */
 
 /* NuttX MTD driver ioctl definitions ***************************************/
 
@@ -458,6 +487,14 @@
                                                * IN: pipe_peek_s
                                                * OUT: Length of data */
 
+#define PIPEIOC_SPLICE      _PIPEIOC(0x0005)  /* Move data between the
+                                               * pipe buffer and another
+                                               * file, without a copy
+                                               * through a user buffer.
+                                               * IN: pipe_splice_s
+                                               * OUT: Number of bytes
+                                               *      moved */
+
 /* RTC driver ioctl definitions *********************************************/
 
 /* (see nuttx/include/rtc.h */
@@ -656,6 +693,11 @@
 #define _SYSLOGVALID(c) (_IOC_TYPE(c)==_SYSLOGBASE)
 #define _SYSLOGIOC(nr)  _IOC(_SYSLOGBASE,nr)
 
+/* usrsock driver ioctl definitions *****************************************/
+
+#define _USRSOCKIOCVALID(c) (_IOC_TYPE(c)==_USRSOCKBASE)
+#define _USRSOCKIOC(nr)     _IOC(_USRSOCKBASE,nr)
+
 /* Wireless driver network ioctl definitions ********************************/
 
 /* (see nuttx/include/wireless/wireless.h */
@@ -678,6 +720,19 @@ struct pipe_peek_s
   size_t size;
 };
 
+/* Argument of PIPEIOC_SPLICE.  The other file may not be a pipe: the pipe
+ * stays locked while the other file is accessed.
+ */
+
+struct file;
+struct pipe_splice_s
+{
+  FAR struct file *filep;   /* The other file */
+  size_t size;              /* Most bytes to move */
+  bool out;                 /* true: from the pipe to the file;
+                             * false: from the file to the pipe */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -0,0 +1,70 @@
+/****************************************************************************
+ * include/nuttx/fs/littlefs.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FS_LITTLEFS_H
+#define __INCLUDE_NUTTX_FS_LITTLEFS_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Returned by the FIOC_LFSSTATS ioctl on any file of a littlefs volume.
+ * The counters start at zero when the volume is mounted.
+ */
+
+struct littlefs_stats_s
+{
+  /* Device operations issued by littlefs */
+
+  uint32_t nreads;          /* Reads */
+  uint32_t nprogs;          /* Programs */
+  uint32_t nerases;         /* Block erases */
+  uint32_t nsyncs;          /* Device flushes */
+  uint64_t readbytes;       /* Bytes read */
+  uint64_t progbytes;       /* Bytes programmed */
+
+  /* Block allocator.  The lookahead window is the range of blocks whose
+   * state is known without scanning the file system again.  A new scan
+   * is made each time the window is used up.
+   */
+
+  uint32_t lookahead_off;   /* First block of the window */
+  uint32_t lookahead_size;  /* Blocks in the window */
+  uint32_t lookahead_next;  /* Blocks of the window already examined */
+  uint32_t lookahead_ack;   /* Blocks left before the volume is full */
+  uint32_t block_count;     /* Blocks on the volume */
+
+  /* Shared file caches, see CONFIG_FS_LITTLEFS_FILE_CACHES */
+
+  uint16_t ncaches;         /* Caches in the pool */
+  uint16_t cachesinuse;     /* Caches in use now */
+  uint16_t cachespeak;      /* Most caches in use at once */
+  uint16_t cachemisses;     /* Opens that allocated from the heap */
+};
+
+#endif /* __INCLUDE_NUTTX_FS_LITTLEFS_H */
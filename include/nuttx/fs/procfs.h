@@ -144,6 +144,58 @@ struct procfs_meminfo_entry_s
 #endif
 };
 
+/* The binary snapshot read from /proc/stat.bin: a header followed by
+ * 'nheaps' heap records and then 'ntasks' task records.  The size of each
+ * kind of record is given in the header, so that a reader can skip the
+ * fields added by a later version.  All fields have their natural
+ * alignment, the byte order is the one of the target.
+ */
+
+#define PROCFS_STATBIN_MAGIC    0x5453584e  /* "NXST" */
+#define PROCFS_STATBIN_VERSION  1
+#define PROCFS_STATBIN_NAMELEN  32
+
+struct procfs_statbin_hdr_s
+{
+  uint32_t magic;                           /* PROCFS_STATBIN_MAGIC */
+  uint16_t version;                         /* PROCFS_STATBIN_VERSION */
+  uint16_t hdrsize;                         /* Size of this header */
+  uint16_t heapsize;                        /* Size of a heap record */
+  uint16_t tasksize;                        /* Size of a task record */
+  uint16_t nheaps;                          /* Number of heap records */
+  uint16_t ntasks;                          /* Number of task records */
+  uint32_t tickspersec;                     /* Clock ticks per second */
+  uint32_t reserved;
+  uint64_t uptime;                          /* System time in clock ticks */
+};
+
+struct procfs_statbin_heap_s
+{
+  char     name[PROCFS_STATBIN_NAMELEN];    /* Name of the heap */
+  uint32_t arena;                           /* Total size of the heap */
+  uint32_t uordblks;                        /* Bytes in use */
+  uint32_t fordblks;                        /* Bytes free */
+  uint32_t mxordblk;                        /* Largest free chunk */
+  uint32_t aordblks;                        /* Number of allocated chunks */
+  uint32_t ordblks;                         /* Number of free chunks */
+};
+
+struct procfs_statbin_task_s
+{
+  char     name[PROCFS_STATBIN_NAMELEN];    /* Name of the thread, if kept */
+  int32_t  pid;                             /* ID of the thread */
+  int32_t  group;                           /* ID of the main thread */
+  uint16_t flags;                           /* TCB_FLAG_* */
+  uint8_t  state;                           /* enum tstate_e */
+  uint8_t  priority;                        /* Current priority */
+  uint8_t  basepriority;                    /* Priority before any boost */
+  uint8_t  reserved[3];
+  uint32_t stacksize;                       /* Size of the stack */
+  uint32_t stackused;                       /* Stack used, or zero */
+  uint32_t cputotal;                        /* CPU load: all ticks */
+  uint32_t cpuactive;                       /* CPU load: thread ticks */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -291,6 +343,25 @@ void procfs_register_meminfo(FAR struct procfs_meminfo_entry_s *entry);
 
 void procfs_unregister_meminfo(FAR struct procfs_meminfo_entry_s *entry);
 
+/****************************************************************************
+ * Name: procfs_meminfo_snapshot
+ *
+ * Description:
+ *   Return the statistics of the heaps registered for meminfo in binary
+ *   form, for /proc/stat.bin.
+ *
+ * Input Parameters:
+ *   heaps  - The records to fill, or NULL to only count the heaps
+ *   nheaps - The capacity of 'heaps'
+ *
+ * Returned Value:
+ *   The number of heaps that are registered.
+ *
+ ****************************************************************************/
+
+size_t procfs_meminfo_snapshot(FAR struct procfs_statbin_heap_s *heaps,
+                               size_t nheaps);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -44,6 +44,16 @@
 #define OSINIT_IDLELOOP()        (g_nx_initstate >= OSINIT_IDLELOOP)
 #define OSINIT_OS_INITIALIZING() (g_nx_initstate  < OSINIT_OSREADY)
 
+/* Record the end of a serial boot stage, which started at the end of the
+ * previous one (see boottrace_stage()).
+ */
+
+#ifdef CONFIG_SCHED_BOOTTRACE
+#  define BOOTTRACE_STAGE(name)  boottrace_stage(name)
+#else
+#  define BOOTTRACE_STAGE(name)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -71,6 +81,17 @@ enum nx_initstate_e
   OSINIT_IDLELOOP  = 6   /* The OS enter idle loop */
 };
 
+#ifdef CONFIG_SCHED_BOOTTRACE
+/* One entry of the boot trace.  Times are up_perf_gettime() values. */
+
+struct boottrace_s
+{
+  FAR const char *name;   /* Name of the stage, a string constant */
+  unsigned long start;    /* Time at the start of the stage */
+  unsigned long end;      /* Time at the end of the stage */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -90,6 +111,16 @@ extern "C"
 
 EXTERN uint8_t g_nx_initstate;  /* See enum nx_initstate_e */
 
+#ifdef CONFIG_SCHED_BOOTTRACE
+/* The boot trace reported by /proc/boottime, in the order of the ends of
+ * the stages.  Stages that do not fit are counted in g_boottrace_dropped.
+ */
+
+EXTERN struct boottrace_s g_boottrace[CONFIG_SCHED_BOOTTRACE_NENTRIES];
+EXTERN int g_nboottrace;
+EXTERN uint32_t g_boottrace_dropped;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -100,6 +131,35 @@ EXTERN uint8_t g_nx_initstate;  /* See enum nx_initstate_e */
 
 void nx_start(void);
 
+#ifdef CONFIG_SCHED_BOOTTRACE
+/****************************************************************************
+ * Name: boottrace_record
+ *
+ * Description:
+ *   Add a stage that started at 'start' and ends now to the boot trace.
+ *   Used for stages that run in parallel, such as those of
+ *   board_initcall_start().
+ *
+ * Input Parameters:
+ *   name  - Name of the stage; must stay valid, normally a string constant
+ *   start - up_perf_gettime() at the start of the stage
+ *
+ ****************************************************************************/
+
+void boottrace_record(FAR const char *name, unsigned long start);
+
+/****************************************************************************
+ * Name: boottrace_stage
+ *
+ * Description:
+ *   Add a stage of the serial boot sequence that started at the end of the
+ *   previous serial stage, or at reset for the first one, and ends now.
+ *
+ ****************************************************************************/
+
+void boottrace_stage(FAR const char *name);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -26,6 +26,17 @@
  * For multiple writer and one reader there is only a need to lock the
  * writer. And vice versa for only one writer and multiple reader there is
  * only a need to lock the reader.
+ *
+ * In this single producer, single consumer mode the writer may be an
+ * interrupt handler and the reader a task, or they may run on different
+ * CPUs: the head and tail updates are ordered so that neither side needs
+ * to disable interrupts.  The writer uses circbuf_write(),
+ * circbuf_get_writeptr() and circbuf_writecommit(); the reader uses
+ * circbuf_peek(), circbuf_peekat(), circbuf_read(), circbuf_skip(),
+ * circbuf_get_readptr() and circbuf_readcommit().  Either side may call
+ * circbuf_used() and circbuf_space().  circbuf_overwrite(),
+ * circbuf_reset() and circbuf_resize() move both indices and need
+ * exclusive access.
  */
 
 /****************************************************************************
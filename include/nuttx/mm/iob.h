@@ -27,6 +27,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/uio.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -70,6 +71,17 @@
 #  error CONFIG_IOB_NBUFFERS <= CONFIG_IOB_THROTTLE
 #endif
 
+/* Small I/O buffers are optional */
+
+#if !defined(CONFIG_IOB_SMALL_NBUFFERS)
+#  define CONFIG_IOB_SMALL_NBUFFERS 0
+#endif
+
+#if CONFIG_IOB_SMALL_NBUFFERS > 0 && \
+    CONFIG_IOB_SMALL_BUFSIZE >= CONFIG_IOB_BUFSIZE
+#  error CONFIG_IOB_SMALL_BUFSIZE >= CONFIG_IOB_BUFSIZE
+#endif
+
 /* Default config of alignment and head padding size */
 
 #if !defined(CONFIG_IOB_ALIGNMENT)
@@ -78,8 +90,14 @@
 
 /* IOB helpers */
 
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+#  define IOB_BUFSIZE(p) ((p)->io_bufsize)
+#else
+#  define IOB_BUFSIZE(p) CONFIG_IOB_BUFSIZE
+#endif
+
 #define IOB_DATA(p)      (&(p)->io_data[(p)->io_offset])
-#define IOB_FREESPACE(p) (CONFIG_IOB_BUFSIZE - (p)->io_len - (p)->io_offset)
+#define IOB_FREESPACE(p) (IOB_BUFSIZE(p) - (p)->io_len - (p)->io_offset)
 
 #if CONFIG_IOB_NCHAINS > 0
 /* Queue helpers */
@@ -94,7 +112,8 @@
 
 /* Represents one I/O buffer.  A packet is contained by one or more I/O
  * buffers in a chain.  The io_pktlen is only valid for the I/O buffer at
- * the head of the chain.
+ * the head of the chain.  A small I/O buffer has only IOB_BUFSIZE() bytes
+ * of io_data[] behind it.
  */
 
 struct iob_s
@@ -108,9 +127,15 @@ struct iob_s
 #if CONFIG_IOB_BUFSIZE < 256
   uint8_t  io_len;      /* Length of the data in the entry */
   uint8_t  io_offset;   /* Data begins at this offset */
+#  if CONFIG_IOB_SMALL_NBUFFERS > 0
+  uint8_t  io_bufsize;  /* Size of io_data[], see IOB_BUFSIZE() */
+#  endif
 #else
   uint16_t io_len;      /* Length of the data in the entry */
   uint16_t io_offset;   /* Data begins at this offset */
+#  if CONFIG_IOB_SMALL_NBUFFERS > 0
+  uint16_t io_bufsize;  /* Size of io_data[], see IOB_BUFSIZE() */
+#  endif
 #endif
   unsigned int io_pktlen; /* Total length of the packet */
 
@@ -203,6 +228,29 @@ FAR struct iob_s *iob_alloc(bool throttled);
 
 FAR struct iob_s *iob_tryalloc(bool throttled);
 
+/****************************************************************************
+ * Name: iob_alloc_size
+ *
+ * Description:
+ *   Allocate an I/O buffer for a packet of 'size' bytes.  A small I/O
+ *   buffer is returned if the packet fits in one and one is free;
+ *   otherwise this behaves like iob_alloc().  Use IOB_BUFSIZE() rather
+ *   than CONFIG_IOB_BUFSIZE for the capacity of the buffer returned.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_size(bool throttled, unsigned int size);
+
+/****************************************************************************
+ * Name: iob_tryalloc_size
+ *
+ * Description:
+ *   Like iob_alloc_size(), but without waiting for a buffer to become free.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_size(bool throttled, unsigned int size);
+
 /****************************************************************************
  * Name: iob_navail
  *
@@ -592,6 +640,28 @@ int iob_update_pktlen(FAR struct iob_s *iob, unsigned int pktlen,
 
 int iob_count(FAR struct iob_s *iob);
 
+/****************************************************************************
+ * Name: iob_iovec
+ *
+ * Description:
+ *   Describe the data of an I/O buffer chain as a list of segments, one per
+ *   non-empty IOB, for drivers that hand the chain to a scatter-gather DMA
+ *   without copying it.  The segments point into the IOBs, which must not
+ *   be modified or freed while the list is in use.
+ *
+ * Input Parameters:
+ *   iob    - The head of the I/O buffer chain
+ *   iov    - The list of segments to fill
+ *   iovcnt - The number of entries in 'iov'
+ *
+ * Returned Value:
+ *   The number of segments filled; -E2BIG if the chain has more non-empty
+ *   IOBs than 'iovcnt'.
+ *
+ ****************************************************************************/
+
+int iob_iovec(FAR struct iob_s *iob, FAR struct iovec *iov, int iovcnt);
+
 /****************************************************************************
  * Name: iob_dump
  *
@@ -139,6 +139,50 @@
 
 struct mm_heap_s; /* Forward reference */
 
+/* The description of a new heap, see mm_initialize_heap() */
+
+struct mm_heap_config_s
+{
+  FAR const char *name;  /* Name in /proc/meminfo, may be NULL */
+  FAR void *start;       /* Start of the initial heap region */
+  size_t size;           /* Size of the initial heap region */
+  bool nokasan;          /* KASan does not check the heap if MM_KASAN */
+};
+
+/* Statistics of the frees that were delayed because the heap mutex could
+ * not be taken, see mm_delayfree_stats().
+ */
+
+#ifdef CONFIG_MM_HEAP_DELAYFREE_WORKER
+struct mm_delayfree_stats_s
+{
+  uint32_t ndelayed;   /* Number of frees that were delayed */
+  uint32_t ndrained;   /* Number of delayed blocks that were freed */
+  uint32_t npending;   /* Number of blocks waiting on the delay lists */
+  uint32_t maxpending; /* Most blocks that were waiting at once */
+  uint32_t nruns;      /* Number of worker runs */
+};
+#endif
+
+/* Free memory distribution of a heap, see mm_fraginfo().  Bin n counts the
+ * free chunks of 2^(minshift + n) up to 2^(minshift + n + 1) - 1 bytes,
+ * the last bin in use also counts all larger chunks.
+ */
+
+#ifdef CONFIG_MM_HEAP_FRAGINFO
+#define MM_FRAGINFO_NBINS 24
+
+struct mm_fraginfo_s
+{
+  uint8_t  minshift;                   /* log2 of the size of bin 0 */
+  uint8_t  nbins;                      /* Number of bins in use */
+  uint16_t fragindex;                  /* 1000 * (1 - largest / free) */
+  size_t   lowfree;                    /* Least free memory since boot */
+  size_t   nchunks[MM_FRAGINFO_NBINS]; /* Free chunks in each bin */
+  size_t   nbytes[MM_FRAGINFO_NBINS];  /* Free bytes in each bin */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -199,6 +243,8 @@ EXTERN FAR struct mm_heap_s *g_kmmheap;
 
 FAR struct mm_heap_s *mm_initialize(FAR const char *name,
                                     FAR void *heap_start, size_t heap_size);
+FAR struct mm_heap_s *
+mm_initialize_heap(FAR const struct mm_heap_config_s *config);
 void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
                   size_t heapsize);
 void mm_uninitialize(FAR struct mm_heap_s *heap);
@@ -316,6 +362,25 @@ bool umm_heapmember(FAR void *mem);
 bool kmm_heapmember(FAR void *mem);
 #endif
 
+/* Functions contained in mm_mallinfo.c *************************************/
+
+#ifdef CONFIG_MM_HEAP_DELAYFREE_WORKER
+void mm_delayfree_stats(FAR struct mm_heap_s *heap,
+                        FAR struct mm_delayfree_stats_s *stats);
+#endif
+
+#ifdef CONFIG_MM_HEAP_FRAGINFO
+void mm_fraginfo(FAR struct mm_heap_s *heap,
+                 FAR struct mm_fraginfo_s *info);
+#endif
+
+/* Functions contained in mm_tcache.c ***************************************/
+
+#ifdef CONFIG_MM_HEAP_TCACHE
+struct mm_tcache_s; /* Forward reference */
+void mm_tcache_release(FAR struct mm_tcache_s *tcache);
+#endif
+
 /* Functions contained in mm_brkaddr.c **************************************/
 
 FAR void *mm_brkaddr(FAR struct mm_heap_s *heap, int region);
@@ -88,6 +88,14 @@
 #  define MQ_WNELIST(cmn)             (&((cmn).waitfornotempty))
 #  define MQ_WNFLIST(cmn)             (&((cmn).waitfornotfull))
 
+/* Buffers reserved with file_mq_reserve() count against mq_maxmsg */
+
+#ifdef CONFIG_MQ_LOAN
+#  define MQ_NMSGS(msgq)              ((msgq)->nmsgs + (msgq)->nreserved)
+#else
+#  define MQ_NMSGS(msgq)              ((msgq)->nmsgs)
+#endif
+
 /****************************************************************************
  * Public Type Declarations
  ****************************************************************************/
@@ -122,6 +130,11 @@ struct mqueue_inode_s
   struct sigwork_s ntwork;    /* Notification work */
 #endif
   FAR struct pollfd *fds[CONFIG_FS_MQUEUE_NPOLLWAITERS];
+#ifdef CONFIG_MQ_LOAN
+  FAR void *pool;             /* Messages pre-allocated for this queue */
+  struct list_node msgpool;   /* Free messages of the pool */
+  int16_t nreserved;          /* Number of reserved, uncommitted messages */
+#endif
 };
 
 /****************************************************************************
@@ -703,6 +716,100 @@ int file_mq_setattr(FAR struct file *mq, FAR const struct mq_attr *mq_stat,
 
 int file_mq_getattr(FAR struct file *mq, FAR struct mq_attr *mq_stat);
 
+/****************************************************************************
+ * Name: file_mq_reserve
+ *
+ * Description:
+ *   Reserve a message buffer of at least mq_msgsize bytes, waiting for the
+ *   queue to become non-full like file_mq_send().  The message is built
+ *   in place and then passed to file_mq_commit(), or given back with
+ *   file_mq_release().  The message holds its place in the queue until
+ *   then.  From an interrupt handler, -EAGAIN is returned if the queue is
+ *   full.
+ *
+ * Input Parameters:
+ *   mq     - Message queue descriptor
+ *   buffer - Location to return the message buffer
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure (see
+ *   file_mq_send()).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MQ_LOAN
+int file_mq_reserve(FAR struct file *mq, FAR char **buffer);
+#endif
+
+/****************************************************************************
+ * Name: file_mq_commit
+ *
+ * Description:
+ *   Send a message reserved by file_mq_reserve() without copying it.  The
+ *   buffer must not be accessed afterwards.  May be called from an
+ *   interrupt handler.  On failure, the message is still reserved and
+ *   must be given back with file_mq_release().
+ *
+ * Input Parameters:
+ *   mq     - Message queue descriptor
+ *   buffer - The reserved message buffer
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MQ_LOAN
+int file_mq_commit(FAR struct file *mq, FAR char *buffer, size_t msglen,
+                   unsigned int prio);
+#endif
+
+/****************************************************************************
+ * Name: file_mq_receive_loan
+ *
+ * Description:
+ *   Receive a message like file_mq_receive(), but return the message
+ *   buffer itself instead of copying it.  The buffer must be given back
+ *   with file_mq_release().
+ *
+ * Input Parameters:
+ *   mq     - Message queue descriptor
+ *   buffer - Location to return the message buffer
+ *   prio   - If not NULL, the location to store message priority.
+ *
+ * Returned Value:
+ *   The length of the message on success; a negated errno value on failure
+ *   (see file_mq_receive()).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MQ_LOAN
+ssize_t file_mq_receive_loan(FAR struct file *mq, FAR char **buffer,
+                             FAR unsigned int *prio);
+#endif
+
+/****************************************************************************
+ * Name: file_mq_release
+ *
+ * Description:
+ *   Give back a buffer obtained by file_mq_reserve() or
+ *   file_mq_receive_loan().  May be called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   mq     - Message queue descriptor
+ *   buffer - The message buffer
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MQ_LOAN
+void file_mq_release(FAR struct file *mq, FAR char *buffer);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -757,6 +757,42 @@ int dhara_initialize_by_path(FAR const char *path,
                              FAR struct mtd_dev_s *mtd);
 #endif
 
+/****************************************************************************
+ * Name: logftl_initialize
+ *
+ * Description:
+ *   Initialize to provide a log-structured FTL block driver around a NOR
+ *   MTD interface.  The MTD must support byte writes.
+ *
+ * Input Parameters:
+ *   minor - The minor device number.  The MTD block device will be
+ *           registered as as /dev/mtdblockN where N is the minor number.
+ *   mtd   - The MTD device that supports the FLASH interface.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_LOGFTL
+int logftl_initialize(int minor, FAR struct mtd_dev_s *mtd);
+#endif
+
+/****************************************************************************
+ * Name: logftl_initialize_by_path
+ *
+ * Description:
+ *   Initialize to provide a log-structured FTL block driver around a NOR
+ *   MTD interface.
+ *
+ * Input Parameters:
+ *   path - The block device path.
+ *   mtd  - The MTD device that supports the FLASH interface.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_LOGFTL
+int logftl_initialize_by_path(FAR const char *path,
+                              FAR struct mtd_dev_s *mtd);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
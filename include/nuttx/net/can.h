@@ -62,6 +62,19 @@
  * Public Types
  ****************************************************************************/
 
+/* Argument of the SIOCSCANRAWFILTER driver ioctl: the union of the
+ * CAN_RAW_FILTER sets of all sockets bound to the device.  A negative
+ * nfilters means that all frames must be accepted; zero means that no
+ * socket wants any frame.
+ */
+
+struct can_filter;
+struct can_rawfilter_s
+{
+  FAR const struct can_filter *filters;
+  int nfilters;
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
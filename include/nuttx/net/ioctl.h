@@ -136,6 +136,30 @@
 #define SIOCGIFBR          _SIOC(0x003A)  /* Bridging support */
 #define SIOCSIFBR          _SIOC(0x003B)  /* Set bridging options */
 
+/* CAN filter offload *******************************************************/
+
+#define SIOCSCANRAWFILTER  _SIOC(0x003C)  /* Set the CAN_RAW_FILTER union of a
+                                           * CAN device (see struct
+                                           * can_rawfilter_s) */
+
+/* TCP zero-copy receive ****************************************************/
+
+#define SIOCTCPZCRECV      _SIOC(0x003D)  /* Take the read-ahead IOB chain of
+                                           * a TCP socket (arg: FAR struct
+                                           * iob_s **) */
+#define SIOCTCPZCRELEASE   _SIOC(0x003E)  /* Return a chain taken by
+                                           * SIOCTCPZCRECV (arg: FAR struct
+                                           * iob_s *) */
+
+/* Hardware packet timestamping *********************************************/
+
+#define SIOCSHWTSTAMP      _SIOC(0x003F)  /* Set the timestamping configuration
+                                           * of a device (ifr_data: FAR struct
+                                           * hwtstamp_config *) */
+#define SIOCGHWTSTAMP      _SIOC(0x0040)  /* Get the timestamping configuration
+                                           * of a device (ifr_data: FAR struct
+                                           * hwtstamp_config *) */
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
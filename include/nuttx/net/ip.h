@@ -243,6 +243,19 @@ struct ipv6_stats_s
                            * were neither ICMP, UDP nor TCP */
 };
 #endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPFRAG
+struct ipfrag_stats_s
+{
+  net_stats_t reass;      /* Number of datagrams reassembled */
+  net_stats_t timeout;    /* Number of datagrams dropped due to
+                           * reassembly timeout */
+  net_stats_t evicted;    /* Number of incomplete datagrams dropped
+                           * to free I/O buffers */
+  net_stats_t overlimit;  /* Number of fragments dropped since their
+                           * source exceeded its reassembly share */
+};
+#endif /* CONFIG_NET_IPFRAG */
 #endif /* CONFIG_NET_STATISTICS */
 
 /****************************************************************************
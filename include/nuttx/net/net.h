@@ -179,6 +179,12 @@ struct sock_intf_s
                     FAR struct file *infile, FAR off_t *offset,
                     size_t count);
 #endif
+  CODE int        (*si_sendmmsg)(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags);
+  CODE int        (*si_recvmmsg)(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags);
 };
 
 /* Each socket refers to a connection structure of type FAR void *.  Each
@@ -218,6 +224,12 @@ struct socket_conn_s
   uint8_t       s_boundto;   /* Index of the interface we are bound to.
                               * Unbound: 0, Bound: 1-MAX_IFINDEX */
 #  endif
+#  ifdef CONFIG_NET_SOPRIORITY
+  uint8_t       s_priority;  /* Transmit priority (SO_PRIORITY) */
+#  endif
+#  ifdef CONFIG_NET_TIMESTAMPING
+  uint16_t      s_tsflags;   /* SOF_TIMESTAMPING_* flags (SO_TIMESTAMPING) */
+#  endif
 #endif
 
   /* Definitions of 8-bit socket flags */
@@ -232,6 +244,10 @@ struct socket_conn_s
   uint8_t       ttl;         /* Default time-to-live */
 #endif
 
+#ifdef CONFIG_NET_CONN_LOCK
+  mutex_t       s_lock;      /* Protects the read-ahead data */
+#endif
+
   /* Connection-specific content may follow */
 };
 
@@ -378,6 +394,32 @@ int net_trylock(void);
 
 void net_unlock(void);
 
+/****************************************************************************
+ * Name: conn_lock and conn_unlock
+ *
+ * Description:
+ *   Take and release the lock of one connection.  It protects the
+ *   read-ahead data of the connection, which may then be consumed without
+ *   the network lock.  The network lock, if needed too, must be taken
+ *   first.
+ *
+ * Input Parameters:
+ *   sconn - The common prologue of the connection
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CONN_LOCK
+#  define conn_lock_init(sconn)    nxmutex_init(&(sconn)->s_lock)
+#  define conn_lock_destroy(sconn) nxmutex_destroy(&(sconn)->s_lock)
+#  define conn_lock(sconn)         nxmutex_lock(&(sconn)->s_lock)
+#  define conn_unlock(sconn)       nxmutex_unlock(&(sconn)->s_lock)
+#else
+#  define conn_lock_init(sconn)
+#  define conn_lock_destroy(sconn)
+#  define conn_lock(sconn)         net_lock()
+#  define conn_unlock(sconn)       net_unlock()
+#endif
+
 /****************************************************************************
  * Name: net_sem_timedwait
  *
@@ -925,6 +967,54 @@ ssize_t psock_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                       int flags);
 
+/****************************************************************************
+ * Name: psock_sendmmsg
+ *
+ * Description:
+ *   psock_sendmmsg() sends a vector of messages to a socket.  It is the
+ *   internal OS interface of sendmmsg(), see psock_sendmsg().
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    The messages to send
+ *   vlen      The number of messages in msgvec
+ *   flags     Send flags
+ *
+ * Returned Value:
+ *   The number of messages sent, with the msg_len of each set to the
+ *   number of bytes sent.  A negated errno value is returned if the first
+ *   message could not be sent.
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags);
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives a vector of messages from a socket.  It is
+ *   the internal OS interface of recvmmsg(), see psock_recvmsg().
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    The buffers to receive the messages
+ *   vlen      The number of messages in msgvec
+ *   flags     Receive flags
+ *   timeout   The time to wait for all vlen messages, or NULL
+ *
+ * Returned Value:
+ *   The number of messages received, with the msg_len of each set to the
+ *   number of bytes received.  A negated errno value is returned if no
+ *   message was received.
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR struct timespec *timeout);
+
 /****************************************************************************
  * Name: psock_send
  *
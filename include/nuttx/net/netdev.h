@@ -52,6 +52,7 @@
 
 #include <sys/ioctl.h>
 #include <stdint.h>
+#include <time.h>
 
 #include <nuttx/queue.h>
 
@@ -168,6 +169,25 @@
 #define IPv4BUF ((FAR struct ipv4_hdr_s *)IPBUF(0))
 #define IPv6BUF ((FAR struct ipv6_hdr_s *)IPBUF(0))
 
+/* Checksum offload capabilities in d_csumcaps.
+ *
+ *   TX: The hardware inserts the TCP and UDP checksums, pseudo-header
+ *       included, of outgoing packets whose checksum field is zero.
+ *   RX: The hardware verifies the checksums of incoming packets and
+ *       discards those that are bad (the IPv4 header checksum too).
+ */
+
+#define NETDEV_CSUM_TX_IPV4     (1 << 0) /* TCP/UDP over IPv4 */
+#define NETDEV_CSUM_TX_IPV6     (1 << 1) /* TCP/UDP over IPv6 */
+#define NETDEV_CSUM_RX_IPV4     (1 << 2) /* IPv4 header and TCP/UDP */
+#define NETDEV_CSUM_RX_IPV6     (1 << 3) /* TCP/UDP over IPv6 */
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+#  define NETDEV_CSUM_OFFLOAD(dev,caps) (((dev)->d_csumcaps & (caps)) != 0)
+#else
+#  define NETDEV_CSUM_OFFLOAD(dev,caps) false
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -271,6 +291,10 @@ struct net_driver_s
 
   uint16_t d_pktsize;           /* Maximum packet size */
 
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  uint8_t d_csumcaps;           /* See NETDEV_CSUM_* definitions */
+#endif
+
   /* Link layer address */
 
 #if defined(CONFIG_NET_ETHERNET) || defined(CONFIG_NET_6LOWPAN) || \
@@ -327,6 +351,15 @@ struct net_driver_s
   FAR struct iob_queue_s d_fragout;
 #endif
 
+#ifdef CONFIG_NETDEV_GRO
+  /* A TCP segment held back to merge the in-order ones that follow */
+
+  FAR struct iob_s *d_groiob;   /* The held segment, NULL if none */
+  uint32_t       d_groseq;      /* Sequence number of the next segment */
+  uint16_t       d_grosum;      /* One's complement sum of the payload */
+  uint8_t        d_gronsegs;    /* Number of segments merged */
+#endif
+
   /* The d_buf array is used to hold incoming and outgoing packets. The
    * device driver should place incoming data into this buffer.  When sending
    * data, the device driver should read the link level headers and the
@@ -383,6 +416,22 @@ struct net_driver_s
 
   uint16_t d_sndlen;
 
+#ifdef CONFIG_NET_TIMESTAMPING
+  /* Hardware packet timestamps.
+   *
+   * d_rxtstamp: Set by the driver before the network input function is
+   *   called to the time the packet in d_buf was received, or to zero if
+   *   the packet was not timestamped.
+   * d_txtstamp: Set by the network when a poll returns a packet whose
+   *   transmit time is requested, NULL otherwise.  The driver saves it
+   *   with the packet and passes it to netdev_txtstamp() once the packet
+   *   has been sent.
+   */
+
+  struct timespec d_rxtstamp;
+  FAR void *d_txtstamp;
+#endif
+
   /* Multicast group support */
 
 #ifdef CONFIG_NET_IGMP
@@ -446,6 +495,10 @@ struct net_driver_s
 
 typedef CODE int (*devif_poll_callback_t)(FAR struct net_driver_s *dev);
 
+/* The link layer input function given to the receive offload */
+
+typedef CODE void (*netdev_gro_input_t)(FAR struct net_driver_s *dev);
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -979,4 +1032,62 @@ void netdev_iob_clear(FAR struct net_driver_s *dev);
 
 void netdev_iob_release(FAR struct net_driver_s *dev);
 
+/****************************************************************************
+ * Name: netdev_gro_receive
+ *
+ * Description:
+ *   Offer a received frame in d_iob to the receive offload.  Consecutive
+ *   in-order TCP segments of the same flow are merged into one IOB chain,
+ *   which then goes through the TCP input processing only once.
+ *
+ *   A driver receiving a batch of frames calls this for each frame and
+ *   netdev_gro_flush() at the end of the batch.
+ *
+ * Returned Value:
+ *   True if the frame was taken.  Otherwise the caller must pass it to
+ *   input() itself; any frame held before it has already been passed on.
+ *
+ * Assumptions:
+ *   The caller has locked the network.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GRO
+bool netdev_gro_receive(FAR struct net_driver_s *dev,
+                        netdev_gro_input_t input);
+
+/****************************************************************************
+ * Name: netdev_gro_flush
+ *
+ * Description:
+ *   Pass the held segment, if any, to the link layer input function.
+ *
+ * Assumptions:
+ *   The caller has locked the network.
+ *
+ ****************************************************************************/
+
+void netdev_gro_flush(FAR struct net_driver_s *dev,
+                      netdev_gro_input_t input);
+#endif
+
+/****************************************************************************
+ * Name: netdev_txtstamp
+ *
+ * Description:
+ *   Report the hardware transmit timestamp of a packet.  'handle' is the
+ *   value of d_txtstamp when the packet was polled.  Handles of sockets
+ *   that have been closed meanwhile are ignored.
+ *
+ * Assumptions:
+ *   Called from the driver's TX completion path, not from an interrupt
+ *   handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TIMESTAMPING
+void netdev_txtstamp(FAR struct net_driver_s *dev, FAR void *handle,
+                     FAR const struct timespec *ts);
+#endif
+
 #endif /* __INCLUDE_NUTTX_NET_NETDEV_H */
@@ -80,6 +80,34 @@
  * Public Type Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_STATISTICS_PERF
+/* The time spent in ipv4_input() and ipv6_input(), in up_perf_gettime()
+ * units.  It covers the processing of a received packet up to the socket
+ * layer, including the reply that is built in place.
+ */
+
+struct netperf_stats_s
+{
+  uint32_t      rxpkts;         /* Number of received packets processed */
+  uint64_t      rxtime;         /* Total processing time */
+  unsigned long rxmax;          /* Longest processing time of a packet */
+};
+#endif
+
+#ifdef CONFIG_NET_6LOWPAN
+/* 6LoWPAN reassembly and IPHC compression statistics */
+
+struct sixlowpan_stats_s
+{
+  net_stats_t reass;      /* Number of packets reassembled from fragments */
+  net_stats_t timeout;    /* Number of reassemblies dropped on timeout */
+  net_stats_t nobuf;      /* Number of first fragments dropped for lack
+                           * of a reassembly buffer */
+  net_stats_t cachehit;   /* Number of IPHC neighbor cache hits */
+  net_stats_t cachemiss;  /* Number of IPHC neighbor cache misses */
+};
+#endif
+
 /* The structure holding the networking statistics that are gathered if
  * CONFIG_NET_STATISTICS is defined.
  */
@@ -94,6 +122,14 @@ struct net_stats_s
   struct ipv6_stats_s ipv6;     /* IPv6 statistics */
 #endif
 
+#ifdef CONFIG_NET_IPFRAG
+  struct ipfrag_stats_s ipfrag; /* IP reassembly statistics */
+#endif
+
+#ifdef CONFIG_NET_6LOWPAN
+  struct sixlowpan_stats_s sixlowpan; /* 6LoWPAN statistics */
+#endif
+
 #ifdef CONFIG_NET_ICMP
   struct icmp_stats_s icmp;     /* ICMP statistics */
 #endif
@@ -117,6 +153,10 @@ struct net_stats_s
 #ifdef CONFIG_NET_UDP
   struct udp_stats_s  udp;      /* UDP statistics */
 #endif
+
+#ifdef CONFIG_NET_STATISTICS_PERF
+  struct netperf_stats_s perf;  /* Packet processing time */
+#endif
 };
 
 /****************************************************************************
@@ -100,6 +100,26 @@ struct udp_stats_s
 };
 #endif
 
+#ifdef CONFIG_NET_UDP_HOOK
+/* A handler of the datagrams received on a local port, registered with
+ * udp_hook_register().  It is called from the network input path with the
+ * network locked, so it must not block.  The datagram is in 'iob': its IP
+ * and UDP headers start at the beginning and its 'len' bytes of payload at
+ * 'offset'.  To answer, the handler writes the reply payload at the same
+ * offset and calls udp_hook_reply().
+ *
+ * The handler returns zero if it consumed the datagram, or a negated errno
+ * value to hand it to the socket layer instead.
+ */
+
+struct net_driver_s;   /* Forward reference */
+struct iob_s;          /* Forward reference */
+
+typedef CODE int (*udp_hook_t)(FAR struct net_driver_s *dev, FAR void *arg,
+                               FAR struct iob_s *iob, unsigned int offset,
+                               unsigned int len);
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -108,4 +128,60 @@ struct udp_stats_s
  * Public Function Prototypes
  ****************************************************************************/
 
+#ifdef CONFIG_NET_UDP_HOOK
+/****************************************************************************
+ * Name: udp_hook_register
+ *
+ * Description:
+ *   Register a handler for the UDP datagrams received on a local port.  The
+ *   handler is called from the network input path, before the socket layer
+ *   is consulted.
+ *
+ * Input Parameters:
+ *   port    - The local port in network order
+ *   handler - The handler to call
+ *   arg     - The argument passed to the handler
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int udp_hook_register(uint16_t port, udp_hook_t handler, FAR void *arg);
+
+/****************************************************************************
+ * Name: udp_hook_unregister
+ *
+ * Description:
+ *   Remove the handler of a local port.
+ *
+ * Input Parameters:
+ *   port - The local port in network order
+ *
+ * Returned Value:
+ *   OK on success; -ENOENT if the port has no handler.
+ *
+ ****************************************************************************/
+
+int udp_hook_unregister(uint16_t port);
+
+/****************************************************************************
+ * Name: udp_hook_reply
+ *
+ * Description:
+ *   Send the payload that a handler wrote in place of the received one back
+ *   to the sender of the datagram.
+ *
+ * Input Parameters:
+ *   dev - The device that received the datagram
+ *   len - The length of the reply payload
+ *
+ * Returned Value:
+ *   OK on success; -EMSGSIZE if the payload does not fit the device MTU.
+ *
+ ****************************************************************************/
+
+int udp_hook_reply(FAR struct net_driver_s *dev, unsigned int len);
+#endif
+
 #endif /* __INCLUDE_NUTTX_NET_UDP_H */
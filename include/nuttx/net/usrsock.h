@@ -33,6 +33,7 @@
 #include <sys/param.h>
 
 #include <nuttx/net/netconfig.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/compiler.h>
 
 /****************************************************************************
@@ -61,6 +62,23 @@
 #define USRSOCK_MESSAGE_REQ_COMPLETED(flags) \
                           (!USRSOCK_MESSAGE_REQ_IN_PROGRESS(flags))
 
+/* /dev/usrsock ioctl commands
+ *
+ * USRSOCKIOC_SHMFLUSH - Handle the records queued in the response ring.
+ *                       Returns the number of records handled.
+ */
+
+#define USRSOCKIOC_SHMFLUSH _USRSOCKIOC(0x0001)
+
+/* Records of the shared-memory rings */
+
+#define USRSOCK_SHMRING_ALIGN     4          /* Alignment of the records */
+#define USRSOCK_SHMRING_WRAP      UINT32_MAX /* Length of the wrap marker */
+
+#define USRSOCK_SHMRING_RECLEN(len) \
+  (sizeof(uint32_t) + \
+   (((len) + USRSOCK_SHMRING_ALIGN - 1) & ~(USRSOCK_SHMRING_ALIGN - 1)))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -266,6 +284,34 @@ begin_packed_struct struct usrsock_message_socket_event_s
   int16_t usockid;
 } end_packed_struct;
 
+/* Shared-memory ring (kernel <=> mmap() of /dev/usrsock <=> daemon)
+ *
+ * A record is a uint32_t length followed by that many bytes and padded to
+ * USRSOCK_SHMRING_ALIGN.  A request record holds one request with its
+ * payload, a response record holds any number of response and event
+ * messages back to back, the same as a write() to /dev/usrsock.  Records
+ * never wrap: a producer that finds no room before the end of the ring
+ * stores USRSOCK_SHMRING_WRAP as the length and continues at offset zero.
+ * Only the producer moves head and only the consumer moves tail, the ring
+ * is empty when they are equal.
+ */
+
+struct usrsock_shmring_s
+{
+  volatile uint32_t head;   /* Offset of the next record to produce */
+  volatile uint32_t tail;   /* Offset of the next record to consume */
+  uint32_t          offset; /* Offset of the records from the mapping */
+  uint32_t          size;   /* Size of the records area */
+};
+
+/* Start of the mapping of /dev/usrsock */
+
+struct usrsock_shm_s
+{
+  struct usrsock_shmring_s req;  /* Requests, kernel => daemon */
+  struct usrsock_shmring_s resp; /* Responses and events, daemon => kernel */
+};
+
 /****************************************************************************
  * Name: usrsock_iovec_get() - copy from iovec to buffer.
  ****************************************************************************/
@@ -452,7 +452,9 @@ typedef FAR void *FCACHE;
 
 struct nxfonts_glyph_s
 {
-  FAR struct nxfonts_glyph_s *flink;   /* Implements a singly linked list */
+  FAR struct nxfonts_glyph_s *flink;   /* Next in LRU order (less recent) */
+  FAR struct nxfonts_glyph_s *blink;   /* Previous in LRU order */
+  FAR struct nxfonts_glyph_s *hlink;   /* Next glyph in the hash bucket */
   uint8_t code;                        /* Character code */
   uint8_t height;                      /* Height of this glyph (in rows) */
   uint8_t width;                       /* Width of this glyph (in pixels) */
@@ -30,6 +30,7 @@
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mutex.h>
 #include <nuttx/list.h>
+#include <nuttx/wqueue.h>
 
 #include <stdbool.h>
 
@@ -157,6 +158,15 @@ struct battery_charger_dev_s
 
   uint32_t mask;  /* record drive support features */
 
+#ifdef CONFIG_BATTERY_CHARGER_ALERT
+  /* Alert handling of the upper-half driver */
+
+  struct work_s work;  /* Reads the charger after an alert */
+  int state;           /* Values reported last */
+  int health;
+  bool online;
+#endif
+
   /* Data fields specific to the lower-half driver may follow */
 };
 
@@ -185,6 +195,31 @@ extern "C"
 int battery_charger_changed(FAR struct battery_charger_dev_s *dev,
                             uint32_t mask);
 
+/****************************************************************************
+ * Name: battery_charger_alert
+ *
+ * Description:
+ *   Called by the lower half driver, or by the board logic on the
+ *   interrupt pin of the charger, when the charger state may have changed.
+ *   The state, health and online status are read again from the lower half
+ *   on the low priority work queue and the changes are reported to the
+ *   readers and poll() waiters.
+ *
+ * Input Parameters:
+ *   dev - The battery charger
+ *
+ * Returned Value:
+ *    Zero on success or a negated errno value on failure.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BATTERY_CHARGER_ALERT
+int battery_charger_alert(FAR struct battery_charger_dev_s *dev);
+#endif
+
 /****************************************************************************
  * Name: battery_charger_register
  *
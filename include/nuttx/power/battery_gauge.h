@@ -30,6 +30,8 @@
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mutex.h>
 #include <nuttx/list.h>
+#include <nuttx/power/battery_ioctl.h>
+#include <nuttx/wqueue.h>
 
 #include <stdbool.h>
 #include <fixedmath.h>
@@ -80,6 +82,9 @@
  *   Input value:  A pointer to type b8_t.
  * BATIOC_CHIPID- Return the chip id of the gauge.
  *   Input value:  A pointer to type unsigned int.
+ * BATIOC_SET_THRESHOLDS - Set how much the values must change before an
+ *   alert reports them as changed, see battery_gauge_alert().
+ *   Input value:  A pointer to type struct batio_thresholds_s.
  */
 
 /****************************************************************************
@@ -135,6 +140,19 @@ struct battery_gauge_dev_s
 
   uint32_t mask;  /* record drive support features */
 
+#ifdef CONFIG_BATTERY_GAUGE_ALERT
+  /* Alert handling of the upper-half driver */
+
+  struct work_s work;                    /* Reads the gauge after an alert */
+  struct batio_thresholds_s thresholds;  /* Change reported after an alert */
+  int state;                             /* Values reported last */
+  bool online;
+  b16_t voltage;
+  b16_t capacity;
+  b16_t current;
+  b8_t temp;
+#endif
+
   /* Data fields specific to the lower-half driver may follow */
 };
 
@@ -163,6 +181,31 @@ extern "C"
 int battery_gauge_changed(FAR struct battery_gauge_dev_s *dev,
                             uint32_t mask);
 
+/****************************************************************************
+ * Name: battery_gauge_alert
+ *
+ * Description:
+ *   Called by the lower half driver, or by the board logic on the alert
+ *   pin interrupt of the gauge, when the battery may have changed.  The
+ *   values are read again from the lower half on the low priority work
+ *   queue and those that changed by more than their threshold are
+ *   reported to the readers and poll() waiters.
+ *
+ * Input Parameters:
+ *   dev - The battery gauge
+ *
+ * Returned Value:
+ *    Zero on success or a negated errno value on failure.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BATTERY_GAUGE_ALERT
+int battery_gauge_alert(FAR struct battery_gauge_dev_s *dev);
+#endif
+
 /****************************************************************************
  * Name: battery_gauge_register
  *
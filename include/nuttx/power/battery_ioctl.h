@@ -29,6 +29,8 @@
 #include <nuttx/config.h>
 #include <nuttx/fs/ioctl.h>
 
+#include <fixedmath.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -58,6 +60,7 @@
 #define BATIOC_GET_VOLTAGE   _BATIOC(0x0012)
 #define BATIOC_VOLTAGE_INFO  _BATIOC(0x0013)
 #define BATIOC_GET_PROTOCOL  _BATIOC(0x0014)
+#define BATIOC_SET_THRESHOLDS _BATIOC(0x0015)
 
 /* Special input values for BATIOC_INPUT_CURRENT that may optionally
  * be supported by lower-half driver:
@@ -120,6 +123,19 @@ enum battery_protocol_e
   BATTERY_PROTOCOL_TX_XIAOMI = 1 << 1,  /* Battery charge protocol of TX is xiaomi standard */
 };
 
+/* Change thresholds of BATIOC_SET_THRESHOLDS:  after an alert, a value is
+ * reported as changed once it has moved by at least its threshold since
+ * it was last reported.  Zero reports every change.
+ */
+
+struct batio_thresholds_s
+{
+  b16_t voltage;                /* Volts */
+  b16_t capacity;               /* Percent of the full capacity */
+  b16_t current;                /* mA */
+  b8_t  temperature;            /* Degrees Celsius */
+};
+
 /* Battery operation message */
 
 struct batio_operate_msg_s
@@ -211,6 +211,14 @@ struct pm_callback_s
 
   CODE void (*notify)(FAR struct pm_callback_s *cb, int domain,
                       enum pm_state_e pmstate);
+
+  /* The callbacks are visited in increasing priority on the way to lower
+   * power states and in decreasing priority on the way back, so that the
+   * drivers with a high priority are the first ready again after a wakeup.
+   * Callbacks of the same priority keep the order of registration.
+   */
+
+  uint8_t priority;
 };
 
 /* An instance of a given PM governor */
@@ -313,6 +321,15 @@ struct pm_wakelock_s
 #endif
 };
 
+/* A wakeup latency constraint on a PM domain, see pm_qos_add() */
+
+struct pm_qos_s
+{
+  struct dq_entry_s node;
+  int domain;
+  uint32_t latency;             /* Maximum wakeup latency in microseconds */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -377,6 +394,19 @@ FAR const struct pm_governor_s *pm_greedy_governor_initialize(void);
 
 FAR const struct pm_governor_s *pm_activity_governor_initialize(void);
 
+/****************************************************************************
+ * Name: pm_residency_governor_initialize
+ *
+ * Description:
+ *   Return the residency governor instance.
+ *
+ * Returned Value:
+ *   A pointer to the governor struct. Otherwise NULL is returned on error.
+ *
+ ****************************************************************************/
+
+FAR const struct pm_governor_s *pm_residency_governor_initialize(void);
+
 /****************************************************************************
  * Name: pm_set_governor
  *
@@ -690,6 +720,87 @@ void pm_wakelock_staytimeout(FAR struct pm_wakelock_s *wakelock, int ms);
 
 int pm_wakelock_staycount(FAR struct pm_wakelock_s *wakelock);
 
+/****************************************************************************
+ * Name: pm_qos_add
+ *
+ * Description:
+ *   Add a wakeup latency constraint to a PM domain:  until the constraint
+ *   is removed, the governor only recommends the states that the system
+ *   can leave within 'latency' microseconds.  Only the residency governor
+ *   knows the latency of the states, the other governors ignore the
+ *   constraints.
+ *
+ * Input Parameters:
+ *   qos     - The constraint, owned by the caller until it is removed
+ *   domain  - The PM domain to constrain
+ *   latency - The maximum wakeup latency in microseconds
+ *
+ * Returned Value:
+ *   None.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void pm_qos_add(FAR struct pm_qos_s *qos, int domain, uint32_t latency);
+
+/****************************************************************************
+ * Name: pm_qos_update
+ *
+ * Description:
+ *   Change the latency of a constraint added with pm_qos_add().
+ *
+ * Input Parameters:
+ *   qos     - The constraint
+ *   latency - The new maximum wakeup latency in microseconds
+ *
+ * Returned Value:
+ *   None.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void pm_qos_update(FAR struct pm_qos_s *qos, uint32_t latency);
+
+/****************************************************************************
+ * Name: pm_qos_remove
+ *
+ * Description:
+ *   Remove a constraint added with pm_qos_add().
+ *
+ * Input Parameters:
+ *   qos - The constraint
+ *
+ * Returned Value:
+ *   None.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void pm_qos_remove(FAR struct pm_qos_s *qos);
+
+/****************************************************************************
+ * Name: pm_qos_latency
+ *
+ * Description:
+ *   Return the tightest wakeup latency constraint of a PM domain.
+ *
+ * Input Parameters:
+ *   domain - The PM domain
+ *
+ * Returned Value:
+ *   The smallest latency of the constraints, in microseconds, or
+ *   UINT32_MAX if the domain has none.
+ *
+ ****************************************************************************/
+
+uint32_t pm_qos_latency(int domain);
+
 /****************************************************************************
  * Name: pm_checkstate
  *
@@ -818,6 +929,10 @@ void pm_auto_updatestate(int domain);
 #  define pm_wakelock_relax(w)
 #  define pm_wakelock_staytimeout(w,m)
 #  define pm_wakelock_staycount(w)            (0)
+#  define pm_qos_add(q,d,l)
+#  define pm_qos_update(q,l)
+#  define pm_qos_remove(q)
+#  define pm_qos_latency(domain)              (UINT32_MAX)
 #  define pm_checkstate(domain)               (0)
 #  define pm_changestate(domain,state)        (0)
 #  define pm_querystate(domain)               (0)
@@ -28,9 +28,14 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <pthread.h>
 #include <sched.h>
 
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/tls.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -39,6 +44,23 @@
 
 #define PTHREAD_DEFAULT_POLICY SCHED_NORMAL
 
+/* An uncontended pthread mutex is taken and released in the caller's
+ * context with the semaphore fast path.  This needs the caller's thread
+ * ID without a system call, so in user space it is only available if the
+ * TLS can be found without the help of the OS.  Robust mutexes always go
+ * through the OS, which keeps track of the mutexes held by each thread.
+ */
+
+#if defined(CONFIG_SEM_FASTPATH) && !defined(CONFIG_PTHREAD_MUTEX_ROBUST)
+#  if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+#    define PTHREAD_MUTEX_FASTPATH 1
+#    define pthread_mutex_self()   _SCHED_GETTID()
+#  elif defined(up_tls_info) || defined(CONFIG_TLS_ALIGNED)
+#    define PTHREAD_MUTEX_FASTPATH 1
+#    define pthread_mutex_self()   (tls_get_info()->tl_tid)
+#  endif
+#endif
+
 /* A lot of hassle to use the old-fashioned struct initializers.  But this
  * gives us backward compatibility with some very old compilers.
  */
@@ -163,6 +185,25 @@ int nx_pthread_create(pthread_trampoline_t trampoline, FAR pthread_t *thread,
 
 void nx_pthread_exit(FAR void *exit_value) noreturn_function;
 
+/****************************************************************************
+ * Name: nx_pthread_mutex_trylock and nx_pthread_mutex_unlock
+ *
+ * Description:
+ *   The OS part of pthread_mutex_trylock() and pthread_mutex_unlock().
+ *   The C library calls these only if the mutex cannot be taken or
+ *   released in the caller's context.
+ *
+ * Input Parameters:
+ *   mutex - A reference to the mutex
+ *
+ * Returned Value:
+ *   0 on success or an errno value on failure.
+ *
+ ****************************************************************************/
+
+int nx_pthread_mutex_trylock(FAR pthread_mutex_t *mutex);
+int nx_pthread_mutex_unlock(FAR pthread_mutex_t *mutex);
+
 /****************************************************************************
  * Name: pthread_cleanup_popall
  *
@@ -189,4 +230,116 @@ void pthread_cleanup_popall(FAR struct tls_info_s *tls);
 }
 #endif
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_mutex_trylock_fast
+ *
+ * Description:
+ *   Take an unlocked mutex with the semaphore fast path.  A thread that
+ *   already holds a recursive or error checking mutex is left to the OS.
+ *
+ * Input Parameters:
+ *   mutex - A reference to the mutex to be locked
+ *
+ * Returned Value:
+ *   true if the mutex was taken; false if the caller must ask the OS.
+ *
+ ****************************************************************************/
+
+#ifdef PTHREAD_MUTEX_FASTPATH
+static inline bool pthread_mutex_trylock_fast(FAR pthread_mutex_t *mutex)
+{
+  pid_t self = pthread_mutex_self();
+
+#ifdef CONFIG_PTHREAD_MUTEX_BOTH
+  if ((mutex->flags & (_PTHREAD_MFLAGS_ROBUST |
+                       _PTHREAD_MFLAGS_INCONSISTENT)) != 0)
+    {
+      return false;
+    }
+#endif
+
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+  if (mutex->type != PTHREAD_MUTEX_NORMAL && mutex->pid == self)
+    {
+      return false;
+    }
+#endif
+
+  if (!nxsem_trywait_fast(&mutex->sem))
+    {
+      return false;
+    }
+
+  mutex->pid = self;
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+  mutex->nlocks = 1;
+#endif
+  return true;
+}
+
+/****************************************************************************
+ * Name: pthread_mutex_unlock_fast
+ *
+ * Description:
+ *   Release a mutex held by the caller with the semaphore fast path.  If
+ *   there are waiters, or the caller does not hold the mutex, the OS must
+ *   hand over the mutex or report the error.
+ *
+ * Input Parameters:
+ *   mutex - A reference to the mutex to be unlocked
+ *
+ * Returned Value:
+ *   true if the mutex was released; false if the caller must ask the OS.
+ *
+ ****************************************************************************/
+
+static inline bool pthread_mutex_unlock_fast(FAR pthread_mutex_t *mutex)
+{
+  pid_t self = pthread_mutex_self();
+
+#ifdef CONFIG_PTHREAD_MUTEX_BOTH
+  if ((mutex->flags & _PTHREAD_MFLAGS_ROBUST) != 0)
+    {
+      return false;
+    }
+#endif
+
+  if (mutex->pid != self || mutex->sem.semcount != 0)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+  if (mutex->type == PTHREAD_MUTEX_RECURSIVE && mutex->nlocks > 1)
+    {
+      mutex->nlocks--;
+      return true;
+    }
+
+  mutex->nlocks = 0;
+#endif
+
+  mutex->pid = INVALID_PROCESS_ID;
+  if (nxsem_post_fast(&mutex->sem))
+    {
+      return true;
+    }
+
+  /* A waiter arrived in the meantime */
+
+  mutex->pid = self;
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+  mutex->nlocks = 1;
+#endif
+  return false;
+}
+#else
+#  define pthread_mutex_trylock_fast(m) false
+#  define pthread_mutex_unlock_fast(m)  false
+#endif
+
 #endif /* __INCLUDE_NUTTX_PTHREAD_H */
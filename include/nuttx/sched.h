@@ -96,6 +96,7 @@
 #  define TCB_FLAG_SCHED_FIFO      (0 << TCB_FLAG_POLICY_SHIFT)  /* FIFO scheding policy */
 #  define TCB_FLAG_SCHED_RR        (1 << TCB_FLAG_POLICY_SHIFT)  /* Round robin scheding policy */
 #  define TCB_FLAG_SCHED_SPORADIC  (2 << TCB_FLAG_POLICY_SHIFT)  /* Sporadic scheding policy */
+#  define TCB_FLAG_SCHED_DEADLINE  (3 << TCB_FLAG_POLICY_SHIFT)  /* Deadline scheding policy */
 #define TCB_FLAG_CPU_LOCKED        (1 << 8)                      /* Bit 7: Locked to this CPU */
 #define TCB_FLAG_SIGNAL_ACTION     (1 << 9)                      /* Bit 8: In a signal handler */
 #define TCB_FLAG_SYSCALL           (1 << 10)                     /* Bit 9: In a system call */
@@ -316,6 +317,37 @@ struct sporadic_s
 
 #endif /* CONFIG_SCHED_SPORADIC */
 
+/* struct deadline_s ********************************************************/
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/* This structure is an allocated "plug-in" to the main TCB structure that
+ * holds the state of the deadline scheduling policy.  A job is released
+ * each period with a budget of 'runtime' ticks; a thread whose budget is
+ * exhausted is throttled to the lowest priority until the next release.
+ */
+
+struct deadline_s
+{
+  FAR struct tcb_s *tcb;            /* The parent TCB structure             */
+  struct wdog_s period_timer;       /* Releases the next job                */
+  struct wdog_s budget_timer;       /* Runs while the thread is running     */
+  clock_t   runtime;                /* Budget per period                    */
+  clock_t   deadline;               /* Relative deadline                    */
+  clock_t   period;                 /* Release period                       */
+  clock_t   release;                /* Release time of the current job      */
+  clock_t   absdeadline;            /* Absolute deadline of the current job */
+  clock_t   eventtime;              /* Time the thread was last resumed     */
+  sclock_t  budget;                 /* Budget left to the current job       */
+  uint32_t  bandwidth;              /* runtime / period in parts per million */
+  uint32_t  noverrun;               /* Number of exhausted budgets          */
+  uint8_t   priority;               /* Priority while not throttled         */
+  bool      running;                /* Budget is being consumed             */
+  bool      throttled;              /* Budget is exhausted                  */
+};
+
+#endif /* CONFIG_SCHED_DEADLINE */
+
 /* struct child_status_s ****************************************************/
 
 /* This structure is used to maintain information about child tasks.
@@ -496,6 +528,10 @@ struct task_group_s
 
   FAR char **tg_envp;               /* Allocated environment strings        */
   ssize_t    tg_envc;               /* Number of environment strings        */
+#ifdef CONFIG_SCHED_ENV_HASH
+  FAR ssize_t *tg_envhash;          /* Hashed index into tg_envp            */
+  size_t     tg_envhsize;           /* Number of slots in tg_envhash        */
+#endif
 #endif
 
 #ifndef CONFIG_DISABLE_POSIX_TIMERS
@@ -584,6 +620,9 @@ struct tcb_s
 #ifdef CONFIG_SCHED_SPORADIC
   FAR struct sporadic_s *sporadic;       /* Sporadic scheduling parameters  */
 #endif
+#ifdef CONFIG_SCHED_DEADLINE
+  FAR struct deadline_s *deadline;       /* Deadline scheduling state       */
+#endif
 
   struct wdog_s waitdog;                 /* All timed waits use this timer  */
 
@@ -622,6 +661,12 @@ struct tcb_s
   FAR struct pthread_mutex_s *mhead;     /* List of mutexes held by thread  */
 #endif
 
+  /* Heap support ***********************************************************/
+
+#ifdef CONFIG_MM_HEAP_TCACHE
+  FAR struct mm_tcache_s *tcache;        /* Cache of small free blocks      */
+#endif
+
   /* CPU load monitoring support ********************************************/
 
 #ifdef CONFIG_SCHED_CPULOAD
@@ -640,6 +685,11 @@ struct tcb_s
   unsigned long run_time;                /* Total time thread run           */
 #endif
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HOTSPOT
+  FAR void *premp_caller;                /* Caller that disabled preemption */
+  FAR void *crit_caller;                 /* Caller that entered csection    */
+#endif
+
   /* State save areas *******************************************************/
 
   /* The form and content of these fields are platform-specific.            */
@@ -739,6 +789,22 @@ begin_packed_struct struct tcbinfo_s
   end_packed_struct reg_off;
 } end_packed_struct;
 
+/* struct critmon_site_s ****************************************************/
+
+/* Accumulated cost of the critical sections or pre-emption disabled regions
+ * entered from one call site.  Times are in up_perf_gettime() counts.
+ */
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HOTSPOT
+struct critmon_site_s
+{
+  FAR void *caller;                      /* Return address of the call site */
+  uint32_t count;                        /* Number of regions entered       */
+  unsigned long max;                     /* Longest region                  */
+  uint64_t total;                        /* Accumulated time of all regions */
+};
+#endif
+
 /* This is the callback type used by nxsched_foreach() */
 
 typedef CODE void (*nxsched_foreach_t)(FAR struct tcb_s *tcb, FAR void *arg);
@@ -766,6 +832,19 @@ EXTERN unsigned long g_premp_max[CONFIG_SMP_NCPUS];
 EXTERN unsigned long g_crit_max[CONFIG_SMP_NCPUS];
 #endif /* CONFIG_SCHED_CRITMONITOR */
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HOTSPOT
+/* Call sites of the most expensive pre-emption disabled regions and
+ * critical sections and the number of sites dropped from the full tables.
+ */
+
+EXTERN struct critmon_site_s
+  g_premp_sites[CONFIG_SCHED_CRITMONITOR_HOTSPOT_NSITES];
+EXTERN struct critmon_site_s
+  g_crit_sites[CONFIG_SCHED_CRITMONITOR_HOTSPOT_NSITES];
+EXTERN uint32_t g_premp_sites_dropped;
+EXTERN uint32_t g_crit_sites_dropped;
+#endif
+
 EXTERN const struct tcbinfo_s g_tcbinfo;
 
 /****************************************************************************
@@ -80,6 +80,18 @@
 #define NOTE_FILTER_MODE_FLAG_SYSCALL_ARGS (1 << 5) /* Enable collecting syscall arguments */
 #endif
 
+/* With the filter, the hooks below are wrapped by a test of the mode flags
+ * inline at the instrumentation point, so that a disabled hook costs a
+ * load and a predicted branch instead of a function call.  The notes that
+ * pass it are still filtered by CPU, syscall, IRQ and tag in the hook.
+ */
+
+#if defined(CONFIG_SCHED_INSTRUMENTATION_FILTER) && \
+    (defined(__KERNEL__) || defined(CONFIG_BUILD_FLAT))
+#  define SCHED_NOTE_INLINE_FILTER 1
+#  define sched_note_active(f) predict_false((g_note_active & (f)) != 0)
+#endif
+
 /* Helper macros for syscall instrumentation filter */
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SYSCALL
@@ -501,6 +513,12 @@ extern "C"
 #define EXTERN extern
 #endif
 
+#ifdef SCHED_NOTE_INLINE_FILTER
+/* The filter mode flags if the instrumentation is enabled, otherwise 0 */
+
+EXTERN volatile unsigned int g_note_active;
+#endif
+
 /****************************************************************************
  * Name: sched_note_*
  *
@@ -523,6 +541,14 @@ void sched_note_stop(FAR struct tcb_s *tcb);
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SWITCH
 void sched_note_suspend(FAR struct tcb_s *tcb);
 void sched_note_resume(FAR struct tcb_s *tcb);
+#  ifdef SCHED_NOTE_INLINE_FILTER
+#    define sched_note_suspend(t) \
+            (sched_note_active(NOTE_FILTER_MODE_FLAG_SWITCH) ? \
+             sched_note_suspend(t) : (void)0)
+#    define sched_note_resume(t) \
+            (sched_note_active(NOTE_FILTER_MODE_FLAG_SWITCH) ? \
+             sched_note_resume(t) : (void)0)
+#  endif
 #else
 #  define sched_note_suspend(t)
 #  define sched_note_resume(t)
@@ -553,12 +579,22 @@ void sched_note_cpu_resumed(FAR struct tcb_s *tcb);
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION_PREEMPTION
 void sched_note_premption(FAR struct tcb_s *tcb, bool locked);
+#  ifdef SCHED_NOTE_INLINE_FILTER
+#    define sched_note_premption(t,l) \
+            (sched_note_active(NOTE_FILTER_MODE_FLAG_ENABLE) ? \
+             sched_note_premption(t, l) : (void)0)
+#  endif
 #else
 #  define sched_note_premption(t,l)
 #endif
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION_CSECTION
 void sched_note_csection(FAR struct tcb_s *tcb, bool enter);
+#  ifdef SCHED_NOTE_INLINE_FILTER
+#    define sched_note_csection(t,e) \
+            (sched_note_active(NOTE_FILTER_MODE_FLAG_ENABLE) ? \
+             sched_note_csection(t, e) : (void)0)
+#  endif
 #else
 #  define sched_note_csection(t,e)
 #endif
@@ -567,6 +603,11 @@ void sched_note_csection(FAR struct tcb_s *tcb, bool enter);
 void sched_note_spinlock(FAR struct tcb_s *tcb,
                          FAR volatile spinlock_t *spinlock,
                          int type);
+#  ifdef SCHED_NOTE_INLINE_FILTER
+#    define sched_note_spinlock(tcb, spinlock, type) \
+            (sched_note_active(NOTE_FILTER_MODE_FLAG_ENABLE) ? \
+             sched_note_spinlock(tcb, spinlock, type) : (void)0)
+#  endif
 #else
 #  define sched_note_spinlock(tcb, spinlock, type)
 #endif
@@ -574,6 +615,14 @@ void sched_note_spinlock(FAR struct tcb_s *tcb,
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SYSCALL
 void sched_note_syscall_enter(int nr, int argc, ...);
 void sched_note_syscall_leave(int nr, uintptr_t result);
+#  ifdef SCHED_NOTE_INLINE_FILTER
+#    define sched_note_syscall_enter(n,a,...) \
+            (sched_note_active(NOTE_FILTER_MODE_FLAG_SYSCALL) ? \
+             sched_note_syscall_enter(n, a, ##__VA_ARGS__) : (void)0)
+#    define sched_note_syscall_leave(n,r) \
+            (sched_note_active(NOTE_FILTER_MODE_FLAG_SYSCALL) ? \
+             sched_note_syscall_leave(n, r) : (void)0)
+#  endif
 #else
 #  define sched_note_syscall_enter(n,a,...)
 #  define sched_note_syscall_leave(n,r)
@@ -581,6 +630,13 @@ void sched_note_syscall_leave(int nr, uintptr_t result);
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION_IRQHANDLER
 void sched_note_irqhandler(int irq, FAR void *handler, bool enter);
+#  ifdef SCHED_NOTE_INLINE_FILTER
+/* Tested for enabled only: the hook counts the nesting of masked IRQs */
+
+#    define sched_note_irqhandler(i,h,e) \
+            (sched_note_active(NOTE_FILTER_MODE_FLAG_ENABLE) ? \
+             sched_note_irqhandler(i, h, e) : (void)0)
+#  endif
 #else
 #  define sched_note_irqhandler(i,h,e)
 #endif
@@ -599,6 +655,26 @@ void sched_note_printf_ip(uint32_t tag, uintptr_t ip,
                           FAR const char *fmt, ...) printf_like(3, 4);
 void sched_note_bprintf_ip(uint32_t tag, uintptr_t ip, uint8_t event,
                            FAR const char *fmt, ...) printf_like(4, 5);
+#  ifdef SCHED_NOTE_INLINE_FILTER
+#    define sched_note_string_ip(t,ip,b) \
+            (sched_note_active(NOTE_FILTER_MODE_FLAG_DUMP) ? \
+             sched_note_string_ip(t, ip, b) : (void)0)
+#    define sched_note_dump_ip(t,ip,e,b,l) \
+            (sched_note_active(NOTE_FILTER_MODE_FLAG_DUMP) ? \
+             sched_note_dump_ip(t, ip, e, b, l) : (void)0)
+#    define sched_note_vprintf_ip(t,ip,f,v) \
+            (sched_note_active(NOTE_FILTER_MODE_FLAG_DUMP) ? \
+             sched_note_vprintf_ip(t, ip, f, v) : (void)0)
+#    define sched_note_vbprintf_ip(t,ip,e,f,v) \
+            (sched_note_active(NOTE_FILTER_MODE_FLAG_DUMP) ? \
+             sched_note_vbprintf_ip(t, ip, e, f, v) : (void)0)
+#    define sched_note_printf_ip(t,ip,f,...) \
+            (sched_note_active(NOTE_FILTER_MODE_FLAG_DUMP) ? \
+             sched_note_printf_ip(t, ip, f, ##__VA_ARGS__) : (void)0)
+#    define sched_note_bprintf_ip(t,ip,e,f,...) \
+            (sched_note_active(NOTE_FILTER_MODE_FLAG_DUMP) ? \
+             sched_note_bprintf_ip(t, ip, e, f, ##__VA_ARGS__) : (void)0)
+#  endif
 #else
 #  define sched_note_string_ip(t,ip,b)
 #  define sched_note_dump_ip(t,ip,e,b,l)
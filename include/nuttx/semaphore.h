@@ -39,7 +39,12 @@
 /* Initializers */
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
-#  if CONFIG_SEM_PREALLOCHOLDERS > 0
+#  if CONFIG_SEM_PREALLOCHOLDERS > 0 && defined(CONFIG_SEM_MUTEX_HOLDER)
+/* semcount, flags, waitlist, hhead, holder */
+
+#    define NXSEM_INITIALIZER(c, f) \
+       {(c), (f), SEM_WAITLIST_INITIALIZER, NULL, SEMHOLDER_INITIALIZER}
+#  elif CONFIG_SEM_PREALLOCHOLDERS > 0
 /* semcount, flags, waitlist, hhead */
 
 #    define NXSEM_INITIALIZER(c, f) \
@@ -637,5 +642,83 @@ int nxsem_tickwait_uninterruptible(FAR sem_t *sem, uint32_t delay);
 }
 #endif
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsem_trywait_fast and nxsem_post_fast
+ *
+ * Description:
+ *   Take or give one count of a semaphore with a compare-and-swap, if that
+ *   does not require to block or to wake up a task.  On a uniprocessor the
+ *   exclusive monitor is cleared on every exception entry, so the swap
+ *   fails and is retried if an interrupt handler or a context switch
+ *   modified the count in between.
+ *
+ * Input Parameters:
+ *   sem - Semaphore descriptor
+ *
+ * Returned Value:
+ *   true if the count was taken or given; false if the caller must take
+ *   the regular path.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SEM_FASTPATH) && defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_2)
+static inline bool nxsem_trywait_fast(FAR sem_t *sem)
+{
+  int16_t count = sem->semcount;
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  if ((sem->flags & SEM_PRIO_MASK) == SEM_PRIO_INHERIT)
+    {
+      return false;
+    }
+#endif
+
+  while (count > 0)
+    {
+      if (__atomic_compare_exchange_n(&sem->semcount, &count, count - 1,
+                                      true, __ATOMIC_ACQUIRE,
+                                      __ATOMIC_RELAXED))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+static inline bool nxsem_post_fast(FAR sem_t *sem)
+{
+  int16_t count = sem->semcount;
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  if ((sem->flags & SEM_PRIO_MASK) == SEM_PRIO_INHERIT)
+    {
+      return false;
+    }
+#endif
+
+  /* A negative count means that there are waiters to wake up */
+
+  while (count >= 0 && count < SEM_VALUE_MAX)
+    {
+      if (__atomic_compare_exchange_n(&sem->semcount, &count, count + 1,
+                                      true, __ATOMIC_RELEASE,
+                                      __ATOMIC_RELAXED))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+#else
+#  define nxsem_trywait_fast(s) false
+#  define nxsem_post_fast(s)    false
+#endif
+
 #endif /* __ASSEMBLY__ */
 #endif /* __INCLUDE_NUTTX_SEMAPHORE_H */
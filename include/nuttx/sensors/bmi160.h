@@ -70,6 +70,7 @@
 #define SNIOC_READSC       _SNIOC(0x0002) /* Arg: int16_t* pointer */
 #define SNIOC_SETACCPM     _SNIOC(0x0003) /* Arg: uint8_t value */
 #define SNIOC_SETACCODR    _SNIOC(0x0004) /* Arg: uint8_t value */
+#define SNIOC_ENABLEFIFO   _SNIOC(0x0005) /* Arg: bool value */
 
 /****************************************************************************
  * Public Types
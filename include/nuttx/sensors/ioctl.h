@@ -406,4 +406,13 @@
 
 #define SNIOC_ENABLE_FIFO             _SNIOC(0x009A)
 
+/* Command:      SNIOC_MMAP_CURSOR
+ * Description:  Get a cursor in the mapped ring of the topic, which is how
+ *               far the user consumed the events that it reads in place.
+ * Argument:     Sets *(int *)arg to the index in struct sensor_ring_s
+ *               cursor[].
+ */
+
+#define SNIOC_MMAP_CURSOR             _SNIOC(0x009B)
+
 #endif /* __INCLUDE_NUTTX_SENSORS_IOCTL_H */
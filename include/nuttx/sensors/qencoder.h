@@ -96,6 +96,11 @@
 #define QE_AS5048A_FIRST   (QE_IMXRT_FIRST + QE_IMXRT_NCMDS)
 #define QE_AS5048A_NCMDS   4
 
+/* See arch/arm/src/stm32l4/stm32l4_qencoder.h */
+
+#define QE_STM32L4_FIRST   (QE_AS5048A_FIRST + QE_AS5048A_NCMDS)
+#define QE_STM32L4_NCMDS   1
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
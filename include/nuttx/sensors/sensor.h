@@ -1025,6 +1025,36 @@ struct sensor_ustate_s
   unsigned long generation;    /* The recent generation of circular buffer */
 };
 
+/* This structure is the head of the ring of events of a topic, which is
+ * what mmap() maps.  The publisher writes each event once into the ring
+ * and the subscribers read it in place:
+ *
+ * - 'head' counts the events published and 'claim' the events published
+ *   or being written, so a write is in progress while they differ.  'last'
+ *   is the slot of event head - 1 and slot n is at offset
+ *   'offset' + n * 'esize' from the head of the ring.
+ * - Read head, last, then claim, and retry while claim differs from head.
+ *   Event i, head - nbuffer <= i < head, is then in slot
+ *   (last + 1 + nbuffer - (head - i)) % nbuffer, and is valid if
+ *   claim - i <= nbuffer still holds once it has been used.
+ * - A subscriber that got a cursor with SNIOC_MMAP_CURSOR stores in it the
+ *   number of events that it consumed, and poll() reports POLLIN while
+ *   that differs from 'head'.
+ */
+
+#ifdef CONFIG_SENSORS_MMAP
+struct sensor_ring_s
+{
+  volatile unsigned long head;   /* Number of events published */
+  volatile unsigned long claim;  /* Events published or being written */
+  volatile unsigned long last;   /* Slot of the last event published */
+  unsigned long nbuffer;         /* Number of event slots */
+  unsigned long esize;           /* The element size of an event */
+  unsigned long offset;          /* Offset of slot 0 from the head */
+  volatile unsigned long cursor[CONFIG_SENSORS_MMAP_NCURSORS];
+};
+#endif
+
 /* This structure describes the register info for the user sensor */
 
 #ifdef CONFIG_USENSOR
@@ -270,6 +270,26 @@ int nxsig_xorset(FAR sigset_t *dest, FAR const sigset_t *left,
 
 sigset_t nxsig_pendingset(FAR struct tcb_s *stcb);
 
+/****************************************************************************
+ * Name: nxsig_dequeue
+ *
+ * Description:
+ *   Remove pending signals of the calling thread's group without waiting.
+ *   This is the batched counterpart of nxsig_waitinfo(), used to drain all
+ *   the pending signals in one call.
+ *
+ * Input Parameters:
+ *   set   - The set of signals to remove
+ *   info  - The array to return the signal information
+ *   count - The number of entries in the array
+ *
+ * Returned Value:
+ *   The number of signals that were removed, zero if none was pending.
+ *
+ ****************************************************************************/
+
+int nxsig_dequeue(FAR const sigset_t *set, FAR siginfo_t *info, int count);
+
 /****************************************************************************
  * Name: nxsig_procmask
  *
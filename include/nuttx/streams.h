@@ -63,6 +63,16 @@
 #define LZF_STREAM_BLOCKSIZE  ((1 << CONFIG_STREAM_LZF_BLOG) - 1)
 #endif
 
+#ifdef CONFIG_STREAM_LZ4
+#define LZ4_STREAM_BLOCKSIZE  (1 << CONFIG_STREAM_LZ4_BLOG)
+#define LZ4_STREAM_OUTSIZE    (4 + LZ4_STREAM_BLOCKSIZE + \
+                               LZ4_STREAM_BLOCKSIZE / 255 + 16)
+#endif
+
+#ifdef CONFIG_STREAM_HEATSHRINK
+#define HS_STREAM_WINDOW      (1 << CONFIG_STREAM_HEATSHRINK_WINDOW)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -276,6 +286,41 @@ struct lib_lzfoutstream_s
 };
 #endif
 
+/* LZ4 compressed stream pipeline */
+
+#ifdef CONFIG_STREAM_LZ4
+struct lib_lz4outstream_s
+{
+  struct lib_outstream_s      public;
+  FAR struct lib_outstream_s *backend;
+  bool                        header;  /* The magic number was written */
+  size_t                      offset;  /* Number of bytes in in[] */
+  uint16_t                    hash[1 << CONFIG_STREAM_LZ4_HLOG];
+  uint8_t                     in[LZ4_STREAM_BLOCKSIZE];
+  uint8_t                     out[LZ4_STREAM_OUTSIZE];
+};
+#endif
+
+/* Heatshrink compressed stream pipeline.  buf[] holds the window and then
+ * the input that is not encoded yet.
+ */
+
+#ifdef CONFIG_STREAM_HEATSHRINK
+struct lib_hsoutstream_s
+{
+  struct lib_outstream_s      public;
+  FAR struct lib_outstream_s *backend;
+  size_t                      hist;    /* Number of bytes in the window */
+  size_t                      offset;  /* Number of bytes of input */
+  uint32_t                    bits;    /* Bits not written yet */
+  uint8_t                     nbits;   /* Number of bits in 'bits' */
+  uint8_t                     nout;    /* Number of bytes in out[] */
+  int16_t                     index[2 * HS_STREAM_WINDOW];
+  uint8_t                     buf[2 * HS_STREAM_WINDOW];
+  uint8_t                     out[64];
+};
+#endif
+
 #ifndef CONFIG_DISABLE_MOUNTPOINT
 struct lib_blkoutstream_s
 {
@@ -569,6 +614,52 @@ void lib_lzfoutstream(FAR struct lib_lzfoutstream_s *stream,
                       FAR struct lib_outstream_s *backend);
 #endif
 
+/****************************************************************************
+ * Name: lib_lz4outstream
+ *
+ * Description:
+ *  LZ4 compressed pipeline stream.  The output is in the LZ4 legacy frame
+ *  format, with blocks of up to LZ4_STREAM_BLOCKSIZE bytes that are
+ *  compressed independently; lib_stream_flush() ends the current block.
+ *
+ * Input Parameters:
+ *   stream  - User allocated, uninitialized instance of struct
+ *                lib_lz4outstream_s to be initialized.
+ *   backend - Stream backend port.
+ *
+ * Returned Value:
+ *   None (User allocated instance initialized).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STREAM_LZ4
+void lib_lz4outstream(FAR struct lib_lz4outstream_s *stream,
+                      FAR struct lib_outstream_s *backend);
+#endif
+
+/****************************************************************************
+ * Name: lib_hsoutstream
+ *
+ * Description:
+ *  Heatshrink compressed pipeline stream.  lib_stream_flush() completes
+ *  the heatshrink stream; the data written after it is decoded as a new
+ *  stream.
+ *
+ * Input Parameters:
+ *   stream  - User allocated, uninitialized instance of struct
+ *                lib_hsoutstream_s to be initialized.
+ *   backend - Stream backend port.
+ *
+ * Returned Value:
+ *   None (User allocated instance initialized).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STREAM_HEATSHRINK
+void lib_hsoutstream(FAR struct lib_hsoutstream_s *stream,
+                     FAR struct lib_outstream_s *backend);
+#endif
+
 /****************************************************************************
  * Name: lib_blkoutstream_open
  *
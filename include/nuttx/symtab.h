@@ -27,10 +27,24 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* SYMTAB_ENTRY() initializes one symbol table entry.  With
+ * CONFIG_SYMTAB_HASHED the hash of the name must be provided and the table
+ * must be ordered by that hash (see tools/mksymtab -h and
+ * symtab_sortbyhash()).
+ */
+
+#ifdef CONFIG_SYMTAB_HASHED
+#  define SYMTAB_ENTRY(n, v, h) { n, (FAR const void *)(v), h }
+#else
+#  define SYMTAB_ENTRY(n, v, h) { n, (FAR const void *)(v) }
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -53,6 +67,9 @@ struct symtab_s
 {
   FAR const char *sym_name;  /* A pointer to the symbol name string */
   FAR const void *sym_value; /* The value associated with the string */
+#ifdef CONFIG_SYMTAB_HASHED
+  uint32_t sym_hash;         /* symtab_hash() of sym_name */
+#endif
 };
 
 /****************************************************************************
@@ -73,9 +90,10 @@ extern "C"
  *
  * Description:
  *   Find the symbol in the symbol table with the matching name.
- *   The implementation will be linear with respect to nsyms if
- *   CONFIG_SYMTAB_ORDEREDBYNAME is not selected, and logarithmic
- *   if it is.
+ *   The implementation will be linear with respect to nsyms if neither
+ *   CONFIG_SYMTAB_ORDEREDBYNAME nor CONFIG_SYMTAB_HASHED is selected, and
+ *   logarithmic if one is.  With CONFIG_SYMTAB_HASHED the search compares
+ *   hashes and calls strcmp() only for the entries with the same hash.
  *
  * Returned Value:
  *   A reference to the symbol table entry if an entry with the matching
@@ -119,6 +137,33 @@ symtab_findbyvalue(FAR const struct symtab_s *symtab,
 
 void symtab_sortbyname(FAR struct symtab_s *symtab, int nsyms);
 
+#ifdef CONFIG_SYMTAB_HASHED
+/****************************************************************************
+ * Name: symtab_hash
+ *
+ * Description:
+ *   Return the GNU (DJB) hash of a symbol name, h = h * 33 + c starting
+ *   from 5381.  tools/mksymtab uses the same function.
+ *
+ ****************************************************************************/
+
+uint32_t symtab_hash(FAR const char *name);
+
+/****************************************************************************
+ * Name: symtab_sortbyhash
+ *
+ * Description:
+ *   Set the hash of each entry of a symbol table built at run time and
+ *   sort the table by that hash, as symtab_findbyname() expects.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void symtab_sortbyhash(FAR struct symtab_s *symtab, int nsyms);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -0,0 +1,159 @@
+/****************************************************************************
+ * include/nuttx/tasklet.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_TASKLET_H
+#define __INCLUDE_NUTTX_TASKLET_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/queue.h>
+
+#ifdef CONFIG_SCHED_TASKLET
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define TASKLET_INITIALIZER(func, arg) {{NULL}, (func), (arg), false}
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* A tasklet function runs in interrupt context and must not block */
+
+typedef CODE void (*tasklet_t)(FAR void *arg);
+
+/* Tasklets are usually statically allocated by the driver that schedules
+ * them.  The structure must stay valid while the tasklet is queued.
+ */
+
+struct tasklet_s
+{
+  sq_entry_t node;         /* Implements a singly linked list */
+  tasklet_t func;          /* Function to run */
+  FAR void *arg;           /* Argument passed to the function */
+  volatile bool queued;    /* True while the tasklet waits to run */
+};
+
+/* Tasklet statistics, see tasklet_getstats() */
+
+struct tasklet_stats_s
+{
+  uint32_t nscheduled;     /* Number of times a tasklet was queued */
+  uint32_t nrun;           /* Number of tasklets run */
+  uint32_t ncoalesced;     /* Schedules of an already queued tasklet */
+  uint32_t maxpending;     /* Most tasklets that were queued at once */
+  unsigned long maxtime;   /* Longest tasklet, up_perf_gettime() units */
+  uint32_t noverrun;       /* Tasklets longer than SCHED_TASKLET_MAXTIME */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: tasklet_schedule
+ *
+ * Description:
+ *   Queue a tasklet to run once the interrupt handlers have finished,
+ *   before returning to thread mode.  Tasklets run in the order that they
+ *   were queued, on the interrupt stack.  Scheduling a tasklet that is
+ *   still queued does nothing: it runs once.  May be called from interrupt
+ *   handlers, from tasklets and from threads.
+ *
+ * Input Parameters:
+ *   tasklet - The tasklet to queue
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void tasklet_schedule(FAR struct tasklet_s *tasklet);
+
+/****************************************************************************
+ * Name: tasklet_cancel
+ *
+ * Description:
+ *   Remove a queued tasklet.  A tasklet that is already running is not
+ *   waited for.
+ *
+ * Input Parameters:
+ *   tasklet - The tasklet to remove
+ *
+ * Returned Value:
+ *   Zero (OK) if the tasklet was removed; -ENOENT if it was not queued.
+ *
+ ****************************************************************************/
+
+int tasklet_cancel(FAR struct tasklet_s *tasklet);
+
+/****************************************************************************
+ * Name: tasklet_getstats
+ *
+ * Description:
+ *   Return the tasklet statistics and optionally reset them.
+ *
+ * Input Parameters:
+ *   stats - Location to return the statistics
+ *   reset - True to reset the statistics
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void tasklet_getstats(FAR struct tasklet_stats_s *stats, bool reset);
+
+/****************************************************************************
+ * Name: tasklet_run
+ *
+ * Description:
+ *   Run the queued tasklets.  Called by the architecture from the software
+ *   interrupt that up_trigger_tasklet() has pended; not to be called by
+ *   drivers.
+ *
+ ****************************************************************************/
+
+void tasklet_run(void);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_SCHED_TASKLET */
+#endif /* __INCLUDE_NUTTX_TASKLET_H */
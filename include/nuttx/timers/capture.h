@@ -28,6 +28,10 @@
 #include <nuttx/config.h>
 #include <nuttx/fs/ioctl.h>
 
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -58,6 +62,8 @@ struct cap_ops_s
 
   CODE int (*stop)(FAR struct cap_lowerhalf_s *lower);
 
+  /* Optional methods *******************************************************/
+
   /* Get the result pwm capture duty value */
 
   CODE int (*getduty)(FAR struct cap_lowerhalf_s *lower,
@@ -67,6 +73,16 @@ struct cap_ops_s
 
   CODE int (*getfreq)(FAR struct cap_lowerhalf_s *lower,
                       FAR uint32_t *freq);
+
+  /* Copy up to 'nedges' timestamps of the captured edges, oldest first, in
+   * counts of the timer.  Return the number copied, -EAGAIN if none is
+   * available and 'nonblock' is set, or -EOVERFLOW once edges have been
+   * lost because the reader fell behind.  This backs read() on the device,
+   * which returns an array of uint32_t timestamps.
+   */
+
+  CODE ssize_t (*read)(FAR struct cap_lowerhalf_s *lower,
+                       FAR uint32_t *edges, size_t nedges, bool nonblock);
 };
 
 /* This structure provides the publicly visible representation of the
@@ -0,0 +1,206 @@
+/****************************************************************************
+ * include/nuttx/timers/hrtimer.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_TIMERS_HRTIMER_H
+#define __INCLUDE_NUTTX_TIMERS_HRTIMER_H
+
+/* The high resolution timers call back drivers in interrupt context at an
+ * absolute time given in nanoseconds, independent of the system tick.
+ * Any number of timers is multiplexed on the single compare channel of a
+ * free-running hardware counter:
+ *
+ * 1) The generic logic keeps the pending timers sorted by expiration time
+ *    and programs the earliest into the lower half.
+ * 2) A platform-specific lower half provides the time base in nanoseconds
+ *    and the compare interrupt, from which it calls hrtimer_expired().
+ *
+ * The resolution is that of the lower-half counter.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <stdint.h>
+
+#include <nuttx/list.h>
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The callback of an expired timer, called from the interrupt of the lower
+ * half.  It returns the delay in nanoseconds from this expiration to the
+ * next one for a periodic timer, or zero to stop the timer.
+ */
+
+struct hrtimer_s;
+typedef CODE uint64_t (*hrtimer_callback_t)(FAR struct hrtimer_s *timer);
+
+/* A timer is allocated by its user and zeroed before its first use.  The
+ * fields are private, except 'arg' which may be read by the callback.
+ */
+
+struct hrtimer_s
+{
+  struct list_node   node;      /* Pending timers, by expiration time */
+  uint64_t           expired;   /* Absolute expiration time (ns) */
+  hrtimer_callback_t callback;  /* Called when the timer expires */
+  FAR void          *arg;       /* Argument of the callback */
+};
+
+enum hrtimer_mode_e
+{
+  HRTIMER_MODE_ABS = 0,         /* The time is that of hrtimer_gettime() */
+  HRTIMER_MODE_REL              /* The time is relative to now */
+};
+
+/* The operations of the lower half, called with interrupts disabled */
+
+struct hrtimer_lowerhalf_s;
+struct hrtimer_ops_s
+{
+  /* Return the time of the free-running counter in nanoseconds */
+
+  CODE uint64_t (*current)(FAR struct hrtimer_lowerhalf_s *lower);
+
+  /* Call hrtimer_expired() from the interrupt when the counter reaches the
+   * time 'ns', replacing any previous alarm.  Return -ETIME if that time
+   * has already passed; the alarm is not set in that case.
+   */
+
+  CODE int (*setalarm)(FAR struct hrtimer_lowerhalf_s *lower, uint64_t ns);
+
+  /* Cancel the alarm */
+
+  CODE void (*cancel)(FAR struct hrtimer_lowerhalf_s *lower);
+};
+
+/* The state structure of a lower half starts with this structure */
+
+struct hrtimer_lowerhalf_s
+{
+  FAR const struct hrtimer_ops_s *ops;
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: hrtimer_register
+ *
+ * Description:
+ *   Install the lower half that provides the time base and the alarm of
+ *   the high resolution timers.  Called once by the platform.
+ *
+ * Input Parameters:
+ *   lower - The lower half
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EBUSY if a lower half is already installed.
+ *
+ ****************************************************************************/
+
+int hrtimer_register(FAR struct hrtimer_lowerhalf_s *lower);
+
+/****************************************************************************
+ * Name: hrtimer_gettime
+ *
+ * Description:
+ *   Return the current time of the high resolution timers in nanoseconds,
+ *   or zero if there is no lower half.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_gettime(void);
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   Start or restart a timer.  The callback is called from the interrupt
+ *   of the lower half when the time is reached; a timer that is already
+ *   due is called back before hrtimer_start() returns.
+ *
+ * Input Parameters:
+ *   timer    - The timer, allocated by the caller
+ *   callback - Called when the timer expires
+ *   arg      - Stored in the timer for the callback
+ *   ns       - The expiration time in nanoseconds
+ *   mode     - Whether 'ns' is absolute or relative to now
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENODEV if there is no lower half.
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *timer, hrtimer_callback_t callback,
+                  FAR void *arg, uint64_t ns, enum hrtimer_mode_e mode);
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ *
+ * Description:
+ *   Stop a timer.  A periodic timer cancelled from another context while
+ *   its callback runs is restarted by the return value of the callback.
+ *
+ * Input Parameters:
+ *   timer - The timer
+ *
+ * Returned Value:
+ *   Zero (OK) if the timer was pending; -EALREADY if it was not.
+ *
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *timer);
+
+/****************************************************************************
+ * Name: hrtimer_expired
+ *
+ * Description:
+ *   Called by the lower half from its interrupt when the alarm is reached.
+ *   Calls back the expired timers and sets the alarm of the next one.
+ *
+ ****************************************************************************/
+
+void hrtimer_expired(void);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_HRTIMER */
+#endif /* __INCLUDE_NUTTX_TIMERS_HRTIMER_H */
@@ -60,6 +60,9 @@
  * CONFIG_PWM_MULTICHAN - Enables support for multiple output channels per
  *   timer.  If selected, then CONFIG_PWM_NCHANNELS must be provided to
  *   indicated the maximum number of supported PWM output channels.
+ * CONFIG_PWM_SEQUENCE - Some hardware can load the duty cycles of every
+ *   period from a buffer.  If selected, sequences of duty cycles can be
+ *   submitted with PWMIOC_SETSEQUENCE.
  * CONFIG_DEBUG_PWM_INFO - This will generate output that can be use to
  *   debug the PWM driver.
  */
@@ -107,12 +110,24 @@
  *  and return immediately.
  *
  *  ioctl argument:  None
+ *
+ * PWMIOC_SETSEQUENCE - Start the pulsed output with a new duty cycle for
+ *  each period, taken from a sequence.  The duty cycles are copied before
+ *  the command returns.  By default, the call blocks until the last period
+ *  of the sequence has been loaded; this can be overridden by using the
+ *  O_NONBLOCK flag when the PWM driver is opened.  After the sequence, the
+ *  output keeps the duty cycles of its last period until it is stopped or
+ *  started again.  Only available if CONFIG_PWM_SEQUENCE is defined;
+ *  -ENOTTY is returned if the lower half has no sequence support.
+ *
+ *  ioctl argument:  A read-only reference to struct pwm_sequence_s.
  */
 
 #define PWMIOC_SETCHARACTERISTICS _PWMIOC(1)
 #define PWMIOC_GETCHARACTERISTICS _PWMIOC(2)
 #define PWMIOC_START              _PWMIOC(3)
 #define PWMIOC_STOP               _PWMIOC(4)
+#define PWMIOC_SETSEQUENCE        _PWMIOC(5)
 
 /* PWM channel polarity *****************************************************/
 
@@ -180,6 +195,21 @@ struct pwm_info_s
                                  * lower half */
 };
 
+#ifdef CONFIG_PWM_SEQUENCE
+/* This structure describes a sequence of duty cycles.  The duty cycles of
+ * one period follow each other in the buffer, period after period; they
+ * apply to the channels 1 to nchannels of the timer.
+ */
+
+struct pwm_sequence_s
+{
+  uint32_t           frequency; /* Frequency of the pulse train */
+  FAR const ub16_t  *duty;      /* nperiods * nchannels duty cycles */
+  uint16_t           nperiods;  /* Number of periods of the sequence */
+  uint8_t            nchannels; /* Number of channels per period */
+};
+#endif
+
 /* This structure is a set a callback functions used to call from the upper-
  * half, generic PWM driver into lower-half, platform-specific logic that
  * supports the low-level timer outputs.
@@ -224,6 +254,17 @@ struct pwm_ops_s
 
   CODE int (*ioctl)(FAR struct pwm_lowerhalf_s *dev,
                     int cmd, unsigned long arg);
+
+#ifdef CONFIG_PWM_SEQUENCE
+  /* Start the pulsed output with the duty cycles of a sequence.  This
+   * method is optional.  The lower half must copy the duty cycles and call
+   * pwm_sequence_done() with the handle once it has loaded the last period.
+   */
+
+  CODE int (*sequence)(FAR struct pwm_lowerhalf_s *dev,
+                       FAR const struct pwm_sequence_s *seq,
+                       FAR void *handle);
+#endif
 };
 
 /* This structure is the generic form of state structure used by lower half
@@ -339,6 +380,30 @@ int pwm_register(FAR const char *path, FAR struct pwm_lowerhalf_s *dev);
 void pwm_expired(FAR void *handle);
 #endif
 
+/****************************************************************************
+ * Name: pwm_sequence_done
+ *
+ * Description:
+ *   Called by the lower half when the last period of a sequence started
+ *   with the sequence() method has been loaded.  A thread waiting in
+ *   PWMIOC_SETSEQUENCE is awakened.  The output is not stopped.
+ *
+ * Input Parameters:
+ *   handle - This is the handle that was provided to the lower-half
+ *     sequence() method.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PWM_SEQUENCE
+void pwm_sequence_done(FAR void *handle);
+#endif
+
 /****************************************************************************
  * Platform-Independent "Lower-Half" PWM Driver Interfaces
  ****************************************************************************/
@@ -205,6 +205,7 @@ struct tls_info_s
   struct pthread_cleanup_s stack[CONFIG_PTHREAD_CLEANUP_STACKSIZE];
 #endif
 
+  pid_t tl_tid;                        /* Thread ID, read without a syscall */
   int tl_errno;                        /* Per-thread error number */
 };
 
@@ -1083,7 +1083,7 @@ struct adc_extunit_desc_s
 
 struct adc_as_ifdesc_s
 {
-  uint8_t as_len;               /* 0: Descriptor length (9) */
+  uint8_t as_len;               /* 0: Descriptor length (16) */
   uint8_t as_type;              /* 1: Descriptor type (ADC_CS_INTERFACE) */
   uint8_t as_subtype;           /* 2: Descriptor sub-type (ADC_AS_GENERAL) */
   uint8_t as_terminal;          /* 3: ID of connected terminal */
@@ -1098,7 +1098,7 @@ struct adc_as_ifdesc_s
   uint8_t as_names;             /* 15: String index to name of first channel */
 };
 
-#define USB_SIZEOF_ADC_AS_IFDESC 9
+#define USB_SIZEOF_ADC_AS_IFDESC 16
 
 /* Encoder Descriptor */
 
@@ -1270,7 +1270,7 @@ struct adc_dts_decoder_desc_s
 struct adc_audio_epdesc_s
 {
   uint8_t ae_len;               /* 0: Descriptor length (8) */
-  uint8_t ae_type;              /* 1: Descriptor type (ADC_CS_INTERFACE) */
+  uint8_t ae_type;              /* 1: Descriptor type (ADC_CS_ENDPOINT) */
   uint8_t ae_subtype;           /* 2: Descriptor sub-type (ADC_EPTYPE_GENERAL) */
   uint8_t ae_attr;              /* 3: Attributes: Bit 7: MaxPacketsOnly */
   uint8_t ae_controls;          /* 4 Controls
@@ -57,7 +57,8 @@
 #define CDC_SUBCLASS_CAPI       0x05 /* CAPI Control Model */
 #define CDC_SUBCLASS_ECM        0x06 /* Ethernet Networking Control Model */
 #define CDC_SUBCLASS_ATM        0x07 /* ATM Networking Control Model */
-                                     /* 0x08-0x0d Reserved (future use) */
+                                     /* 0x08-0x0c Reserved (future use) */
+#define CDC_SUBCLASS_NCM        0x0d /* Network Control Model */
 #define CDC_SUBCLASS_MBIM       0x0e /* MBIM Control Model */
                                      /* 0x0f-0x7f Reserved (future use) */
                                      /* 0x80-0xfe Reserved (vendor specific) */
@@ -84,8 +85,9 @@
 /* Table 19: Data Interface Class Protocol Codes */
 
 #define CDC_DATA_PROTO_NONE     0x00 /* No class specific protocol required */
-                                     /* 0x01-0x2f Reserved (future use) */
+#define CDC_DATA_PROTO_NCMNTB   0x01 /* Network Transfer Block protocol (NCM) */
 #define CDC_DATA_PROTO_NTB      0x02 /* Network Transfer Block protocol */
+                                     /* 0x03-0x2f Reserved (future use) */
 #define CDC_DATA_PROTO_ISDN     0x30 /* Physical interface protocol for ISDN BRI */
 #define CDC_DATA_PROTO_HDLC     0x31 /* HDLC */
 #define CDC_DATA_PROTO_TRANSP   0x32 /* Transparent */
@@ -287,6 +289,65 @@
 #define ECM_SPEED_CHANGE        0x2a /* Reports a change in upstream or downstream (Required)
                                       */
 
+/* NCM 1.0 Table 6-2: Requests, Network Control Model */
+
+#define NCM_GET_NTB_PARAMETERS  0x80 /* Returns the NTB data format and size
+                                      * parameters (Required)
+                                      */
+#define NCM_GET_NET_ADDRESS     0x81 /* Returns the current EUI-48 station
+                                      * address (Optional)
+                                      */
+#define NCM_SET_NET_ADDRESS     0x82 /* Sets the EUI-48 station address
+                                      * (Optional)
+                                      */
+#define NCM_GET_NTB_FORMAT      0x83 /* Returns the NTB format in use
+                                      * (Optional)
+                                      */
+#define NCM_SET_NTB_FORMAT      0x84 /* Selects NTB-16 or NTB-32 (Optional) */
+#define NCM_GET_NTB_INPUT_SIZE  0x85 /* Returns the maximum size of the IN
+                                      * NTBs (Required)
+                                      */
+#define NCM_SET_NTB_INPUT_SIZE  0x86 /* Limits the size of the IN NTBs
+                                      * (Required)
+                                      */
+#define NCM_GET_MAX_DATAGRAM    0x87 /* Returns the maximum datagram size
+                                      * (Optional)
+                                      */
+#define NCM_SET_MAX_DATAGRAM    0x88 /* Sets the maximum datagram size
+                                      * (Optional)
+                                      */
+#define NCM_GET_CRC_MODE        0x89 /* Returns the CRC mode (Optional) */
+#define NCM_SET_CRC_MODE        0x8a /* Selects whether datagrams of IN NTBs
+                                      * carry a CRC (Optional)
+                                      */
+
+/* NCM 1.0 Table 5-2: bmNetworkCapabilities of the NCM Functional
+ * Descriptor
+ */
+
+#define NCM_NCAP_ETH_FILTER     (1 << 0) /* SetEthernetPacketFilter */
+#define NCM_NCAP_NET_ADDRESS    (1 << 1) /* Get/SetNetAddress */
+#define NCM_NCAP_ENCAP_COMMAND  (1 << 2) /* Encapsulated commands */
+#define NCM_NCAP_MAX_DATAGRAM   (1 << 3) /* Get/SetMaxDatagramSize */
+#define NCM_NCAP_CRC_MODE       (1 << 4) /* Get/SetCrcMode */
+#define NCM_NCAP_NTB_INPUT_SIZE (1 << 5) /* 8-byte GetNtbInputSize */
+
+/* NCM 1.0 Table 6-3: bmNtbFormatsSupported of the NTB Parameter
+ * Structure, and the NTB formats of Get/SetNtbFormat
+ */
+
+#define NCM_NTB16_SUPPORTED     (1 << 0)
+#define NCM_NTB32_SUPPORTED     (1 << 1)
+
+#define NCM_NTB16_FORMAT        0x00
+#define NCM_NTB32_FORMAT        0x01
+
+/* NCM 1.0 Tables 3-1 and 3-3: NTH16 and NDP16 signatures */
+
+#define NCM_NTH16_SIGNATURE     0x484d434e /* "NCMH" */
+#define NCM_NDP16_NOCRC_SIGN    0x304d434e /* "NCM0" */
+#define NCM_NDP16_CRC_SIGN      0x314d434e /* "NCM1" */
+
 /* Table 12: Requests, ATM Networking Control Model */
 
 #define ATM_SEND_COMMAND        0x00 /* Issues a command in the format of the supported control
@@ -352,6 +413,7 @@
 #define CDC_DSUBTYPE_CAPI       0x0e /* CAPI Control Management Functional Descriptor */
 #define CDC_DSUBTYPE_ECM        0x0f /* Ethernet Networking Functional Descriptor */
 #define CDC_DSUBTYPE_ATM        0x10 /* ATM Networking Functional Descriptor */
+#define CDC_DSUBTYPE_NCM        0x1a /* NCM Functional Descriptor */
 #define CDC_DSUBTYPE_MBIM       0x1b /* MBIM Functional Descriptor */
                                      /* 0x11-0xff Reserved (future use) */
 
@@ -911,6 +973,19 @@ struct cdc_atm_funcdesc_s
 
 #define SIZEOF_ATM_FUNCDESC 12
 
+/* NCM 1.0 Table 5-2: NCM Functional Descriptor */
+
+struct cdc_ncm_funcdesc_s
+{
+  uint8_t size;       /* bFunctionLength, Size of this descriptor */
+  uint8_t type;       /* bDescriptorType, USB_DESC_TYPE_CSINTERFACE */
+  uint8_t subtype;    /* bDescriptorSubType, CDC_DSUBTYPE_NCM */
+  uint8_t version[2]; /* bcdNcmVersion, Release of the NCM specification */
+  uint8_t caps;       /* bmNetworkCapabilities, See NCM_NCAP_* */
+};
+
+#define SIZEOF_NCM_FUNCDESC 6
+
 /* Descriptor Data Structures ************************************************/
 
 /* Table 50: Line Coding Structure */
@@ -955,6 +1030,54 @@ struct cdc_notification_s
 
 #define SIZEOF_NOTIFICATION_S(n) (sizeof(struct cdc_notification_s) + (n) - 1)
 
+/* NCM 1.0 Table 6-3: NTB Parameter Structure */
+
+struct cdc_ncm_ntbparams_s
+{
+  uint8_t len[2];      /* wLength, Size of this structure */
+  uint8_t formats[2];  /* bmNtbFormatsSupported, See NCM_NTB*_SUPPORTED */
+  uint8_t insize[4];   /* dwNtbInMaxSize, Maximum size of IN NTBs */
+  uint8_t indiv[2];    /* wNdpInDivisor, IN datagram alignment divisor */
+  uint8_t inrem[2];    /* wNdpInPayloadRemainder, and remainder */
+  uint8_t inalign[2];  /* wNdpInAlignment, Alignment of IN NDPs */
+  uint8_t reserved[2];
+  uint8_t outsize[4];  /* dwNtbOutMaxSize, Maximum size of OUT NTBs */
+  uint8_t outdiv[2];   /* wNdpOutDivisor, OUT datagram alignment divisor */
+  uint8_t outrem[2];   /* wNdpOutPayloadRemainder, and remainder */
+  uint8_t outalign[2]; /* wNdpOutAlignment, Alignment of OUT NDPs */
+  uint8_t outmax[2];   /* wNtbOutMaxDatagrams, 0 means no limit */
+};
+
+#define SIZEOF_NCM_NTBPARAMS 28
+
+/* NCM 1.0 Table 3-1: 16-bit NCM Transfer Header (NTH16) */
+
+struct cdc_ncm_nth16_s
+{
+  uint8_t sign[4];     /* dwSignature, NCM_NTH16_SIGNATURE */
+  uint8_t hdrlen[2];   /* wHeaderLength, Size of this header */
+  uint8_t seq[2];      /* wSequence, Sequence number of the NTB */
+  uint8_t blklen[2];   /* wBlockLength, Size of the whole NTB */
+  uint8_t ndpindex[2]; /* wNdpIndex, Offset of the first NDP */
+};
+
+#define SIZEOF_NCM_NTH16 12
+
+/* NCM 1.0 Table 3-3: 16-bit NCM Datagram Pointer Table (NDP16).  The
+ * header is followed by (wDatagramIndex, wDatagramLength) pairs, the last
+ * of which is zero.
+ */
+
+struct cdc_ncm_ndp16_s
+{
+  uint8_t sign[4];     /* dwSignature, NCM_NDP16_*_SIGN */
+  uint8_t len[2];      /* wLength, Size of this NDP */
+  uint8_t next[2];     /* wNextNdpIndex, Offset of the next NDP, 0 if none */
+  uint8_t dpe[1][4];   /* Datagram pointer entries begin here */
+};
+
+#define SIZEOF_NCM_NDP16(n) (8 + 4 * (n))
+
 /* Table 60: Unit Parameter Structure */
 
 struct cdc_unitparm_s
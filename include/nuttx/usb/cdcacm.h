@@ -158,8 +158,8 @@
  * bulk endpoint.  NOTE that difference sizes may be selected for full (FS)
  * or high speed (HS) modes.
  *
- * NOTE:  The BULKOUT request buffer size is always the same as the
- * maxpacket size.
+ * NOTE:  The BULKOUT request buffer size is the larger of the maxpacket
+ * size and CONFIG_CDCACM_BULKOUT_REQLEN.
  */
 
 #ifndef CONFIG_CDCACM_COMPOSITE
@@ -168,6 +168,10 @@
 #  endif
 #endif
 
+#ifndef CONFIG_CDCACM_BULKOUT_REQLEN
+#  define CONFIG_CDCACM_BULKOUT_REQLEN 0
+#endif
+
 #ifndef CONFIG_CDCACM_EPBULKOUT_FSSIZE
 #  define CONFIG_CDCACM_EPBULKOUT_FSSIZE 64
 #endif
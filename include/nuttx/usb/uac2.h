@@ -0,0 +1,82 @@
+/****************************************************************************
+ * include/nuttx/usb/uac2.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_USB_UAC2_H
+#define __INCLUDE_NUTTX_USB_UAC2_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/usb/usbdev.h>
+#include <nuttx/audio/i2s.h>
+
+/****************************************************************************
+ * Public Functions Definitions
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#  define EXTERN extern "C"
+extern "C"
+{
+#else
+#  define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: usbdev_uac2_get_composite_devdesc
+ *
+ * Description:
+ *   Helper function to fill in some constants into the composite
+ *   configuration struct.  The function uses two interfaces, one string
+ *   and two endpoints: devinfo.epno[0] is the isochronous OUT endpoint of
+ *   the audio data and devinfo.epno[1] the isochronous IN endpoint of the
+ *   feedback.
+ *
+ * Input Parameters:
+ *     dev - Pointer to the configuration struct we should fill
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void usbdev_uac2_get_composite_devdesc(FAR struct composite_devdesc_s *dev);
+
+/****************************************************************************
+ * Name: board_uac2_i2sdev
+ *
+ * Description:
+ *   Return the I2S device that plays the audio of the UAC2 function with
+ *   the given minor number.  The board-specific code must provide
+ *   implementation for this function.
+ *
+ ****************************************************************************/
+
+FAR struct i2s_dev_s *board_uac2_i2sdev(int minor);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_USB_UAC2_H */
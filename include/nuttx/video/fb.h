@@ -997,6 +997,80 @@ FAR struct fb_vtable_s *up_fbgetvplane(int display, int vplane);
 
 void up_fbuninitialize(int display);
 
+/****************************************************************************
+ * If an architecture has a 2-D graphics accelerator, then it may select
+ * CONFIG_FB_HWACCEL and provide the following APIs.  The graphics library
+ * will then offload large fills and copies into framebuffer memory.
+ ****************************************************************************/
+
+#ifdef CONFIG_FB_HWACCEL
+/****************************************************************************
+ * Name: up_fbfillarea
+ *
+ * Description:
+ *   Start filling an area of the plane with a solid color.  The operation
+ *   may still be in progress when this function returns; up_fbsync() must
+ *   be called before the CPU accesses the framebuffer memory again.
+ *
+ * Input Parameters:
+ *   pinfo - Describes the plane memory to be written
+ *   area  - The area within the plane to fill
+ *   color - The color in the native pixel format of the plane
+ *
+ * Returned Value:
+ *   Zero is returned if the fill was started.  A negated errno value is
+ *   returned if the accelerator cannot perform the operation; the caller
+ *   must then fall back to a software fill.
+ *
+ ****************************************************************************/
+
+int up_fbfillarea(FAR struct fb_planeinfo_s *pinfo,
+                  FAR const struct fb_area_s *area, uint32_t color);
+
+/****************************************************************************
+ * Name: up_fbcopyarea
+ *
+ * Description:
+ *   Copy an image in the native pixel format of the plane into an area of
+ *   the plane.  The source memory belongs to the caller, so the copy has
+ *   completed when this function returns.  The calling thread sleeps
+ *   while the accelerator runs.
+ *
+ *   The source may also be an area of the same plane that lies lower than
+ *   the destination (an upward move).  The accelerator must then copy the
+ *   rows from the top down.
+ *
+ * Input Parameters:
+ *   pinfo     - Describes the plane memory to be written
+ *   area      - The area within the plane to write
+ *   src       - The first source pixel to copy
+ *   srcstride - The length of a source line in bytes
+ *
+ * Returned Value:
+ *   Zero is returned on success.  A negated errno value is returned if the
+ *   accelerator cannot perform the operation; the caller must then fall
+ *   back to a software copy.
+ *
+ ****************************************************************************/
+
+int up_fbcopyarea(FAR struct fb_planeinfo_s *pinfo,
+                  FAR const struct fb_area_s *area,
+                  FAR const void *src, fb_coord_t srcstride);
+
+/****************************************************************************
+ * Name: up_fbsync
+ *
+ * Description:
+ *   Wait until any operation started by up_fbfillarea() has completed.
+ *
+ * Input Parameters:
+ *   pinfo - Describes the plane memory to be accessed
+ *
+ ****************************************************************************/
+
+void up_fbsync(FAR struct fb_planeinfo_s *pinfo);
+#endif
+
 /****************************************************************************
  * Name: fb_pollnotify
  *
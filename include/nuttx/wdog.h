@@ -75,7 +75,13 @@ struct wdog_s
 #ifdef CONFIG_PIC
   FAR void          *picbase;    /* PIC base address */
 #endif
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  FAR struct wdog_s *prev;       /* Previous in slot, the head's is the tail */
+  FAR struct wdog_s **slot;      /* Timing wheel slot holding the watchdog */
+  clock_t            expired;    /* Absolute expiration time in wheel ticks */
+#else
   sclock_t           lag;        /* Timer associated with the delay */
+#endif
 };
 
 /****************************************************************************
@@ -166,6 +172,25 @@ int wd_cancel(FAR struct wdog_s *wdog);
 
 sclock_t wd_gettime(FAR struct wdog_s *wdog);
 
+/****************************************************************************
+ * Name: wd_nextdelay
+ *
+ * Description:
+ *   This function returns the time remaining before the next active
+ *   watchdog timer expires, a lower bound of how long the system will stay
+ *   idle if nothing but the timers wakes it up.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The time in system ticks remaining until the next watchdog timer
+ *   expires, or a negative value if no watchdog timer is active.
+ *
+ ****************************************************************************/
+
+sclock_t wd_nextdelay(void);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -49,6 +49,15 @@
 #define bt_netdev_receive(btdev, type, data, len) \
         (btdev)->receive(btdev, type, data, len)
 
+/* Pass a received frame held in an IOB.  The frame starts at io_offset and
+ * io_len includes the offset.  On success the IOB belongs to the stack; on
+ * failure it remains with the caller.  Only available if receive_iob is
+ * not NULL.
+ */
+
+#define bt_netdev_receive_iob(btdev, type, iob) \
+        (btdev)->receive_iob(btdev, type, iob)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -79,6 +88,14 @@ struct bt_driver_s
                       enum bt_buf_type_e type,
                       FAR void *data, size_t len);
 
+  /* Filled by register function if the receiver can take over an IOB
+   * without copying it.  May be NULL, then receive() must be used.
+   */
+
+  CODE int (*receive_iob)(FAR struct bt_driver_s *btdev,
+                          enum bt_buf_type_e type,
+                          FAR struct iob_s *iob);
+
   /* Lower-half logic may support platform-specific ioctl commands */
 
   CODE int (*ioctl)(FAR struct bt_driver_s *btdev, int cmd,
@@ -241,6 +241,7 @@ typedef CODE void (*worker_t)(FAR void *arg);
  * fields is performed by the work APIs
  */
 
+struct kwork_wqueue_s;
 struct work_s
 {
   union
@@ -254,6 +255,12 @@ struct work_s
   } u;
   worker_t  worker;         /* Work callback */
   FAR void *arg;            /* Callback argument */
+#ifdef CONFIG_SCHED_WORKQUEUE
+  FAR struct kwork_wqueue_s *wq; /* Kernel work queue holding the work */
+#endif
+#ifdef CONFIG_WQUEUE_DEADLINE
+  clock_t   deadline;       /* Absolute time the work should have run by */
+#endif
 };
 
 /* This is an enumeration of the various events that may be
@@ -383,6 +390,78 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
 
 int work_cancel(int qid, FAR struct work_s *work);
 
+/****************************************************************************
+ * Name: work_queue_create
+ *
+ * Description:
+ *   Create a kernel work queue with its own worker thread(s), so that the
+ *   bottom halves of a driver do not wait behind unrelated work in the
+ *   shared high and low priority queues.  Work queues are never freed.
+ *
+ * Input Parameters:
+ *   name       - Name of the worker thread(s)
+ *   priority   - Priority of the worker thread(s)
+ *   stack_size - Stack size of each worker thread
+ *   nthreads   - Number of worker threads, at least one
+ *
+ * Returned Value:
+ *   The new work queue on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+FAR struct kwork_wqueue_s *work_queue_create(FAR const char *name,
+                                             int priority, int stack_size,
+                                             int nthreads);
+#endif
+
+/****************************************************************************
+ * Name: work_queue_wq and work_cancel_wq
+ *
+ * Description:
+ *   Same as work_queue() and work_cancel(), for a work queue created by
+ *   work_queue_create().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
+                  FAR struct work_s *work, worker_t worker,
+                  FAR void *arg, clock_t delay);
+int work_cancel_wq(FAR struct kwork_wqueue_s *wqueue,
+                   FAR struct work_s *work);
+#endif
+
+/****************************************************************************
+ * Name: work_queue_deadline
+ *
+ * Description:
+ *   Queue work like work_queue_wq() with an explicit deadline.  The work
+ *   that is ready to run is performed in order of deadline, so work with a
+ *   short deadline overtakes work that is already waiting.  Work queued
+ *   without a deadline has one of CONFIG_WQUEUE_DEADLINE_DEFAULT
+ *   milliseconds after it becomes ready.
+ *
+ * Input Parameters:
+ *   wqueue   - The work queue
+ *   work     - The work structure to queue
+ *   worker   - The worker callback to be invoked
+ *   arg      - The argument that will be passed to the worker callback
+ *   delay    - Delay (in clock ticks) until the work becomes ready
+ *   deadline - Time (in clock ticks) after it became ready by which the
+ *              work should have run
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WQUEUE_DEADLINE
+int work_queue_deadline(FAR struct kwork_wqueue_s *wqueue,
+                        FAR struct work_s *work, worker_t worker,
+                        FAR void *arg, clock_t delay, clock_t deadline);
+#endif
+
 /****************************************************************************
  * Name: work_foreach
  *
@@ -112,6 +112,9 @@ struct sem_s
 #ifdef CONFIG_PRIORITY_INHERITANCE
 #  if CONFIG_SEM_PREALLOCHOLDERS > 0
   FAR struct semholder_s *hhead; /* List of holders of semaphore counts */
+#    ifdef CONFIG_SEM_MUTEX_HOLDER
+  struct semholder_s holder;     /* Holder of a mutex, not in the list */
+#    endif
 #  else
   struct semholder_s holder;     /* Slot for old and new holder */
 #  endif
@@ -123,7 +126,12 @@ typedef struct sem_s sem_t;
 /* Initializers */
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
-#  if CONFIG_SEM_PREALLOCHOLDERS > 0
+#  if CONFIG_SEM_PREALLOCHOLDERS > 0 && defined(CONFIG_SEM_MUTEX_HOLDER)
+/* semcount, flags, waitlist, hhead, holder */
+
+#    define SEM_INITIALIZER(c) \
+       {(c), 0, SEM_WAITLIST_INITIALIZER, NULL, SEMHOLDER_INITIALIZER}
+#  elif CONFIG_SEM_PREALLOCHOLDERS > 0
 /* semcount, flags, waitlist, hhead */
 
 #    define SEM_INITIALIZER(c) \
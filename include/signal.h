@@ -359,6 +359,9 @@ struct siginfo
   pid_t        si_pid;       /* Sending task ID */
   int          si_status;    /* Exit value or signal (SIGCHLD only). */
 #endif
+#ifdef CONFIG_SIG_RTCOALESCE
+  int          si_overrun;   /* Number of coalesced signals that followed */
+#endif
 #if 0                        /* Not implemented */
   FAR void    *si_addr;      /* Report address with SIGFPE, SIGSEGV, or SIGBUS */
 #endif
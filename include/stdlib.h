@@ -276,6 +276,8 @@ FAR char *mkdtemp(FAR char *path_template);
 
 void      qsort(FAR void *base, size_t nel, size_t width,
                 CODE int (*compar)(FAR const void *, FAR const void *));
+void      radixsort32(FAR void *base, size_t nel, size_t width,
+                      size_t keyoff, FAR void *tmp);
 
 /* Binary search */
 
@@ -131,6 +131,7 @@
 #define MSG_ERRQUEUE     0x002000 /* Fetch message from error queue.  */
 #define MSG_NOSIGNAL     0x004000 /* Do not generate SIGPIPE.  */
 #define MSG_MORE         0x008000 /* Sender will send more.  */
+#define MSG_WAITFORONE   0x010000 /* recvmmsg(): block until 1+ packets.  */
 #define MSG_CMSG_CLOEXEC 0x100000 /* Set close_on_exit for file
                                    * descriptor received through SCM_RIGHTS.
                                    */
@@ -215,6 +216,13 @@
 #define SO_PEERCRED     18 /* Return the credentials of the peer process
                             * connected to this socket.
                             */
+#define SO_PRIORITY     19 /* Sets the transmit priority of the socket
+                            * (get/set).  arg: integer value 0-255
+                            */
+#define SO_TIMESTAMPING 20 /* Selects the packet timestamps to generate and
+                            * report (get/set).  arg: SOF_TIMESTAMPING_*
+                            * flags, see include/net/net_tstamp.h
+                            */
 
 /* The options are unsupported but included for compatibility
  * and portability
@@ -288,6 +296,8 @@
 #define SCM_RIGHTS      0x01    /* rw: access rights (array of int) */
 #define SCM_CREDENTIALS 0x02    /* rw: struct ucred */
 #define SCM_SECURITY    0x03    /* rw: security label */
+#define SCM_TIMESTAMPING SO_TIMESTAMPING
+                                /* r: struct scm_timestamping */
 
 /* Desired design of maximum size and alignment (see RFC2553) */
 
@@ -348,6 +358,14 @@ struct msghdr
   unsigned int msg_flags;
 };
 
+/* One message of the vector given to sendmmsg/recvmmsg */
+
+struct mmsghdr
+{
+  struct msghdr msg_hdr;        /* The message */
+  unsigned int msg_len;         /* Number of bytes transferred */
+};
+
 struct cmsghdr
 {
   unsigned long cmsg_len;       /* Data byte count, including hdr */
@@ -435,6 +453,12 @@ int getpeername(int sockfd, FAR struct sockaddr *addr,
 ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags);
 ssize_t sendmsg(int sockfd, FAR struct msghdr *msg, int flags);
 
+struct timespec;
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout);
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags);
+
 #if CONFIG_FORTIFY_SOURCE > 0
 fortify_function(send) ssize_t send(int sockfd, FAR const void *buf,
                                     size_t len, int flags)
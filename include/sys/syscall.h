@@ -99,6 +99,23 @@ EXTERN const char *g_funcnames[SYS_nsyscalls];
  * Public Function Prototypes
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: syscall_account
+ *
+ * Description:
+ *   Add one system call to the statistics of /proc/syscalls.  Called by the
+ *   architecture when the call returns to the caller.
+ *
+ * Input Parameters:
+ *   nr      - The system call number, less CONFIG_SYS_RESERVED
+ *   elapsed - The up_perf_gettime() units since the entry of the call
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSCALL_STATS
+void syscall_account(unsigned int nr, unsigned long elapsed);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -88,6 +88,18 @@ SYSCALL_LOOKUP(sem_wait,                   1)
   SYSCALL_LOOKUP(sem_setprotocol,          2)
 #endif
 
+/* Event groups */
+
+#ifdef CONFIG_SCHED_EVENTS
+  SYSCALL_LOOKUP(nxevent_init,             2)
+  SYSCALL_LOOKUP(nxevent_destroy,          1)
+  SYSCALL_LOOKUP(nxevent_post,             2)
+  SYSCALL_LOOKUP(nxevent_clear,            2)
+  SYSCALL_LOOKUP(nxevent_wait,             3)
+  SYSCALL_LOOKUP(nxevent_tickwait,         4)
+  SYSCALL_LOOKUP(nxevent_trywait,          3)
+#endif
+
 /* Named semaphores */
 
 #ifdef CONFIG_FS_NAMED_SEMAPHORES
@@ -172,9 +184,13 @@ SYSCALL_LOOKUP(clock_nanosleep,            4)
 SYSCALL_LOOKUP(clock,                      0)
 SYSCALL_LOOKUP(clock_gettime,              2)
 SYSCALL_LOOKUP(clock_settime,              2)
+SYSCALL_LOOKUP(clock_adjtime,              2)
 #ifdef CONFIG_CLOCK_TIMEKEEPING
   SYSCALL_LOOKUP(adjtime,                  2)
 #endif
+#ifdef CONFIG_CLOCK_TIMEPAGE
+  SYSCALL_LOOKUP(clock_timepage,           0)
+#endif
 
 /* The following are defined only if POSIX timers are supported */
 
@@ -202,6 +218,8 @@ SYSCALL_LOOKUP(read,                       3)
 SYSCALL_LOOKUP(write,                      3)
 SYSCALL_LOOKUP(pread,                      4)
 SYSCALL_LOOKUP(pwrite,                     4)
+SYSCALL_LOOKUP(readv,                      3)
+SYSCALL_LOOKUP(writev,                     3)
 #ifdef CONFIG_FS_AIO
   SYSCALL_LOOKUP(aio_read,                 1)
   SYSCALL_LOOKUP(aio_write,                1)
@@ -315,8 +333,8 @@ SYSCALL_LOOKUP(munmap,                     2)
   SYSCALL_LOOKUP(pthread_mutex_destroy,    1)
   SYSCALL_LOOKUP(pthread_mutex_init,       2)
   SYSCALL_LOOKUP(pthread_mutex_timedlock,  2)
-  SYSCALL_LOOKUP(pthread_mutex_trylock,    1)
-  SYSCALL_LOOKUP(pthread_mutex_unlock,     1)
+  SYSCALL_LOOKUP(nx_pthread_mutex_trylock, 1)
+  SYSCALL_LOOKUP(nx_pthread_mutex_unlock,  1)
 #ifndef CONFIG_PTHREAD_MUTEX_UNSAFE
   SYSCALL_LOOKUP(pthread_mutex_consistent, 1)
 #endif
@@ -369,9 +387,11 @@ SYSCALL_LOOKUP(munmap,                     2)
   SYSCALL_LOOKUP(recv,                     4)
   SYSCALL_LOOKUP(recvfrom,                 6)
   SYSCALL_LOOKUP(recvmsg,                  3)
+  SYSCALL_LOOKUP(recvmmsg,                 5)
   SYSCALL_LOOKUP(send,                     4)
   SYSCALL_LOOKUP(sendto,                   6)
   SYSCALL_LOOKUP(sendmsg,                  3)
+  SYSCALL_LOOKUP(sendmmsg,                 4)
   SYSCALL_LOOKUP(setsockopt,               5)
   SYSCALL_LOOKUP(shutdown,                 2)
   SYSCALL_LOOKUP(socket,                   3)
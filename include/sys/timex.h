@@ -0,0 +1,110 @@
+/****************************************************************************
+ * include/sys/timex.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_SYS_TIMEX_H
+#define __INCLUDE_SYS_TIMEX_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/time.h>
+#include <time.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Mode bits of struct timex */
+
+#define ADJ_OFFSET     0x0001  /* Slew the clock by 'offset' */
+#define ADJ_FREQUENCY  0x0002  /* Set the frequency offset to 'freq' */
+#define ADJ_SETOFFSET  0x0100  /* Step the clock by 'time' */
+#define ADJ_NANO       0x2000  /* 'offset' and time.tv_usec are nanoseconds */
+
+/* Clock states returned by clock_adjtime() */
+
+#define TIME_OK        0       /* Clock synchronized */
+#define TIME_ERROR     5       /* Clock not synchronized */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The fields of struct timex follow Linux.  Only the fields selected by
+ * the supported mode bits are used; the remaining ones are returned as
+ * zero.
+ */
+
+struct timex
+{
+  unsigned int modes;    /* Mode bits, see ADJ_* definitions */
+  long offset;           /* Slew offset (microseconds or nanoseconds) */
+  long freq;             /* Frequency offset (ppm scaled by 2^16) */
+  long maxerror;         /* Maximum error (microseconds) */
+  long esterror;         /* Estimated error (microseconds) */
+  int status;            /* Clock status */
+  long constant;         /* PLL time constant */
+  long precision;        /* Clock precision (microseconds, read-only) */
+  long tolerance;        /* Maximum frequency error (read-only) */
+  struct timeval time;   /* Current time (read-only, except ADJ_SETOFFSET) */
+  long tick;             /* Microseconds between clock ticks */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: clock_adjtime
+ *
+ * Description:
+ *   Read or adjust a clock.  With 'modes' zero only the state of the clock
+ *   is returned.  ADJ_SETOFFSET steps the clock by 'time' and ADJ_OFFSET
+ *   slews it by 'offset' through adjtime(), if that is available.  Only
+ *   CLOCK_REALTIME is supported.
+ *
+ *   NOTE: This is not a POSIX interface.  It is supported for Linux
+ *   compatibility, as used by PTP and NTP daemons.
+ *
+ * Returned Value:
+ *   The clock state (TIME_OK) on success; -1 with errno set on failure.
+ *
+ ****************************************************************************/
+
+int clock_adjtime(clockid_t clk_id, FAR struct timex *buf);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __INCLUDE_SYS_TIMEX_H */
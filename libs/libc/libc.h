@@ -175,6 +175,13 @@
 #  define LIBC_BUILD_STRRCHR
 #endif
 
+/* Without a stdio buffer pool, setvbuf() buffers come from the heap */
+
+#if !defined(CONFIG_STDIO_BUFFER_POOL) || CONFIG_STDIO_BUFFER_POOL == 0
+#  define lib_bufpool_alloc(s) ((FAR unsigned char *)lib_malloc(s))
+#  define lib_bufpool_free(b)  lib_free(b)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -236,6 +243,13 @@ FAR char *lib_fgets(FAR char *buf, size_t buflen, FILE *stream,
 
 ssize_t lib_fflush(FAR FILE *stream, bool bforce);
 
+/* Defined in lib_libbufpool.c */
+
+#if defined(CONFIG_STDIO_BUFFER_POOL) && CONFIG_STDIO_BUFFER_POOL > 0
+FAR unsigned char *lib_bufpool_alloc(size_t size);
+void lib_bufpool_free(FAR unsigned char *buf);
+#endif
+
 /* Defined in lib_rdflush.c */
 
 int lib_rdflush(FAR FILE *stream);
@@ -494,6 +494,7 @@ int up_relocate(const Elf32_Rel *rel, const Elf32_Sym *sym, uintptr_t addr)
       break;
 
     case R_ARM_RELATIVE:
+    case R_ARM_GLOB_DAT:
     case R_ARM_JUMP_SLOT:
       {
         *(uint32_t *)addr = (uint32_t)sym->st_value;
@@ -39,6 +39,7 @@
 #include <sys/types.h>
 #include <stdint.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/crc16.h>
 
 /************************************************************************************************
@@ -99,6 +100,15 @@ uint16_t crc16part(FAR const uint8_t *src, size_t len, uint16_t crc16val)
 {
   size_t i;
 
+#ifdef CONFIG_ARCH_CRC
+  /* Use the CRC unit of the chip when it is available */
+
+  if (up_crc16part(src, len, &crc16val) >= 0)
+    {
+      return crc16val;
+    }
+#endif
+
   for (i = 0; i < len; i++)
     {
       crc16val = crc16_tab[((crc16val >> 8) & 0xff) ^
@@ -197,6 +197,15 @@ int nxmutex_lock(FAR mutex_t *mutex)
   int ret;
 
   DEBUGASSERT(!nxmutex_is_hold(mutex));
+
+  /* An uncontended mutex is taken without calling into the OS */
+
+  if (nxsem_trywait_fast(&mutex->sem))
+    {
+      mutex->holder = _SCHED_GETTID();
+      return OK;
+    }
+
   for (; ; )
     {
       /* Take the semaphore (perhaps waiting) */
@@ -242,6 +251,12 @@ int nxmutex_trylock(FAR mutex_t *mutex)
   int ret;
 
   DEBUGASSERT(!nxmutex_is_hold(mutex));
+  if (nxsem_trywait_fast(&mutex->sem))
+    {
+      mutex->holder = _SCHED_GETTID();
+      return OK;
+    }
+
   ret = _SEM_TRYWAIT(&mutex->sem);
   if (ret < 0)
     {
@@ -340,6 +355,11 @@ int nxmutex_unlock(FAR mutex_t *mutex)
 
   mutex->holder = NXMUTEX_NO_HOLDER;
 
+  if (nxsem_post_fast(&mutex->sem))
+    {
+      return OK;
+    }
+
   ret = _SEM_POST(&mutex->sem);
   if (ret < 0)
     {
@@ -524,6 +524,10 @@ int modlib_insertsymtab(FAR struct module_s *modp,
                   j++;
                 }
             }
+
+#ifdef CONFIG_SYMTAB_HASHED
+          symtab_sortbyhash(symbol, symcount);
+#endif
         }
       else
         {
@@ -26,6 +26,8 @@
 
 #include <pthread.h>
 
+#include <nuttx/pthread.h>
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -82,6 +84,13 @@
 
 int pthread_mutex_lock(FAR pthread_mutex_t *mutex)
 {
+  /* Take an uncontended mutex without a system call */
+
+  if (pthread_mutex_trylock_fast(mutex))
+    {
+      return OK;
+    }
+
   /* pthread_mutex_lock() is equivalent to pthread_mutex_timedlock() when
    * the absolute time delay is a NULL value.
    */
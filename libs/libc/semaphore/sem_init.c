@@ -81,6 +81,9 @@ int nxsem_init(FAR sem_t *sem, int pshared, unsigned int value)
 #ifdef CONFIG_PRIORITY_INHERITANCE
 #  if CONFIG_SEM_PREALLOCHOLDERS > 0
   sem->hhead = NULL;
+#    ifdef CONFIG_SEM_MUTEX_HOLDER
+  INITIALIZE_SEMHOLDER(&sem->holder);
+#    endif
 #  else
   INITIALIZE_SEMHOLDER(&sem->holder);
 #  endif
@@ -38,6 +38,7 @@
  ****************************************************************************/
 
 #include <math.h>
+#include <string.h>
 
 #include <sys/param.h>
 
@@ -58,6 +59,140 @@
 #define MIN_MANT_INT  ((uint64_t)MIN_MANT)
 #define MIN_MANT_EXP  DBL_DIG
 
+/* The decimal exponent can be estimated from the binary one if double is
+ * the IEEE 754 binary64 format.
+ */
+
+#if DBL_MANT_DIG == 53 && DBL_MAX_EXP == 1024
+#  define DTOA_IEEE754
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef DTOA_IEEE754
+/****************************************************************************
+ * Name: dtoa_scale10
+ *
+ * Description:
+ *   Return x * 10 ** n, applying the scale factors from the largest to the
+ *   smallest as the search in dtoa_scale() does.
+ *
+ ****************************************************************************/
+
+static double dtoa_scale10(double x, int n)
+{
+  int i;
+
+  if (n > 0)
+    {
+      for (i = DTOA_SCALE_UP_NUM - 1; i >= 0; i--)
+        {
+          if (n & (1 << i))
+            {
+              x *= g_dtoa_scale_up[i];
+            }
+        }
+    }
+  else
+    {
+      n = -n;
+      for (i = DTOA_SCALE_DOWN_NUM - 1; i >= 0; i--)
+        {
+          if (n & (1 << i))
+            {
+              x *= g_dtoa_scale_down[i];
+            }
+        }
+    }
+
+  return x;
+}
+#endif
+
+/****************************************************************************
+ * Name: dtoa_scale
+ *
+ * Description:
+ *   Bring the positive, finite x within range MIN_MANT <= x < MAX_MANT and
+ *   return the decimal exponent of its leading digit in exp.
+ *
+ ****************************************************************************/
+
+static double dtoa_scale(double x, FAR int32_t *exp)
+{
+  double y;
+  int i;
+
+#ifdef DTOA_IEEE754
+  uint64_t bits;
+  int e2;
+
+  memcpy(&bits, &x, sizeof(bits));
+  e2 = (int)((bits >> 52) & 0x7ff);
+  if (e2 != 0)
+    {
+      /* A normal x is in [2 ** (e2 - 1023), 2 ** (e2 - 1022)), so its
+       * decimal exponent is close to (e2 - 1023) * log10(2), which is
+       * ((e2 - 1023) * 1233) >> 12.  Only the factors of the resulting
+       * power of ten need to be applied, instead of trying every one of
+       * them.  The estimate is off by at most one.
+       */
+
+      *exp = ((e2 - 1023 + 4096) * 1233 >> 12) - 1233;
+
+      for (; ; )
+        {
+          y = dtoa_scale10(x, MIN_MANT_EXP - *exp);
+          if (y >= MAX_MANT)
+            {
+              (*exp)++;
+            }
+          else if (y < MIN_MANT)
+            {
+              (*exp)--;
+            }
+          else
+            {
+              return y;
+            }
+        }
+    }
+#endif
+
+  /* Subnormal numbers and other formats: search the exponent */
+
+  *exp = MIN_MANT_EXP;
+
+  if (x < MIN_MANT)
+    {
+      for (i = DTOA_SCALE_UP_NUM - 1; i >= 0; i--)
+        {
+          y = x * g_dtoa_scale_up[i];
+          if (y < MAX_MANT)
+            {
+              x = y;
+              *exp -= (1 << i);
+            }
+        }
+    }
+  else
+    {
+      for (i = DTOA_SCALE_DOWN_NUM - 1; i >= 0; i--)
+        {
+          y = x * g_dtoa_scale_down[i];
+          if (y >= MIN_MANT)
+            {
+              x = y;
+              *exp += (1 << i);
+            }
+        }
+    }
+
+  return x;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -91,38 +226,15 @@ int __dtoa_engine(double x, FAR struct dtoa_s *dtoa, int max_digits,
     }
   else
     {
-      double y;
-
-      exp = MIN_MANT_EXP;
+      char digits[MIN_MANT_EXP + 1];
+      uint64_t mant;
+      int j;
 
       /* Bring x within range MIN_MANT <= x < MAX_MANT while computing
        * exponent value
        */
 
-      if (x < MIN_MANT)
-        {
-          for (i = DTOA_SCALE_UP_NUM - 1; i >= 0; i--)
-            {
-              y = x * g_dtoa_scale_up[i];
-              if (y < MAX_MANT)
-                {
-                  x = y;
-                  exp -= (1 << i);
-                }
-            }
-        }
-      else
-        {
-          for (i = DTOA_SCALE_DOWN_NUM - 1; i >= 0; i--)
-            {
-              y = x * g_dtoa_scale_down[i];
-              if (y >= MIN_MANT)
-                {
-                  x = y;
-                  exp += (1 << i);
-                }
-            }
-        }
+      x = dtoa_scale(x, &exp);
 
       /* If limiting decimals, then limit the max digits to no more than the
        * number of digits left of the decimal plus the number of digits right
@@ -147,19 +259,27 @@ int __dtoa_engine(double x, FAR struct dtoa_s *dtoa, int max_digits,
           exp++;
         }
 
-      /* Now convert mantissa to decimal. */
-
-      uint64_t mant = (uint64_t)x;
-      uint64_t decimal = MIN_MANT_INT;
+      /* Now convert mantissa to decimal.  It is split in chunks of eight
+       * digits so that the digits are computed with 32-bit arithmetic
+       * rather than with two long long divisions each.
+       */
 
-      /* Compute digits */
+      mant = (uint64_t)x;
+      i    = MIN_MANT_EXP;
 
-      for (i = 0; i < max_digits; i++)
+      while (i >= 0)
         {
-          dtoa->digits[i] = mant / decimal + '0';
-          mant %= decimal;
-          decimal /= 10;
+          uint32_t part = mant % 100000000;
+
+          mant /= 100000000;
+          for (j = 0; j < 8 && i >= 0; j++, i--)
+            {
+              digits[i] = part % 10 + '0';
+              part /= 10;
+            }
         }
+
+      memcpy(dtoa->digits, digits, max_digits);
     }
 
   dtoa->digits[max_digits] = '\0';
@@ -153,7 +153,7 @@ int fclose(FAR FILE *stream)
       if (stream->fs_bufstart != NULL &&
           (stream->fs_flags & __FS_FLAG_UBF) == 0)
         {
-          lib_free(stream->fs_bufstart);
+          lib_bufpool_free(stream->fs_bufstart);
         }
 #endif
 
@@ -0,0 +1,117 @@
+/****************************************************************************
+ * libs/libc/stdio/lib_libbufpool.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/compiler.h>
+#include <nuttx/mutex.h>
+
+#include "libc.h"
+
+#if defined(CONFIG_STDIO_BUFFER_POOL) && CONFIG_STDIO_BUFFER_POOL > 0
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static aligned_data(sizeof(uintptr_t))
+unsigned char g_bufpool[CONFIG_STDIO_BUFFER_POOL]
+                       [CONFIG_STDIO_BUFFER_POOL_SIZE];
+static uint32_t g_bufpool_used;
+static mutex_t g_bufpool_lock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lib_bufpool_alloc
+ *
+ * Description:
+ *   Allocate a stream buffer of the given size for setvbuf().  It is taken
+ *   from the stdio buffer pool if it fits and a pool buffer is free, and
+ *   from the heap otherwise.
+ *
+ * Returned Value:
+ *   The buffer, or NULL if no memory is available.
+ *
+ ****************************************************************************/
+
+FAR unsigned char *lib_bufpool_alloc(size_t size)
+{
+  FAR unsigned char *buf = NULL;
+  int i;
+
+  if (size <= CONFIG_STDIO_BUFFER_POOL_SIZE)
+    {
+      nxmutex_lock(&g_bufpool_lock);
+      for (i = 0; i < CONFIG_STDIO_BUFFER_POOL; i++)
+        {
+          if ((g_bufpool_used & (UINT32_C(1) << i)) == 0)
+            {
+              g_bufpool_used |= UINT32_C(1) << i;
+              buf = g_bufpool[i];
+              break;
+            }
+        }
+
+      nxmutex_unlock(&g_bufpool_lock);
+    }
+
+  if (buf == NULL)
+    {
+      buf = lib_malloc(size);
+    }
+
+  return buf;
+}
+
+/****************************************************************************
+ * Name: lib_bufpool_free
+ *
+ * Description:
+ *   Release a buffer allocated by lib_bufpool_alloc().
+ *
+ ****************************************************************************/
+
+void lib_bufpool_free(FAR unsigned char *buf)
+{
+  uintptr_t offset = (uintptr_t)buf - (uintptr_t)g_bufpool;
+
+  if (offset < sizeof(g_bufpool))
+    {
+      nxmutex_lock(&g_bufpool_lock);
+      g_bufpool_used &= ~(UINT32_C(1) <<
+                          (offset / CONFIG_STDIO_BUFFER_POOL_SIZE));
+      nxmutex_unlock(&g_bufpool_lock);
+    }
+  else
+    {
+      lib_free(buf);
+    }
+}
+
+#endif /* CONFIG_STDIO_BUFFER_POOL > 0 */
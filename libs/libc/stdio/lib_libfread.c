@@ -130,15 +130,16 @@ ssize_t lib_fread(FAR void *ptr, size_t count, FAR FILE *stream)
 
               if (gulp_size > 0)
                 {
-                  if (gulp_size > count)
+                  if (gulp_size > remaining)
                     {
                       /* Clip the gulp size to the requested byte count */
 
-                      gulp_size = count;
+                      gulp_size = remaining;
                     }
 
                   memcpy(dest, stream->fs_bufpos, gulp_size);
 
+                  dest      += gulp_size;
                   remaining -= gulp_size;
                   stream->fs_bufpos += gulp_size;
                 }
@@ -167,11 +168,12 @@ ssize_t lib_fread(FAR void *ptr, size_t count, FAR FILE *stream)
 
                   /* Will the number of bytes that we need to read fit into
                    * the buffer space that is available? If the read size is
-                   * larger than the buffer, then read some of the data
-                   * directly into the user's buffer.
+                   * at least the size of the buffer, then read the data
+                   * directly into the user's buffer rather than copying it
+                   * through the buffer.
                    */
 
-                  if (remaining > buffer_available)
+                  if (remaining >= buffer_available)
                     {
                       bytes_read = _NX_READ(stream->fs_fd, dest, remaining);
                       if (bytes_read < 0)
@@ -27,6 +27,7 @@
 #include <sys/types.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
@@ -95,29 +96,51 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
       goto errout_with_lock;
     }
 
-  /* Determine the number of bytes left in the buffer */
+  /* A write that is at least as large as the buffer would only be copied
+   * through it.  Flush the data already buffered, to keep the order, and
+   * write the user data directly.
+   */
 
-  gulp_size = stream->fs_bufend - stream->fs_bufpos;
-  if (gulp_size != CONFIG_STDIO_BUFFER_SIZE || count < gulp_size)
+  if (count >= (size_t)(stream->fs_bufend - stream->fs_bufstart))
     {
-      if (gulp_size > count)
+      if (lib_fflush(stream, true) < 0)
         {
-          /* Yes, clip the gulp to the size of the user data */
+          goto errout_with_lock;
+        }
 
-          gulp_size = count;
+      while (count > 0)
+        {
+          ret = _NX_WRITE(stream->fs_fd, src, count);
+          if (ret < 0)
+            {
+              _NX_SETERRNO(ret);
+              ret = ERROR;
+              goto errout_with_lock;
+            }
+
+          src   += ret;
+          count -= ret;
         }
+    }
 
-      /* Adjust the number of bytes remaining to be transferred
-       * on the next pass through the loop (might be zero).
+  while (count > 0)
+    {
+      /* Determine the number of bytes left in the buffer and clip the
+       * gulp to the size of the user data.
        */
 
-      count -= gulp_size;
+      gulp_size = stream->fs_bufend - stream->fs_bufpos;
+      if (gulp_size > count)
+        {
+          gulp_size = count;
+        }
 
       /* Transfer the data into the buffer */
 
       memcpy(stream->fs_bufpos, src, gulp_size);
       stream->fs_bufpos += gulp_size;
-      src += gulp_size;
+      src   += gulp_size;
+      count -= gulp_size;
 
       /* Is the buffer full? */
 
@@ -125,33 +148,13 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
         {
           /* Flush the buffered data to the IO stream */
 
-          int bytes_buffered = lib_fflush(stream, false);
-          if (bytes_buffered < 0)
+          if (lib_fflush(stream, false) < 0)
             {
               goto errout_with_lock;
             }
         }
     }
 
-  if (count >= CONFIG_STDIO_BUFFER_SIZE)
-    {
-      ret = _NX_WRITE(stream->fs_fd, src, count);
-      if (ret < 0)
-        {
-          _NX_SETERRNO(ret);
-          ret = ERROR;
-          goto errout_with_lock;
-        }
-
-      src += ret;
-    }
-  else if (count > 0)
-    {
-      memcpy(stream->fs_bufpos, src, count);
-      stream->fs_bufpos += count;
-      src += count;
-    }
-
   /* Return the number of bytes written */
 
   ret = (uintptr_t)src - (uintptr_t)start;
@@ -191,6 +191,27 @@ static int vsprintf_internal(FAR struct lib_outstream_s *stream,
     {
       for (; ; )
         {
+#ifndef CONFIG_ARCH_ROMGETC
+          /* Write the literal text up to the next conversion in one call
+           * rather than a character at a time.
+           */
+
+          for (pnt = fmt; *fmt != '\0' && *fmt != '%'; fmt++);
+
+          size = fmt - pnt;
+          if (size > 0)
+            {
+#ifdef CONFIG_LIBC_NUMBERED_ARGS
+              if (stream != NULL)
+                {
+                  stream_puts(pnt, size, stream);
+                }
+#else
+              stream_puts(pnt, size, stream);
+#endif
+            }
+#endif
+
           c = fmt_char(fmt);
           if (c == '\0')
             {
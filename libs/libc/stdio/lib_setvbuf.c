@@ -192,7 +192,7 @@ int setvbuf(FAR FILE *stream, FAR char *buffer, int mode, size_t size)
               }
             else
               {
-                newbuf = (FAR unsigned char *)lib_malloc(size);
+                newbuf = lib_bufpool_alloc(size);
                 if (newbuf == NULL)
                   {
                     errcode = ENOMEM;
@@ -232,7 +232,7 @@ int setvbuf(FAR FILE *stream, FAR char *buffer, int mode, size_t size)
   if (stream->fs_bufstart != NULL &&
      (stream->fs_flags & __FS_FLAG_UBF) == 0)
     {
-      lib_free(stream->fs_bufstart);
+      lib_bufpool_free(stream->fs_bufstart);
     }
 
   /* Set the new buffer information */
@@ -37,6 +37,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <limits.h>
+
 #include "lib_ultoa_invert.h"
 
 /****************************************************************************
@@ -49,36 +51,70 @@ FAR char *__ultoa_invert(unsigned long long val, FAR char *str, int base)
 FAR char *__ultoa_invert(unsigned long val, FAR char *str, int base)
 #endif
 {
-  int upper = 0;
+  FAR const char *digits = "0123456789abcdef";
+  unsigned long v;
 
   if (base & XTOA_UPPER)
     {
-      upper = 1;
+      digits = "0123456789ABCDEF";
       base &= ~XTOA_UPPER;
     }
 
-  do
+#ifdef CONFIG_LIBC_LONG_LONG
+  /* Use the (slow, on 32-bit targets) long long division only for as
+   * many digits as the value does not fit in an unsigned long.
+   */
+
+  while (val > ULONG_MAX)
+    {
+      *str++ = digits[val % base];
+      val   /= base;
+    }
+#endif
+
+  /* Specialize the common bases so that the compiler can replace the
+   * division by a multiplication or a shift.
+   */
+
+  v = val;
+  switch (base)
     {
-      int v;
+      case 10:
+        do
+          {
+            *str++ = '0' + v % 10;
+            v     /= 10;
+          }
+        while (v);
+        break;
 
-      v   = val % base;
-      val = val / base;
+      case 16:
+        do
+          {
+            *str++ = digits[v & 0xf];
+            v    >>= 4;
+          }
+        while (v);
+        break;
 
-      if (v <= 9)
-        {
-          v += '0';
-        }
-      else
-        {
-          if (upper)
-            v += 'A' - 10;
-          else
-            v += 'a' - 10;
-        }
+      case 8:
+        do
+          {
+            *str++ = '0' + (v & 7);
+            v    >>= 3;
+          }
+        while (v);
+        break;
 
-      *str++ = v;
+      default:
+        do
+          {
+            *str++ = digits[v % base];
+            v     /= base;
+          }
+        while (v);
+        break;
     }
-  while (val);
 
   return str;
 }
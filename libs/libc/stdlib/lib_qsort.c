@@ -48,6 +48,8 @@
 
 #include <sys/types.h>
 #include <sys/param.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 /****************************************************************************
@@ -84,6 +86,12 @@
 
 #define vecswap(a, b, n) if ((n) > 0) swapfunc(a, b, n, swaptype)
 
+#define elem(i) ((FAR char *)base + (i) * width)
+
+/* Partitions smaller than this are sorted by insertion */
+
+#define QSORT_INSERTION 12
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -119,50 +127,104 @@ static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
 }
 
 /****************************************************************************
- * Public Function
+ * Name: insertion_sort
+ *
+ * Description:
+ *   Sort by insertion.  Give up and return false after more than 'limit'
+ *   element moves, leaving the elements permuted.
+ *
  ****************************************************************************/
 
+static bool insertion_sort(FAR void *base, size_t nel, size_t width,
+                           int swaptype, size_t limit,
+                           CODE int (*compar)(FAR const void *,
+                                              FAR const void *))
+{
+  FAR char *pm;
+  FAR char *pl;
+
+  for (pm = elem(1); pm < elem(nel); pm += width)
+    {
+      for (pl = pm;
+           pl > (FAR char *)base && compar(pl - width, pl) > 0;
+           pl -= width)
+        {
+          if (limit-- == 0)
+            {
+              return false;
+            }
+
+          swap(pl, pl - width);
+        }
+    }
+
+  return true;
+}
+
 /****************************************************************************
- * Name: qsort
+ * Name: heap_sort
  *
  * Description:
- *   The qsort() function will sort an array of 'nel' objects, the initial
- *   element of which is pointed to by 'base'. The size of each object, in
- *   bytes, is specified by the 'width" argument. If the 'nel' argument has
- *   the value zero, the comparison function pointed to by 'compar' will not
- *   be called and no rearrangement will take place.
- *
- *   The application will ensure that the comparison function pointed to by
- *   'compar' does not alter the contents of the array. The implementation
- *   may reorder elements of the array between calls to the comparison
- *   function, but will not alter the contents of any individual element.
- *
- *   When the same objects (consisting of 'width" bytes, irrespective of
- *   their current positions in the array) are passed more than once to
- *   the comparison function, the results will be consistent with one
- *   another. That is, they will define a total ordering on the array.
+ *   Sort by heapsort.  Used for the ranges on which quicksort is found to
+ *   degenerate.
  *
- *   The contents of the array will be sorted in ascending order according
- *   to a comparison function. The 'compar' argument is a pointer to the
- *   comparison function, which is called with two arguments that point to
- *   the elements being compared. The application will ensure that the
- *   function returns an integer less than, equal to, or greater than 0,
- *   if the first argument is considered respectively less than, equal to,
- *   or greater than the second. If two members compare as equal, their
- *   order in the sorted array is unspecified.
- *
- *   (Based on description from OpenGroup.org).
- *
- * Returned Value:
- *   The qsort() function will not return a value.
+ ****************************************************************************/
+
+static void heap_sort(FAR void *base, size_t nel, size_t width,
+                      int swaptype,
+                      CODE int (*compar)(FAR const void *,
+                                         FAR const void *))
+{
+  size_t start = nel / 2;
+  size_t root;
+  size_t child;
+
+  while (nel > 1)
+    {
+      /* First build the heap, then move its root to the end */
+
+      if (start > 0)
+        {
+          root = --start;
+        }
+      else
+        {
+          nel--;
+          swap(elem(0), elem(nel));
+          root = 0;
+        }
+
+      /* Sift the root down */
+
+      while ((child = 2 * root + 1) < nel)
+        {
+          if (child + 1 < nel && compar(elem(child), elem(child + 1)) < 0)
+            {
+              child++;
+            }
+
+          if (compar(elem(root), elem(child)) >= 0)
+            {
+              break;
+            }
+
+          swap(elem(root), elem(child));
+          root = child;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: intro_sort
  *
- * Notes from the original BSD version:
- *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ * Description:
+ *   Sort by quicksort while 'depth' partitions remain, then by heapsort.
  *
  ****************************************************************************/
 
-void qsort(FAR void *base, size_t nel, size_t width,
-           CODE int(*compar)(FAR const void *, FAR const void *))
+static void intro_sort(FAR void *base, size_t nel, size_t width, int depth,
+                       CODE int (*compar)(FAR const void *,
+                                          FAR const void *))
 {
   FAR char *pa;
   FAR char *pb;
@@ -171,6 +233,9 @@ void qsort(FAR void *base, size_t nel, size_t width,
   FAR char *pl;
   FAR char *pm;
   FAR char *pn;
+  bool presorted = true;
+  size_t lnel;
+  size_t rnel;
   int swaptype;
   int swap_cnt;
   int d;
@@ -180,43 +245,35 @@ loop:
   SWAPINIT(base, width);
   swap_cnt = 0;
 
-  if (nel < 7)
+  if (nel < QSORT_INSERTION)
     {
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
-        {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
-            {
-              swap(pl, pl - width);
-            }
-        }
-
+      insertion_sort(base, nel, width, swaptype, SIZE_MAX, compar);
       return;
     }
 
-  pm = (FAR char *)base + (nel / 2) * width;
-  if (nel > 7)
+  if (depth-- <= 0)
     {
-      pl = base;
-      pn = (FAR char *)base + (nel - 1) * width;
-      if (nel > 40)
-        {
-          d  = (nel / 8) * width;
-          pl = med3(pl, pl + d, pl + 2 * d, compar);
-          pm = med3(pm - d, pm, pm + d, compar);
-          pn = med3(pn - 2 * d, pn - d, pn, compar);
-        }
+      heap_sort(base, nel, width, swaptype, compar);
+      return;
+    }
 
-      pm = med3(pl, pm, pn, compar);
+  pm = elem(nel / 2);
+  pl = base;
+  pn = elem(nel - 1);
+  if (nel > 40)
+    {
+      d  = (nel / 8) * width;
+      pl = med3(pl, pl + d, pl + 2 * d, compar);
+      pm = med3(pm - d, pm, pm + d, compar);
+      pn = med3(pn - 2 * d, pn - d, pn, compar);
     }
 
+  pm = med3(pl, pm, pn, compar);
+
   swap(base, pm);
-  pa = pb = (FAR char *)base + width;
+  pa = pb = elem(1);
 
-  pc = pd = (FAR char *)base + (nel - 1) * width;
+  pc = pd = elem(nel - 1);
   for (; ; )
     {
       while (pb <= pc && (r = compar(pb, base)) <= 0)
@@ -254,43 +311,127 @@ loop:
       pc      -= width;
     }
 
-  if (swap_cnt == 0)
+  if (swap_cnt == 0 && presorted)
     {
-      /* Switch to insertion sort */
+      /* Nothing moved: the range is likely sorted already.  Try to finish
+       * it by insertion, and partition it again if that takes too long.
+       */
 
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
+      if (insertion_sort(base, nel, width, swaptype, nel, compar))
         {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
-            {
-              swap(pl, pl - width);
-            }
+          return;
         }
 
-      return;
+      presorted = false;
+      depth++;
+      goto loop;
     }
 
-  pn = (FAR char *)base + nel * width;
+  presorted = true;
+
+  pn = elem(nel);
   r  = MIN(pa - (FAR char *)base, pb - pa);
   vecswap(base, pb - r, r);
 
   r  = MIN(pd - pc, pn - pd - width);
   vecswap(pb, pn - r, r);
 
-  if ((r = pb - pa) > width)
+  /* Recurse into the smaller partition and iterate over the larger one to
+   * bound the stack usage.
+   */
+
+  lnel = (pb - pa) / width;
+  rnel = (pd - pc) / width;
+
+  if (lnel < rnel)
     {
-      qsort(base, r / width, width, compar);
-    }
+      if (lnel > 1)
+        {
+          intro_sort(base, lnel, width, depth, compar);
+        }
 
-  if ((r = pd - pc) > width)
+      base = pn - rnel * width;
+      nel  = rnel;
+    }
+  else
     {
-      /* Iterate rather than recurse to save stack space */
+      if (rnel > 1)
+        {
+          intro_sort(pn - rnel * width, rnel, width, depth, compar);
+        }
+
+      nel = lnel;
+    }
 
-      base = pn - r;
-      nel = r / width;
+  if (nel > 1)
+    {
       goto loop;
     }
 }
+
+/****************************************************************************
+ * Public Function
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: qsort
+ *
+ * Description:
+ *   The qsort() function will sort an array of 'nel' objects, the initial
+ *   element of which is pointed to by 'base'. The size of each object, in
+ *   bytes, is specified by the 'width" argument. If the 'nel' argument has
+ *   the value zero, the comparison function pointed to by 'compar' will not
+ *   be called and no rearrangement will take place.
+ *
+ *   The application will ensure that the comparison function pointed to by
+ *   'compar' does not alter the contents of the array. The implementation
+ *   may reorder elements of the array between calls to the comparison
+ *   function, but will not alter the contents of any individual element.
+ *
+ *   When the same objects (consisting of 'width" bytes, irrespective of
+ *   their current positions in the array) are passed more than once to
+ *   the comparison function, the results will be consistent with one
+ *   another. That is, they will define a total ordering on the array.
+ *
+ *   The contents of the array will be sorted in ascending order according
+ *   to a comparison function. The 'compar' argument is a pointer to the
+ *   comparison function, which is called with two arguments that point to
+ *   the elements being compared. The application will ensure that the
+ *   function returns an integer less than, equal to, or greater than 0,
+ *   if the first argument is considered respectively less than, equal to,
+ *   or greater than the second. If two members compare as equal, their
+ *   order in the sorted array is unspecified.
+ *
+ *   (Based on description from OpenGroup.org).
+ *
+ * Returned Value:
+ *   The qsort() function will not return a value.
+ *
+ * Notes from the original BSD version:
+ *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ *
+ *   The partitioning is combined with introsort: the recursion follows the
+ *   smaller partition only, so the stack depth is logarithmic, and ranges
+ *   that partition badly more than 2 * log2(nel) times are heap sorted,
+ *   which bounds the worst case to O(nel * log(nel)).  A partition that
+ *   moved nothing is finished by an insertion sort that gives up after
+ *   nel moves, so nearly sorted input stays fast without turning
+ *   quadratic.
+ *
+ ****************************************************************************/
+
+void qsort(FAR void *base, size_t nel, size_t width,
+           CODE int(*compar)(FAR const void *, FAR const void *))
+{
+  int depth = 0;
+  size_t n;
+
+  /* Allow 2 * log2(nel) levels of partitioning before heapsort */
+
+  for (n = nel; n > 1; n >>= 1)
+    {
+      depth += 2;
+    }
+
+  intro_sort(base, nel, width, depth, compar);
+}
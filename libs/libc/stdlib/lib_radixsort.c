@@ -0,0 +1,129 @@
+/****************************************************************************
+ * libs/libc/stdlib/lib_radixsort.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define RADIX_BITS   8
+#define RADIX_SIZE   (1 << RADIX_BITS)
+#define RADIX_MASK   (RADIX_SIZE - 1)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline uint32_t radix_key(FAR const char *elem, size_t keyoff)
+{
+  uint32_t key;
+
+  memcpy(&key, elem + keyoff, sizeof(key));
+  return key;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: radixsort32
+ *
+ * Description:
+ *   Sort an array of 'nel' objects of 'width' bytes in ascending order of
+ *   the uint32_t key found 'keyoff' bytes into each object.  The key does
+ *   not need to be aligned.  Unlike qsort(), the sort is stable and takes
+ *   O(nel) time, in at most four passes over the array: one per key byte,
+ *   skipping the bytes that are the same in all keys.
+ *
+ * Input Parameters:
+ *   base   - The array to sort
+ *   nel    - The number of objects in the array
+ *   width  - The size of each object
+ *   keyoff - The offset of the key in each object
+ *   tmp    - A scratch area of nel * width bytes
+ *
+ ****************************************************************************/
+
+void radixsort32(FAR void *base, size_t nel, size_t width, size_t keyoff,
+                 FAR void *tmp)
+{
+  size_t count[RADIX_SIZE];
+  FAR char *src = base;
+  FAR char *dst = tmp;
+  FAR char *swp;
+  size_t offset;
+  size_t n;
+  int shift;
+  int i;
+
+  for (shift = 0; shift < 32; shift += RADIX_BITS)
+    {
+      memset(count, 0, sizeof(count));
+      for (n = 0; n < nel; n++)
+        {
+          count[(radix_key(src + n * width, keyoff) >> shift) &
+                RADIX_MASK]++;
+        }
+
+      /* The pass would not move anything if all keys share this byte */
+
+      if (nel == 0 ||
+          count[(radix_key(src, keyoff) >> shift) & RADIX_MASK] == nel)
+        {
+          continue;
+        }
+
+      /* Turn the counts into the first destination of each byte value */
+
+      for (offset = 0, i = 0; i < RADIX_SIZE; i++)
+        {
+          n        = count[i];
+          count[i] = offset;
+          offset  += n;
+        }
+
+      for (n = 0; n < nel; n++)
+        {
+          FAR const char *elem = src + n * width;
+
+          i = (radix_key(elem, keyoff) >> shift) & RADIX_MASK;
+          memcpy(dst + count[i]++ * width, elem, width);
+        }
+
+      swp = src;
+      src = dst;
+      dst = swp;
+    }
+
+  if (src != base)
+    {
+      memcpy(base, src, nel * width);
+    }
+}
@@ -0,0 +1,323 @@
+/****************************************************************************
+ * libs/libc/stream/lib_hsoutstream.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/streams.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The stream is written in the format of the heatshrink library, with
+ * window and lookahead sizes of CONFIG_STREAM_HEATSHRINK_WINDOW and
+ * CONFIG_STREAM_HEATSHRINK_LOOKAHEAD bits, which the decoder must be
+ * configured with too.  Each operation is a tag bit, then either a literal
+ * byte (tag 1) or the offset and length minus one of a match in the window
+ * (tag 0), most significant bit first.
+ */
+
+#define HS_WINDOW_BITS     CONFIG_STREAM_HEATSHRINK_WINDOW
+#define HS_LOOKAHEAD_BITS  CONFIG_STREAM_HEATSHRINK_LOOKAHEAD
+#define HS_LOOKAHEAD       (1 << HS_LOOKAHEAD_BITS)
+
+/* A match is shorter than its bytes as literals from this length on */
+
+#define HS_MINMATCH        ((1 + HS_WINDOW_BITS + HS_LOOKAHEAD_BITS) / 9 + 1)
+
+#if HS_LOOKAHEAD_BITS >= HS_WINDOW_BITS
+#  error CONFIG_STREAM_HEATSHRINK_LOOKAHEAD must be smaller than the window
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hsoutstream_bits
+ *
+ * Description:
+ *   Append the low 'count' bits of 'value' to the output.
+ *
+ ****************************************************************************/
+
+static int hsoutstream_bits(FAR struct lib_hsoutstream_s *stream,
+                            uint32_t value, int count)
+{
+  int ret;
+
+  stream->bits   = stream->bits << count | value;
+  stream->nbits += count;
+
+  while (stream->nbits >= 8)
+    {
+      stream->nbits -= 8;
+      stream->out[stream->nout++] = stream->bits >> stream->nbits;
+
+      if (stream->nout == sizeof(stream->out))
+        {
+          stream->nout = 0;
+          ret = lib_stream_puts(stream->backend, stream->out,
+                                sizeof(stream->out));
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: hsoutstream_encode
+ *
+ * Description:
+ *   Encode the pending input, which follows the window in the buffer, and
+ *   then slide the window over it.  index[] links each position to the
+ *   previous one holding the same byte, so that the search for the longest
+ *   match only visits candidates whose first byte matches.
+ *
+ ****************************************************************************/
+
+static int hsoutstream_encode(FAR struct lib_hsoutstream_s *stream)
+{
+  FAR const uint8_t *buf = stream->buf;
+  int16_t last[256];
+  size_t start = HS_STREAM_WINDOW - stream->hist;
+  size_t end = HS_STREAM_WINDOW + stream->offset;
+  size_t keep;
+  size_t best;
+  size_t bestoff;
+  size_t maxlen;
+  size_t len;
+  size_t p;
+  int q;
+  int ret;
+
+  memset(last, 0xff, sizeof(last));
+  for (p = start; p < end; p++)
+    {
+      stream->index[p] = last[buf[p]];
+      last[buf[p]] = p;
+    }
+
+  for (p = HS_STREAM_WINDOW; p < end; p += best)
+    {
+      maxlen  = end - p < HS_LOOKAHEAD ? end - p : HS_LOOKAHEAD;
+      best    = 0;
+      bestoff = 0;
+
+      for (q = stream->index[p]; q >= 0 && p - q <= HS_STREAM_WINDOW;
+           q = stream->index[q])
+        {
+          len = 1;
+          while (len < maxlen && buf[q + len] == buf[p + len])
+            {
+              len++;
+            }
+
+          if (len > best)
+            {
+              best    = len;
+              bestoff = p - q;
+              if (best == maxlen)
+                {
+                  break;
+                }
+            }
+        }
+
+      if (best >= HS_MINMATCH)
+        {
+          ret = hsoutstream_bits(stream, 0, 1);
+          if (ret >= 0)
+            {
+              ret = hsoutstream_bits(stream, bestoff - 1, HS_WINDOW_BITS);
+            }
+
+          if (ret >= 0)
+            {
+              ret = hsoutstream_bits(stream, best - 1, HS_LOOKAHEAD_BITS);
+            }
+        }
+      else
+        {
+          best = 1;
+          ret  = hsoutstream_bits(stream, 0x100 | buf[p], 9);
+        }
+
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  keep = stream->hist + stream->offset;
+  if (keep > HS_STREAM_WINDOW)
+    {
+      keep = HS_STREAM_WINDOW;
+    }
+
+  memmove(stream->buf + HS_STREAM_WINDOW - keep, stream->buf + end - keep,
+          keep);
+  stream->hist   = keep;
+  stream->offset = 0;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: hsoutstream_flush
+ *
+ * Description:
+ *   Encode the pending input and pad the last byte with zero bits, which
+ *   completes the heatshrink stream as heatshrink_encoder_finish() does.
+ *   The data written after a flush starts a new stream with an empty
+ *   window.
+ *
+ ****************************************************************************/
+
+static int hsoutstream_flush(FAR struct lib_outstream_s *this)
+{
+  FAR struct lib_hsoutstream_s *stream =
+                                (FAR struct lib_hsoutstream_s *)this;
+  int ret = 0;
+
+  if (stream->offset > 0)
+    {
+      ret = hsoutstream_encode(stream);
+    }
+
+  if (ret >= 0 && stream->nbits > 0)
+    {
+      ret = hsoutstream_bits(stream, 0, 8 - stream->nbits);
+    }
+
+  if (ret >= 0 && stream->nout > 0)
+    {
+      ret = lib_stream_puts(stream->backend, stream->out, stream->nout);
+    }
+
+  stream->hist  = 0;
+  stream->nout  = 0;
+  stream->nbits = 0;
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return lib_stream_flush(stream->backend);
+}
+
+/****************************************************************************
+ * Name: hsoutstream_puts
+ ****************************************************************************/
+
+static int hsoutstream_puts(FAR struct lib_outstream_s *this,
+                            FAR const void *buf, int len)
+{
+  FAR struct lib_hsoutstream_s *stream =
+                                (FAR struct lib_hsoutstream_s *)this;
+  FAR const uint8_t *ptr = buf;
+  size_t total = len;
+  size_t copyin;
+  int ret;
+
+  while (total > 0)
+    {
+      copyin = HS_STREAM_WINDOW - stream->offset;
+      if (copyin > total)
+        {
+          copyin = total;
+        }
+
+      memcpy(stream->buf + HS_STREAM_WINDOW + stream->offset, ptr, copyin);
+
+      ptr            += copyin;
+      stream->offset += copyin;
+      this->nput     += copyin;
+      total          -= copyin;
+
+      if (stream->offset == HS_STREAM_WINDOW)
+        {
+          ret = hsoutstream_encode(stream);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return len;
+}
+
+/****************************************************************************
+ * Name: hsoutstream_putc
+ ****************************************************************************/
+
+static void hsoutstream_putc(FAR struct lib_outstream_s *this, int ch)
+{
+  char tmp = ch;
+
+  hsoutstream_puts(this, &tmp, 1);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lib_hsoutstream
+ *
+ * Description:
+ *  Heatshrink compressed pipeline stream
+ *
+ * Input Parameters:
+ *   stream  - User allocated, uninitialized instance of struct
+ *                lib_hsoutstream_s to be initialized.
+ *   backend - Stream backend port.
+ *
+ * Returned Value:
+ *   None (User allocated instance initialized).
+ *
+ ****************************************************************************/
+
+void lib_hsoutstream(FAR struct lib_hsoutstream_s *stream,
+                     FAR struct lib_outstream_s *backend)
+{
+  if (stream == NULL || backend == NULL)
+    {
+      return;
+    }
+
+  memset(stream, 0, sizeof(*stream));
+  stream->public.putc  = hsoutstream_putc;
+  stream->public.puts  = hsoutstream_puts;
+  stream->public.flush = hsoutstream_flush;
+  stream->backend      = backend;
+}
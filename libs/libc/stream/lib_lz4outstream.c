@@ -0,0 +1,339 @@
+/****************************************************************************
+ * libs/libc/stream/lib_lz4outstream.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/streams.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The stream is written in the LZ4 legacy frame format, which the lz4
+ * command line tool decompresses: a magic number followed by blocks that
+ * are compressed independently, each preceded by its compressed size.  It
+ * needs no end mark, so every flush leaves a complete stream behind.
+ */
+
+#define LZ4_LEGACY_MAGIC  0x184c2102
+
+#define LZ4_MINMATCH      4      /* Shortest match */
+#define LZ4_LASTLITERALS  5      /* The last bytes are always literals */
+#define LZ4_MFLIMIT       12     /* No match starts in the last bytes */
+#define LZ4_MAXOFFSET     65535  /* Farthest match */
+
+#define LZ4_HASH(v) \
+  (((uint32_t)(v) * 2654435761u) >> (32 - CONFIG_STREAM_LZ4_HLOG))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t lz4_read32(FAR const uint8_t *ptr)
+{
+  uint32_t value;
+
+  memcpy(&value, ptr, sizeof(value));
+  return value;
+}
+
+static void lz4_write32(FAR uint8_t *ptr, uint32_t value)
+{
+  ptr[0] = value;
+  ptr[1] = value >> 8;
+  ptr[2] = value >> 16;
+  ptr[3] = value >> 24;
+}
+
+static FAR uint8_t *lz4_length(FAR uint8_t *op, size_t len)
+{
+  for (; len >= 255; len -= 255)
+    {
+      *op++ = 255;
+    }
+
+  *op++ = len;
+  return op;
+}
+
+/****************************************************************************
+ * Name: lz4_sequence
+ *
+ * Description:
+ *   Write one LZ4 sequence: a token, the literals and, unless this is the
+ *   last sequence of the block (mlen == 0), the offset and length of the
+ *   match that follows them.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *lz4_sequence(FAR uint8_t *op, FAR const uint8_t *lit,
+                                 size_t nlit, size_t offset, size_t mlen)
+{
+  FAR uint8_t *token = op++;
+
+  if (nlit >= 15)
+    {
+      *token = 15 << 4;
+      op = lz4_length(op, nlit - 15);
+    }
+  else
+    {
+      *token = nlit << 4;
+    }
+
+  memcpy(op, lit, nlit);
+  op += nlit;
+
+  if (mlen > 0)
+    {
+      *op++ = offset;
+      *op++ = offset >> 8;
+
+      mlen -= LZ4_MINMATCH;
+      if (mlen >= 15)
+        {
+          *token |= 15;
+          op = lz4_length(op, mlen - 15);
+        }
+      else
+        {
+          *token |= mlen;
+        }
+    }
+
+  return op;
+}
+
+/****************************************************************************
+ * Name: lz4_compress
+ *
+ * Description:
+ *   Compress the pending input as one LZ4 block behind a 4 byte compressed
+ *   size.  Matches are found with a hash table of the last position of each
+ *   4 byte sequence; the step grows while no match is found, so that
+ *   incompressible data is skipped quickly.
+ *
+ * Returned Value:
+ *   The number of bytes in the output buffer.
+ *
+ ****************************************************************************/
+
+static size_t lz4_compress(FAR struct lib_lz4outstream_s *stream)
+{
+  FAR const uint8_t *in = stream->in;
+  FAR uint8_t *op = stream->out + 4;
+  size_t len = stream->offset;
+  size_t anchor = 0;
+  size_t ip = 0;
+  size_t ref;
+  size_t mlen;
+  uint32_t seq;
+  uint32_t h;
+
+  memset(stream->hash, 0, sizeof(stream->hash));
+
+  while (ip + LZ4_MFLIMIT <= len)
+    {
+      seq = lz4_read32(in + ip);
+      h   = LZ4_HASH(seq);
+      ref = stream->hash[h];
+      stream->hash[h] = ip;
+
+      if (ref >= ip || ip - ref > LZ4_MAXOFFSET ||
+          lz4_read32(in + ref) != seq)
+        {
+          ip += 1 + ((ip - anchor) >> 6);
+          continue;
+        }
+
+      while (ip > anchor && ref > 0 && in[ip - 1] == in[ref - 1])
+        {
+          ip--;
+          ref--;
+        }
+
+      mlen = LZ4_MINMATCH;
+      while (ip + mlen < len - LZ4_LASTLITERALS &&
+             in[ip + mlen] == in[ref + mlen])
+        {
+          mlen++;
+        }
+
+      op     = lz4_sequence(op, in + anchor, ip - anchor, ip - ref, mlen);
+      ip    += mlen;
+      anchor = ip;
+    }
+
+  op = lz4_sequence(op, in + anchor, len - anchor, 0, 0);
+
+  lz4_write32(stream->out, op - stream->out - 4);
+  return op - stream->out;
+}
+
+/****************************************************************************
+ * Name: lz4outstream_block
+ *
+ * Description:
+ *   Compress the pending input and write it to the backend, preceded by
+ *   the magic number if it is the first block.
+ *
+ ****************************************************************************/
+
+static int lz4outstream_block(FAR struct lib_lz4outstream_s *stream)
+{
+  uint8_t magic[4];
+  size_t outlen;
+  int ret;
+
+  if (!stream->header)
+    {
+      lz4_write32(magic, LZ4_LEGACY_MAGIC);
+      ret = lib_stream_puts(stream->backend, magic, sizeof(magic));
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      stream->header = true;
+    }
+
+  outlen = lz4_compress(stream);
+  stream->offset = 0;
+
+  ret = lib_stream_puts(stream->backend, stream->out, outlen);
+  return ret < 0 ? ret : 0;
+}
+
+/****************************************************************************
+ * Name: lz4outstream_flush
+ ****************************************************************************/
+
+static int lz4outstream_flush(FAR struct lib_outstream_s *this)
+{
+  FAR struct lib_lz4outstream_s *stream =
+                                 (FAR struct lib_lz4outstream_s *)this;
+  int ret;
+
+  if (stream->offset > 0)
+    {
+      ret = lz4outstream_block(stream);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return lib_stream_flush(stream->backend);
+}
+
+/****************************************************************************
+ * Name: lz4outstream_puts
+ ****************************************************************************/
+
+static int lz4outstream_puts(FAR struct lib_outstream_s *this,
+                             FAR const void *buf, int len)
+{
+  FAR struct lib_lz4outstream_s *stream =
+                                 (FAR struct lib_lz4outstream_s *)this;
+  FAR const uint8_t *ptr = buf;
+  size_t total = len;
+  size_t copyin;
+  int ret;
+
+  while (total > 0)
+    {
+      copyin = LZ4_STREAM_BLOCKSIZE - stream->offset;
+      if (copyin > total)
+        {
+          copyin = total;
+        }
+
+      memcpy(stream->in + stream->offset, ptr, copyin);
+
+      ptr            += copyin;
+      stream->offset += copyin;
+      this->nput     += copyin;
+      total          -= copyin;
+
+      if (stream->offset == LZ4_STREAM_BLOCKSIZE)
+        {
+          ret = lz4outstream_block(stream);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return len;
+}
+
+/****************************************************************************
+ * Name: lz4outstream_putc
+ ****************************************************************************/
+
+static void lz4outstream_putc(FAR struct lib_outstream_s *this, int ch)
+{
+  char tmp = ch;
+
+  lz4outstream_puts(this, &tmp, 1);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lib_lz4outstream
+ *
+ * Description:
+ *  LZ4 compressed pipeline stream
+ *
+ * Input Parameters:
+ *   stream  - User allocated, uninitialized instance of struct
+ *                lib_lz4outstream_s to be initialized.
+ *   backend - Stream backend port.
+ *
+ * Returned Value:
+ *   None (User allocated instance initialized).
+ *
+ ****************************************************************************/
+
+void lib_lz4outstream(FAR struct lib_lz4outstream_s *stream,
+                      FAR struct lib_outstream_s *backend)
+{
+  if (stream == NULL || backend == NULL)
+    {
+      return;
+    }
+
+  memset(stream, 0, sizeof(*stream));
+  stream->public.putc  = lz4outstream_putc;
+  stream->public.puts  = lz4outstream_puts;
+  stream->public.flush = lz4outstream_flush;
+  stream->backend      = backend;
+}
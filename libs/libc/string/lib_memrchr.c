@@ -44,6 +44,7 @@
  *
  ****************************************************************************/
 
+#ifndef CONFIG_LIBC_ARCH_MEMRCHR
 #undef memrchr /* See mm/README.txt */
 FAR void *memrchr(FAR const void *s, int c, size_t n)
 {
@@ -59,3 +60,4 @@ FAR void *memrchr(FAR const void *s, int c, size_t n)
 
   return NULL;
 }
+#endif
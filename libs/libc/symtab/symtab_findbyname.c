@@ -40,8 +40,8 @@
  *
  * Description:
  *   Find the symbol in the symbol table with the matching name.
- *   This version assumes that table is not ordered with respect to symbol
- *   name and, hence, access time will be linear with respect to nsyms.
+ *   Unless the table is ordered by name or by hash, access time will be
+ *   linear with respect to nsyms.
  *
  * Returned Value:
  *   A reference to the symbol table entry if an entry with the matching
@@ -53,7 +53,12 @@ FAR const struct symtab_s *
 symtab_findbyname(FAR const struct symtab_s *symtab,
                   FAR const char *name, int nsyms)
 {
-#ifdef CONFIG_SYMTAB_ORDEREDBYNAME
+#if defined(CONFIG_SYMTAB_HASHED)
+  uint32_t hash;
+  int low  = 0;
+  int high = nsyms;
+  int mid;
+#elif defined(CONFIG_SYMTAB_ORDEREDBYNAME)
   int low  = 0;
   int high = nsyms - 1;
   int mid;
@@ -75,7 +80,35 @@ symtab_findbyname(FAR const struct symtab_s *symtab,
 
   DEBUGASSERT(name != NULL);
 
-#ifdef CONFIG_SYMTAB_ORDEREDBYNAME
+#if defined(CONFIG_SYMTAB_HASHED)
+  /* Find the first entry whose hash is not below that of the name */
+
+  hash = symtab_hash(name);
+  while (low < high)
+    {
+      mid = (low + high) >> 1;
+      if (symtab[mid].sym_hash < hash)
+        {
+          low = mid + 1;
+        }
+      else
+        {
+          high = mid;
+        }
+    }
+
+  /* Then compare the names of the entries with the same hash */
+
+  for (; low < nsyms && symtab[low].sym_hash == hash; low++)
+    {
+      if (strcmp(name, symtab[low].sym_name) == 0)
+        {
+          return &symtab[low];
+        }
+    }
+
+  return NULL;
+#elif defined(CONFIG_SYMTAB_ORDEREDBYNAME)
   while (low < high)
     {
       /* Compare the name to the one in the middle.  (or just below
@@ -0,0 +1,117 @@
+/****************************************************************************
+ * libs/libc/time/lib_clock_gettime.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+#include <syscall.h>
+
+#include <nuttx/clock.h>
+
+/* The kernel has its own clock_gettime(), this one is only for user space */
+
+#if defined(CONFIG_CLOCK_TIMEPAGE) && !defined(__KERNEL__)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define TIMEPAGE_BARRIER()  __asm__ __volatile__ ("" : : : "memory")
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const struct clock_timepage_s *g_timepage;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_gettime
+ *
+ * Description:
+ *   Read CLOCK_MONOTONIC, CLOCK_BOOTTIME and CLOCK_REALTIME from the time
+ *   page without a system call.  The other clocks are passed to the kernel.
+ *
+ ****************************************************************************/
+
+int clock_gettime(clockid_t clock_id, FAR struct timespec *tp)
+{
+  FAR const struct clock_timepage_s *page = g_timepage;
+  clockid_t clock_type = clock_id & CLOCK_MASK;
+  struct timespec basetime;
+  clock_t ticks;
+  uint32_t seq;
+
+  if (tp != NULL &&
+      (clock_type == CLOCK_MONOTONIC || clock_type == CLOCK_BOOTTIME ||
+       clock_type == CLOCK_REALTIME))
+    {
+      if (page == NULL)
+        {
+          page = clock_timepage();
+          g_timepage = page;
+        }
+
+      if (page != NULL)
+        {
+          /* Retry while the kernel writes the page */
+
+          do
+            {
+              seq = page->seq;
+              TIMEPAGE_BARRIER();
+
+              ticks    = page->ticks;
+              basetime = page->basetime;
+
+              TIMEPAGE_BARRIER();
+            }
+          while ((seq & 1) != 0 || seq != page->seq);
+
+          timespec_from_tick(tp, ticks);
+
+          if (clock_type == CLOCK_REALTIME)
+            {
+              tp->tv_sec  += basetime.tv_sec;
+              tp->tv_nsec += basetime.tv_nsec;
+              if (tp->tv_nsec >= NSEC_PER_SEC)
+                {
+                  tp->tv_sec++;
+                  tp->tv_nsec -= NSEC_PER_SEC;
+                }
+            }
+
+          return OK;
+        }
+    }
+
+  return (int)sys_call2((unsigned int)SYS_clock_gettime,
+                        (uintptr_t)clock_id, (uintptr_t)tp);
+}
+
+#endif /* CONFIG_CLOCK_TIMEPAGE && !__KERNEL__ */
@@ -141,6 +141,20 @@
 #define TIME_T_MIN MINVAL(time_t, TYPE_BIT(time_t))
 #define TIME_T_MAX MAXVAL(time_t, TYPE_BIT(time_t))
 
+/* The local day cache is read without a lock; a sequence count, odd while
+ * the cache is updated, tells a reader to take the slow path instead.
+ */
+
+#ifdef __GNUC__
+#  define lcl_seqload(p)     __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#  define lcl_seqstore(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+#  define lcl_seqfence()     __atomic_thread_fence(__ATOMIC_ACQ_REL)
+#else
+#  define lcl_seqload(p)     (*(FAR volatile unsigned int *)(p))
+#  define lcl_seqstore(p, v) (*(FAR volatile unsigned int *)(p) = (v))
+#  define lcl_seqfence()
+#endif
+
 /* This abbreviation means local time is unspecified. */
 
 #define UNSPEC              "-00"
@@ -281,6 +295,22 @@ struct state_s
   int defaulttype;
 };
 
+#ifdef CONFIG_LIBC_LOCALTIME_CACHE
+
+/* The instants [start, end) have the same local date and time type, so
+ * localtime() of one of them only differs from 'tm', the broken-down local
+ * time of 'midnight', in the time of day.
+ */
+
+struct lcl_cache_s
+{
+  time_t start;
+  time_t end;
+  time_t midnight;
+  struct tm tm;
+};
+#endif
+
 struct rule_s
 {
   int r_type;                 /* type of rule; see below */
@@ -307,6 +337,11 @@ static FAR struct state_s *g_gmt_ptr;
 static rmutex_t g_lcl_lock = NXRMUTEX_INITIALIZER;
 static rmutex_t g_gmt_lock = NXRMUTEX_INITIALIZER;
 
+#ifdef CONFIG_LIBC_LOCALTIME_CACHE
+static unsigned int g_lcl_cacheseq;
+static struct lcl_cache_s g_lcl_cache;
+#endif
+
 /* Section 4.12.3 of X3.159-1989 requires that
  *    Except for the strftime function, these functions [asctime,
  *    ctime, gmtime, localtime] return values in one of two static
@@ -1880,6 +1915,93 @@ static void gmtload(FAR struct state_s *sp)
     }
 }
 
+#ifdef CONFIG_LIBC_LOCALTIME_CACHE
+
+/* Return localtime() of T from the local day cache, or NULL if T is not
+ * in the cached range.  SEQ is the sequence count read by the caller on
+ * entry.
+ */
+
+static FAR struct tm *lcl_cache_get(unsigned int seq, time_t t,
+                                    FAR struct tm *tmp)
+{
+  int_fast32_t secs;
+
+  if ((seq & 1) != 0 || t < g_lcl_cache.start || t >= g_lcl_cache.end)
+    {
+      return NULL;
+    }
+
+  secs = t - g_lcl_cache.midnight;
+  *tmp = g_lcl_cache.tm;
+
+  /* Drop the copy if the cache was updated meanwhile */
+
+  lcl_seqfence();
+  if (lcl_seqload(&g_lcl_cacheseq) != seq)
+    {
+      return NULL;
+    }
+
+  tmp->tm_hour = (int)(secs / SECSPERHOUR);
+  tmp->tm_min = (int)(secs / SECSPERMIN % MINSPERHOUR);
+  tmp->tm_sec = (int)(secs % SECSPERMIN);
+  tzname[tmp->tm_isdst] = (FAR char *)tmp->tm_zone;
+  return tmp;
+}
+
+/* Remember that the instants of [START, END), the period of the time type
+ * of T, that fall on the local day of TMP = localtime(T) only differ from
+ * TMP in the time of day.  The cache is left alone if another thread
+ * holds the lock, or if it was changed or dropped since SEQ was read.
+ */
+
+static void lcl_cache_put(unsigned int seq, time_t t, time_t start,
+                          time_t end, FAR const struct tm *tmp)
+{
+  time_t midnight;
+
+  if ((seq & 1) != 0 || t < TIME_T_MIN + SECSPERDAY ||
+      t > TIME_T_MAX - SECSPERDAY || nxrmutex_trylock(&g_lcl_lock) < 0)
+    {
+      return;
+    }
+
+  if (g_lcl_cacheseq == seq)
+    {
+      midnight = t - (tmp->tm_hour * SECSPERHOUR +
+                      tmp->tm_min * SECSPERMIN + tmp->tm_sec);
+
+      lcl_seqstore(&g_lcl_cacheseq, seq + 1);
+      lcl_seqfence();
+
+      g_lcl_cache.start    = MAX(start, midnight);
+      g_lcl_cache.end      = MIN(end, midnight + SECSPERDAY);
+      g_lcl_cache.midnight = midnight;
+      g_lcl_cache.tm       = *tmp;
+
+      lcl_seqstore(&g_lcl_cacheseq, seq + 2);
+    }
+
+  nxrmutex_unlock(&g_lcl_lock);
+}
+
+/* Drop the cache; called with g_lcl_lock held around a change of rules */
+
+static void lcl_cache_invalidate(void)
+{
+  unsigned int seq = g_lcl_cacheseq;
+
+  lcl_seqstore(&g_lcl_cacheseq, seq + 1);
+  lcl_seqfence();
+
+  g_lcl_cache.start = 0;
+  g_lcl_cache.end   = 0;
+
+  lcl_seqstore(&g_lcl_cacheseq, seq + 2);
+}
+#endif
+
 /* The easy way to behave "as if no library function calls" localtime
  * is to not call it, so we drop its guts into "localsub", which can be
  * freely called. (And no, the PANS doesn't require the above behavior,
@@ -1896,6 +2018,11 @@ static FAR struct tm *localsub(FAR const time_t *timep,
   int i;
   FAR struct tm *result;
   const time_t t = *timep;
+#ifdef CONFIG_LIBC_LOCALTIME_CACHE
+  unsigned int seq;
+  time_t start;
+  time_t end;
+#endif
 
   sp = g_lcl_ptr;
   if (sp == NULL)
@@ -1908,6 +2035,14 @@ static FAR struct tm *localsub(FAR const time_t *timep,
       return NULL;
     }
 
+#ifdef CONFIG_LIBC_LOCALTIME_CACHE
+  seq = lcl_seqload(&g_lcl_cacheseq);
+  if (lcl_cache_get(seq, t, tmp) != NULL)
+    {
+      return tmp;
+    }
+#endif
+
   if ((sp->goback && t < sp->ats[0]) ||
       (sp->goahead && t > sp->ats[sp->timecnt - 1]))
     {
@@ -1976,6 +2111,10 @@ static FAR struct tm *localsub(FAR const time_t *timep,
   if (sp->timecnt == 0 || t < sp->ats[0])
     {
       i = sp->defaulttype;
+#ifdef CONFIG_LIBC_LOCALTIME_CACHE
+      start = TIME_T_MIN;
+      end = sp->timecnt == 0 ? TIME_T_MAX : sp->ats[0];
+#endif
     }
   else
     {
@@ -1997,6 +2136,19 @@ static FAR struct tm *localsub(FAR const time_t *timep,
         }
 
       i = sp->types[lo - 1];
+#ifdef CONFIG_LIBC_LOCALTIME_CACHE
+      start = sp->ats[lo - 1];
+      if (lo < sp->timecnt)
+        {
+          end = sp->ats[lo];
+        }
+      else
+        {
+          /* Later instants are extrapolated above if goahead is set */
+
+          end = sp->goahead ? sp->ats[lo - 1] + 1 : TIME_T_MAX;
+        }
+#endif
     }
 
   ttisp = &sp->ttis[i];
@@ -2013,6 +2165,13 @@ static FAR struct tm *localsub(FAR const time_t *timep,
       result->tm_isdst = ttisp->tt_isdst;
       tzname[result->tm_isdst] = &sp->chars[ttisp->tt_desigidx];
       result->tm_zone = tzname[result->tm_isdst];
+
+#ifdef CONFIG_LIBC_LOCALTIME_CACHE
+      if (sp->leapcnt == 0)
+        {
+          lcl_cache_put(seq, t, start, end, result);
+        }
+#endif
     }
 
   return result;
@@ -2788,6 +2947,10 @@ void tzset(void)
         }
     }
 
+#ifdef CONFIG_LIBC_LOCALTIME_CACHE
+  lcl_cache_invalidate();
+#endif
+
   if (zoneinit(name) != 0)
     {
       zoneinit("");
@@ -2798,6 +2961,15 @@ void tzset(void)
 tzname:
   settzname();
   g_lcl_isset = 1;
+
+#ifdef CONFIG_LIBC_LOCALTIME_CACHE
+  /* Bump the sequence again, so that a reader which sampled it while
+   * zoneinit() rewrote the rules cannot store its result in the cache.
+   */
+
+  lcl_cache_invalidate();
+#endif
+
   nxrmutex_unlock(&g_lcl_lock);
 }
 
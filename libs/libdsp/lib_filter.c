@@ -0,0 +1,308 @@
+/****************************************************************************
+ * libs/libdsp/lib_filter.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <assert.h>
+#include <dsp.h>
+#include <string.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fir_filter_init
+ *
+ * Description:
+ *   Initialize a FIR filter.  The delay line is kept twice, so that the
+ *   taps of every output are contiguous in memory and the inner loop needs
+ *   no wrap-around check.
+ *
+ * Input Parameters:
+ *   fir    - pointer to the FIR filter data
+ *   coeffs - ntaps filter coefficients, coeffs[0] applies to the newest
+ *            sample
+ *   state  - buffer of 2 * ntaps samples for the delay line
+ *   ntaps  - number of filter taps
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void fir_filter_init(FAR struct fir_filter_f32_s *fir,
+                     FAR const float *coeffs, FAR float *state,
+                     uint16_t ntaps)
+{
+  LIBDSP_DEBUGASSERT(fir != NULL);
+  LIBDSP_DEBUGASSERT(coeffs != NULL);
+  LIBDSP_DEBUGASSERT(state != NULL);
+  LIBDSP_DEBUGASSERT(ntaps > 0);
+
+  fir->coeffs = coeffs;
+  fir->state  = state;
+  fir->ntaps  = ntaps;
+  fir->pos    = 0;
+
+  memset(state, 0, 2 * ntaps * sizeof(float));
+}
+
+/****************************************************************************
+ * Name: fir_filter
+ *
+ * Description:
+ *   Filter a block of samples with a FIR filter.
+ *
+ * Input Parameters:
+ *   fir - pointer to the FIR filter data
+ *   in  - input samples
+ *   out - output samples, may be the same buffer as in
+ *   n   - number of samples
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void fir_filter(FAR struct fir_filter_f32_s *fir, FAR const float *in,
+                FAR float *out, size_t n)
+{
+  FAR const float *coeffs;
+  FAR const float *taps;
+  uint16_t ntaps;
+  uint16_t pos;
+  uint16_t k;
+  float acc;
+
+  LIBDSP_DEBUGASSERT(fir != NULL);
+  LIBDSP_DEBUGASSERT(in != NULL);
+  LIBDSP_DEBUGASSERT(out != NULL);
+
+  coeffs = fir->coeffs;
+  ntaps  = fir->ntaps;
+  pos    = fir->pos;
+
+  while (n-- > 0)
+    {
+      /* The newest sample goes in front of the previous ones */
+
+      pos = (pos == 0 ? ntaps : pos) - 1;
+      fir->state[pos]         = *in;
+      fir->state[pos + ntaps] = *in++;
+
+      taps = &fir->state[pos];
+      acc  = 0.0f;
+
+      for (k = 0; k < ntaps; k++)
+        {
+          acc += coeffs[k] * taps[k];
+        }
+
+      *out++ = acc;
+    }
+
+  fir->pos = pos;
+}
+
+/****************************************************************************
+ * Name: biquad_init
+ *
+ * Description:
+ *   Initialize a cascade of biquad filters.  Each stage computes
+ *     y(n) = b0*x(n) + b1*x(n-1) + b2*x(n-2) - a1*y(n-1) - a2*y(n-2)
+ *   in the transposed direct form II.
+ *
+ * Input Parameters:
+ *   bq      - pointer to the biquad cascade data
+ *   coeffs  - 5 coefficients per stage: b0, b1, b2, a1, a2
+ *   state   - buffer of 2 values per stage
+ *   nstages - number of stages
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void biquad_init(FAR struct biquad_f32_s *bq, FAR const float *coeffs,
+                 FAR float *state, uint8_t nstages)
+{
+  LIBDSP_DEBUGASSERT(bq != NULL);
+  LIBDSP_DEBUGASSERT(coeffs != NULL);
+  LIBDSP_DEBUGASSERT(state != NULL);
+  LIBDSP_DEBUGASSERT(nstages > 0);
+
+  bq->coeffs  = coeffs;
+  bq->state   = state;
+  bq->nstages = nstages;
+
+  memset(state, 0, 2 * nstages * sizeof(float));
+}
+
+/****************************************************************************
+ * Name: biquad_cascade
+ *
+ * Description:
+ *   Filter a block of samples with a cascade of biquad filters.  The block
+ *   passes one stage at a time, so the coefficients and the state of a
+ *   stage stay in registers for the whole block.
+ *
+ * Input Parameters:
+ *   bq  - pointer to the biquad cascade data
+ *   in  - input samples
+ *   out - output samples, may be the same buffer as in
+ *   n   - number of samples
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void biquad_cascade(FAR struct biquad_f32_s *bq, FAR const float *in,
+                    FAR float *out, size_t n)
+{
+  FAR const float *src;
+  FAR const float *c;
+  FAR float *d;
+  uint8_t stage;
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(bq != NULL);
+  LIBDSP_DEBUGASSERT(in != NULL);
+  LIBDSP_DEBUGASSERT(out != NULL);
+
+  c   = bq->coeffs;
+  d   = bq->state;
+  src = in;
+
+  for (stage = 0; stage < bq->nstages; stage++)
+    {
+      float b0 = c[0];
+      float b1 = c[1];
+      float b2 = c[2];
+      float a1 = c[3];
+      float a2 = c[4];
+      float d1 = d[0];
+      float d2 = d[1];
+
+      for (i = 0; i < n; i++)
+        {
+          float x = src[i];
+          float y = b0 * x + d1;
+
+          d1     = b1 * x - a1 * y + d2;
+          d2     = b2 * x - a2 * y;
+          out[i] = y;
+        }
+
+      d[0] = d1;
+      d[1] = d2;
+
+      /* The next stages work in place on the output */
+
+      src  = out;
+      c   += 5;
+      d   += 2;
+    }
+}
+
+/****************************************************************************
+ * Name: mavg_filter_init
+ *
+ * Description:
+ *   Initialize a moving average filter over the last len samples.
+ *
+ * Input Parameters:
+ *   mavg - pointer to the moving average filter data
+ *   buf  - buffer of len samples
+ *   len  - length of the window
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mavg_filter_init(FAR struct mavg_filter_f32_s *mavg, FAR float *buf,
+                      uint16_t len)
+{
+  LIBDSP_DEBUGASSERT(mavg != NULL);
+  LIBDSP_DEBUGASSERT(buf != NULL);
+  LIBDSP_DEBUGASSERT(len > 0);
+
+  mavg->buf        = buf;
+  mavg->sum        = 0.0f;
+  mavg->one_by_len = 1.0f / len;
+  mavg->len        = len;
+  mavg->pos        = 0;
+
+  memset(buf, 0, len * sizeof(float));
+}
+
+/****************************************************************************
+ * Name: mavg_filter
+ *
+ * Description:
+ *   Filter a block of samples with a moving average filter.  A running sum
+ *   makes the cost of a sample independent of the window length; the sum
+ *   is recomputed once per window to stop rounding errors from adding up.
+ *
+ * Input Parameters:
+ *   mavg - pointer to the moving average filter data
+ *   in   - input samples
+ *   out  - output samples, may be the same buffer as in
+ *   n    - number of samples
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mavg_filter(FAR struct mavg_filter_f32_s *mavg, FAR const float *in,
+                 FAR float *out, size_t n)
+{
+  uint16_t k;
+
+  LIBDSP_DEBUGASSERT(mavg != NULL);
+  LIBDSP_DEBUGASSERT(in != NULL);
+  LIBDSP_DEBUGASSERT(out != NULL);
+
+  while (n-- > 0)
+    {
+      float x = *in++;
+
+      mavg->sum += x - mavg->buf[mavg->pos];
+      mavg->buf[mavg->pos] = x;
+
+      if (++mavg->pos >= mavg->len)
+        {
+          mavg->pos = 0;
+          mavg->sum = 0.0f;
+
+          for (k = 0; k < mavg->len; k++)
+            {
+              mavg->sum += mavg->buf[k];
+            }
+        }
+
+      *out++ = mavg->sum * mavg->one_by_len;
+    }
+}
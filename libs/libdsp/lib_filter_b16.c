@@ -0,0 +1,334 @@
+/****************************************************************************
+ * libs/libdsp/lib_filter_b16.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <assert.h>
+#include <dspb16.h>
+#include <string.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The products are accumulated at full precision and rounded once per
+ * output when a 64-bit type is available.  On ARMv7-M this compiles to one
+ * SMLAL per tap.
+ */
+
+#ifdef CONFIG_HAVE_LONG_LONG
+#  define ACC_MAC(acc, a, b)    ((acc) += (b32_t)(a) * (b))
+#  define ACC_B16(acc)          ((b16_t)b32tob16(acc))
+#else
+#  define ACC_MAC(acc, a, b)    ((acc) += b16mulb16(a, b))
+#  define ACC_B16(acc)          (acc)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_HAVE_LONG_LONG
+typedef b32_t acc_t;
+#else
+typedef b16_t acc_t;
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fir_filter_init_b16
+ *
+ * Description:
+ *   Initialize a FIR filter.  The delay line is kept twice, so that the
+ *   taps of every output are contiguous in memory and the inner loop needs
+ *   no wrap-around check.
+ *
+ * Input Parameters:
+ *   fir    - pointer to the FIR filter data
+ *   coeffs - ntaps filter coefficients, coeffs[0] applies to the newest
+ *            sample
+ *   state  - buffer of 2 * ntaps samples for the delay line
+ *   ntaps  - number of filter taps
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void fir_filter_init_b16(FAR struct fir_filter_b16_s *fir,
+                         FAR const b16_t *coeffs, FAR b16_t *state,
+                         uint16_t ntaps)
+{
+  LIBDSP_DEBUGASSERT(fir != NULL);
+  LIBDSP_DEBUGASSERT(coeffs != NULL);
+  LIBDSP_DEBUGASSERT(state != NULL);
+  LIBDSP_DEBUGASSERT(ntaps > 0);
+
+  fir->coeffs = coeffs;
+  fir->state  = state;
+  fir->ntaps  = ntaps;
+  fir->pos    = 0;
+
+  memset(state, 0, 2 * ntaps * sizeof(b16_t));
+}
+
+/****************************************************************************
+ * Name: fir_filter_b16
+ *
+ * Description:
+ *   Filter a block of samples with a FIR filter.
+ *
+ * Input Parameters:
+ *   fir - pointer to the FIR filter data
+ *   in  - input samples
+ *   out - output samples, may be the same buffer as in
+ *   n   - number of samples
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void fir_filter_b16(FAR struct fir_filter_b16_s *fir, FAR const b16_t *in,
+                    FAR b16_t *out, size_t n)
+{
+  FAR const b16_t *coeffs;
+  FAR const b16_t *taps;
+  uint16_t ntaps;
+  uint16_t pos;
+  uint16_t k;
+  acc_t acc;
+
+  LIBDSP_DEBUGASSERT(fir != NULL);
+  LIBDSP_DEBUGASSERT(in != NULL);
+  LIBDSP_DEBUGASSERT(out != NULL);
+
+  coeffs = fir->coeffs;
+  ntaps  = fir->ntaps;
+  pos    = fir->pos;
+
+  while (n-- > 0)
+    {
+      /* The newest sample goes in front of the previous ones */
+
+      pos = (pos == 0 ? ntaps : pos) - 1;
+      fir->state[pos]         = *in;
+      fir->state[pos + ntaps] = *in++;
+
+      taps = &fir->state[pos];
+      acc  = 0;
+
+      for (k = 0; k < ntaps; k++)
+        {
+          ACC_MAC(acc, coeffs[k], taps[k]);
+        }
+
+      *out++ = ACC_B16(acc);
+    }
+
+  fir->pos = pos;
+}
+
+/****************************************************************************
+ * Name: biquad_init_b16
+ *
+ * Description:
+ *   Initialize a cascade of biquad filters.  Each stage computes
+ *     y(n) = b0*x(n) + b1*x(n-1) + b2*x(n-2) - a1*y(n-1) - a2*y(n-2)
+ *   in the direct form I, which needs a single rounding per output and
+ *   keeps the state within the range of the signal.
+ *
+ * Input Parameters:
+ *   bq      - pointer to the biquad cascade data
+ *   coeffs  - 5 coefficients per stage: b0, b1, b2, a1, a2
+ *   state   - buffer of 4 values per stage
+ *   nstages - number of stages
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void biquad_init_b16(FAR struct biquad_b16_s *bq, FAR const b16_t *coeffs,
+                     FAR b16_t *state, uint8_t nstages)
+{
+  LIBDSP_DEBUGASSERT(bq != NULL);
+  LIBDSP_DEBUGASSERT(coeffs != NULL);
+  LIBDSP_DEBUGASSERT(state != NULL);
+  LIBDSP_DEBUGASSERT(nstages > 0);
+
+  bq->coeffs  = coeffs;
+  bq->state   = state;
+  bq->nstages = nstages;
+
+  memset(state, 0, 4 * nstages * sizeof(b16_t));
+}
+
+/****************************************************************************
+ * Name: biquad_cascade_b16
+ *
+ * Description:
+ *   Filter a block of samples with a cascade of biquad filters.  The block
+ *   passes one stage at a time, so the coefficients and the state of a
+ *   stage stay in registers for the whole block.
+ *
+ * Input Parameters:
+ *   bq  - pointer to the biquad cascade data
+ *   in  - input samples
+ *   out - output samples, may be the same buffer as in
+ *   n   - number of samples
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void biquad_cascade_b16(FAR struct biquad_b16_s *bq, FAR const b16_t *in,
+                        FAR b16_t *out, size_t n)
+{
+  FAR const b16_t *src;
+  FAR const b16_t *c;
+  FAR b16_t *d;
+  uint8_t stage;
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(bq != NULL);
+  LIBDSP_DEBUGASSERT(in != NULL);
+  LIBDSP_DEBUGASSERT(out != NULL);
+
+  c   = bq->coeffs;
+  d   = bq->state;
+  src = in;
+
+  for (stage = 0; stage < bq->nstages; stage++)
+    {
+      b16_t x1 = d[0];
+      b16_t x2 = d[1];
+      b16_t y1 = d[2];
+      b16_t y2 = d[3];
+
+      for (i = 0; i < n; i++)
+        {
+          b16_t x = src[i];
+          acc_t acc = 0;
+
+          ACC_MAC(acc, c[0], x);
+          ACC_MAC(acc, c[1], x1);
+          ACC_MAC(acc, c[2], x2);
+          ACC_MAC(acc, -c[3], y1);
+          ACC_MAC(acc, -c[4], y2);
+
+          x2     = x1;
+          x1     = x;
+          y2     = y1;
+          y1     = ACC_B16(acc);
+          out[i] = y1;
+        }
+
+      d[0] = x1;
+      d[1] = x2;
+      d[2] = y1;
+      d[3] = y2;
+
+      /* The next stages work in place on the output */
+
+      src  = out;
+      c   += 5;
+      d   += 4;
+    }
+}
+
+/****************************************************************************
+ * Name: mavg_filter_init_b16
+ *
+ * Description:
+ *   Initialize a moving average filter over the last len samples.
+ *
+ * Input Parameters:
+ *   mavg - pointer to the moving average filter data
+ *   buf  - buffer of len samples
+ *   len  - length of the window
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mavg_filter_init_b16(FAR struct mavg_filter_b16_s *mavg,
+                          FAR b16_t *buf, uint16_t len)
+{
+  LIBDSP_DEBUGASSERT(mavg != NULL);
+  LIBDSP_DEBUGASSERT(buf != NULL);
+  LIBDSP_DEBUGASSERT(len > 0);
+
+  mavg->buf = buf;
+  mavg->sum = 0;
+  mavg->len = len;
+  mavg->pos = 0;
+
+  memset(buf, 0, len * sizeof(b16_t));
+}
+
+/****************************************************************************
+ * Name: mavg_filter_b16
+ *
+ * Description:
+ *   Filter a block of samples with a moving average filter.  The running
+ *   sum is exact in fixed point, so the cost of a sample does not depend on
+ *   the window length.
+ *
+ * Input Parameters:
+ *   mavg - pointer to the moving average filter data
+ *   in   - input samples
+ *   out  - output samples, may be the same buffer as in
+ *   n    - number of samples
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mavg_filter_b16(FAR struct mavg_filter_b16_s *mavg,
+                     FAR const b16_t *in, FAR b16_t *out, size_t n)
+{
+  LIBDSP_DEBUGASSERT(mavg != NULL);
+  LIBDSP_DEBUGASSERT(in != NULL);
+  LIBDSP_DEBUGASSERT(out != NULL);
+
+  while (n-- > 0)
+    {
+      b16_t x = *in++;
+
+      mavg->sum += (acc_t)x - mavg->buf[mavg->pos];
+      mavg->buf[mavg->pos] = x;
+
+      if (++mavg->pos >= mavg->len)
+        {
+          mavg->pos = 0;
+        }
+
+      *out++ = (b16_t)(mavg->sum / mavg->len);
+    }
+}
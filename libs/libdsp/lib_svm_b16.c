@@ -204,55 +204,61 @@ static void svm3_duty_calc_b16(FAR struct svm3_state_b16_s *s,
 
   T0 = b16ONE - T1 - T2;
 
+  /* All phases need half of the null vector time.  This is
+   * b16mulb16(T0, b16HALF), rounded the same way, without the multiply.
+   */
+
+  T0 = (T0 + 1) >> 1;
+
   /* Calculate duty cycle for 3 phase */
 
   switch (s->sector)
     {
       case 1:
         {
-          s->d_u = T1 + T2 + b16mulb16(T0, b16HALF);
-          s->d_v = T2 + b16mulb16(T0, b16HALF);
-          s->d_w = b16mulb16(T0, b16HALF);
+          s->d_u = T1 + T2 + T0;
+          s->d_v = T2 + T0;
+          s->d_w = T0;
           break;
         }
 
       case 2:
         {
-          s->d_u = T1 + b16mulb16(T0, b16HALF);
-          s->d_v = T1 + T2 + b16mulb16(T0, b16HALF);
-          s->d_w = b16mulb16(T0, b16HALF);
+          s->d_u = T1 + T0;
+          s->d_v = T1 + T2 + T0;
+          s->d_w = T0;
           break;
         }
 
       case 3:
         {
-          s->d_u = b16mulb16(T0, b16HALF);
-          s->d_v = T1 + T2 + b16mulb16(T0, b16HALF);
-          s->d_w = T2 + b16mulb16(T0, b16HALF);
+          s->d_u = T0;
+          s->d_v = T1 + T2 + T0;
+          s->d_w = T2 + T0;
           break;
         }
 
       case 4:
         {
-          s->d_u = b16mulb16(T0, b16HALF);
-          s->d_v = T1 + b16mulb16(T0, b16HALF);
-          s->d_w = T1 + T2 + b16mulb16(T0, b16HALF);
+          s->d_u = T0;
+          s->d_v = T1 + T0;
+          s->d_w = T1 + T2 + T0;
           break;
         }
 
       case 5:
         {
-          s->d_u = T2 + b16mulb16(T0, b16HALF);
-          s->d_v = b16mulb16(T0, b16HALF);
-          s->d_w = T1 + T2 + b16mulb16(T0, b16HALF);
+          s->d_u = T2 + T0;
+          s->d_v = T0;
+          s->d_w = T1 + T2 + T0;
           break;
         }
 
       case 6:
         {
-          s->d_u = T1 + T2 + b16mulb16(T0, b16HALF);
-          s->d_v = b16mulb16(T0, b16HALF);
-          s->d_w = T1 + b16mulb16(T0, b16HALF);
+          s->d_u = T1 + T2 + T0;
+          s->d_v = T0;
+          s->d_w = T1 + T0;
           break;
         }
 
@@ -329,8 +335,7 @@ void svm3_b16(FAR struct svm3_state_b16_s *s, FAR ab_frame_b16_t *v_ab)
    * to obtain auxiliary frame which will be used in further calculations.
    */
 
-  ijk.a = b16mulb16(-b16HALF, v_ab->b) + b16mulb16(SQRT3_BY_TWO_B16,
-                                                   v_ab->a);
+  ijk.a = B16_MAC2(-b16HALF, v_ab->b, SQRT3_BY_TWO_B16, v_ab->a);
   ijk.b = v_ab->b;
   ijk.c = -ijk.b - ijk.a;
 
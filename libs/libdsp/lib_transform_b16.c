@@ -58,8 +58,7 @@ void clarke_transform_b16(FAR abc_frame_b16_t *abc,
   LIBDSP_DEBUGASSERT(ab != NULL);
 
   ab->a = abc->a;
-  ab->b = (b16mulb16(ONE_BY_SQRT3_B16, abc->a) +
-           b16mulb16(TWO_BY_SQRT3_B16, abc->b));
+  ab->b = B16_MAC2(ONE_BY_SQRT3_B16, abc->a, TWO_BY_SQRT3_B16, abc->b);
 }
 
 /****************************************************************************
@@ -87,8 +86,7 @@ void inv_clarke_transform_b16(FAR ab_frame_b16_t *ab,
   /* Assume non-power-invariant transform and balanced system */
 
   abc->a = ab->a;
-  abc->b = (b16mulb16(-b16HALF, ab->a) +
-            b16mulb16(SQRT3_BY_TWO_B16, ab->b));
+  abc->b = B16_MAC2(-b16HALF, ab->a, SQRT3_BY_TWO_B16, ab->b);
   abc->c = (-abc->a - abc->b);
 }
 
@@ -117,8 +115,8 @@ void park_transform_b16(FAR phase_angle_b16_t *angle,
   LIBDSP_DEBUGASSERT(ab != NULL);
   LIBDSP_DEBUGASSERT(dq != NULL);
 
-  dq->d = b16mulb16(angle->cos, ab->a) + b16mulb16(angle->sin, ab->b);
-  dq->q = b16mulb16(angle->cos, ab->b) - b16mulb16(angle->sin, ab->a);
+  dq->d = B16_MAC2(angle->cos, ab->a, angle->sin, ab->b);
+  dq->q = B16_MAC2(angle->cos, ab->b, -angle->sin, ab->a);
 }
 
 /****************************************************************************
@@ -146,6 +144,6 @@ void inv_park_transform_b16(FAR phase_angle_b16_t *angle,
   LIBDSP_DEBUGASSERT(dq != NULL);
   LIBDSP_DEBUGASSERT(ab != NULL);
 
-  ab->a = b16mulb16(angle->cos, dq->d) - b16mulb16(angle->sin, dq->q);
-  ab->b = b16mulb16(angle->cos, dq->q) + b16mulb16(angle->sin, dq->d);
+  ab->a = B16_MAC2(angle->cos, dq->d, -angle->sin, dq->q);
+  ab->b = B16_MAC2(angle->cos, dq->q, angle->sin, dq->d);
 }
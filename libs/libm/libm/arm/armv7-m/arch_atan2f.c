@@ -0,0 +1,156 @@
+/****************************************************************************
+ * libs/libm/libm/arm/armv7-m/arch_atan2f.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <math.h>
+
+#include "arch_libmf.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* With t = n / d, n = min(|x|, |y|), d = max(|x|, |y|) and c = j/8 the
+ * closest point atan(t) = atan(c) + atan(u), |u| <= 1/16 for
+ * u = (t - c) / (1 + t * c) = (n - c * d) / (d + c * n).  The last form
+ * avoids the rounding error of t.  d is scaled down where d + c * n could
+ * overflow and up where c * d could be subnormal.
+ */
+
+#define ATAN2F_N        8
+#define ATAN2F_DMAX     1.0e38f
+#define ATAN2F_DMIN     1.0e-30f
+#define ATAN2F_2P64     1.8446744e+19f
+#define ATAN2F_PIO2_HI  1.5707964f
+#define ATAN2F_PIO2_LO  -4.371139e-08f
+#define ATAN2F_PI_HI    3.1415927f
+#define ATAN2F_PI_LO    -8.742278e-08f
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* atan(j/8) for 0 <= j <= 8 */
+
+static const float g_atan2f_table[ATAN2F_N + 1] =
+{
+  0.0f, 0.124354996f, 0.244978666f, 0.358770669f,
+  0.463647604f, 0.558599293f, 0.643501103f, 0.718829989f,
+  0.785398185f
+};
+
+#ifndef CONFIG_ARMV7M_LIBM_APPROX
+/* atan(j/8) - g_atan2f_table[j], which matters where atan(u) cancels part
+ * of atan(c).
+ */
+
+static const float g_atan2f_table_lo[ATAN2F_N + 1] =
+{
+  0.0f, -1.2403822e-09f, -3.1786778e-09f, 1.7639499e-09f,
+  5.0121587e-09f, 2.2111598e-08f, 5.8689373e-09f, 1.01883355e-08f,
+  -2.1855694e-08f
+};
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+float atan2f(float y, float x)
+{
+  unsigned int j;
+  float ax;
+  float ay;
+  float a;
+  float c;
+  float d;
+  float n;
+  float t;
+  float u;
+  float u2;
+
+  if (isnan(x) || isnan(y))
+    {
+      return x + y;
+    }
+
+  ax = fabsf(x);
+  ay = fabsf(y);
+
+  if (isinf(ax) && isinf(ay))
+    {
+      a = 0.5f * ATAN2F_PIO2_HI;
+    }
+  else if (ay == 0.0f)
+    {
+      /* atan2(+-0, x) is +-0 for x > 0 or x = +0 and +-pi otherwise */
+
+      a = signbit(x) ? ATAN2F_PI_HI : 0.0f;
+      return copysignf(a, y);
+    }
+  else
+    {
+      n = ay <= ax ? ay : ax;
+      d = ay <= ax ? ax : ay;
+      if (d > ATAN2F_DMAX)
+        {
+          n *= 0.25f;
+          d *= 0.25f;
+        }
+      else if (d < ATAN2F_DMIN)
+        {
+          n *= ATAN2F_2P64;
+          d *= ATAN2F_2P64;
+        }
+
+      t = n / d;
+      j = (unsigned int)ARCH_FMAF(t, ATAN2F_N, 0.5f);
+      c = (float)j / ATAN2F_N;
+
+      u  = ARCH_FMAF(-c, d, n) / ARCH_FMAF(c, n, d);
+      u2 = u * u;
+
+#ifdef CONFIG_ARMV7M_LIBM_APPROX
+      a = ARCH_FMAF(u * u2, -(1.0f / 3.0f), u);
+#else
+      a = ARCH_FMAF(u * u2, ARCH_FMAF(u2, (1.0f / 5.0f), -(1.0f / 3.0f)),
+                    u);
+      a += g_atan2f_table_lo[j];
+#endif
+
+      a += g_atan2f_table[j];
+
+      if (ay > ax)
+        {
+          a = (ATAN2F_PIO2_HI - a) + ATAN2F_PIO2_LO;
+        }
+    }
+
+  if (signbit(x))
+    {
+      a = (ATAN2F_PI_HI - a) + ATAN2F_PI_LO;
+    }
+
+  return copysignf(a, y);
+}
@@ -0,0 +1,128 @@
+/****************************************************************************
+ * libs/libm/libm/arm/armv7-m/arch_expf.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <math.h>
+
+#include "arch_libmf.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* x = (m + j/32) * ln2 + r, |r| <= ln2/64, and
+ * exp(x) = 2^m * 2^(j/32) * exp(r)
+ */
+
+#define EXPF_N          32
+#define EXPF_INVLN2N    46.16624f
+#define EXPF_LN2N_HI    0.02166085f
+#define EXPF_LN2N_LO    -5.9520444e-11f
+
+/* exp(x) overflows above 128 * ln2 and is below half the smallest
+ * subnormal under -150 * ln2.
+ */
+
+#define EXPF_MAX        88.72284f
+#define EXPF_MIN        -103.97208f
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* 2^(j/32) for 0 <= j < 32 */
+
+static const float g_expf_table[EXPF_N] =
+{
+  1.0f, 1.0218972f, 1.04427373f, 1.06714046f,
+  1.09050775f, 1.1143868f, 1.13878858f, 1.1637249f,
+  1.18920708f, 1.21524739f, 1.24185777f, 1.26905096f,
+  1.29683959f, 1.32523668f, 1.35425556f, 1.38390994f,
+  1.41421354f, 1.44518077f, 1.47682619f, 1.50916445f,
+  1.54221082f, 1.5759809f, 1.61049032f, 1.64575553f,
+  1.68179286f, 1.71861935f, 1.75625217f, 1.79470909f,
+  1.8340081f, 1.87416768f, 1.91520655f, 1.95714414f
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+float expf(float x)
+{
+  int32_t k;
+  int32_t m;
+  float kf;
+  float r;
+  float p;
+  float t;
+  float y;
+
+  if (!(x <= EXPF_MAX))
+    {
+      /* Overflow or NaN */
+
+      return x + INFINITY_F;
+    }
+
+  if (x < EXPF_MIN)
+    {
+      return 0.0f;
+    }
+
+  kf = arch_roundf(x * EXPF_INVLN2N);
+  k  = (int32_t)kf;
+
+  r = ARCH_FMAF(-kf, EXPF_LN2N_HI, x);
+  r = ARCH_FMAF(-kf, EXPF_LN2N_LO, r);
+
+  /* exp(r) - 1 */
+
+#ifdef CONFIG_ARMV7M_LIBM_APPROX
+  p = ARCH_FMAF(r * r, 0.5f, r);
+#else
+  p = ARCH_FMAF(r * r, ARCH_FMAF(r, (1.0f / 6.0f), 0.5f), r);
+#endif
+
+  t = g_expf_table[k & (EXPF_N - 1)];
+  y = ARCH_FMAF(t, p, t);
+
+  /* Scale by 2^m, in two steps where 2^m is not a normal float.  The
+   * first step is exact, so subnormal results are rounded only once.
+   */
+
+  m = (k - (k & (EXPF_N - 1))) / EXPF_N;
+  if (m > 127)
+    {
+      y *= 2.0f;
+      m -= 1;
+    }
+  else if (m < -126)
+    {
+      y *= 5.421011e-20f;
+      m += 64;
+    }
+
+  return y * arch_asfloat((uint32_t)(m + 127) << 23);
+}
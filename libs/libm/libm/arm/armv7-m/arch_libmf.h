@@ -0,0 +1,154 @@
+/****************************************************************************
+ * libs/libm/libm/arm/armv7-m/arch_libmf.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __LIBS_LIBM_LIBM_ARM_ARMV7_M_ARCH_LIBMF_H
+#define __LIBS_LIBM_LIBM_ARM_ARMV7_M_ARCH_LIBMF_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Every FPv4-SP and FPv5 unit has VFMA, so fmaf() is a single instruction
+ * with a single rounding.  The range reductions below rely on it.
+ */
+
+#define ARCH_FMAF(a, b, c)   __builtin_fmaf(a, b, c)
+
+/* sinf()/cosf() work on x = n * pi/32 + r with |r| <= pi/64.  pi/32 is
+ * split in three floats for the Cody-Waite reduction, which is accurate
+ * for |x| < ARCH_SINCOSF_MAX.  Larger arguments go through sin()/cos().
+ */
+
+#define ARCH_SINCOSF_MAX     131072.0f
+#define ARCH_SINCOSF_N       64
+#define ARCH_INVPIO32F       10.185916f
+#define ARCH_PIO32F_HI       0.09817477f
+#define ARCH_PIO32F_MID      -2.7319618e-09f
+#define ARCH_PIO32F_LO       -1.0719528e-16f
+
+/* Adding and subtracting 1.5 * 2^23 rounds a float of magnitude below
+ * 2^22 to the nearest integer without a float to integer conversion.
+ */
+
+#define ARCH_ROUNDF_SHIFT    12582912.0f
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* sin(i * pi/32) for 0 <= i < 80, cos(i * pi/32) is entry i + 16.  The
+ * low parts matter where the result is much smaller than the table entry,
+ * which is between the entries next to the zeros.  The approximate variant
+ * does without them.
+ */
+
+extern const float g_arch_sintabf[ARCH_SINCOSF_N + ARCH_SINCOSF_N / 4];
+#ifndef CONFIG_ARMV7M_LIBM_APPROX
+extern const float g_arch_sintabf_lo[ARCH_SINCOSF_N + ARCH_SINCOSF_N / 4];
+#  define ARCH_SINTABF_LO(i) g_arch_sintabf_lo[i]
+#else
+#  define ARCH_SINTABF_LO(i) 0.0f
+#endif
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+static inline uint32_t arch_asuint(float x)
+{
+  uint32_t i;
+
+  memcpy(&i, &x, sizeof(i));
+  return i;
+}
+
+static inline float arch_asfloat(uint32_t i)
+{
+  float x;
+
+  memcpy(&x, &i, sizeof(x));
+  return x;
+}
+
+static inline float arch_roundf(float x)
+{
+  return (x + ARCH_ROUNDF_SHIFT) - ARCH_ROUNDF_SHIFT;
+}
+
+/****************************************************************************
+ * Name: arch_sincosf_reduce
+ *
+ * Description:
+ *   Reduce x to r = x - n * pi/32, |r| <= pi/64, for |x| <
+ *   ARCH_SINCOSF_MAX.  With the fused multiply-adds the first step is
+ *   exact and the result is accurate even close to multiples of pi.
+ *
+ * Returned Value:
+ *   r, n modulo ARCH_SINCOSF_N is returned through pn.
+ *
+ ****************************************************************************/
+
+static inline float arch_sincosf_reduce(float x, unsigned int *pn)
+{
+  float kf;
+  float r;
+
+  kf  = arch_roundf(x * ARCH_INVPIO32F);
+  *pn = (unsigned int)(int32_t)kf % ARCH_SINCOSF_N;
+
+  r = ARCH_FMAF(-kf, ARCH_PIO32F_HI, x);
+  r = ARCH_FMAF(-kf, ARCH_PIO32F_MID, r);
+  r = ARCH_FMAF(-kf, ARCH_PIO32F_LO, r);
+
+  return r;
+}
+
+/****************************************************************************
+ * Name: arch_sincosf_poly
+ *
+ * Description:
+ *   Evaluate sin(r) and cos(r) - 1 for |r| <= pi/64.
+ *
+ ****************************************************************************/
+
+static inline void arch_sincosf_poly(float r, float *sinr, float *cosr1)
+{
+  float r2 = r * r;
+
+#ifdef CONFIG_ARMV7M_LIBM_APPROX
+  *sinr  = ARCH_FMAF(r * r2, -(1.0f / 6.0f), r);
+  *cosr1 = r2 * -0.5f;
+#else
+  *sinr  = ARCH_FMAF(r * r2, ARCH_FMAF(r2, (1.0f / 120.0f),
+                                       -(1.0f / 6.0f)), r);
+  *cosr1 = r2 * ARCH_FMAF(r2, (1.0f / 24.0f), -0.5f);
+#endif
+}
+
+#endif /* __LIBS_LIBM_LIBM_ARM_ARMV7_M_ARCH_LIBMF_H */
@@ -0,0 +1,161 @@
+/****************************************************************************
+ * libs/libm/libm/arm/armv7-m/arch_logf.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <math.h>
+
+#include "arch_libmf.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* x = 2^k * z with z in [LOGF_OFF, 2 * LOGF_OFF), so that z is close to 1
+ * when x is.  The top bits of the mantissa of z select c with
+ * log(x) = k * ln2 + log(c) + log1p(z / c - 1), |z / c - 1| < 1/64.
+ */
+
+#define LOGF_N          32
+#define LOGF_OFF        0x3f330000
+#define LOGF_LN2_HI     0.6931472f
+#define LOGF_LN2_LO     -1.9046542e-09f
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct logf_entry_s
+{
+  float invc;   /* 1 / c, exactly 1 for the interval that contains 1 */
+  float logc;   /* -log(invc) */
+  float logclo; /* -log(invc) - logc */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct logf_entry_s g_logf_table[LOGF_N] =
+{
+  { 1.4143647f, -0.34668046f, 1.0496759e-08f },
+  { 1.3837838f, -0.32482165f, 7.3662787e-09f },
+  { 1.3544973f, -0.3034304f, 9.087429e-09f },
+  { 1.3264248f, -0.28248724f, 1.2984958e-08f },
+  { 1.2994924f, -0.2619737f, 1.361555e-08f },
+  { 1.2736318f, -0.24187252f, 6.1172623e-09f },
+  { 1.2487805f, -0.22216746f, -4.1619574e-09f },
+  { 1.2248803f, -0.20284316f, 3.7096703e-09f },
+  { 1.201878f, -0.18388529f, -1.9868795e-09f },
+  { 1.1797235f, -0.16528009f, -1.2254698e-09f },
+  { 1.1583711f, -0.14701478f, -4.4356137e-09f },
+  { 1.1377778f, -0.12907706f, -4.478764e-09f },
+  { 1.117904f, -0.111455455f, -1.335405e-09f },
+  { 1.0987124f, -0.09413899f, -1.688832e-09f },
+  { 1.0801687f, -0.07711726f, 1.9045456e-09f },
+  { 1.0622407f, -0.060380563f, -4.6871607e-10f },
+  { 1.0448979f, -0.04391919f, 1.3609236e-10f },
+  { 1.0281124f, -0.02772451f, -7.0319056e-10f },
+  { 1.0118577f, -0.011787996f, -1.0284434e-10f },
+  { 1.0f, 0.0f, 0.0f },
+  { 0.96240604f, 0.03831884f, 2.3225785e-10f },
+  { 0.93430656f, 0.06795067f, -3.5766061e-09f },
+  { 0.9078014f, 0.09672966f, -4.2054443e-10f },
+  { 0.8827586f, 0.12470348f, 4.3284393e-10f },
+  { 0.8590604f, 0.15191604f, -4.601024e-09f },
+  { 0.8366013f, 0.17840764f, 6.566226e-09f },
+  { 0.81528664f, 0.20421553f, -5.328074e-11f },
+  { 0.7950311f, 0.22937408f, 1.542017e-09f },
+  { 0.77575755f, 0.25391525f, -8.655429e-09f },
+  { 0.75739646f, 0.27786845f, -1.1723017e-08f },
+  { 0.7398844f, 0.30126137f, -1.2483762e-08f },
+  { 0.72316384f, 0.32411948f, -1.167256e-08f }
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+float logf(float x)
+{
+  FAR const struct logf_entry_s *e;
+  uint32_t ix;
+  uint32_t tmp;
+  int32_t k;
+  float kf;
+  float r;
+  float r2;
+  float p;
+  float y;
+
+  ix = arch_asuint(x);
+  k  = 0;
+
+  if (ix - 0x00800000 >= 0x7f800000 - 0x00800000)
+    {
+      /* Zero, subnormal, negative, infinite or NaN */
+
+      if ((ix << 1) == 0)
+        {
+          return -INFINITY_F;
+        }
+
+      if (ix == 0x7f800000)
+        {
+          return x;
+        }
+
+      if ((ix & 0x80000000) != 0 || (ix << 1) >= 0xff000000)
+        {
+          return (x - x) / (x - x);
+        }
+
+      ix = arch_asuint(x * 8388608.0f);
+      k  = -23;
+    }
+
+  tmp = ix - LOGF_OFF;
+  e   = &g_logf_table[(tmp >> 18) % LOGF_N];
+  k  += (int32_t)tmp >> 23;
+  kf  = (float)k;
+
+  r  = ARCH_FMAF(arch_asfloat(ix - (tmp & 0xff800000)), e->invc, -1.0f);
+  r2 = r * r;
+
+  /* log1p(r) - r */
+
+#ifdef CONFIG_ARMV7M_LIBM_APPROX
+  p = r2 * ARCH_FMAF(r, (1.0f / 3.0f), -0.5f);
+#else
+  p = r2 * ARCH_FMAF(r, ARCH_FMAF(r, -0.25f, (1.0f / 3.0f)), -0.5f);
+#endif
+
+  /* The low part of log(c) matters where log1p(r) cancels part of it */
+
+#ifndef CONFIG_ARMV7M_LIBM_APPROX
+  p += e->logclo;
+#endif
+
+  y = ARCH_FMAF(kf, LOGF_LN2_HI, e->logc) + r;
+  return y + ARCH_FMAF(kf, LOGF_LN2_LO, p);
+}
@@ -0,0 +1,61 @@
+/****************************************************************************
+ * libs/libm/libm/arm/armv7-m/arch_sinf.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <math.h>
+
+#include "arch_libmf.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/* sin(n * pi/32 + r) = sin(n * pi/32) + (cos(n * pi/32) * sin(r) +
+ *                      sin(n * pi/32) * (cos(r) - 1))
+ */
+
+float sinf(float x)
+{
+  unsigned int n;
+  float cosr1;
+  float sinr;
+  float s;
+  float c;
+  float r;
+
+  if (!(fabsf(x) < ARCH_SINCOSF_MAX))
+    {
+      /* Large arguments, infinities and NaNs */
+
+      return (float)sin((double)x);
+    }
+
+  r = arch_sincosf_reduce(x, &n);
+  arch_sincosf_poly(r, &sinr, &cosr1);
+
+  s = g_arch_sintabf[n];
+  c = g_arch_sintabf[n + ARCH_SINCOSF_N / 4];
+
+  return s + ARCH_FMAF(c, sinr, ARCH_FMAF(s, cosr1, ARCH_SINTABF_LO(n)));
+}
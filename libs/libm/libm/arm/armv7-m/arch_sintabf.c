@@ -0,0 +1,81 @@
+/****************************************************************************
+ * libs/libm/libm/arm/armv7-m/arch_sintabf.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include "arch_libmf.h"
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const float g_arch_sintabf[ARCH_SINCOSF_N + ARCH_SINCOSF_N / 4] =
+{
+  0.0f, 0.09801714f, 0.19509032f, 0.29028466f,
+  0.38268343f, 0.47139674f, 0.55557024f, 0.6343933f,
+  0.70710677f, 0.77301043f, 0.8314696f, 0.8819213f,
+  0.9238795f, 0.95694035f, 0.98078525f, 0.9951847f,
+  1.0f, 0.9951847f, 0.98078525f, 0.95694035f,
+  0.9238795f, 0.8819213f, 0.8314696f, 0.77301043f,
+  0.70710677f, 0.6343933f, 0.55557024f, 0.47139674f,
+  0.38268343f, 0.29028466f, 0.19509032f, 0.09801714f,
+  0.0f, -0.09801714f, -0.19509032f, -0.29028466f,
+  -0.38268343f, -0.47139674f, -0.55557024f, -0.6343933f,
+  -0.70710677f, -0.77301043f, -0.8314696f, -0.8819213f,
+  -0.9238795f, -0.95694035f, -0.98078525f, -0.9951847f,
+  -1.0f, -0.9951847f, -0.98078525f, -0.95694035f,
+  -0.9238795f, -0.8819213f, -0.8314696f, -0.77301043f,
+  -0.70710677f, -0.6343933f, -0.55557024f, -0.47139674f,
+  -0.38268343f, -0.29028466f, -0.19509032f, -0.09801714f,
+  0.0f, 0.09801714f, 0.19509032f, 0.29028466f,
+  0.38268343f, 0.47139674f, 0.55557024f, 0.6343933f,
+  0.70710677f, 0.77301043f, 0.8314696f, 0.8819213f,
+  0.9238795f, 0.95694035f, 0.98078525f, 0.9951847f
+};
+
+#ifndef CONFIG_ARMV7M_LIBM_APPROX
+/* sin(i * pi/32) - g_arch_sintabf[i] */
+
+const float g_arch_sintabf_lo[ARCH_SINCOSF_N + ARCH_SINCOSF_N / 4] =
+{
+  0.0f, -8.933932e-10f, -1.6704715e-09f, 1.3815665e-08f,
+  6.2233507e-09f, -7.4252537e-09f, -1.1769521e-08f, 9.379558e-09f,
+  1.21016175e-08f, 2.0642553e-08f, 1.6870263e-08f, -2.7002963e-08f,
+  2.830749e-08f, -1.7184508e-08f, 2.9739473e-08f, 7.109666e-09f,
+  0.0f, 7.109666e-09f, 2.9739473e-08f, -1.7184508e-08f,
+  2.830749e-08f, -2.7002963e-08f, 1.6870263e-08f, 2.0642553e-08f,
+  1.21016175e-08f, 9.379558e-09f, -1.1769521e-08f, -7.4252537e-09f,
+  6.2233507e-09f, 1.3815665e-08f, -1.6704715e-09f, -8.933932e-10f,
+  0.0f, 8.933932e-10f, 1.6704715e-09f, -1.3815665e-08f,
+  -6.2233507e-09f, 7.4252537e-09f, 1.1769521e-08f, -9.379558e-09f,
+  -1.21016175e-08f, -2.0642553e-08f, -1.6870263e-08f, 2.7002963e-08f,
+  -2.830749e-08f, 1.7184508e-08f, -2.9739473e-08f, -7.109666e-09f,
+  0.0f, -7.109666e-09f, -2.9739473e-08f, 1.7184508e-08f,
+  -2.830749e-08f, 2.7002963e-08f, -1.6870263e-08f, -2.0642553e-08f,
+  -1.21016175e-08f, -9.379558e-09f, 1.1769521e-08f, 7.4252537e-09f,
+  -6.2233507e-09f, -1.3815665e-08f, 1.6704715e-09f, 8.933932e-10f,
+  0.0f, -8.933932e-10f, -1.6704715e-09f, 1.3815665e-08f,
+  6.2233507e-09f, -7.4252537e-09f, -1.1769521e-08f, 9.379558e-09f,
+  1.21016175e-08f, 2.0642553e-08f, 1.6870263e-08f, -2.7002963e-08f,
+  2.830749e-08f, -1.7184508e-08f, 2.9739473e-08f, 7.109666e-09f
+};
+#endif
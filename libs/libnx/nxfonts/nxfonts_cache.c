@@ -36,6 +36,15 @@
 
 #include "nxcontext.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Glyphs are looked up by character code in a small hash table */
+
+#define NXF_HASHSIZE     32
+#define NXF_HASH(ch)     ((ch) & (NXF_HASHSIZE - 1))
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -65,8 +74,9 @@ struct nxfonts_fcache_s
 
   /* Glyph cache data storage */
 
-  FAR struct nxfonts_glyph_s *head;    /* Head of the list of glyphs */
-  FAR struct nxfonts_glyph_s *tail;    /* Tail of the list of glyphs */
+  FAR struct nxfonts_glyph_s *head;    /* Most recently used glyph */
+  FAR struct nxfonts_glyph_s *tail;    /* Least recently used glyph */
+  FAR struct nxfonts_glyph_s *hash[NXF_HASHSIZE];
 };
 
 /****************************************************************************
@@ -124,47 +134,49 @@ static inline void nxf_removecache(FAR struct nxfonts_fcache_s *fcache,
  ****************************************************************************/
 
 static inline void nxf_removeglyph(FAR struct nxfonts_fcache_s *priv,
-                                   FAR struct nxfonts_glyph_s *glyph,
-                                   FAR struct nxfonts_glyph_s *prev)
+                                   FAR struct nxfonts_glyph_s *glyph)
 {
+  FAR struct nxfonts_glyph_s **link;
+
   ginfo("fcache=%p glyph=%p\n", priv, glyph);
 
-  /* Remove the glyph for the list.  First check for removal from the head
-   * (which, I think, never actually happens).
-   */
+  /* Remove the glyph from the LRU list */
 
-  if (prev == NULL)
+  if (glyph->blink != NULL)
+    {
+      glyph->blink->flink = glyph->flink;
+    }
+  else
     {
-      /* Replace the head with the node following glyph */
-
       priv->head = glyph->flink;
-
-      /* If there is no node following glyph, then the list is empty */
-
-      if (priv->head == NULL)
-        {
-          priv->tail = NULL;
-        }
     }
 
-  /* Check for removal from the tail (we know that the list cannot become
-   * empty in either of the next two cases).
-   */
-
-  else if (glyph->flink == NULL)
+  if (glyph->flink != NULL)
     {
-      priv->tail = prev;
-      prev->flink = NULL;
+      glyph->flink->blink = glyph->blink;
     }
-
-  /* No.. Remove from mid-list */
-
   else
     {
-      prev->flink = glyph->flink;
+      priv->tail = glyph->blink;
     }
 
   glyph->flink = NULL;
+  glyph->blink = NULL;
+
+  /* And from its hash bucket */
+
+  for (link = &priv->hash[NXF_HASH(glyph->code)];
+       *link != NULL;
+       link = &(*link)->hlink)
+    {
+      if (*link == glyph)
+        {
+          *link = glyph->hlink;
+          break;
+        }
+    }
+
+  glyph->hlink = NULL;
 
   /* Decrement the count of glyphs in the font cache */
 
@@ -172,6 +184,38 @@ static inline void nxf_removeglyph(FAR struct nxfonts_fcache_s *priv,
   priv->nglyphs--;
 }
 
+/****************************************************************************
+ * Name: nxf_mkrecent
+ *
+ * Description:
+ *   Move the entry 'glyph' to the head of the LRU list.
+ *
+ ****************************************************************************/
+
+static inline void nxf_mkrecent(FAR struct nxfonts_fcache_s *priv,
+                                FAR struct nxfonts_glyph_s *glyph)
+{
+  if (glyph->blink == NULL)
+    {
+      return;
+    }
+
+  glyph->blink->flink = glyph->flink;
+  if (glyph->flink != NULL)
+    {
+      glyph->flink->blink = glyph->blink;
+    }
+  else
+    {
+      priv->tail = glyph->blink;
+    }
+
+  glyph->blink       = NULL;
+  glyph->flink       = priv->head;
+  priv->head->blink  = glyph;
+  priv->head         = glyph;
+}
+
 /****************************************************************************
  * Name: nxf_addglyph
  *
@@ -183,19 +227,31 @@ static inline void nxf_removeglyph(FAR struct nxfonts_fcache_s *priv,
 static inline void nxf_addglyph(FAR struct nxfonts_fcache_s *priv,
                                 FAR struct nxfonts_glyph_s *glyph)
 {
+  FAR struct nxfonts_glyph_s **bucket = &priv->hash[NXF_HASH(glyph->code)];
+
   ginfo("fcache=%p glyph=%p\n", priv, glyph);
 
-  /* Add the glyph to the head of the list */
+  /* Add the glyph to the head of the LRU list */
 
+  glyph->blink = NULL;
   glyph->flink = priv->head;
 
   if (priv->head == NULL)
     {
       priv->tail = glyph;
     }
+  else
+    {
+      priv->head->blink = glyph;
+    }
 
   priv->head = glyph;
 
+  /* And to its hash bucket */
+
+  glyph->hlink = *bucket;
+  *bucket      = glyph;
+
   /* Increment the count of glyphs in the font cache. */
 
   DEBUGASSERT(priv->nglyphs < priv->maxglyphs);
@@ -228,51 +284,33 @@ static FAR struct nxfonts_glyph_s *
 nxf_findglyph(FAR struct nxfonts_fcache_s *priv, uint8_t ch)
 {
   FAR struct nxfonts_glyph_s *glyph;
-  FAR struct nxfonts_glyph_s *prev;
 
   ginfo("fcache=%p ch=%c (%02x)\n",
         priv, (ch >= 32 && ch < 128) ? ch : '.', ch);
 
-  /* Try to find the glyph in the list of pre-rendered glyphs */
+  /* Try to find the glyph in the pre-rendered glyphs */
 
-  for (prev = NULL, glyph = priv->head;
-       glyph != NULL;
-       prev = glyph, glyph = glyph->flink)
+  for (glyph = priv->hash[NXF_HASH(ch)]; glyph != NULL;
+       glyph = glyph->hlink)
     {
-      /* Check if we found the glyph for this character */
-
       if (glyph->code == ch)
         {
-          /* This is now the most recently used glyph.  Move it to the head
-           * of the list (if it is not already at the head of the list).
-           */
-
-          if (prev != NULL)
-            {
-              nxf_removeglyph(priv, glyph, prev);
-              nxf_addglyph(priv, glyph);
-            }
-
-          /* And return the glyph that we found */
+          /* This is now the most recently used glyph */
 
+          nxf_mkrecent(priv, glyph);
           return glyph;
         }
+    }
 
-      /* Is this the last glyph in the list?  Has the cache reached its
-       * limit for the number of cached fonts?
-       */
-
-      if (glyph->flink == NULL && priv->nglyphs >= priv->maxglyphs)
-        {
-          /* Yes.. then remove it from the list and free the glyph memory.
-           * We do this because we have all of the information in hand now
-           * and we will surely need to have this space later.
-           */
+  /* Has the cache reached its limit for the number of cached fonts?  Then
+   * free the least recently used glyph now, we will surely need the space.
+   */
 
-          nxf_removeglyph(priv, glyph, prev);
-          lib_free(glyph);
-          return NULL;
-        }
+  glyph = priv->tail;
+  if (glyph != NULL && priv->nglyphs >= priv->maxglyphs)
+    {
+      nxf_removeglyph(priv, glyph);
+      lib_free(glyph);
     }
 
   return NULL;
@@ -23,6 +23,12 @@
  * For multiple writer and one reader there is only a need to lock the
  * writer. And vice versa for only one writer and multiple reader there is
  * only a need to lock the reader.
+ *
+ * The writer only modifies head and the reader only modifies tail.  Each
+ * side publishes its index with a release store after the data has been
+ * copied, and loads the other side's index with an acquire load before
+ * touching the data, so the data is never seen before the index that
+ * covers it, on SMP either.
  */
 
 /****************************************************************************
@@ -36,6 +42,18 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/mm/circbuf.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef __GNUC__
+#  define circbuf_load(p)     __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#  define circbuf_store(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+#else
+#  define circbuf_load(p)     (*(FAR volatile size_t *)(p))
+#  define circbuf_store(p, v) (*(FAR volatile size_t *)(p) = (v))
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -208,8 +226,14 @@ size_t circbuf_size(FAR struct circbuf_s *circ)
 
 size_t circbuf_used(FAR struct circbuf_s *circ)
 {
+  size_t tail;
+
   DEBUGASSERT(circ);
-  return circ->head - circ->tail;
+
+  /* Load tail first: head can only move away from it meanwhile */
+
+  tail = circbuf_load(&circ->tail);
+  return circbuf_load(&circ->head) - tail;
 }
 
 /****************************************************************************
@@ -296,6 +320,7 @@ bool circbuf_is_full(FAR struct circbuf_s *circ)
 ssize_t circbuf_peekat(FAR struct circbuf_s *circ, size_t pos,
                        FAR void *dst, size_t bytes)
 {
+  size_t head;
   size_t len;
   size_t off;
 
@@ -306,12 +331,13 @@ ssize_t circbuf_peekat(FAR struct circbuf_s *circ, size_t pos,
       return 0;
     }
 
-  if (circ->head - pos > circ->head - circ->tail)
+  head = circbuf_load(&circ->head);
+  if (head - pos > head - circ->tail)
     {
       pos = circ->tail;
     }
 
-  len = circ->head - pos;
+  len = head - pos;
   off = pos % circ->size;
 
   if (bytes > len)
@@ -384,7 +410,7 @@ ssize_t circbuf_read(FAR struct circbuf_s *circ,
   DEBUGASSERT(dst || !bytes);
 
   bytes = circbuf_peek(circ, dst, bytes);
-  circ->tail += bytes;
+  circbuf_store(&circ->tail, circ->tail + bytes);
 
   return bytes;
 }
@@ -421,7 +447,7 @@ ssize_t circbuf_skip(FAR struct circbuf_s *circ, size_t bytes)
       bytes = len;
     }
 
-  circ->tail += bytes;
+  circbuf_store(&circ->tail, circ->tail + bytes);
 
   return bytes;
 }
@@ -475,7 +501,7 @@ ssize_t circbuf_write(FAR struct circbuf_s *circ,
 
   memcpy((FAR char *)circ->base + off, src, space);
   memcpy(circ->base, (FAR char *)src + space, bytes - space);
-  circ->head += bytes;
+  circbuf_store(&circ->head, circ->head + bytes);
 
   return bytes;
 }
@@ -564,20 +590,21 @@ ssize_t circbuf_overwrite(FAR struct circbuf_s *circ,
 
 FAR void *circbuf_get_writeptr(FAR struct circbuf_s *circ, FAR size_t *size)
 {
+  size_t space;
   size_t off;
-  size_t pos;
 
   DEBUGASSERT(circ);
 
-  off = circ->head % circ->size;
-  pos = circ->tail % circ->size;
-  if (off >= pos)
-    {
-      *size = circ->size - off;
-    }
-  else
+  /* Head and tail are at the same offset both when the buffer is empty and
+   * when it is full, so use the free space rather than the tail offset.
+   */
+
+  space = circ->size - (circ->head - circbuf_load(&circ->tail));
+  off   = circ->head % circ->size;
+  *size = circ->size - off;
+  if (*size > space)
     {
-      *size = pos - off;
+      *size = space;
     }
 
   return (FAR char *)circ->base + off;
@@ -600,20 +627,17 @@ FAR void *circbuf_get_writeptr(FAR struct circbuf_s *circ, FAR size_t *size)
 
 FAR void *circbuf_get_readptr(FAR struct circbuf_s *circ, size_t *size)
 {
-  size_t off;
+  size_t used;
   size_t pos;
 
   DEBUGASSERT(circ);
 
-  off = circ->head % circ->size;
-  pos = circ->tail % circ->size;
-  if (pos > off)
-    {
-      *size = circ->size - pos;
-    }
-  else
+  used  = circbuf_load(&circ->head) - circ->tail;
+  pos   = circ->tail % circ->size;
+  *size = circ->size - pos;
+  if (*size > used)
     {
-      *size = off - pos;
+      *size = used;
     }
 
   return (FAR char *)circ->base + pos;
@@ -636,7 +660,7 @@ FAR void *circbuf_get_readptr(FAR struct circbuf_s *circ, size_t *size)
 void circbuf_writecommit(FAR struct circbuf_s *circ, size_t writtensize)
 {
   DEBUGASSERT(circ);
-  circ->head += writtensize;
+  circbuf_store(&circ->head, circ->head + writtensize);
 }
 
 /****************************************************************************
@@ -656,5 +680,5 @@ void circbuf_writecommit(FAR struct circbuf_s *circ, size_t writtensize)
 void circbuf_readcommit(FAR struct circbuf_s *circ, size_t readsize)
 {
   DEBUGASSERT(circ);
-  circ->tail += readsize;
+  circbuf_store(&circ->tail, circ->tail + readsize);
 }
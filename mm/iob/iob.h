@@ -48,6 +48,30 @@
 #  define iobinfo                _none
 #endif /* CONFIG_DEBUG_FEATURES && CONFIG_IOB_DEBUG */
 
+/* The IOB notifier is signalled each time the number of available IOBs
+ * reaches a multiple of IOB_DIVIDER.
+ */
+
+#ifdef CONFIG_IOB_NOTIFIER
+#  if !defined(CONFIG_IOB_NOTIFIER_DIV) || CONFIG_IOB_NOTIFIER_DIV < 2
+#    define IOB_DIVIDER 1
+#  elif CONFIG_IOB_NOTIFIER_DIV < 4
+#    define IOB_DIVIDER 2
+#  elif CONFIG_IOB_NOTIFIER_DIV < 8
+#    define IOB_DIVIDER 4
+#  elif CONFIG_IOB_NOTIFIER_DIV < 16
+#    define IOB_DIVIDER 8
+#  elif CONFIG_IOB_NOTIFIER_DIV < 32
+#    define IOB_DIVIDER 16
+#  elif CONFIG_IOB_NOTIFIER_DIV < 64
+#    define IOB_DIVIDER 32
+#  else
+#    define IOB_DIVIDER 64
+#  endif
+#endif
+
+#define IOB_MASK      (IOB_DIVIDER - 1)
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -60,6 +84,14 @@ extern FAR struct iob_s *g_iob_freelist;
 
 extern FAR struct iob_s *g_iob_committed;
 
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+/* A list of all free small I/O buffers.  They are not counted by the
+ * semaphores and nobody waits for them.
+ */
+
+extern FAR struct iob_s *g_iob_smallfree;
+#endif
+
 #if CONFIG_IOB_NCHAINS > 0
 /* A list of all free, unallocated I/O buffer queue containers */
 
@@ -245,6 +245,92 @@ FAR struct iob_s *iob_alloc(bool throttled)
   return iob_timedalloc(throttled, UINT_MAX);
 }
 
+/****************************************************************************
+ * Name: iob_tryalloc_small
+ *
+ * Description:
+ *   Take a small I/O buffer from its free list, if there is one.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+static FAR struct iob_s *iob_tryalloc_small(void)
+{
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  iob = g_iob_smallfree;
+  if (iob != NULL)
+    {
+      g_iob_smallfree = iob->io_flink;
+    }
+
+  leave_critical_section(flags);
+
+  if (iob != NULL)
+    {
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+    }
+
+  return iob;
+}
+#endif
+
+/****************************************************************************
+ * Name: iob_alloc_size
+ *
+ * Description:
+ *   Allocate an I/O buffer that is large enough for 'size' bytes, a small
+ *   one if possible.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_size(bool throttled, unsigned int size)
+{
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+  FAR struct iob_s *iob;
+
+  if (size <= CONFIG_IOB_SMALL_BUFSIZE &&
+      (iob = iob_tryalloc_small()) != NULL)
+    {
+      return iob;
+    }
+#endif
+
+  return iob_alloc(throttled);
+}
+
+/****************************************************************************
+ * Name: iob_tryalloc_size
+ *
+ * Description:
+ *   Try to allocate an I/O buffer that is large enough for 'size' bytes, a
+ *   small one if possible, without waiting.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_size(bool throttled, unsigned int size)
+{
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+  FAR struct iob_s *iob;
+
+  if (size <= CONFIG_IOB_SMALL_BUFSIZE &&
+      (iob = iob_tryalloc_small()) != NULL)
+    {
+      return iob;
+    }
+#endif
+
+  return iob_tryalloc(throttled);
+}
+
 /****************************************************************************
  * Name: iob_tryalloc
  *
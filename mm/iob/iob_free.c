@@ -34,30 +34,6 @@
 
 #include "iob.h"
 
-/****************************************************************************
- * Pre-processor Definitions
- ****************************************************************************/
-
-#ifdef CONFIG_IOB_NOTIFIER
-#  if !defined(CONFIG_IOB_NOTIFIER_DIV) || CONFIG_IOB_NOTIFIER_DIV < 2
-#    define IOB_DIVIDER 1
-#  elif CONFIG_IOB_NOTIFIER_DIV < 4
-#    define IOB_DIVIDER 2
-#  elif CONFIG_IOB_NOTIFIER_DIV < 8
-#    define IOB_DIVIDER 4
-#  elif CONFIG_IOB_NOTIFIER_DIV < 16
-#    define IOB_DIVIDER 8
-#  elif CONFIG_IOB_NOTIFIER_DIV < 32
-#    define IOB_DIVIDER 16
-#  elif CONFIG_IOB_NOTIFIER_DIV < 64
-#    define IOB_DIVIDER 32
-#  else
-#    define IOB_DIVIDER 64
-#  endif
-#endif
-
-#define IOB_MASK      (IOB_DIVIDER - 1)
-
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -112,6 +88,20 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
               next, next->io_pktlen, next->io_len);
     }
 
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+  /* Small I/O buffers only go back to their own free list */
+
+  if (IOB_BUFSIZE(iob) != CONFIG_IOB_BUFSIZE)
+    {
+      flags = enter_critical_section();
+      iob->io_flink   = g_iob_smallfree;
+      g_iob_smallfree = iob;
+      leave_critical_section(flags);
+
+      return next;
+    }
+#endif
+
   /* Free the I/O buffer by adding it to the head of the free or the
    * committed list. We don't know what context we are called from so
    * we use extreme measures to protect the free list:  We disable
@@ -24,7 +24,11 @@
 
 #include <nuttx/config.h>
 
+#include <assert.h>
+
 #include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/queue.h>
 #include <nuttx/mm/iob.h>
 
 #include "iob.h"
@@ -44,9 +48,79 @@
 
 void iob_free_chain(FAR struct iob_s *iob)
 {
+  FAR struct iob_s *tail;
   FAR struct iob_s *next;
+  irqstate_t flags;
+  int16_t navail;
+  int16_t nfree;
+
+  if (iob == NULL)
+    {
+      return;
+    }
+
+  for (tail = iob, nfree = 1; tail->io_flink != NULL; nfree++)
+    {
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+      if (IOB_BUFSIZE(tail) != CONFIG_IOB_BUFSIZE)
+        {
+          break;
+        }
+#endif
+
+      tail = tail->io_flink;
+    }
+
+  flags = enter_critical_section();
+
+  /* If no thread waits for an IOB and the chain holds no small IOB, the
+   * whole chain goes back to the free list at once and the counts are
+   * given without waking anyone, just as the same number of calls to
+   * iob_free() would do.
+   */
+
+  if (g_iob_sem.semcount >= 0
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+      && tail->io_flink == NULL && IOB_BUFSIZE(tail) == CONFIG_IOB_BUFSIZE
+#endif
+#if CONFIG_IOB_THROTTLE > 0
+      && dq_empty(SEM_WAITLIST(&g_throttle_sem))
+#endif
+     )
+    {
+      navail          = g_iob_sem.semcount;
+      tail->io_flink  = g_iob_freelist;
+      g_iob_freelist  = iob;
+
+      g_iob_sem.semcount += nfree;
+      DEBUGASSERT(g_iob_sem.semcount <= CONFIG_IOB_NBUFFERS);
+
+#if CONFIG_IOB_THROTTLE > 0
+      g_throttle_sem.semcount += nfree;
+      DEBUGASSERT(g_throttle_sem.semcount <=
+                  (CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE));
+#endif
+
+#ifdef CONFIG_IOB_NOTIFIER
+      /* Signal once if the count passed a multiple of IOB_DIVIDER */
+
+      if ((navail & ~IOB_MASK) != (g_iob_sem.semcount & ~IOB_MASK))
+        {
+          iob_notifier_signal();
+        }
+#else
+      UNUSED(navail);
+#endif
+
+      leave_critical_section(flags);
+      return;
+    }
+
+  leave_critical_section(flags);
 
-  /* Free each IOB in the chain -- one at a time to keep the count straight */
+  /* Otherwise free each IOB in the chain -- one at a time so that the
+   * waiters are served from the committed list.
+   */
 
   for (; iob; iob = next)
     {
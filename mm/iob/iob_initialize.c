@@ -42,6 +42,18 @@
 #define IOB_BUFFER_SIZE   (IOB_ALIGN_SIZE * CONFIG_IOB_NBUFFERS + \
                            CONFIG_IOB_ALIGNMENT - 1)
 
+/* A small I/O buffer is an iob_s cut short after its io_data[] */
+
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+#  define IOB_SMALL_ALIGN_SIZE \
+          ROUNDUP(ROUNDUP(offsetof(struct iob_s, io_data) + \
+                          CONFIG_IOB_SMALL_BUFSIZE, sizeof(uintptr_t)), \
+                  CONFIG_IOB_ALIGNMENT)
+#  define IOB_SMALL_BUFFER_SIZE \
+          (IOB_SMALL_ALIGN_SIZE * CONFIG_IOB_SMALL_NBUFFERS + \
+           CONFIG_IOB_ALIGNMENT - 1)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -57,6 +69,15 @@ static uint8_t g_iob_buffer[IOB_BUFFER_SIZE] locate_data(IOB_SECTION);
 static uint8_t g_iob_buffer[IOB_BUFFER_SIZE];
 #endif
 
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+#  ifdef IOB_SECTION
+static uint8_t g_iob_smallbuffer[IOB_SMALL_BUFFER_SIZE]
+               locate_data(IOB_SECTION);
+#  else
+static uint8_t g_iob_smallbuffer[IOB_SMALL_BUFFER_SIZE];
+#  endif
+#endif
+
 #if CONFIG_IOB_NCHAINS > 0
 /* This is a pool of pre-allocated iob_qentry_s buffers */
 
@@ -75,6 +96,12 @@ FAR struct iob_s *g_iob_freelist;
 
 FAR struct iob_s *g_iob_committed;
 
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+/* A list of all free small I/O buffers */
+
+FAR struct iob_s *g_iob_smallfree;
+#endif
+
 #if CONFIG_IOB_NCHAINS > 0
 /* A list of all free, unallocated I/O buffer queue containers */
 
@@ -136,9 +163,30 @@ void iob_initialize(void)
 
       /* Add the pre-allocate I/O buffer to the head of the free list */
 
-      iob->io_flink  = g_iob_freelist;
-      g_iob_freelist = iob;
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+      iob->io_bufsize = CONFIG_IOB_BUFSIZE;
+#endif
+      iob->io_flink   = g_iob_freelist;
+      g_iob_freelist  = iob;
+    }
+
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+  /* The small I/O buffers are laid out the same way in their own pool */
+
+  buf = ROUNDUP((uintptr_t)g_iob_smallbuffer +
+                offsetof(struct iob_s, io_data),
+                CONFIG_IOB_ALIGNMENT) - offsetof(struct iob_s, io_data);
+
+  for (i = 0; i < CONFIG_IOB_SMALL_NBUFFERS; i++)
+    {
+      FAR struct iob_s *iob =
+        (FAR struct iob_s *)(buf + i * IOB_SMALL_ALIGN_SIZE);
+
+      iob->io_bufsize = CONFIG_IOB_SMALL_BUFSIZE;
+      iob->io_flink   = g_iob_smallfree;
+      g_iob_smallfree = iob;
     }
+#endif
 
 #if CONFIG_IOB_NCHAINS > 0
   /* Add each I/O buffer chain queue container to the free list */
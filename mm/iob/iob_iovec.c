@@ -0,0 +1,69 @@
+/****************************************************************************
+ * mm/iob/iob_iovec.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/uio.h>
+#include <errno.h>
+
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_iovec
+ *
+ * Description:
+ *   Describe the data of an I/O buffer chain as a list of segments, one per
+ *   non-empty IOB, without copying it.
+ *
+ ****************************************************************************/
+
+int iob_iovec(FAR struct iob_s *iob, FAR struct iovec *iov, int iovcnt)
+{
+  int count = 0;
+
+  for (; iob != NULL; iob = iob->io_flink)
+    {
+      if (iob->io_len == 0)
+        {
+          continue;
+        }
+
+      if (count >= iovcnt)
+        {
+          return -E2BIG;
+        }
+
+      iov[count].iov_base = IOB_DATA(iob);
+      iov[count].iov_len  = iob->io_len;
+      count++;
+    }
+
+  return count;
+}
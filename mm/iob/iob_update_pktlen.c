@@ -47,79 +47,54 @@
 int iob_update_pktlen(FAR struct iob_s *iob, unsigned int pktlen,
                       bool throttled)
 {
-  FAR struct iob_s *penultimate;
+  FAR struct iob_s *penultimate = NULL;
   FAR struct iob_s *next;
-  uint16_t offset = 0;
-  int ninqueue = 0;
-  int nrequire;
+  unsigned int capacity = 0;
   uint16_t len;
 
-  /* The data offset must be less than CONFIG_IOB_BUFSIZE */
-
   if (iob == NULL)
     {
       return -EINVAL;
     }
 
-  /* Calculate the total entries of the data in the I/O buffer chain */
+  /* Find the entry that will hold the end of the data.  The entries may
+   * be of different sizes, so count the space that each one offers.
+   */
 
   next = iob;
   while (next != NULL)
     {
-      ninqueue++;
-      offset += next->io_offset;
+      capacity   += IOB_BUFSIZE(next) - next->io_offset;
       penultimate = next;
-      next = next->io_flink;
+      next        = next->io_flink;
+
+      if (capacity >= pktlen)
+        {
+          break;
+        }
     }
 
-  /* Trim inqueue entries if needed */
+  /* Trim the entries after it, if any */
 
-  nrequire = (pktlen + offset + CONFIG_IOB_BUFSIZE - 1) /
-             CONFIG_IOB_BUFSIZE;
-  if (nrequire == 0)
+  if (next != NULL)
     {
-      nrequire = 1;
+      penultimate->io_flink = NULL;
+      iob_free_chain(next);
     }
 
-  if (nrequire < ninqueue)
-    {
-      /* Loop until complete the trim */
-
-      next = iob;
-      penultimate = NULL;
+  /* Or extend the chain from the last entry */
 
-      while (next != NULL)
-        {
-          if (nrequire-- <= 0)
-            {
-              if (penultimate != NULL)
-                {
-                  penultimate->io_flink = NULL;
-                }
-
-              iob_free_chain(next);
-              break;
-            }
-          else
-            {
-              penultimate = next;
-              next = next->io_flink;
-            }
-        }
-    }
-  else if (nrequire > ninqueue)
+  else
     {
-      /* Start from the last IOB */
-
       next = penultimate;
-
-      /* Loop to extend the link */
-
-      while (next != NULL && nrequire > ninqueue)
+      while (next != NULL && capacity < pktlen)
         {
           next->io_flink = iob_tryalloc(throttled);
           next = next->io_flink;
-          ninqueue++;
+          if (next != NULL)
+            {
+              capacity += IOB_BUFSIZE(next);
+            }
         }
     }
 
@@ -130,9 +105,9 @@ int iob_update_pktlen(FAR struct iob_s *iob, unsigned int pktlen,
   next = iob;
   while (next != NULL && pktlen > 0)
     {
-      if (pktlen + next->io_offset > CONFIG_IOB_BUFSIZE)
+      if (pktlen + next->io_offset > IOB_BUFSIZE(next))
         {
-          len = CONFIG_IOB_BUFSIZE - next->io_offset;
+          len = IOB_BUFSIZE(next) - next->io_offset;
         }
       else
         {
@@ -50,6 +50,14 @@
 #define KASAN_REGION_SIZE(size) \
   (sizeof(struct kasan_region_s) + KASAN_SHADOW_SIZE(size))
 
+/* Shadow bits covered by an aligned access of 1, 2, 4, 8 or 16 bytes.
+ * Thanks to the alignment they are always in the same shadow word.
+ */
+
+#define KASAN_ACCESS_MASK(size) \
+  ((size) > KASAN_SHADOW_SCALE ? \
+   ((uintptr_t)1 << ((size) / KASAN_SHADOW_SCALE)) - 1 : (uintptr_t)1)
+
 #define KASAN_INIT_VALUE            0xDEADCAFE
 
 /****************************************************************************
@@ -76,8 +84,8 @@ static uint32_t g_region_init;
  * Private Functions
  ****************************************************************************/
 
-static FAR uintptr_t *kasan_mem_to_shadow(FAR const void *ptr, size_t size,
-                                          unsigned int *bit)
+static always_inline_function FAR uintptr_t *
+kasan_mem_to_shadow(FAR const void *ptr, size_t size, FAR unsigned int *bit)
 {
   FAR struct kasan_region_s *region;
   uintptr_t addr = (uintptr_t)ptr;
@@ -102,7 +110,8 @@ static FAR uintptr_t *kasan_mem_to_shadow(FAR const void *ptr, size_t size,
   return NULL;
 }
 
-static void kasan_report(FAR const void *addr, size_t size, bool is_write)
+static noinline_function void kasan_report(FAR const void *addr,
+                                           size_t size, bool is_write)
 {
   static int recursion;
 
@@ -117,13 +126,69 @@ static void kasan_report(FAR const void *addr, size_t size, bool is_write)
   --recursion;
 }
 
+/* Check every shadow bit of an access of any size and alignment */
+
 static bool kasan_is_poisoned(FAR const void *addr, size_t size)
+{
+  FAR uintptr_t *first;
+  FAR uintptr_t *last;
+  unsigned int bit;
+  unsigned int lbit;
+  uintptr_t mask;
+
+  if (size == 0)
+    {
+      return false;
+    }
+
+  first = kasan_mem_to_shadow(addr, size, &bit);
+  if (first == NULL)
+    {
+      return false;
+    }
+
+  last = kasan_mem_to_shadow((FAR const char *)addr + size - 1, 1, &lbit);
+  mask = KASAN_FIRST_WORD_MASK(bit);
+
+  for (; first < last; first++)
+    {
+      if ((*first & mask) != 0)
+        {
+          return true;
+        }
+
+      mask = UINTPTR_MAX;
+    }
+
+  mask &= KASAN_LAST_WORD_MASK(lbit + 1);
+  return (*first & mask) != 0;
+}
+
+/* The check behind the sized entry points called by the instrumentation.
+ * The size is a constant there, so an aligned access costs one region
+ * lookup and one mask test without further calls.
+ */
+
+static always_inline_function void kasan_check(FAR const void *addr,
+                                               size_t size, bool is_write)
 {
   FAR uintptr_t *p;
   unsigned int bit;
 
-  p = kasan_mem_to_shadow(addr + size - 1, 1, &bit);
-  return p && ((*p >> bit) & 1);
+  if (((uintptr_t)addr & (size - 1)) == 0)
+    {
+      p = kasan_mem_to_shadow(addr, size, &bit);
+      if (p == NULL || (*p & (KASAN_ACCESS_MASK(size) << bit)) == 0)
+        {
+          return;
+        }
+    }
+  else if (!kasan_is_poisoned(addr, size))
+    {
+      return;
+    }
+
+  kasan_report(addr, size, is_write);
 }
 
 static void kasan_set_poison(FAR const void *addr, size_t size,
@@ -137,8 +202,14 @@ static void kasan_set_poison(FAR const void *addr, size_t size,
 
   flags = spin_lock_irqsave(&g_lock);
 
+  /* The memory of a heap that is not checked has no shadow */
+
   p = kasan_mem_to_shadow(addr, size, &bit);
-  DEBUGASSERT(p != NULL);
+  if (p == NULL)
+    {
+      spin_unlock_irqrestore(&g_lock, flags);
+      return;
+    }
 
   nbit = KASAN_BITS_PER_WORD - bit % KASAN_BITS_PER_WORD;
   mask = KASAN_FIRST_WORD_MASK(bit);
@@ -279,27 +350,27 @@ void __asan_storeN(FAR void *addr, size_t size)
 #define DEFINE_ASAN_LOAD_STORE(size) \
   void __asan_report_load##size##_noabort(FAR void *addr) \
   { \
-    __asan_report_load_n_noabort(addr, size); \
+    kasan_report(addr, size, false); \
   } \
   void __asan_report_store##size##_noabort(FAR void *addr) \
   { \
-    __asan_report_store_n_noabort(addr, size); \
+    kasan_report(addr, size, true); \
   } \
   void __asan_load##size##_noabort(FAR void *addr) \
   { \
-    __asan_loadN_noabort(addr, size); \
+    kasan_check(addr, size, false); \
   } \
   void __asan_store##size##_noabort(FAR void *addr) \
   { \
-    __asan_storeN_noabort(addr, size); \
+    kasan_check(addr, size, true); \
   } \
   void __asan_load##size(FAR void *addr) \
   { \
-    __asan_load##size##_noabort(addr); \
+    kasan_check(addr, size, false); \
   } \
   void __asan_store##size(FAR void *addr) \
   { \
-    __asan_store##size##_noabort(addr); \
+    kasan_check(addr, size, true); \
   }
 
 DEFINE_ASAN_LOAD_STORE(1)
@@ -58,7 +58,17 @@ FAR struct mm_heap_s *g_kmmheap;
 
 void kmm_initialize(FAR void *heap_start, size_t heap_size)
 {
-  g_kmmheap = mm_initialize("Kmem", heap_start, heap_size);
+  struct mm_heap_config_s config =
+  {
+    .name    = "Kmem",
+    .start   = heap_start,
+    .size    = heap_size,
+#ifndef CONFIG_MM_KASAN_KMM
+    .nokasan = true,
+#endif
+  };
+
+  g_kmmheap = mm_initialize_heap(&config);
 }
 
 #endif /* CONFIG_MM_KERNEL_HEAP */
@@ -29,9 +29,11 @@
 
 #include <nuttx/mutex.h>
 #include <nuttx/sched.h>
+#include <nuttx/mm/mm.h>
 #include <nuttx/fs/procfs.h>
 #include <nuttx/lib/math32.h>
 #include <nuttx/mm/mempool.h>
+#include <nuttx/wqueue.h>
 
 #include <assert.h>
 #include <sys/types.h>
@@ -45,6 +47,16 @@
 
 /* Configuration ************************************************************/
 
+/* Only the mm code built into the kernel can queue work.  Whether a heap
+ * uses the worker is decided when the heap is initialized, so the heap
+ * layout is the same in the kernel and in user space.
+ */
+
+#if defined(CONFIG_MM_HEAP_DELAYFREE_WORKER) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define MM_DELAYFREE_WORKER 1
+#endif
+
 /* Chunk Header Definitions *************************************************/
 
 /* These definitions define the characteristics of the allocator:
@@ -106,6 +118,27 @@
 #  define MM_ADD_BACKTRACE(heap, ptr)
 #endif
 
+/* Track the allocated bytes of a heap for its low watermark.  The caller
+ * holds the heap mutex.
+ */
+
+#ifdef CONFIG_MM_HEAP_FRAGINFO
+#  define MM_ADD_USED(heap, size) \
+     do \
+       { \
+         (heap)->mm_curused += (size); \
+         if ((heap)->mm_curused > (heap)->mm_maxused) \
+           { \
+             (heap)->mm_maxused = (heap)->mm_curused; \
+           } \
+       } \
+     while (0)
+#  define MM_SUB_USED(heap, size) ((heap)->mm_curused -= (size))
+#else
+#  define MM_ADD_USED(heap, size)
+#  define MM_SUB_USED(heap, size)
+#endif
+
 /* All other definitions derive from these two */
 
 #define MM_MIN_CHUNK     (1 << MM_MIN_SHIFT)
@@ -203,6 +236,11 @@ static_assert(MM_ALIGN >= sizeof(uintptr_t) &&
               (MM_ALIGN & MM_GRAN_MASK) == 0,
               "Error memory aligment\n");
 
+#ifdef CONFIG_MM_HEAP_FRAGINFO
+static_assert(MM_NNODES <= MM_FRAGINFO_NBINS,
+              "Error too many free lists for mm_fraginfo\n");
+#endif
+
 struct mm_delaynode_s
 {
   FAR struct mm_delaynode_s *flink;
@@ -238,18 +276,39 @@ struct mm_heap_s
 
   struct mm_freenode_s mm_nodelist[MM_NNODES];
 
+#ifdef CONFIG_MM_HEAP_FRAGINFO
+  /* The allocated bytes, including the guard nodes, now and at most */
+
+  size_t mm_curused;
+  size_t mm_maxused;
+#endif
+
   /* Free delay list, for some situations where we can't do free
    * immdiately.
    */
 
   FAR struct mm_delaynode_s *mm_delaylist[CONFIG_SMP_NCPUS];
 
+#ifdef CONFIG_MM_HEAP_DELAYFREE_WORKER
+  /* The worker draining the delay lists, and its statistics */
+
+  bool mm_delayworker;
+  struct work_s mm_delaywork;
+  struct mm_delayfree_stats_s mm_delaystats;
+#endif
+
   /* The is a multiple mempool of the heap */
 
 #if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
   FAR struct mempool_multiple_s *mm_mpool;
 #endif
 
+#ifdef CONFIG_MM_KASAN
+  /* The regions of the heap are not registered to KASan */
+
+  bool mm_nokasan;
+#endif
+
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
   struct procfs_meminfo_entry_s mm_procfs;
 #endif
@@ -283,6 +342,19 @@ void mm_addfreechunk(FAR struct mm_heap_s *heap,
 
 int mm_size2ndx(size_t size);
 
+/* Functions contained in mm_malloc.c ***************************************/
+
+#ifdef MM_DELAYFREE_WORKER
+void mm_delayfree_kick(FAR struct mm_heap_s *heap);
+#endif
+
+/* Functions contained in mm_tcache.c ***************************************/
+
+#ifdef CONFIG_MM_HEAP_TCACHE
+FAR void *mm_tcache_alloc(FAR struct mm_heap_s *heap, size_t size);
+bool mm_tcache_free(FAR struct mm_heap_s *heap, FAR void *mem);
+#endif
+
 /* Functions contained in mm_foreach.c **************************************/
 
 void mm_foreach(FAR struct mm_heap_s *heap, mm_node_handler_t handler,
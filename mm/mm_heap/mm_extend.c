@@ -109,6 +109,12 @@ void mm_extend(FAR struct mm_heap_s *heap, FAR void *mem, size_t size,
   /* Finally, increase the total heap size accordingly */
 
   heap->mm_heapsize += size;
+
+  /* The new block is counted as allocated until it is freed below, the old
+   * terminal node is replaced by the new one.
+   */
+
+  MM_ADD_USED(heap, size);
   mm_unlock(heap);
 
   /* Finally "free" the new block of memory where the old terminal node was
@@ -50,6 +50,25 @@ static void add_delaylist(FAR struct mm_heap_s *heap, FAR void *mem)
   tmp->flink = heap->mm_delaylist[up_cpu_index()];
   heap->mm_delaylist[up_cpu_index()] = tmp;
 
+#ifdef CONFIG_MM_HEAP_DELAYFREE_WORKER
+  heap->mm_delaystats.ndelayed++;
+  if (++heap->mm_delaystats.npending > heap->mm_delaystats.maxpending)
+    {
+      heap->mm_delaystats.maxpending = heap->mm_delaystats.npending;
+    }
+#endif
+
+#ifdef MM_DELAYFREE_WORKER
+  /* The work cannot be queued while the ready-to-run list is in flux.
+   * Blocks delayed by a context switch are picked up by the next kick.
+   */
+
+  if (up_interrupt_context())
+    {
+      mm_delayfree_kick(heap);
+    }
+#endif
+
   leave_critical_section(flags);
 #endif
 }
@@ -86,6 +105,13 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
 
   DEBUGASSERT(mm_heapmember(heap, mem));
 
+#ifdef CONFIG_MM_HEAP_TCACHE
+  if (mm_tcache_free(heap, mem))
+    {
+      return;
+    }
+#endif
+
 #if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
   if (mempool_multiple_free(heap->mm_mpool, mem) >= 0)
     {
@@ -110,6 +136,7 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
 
   node = (FAR struct mm_freenode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
   nodesize = SIZEOF_MM_NODE(node);
+  MM_SUB_USED(heap, nodesize);
 
   /* Sanity check against double-frees */
 
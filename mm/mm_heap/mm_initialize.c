@@ -131,7 +131,12 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
 
   /* Register to KASan for access check */
 
-  kasan_register(heapstart, &heapsize);
+#ifdef CONFIG_MM_KASAN
+  if (!heap->mm_nokasan)
+    {
+      kasan_register(heapstart, &heapsize);
+    }
+#endif
 
   DEBUGVERIFY(mm_lock(heap));
 
@@ -181,6 +186,7 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
                                      MM_PREVFREE_BIT;
   heap->mm_heapend[IDX]->preceding = node->size;
   MM_ADD_BACKTRACE(heap, heap->mm_heapend[IDX]);
+  MM_ADD_USED(heap, 2 * SIZEOF_MM_ALLOCNODE);
 
 #undef IDX
 
@@ -217,6 +223,38 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
 FAR struct mm_heap_s *mm_initialize(FAR const char *name,
                                     FAR void *heapstart, size_t heapsize)
 {
+  struct mm_heap_config_s config =
+  {
+    .name  = name,
+    .start = heapstart,
+    .size  = heapsize,
+  };
+
+  return mm_initialize_heap(&config);
+}
+
+/****************************************************************************
+ * Name: mm_initialize_heap
+ *
+ * Description:
+ *   Initialize a heap like mm_initialize(), with the options of the
+ *   configuration.  KASan does not check and keeps no shadow for the
+ *   regions of a heap that is configured with nokasan.
+ *
+ * Input Parameters:
+ *   config - The description of the heap
+ *
+ * Returned Value:
+ *   Return the address of a new heap instance.
+ *
+ ****************************************************************************/
+
+FAR struct mm_heap_s *
+mm_initialize_heap(FAR const struct mm_heap_config_s *config)
+{
+  FAR const char       *name      = config->name;
+  FAR void             *heapstart = config->start;
+  size_t                heapsize  = config->size;
 #if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
   size_t poolsize[MEMPOOL_NPOOLS];
 #endif
@@ -244,6 +282,19 @@ FAR struct mm_heap_s *mm_initialize(FAR const char *name,
 
   memset(heap, 0, sizeof(struct mm_heap_s));
 
+#ifdef CONFIG_MM_KASAN
+  heap->mm_nokasan = config->nokasan;
+#endif
+
+#ifdef MM_DELAYFREE_WORKER
+  /* A heap initialized by the kernel has its delay lists drained by the
+   * worker.  The kernel side of a user space heap drains them on malloc(),
+   * like user space does.
+   */
+
+  heap->mm_delayworker = true;
+#endif
+
   /* Initialize the node array */
 
   for (i = 1; i < MM_NNODES; i++)
@@ -314,6 +365,13 @@ FAR struct mm_heap_s *mm_initialize(FAR const char *name,
 
 void mm_uninitialize(FAR struct mm_heap_s *heap)
 {
+#ifdef MM_DELAYFREE_WORKER
+  if (heap->mm_delayworker)
+    {
+      work_cancel(LPWORK, &heap->mm_delaywork);
+    }
+#endif
+
 #if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
   mempool_multiple_deinit(heap->mm_mpool);
 #endif
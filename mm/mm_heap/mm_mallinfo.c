@@ -26,7 +26,9 @@
 
 #include <assert.h>
 #include <debug.h>
+#include <string.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/mm/mm.h>
 
 #include "mm_heap/mm.h"
@@ -159,6 +161,95 @@ struct mallinfo mm_mallinfo(FAR struct mm_heap_s *heap)
   return info;
 }
 
+/****************************************************************************
+ * Name: mm_delayfree_stats
+ *
+ * Description:
+ *   Return the statistics of the delayed frees of a heap.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_DELAYFREE_WORKER
+void mm_delayfree_stats(FAR struct mm_heap_s *heap,
+                        FAR struct mm_delayfree_stats_s *stats)
+{
+#ifdef MM_DELAYFREE_WORKER
+  irqstate_t flags;
+
+  DEBUGASSERT(heap != NULL && stats != NULL);
+
+  flags = enter_critical_section();
+  *stats = heap->mm_delaystats;
+  leave_critical_section(flags);
+#else
+  /* A user space heap drains its delay list on malloc() */
+
+  DEBUGASSERT(stats != NULL);
+  memset(stats, 0, sizeof(*stats));
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: mm_fraginfo
+ *
+ * Description:
+ *   Return the distribution of the free chunks of a heap over the free list
+ *   bins, its external fragmentation and the low watermark of its free
+ *   memory.  Chunks held by the mempools of the heap count as allocated.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_FRAGINFO
+void mm_fraginfo(FAR struct mm_heap_s *heap,
+                 FAR struct mm_fraginfo_s *info)
+{
+  FAR struct mm_freenode_s *node;
+  size_t largest = 0;
+  size_t total = 0;
+  int ndx;
+
+  DEBUGASSERT(heap != NULL && info != NULL);
+
+  memset(info, 0, sizeof(*info));
+  info->minshift = MM_MIN_SHIFT;
+  info->nbins    = MM_NNODES;
+
+  DEBUGVERIFY(mm_lock(heap));
+
+  /* Each bin is a sorted section of the free list that ends at the head of
+   * the next bin, which has a size of zero.
+   */
+
+  for (ndx = 0; ndx < MM_NNODES; ndx++)
+    {
+      for (node = heap->mm_nodelist[ndx].flink;
+           node != NULL && node->size != 0;
+           node = node->flink)
+        {
+          size_t nodesize = SIZEOF_MM_NODE(node);
+
+          info->nchunks[ndx]++;
+          info->nbytes[ndx] += nodesize;
+          total += nodesize;
+          if (nodesize > largest)
+            {
+              largest = nodesize;
+            }
+        }
+    }
+
+  info->lowfree = heap->mm_heapsize - heap->mm_maxused;
+
+  mm_unlock(heap);
+
+  if (total > 0)
+    {
+      info->fragindex = (uint64_t)(total - largest) * 1000 / total;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: mm_mallinfo_task
  *
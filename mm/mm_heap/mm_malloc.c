@@ -26,6 +26,7 @@
 
 #include <assert.h>
 #include <debug.h>
+#include <stdint.h>
 #include <string.h>
 
 #include <nuttx/arch.h>
@@ -39,18 +40,34 @@
  * Private Functions
  ****************************************************************************/
 
-static void free_delaylist(FAR struct mm_heap_s *heap)
+static size_t free_delaylist(FAR struct mm_heap_s *heap, size_t limit)
 {
+  size_t count = 0;
 #if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
-  FAR struct mm_delaynode_s *tmp;
+  FAR struct mm_delaynode_s *tmp = NULL;
+  FAR struct mm_delaynode_s *node;
   irqstate_t flags;
+  int cpu;
 
-  /* Move the delay list to local */
+  /* Move up to 'limit' delayed blocks to a local list */
 
   flags = enter_critical_section();
 
-  tmp = heap->mm_delaylist[up_cpu_index()];
-  heap->mm_delaylist[up_cpu_index()] = NULL;
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      while (count < limit && (node = heap->mm_delaylist[cpu]) != NULL)
+        {
+          heap->mm_delaylist[cpu] = node->flink;
+          node->flink = tmp;
+          tmp = node;
+          count++;
+        }
+    }
+
+#ifdef CONFIG_MM_HEAP_DELAYFREE_WORKER
+  heap->mm_delaystats.npending -= count;
+  heap->mm_delaystats.ndrained += count;
+#endif
 
   leave_critical_section(flags);
 
@@ -72,7 +89,26 @@ static void free_delaylist(FAR struct mm_heap_s *heap)
       mm_free(heap, address);
     }
 #endif
+
+  return count;
+}
+
+#ifdef MM_DELAYFREE_WORKER
+static void mm_delayfree_worker(FAR void *arg)
+{
+  FAR struct mm_heap_s *heap = arg;
+
+  heap->mm_delaystats.nruns++;
+
+  /* Give the work queue to other work between the batches */
+
+  if (free_delaylist(heap, CONFIG_MM_HEAP_DELAYFREE_BATCH) ==
+      CONFIG_MM_HEAP_DELAYFREE_BATCH)
+    {
+      mm_delayfree_kick(heap);
+    }
 }
+#endif
 
 #if CONFIG_MM_BACKTRACE >= 0
 void mm_dump_handler(FAR struct tcb_s *tcb, FAR void *arg)
@@ -105,6 +141,27 @@ void mm_mempool_dump_handle(FAR struct mempool_s *pool, FAR void *arg)
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: mm_delayfree_kick
+ *
+ * Description:
+ *   Queue the worker that drains the delay lists if the heap uses it,
+ *   blocks are waiting and it is not queued yet.  Must not be called during
+ *   a context switch.
+ *
+ ****************************************************************************/
+
+#ifdef MM_DELAYFREE_WORKER
+void mm_delayfree_kick(FAR struct mm_heap_s *heap)
+{
+  if (heap->mm_delayworker && heap->mm_delaystats.npending != 0 &&
+      work_available(&heap->mm_delaywork))
+    {
+      work_queue(LPWORK, &heap->mm_delaywork, mm_delayfree_worker, heap, 0);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: mm_malloc
  *
@@ -122,11 +179,39 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
   size_t alignsize;
   size_t nodesize;
   FAR void *ret = NULL;
+#ifdef MM_DELAYFREE_WORKER
+  bool drained = false;
+#endif
   int ndx;
 
-  /* Free the delay list first */
+#ifdef CONFIG_MM_HEAP_TCACHE
+  /* Small blocks freed by this thread are reused without any lock */
+
+  ret = mm_tcache_alloc(heap, size);
+  if (ret != NULL)
+    {
+      return ret;
+    }
+#endif
+
+#ifdef MM_DELAYFREE_WORKER
+  /* The delay list is drained by the worker, unless memory runs out */
 
-  free_delaylist(heap);
+  if (heap->mm_delayworker)
+    {
+      mm_delayfree_kick(heap);
+    }
+  else
+#endif
+    {
+      /* Free the delay list first */
+
+      free_delaylist(heap, SIZE_MAX);
+    }
+
+#ifdef MM_DELAYFREE_WORKER
+retry:
+#endif
 
 #if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
   ret = mempool_multiple_alloc(heap->mm_mpool, size);
@@ -249,12 +334,22 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       /* Handle the case of an exact size match */
 
       node->size |= MM_ALLOC_BIT;
+      MM_ADD_USED(heap, SIZEOF_MM_NODE(node));
       ret = (FAR void *)((FAR char *)node + SIZEOF_MM_ALLOCNODE);
     }
 
   DEBUGASSERT(ret == NULL || mm_heapmember(heap, ret));
   mm_unlock(heap);
 
+#ifdef MM_DELAYFREE_WORKER
+  if (ret == NULL && heap->mm_delayworker && !drained &&
+      free_delaylist(heap, SIZE_MAX) > 0)
+    {
+      drained = true;
+      goto retry;
+    }
+#endif
+
   if (ret)
     {
       MM_ADD_BACKTRACE(heap, node);
@@ -190,6 +190,8 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
           precedingsize = (uintptr_t)newnode - (uintptr_t)node;
         }
 
+      MM_SUB_USED(heap, precedingsize);
+
       /* If the previous node is free, merge node and previous node, then
        * set up the node size.
        */
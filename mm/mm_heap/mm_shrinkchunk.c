@@ -96,6 +96,7 @@ void mm_shrinkchunk(FAR struct mm_heap_s *heap,
       newnode->size        = nextsize + nodesize - size;
       node->size           = size | (node->size & MM_MASK_BIT);
       andbeyond->preceding = newnode->size;
+      MM_SUB_USED(heap, nodesize - size);
 
       /* Add the new node to the freenodelist */
 
@@ -122,6 +123,7 @@ void mm_shrinkchunk(FAR struct mm_heap_s *heap,
       node->size      = size | (node->size & MM_MASK_BIT);
       next->size     |= MM_PREVFREE_BIT;
       next->preceding = newnode->size;
+      MM_SUB_USED(heap, nodesize - size);
 
       /* Add the new node to the freenodelist */
 
@@ -0,0 +1,274 @@
+/****************************************************************************
+ * mm/mm_heap/mm_tcache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/init.h>
+#include <nuttx/sched.h>
+#include <nuttx/mm/mm.h>
+
+#include "mm_heap/mm.h"
+
+#ifdef CONFIG_MM_HEAP_TCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Size class n holds blocks that can satisfy any request of up to
+ * (n + 1) * MM_ALIGN bytes.
+ */
+
+#define MM_TCACHE_NCLASSES   (CONFIG_MM_HEAP_TCACHE_MAXSIZE / MM_ALIGN)
+#define MM_TCACHE_NDX(size)  ((size) > 0 ? ((size) - 1) / MM_ALIGN : 0)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The cache of one thread.  It is only used by the thread that owns it and
+ * is released with its TCB, so it needs no lock.  'busy' stops a signal
+ * handler that allocates from using the lists while they are modified.
+ */
+
+struct mm_tcache_s
+{
+  FAR struct mm_heap_s *heap;               /* The heap of the cached blocks */
+  FAR void *free[MM_TCACHE_NCLASSES];       /* Lists linked by the first word */
+  uint8_t   count[MM_TCACHE_NCLASSES];      /* Number of blocks in each list */
+  volatile bool busy;                       /* The lists are being modified */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Installed while a thread allocates its cache, so that the allocation
+ * itself bypasses the cache.
+ */
+
+static struct mm_tcache_s g_tcache_creating =
+{
+  .busy = true
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tcache_self
+ *
+ * Description:
+ *   Return the TCB of the calling thread if it may use a cache.
+ *
+ ****************************************************************************/
+
+static FAR struct tcb_s *mm_tcache_self(void)
+{
+  if (!OSINIT_OS_READY() || up_interrupt_context())
+    {
+      return NULL;
+    }
+
+  return nxsched_self();
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tcache_alloc
+ *
+ * Description:
+ *   Take a block for a small request from the cache of the calling thread.
+ *   The cache is created by the first small request that is not served,
+ *   which then continues through the heap.
+ *
+ * Returned Value:
+ *   The block, or NULL if the request must be served by the heap.
+ *
+ ****************************************************************************/
+
+FAR void *mm_tcache_alloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  FAR struct mm_tcache_s *tcache;
+  FAR struct tcb_s *tcb;
+  FAR void **blk;
+  int ndx;
+
+  if (size > CONFIG_MM_HEAP_TCACHE_MAXSIZE ||
+      (tcb = mm_tcache_self()) == NULL)
+    {
+      return NULL;
+    }
+
+  tcache = tcb->tcache;
+  if (tcache == NULL)
+    {
+      tcb->tcache = &g_tcache_creating;
+      tcache = mm_zalloc(heap, sizeof(struct mm_tcache_s));
+      if (tcache != NULL)
+        {
+          tcache->heap = heap;
+        }
+
+      tcb->tcache = tcache;
+      return NULL;
+    }
+
+  if (tcache->heap != heap || tcache->busy)
+    {
+      return NULL;
+    }
+
+  tcache->busy = true;
+
+  ndx = MM_TCACHE_NDX(size);
+  blk = tcache->free[ndx];
+  if (blk != NULL)
+    {
+      tcache->free[ndx] = *blk;
+      tcache->count[ndx]--;
+    }
+
+  tcache->busy = false;
+  return blk;
+}
+
+/****************************************************************************
+ * Name: mm_tcache_free
+ *
+ * Description:
+ *   Keep a small block in the cache of the calling thread.
+ *
+ * Returned Value:
+ *   True if the block was cached; false if it must be returned to the heap
+ *   because it is too big, the size class is full or there is no cache.
+ *
+ ****************************************************************************/
+
+bool mm_tcache_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  FAR struct mm_tcache_s *tcache;
+  FAR struct tcb_s *tcb;
+  bool ret = false;
+  size_t size;
+  int ndx;
+
+  tcb = mm_tcache_self();
+  if (tcb == NULL || (tcache = tcb->tcache) == NULL ||
+      tcache->heap != heap || tcache->busy)
+    {
+      return false;
+    }
+
+  /* A block is filed under the largest class that it can fully serve */
+
+  size = mm_malloc_size(heap, mem);
+  if (size < MM_ALIGN)
+    {
+      return false;
+    }
+
+  ndx = size / MM_ALIGN - 1;
+  if (ndx >= MM_TCACHE_NCLASSES)
+    {
+      ndx = MM_TCACHE_NCLASSES - 1;
+    }
+
+  tcache->busy = true;
+
+  if (tcache->count[ndx] < CONFIG_MM_HEAP_TCACHE_COUNT)
+    {
+      *(FAR void **)mem = tcache->free[ndx];
+      tcache->free[ndx] = mem;
+      tcache->count[ndx]++;
+      ret = true;
+    }
+
+  tcache->busy = false;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_tcache_release
+ *
+ * Description:
+ *   Return the blocks of a thread's cache and the cache itself to the heap.
+ *   Called when the TCB of the thread is released.
+ *
+ * Input Parameters:
+ *   tcache - The cache to release
+ *
+ ****************************************************************************/
+
+void mm_tcache_release(FAR struct mm_tcache_s *tcache)
+{
+  FAR struct mm_tcache_s *self = NULL;
+  FAR struct tcb_s *tcb;
+  FAR void **blk;
+  bool busy = false;
+  int ndx;
+
+  DEBUGASSERT(tcache != NULL && !tcache->busy);
+
+  /* The blocks must go back to the heap, not to the cache of the thread
+   * that releases the TCB.
+   */
+
+  tcb = mm_tcache_self();
+  if (tcb != NULL && tcb->tcache != NULL &&
+      tcb->tcache != &g_tcache_creating)
+    {
+      self       = tcb->tcache;
+      busy       = self->busy;
+      self->busy = true;
+    }
+
+  for (ndx = 0; ndx < MM_TCACHE_NCLASSES; ndx++)
+    {
+      while ((blk = tcache->free[ndx]) != NULL)
+        {
+          tcache->free[ndx] = *blk;
+          mm_free(tcache->heap, blk);
+        }
+    }
+
+  mm_free(tcache->heap, tcache);
+
+  /* A thread releasing its own cache must not touch it once it is freed */
+
+  if (self != NULL && self != tcache)
+    {
+      self->busy = busy;
+    }
+}
+
+#endif /* CONFIG_MM_HEAP_TCACHE */
@@ -95,6 +95,12 @@ struct mm_heap_s
   FAR struct mempool_multiple_s *mm_mpool;
 #endif
 
+#ifdef CONFIG_MM_KASAN
+  /* The regions of the heap are not registered to KASan */
+
+  bool mm_nokasan;
+#endif
+
   /* Free delay list, for some situation can't do free immdiately */
 
 #ifdef CONFIG_SMP
@@ -447,6 +453,98 @@ static void memdump_handler(FAR void *ptr, size_t size, int used,
     }
 }
 
+/****************************************************************************
+ * Name: mm_dump_handler
+ ****************************************************************************/
+
+#if defined(CONFIG_MM_DUMP_ON_FAILURE) && CONFIG_MM_BACKTRACE >= 0
+static void mm_dump_handler(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  struct mallinfo_task info;
+  struct malltask task;
+
+  task.pid = tcb ? tcb->pid : PID_MM_LEAK;
+  task.seqmin = 0;
+  task.seqmax = ULONG_MAX;
+  info = mm_mallinfo_task(arg, &task);
+  mwarn("pid:%5d, used:%10d, nused:%10d\n",
+        task.pid, info.uordblks, info.aordblks);
+}
+#endif
+
+/****************************************************************************
+ * Name: mm_mempool_dump_handle
+ ****************************************************************************/
+
+#if defined(CONFIG_MM_DUMP_ON_FAILURE) && CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
+static void mm_mempool_dump_handle(FAR struct mempool_s *pool,
+                                   FAR void *arg)
+{
+  struct mempoolinfo_s info;
+
+  mempool_info(pool, &info);
+  mwarn("%9lu%11lu%9lu%9lu%9lu%9lu\n",
+        info.sizeblks, info.arena, info.aordblks,
+        info.ordblks, info.iordblks, info.nwaiter);
+}
+#endif
+
+/****************************************************************************
+ * Name: mm_alloc_failed
+ *
+ * Description:
+ *   Report an allocation that the heap could not satisfy, like mm_heap
+ *   does.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEBUG_MM
+static void mm_alloc_failed(FAR struct mm_heap_s *heap, size_t size)
+{
+#ifdef CONFIG_MM_DUMP_ON_FAILURE
+  struct mallinfo minfo;
+#  ifdef CONFIG_MM_DUMP_DETAILS_ON_FAILURE
+  struct mm_memdump_s dump =
+  {
+    PID_MM_ALLOC, 0, ULONG_MAX
+  };
+#  endif
+#endif
+
+  if (!MM_INTERNAL_HEAP(heap))
+    {
+      return;
+    }
+
+  mwarn("WARNING: Allocation failed, size %zu\n", size);
+#ifdef CONFIG_MM_DUMP_ON_FAILURE
+  minfo = mm_mallinfo(heap);
+  mwarn("Total:%d, used:%d, free:%d, largest:%d, nused:%d, nfree:%d\n",
+        minfo.arena, minfo.uordblks, minfo.fordblks,
+        minfo.mxordblk, minfo.aordblks, minfo.ordblks);
+#  if CONFIG_MM_BACKTRACE >= 0
+  nxsched_foreach(mm_dump_handler, heap);
+  mm_dump_handler(NULL, heap);
+#  endif
+#  if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
+  mwarn("%11s%9s%9s%9s%9s%9s\n",
+        "bsize", "total", "nused",
+        "nfree", "nifree", "nwaiter");
+  mempool_multiple_foreach(heap->mm_mpool,
+                           mm_mempool_dump_handle, NULL);
+#  endif
+#  ifdef CONFIG_MM_DUMP_DETAILS_ON_FAILURE
+  mm_memdump(heap, &dump);
+#  endif
+#endif
+#ifdef CONFIG_MM_PANIC_ON_FAILURE
+  PANIC();
+#endif
+}
+#else
+#  define mm_alloc_failed(heap, size)
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -491,10 +589,35 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
 
   /* Register to KASan for access check */
 
-  kasan_register(heapstart, &heapsize);
+#ifdef CONFIG_MM_KASAN
+  if (!heap->mm_nokasan)
+    {
+      kasan_register(heapstart, &heapsize);
+    }
+#endif
 
   DEBUGVERIFY(mm_lock(heap));
 
+#if CONFIG_MM_REGIONS > 1
+  /* A region that starts where the previous one ends extends its pool, so
+   * that blocks may span both and no region slot is used.
+   */
+
+  if (idx > 0 && heapstart == heap->mm_heapend[idx - 1])
+    {
+      minfo("Region %d: extended by %zu\n", idx, heapsize);
+
+      tlsf_extend_pool(heap->mm_tlsf, heap->mm_heapstart[idx - 1],
+                       heap->mm_heapend[idx - 1] -
+                       heap->mm_heapstart[idx - 1], heapsize);
+
+      heap->mm_heapsize += heapsize;
+      heap->mm_heapend[idx - 1] += heapsize;
+      mm_unlock(heap);
+      return;
+    }
+#endif
+
   minfo("Region %d: base=%p size=%zu\n", idx + 1, heapstart, heapsize);
 
   /* Add the size of this region to the total size of the heap */
@@ -783,6 +906,37 @@ bool mm_heapmember(FAR struct mm_heap_s *heap, FAR void *mem)
 FAR struct mm_heap_s *mm_initialize(FAR const char *name,
                                     FAR void *heapstart, size_t heapsize)
 {
+  struct mm_heap_config_s config =
+  {
+    .name  = name,
+    .start = heapstart,
+    .size  = heapsize,
+  };
+
+  return mm_initialize_heap(&config);
+}
+
+/****************************************************************************
+ * Name: mm_initialize_heap
+ *
+ * Description:
+ *   Initialize a heap like mm_initialize(), with the options of the
+ *   configuration.
+ *
+ * Input Parameters:
+ *   config - The description of the heap
+ *
+ * Returned Value:
+ *   Return the address of a new heap instance.
+ *
+ ****************************************************************************/
+
+FAR struct mm_heap_s *
+mm_initialize_heap(FAR const struct mm_heap_config_s *config)
+{
+  FAR const char *name = config->name;
+  FAR char *heapstart = config->start;
+  size_t heapsize = config->size;
   FAR struct mm_heap_s *heap;
 #if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
   size_t poolsize[MEMPOOL_NPOOLS];
@@ -796,6 +950,10 @@ FAR struct mm_heap_s *mm_initialize(FAR const char *name,
   DEBUGASSERT(heapsize > sizeof(struct mm_heap_s));
   heap = (FAR struct mm_heap_s *)heapstart;
   memset(heap, 0, sizeof(struct mm_heap_s));
+#ifdef CONFIG_MM_KASAN
+  heap->mm_nokasan = config->nokasan;
+#endif
+
   heapstart += sizeof(struct mm_heap_s);
   heapsize -= sizeof(struct mm_heap_s);
 
@@ -1064,6 +1222,13 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       memdump_backtrace(heap, buf);
 #endif
       kasan_unpoison(ret, mm_malloc_size(heap, ret));
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+      memset(ret, 0xaa, mm_malloc_size(heap, ret));
+#endif
+    }
+  else
+    {
+      mm_alloc_failed(heap, size);
     }
 
   return ret;
@@ -1118,6 +1283,13 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
       memdump_backtrace(heap, buf);
 #endif
       kasan_unpoison(ret, mm_malloc_size(heap, ret));
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+      memset(ret, 0xaa, mm_malloc_size(heap, ret));
+#endif
+    }
+  else
+    {
+      mm_alloc_failed(heap, size);
     }
 
   return ret;
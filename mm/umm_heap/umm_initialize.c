@@ -38,7 +38,7 @@
  * Name: umm_initialize
  *
  * Description:
- *   This is a simple wrapper for the mm_initialize() function.  This
+ *   This is a simple wrapper for the mm_initialize_heap() function.  This
  *   function will initialize the user heap.
  *
  *   CONFIG_BUILD_FLAT:
@@ -83,11 +83,19 @@
 
 void umm_initialize(FAR void *heap_start, size_t heap_size)
 {
-#ifdef CONFIG_BUILD_KERNEL
-  USR_HEAP = mm_initialize(NULL, heap_start, heap_size);
-#else
-  USR_HEAP = mm_initialize("Umem", heap_start, heap_size);
+  struct mm_heap_config_s config =
+  {
+#ifndef CONFIG_BUILD_KERNEL
+    .name    = "Umem",
+#endif
+    .start   = heap_start,
+    .size    = heap_size,
+#ifndef CONFIG_MM_KASAN_UMM
+    .nokasan = true,
 #endif
+  };
+
+  USR_HEAP = mm_initialize_heap(&config);
 }
 
 /****************************************************************************
@@ -44,6 +44,7 @@
 #include <netinet/in.h>
 
 #include <nuttx/net/netdev.h>
+#include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
 
 #include "devif/devif.h"
@@ -156,9 +157,11 @@ struct arp_notify_s
 
 struct arp_entry_s
 {
+  dq_entry_t               at_node;     /* LRU list, most recent first */
+  FAR struct arp_entry_s  *at_hnext;    /* Next entry in the hash bucket */
   in_addr_t                at_ipaddr;   /* IP address */
   struct ether_addr        at_ethaddr;  /* Hardware address */
-  clock_t                  at_time;     /* Time of last usage */
+  clock_t                  at_time;     /* Time of last update */
   FAR struct net_driver_s *at_dev;      /* The device driver structure */
 };
 
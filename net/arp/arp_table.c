@@ -85,9 +85,15 @@ struct arp_table_info_s
  * Private Data
  ****************************************************************************/
 
-/* The table of known address mappings */
+/* The table of known address mappings.  The used entries are also linked
+ * in hash buckets by IP address.  All entries are on the LRU list: the
+ * most recently used at the head, unused entries at the tail, where the
+ * next entry to fill is taken from.
+ */
 
 static struct arp_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
+static FAR struct arp_entry_s *g_arphash[CONFIG_NET_ARPTAB_SIZE];
+static dq_queue_t g_arplru;
 
 /****************************************************************************
  * Private Functions
@@ -140,32 +146,87 @@ static int arp_match(FAR struct net_driver_s *dev, FAR void *arg)
 }
 
 /****************************************************************************
- * Name: arp_return_old_entry
+ * Name: arp_bucket
  *
  * Description:
- *   Compare and return the old ARP table entry.
+ *   Return the hash bucket of an IP address.  All bytes are folded in, so
+ *   that hosts of a subnet spread whatever the byte order.
  *
  ****************************************************************************/
 
-static FAR struct arp_entry_s *
-arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
+static FAR struct arp_entry_s **arp_bucket(in_addr_t ipaddr)
 {
-  if (e1->at_ipaddr == 0)
-    {
-      return e1;
-    }
-  else if (e2->at_ipaddr == 0)
-    {
-      return e2;
-    }
-  else if ((int)(e1->at_time - e2->at_time) <= 0)
+  uint32_t hash = ipaddr;
+
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+  return &g_arphash[hash % CONFIG_NET_ARPTAB_SIZE];
+}
+
+/****************************************************************************
+ * Name: arp_touch
+ *
+ * Description:
+ *   Make an entry the most recently used one.
+ *
+ ****************************************************************************/
+
+static void arp_touch(FAR struct arp_entry_s *tabptr)
+{
+  dq_rem(&tabptr->at_node, &g_arplru);
+  dq_addfirst(&tabptr->at_node, &g_arplru);
+}
+
+/****************************************************************************
+ * Name: arp_initlru
+ *
+ * Description:
+ *   Place all entries on the LRU list.  Done once, by the first update.
+ *
+ ****************************************************************************/
+
+static void arp_initlru(void)
+{
+  int i;
+
+  if (dq_empty(&g_arplru))
     {
-      return e1;
+      for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; i++)
+        {
+          dq_addlast(&g_arptable[i].at_node, &g_arplru);
+        }
     }
-  else
+}
+
+/****************************************************************************
+ * Name: arp_release
+ *
+ * Description:
+ *   Remove an entry from its hash bucket and make it the next one to fill.
+ *
+ ****************************************************************************/
+
+static void arp_release(FAR struct arp_entry_s *tabptr)
+{
+  FAR struct arp_entry_s **prev = arp_bucket(tabptr->at_ipaddr);
+
+  while (*prev != NULL)
     {
-      return e2;
+      if (*prev == tabptr)
+        {
+          *prev = tabptr->at_hnext;
+          break;
+        }
+
+      prev = &(*prev)->at_hnext;
     }
+
+  tabptr->at_hnext  = NULL;
+  tabptr->at_ipaddr = 0;
+  tabptr->at_dev    = NULL;
+
+  dq_rem(&tabptr->at_node, &g_arplru);
+  dq_addlast(&tabptr->at_node, &g_arplru);
 }
 
 /****************************************************************************
@@ -188,17 +249,25 @@ static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
                                           FAR struct net_driver_s *dev)
 {
   FAR struct arp_entry_s *tabptr;
-  int i;
 
-  /* Check if the IPv4 address is already in the ARP table. */
+  /* Check if the IPv4 address is already in the ARP table.  An entry that
+   * has expired is released when it is found, so the table ages without
+   * scanning it.
+   */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  for (tabptr = *arp_bucket(ipaddr); tabptr != NULL;
+       tabptr = tabptr->at_hnext)
     {
-      tabptr = &g_arptable[i];
       if (tabptr->at_dev == dev &&
-          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr) &&
-          clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK)
+          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
         {
+          if (clock_systime_ticks() - tabptr->at_time > ARP_MAXAGE_TICK)
+            {
+              arp_release(tabptr);
+              break;
+            }
+
+          arp_touch(tabptr);
           return tabptr;
         }
     }
@@ -236,45 +305,52 @@ static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
 int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
                FAR const uint8_t *ethaddr)
 {
-  FAR struct arp_entry_s *tabptr = &g_arptable[0];
-  int i;
+  FAR struct arp_entry_s **bucket;
+  FAR struct arp_entry_s *tabptr;
+
+  if (ipaddr == 0)
+    {
+      return -EINVAL;
+    }
+
+  arp_initlru();
 
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
+  /* Try to find the entry to update in the hash bucket of the address.
+   * If there is none, the IP -> MAC address mapping is inserted in the
+   * least recently used entry, which is an unused one if there is any.
    */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  bucket = arp_bucket(ipaddr);
+  for (tabptr = *bucket; tabptr != NULL; tabptr = tabptr->at_hnext)
     {
-      /* Check if the source IP address of the incoming packet matches
-       * the IP address in this ARP table entry.
-       */
-
-      if (g_arptable[i].at_dev == dev &&
-          g_arptable[i].at_ipaddr != 0 &&
-          net_ipv4addr_cmp(ipaddr, g_arptable[i].at_ipaddr))
+      if (tabptr->at_dev == dev &&
+          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
         {
-          /* An old entry found, break. */
-
-          tabptr = &g_arptable[i];
           break;
         }
-      else
-        {
-          /* Record the oldest entry. */
+    }
 
-          tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
+  if (tabptr == NULL)
+    {
+      tabptr = (FAR struct arp_entry_s *)dq_tail(&g_arplru);
+      if (tabptr->at_ipaddr != 0)
+        {
+          arp_release(tabptr);
         }
+
+      tabptr->at_ipaddr = ipaddr;
+      tabptr->at_hnext  = *bucket;
+      *bucket           = tabptr;
     }
 
   /* Now, tabptr is the ARP table entry which we will fill with the new
    * information.
    */
 
-  tabptr->at_ipaddr = ipaddr;
   memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
   tabptr->at_dev = dev;
   tabptr->at_time = clock_systime_ticks();
+  arp_touch(tabptr);
   return OK;
 }
 
@@ -398,9 +474,9 @@ int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev)
   tabptr = arp_lookup(ipaddr, dev);
   if (tabptr != NULL)
     {
-      /* Yes.. Set the IP address to zero to "delete" it */
+      /* Yes.. Release it */
 
-      tabptr->at_ipaddr = 0;
+      arp_release(tabptr);
       return OK;
     }
 
@@ -427,9 +503,9 @@ void arp_cleanup(FAR struct net_driver_s *dev)
 
   for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
     {
-      if (dev == g_arptable[i].at_dev)
+      if (dev == g_arptable[i].at_dev && g_arptable[i].at_ipaddr != 0)
         {
-          memset(&g_arptable[i], 0, sizeof(g_arptable[i]));
+          arp_release(&g_arptable[i]);
         }
     }
 }
@@ -404,6 +404,25 @@ int can_getsockopt(FAR struct socket *psock, int level, int option,
                    FAR void *value, FAR socklen_t *value_len);
 #endif
 
+/****************************************************************************
+ * Name: can_offload_filters
+ *
+ * Description:
+ *   Pass the union of the CAN_RAW_FILTER sets of all sockets bound to a
+ *   device to its driver, so that it can program its acceptance filters.
+ *
+ * Input Parameters:
+ *   dev - The CAN device whose sockets changed; may be NULL
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CAN_RAW_FILTER_OFFLOAD
+void can_offload_filters(FAR struct net_driver_s *dev);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -199,8 +199,28 @@ uint16_t can_datahandler(FAR struct net_driver_s *dev,
                          FAR struct can_conn_s *conn)
 {
   FAR struct iob_s *iob = dev->d_iob;
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+  FAR struct iob_s *copy;
+#endif
   int ret;
 
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+  /* A CAN frame usually fits in a small IOB.  Queue a copy in one, so that
+   * the full size device buffer does not sit in the read-ahead queue.
+   */
+
+  if (iob->io_pktlen <= CONFIG_IOB_SMALL_BUFSIZE &&
+      (copy = iob_tryalloc_size(false, iob->io_pktlen)) != NULL)
+    {
+      iob_copyout(copy->io_data, iob, iob->io_pktlen, 0);
+      copy->io_len    = iob->io_pktlen;
+      copy->io_pktlen = iob->io_pktlen;
+
+      iob_free_chain(iob);
+      iob = copy;
+    }
+#endif
+
   /* Concat the iob to readahead */
 
   ret = iob_tryadd_queue(iob, &conn->readahead);
@@ -0,0 +1,151 @@
+/****************************************************************************
+ * net/can/can_offload.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <netpacket/can.h>
+
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ioctl.h>
+#include <nuttx/net/can.h>
+
+#include "can/can.h"
+
+#ifdef CONFIG_NET_CAN_RAW_FILTER_OFFLOAD
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_offload_filters
+ *
+ * Description:
+ *   Pass the union of the CAN_RAW_FILTER sets of all sockets bound to a
+ *   device to its driver, so that it can program its acceptance filters.
+ *
+ *   Inverted filters cannot be expressed as acceptance filters, and an
+ *   unbound socket receives from every device; in both cases, and when the
+ *   union does not fit, the driver is asked to accept all frames.
+ *
+ * Input Parameters:
+ *   dev - The CAN device whose sockets changed; may be NULL
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void can_offload_filters(FAR struct net_driver_s *dev)
+{
+  struct can_filter filters[CONFIG_NET_CAN_RAW_FILTER_MAX];
+  struct can_rawfilter_s req;
+  FAR struct can_conn_s *conn = NULL;
+  FAR const struct can_filter *filter;
+  bool bound = false;
+  int ret;
+  int i;
+  int j;
+
+  if (dev == NULL || dev->d_lltype != NET_LL_CAN || dev->d_ioctl == NULL)
+    {
+      return;
+    }
+
+  req.filters  = filters;
+  req.nfilters = 0;
+
+  while ((conn = can_nextconn(conn)) != NULL)
+    {
+      if (conn->dev == NULL)
+        {
+          goto acceptall;
+        }
+
+      if (conn->dev != dev)
+        {
+          continue;
+        }
+
+      bound = true;
+
+      for (i = 0; i < conn->filter_count; i++)
+        {
+          filter = &conn->filters[i];
+          if ((filter->can_id & CAN_INV_FILTER) != 0)
+            {
+              goto acceptall;
+            }
+
+          /* Skip duplicates of filters already in the union */
+
+          for (j = 0; j < req.nfilters; j++)
+            {
+              if (filters[j].can_id == filter->can_id &&
+                  filters[j].can_mask == filter->can_mask)
+                {
+                  break;
+                }
+            }
+
+          if (j < req.nfilters)
+            {
+              continue;
+            }
+
+          if (req.nfilters >= CONFIG_NET_CAN_RAW_FILTER_MAX)
+            {
+              goto acceptall;
+            }
+
+          filters[req.nfilters++] = *filter;
+        }
+    }
+
+  /* With no socket bound to the device, restore the default of accepting
+   * all frames.
+   */
+
+  if (bound)
+    {
+      goto offload;
+    }
+
+acceptall:
+  req.nfilters = -1;
+
+offload:
+  ret = dev->d_ioctl(dev, SIOCSCANRAWFILTER, (unsigned long)(uintptr_t)&req);
+  if (ret < 0 && ret != -ENOTTY)
+    {
+      nwarn("WARNING: %s: filter offload failed: %d\n", dev->d_ifname, ret);
+    }
+}
+
+#endif /* CONFIG_NET_CAN_RAW_FILTER_OFFLOAD */
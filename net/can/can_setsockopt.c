@@ -150,6 +150,15 @@ int can_setsockopt(FAR struct socket *psock, int level, int option,
 
             ret = OK;
           }
+
+#ifdef CONFIG_NET_CAN_RAW_FILTER_OFFLOAD
+        if (ret == OK)
+          {
+            net_lock();
+            can_offload_filters(conn->dev);
+            net_unlock();
+          }
+#endif
         break;
 
       case CAN_RAW_ERR_FILTER:
@@ -328,6 +328,14 @@ static int can_bind(FAR struct socket *psock,
   conn->dev = netdev_findbyname((const char *)&netdev_name);
 #endif
 
+#ifdef CONFIG_NET_CAN_RAW_FILTER_OFFLOAD
+  /* The socket no longer listens on all devices */
+
+  net_lock();
+  can_offload_filters(conn->dev);
+  net_unlock();
+#endif
+
   return OK;
 }
 
@@ -479,6 +487,9 @@ errout_with_lock:
 static int can_close(FAR struct socket *psock)
 {
   FAR struct can_conn_s *conn = psock->s_conn;
+#ifdef CONFIG_NET_CAN_RAW_FILTER_OFFLOAD
+  FAR struct net_driver_s *dev = conn->dev;
+#endif
   int ret = OK;
 
   /* Perform some pre-close operations for the CAN socket type. */
@@ -498,6 +509,14 @@ static int can_close(FAR struct socket *psock)
       conn->crefs = 0;
       can_free(psock->s_conn);
 
+#ifdef CONFIG_NET_CAN_RAW_FILTER_OFFLOAD
+      /* Drop the filters of the closed socket */
+
+      net_lock();
+      can_offload_filters(dev);
+      net_unlock();
+#endif
+
       if (ret < 0)
         {
           /* Return with error code, but free resources. */
@@ -307,6 +307,21 @@ extern "C"
 
 void devif_initialize(void);
 
+/****************************************************************************
+ * Name: devif_perf_input
+ *
+ * Description:
+ *   Account the processing time of a received packet.
+ *
+ * Input Parameters:
+ *   start - The up_perf_gettime() value when the processing started
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_STATISTICS_PERF
+void devif_perf_input(unsigned long start);
+#endif
+
 /****************************************************************************
  * Name: devif_callback_init
  *
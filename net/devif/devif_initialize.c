@@ -44,6 +44,7 @@
 #include <nuttx/config.h>
 #ifdef CONFIG_NET
 
+#include <nuttx/arch.h>
 #include <nuttx/net/netstats.h>
 
 #include "devif/devif.h"
@@ -90,4 +91,32 @@ void devif_initialize(void)
 
   devif_callback_init();
 }
+
+/****************************************************************************
+ * Name: devif_perf_input
+ *
+ * Description:
+ *   Account the processing time of a received packet.
+ *
+ * Input Parameters:
+ *   start - The up_perf_gettime() value when the processing started
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_STATISTICS_PERF
+void devif_perf_input(unsigned long start)
+{
+  unsigned long elapsed = up_perf_gettime() - start;
+
+  g_netstats.perf.rxpkts++;
+  g_netstats.perf.rxtime += elapsed;
+  if (elapsed > g_netstats.perf.rxmax)
+    {
+      g_netstats.perf.rxmax = elapsed;
+    }
+}
+#endif
 #endif /* CONFIG_NET */
@@ -50,6 +50,19 @@
 #include "ipfrag/ipfrag.h"
 #include "inet/inet.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Number of priority bands that TCP and UDP connections are polled in */
+
+#ifdef CONFIG_NET_SOPRIORITY
+#  define DEVIF_NBANDS        3
+#else
+#  define DEVIF_NBANDS        1
+#  define devif_txband(conn)  0
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -64,10 +77,61 @@ enum devif_packet_type
   DEVIF_ICMP6
 };
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOPRIORITY
+/* The band of each SO_PRIORITY value, as in the pfifo_fast queue
+ * discipline of Linux: interactive (6) and control (7) go first, bulk (2)
+ * and the unused values 3 and 5 go last.
+ */
+
+static const uint8_t g_prio2band[16] =
+{
+  1, 2, 2, 2, 1, 2, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: devif_txband
+ *
+ * Description:
+ *   Return the priority band of a connection, 0 being served first.  It
+ *   is selected by SO_PRIORITY or, if that is not set, by the DSCP:
+ *   class selector 5 and above (voice, network control) goes first, lower
+ *   effort and class selector 1 go last.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOPRIORITY
+static int devif_txband(FAR struct socket_conn_s *conn)
+{
+  uint8_t dscp;
+
+  if (conn->s_priority != 0)
+    {
+      return g_prio2band[conn->s_priority & 15];
+    }
+
+  dscp = conn->s_tos >> 2;
+  if (dscp >= 40)
+    {
+      return 0;
+    }
+  else if (dscp == 1 || (dscp >= 8 && dscp < 16))
+    {
+      return 2;
+    }
+
+  return 1;
+}
+#endif
+
 /****************************************************************************
  * Name: devif_packet_conversion
  *
@@ -554,7 +618,8 @@ static inline int devif_poll_mld(FAR struct net_driver_s *dev,
 
 #ifdef NET_UDP_HAVE_STACK
 static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
-                                      devif_poll_callback_t callback)
+                                      devif_poll_callback_t callback,
+                                      int band)
 {
   FAR struct udp_conn_s *conn = NULL;
   int bstop = 0;
@@ -565,6 +630,13 @@ static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
 
   while (!bstop && (conn = udp_nextconn(conn)))
     {
+      /* Skip UDP connections of other priority bands */
+
+      if (devif_txband(&conn->sconn) != band)
+        {
+          continue;
+        }
+
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
       /* Skip UDP connections that are bound to other polling devices */
 
@@ -575,6 +647,12 @@ static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
 
           udp_poll(dev, conn);
 
+#ifdef CONFIG_NET_TIMESTAMPING
+          /* Take the transmit timestamps that the socket asked for */
+
+          udp_tstamp_txpoll(dev, conn);
+#endif
+
           /* Perform any necessary conversions on outgoing packets */
 
           devif_packet_conversion(dev, DEVIF_UDP);
@@ -582,11 +660,24 @@ static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
           /* Call back into the driver */
 
           bstop = devif_poll_out(dev, callback);
+
+#ifdef CONFIG_NET_TIMESTAMPING
+          /* Unless the packet is still to be copied out by devif_poll(),
+           * the driver has taken it and d_txtstamp with it.
+           */
+
+          if (!bstop)
+            {
+              dev->d_txtstamp = NULL;
+            }
+#endif
         }
     }
 
   return bstop;
 }
+#else
+#  define devif_poll_udp_connections(dev, callback, band) (0)
 #endif /* NET_UDP_HAVE_STACK */
 
 /****************************************************************************
@@ -603,7 +694,8 @@ static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
 
 #ifdef NET_TCP_HAVE_STACK
 static inline int devif_poll_tcp_connections(FAR struct net_driver_s *dev,
-                                             devif_poll_callback_t callback)
+                                             devif_poll_callback_t callback,
+                                             int band)
 {
   FAR struct tcp_conn_s *conn  = NULL;
   int bstop = 0;
@@ -612,9 +704,11 @@ static inline int devif_poll_tcp_connections(FAR struct net_driver_s *dev,
 
   while (!bstop && (conn = tcp_nextconn(conn)))
     {
-      /* Skip TCP connections that are bound to other polling devices */
+      /* Skip TCP connections that are bound to other polling devices or
+       * belong to other priority bands.
+       */
 
-      if (dev == conn->dev)
+      if (dev == conn->dev && devif_txband(&conn->sconn) == band)
         {
           /* Perform the TCP TX poll */
 
@@ -633,7 +727,7 @@ static inline int devif_poll_tcp_connections(FAR struct net_driver_s *dev,
   return bstop;
 }
 #else
-#  define devif_poll_tcp_connections(dev, callback) (0)
+#  define devif_poll_tcp_connections(dev, callback, band) (0)
 #endif
 
 /****************************************************************************
@@ -745,6 +839,9 @@ static int devif_poll_connections(FAR struct net_driver_s *dev,
   /* Reset device buffer length */
 
   dev->d_len = 0;
+#ifdef CONFIG_NET_TIMESTAMPING
+  dev->d_txtstamp = NULL;
+#endif
 
   /* Traverse all of the active packet connections and perform the poll
    * action.
@@ -819,24 +916,24 @@ static int devif_poll_connections(FAR struct net_driver_s *dev,
 
   if (!bstop)
 #endif
-#ifdef NET_TCP_HAVE_STACK
+#if defined(NET_TCP_HAVE_STACK) || defined(NET_UDP_HAVE_STACK)
     {
-      /* Traverse all of the active TCP connections and perform the poll
-       * action.
-       */
+      int band;
 
-      bstop = devif_poll_tcp_connections(dev, callback);
-    }
-
-  if (!bstop)
-#endif
-#ifdef NET_UDP_HAVE_STACK
-    {
-      /* Traverse all of the allocated UDP connections and perform
-       * the poll action
+      /* Traverse all of the active TCP and UDP connections and perform the
+       * poll action, one priority band after the other.  As a flat-buffer
+       * driver restarts the poll for each packet, a connection of a higher
+       * band that has data is always served first.
        */
 
-      bstop = devif_poll_udp_connections(dev, callback);
+      for (band = 0; !bstop && band < DEVIF_NBANDS; band++)
+        {
+          bstop = devif_poll_tcp_connections(dev, callback, band);
+          if (!bstop)
+            {
+              bstop = devif_poll_udp_connections(dev, callback, band);
+            }
+        }
     }
 
   if (!bstop)
@@ -933,6 +1030,9 @@ static int devif_iob_poll(FAR struct net_driver_s *dev,
   /* Device polling completed, release iob */
 
   netdev_iob_release(dev);
+#ifdef CONFIG_NET_TIMESTAMPING
+  dev->d_txtstamp = NULL;
+#endif
 
   return bstop;
 }
@@ -1034,6 +1134,9 @@ int devif_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
           /* Call the real device callback */
 
           bstop = callback(dev);
+#ifdef CONFIG_NET_TIMESTAMPING
+          dev->d_txtstamp = NULL;
+#endif
 
           /* Flat buffer changed by NIC ? */
 
@@ -89,6 +89,7 @@
 #include <netinet/in.h>
 #include <net/if.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/netstats.h>
@@ -384,7 +385,8 @@ static int ipv4_in(FAR struct net_driver_s *dev)
     }
 #endif
 
-  if (ipv4_chksum(IPv4BUF) != 0xffff)
+  if (!NETDEV_CSUM_OFFLOAD(dev, NETDEV_CSUM_RX_IPV4) &&
+      ipv4_chksum(IPv4BUF) != 0xffff)
     {
       /* Compute and check the IP header checksum. */
 
@@ -488,6 +490,9 @@ drop:
 
 int ipv4_input(FAR struct net_driver_s *dev)
 {
+#ifdef CONFIG_NET_STATISTICS_PERF
+  unsigned long start = up_perf_gettime();
+#endif
   FAR uint8_t *buf;
   int ret;
 
@@ -501,11 +506,17 @@ int ipv4_input(FAR struct net_driver_s *dev)
       ret = ipv4_in(dev);
 
       dev->d_buf = buf;
-
-      return ret;
     }
+  else
+    {
+      ret = netdev_input(dev, ipv4_in, true);
+    }
+
+#ifdef CONFIG_NET_STATISTICS_PERF
+  devif_perf_input(start);
+#endif
 
-  return netdev_input(dev, ipv4_in, true);
+  return ret;
 }
 
 #endif /* CONFIG_NET_IPv4 */
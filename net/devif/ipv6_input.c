@@ -34,6 +34,7 @@
 
 #include <net/if.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/netstats.h>
@@ -606,6 +607,9 @@ bool ipv6_exthdr(uint8_t nxthdr)
 
 int ipv6_input(FAR struct net_driver_s *dev)
 {
+#ifdef CONFIG_NET_STATISTICS_PERF
+  unsigned long start = up_perf_gettime();
+#endif
   FAR uint8_t *buf;
   int ret;
 
@@ -619,10 +623,16 @@ int ipv6_input(FAR struct net_driver_s *dev)
       ret = ipv6_in(dev);
 
       dev->d_buf = buf;
-
-      return ret;
     }
+  else
+    {
+      ret = netdev_input(dev, ipv6_in, true);
+    }
+
+#ifdef CONFIG_NET_STATISTICS_PERF
+  devif_perf_input(start);
+#endif
 
-  return netdev_input(dev, ipv6_in, true);
+  return ret;
 }
 #endif /* CONFIG_NET_IPv6 */
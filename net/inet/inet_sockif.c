@@ -103,6 +103,12 @@ static ssize_t    inet_sendfile(FAR struct socket *psock,
                     FAR struct file *infile, FAR off_t *offset,
                     size_t count);
 #endif
+static int        inet_sendmmsg(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags);
+static int        inet_recvmmsg(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags);
 
 /****************************************************************************
  * Private Data
@@ -133,6 +139,8 @@ static const struct sock_intf_s g_inet_sockif =
 #ifdef CONFIG_NET_SENDFILE
   , inet_sendfile   /* si_sendfile */
 #endif
+  , inet_sendmmsg   /* si_sendmmsg */
+  , inet_recvmmsg   /* si_recvmmsg */
 };
 
 /****************************************************************************
@@ -943,6 +951,9 @@ static int inet_set_socketlevel_option(FAR struct socket *psock, int option,
               /* Save the receive buffer size */
 
               tcp->rcv_bufs = buffersize;
+#ifdef CONFIG_NET_TCP_BUFSIZE_AUTO
+              tcp->autotune.locks |= TCP_AUTOTUNE_RCVLOCK;
+#endif
             }
           else
 #endif
@@ -1004,6 +1015,9 @@ static int inet_set_socketlevel_option(FAR struct socket *psock, int option,
               /* Save the send buffer size */
 
               tcp->snd_bufs = buffersize;
+#ifdef CONFIG_NET_TCP_BUFSIZE_AUTO
+              tcp->autotune.locks |= TCP_AUTOTUNE_SNDLOCK;
+#endif
             }
           else
 #endif
@@ -1923,6 +1937,64 @@ static ssize_t inet_sendmsg(FAR struct socket *psock,
   return ret;
 }
 
+/****************************************************************************
+ * Name: inet_sendmmsg
+ *
+ * Description:
+ *   Send a batch of datagrams on a SOCK_DGRAM socket.  The network stays
+ *   locked for the whole batch, so each datagram only re-enters the lock
+ *   and the device is polled once the batch is queued.
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   msgvec   The messages to send
+ *   vlen     The number of messages in msgvec
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   The number of messages sent, zero if they must be sent one at a time.
+ *   A negated errno value is returned if the first message failed.
+ *
+ ****************************************************************************/
+
+static int inet_sendmmsg(FAR struct socket *psock,
+                         FAR struct mmsghdr *msgvec, unsigned int vlen,
+                         int flags)
+{
+  FAR struct msghdr *msg;
+  unsigned int n;
+  int ret = 0;
+
+  if (psock->s_type != SOCK_DGRAM)
+    {
+      return 0;
+    }
+
+  net_lock();
+
+  for (n = 0; n < vlen; n++)
+    {
+      /* Leave a message that psock_sendmsg() would refuse to the caller */
+
+      msg = &msgvec[n].msg_hdr;
+      if (msg->msg_iov == NULL || msg->msg_iov->iov_base == NULL)
+        {
+          break;
+        }
+
+      ret = inet_sendmsg(psock, msg, flags);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[n].msg_len = ret;
+    }
+
+  net_unlock();
+  return n > 0 ? n : ret;
+}
+
 /****************************************************************************
  * Name: inet_ioctl
  *
@@ -2297,6 +2369,37 @@ static ssize_t inet_recvmsg(FAR struct socket *psock,
   return ret;
 }
 
+/****************************************************************************
+ * Name: inet_recvmmsg
+ *
+ * Description:
+ *   Take the datagrams that are already buffered for a SOCK_DGRAM socket.
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   msgvec   The buffers to receive the messages
+ *   vlen     The number of messages in msgvec
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   The number of messages received, zero if none was buffered.
+ *
+ ****************************************************************************/
+
+static int inet_recvmmsg(FAR struct socket *psock,
+                         FAR struct mmsghdr *msgvec, unsigned int vlen,
+                         int flags)
+{
+#ifdef NET_UDP_HAVE_STACK
+  if (psock->s_type == SOCK_DGRAM)
+    {
+      return psock_udp_recvmmsg(psock, msgvec, vlen, flags);
+    }
+#endif
+
+  return 0;
+}
+
 #endif /* NET_UDP_HAVE_STACK || NET_TCP_HAVE_STACK */
 
 /****************************************************************************
@@ -93,7 +93,29 @@ do  \
 
 /* The maximum I/O buffer occupied by fragment reassembly cache */
 
-#define REASSEMBLY_MAXOCCUPYIOB        CONFIG_IOB_NBUFFERS / 5
+#if CONFIG_NET_IPFRAG_MAXIOB > 0
+#  define REASSEMBLY_MAXOCCUPYIOB      CONFIG_NET_IPFRAG_MAXIOB
+#else
+#  define REASSEMBLY_MAXOCCUPYIOB      (CONFIG_IOB_NBUFFERS / 5)
+#endif
+
+/* The maximum I/O buffer occupied by the datagrams of one source */
+
+#if CONFIG_NET_IPFRAG_SRC_MAXIOB > 0
+#  define REASSEMBLY_SRCMAXOCCUPYIOB   CONFIG_NET_IPFRAG_SRC_MAXIOB
+#else
+#  define REASSEMBLY_SRCMAXOCCUPYIOB   (REASSEMBLY_MAXOCCUPYIOB / 2)
+#endif
+
+/* Incomplete datagrams are dropped, oldest first, while fewer I/O buffers
+ * than this remain free in the pool.
+ */
+
+#define REASSEMBLY_MINFREEIOB          CONFIG_NET_IPFRAG_IOB_MINFREE
+
+/* Number of reassembly hash buckets */
+
+#define REASSEMBLY_HASHSIZE            CONFIG_NET_IPFRAG_HASHSIZE
 
 /* Deciding whether to fragment outgoing packets which target is to ourself */
 
@@ -116,13 +138,14 @@ static struct work_s g_wkfragtimeout;
 
 /* Remember the number of I/O buffers currently in reassembly cache */
 
-static uint8_t       g_bufoccupy;
+static uint32_t      g_bufoccupy;
 
-/* Queue header definition, it links all fragments of all NICs by ascending
- * ipid.
+/* Reassembly hash buckets, each one links the nodes of all NICs whose
+ * source address hashes to it.  All datagrams of one source are found in
+ * a single bucket, so that their I/O buffers can be accounted together.
  */
 
-static sq_queue_t    g_assemblyhead_ipid;
+static sq_queue_t    g_assemblyhash[REASSEMBLY_HASHSIZE];
 
 /* Queue header definition, which connects all fragments of all NICs in order
  * of addition time.
@@ -134,8 +157,8 @@ static sq_queue_t    g_assemblyhead_time;
  * Public Data
  ****************************************************************************/
 
-/* Only one thread can access g_assemblyhead_ipid and g_assemblyhead_time
- * at a time.
+/* Only one thread can access the reassembly hash buckets and
+ * g_assemblyhead_time at a time.
  */
 
 mutex_t              g_ipfrag_lock = NXMUTEX_INITIALIZER;
@@ -150,6 +173,11 @@ static inline FAR struct ip_fraglink_s *
 ip_fragin_freelink(FAR struct ip_fraglink_s *fraglink);
 static void ip_fragin_check(FAR struct ip_fragsnode_s *fragsnode);
 static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode);
+static void ip_fragin_getsrc(FAR struct ip_fraglink_s *fraglink,
+                             FAR union ip_addr_u *src);
+static uint16_t ip_fragin_hash(FAR struct net_driver_s *dev,
+                               FAR const union ip_addr_u *src,
+                               uint8_t isipv4);
 static inline FAR struct iob_s *
 ip_fragout_allocfragbuf(FAR struct iob_queue_s *fragq);
 
@@ -224,6 +252,10 @@ static void ip_fragin_timerwork(FAR void *arg)
            */
 
           ninfo("Reassembly timeout occurs!");
+#ifdef CONFIG_NET_STATISTICS
+          g_netstats.ipfrag.timeout++;
+#endif
+
 #if defined(CONFIG_NET_ICMP) && !defined(CONFIG_NET_ICMP_NO_STACK)
           if ((node->verifyflag & IP_FRAGVERIFY_RECVDZEROFRAG) != 0)
             {
@@ -409,7 +441,8 @@ static void ip_fragin_check(FAR struct ip_fragsnode_s *fragsnode)
  *
  * Description:
  *   Check the reassembly cache buffer size, if it exceeds the configured
- *   threshold, some I/O buffers need to be freed
+ *   threshold or the I/O buffer pool is running short, the oldest
+ *   incomplete datagrams are dropped to free some I/O buffers
  *
  * Input Parameters:
  *   curnode - node of the upper-level linked list, it maintains information
@@ -424,6 +457,7 @@ static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode)
 {
   uint32_t        cleancnt = 0;
   uint32_t        bufcnt;
+  int             navail;
   FAR sq_entry_t *entry;
   FAR sq_entry_t *entrynext;
   FAR struct ip_fragsnode_s *node;
@@ -433,6 +467,19 @@ static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode)
   if (g_bufoccupy > REASSEMBLY_MAXOCCUPYIOB)
     {
       cleancnt = g_bufoccupy - REASSEMBLY_MAXOCCUPYIOB;
+    }
+
+  /* Or if the fragments leave too few I/O buffers for other traffic */
+
+  navail = iob_navail(false);
+  if (navail < REASSEMBLY_MINFREEIOB &&
+      cleancnt < REASSEMBLY_MINFREEIOB - navail)
+    {
+      cleancnt = REASSEMBLY_MINFREEIOB - navail;
+    }
+
+  if (cleancnt > 0)
+    {
       entry = sq_peek(&g_assemblyhead_time);
 
       while (entry != NULL && cleancnt > 0)
@@ -463,6 +510,10 @@ static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode)
               bufcnt = ip_frag_remnode(node);
               kmm_free(node);
 
+#ifdef CONFIG_NET_STATISTICS
+              g_netstats.ipfrag.evicted++;
+#endif
+
               cleancnt = cleancnt > bufcnt ? cleancnt - bufcnt : 0;
             }
 
@@ -471,6 +522,95 @@ static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode)
     }
 }
 
+/****************************************************************************
+ * Name: ip_fragin_getsrc
+ *
+ * Description:
+ *   Get the source address from the IP header of a fragment
+ *
+ * Input Parameters:
+ *   fraglink - node of the lower-level linked list, it maintains
+ *              information of one fragment
+ *   src      - Location to return the source address
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void ip_fragin_getsrc(FAR struct ip_fraglink_s *fraglink,
+                             FAR union ip_addr_u *src)
+{
+  FAR uint8_t *iphdr = fraglink->frag->io_data + fraglink->frag->io_offset;
+
+  memset(src, 0, sizeof(*src));
+
+#ifdef CONFIG_NET_IPv4
+  if (fraglink->isipv4)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)iphdr;
+
+      src->ipv4 = net_ip4addr_conv32(ipv4->srcipaddr);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (!fraglink->isipv4)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)iphdr;
+
+      net_ipv6addr_copy(src->ipv6, ipv6->srcipaddr);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: ip_fragin_hash
+ *
+ * Description:
+ *   Select the reassembly hash bucket of a source address
+ *
+ * Input Parameters:
+ *   dev    - NIC Device instance
+ *   src    - The source address
+ *   isipv4 - IPv4 or IPv6
+ *
+ * Returned Value:
+ *   The index of the hash bucket
+ *
+ ****************************************************************************/
+
+static uint16_t ip_fragin_hash(FAR struct net_driver_s *dev,
+                               FAR const union ip_addr_u *src,
+                               uint8_t isipv4)
+{
+  uint32_t hash = (uint32_t)(uintptr_t)dev >> 4;
+
+#ifdef CONFIG_NET_IPv4
+  if (isipv4)
+    {
+      hash ^= src->ipv4;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (!isipv4)
+    {
+      int i;
+
+      for (i = 0; i < 8; i += 2)
+        {
+          hash ^= ((uint32_t)src->ipv6[i] << 16) | src->ipv6[i + 1];
+        }
+    }
+#endif
+
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+
+  return hash % REASSEMBLY_HASHSIZE;
+}
+
 /****************************************************************************
  * Name: ip_fragout_allocfragbuf
  *
@@ -527,7 +667,7 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
   g_bufoccupy -= node->bufcnt;
   assert(g_bufoccupy < CONFIG_IOB_NBUFFERS);
 
-  sq_rem((FAR sq_entry_t *)node, &g_assemblyhead_ipid);
+  sq_rem((FAR sq_entry_t *)node, &g_assemblyhash[node->bucket]);
   sq_rem((FAR sq_entry_t *)&node->flinkat, &g_assemblyhead_time);
 
   return node->bufcnt;
@@ -540,50 +680,84 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
  *   Enqueue one fragment.
  *   All fragments belonging to one IP frame are organized in a linked list
  *   form, that is a ip_fragsnode_s node. All ip_fragsnode_s nodes are also
- *   organized in an upper-level linked list.
+ *   organized in upper-level linked lists, hashed by source address.
  *
  * Input Parameters:
  *   dev         - NIC Device instance
  *   curfraglink - node of the lower-level linked list, it maintains
  *                 information of one fragment
+ *   empty       - Return whether queue is empty before enqueue the new node
  *
  * Returned Value:
- *   Whether queue is empty before enqueue the new node
+ *   OK on success.  On failure the fragment is not queued and a negated
+ *   errno is returned:
+ *   ENOMEM - No memory for a new node
+ *   ENOBUFS - The source of the fragment exceeds its reassembly cache share
  *
  ****************************************************************************/
 
-bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
-                       FAR struct ip_fraglink_s *curfraglink)
+int32_t ip_fragin_enqueue(FAR struct net_driver_s *dev,
+                          FAR struct ip_fraglink_s *curfraglink,
+                          FAR bool *empty)
 {
   FAR struct ip_fragsnode_s *node;
   FAR sq_entry_t            *entry;
-  FAR sq_entry_t            *entrylast = NULL;
-  bool                       empty;
-
-  /* The linked list is ordered by IP ID value, walk through it and try to
-   * find a node that has the same IP ID value, otherwise need to create a
-   * new node and insert it into the linked list.
+  union ip_addr_u            src;
+  uint32_t                   srcoccupy = 0;
+  uint32_t                   bufcnt;
+  uint16_t                   bucket;
+
+  /* All datagrams of one source are linked in the same hash bucket, walk
+   * through it to find the node of this datagram and to count the I/O
+   * buffers that the source already holds.
    */
 
-  entry = sq_peek(&g_assemblyhead_ipid);
-  empty = (entry == NULL) ? true : false;
+  ip_fragin_getsrc(curfraglink, &src);
+  bucket = ip_fragin_hash(dev, &src, curfraglink->isipv4);
+  bufcnt = IOBUF_CNT(curfraglink->frag);
+  *empty = sq_empty(&g_assemblyhead_time);
+
+  node  = NULL;
+  entry = sq_peek(&g_assemblyhash[bucket]);
 
   while (entry != NULL)
     {
-      node = (struct ip_fragsnode_s *)entry;
+      FAR struct ip_fragsnode_s *tmp = (FAR struct ip_fragsnode_s *)entry;
 
-      if (dev == node->dev && curfraglink->ipid <= node->ipid)
+      if (dev == tmp->dev && curfraglink->isipv4 == tmp->isipv4 &&
+          memcmp(&src, &tmp->src, sizeof(src)) == 0)
         {
-          break;
+          if (curfraglink->ipid == tmp->ipid)
+            {
+              node = tmp;
+            }
+          else
+            {
+              srcoccupy += tmp->bufcnt;
+            }
         }
 
-      entrylast = entry;
       entry = sq_next(entry);
     }
 
-  node = (FAR struct ip_fragsnode_s *)entry;
+  /* Refuse the fragment if its source would exceed its share of the
+   * reassembly cache, so that one source cannot flush the datagrams of
+   * the others.  A datagram that is the only one of its source is always
+   * accepted, so that datagrams larger than the share still reassemble.
+   */
+
+  if (srcoccupy > 0 &&
+      srcoccupy + (node != NULL ? node->bufcnt : 0) + bufcnt >
+      REASSEMBLY_SRCMAXOCCUPYIOB)
+    {
+      nwarn("WARNING: Reassembly cache share of source exceeded\n");
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipfrag.overlimit++;
+#endif
+      return -ENOBUFS;
+    }
 
-  if (node != NULL && curfraglink->ipid == node->ipid)
+  if (node != NULL)
     {
       FAR struct ip_fraglink_s *fraglink;
       FAR struct ip_fraglink_s *lastlink = NULL;
@@ -621,8 +795,8 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
 
           /* Remember I/O buffer count */
 
-          node->bufcnt += IOBUF_CNT(curfraglink->frag);
-          g_bufoccupy  += IOBUF_CNT(curfraglink->frag);
+          node->bufcnt += bufcnt;
+          g_bufoccupy  += bufcnt;
         }
       else if (curfraglink->fragoff == fraglink->fragoff)
         {
@@ -641,6 +815,11 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
               lastlink->flink = curfraglink;
             }
 
+          /* Account the I/O buffers of the new copy instead of the old */
+
+          node->bufcnt += bufcnt - IOBUF_CNT(fraglink->frag);
+          g_bufoccupy  += bufcnt - IOBUF_CNT(fraglink->frag);
+
           iob_free_chain(fraglink->frag);
           kmm_free(fraglink);
         }
@@ -665,8 +844,8 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
 
           /* Remember I/O buffer count */
 
-          node->bufcnt += IOBUF_CNT(curfraglink->frag);
-          g_bufoccupy  += IOBUF_CNT(curfraglink->frag);
+          node->bufcnt += bufcnt;
+          g_bufoccupy  += bufcnt;
         }
     }
   else
@@ -686,26 +865,19 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
       node->flinkat    = NULL;
       node->dev        = dev;
       node->ipid       = curfraglink->ipid;
+      node->src        = src;
+      node->isipv4     = curfraglink->isipv4;
+      node->bucket     = bucket;
       node->frags      = curfraglink;
       node->tick       = clock_systime_ticks();
-      node->bufcnt     = IOBUF_CNT(curfraglink->frag);
-      g_bufoccupy     += IOBUF_CNT(curfraglink->frag);
+      node->bufcnt     = bufcnt;
+      g_bufoccupy     += bufcnt;
       node->verifyflag = 0;
       node->outgoframe = NULL;
 
-      /* Insert this new node into linked list identified by
-       * g_assemblyhead_ipid with correct position
-       */
+      /* Insert this new node into the hash bucket of its source */
 
-      if (sq_peek(&g_assemblyhead_ipid) == NULL || entrylast == NULL)
-        {
-          sq_addfirst((FAR sq_entry_t *)node, &g_assemblyhead_ipid);
-        }
-      else
-        {
-          sq_addafter(entrylast, (FAR sq_entry_t *)node,
-                      &g_assemblyhead_ipid);
-        }
+      sq_addfirst((FAR sq_entry_t *)node, &g_assemblyhash[bucket]);
 
       /* Add this new node to the tail of linked list identified by
        * g_assemblyhead_time
@@ -745,7 +917,7 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
 
   ip_fragin_cachemonitor(node);
 
-  return empty;
+  return OK;
 }
 
 /****************************************************************************
@@ -1114,13 +1286,14 @@ void ip_frag_stop(FAR struct net_driver_s *dev)
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  entry = sq_peek(&g_assemblyhead_ipid);
+  entry = sq_peek(&g_assemblyhead_time);
 
   /* Drop those unassembled incoming fragments belonging to this NIC */
 
   while (entry != NULL)
     {
-      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)entry;
+      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)
+             container_of(entry, FAR struct ip_fragsnode_s, flinkat);
       entrynext = sq_next(entry);
 
       if (dev == node->dev)
@@ -1136,7 +1309,7 @@ void ip_frag_stop(FAR struct net_driver_s *dev)
             }
 
           ip_frag_remnode(node);
-          kmm_free(entry);
+          kmm_free(node);
         }
 
       entry = entrynext;
@@ -1166,16 +1339,18 @@ void ip_frag_remallfrags(void)
   FAR sq_entry_t *entry = NULL;
   FAR sq_entry_t *entrynext;
   FAR struct net_driver_s *dev;
+  int i;
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  entry = sq_peek(&g_assemblyhead_ipid);
+  entry = sq_peek(&g_assemblyhead_time);
 
   /* Drop all unassembled incoming fragments */
 
   while (entry != NULL)
     {
-      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)entry;
+      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)
+             container_of(entry, FAR struct ip_fragsnode_s, flinkat);
       entrynext = sq_next(entry);
 
       if (node->frags != NULL)
@@ -1188,18 +1363,21 @@ void ip_frag_remallfrags(void)
             }
         }
 
-      /* Because nodes managed by the two queues are the same,
-       * and g_assemblyhead_ipid will be cleared after this loop ends,
-       * so only reset g_assemblyhead_time is needed after this loop ends
+      /* Because nodes managed by the time queue and the hash buckets are
+       * the same, all of the queues are simply reset after this loop ends
        */
 
-      sq_rem(entry, &g_assemblyhead_ipid);
-      kmm_free(entry);
+      kmm_free(node);
 
       entry = entrynext;
     }
 
   sq_init(&g_assemblyhead_time);
+  for (i = 0; i < REASSEMBLY_HASHSIZE; i++)
+    {
+      sq_init(&g_assemblyhash[i]);
+    }
+
   g_bufoccupy = 0;
 
   nxmutex_unlock(&g_ipfrag_lock);
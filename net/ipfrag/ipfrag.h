@@ -92,8 +92,9 @@ struct ip_fraglink_s
 
 struct ip_fragsnode_s
 {
-  /* This link is used to maintain a single-linked list of ip_fragsnode_s.
-   * Must be the first field in the structure due to flink type casting.
+  /* This link is used to maintain the single-linked list of ip_fragsnode_s
+   * in one reassembly hash bucket.  Must be the first field in the
+   * structure due to flink type casting.
    */
 
   FAR struct ip_fragsnode_s *flink;
@@ -114,6 +115,20 @@ struct ip_fragsnode_s
 
   uint32_t                   ipid;
 
+  /* Source address of the datagram, fragments are matched on the source
+   * address and accounted to it.
+   */
+
+  union ip_addr_u            src;
+
+  /* IPv4 or IPv6, the IP ID spaces are distinct */
+
+  uint8_t                    isipv4;
+
+  /* Index of the reassembly hash bucket that holds this node */
+
+  uint16_t                   bucket;
+
   /* Count ticks, used by ressembly timer */
 
   clock_t                    tick;
@@ -147,8 +162,8 @@ extern "C"
 #  define EXTERN extern
 #endif
 
-/* Only one thread can access g_assemblyhead_ipid and g_assemblyhead_time
- * at a time
+/* Only one thread can access the reassembly hash buckets and
+ * g_assemblyhead_time at a time
  */
 
 extern mutex_t g_ipfrag_lock;
@@ -181,20 +196,25 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node);
  *   Enqueue one fragment.
  *   All fragments belonging to one IP frame are organized in a linked list
  *   form, that is a ip_fragsnode_s node. All ip_fragsnode_s nodes are also
- *   organized in an upper-level linked list.
+ *   organized in upper-level linked lists, hashed by source address.
  *
  * Input Parameters:
  *   dev         - NIC Device instance
  *   curfraglink - node of the lower-level linked list, it maintains
  *                 information of one fragment
+ *   empty       - Return whether queue is empty before enqueue the new node
  *
  * Returned Value:
- *   Whether queue is empty before enqueue the new node
+ *   OK on success.  On failure the fragment is not queued and a negated
+ *   errno is returned:
+ *   ENOMEM - No memory for a new node
+ *   ENOBUFS - The source of the fragment exceeds its reassembly cache share
  *
  ****************************************************************************/
 
-bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
-                       FAR struct ip_fraglink_s *curfraglink);
+int32_t ip_fragin_enqueue(FAR struct net_driver_s *dev,
+                          FAR struct ip_fraglink_s *curfraglink,
+                          FAR bool *empty);
 
 /****************************************************************************
  * Name: ipv4_fragin
@@ -208,6 +228,7 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
  *
  * Returned Value:
  *   ENOMEM - No memory
+ *   ENOBUFS - The source exceeds its reassembly cache share
  *   OK     - The input fragment is processed as expected
  *
  ****************************************************************************/
@@ -226,6 +247,7 @@ int32_t ipv4_fragin(FAR struct net_driver_s *dev);
  *
  * Returned Value:
  *   ENOMEM - No memory
+ *   ENOBUFS - The source exceeds its reassembly cache share
  *   OK     - The input fragment is processed as expected
  *
  ****************************************************************************/
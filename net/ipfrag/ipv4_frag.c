@@ -252,6 +252,7 @@ ipv4_fragout_buildipv4header(FAR struct ipv4_hdr_s *ref,
  *
  * Returned Value:
  *   ENOMEM - No memory
+ *   ENOBUFS - The source exceeds its reassembly cache share
  *   OK     - The input fragment is processed as expected
  *
  ****************************************************************************/
@@ -261,6 +262,7 @@ int32_t ipv4_fragin(FAR struct net_driver_s *dev)
   FAR struct ip_fragsnode_s *node;
   FAR struct ip_fraglink_s *fraginfo;
   bool restartwdog;
+  int32_t ret;
 
   if (dev->d_len != dev->d_iob->io_pktlen)
     {
@@ -283,7 +285,13 @@ int32_t ipv4_fragin(FAR struct net_driver_s *dev)
 
   /* Need to restart reassembly worker if the original linked list is empty */
 
-  restartwdog = ip_fragin_enqueue(dev, fraginfo);
+  ret = ip_fragin_enqueue(dev, fraginfo, &restartwdog);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&g_ipfrag_lock);
+      kmm_free(fraginfo);
+      return ret;
+    }
 
   node = fraginfo->fragsnode;
 
@@ -296,6 +304,10 @@ int32_t ipv4_fragin(FAR struct net_driver_s *dev)
 
       ip_frag_remnode(node);
 
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipfrag.reass++;
+#endif
+
       /* All fragments belonging to one IP frame have been separated
        * from the fragment processing module, unlocks mutex as soon
        * as possible
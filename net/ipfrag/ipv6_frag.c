@@ -458,6 +458,7 @@ done:
  *
  * Returned Value:
  *   ENOMEM - No memory
+ *   ENOBUFS - The source exceeds its reassembly cache share
  *   OK     - The input fragment is processed as expected
  *
  ****************************************************************************/
@@ -467,6 +468,7 @@ int32_t ipv6_fragin(FAR struct net_driver_s *dev)
   FAR struct ip_fragsnode_s *node = NULL;
   FAR struct ip_fraglink_s *fraginfo = NULL;
   bool restartwdog;
+  int32_t ret;
 
   if (dev->d_len != dev->d_iob->io_pktlen)
     {
@@ -489,7 +491,13 @@ int32_t ipv6_fragin(FAR struct net_driver_s *dev)
 
   /* Need to restart reassembly worker if the original linked list is empty */
 
-  restartwdog = ip_fragin_enqueue(dev, fraginfo);
+  ret = ip_fragin_enqueue(dev, fraginfo, &restartwdog);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&g_ipfrag_lock);
+      kmm_free(fraginfo);
+      return ret;
+    }
 
   node = fraginfo->fragsnode;
   if (node->verifyflag & IP_FRAGVERIFY_RECVDALLFRAGS)
@@ -501,6 +509,10 @@ int32_t ipv6_fragin(FAR struct net_driver_s *dev)
 
       ip_frag_remnode(node);
 
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipfrag.reass++;
+#endif
+
       /* All fragments belonging to one IP frame have been separated
        * from the fragment processing module, unlocks mutex as soon
        * as possible
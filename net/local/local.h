@@ -138,6 +138,18 @@ struct local_conn_s
   mutex_t lc_sendlock;           /* Make sending multi-thread safe */
   mutex_t lc_polllock;           /* Lock for net poll */
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  /* Direct handoff to a receiver that waits on an empty FIFO.  The fields
+   * are protected by the network lock.
+   */
+
+  FAR void *lc_dbuf;             /* Buffer of the waiting receiver */
+  size_t lc_dlen;                /* Size of lc_dbuf */
+  ssize_t lc_dresult;            /* Bytes handed off into lc_dbuf */
+  sem_t lc_dsem;                 /* Wakes up the waiting receiver */
+  uint16_t lc_dwriters;          /* Senders writing to lc_outfile */
+#endif
+
 #ifdef CONFIG_NET_LOCAL_STREAM
   /* SOCK_STREAM fields common to both client and server */
 
@@ -398,6 +410,69 @@ ssize_t local_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 int local_send_packet(FAR struct file *filep, FAR const struct iovec *buf,
                       size_t len, bool preamble);
 
+/****************************************************************************
+ * Name: local_send_direct
+ *
+ * Description:
+ *   Send a packet on a connected socket.  If the peer is waiting in recv()
+ *   on an empty FIFO, the data is copied straight into its buffer;
+ *   anything that does not fit there goes through the FIFO as usual.
+ *
+ * Input Parameters:
+ *   conn     The sending connection, with lc_sendlock held
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   dgram    True for a datagram, which is never split
+ *
+ * Returned Value:
+ *   Packet length is returned on success; a negated errno value is returned
+ *   on any failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DIRECT
+ssize_t local_send_direct(FAR struct local_conn_s *conn,
+                          FAR const struct iovec *buf, size_t len,
+                          bool dgram);
+
+/****************************************************************************
+ * Name: local_recv_direct
+ *
+ * Description:
+ *   Wait for a direct handoff from the peer if the FIFO is empty and the
+ *   call may block.
+ *
+ * Input Parameters:
+ *   conn     The receiving connection
+ *   buf      Buffer to receive data
+ *   len      Length of buffer
+ *   flags    Receive flags
+ *   result   The number of bytes received or a negated errno value
+ *
+ * Returned Value:
+ *   True if the receive was handled and 'result' is valid; false if the
+ *   data must be read from the FIFO.
+ *
+ ****************************************************************************/
+
+bool local_recv_direct(FAR struct local_conn_s *conn, FAR void *buf,
+                       size_t len, int flags, FAR ssize_t *result);
+
+/****************************************************************************
+ * Name: local_direct_hangup
+ *
+ * Description:
+ *   Release a peer waiting for a direct handoff from 'conn' with end of
+ *   file, because 'conn' stops sending.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void local_direct_hangup(FAR struct local_conn_s *conn);
+#endif
+
 /****************************************************************************
  * Name: local_recvmsg
  *
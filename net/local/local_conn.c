@@ -131,6 +131,10 @@ FAR struct local_conn_s *local_alloc(void)
       nxmutex_init(&conn->lc_sendlock);
       nxmutex_init(&conn->lc_polllock);
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+      nxsem_init(&conn->lc_dsem, 0, 0);
+#endif
+
 #ifdef CONFIG_NET_LOCAL_SCM
       conn->lc_cred.pid = nxsched_getpid();
       conn->lc_cred.uid = getuid();
@@ -169,6 +173,10 @@ void local_free(FAR struct local_conn_s *conn)
   net_lock();
   dq_rem(&conn->lc_conn.node, &g_local_connections);
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  local_direct_hangup(conn);
+#endif
+
   if (local_peerconn(conn) && conn->lc_peer)
     {
       conn->lc_peer->lc_peer = NULL;
@@ -219,6 +227,9 @@ void local_free(FAR struct local_conn_s *conn)
 
   nxmutex_destroy(&conn->lc_sendlock);
   nxmutex_destroy(&conn->lc_polllock);
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  nxsem_destroy(&conn->lc_dsem);
+#endif
 
   /* And free the connection structure */
 
@@ -0,0 +1,249 @@
+/****************************************************************************
+ * net/local/local_direct.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_LOCAL_DIRECT)
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+#include "local/local.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_send_direct
+ *
+ * Description:
+ *   Send a packet on a connected socket.  If the peer is waiting in recv()
+ *   on an empty FIFO, the data is copied straight into its buffer;
+ *   anything that does not fit there goes through the FIFO as usual.
+ *
+ ****************************************************************************/
+
+ssize_t local_send_direct(FAR struct local_conn_s *conn,
+                          FAR const struct iovec *buf, size_t len,
+                          bool dgram)
+{
+  FAR const struct iovec *end = buf + len;
+  FAR const struct iovec *iov;
+  FAR struct local_conn_s *peer;
+  struct iovec rest;
+  size_t copied = 0;
+  size_t total = 0;
+  size_t n;
+  ssize_t ret;
+
+  for (iov = buf; iov != end; iov++)
+    {
+      total += iov->iov_len;
+    }
+
+  if (dgram && total > CONFIG_DEV_FIFO_SIZE - sizeof(uint16_t))
+    {
+      return -EMSGSIZE;
+    }
+
+  net_lock();
+
+  peer = conn->lc_peer;
+  if (peer != NULL && peer->lc_dbuf != NULL)
+    {
+      for (iov = buf; iov != end && copied < peer->lc_dlen; iov++)
+        {
+          n = MIN(iov->iov_len, peer->lc_dlen - copied);
+          memcpy((FAR uint8_t *)peer->lc_dbuf + copied, iov->iov_base, n);
+          copied += n;
+        }
+
+      peer->lc_dbuf    = NULL;
+      peer->lc_dresult = copied;
+      nxsem_post(&peer->lc_dsem);
+
+      /* The rest of a datagram is discarded, as by a short recv() */
+
+      if (dgram || copied == total)
+        {
+          net_unlock();
+          return total;
+        }
+    }
+
+  /* While data is on its way into the FIFO, the peer must not wait for a
+   * handoff, or it would miss that data.
+   */
+
+  conn->lc_dwriters++;
+  net_unlock();
+
+  if (copied == 0)
+    {
+      ret = local_send_packet(&conn->lc_outfile, buf, len, dgram);
+    }
+  else
+    {
+      /* Pass the bytes that did not fit into the peer's buffer */
+
+      for (iov = buf, n = copied; n >= iov->iov_len; iov++)
+        {
+          n -= iov->iov_len;
+        }
+
+      rest.iov_base = (FAR uint8_t *)iov->iov_base + n;
+      rest.iov_len  = iov->iov_len - n;
+
+      ret = local_send_packet(&conn->lc_outfile, &rest, 1, false);
+      if (ret == rest.iov_len && ++iov != end)
+        {
+          n   = ret;
+          ret = local_send_packet(&conn->lc_outfile, iov, end - iov, false);
+          ret = ret < 0 ? n : n + ret;
+        }
+
+      ret = ret < 0 ? copied : copied + ret;
+    }
+
+  net_lock();
+  conn->lc_dwriters--;
+  net_unlock();
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_recv_direct
+ *
+ * Description:
+ *   Wait for a direct handoff from the peer if the FIFO is empty and the
+ *   call may block.
+ *
+ ****************************************************************************/
+
+bool local_recv_direct(FAR struct local_conn_s *conn, FAR void *buf,
+                       size_t len, int flags, FAR ssize_t *result)
+{
+  FAR struct local_conn_s *peer;
+  unsigned int timeout;
+  int nread = 0;
+  int ret;
+
+  if (len == 0 || (flags & (MSG_PEEK | MSG_DONTWAIT)) != 0 ||
+      _SS_ISNONBLOCK(conn->lc_conn.s_flags))
+    {
+      return false;
+    }
+
+  /* Only wait for the peer if nothing is, or is about to be, in the FIFO
+   * and the peer can still send.
+   */
+
+  net_lock();
+
+  peer = conn->lc_peer;
+  if (peer == NULL || peer->lc_dwriters > 0 ||
+      peer->lc_outfile.f_inode == NULL ||
+      file_ioctl(&conn->lc_infile, FIONREAD, &nread) < 0 || nread > 0)
+    {
+      net_unlock();
+      return false;
+    }
+
+  conn->lc_dbuf = buf;
+  conn->lc_dlen = len;
+
+  net_unlock();
+
+  timeout = _SO_TIMEOUT(conn->lc_conn.s_rcvtimeo);
+  if (timeout == UINT_MAX)
+    {
+      ret = nxsem_wait(&conn->lc_dsem);
+    }
+  else
+    {
+      ret = nxsem_tickwait(&conn->lc_dsem, MSEC2TICK(timeout));
+    }
+
+  net_lock();
+
+  if (conn->lc_dbuf != NULL)
+    {
+      /* Timed out or interrupted before the peer sent anything */
+
+      conn->lc_dbuf = NULL;
+      *result = ret == -ETIMEDOUT ? -EAGAIN : ret;
+    }
+  else
+    {
+      /* The handoff may have raced with the timeout */
+
+      if (ret < 0)
+        {
+          nxsem_trywait(&conn->lc_dsem);
+        }
+
+      *result = conn->lc_dresult;
+    }
+
+  net_unlock();
+  return true;
+}
+
+/****************************************************************************
+ * Name: local_direct_hangup
+ *
+ * Description:
+ *   Release a peer waiting for a direct handoff from 'conn' with end of
+ *   file, because 'conn' stops sending.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void local_direct_hangup(FAR struct local_conn_s *conn)
+{
+  FAR struct local_conn_s *peer = conn->lc_peer;
+
+  if (peer != NULL && peer->lc_dbuf != NULL)
+    {
+      peer->lc_dbuf    = NULL;
+      peer->lc_dresult = 0;
+      nxsem_post(&peer->lc_dsem);
+    }
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_LOCAL_DIRECT */
@@ -191,7 +191,7 @@ static void local_recvctl(FAR struct local_conn_s *conn,
     {
       if (peer->lc_cfpcount)
         {
-          memmove(peer->lc_cfps[0], peer->lc_cfps[i],
+          memmove(&peer->lc_cfps[0], &peer->lc_cfps[i],
                   sizeof(FAR void *) * peer->lc_cfpcount);
         }
     }
@@ -231,6 +231,9 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 {
   FAR struct local_conn_s *conn = psock->s_conn;
   size_t readlen = len;
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  ssize_t nrecv;
+#endif
   int ret;
 
   /* Verify that this is a connected peer socket */
@@ -266,12 +269,28 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
         }
     }
 
-  /* Read the packet */
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  /* Take the data straight from the peer if the FIFO is empty */
 
-  ret = psock_fifo_read(psock, buf, &readlen, flags, true);
-  if (ret < 0)
+  if (local_recv_direct(conn, buf, len, flags, &nrecv))
     {
-      return ret;
+      if (nrecv < 0)
+        {
+          return nrecv;
+        }
+
+      readlen = nrecv;
+    }
+  else
+#endif
+    {
+      /* Read the packet */
+
+      ret = psock_fifo_read(psock, buf, &readlen, flags, true);
+      if (ret < 0)
+        {
+          return ret;
+        }
     }
 
   /* Return the address family */
@@ -319,6 +338,9 @@ psock_dgram_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
   FAR struct local_conn_s *conn = psock->s_conn;
   size_t readlen;
   bool bclose = false;
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  ssize_t nrecv;
+#endif
   int ret = 0;
 
   /* We keep packet sizes in a uint16_t, so there is a upper limit to the
@@ -364,6 +386,22 @@ psock_dgram_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
         }
     }
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  /* A socket pair may take the datagram straight from the peer */
+
+  if (conn->lc_state == LOCAL_STATE_CONNECTED && conn->pktlen <= 0 &&
+      local_recv_direct(conn, buf, len, flags, &nrecv))
+    {
+      if (nrecv < 0)
+        {
+          return nrecv;
+        }
+
+      readlen = nrecv;
+      goto skip_flush;
+    }
+#endif
+
   /* Sync to the start of the next packet in the stream and get the size of
    * the next packet.
    */
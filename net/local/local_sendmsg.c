@@ -208,8 +208,13 @@ static ssize_t local_send(FAR struct socket *psock,
               return ret;
             }
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+          ret = local_send_direct(peer, buf, len,
+                                  psock->s_type == SOCK_DGRAM);
+#else
           ret = local_send_packet(&peer->lc_outfile, buf, len,
                                   psock->s_type == SOCK_DGRAM);
+#endif
           nxmutex_unlock(&peer->lc_sendlock);
         }
         break;
@@ -969,6 +969,8 @@ static int local_socketpair(FAR struct socket *psocks[2])
 
   conns[0]->lc_state = conns[1]->lc_state
                      = LOCAL_STATE_CONNECTED;
+  conns[0]->lc_peer  = conns[1];
+  conns[1]->lc_peer  = conns[0];
 
 #ifdef CONFIG_NET_LOCAL_DGRAM
   if (psocks[0]->s_type == SOCK_DGRAM)
@@ -1034,6 +1036,12 @@ static int local_shutdown(FAR struct socket *psock, int how)
                   file_close(&conn->lc_outfile);
                   conn->lc_outfile.f_inode = NULL;
                 }
+
+#ifdef CONFIG_NET_LOCAL_DIRECT
+              net_lock();
+              local_direct_hangup(conn);
+              net_unlock();
+#endif
             }
         }
 
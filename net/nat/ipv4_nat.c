@@ -204,10 +204,25 @@ ipv4_nat_inbound_tcp(FAR struct ipv4_hdr_s *ipv4,
   FAR struct tcp_hdr_s      *tcp           = L4_HDR(ipv4);
   FAR uint16_t              *external_ip   = MANIP_IPADDR(ipv4, manip_type);
   FAR uint16_t              *external_port = MANIP_PORT(tcp, manip_type);
-  FAR struct ipv4_nat_entry *entry         =
-                 ipv4_nat_inbound_entry_find(IP_PROTO_TCP,
-                                             net_ip4addr_conv32(external_ip),
-                                             *external_port, true);
+  FAR struct ipv4_nat_entry *entry;
+
+  /* Only the outermost packet (manip type is DST) belongs to a flow. */
+
+  if (manip_type == NAT_MANIP_DST)
+    {
+      entry = ipv4_nat_inbound_flow_find(IP_PROTO_TCP,
+                                         net_ip4addr_conv32(external_ip),
+                                         *external_port,
+                                         net_ip4addr_conv32(ipv4->srcipaddr),
+                                         tcp->srcport, tcp->flags);
+    }
+  else
+    {
+      entry = ipv4_nat_inbound_entry_find(IP_PROTO_TCP,
+                                          net_ip4addr_conv32(external_ip),
+                                          *external_port, true);
+    }
+
   if (!entry)
     {
       return NULL;
@@ -254,10 +269,24 @@ ipv4_nat_inbound_udp(FAR struct ipv4_hdr_s *ipv4,
   FAR uint16_t              *external_ip   = MANIP_IPADDR(ipv4, manip_type);
   FAR uint16_t              *external_port = MANIP_PORT(udp, manip_type);
   FAR uint16_t              *udpchksum;
-  FAR struct ipv4_nat_entry *entry         =
-                 ipv4_nat_inbound_entry_find(IP_PROTO_UDP,
-                                             net_ip4addr_conv32(external_ip),
-                                             *external_port, true);
+  FAR struct ipv4_nat_entry *entry;
+
+  /* Only the outermost packet (manip type is DST) belongs to a flow. */
+
+  if (manip_type == NAT_MANIP_DST)
+    {
+      entry = ipv4_nat_inbound_flow_find(IP_PROTO_UDP,
+                                         net_ip4addr_conv32(external_ip),
+                                         *external_port,
+                                         net_ip4addr_conv32(ipv4->srcipaddr),
+                                         udp->srcport, 0);
+    }
+  else
+    {
+      entry = ipv4_nat_inbound_entry_find(IP_PROTO_UDP,
+                                          net_ip4addr_conv32(external_ip),
+                                          *external_port, true);
+    }
 
   if (!entry)
     {
@@ -417,11 +446,23 @@ ipv4_nat_outbound_tcp(FAR struct net_driver_s *dev,
   FAR uint16_t              *local_port = MANIP_PORT(tcp, manip_type);
   FAR struct ipv4_nat_entry *entry;
 
-  /* Only create entry when it's the outermost packet (manip type is SRC). */
+  /* Only create entry when it's the outermost packet (manip type is SRC),
+   * which is also the only one that belongs to a flow.
+   */
+
+  if (manip_type == NAT_MANIP_SRC)
+    {
+      entry = ipv4_nat_outbound_flow_find(dev, IP_PROTO_TCP,
+                  net_ip4addr_conv32(local_ip), *local_port,
+                  net_ip4addr_conv32(ipv4->destipaddr), tcp->destport,
+                  tcp->flags);
+    }
+  else
+    {
+      entry = ipv4_nat_outbound_entry_find(dev, IP_PROTO_TCP,
+                  net_ip4addr_conv32(local_ip), *local_port, false);
+    }
 
-  entry = ipv4_nat_outbound_entry_find(dev, IP_PROTO_TCP,
-              net_ip4addr_conv32(local_ip), *local_port,
-              (manip_type == NAT_MANIP_SRC));
   if (!entry)
     {
       return NULL;
@@ -471,11 +512,22 @@ ipv4_nat_outbound_udp(FAR struct net_driver_s *dev,
   FAR uint16_t              *udpchksum;
   FAR struct ipv4_nat_entry *entry;
 
-  /* Only create entry when it's the outermost packet (manip type is SRC). */
+  /* Only create entry when it's the outermost packet (manip type is SRC),
+   * which is also the only one that belongs to a flow.
+   */
+
+  if (manip_type == NAT_MANIP_SRC)
+    {
+      entry = ipv4_nat_outbound_flow_find(dev, IP_PROTO_UDP,
+                  net_ip4addr_conv32(local_ip), *local_port,
+                  net_ip4addr_conv32(ipv4->destipaddr), udp->destport, 0);
+    }
+  else
+    {
+      entry = ipv4_nat_outbound_entry_find(dev, IP_PROTO_UDP,
+                  net_ip4addr_conv32(local_ip), *local_port, false);
+    }
 
-  entry = ipv4_nat_outbound_entry_find(dev, IP_PROTO_UDP,
-              net_ip4addr_conv32(local_ip), *local_port,
-              (manip_type == NAT_MANIP_SRC));
   if (!entry)
     {
       return NULL;
@@ -260,6 +260,8 @@ static void ipv4_nat_entry_refresh(FAR struct ipv4_nat_entry *entry)
          * connection, and keep 24h for other TCP connections. However, full
          * cone NAT may have multiple connections on one entry, so this
          * optimization may not work and we only use one expiration time.
+         * With CONFIG_NET_NAT_FLOW the connections of an entry are tracked
+         * and the entry is shortened when the last one closes.
          */
 
         entry->expire_time = TICK2SEC(clock_systime_ticks()) +
@@ -320,6 +322,11 @@ ipv4_nat_entry_create(uint8_t protocol,
   entry->local_ip      = local_ip;
   entry->local_port    = local_port;
 
+#ifdef CONFIG_NET_NAT_FLOW
+  dq_init(&entry->flows);
+  entry->nopen         = 0;
+#endif
+
   ipv4_nat_entry_refresh(entry);
 
   hashtable_add(g_table_inbound, &entry->hash_inbound,
@@ -348,6 +355,10 @@ static void ipv4_nat_entry_delete(FAR struct ipv4_nat_entry *entry)
         entry->protocol, entry->local_ip, entry->local_port,
         entry->external_port);
 
+#ifdef CONFIG_NET_NAT_FLOW
+  ipv4_nat_flow_clear(entry);
+#endif
+
   hashtable_delete(g_table_inbound, &entry->hash_inbound,
                    ipv4_nat_inbound_key(entry->external_ip,
                                         entry->external_port,
@@ -389,6 +400,10 @@ static void ipv4_nat_reclaim_entry(int32_t current_time)
 
       ninfo("INFO: Reclaiming all expired NAT entries.\n");
 
+#ifdef CONFIG_NET_NAT_FLOW
+      ipv4_nat_flow_reclaim(current_time);
+#endif
+
       hashtable_for_every_safe(g_table_inbound, p, tmp, i)
         {
           FAR struct ipv4_nat_entry *entry =
@@ -0,0 +1,482 @@
+/****************************************************************************
+ * net/nat/ipv4_nat_flow.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <debug.h>
+#include <stdint.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/hashtable.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/queue.h>
+#include <nuttx/net/tcp.h>
+
+#include "nat/nat.h"
+
+#if defined(CONFIG_NET_NAT_FLOW) && defined(CONFIG_NET_IPv4)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* TCP state of a flow */
+
+#define NAT_FLOW_FIN_OUT   (1 << 0)  /* FIN sent by the local host */
+#define NAT_FLOW_FIN_IN    (1 << 1)  /* FIN sent by the peer */
+#define NAT_FLOW_CLOSED    (1 << 2)  /* FIN from both sides, or RST seen */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A flow is the 5-tuple of one connection through a NAT entry.  It caches
+ * the entry for the packets in both directions and tracks the TCP state of
+ * the connection, which a full cone entry shared by several connections
+ * cannot do.
+ */
+
+struct ipv4_nat_flow_s
+{
+  hash_node_t hash_inbound;
+  hash_node_t hash_outbound;
+  dq_entry_t  node;          /* Links the flows of one entry */
+
+  FAR struct ipv4_nat_entry *entry;
+
+  in_addr_t   peer_ip;       /* IP address of the peer host */
+  uint16_t    peer_port;     /* Port of the peer host */
+  uint8_t     state;         /* TCP state, see NAT_FLOW_* */
+
+  int32_t     expire_time;   /* The expiration time of this flow */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static DECLARE_HASHTABLE(g_flow_inbound, CONFIG_NET_NAT_HASH_BITS);
+static DECLARE_HASHTABLE(g_flow_outbound, CONFIG_NET_NAT_HASH_BITS);
+
+static int g_nflows;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_nat_flow_key
+ *
+ * Description:
+ *   Create a hash key for a flow from the address of one side of the NAT
+ *   entry and the address of the peer.
+ *
+ ****************************************************************************/
+
+static inline uint32_t ipv4_nat_flow_key(uint8_t protocol,
+                                         in_addr_t ip, uint16_t port,
+                                         in_addr_t peer_ip,
+                                         uint16_t peer_port)
+{
+  return NTOHL(ip) ^ NTOHL(peer_ip) ^ ((uint32_t)protocol << 8) ^
+         ((uint32_t)port << 16) ^ peer_port;
+}
+
+/****************************************************************************
+ * Name: ipv4_nat_flow_delete
+ *
+ * Description:
+ *   Delete a flow and remove it from the flow tables and from its entry.
+ *
+ ****************************************************************************/
+
+static void ipv4_nat_flow_delete(FAR struct ipv4_nat_flow_s *flow)
+{
+  FAR struct ipv4_nat_entry *entry = flow->entry;
+
+  hashtable_delete(g_flow_inbound, &flow->hash_inbound,
+                   ipv4_nat_flow_key(entry->protocol, entry->external_ip,
+                                     entry->external_port, flow->peer_ip,
+                                     flow->peer_port));
+  hashtable_delete(g_flow_outbound, &flow->hash_outbound,
+                   ipv4_nat_flow_key(entry->protocol, entry->local_ip,
+                                     entry->local_port, flow->peer_ip,
+                                     flow->peer_port));
+  dq_rem(&flow->node, &entry->flows);
+
+  if ((flow->state & NAT_FLOW_CLOSED) == 0)
+    {
+      entry->nopen--;
+    }
+
+  g_nflows--;
+  kmm_free(flow);
+}
+
+/****************************************************************************
+ * Name: ipv4_nat_flow_create
+ *
+ * Description:
+ *   Create a flow of an entry.  Fails if there are still
+ *   CONFIG_NET_NAT_FLOW_MAX flows after the expired ones are deleted, the
+ *   packets of the connection then take the entry lookups.
+ *
+ ****************************************************************************/
+
+static FAR struct ipv4_nat_flow_s *
+ipv4_nat_flow_create(FAR struct ipv4_nat_entry *entry,
+                     in_addr_t peer_ip, uint16_t peer_port, int32_t now)
+{
+  FAR struct ipv4_nat_flow_s *flow;
+
+  if (g_nflows >= CONFIG_NET_NAT_FLOW_MAX)
+    {
+      ipv4_nat_flow_reclaim(now);
+      if (g_nflows >= CONFIG_NET_NAT_FLOW_MAX)
+        {
+          return NULL;
+        }
+    }
+
+  flow = kmm_malloc(sizeof(struct ipv4_nat_flow_s));
+  if (flow == NULL)
+    {
+      nwarn("WARNING: Failed to allocate IPv4 NAT flow\n");
+      return NULL;
+    }
+
+  flow->entry       = entry;
+  flow->peer_ip     = peer_ip;
+  flow->peer_port   = peer_port;
+  flow->state       = 0;
+  flow->expire_time = entry->expire_time;
+
+  hashtable_add(g_flow_inbound, &flow->hash_inbound,
+                ipv4_nat_flow_key(entry->protocol, entry->external_ip,
+                                  entry->external_port, peer_ip,
+                                  peer_port));
+  hashtable_add(g_flow_outbound, &flow->hash_outbound,
+                ipv4_nat_flow_key(entry->protocol, entry->local_ip,
+                                  entry->local_port, peer_ip, peer_port));
+  dq_addlast(&flow->node, &entry->flows);
+
+  entry->nopen++;
+  g_nflows++;
+  return flow;
+}
+
+/****************************************************************************
+ * Name: ipv4_nat_flow_update
+ *
+ * Description:
+ *   Account a packet of a flow: follow the TCP state and extend the
+ *   lifetime of the flow and of its entry.
+ *
+ * Input Parameters:
+ *   flow     - The flow of the packet.
+ *   tcpflags - The TCP flags of the packet, zero for other protocols.
+ *   outbound - The packet is sent by the local host.
+ *   now      - The current time in seconds.
+ *
+ ****************************************************************************/
+
+static void ipv4_nat_flow_update(FAR struct ipv4_nat_flow_s *flow,
+                                 uint8_t tcpflags, bool outbound,
+                                 int32_t now)
+{
+  FAR struct ipv4_nat_entry *entry = flow->entry;
+
+  switch (entry->protocol)
+    {
+#ifdef CONFIG_NET_TCP
+      case IP_PROTO_TCP:
+        if ((flow->state & NAT_FLOW_CLOSED) != 0)
+          {
+            /* Keep a closed flow for its remaining segments, only a new
+             * connection on the same 5-tuple opens it again.
+             */
+
+            if ((tcpflags & (TCP_SYN | TCP_ACK)) != TCP_SYN)
+              {
+                return;
+              }
+
+            flow->state = 0;
+            entry->nopen++;
+          }
+
+        if ((tcpflags & TCP_FIN) != 0)
+          {
+            flow->state |= outbound ? NAT_FLOW_FIN_OUT : NAT_FLOW_FIN_IN;
+          }
+
+        if ((tcpflags & TCP_RST) != 0 ||
+            (flow->state & (NAT_FLOW_FIN_OUT | NAT_FLOW_FIN_IN)) ==
+            (NAT_FLOW_FIN_OUT | NAT_FLOW_FIN_IN))
+          {
+            /* RFC2663, Section 2.6: the state of a TCP session may be
+             * dropped a while after both FINs are seen.  Once the last open
+             * connection of the entry is closed, the entry goes with it.
+             */
+
+            flow->state      |= NAT_FLOW_CLOSED;
+            flow->expire_time = now + CONFIG_NET_NAT_TCP_CLOSED_EXPIRE_SEC;
+
+            if (--entry->nopen == 0)
+              {
+                entry->expire_time = flow->expire_time;
+              }
+
+            return;
+          }
+
+        flow->expire_time = now + CONFIG_NET_NAT_TCP_EXPIRE_SEC;
+        break;
+#endif
+
+#ifdef CONFIG_NET_UDP
+      case IP_PROTO_UDP:
+        flow->expire_time = now + CONFIG_NET_NAT_UDP_EXPIRE_SEC;
+        break;
+#endif
+
+      default:
+        return;
+    }
+
+  if (entry->expire_time - flow->expire_time < 0)
+    {
+      entry->expire_time = flow->expire_time;
+    }
+}
+
+/****************************************************************************
+ * Name: ipv4_nat_flow_valid
+ *
+ * Description:
+ *   Check whether a flow and its entry are still alive.  Expired flows are
+ *   deleted, the entry is left to the entry lookups.
+ *
+ ****************************************************************************/
+
+static bool ipv4_nat_flow_valid(FAR struct ipv4_nat_flow_s *flow,
+                                int32_t now)
+{
+  if (flow->expire_time - now <= 0)
+    {
+      ipv4_nat_flow_delete(flow);
+      return false;
+    }
+
+  return flow->entry->expire_time - now > 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_nat_flow_clear
+ *
+ * Description:
+ *   Delete all flows of an entry.  Called when the entry is deleted.
+ *
+ * Input Parameters:
+ *   entry      - The entry whose flows will be deleted.
+ *
+ ****************************************************************************/
+
+void ipv4_nat_flow_clear(FAR struct ipv4_nat_entry *entry)
+{
+  FAR dq_entry_t *node;
+
+  while ((node = dq_peek(&entry->flows)) != NULL)
+    {
+      ipv4_nat_flow_delete(container_of(node, struct ipv4_nat_flow_s,
+                                        node));
+    }
+}
+
+/****************************************************************************
+ * Name: ipv4_nat_flow_reclaim
+ *
+ * Description:
+ *   Delete all expired flows.
+ *
+ * Input Parameters:
+ *   current_time - The current time in seconds.
+ *
+ ****************************************************************************/
+
+void ipv4_nat_flow_reclaim(int32_t current_time)
+{
+  FAR hash_node_t *p;
+  FAR hash_node_t *tmp;
+  int i;
+
+  hashtable_for_every_safe(g_flow_inbound, p, tmp, i)
+    {
+      FAR struct ipv4_nat_flow_s *flow =
+        container_of(p, struct ipv4_nat_flow_s, hash_inbound);
+
+      if (flow->expire_time - current_time <= 0)
+        {
+          ipv4_nat_flow_delete(flow);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: ipv4_nat_inbound_flow_find
+ *
+ * Description:
+ *   Find the entry of a received packet through the flow of its connection,
+ *   so that the packets after the first one of a connection skip the entry
+ *   lookup.  Falls back to ipv4_nat_inbound_entry_find() and creates the
+ *   flow on a miss.
+ *
+ * Input Parameters:
+ *   protocol      - The L4 protocol of the packet.
+ *   external_ip   - The external ip of the packet.
+ *   external_port - The external port of the packet.
+ *   peer_ip       - The ip of the peer that sent the packet.
+ *   peer_port     - The port of the peer that sent the packet.
+ *   tcpflags      - The TCP flags of the packet, zero for other protocols.
+ *
+ * Returned Value:
+ *   Pointer to entry on success; null on failure
+ *
+ ****************************************************************************/
+
+FAR struct ipv4_nat_entry *
+ipv4_nat_inbound_flow_find(uint8_t protocol, in_addr_t external_ip,
+                           uint16_t external_port, in_addr_t peer_ip,
+                           uint16_t peer_port, uint8_t tcpflags)
+{
+  FAR struct ipv4_nat_flow_s *flow;
+  FAR struct ipv4_nat_entry *entry;
+  FAR hash_node_t *p;
+  FAR hash_node_t *tmp;
+  int32_t now = TICK2SEC(clock_systime_ticks());
+
+  hashtable_for_every_possible_safe(g_flow_inbound, p, tmp,
+      ipv4_nat_flow_key(protocol, external_ip, external_port, peer_ip,
+                        peer_port))
+    {
+      flow  = container_of(p, struct ipv4_nat_flow_s, hash_inbound);
+      entry = flow->entry;
+
+      if (entry->protocol == protocol &&
+          net_ipv4addr_cmp(entry->external_ip, external_ip) &&
+          entry->external_port == external_port &&
+          net_ipv4addr_cmp(flow->peer_ip, peer_ip) &&
+          flow->peer_port == peer_port && ipv4_nat_flow_valid(flow, now))
+        {
+          ipv4_nat_flow_update(flow, tcpflags, false, now);
+          return entry;
+        }
+    }
+
+  entry = ipv4_nat_inbound_entry_find(protocol, external_ip, external_port,
+                                      true);
+  if (entry != NULL)
+    {
+      flow = ipv4_nat_flow_create(entry, peer_ip, peer_port, now);
+      if (flow != NULL)
+        {
+          ipv4_nat_flow_update(flow, tcpflags, false, now);
+        }
+    }
+
+  return entry;
+}
+
+/****************************************************************************
+ * Name: ipv4_nat_outbound_flow_find
+ *
+ * Description:
+ *   Find the entry of a packet to be sent through the flow of its
+ *   connection.  Falls back to ipv4_nat_outbound_entry_find(), which
+ *   creates the entry if needed, and creates the flow on a miss.
+ *
+ * Input Parameters:
+ *   dev        - The device on which the packet will be sent.
+ *   protocol   - The L4 protocol of the packet.
+ *   local_ip   - The local ip of the packet.
+ *   local_port - The local port of the packet.
+ *   peer_ip    - The ip of the peer that the packet is sent to.
+ *   peer_port  - The port of the peer that the packet is sent to.
+ *   tcpflags   - The TCP flags of the packet, zero for other protocols.
+ *
+ * Returned Value:
+ *   Pointer to entry on success; null on failure
+ *
+ ****************************************************************************/
+
+FAR struct ipv4_nat_entry *
+ipv4_nat_outbound_flow_find(FAR struct net_driver_s *dev, uint8_t protocol,
+                            in_addr_t local_ip, uint16_t local_port,
+                            in_addr_t peer_ip, uint16_t peer_port,
+                            uint8_t tcpflags)
+{
+  FAR struct ipv4_nat_flow_s *flow;
+  FAR struct ipv4_nat_entry *entry;
+  FAR hash_node_t *p;
+  FAR hash_node_t *tmp;
+  int32_t now = TICK2SEC(clock_systime_ticks());
+
+  hashtable_for_every_possible_safe(g_flow_outbound, p, tmp,
+      ipv4_nat_flow_key(protocol, local_ip, local_port, peer_ip, peer_port))
+    {
+      flow  = container_of(p, struct ipv4_nat_flow_s, hash_outbound);
+      entry = flow->entry;
+
+      if (entry->protocol == protocol &&
+          net_ipv4addr_cmp(entry->external_ip, dev->d_ipaddr) &&
+          net_ipv4addr_cmp(entry->local_ip, local_ip) &&
+          entry->local_port == local_port &&
+          net_ipv4addr_cmp(flow->peer_ip, peer_ip) &&
+          flow->peer_port == peer_port && ipv4_nat_flow_valid(flow, now))
+        {
+          ipv4_nat_flow_update(flow, tcpflags, true, now);
+          return entry;
+        }
+    }
+
+  entry = ipv4_nat_outbound_entry_find(dev, protocol, local_ip, local_port,
+                                       true);
+  if (entry != NULL)
+    {
+      flow = ipv4_nat_flow_create(entry, peer_ip, peer_port, now);
+      if (flow != NULL)
+        {
+          ipv4_nat_flow_update(flow, tcpflags, true, now);
+        }
+    }
+
+  return entry;
+}
+
+#endif /* CONFIG_NET_NAT_FLOW && CONFIG_NET_IPv4 */
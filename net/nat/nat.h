@@ -65,6 +65,11 @@ struct ipv4_nat_entry
   uint8_t    protocol;       /* L4 protocol (TCP, UDP etc). */
 
   int32_t    expire_time;    /* The expiration time of this entry. */
+
+#ifdef CONFIG_NET_NAT_FLOW
+  dq_queue_t flows;          /* The connections through this entry. */
+  uint16_t   nopen;          /* Number of these not closed yet. */
+#endif
 };
 
 /* NAT IP/Port manipulate type, to indicate whether to manipulate source or
@@ -238,5 +243,102 @@ ipv4_nat_outbound_entry_find(FAR struct net_driver_s *dev, uint8_t protocol,
                              in_addr_t local_ip, uint16_t local_port,
                              bool try_create);
 
+/****************************************************************************
+ * Name: ipv4_nat_flow_clear
+ *
+ * Description:
+ *   Delete all flows of an entry.  Called when the entry is deleted.
+ *
+ * Input Parameters:
+ *   entry      - The entry whose flows will be deleted.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_NAT_FLOW
+void ipv4_nat_flow_clear(FAR struct ipv4_nat_entry *entry);
+#endif
+
+/****************************************************************************
+ * Name: ipv4_nat_flow_reclaim
+ *
+ * Description:
+ *   Delete all expired flows.
+ *
+ * Input Parameters:
+ *   current_time - The current time in seconds.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_NAT_FLOW
+void ipv4_nat_flow_reclaim(int32_t current_time);
+#endif
+
+/****************************************************************************
+ * Name: ipv4_nat_inbound_flow_find
+ *
+ * Description:
+ *   Find the entry of a received packet through the flow of its connection,
+ *   so that the packets after the first one of a connection skip the entry
+ *   lookup.  Falls back to ipv4_nat_inbound_entry_find() and creates the
+ *   flow on a miss.
+ *
+ * Input Parameters:
+ *   protocol      - The L4 protocol of the packet.
+ *   external_ip   - The external ip of the packet.
+ *   external_port - The external port of the packet.
+ *   peer_ip       - The ip of the peer that sent the packet.
+ *   peer_port     - The port of the peer that sent the packet.
+ *   tcpflags      - The TCP flags of the packet, zero for other protocols.
+ *
+ * Returned Value:
+ *   Pointer to entry on success; null on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_NAT_FLOW
+FAR struct ipv4_nat_entry *
+ipv4_nat_inbound_flow_find(uint8_t protocol, in_addr_t external_ip,
+                           uint16_t external_port, in_addr_t peer_ip,
+                           uint16_t peer_port, uint8_t tcpflags);
+#else
+#  define ipv4_nat_inbound_flow_find(protocol, external_ip, external_port, \
+                                     peer_ip, peer_port, tcpflags) \
+     ipv4_nat_inbound_entry_find(protocol, external_ip, external_port, true)
+#endif
+
+/****************************************************************************
+ * Name: ipv4_nat_outbound_flow_find
+ *
+ * Description:
+ *   Find the entry of a packet to be sent through the flow of its
+ *   connection.  Falls back to ipv4_nat_outbound_entry_find(), which
+ *   creates the entry if needed, and creates the flow on a miss.
+ *
+ * Input Parameters:
+ *   dev        - The device on which the packet will be sent.
+ *   protocol   - The L4 protocol of the packet.
+ *   local_ip   - The local ip of the packet.
+ *   local_port - The local port of the packet.
+ *   peer_ip    - The ip of the peer that the packet is sent to.
+ *   peer_port  - The port of the peer that the packet is sent to.
+ *   tcpflags   - The TCP flags of the packet, zero for other protocols.
+ *
+ * Returned Value:
+ *   Pointer to entry on success; null on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_NAT_FLOW
+FAR struct ipv4_nat_entry *
+ipv4_nat_outbound_flow_find(FAR struct net_driver_s *dev, uint8_t protocol,
+                            in_addr_t local_ip, uint16_t local_port,
+                            in_addr_t peer_ip, uint16_t peer_port,
+                            uint8_t tcpflags);
+#else
+#  define ipv4_nat_outbound_flow_find(dev, protocol, local_ip, local_port, \
+                                      peer_ip, peer_port, tcpflags) \
+     ipv4_nat_outbound_entry_find(dev, protocol, local_ip, local_port, true)
+#endif
+
 #endif /* CONFIG_NET_NAT && CONFIG_NET_IPv4 */
 #endif /* __NET_NAT_NAT_H */
@@ -30,6 +30,7 @@
 
 #include <net/ethernet.h>
 
+#include <nuttx/queue.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/sixlowpan.h>
@@ -37,15 +38,36 @@
 
 #ifdef CONFIG_NET_IPv6
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One slot of the Neighbor table.  The entry itself is what netlink
+ * reports, the links are internal.
+ */
+
+struct neighbor_cache_s
+{
+  dq_entry_t                   nc_node;   /* LRU list, most recent first */
+  FAR struct neighbor_cache_s *nc_hnext;  /* Next entry in the hash bucket */
+  struct neighbor_entry_s      nc_entry;  /* The neighbor */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
 /* This is the Neighbor table.  The network should be locked when accessing
- * this table.
+ * this table.  The used slots are also linked in hash buckets by IPv6
+ * address.  All slots are on the LRU list: the most recently used at the
+ * head, unused slots at the tail, where the next slot to fill is taken
+ * from.
  */
 
-extern struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+extern struct neighbor_cache_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+extern FAR struct neighbor_cache_s *
+g_neighbor_hash[CONFIG_NET_IPv6_NCONF_ENTRIES];
+extern dq_queue_t g_neighbor_lru;
 
 /****************************************************************************
  * Public Function Prototypes
@@ -53,6 +75,23 @@ extern struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
 struct net_driver_s; /* Forward reference */
 
+/****************************************************************************
+ * Name: neighbor_bucket
+ *
+ * Description:
+ *   Return the hash bucket of an IPv6 address.  This interface is internal
+ *   to the neighbor implementation.
+ *
+ * Input Parameters:
+ *   ipaddr - The IPv6 address
+ *
+ * Returned Value:
+ *   The head of the bucket list.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_cache_s **neighbor_bucket(const net_ipv6addr_t ipaddr);
+
 /****************************************************************************
  * Name: neighbor_findentry
  *
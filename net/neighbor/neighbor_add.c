@@ -36,6 +36,7 @@
 #include <nuttx/net/neighbor.h>
 
 #include "netdev/netdev.h"
+#include "inet/inet.h"
 #include "neighbor/neighbor.h"
 
 /****************************************************************************
@@ -62,53 +63,85 @@
 void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
                   FAR uint8_t *addr)
 {
+  FAR struct neighbor_cache_s **bucket;
+  FAR struct neighbor_cache_s **prev;
+  FAR struct neighbor_cache_s *cache;
+  FAR struct neighbor_entry_s *neighbor;
   uint8_t lltype;
-  clock_t oldest_time;
-  int     oldest_ndx;
   int     i;
 
   DEBUGASSERT(dev != NULL && addr != NULL);
 
-  /* Find the matching entry, first unused entry, or the oldest used entry.
-   * The unused entry will have ne_time == 0 and should generate the oldest
-   * time.  REVISIT:  Could this fail on clock wraparound?  A more explicit
-   * check might be to compare ne_ipaddr with the IPv6 unspecified address.
+  /* The unspecified address marks an unused entry */
+
+  if (net_ipv6addr_cmp(ipaddr, g_ipv6_unspecaddr))
+    {
+      return;
+    }
+
+  /* Place all entries on the LRU list the first time */
+
+  if (dq_empty(&g_neighbor_lru))
+    {
+      for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+        {
+          dq_addlast(&g_neighbors[i].nc_node, &g_neighbor_lru);
+        }
+    }
+
+  /* Find the matching entry in the hash bucket of the address, or else
+   * take the least recently used entry, which is an unused one if there is
+   * any.
    */
 
-  oldest_time = g_neighbors[0].ne_time;
-  oldest_ndx  = 0;
-  lltype      = dev->d_lltype;
+  lltype = dev->d_lltype;
+  bucket = neighbor_bucket(ipaddr);
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (cache = *bucket; cache != NULL; cache = cache->nc_hnext)
     {
-      if (g_neighbors[i].ne_addr.na_lltype == lltype &&
-          net_ipv6addr_cmp(g_neighbors[i].ne_ipaddr, ipaddr))
+      if (cache->nc_entry.ne_addr.na_lltype == lltype &&
+          net_ipv6addr_cmp(cache->nc_entry.ne_ipaddr, ipaddr))
         {
-          oldest_ndx = i;
           break;
         }
+    }
+
+  if (cache == NULL)
+    {
+      cache = (FAR struct neighbor_cache_s *)dq_tail(&g_neighbor_lru);
+
+      /* A used entry is evicted from its bucket first */
 
-      if ((int)(g_neighbors[i].ne_time - oldest_time) < 0)
+      if (!net_ipv6addr_cmp(cache->nc_entry.ne_ipaddr, g_ipv6_unspecaddr))
         {
-          oldest_ndx = i;
-          oldest_time = g_neighbors[i].ne_time;
+          for (prev = neighbor_bucket(cache->nc_entry.ne_ipaddr);
+               *prev != NULL; prev = &(*prev)->nc_hnext)
+            {
+              if (*prev == cache)
+                {
+                  *prev = cache->nc_hnext;
+                  break;
+                }
+            }
         }
+
+      cache->nc_hnext = *bucket;
+      *bucket         = cache;
     }
 
-  /* Use the oldest or first free entry (either pointed to by the
-   * "oldest_ndx" variable).
-   */
+  dq_rem(&cache->nc_node, &g_neighbor_lru);
+  dq_addfirst(&cache->nc_node, &g_neighbor_lru);
 
-  g_neighbors[oldest_ndx].ne_time = clock_systime_ticks();
-  net_ipv6addr_copy(g_neighbors[oldest_ndx].ne_ipaddr, ipaddr);
+  neighbor = &cache->nc_entry;
+  neighbor->ne_time = clock_systime_ticks();
+  net_ipv6addr_copy(neighbor->ne_ipaddr, ipaddr);
 
-  g_neighbors[oldest_ndx].ne_addr.na_lltype = lltype;
-  g_neighbors[oldest_ndx].ne_addr.na_llsize = netdev_lladdrsize(dev);
+  neighbor->ne_addr.na_lltype = lltype;
+  neighbor->ne_addr.na_llsize = netdev_lladdrsize(dev);
 
-  memcpy(&g_neighbors[oldest_ndx].ne_addr.u, addr,
-         g_neighbors[oldest_ndx].ne_addr.na_llsize);
+  memcpy(&neighbor->ne_addr.u, addr, neighbor->ne_addr.na_llsize);
 
   /* Dump the contents of the new entry */
 
-  neighbor_dumpentry("Added entry", &g_neighbors[oldest_ndx]);
+  neighbor_dumpentry("Added entry", neighbor);
 }
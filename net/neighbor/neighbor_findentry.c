@@ -51,14 +51,20 @@
 
 FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr)
 {
-  int i;
+  FAR struct neighbor_cache_s *cache;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (cache = *neighbor_bucket(ipaddr); cache != NULL;
+       cache = cache->nc_hnext)
     {
-      FAR struct neighbor_entry_s *neighbor = &g_neighbors[i];
+      FAR struct neighbor_entry_s *neighbor = &cache->nc_entry;
 
       if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
         {
+          /* Make it the most recently used entry */
+
+          dq_rem(&cache->nc_node, &g_neighbor_lru);
+          dq_addfirst(&cache->nc_node, &g_neighbor_lru);
+
           neighbor_dumpentry("Entry found", neighbor);
           return neighbor;
         }
@@ -34,8 +34,33 @@
  * this table.
  */
 
-struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+struct neighbor_cache_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+FAR struct neighbor_cache_s *g_neighbor_hash[CONFIG_NET_IPv6_NCONF_ENTRIES];
+dq_queue_t g_neighbor_lru;
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_bucket
+ *
+ * Description:
+ *   Return the hash bucket of an IPv6 address.  Neighbors usually share the
+ *   prefix, so the whole address is folded in.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_cache_s **neighbor_bucket(const net_ipv6addr_t ipaddr)
+{
+  uint16_t hash = 0;
+  int i;
+
+  for (i = 0; i < 8; i++)
+    {
+      hash ^= ipaddr[i];
+    }
+
+  hash ^= hash >> 8;
+  return &g_neighbor_hash[hash % CONFIG_NET_IPv6_NCONF_ENTRIES];
+}
@@ -0,0 +1,350 @@
+/****************************************************************************
+ * net/netdev/netdev_gro.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/ethernet.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+#include "utils/utils.h"
+
+#ifdef CONFIG_NETDEV_GRO
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Segments with these flags are never merged */
+
+#define GRO_NOMERGE      (TCP_FIN | TCP_SYN | TCP_RST | TCP_URG)
+
+#define GRO_TCPHDRLEN(tcp) (((tcp)->tcpoffset >> 4) << 2)
+#define GRO_TCPBUF(iob)  ((FAR struct tcp_hdr_s *) \
+                          (IOB_DATA(iob) + IPv4_HDRLEN))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: gro_add
+ *
+ * Description:
+ *   Add two one's complement sums.
+ *
+ ****************************************************************************/
+
+static inline uint16_t gro_add(uint16_t a, uint16_t b)
+{
+  uint32_t sum = (uint32_t)a + b;
+
+  return (uint16_t)((sum & 0xffff) + (sum >> 16));
+}
+
+/****************************************************************************
+ * Name: gro_hdrsum
+ *
+ * Description:
+ *   Sum the pseudo-header and the TCP header of a segment.
+ *
+ ****************************************************************************/
+
+static uint16_t gro_hdrsum(FAR struct ipv4_hdr_s *ipv4,
+                           FAR struct tcp_hdr_s *tcp, uint16_t tcplen)
+{
+  uint16_t sum;
+
+  sum = tcplen + IP_PROTO_TCP;
+  sum = chksum(sum, (FAR uint8_t *)&ipv4->srcipaddr, 2 * sizeof(in_addr_t));
+  return chksum(sum, (FAR uint8_t *)tcp, GRO_TCPHDRLEN(tcp));
+}
+
+/****************************************************************************
+ * Name: gro_segment
+ *
+ * Description:
+ *   Check if the frame in d_iob is an IPv4 TCP segment with data that may
+ *   be merged with others.
+ *
+ * Returned Value:
+ *   The TCP header of the segment, NULL if it must be passed on as it is.
+ *
+ ****************************************************************************/
+
+static FAR struct tcp_hdr_s *gro_segment(FAR struct net_driver_s *dev,
+                                         FAR uint16_t *datalen)
+{
+  FAR struct iob_s *iob = dev->d_iob;
+  FAR struct eth_hdr_s *eth;
+  FAR struct ipv4_hdr_s *ipv4;
+  FAR struct tcp_hdr_s *tcp;
+  uint16_t totlen;
+  uint16_t hdrlen;
+
+  if (dev->d_lltype != NET_LL_ETHERNET || iob == NULL ||
+      iob->io_len < IPv4_HDRLEN + TCP_HDRLEN)
+    {
+      return NULL;
+    }
+
+  eth  = NETLLBUF;
+  ipv4 = IPv4BUF;
+
+  /* No IPv4 options and no fragments */
+
+  if (eth->type != HTONS(ETHTYPE_IP) || ipv4->vhl != 0x45 ||
+      ipv4->proto != IP_PROTO_TCP ||
+      ((((uint16_t)ipv4->ipoffset[0] << 8) | ipv4->ipoffset[1]) &
+       ~IP_FLAG_DONTFRAG) != 0)
+    {
+      return NULL;
+    }
+
+  /* The headers must be in the first buffer and the frame not padded */
+
+  tcp    = IPBUF(IPv4_HDRLEN);
+  totlen = ((uint16_t)ipv4->len[0] << 8) + ipv4->len[1];
+  hdrlen = IPv4_HDRLEN + GRO_TCPHDRLEN(tcp);
+
+  if (GRO_TCPHDRLEN(tcp) < TCP_HDRLEN || hdrlen > iob->io_len ||
+      hdrlen >= totlen || totlen != iob->io_pktlen ||
+      (tcp->flags & TCP_ACK) == 0 || (tcp->flags & GRO_NOMERGE) != 0)
+    {
+      return NULL;
+    }
+
+  *datalen = totlen - hdrlen;
+  return tcp;
+}
+
+/****************************************************************************
+ * Name: gro_merge
+ *
+ * Description:
+ *   Append the segment in d_iob to the held one if it is the next segment
+ *   of the same flow and its headers only differ in the window.
+ *
+ * Returned Value:
+ *   True if the segment was merged and d_iob taken.
+ *
+ ****************************************************************************/
+
+static bool gro_merge(FAR struct net_driver_s *dev,
+                      FAR struct tcp_hdr_s *tcp, uint16_t datalen)
+{
+  FAR struct iob_s *held = dev->d_groiob;
+  FAR struct ipv4_hdr_s *hipv4 = (FAR struct ipv4_hdr_s *)IOB_DATA(held);
+  FAR struct tcp_hdr_s *htcp = GRO_TCPBUF(held);
+  FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+  FAR struct iob_s *iob;
+  uint16_t hdrlen = GRO_TCPHDRLEN(tcp);
+  uint16_t sum;
+
+  if (dev->d_gronsegs >= CONFIG_NETDEV_GRO_MAXSEGS ||
+      held->io_pktlen + datalen > UINT16_MAX ||
+      tcp_getsequence(tcp->seqno) != dev->d_groseq ||
+      ipv4->tos != hipv4->tos ||
+      memcmp(ipv4->srcipaddr, hipv4->srcipaddr,
+             2 * sizeof(in_addr_t)) != 0 ||
+      tcp->srcport != htcp->srcport || tcp->destport != htcp->destport ||
+      memcmp(tcp->ackno, htcp->ackno, sizeof(tcp->ackno)) != 0 ||
+      tcp->tcpoffset != htcp->tcpoffset ||
+      memcmp(tcp->optdata, htcp->optdata, hdrlen - TCP_HDRLEN) != 0)
+    {
+      return false;
+    }
+
+  /* The payload sum is taken from the checksum of the segment, as if it
+   * were right.  A wrong one makes the checksum of the merged segment
+   * wrong, so tcp_input() still drops it.
+   */
+
+  sum = ~gro_hdrsum(ipv4, tcp, hdrlen + datalen);
+
+  iob = iob_trimhead(dev->d_iob, IPv4_HDRLEN + hdrlen);
+  dev->d_iob = NULL;
+  dev->d_len = 0;
+
+  iob_concat(held, iob);
+
+  memcpy(htcp->wnd, tcp->wnd, sizeof(htcp->wnd));
+  htcp->flags |= tcp->flags & TCP_PSH;
+
+  dev->d_groseq += datalen;
+  dev->d_grosum  = gro_add(dev->d_grosum, sum);
+  dev->d_gronsegs++;
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: gro_finish
+ *
+ * Description:
+ *   Update the length and the checksums of a merged segment.
+ *
+ ****************************************************************************/
+
+static void gro_finish(FAR struct net_driver_s *dev)
+{
+  FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+  FAR struct tcp_hdr_s *tcp = GRO_TCPBUF(dev->d_iob);
+  uint16_t totlen = dev->d_iob->io_pktlen;
+  uint16_t sum;
+
+  ipv4->len[0]   = totlen >> 8;
+  ipv4->len[1]   = totlen & 0xff;
+  ipv4->ipchksum = 0;
+  ipv4->ipchksum = ~ipv4_chksum(ipv4);
+
+  tcp->tcpchksum = 0;
+  sum = gro_hdrsum(ipv4, tcp, totlen - IPv4_HDRLEN);
+  sum = gro_add(sum, dev->d_grosum);
+  tcp->tcpchksum = HTONS((uint16_t)~sum);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_gro_receive
+ *
+ * Description:
+ *   Offer a received frame in d_iob to the receive offload.  Consecutive
+ *   in-order TCP segments of the same flow are merged into one IOB chain,
+ *   which then goes through the TCP input processing only once.
+ *
+ *   A driver receiving a batch of frames calls this for each frame and
+ *   netdev_gro_flush() at the end of the batch.
+ *
+ * Input Parameters:
+ *   dev   - The network device that received the frame
+ *   input - The link layer input function of the device
+ *
+ * Returned Value:
+ *   True if the frame was taken.  Otherwise the caller must pass it to
+ *   input() itself; any frame held before it has already been passed on.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool netdev_gro_receive(FAR struct net_driver_s *dev,
+                        netdev_gro_input_t input)
+{
+  FAR struct tcp_hdr_s *tcp;
+  uint16_t datalen;
+
+  tcp = gro_segment(dev, &datalen);
+  if (tcp != NULL && dev->d_groiob != NULL &&
+      gro_merge(dev, tcp, datalen))
+    {
+      /* The sums only add up while the merged data has an even length */
+
+      if ((GRO_TCPBUF(dev->d_groiob)->flags & TCP_PSH) != 0 ||
+          (datalen & 1) != 0)
+        {
+          netdev_gro_flush(dev, input);
+        }
+
+      return true;
+    }
+
+  netdev_gro_flush(dev, input);
+
+  if (tcp == NULL || (tcp->flags & TCP_PSH) != 0 || (datalen & 1) != 0)
+    {
+      return false;
+    }
+
+  /* Hold the segment for the ones that may follow */
+
+  dev->d_groiob  = dev->d_iob;
+  dev->d_groseq  = tcp_getsequence(tcp->seqno) + datalen;
+  dev->d_grosum  = ~gro_hdrsum(IPv4BUF, tcp,
+                               GRO_TCPHDRLEN(tcp) + datalen);
+  dev->d_gronsegs = 1;
+
+  dev->d_iob = NULL;
+  dev->d_len = 0;
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: netdev_gro_flush
+ *
+ * Description:
+ *   Pass the held segment, if any, to the link layer input function.
+ *
+ * Input Parameters:
+ *   dev   - The network device
+ *   input - The link layer input function of the device
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void netdev_gro_flush(FAR struct net_driver_s *dev,
+                      netdev_gro_input_t input)
+{
+  FAR struct iob_s *iob = dev->d_iob;
+  FAR uint8_t *buf = dev->d_buf;
+  uint16_t len = dev->d_len;
+
+  if (dev->d_groiob == NULL)
+    {
+      return;
+    }
+
+  dev->d_iob    = dev->d_groiob;
+  dev->d_groiob = NULL;
+
+  if (dev->d_gronsegs > 1)
+    {
+      gro_finish(dev);
+    }
+
+  dev->d_len = dev->d_iob->io_pktlen + NET_LL_HDRLEN(dev);
+  input(dev);
+
+  netdev_iob_release(dev);
+
+  dev->d_iob = iob;
+  dev->d_buf = buf;
+  dev->d_len = len;
+}
+
+#endif /* CONFIG_NETDEV_GRO */
@@ -714,6 +714,8 @@ static ssize_t net_ioctl_ifreq_arglen(int cmd)
       case SIOCSIFNAME:
       case SIOCGIFNAME:
       case SIOCGIFINDEX:
+      case SIOCSHWTSTAMP:
+      case SIOCGHWTSTAMP:
         return sizeof(struct ifreq);
 
       case SIOCGLIFADDR:
@@ -1128,6 +1130,21 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
         break;
 #endif
 
+#if defined(CONFIG_NETDEV_IOCTL) && defined(CONFIG_NET_TIMESTAMPING)
+      case SIOCSHWTSTAMP:  /* Set the hardware timestamping configuration */
+      case SIOCGHWTSTAMP:  /* Get the hardware timestamping configuration */
+        if (dev->d_ioctl && req->ifr_data != NULL)
+          {
+            ret = dev->d_ioctl(dev, cmd,
+                               (unsigned long)(uintptr_t)req->ifr_data);
+          }
+        else
+          {
+            ret = req->ifr_data == NULL ? -EINVAL : -ENOSYS;
+          }
+        break;
+#endif
+
       default:
         ret = -ENOTTY;
         break;
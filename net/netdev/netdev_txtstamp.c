@@ -0,0 +1,71 @@
+/****************************************************************************
+ * net/netdev/netdev_txtstamp.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "udp/udp.h"
+
+#ifdef CONFIG_NET_TIMESTAMPING
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_txtstamp
+ *
+ * Description:
+ *   Report the hardware transmit timestamp of a packet.  'handle' is the
+ *   value of d_txtstamp when the packet was polled.  Handles of sockets
+ *   that have been closed meanwhile are ignored.
+ *
+ * Input Parameters:
+ *   dev    - The device that sent the packet
+ *   handle - The d_txtstamp value saved with the packet
+ *   ts     - The time the packet was sent, in the time base of the device
+ *
+ * Returned Value:
+ *  None
+ *
+ ****************************************************************************/
+
+void netdev_txtstamp(FAR struct net_driver_s *dev, FAR void *handle,
+                     FAR const struct timespec *ts)
+{
+  DEBUGASSERT(dev != NULL && ts != NULL);
+
+  if (handle != NULL)
+    {
+      net_lock();
+      udp_tstamp_txdone(handle, ts);
+      net_unlock();
+    }
+}
+
+#endif /* CONFIG_NET_TIMESTAMPING */
@@ -25,6 +25,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
 #include <debug.h>
@@ -55,6 +56,15 @@ static int netprocfs_ipv4_dropped(FAR struct netprocfs_file_s *netfile);
 #ifdef CONFIG_NET_IPv6
 static int netprocfs_ipv6_dropped(FAR struct netprocfs_file_s *netfile);
 #endif /* CONFIG_NET_IPv4 */
+#ifdef CONFIG_NET_IPFRAG
+static int netprocfs_ipfrag(FAR struct netprocfs_file_s *netfile);
+#endif /* CONFIG_NET_IPFRAG */
+#ifdef CONFIG_NET_6LOWPAN
+static int netprocfs_sixlowpan(FAR struct netprocfs_file_s *netfile);
+#endif /* CONFIG_NET_6LOWPAN */
+#ifdef CONFIG_NET_STATISTICS_PERF
+static int netprocfs_perf(FAR struct netprocfs_file_s *netfile);
+#endif /* CONFIG_NET_STATISTICS_PERF */
 static int netprocfs_checksum(FAR struct netprocfs_file_s *netfile);
 #ifdef CONFIG_NET_TCP
 static int netprocfs_tcp_dropped_1(FAR struct netprocfs_file_s *netfile);
@@ -86,6 +96,18 @@ static const linegen_t g_stat_linegen[] =
   netprocfs_ipv6_dropped,
 #endif /* CONFIG_NET_IPv4 */
 
+#ifdef CONFIG_NET_IPFRAG
+  netprocfs_ipfrag,
+#endif /* CONFIG_NET_IPFRAG */
+
+#ifdef CONFIG_NET_6LOWPAN
+  netprocfs_sixlowpan,
+#endif /* CONFIG_NET_6LOWPAN */
+
+#ifdef CONFIG_NET_STATISTICS_PERF
+  netprocfs_perf,
+#endif /* CONFIG_NET_STATISTICS_PERF */
+
   netprocfs_checksum,
 
 #ifdef CONFIG_NET_TCP
@@ -247,6 +269,54 @@ static int netprocfs_ipv6_dropped(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_IPv6 */
 
+/****************************************************************************
+ * Name: netprocfs_ipfrag
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_IPFRAG)
+static int netprocfs_ipfrag(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "  IPfrag       Ok: %04x Tmo: %04x Evc: %04x Lim: %04x\n",
+                  g_netstats.ipfrag.reass, g_netstats.ipfrag.timeout,
+                  g_netstats.ipfrag.evicted, g_netstats.ipfrag.overlimit);
+}
+#endif /* CONFIG_NET_STATISTICS && CONFIG_NET_IPFRAG */
+
+/****************************************************************************
+ * Name: netprocfs_sixlowpan
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_6LOWPAN)
+static int netprocfs_sixlowpan(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "  6LoWPAN      Ok: %04x Tmo: %04x Buf: %04x "
+                  "Hit: %04x Mis: %04x\n",
+                  g_netstats.sixlowpan.reass, g_netstats.sixlowpan.timeout,
+                  g_netstats.sixlowpan.nobuf, g_netstats.sixlowpan.cachehit,
+                  g_netstats.sixlowpan.cachemiss);
+}
+#endif /* CONFIG_NET_STATISTICS && CONFIG_NET_6LOWPAN */
+
+/****************************************************************************
+ * Name: netprocfs_perf
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_STATISTICS_PERF
+static int netprocfs_perf(FAR struct netprocfs_file_s *netfile)
+{
+  uint32_t rxpkts = g_netstats.perf.rxpkts;
+
+  return snprintf(netfile->line, NET_LINELEN,
+                  "  RxCost       Pkts: %" PRIu32 " Avg: %lu Max: %lu\n",
+                  rxpkts,
+                  rxpkts > 0 ?
+                  (unsigned long)(g_netstats.perf.rxtime / rxpkts) : 0,
+                  g_netstats.perf.rxmax);
+}
+#endif /* CONFIG_NET_STATISTICS_PERF */
+
 /****************************************************************************
  * Name: netprocfs_checksum
  ****************************************************************************/
@@ -128,6 +128,10 @@ void net_init_ramroute(void)
       ramroute_ipv6_addlast(&g_prealloc_ipv6routes[i], &g_free_ipv6routes);
     }
 #endif
+
+#ifdef CONFIG_ROUTE_TRIE
+  net_init_trieroute();
+#endif
 }
 
 /****************************************************************************
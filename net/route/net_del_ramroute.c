@@ -98,6 +98,8 @@ static int net_match_ipv4(FAR struct net_route_ipv4_s *route, FAR void *arg)
     {
       /* They match.. Remove the entry from the routing table */
 
+      net_trie_delroute_ipv4((FAR struct net_route_ipv4_entry_s *)route);
+
       if (match->prev)
         {
           ramroute_ipv4_remafter(
@@ -154,6 +156,8 @@ static int net_match_ipv6(
     {
       /* They match.. Remove the entry from the routing table */
 
+      net_trie_delroute_ipv6((FAR struct net_route_ipv6_entry_s *)route);
+
       if (match->prev)
         {
           ramroute_ipv6_remafter(
@@ -0,0 +1,684 @@
+/****************************************************************************
+ * net/route/net_trie_ramroute.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/ip.h>
+
+#include "route/ramroute.h"
+#include "route/route.h"
+
+#ifdef CONFIG_ROUTE_TRIE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+#  define TRIE_KEYLEN 16
+#else
+#  define TRIE_KEYLEN 4
+#endif
+
+/* A trie over N routes needs at most N - 1 branch nodes */
+
+#define TRIE_IPv4_NNODES (2 * CONFIG_ROUTE_MAX_IPv4_RAMROUTES)
+#define TRIE_IPv6_NNODES (2 * CONFIG_ROUTE_MAX_IPv6_RAMROUTES)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One node of a path-compressed binary trie.  The prefix of a node extends
+ * the prefix of its parent, bit 'plen' of a key selects the child to
+ * descend to.  A node without routes only exists as a branch point.
+ */
+
+struct route_trie_s
+{
+  FAR struct route_trie_s *parent;
+  FAR struct route_trie_s *child[2];
+  FAR void *routes;              /* Routes of exactly this prefix */
+  uint8_t   plen;                /* Prefix length in bits */
+  uint8_t   key[TRIE_KEYLEN];    /* Prefix, network order, rest zeroed */
+};
+
+struct route_trie_table_s
+{
+  FAR struct route_trie_s *root;
+  FAR struct route_trie_s *free;
+  unsigned int nirregular;       /* Routes with a non-prefix netmask */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+static struct route_trie_s g_ipv4_trienodes[TRIE_IPv4_NNODES];
+static struct route_trie_table_s g_ipv4_trie;
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+static struct route_trie_s g_ipv6_trienodes[TRIE_IPv6_NNODES];
+static struct route_trie_table_s g_ipv6_trie;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: trie_bit
+ *
+ * Description:
+ *   Return bit 'n' of a key, counting from the most significant bit of the
+ *   first byte.
+ *
+ ****************************************************************************/
+
+static inline int trie_bit(FAR const uint8_t *key, int n)
+{
+  return (key[n >> 3] >> (7 - (n & 7))) & 1;
+}
+
+/****************************************************************************
+ * Name: trie_common
+ *
+ * Description:
+ *   Return the number of leading bits, up to 'maxbits', that two keys have
+ *   in common.
+ *
+ ****************************************************************************/
+
+static int trie_common(FAR const uint8_t *a, FAR const uint8_t *b,
+                       int maxbits)
+{
+  uint8_t diff;
+  int n;
+
+  for (n = 0; n < maxbits; n += 8)
+    {
+      diff = a[n >> 3] ^ b[n >> 3];
+      if (diff != 0)
+        {
+          while ((diff & 0x80) == 0)
+            {
+              diff <<= 1;
+              n++;
+            }
+
+          break;
+        }
+    }
+
+  return n < maxbits ? n : maxbits;
+}
+
+/****************************************************************************
+ * Name: trie_plen
+ *
+ * Description:
+ *   Return the prefix length of a netmask in network order, or -1 if the
+ *   set bits are not contiguous.
+ *
+ ****************************************************************************/
+
+static int trie_plen(FAR const uint8_t *mask, int len)
+{
+  int plen = 0;
+  int i;
+
+  for (i = 0; i < len && mask[i] == 0xff; i++)
+    {
+      plen += 8;
+    }
+
+  if (i < len)
+    {
+      uint8_t rest = mask[i];
+
+      while ((rest & 0x80) != 0)
+        {
+          rest <<= 1;
+          plen++;
+        }
+
+      if (rest != 0)
+        {
+          return -1;
+        }
+
+      while (++i < len)
+        {
+          if (mask[i] != 0)
+            {
+              return -1;
+            }
+        }
+    }
+
+  return plen;
+}
+
+/****************************************************************************
+ * Name: trie_alloc
+ *
+ * Description:
+ *   Take a node from the free list and give it the first 'plen' bits of
+ *   'key'.
+ *
+ ****************************************************************************/
+
+static FAR struct route_trie_s *
+trie_alloc(FAR struct route_trie_table_s *tab, FAR const uint8_t *key,
+           int plen, FAR struct route_trie_s *parent)
+{
+  FAR struct route_trie_s *node = tab->free;
+  int nbytes = (plen + 7) >> 3;
+
+  DEBUGASSERT(node != NULL);
+  tab->free = node->child[0];
+
+  memset(node, 0, sizeof(*node));
+  memcpy(node->key, key, nbytes);
+  if ((plen & 7) != 0)
+    {
+      node->key[nbytes - 1] &= 0xff << (8 - (plen & 7));
+    }
+
+  node->plen   = plen;
+  node->parent = parent;
+  return node;
+}
+
+/****************************************************************************
+ * Name: trie_link
+ *
+ * Description:
+ *   Return the location that points to a node: the root or a child slot of
+ *   its parent.
+ *
+ ****************************************************************************/
+
+static FAR struct route_trie_s **
+trie_link(FAR struct route_trie_table_s *tab, FAR struct route_trie_s *node)
+{
+  FAR struct route_trie_s *parent = node->parent;
+
+  if (parent == NULL)
+    {
+      return &tab->root;
+    }
+
+  return &parent->child[parent->child[1] == node];
+}
+
+/****************************************************************************
+ * Name: trie_insert
+ *
+ * Description:
+ *   Return the node of a prefix, creating it and a branch node if needed.
+ *
+ ****************************************************************************/
+
+static FAR struct route_trie_s *
+trie_insert(FAR struct route_trie_table_s *tab, FAR const uint8_t *key,
+            int plen)
+{
+  FAR struct route_trie_s **link = &tab->root;
+  FAR struct route_trie_s *parent = NULL;
+  FAR struct route_trie_s *node;
+  FAR struct route_trie_s *branch;
+  FAR struct route_trie_s *leaf;
+  int common;
+
+  while ((node = *link) != NULL)
+    {
+      common = trie_common(node->key, key, MIN(node->plen, plen));
+      if (common < node->plen)
+        {
+          break;
+        }
+
+      if (node->plen == plen)
+        {
+          return node;
+        }
+
+      parent = node;
+      link   = &node->child[trie_bit(key, node->plen)];
+    }
+
+  if (node == NULL)
+    {
+      *link = trie_alloc(tab, key, plen, parent);
+      return *link;
+    }
+
+  /* The new prefix is a prefix of the node: it becomes its parent */
+
+  if (common == plen)
+    {
+      leaf = trie_alloc(tab, key, plen, parent);
+      leaf->child[trie_bit(node->key, plen)] = node;
+      node->parent = leaf;
+      *link = leaf;
+      return leaf;
+    }
+
+  /* The prefixes diverge: join them under a branch node */
+
+  branch = trie_alloc(tab, key, common, parent);
+  leaf   = trie_alloc(tab, key, plen, branch);
+
+  branch->child[trie_bit(key, common)]       = leaf;
+  branch->child[trie_bit(node->key, common)] = node;
+  node->parent = branch;
+  *link = branch;
+  return leaf;
+}
+
+/****************************************************************************
+ * Name: trie_find
+ *
+ * Description:
+ *   Return the node of exactly this prefix, or NULL.
+ *
+ ****************************************************************************/
+
+static FAR struct route_trie_s *
+trie_find(FAR struct route_trie_table_s *tab, FAR const uint8_t *key,
+          int plen)
+{
+  FAR struct route_trie_s *node = tab->root;
+
+  while (node != NULL && node->plen <= plen &&
+         trie_common(node->key, key, node->plen) == node->plen)
+    {
+      if (node->plen == plen)
+        {
+          return node;
+        }
+
+      node = node->child[trie_bit(key, node->plen)];
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: trie_match
+ *
+ * Description:
+ *   Return the node with routes of the longest prefix that matches an
+ *   address.  The less specific matches are among its ancestors.
+ *
+ ****************************************************************************/
+
+static FAR struct route_trie_s *
+trie_match(FAR struct route_trie_table_s *tab, FAR const uint8_t *key,
+           int nbits)
+{
+  FAR struct route_trie_s *node = tab->root;
+  FAR struct route_trie_s *best = NULL;
+
+  while (node != NULL &&
+         trie_common(node->key, key, node->plen) == node->plen)
+    {
+      if (node->routes != NULL)
+        {
+          best = node;
+        }
+
+      if (node->plen >= nbits)
+        {
+          break;
+        }
+
+      node = node->child[trie_bit(key, node->plen)];
+    }
+
+  return best;
+}
+
+/****************************************************************************
+ * Name: trie_remove
+ *
+ * Description:
+ *   Release a node that has no routes left, and its parent if that is left
+ *   as a branch node with a single child.
+ *
+ ****************************************************************************/
+
+static void trie_remove(FAR struct route_trie_table_s *tab,
+                        FAR struct route_trie_s *node)
+{
+  FAR struct route_trie_s *child;
+  FAR struct route_trie_s *parent;
+
+  while (node != NULL && node->routes == NULL &&
+         (node->child[0] == NULL || node->child[1] == NULL))
+    {
+      parent = node->parent;
+      child  = node->child[0] != NULL ? node->child[0] : node->child[1];
+
+      *trie_link(tab, node) = child;
+      if (child != NULL)
+        {
+          child->parent = parent;
+        }
+
+      node->child[0] = tab->free;
+      tab->free      = node;
+
+      /* Only a parent that lost its last but one child may go as well */
+
+      node = child == NULL ? parent : NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: trie_init
+ ****************************************************************************/
+
+static void trie_init(FAR struct route_trie_table_s *tab,
+                      FAR struct route_trie_s *nodes, int nnodes)
+{
+  int i;
+
+  tab->root       = NULL;
+  tab->free       = NULL;
+  tab->nirregular = 0;
+
+  for (i = 0; i < nnodes; i++)
+    {
+      nodes[i].child[0] = tab->free;
+      tab->free         = &nodes[i];
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_init_trieroute
+ *
+ * Description:
+ *   Initialize the prefix tries of the in-memory routing tables.
+ *
+ ****************************************************************************/
+
+void net_init_trieroute(void)
+{
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+  trie_init(&g_ipv4_trie, g_ipv4_trienodes, TRIE_IPv4_NNODES);
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+  trie_init(&g_ipv6_trie, g_ipv6_trienodes, TRIE_IPv6_NNODES);
+#endif
+}
+
+/****************************************************************************
+ * Name: net_trie_addroute_ipv4 and net_trie_addroute_ipv6
+ *
+ * Description:
+ *   Index a route that was added to the in-memory routing table.  A route
+ *   with a netmask that is not a prefix cannot be indexed, lookups then
+ *   fall back to traversing the list.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+void net_trie_addroute_ipv4(FAR struct net_route_ipv4_entry_s *route)
+{
+  FAR struct net_route_ipv4_entry_s **prev;
+  FAR struct route_trie_s *node;
+  int plen;
+
+  plen = trie_plen((FAR const uint8_t *)&route->entry.netmask,
+                   sizeof(in_addr_t));
+  if (plen < 0)
+    {
+      g_ipv4_trie.nirregular++;
+      return;
+    }
+
+  /* Routes of the same prefix are visited in the order they were added */
+
+  node = trie_insert(&g_ipv4_trie,
+                     (FAR const uint8_t *)&route->entry.target, plen);
+  for (prev = (FAR struct net_route_ipv4_entry_s **)&node->routes;
+       *prev != NULL; prev = &(*prev)->plink)
+    {
+    }
+
+  route->plink = NULL;
+  *prev        = route;
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+void net_trie_addroute_ipv6(FAR struct net_route_ipv6_entry_s *route)
+{
+  FAR struct net_route_ipv6_entry_s **prev;
+  FAR struct route_trie_s *node;
+  int plen;
+
+  plen = trie_plen((FAR const uint8_t *)route->entry.netmask,
+                   sizeof(net_ipv6addr_t));
+  if (plen < 0)
+    {
+      g_ipv6_trie.nirregular++;
+      return;
+    }
+
+  /* Routes of the same prefix are visited in the order they were added */
+
+  node = trie_insert(&g_ipv6_trie,
+                     (FAR const uint8_t *)route->entry.target, plen);
+  for (prev = (FAR struct net_route_ipv6_entry_s **)&node->routes;
+       *prev != NULL; prev = &(*prev)->plink)
+    {
+    }
+
+  route->plink = NULL;
+  *prev        = route;
+}
+#endif
+
+/****************************************************************************
+ * Name: net_trie_delroute_ipv4 and net_trie_delroute_ipv6
+ *
+ * Description:
+ *   Remove a route from the index before it is removed from the in-memory
+ *   routing table.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+void net_trie_delroute_ipv4(FAR struct net_route_ipv4_entry_s *route)
+{
+  FAR struct net_route_ipv4_entry_s **prev;
+  FAR struct route_trie_s *node;
+  int plen;
+
+  plen = trie_plen((FAR const uint8_t *)&route->entry.netmask,
+                   sizeof(in_addr_t));
+  if (plen < 0)
+    {
+      g_ipv4_trie.nirregular--;
+      return;
+    }
+
+  node = trie_find(&g_ipv4_trie,
+                   (FAR const uint8_t *)&route->entry.target, plen);
+  DEBUGASSERT(node != NULL);
+
+  for (prev = (FAR struct net_route_ipv4_entry_s **)&node->routes;
+       *prev != NULL; prev = &(*prev)->plink)
+    {
+      if (*prev == route)
+        {
+          *prev = route->plink;
+          break;
+        }
+    }
+
+  trie_remove(&g_ipv4_trie, node);
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+void net_trie_delroute_ipv6(FAR struct net_route_ipv6_entry_s *route)
+{
+  FAR struct net_route_ipv6_entry_s **prev;
+  FAR struct route_trie_s *node;
+  int plen;
+
+  plen = trie_plen((FAR const uint8_t *)route->entry.netmask,
+                   sizeof(net_ipv6addr_t));
+  if (plen < 0)
+    {
+      g_ipv6_trie.nirregular--;
+      return;
+    }
+
+  node = trie_find(&g_ipv6_trie,
+                   (FAR const uint8_t *)route->entry.target, plen);
+  DEBUGASSERT(node != NULL);
+
+  for (prev = (FAR struct net_route_ipv6_entry_s **)&node->routes;
+       *prev != NULL; prev = &(*prev)->plink)
+    {
+      if (*prev == route)
+        {
+          *prev = route->plink;
+          break;
+        }
+    }
+
+  trie_remove(&g_ipv6_trie, node);
+}
+#endif
+
+/****************************************************************************
+ * Name: net_lpmroute_ipv4 and net_lpmroute_ipv6
+ *
+ * Description:
+ *   Call the handler for the routes that match an address, the longest
+ *   prefix first.  If the table holds a route that is not indexed, all
+ *   routes are visited in table order instead.
+ *
+ * Input Parameters:
+ *   target  - The address to match
+ *   handler - Will be called for each matching route.  It must not modify
+ *             the routing table.
+ *   arg     - An arbitrary value that will be passed to the handler.
+ *
+ * Returned Value:
+ *   Zero (OK) if no handler terminated the search, or the non-zero value
+ *   returned by the handler that did.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+int net_lpmroute_ipv4(in_addr_t target, route_handler_ipv4_t handler,
+                      FAR void *arg)
+{
+  FAR struct net_route_ipv4_entry_s *route;
+  FAR struct route_trie_s *node;
+  int ret = 0;
+
+  net_lock();
+
+  if (g_ipv4_trie.nirregular > 0)
+    {
+      ret = net_foreachroute_ipv4(handler, arg);
+      net_unlock();
+      return ret;
+    }
+
+  for (node = trie_match(&g_ipv4_trie, (FAR const uint8_t *)&target, 32);
+       ret == 0 && node != NULL; node = node->parent)
+    {
+      for (route = node->routes; ret == 0 && route != NULL;
+           route = route->plink)
+        {
+          ret = handler(&route->entry, arg);
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+int net_lpmroute_ipv6(FAR const net_ipv6addr_t target,
+                      route_handler_ipv6_t handler, FAR void *arg)
+{
+  FAR struct net_route_ipv6_entry_s *route;
+  FAR struct route_trie_s *node;
+  int ret = 0;
+
+  net_lock();
+
+  if (g_ipv6_trie.nirregular > 0)
+    {
+      ret = net_foreachroute_ipv6(handler, arg);
+      net_unlock();
+      return ret;
+    }
+
+  for (node = trie_match(&g_ipv6_trie, (FAR const uint8_t *)target, 128);
+       ret == 0 && node != NULL; node = node->parent)
+    {
+      for (route = node->routes; ret == 0 && route != NULL;
+           route = route->plink)
+        {
+          ret = handler(&route->entry, arg);
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
+#endif /* CONFIG_ROUTE_TRIE */
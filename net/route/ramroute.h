@@ -66,6 +66,9 @@ struct net_route_ipv4_entry_s
 {
   struct net_route_ipv4_s entry;
   FAR struct net_route_ipv4_entry_s *flink;
+#ifdef CONFIG_ROUTE_TRIE
+  FAR struct net_route_ipv4_entry_s *plink; /* Next route of the prefix */
+#endif
 };
 
 /* This structure describes the head of a routing table list */
@@ -84,6 +87,9 @@ struct net_route_ipv6_entry_s
 {
   struct net_route_ipv6_s entry;
   FAR struct net_route_ipv6_entry_s *flink;
+#ifdef CONFIG_ROUTE_TRIE
+  FAR struct net_route_ipv6_entry_s *plink; /* Next route of the prefix */
+#endif
 };
 
 /* This structure describes the head of a routing table list */
@@ -216,5 +222,58 @@ ramroute_ipv6_remafter(FAR struct net_route_ipv6_entry_s *entry,
                        FAR struct net_route_ipv6_queue_s *list);
 #endif
 
+/****************************************************************************
+ * Name: net_init_trieroute
+ *
+ * Description:
+ *   Initialize the prefix tries of the in-memory routing tables
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_TRIE
+void net_init_trieroute(void);
+#endif
+
+/****************************************************************************
+ * Name: net_trie_addroute_ipv4/6 and net_trie_delroute_ipv4/6
+ *
+ * Description:
+ *   Keep the prefix trie in sync with the in-memory routing table.  A
+ *   route is indexed after it is added to the list and removed from the
+ *   index before it is removed from the list.
+ *
+ * Input Parameters:
+ *   route - The routing table entry
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_ROUTE_TRIE) && defined(CONFIG_ROUTE_IPv4_RAMROUTE)
+void net_trie_addroute_ipv4(FAR struct net_route_ipv4_entry_s *route);
+void net_trie_delroute_ipv4(FAR struct net_route_ipv4_entry_s *route);
+#else
+#  define net_trie_addroute_ipv4(r)
+#  define net_trie_delroute_ipv4(r)
+#endif
+
+#if defined(CONFIG_ROUTE_TRIE) && defined(CONFIG_ROUTE_IPv6_RAMROUTE)
+void net_trie_addroute_ipv6(FAR struct net_route_ipv6_entry_s *route);
+void net_trie_delroute_ipv6(FAR struct net_route_ipv6_entry_s *route);
+#else
+#  define net_trie_addroute_ipv6(r)
+#  define net_trie_delroute_ipv6(r)
+#endif
+
 #endif /* CONFIG_ROUTE_IPv4_RAMROUTE || CONFIG_ROUTE_IPv6_RAMROUTE */
 #endif /* __NET_ROUTE_RAMROUTE_H */
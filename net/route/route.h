@@ -273,6 +273,43 @@ int net_foreachroute_ipv4(route_handler_ipv4_t handler, FAR void *arg);
 int net_foreachroute_ipv6(route_handler_ipv6_t handler, FAR void *arg);
 #endif
 
+/****************************************************************************
+ * Name: net_lpmroute_ipv4/net_lpmroute_ipv6
+ *
+ * Description:
+ *   Traverse the routes that match an address, the longest prefix first.
+ *   Without CONFIG_ROUTE_TRIE this is a traversal of the whole table.
+ *
+ * Input Parameters:
+ *   target  - The address to match
+ *   handler - Will be called for each matching route.  It must not modify
+ *             the routing table.
+ *   arg     - An arbitrary value that will be passed to the handler.
+ *
+ * Returned Value:
+ *   Zero (OK) returned if no handler terminated the search.  Otherwise the
+ *   non-zero value returned by the handler that did.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+#  if defined(CONFIG_ROUTE_TRIE) && defined(CONFIG_ROUTE_IPv4_RAMROUTE)
+int net_lpmroute_ipv4(in_addr_t target, route_handler_ipv4_t handler,
+                      FAR void *arg);
+#  else
+#    define net_lpmroute_ipv4(t,h,a) net_foreachroute_ipv4(h,a)
+#  endif
+#endif
+
+#ifdef CONFIG_NET_IPv6
+#  if defined(CONFIG_ROUTE_TRIE) && defined(CONFIG_ROUTE_IPv6_RAMROUTE)
+int net_lpmroute_ipv6(FAR const net_ipv6addr_t target,
+                      route_handler_ipv6_t handler, FAR void *arg);
+#  else
+#    define net_lpmroute_ipv6(t,h,a) net_foreachroute_ipv6(h,a)
+#  endif
+#endif
+
 /****************************************************************************
  * Name: net_ipv4_dumproute and net_ipv6_dumproute
  *
@@ -66,6 +66,7 @@
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/radiodev.h>
 #include <nuttx/net/ip.h>
+#include <nuttx/net/netstats.h>
 
 #include "sixlowpan/sixlowpan_internal.h"
 
@@ -101,6 +102,22 @@ struct sixlowpan_addrcontext_s
   uint8_t prefix[8];
 };
 
+#if CONFIG_NET_6LOWPAN_IPHC_CACHE > 0
+/* An entry of the IPHC neighbor cache.  It holds the results of the
+ * destination address compression that depend only on the destination:
+ * the address context of its prefix and whether its IID is formed from
+ * its MAC address.  An entry with a zero nc_macaddr length is unused.
+ */
+
+struct sixlowpan_iphc_cache_s
+{
+  net_ipv6addr_t nc_ipaddr;                        /* Destination IPv6 address */
+  struct netdev_varaddr_s nc_macaddr;              /* Its MAC address */
+  FAR struct sixlowpan_addrcontext_s *nc_context;  /* Its context, or NULL */
+  bool nc_macbased;                                /* IID is based on nc_macaddr */
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -120,6 +137,13 @@ static struct sixlowpan_addrcontext_s
   g_hc06_addrcontexts[CONFIG_NET_6LOWPAN_MAXADDRCONTEXT];
 #endif
 
+#if CONFIG_NET_6LOWPAN_IPHC_CACHE > 0
+/* IPHC neighbor cache, direct-mapped by the IID of the destination */
+
+static struct sixlowpan_iphc_cache_s
+  g_hc06_cache[CONFIG_NET_6LOWPAN_IPHC_CACHE];
+#endif
+
 /* Pointer to the byte where to write next inline field. */
 
 static FAR uint8_t *g_hc06ptr;
@@ -270,7 +294,7 @@ static FAR struct sixlowpan_addrcontext_s *
  *   and the second postfix count (NOTE: 15/0xf ipaddr=16 bytes copy).
  *
  *   compress_tagaddr() accepts a remote, variable length, tagged MAC
- *                      address;
+ *                      address and whether the IID is formed from it;
  *   compress_laddr() accepts a local, fixed length MAC address.
  *   compress_ipaddr() is simply the common logic that does not depend on
  *   the size of the MAC address.
@@ -317,7 +341,7 @@ static uint8_t compress_ipaddr(FAR const net_ipv6addr_t ipaddr,
 
 static uint8_t compress_tagaddr(FAR const net_ipv6addr_t ipaddr,
                                 FAR const struct netdev_varaddr_s *macaddr,
-                                uint8_t bitpos)
+                                bool macbased, uint8_t bitpos)
 {
   uint8_t tag;
 
@@ -354,7 +378,7 @@ static uint8_t compress_tagaddr(FAR const net_ipv6addr_t ipaddr,
     }
 #endif
 
-  if (sixlowpan_ismacbased(ipaddr, macaddr))
+  if (macbased)
     {
       tag = (3 << bitpos);       /* 0-bits */
     }
@@ -416,6 +440,53 @@ static uint8_t compress_laddr(FAR const net_ipv6addr_t srcipaddr,
   return tag;
 }
 
+/****************************************************************************
+ * Name: hc06_cache_lookup
+ *
+ * Description:
+ *   Return the IPHC neighbor cache entry of a destination, filling it in on
+ *   a miss.  The address contexts do not change after initialization, so
+ *   an entry stays valid until it is replaced by another destination.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_6LOWPAN_IPHC_CACHE > 0
+static FAR struct sixlowpan_iphc_cache_s *
+  hc06_cache_lookup(FAR const net_ipv6addr_t ipaddr,
+                    FAR const struct netdev_varaddr_s *macaddr)
+{
+  FAR struct sixlowpan_iphc_cache_s *entry;
+
+  entry = &g_hc06_cache[(ipaddr[6] ^ ipaddr[7]) %
+                        CONFIG_NET_6LOWPAN_IPHC_CACHE];
+
+  if (macaddr->nv_addrlen != 0 &&
+      entry->nc_macaddr.nv_addrlen == macaddr->nv_addrlen &&
+      net_ipv6addr_cmp(entry->nc_ipaddr, ipaddr) &&
+      memcmp(entry->nc_macaddr.nv_addr, macaddr->nv_addr,
+             macaddr->nv_addrlen) == 0)
+    {
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.sixlowpan.cachehit++;
+#endif
+      return entry;
+    }
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.sixlowpan.cachemiss++;
+#endif
+
+  net_ipv6addr_copy(entry->nc_ipaddr, ipaddr);
+  memcpy(&entry->nc_macaddr, macaddr, sizeof(struct netdev_varaddr_s));
+  entry->nc_context  = find_addrcontext_byprefix(ipaddr);
+  entry->nc_macbased = sixlowpan_ismacbased(ipaddr, macaddr);
+  return entry;
+}
+#endif
+
 /****************************************************************************
  * Name: uncompress_addr
  *
@@ -683,6 +754,12 @@ void sixlowpan_hc06_initialize(void)
     }
 #endif /* CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 1 */
 #endif /* CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0 */
+
+#if CONFIG_NET_6LOWPAN_IPHC_CACHE > 0
+  /* The cached address contexts refer to the ones just set up */
+
+  memset(g_hc06_cache, 0, sizeof(g_hc06_cache));
+#endif
 }
 
 /****************************************************************************
@@ -746,6 +823,10 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
   FAR uint8_t *iphc = fptr + g_frame_hdrlen;
   FAR struct sixlowpan_addrcontext_s *saddrcontext;
   FAR struct sixlowpan_addrcontext_s *daddrcontext;
+#if CONFIG_NET_6LOWPAN_IPHC_CACHE > 0
+  FAR struct sixlowpan_iphc_cache_s *dcache;
+#endif
+  bool dmacbased;
   uint8_t iphc0;
   uint8_t iphc1;
   uint8_t tmp;
@@ -773,7 +854,14 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
 
   /* Check if dest address context exists (for allocating third byte) */
 
+#if CONFIG_NET_6LOWPAN_IPHC_CACHE > 0
+  dcache       = hc06_cache_lookup(ipv6->destipaddr, destmac);
+  daddrcontext = dcache->nc_context;
+  dmacbased    = dcache->nc_macbased;
+#else
   daddrcontext = find_addrcontext_byprefix(ipv6->destipaddr);
+  dmacbased    = sixlowpan_ismacbased(ipv6->destipaddr, destmac);
+#endif
   saddrcontext = find_addrcontext_byprefix(ipv6->srcipaddr);
 
   if (daddrcontext != NULL || saddrcontext != NULL)
@@ -1014,7 +1102,7 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
 
           /* Compession compare with link address (destination) */
 
-          iphc1   |= compress_tagaddr(ipv6->destipaddr, destmac,
+          iphc1   |= compress_tagaddr(ipv6->destipaddr, destmac, dmacbased,
                                       SIXLOWPAN_IPHC_DAM_BIT);
         }
 
@@ -1024,7 +1112,7 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
                ipv6->destipaddr[1] == 0 && ipv6->destipaddr[2] == 0 &&
                ipv6->destipaddr[3] == 0)
         {
-          iphc1 |= compress_tagaddr(ipv6->destipaddr, destmac,
+          iphc1 |= compress_tagaddr(ipv6->destipaddr, destmac, dmacbased,
                                     SIXLOWPAN_IPHC_DAM_BIT);
         }
 
@@ -60,6 +60,7 @@
 #include "nuttx/net/ip.h"
 #include "nuttx/net/icmpv6.h"
 #include "nuttx/net/sixlowpan.h"
+#include "nuttx/net/netstats.h"
 #include "nuttx/wireless/ieee802154/ieee802154_mac.h"
 
 #ifdef CONFIG_NET_PKT
@@ -581,6 +582,13 @@ static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
     {
       ninfo("IP packet ready (length %d)\n", reass->rb_pktlen);
 
+#ifdef CONFIG_NET_STATISTICS
+      if (isfrag)
+        {
+          g_netstats.sixlowpan.reass++;
+        }
+#endif
+
       radio->r_dev.d_buf  = reass->rb_buf;
       radio->r_dev.d_len  = reass->rb_pktlen;
       reass->rb_active    = false;
@@ -33,6 +33,7 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/mm/iob.h>
+#include <nuttx/net/netstats.h>
 
 #include "sixlowpan_internal.h"
 
@@ -44,6 +45,11 @@
 
 #define NET_6LOWPAN_TIMEOUT SEC2TICK(CONFIG_NET_6LOWPAN_MAXAGE)
 
+/* Hash bucket of an active reassembly buffer */
+
+#define REASS_HASH(tag, src) \
+  (sixlowpan_reass_hashkey(tag, src) % CONFIG_NET_6LOWPAN_REASS_HASHSIZE)
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -55,9 +61,12 @@
 
 static FAR struct sixlowpan_reassbuf_s *g_free_reass;
 
-/* This is a list of active, allocated reassemby buffers */
+/* Active, allocated reassembly buffers, hashed by reassembly tag and
+ * fragment source.  Each bucket is a list linked by rb_flink.
+ */
 
-static FAR struct sixlowpan_reassbuf_s *g_active_reass;
+static FAR struct sixlowpan_reassbuf_s *
+              g_reass_hash[CONFIG_NET_6LOWPAN_REASS_HASHSIZE];
 
 /* Pool of pre-allocated reassembly buffer structures */
 
@@ -65,9 +74,34 @@ static struct sixlowpan_reassbuf_s
               g_metadata_pool[CONFIG_NET_6LOWPAN_NREASSBUF];
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sixlowpan_reass_hashkey
+ *
+ * Description:
+ *   Fold the reassembly tag and the source address of a fragment into a
+ *   hash key.  The tag varies the most between the datagrams of one
+ *   source; the address spreads the sources that use the same tags.
+ *
+ ****************************************************************************/
+
+static unsigned int
+  sixlowpan_reass_hashkey(uint16_t reasstag,
+                          FAR const struct netdev_varaddr_s *fragsrc)
+{
+  unsigned int key = reasstag;
+  int i;
+
+  for (i = 0; i < fragsrc->nv_addrlen && i < RADIO_MAX_ADDRLEN; i++)
+    {
+      key = key * 31 + fragsrc->nv_addr[i];
+    }
+
+  return key;
+}
+
 /****************************************************************************
  * Name: sixlowpan_compare_fragsrc
  *
@@ -122,36 +156,45 @@ static void sixlowpan_reass_expire(void)
   FAR struct sixlowpan_reassbuf_s *reass;
   FAR struct sixlowpan_reassbuf_s *next;
   clock_t elapsed;
+  int i;
 
   /* If reassembly timed out, cancel it */
 
-  for (reass = g_active_reass; reass != NULL; reass = next)
+  for (i = 0; i < CONFIG_NET_6LOWPAN_REASS_HASHSIZE; i++)
     {
-      /* Needed if 'reass' is freed */
-
-      next = reass->rb_flink;
-
-      /* Free any inactive reassembly buffers.  This is done because the life
-       * the reassembly buffer is not cerain.
-       */
-
-      if (!reass->rb_active)
-        {
-          sixlowpan_reass_free(reass);
-        }
-      else
+      for (reass = g_reass_hash[i]; reass != NULL; reass = next)
         {
-          /* Get the elpased time of the reassembly */
+          /* Needed if 'reass' is freed */
 
-          elapsed = clock_systime_ticks() - reass->rb_time;
+          next = reass->rb_flink;
 
-          /* If the reassembly has expired, then free the reassembly buffer */
+          /* Free any inactive reassembly buffers.  This is done because the
+           * life the reassembly buffer is not cerain.
+           */
 
-          if (elapsed >= NET_6LOWPAN_TIMEOUT)
+          if (!reass->rb_active)
             {
-              nwarn("WARNING: Reassembly timed out\n");
               sixlowpan_reass_free(reass);
             }
+          else
+            {
+              /* Get the elpased time of the reassembly */
+
+              elapsed = clock_systime_ticks() - reass->rb_time;
+
+              /* If the reassembly has expired, then free the reassembly
+               * buffer
+               */
+
+              if (elapsed >= NET_6LOWPAN_TIMEOUT)
+                {
+                  nwarn("WARNING: Reassembly timed out\n");
+#ifdef CONFIG_NET_STATISTICS
+                  g_netstats.sixlowpan.timeout++;
+#endif
+                  sixlowpan_reass_free(reass);
+                }
+            }
         }
     }
 }
@@ -177,10 +220,21 @@ static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 {
   FAR struct sixlowpan_reassbuf_s *curr;
   FAR struct sixlowpan_reassbuf_s *prev;
+  FAR struct sixlowpan_reassbuf_s **bucket;
+
+  /* Find the reassembly buffer in its hash bucket.  Buffers provided by
+   * the radio driver are never hashed and their tag is not initialized.
+   */
+
+  if (reass->rb_pool == REASS_POOL_RADIO)
+    {
+      return;
+    }
 
-  /* Find the reassembly buffer in the list of active reassembly buffers */
+  bucket = &g_reass_hash[REASS_HASH(reass->rb_reasstag,
+                                    &reass->rb_fragsrc)];
 
-  for (prev = NULL, curr = g_active_reass;
+  for (prev = NULL, curr = *bucket;
        curr != NULL && curr != reass;
        prev = curr, curr = curr->rb_flink)
     {
@@ -194,7 +248,7 @@ static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 
       if (prev == NULL)
         {
-          g_active_reass = reass->rb_flink;
+          *bucket = reass->rb_flink;
         }
       else
         {
@@ -279,6 +333,7 @@ FAR struct sixlowpan_reassbuf_s *
   sixlowpan_reass_allocate(uint16_t reasstag,
                            FAR const struct netdev_varaddr_s *fragsrc)
 {
+  FAR struct sixlowpan_reassbuf_s **bucket;
   FAR struct sixlowpan_reassbuf_s *reass;
   uint8_t pool;
 
@@ -324,11 +379,20 @@ FAR struct sixlowpan_reassbuf_s *
       reass->rb_reasstag = reasstag;
       reass->rb_time     = clock_systime_ticks();
 
-      /* Add the reassembly buffer to the list of active reassembly buffers */
+      /* Add the reassembly buffer to its bucket of active reassembly
+       * buffers.
+       */
 
-      reass->rb_flink   = g_active_reass;
-      g_active_reass    = reass;
+      bucket            = &g_reass_hash[REASS_HASH(reasstag, fragsrc)];
+      reass->rb_flink   = *bucket;
+      *bucket           = reass;
     }
+#ifdef CONFIG_NET_STATISTICS
+  else
+    {
+      g_netstats.sixlowpan.nobuf++;
+    }
+#endif
 
   return reass;
 }
@@ -358,17 +422,15 @@ FAR struct sixlowpan_reassbuf_s *
 {
   FAR struct sixlowpan_reassbuf_s *reass;
 
-  /* First, removed any expired or inactive reassembly buffers (we don't want
-   * to return old reassembly buffer with the same tag)
+  /* Search for the matching reassembly buffer in its bucket.  The other
+   * buckets are left to the sweep done by sixlowpan_reass_allocate(), only
+   * the match itself is checked for expiry (we don't want to return old
+   * reassembly buffer with the same tag).
    */
 
-  sixlowpan_reass_expire();
-
-  /* Now search for the matching reassembly buffer in the remainng, active
-   * reassembly buffers.
-   */
-
-  for (reass = g_active_reass; reass != NULL; reass = reass->rb_flink)
+  for (reass = g_reass_hash[REASS_HASH(reasstag, fragsrc)];
+       reass != NULL;
+       reass = reass->rb_flink)
     {
       /* In order to be a match, it must have the same reassembly tag as
        * well as source address (different sources might use the same
@@ -378,6 +440,22 @@ FAR struct sixlowpan_reassbuf_s *
       if (reass->rb_reasstag == reasstag &&
           sixlowpan_compare_fragsrc(reass, fragsrc))
         {
+          if (!reass->rb_active)
+            {
+              sixlowpan_reass_free(reass);
+              return NULL;
+            }
+
+          if (clock_systime_ticks() - reass->rb_time >= NET_6LOWPAN_TIMEOUT)
+            {
+              nwarn("WARNING: Reassembly timed out\n");
+#ifdef CONFIG_NET_STATISTICS
+              g_netstats.sixlowpan.timeout++;
+#endif
+              sixlowpan_reass_free(reass);
+              return NULL;
+            }
+
           return reass;
         }
     }
@@ -204,6 +204,34 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
         }
         break;
 
+#ifdef CONFIG_NET_SOPRIORITY
+      case SO_PRIORITY:   /* Reports the transmit priority */
+        {
+          if (*value_len < sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          *(FAR int *)value = conn->s_priority;
+          *value_len        = sizeof(int);
+        }
+        break;
+#endif
+
+#ifdef CONFIG_NET_TIMESTAMPING
+      case SO_TIMESTAMPING:  /* Reports the packet timestamp flags */
+        {
+          if (*value_len < sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          *(FAR int *)value = conn->s_tsflags;
+          *value_len        = sizeof(int);
+        }
+        break;
+#endif
+
       default:
         return -ENOPROTOOPT;
     }
@@ -29,6 +29,7 @@
 
 #include <nuttx/cancelpt.h>
 #include <nuttx/net/net.h>
+#include <nuttx/trace.h>
 
 #include "socket/socket.h"
 
@@ -109,7 +110,9 @@ ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
   msg_control         = msg->msg_control;
   msg_controllen      = msg->msg_controllen;
 
+  net_trace_begin();
   ret = psock->s_sockif->si_recvmsg(psock, msg, flags);
+  net_trace_end();
 
   /* Recover the pointer and calculate the cmsg's true data length */
 
@@ -29,6 +29,7 @@
 
 #include <nuttx/cancelpt.h>
 #include <nuttx/net/net.h>
+#include <nuttx/trace.h>
 
 #include "socket/socket.h"
 
@@ -69,6 +70,8 @@
 ssize_t psock_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                        int flags)
 {
+  ssize_t ret;
+
   /* Verify that non-NULL pointers were passed */
 
   if (msg == NULL || msg->msg_iov == NULL || msg->msg_iov->iov_base == NULL)
@@ -90,7 +93,11 @@ ssize_t psock_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
   DEBUGASSERT(psock->s_sockif != NULL &&
               psock->s_sockif->si_sendmsg != NULL);
 
-  return psock->s_sockif->si_sendmsg(psock, msg, flags);
+  net_trace_begin();
+  ret = psock->s_sockif->si_sendmsg(psock, msg, flags);
+  net_trace_end();
+
+  return ret;
 }
 
 /****************************************************************************
@@ -33,6 +33,7 @@
 #include <assert.h>
 #include <arch/irq.h>
 
+#include <net/net_tstamp.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <netdev/netdev.h>
@@ -216,6 +217,55 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
         }
 #endif
 
+#ifdef CONFIG_NET_SOPRIORITY
+      case SO_PRIORITY:  /* Sets the transmit priority */
+        {
+          int priority;
+
+          if (value == NULL || value_len != sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          priority = *(FAR const int *)value;
+          if (priority < 0 || priority > UINT8_MAX)
+            {
+              return -EINVAL;
+            }
+
+          conn->s_priority = priority;
+          break;
+        }
+#endif
+
+#ifdef CONFIG_NET_TIMESTAMPING
+      case SO_TIMESTAMPING:  /* Selects the packet timestamps */
+        {
+          int flags;
+
+          if (value == NULL || value_len != sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          /* Only UDP sockets generate timestamps */
+
+          if (psock->s_type != SOCK_DGRAM)
+            {
+              return -ENOPROTOOPT;
+            }
+
+          flags = *(FAR const int *)value;
+          if ((flags & ~SOF_TIMESTAMPING_MASK) != 0)
+            {
+              return -EINVAL;
+            }
+
+          conn->s_tsflags = flags;
+          break;
+        }
+#endif
+
       /* There options are only valid when used with getopt */
 
       case SO_ACCEPTCONN: /* Reports whether socket listening is enabled */
@@ -114,6 +114,10 @@
 #define TCP_INFR              0x08U /* The flag in Fast Recovery */
 #define TCP_INFT              0x10U /* The flag in Fast Transmitted */
 
+/* Max length of a congestion control algorithm name, including the NUL */
+
+#define TCP_CC_NAME_MAX       16
+
 #endif
 
 /* The Max Range count of TCP Selective ACKs */
@@ -129,6 +133,21 @@
 #define TCP_RTO_MAX 240 /* 120s,The unit is half a second */
 #define TCP_RTO_MIN 1   /* 0.5s */
 
+/* The quotas that are fixed by SO_SNDBUF and SO_RCVBUF and the quotas that
+ * are used for the write buffers and the receive window.
+ */
+
+#ifdef CONFIG_NET_TCP_BUFSIZE_AUTO
+#  define TCP_AUTOTUNE_SNDLOCK  0x01U
+#  define TCP_AUTOTUNE_RCVLOCK  0x02U
+
+#  define TCP_SNDBUFS(conn)     tcp_autotune_sndbuf(conn)
+#  define TCP_RCVBUFS(conn)     tcp_autotune_rcvbuf(conn)
+#else
+#  define TCP_SNDBUFS(conn)     ((conn)->snd_bufs)
+#  define TCP_RCVBUFS(conn)     ((conn)->rcv_bufs)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -178,6 +197,79 @@ struct tcp_sack_s
   uint32_t right;   /* Right edge of the SACK */
 };
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+/* A congestion control algorithm.  The loss detection (duplicate ACKs,
+ * fast retransmit and recovery, retransmission timeout) is shared in
+ * tcp_cc.c; the algorithm only decides how the window reacts.
+ *
+ *   init       - Reset the private state (optional)
+ *   ssthresh   - Return the slow start threshold after a loss
+ *   cong_avoid - Grow cwnd on an ACK of new data outside of recovery
+ *   acked      - Observe every ACK of new data, also in recovery
+ *                (optional)
+ */
+
+struct tcp_cc_ops_s
+{
+  FAR const char *name;
+  CODE void     (*init)(FAR struct tcp_conn_s *conn);
+  CODE uint32_t (*ssthresh)(FAR struct tcp_conn_s *conn);
+  CODE void     (*cong_avoid)(FAR struct tcp_conn_s *conn, uint32_t acked);
+  CODE void     (*acked)(FAR struct tcp_conn_s *conn, uint32_t acked);
+};
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+/* The state of CUBIC (RFC 9438) */
+
+struct tcp_cubic_s
+{
+  uint32_t w_max;          /* cwnd before the last reduction */
+  uint32_t origin;         /* cwnd at the plateau of the curve */
+  uint32_t w_est;          /* cwnd of the Reno-friendly estimate */
+  uint32_t k;              /* Time to reach the plateau (ms) */
+  clock_t  epoch;          /* Start of congestion avoidance, 0 if none */
+};
+#endif
+
+#ifdef CONFIG_NET_TCP_CC_BBR
+/* The state of the BBR variant, one sample per round trip */
+
+struct tcp_bbr_s
+{
+  uint32_t max_bw;         /* Max delivery rate of the recent rounds (B/s) */
+  uint32_t full_bw;        /* max_bw at the last growth in startup */
+  uint32_t min_rtt;        /* Min round trip time (ms) */
+  clock_t  min_rtt_stamp;  /* When min_rtt was measured */
+  clock_t  stamp;          /* Start of the current round or of PROBE_RTT */
+  uint32_t round_seq;      /* The round ends when this is ACKed */
+  uint32_t delivered;      /* Bytes ACKed in the current round */
+  uint8_t  mode;           /* STARTUP, DRAIN, PROBE_BW or PROBE_RTT */
+  uint8_t  cycle;          /* PROBE_BW gain phase, PROBE_RTT rounds */
+  uint8_t  full_cnt;       /* Rounds without bandwidth growth */
+  uint8_t  bw_age;         /* Rounds since max_bw was measured */
+  bool     inround;        /* A round is being measured */
+};
+#endif
+#endif
+
+#ifdef CONFIG_NET_TCP_BUFSIZE_AUTO
+/* The measurements that size the send and receive quotas of a connection */
+
+struct tcp_autotune_s
+{
+  uint32_t round_seq;      /* The send round ends when this is ACKed */
+  uint32_t delivered;      /* Bytes ACKed in the current send round */
+  uint32_t snd_bdp;        /* Bytes ACKed in the last send round */
+  clock_t  stamp;          /* Start of the current send round */
+  clock_t  rtt;            /* Duration of the last send round, 0 if none */
+  clock_t  rcv_stamp;      /* Start of the current read interval */
+  uint32_t rcv_copied;     /* Bytes read in the current read interval */
+  uint32_t rcv_rate;       /* Bytes read per round trip */
+  uint8_t  locks;          /* Quotas fixed by SO_SNDBUF and SO_RCVBUF */
+  bool     inround;        /* A send round is being measured */
+};
+#endif
+
 struct tcp_conn_s
 {
   /* Common prologue of all connection structures. */
@@ -211,6 +303,10 @@ struct tcp_conn_s
   /* TCP-specific content follows */
 
   union ip_binding_u u;   /* IP address binding */
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR struct tcp_conn_s *hnext; /* Next in the hash bucket of the active
+                                 * connections or of the listeners */
+#endif
   uint8_t  rcvseq[4];     /* The sequence number that we expect to
                            * receive next */
   uint8_t  sndseq[4];     /* The sequence number that was last sent by us */
@@ -254,6 +350,21 @@ struct tcp_conn_s
   uint32_t cwnd;          /* The Congestion window */
   uint32_t max_cwnd;      /* The Congestion window maximum value */
   uint32_t ssthresh;      /* The Slow start threshold */
+
+  /* The congestion control algorithm and its private state */
+
+  FAR const struct tcp_cc_ops_s *cc_ops;
+#if defined(CONFIG_NET_TCP_CC_CUBIC) || defined(CONFIG_NET_TCP_CC_BBR)
+  union
+  {
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+    struct tcp_cubic_s cubic;
+#endif
+#ifdef CONFIG_NET_TCP_CC_BBR
+    struct tcp_bbr_s bbr;
+#endif
+  } cc;
+#endif
 #endif
 #ifdef CONFIG_NET_TCP_WINDOW_SCALE
   uint32_t snd_wnd;       /* Sequence and acknowledgement numbers of last
@@ -273,6 +384,9 @@ struct tcp_conn_s
   int32_t  snd_bufs;      /* Maximum amount of bytes queued in send */
   sem_t    snd_sem;       /* Semaphore signals send completion */
 #endif
+#ifdef CONFIG_NET_TCP_BUFSIZE_AUTO
+  struct tcp_autotune_s autotune; /* Sizing of snd_bufs and rcv_bufs use */
+#endif
 #if defined(CONFIG_NET_TCP_WRITE_BUFFERS) || \
     defined(CONFIG_NET_TCP_WINDOW_SCALE)
   uint32_t tx_unacked;    /* Number bytes sent but not yet ACKed */
@@ -296,6 +410,10 @@ struct tcp_conn_s
    */
 
   FAR struct iob_s *readahead;   /* Read-ahead buffering */
+#ifdef CONFIG_NET_TCP_ZEROCOPY_RECV
+  uint32_t rcv_held;             /* Bytes taken by SIOCTCPZCRECV and not
+                                  * yet released */
+#endif
 
 #ifdef CONFIG_NET_TCP_OUT_OF_ORDER
 
@@ -308,6 +426,14 @@ struct tcp_conn_s
   struct tcp_ofoseg_s ofosegs[TCP_SACK_RANGES_MAX];
 #endif
 
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+  /* Left edge of the last out-of-order segment, whose block is reported
+   * first (RFC 2018, Section 4).
+   */
+
+  uint32_t ofo_recent;
+#endif
+
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   /* Write buffering
    *
@@ -325,6 +451,10 @@ struct tcp_conn_s
   uint32_t   isn;         /* Initial sequence number */
   uint32_t   sndseq_max;  /* The sequence number of next not-retransmitted
                            * segment (next greater sndseq) */
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+  uint32_t   sack_rexmit; /* End of the data retransmitted in the current
+                           * SACK recovery */
+#endif
 #endif
 
 #ifdef CONFIG_NET_TCPBACKLOG
@@ -447,6 +577,16 @@ extern "C"
 {
 #endif
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+extern const struct tcp_cc_ops_s g_tcp_cc_newreno;
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+extern const struct tcp_cc_ops_s g_tcp_cc_cubic;
+#endif
+#ifdef CONFIG_NET_TCP_CC_BBR
+extern const struct tcp_cc_ops_s g_tcp_cc_bbr;
+#endif
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -2185,6 +2325,71 @@ int tcp_ioctl(FAR struct tcp_conn_s *conn, int cmd, unsigned long arg);
 void tcp_sendbuffer_notify(FAR struct tcp_conn_s *conn);
 #endif /* CONFIG_NET_SEND_BUFSIZE */
 
+/****************************************************************************
+ * Name: tcp_autotune_acked
+ *
+ * Description:
+ *   Account the bytes ACKed by an incoming segment to measure the
+ *   bandwidth-delay product and the round trip time of the connection.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   ackseq - The acknowledgement number of the segment
+ *   acked  - The number of bytes newly ACKed
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_BUFSIZE_AUTO
+void tcp_autotune_acked(FAR struct tcp_conn_s *conn, uint32_t ackseq,
+                        uint32_t acked);
+#endif
+
+/****************************************************************************
+ * Name: tcp_autotune_consumed
+ *
+ * Description:
+ *   Account the bytes read by the application to measure its read rate.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   nbytes - The number of bytes read
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_BUFSIZE_AUTO
+void tcp_autotune_consumed(FAR struct tcp_conn_s *conn, uint32_t nbytes);
+#endif
+
+/****************************************************************************
+ * Name: tcp_autotune_sndbuf and tcp_autotune_rcvbuf
+ *
+ * Description:
+ *   Return the current send or receive quota of a connection, sized from
+ *   its measurements up to snd_bufs or rcv_bufs.  Use TCP_SNDBUFS() and
+ *   TCP_RCVBUFS() instead.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *
+ * Returned Value:
+ *   The quota in bytes.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_TCP_BUFSIZE_AUTO) && CONFIG_NET_SEND_BUFSIZE > 0
+uint32_t tcp_autotune_sndbuf(FAR struct tcp_conn_s *conn);
+#endif
+
+#if defined(CONFIG_NET_TCP_BUFSIZE_AUTO) && CONFIG_NET_RECV_BUFSIZE > 0
+uint32_t tcp_autotune_rcvbuf(FAR struct tcp_conn_s *conn);
+#endif
+
 /****************************************************************************
  * Name: tcpip_hdrsize
  *
@@ -2302,6 +2507,74 @@ void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
  ****************************************************************************/
 
 void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion control variables on a retransmission timeout.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_cc_slow_start
+ *
+ * Description:
+ *   Grow cwnd by up to one segment for an ACK (RFC 5681).  Used by the
+ *   algorithms while cwnd is below ssthresh.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   acked  - The number of bytes newly acknowledged
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void tcp_cc_slow_start(FAR struct tcp_conn_s *conn, uint32_t acked);
+
+/****************************************************************************
+ * Name: tcp_cc_select
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection by name.  This
+ *   is the TCP_CONGESTION socket option.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   name   - The name of the algorithm
+ *
+ * Returned Value:
+ *   OK on success; -ENOENT if no such algorithm is configured.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_cc_select(FAR struct tcp_conn_s *conn, FAR const char *name);
+
+/****************************************************************************
+ * Name: tcp_cc_name
+ *
+ * Description:
+ *   Return the name of the congestion control algorithm of a connection.
+ *
+ ****************************************************************************/
+
+FAR const char *tcp_cc_name(FAR struct tcp_conn_s *conn);
 #endif
 
 #ifdef __cplusplus
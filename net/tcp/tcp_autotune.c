@@ -0,0 +1,249 @@
+/****************************************************************************
+ * net/tcp/tcp_autotune.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/net/netconfig.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_BUFSIZE_AUTO
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A quota is twice the amount moved in a round trip, so that it does not
+ * limit a connection that keeps up, but never below a few segments.
+ */
+
+#define TCP_AUTOTUNE_MINSEGS   4
+#define TCP_AUTOTUNE_MIN(conn) \
+  (TCP_AUTOTUNE_MINSEGS * MAX((conn)->mss, MIN_TCP_MSS))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_autotune_clamp
+ *
+ * Description:
+ *   Size a quota for twice the bytes moved per round trip, bounded by the
+ *   minimum and by the configured buffer size.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_autotune_clamp(FAR struct tcp_conn_s *conn,
+                                   uint32_t perrtt, int32_t bufs)
+{
+  uint32_t desire = MAX(2 * perrtt, TCP_AUTOTUNE_MIN(conn));
+
+  return MIN(desire, (uint32_t)bufs);
+}
+
+/****************************************************************************
+ * Name: tcp_autotune_startround
+ *
+ * Description:
+ *   Start measuring a send round if there is data in flight.  The round
+ *   ends when the last byte in flight now is ACKed.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_SEND_BUFSIZE > 0
+static void tcp_autotune_startround(FAR struct tcp_conn_s *conn,
+                                    uint32_t ackseq, clock_t now)
+{
+  FAR struct tcp_autotune_s *at = &conn->autotune;
+
+  at->inround = conn->tx_unacked > 0;
+  if (at->inround)
+    {
+      at->round_seq = ackseq + conn->tx_unacked;
+      at->stamp     = now;
+      at->delivered = 0;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_autotune_acked
+ *
+ * Description:
+ *   Account the bytes ACKed by an incoming segment.  Once per round trip
+ *   this samples the bytes delivered in the round, the bandwidth-delay
+ *   product that the send quota follows, and the round trip time.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   ackseq - The acknowledgement number of the segment
+ *   acked  - The number of bytes newly ACKed
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_autotune_acked(FAR struct tcp_conn_s *conn, uint32_t ackseq,
+                        uint32_t acked)
+{
+#if CONFIG_NET_SEND_BUFSIZE > 0
+  FAR struct tcp_autotune_s *at = &conn->autotune;
+  clock_t now = clock_systime_ticks();
+
+  if (!at->inround)
+    {
+      tcp_autotune_startround(conn, ackseq, now);
+      return;
+    }
+
+  at->delivered += acked;
+  if (TCP_SEQ_GTE(ackseq, at->round_seq))
+    {
+      at->snd_bdp = at->delivered;
+      at->rtt     = MAX(now - at->stamp, 1);
+      tcp_autotune_startround(conn, ackseq, now);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_autotune_consumed
+ *
+ * Description:
+ *   Account the bytes read by the application.  The receive quota follows
+ *   the bytes read per round trip, using the round trip time measured by
+ *   the send rounds or CONFIG_NET_TCP_BUFSIZE_AUTO_RTT until there is one.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   nbytes - The number of bytes read
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_autotune_consumed(FAR struct tcp_conn_s *conn, uint32_t nbytes)
+{
+#if CONFIG_NET_RECV_BUFSIZE > 0
+  FAR struct tcp_autotune_s *at = &conn->autotune;
+  clock_t now = clock_systime_ticks();
+  clock_t interval;
+  clock_t elapsed;
+
+  interval = at->rtt != 0 ? at->rtt :
+             MAX(MSEC2TICK(CONFIG_NET_TCP_BUFSIZE_AUTO_RTT), 1);
+  elapsed  = now - at->rcv_stamp;
+
+  if (elapsed >= interval)
+    {
+      /* Scale the bytes read in the interval to one round trip, an idle
+       * period so lowers the rate.
+       */
+
+      at->rcv_rate   = (uint64_t)at->rcv_copied * interval / elapsed;
+      at->rcv_copied = 0;
+      at->rcv_stamp  = now;
+    }
+
+  at->rcv_copied += nbytes;
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_autotune_sndbuf
+ *
+ * Description:
+ *   Return the current send quota of a connection: twice its measured
+ *   bandwidth-delay product, up to snd_bufs.  A slow peer so only holds
+ *   a few segments of write buffers, whatever its producer does.  A quota
+ *   set with SO_SNDBUF is used as is.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *
+ * Returned Value:
+ *   The number of bytes that may be queued for sending.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_SEND_BUFSIZE > 0
+uint32_t tcp_autotune_sndbuf(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_autotune_s *at = &conn->autotune;
+
+  if ((at->locks & TCP_AUTOTUNE_SNDLOCK) != 0)
+    {
+      return conn->snd_bufs;
+    }
+
+  return tcp_autotune_clamp(conn, MAX(at->snd_bdp, at->delivered),
+                            conn->snd_bufs);
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_autotune_rcvbuf
+ *
+ * Description:
+ *   Return the current receive quota of a connection: twice the bytes its
+ *   application reads per round trip, up to rcv_bufs.  A connection that
+ *   is not read so only holds a few segments of read-ahead buffers.  A
+ *   quota set with SO_RCVBUF is used as is.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *
+ * Returned Value:
+ *   The number of bytes that may be buffered for receiving.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_RECV_BUFSIZE > 0
+uint32_t tcp_autotune_rcvbuf(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_autotune_s *at = &conn->autotune;
+
+  if ((at->locks & TCP_AUTOTUNE_RCVLOCK) != 0)
+    {
+      return conn->rcv_bufs;
+    }
+
+  return tcp_autotune_clamp(conn, MAX(at->rcv_rate, at->rcv_copied),
+                            conn->rcv_bufs);
+}
+#endif
+
+#endif /* CONFIG_NET_TCP_BUFSIZE_AUTO */
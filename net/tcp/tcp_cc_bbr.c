@@ -0,0 +1,330 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_bbr.c
+ * Simplified BBR TCP congestion control
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_CC_BBR
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A simplified BBR: the bottleneck bandwidth and the round trip time are
+ * sampled once per round trip instead of per packet, and as there is no
+ * pacing the gains apply to cwnd.  That keeps the state to a few words per
+ * connection.
+ */
+
+/* The gains are fixed point in 1/256 */
+
+#define BBR_UNIT            256
+#define BBR_HIGH_GAIN       739        /* 2/ln(2), startup */
+#define BBR_CWND_GAIN       512        /* cwnd in PROBE_BW */
+
+/* Startup ends when the bandwidth grew by less than 25% for 3 rounds */
+
+#define BBR_FULL_BW_THRESH  320
+#define BBR_FULL_BW_CNT     3
+
+/* max_bw is forgotten after this number of rounds */
+
+#define BBR_BW_ROUNDS       10
+
+/* min_rtt is refreshed by PROBE_RTT after this long: cwnd is held at
+ * BBR_MIN_CWND segments for one round to drain the queue, and the next
+ * round measures the RTT.
+ */
+
+#define BBR_MIN_RTT_MS      10000
+#define BBR_PROBE_RTT_ROUNDS 2
+#define BBR_MIN_CWND        4
+
+/* The modes */
+
+#define BBR_STARTUP         0
+#define BBR_DRAIN           1
+#define BBR_PROBE_BW        2
+#define BBR_PROBE_RTT       3
+
+#define BBR_ELAPSED_MS(now, stamp) TICK2MSEC((uint64_t)((now) - (stamp)))
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void bbr_init(FAR struct tcp_conn_s *conn);
+static uint32_t bbr_ssthresh(FAR struct tcp_conn_s *conn);
+static void bbr_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked);
+static void bbr_acked(FAR struct tcp_conn_s *conn, uint32_t acked);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_bbr =
+{
+  "bbr",                   /* name */
+  bbr_init,                /* init */
+  bbr_ssthresh,            /* ssthresh */
+  bbr_cong_avoid,          /* cong_avoid */
+  bbr_acked                /* acked */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The cwnd gain of the phases of PROBE_BW: probe for more bandwidth, drain
+ * the queue that this built, then cruise.
+ */
+
+static const uint16_t g_bbr_cycle[] =
+{
+  320, 192, 256, 256, 256, 256, 256, 256
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bbr_bdp
+ *
+ * Description:
+ *   Return the estimated bandwidth-delay product in bytes, 0 if unknown.
+ *
+ ****************************************************************************/
+
+static uint32_t bbr_bdp(FAR struct tcp_bbr_s *bbr)
+{
+  uint64_t bdp = (uint64_t)bbr->max_bw * bbr->min_rtt / 1000;
+
+  return MIN(bdp, UINT32_MAX);
+}
+
+/****************************************************************************
+ * Name: bbr_start_round
+ ****************************************************************************/
+
+static void bbr_start_round(FAR struct tcp_conn_s *conn, clock_t now)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->cc.bbr;
+
+  bbr->round_seq = tcp_getsequence(conn->sndseq);
+  bbr->stamp     = now;
+  bbr->delivered = 0;
+  bbr->inround   = true;
+}
+
+/****************************************************************************
+ * Name: bbr_init
+ ****************************************************************************/
+
+static void bbr_init(FAR struct tcp_conn_s *conn)
+{
+  memset(&conn->cc.bbr, 0, sizeof(struct tcp_bbr_s));
+  conn->cc.bbr.mode = BBR_STARTUP;
+}
+
+/****************************************************************************
+ * Name: bbr_ssthresh
+ *
+ * Description:
+ *   A loss is no congestion signal for BBR: fall back to the model, or to
+ *   halving the flight while there is none.
+ *
+ ****************************************************************************/
+
+static uint32_t bbr_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  uint32_t bdp = bbr_bdp(&conn->cc.bbr);
+
+  if (bdp == 0)
+    {
+      bdp = conn->tx_unacked / 2;
+    }
+
+  return MAX(bdp, 2 * conn->mss);
+}
+
+/****************************************************************************
+ * Name: bbr_acked
+ *
+ * Description:
+ *   Account the ACKed bytes and at the end of each round trip, update the
+ *   bandwidth and RTT estimates and the mode.
+ *
+ ****************************************************************************/
+
+static void bbr_acked(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->cc.bbr;
+  clock_t now = clock_systime_ticks();
+  uint32_t rtt;
+  uint64_t bw;
+
+  if (!bbr->inround)
+    {
+      bbr_start_round(conn, now);
+      return;
+    }
+
+  bbr->delivered += acked;
+  if (TCP_SEQ_LT(conn->last_ackno, bbr->round_seq))
+    {
+      return;
+    }
+
+  /* The round is over, take the samples */
+
+  rtt = MAX(BBR_ELAPSED_MS(now, bbr->stamp), 1);
+  bw = (uint64_t)bbr->delivered * 1000 / rtt;
+  bw = MIN(bw, UINT32_MAX);
+
+  if (bw >= bbr->max_bw || ++bbr->bw_age >= BBR_BW_ROUNDS)
+    {
+      bbr->max_bw = bw;
+      bbr->bw_age = 0;
+    }
+
+  if (bbr->min_rtt == 0 || rtt <= bbr->min_rtt)
+    {
+      bbr->min_rtt       = rtt;
+      bbr->min_rtt_stamp = now;
+    }
+
+  switch (bbr->mode)
+    {
+      case BBR_STARTUP:
+        if (bbr->max_bw >= (uint64_t)bbr->full_bw * BBR_FULL_BW_THRESH /
+                           BBR_UNIT)
+          {
+            bbr->full_bw  = bbr->max_bw;
+            bbr->full_cnt = 0;
+          }
+        else if (++bbr->full_cnt >= BBR_FULL_BW_CNT)
+          {
+            bbr->mode = BBR_DRAIN;
+          }
+        break;
+
+      case BBR_PROBE_BW:
+        bbr->cycle = (bbr->cycle + 1) % nitems(g_bbr_cycle);
+        break;
+
+      case BBR_PROBE_RTT:
+        if (++bbr->cycle >= BBR_PROBE_RTT_ROUNDS)
+          {
+            bbr->min_rtt       = rtt;
+            bbr->min_rtt_stamp = now;
+            bbr->mode          = BBR_PROBE_BW;
+            bbr->cycle         = 0;
+          }
+        break;
+
+      default:
+        break;
+    }
+
+  /* Let in-flight data drain now and then to see the propagation delay */
+
+  if (bbr->mode == BBR_PROBE_BW &&
+      BBR_ELAPSED_MS(now, bbr->min_rtt_stamp) >= BBR_MIN_RTT_MS)
+    {
+      bbr->mode  = BBR_PROBE_RTT;
+      bbr->cycle = 0;
+    }
+
+  bbr_start_round(conn, now);
+}
+
+/****************************************************************************
+ * Name: bbr_cong_avoid
+ *
+ * Description:
+ *   Set cwnd to the gain of the mode times the bandwidth-delay product.
+ *
+ ****************************************************************************/
+
+static void bbr_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->cc.bbr;
+  uint32_t mincwnd = BBR_MIN_CWND * conn->mss;
+  uint32_t bdp = bbr_bdp(bbr);
+  uint64_t target;
+
+  if (bdp == 0 || bbr->mode == BBR_STARTUP)
+    {
+      /* Grow exponentially until the pipe is full */
+
+      if (bdp == 0 ||
+          conn->cwnd < (uint64_t)bdp * BBR_HIGH_GAIN / BBR_UNIT)
+        {
+          conn->cwnd = MIN((uint64_t)conn->cwnd + acked,
+                           MAX(conn->max_cwnd, mincwnd));
+        }
+
+      return;
+    }
+
+  switch (bbr->mode)
+    {
+      case BBR_DRAIN:
+        target = bdp;
+        if (conn->tx_unacked <= bdp)
+          {
+            bbr->mode  = BBR_PROBE_BW;
+            bbr->cycle = 0;
+          }
+        break;
+
+      case BBR_PROBE_RTT:
+        target = 0;
+        break;
+
+      default:
+        target = (uint64_t)bdp * BBR_CWND_GAIN / BBR_UNIT *
+                 g_bbr_cycle[bbr->cycle] / BBR_UNIT;
+        break;
+    }
+
+  target = MAX(target, mincwnd);
+  target = MIN(target, MAX(conn->max_cwnd, mincwnd));
+
+  conn->cwnd = MIN((uint64_t)conn->cwnd + acked, target);
+  ninfo("update bbr cwnd to %" PRIu32 "\n", conn->cwnd);
+}
+
+#endif /* CONFIG_NET_TCP_CC_BBR */
@@ -0,0 +1,233 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_cubic.c
+ * CUBIC TCP congestion control
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The multiplicative decrease factor, beta = 0.7, in 1/1024 */
+
+#define CUBIC_BETA        717
+
+/* The scaling constant, C = 0.4 segments per second cubed */
+
+#define CUBIC_C_NUM       4
+#define CUBIC_C_DEN       10
+
+/* The additive increase of the Reno-friendly estimate in segments per
+ * round trip, alpha = 3 * (1 - beta) / (1 + beta) ~= 9 / 17
+ */
+
+#define CUBIC_ALPHA_NUM   9
+#define CUBIC_ALPHA_DEN   17
+
+/* Bound of |t - K| so that the cube times the segment size fits 63 bits */
+
+#define CUBIC_MAX_DELTA   30000      /* ms */
+
+/* One second cubed in ms */
+
+#define CUBIC_SEC3        1000000000ull
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn);
+static uint32_t cubic_ssthresh(FAR struct tcp_conn_s *conn);
+static void cubic_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_cubic =
+{
+  "cubic",                 /* name */
+  cubic_init,              /* init */
+  cubic_ssthresh,          /* ssthresh */
+  cubic_cong_avoid,        /* cong_avoid */
+  NULL                     /* acked */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cubic_root
+ *
+ * Description:
+ *   Return the integer cube root of a 64-bit value.
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_root(uint64_t x)
+{
+  uint64_t y = 0;
+  uint64_t b;
+  int s;
+
+  for (s = 63; s >= 0; s -= 3)
+    {
+      y <<= 1;
+      b = 3 * y * (y + 1) + 1;
+      if ((x >> s) >= b)
+        {
+          x -= b << s;
+          y++;
+        }
+    }
+
+  return (uint32_t)y;
+}
+
+/****************************************************************************
+ * Name: cubic_init
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn)
+{
+  memset(&conn->cc.cubic, 0, sizeof(struct tcp_cubic_s));
+}
+
+/****************************************************************************
+ * Name: cubic_ssthresh
+ *
+ * Description:
+ *   Remember the window at the loss, which is the plateau of the next
+ *   curve, and reduce it by beta.
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_cubic_s *ca = &conn->cc.cubic;
+  uint32_t cwnd = conn->cwnd;
+
+  ca->epoch = 0;
+
+  /* Fast convergence: a plateau below the previous one means that another
+   * flow is taking bandwidth, so give some more up.
+   */
+
+  if (cwnd < ca->w_max)
+    {
+      ca->w_max = (uint64_t)cwnd * (1024 + CUBIC_BETA) / 2048;
+    }
+  else
+    {
+      ca->w_max = cwnd;
+    }
+
+  return MAX((uint64_t)cwnd * CUBIC_BETA / 1024, 2 * conn->mss);
+}
+
+/****************************************************************************
+ * Name: cubic_cong_avoid
+ *
+ * Description:
+ *   Grow cwnd towards W_cubic(t) = C * (t - K)^3 + W_max, or the
+ *   Reno-friendly estimate if that is larger.
+ *
+ ****************************************************************************/
+
+static void cubic_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  FAR struct tcp_cubic_s *ca = &conn->cc.cubic;
+  clock_t now = clock_systime_ticks();
+  uint32_t cwnd = conn->cwnd;
+  uint32_t mss = conn->mss;
+  int64_t target;
+  int64_t delta;
+
+  if (cwnd < conn->ssthresh)
+    {
+      tcp_cc_slow_start(conn, acked);
+      return;
+    }
+
+  /* A new epoch starts with the first ACK after a reduction */
+
+  if (ca->epoch == 0)
+    {
+      ca->epoch = now;
+      ca->w_est = cwnd;
+
+      if (cwnd < ca->w_max)
+        {
+          /* K = cbrt((W_max - cwnd) / C) in segments and seconds */
+
+          ca->k      = cubic_root((uint64_t)((ca->w_max - cwnd) / mss) *
+                                  CUBIC_SEC3 * CUBIC_C_DEN / CUBIC_C_NUM);
+          ca->origin = ca->w_max;
+        }
+      else
+        {
+          ca->k      = 0;
+          ca->origin = cwnd;
+        }
+    }
+
+  delta = (int64_t)TICK2MSEC((uint64_t)(now - ca->epoch)) - ca->k;
+  delta = MIN(MAX(delta, -CUBIC_MAX_DELTA), CUBIC_MAX_DELTA);
+
+  target = (int64_t)ca->origin + delta * delta * delta * CUBIC_C_NUM *
+           mss / (int64_t)(CUBIC_C_DEN * CUBIC_SEC3);
+
+  /* Never grow faster than by half of the window per round trip */
+
+  target = MIN(target, (int64_t)cwnd * 3 / 2);
+
+  ca->w_est += (uint64_t)acked * mss * CUBIC_ALPHA_NUM /
+               ((uint64_t)CUBIC_ALPHA_DEN * cwnd);
+  target = MAX(target, (int64_t)ca->w_est);
+
+  /* cwnd grows by (target - cwnd) / cwnd segments per ACK */
+
+  if (target > cwnd)
+    {
+      uint32_t increase = (uint64_t)(target - cwnd) * mss / cwnd;
+
+      conn->cwnd = MIN(cwnd + MAX(increase, 1), conn->max_cwnd);
+      ninfo("update cubic cwnd to %" PRIu32 "\n", conn->cwnd);
+    }
+}
+
+#endif /* CONFIG_NET_TCP_CC_CUBIC */
@@ -89,10 +89,115 @@ static dq_queue_t g_free_tcp_connections;
 
 static dq_queue_t g_active_tcp_connections;
 
+/* The connected TCP connections again, hashed on their ports and remote
+ * address.  The list above is still used to visit all of them.
+ */
+
+#ifdef CONFIG_NET_TCP_CONN_HASH
+static FAR struct tcp_conn_s *g_tcp_conn_hash[CONFIG_NET_TCP_CONN_HASHSIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+
+/****************************************************************************
+ * Name: tcp_hash
+ *
+ * Description:
+ *   Return the hash bucket of the connection with the given ports, in
+ *   network byte order, and the given 32 bits of the remote address.
+ *
+ ****************************************************************************/
+
+static inline unsigned int tcp_hash(uint16_t lport, uint16_t rport,
+                                    uint32_t raddr)
+{
+  uint32_t hash = (((uint32_t)lport << 16) | rport) ^ raddr;
+
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3b;
+  hash ^= hash >> 16;
+
+  return hash % CONFIG_NET_TCP_CONN_HASHSIZE;
+}
+
+#ifdef CONFIG_NET_IPv6
+static inline uint32_t tcp_hash_ipv6addr(FAR const uint16_t *addr)
+{
+  /* The interface identifier differs most between hosts */
+
+  return ((uint32_t)addr[6] << 16) | addr[7];
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_conn_hash
+ *
+ * Description:
+ *   Return the hash bucket of a connection.
+ *
+ ****************************************************************************/
+
+static FAR struct tcp_conn_s **tcp_conn_hash(FAR struct tcp_conn_s *conn)
+{
+  uint32_t raddr;
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (conn->domain == PF_INET6)
+#endif
+    {
+      raddr = tcp_hash_ipv6addr(conn->u.ipv6.raddr);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      raddr = conn->u.ipv4.raddr;
+    }
+#endif
+
+  return &g_tcp_conn_hash[tcp_hash(conn->lport, conn->rport, raddr)];
+}
+
+/****************************************************************************
+ * Name: tcp_conn_hashadd and tcp_conn_hashrem
+ *
+ * Description:
+ *   Add a connection to, or remove it from, its hash bucket as it enters or
+ *   leaves the active list.
+ *
+ ****************************************************************************/
+
+static void tcp_conn_hashadd(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s **bucket = tcp_conn_hash(conn);
+
+  conn->hnext = *bucket;
+  *bucket     = conn;
+}
+
+static void tcp_conn_hashrem(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s **prev;
+
+  for (prev = tcp_conn_hash(conn); *prev != NULL; prev = &(*prev)->hnext)
+    {
+      if (*prev == conn)
+        {
+          *prev = conn->hnext;
+          break;
+        }
+    }
+}
+#endif /* CONFIG_NET_TCP_CONN_HASH */
+
 /****************************************************************************
  * Name: tcp_listener
  *
@@ -187,9 +292,14 @@ static inline FAR struct tcp_conn_s *
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  conn       = g_tcp_conn_hash[tcp_hash(tcp->destport, tcp->srcport,
+                                        srcipaddr)];
+#else
+  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
 
   while (conn)
     {
@@ -215,7 +325,11 @@ static inline FAR struct tcp_conn_s *
           tcp->srcport  == conn->rport &&
           (net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY) ||
            net_ipv4addr_cmp(destipaddr, conn->u.ipv4.laddr)) &&
-          net_ipv4addr_cmp(srcipaddr, conn->u.ipv4.raddr))
+          net_ipv4addr_cmp(srcipaddr, conn->u.ipv4.raddr)
+#if defined(CONFIG_NET_TCP_CONN_HASH) && defined(CONFIG_NET_IPv6)
+          && conn->domain == PF_INET
+#endif
+         )
         {
           /* Matching connection found.. break out of the loop and return a
            * reference to it.
@@ -226,7 +340,11 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+      conn = conn->hnext;
+#else
       conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+#endif
     }
 
   return conn;
@@ -254,9 +372,14 @@ static inline FAR struct tcp_conn_s *
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  conn       = g_tcp_conn_hash[tcp_hash(tcp->destport, tcp->srcport,
+                                        tcp_hash_ipv6addr(*srcipaddr))];
+#else
+  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
 
   while (conn)
     {
@@ -282,7 +405,11 @@ static inline FAR struct tcp_conn_s *
           tcp->srcport  == conn->rport &&
           (net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_unspecaddr) ||
            net_ipv6addr_cmp(*destipaddr, conn->u.ipv6.laddr)) &&
-          net_ipv6addr_cmp(*srcipaddr, conn->u.ipv6.raddr))
+          net_ipv6addr_cmp(*srcipaddr, conn->u.ipv6.raddr)
+#if defined(CONFIG_NET_TCP_CONN_HASH) && defined(CONFIG_NET_IPv4)
+          && conn->domain == PF_INET6
+#endif
+         )
         {
           /* Matching connection found.. break out of the loop and return a
            * reference to it.
@@ -293,7 +420,11 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+      conn = conn->hnext;
+#else
       conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+#endif
     }
 
   return conn;
@@ -820,6 +951,7 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
 
       nxsem_init(&conn->snd_sem, 0, 0);
 #endif
+      conn_lock_init(&conn->sconn);
 
       /* Set the default value of mss to max, this field will changed when
        * receive SYN.
@@ -939,9 +1071,13 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       /* Remove the connection from the active list */
 
       dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+      tcp_conn_hashrem(conn);
+#endif
     }
 
   tcp_free_rx_buffers(conn);
+  conn_lock_destroy(&conn->sconn);
 
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   /* Release any write buffers attached to the connection */
@@ -1186,6 +1322,9 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
 #  ifdef CONFIG_NET_BINDTODEVICE
       conn->sconn.s_boundto  = listener->sconn.s_boundto;
 #  endif
+#  ifdef CONFIG_NET_SOPRIORITY
+      conn->sconn.s_priority = listener->sconn.s_priority;
+#  endif
 #endif
 
       conn->sconn.s_tos      = listener->sconn.s_tos;
@@ -1195,8 +1334,14 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
 #endif
 #if CONFIG_NET_SEND_BUFSIZE > 0
       conn->snd_bufs         = listener->snd_bufs;
+#endif
+#ifdef CONFIG_NET_TCP_BUFSIZE_AUTO
+      conn->autotune.locks   = listener->autotune.locks;
 #endif
       conn->mss              = listener->mss;
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      conn->cc_ops           = listener->cc_ops;
+#endif
 
       /* Fill in the necessary fields for the new connection. */
 
@@ -1248,6 +1393,9 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        */
 
       dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+      tcp_conn_hashadd(conn);
+#endif
       tcp_update_retrantimer(conn, TCP_RTO);
     }
 
@@ -1556,6 +1704,9 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   /* And, finally, put the connection structure into the active list. */
 
   dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  tcp_conn_hashadd(conn);
+#endif
   ret = OK;
 
 errout_with_lock:
@@ -432,6 +432,10 @@ static void tcp_input_ofosegs(FAR struct net_driver_s *dev,
   ofoseg.left =
     tcp_getsequence(((FAR struct tcp_hdr_s *)IPBUF(iplen))->seqno);
 
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+  conn->ofo_recent = ofoseg.left;
+#endif
+
   /* Calculate the pending size of out-of-order cache, if the input edge can
    * not fill the adjacent segments, drop it
    */
@@ -722,7 +726,7 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 
   /* Start of TCP input header processing code. */
 
-  if (tcp_chksum(dev) != 0xffff)
+  if (!net_chksum_rxoffload(dev) && tcp_chksum(dev) != 0xffff)
     {
       /* Compute and check the TCP checksum. */
 
@@ -1024,6 +1028,9 @@ found:
 
   if ((tcp->flags & TCP_ACK) != 0 && conn->tx_unacked > 0)
     {
+#ifdef CONFIG_NET_TCP_BUFSIZE_AUTO
+      uint32_t prevunacked = conn->tx_unacked;
+#endif
       uint32_t unackseq;
       uint32_t ackseq;
 
@@ -1087,6 +1094,12 @@ found:
             }
         }
 
+#ifdef CONFIG_NET_TCP_BUFSIZE_AUTO
+      tcp_autotune_acked(conn, ackseq,
+                         prevunacked > conn->tx_unacked ?
+                         prevunacked - conn->tx_unacked : 0);
+#endif
+
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
 #ifdef CONFIG_NET_SENDFILE
       if (!conn->sendfile)
@@ -1266,6 +1279,9 @@ found:
             tcp_setsequence(conn->sndseq, conn->isn);
             conn->sent          = 0;
             conn->sndseq_max    = 0;
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+            conn->sack_rexmit   = conn->isn;
+#endif
 #endif
             conn->tx_unacked    = 0;
             tcp_snd_wnd_init(conn, tcp);
@@ -1332,6 +1348,9 @@ found:
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
             conn->isn           = tcp_getsequence(tcp->ackno);
             tcp_setsequence(conn->sndseq, conn->isn);
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+            conn->sack_rexmit   = conn->isn;
+#endif
 #endif
             dev->d_len          = 0;
             dev->d_sndlen       = 0;
@@ -35,8 +35,11 @@
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/net.h>
+#include <nuttx/net/ioctl.h>
 
+#include "netdev/netdev.h"
 #include "tcp/tcp.h"
+#include "socket/socket.h"
 
 /****************************************************************************
  * Private Functions
@@ -103,6 +106,85 @@ static void tcp_path(FAR struct tcp_conn_s *conn, FAR char *buf, size_t len)
            );
 }
 
+/****************************************************************************
+ * Name: tcp_zcrecv
+ *
+ * Description:
+ *   Hand the whole read-ahead IOB chain to the caller.  The data of each
+ *   IOB starts at io_offset and is io_len bytes long; io_pktlen of the
+ *   head is the total.
+ *
+ * Parameters:
+ *   conn     The TCP connection of interest
+ *   iobp     The location to return the chain, NULL at the end of stream
+ *
+ * Returned Value:
+ *   OK on success, -EAGAIN if there is no data yet or -ENOTCONN if the
+ *   connection is lost.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY_RECV
+static int tcp_zcrecv(FAR struct tcp_conn_s *conn, FAR struct iob_s **iobp)
+{
+  FAR struct iob_s *iob;
+
+  conn_lock(&conn->sconn);
+  iob = conn->readahead;
+  if (iob != NULL)
+    {
+      conn->readahead = NULL;
+      conn->rcv_held += iob->io_pktlen;
+    }
+
+  conn_unlock(&conn->sconn);
+
+  *iobp = iob;
+  if (iob != NULL)
+    {
+      return OK;
+    }
+
+  if (!_SS_ISCONNECTED(conn->sconn.s_flags))
+    {
+      return _SS_ISCLOSED(conn->sconn.s_flags) ? OK : -ENOTCONN;
+    }
+
+  return -EAGAIN;
+}
+
+/****************************************************************************
+ * Name: tcp_zcrelease
+ *
+ * Description:
+ *   Free a chain returned by tcp_zcrecv() and reopen the receive window.
+ *
+ * Parameters:
+ *   conn     The TCP connection that the chain was taken from
+ *   iob      The unmodified head of the chain
+ *
+ ****************************************************************************/
+
+static int tcp_zcrelease(FAR struct tcp_conn_s *conn, FAR struct iob_s *iob)
+{
+  if (iob == NULL || iob->io_pktlen > conn->rcv_held)
+    {
+      return -EINVAL;
+    }
+
+  conn->rcv_held -= iob->io_pktlen;
+  iob_free_chain(iob);
+
+  if (_SS_ISCONNECTED(conn->sconn.s_flags) &&
+      tcp_should_send_recvwindow(conn))
+    {
+      netdev_txnotify_dev(conn->dev);
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -130,6 +212,7 @@ int tcp_ioctl(FAR struct tcp_conn_s *conn, int cmd, unsigned long arg)
   switch (cmd)
     {
       case FIONREAD:
+        conn_lock(&conn->sconn);
         if (conn->readahead != NULL)
           {
             *(FAR int *)((uintptr_t)arg) = conn->readahead->io_pktlen;
@@ -138,6 +221,8 @@ int tcp_ioctl(FAR struct tcp_conn_s *conn, int cmd, unsigned long arg)
           {
             *(FAR int *)((uintptr_t)arg) = 0;
           }
+
+        conn_unlock(&conn->sconn);
         break;
       case FIONSPACE:
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
@@ -146,7 +231,7 @@ int tcp_ioctl(FAR struct tcp_conn_s *conn, int cmd, unsigned long arg)
                                 iob_navail(true) * CONFIG_IOB_BUFSIZE;
 #  else
         *(FAR int *)((uintptr_t)arg) =
-                        conn->snd_bufs - tcp_wrbuffer_inqueue_size(conn);
+                      TCP_SNDBUFS(conn) - tcp_wrbuffer_inqueue_size(conn);
 #  endif
 #else
         *(FAR int *)((uintptr_t)arg) = MIN_TCP_MSS;
@@ -155,6 +240,14 @@ int tcp_ioctl(FAR struct tcp_conn_s *conn, int cmd, unsigned long arg)
       case FIOC_FILEPATH:
         tcp_path(conn, (FAR char *)(uintptr_t)arg, PATH_MAX);
         break;
+#ifdef CONFIG_NET_TCP_ZEROCOPY_RECV
+      case SIOCTCPZCRECV:
+        ret = tcp_zcrecv(conn, (FAR struct iob_s **)((uintptr_t)arg));
+        break;
+      case SIOCTCPZCRELEASE:
+        ret = tcp_zcrelease(conn, (FAR struct iob_s *)((uintptr_t)arg));
+        break;
+#endif
       default:
         ret = -ENOTTY;
         break;
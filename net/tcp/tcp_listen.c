@@ -59,9 +59,18 @@
  * Private Data
  ****************************************************************************/
 
-/* The tcp_listenports list all currently listening ports. */
+/* The tcp_listenports list all currently listening ports.  With the hash
+ * table, the listeners are chained on the buckets of their local port.
+ */
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+#  define TCP_LISTEN_HASH(p) ((p) % CONFIG_NET_TCP_CONN_HASHSIZE)
+
+static FAR struct tcp_conn_s *tcp_listenhash[CONFIG_NET_TCP_CONN_HASHSIZE];
+static int tcp_nlisteners;
+#else
 static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -87,17 +96,28 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
                                         uint16_t portno)
 #endif
 {
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR struct tcp_conn_s *conn;
+
+  /* Examine each listener on the bucket of this port */
+
+  for (conn = tcp_listenhash[TCP_LISTEN_HASH(portno)]; conn != NULL;
+       conn = conn->hnext)
+#else
   int ndx;
 
   /* Examine each connection structure in each slot of the listener list */
 
   for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+#endif
     {
       /* Is this slot assigned?  If so, does the connection have the same
        * local port number?
        */
 
+#ifndef CONFIG_NET_TCP_CONN_HASH
       FAR struct tcp_conn_s *conn = tcp_listenports[ndx];
+#endif
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
       if (conn && conn->lport == portno && conn->domain == domain)
 #else
@@ -158,10 +178,27 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
 
 int tcp_unlisten(FAR struct tcp_conn_s *conn)
 {
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR struct tcp_conn_s **prev;
+#else
   int ndx;
+#endif
   int ret = -EINVAL;
 
   net_lock();
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  for (prev = &tcp_listenhash[TCP_LISTEN_HASH(conn->lport)];
+       *prev != NULL; prev = &(*prev)->hnext)
+    {
+      if (*prev == conn)
+        {
+          *prev = conn->hnext;
+          tcp_nlisteners--;
+          ret = OK;
+          break;
+        }
+    }
+#else
   for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
     {
       if (tcp_listenports[ndx] == conn)
@@ -171,6 +208,7 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
           break;
         }
     }
+#endif
 
   net_unlock();
   return ret;
@@ -189,7 +227,11 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
 
 int tcp_listen(FAR struct tcp_conn_s *conn)
 {
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR struct tcp_conn_s **bucket;
+#else
   int ndx;
+#endif
   int ret;
 
   /* This must be done with network locked because the listener table
@@ -218,6 +260,20 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
 
       ret = -ENOBUFS; /* Assume failure */
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+      /* The listener is never in the hash table of the active
+       * connections, so its link is free.
+       */
+
+      if (tcp_nlisteners < CONFIG_NET_MAX_LISTENPORTS)
+        {
+          bucket      = &tcp_listenhash[TCP_LISTEN_HASH(conn->lport)];
+          conn->hnext = *bucket;
+          *bucket     = conn;
+          tcp_nlisteners++;
+          ret = OK;
+        }
+#else
       /* Search all slots until an available slot is found */
 
       for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
@@ -233,6 +289,7 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
               break;
             }
         }
+#endif
     }
 
   net_unlock();
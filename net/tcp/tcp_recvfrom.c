@@ -233,7 +233,7 @@ static inline uint16_t tcp_newdata(FAR struct net_driver_s *dev,
  *   None
  *
  * Assumptions:
- *   The network is locked.
+ *   The connection is locked.
  *
  ****************************************************************************/
 
@@ -617,22 +617,35 @@ ssize_t psock_tcp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
   FAR struct tcp_conn_s *conn;
   int                    ret;
 
-  net_lock();
-
   conn = psock->s_conn;
 
-  /* Initialize the state structure.  This is done with the network locked
-   * because we don't want anything to happen until we are ready.
-   */
+  /* Initialize the state structure. */
 
   tcp_recvfrom_initialize(conn, buf, len, from, fromlen, &state, flags);
 
   /* Handle any any TCP data already buffered in a read-ahead buffer.  NOTE
    * that there may be read-ahead data to be retrieved even after the
-   * socket has been disconnected.
+   * socket has been disconnected.  The read-ahead data is protected by the
+   * connection lock, so it is copied before the network is locked.
    */
 
+  conn_lock(&conn->sconn);
   tcp_readahead(&state);
+  conn_unlock(&conn->sconn);
+
+  net_lock();
+
+  /* Take what was buffered before the network was locked, a wait below
+   * would only be woken by new data.
+   */
+
+  if (state.ir_buflen > 0 &&
+      ((flags & MSG_PEEK) == 0 || state.ir_recvlen == 0))
+    {
+      conn_lock(&conn->sconn);
+      tcp_readahead(&state);
+      conn_unlock(&conn->sconn);
+    }
 
   /* The default return value is the number of bytes that we just copied
    * into the user buffer.  We will return this if the socket has become
@@ -752,6 +765,13 @@ ssize_t psock_tcp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
    * not only this particular connection.
    */
 
+#ifdef CONFIG_NET_TCP_BUFSIZE_AUTO
+  if (ret > 0 && (flags & MSG_PEEK) == 0)
+    {
+      tcp_autotune_consumed(conn, ret);
+    }
+#endif
+
   if (tcp_should_send_recvwindow(conn))
     {
       netdev_txnotify_dev(conn->dev);
@@ -61,12 +61,21 @@ static uint32_t tcp_calc_rcvsize(FAR struct tcp_conn_s *conn,
 {
 #if CONFIG_NET_RECV_BUFSIZE > 0
   uint32_t recvsize;
+  uint32_t rcvbufs;
   uint32_t desire;
 
+  conn_lock(&conn->sconn);
   recvsize = conn->readahead ? conn->readahead->io_pktlen : 0;
-  if (conn->rcv_bufs > recvsize)
+  conn_unlock(&conn->sconn);
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY_RECV
+  recvsize += conn->rcv_held;
+#endif
+
+  rcvbufs = TCP_RCVBUFS(conn);
+  if (rcvbufs > recvsize)
     {
-      desire = conn->rcv_bufs - recvsize;
+      desire = rcvbufs - recvsize;
       if (recvwndo > desire)
         {
           recvwndo = desire;
@@ -154,6 +163,7 @@ uint32_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
    * (ignoring competition with other IOB consumers).
    */
 
+  conn_lock(&conn->sconn);
   if (conn->readahead != NULL)
     {
       tailroom = iob_tailroom(conn->readahead);
@@ -163,6 +173,8 @@ uint32_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
       tailroom = 0;
     }
 
+  conn_unlock(&conn->sconn);
+
   niob_avail = iob_navail(true);
 
   /* Is there a a queue entry and IOBs available for read-ahead buffering? */
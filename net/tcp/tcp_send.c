@@ -187,7 +187,11 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       /* Calculate TCP checksum. */
 
       tcp->tcpchksum = 0;
-      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+      if (!net_chksum_txoffload(dev))
+        {
+          tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+        }
+
 #ifdef CONFIG_NET_STATISTICS
       g_netstats.ipv6.sent++;
 #endif
@@ -207,7 +211,11 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       /* Calculate TCP checksum. */
 
       tcp->tcpchksum = 0;
-      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+      if (!net_chksum_txoffload(dev))
+        {
+          tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+        }
+
 #ifdef CONFIG_NET_STATISTICS
       g_netstats.ipv4.sent++;
 #endif
@@ -281,7 +289,9 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 #ifdef CONFIG_NET_TCP_SELECTIVE_ACK
   if ((conn->flags & TCP_SACK) && (flags == TCP_ACK) && conn->nofosegs > 0)
     {
+      FAR struct tcp_ofoseg_s *seg;
       int optlen = conn->nofosegs * sizeof(struct tcp_sack_s);
+      int first = 0;
       int i;
 
       tcp->optdata[0] = TCP_OPT_NOOP;
@@ -291,16 +301,31 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
       optlen += 4;
 
+      /* The first block must hold the most recently received segment, the
+       * others follow in sequence order (RFC 2018, Section 4).
+       */
+
       for (i = 0; i < conn->nofosegs; i++)
         {
+          if (TCP_SEQ_GTE(conn->ofo_recent, conn->ofosegs[i].left) &&
+              TCP_SEQ_LT(conn->ofo_recent, conn->ofosegs[i].right))
+            {
+              first = i;
+              break;
+            }
+        }
+
+      for (i = 0; i < conn->nofosegs; i++)
+        {
+          seg = &conn->ofosegs[i == 0 ? first : (i <= first ? i - 1 : i)];
+
           ninfo("TCP SACK [%d]"
                 "[%" PRIu32 " : %" PRIu32 " : %" PRIu32 "]\n", i,
-                conn->ofosegs[i].left, conn->ofosegs[i].right,
-                TCP_SEQ_SUB(conn->ofosegs[i].right, conn->ofosegs[i].left));
+                seg->left, seg->right, TCP_SEQ_SUB(seg->right, seg->left));
           tcp_setsequence(&tcp->optdata[4 + i * 2 * sizeof(uint32_t)],
-                          conn->ofosegs[i].left);
+                          seg->left);
           tcp_setsequence(&tcp->optdata[4 + (i * 2 + 1) * sizeof(uint32_t)],
-                          conn->ofosegs[i].right);
+                          seg->right);
         }
 
       dev->d_len += optlen;
@@ -480,7 +505,10 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
                         conn ? conn->sconn.ttl : IP_TTL_DEFAULT,
                         conn ? conn->sconn.s_tos : 0);
       tcp->tcpchksum = 0;
-      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+      if (!net_chksum_txoffload(dev))
+        {
+          tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+        }
     }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -497,7 +525,10 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
                         conn ? conn->sconn.s_tos : 0, NULL);
 
       tcp->tcpchksum = 0;
-      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+      if (!net_chksum_txoffload(dev))
+        {
+          tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+        }
     }
 #endif /* CONFIG_NET_IPv4 */
 }
@@ -318,7 +318,9 @@ static inline void psock_lost_connection(FAR struct tcp_conn_s *conn,
  * Name: parse_sack
  *
  * Description:
- *   Parse sack from incoming TCP options
+ *   Parse sack from incoming TCP options.  Blocks that are malformed, that
+ *   are already covered by the cumulative ACK (D-SACK) or that exceed what
+ *   was sent are ignored.
  *
  * Input Parameters:
  *   conn   - The TCP connection of interest
@@ -335,18 +337,24 @@ static inline void psock_lost_connection(FAR struct tcp_conn_s *conn,
 
 #ifdef CONFIG_NET_TCP_SELECTIVE_ACK
 static int parse_sack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp,
-                      FAR struct tcp_ofoseg_s *segs)
+                      uint32_t ackno, FAR struct tcp_ofoseg_s *segs)
 {
   FAR struct tcp_sack_s *sacks;
+  uint32_t sndseq = tcp_getsequence(conn->sndseq);
+  uint32_t left;
+  uint32_t right;
+  int optlen = ((tcp->tcpoffset >> 4) - 5) << 2;
   int nsack = 0;
   uint8_t opt;
+  int len;
   int i;
+  int j;
 
   /* Get the size of the link layer header,
    * the IP and TCP header
    */
 
-  for (i = 0; i < ((tcp->tcpoffset >> 4) - 5) << 2 ; )
+  for (i = 0; i < optlen; )
     {
       opt = *(tcp->optdata + i);
       if (opt == TCP_OPT_END)
@@ -364,19 +372,33 @@ static int parse_sack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp,
         }
       else if (opt == TCP_OPT_SACK)
         {
-          nsack = (*(tcp->optdata + 1 + i) -
-                   TCP_OPT_SACK_PERM_LEN) /
-                   (sizeof(uint32_t) * 2);
+          len = i + 1 < optlen ? *(tcp->optdata + 1 + i) : 0;
+          if (len < TCP_OPT_SACK_PERM_LEN || i + len > optlen)
+            {
+              break;
+            }
+
+          len   = (len - TCP_OPT_SACK_PERM_LEN) / (sizeof(uint32_t) * 2);
           sacks = (FAR struct tcp_sack_s *)
                   (tcp->optdata + i +
                    TCP_OPT_SACK_PERM_LEN);
 
-          for (i = 0; i < nsack; i++)
+          for (j = 0; j < len && nsack < TCP_SACK_RANGES_MAX; j++)
             {
               /* Use the pointer to avoid the error of 4 byte alignment. */
 
-              segs[i].left = tcp_getsequence((uint8_t *)&sacks[i]);
-              segs[i].right = tcp_getsequence((uint8_t *)&sacks[i] + 4);
+              left  = tcp_getsequence((uint8_t *)&sacks[j]);
+              right = tcp_getsequence((uint8_t *)&sacks[j] + 4);
+
+              if (TCP_SEQ_LTE(right, ackno) || TCP_SEQ_GTE(left, right) ||
+                  TCP_SEQ_GT(right, sndseq))
+                {
+                  continue;
+                }
+
+              segs[nsack].left  = left;
+              segs[nsack].right = right;
+              nsack++;
             }
 
           tcp_reorder_ofosegs(nsack, segs);
@@ -389,7 +411,7 @@ static int parse_sack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp,
            * so that we easily can skip past them.
            */
 
-          if (*(tcp->optdata + 1 + i) == 0)
+          if (i + 1 >= optlen || *(tcp->optdata + 1 + i) == 0)
             {
               /* If the length field is zero,
                * the options are malformed and
@@ -433,6 +455,7 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
   FAR struct tcp_conn_s *conn = pvpriv;
 #ifdef CONFIG_NET_TCP_SELECTIVE_ACK
   struct tcp_ofoseg_s ofosegs[TCP_SACK_RANGES_MAX];
+  uint32_t sackno = 0;
   uint8_t nsacks = 0;
 #endif
 #ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
@@ -503,6 +526,18 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       ackno = tcp_getsequence(tcp->ackno);
       ninfo("ACK: ackno=%" PRIu32 " flags=%04x\n", ackno, flags);
 
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+      /* Keep the retransmission mark at or above the cumulative ACK.  A
+       * mark left behind would wrap around and skip every hole once more
+       * than 2^31 bytes are sent without loss.
+       */
+
+      if (TCP_SEQ_LT(conn->sack_rexmit, ackno))
+        {
+          conn->sack_rexmit = ackno;
+        }
+
+#endif
       /* Look at every write buffer in the unacked_q.  The unacked_q
        * holds write buffers that have been entirely sent, but which
        * have not yet been ACKed.
@@ -607,13 +642,19 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
                     {
                       /* Parse s-ack from tcp options */
 
-                      nsacks = parse_sack(conn, tcp, ofosegs);
+                      nsacks = parse_sack(conn, tcp, ackno, ofosegs);
+                      sackno = ackno;
+                    }
+
+                  /* Without usable blocks, retransmit only the first
+                   * unacknowledged segment rather than the whole window.
+                   */
 
+                  if (nsacks > 0)
+                    {
                       flags |= TCP_REXMIT;
                     }
-#ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
                   else
-#endif
 #endif
                     {
 #ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
@@ -625,6 +666,10 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
                       TCP_WBNACK(wrb) = 0;
 #endif
+#else
+                      /* Retransmit the unacknowledged data */
+
+                      flags |= TCP_REXMIT;
 #endif
                     }
                 }
@@ -798,12 +843,32 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
                 TCP_SEQ_SUB(ofosegs[i].right, ofosegs[i].left));
         }
 
+      /* Every hole is retransmitted once per recovery: the segments below
+       * sack_rexmit were already resent for an earlier duplicate ACK, so
+       * they are left to the retransmission timer.  A recovery ends when
+       * the cumulative ACK passes sack_rexmit.
+       */
+
+      if (TCP_SEQ_LT(conn->sack_rexmit, sackno))
+        {
+          conn->sack_rexmit = sackno;
+        }
+
       for (entry = sq_peek(&conn->unacked_q); entry; entry = next)
         {
           wrb  = (FAR struct tcp_wrbuffer_s *)entry;
           next = sq_next(entry);
 
-          for (i = 0, right = 0; i < nsacks; i++)
+          if (TCP_SEQ_LT(TCP_WBSEQNO(wrb), conn->sack_rexmit))
+            {
+              continue;
+            }
+
+          /* The holes lie between the cumulative ACK and the first block,
+           * and between the blocks.
+           */
+
+          for (i = 0, right = sackno; i < nsacks; i++)
             {
               /* Wrb seqno out of s-ack edge ? do retransmit ! */
 
@@ -815,6 +880,8 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
                         TCP_WBSEQNO(wrb),
                         TCP_SEQ_ADD(TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb)),
                         TCP_WBPKTLEN(wrb));
+                  conn->sack_rexmit = TCP_SEQ_ADD(TCP_WBSEQNO(wrb),
+                                                  TCP_WBPKTLEN(wrb));
                   sq_rem(entry, &conn->unacked_q);
                   retransmit_segment(conn, (FAR void *)entry);
                   break;
@@ -926,6 +993,16 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
             }
         }
 
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+      /* Everything is resent, so end any SACK recovery */
+
+      wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->unacked_q);
+      if (wrb != NULL)
+        {
+          conn->sack_rexmit = TCP_WBSEQNO(wrb);
+        }
+#endif
+
       /* Move all segments that have been sent but not ACKed to the write
        * queue again note, the un-ACKed segments are put at the head of the
        * write_q so they can be resent as soon as possible.
@@ -1379,7 +1456,7 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
        * wait for the write buffer to be released
        */
 
-      while (tcp_wrbuffer_inqueue_size(conn) >= conn->snd_bufs)
+      while (tcp_wrbuffer_inqueue_size(conn) >= TCP_SNDBUFS(conn))
         {
           if (nonblock)
             {
@@ -71,6 +71,7 @@ struct sendfile_s
   FAR struct tcp_conn_s *snd_conn;         /* Connection associated with the socket */
   FAR struct devif_callback_s *snd_cb;     /* Reference to callback instance */
   FAR struct file   *snd_file;             /* File structure of the input file */
+  FAR const uint8_t *snd_xip;              /* File data readable in place, or NULL */
   sem_t              snd_sem;              /* Used to wake up the waiting thread */
   off_t              snd_foffset;          /* Input file offset */
   size_t             snd_flen;             /* File length */
@@ -94,6 +95,32 @@ struct sendfile_s
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sendfile_copyin
+ *
+ * Description:
+ *   Set up the device buffer with 'len' bytes of the file at 'offset' from
+ *   the start of the transfer.  Data of a file that can be read in place is
+ *   copied into the IOBs straight from the medium, other files are read
+ *   through the file system.
+ *
+ ****************************************************************************/
+
+static int sendfile_copyin(FAR struct net_driver_s *dev,
+                           FAR struct sendfile_s *pstate,
+                           uint32_t len, uint32_t offset)
+{
+  unsigned int hdrlen = tcpip_hdrsize(pstate->snd_conn);
+
+  if (pstate->snd_xip != NULL)
+    {
+      return devif_send(dev, pstate->snd_xip + offset, len, hdrlen);
+    }
+
+  return devif_file_send(dev, pstate->snd_file, len,
+                         pstate->snd_foffset + offset, hdrlen);
+}
+
 /****************************************************************************
  * Name: sendfile_eventhandler
  *
@@ -267,9 +294,7 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
        * happen until the polling cycle completes).
        */
 
-      ret = devif_file_send(dev, pstate->snd_file, sndlen,
-                            pstate->snd_foffset + pstate->snd_acked,
-                            tcpip_hdrsize(conn));
+      ret = sendfile_copyin(dev, pstate, sndlen, pstate->snd_acked);
       if (ret < 0)
         {
           nerr("ERROR: Failed to read from input file: %d\n", (int)ret);
@@ -338,9 +363,7 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
            * happen until the polling cycle completes).
            */
 
-          ret = devif_file_send(dev, pstate->snd_file, sndlen,
-                                pstate->snd_foffset + pstate->snd_sent,
-                                tcpip_hdrsize(conn));
+          ret = sendfile_copyin(dev, pstate, sndlen, pstate->snd_sent);
           if (ret < 0)
             {
               nerr("ERROR: Failed to read from input file: %d\n", (int)ret);
@@ -416,7 +439,10 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
 {
   FAR struct tcp_conn_s *conn;
   struct sendfile_s state;
+  FAR const void *xip;
+  struct stat st;
   off_t startpos;
+  off_t foffset;
   int ret;
 
   conn = psock->s_conn;
@@ -471,6 +497,31 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
       return startpos;
     }
 
+  /* Send directly from the medium if the file can be read in place.  The
+   * transfer then stops at the end of the file, like a read would.
+   */
+
+  xip     = NULL;
+  foffset = offset ? *offset : startpos;
+
+  if (file_fstat(infile, &st) >= 0 && S_ISREG(st.st_mode))
+    {
+      if (foffset >= st.st_size)
+        {
+          return 0;
+        }
+
+      if (count > st.st_size - foffset)
+        {
+          count = st.st_size - foffset;
+        }
+
+      if (file_xipmap(infile, foffset, count, &xip) < 0)
+        {
+          xip = NULL;
+        }
+    }
+
   /* Initialize the state structure.  This is done with the network
    * locked because we don't want anything to happen until we are
    * ready.
@@ -484,9 +535,10 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
   nxsem_init(&state.snd_sem, 0, 0);                /* Doesn't really fail */
 
   state.snd_conn    = conn;                        /* Tcp conn to use */
-  state.snd_foffset = offset ? *offset : startpos; /* Input file offset */
+  state.snd_foffset = foffset;                     /* Input file offset */
   state.snd_flen    = count;                       /* Number of bytes to send */
   state.snd_file    = infile;                      /* File to read from */
+  state.snd_xip     = xip;                         /* Or memory to send from */
 
   /* Allocate resources to receive a callback */
 
@@ -546,6 +598,15 @@ errout_locked:
 #endif
   net_unlock();
 
+  /* Nothing was read through the file system when sending in place: move
+   * the file position past the data sent, as reading it would have.
+   */
+
+  if (xip != NULL && state.snd_sent > 0)
+    {
+      file_seek(infile, foffset + state.snd_sent, SEEK_SET);
+    }
+
   /* Return the current file position */
 
   if (offset)
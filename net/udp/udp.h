@@ -30,6 +30,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 
+#include <net/net_tstamp.h>
 #include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/ip.h>
@@ -151,6 +152,19 @@ struct udp_conn_s
   struct ip_mreqn mreq;
 #endif
 
+#ifdef CONFIG_NET_TIMESTAMPING
+  /* Transmit timestamps of the last datagram sent, read with
+   * recvmsg(MSG_ERRQUEUE).
+   *
+   *   txtstamp  - ts[0] software and ts[2] hardware timestamp
+   *   txtsready - SOF_TIMESTAMPING_TX_* flags of the timestamps that are
+   *               available and not read yet
+   */
+
+  struct scm_timestamping txtstamp;
+  uint8_t txtsready;
+#endif
+
   /* The following is a list of poll structures of threads waiting for
    * socket events.
    */
@@ -711,6 +725,27 @@ uint16_t udp_callback(FAR struct net_driver_s *dev,
 ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
                            int flags);
 
+/****************************************************************************
+ * Name: psock_udp_recvmmsg
+ *
+ * Description:
+ *   Take the datagrams that are already buffered for a UDP SOCK_DGRAM
+ *   without waiting.  The read-ahead buffer is locked once for the batch.
+ *
+ * Input Parameters:
+ *   psock    Pointer to the socket structure for the SOCK_DRAM socket
+ *   msgvec   The buffers to receive the datagrams
+ *   vlen     The number of messages in msgvec
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   The number of datagrams received, zero if none was buffered.
+ *
+ ****************************************************************************/
+
+int psock_udp_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                       unsigned int vlen, int flags);
+
 /****************************************************************************
  * Name: psock_udp_sendto
  *
@@ -982,6 +1017,114 @@ void udp_sendbuffer_notify(FAR struct udp_conn_s *conn);
 
 uint16_t udpip_hdrsize(FAR struct udp_conn_s *conn);
 
+#ifdef CONFIG_NET_UDP_HOOK
+/****************************************************************************
+ * Name: udp_hook_input
+ *
+ * Description:
+ *   Give a received datagram to the handler registered on its destination
+ *   port, if there is one.
+ *
+ * Input Parameters:
+ *   dev      - The device that received the datagram.  d_len is the length
+ *              of the payload
+ *   udp      - The UDP header of the datagram
+ *   udpiplen - The length of the IP and UDP headers
+ *
+ * Returned Value:
+ *   True if the handler consumed the datagram; dev->d_len is then the
+ *   length of the reply, or zero.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool udp_hook_input(FAR struct net_driver_s *dev,
+                    FAR struct udp_hdr_s *udp, unsigned int udpiplen);
+#endif
+
+#ifdef CONFIG_NET_TIMESTAMPING
+/****************************************************************************
+ * Name: udp_tstamp_rx
+ *
+ * Description:
+ *   Take the receive timestamps of the packet in the device buffer that the
+ *   socket asked for with SO_TIMESTAMPING.
+ *
+ * Input Parameters:
+ *   dev  - The device that received the packet
+ *   conn - The UDP connection that receives the packet
+ *   ts   - Receives the software (ts[0]) and hardware (ts[1]) timestamp
+ *
+ * Returned Value:
+ *   The number of entries of ts that were set: 2, or 0 if the socket does
+ *   not want receive timestamps.
+ *
+ ****************************************************************************/
+
+int udp_tstamp_rx(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
+                  FAR struct timespec *ts);
+
+/****************************************************************************
+ * Name: udp_tstamp_cmsg
+ *
+ * Description:
+ *   Append an SCM_TIMESTAMPING control message with the timestamps that
+ *   the socket reports.  Either timestamp may be NULL.
+ *
+ ****************************************************************************/
+
+void udp_tstamp_cmsg(FAR struct udp_conn_s *conn, FAR struct msghdr *msg,
+                     FAR const struct timespec *sw,
+                     FAR const struct timespec *hw);
+
+/****************************************************************************
+ * Name: udp_tstamp_txpoll
+ *
+ * Description:
+ *   Called after a connection was polled.  If it produced a datagram, take
+ *   its software transmit timestamp and ask the driver for the hardware
+ *   one, as selected by SO_TIMESTAMPING.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void udp_tstamp_txpoll(FAR struct net_driver_s *dev,
+                       FAR struct udp_conn_s *conn);
+
+/****************************************************************************
+ * Name: udp_tstamp_txdone
+ *
+ * Description:
+ *   Save the hardware transmit timestamp passed to netdev_txtstamp(), if
+ *   'handle' is still an allocated UDP connection.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void udp_tstamp_txdone(FAR void *handle, FAR const struct timespec *ts);
+
+/****************************************************************************
+ * Name: udp_tstamp_recverr
+ *
+ * Description:
+ *   Implement recvmsg(MSG_ERRQUEUE): return the transmit timestamps of the
+ *   last datagram sent in an SCM_TIMESTAMPING control message.
+ *
+ * Returned Value:
+ *   Zero (no data bytes) on success; -EAGAIN if no timestamp is pending.
+ *
+ ****************************************************************************/
+
+ssize_t udp_tstamp_recverr(FAR struct udp_conn_s *conn,
+                           FAR struct msghdr *msg);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
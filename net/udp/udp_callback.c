@@ -74,16 +74,24 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
   uint8_t src_addr_size;
   FAR void *src_addr;
   int offset;
+#ifdef CONFIG_NET_TIMESTAMPING
+  struct timespec tstamp[2];
+  uint8_t tsnum;
+#endif
 
 #if CONFIG_NET_RECV_BUFSIZE > 0
+  conn_lock(&conn->sconn);
   if (conn->readahead && conn->readahead->io_pktlen > conn->rcvbufs)
     {
+      conn_unlock(&conn->sconn);
       netdev_iob_release(dev);
 #ifdef CONFIG_NET_STATISTICS
       g_netstats.udp.drop++;
 #endif
       return 0;
     }
+
+  conn_unlock(&conn->sconn);
 #endif
 
   iob = dev->d_iob;
@@ -153,7 +161,8 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
 #endif /* CONFIG_NET_IPv4 */
 
   /* Copy the meta info into the I/O buffer chain, just before data.
-   * Layout: |datalen|ifindex|src_addr_size|src_addr|data|
+   * Layout: |datalen|ifindex|tsnum|tstamp|src_addr_size|src_addr|data|
+   * tsnum is the number of timestamps in tstamp, see udp_tstamp_rx().
    */
 
   offset = (dev->d_appdata - iob->io_data) - iob->io_offset;
@@ -173,6 +182,27 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
       goto errout;
     }
 
+#ifdef CONFIG_NET_TIMESTAMPING
+  tsnum = udp_tstamp_rx(dev, conn, tstamp);
+  if (tsnum > 0)
+    {
+      offset -= tsnum * sizeof(struct timespec);
+      ret = iob_trycopyin(iob, (FAR const uint8_t *)tstamp,
+                          tsnum * sizeof(struct timespec), offset, true);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+
+  offset -= sizeof(tsnum);
+  ret = iob_trycopyin(iob, &tsnum, sizeof(tsnum), offset, true);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+#endif
+
 #ifdef CONFIG_NETDEV_IFINDEX
   offset -= sizeof(dev->d_ifindex);
   ret = iob_trycopyin(iob, &dev->d_ifindex, sizeof(dev->d_ifindex),
@@ -198,7 +228,9 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
 
   /* Concat the iob to readahead */
 
+  conn_lock(&conn->sconn);
   net_iob_concat(&conn->readahead, &iob);
+  conn_unlock(&conn->sconn);
 
 #ifdef CONFIG_NET_UDP_NOTIFIER
   ninfo("Buffered %d bytes\n", buflen);
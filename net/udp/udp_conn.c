@@ -650,6 +650,7 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
 
       nxsem_init(&conn->sndsem, 0, 0);
 #endif
+      conn_lock_init(&conn->sconn);
 
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
       /* Initialize the write buffer lists */
@@ -694,6 +695,7 @@ void udp_free(FAR struct udp_conn_s *conn)
   /* Release any read-ahead buffers attached to the connection, NULL is ok */
 
   iob_free_chain(conn->readahead);
+  conn_lock_destroy(&conn->sconn);
 
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
   /* Release any write buffers attached to the connection */
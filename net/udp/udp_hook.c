@@ -0,0 +1,355 @@
+/****************************************************************************
+ * net/udp/udp_hook.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET_UDP) && defined(CONFIG_NET_UDP_HOOK)
+
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
+#include <nuttx/net/udp.h>
+
+#include "inet/inet.h"
+#include "utils/utils.h"
+#include "udp/udp.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A handler registered on a local UDP port */
+
+struct udp_hook_s
+{
+  udp_hook_t handler;  /* The handler, NULL if the entry is free */
+  FAR void  *arg;      /* The argument of the handler */
+  uint16_t   port;     /* The local port in network order */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The registered handlers, protected by the network lock */
+
+static struct udp_hook_s g_udp_hooks[CONFIG_NET_UDP_NHOOKS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_hook_find
+ *
+ * Description:
+ *   Return the entry of a port, or NULL if there is no handler on it.
+ *
+ ****************************************************************************/
+
+static FAR struct udp_hook_s *udp_hook_find(uint16_t port)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NET_UDP_NHOOKS; i++)
+    {
+      if (g_udp_hooks[i].handler != NULL && g_udp_hooks[i].port == port)
+        {
+          return &g_udp_hooks[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_hook_register
+ *
+ * Description:
+ *   Register a handler for the UDP datagrams received on a local port.  The
+ *   handler is called from the network input path, before the socket layer
+ *   is consulted.  See udp_hook_t.
+ *
+ * Input Parameters:
+ *   port    - The local port in network order
+ *   handler - The handler to call
+ *   arg     - The argument passed to the handler
+ *
+ * Returned Value:
+ *   OK on success; -EINVAL if the port is zero, -EADDRINUSE if the port
+ *   already has a handler and -ENOMEM if CONFIG_NET_UDP_NHOOKS handlers
+ *   are registered.
+ *
+ ****************************************************************************/
+
+int udp_hook_register(uint16_t port, udp_hook_t handler, FAR void *arg)
+{
+  FAR struct udp_hook_s *hook = NULL;
+  int ret = OK;
+  int i;
+
+  if (port == 0 || handler == NULL)
+    {
+      return -EINVAL;
+    }
+
+  net_lock();
+
+  if (udp_hook_find(port) != NULL)
+    {
+      ret = -EADDRINUSE;
+      goto errout_with_lock;
+    }
+
+  for (i = 0; i < CONFIG_NET_UDP_NHOOKS; i++)
+    {
+      if (g_udp_hooks[i].handler == NULL)
+        {
+          hook = &g_udp_hooks[i];
+          break;
+        }
+    }
+
+  if (hook == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_lock;
+    }
+
+  hook->port    = port;
+  hook->arg     = arg;
+  hook->handler = handler;
+
+errout_with_lock:
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: udp_hook_unregister
+ *
+ * Description:
+ *   Remove the handler of a local port.  The handler is not running and
+ *   will not be called anymore when this returns.
+ *
+ * Input Parameters:
+ *   port - The local port in network order
+ *
+ * Returned Value:
+ *   OK on success; -ENOENT if the port has no handler.
+ *
+ ****************************************************************************/
+
+int udp_hook_unregister(uint16_t port)
+{
+  FAR struct udp_hook_s *hook;
+  int ret = -ENOENT;
+
+  net_lock();
+
+  hook = udp_hook_find(port);
+  if (hook != NULL)
+    {
+      memset(hook, 0, sizeof(*hook));
+      ret = OK;
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: udp_hook_reply
+ *
+ * Description:
+ *   Turn the received datagram into a reply to its sender.  Called by a
+ *   handler after it wrote the reply payload in place of the received one,
+ *   at the same offset in dev->d_iob.  The reply is sent from the address
+ *   of the device and with the ports swapped when the handler returns.
+ *
+ * Input Parameters:
+ *   dev - The device that received the datagram
+ *   len - The length of the reply payload
+ *
+ * Returned Value:
+ *   OK on success; -EMSGSIZE if the payload does not fit the device MTU.
+ *
+ * Assumptions:
+ *   Called from a handler, with the network locked.
+ *
+ ****************************************************************************/
+
+int udp_hook_reply(FAR struct net_driver_s *dev, unsigned int len)
+{
+  FAR struct udp_hdr_s *udp;
+  uint16_t port;
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+      net_ipv6addr_t raddr;
+
+      if (len + IPv6UDP_HDRLEN > NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev))
+        {
+          return -EMSGSIZE;
+        }
+
+      udp = UDPIPv6BUF;
+      net_ipv6addr_copy(raddr, ipv6->srcipaddr);
+      ipv6_build_header(ipv6, len + UDP_HDRLEN, IP_PROTO_UDP,
+                        dev->d_ipv6addr, raddr, IP_TTL_DEFAULT, 0);
+
+      dev->d_len = len + IPv6UDP_HDRLEN;
+
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipv6.sent++;
+#endif
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+      in_addr_t raddr;
+
+      if (len + IPv4UDP_HDRLEN > NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev))
+        {
+          return -EMSGSIZE;
+        }
+
+      udp   = UDPIPv4BUF;
+      raddr = net_ip4addr_conv32(ipv4->srcipaddr);
+      dev->d_len = len + IPv4UDP_HDRLEN;
+      ipv4_build_header(ipv4, dev->d_len, IP_PROTO_UDP, &dev->d_ipaddr,
+                        &raddr, IP_TTL_DEFAULT, 0, NULL);
+
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipv4.sent++;
+#endif
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+  port           = udp->srcport;
+  udp->srcport   = udp->destport;
+  udp->destport  = port;
+  udp->udplen    = HTONS(len + UDP_HDRLEN);
+  udp->udpchksum = 0;
+
+  iob_update_pktlen(dev->d_iob, dev->d_len, false);
+
+#ifdef CONFIG_NET_UDP_CHECKSUMS
+  if (!net_chksum_txoffload(dev))
+    {
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+      if (IFF_IS_IPv6(dev->d_flags))
+#endif
+        {
+          udp->udpchksum = ~udp_ipv6_chksum(dev);
+        }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+      else
+#endif
+        {
+          udp->udpchksum = ~udp_ipv4_chksum(dev);
+        }
+#endif
+
+      if (udp->udpchksum == 0)
+        {
+          udp->udpchksum = 0xffff;
+        }
+    }
+#endif /* CONFIG_NET_UDP_CHECKSUMS */
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.udp.sent++;
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: udp_hook_input
+ *
+ * Description:
+ *   Give a received datagram to the handler of its destination port.
+ *
+ * Input Parameters:
+ *   dev      - The device that received the datagram.  d_len is the length
+ *              of the payload
+ *   udp      - The UDP header of the datagram
+ *   udpiplen - The length of the IP and UDP headers
+ *
+ * Returned Value:
+ *   True if the handler consumed the datagram.  dev->d_len is then the
+ *   length of the reply, or zero.  False if the datagram is for the socket
+ *   layer.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool udp_hook_input(FAR struct net_driver_s *dev,
+                    FAR struct udp_hdr_s *udp, unsigned int udpiplen)
+{
+  FAR struct udp_hook_s *hook;
+  unsigned int len = dev->d_len;
+
+  hook = udp_hook_find(udp->destport);
+  if (hook == NULL)
+    {
+      return false;
+    }
+
+  /* The handler replies by setting d_len with udp_hook_reply() */
+
+  dev->d_len = 0;
+  if (hook->handler(dev, hook->arg, dev->d_iob, udpiplen, len) < 0)
+    {
+      dev->d_len = len;
+      return false;
+    }
+
+  return true;
+}
+
+#endif /* CONFIG_NET_UDP && CONFIG_NET_UDP_HOOK */
@@ -121,7 +121,7 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
   dev->d_appdata = IPBUF(udpiplen);
 
 #ifdef CONFIG_NET_UDP_CHECKSUMS
-  chksum = udp->udpchksum;
+  chksum = net_chksum_rxoffload(dev) ? 0 : udp->udpchksum;
   if (chksum != 0)
     {
 #ifdef CONFIG_NET_IPv6
@@ -171,6 +171,15 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
        * packet as read-only.
        */
 
+#ifdef CONFIG_NET_UDP_HOOK
+      /* An in-kernel handler of the port takes the datagram first */
+
+      if (udp_hook_input(dev, udp, udpiplen))
+        {
+          return OK;
+        }
+#endif
+
       conn = udp_active(dev, udp);
       if (conn)
         {
@@ -104,6 +104,20 @@ static void udp_recvpktinfo(FAR struct udp_recvfrom_s *pstate,
 #define udp_recvpktinfo(p, s, i) {(void)(p); (void)(s); (void)(i);}
 #endif
 
+#ifdef CONFIG_NET_TIMESTAMPING
+static void udp_recvtstamp(FAR struct udp_recvfrom_s *pstate,
+                           FAR const struct timespec *tstamp, int tsnum)
+{
+  if (tsnum > 0)
+    {
+      udp_tstamp_cmsg(pstate->ir_conn, pstate->ir_msg,
+                      &tstamp[0], &tstamp[1]);
+    }
+}
+#else
+#define udp_recvtstamp(p, t, n) {(void)(p); (void)(n);}
+#endif
+
 /****************************************************************************
  * Name: udp_recvfrom_newdata
  *
@@ -171,6 +185,10 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
       uint16_t datalen;
       uint8_t src_addr_size;
       uint8_t ifindex;
+      uint8_t tsnum = 0;
+#ifdef CONFIG_NET_TIMESTAMPING
+      struct timespec tstamp[2];
+#endif
 #ifdef CONFIG_NET_IPv6
       uint8_t srcaddr[sizeof(struct sockaddr_in6)];
 #else
@@ -178,7 +196,7 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
 #endif
 
       /* Unflatten saved connection information
-       * Layout: |datalen|ifindex|src_addr_size|src_addr|data|
+       * Layout: |datalen|ifindex|tsnum|tstamp|src_addr_size|src_addr|data|
        */
 
       recvlen = iob_copyout((FAR uint8_t *)&datalen, iob,
@@ -192,6 +210,20 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
       DEBUGASSERT(recvlen == sizeof(ifindex));
 #else
       ifindex = 1;
+#endif
+#ifdef CONFIG_NET_TIMESTAMPING
+      recvlen = iob_copyout(&tsnum, iob, sizeof(tsnum), offset);
+      offset += sizeof(tsnum);
+      DEBUGASSERT(recvlen == sizeof(tsnum) && tsnum <= 2);
+
+      if (tsnum > 0)
+        {
+          recvlen = iob_copyout((FAR uint8_t *)tstamp, iob,
+                                tsnum * sizeof(struct timespec), offset);
+          offset += tsnum * sizeof(struct timespec);
+          DEBUGASSERT(recvlen == tsnum * sizeof(struct timespec));
+        }
+
 #endif
       recvlen = iob_copyout(&src_addr_size, iob,
                             sizeof(src_addr_size), offset);
@@ -226,6 +258,7 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
         }
 
       udp_recvpktinfo(pstate, srcaddr, ifindex);
+      udp_recvtstamp(pstate, tstamp, tsnum);
 
       /* Remove the packet from the head of the I/O buffer chain. */
 
@@ -271,6 +304,9 @@ static inline void udp_sender(FAR struct net_driver_s *dev,
   uint8_t srcaddr[sizeof(struct sockaddr_in)];
 #endif
   socklen_t fromlen = 0;
+#ifdef CONFIG_NET_TIMESTAMPING
+  struct timespec tstamp[2];
+#endif
 
   /* Get the family from the packet type, IP address from the IP header, and
    * the port number from the UDP header.
@@ -351,6 +387,11 @@ static inline void udp_sender(FAR struct net_driver_s *dev,
 #else
   udp_recvpktinfo(pstate, srcaddr, 1);
 #endif
+
+#ifdef CONFIG_NET_TIMESTAMPING
+  udp_recvtstamp(pstate, tstamp, udp_tstamp_rx(dev, pstate->ir_conn,
+                                               tstamp));
+#endif
 }
 
 /****************************************************************************
@@ -589,18 +630,27 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
   struct udp_recvfrom_s state;
   int ret;
 
-  /* Perform the UDP recvfrom() operation */
+#ifdef CONFIG_NET_TIMESTAMPING
+  /* MSG_ERRQUEUE returns the transmit timestamps, never data */
 
-  /* Initialize the state structure.  This is done with the network locked
-   * because we don't want anything to happen until we are ready.
-   */
+  if ((flags & MSG_ERRQUEUE) != 0)
+    {
+      return udp_tstamp_recverr(conn, msg);
+    }
+#endif
+
+  /* Perform the UDP recvfrom() operation */
 
-  net_lock();
   udp_recvfrom_initialize(conn, msg, &state, flags);
 
-  /* Copy the read-ahead data from the packet */
+  /* Copy the read-ahead data from the packet.  The read-ahead data is
+   * protected by the connection lock, the network is only locked below if
+   * we have to wait.
+   */
 
+  conn_lock(&conn->sconn);
   udp_readahead(&state);
+  conn_unlock(&conn->sconn);
 
   /* The default return value is the number of bytes that we just copied
    * into the user buffer.  We will return this if the socket has become
@@ -636,50 +686,134 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
 
   else if (state.ir_recvlen <= 0)
     {
-      /* Get the device that will handle the packet transfers.  This may be
-       * NULL if the UDP socket is bound to INADDR_ANY.  In that case, no
-       * NETDEV_DOWN notifications will be received.
-       */
+      net_lock();
+
+      /* A datagram may have been buffered before the network was locked */
 
-      dev = udp_find_laddr_device(conn);
+      if (state.ir_recvlen < 0)
+        {
+          conn_lock(&conn->sconn);
+          udp_readahead(&state);
+          conn_unlock(&conn->sconn);
 
-      /* Set up the callback in the connection */
+          ret = state.ir_recvlen;
+        }
 
-      state.ir_cb = udp_callback_alloc(dev, conn);
-      if (state.ir_cb)
+      if (state.ir_recvlen <= 0)
         {
+          /* Get the device that will handle the packet transfers.  This may
+           * be NULL if the UDP socket is bound to INADDR_ANY.  In that case,
+           * no NETDEV_DOWN notifications will be received.
+           */
+
+          dev = udp_find_laddr_device(conn);
+
           /* Set up the callback in the connection */
 
-          state.ir_cb->flags = (UDP_NEWDATA | NETDEV_DOWN);
-          state.ir_cb->priv  = (FAR void *)&state;
-          state.ir_cb->event = udp_eventhandler;
+          state.ir_cb = udp_callback_alloc(dev, conn);
+          if (state.ir_cb)
+            {
+              /* Set up the callback in the connection */
 
-          /* Wait for either the receive to complete or for an error/timeout
-           * to occur.  net_sem_timedwait will also terminate if a signal is
-           * received.
-           */
+              state.ir_cb->flags = (UDP_NEWDATA | NETDEV_DOWN);
+              state.ir_cb->priv  = (FAR void *)&state;
+              state.ir_cb->event = udp_eventhandler;
 
-          ret = net_sem_timedwait(&state.ir_sem,
-                              _SO_TIMEOUT(conn->sconn.s_rcvtimeo));
-          if (ret == -ETIMEDOUT)
+              /* Wait for either the receive to complete or for an
+               * error/timeout to occur.  net_sem_timedwait will also
+               * terminate if a signal is received.
+               */
+
+              ret = net_sem_timedwait(&state.ir_sem,
+                                      _SO_TIMEOUT(conn->sconn.s_rcvtimeo));
+              if (ret == -ETIMEDOUT)
+                {
+                  ret = -EAGAIN;
+                }
+
+              /* Make sure that no further events are processed */
+
+              udp_callback_free(dev, conn, state.ir_cb);
+              ret = udp_recvfrom_result(ret, &state);
+            }
+          else
             {
-              ret = -EAGAIN;
+              ret = -EBUSY;
             }
+        }
 
-          /* Make sure that no further events are processed */
+      net_unlock();
+    }
 
-          udp_callback_free(dev, conn, state.ir_cb);
-          ret = udp_recvfrom_result(ret, &state);
-        }
-      else
+  udp_recvfrom_uninitialize(&state);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: psock_udp_recvmmsg
+ *
+ * Description:
+ *   Take the datagrams that are already buffered for a UDP SOCK_DGRAM
+ *   without waiting.  The read-ahead buffer is locked once for the batch.
+ *
+ * Input Parameters:
+ *   psock    Pointer to the socket structure for the SOCK_DRAM socket
+ *   msgvec   The buffers to receive the datagrams
+ *   vlen     The number of messages in msgvec
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   The number of datagrams received, zero if none was buffered.
+ *
+ ****************************************************************************/
+
+int psock_udp_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                       unsigned int vlen, int flags)
+{
+  FAR struct udp_conn_s *conn = psock->s_conn;
+  struct udp_recvfrom_s state;
+  unsigned long controllen;
+  FAR struct msghdr *msg;
+  FAR void *control;
+  unsigned int n;
+
+  /* Peeking would return the same datagram again */
+
+  if ((flags & MSG_PEEK) != 0)
+    {
+      return 0;
+    }
+
+  conn_lock(&conn->sconn);
+
+  for (n = 0; n < vlen && conn->readahead != NULL; n++)
+    {
+      /* Leave a message that psock_recvmsg() would refuse to the caller */
+
+      msg = &msgvec[n].msg_hdr;
+      if (msg->msg_iov == NULL || msg->msg_iov->iov_base == NULL ||
+          msg->msg_iovlen != 1 ||
+          (msg->msg_name != NULL && msg->msg_namelen <= 0))
         {
-          ret = -EBUSY;
+          break;
         }
+
+      /* Save the cmsg information as psock_recvmsg() does */
+
+      control    = msg->msg_control;
+      controllen = msg->msg_controllen;
+
+      udp_recvfrom_initialize(conn, msg, &state, flags);
+      udp_readahead(&state);
+      udp_recvfrom_uninitialize(&state);
+
+      msg->msg_control    = control;
+      msg->msg_controllen = controllen - msg->msg_controllen;
+      msgvec[n].msg_len   = state.ir_recvlen;
     }
 
-  net_unlock();
-  udp_recvfrom_uninitialize(&state);
-  return ret;
+  conn_unlock(&conn->sconn);
+  return n;
 }
 
 #endif /* CONFIG_NET && CONFIG_NET_UDP */
@@ -0,0 +1,224 @@
+/****************************************************************************
+ * net/udp/udp_tstamp.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET_UDP) && defined(CONFIG_NET_TIMESTAMPING)
+
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+#include <net/net_tstamp.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "udp/udp.h"
+#include "utils/utils.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_tstamp_rx
+ *
+ * Description:
+ *   Take the receive timestamps of the packet in the device buffer that the
+ *   socket asked for with SO_TIMESTAMPING.
+ *
+ ****************************************************************************/
+
+int udp_tstamp_rx(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
+                  FAR struct timespec *ts)
+{
+  uint16_t tsflags = conn->sconn.s_tsflags;
+
+  if ((tsflags & (SOF_TIMESTAMPING_RX_SOFTWARE |
+                  SOF_TIMESTAMPING_RX_HARDWARE)) == 0)
+    {
+      return 0;
+    }
+
+  memset(ts, 0, 2 * sizeof(struct timespec));
+
+  if ((tsflags & SOF_TIMESTAMPING_RX_SOFTWARE) != 0)
+    {
+      clock_gettime(CLOCK_REALTIME, &ts[0]);
+    }
+
+  if ((tsflags & SOF_TIMESTAMPING_RX_HARDWARE) != 0)
+    {
+      ts[1] = dev->d_rxtstamp;
+    }
+
+  return 2;
+}
+
+/****************************************************************************
+ * Name: udp_tstamp_cmsg
+ *
+ * Description:
+ *   Append an SCM_TIMESTAMPING control message with the timestamps that
+ *   the socket reports.  Either timestamp may be NULL.
+ *
+ ****************************************************************************/
+
+void udp_tstamp_cmsg(FAR struct udp_conn_s *conn, FAR struct msghdr *msg,
+                     FAR const struct timespec *sw,
+                     FAR const struct timespec *hw)
+{
+  uint16_t tsflags = conn->sconn.s_tsflags;
+  struct scm_timestamping tss;
+
+  memset(&tss, 0, sizeof(tss));
+
+  if (sw != NULL && (tsflags & SOF_TIMESTAMPING_SOFTWARE) != 0)
+    {
+      tss.ts[0] = *sw;
+    }
+
+  if (hw != NULL && (tsflags & SOF_TIMESTAMPING_RAW_HARDWARE) != 0)
+    {
+      tss.ts[2] = *hw;
+    }
+
+  if (tss.ts[0].tv_sec != 0 || tss.ts[0].tv_nsec != 0 ||
+      tss.ts[2].tv_sec != 0 || tss.ts[2].tv_nsec != 0)
+    {
+      cmsg_append(msg, SOL_SOCKET, SCM_TIMESTAMPING, &tss, sizeof(tss));
+    }
+}
+
+/****************************************************************************
+ * Name: udp_tstamp_txpoll
+ *
+ * Description:
+ *   Called after a connection was polled.  If it produced a datagram, take
+ *   its software transmit timestamp and ask the driver for the hardware
+ *   one, as selected by SO_TIMESTAMPING.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void udp_tstamp_txpoll(FAR struct net_driver_s *dev,
+                       FAR struct udp_conn_s *conn)
+{
+  uint16_t tsflags = conn->sconn.s_tsflags;
+
+  if (dev->d_len == 0 ||
+      (tsflags & (SOF_TIMESTAMPING_TX_SOFTWARE |
+                  SOF_TIMESTAMPING_TX_HARDWARE)) == 0)
+    {
+      return;
+    }
+
+  /* Only the timestamps of the last datagram are kept */
+
+  memset(&conn->txtstamp, 0, sizeof(conn->txtstamp));
+  conn->txtsready = 0;
+
+  if ((tsflags & SOF_TIMESTAMPING_TX_SOFTWARE) != 0)
+    {
+      clock_gettime(CLOCK_REALTIME, &conn->txtstamp.ts[0]);
+      conn->txtsready = SOF_TIMESTAMPING_TX_SOFTWARE;
+    }
+
+  if ((tsflags & SOF_TIMESTAMPING_TX_HARDWARE) != 0)
+    {
+      dev->d_txtstamp = conn;
+    }
+}
+
+/****************************************************************************
+ * Name: udp_tstamp_txdone
+ *
+ * Description:
+ *   Save the hardware transmit timestamp passed to netdev_txtstamp(), if
+ *   'handle' is still an allocated UDP connection.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void udp_tstamp_txdone(FAR void *handle, FAR const struct timespec *ts)
+{
+  FAR struct udp_conn_s *conn = NULL;
+
+  while ((conn = udp_nextconn(conn)) != NULL)
+    {
+      if (conn == handle)
+        {
+          if ((conn->sconn.s_tsflags & SOF_TIMESTAMPING_TX_HARDWARE) != 0)
+            {
+              conn->txtstamp.ts[2] = *ts;
+              conn->txtsready     |= SOF_TIMESTAMPING_TX_HARDWARE;
+            }
+
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: udp_tstamp_recverr
+ *
+ * Description:
+ *   Implement recvmsg(MSG_ERRQUEUE): return the transmit timestamps of the
+ *   last datagram sent in an SCM_TIMESTAMPING control message.
+ *
+ ****************************************************************************/
+
+ssize_t udp_tstamp_recverr(FAR struct udp_conn_s *conn,
+                           FAR struct msghdr *msg)
+{
+  uint8_t ready;
+
+  net_lock();
+
+  ready = conn->txtsready;
+  if (ready == 0)
+    {
+      net_unlock();
+      return -EAGAIN;
+    }
+
+  udp_tstamp_cmsg(conn, msg,
+                  (ready & SOF_TIMESTAMPING_TX_SOFTWARE) != 0 ?
+                  &conn->txtstamp.ts[0] : NULL,
+                  (ready & SOF_TIMESTAMPING_TX_HARDWARE) != 0 ?
+                  &conn->txtstamp.ts[2] : NULL);
+
+  /* A hardware timestamp that is still due will be reported later */
+
+  memset(&conn->txtstamp, 0, sizeof(conn->txtstamp));
+  conn->txtsready = 0;
+
+  net_unlock();
+  return 0;
+}
+
+#endif /* CONFIG_NET_UDP && CONFIG_NET_TIMESTAMPING */
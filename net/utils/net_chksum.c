@@ -25,8 +25,84 @@
 #include <nuttx/config.h>
 #ifdef CONFIG_NET
 
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "devif/devif.h"
 #include "utils/utils.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: chksum_native
+ *
+ * Description:
+ *   Sum the naturally aligned data as native 16-bit words, 32 bits at a
+ *   time with the carries deferred to the end.  The one's complement sum
+ *   is independent of the byte order, so the result is the Internet sum
+ *   in the byte order of the host.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_ARCH_CHKSUM
+static uint16_t chksum_native(FAR const uint8_t *data, uint16_t len)
+{
+  uint64_t acc = 0;
+
+  if (((uintptr_t)data & 2) != 0 && len >= 2)
+    {
+      acc  += *(FAR const uint16_t *)data;
+      data += 2;
+      len  -= 2;
+    }
+
+  while (len >= 16)
+    {
+      acc  += ((FAR const uint32_t *)data)[0];
+      acc  += ((FAR const uint32_t *)data)[1];
+      acc  += ((FAR const uint32_t *)data)[2];
+      acc  += ((FAR const uint32_t *)data)[3];
+      data += 16;
+      len  -= 16;
+    }
+
+  while (len >= 4)
+    {
+      acc  += *(FAR const uint32_t *)data;
+      data += 4;
+      len  -= 4;
+    }
+
+  if (len >= 2)
+    {
+      acc  += *(FAR const uint16_t *)data;
+      data += 2;
+      len  -= 2;
+    }
+
+  if (len > 0)
+    {
+      /* A trailing byte is the first byte of a zero-padded word */
+
+      uint16_t last = 0;
+
+      *(FAR uint8_t *)&last = *data;
+      acc += last;
+    }
+
+  /* Fold 64 to 16 bits */
+
+  acc = (acc >> 32) + (acc & 0xffffffff);
+  acc = (acc >> 32) + (acc & 0xffffffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+
+  return (uint16_t)acc;
+}
+#endif /* CONFIG_NET_ARCH_CHKSUM */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -53,40 +129,42 @@
 #ifndef CONFIG_NET_ARCH_CHKSUM
 uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
-  uint16_t t;
+  uint32_t total = sum;
+  uint16_t part;
+  bool odd = false;
 
-  dataptr = data;
-  last_byte = data + len - 1;
-
-  while (dataptr < last_byte)
+  if (len == 0)
     {
-      /* At least two more bytes */
+      return sum;
+    }
 
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+  /* An odd address starts with the high byte of a word.  The words summed
+   * after it are then shifted by one byte, which swaps their sum.
+   */
 
-      dataptr += 2;
+  if (((uintptr_t)data & 1) != 0)
+    {
+      total += (uint16_t)data[0] << 8;
+      data++;
+      len--;
+      odd = true;
     }
 
-  if (dataptr == last_byte)
+  /* The native sum is in network order once swapped to the host order */
+
+  part = NTOHS(chksum_native(data, len));
+  if (odd)
     {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+      part = (uint16_t)((part << 8) | (part >> 8));
     }
 
+  total += part;
+  total  = (total >> 16) + (total & 0xffff);
+  total  = (total >> 16) + (total & 0xffff);
+
   /* Return sum in host byte order. */
 
-  return sum;
+  return (uint16_t)total;
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
 
@@ -262,4 +340,37 @@ void net_chksum_adjust(FAR uint16_t *chksum,
   *chksum = HTONS(x);
 }
 
+/****************************************************************************
+ * Name: net_chksum_txoffload
+ *
+ * Description:
+ *   Return true if the TCP/UDP checksum of the outgoing packet in d_iob is
+ *   left to the hardware of the device.  The IP header must be built.
+ *
+ *   Packets looped back to ourself or fragmented by the stack do not pass
+ *   the checksum engine as they are, so they are always summed here.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+bool net_chksum_txoffload(FAR struct net_driver_s *dev)
+{
+  uint8_t caps;
+
+#ifdef CONFIG_NET_IPv4
+  if ((IPv4BUF->vhl & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      caps = NETDEV_CSUM_TX_IPV4;
+    }
+  else
+#endif
+    {
+      caps = NETDEV_CSUM_TX_IPV6;
+    }
+
+  return NETDEV_CSUM_OFFLOAD(dev, caps) &&
+         dev->d_len <= devif_get_mtu(dev) && !devif_is_loopback(dev);
+}
+#endif /* CONFIG_NETDEV_CSUM_OFFLOAD */
+
 #endif /* CONFIG_NET */
@@ -267,6 +267,38 @@ uint16_t tcp_chksum(FAR struct net_driver_s *dev);
 #  define tcp_chksum(d) tcp_ipv6_chksum(d)
 #endif
 
+/****************************************************************************
+ * Name: net_chksum_txoffload
+ *
+ * Description:
+ *   Return true if the TCP/UDP checksum of the outgoing packet in d_iob is
+ *   left to the hardware of the device.  The IP header must be built.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+bool net_chksum_txoffload(FAR struct net_driver_s *dev);
+#else
+#  define net_chksum_txoffload(dev) false
+#endif
+
+/****************************************************************************
+ * Name: net_chksum_rxoffload
+ *
+ * Description:
+ *   Return true if the checksums of the incoming packet in d_iob were
+ *   verified by the hardware of the device.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+#  define net_chksum_rxoffload(dev) \
+     NETDEV_CSUM_OFFLOAD(dev, IFF_IS_IPv4((dev)->d_flags) ? \
+                         NETDEV_CSUM_RX_IPV4 : NETDEV_CSUM_RX_IPV6)
+#else
+#  define net_chksum_rxoffload(dev) false
+#endif
+
 /****************************************************************************
  * Name: udp_ipv4_chksum
  *
@@ -84,6 +84,14 @@ void clock_timer(void);
 #  define clock_timer()
 #endif
 
+#ifdef CONFIG_CLOCK_TIMEPAGE
+void clock_timepage_initialize(void);
+void clock_timepage_update(void);
+#else
+#  define clock_timepage_initialize()
+#  define clock_timepage_update()
+#endif
+
 #ifdef CONFIG_CLOCK_ADJTIME
 void clock_set_adjust(long long adj_usec, long long adj_count,
                       FAR long long *adj_usec_old,
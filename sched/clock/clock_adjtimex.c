@@ -0,0 +1,163 @@
+/****************************************************************************
+ * sched/clock/clock_adjtimex.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/time.h>
+#include <sys/timex.h>
+#include <time.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+
+#include "clock/clock.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* adjtime() is provided by either of the clock implementations */
+
+#if defined(CONFIG_CLOCK_TIMEKEEPING) || defined(CONFIG_CLOCK_ADJTIME)
+#  define HAVE_ADJTIME 1
+#endif
+
+#ifdef HAVE_ADJTIME
+#  define CLOCK_ADJ_MODES (ADJ_OFFSET | ADJ_SETOFFSET | ADJ_NANO)
+#else
+#  define CLOCK_ADJ_MODES (ADJ_SETOFFSET | ADJ_NANO)
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_adjtime
+ *
+ * Description:
+ *   Read or adjust a clock.  With 'modes' zero only the state of the clock
+ *   is returned.  ADJ_SETOFFSET steps the clock by 'time' and ADJ_OFFSET
+ *   slews it by 'offset' through adjtime(), if that is available.  Only
+ *   CLOCK_REALTIME is supported.
+ *
+ * Returned Value:
+ *   The clock state (TIME_OK) on success; -1 with errno set on failure.
+ *
+ ****************************************************************************/
+
+int clock_adjtime(clockid_t clk_id, FAR struct timex *buf)
+{
+  struct timespec ts;
+  long nsec;
+  int ret;
+
+  if (buf == NULL || clk_id != CLOCK_REALTIME)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  /* Frequency adjustment needs a tunable clock source */
+
+  if ((buf->modes & ~CLOCK_ADJ_MODES) != 0)
+    {
+      set_errno(ENOTSUP);
+      return ERROR;
+    }
+
+  /* Step the clock by the offset in 'time' */
+
+  if ((buf->modes & ADJ_SETOFFSET) != 0)
+    {
+      nsec = buf->time.tv_usec;
+      if ((buf->modes & ADJ_NANO) == 0)
+        {
+          nsec *= NSEC_PER_USEC;
+        }
+
+      if (nsec < 0 || nsec >= NSEC_PER_SEC)
+        {
+          set_errno(EINVAL);
+          return ERROR;
+        }
+
+      clock_gettime(CLOCK_REALTIME, &ts);
+
+      ts.tv_sec  += buf->time.tv_sec;
+      ts.tv_nsec += nsec;
+      if (ts.tv_nsec >= NSEC_PER_SEC)
+        {
+          ts.tv_nsec -= NSEC_PER_SEC;
+          ts.tv_sec++;
+        }
+
+      ret = clock_settime(CLOCK_REALTIME, &ts);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+#ifdef HAVE_ADJTIME
+  /* Slew the clock by 'offset' */
+
+  if ((buf->modes & ADJ_OFFSET) != 0)
+    {
+      struct timeval delta;
+      long usec = buf->offset;
+
+      if ((buf->modes & ADJ_NANO) != 0)
+        {
+          usec /= NSEC_PER_USEC;
+        }
+
+      delta.tv_sec  = usec / USEC_PER_SEC;
+      delta.tv_usec = usec % USEC_PER_SEC;
+
+      ret = adjtime(&delta, NULL);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+#endif
+
+  /* Return the state of the clock */
+
+  clock_gettime(CLOCK_REALTIME, &ts);
+
+  buf->time.tv_sec  = ts.tv_sec;
+  buf->time.tv_usec = (buf->modes & ADJ_NANO) != 0 ?
+                      ts.tv_nsec : ts.tv_nsec / NSEC_PER_USEC;
+  buf->tick         = USEC_PER_TICK;
+  buf->precision    = 1;
+  buf->status       = 0;
+
+  sinfo("modes=%04x time=(%ld,%ld)\n", buf->modes,
+        (long)buf->time.tv_sec, buf->time.tv_usec);
+
+  return TIME_OK;
+}
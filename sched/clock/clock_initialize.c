@@ -237,6 +237,8 @@ void clock_initialize(void)
 
 #endif
 
+  clock_timepage_initialize();
+
   sched_trace_end();
 }
 
@@ -470,6 +472,10 @@ void clock_timer(void)
 
   g_system_ticks++;
 
+  /* The time page also picks up any change of the base time here */
+
+  clock_timepage_update();
+
 #ifdef CONFIG_CLOCK_ADJTIME
   /* Do we apply timer adjustment? */
 
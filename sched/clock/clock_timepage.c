@@ -0,0 +1,130 @@
+/****************************************************************************
+ * sched/clock/clock_timepage.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
+
+#include "clock/clock.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Without SMP only the compiler may reorder the writes to the page */
+
+#ifndef CONFIG_SPINLOCK
+#  undef  SP_DMB
+#  define SP_DMB()  __asm__ __volatile__ ("" : : : "memory")
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The page is allocated from the user heap so that unprivileged code can
+ * read it.
+ */
+
+static FAR struct clock_timepage_s *g_timepage;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_timepage_initialize
+ *
+ * Description:
+ *   Allocate and fill the time page.  Called once by clock_initialize().
+ *
+ ****************************************************************************/
+
+void clock_timepage_initialize(void)
+{
+  FAR struct clock_timepage_s *page;
+  irqstate_t flags;
+
+  page = kumm_zalloc(sizeof(struct clock_timepage_s));
+  if (page == NULL)
+    {
+      serr("ERROR: Failed to allocate the time page\n");
+      return;
+    }
+
+  flags = enter_critical_section();
+  g_timepage = page;
+  clock_timepage_update();
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: clock_timepage_update
+ *
+ * Description:
+ *   Copy the tick count and the base time to the time page.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled, from the timer interrupt or when the
+ *   base time changes.
+ *
+ ****************************************************************************/
+
+void clock_timepage_update(void)
+{
+  FAR struct clock_timepage_s *page = g_timepage;
+
+  if (page != NULL)
+    {
+      page->seq++;
+      SP_DMB();
+
+      page->ticks    = clock_systime_ticks();
+      page->basetime = g_basetime;
+
+      SP_DMB();
+      page->seq++;
+    }
+}
+
+/****************************************************************************
+ * Name: clock_timepage
+ *
+ * Description:
+ *   Return the time page.  This is the system call that the C library makes
+ *   once to find the page.
+ *
+ * Returned Value:
+ *   The time page, or NULL if it could not be allocated.
+ *
+ ****************************************************************************/
+
+FAR const struct clock_timepage_s *clock_timepage(void)
+{
+  return g_timepage;
+}
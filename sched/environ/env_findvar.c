@@ -96,6 +96,14 @@ ssize_t env_findvar(FAR struct task_group_s *group, FAR const char *pname)
       return -ENOENT;
     }
 
+#ifdef CONFIG_SCHED_ENV_HASH
+  i = env_hashfind(group, pname);
+  if (i != -ENOMEM)
+    {
+      return i;
+    }
+#endif
+
   /* Search for a name=value string with matching name */
 
   for (i = 0; group->tg_envp[i] != NULL; i++)
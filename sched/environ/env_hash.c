@@ -0,0 +1,321 @@
+/****************************************************************************
+ * sched/environ/env_hash.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#ifdef CONFIG_SCHED_ENV_HASH
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/kmalloc.h>
+
+#include "environ/environ.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The table is kept at most half full so that the probe sequences stay
+ * short.
+ */
+
+#define ENV_HASH_MINSIZE  8
+#define ENV_HASH_EMPTY    (-1)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: env_hashname
+ *
+ * Description:
+ *   FNV-1a hash of a variable name that ends with '\0' or '=', so that a
+ *   name and its name=value string have the same hash.
+ *
+ ****************************************************************************/
+
+static uint32_t env_hashname(FAR const char *name)
+{
+  uint32_t hash = 2166136261u;
+
+  for (; *name != '\0' && *name != '='; name++)
+    {
+      hash = (hash ^ (uint8_t)*name) * 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: env_hashslot
+ *
+ * Description:
+ *   Return the slot that holds the index 'index' of the name=value string
+ *   'pvar', which must be in the table.
+ *
+ ****************************************************************************/
+
+static size_t env_hashslot(FAR struct task_group_s *group,
+                           FAR const char *pvar, ssize_t index)
+{
+  size_t mask = group->tg_envhsize - 1;
+  size_t slot = env_hashname(pvar) & mask;
+
+  while (group->tg_envhash[slot] != index)
+    {
+      DEBUGASSERT(group->tg_envhash[slot] != ENV_HASH_EMPTY);
+      slot = (slot + 1) & mask;
+    }
+
+  return slot;
+}
+
+/****************************************************************************
+ * Name: env_hashinsert
+ ****************************************************************************/
+
+static void env_hashinsert(FAR struct task_group_s *group, ssize_t index)
+{
+  size_t mask = group->tg_envhsize - 1;
+  size_t slot = env_hashname(group->tg_envp[index]) & mask;
+
+  while (group->tg_envhash[slot] != ENV_HASH_EMPTY)
+    {
+      slot = (slot + 1) & mask;
+    }
+
+  group->tg_envhash[slot] = index;
+}
+
+/****************************************************************************
+ * Name: env_hashbuild
+ *
+ * Description:
+ *   (Re-)create the table of the group for its current environment.  On an
+ *   allocation failure the group is left without a table and the lookups
+ *   fall back to a linear search until the next attempt.
+ *
+ ****************************************************************************/
+
+static void env_hashbuild(FAR struct task_group_s *group)
+{
+  size_t size = ENV_HASH_MINSIZE;
+  size_t slot;
+  ssize_t i;
+
+  while (size < 2 * (size_t)group->tg_envc)
+    {
+      size <<= 1;
+    }
+
+  kmm_free(group->tg_envhash);
+  group->tg_envhash = kmm_malloc(size * sizeof(*group->tg_envhash));
+  if (group->tg_envhash == NULL)
+    {
+      group->tg_envhsize = 0;
+      return;
+    }
+
+  group->tg_envhsize = size;
+  for (slot = 0; slot < size; slot++)
+    {
+      group->tg_envhash[slot] = ENV_HASH_EMPTY;
+    }
+
+  for (i = 0; i < group->tg_envc; i++)
+    {
+      env_hashinsert(group, i);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: env_hashfind
+ *
+ * Description:
+ *   Look up a variable in the hashed index of the group's environment.  The
+ *   index is created by the first lookup.
+ *
+ * Input Parameters:
+ *   group - The task group containing environment array to be searched.
+ *   pname - The variable name to find
+ *
+ * Returned Value:
+ *   The index of the name=value string in the environment, -ENOENT if the
+ *   variable is not defined, or -ENOMEM if there is no index and the caller
+ *   must search the environment itself.
+ *
+ ****************************************************************************/
+
+ssize_t env_hashfind(FAR struct task_group_s *group, FAR const char *pname)
+{
+  FAR const char *name;
+  FAR const char *var;
+  size_t mask;
+  size_t slot;
+  ssize_t index;
+
+  if (group->tg_envhash == NULL)
+    {
+      env_hashbuild(group);
+      if (group->tg_envhash == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  mask = group->tg_envhsize - 1;
+  slot = env_hashname(pname) & mask;
+
+  while ((index = group->tg_envhash[slot]) != ENV_HASH_EMPTY)
+    {
+      for (name = pname, var = group->tg_envp[index];
+           *name != '\0' && *name == *var; name++, var++)
+        {
+        }
+
+      if (*name == '\0' && *var == '=')
+        {
+          return index;
+        }
+
+      slot = (slot + 1) & mask;
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: env_hashadd
+ *
+ * Description:
+ *   Enter the name=value string 'index', just appended to the environment,
+ *   into the hashed index.  The index grows when it gets half full.
+ *
+ ****************************************************************************/
+
+void env_hashadd(FAR struct task_group_s *group, ssize_t index)
+{
+  if (group->tg_envhash == NULL)
+    {
+      return;
+    }
+
+  if (2 * (size_t)group->tg_envc > group->tg_envhsize)
+    {
+      env_hashbuild(group);
+    }
+  else
+    {
+      env_hashinsert(group, index);
+    }
+}
+
+/****************************************************************************
+ * Name: env_hashremove
+ *
+ * Description:
+ *   Remove the name=value string 'index' from the hashed index before the
+ *   string is freed.  The following entries of the probe sequence are
+ *   moved back, so no tombstones are needed.
+ *
+ ****************************************************************************/
+
+void env_hashremove(FAR struct task_group_s *group, ssize_t index)
+{
+  size_t mask;
+  size_t home;
+  size_t hole;
+  size_t slot;
+
+  if (group->tg_envhash == NULL)
+    {
+      return;
+    }
+
+  mask = group->tg_envhsize - 1;
+  hole = env_hashslot(group, group->tg_envp[index], index);
+  slot = hole;
+
+  for (; ; )
+    {
+      slot = (slot + 1) & mask;
+      if (group->tg_envhash[slot] == ENV_HASH_EMPTY)
+        {
+          break;
+        }
+
+      /* An entry may fill the hole only if its home slot does not lie
+       * cyclically in (hole, slot].
+       */
+
+      home = env_hashname(group->tg_envp[group->tg_envhash[slot]]) & mask;
+      if (((slot - home) & mask) >= ((slot - hole) & mask))
+        {
+          group->tg_envhash[hole] = group->tg_envhash[slot];
+          hole = slot;
+        }
+    }
+
+  group->tg_envhash[hole] = ENV_HASH_EMPTY;
+}
+
+/****************************************************************************
+ * Name: env_hashmove
+ *
+ * Description:
+ *   Record that the name=value string 'from' now lives at 'to' in the
+ *   environment array.
+ *
+ ****************************************************************************/
+
+void env_hashmove(FAR struct task_group_s *group, ssize_t from, ssize_t to)
+{
+  if (group->tg_envhash != NULL)
+    {
+      /* The string is already stored at 'to' */
+
+      group->tg_envhash[env_hashslot(group, group->tg_envp[to], from)] = to;
+    }
+}
+
+/****************************************************************************
+ * Name: env_hashrelease
+ ****************************************************************************/
+
+void env_hashrelease(FAR struct task_group_s *group)
+{
+  kmm_free(group->tg_envhash);
+  group->tg_envhash  = NULL;
+  group->tg_envhsize = 0;
+}
+
+#endif /* CONFIG_SCHED_ENV_HASH */
@@ -85,6 +85,7 @@ void env_release(FAR struct task_group_s *group)
 
   group->tg_envp = NULL;
   group->tg_envc = 0;
+  env_hashrelease(group);
 }
 
 #endif /* CONFIG_DISABLE_ENVIRON */
@@ -65,6 +65,7 @@ void env_removevar(FAR struct task_group_s *group, ssize_t index)
 
   /* Free the allocate environment string */
 
+  env_hashremove(group, index);
   group_free(group, group->tg_envp[index]);
 
   /* Exchange the last env and the index env */
@@ -78,6 +79,7 @@ void env_removevar(FAR struct task_group_s *group, ssize_t index)
     {
       group->tg_envp[index] = group->tg_envp[group->tg_envc];
       group->tg_envp[group->tg_envc] = NULL;
+      env_hashmove(group, group->tg_envc, index);
     }
 
   /* Free the old environment (if there was one) */
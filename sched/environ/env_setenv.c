@@ -114,7 +114,8 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
 
   /* Check if the variable already exists */
 
-  if (group->tg_envp && (ret = env_findvar(group, name)) >= 0)
+  ret = env_findvar(group, name);
+  if (ret >= 0)
     {
       /* It does! Do we have permission to overwrite the existing value? */
 
@@ -125,13 +126,6 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
           sched_unlock();
           return OK;
         }
-
-      /* Yes.. just remove the name=value pair from the environment.  It will
-       * be added again below.  Note that we are responsible for reallocating
-       * the environment buffer; this will happen below.
-       */
-
-      env_removevar(group, ret);
     }
 
   /* Check current envirments count */
@@ -144,7 +138,7 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
 
   varlen = strlen(name) + strlen(value) + 2;
 
-  /* Then allocate or reallocate the environment buffer */
+  /* Then allocate the new name=value string */
 
   pvar = group_malloc(group, varlen);
   if (pvar == NULL)
@@ -153,6 +147,22 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
       goto errout_with_lock;
     }
 
+  snprintf(pvar, varlen, "%s=%s", name, value);
+
+  /* An existing variable is replaced in place, so its position in the
+   * environment and in the hashed index does not change.
+   */
+
+  if (ret >= 0)
+    {
+      group_free(group, group->tg_envp[ret]);
+      group->tg_envp[ret] = pvar;
+      sched_unlock();
+      return OK;
+    }
+
+  /* Otherwise append it to the reallocated environment buffer */
+
   if (group->tg_envp)
     {
       envc = group->tg_envc;
@@ -182,9 +192,7 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
   group->tg_envp = envp;
   group->tg_envc = envc;
 
-  /* Now, put the new name=value string into the environment buffer */
-
-  snprintf(pvar, varlen, "%s=%s", name, value);
+  env_hashadd(group, envc - 1);
   sched_unlock();
   return OK;
 
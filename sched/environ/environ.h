@@ -37,6 +37,13 @@
 #  define env_release(group)   (0)
 #else
 
+#ifndef CONFIG_SCHED_ENV_HASH
+#  define env_hashadd(group, index)
+#  define env_hashremove(group, index)
+#  define env_hashmove(group, from, to)
+#  define env_hashrelease(group)
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -145,6 +152,55 @@ ssize_t env_findvar(FAR struct task_group_s *group, FAR const char *pname);
 
 void env_removevar(FAR struct task_group_s *group, ssize_t index);
 
+#ifdef CONFIG_SCHED_ENV_HASH
+
+/****************************************************************************
+ * Name: env_hashfind
+ *
+ * Description:
+ *   Look up a variable in the hashed index of the group's environment.  The
+ *   index is created by the first lookup.
+ *
+ * Input Parameters:
+ *   group - The task group containing environment array to be searched.
+ *   pname - The variable name to find
+ *
+ * Returned Value:
+ *   The index of the name=value string in the environment, -ENOENT if the
+ *   variable is not defined, or -ENOMEM if there is no index and the caller
+ *   must search the environment itself.
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Pre-emption is disabled by caller
+ *
+ ****************************************************************************/
+
+ssize_t env_hashfind(FAR struct task_group_s *group, FAR const char *pname);
+
+/****************************************************************************
+ * Name: env_hashadd, env_hashremove, env_hashmove and env_hashrelease
+ *
+ * Description:
+ *   Keep the hashed index in step with the environment array:
+ *   env_hashadd() after the name=value string 'index' was appended,
+ *   env_hashremove() before the string 'index' is freed, env_hashmove()
+ *   after the string at 'from' was moved to 'to', and env_hashrelease()
+ *   when the environment is released.
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Pre-emption is disabled by caller
+ *
+ ****************************************************************************/
+
+void env_hashadd(FAR struct task_group_s *group, ssize_t index);
+void env_hashremove(FAR struct task_group_s *group, ssize_t index);
+void env_hashmove(FAR struct task_group_s *group, ssize_t from, ssize_t to);
+void env_hashrelease(FAR struct task_group_s *group);
+
+#endif /* CONFIG_SCHED_ENV_HASH */
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -0,0 +1,80 @@
+/****************************************************************************
+ * sched/event/event.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __SCHED_EVENT_EVENT_H
+#define __SCHED_EVENT_EVENT_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+
+#include <nuttx/event.h>
+#include <nuttx/list.h>
+#include <nuttx/semaphore.h>
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* One task waiting for an event group.  It lives on the stack of the
+ * waiting task while it is linked into the waitlist of the group.
+ */
+
+struct nxevent_wait_s
+{
+  struct list_node node;           /* Link in the waitlist of the group */
+  nxevent_mask_t expect;           /* Events waited for */
+  nxevent_mask_t received;         /* Events received, 0 while waiting */
+  int eflags;                      /* NXEVENT_WAIT_* flags */
+  sem_t sem;                       /* Posted when the events are received */
+};
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxevent_match
+ *
+ * Description:
+ *   Return the events of 'set' that satisfy a wait for 'expect', or zero
+ *   if the wait condition is not met.
+ *
+ ****************************************************************************/
+
+static inline nxevent_mask_t nxevent_match(nxevent_mask_t set,
+                                           nxevent_mask_t expect,
+                                           int eflags)
+{
+  nxevent_mask_t match = set & expect;
+
+  if ((eflags & NXEVENT_WAIT_ALL) != 0 && match != expect)
+    {
+      return 0;
+    }
+
+  return match;
+}
+
+#endif /* __SCHED_EVENT_EVENT_H */
@@ -0,0 +1,94 @@
+/****************************************************************************
+ * sched/event/event_init.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/event.h>
+#include <nuttx/list.h>
+
+#include "event/event.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxevent_init
+ *
+ * Description:
+ *   Initialize an event group.
+ *
+ * Input Parameters:
+ *   event  - The event group
+ *   events - The events that are initially set
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int nxevent_init(FAR nxevent_t *event, nxevent_mask_t events)
+{
+  if (event == NULL)
+    {
+      return -EINVAL;
+    }
+
+  list_initialize(&event->waitlist);
+  event->events = events;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxevent_destroy
+ *
+ * Description:
+ *   Destroy an event group.  No task may be waiting for it.
+ *
+ * Input Parameters:
+ *   event - The event group
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int nxevent_destroy(FAR nxevent_t *event)
+{
+  if (event == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (!list_is_empty(&event->waitlist))
+    {
+      return -EBUSY;
+    }
+
+  event->events = 0;
+  return OK;
+}
@@ -0,0 +1,132 @@
+/****************************************************************************
+ * sched/event/event_post.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sched.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/event.h>
+#include <nuttx/list.h>
+#include <nuttx/semaphore.h>
+
+#include "event/event.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxevent_post
+ *
+ * Description:
+ *   Set events and wake up every task whose wait condition is now met.
+ *   May be called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   event  - The event group
+ *   events - The events to set
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int nxevent_post(FAR nxevent_t *event, nxevent_mask_t events)
+{
+  FAR struct nxevent_wait_s *wait;
+  FAR struct nxevent_wait_s *tmp;
+  nxevent_mask_t consumed = 0;
+  nxevent_mask_t match;
+  irqstate_t flags;
+
+  if (event == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+
+  /* Don't let a woken task run before every waiter has been examined */
+
+  sched_lock();
+
+  event->events |= events;
+
+  list_for_every_entry_safe(&event->waitlist, wait, tmp,
+                            struct nxevent_wait_s, node)
+    {
+      match = nxevent_match(event->events, wait->expect, wait->eflags);
+      if (match != 0)
+        {
+          /* Clear the received events only after all waiters have seen
+           * them, so that one post can wake up several tasks.
+           */
+
+          if ((wait->eflags & NXEVENT_WAIT_NOCLEAR) == 0)
+            {
+              consumed |= match;
+            }
+
+          wait->received = match;
+          list_delete(&wait->node);
+          nxsem_post(&wait->sem);
+        }
+    }
+
+  event->events &= ~consumed;
+
+  sched_unlock();
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxevent_clear
+ *
+ * Description:
+ *   Clear events.  May be called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   event  - The event group
+ *   events - The events to clear
+ *
+ * Returned Value:
+ *   The events that were set before they were cleared.
+ *
+ ****************************************************************************/
+
+nxevent_mask_t nxevent_clear(FAR nxevent_t *event, nxevent_mask_t events)
+{
+  nxevent_mask_t old;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  old = event->events;
+  event->events = old & ~events;
+  leave_critical_section(flags);
+
+  return old;
+}
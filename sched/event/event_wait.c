@@ -0,0 +1,200 @@
+/****************************************************************************
+ * sched/event/event_wait.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/event.h>
+#include <nuttx/list.h>
+#include <nuttx/semaphore.h>
+
+#include "event/event.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Delay of nxevent_tickwait() that means no timeout */
+
+#define NXEVENT_FOREVER UINT32_MAX
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxevent_take
+ *
+ * Description:
+ *   Take the events that satisfy the wait, if any.  Called within a
+ *   critical section.
+ *
+ ****************************************************************************/
+
+static nxevent_mask_t nxevent_take(FAR nxevent_t *event,
+                                   nxevent_mask_t events, int eflags)
+{
+  nxevent_mask_t match;
+
+  match = nxevent_match(event->events, events, eflags);
+  if (match != 0 && (eflags & NXEVENT_WAIT_NOCLEAR) == 0)
+    {
+      event->events &= ~match;
+    }
+
+  return match;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxevent_tickwait
+ *
+ * Description:
+ *   Wait until any or all of the events are set, or until 'delay' ticks
+ *   have elapsed.
+ *
+ * Input Parameters:
+ *   event  - The event group
+ *   events - The events to wait for
+ *   eflags - NXEVENT_WAIT_* flags
+ *   delay  - Maximum time to wait, in clock ticks
+ *
+ * Returned Value:
+ *   The received events; zero if the wait timed out.
+ *
+ ****************************************************************************/
+
+nxevent_mask_t nxevent_tickwait(FAR nxevent_t *event, nxevent_mask_t events,
+                                int eflags, uint32_t delay)
+{
+  struct nxevent_wait_s wait;
+  irqstate_t flags;
+
+  DEBUGASSERT(event != NULL && events != 0);
+  DEBUGASSERT(!up_interrupt_context());
+
+  flags = enter_critical_section();
+
+  wait.received = nxevent_take(event, events, eflags);
+  if (wait.received != 0 || delay == 0)
+    {
+      leave_critical_section(flags);
+      return wait.received;
+    }
+
+  /* Block on a private semaphore until nxevent_post() hands over the
+   * events.  The semaphore is used for signaling, so it must not take
+   * part in priority inheritance.
+   */
+
+  wait.expect = events;
+  wait.eflags = eflags;
+  nxsem_init(&wait.sem, 0, 0);
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  nxsem_set_protocol(&wait.sem, SEM_PRIO_NONE);
+#endif
+
+  list_add_tail(&event->waitlist, &wait.node);
+
+  if (delay == NXEVENT_FOREVER)
+    {
+      nxsem_wait_uninterruptible(&wait.sem);
+    }
+  else
+    {
+      nxsem_tickwait_uninterruptible(&wait.sem, delay);
+    }
+
+  /* A post may have handed over the events right after the timeout */
+
+  if (wait.received == 0)
+    {
+      list_delete(&wait.node);
+    }
+
+  nxsem_destroy(&wait.sem);
+  leave_critical_section(flags);
+  return wait.received;
+}
+
+/****************************************************************************
+ * Name: nxevent_wait
+ *
+ * Description:
+ *   Wait until any or all of the events are set.
+ *
+ * Input Parameters:
+ *   event  - The event group
+ *   events - The events to wait for
+ *   eflags - NXEVENT_WAIT_* flags
+ *
+ * Returned Value:
+ *   The received events.
+ *
+ ****************************************************************************/
+
+nxevent_mask_t nxevent_wait(FAR nxevent_t *event, nxevent_mask_t events,
+                            int eflags)
+{
+  return nxevent_tickwait(event, events, eflags, NXEVENT_FOREVER);
+}
+
+/****************************************************************************
+ * Name: nxevent_trywait
+ *
+ * Description:
+ *   Take the events if the wait condition is met, without waiting.  May
+ *   be called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   event  - The event group
+ *   events - The events to wait for
+ *   eflags - NXEVENT_WAIT_* flags
+ *
+ * Returned Value:
+ *   The received events; zero if the condition is not met.
+ *
+ ****************************************************************************/
+
+nxevent_mask_t nxevent_trywait(FAR nxevent_t *event, nxevent_mask_t events,
+                               int eflags)
+{
+  nxevent_mask_t ret;
+  irqstate_t flags;
+
+  DEBUGASSERT(event != NULL);
+
+  flags = enter_critical_section();
+  ret = nxevent_take(event, events, eflags);
+  leave_critical_section(flags);
+
+  return ret;
+}
@@ -0,0 +1,111 @@
+/****************************************************************************
+ * sched/init/nx_boottrace.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/init.h>
+#include <nuttx/irq.h>
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+struct boottrace_s g_boottrace[CONFIG_SCHED_BOOTTRACE_NENTRIES];
+int g_nboottrace;
+uint32_t g_boottrace_dropped;
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The end of the last serial stage.  Zero at reset, which is where the
+ * performance counter starts.
+ */
+
+static unsigned long g_boottrace_last;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: boottrace_add
+ ****************************************************************************/
+
+static void boottrace_add(FAR const char *name, unsigned long start,
+                          unsigned long end)
+{
+  FAR struct boottrace_s *entry;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  if (g_nboottrace < CONFIG_SCHED_BOOTTRACE_NENTRIES)
+    {
+      entry        = &g_boottrace[g_nboottrace++];
+      entry->name  = name;
+      entry->start = start;
+      entry->end   = end;
+    }
+  else
+    {
+      g_boottrace_dropped++;
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: boottrace_record
+ *
+ * Description:
+ *   Add a stage that started at 'start' and ends now to the boot trace.
+ *
+ ****************************************************************************/
+
+void boottrace_record(FAR const char *name, unsigned long start)
+{
+  boottrace_add(name, start, up_perf_gettime());
+}
+
+/****************************************************************************
+ * Name: boottrace_stage
+ *
+ * Description:
+ *   Add a stage of the serial boot sequence that ends now.
+ *
+ ****************************************************************************/
+
+void boottrace_stage(FAR const char *name)
+{
+  unsigned long now = up_perf_gettime();
+
+  boottrace_add(name, g_boottrace_last, now);
+  g_boottrace_last = now;
+}
@@ -246,6 +246,7 @@ static inline void nx_start_application(void)
    */
 
   board_late_initialize();
+  BOOTTRACE_STAGE("board_late_initialize");
 #endif
 
   posix_spawnattr_init(&attr);
@@ -300,6 +301,8 @@ static inline void nx_start_application(void)
 #endif
   posix_spawnattr_destroy(&attr);
   DEBUGASSERT(ret > 0);
+
+  BOOTTRACE_STAGE("init_spawn");
 }
 
 /****************************************************************************
@@ -442,6 +445,7 @@ int nx_bringup(void)
    */
 
   nx_workqueues();
+  BOOTTRACE_STAGE("nx_workqueues");
 
   /* Once the operating system has been initialized, the system must be
    * started by spawning the user initialization thread of execution.  This
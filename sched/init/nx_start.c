@@ -321,6 +321,7 @@ void nx_start(void)
   /* Boot up is complete */
 
   g_nx_initstate = OSINIT_BOOT;
+  BOOTTRACE_STAGE("arch_boot");
 
   /* Initialize RTOS Data ***************************************************/
 
@@ -419,7 +420,12 @@ void nx_start(void)
 #else
       tasklist = TLIST_HEAD(&g_idletcb[i].cmn);
 #endif
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+      nxsched_rtrmap_add(&g_idletcb[i].cmn);
+      UNUSED(tasklist);
+#else
       dq_addfirst((FAR dq_entry_t *)&g_idletcb[i], tasklist);
+#endif
 
       /* Mark the idle task as the running task */
 
@@ -429,6 +435,7 @@ void nx_start(void)
   /* Task lists are initialized */
 
   g_nx_initstate = OSINIT_TASKLISTS;
+  BOOTTRACE_STAGE("tasklists");
 
   /* Initialize RTOS facilities *********************************************/
 
@@ -555,6 +562,7 @@ void nx_start(void)
   /* The memory manager is available */
 
   g_nx_initstate = OSINIT_MEMORY;
+  BOOTTRACE_STAGE("memory");
 
   /* Initialize tasking data structures */
 
@@ -570,10 +578,12 @@ void nx_start(void)
   /* Initialize the file system (needed to support device drivers) */
 
   fs_initialize();
+  BOOTTRACE_STAGE("fs_initialize");
 
   /* Initialize the interrupt handling subsystem (if included) */
 
   irq_initialize();
+  BOOTTRACE_STAGE("irq_initialize");
 
   /* Initialize the POSIX timer facility (if included in the link) */
 
@@ -583,9 +593,12 @@ void nx_start(void)
   timer_initialize();
 #endif
 
+  BOOTTRACE_STAGE("clock_initialize");
+
   /* Initialize the signal facility (if in link) */
 
   nxsig_initialize();
+  BOOTTRACE_STAGE("nxsig_initialize");
 
 #if !defined(CONFIG_DISABLE_MQUEUE) || !defined(CONFIG_DISABLE_MQUEUE_SYSV)
   /* Initialize the named message queue facility (if in link) */
@@ -599,16 +612,20 @@ void nx_start(void)
   nxmsg_initialize();
 #endif
 
+  BOOTTRACE_STAGE("mqueue");
+
 #ifdef CONFIG_NET
   /* Initialize the networking system */
 
   net_initialize();
+  BOOTTRACE_STAGE("net_initialize");
 #endif
 
 #ifndef CONFIG_BINFMT_DISABLE
   /* Initialize the binfmt system */
 
   binfmt_initialize();
+  BOOTTRACE_STAGE("binfmt_initialize");
 #endif
 
   /* Initialize Hardware Facilities *****************************************/
@@ -620,6 +637,7 @@ void nx_start(void)
    */
 
   up_initialize();
+  BOOTTRACE_STAGE("up_initialize");
 
   /* Initialize common drivers */
 
@@ -632,6 +650,7 @@ void nx_start(void)
    */
 
   board_early_initialize();
+  BOOTTRACE_STAGE("board_early_initialize");
 #endif
 
   /* Hardware resources are now available */
@@ -665,6 +684,8 @@ void nx_start(void)
         }
     }
 
+  BOOTTRACE_STAGE("idle_files");
+
 #ifdef CONFIG_SMP
   /* Start all CPUs *********************************************************/
 
@@ -675,6 +696,7 @@ void nx_start(void)
   /* Then start the other CPUs */
 
   DEBUGVERIFY(nx_smp_start());
+  BOOTTRACE_STAGE("nx_smp_start");
 
 #endif /* CONFIG_SMP */
 
@@ -67,6 +67,15 @@ struct irq_info_s
   uint32_t lscount;  /* Number of interrupts on this IRQ (LS) */
 #endif
   uint32_t time;     /* Maximum execution time on this IRQ */
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+  uint32_t mintime;  /* Minimum execution time on this IRQ */
+  uint32_t timehist[CONFIG_SCHED_IRQMONITOR_HISTOGRAM_NBUCKETS];
+#ifdef CONFIG_ARCH_HAVE_IRQ_TIMESTAMP
+  uint32_t minlat;   /* Minimum time from exception entry to the handler */
+  uint32_t maxlat;   /* Maximum time from exception entry to the handler */
+  uint32_t lathist[CONFIG_SCHED_IRQMONITOR_HISTOGRAM_NBUCKETS];
+#endif
+#endif
 #endif
 };
 
@@ -212,6 +221,19 @@ bool irq_cpu_locked(int cpu);
 int irq_foreach(irq_foreach_t callback, FAR void *arg);
 #endif
 
+/****************************************************************************
+ * Name: irq_histogram_reset
+ *
+ * Description:
+ *   Clear the execution time and latency histograms of one interrupt.
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+void irq_histogram_reset(FAR struct irq_info_s *info);
+#endif
+
 #ifdef CONFIG_IRQCHAIN
 void irqchain_initialize(void);
 bool is_irqchain(int ndx, xcpt_t isr);
@@ -123,6 +123,9 @@ int irq_attach(int irq, xcpt_t isr, FAR void *arg)
       g_irqvector[ndx].mscount = 0;
       g_irqvector[ndx].lscount = 0;
 #endif
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+      irq_histogram_reset(&g_irqvector[ndx]);
+#endif
 #endif
 
       leave_critical_section(flags);
@@ -375,6 +375,9 @@ try_again_in_irq:
 
               /* Note that we have entered the critical section */
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HOTSPOT
+              rtcb->crit_caller = return_address(0);
+#endif
 #ifdef CONFIG_SCHED_CRITMONITOR
               nxsched_critmon_csection(rtcb, true);
 #endif
@@ -418,6 +421,9 @@ irqstate_t enter_critical_section(void)
         {
           /* Note that we have entered the critical section */
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HOTSPOT
+          rtcb->crit_caller = return_address(0);
+#endif
 #ifdef CONFIG_SCHED_CRITMONITOR
           nxsched_critmon_csection(rtcb, true);
 #endif
@@ -25,6 +25,8 @@
 #include <nuttx/config.h>
 
 #include <debug.h>
+#include <stdint.h>
+#include <string.h>
 #include <nuttx/arch.h>
 #include <nuttx/irq.h>
 #include <nuttx/mm/mm.h>
@@ -68,6 +70,17 @@
      while (0)
 #endif
 
+/* UPDATE_HISTOGRAM - Record the execution time (and latency) statistics
+ * of this IRQ number
+ */
+
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+#  define UPDATE_HISTOGRAM(ndx, start, elapsed) \
+     irq_histogram(&g_irqvector[ndx], start, elapsed)
+#else
+#  define UPDATE_HISTOGRAM(ndx, start, elapsed)
+#endif
+
 /* CALL_VECTOR - Call the interrupt service routine attached to this
  * interrupt request
  */
@@ -92,6 +105,7 @@
                { \
                  g_irqvector[ndx].time = elapsed; \
                } \
+             UPDATE_HISTOGRAM(ndx, start, elapsed); \
            } \
          if (CONFIG_SCHED_CRITMONITOR_MAXTIME_IRQ > 0 && \
              elapsed > CONFIG_SCHED_CRITMONITOR_MAXTIME_IRQ) \
@@ -106,10 +120,99 @@
      vector(irq, context, arg)
 #endif /* CONFIG_SCHED_IRQMONITOR */
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+
+/****************************************************************************
+ * Name: irq_bucket
+ *
+ * Description:
+ *   Return the logarithmic histogram bucket of a time value
+ *
+ ****************************************************************************/
+
+static inline unsigned int irq_bucket(unsigned long value)
+{
+  unsigned int bucket = 0;
+
+  value >>= CONFIG_SCHED_IRQMONITOR_HISTOGRAM_SHIFT;
+  while (value != 0 &&
+         bucket < CONFIG_SCHED_IRQMONITOR_HISTOGRAM_NBUCKETS - 1)
+    {
+      value >>= 1;
+      bucket++;
+    }
+
+  return bucket;
+}
+
+/****************************************************************************
+ * Name: irq_histogram
+ *
+ * Description:
+ *   Update the execution time and latency statistics of one interrupt.
+ *   'start' is the up_perf_gettime() value just before the handler was
+ *   called.
+ *
+ ****************************************************************************/
+
+static inline void irq_histogram(FAR struct irq_info_s *info,
+                                 unsigned long start,
+                                 unsigned long elapsed)
+{
+#ifdef CONFIG_ARCH_HAVE_IRQ_TIMESTAMP
+  unsigned long latency = start - up_irq_timestamp();
+
+  if (latency < info->minlat)
+    {
+      info->minlat = latency;
+    }
+
+  if (latency > info->maxlat)
+    {
+      info->maxlat = latency;
+    }
+
+  info->lathist[irq_bucket(latency)]++;
+#endif
+
+  if (elapsed < info->mintime)
+    {
+      info->mintime = elapsed;
+    }
+
+  info->timehist[irq_bucket(elapsed)]++;
+}
+#endif /* CONFIG_SCHED_IRQMONITOR_HISTOGRAM */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: irq_histogram_reset
+ *
+ * Description:
+ *   Clear the execution time and latency histograms of one interrupt.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+void irq_histogram_reset(FAR struct irq_info_s *info)
+{
+  info->mintime = UINT32_MAX;
+  memset(info->timehist, 0, sizeof(info->timehist));
+#ifdef CONFIG_ARCH_HAVE_IRQ_TIMESTAMP
+  info->minlat  = UINT32_MAX;
+  info->maxlat  = 0;
+  memset(info->lathist, 0, sizeof(info->lathist));
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: irq_dispatch
  *
@@ -129,6 +232,12 @@ void irq_dispatch(int irq, FAR void *context)
   FAR void *arg = NULL;
   unsigned int ndx = irq;
 
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+  /* Account the time until now to the interrupted thread */
+
+  nxsched_critmon_irq(true);
+#endif
+
 #if NR_IRQS > 0
   if ((unsigned)irq < NR_IRQS)
     {
@@ -182,4 +291,10 @@ void irq_dispatch(int irq, FAR void *context)
       kmm_checkcorruption();
     }
 #endif
+
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+  /* And the time in the interrupt handler to interrupt processing */
+
+  nxsched_critmon_irq(false);
+#endif
 }
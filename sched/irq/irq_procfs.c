@@ -66,7 +66,21 @@
  * bytes).
  */
 
-#define IRQ_LINELEN 50
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+/* With histograms every interrupt is followed by
+ *
+ *       TIME MIN-MAX: <bucket 0> ... <bucket N-1>
+ *       LAT  MIN-MAX: <bucket 0> ... <bucket N-1>
+ *
+ * in up_perf_gettime() units.  Bucket 0 counts values below 2^SHIFT,
+ * bucket n values below 2^(SHIFT+n), the last one all larger values.
+ */
+
+#  define HIST_NBUCKETS CONFIG_SCHED_IRQMONITOR_HISTOGRAM_NBUCKETS
+#  define IRQ_LINELEN   (34 + 11 * HIST_NBUCKETS)
+#else
+#  define IRQ_LINELEN   50
+#endif
 
 /****************************************************************************
  * Private Types
@@ -88,6 +102,12 @@ struct irq_file_s
  * Private Function Prototypes
  ****************************************************************************/
 
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+static void    irq_histline(FAR struct irq_file_s *irqfile,
+                 FAR const char *name, uint32_t minval, uint32_t maxval,
+                 FAR const uint32_t *hist);
+#endif
+
 /* irq_foreach() callback function */
 
 static int     irq_callback(int irq, FAR struct irq_info_s *info,
@@ -134,6 +154,41 @@ const struct procfs_operations g_irq_operations =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: irq_histline
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+static void irq_histline(FAR struct irq_file_s *irqfile,
+                         FAR const char *name, uint32_t minval,
+                         uint32_t maxval, FAR const uint32_t *hist)
+{
+  size_t linesize;
+  size_t copysize;
+  int i;
+
+  linesize = snprintf(irqfile->line, IRQ_LINELEN, "    %s %lu-%lu:", name,
+                      (unsigned long)minval, (unsigned long)maxval);
+
+  for (i = 0; i < HIST_NBUCKETS; i++)
+    {
+      linesize += snprintf(irqfile->line + linesize,
+                           IRQ_LINELEN - linesize, " %lu",
+                           (unsigned long)hist[i]);
+    }
+
+  linesize += snprintf(irqfile->line + linesize, IRQ_LINELEN - linesize,
+                       "\n");
+
+  copysize  = procfs_memcpy(irqfile->line, linesize, irqfile->buffer,
+                            irqfile->remaining, &irqfile->offset);
+
+  irqfile->ncopied   += copysize;
+  irqfile->buffer    += copysize;
+  irqfile->remaining -= copysize;
+}
+#endif
+
 /****************************************************************************
  * Name: irq_callback
  ****************************************************************************/
@@ -168,6 +223,9 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
   info->lscount = 0;
 #endif
   info->time    = 0;
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+  irq_histogram_reset(info);
+#endif
   leave_critical_section(flags);
 
   /* Don't bother if count == 0.
@@ -252,6 +310,15 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
   irqfile->buffer    += copysize;
   irqfile->remaining -= copysize;
 
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+  /* Followed by the histograms */
+
+  irq_histline(irqfile, "TIME", copy.mintime, copy.time, copy.timehist);
+#ifdef CONFIG_ARCH_HAVE_IRQ_TIMESTAMP
+  irq_histline(irqfile, "LAT ", copy.minlat, copy.maxlat, copy.lathist);
+#endif
+#endif
+
   /* Return a non-zero value to stop the traversal if the user-provided
    * buffer is full.
    */
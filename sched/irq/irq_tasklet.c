@@ -0,0 +1,212 @@
+/****************************************************************************
+ * sched/irq/irq_tasklet.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/queue.h>
+#include <nuttx/tasklet.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_TASKLET
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Queued tasklets in the order that they were scheduled */
+
+static sq_queue_t g_tasklets;
+static uint32_t g_npending;
+
+static struct tasklet_stats_s g_taskletstats;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tasklet_schedule
+ *
+ * Description:
+ *   Queue a tasklet to run before returning to thread mode.
+ *
+ ****************************************************************************/
+
+void tasklet_schedule(FAR struct tasklet_s *tasklet)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(tasklet != NULL && tasklet->func != NULL);
+
+  flags = enter_critical_section();
+
+  if (tasklet->queued)
+    {
+      g_taskletstats.ncoalesced++;
+    }
+  else
+    {
+      tasklet->queued = true;
+      sq_addlast(&tasklet->node, &g_tasklets);
+
+      g_taskletstats.nscheduled++;
+      if (++g_npending > g_taskletstats.maxpending)
+        {
+          g_taskletstats.maxpending = g_npending;
+        }
+
+      /* The first tasklet pends the software interrupt, the others are
+       * picked up by the same run.
+       */
+
+      if (g_npending == 1)
+        {
+          up_trigger_tasklet();
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: tasklet_cancel
+ *
+ * Description:
+ *   Remove a queued tasklet.
+ *
+ ****************************************************************************/
+
+int tasklet_cancel(FAR struct tasklet_s *tasklet)
+{
+  irqstate_t flags;
+  int ret = -ENOENT;
+
+  DEBUGASSERT(tasklet != NULL);
+
+  flags = enter_critical_section();
+
+  if (tasklet->queued)
+    {
+      sq_rem(&tasklet->node, &g_tasklets);
+      tasklet->queued = false;
+      g_npending--;
+      ret = OK;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: tasklet_getstats
+ *
+ * Description:
+ *   Return the tasklet statistics and optionally reset them.
+ *
+ ****************************************************************************/
+
+void tasklet_getstats(FAR struct tasklet_stats_s *stats, bool reset)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(stats != NULL);
+
+  flags = enter_critical_section();
+
+  *stats = g_taskletstats;
+  if (reset)
+    {
+      memset(&g_taskletstats, 0, sizeof(g_taskletstats));
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: tasklet_run
+ *
+ * Description:
+ *   Run the queued tasklets, including those that are queued meanwhile.
+ *   Each tasklet is removed before it runs, with the interrupts enabled, so
+ *   it may schedule itself again and higher priority interrupts are not
+ *   delayed.
+ *
+ ****************************************************************************/
+
+void tasklet_run(void)
+{
+  FAR struct tasklet_s *tasklet;
+  unsigned long elapsed;
+  unsigned long start;
+  irqstate_t flags;
+  tasklet_t func;
+  FAR void *arg;
+
+  flags = enter_critical_section();
+
+  while ((tasklet = (FAR struct tasklet_s *)
+                    sq_remfirst(&g_tasklets)) != NULL)
+    {
+      func            = tasklet->func;
+      arg             = tasklet->arg;
+      tasklet->queued = false;
+      g_npending--;
+
+      leave_critical_section(flags);
+
+      start = up_perf_gettime();
+      func(arg);
+      elapsed = up_perf_gettime() - start;
+
+      flags = enter_critical_section();
+
+      g_taskletstats.nrun++;
+      if (elapsed > g_taskletstats.maxtime)
+        {
+          g_taskletstats.maxtime = elapsed;
+        }
+
+#if CONFIG_SCHED_TASKLET_MAXTIME > 0
+      if (elapsed > CONFIG_SCHED_TASKLET_MAXTIME)
+        {
+          g_taskletstats.noverrun++;
+          CRITMONITOR_PANIC("TASKLET %p execute too long %lu\n",
+                            func, elapsed);
+        }
+#endif
+    }
+
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_SCHED_TASKLET */
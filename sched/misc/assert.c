@@ -84,7 +84,7 @@ static struct lib_lzfoutstream_s  g_lzfstream;
 
 static FAR const char *g_policy[4] =
 {
-  "FIFO", "RR", "SPORADIC"
+  "FIFO", "RR", "SPORADIC", "DEADLINE"
 };
 
 static FAR const char * const g_ttypenames[4] =
@@ -0,0 +1,304 @@
+/****************************************************************************
+ * sched/mqueue/mq_loan.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <assert.h>
+#include <errno.h>
+#include <mqueue.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/mqueue.h>
+
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_LOAN
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_loan_msgq
+ *
+ * Description:
+ *   Return the message queue of an open descriptor if it was opened with
+ *   the access mode 'oflag', otherwise NULL.
+ *
+ ****************************************************************************/
+
+static FAR struct mqueue_inode_s *nxmq_loan_msgq(FAR struct file *mq,
+                                                 int oflag)
+{
+  if (mq == NULL || mq->f_inode == NULL || (mq->f_oflags & oflag) == 0)
+    {
+      return NULL;
+    }
+
+  return mq->f_inode->i_private;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_mq_reserve
+ *
+ * Description:
+ *   Reserve a message buffer of at least mq_msgsize bytes, waiting for the
+ *   queue to become non-full like file_mq_send().  The reserved message
+ *   counts against mq_maxmsg until it is committed or released.
+ *
+ * Input Parameters:
+ *   mq     - Message queue descriptor
+ *   buffer - Location to return the message buffer
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int file_mq_reserve(FAR struct file *mq, FAR char **buffer)
+{
+  FAR struct mqueue_inode_s *msgq;
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  int ret = OK;
+
+  msgq = nxmq_loan_msgq(mq, O_WROK);
+  if (msgq == NULL || buffer == NULL)
+    {
+      return msgq == NULL ? -EBADF : -EINVAL;
+    }
+
+  flags = enter_critical_section();
+
+  if (MQ_NMSGS(msgq) >= msgq->maxmsgs)
+    {
+      /* An interrupt handler cannot wait for the queue to drain */
+
+      if (up_interrupt_context())
+        {
+          ret = -EAGAIN;
+        }
+      else
+        {
+          ret = nxmq_wait_send(msgq, mq->f_oflags);
+        }
+    }
+
+  if (ret == OK)
+    {
+      mqmsg = nxmq_alloc_msg(msgq);
+      if (mqmsg != NULL)
+        {
+          mqmsg->reserved = true;
+          msgq->nreserved++;
+          *buffer = mqmsg->mail;
+        }
+      else
+        {
+          ret = -ENOMEM;
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: file_mq_commit
+ *
+ * Description:
+ *   Send a message reserved by file_mq_reserve() without copying it.
+ *
+ * Input Parameters:
+ *   mq     - Message queue descriptor
+ *   buffer - The reserved message buffer
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int file_mq_commit(FAR struct file *mq, FAR char *buffer, size_t msglen,
+                   unsigned int prio)
+{
+  FAR struct mqueue_inode_s *msgq;
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  int ret;
+
+  msgq = nxmq_loan_msgq(mq, O_WROK);
+  if (msgq == NULL)
+    {
+      return -EBADF;
+    }
+
+  if (buffer == NULL || prio >= MQ_PRIO_MAX)
+    {
+      return -EINVAL;
+    }
+
+  if (msglen > (size_t)msgq->maxmsgsize)
+    {
+      return -EMSGSIZE;
+    }
+
+  mqmsg = container_of(buffer, struct mqueue_msg_s, mail);
+
+  flags = enter_critical_section();
+
+  if (mqmsg->reserved)
+    {
+      /* The message already holds its place in the queue */
+
+      msgq->nreserved--;
+      ret = nxmq_do_send(msgq, mqmsg, buffer, msglen, prio);
+    }
+  else
+    {
+      ret = -EINVAL;
+    }
+
+  leave_critical_section(flags);
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: file_mq_receive_loan
+ *
+ * Description:
+ *   Receive a message like file_mq_receive(), but return the message
+ *   buffer itself instead of copying it.
+ *
+ * Input Parameters:
+ *   mq     - Message queue descriptor
+ *   buffer - Location to return the message buffer
+ *   prio   - If not NULL, the location to store message priority.
+ *
+ * Returned Value:
+ *   The length of the message on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t file_mq_receive_loan(FAR struct file *mq, FAR char **buffer,
+                             FAR unsigned int *prio)
+{
+  FAR struct mqueue_inode_s *msgq;
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  ssize_t ret;
+
+  DEBUGASSERT(up_interrupt_context() == false);
+
+  msgq = nxmq_loan_msgq(mq, O_RDOK);
+  if (msgq == NULL || buffer == NULL)
+    {
+      return msgq == NULL ? -EBADF : -EINVAL;
+    }
+
+  flags = enter_critical_section();
+
+  ret = nxmq_wait_receive(msgq, mq->f_oflags, &mqmsg);
+  if (ret == OK)
+    {
+      *buffer = mqmsg->mail;
+      if (prio)
+        {
+          *prio = mqmsg->priority;
+        }
+
+      ret = mqmsg->msglen;
+
+      /* The message has left the queue, a sender may proceed although
+       * the buffer is still lent out.
+       */
+
+      nxmq_wake_sender(msgq);
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: file_mq_release
+ *
+ * Description:
+ *   Give back a buffer obtained by file_mq_reserve() or
+ *   file_mq_receive_loan().
+ *
+ * Input Parameters:
+ *   mq     - Message queue descriptor
+ *   buffer - The message buffer
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void file_mq_release(FAR struct file *mq, FAR char *buffer)
+{
+  FAR struct mqueue_inode_s *msgq;
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  bool reserved;
+
+  DEBUGASSERT(mq != NULL && mq->f_inode != NULL && buffer != NULL);
+  msgq  = mq->f_inode->i_private;
+  mqmsg = container_of(buffer, struct mqueue_msg_s, mail);
+
+  flags = enter_critical_section();
+
+  reserved = mqmsg->reserved;
+  nxmq_free_msg(msgq, mqmsg);
+
+  if (reserved)
+    {
+      /* Give the place held by the reservation back to the senders */
+
+      msgq->nreserved--;
+      if (MQ_NMSGS(msgq) + 1 == msgq->maxmsgs)
+        {
+          nxmq_pollnotify(msgq, POLLOUT);
+        }
+
+      nxmq_wake_sender(msgq);
+    }
+
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_MQ_LOAN */
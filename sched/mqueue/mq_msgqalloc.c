@@ -102,6 +102,33 @@ int nxmq_alloc_msgq(FAR struct mq_attr *attr,
       msgq->ntpid = INVALID_PROCESS_ID;
 #endif
 
+#ifdef CONFIG_MQ_LOAN
+      list_initialize(&msgq->msgpool);
+      if (attr && (attr->mq_flags & MQ_POOL) != 0)
+        {
+          size_t size = MQ_POOLMSG_SIZE(msgq->maxmsgsize);
+          FAR struct mqueue_msg_s *mqmsg;
+          int i;
+
+          /* The messages of the pool only hold mq_msgsize bytes */
+
+          msgq->pool = kmm_malloc(size * msgq->maxmsgs);
+          if (msgq->pool == NULL)
+            {
+              kmm_free(msgq);
+              return -ENOSPC;
+            }
+
+          for (i = 0; i < msgq->maxmsgs; i++)
+            {
+              mqmsg = (FAR struct mqueue_msg_s *)
+                      ((FAR uint8_t *)msgq->pool + i * size);
+              mqmsg->type = MQ_ALLOC_POOL;
+              list_add_tail(&msgq->msgpool, &mqmsg->node);
+            }
+        }
+#endif
+
       dq_init(&msgq->cmn.waitfornotempty);
       dq_init(&msgq->cmn.waitfornotfull);
     }
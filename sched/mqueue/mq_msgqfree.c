@@ -63,9 +63,13 @@ void nxmq_free_msgq(FAR struct mqueue_inode_s *msgq)
       /* Deallocate the message structure. */
 
       list_delete(&entry->node);
-      nxmq_free_msg(entry);
+      nxmq_free_msg(msgq, entry);
     }
 
+#ifdef CONFIG_MQ_LOAN
+  kmm_free(msgq->pool);
+#endif
+
   /* Then deallocate the message queue itself */
 
   kmm_free(msgq);
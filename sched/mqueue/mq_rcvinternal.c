@@ -227,7 +227,8 @@ int nxmq_wait_receive(FAR struct mqueue_inode_s *msgq,
 
   if (newmsg)
     {
-      if (msgq->nmsgs-- == msgq->maxmsgs)
+      msgq->nmsgs--;
+      if (MQ_NMSGS(msgq) + 1 == msgq->maxmsgs)
         {
           nxmq_pollnotify(msgq, POLLOUT);
         }
@@ -270,7 +271,6 @@ ssize_t nxmq_do_receive(FAR struct mqueue_inode_s *msgq,
                         FAR struct mqueue_msg_s *mqmsg,
                         FAR char *ubuffer, FAR unsigned int *prio)
 {
-  FAR struct tcb_s *btcb;
   ssize_t rcvmsglen;
 
   /* Get the length of the message (also the return value) */
@@ -290,7 +290,38 @@ ssize_t nxmq_do_receive(FAR struct mqueue_inode_s *msgq,
 
   /* We are done with the message.  Deallocate it now. */
 
-  nxmq_free_msg(mqmsg);
+  nxmq_free_msg(msgq, mqmsg);
+
+  /* Wake up any task waiting for the MQ not full event. */
+
+  nxmq_wake_sender(msgq);
+
+  /* Return the length of the message transferred to the user buffer */
+
+  return rcvmsglen;
+}
+
+/****************************************************************************
+ * Name: nxmq_wake_sender
+ *
+ * Description:
+ *   Wake up the highest priority task waiting for the message queue to
+ *   become non-full, if any, after a message has been removed from it.
+ *
+ * Input Parameters:
+ *   msgq - Message queue descriptor
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ * - Pre-emption should be disabled throughout this call.
+ *
+ ****************************************************************************/
+
+void nxmq_wake_sender(FAR struct mqueue_inode_s *msgq)
+{
+  FAR struct tcb_s *btcb;
 
   /* Check if any tasks are waiting for the MQ not full event. */
 
@@ -333,8 +364,4 @@ ssize_t nxmq_do_receive(FAR struct mqueue_inode_s *msgq,
           up_switch_context(btcb, rtcb);
         }
     }
-
-  /* Return the length of the message transferred to the user buffer */
-
-  return rcvmsglen;
 }
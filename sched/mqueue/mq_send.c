@@ -101,7 +101,7 @@ int file_mq_send(FAR struct file *mq, FAR const char *msg, size_t msglen,
     {
       /* No.. Not in an interrupt handler.  Is the message queue FULL? */
 
-      if (msgq->nmsgs >= msgq->maxmsgs)
+      if (MQ_NMSGS(msgq) >= msgq->maxmsgs)
         {
           /* Yes.. the message queue is full.  Wait for space to become
            * available in the message queue.
@@ -117,7 +117,7 @@ int file_mq_send(FAR struct file *mq, FAR const char *msg, size_t msglen,
     {
       /* Now allocate the message. */
 
-      mqmsg = nxmq_alloc_msg();
+      mqmsg = nxmq_alloc_msg(msgq);
       DEBUGASSERT(mqmsg != NULL);
 
       /* Check if the message was successfully allocated */
@@ -112,8 +112,9 @@ int nxmq_verify_send(FAR FAR struct file *mq, FAR const char *msg,
  *
  * Description:
  *   The nxmq_alloc_msg function will get a free message for use by the
- *   operating system.  The message will be allocated from the g_msgfree
- *   list.
+ *   operating system.  The message will be allocated from the pool of the
+ *   message queue if it has one and that is not empty, otherwise from the
+ *   g_msgfree list.
  *
  *   If the list is empty AND the message is NOT being allocated from the
  *   interrupt level, then the message will be allocated.  If a message
@@ -126,7 +127,7 @@ int nxmq_verify_send(FAR FAR struct file *mq, FAR const char *msg,
  *   handler will be notified.
  *
  * Input Parameters:
- *   None
+ *   msgq - The message queue that the message will be sent to
  *
  * Returned Value:
  *   A reference to the allocated msg structure.  On a failure to allocate,
@@ -134,10 +135,20 @@ int nxmq_verify_send(FAR FAR struct file *mq, FAR const char *msg,
  *
  ****************************************************************************/
 
-FAR struct mqueue_msg_s *nxmq_alloc_msg(void)
+FAR struct mqueue_msg_s *nxmq_alloc_msg(FAR struct mqueue_inode_s *msgq)
 {
   FAR struct list_node *mqmsg;
 
+#ifdef CONFIG_MQ_LOAN
+  /* Try the pool of the message queue first */
+
+  mqmsg = list_remove_head(&msgq->msgpool);
+  if (mqmsg != NULL)
+    {
+      return (FAR struct mqueue_msg_s *)mqmsg;
+    }
+#endif
+
   /* Try to get the message from the generally available free list. */
 
   mqmsg = list_remove_head(&g_msgfree);
@@ -236,7 +247,7 @@ int nxmq_wait_send(FAR struct mqueue_inode_s *msgq, int oflags)
    * receiving message queue
    */
 
-  while (msgq->nmsgs >= msgq->maxmsgs)
+  while (MQ_NMSGS(msgq) >= msgq->maxmsgs)
     {
       /* Should we block until there is sufficient space in the
        * message queue?
@@ -333,10 +344,18 @@ int nxmq_do_send(FAR struct mqueue_inode_s *msgq,
 
   mqmsg->priority = prio;
   mqmsg->msglen   = msglen;
+#ifdef CONFIG_MQ_LOAN
+  mqmsg->reserved = false;
+#endif
 
-  /* Copy the message data into the message */
+  /* Copy the message data into the message, unless it was built in place
+   * by file_mq_reserve() and file_mq_commit().
+   */
 
-  memcpy((FAR void *)mqmsg->mail, (FAR const void *)msg, msglen);
+  if (msg != mqmsg->mail)
+    {
+      memcpy((FAR void *)mqmsg->mail, (FAR const void *)msg, msglen);
+    }
 
   /* Insert the new message in the message queue
    * Search the message list to find the location to insert the new
@@ -29,6 +29,7 @@
 #include <nuttx/compiler.h>
 
 #include <sys/types.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <limits.h>
@@ -55,7 +56,8 @@ enum mqalloc_e
 {
   MQ_ALLOC_FIXED = 0,  /* Pre-allocated; never freed */
   MQ_ALLOC_DYN,        /* Dynamically allocated; free when unused */
-  MQ_ALLOC_IRQ         /* Preallocated, reserved for interrupt handling */
+  MQ_ALLOC_IRQ,        /* Preallocated, reserved for interrupt handling */
+  MQ_ALLOC_POOL        /* Preallocated in the pool of a message queue */
 };
 
 /* This structure describes one buffered POSIX message. */
@@ -69,10 +71,19 @@ struct mqueue_msg_s
   uint8_t msglen;          /* Message data length */
 #else
   uint16_t msglen;         /* Message data length */
+#endif
+#ifdef CONFIG_MQ_LOAN
+  bool reserved;           /* Reserved by file_mq_reserve(), not sent */
 #endif
   char mail[MQ_MAX_BYTES]; /* Message data */
 };
 
+/* Size of a message of a queue pool, holding up to 'n' bytes */
+
+#define MQ_POOLMSG_SIZE(n) \
+  ((offsetof(struct mqueue_msg_s, mail) + (n) + sizeof(uintptr_t) - 1) & \
+   ~(sizeof(uintptr_t) - 1))
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -107,7 +118,8 @@ struct task_group_s; /* Forward reference */
 /* Functions defined in mq_initialize.c *************************************/
 
 void nxmq_initialize(void);
-void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg);
+void nxmq_free_msg(FAR struct mqueue_inode_s *msgq,
+                   FAR struct mqueue_msg_s *mqmsg);
 
 /* mq_waitirq.c *************************************************************/
 
@@ -125,6 +137,7 @@ int nxmq_wait_receive(FAR struct mqueue_inode_s *msgq,
 ssize_t nxmq_do_receive(FAR struct mqueue_inode_s *msgq,
                         FAR struct mqueue_msg_s *mqmsg,
                         FAR char *ubuffer, FAR unsigned int *prio);
+void nxmq_wake_sender(FAR struct mqueue_inode_s *msgq);
 
 /* mq_sndinternal.c *********************************************************/
 
@@ -134,7 +147,7 @@ int nxmq_verify_send(FAR struct file *mq, FAR const char *msg,
 #else
 #  define nxmq_verify_send(mq, msg, msglen, prio) OK
 #endif
-FAR struct mqueue_msg_s *nxmq_alloc_msg(void);
+FAR struct mqueue_msg_s *nxmq_alloc_msg(FAR struct mqueue_inode_s *msgq);
 int nxmq_wait_send(FAR struct mqueue_inode_s *msgq, int oflags);
 int nxmq_do_send(FAR struct mqueue_inode_s *msgq,
                  FAR struct mqueue_msg_s *mqmsg,
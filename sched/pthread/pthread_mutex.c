@@ -36,6 +36,19 @@
 #include "sched/sched.h"
 #include "pthread/pthread.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Non-robust mutexes are not tracked if they may be taken and released
+ * in user space (see pthread_mutex_add()).
+ */
+
+#if defined(CONFIG_SEM_FASTPATH) && defined(CONFIG_PTHREAD_MUTEX_BOTH)
+#  define PTHREAD_MUTEX_UNTRACKED(m) \
+     (((m)->flags & _PTHREAD_MFLAGS_ROBUST) == 0)
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -46,6 +59,11 @@
  * Description:
  *   Add the mutex to the list of mutexes held by this pthread.
  *
+ *   With CONFIG_SEM_FASTPATH, a non-robust mutex may be taken and released
+ *   in user space without the OS knowing, so only robust mutexes are kept
+ *   on the list.  A non-robust mutex is then not released when its holder
+ *   exits; POSIX leaves that case undefined.
+ *
  * Input Parameters:
  *  mutex - The mutex to be locked
  *
@@ -59,6 +77,13 @@ static void pthread_mutex_add(FAR struct pthread_mutex_s *mutex)
   FAR struct tcb_s *rtcb = this_task();
   irqstate_t flags;
 
+#ifdef PTHREAD_MUTEX_UNTRACKED
+  if (PTHREAD_MUTEX_UNTRACKED(mutex))
+    {
+      return;
+    }
+#endif
+
   DEBUGASSERT(mutex->flink == NULL);
 
   /* Add the mutex to the list of mutexes held by this pthread */
@@ -90,6 +115,13 @@ static void pthread_mutex_remove(FAR struct pthread_mutex_s *mutex)
   FAR struct pthread_mutex_s *prev;
   irqstate_t flags;
 
+#ifdef PTHREAD_MUTEX_UNTRACKED
+  if (PTHREAD_MUTEX_UNTRACKED(mutex))
+    {
+      return;
+    }
+#endif
+
   flags = enter_critical_section();
 
   /* Remove the mutex from the list of mutexes held by this task */
@@ -31,6 +31,8 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/pthread.h>
+
 #include "pthread/pthread.h"
 
 /****************************************************************************
@@ -38,7 +40,7 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: pthread_mutex_trylock
+ * Name: nx_pthread_mutex_trylock
  *
  * Description:
  *   The function pthread_mutex_trylock() is identical to
@@ -46,6 +48,9 @@
  *   mutex is currently locked (by any thread, including the current
  *   thread), the call returns immediately with the errno EBUSY.
  *
+ *   This is the OS part of pthread_mutex_trylock().  The C library calls it
+ *   only if the mutex cannot be taken without a system call.
+ *
  *   If a signal is delivered to a thread waiting for a mutex, upon return
  *   from the signal handler the thread resumes waiting for the mutex as if
  *   it was not interrupted.
@@ -66,7 +71,7 @@
  *
  ****************************************************************************/
 
-int pthread_mutex_trylock(FAR pthread_mutex_t *mutex)
+int nx_pthread_mutex_trylock(FAR pthread_mutex_t *mutex)
 {
   int status;
   int ret = EINVAL;
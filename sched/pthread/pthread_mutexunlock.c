@@ -31,6 +31,8 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/pthread.h>
+
 #include "pthread/pthread.h"
 
 /****************************************************************************
@@ -71,7 +73,7 @@ static inline bool pthread_mutex_islocked(FAR struct pthread_mutex_s *mutex)
  ****************************************************************************/
 
 /****************************************************************************
- * Name: pthread_mutex_unlock
+ * Name: nx_pthread_mutex_unlock
  *
  * Description:
  *   The pthread_mutex_unlock() function releases the mutex object referenced
@@ -84,6 +86,9 @@ static inline bool pthread_mutex_islocked(FAR struct pthread_mutex_s *mutex)
  *   count reaches zero and the calling thread no longer has any locks on
  *   this mutex).
  *
+ *   This is the OS part of pthread_mutex_unlock().  The C library calls it
+ *   only if the mutex cannot be released without a system call.
+ *
  *   If a signal is delivered to a thread waiting for a mutex, upon return
  *   from the signal handler the thread resumes waiting for the mutex as if
  *   it was not interrupted.
@@ -98,7 +103,7 @@ static inline bool pthread_mutex_islocked(FAR struct pthread_mutex_s *mutex)
  *
  ****************************************************************************/
 
-int pthread_mutex_unlock(FAR pthread_mutex_t *mutex)
+int nx_pthread_mutex_unlock(FAR pthread_mutex_t *mutex)
 {
   int ret = EPERM;
   irqstate_t flags;
@@ -241,6 +241,12 @@ extern const struct tasklist_s g_tasklisttable[NUM_TASK_STATES];
  */
 
 extern volatile uint32_t g_cpuload_total;
+
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+/* The part of g_cpuload_total that was spent in interrupt handlers */
+
+extern volatile uint32_t g_cpuload_irq;
+#endif
 #endif
 
 /* Declared in sched_lock.c *************************************************/
@@ -336,6 +342,23 @@ void nxsched_remove_blocked(FAR struct tcb_s *btcb);
 int  nxsched_set_priority(FAR struct tcb_s *tcb, int sched_priority);
 bool nxsched_reprioritize_rtr(FAR struct tcb_s *tcb, int priority);
 
+/* Insertion into, removal from and in-place re-prioritization of the
+ * running task in the non-SMP g_readytorun list.
+ */
+
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+bool nxsched_rtrmap_add(FAR struct tcb_s *tcb);
+void nxsched_rtrmap_remove(FAR struct tcb_s *tcb);
+void nxsched_rtrmap_setpriority(FAR struct tcb_s *tcb, int prio);
+#else
+#  define nxsched_rtrmap_add(t) \
+     nxsched_add_prioritized(t, &g_readytorun)
+#  define nxsched_rtrmap_remove(t) \
+     dq_rem((FAR dq_entry_t *)(t), &g_readytorun)
+#  define nxsched_rtrmap_setpriority(t, p) \
+     ((t)->sched_priority = (uint8_t)(p))
+#endif
+
 /* Priority inheritance support */
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
@@ -376,6 +399,18 @@ uint32_t nxsched_process_sporadic(FAR struct tcb_s *tcb, uint32_t ticks,
 void nxsched_sporadic_lowpriority(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+int  nxsched_start_deadline(FAR struct tcb_s *tcb,
+                            FAR const struct sched_param *param);
+int  nxsched_stop_deadline(FAR struct tcb_s *tcb);
+void nxsched_resume_deadline(FAR struct tcb_s *tcb);
+void nxsched_suspend_deadline(FAR struct tcb_s *tcb);
+bool nxsched_deadline_earlier(FAR struct tcb_s *tcb,
+                              FAR struct tcb_s *other);
+#else
+#  define nxsched_deadline_earlier(t, o) (false)
+#endif
+
 #ifdef CONFIG_SIG_SIGSTOP_ACTION
 void nxsched_suspend(FAR struct tcb_s *tcb);
 #endif
@@ -404,6 +439,10 @@ void nxsched_process_cpuload_ticks(uint32_t ticks);
 #define nxsched_process_cpuload() nxsched_process_cpuload_ticks(1)
 #endif
 
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+void nxsched_process_irqload_ticks(uint32_t ticks);
+#endif
+
 /* Critical section monitor */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
@@ -413,6 +452,10 @@ void nxsched_resume_critmon(FAR struct tcb_s *tcb);
 void nxsched_suspend_critmon(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+void nxsched_critmon_irq(bool state);
+#endif
+
 /* TCB operations */
 
 bool nxsched_verify_tcb(FAR struct tcb_s *tcb);
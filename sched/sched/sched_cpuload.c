@@ -24,9 +24,11 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <errno.h>
 #include <assert.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/clock.h>
 #include <nuttx/irq.h>
 
@@ -42,7 +44,9 @@
  * of the sampling in ticks per second for the selected timer.
  */
 
-#ifdef CONFIG_SCHED_CPULOAD_EXTCLK
+#if defined(CONFIG_SCHED_CPULOAD_CRITMONITOR)
+#  define CPULOAD_TICKSPERSEC up_perf_getfreq()
+#elif defined(CONFIG_SCHED_CPULOAD_EXTCLK)
 #  ifndef CONFIG_SCHED_CPULOAD_TICKSPERSEC
 #    error CONFIG_SCHED_CPULOAD_TICKSPERSEC is not defined
 #  endif
@@ -53,13 +57,15 @@
 
 /* When g_cpuload_total exceeds the following time constant, the load and
  * the counts will be scaled back by two.  In the CONFIG_SMP, g_cpuload_total
- * will be incremented multiple times per tick.
+ * will be incremented multiple times per tick.  With the critical monitor
+ * the counts are in up_perf_gettime() units, so the time constant is
+ * limited to keep the counts within 32 bits.
  */
 
 #define CPULOAD_TIMECONSTANT \
-     (CONFIG_SMP_NCPUS * \
-      CONFIG_SCHED_CPULOAD_TIMECONSTANT * \
-      CPULOAD_TICKSPERSEC)
+     ((uint32_t)MIN((uint64_t)CONFIG_SMP_NCPUS * \
+                    CONFIG_SCHED_CPULOAD_TIMECONSTANT * \
+                    CPULOAD_TICKSPERSEC, UINT32_MAX / 2))
 
 /****************************************************************************
  * Public Data
@@ -80,6 +86,62 @@
 
 volatile uint32_t g_cpuload_total;
 
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+/* The part of g_cpuload_total that was spent in interrupt handlers rather
+ * than in any thread.
+ */
+
+volatile uint32_t g_cpuload_irq;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_cpuload_rescale
+ *
+ * Description:
+ *   Divide all counts by two once the total exceeds the time constant.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+static void nxsched_cpuload_rescale(void)
+{
+  uint32_t total = 0;
+  int i;
+
+  if (g_cpuload_total <= CPULOAD_TIMECONSTANT)
+    {
+      return;
+    }
+
+  /* Divide the tick count for every task by two and recalculate the
+   * total.
+   */
+
+  for (i = 0; i < g_npidhash; i++)
+    {
+      if (g_pidhash[i])
+        {
+          g_pidhash[i]->ticks >>= 1;
+          total += g_pidhash[i]->ticks;
+        }
+    }
+
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+  g_cpuload_irq >>= 1;
+  total += g_cpuload_irq;
+#endif
+
+  /* Save the new total. */
+
+  g_cpuload_total = total;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -107,32 +169,39 @@ void nxsched_process_taskload_ticks(FAR struct tcb_s *tcb, uint32_t ticks)
 
   tcb->ticks += ticks;
   g_cpuload_total += ticks;
+  nxsched_cpuload_rescale();
 
-  if (g_cpuload_total > CPULOAD_TIMECONSTANT)
-    {
-      uint32_t total = 0;
-      int i;
+  leave_critical_section(flags);
+}
 
-      /* Divide the tick count for every task by two and recalculate the
-       * total.
-       */
+/****************************************************************************
+ * Name: nxsched_process_irqload_ticks
+ *
+ * Description:
+ *   Collect data that can be used for interrupt load measurements.
+ *
+ * Input Parameters:
+ *   ticks - The ticks spent in interrupt handlers.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
 
-      for (i = 0; i < g_npidhash; i++)
-        {
-          if (g_pidhash[i])
-            {
-              g_pidhash[i]->ticks >>= 1;
-              total += g_pidhash[i]->ticks;
-            }
-        }
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+void nxsched_process_irqload_ticks(uint32_t ticks)
+{
+  irqstate_t flags;
 
-      /* Save the new total. */
+  flags = enter_critical_section();
 
-      g_cpuload_total = total;
-    }
+  g_cpuload_irq += ticks;
+  g_cpuload_total += ticks;
+  nxsched_cpuload_rescale();
 
   leave_critical_section(flags);
 }
+#endif
 
 /****************************************************************************
  * Name: nxsched_process_cpuload_ticks
@@ -221,6 +290,9 @@ int clock_cpuload(int pid, FAR struct cpuload_s *cpuload)
     {
       cpuload->total  = g_cpuload_total;
       cpuload->active = g_pidhash[hash_index]->ticks;
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+      cpuload->irq    = g_cpuload_irq;
+#endif
       ret = OK;
     }
 
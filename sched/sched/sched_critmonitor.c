@@ -106,6 +106,15 @@
 static unsigned long g_premp_start[CONFIG_SMP_NCPUS];
 static unsigned long g_crit_start[CONFIG_SMP_NCPUS];
 
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+/* Time up to which the CPU load has been accounted and interrupt nesting
+ * level of each CPU.
+ */
+
+static unsigned long g_cpuload_start[CONFIG_SMP_NCPUS];
+static int g_irq_nesting[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -115,6 +124,107 @@ static unsigned long g_crit_start[CONFIG_SMP_NCPUS];
 unsigned long g_premp_max[CONFIG_SMP_NCPUS];
 unsigned long g_crit_max[CONFIG_SMP_NCPUS];
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HOTSPOT
+/* Cost of the pre-emption disabled regions and critical sections per call
+ * site.
+ */
+
+struct critmon_site_s g_premp_sites[CONFIG_SCHED_CRITMONITOR_HOTSPOT_NSITES];
+struct critmon_site_s g_crit_sites[CONFIG_SCHED_CRITMONITOR_HOTSPOT_NSITES];
+uint32_t g_premp_sites_dropped;
+uint32_t g_crit_sites_dropped;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_critmon_cpuload
+ *
+ * Description:
+ *   Charge the time since the last accounting point of this CPU to a
+ *   thread or, if tcb is NULL, to interrupt processing.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+static void nxsched_critmon_cpuload(FAR struct tcb_s *tcb,
+                                    unsigned long current)
+{
+  int cpu = this_cpu();
+  unsigned long elapsed = current - g_cpuload_start[cpu];
+
+  g_cpuload_start[cpu] = current;
+
+  if (tcb != NULL)
+    {
+      nxsched_process_taskload_ticks(tcb, elapsed);
+    }
+  else
+    {
+      nxsched_process_irqload_ticks(elapsed);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: nxsched_critmon_site
+ *
+ * Description:
+ *   Charge a region that has just been left to its call site.  If the
+ *   site is not in the table yet and the table is full, the site with the
+ *   smallest total time is replaced.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HOTSPOT
+static void nxsched_critmon_site(FAR struct critmon_site_s *sites,
+                                 FAR uint32_t *dropped, FAR void *caller,
+                                 unsigned long elapsed)
+{
+  FAR struct critmon_site_s *site = &sites[0];
+  int i;
+
+  for (i = 0; i < CONFIG_SCHED_CRITMONITOR_HOTSPOT_NSITES; i++)
+    {
+      if (sites[i].caller == caller)
+        {
+          site = &sites[i];
+          break;
+        }
+
+      /* Remember a free entry or else the cheapest one */
+
+      if (site->caller != NULL && (sites[i].caller == NULL ||
+          sites[i].total < site->total))
+        {
+          site = &sites[i];
+        }
+    }
+
+  if (site->caller != caller)
+    {
+      if (site->caller != NULL)
+        {
+          (*dropped)++;
+        }
+
+      site->caller = caller;
+      site->count  = 0;
+      site->max    = 0;
+      site->total  = 0;
+    }
+
+  site->count++;
+  site->total += elapsed;
+  if (elapsed > site->max)
+    {
+      site->max = elapsed;
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -157,6 +267,11 @@ void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state)
           CHECK_PREEMPTION(tcb->pid, elapsed);
         }
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HOTSPOT
+      nxsched_critmon_site(g_premp_sites, &g_premp_sites_dropped,
+                           tcb->premp_caller, elapsed);
+#endif
+
       /* Check for the global max elapsed time */
 
       elapsed = now - g_premp_start[cpu];
@@ -205,6 +320,11 @@ void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state)
           CHECK_CSECTION(tcb->pid, elapsed);
         }
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HOTSPOT
+      nxsched_critmon_site(g_crit_sites, &g_crit_sites_dropped,
+                           tcb->crit_caller, elapsed);
+#endif
+
       /* Check for the global max elapsed time */
 
       elapsed = now - g_crit_start[cpu];
@@ -298,8 +418,12 @@ void nxsched_suspend_critmon(FAR struct tcb_s *tcb)
   unsigned long elapsed = current - tcb->run_start;
 
 #ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
-  unsigned long tick = elapsed * CLOCKS_PER_SEC / up_perf_getfreq();
-  nxsched_process_taskload_ticks(tcb, tick);
+  /* A switch from an interrupt handler is accounted as interrupt time */
+
+  if (!up_interrupt_context())
+    {
+      nxsched_critmon_cpuload(tcb, current);
+    }
 #endif
 
   tcb->run_time += elapsed;
@@ -338,4 +462,39 @@ void nxsched_suspend_critmon(FAR struct tcb_s *tcb)
     }
 }
 
+/****************************************************************************
+ * Name: nxsched_critmon_irq
+ *
+ * Description:
+ *   Called when an interrupt handler is entered or left.  The time until
+ *   the outermost interrupt is entered is charged to the interrupted
+ *   thread, the time until it is left to interrupt processing.
+ *
+ * Assumptions:
+ *   - Called from an interrupt handler with interrupts disabled
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+void nxsched_critmon_irq(bool state)
+{
+  int cpu = this_cpu();
+
+  if (state)
+    {
+      if (g_irq_nesting[cpu]++ == 0)
+        {
+          nxsched_critmon_cpuload(this_task(), up_perf_gettime());
+        }
+    }
+  else
+    {
+      if (--g_irq_nesting[cpu] == 0)
+        {
+          nxsched_critmon_cpuload(NULL, up_perf_gettime());
+        }
+    }
+}
+#endif
+
 #endif
@@ -0,0 +1,450 @@
+/****************************************************************************
+ * sched/sched/sched_deadline.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sched.h>
+#include <signal.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/wdog.h>
+#include <nuttx/clock.h>
+
+#include "clock/clock.h"
+#include "signal/signal.h"
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Bandwidths are in parts per million */
+
+#define DEADLINE_BW_ONE    1000000
+#define DEADLINE_BW_MAX    (CONFIG_SCHED_DEADLINE_UTILIZATION * 10000)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void deadline_budget_expire(wdparm_t arg);
+static void deadline_period_expire(wdparm_t arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Total bandwidth of the threads using the deadline policy */
+
+static uint32_t g_deadline_bw;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: deadline_set_priority
+ *
+ * Description:
+ *   Change the priority of a deadline thread.  Like for the sporadic
+ *   policy, a priority boosted by priority inheritance is kept and only
+ *   the base priority is changed.
+ *
+ ****************************************************************************/
+
+static int deadline_set_priority(FAR struct tcb_s *tcb, int priority)
+{
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  if (tcb->sched_priority > tcb->base_priority &&
+      tcb->sched_priority >= priority)
+    {
+      tcb->base_priority = priority;
+      return OK;
+    }
+#endif
+
+  return nxsched_reprioritize(tcb, priority);
+}
+
+/****************************************************************************
+ * Name: deadline_budget_start
+ *
+ * Description:
+ *   Start consuming the budget of the current job.
+ *
+ ****************************************************************************/
+
+static void deadline_budget_start(FAR struct deadline_s *dl, clock_t now)
+{
+  dl->eventtime = now;
+  dl->running   = true;
+
+  DEBUGVERIFY(wd_start(&dl->budget_timer, dl->budget,
+                       deadline_budget_expire, (wdparm_t)dl));
+}
+
+/****************************************************************************
+ * Name: deadline_release
+ *
+ * Description:
+ *   Release a new job: renew the budget, move the absolute deadline and
+ *   start the timer of the next release.
+ *
+ ****************************************************************************/
+
+static void deadline_release(FAR struct deadline_s *dl, clock_t release,
+                             clock_t now)
+{
+  sclock_t delay;
+
+  dl->release     = release;
+  dl->absdeadline = release + dl->deadline;
+  dl->budget      = dl->runtime;
+
+  /* Keep the cadence of the releases even if this timer was late */
+
+  delay = (sclock_t)(release + dl->period - now);
+  DEBUGVERIFY(wd_start(&dl->period_timer, delay > 0 ? delay : 0,
+                       deadline_period_expire, (wdparm_t)dl));
+}
+
+/****************************************************************************
+ * Name: deadline_budget_expire
+ *
+ * Description:
+ *   The running thread has exhausted the budget of its job: throttle it
+ *   until the next release.
+ *
+ ****************************************************************************/
+
+static void deadline_budget_expire(wdparm_t arg)
+{
+  FAR struct deadline_s *dl = (FAR struct deadline_s *)arg;
+  FAR struct tcb_s *tcb = dl->tcb;
+#ifdef CONFIG_SCHED_DEADLINE_SIGXCPU
+  siginfo_t info;
+#endif
+
+  dl->budget    = 0;
+  dl->running   = false;
+  dl->throttled = true;
+  dl->noverrun++;
+
+  swarn("WARNING: pid %d overran its budget\n", tcb->pid);
+
+#ifdef CONFIG_SCHED_DEADLINE_SIGXCPU
+  info.si_signo           = SIGXCPU;
+  info.si_code            = SI_TIMER;
+  info.si_errno           = OK;
+  info.si_value.sival_int = 0;
+#ifdef CONFIG_SCHED_HAVE_PARENT
+  info.si_pid             = 0;
+  info.si_status          = OK;
+#endif
+
+  nxsig_tcbdispatch(tcb, &info);
+#endif
+
+  DEBUGVERIFY(deadline_set_priority(tcb, SCHED_PRIORITY_MIN));
+}
+
+/****************************************************************************
+ * Name: deadline_period_expire
+ *
+ * Description:
+ *   Release the next job.  A throttled thread gets its priority back; any
+ *   other thread is moved to its new place in the earliest deadline first
+ *   order.
+ *
+ ****************************************************************************/
+
+static void deadline_period_expire(wdparm_t arg)
+{
+  FAR struct deadline_s *dl = (FAR struct deadline_s *)arg;
+  FAR struct tcb_s *tcb = dl->tcb;
+  clock_t now = clock_systime_ticks();
+  bool throttled = dl->throttled;
+
+  if (dl->running)
+    {
+      wd_cancel(&dl->budget_timer);
+      dl->running = false;
+    }
+
+  deadline_release(dl, dl->release + dl->period, now);
+
+  dl->throttled = false;
+  if (tcb->task_state == TSTATE_TASK_RUNNING)
+    {
+      deadline_budget_start(dl, now);
+    }
+
+  if (throttled)
+    {
+      DEBUGVERIFY(deadline_set_priority(tcb, dl->priority));
+    }
+  else if (tcb->task_state == TSTATE_TASK_RUNNING ||
+           tcb->task_state == TSTATE_TASK_READYTORUN)
+    {
+      DEBUGVERIFY(nxsched_set_priority(tcb, tcb->sched_priority));
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_start_deadline
+ *
+ * Description:
+ *   Validate and admit the deadline parameters of a thread, then release
+ *   its first job.  Also used to change the parameters of a thread that
+ *   already uses the deadline policy.
+ *
+ * Input Parameters:
+ *   tcb   - The TCB of the thread
+ *   param - The runtime, deadline, period and priority
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure:
+ *
+ *   EINVAL runtime <= deadline <= period does not hold.
+ *   EBUSY  The new bandwidth cannot be admitted.
+ *   ENOMEM The policy state cannot be allocated.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+int nxsched_start_deadline(FAR struct tcb_s *tcb,
+                           FAR const struct sched_param *param)
+{
+  FAR struct deadline_s *dl = tcb->deadline;
+  sclock_t runtime;
+  sclock_t deadline;
+  sclock_t period;
+  uint32_t bandwidth;
+  uint32_t total;
+  clock_t now;
+
+  clock_time2ticks(&param->sched_dl_runtime, &runtime);
+  clock_time2ticks(&param->sched_dl_deadline, &deadline);
+  clock_time2ticks(&param->sched_dl_period, &period);
+
+  if (period == 0)
+    {
+      period = deadline;
+    }
+
+  if (runtime < 1 || runtime > deadline || deadline > period)
+    {
+      return -EINVAL;
+    }
+
+  /* Admission control */
+
+  bandwidth = (uint32_t)(((uint64_t)runtime * DEADLINE_BW_ONE) / period);
+  total     = g_deadline_bw + bandwidth;
+  if (dl != NULL)
+    {
+      total -= dl->bandwidth;
+    }
+
+  if (total > DEADLINE_BW_MAX)
+    {
+      return -EBUSY;
+    }
+
+  if (dl == NULL)
+    {
+      dl = kmm_zalloc(sizeof(struct deadline_s));
+      if (dl == NULL)
+        {
+          serr("ERROR: Failed to allocate deadline data structure\n");
+          return -ENOMEM;
+        }
+
+      dl->tcb       = tcb;
+      tcb->deadline = dl;
+    }
+  else
+    {
+      wd_cancel(&dl->period_timer);
+      wd_cancel(&dl->budget_timer);
+    }
+
+  g_deadline_bw = total;
+
+  dl->runtime   = runtime;
+  dl->deadline  = deadline;
+  dl->period    = period;
+  dl->bandwidth = bandwidth;
+  dl->priority  = param->sched_priority;
+  dl->running   = false;
+  dl->throttled = false;
+
+  /* Release the first job now */
+
+  now = clock_systime_ticks();
+  deadline_release(dl, now, now);
+
+  if (tcb->task_state == TSTATE_TASK_RUNNING)
+    {
+      deadline_budget_start(dl, now);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_stop_deadline
+ *
+ * Description:
+ *   Stop the deadline policy of a thread and release its bandwidth.  Called
+ *   when the thread changes its policy or exits; an exiting thread is left
+ *   with the FIFO policy.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Returned Value:
+ *   Zero (OK) on success.
+ *
+ ****************************************************************************/
+
+int nxsched_stop_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl = tcb->deadline;
+  irqstate_t flags;
+
+  DEBUGASSERT(dl != NULL);
+
+  flags = enter_critical_section();
+
+  wd_cancel(&dl->period_timer);
+  wd_cancel(&dl->budget_timer);
+
+  g_deadline_bw -= dl->bandwidth;
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      tcb->flags &= ~TCB_FLAG_POLICY_MASK;
+      tcb->flags |= TCB_FLAG_SCHED_FIFO;
+    }
+
+  tcb->deadline = NULL;
+  leave_critical_section(flags);
+
+  kmm_free(dl);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_resume_deadline
+ *
+ * Description:
+ *   Called when a deadline thread is about to run: start consuming the
+ *   budget of its job.
+ *
+ ****************************************************************************/
+
+void nxsched_resume_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl = tcb->deadline;
+
+  if (dl != NULL && !dl->throttled && !dl->running)
+    {
+      deadline_budget_start(dl, clock_systime_ticks());
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_suspend_deadline
+ *
+ * Description:
+ *   Called when a deadline thread stops running: charge the time that it
+ *   ran to its budget.
+ *
+ ****************************************************************************/
+
+void nxsched_suspend_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl = tcb->deadline;
+
+  if (dl != NULL && dl->running)
+    {
+      wd_cancel(&dl->budget_timer);
+
+      dl->budget -= (sclock_t)(clock_systime_ticks() - dl->eventtime);
+      if (dl->budget < 1)
+        {
+          /* Less than a tick is left, it expires on the next resume */
+
+          dl->budget = 1;
+        }
+
+      dl->running = false;
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_deadline_earlier
+ *
+ * Description:
+ *   Return true if 'tcb' must run before 'other' by the earliest deadline
+ *   first rule.  A thread without the deadline policy has an infinite
+ *   deadline.  The priorities are not compared.
+ *
+ ****************************************************************************/
+
+bool nxsched_deadline_earlier(FAR struct tcb_s *tcb, FAR struct tcb_s *other)
+{
+  if (tcb->deadline == NULL ||
+      (tcb->flags & TCB_FLAG_POLICY_MASK) != TCB_FLAG_SCHED_DEADLINE)
+    {
+      return false;
+    }
+
+  if (other->deadline == NULL ||
+      (other->flags & TCB_FLAG_POLICY_MASK) != TCB_FLAG_SCHED_DEADLINE)
+    {
+      return true;
+    }
+
+  return (sclock_t)(tcb->deadline->absdeadline -
+                    other->deadline->absdeadline) < 0;
+}
+
+#endif /* CONFIG_SCHED_DEADLINE */
@@ -199,6 +199,9 @@ int sched_lock(void)
         {
           /* Note that we have pre-emption locked */
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HOTSPOT
+          rtcb->premp_caller = return_address(0);
+#endif
 #ifdef CONFIG_SCHED_CRITMONITOR
           nxsched_critmon_preemption(rtcb, true);
 #endif
@@ -256,6 +259,9 @@ int sched_lock(void)
         {
           /* Note that we have pre-emption locked */
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HOTSPOT
+          rtcb->premp_caller = return_address(0);
+#endif
 #ifdef CONFIG_SCHED_CRITMONITOR
           nxsched_critmon_preemption(rtcb, true);
 #endif
@@ -69,7 +69,7 @@
  *
  ****************************************************************************/
 
-#ifndef CONFIG_SMP
+#if !defined(CONFIG_SMP) && !defined(CONFIG_SCHED_READYTORUN_BITMAP)
 bool nxsched_merge_pending(void)
 {
   FAR struct tcb_s *ptcb;
@@ -157,7 +157,63 @@ bool nxsched_merge_pending(void)
 
   return ret;
 }
-#endif /* !CONFIG_SMP */
+#endif /* !CONFIG_SMP && !CONFIG_SCHED_READYTORUN_BITMAP */
+
+/****************************************************************************
+ * Name: nxsched_merge_pending
+ *
+ * Description:
+ *   This function merges the prioritized g_pendingtasks list into the
+ *   prioritized ready-to-run task list.  With the priority bitmap each
+ *   pending task is inserted in bounded time, so there is no need to walk
+ *   the ready-to-run list alongside the pending list.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   true if the head of the ready-to-run task list has changed indicating
+ *     a context switch is needed.
+ *
+ * Assumptions:
+ * - The caller has established a critical section before calling this
+ *   function.
+ * - The caller handles the condition that occurs if the head of the
+ *   ready-to-run task list is changed.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_SMP) && defined(CONFIG_SCHED_READYTORUN_BITMAP)
+bool nxsched_merge_pending(void)
+{
+  FAR struct tcb_s *ptcb;
+  bool ret = false;
+
+  /* Do nothing if pre-emption is still disabled */
+
+  if (this_task()->lockcount == 0)
+    {
+      while ((ptcb = (FAR struct tcb_s *)dq_remfirst(&g_pendingtasks)) !=
+             NULL)
+        {
+          if (nxsched_rtrmap_add(ptcb))
+            {
+              /* ptcb is the new head of the ready-to-run list */
+
+              ptcb->flink->task_state = TSTATE_TASK_READYTORUN;
+              ptcb->task_state        = TSTATE_TASK_RUNNING;
+              ret                     = true;
+            }
+          else
+            {
+              ptcb->task_state        = TSTATE_TASK_READYTORUN;
+            }
+        }
+    }
+
+  return ret;
+}
+#endif /* !CONFIG_SMP && CONFIG_SCHED_READYTORUN_BITMAP */
 
 /****************************************************************************
  * Name: nxsched_merge_pending
@@ -30,6 +30,7 @@
 
 #include <nuttx/arch.h>
 #include <nuttx/sched.h>
+#include <nuttx/mm/mm.h>
 
 #include "sched/sched.h"
 #include "group/group.h"
@@ -157,6 +158,16 @@ int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
       ret = addrenv_leave(tcb);
 #endif
 
+#ifdef CONFIG_MM_HEAP_TCACHE
+      /* Return the cached heap blocks of the thread */
+
+      if (tcb->tcache != NULL)
+        {
+          mm_tcache_release(tcb->tcache);
+          tcb->tcache = NULL;
+        }
+#endif
+
       /* Leave the group (if we did not already leave in task_exithook.c) */
 
       group_leave(tcb);
@@ -88,10 +88,18 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *rtcb, bool merge)
     }
 
   /* Remove the TCB from the ready-to-run list.  In the non-SMP case, this
-   * is always the g_readytorun list.
+   * is always the g_readytorun list, except when nxtask_terminate() uses
+   * this function to remove a TCB from whatever list it is in.
    */
 
-  dq_rem((FAR dq_entry_t *)rtcb, tasklist);
+  if (tasklist == &g_readytorun)
+    {
+      nxsched_rtrmap_remove(rtcb);
+    }
+  else
+    {
+      dq_rem((FAR dq_entry_t *)rtcb, tasklist);
+    }
 
   /* Since the TCB is not in any list, it is now invalid */
 
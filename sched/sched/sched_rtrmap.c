@@ -0,0 +1,280 @@
+/****************************************************************************
+ * sched/sched/sched_rtrmap.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/queue.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* One bit per priority in g_rtrmap[], one bit per word of g_rtrmap[] in
+ * g_rtrsummary.
+ */
+
+#define RTRMAP_NPRIO       (SCHED_PRIORITY_MAX + 1)
+#define RTRMAP_NWORDS      ((RTRMAP_NPRIO + 31) >> 5)
+
+/* Index of the least significant bit set in a non-zero word.  On the
+ * Cortex-M this is RBIT followed by CLZ.
+ */
+
+#ifdef CONFIG_HAVE_BUILTIN_CTZ
+#  define RTRMAP_CTZ(v)    __builtin_ctz(v)
+#else
+#  define RTRMAP_CTZ(v)    (ffs(v) - 1)
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The last TCB of each priority present in g_readytorun.  Because the list
+ * is kept in descending priority order, this is the TCB after which a new
+ * task of that priority must be inserted.  Only valid while the priority's
+ * bit is set in g_rtrmap[].
+ */
+
+static FAR struct tcb_s *g_rtrlast[RTRMAP_NPRIO];
+
+static uint32_t g_rtrmap[RTRMAP_NWORDS];
+static uint32_t g_rtrsummary;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline void nxsched_rtrmap_set(int prio)
+{
+  g_rtrmap[prio >> 5] |= 1ul << (prio & 31);
+  g_rtrsummary        |= 1ul << (prio >> 5);
+}
+
+static inline void nxsched_rtrmap_clear(int prio)
+{
+  g_rtrmap[prio >> 5] &= ~(1ul << (prio & 31));
+  if (g_rtrmap[prio >> 5] == 0)
+    {
+      g_rtrsummary &= ~(1ul << (prio >> 5));
+    }
+}
+
+static inline bool nxsched_rtrmap_isset(int prio)
+{
+  return (g_rtrmap[prio >> 5] & (1ul << (prio & 31))) != 0;
+}
+
+/****************************************************************************
+ * Name: nxsched_rtrmap_lowest
+ *
+ * Description:
+ *   Return the lowest priority present in the ready-to-run list that is
+ *   greater than or equal to 'prio', or -1 if there is none.  Takes at most
+ *   two bit scans.
+ *
+ ****************************************************************************/
+
+static inline int nxsched_rtrmap_lowest(int prio)
+{
+  int word = prio >> 5;
+  uint32_t bits;
+
+  bits = g_rtrmap[word] & (UINT32_MAX << (prio & 31));
+  if (bits == 0)
+    {
+      /* Nothing left in this word, look for the next non-empty word */
+
+      bits = g_rtrsummary & (UINT32_MAX << (word + 1));
+      if (bits == 0)
+        {
+          return -1;
+        }
+
+      word = RTRMAP_CTZ(bits);
+      bits = g_rtrmap[word];
+    }
+
+  return (word << 5) + RTRMAP_CTZ(bits);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_rtrmap_add
+ *
+ * Description:
+ *   Insert a TCB into g_readytorun, after all TCBs of the same or higher
+ *   priority.  This is the bounded time equivalent of
+ *   nxsched_add_prioritized(tcb, &g_readytorun).
+ *
+ * Input Parameters:
+ *   tcb - Points to the TCB to add to the ready-to-run list
+ *
+ * Returned Value:
+ *   true if the head of the list has changed.
+ *
+ * Assumptions:
+ *   Same as for nxsched_add_prioritized().
+ *
+ ****************************************************************************/
+
+bool nxsched_rtrmap_add(FAR struct tcb_s *tcb)
+{
+  FAR struct tcb_s *prev;
+  int prio = tcb->sched_priority;
+  int lowest;
+
+  lowest = nxsched_rtrmap_lowest(prio);
+  prev   = lowest < 0 ? NULL : g_rtrlast[lowest];
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Among the TCBs of its own priority, a deadline thread goes before those
+   * with a later deadline.
+   */
+
+  if (lowest == prio)
+    {
+      while (prev != NULL && prev->sched_priority == prio &&
+             nxsched_deadline_earlier(tcb, prev))
+        {
+          prev = prev->blink;
+        }
+    }
+#endif
+
+  if (prev == NULL)
+    {
+      /* Every task in the list has a lower priority */
+
+      dq_addfirst((FAR dq_entry_t *)tcb, &g_readytorun);
+    }
+  else
+    {
+      dq_addafter((FAR dq_entry_t *)prev, (FAR dq_entry_t *)tcb,
+                  &g_readytorun);
+    }
+
+  /* The TCB is the last one of its priority unless it was inserted before
+   * another one.
+   */
+
+  if (lowest != prio || prev == g_rtrlast[prio])
+    {
+      g_rtrlast[prio] = tcb;
+      nxsched_rtrmap_set(prio);
+    }
+
+  return prev == NULL;
+}
+
+/****************************************************************************
+ * Name: nxsched_rtrmap_remove
+ *
+ * Description:
+ *   Remove a TCB from g_readytorun.
+ *
+ * Input Parameters:
+ *   tcb - Points to the TCB to remove from the ready-to-run list
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxsched_rtrmap_remove(FAR struct tcb_s *tcb)
+{
+  int prio = tcb->sched_priority;
+
+  DEBUGASSERT(nxsched_rtrmap_isset(prio));
+
+  if (g_rtrlast[prio] == tcb)
+    {
+      FAR struct tcb_s *prev = tcb->blink;
+
+      if (prev != NULL && prev->sched_priority == prio)
+        {
+          g_rtrlast[prio] = prev;
+        }
+      else
+        {
+          nxsched_rtrmap_clear(prio);
+        }
+    }
+
+  dq_rem((FAR dq_entry_t *)tcb, &g_readytorun);
+}
+
+/****************************************************************************
+ * Name: nxsched_rtrmap_setpriority
+ *
+ * Description:
+ *   Change the priority of the running task without moving it.  The new
+ *   priority must not be lower than that of the next task in the list.
+ *
+ * Input Parameters:
+ *   tcb  - The TCB at the head of g_readytorun
+ *   prio - The new priority
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxsched_rtrmap_setpriority(FAR struct tcb_s *tcb, int prio)
+{
+  DEBUGASSERT(tcb->blink == NULL);
+
+  /* Being at the head, the TCB is the last of its priority only if it is
+   * also the only one.
+   */
+
+  if (g_rtrlast[tcb->sched_priority] == tcb)
+    {
+      nxsched_rtrmap_clear(tcb->sched_priority);
+    }
+
+  /* Any other TCB of the new priority follows this one */
+
+  if (!nxsched_rtrmap_isset(prio))
+    {
+      g_rtrlast[prio] = tcb;
+      nxsched_rtrmap_set(prio);
+    }
+
+  tcb->sched_priority = (uint8_t)prio;
+}
+
+#endif /* CONFIG_SCHED_READYTORUN_BITMAP */
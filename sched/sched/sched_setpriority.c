@@ -167,7 +167,7 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
 
           /* Change the task priority */
 
-          tcb->sched_priority = (uint8_t)sched_priority;
+          nxsched_rtrmap_setpriority(tcb, sched_priority);
         }
       else
         {
@@ -186,7 +186,7 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
     {
       /* Change the task priority */
 
-      tcb->sched_priority = (uint8_t)sched_priority;
+      nxsched_rtrmap_setpriority(tcb, sched_priority);
     }
 }
 
@@ -251,10 +251,13 @@ static void nxsched_readytorun_setpriority(FAR struct tcb_s *tcb,
 #endif
 
   /* A context switch will occur if the new priority of the ready-to-run
-   * task is (strictly) greater than the current running task
+   * task is (strictly) greater than the current running task, or equal
+   * with an earlier deadline.
    */
 
-  if (sched_priority > rtcb->sched_priority)
+  if (sched_priority > rtcb->sched_priority ||
+      (sched_priority == rtcb->sched_priority &&
+       nxsched_deadline_earlier(tcb, rtcb)))
     {
       /* A context switch will occur. */
 
@@ -61,7 +61,8 @@
  * Input Parameters:
  *   pid - the task ID of the task to modify.  If pid is zero, the calling
  *      task is modified.
- *   policy - Scheduling policy requested (either SCHED_FIFO or SCHED_RR)
+ *   policy - Scheduling policy requested (SCHED_FIFO, SCHED_RR,
+ *      SCHED_SPORADIC or SCHED_DEADLINE)
  *   param - A structure whose member sched_priority is the new priority.
  *      The range of valid priority numbers is from SCHED_PRIORITY_MIN
  *      through SCHED_PRIORITY_MAX.
@@ -72,6 +73,7 @@
  *
  *   EINVAL The scheduling policy is not one of the recognized policies.
  *   ESRCH  The task whose ID is pid could not be found.
+ *   EBUSY  SCHED_DEADLINE: the bandwidth of the thread cannot be admitted.
  *
  ****************************************************************************/
 
@@ -80,6 +82,9 @@ int nxsched_set_scheduler(pid_t pid, int policy,
 {
   FAR struct tcb_s *tcb;
   irqstate_t flags;
+#ifdef CONFIG_SCHED_DEADLINE
+  uint16_t oldpolicy;
+#endif
   int ret;
 
   /* Check for supported scheduling policy */
@@ -91,6 +96,9 @@ int nxsched_set_scheduler(pid_t pid, int policy,
 #endif
 #ifdef CONFIG_SCHED_SPORADIC
       && policy != SCHED_SPORADIC
+#endif
+#ifdef CONFIG_SCHED_DEADLINE
+      && policy != SCHED_DEADLINE
 #endif
      )
     {
@@ -129,6 +137,19 @@ int nxsched_set_scheduler(pid_t pid, int policy,
   /* Further, disable timer interrupts while we set up scheduling policy. */
 
   flags = enter_critical_section();
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Cancel any on-going deadline scheduling unless only its parameters
+   * change.
+   */
+
+  oldpolicy = tcb->flags & TCB_FLAG_POLICY_MASK;
+  if (policy != SCHED_DEADLINE && tcb->deadline != NULL)
+    {
+      DEBUGVERIFY(nxsched_stop_deadline(tcb));
+    }
+#endif
+
   tcb->flags &= ~TCB_FLAG_POLICY_MASK;
   switch (policy)
     {
@@ -264,6 +285,28 @@ int nxsched_set_scheduler(pid_t pid, int policy,
         }
         break;
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+      case SCHED_DEADLINE:
+        {
+          /* Admit the thread and release its first job.  On failure, the
+           * thread keeps its previous policy.
+           */
+
+          ret = nxsched_start_deadline(tcb, param);
+          if (ret < 0)
+            {
+              tcb->flags |= oldpolicy;
+              goto errout_with_irq;
+            }
+
+          tcb->flags |= TCB_FLAG_SCHED_DEADLINE;
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+          tcb->timeslice  = 0;
+#endif
+        }
+        break;
+#endif
     }
 
   leave_critical_section(flags);
@@ -274,7 +317,7 @@ int nxsched_set_scheduler(pid_t pid, int policy,
   sched_unlock();
   return ret;
 
-#ifdef CONFIG_SCHED_SPORADIC
+#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_DEADLINE)
 errout_with_irq:
   leave_critical_section(flags);
   sched_unlock();
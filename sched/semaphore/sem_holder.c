@@ -77,13 +77,22 @@ nxsem_allocholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
    */
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  pholder = g_freeholders;
-  if (pholder != NULL)
+#  ifdef CONFIG_SEM_MUTEX_HOLDER
+  /* A mutex has a single holder, kept in the mutex itself */
+
+  if ((sem->flags & SEM_TYPE_MUTEX) != 0 && sem->holder.htcb == NULL)
+    {
+      pholder = &sem->holder;
+    }
+  else
+#  endif
+  if (g_freeholders != NULL)
     {
       /* Remove the holder from the free list and
        * put it into the semaphore's holder list
        */
 
+      pholder        = g_freeholders;
       g_freeholders  = pholder->flink;
       pholder->flink = sem->hhead;
       sem->hhead     = pholder;
@@ -127,6 +136,13 @@ nxsem_findholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
   FAR struct semholder_s *pholder;
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
+#  ifdef CONFIG_SEM_MUTEX_HOLDER
+  if (sem->holder.htcb == htcb)
+    {
+      return &sem->holder;
+    }
+#  endif
+
   /* Try to find the holder in the list of holders associated with this
    * semaphore
    */
@@ -204,6 +220,15 @@ static inline void nxsem_freeholder(FAR sem_t *sem,
   pholder->counts = 0;
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
+#  ifdef CONFIG_SEM_MUTEX_HOLDER
+  /* The holder embedded in a mutex is in neither list */
+
+  if (pholder == &sem->holder)
+    {
+      return;
+    }
+#  endif
+
   /* Remove the holder from the semaphore's list */
 
   for (curr = &sem->hhead;
@@ -259,6 +284,13 @@ static int nxsem_foreachholder(FAR sem_t *sem, holderhandler_t handler,
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
   FAR struct semholder_s *next;
 
+#  ifdef CONFIG_SEM_MUTEX_HOLDER
+  if (sem->holder.htcb != NULL)
+    {
+      ret = handler(&sem->holder, sem, arg);
+    }
+#  endif
+
   for (pholder = sem->hhead; pholder && ret == 0; pholder = next)
     {
       /* In case this holder gets deleted */
@@ -723,6 +755,14 @@ void nxsem_release_holder(FAR sem_t *sem)
       /* Find the container for this holder */
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
+#  ifdef CONFIG_SEM_MUTEX_HOLDER
+      if (sem->holder.htcb == rtcb)
+        {
+          sem->holder.counts--;
+          return;
+        }
+#  endif
+
       for (pholder = sem->hhead; pholder != NULL; pholder = pholder->flink)
         {
           DEBUGASSERT(pholder->counts > 0);
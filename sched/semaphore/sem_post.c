@@ -78,6 +78,15 @@ int nxsem_post(FAR sem_t *sem)
 
   DEBUGASSERT(sem != NULL);
 
+  /* Give the count without entering the critical section if there is
+   * nobody to wake up.
+   */
+
+  if (nxsem_post_fast(sem))
+    {
+      return OK;
+    }
+
   /* The following operations must be performed with interrupts
    * disabled because sem_post() may be called from an interrupt
    * handler.
@@ -25,6 +25,7 @@
 #include <nuttx/config.h>
 
 #include <inttypes.h>
+#include <limits.h>
 #include <string.h>
 #include <signal.h>
 #include <unistd.h>
@@ -184,18 +185,41 @@ static FAR sigpendq_t *nxsig_alloc_pendingsignal(void)
   return sigpend;
 }
 
+/****************************************************************************
+ * Name: nxsig_same_event
+ *
+ * Description:
+ *   Return true if two signals were caused by the same event source, i.e.
+ *   they only differ by the sender and so may be coalesced.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SIG_RTCOALESCE
+static bool nxsig_same_event(FAR const siginfo_t *info1,
+                             FAR const siginfo_t *info2)
+{
+  return info1->si_signo == info2->si_signo &&
+         info1->si_code == info2->si_code &&
+         memcmp(&info1->si_value, &info2->si_value,
+                sizeof(union sigval)) == 0;
+}
+#endif
+
 /****************************************************************************
  * Name: nxsig_find_pendingsignal
  *
  * Description:
- *   Find a specified element in the pending signal list
+ *   Find a specified element in the pending signal list.  A realtime signal
+ *   is only found if it was caused by the same event.
  *
  ****************************************************************************/
 
 static FAR sigpendq_t *
-nxsig_find_pendingsignal(FAR struct task_group_s *group, int signo)
+nxsig_find_pendingsignal(FAR struct task_group_s *group,
+                         FAR const siginfo_t *info)
 {
   FAR sigpendq_t *sigpend = NULL;
+  int signo = info->si_signo;
   irqstate_t flags;
 
   DEBUGASSERT(group != NULL);
@@ -204,6 +228,15 @@ nxsig_find_pendingsignal(FAR struct task_group_s *group, int signo)
 
   if (SIGRTMIN <= signo && signo <= SIGRTMAX)
     {
+#ifdef CONFIG_SIG_RTCOALESCE
+      flags = enter_critical_section();
+
+      for (sigpend = (FAR sigpendq_t *)group->tg_sigpendingq.head;
+           (sigpend && !nxsig_same_event(&sigpend->info, info));
+           sigpend = sigpend->flink);
+
+      leave_critical_section(flags);
+#endif
       return sigpend;
     }
 
@@ -262,12 +295,29 @@ static void nxsig_add_pendingsignal(FAR struct tcb_s *stcb,
 
   /* Check if the signal is already pending for the group */
 
-  sigpend = nxsig_find_pendingsignal(group, info->si_signo);
+  sigpend = nxsig_find_pendingsignal(group, info);
   if (sigpend != NULL)
     {
-      /* The signal is already pending... retain only one copy */
+#ifdef CONFIG_SIG_RTCOALESCE
+      /* The same event is still pending... only count it */
 
-      memcpy(&sigpend->info, info, sizeof(siginfo_t));
+      if (nxsig_same_event(&sigpend->info, info))
+        {
+          flags = enter_critical_section();
+          if (sigpend->info.si_overrun < DELAYTIMER_MAX)
+            {
+              sigpend->info.si_overrun++;
+            }
+
+          leave_critical_section(flags);
+        }
+      else
+#endif
+        {
+          /* The signal is already pending... retain only one copy */
+
+          memcpy(&sigpend->info, info, sizeof(siginfo_t));
+        }
     }
 
   /* No... There is nothing pending in the group for this signo */
@@ -349,6 +399,12 @@ int nxsig_tcbdispatch(FAR struct tcb_s *stcb, siginfo_t *info)
       return OK;
     }
 
+#ifdef CONFIG_SIG_RTCOALESCE
+  /* Nothing has been coalesced into this signal yet */
+
+  info->si_overrun = 0;
+#endif
+
   /************************** MASKED SIGNAL ACTIONS *************************/
 
   masked = nxsig_ismember(&stcb->sigprocmask, info->si_signo);
@@ -646,3 +702,36 @@ int nxsig_dispatch(pid_t pid, FAR siginfo_t *info)
 
 #endif
 }
+
+/****************************************************************************
+ * Name: nxsig_pending_overrun
+ *
+ * Description:
+ *   Return the overrun count of a pending realtime signal caused by the
+ *   same event as 'info'.
+ *
+ * Returned Value:
+ *   The overrun count, or -ENOENT if no such signal is pending.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SIG_RTCOALESCE
+int nxsig_pending_overrun(FAR struct tcb_s *stcb, FAR const siginfo_t *info)
+{
+  FAR sigpendq_t *sigpend;
+  irqstate_t flags;
+  int ret = -ENOENT;
+
+  DEBUGASSERT(stcb != NULL && stcb->group != NULL);
+
+  flags = enter_critical_section();
+  sigpend = nxsig_find_pendingsignal(stcb->group, info);
+  if (sigpend != NULL && nxsig_same_event(&sigpend->info, info))
+    {
+      ret = sigpend->info.si_overrun;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+#endif
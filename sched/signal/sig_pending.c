@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <string.h>
 #include <signal.h>
 #include <sched.h>
 #include <assert.h>
@@ -103,3 +104,67 @@ sigset_t nxsig_pendingset(FAR struct tcb_s *stcb)
 
   return sigpendset;
 }
+
+/****************************************************************************
+ * Name: nxsig_dequeue
+ *
+ * Description:
+ *   Remove up to 'count' pending signals in 'set' from the group of the
+ *   calling thread, in the order that they were queued, and return their
+ *   information.  Unlike nxsig_waitinfo(), which returns one signal per
+ *   call, all of the pending signals are taken with one scan of the
+ *   pending list and never block.
+ *
+ ****************************************************************************/
+
+int nxsig_dequeue(FAR const sigset_t *set, FAR siginfo_t *info, int count)
+{
+  FAR struct task_group_s *group;
+  FAR sigpendq_t *sigpend;
+  FAR sigpendq_t *prevsig;
+  FAR sigpendq_t *nextsig;
+  sq_queue_t taken;
+  irqstate_t flags;
+  int ret = 0;
+
+  group = this_task()->group;
+  DEBUGASSERT(group && set && info);
+
+  sq_init(&taken);
+
+  flags = enter_critical_section();
+  for (prevsig = NULL,
+       sigpend = (FAR sigpendq_t *)group->tg_sigpendingq.head;
+       sigpend != NULL && ret < count; sigpend = nextsig)
+    {
+      nextsig = sigpend->flink;
+      if (!nxsig_ismember(set, sigpend->info.si_signo))
+        {
+          prevsig = sigpend;
+          continue;
+        }
+
+      if (prevsig)
+        {
+          sq_remafter((FAR sq_entry_t *)prevsig, &group->tg_sigpendingq);
+        }
+      else
+        {
+          sq_remfirst(&group->tg_sigpendingq);
+        }
+
+      memcpy(&info[ret++], &sigpend->info, sizeof(siginfo_t));
+      sq_addlast((FAR sq_entry_t *)sigpend, &taken);
+    }
+
+  leave_critical_section(flags);
+
+  /* Release the entries outside of the critical section */
+
+  while ((sigpend = (FAR sigpendq_t *)sq_remfirst(&taken)) != NULL)
+    {
+      nxsig_release_pendingsignal(sigpend);
+    }
+
+  return ret;
+}
@@ -168,6 +168,10 @@ int                nxsig_default_initialize(FAR struct tcb_s *tcb);
 int                nxsig_tcbdispatch(FAR struct tcb_s *stcb,
                                      FAR siginfo_t *info);
 int                nxsig_dispatch(pid_t pid, FAR siginfo_t *info);
+#ifdef CONFIG_SIG_RTCOALESCE
+int                nxsig_pending_overrun(FAR struct tcb_s *stcb,
+                                         FAR const siginfo_t *info);
+#endif
 
 /* sig_cleanup.c */
 
@@ -139,7 +139,17 @@ static int nxtask_restart(pid_t pid)
   tasklist = TLIST_HEAD(&tcb->cmn);
 #endif
 
-  dq_rem((FAR dq_entry_t *)tcb, tasklist);
+#ifndef CONFIG_SMP
+  if (tasklist == &g_readytorun)
+    {
+      nxsched_rtrmap_remove(&tcb->cmn);
+    }
+  else
+#endif
+    {
+      dq_rem((FAR dq_entry_t *)tcb, tasklist);
+    }
+
   tcb->cmn.task_state = TSTATE_TASK_INVALID;
 
   /* Deallocate anything left in the TCB's signal queues */
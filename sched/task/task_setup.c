@@ -381,6 +381,13 @@ static int nxthread_setup_scheduler(FAR struct tcb_s *tcb, int priority,
   ret = nxtask_assign_pid(tcb);
   if (ret == OK)
     {
+      FAR struct tls_info_s *info = tcb->stack_alloc_ptr;
+
+      /* Let user space read the thread ID without a system call */
+
+      DEBUGASSERT(info != NULL);
+      info->tl_tid = tcb->pid;
+
       /* Save task priority and entry point in the TCB */
 
       tcb->sched_priority = (uint8_t)priority;
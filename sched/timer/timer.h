@@ -60,6 +60,10 @@ struct posix_timer_s
   struct wdog_s    pt_wdog;        /* The watchdog that provides the timing */
   struct sigevent  pt_event;       /* Notification information */
   struct sigwork_s pt_work;
+#ifdef CONFIG_SIG_RTCOALESCE
+  int              pt_overrun;     /* Overruns of the last delivered signal */
+  int              pt_pendoverrun; /* Overruns of the last generated signal */
+#endif
 };
 
 /****************************************************************************
@@ -87,6 +91,9 @@ void timer_initialize(void);
 void timer_deleteall(pid_t pid);
 int timer_release(FAR struct posix_timer_s *timer);
 FAR struct posix_timer_s *timer_gethandle(timer_t timerid);
+#ifdef CONFIG_SIG_RTCOALESCE
+int timer_pendingoverrun(FAR struct posix_timer_s *timer);
+#endif
 
 #endif /* CONFIG_DISABLE_POSIX_TIMERS */
 #endif /* __SCHED_TIMER_TIMER_H */
@@ -180,6 +180,10 @@ int timer_create(clockid_t clockid, FAR struct sigevent *evp,
   ret->pt_crefs = 1;
   ret->pt_owner = nxsched_getpid();
   ret->pt_delay = 0;
+#ifdef CONFIG_SIG_RTCOALESCE
+  ret->pt_overrun     = 0;
+  ret->pt_pendoverrun = 0;
+#endif
 
   /* Was a struct sigevent provided? */
 
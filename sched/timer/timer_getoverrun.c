@@ -25,8 +25,13 @@
 #include <nuttx/config.h>
 
 #include <time.h>
+#include <string.h>
 #include <errno.h>
 
+#include <nuttx/irq.h>
+
+#include "sched/sched.h"
+#include "signal/signal.h"
 #include "timer/timer.h"
 
 #ifndef CONFIG_DISABLE_POSIX_TIMERS
@@ -35,6 +40,43 @@
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: timer_pendingoverrun
+ *
+ * Description:
+ *   Return the overrun count of the timer's signal while it is pending for
+ *   its owner, or -ENOENT if it is not pending.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SIG_RTCOALESCE
+int timer_pendingoverrun(FAR struct posix_timer_s *timer)
+{
+  FAR struct tcb_s *tcb;
+  siginfo_t info;
+
+  if (timer->pt_event.sigev_notify != SIGEV_SIGNAL)
+    {
+      return -ENOENT;
+    }
+
+  tcb = nxsched_get_tcb(timer->pt_owner);
+  if (tcb == NULL)
+    {
+      return -ENOENT;
+    }
+
+  /* The fields that nxsig_notification() sets from the event */
+
+  info.si_signo = timer->pt_event.sigev_signo;
+  info.si_code  = SI_TIMER;
+  memcpy(&info.si_value, &timer->pt_event.sigev_value,
+         sizeof(union sigval));
+
+  return nxsig_pending_overrun(tcb, &info);
+}
+#endif
+
 /****************************************************************************
  * Name: timer_getoverrun
  *
@@ -75,9 +117,38 @@
 
 int timer_getoverrun(timer_t timerid)
 {
+#ifdef CONFIG_SIG_RTCOALESCE
+  FAR struct posix_timer_s *timer = timer_gethandle(timerid);
+  irqstate_t flags;
+  int ret;
+
+  if (timer == NULL)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  /* While the last signal is pending, its count is not final yet and the
+   * count of the signal before it applies.
+   */
+
+  flags = enter_critical_section();
+  if (timer_pendingoverrun(timer) < 0)
+    {
+      ret = timer->pt_pendoverrun;
+    }
+  else
+    {
+      ret = timer->pt_overrun;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+#else
   UNUSED(timerid);
   set_errno(ENOSYS);
   return ERROR;
+#endif
 }
 
 #endif /* CONFIG_DISABLE_POSIX_TIMERS */
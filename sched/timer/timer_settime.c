@@ -25,6 +25,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <limits.h>
 #include <time.h>
 #include <string.h>
 #include <assert.h>
@@ -70,6 +71,24 @@ static void timer_timeout(wdparm_t itimer);
 
 static inline void timer_signotify(FAR struct posix_timer_s *timer)
 {
+#ifdef CONFIG_SIG_RTCOALESCE
+  int overrun = timer_pendingoverrun(timer);
+
+  if (overrun < 0)
+    {
+      /* The previous signal has been delivered, this one starts again */
+
+      timer->pt_overrun     = timer->pt_pendoverrun;
+      timer->pt_pendoverrun = 0;
+    }
+  else if (overrun < DELAYTIMER_MAX)
+    {
+      /* The signal is still pending and this expiration will be counted */
+
+      timer->pt_pendoverrun = overrun + 1;
+    }
+
+#endif
   DEBUGVERIFY(nxsig_notification(timer->pt_owner, &timer->pt_event,
                                  SI_TIMER, &timer->pt_work));
 }
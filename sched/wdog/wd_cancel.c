@@ -55,6 +55,44 @@
  *
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+int wd_cancel(FAR struct wdog_s *wdog)
+{
+  irqstate_t flags;
+  int ret = -EINVAL;
+
+  flags = enter_critical_section();
+
+  if (wdog != NULL && WDOG_ISACTIVE(wdog))
+    {
+#ifdef CONFIG_SCHED_TICKLESS
+      /* Only a watchdog that expires no later than the next event of the
+       * wheel is what the interval timer waits for.
+       */
+
+      bool first = (sclock_t)(wdog->expired - g_wdtickbase) <=
+                   (sclock_t)wd_wheel_nextdelay();
+#endif
+
+      /* Remove the watchdog from its slot and mark it inactive */
+
+      wd_wheel_remove(wdog);
+      wdog->func = NULL;
+
+#ifdef CONFIG_SCHED_TICKLESS
+      if (first)
+        {
+          nxsched_reassess_timer();
+        }
+#endif
+
+      ret = OK;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+#else
 int wd_cancel(FAR struct wdog_s *wdog)
 {
   FAR struct wdog_s *curr;
@@ -136,3 +174,4 @@ int wd_cancel(FAR struct wdog_s *wdog)
   leave_critical_section(flags);
   return ret;
 }
+#endif /* CONFIG_WDOG_TIMERWHEEL */
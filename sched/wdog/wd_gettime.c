@@ -59,6 +59,15 @@ sclock_t wd_gettime(FAR struct wdog_s *wdog)
   flags = enter_critical_section();
   if (wdog != NULL && WDOG_ISACTIVE(wdog))
     {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+      /* The wheel keeps the absolute expiration time */
+
+      sclock_t delay = (sclock_t)(wdog->expired - g_wdtickbase);
+
+      delay -= wd_elapse();
+      leave_critical_section(flags);
+      return delay;
+#else
       /* Traverse the watchdog list accumulating lag times until we find the
        * wdog that we are looking for
        */
@@ -78,8 +87,64 @@ sclock_t wd_gettime(FAR struct wdog_s *wdog)
               return delay;
             }
         }
+#endif
     }
 
   leave_critical_section(flags);
   return 0;
 }
+
+/****************************************************************************
+ * Name: wd_nextdelay
+ *
+ * Description:
+ *   This function returns the time remaining before the next active
+ *   watchdog timer expires.  With the timing wheel this may be the time of
+ *   the next cascade instead, which is never later than the expiration.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The time in system ticks remaining until the next watchdog timer
+ *   expires, or a negative value if no watchdog timer is active.
+ *
+ ****************************************************************************/
+
+sclock_t wd_nextdelay(void)
+{
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  clock_t next;
+#else
+  FAR struct wdog_s *head;
+#endif
+  irqstate_t flags;
+  sclock_t delay = -1;
+
+  flags = enter_critical_section();
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  next = wd_wheel_nextdelay();
+  if (next != 0)
+    {
+      delay = (sclock_t)next - wd_elapse();
+      if (delay < 0)
+        {
+          delay = 0;
+        }
+    }
+#else
+  head = (FAR struct wdog_s *)g_wdactivelist.head;
+  if (head != NULL)
+    {
+      delay = head->lag - wd_elapse();
+      if (delay < 0)
+        {
+          delay = 0;
+        }
+    }
+#endif
+
+  leave_critical_section(flags);
+  return delay;
+}
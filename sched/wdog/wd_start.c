@@ -88,6 +88,30 @@
  *
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+static inline void wd_expiration(void)
+{
+  FAR struct wdog_s *wdog;
+  wdentry_t func;
+
+  /* Run the watchdogs that the wheel found due, including those that the
+   * watchdog functions themselves make due.
+   */
+
+  while ((wdog = wd_wheel_expired()) != NULL)
+    {
+      /* Indicate that the watchdog is no longer active. */
+
+      func = wdog->func;
+      wdog->func = NULL;
+
+      /* Execute the watchdog function */
+
+      up_setpicbase(wdog->picbase);
+      CALL_FUNC(func, wdog->arg);
+    }
+}
+#else
 static inline void wd_expiration(void)
 {
   FAR struct wdog_s *wdog;
@@ -124,6 +148,57 @@ static inline void wd_expiration(void)
       CALL_FUNC(func, wdog->arg);
     }
 }
+#endif /* CONFIG_WDOG_TIMERWHEEL */
+
+/****************************************************************************
+ * Name: wd_wheel_start
+ *
+ * Description:
+ *   Insert a watchdog into the timing wheel.  In the tick-less case the
+ *   interval timer only needs to be reprogrammed if the new watchdog is
+ *   the first to expire.
+ *
+ * Input Parameters:
+ *   wdog  - The watchdog, not active
+ *   delay - Delay in ticks, at least one
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+static inline void wd_wheel_start(FAR struct wdog_s *wdog, sclock_t delay)
+{
+#ifdef CONFIG_SCHED_TICKLESS
+  clock_t next = wd_wheel_nextdelay();
+  clock_t expired;
+
+  /* The wheel is not advanced while it is empty, so resynchronize it */
+
+  if (next == 0)
+    {
+      g_wdtickbase = clock_systime_ticks();
+    }
+
+  expired = g_wdtickbase + wd_elapse() + delay;
+  if (next == 0 || expired - g_wdtickbase < next)
+    {
+      /* The new watchdog expires first, restart the interval timer */
+
+      nxsched_cancel_timer();
+      wd_wheel_insert(wdog, expired);
+      nxsched_resume_timer();
+    }
+  else
+    {
+      wd_wheel_insert(wdog, expired);
+    }
+#else
+  wd_wheel_insert(wdog, g_wdtickbase + delay);
+#endif
+}
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -168,10 +243,12 @@ static inline void wd_expiration(void)
 int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
              wdentry_t wdentry, wdparm_t arg)
 {
+#ifndef CONFIG_WDOG_TIMERWHEEL
   FAR struct wdog_s *curr;
   FAR struct wdog_s *prev;
   FAR struct wdog_s *next;
   sclock_t now;
+#endif
   irqstate_t flags;
 
   /* Verify the wdog and setup parameters */
@@ -223,6 +300,9 @@ int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
       delay--;
     }
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  wd_wheel_start(wdog, delay);
+#else
 #ifdef CONFIG_SCHED_TICKLESS
   /* Cancel the interval timer that drives the timing events.  This will
    * cause wd_timer to be called which update the delay value for the first
@@ -335,6 +415,7 @@ int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
 
   nxsched_resume_timer();
 #endif
+#endif /* CONFIG_WDOG_TIMERWHEEL */
 
   leave_critical_section(flags);
   return OK;
@@ -366,7 +447,33 @@ int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
  *
  ****************************************************************************/
 
-#ifdef CONFIG_SCHED_TICKLESS
+#if defined(CONFIG_WDOG_TIMERWHEEL) && defined(CONFIG_SCHED_TICKLESS)
+unsigned int wd_timer(int ticks, bool noswitches)
+{
+  /* Move the watchdogs that became due to the expired list */
+
+  wd_wheel_advance(ticks);
+
+  /* Run them unless context switches are not possible now */
+
+  if (!noswitches)
+    {
+      wd_expiration();
+    }
+
+  /* Return the delay for the next slot that needs processing */
+
+  return wd_wheel_nextdelay();
+}
+
+#elif defined(CONFIG_WDOG_TIMERWHEEL)
+void wd_timer(void)
+{
+  wd_wheel_advance(1);
+  wd_expiration();
+}
+
+#elif defined(CONFIG_SCHED_TICKLESS)
 unsigned int wd_timer(int ticks, bool noswitches)
 {
   FAR struct wdog_s *wdog;
@@ -0,0 +1,377 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/wdog.h>
+
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Level n of the wheel has one slot per 64^n ticks and holds the watchdogs
+ * that expire in 64^n up to 64^(n+1) ticks.  When the time crosses a slot
+ * boundary of level n, the watchdogs of that slot are cascaded into the
+ * lower levels.  The watchdogs of a level 0 slot are due when the time
+ * reaches it.
+ */
+
+#define WD_LEVELS          CONFIG_WDOG_TIMERWHEEL_LEVELS
+#define WD_SLOTBITS        6
+#define WD_NSLOTS          (1 << WD_SLOTBITS)
+#define WD_SLOTMASK        (WD_NSLOTS - 1)
+#define WD_SHIFT(l)        ((l) * WD_SLOTBITS)
+#define WD_MAXDELAY        (((clock_t)1 << WD_SHIFT(WD_LEVELS)) - 1)
+
+#ifdef CONFIG_HAVE_BUILTIN_CTZ
+#  define WD_CTZ64(v)      __builtin_ctzll(v)
+#else
+#  define WD_CTZ64(v)      (ffsll(v) - 1)
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Each slot is a singly linked list of watchdogs in the order they were
+ * inserted.  The prev links make removal constant time; the prev link of
+ * the head points to the tail.
+ */
+
+static FAR struct wdog_s *g_wdwheel[WD_LEVELS][WD_NSLOTS];
+
+/* One bit per non-empty slot of each level */
+
+static uint64_t g_wdmap[WD_LEVELS];
+
+/* Watchdogs that are due but have not been run yet, in expiration order */
+
+static FAR struct wdog_s *g_wdexpired;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_slot_append
+ ****************************************************************************/
+
+static void wd_slot_append(FAR struct wdog_s **slot,
+                           FAR struct wdog_s *wdog)
+{
+  FAR struct wdog_s *head = *slot;
+
+  wdog->next = NULL;
+  wdog->slot = slot;
+
+  if (head == NULL)
+    {
+      wdog->prev = wdog;
+      *slot      = wdog;
+    }
+  else
+    {
+      wdog->prev       = head->prev;
+      head->prev->next = wdog;
+      head->prev       = wdog;
+    }
+}
+
+/****************************************************************************
+ * Name: wd_slot_nextevent
+ *
+ * Description:
+ *   Return the distance, 1 to 64, from slot 'index' to the next non-empty
+ *   slot of a level.  A distance of 64 is the slot 'index' itself, one
+ *   round later.  The map must not be empty.
+ *
+ ****************************************************************************/
+
+static inline int wd_slot_nextevent(uint64_t map, int index)
+{
+  index = (index + 1) & WD_SLOTMASK;
+  if (index != 0)
+    {
+      map = (map >> index) | (map << (WD_NSLOTS - index));
+    }
+
+  return WD_CTZ64(map) + 1;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_nextevent
+ *
+ * Description:
+ *   Return the number of ticks until the next slot must be processed, or
+ *   zero if the wheel is empty.
+ *
+ ****************************************************************************/
+
+static clock_t wd_wheel_nextevent(void)
+{
+  clock_t now = g_wdtickbase;
+  clock_t ret = 0;
+  clock_t dist;
+  clock_t base;
+  int level;
+
+  for (level = 0; level < WD_LEVELS; level++)
+    {
+      if (g_wdmap[level] != 0)
+        {
+          base = now >> WD_SHIFT(level);
+          base += wd_slot_nextevent(g_wdmap[level], base & WD_SLOTMASK);
+          dist = (base << WD_SHIFT(level)) - now;
+
+          if (ret == 0 || dist < ret)
+            {
+              ret = dist;
+            }
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_process
+ *
+ * Description:
+ *   Process the slots that start at the current time: cascade the upper
+ *   level slots and move the due watchdogs to the expired list.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_process(void)
+{
+  FAR struct wdog_s **slot;
+  FAR struct wdog_s *wdog;
+  clock_t now = g_wdtickbase;
+  int level;
+
+  for (level = 1; level < WD_LEVELS; level++)
+    {
+      if ((now & (((clock_t)1 << WD_SHIFT(level)) - 1)) != 0)
+        {
+          break;
+        }
+
+      slot = &g_wdwheel[level][(now >> WD_SHIFT(level)) & WD_SLOTMASK];
+      while ((wdog = *slot) != NULL)
+        {
+          wd_wheel_remove(wdog);
+          wd_wheel_insert(wdog, wdog->expired);
+        }
+    }
+
+  slot = &g_wdwheel[0][now & WD_SLOTMASK];
+  while ((wdog = *slot) != NULL)
+    {
+      wd_wheel_remove(wdog);
+      wd_slot_append(&g_wdexpired, wdog);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Insert a watchdog into the timing wheel.
+ *
+ * Input Parameters:
+ *   wdog    - The watchdog, not in the wheel
+ *   expired - Absolute expiration time in the ticks of g_wdtickbase
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog, clock_t expired)
+{
+  clock_t index = expired;
+  sclock_t delay;
+  int level = 0;
+  int slot;
+
+  wdog->expired = expired;
+
+  /* A delay of zero only happens while cascading and goes to the level 0
+   * slot that is processed right after.  A negative one is overdue.
+   */
+
+  delay = (sclock_t)(expired - g_wdtickbase);
+  if (delay < 0)
+    {
+      wd_slot_append(&g_wdexpired, wdog);
+      return;
+    }
+
+  /* Park longer delays in the last level; they are re-inserted each time
+   * their slot comes around.
+   */
+
+  if ((clock_t)delay > WD_MAXDELAY)
+    {
+      delay = WD_MAXDELAY;
+      index = g_wdtickbase + WD_MAXDELAY;
+    }
+
+  while (level < WD_LEVELS - 1 && (delay >> WD_SHIFT(level + 1)) != 0)
+    {
+      level++;
+    }
+
+  slot = (index >> WD_SHIFT(level)) & WD_SLOTMASK;
+  wd_slot_append(&g_wdwheel[level][slot], wdog);
+  g_wdmap[level] |= (uint64_t)1 << slot;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove a watchdog from the timing wheel or from the expired list.
+ *
+ ****************************************************************************/
+
+void wd_wheel_remove(FAR struct wdog_s *wdog)
+{
+  FAR struct wdog_s **slot = wdog->slot;
+  FAR struct wdog_s *head = *slot;
+  int index;
+
+  if (wdog == head)
+    {
+      *slot = wdog->next;
+    }
+  else
+    {
+      wdog->prev->next = wdog->next;
+    }
+
+  if (wdog->next != NULL)
+    {
+      wdog->next->prev = wdog->prev;
+    }
+  else if (wdog != head)
+    {
+      head->prev = wdog->prev;
+    }
+
+  if (*slot == NULL && slot != &g_wdexpired)
+    {
+      index = slot - &g_wdwheel[0][0];
+      g_wdmap[index >> WD_SLOTBITS] &= ~((uint64_t)1 <<
+                                         (index & WD_SLOTMASK));
+    }
+
+  wdog->slot = NULL;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_advance
+ *
+ * Description:
+ *   Advance the time of the wheel by 'ticks'.  Only the slots that hold
+ *   watchdogs are visited, so a long tick-less interval takes a number of
+ *   steps bounded by the number of levels and watchdogs, not by 'ticks'.
+ *   Due watchdogs are moved to the expired list.
+ *
+ ****************************************************************************/
+
+void wd_wheel_advance(clock_t ticks)
+{
+  clock_t target = g_wdtickbase + ticks;
+  clock_t next;
+  sclock_t remain;
+
+  for (; ; )
+    {
+      /* A watchdog function may have advanced the time already */
+
+      remain = (sclock_t)(target - g_wdtickbase);
+      if (remain <= 0)
+        {
+          break;
+        }
+
+      next = wd_wheel_nextevent();
+      if (next == 0 || next > (clock_t)remain)
+        {
+          g_wdtickbase = target;
+          break;
+        }
+
+      g_wdtickbase += next;
+      wd_wheel_process();
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_nextdelay
+ *
+ * Description:
+ *   Return the number of ticks until the wheel needs to be advanced again:
+ *   one if watchdogs are waiting to run, zero if no watchdog is active.
+ *   The next event may be a cascade rather than an expiration.
+ *
+ ****************************************************************************/
+
+clock_t wd_wheel_nextdelay(void)
+{
+  return g_wdexpired != NULL ? 1 : wd_wheel_nextevent();
+}
+
+/****************************************************************************
+ * Name: wd_wheel_expired
+ *
+ * Description:
+ *   Remove and return the first due watchdog, or NULL if there is none.
+ *
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_expired(void)
+{
+  FAR struct wdog_s *wdog = g_wdexpired;
+
+  if (wdog != NULL)
+    {
+      wd_wheel_remove(wdog);
+    }
+
+  return wdog;
+}
+
+#endif /* CONFIG_WDOG_TIMERWHEEL */
@@ -73,13 +73,16 @@ extern "C"
  * this linked list are removed and the function is called.
  */
 
+#ifndef CONFIG_WDOG_TIMERWHEEL
 extern sq_queue_t g_wdactivelist;
+#endif
 
 /* This is wdog tickbase, for wd_gettime() may called many times
  * between 2 times of wd_timer(), we use it to update wd_gettime().
+ * With the timing wheel it is also the current time of the wheel.
  */
 
-#ifdef CONFIG_SCHED_TICKLESS
+#if defined(CONFIG_SCHED_TICKLESS) || defined(CONFIG_WDOG_TIMERWHEEL)
 extern clock_t g_wdtickbase;
 #endif
 
@@ -141,6 +144,28 @@ void wd_timer(void);
 struct tcb_s;
 void wd_recover(FAR struct tcb_s *tcb);
 
+/****************************************************************************
+ * Name: wd_wheel_*
+ *
+ * Description:
+ *   Timing wheel primitives, see wd_wheel.c.  Watchdogs are kept by
+ *   absolute expiration time in the ticks of g_wdtickbase.  Due watchdogs
+ *   are moved to an expired list by wd_wheel_advance() and are run by
+ *   wd_timer() through wd_wheel_expired().
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+void wd_wheel_insert(FAR struct wdog_s *wdog, clock_t expired);
+void wd_wheel_remove(FAR struct wdog_s *wdog);
+void wd_wheel_advance(clock_t ticks);
+clock_t wd_wheel_nextdelay(void);
+FAR struct wdog_s *wd_wheel_expired(void);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
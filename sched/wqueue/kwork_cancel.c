@@ -37,11 +37,57 @@
 #ifdef CONFIG_SCHED_WORKQUEUE
 
 /****************************************************************************
- * Private Functions
+ * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: work_qcancel
+ * Name: work_cancel
+ *
+ * Description:
+ *   Cancel previously queued user-mode work.  This removes work from the
+ *   user mode work queue.  After work has been cancelled, it may be
+ *   requeued by calling work_queue() again.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID (must be HPWORK or LPWORK)
+ *   work   - The previously queued work structure to cancel
+ *
+ * Returned Value:
+ *   Zero (OK) on success, a negated errno on failure.  This error may be
+ *   reported:
+ *
+ *   -ENOENT - There is no such work queued.
+ *   -EINVAL - An invalid work queue was specified
+ *
+ ****************************************************************************/
+
+int work_cancel(int qid, FAR struct work_s *work)
+{
+#ifdef CONFIG_SCHED_HPWORK
+  if (qid == HPWORK)
+    {
+      /* Cancel high priority work */
+
+      return work_cancel_wq((FAR struct kwork_wqueue_s *)&g_hpwork, work);
+    }
+  else
+#endif
+#ifdef CONFIG_SCHED_LPWORK
+  if (qid == LPWORK)
+    {
+      /* Cancel low priority work */
+
+      return work_cancel_wq((FAR struct kwork_wqueue_s *)&g_lpwork, work);
+    }
+  else
+#endif
+    {
+      return -EINVAL;
+    }
+}
+
+/****************************************************************************
+ * Name: work_cancel_wq
  *
  * Description:
  *   Cancel previously queued work.  This removes work from the work queue.
@@ -49,7 +95,7 @@
  *   work_queue() again.
  *
  * Input Parameters:
- *   qid    - The work queue ID
+ *   wqueue - The work queue
  *   work   - The previously queued work structure to cancel
  *
  * Returned Value:
@@ -57,12 +103,12 @@
  *   reported:
  *
  *   -ENOENT - There is no such work queued.
- *   -EINVAL - An invalid work queue was specified
+ *   -EINVAL - The work is queued on another work queue
  *
  ****************************************************************************/
 
-static int work_qcancel(FAR struct kwork_wqueue_s *wqueue,
-                        FAR struct work_s *work)
+int work_cancel_wq(FAR struct kwork_wqueue_s *wqueue,
+                   FAR struct work_s *work)
 {
   irqstate_t flags;
   int ret = -ENOENT;
@@ -77,6 +123,12 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue,
   flags = enter_critical_section();
   if (work->worker != NULL)
     {
+      if (work->wq != wqueue)
+        {
+          leave_critical_section(flags);
+          return -EINVAL;
+        }
+
       /* Remove the entry from the work queue and make sure that it is
        * marked as available (i.e., the worker field is nullified).
        */
@@ -98,54 +150,4 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue,
   return ret;
 }
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: work_cancel
- *
- * Description:
- *   Cancel previously queued user-mode work.  This removes work from the
- *   user mode work queue.  After work has been cancelled, it may be
- *   requeued by calling work_queue() again.
- *
- * Input Parameters:
- *   qid    - The work queue ID (must be HPWORK or LPWORK)
- *   work   - The previously queued work structure to cancel
- *
- * Returned Value:
- *   Zero (OK) on success, a negated errno on failure.  This error may be
- *   reported:
- *
- *   -ENOENT - There is no such work queued.
- *   -EINVAL - An invalid work queue was specified
- *
- ****************************************************************************/
-
-int work_cancel(int qid, FAR struct work_s *work)
-{
-#ifdef CONFIG_SCHED_HPWORK
-  if (qid == HPWORK)
-    {
-      /* Cancel high priority work */
-
-      return work_qcancel((FAR struct kwork_wqueue_s *)&g_hpwork, work);
-    }
-  else
-#endif
-#ifdef CONFIG_SCHED_LPWORK
-  if (qid == LPWORK)
-    {
-      /* Cancel low priority work */
-
-      return work_qcancel((FAR struct kwork_wqueue_s *)&g_lpwork, work);
-    }
-  else
-#endif
-    {
-      return -EINVAL;
-    }
-}
-
 #endif /* CONFIG_SCHED_WORKQUEUE */
@@ -42,49 +42,132 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define queue_work(wqueue, work) \
-  do \
-    { \
-      int sem_count; \
-      dq_addlast((FAR dq_entry_t *)(work), &(wqueue).q); \
-      nxsem_get_value(&(wqueue).sem, &sem_count); \
-      if (sem_count < 0) /* There are threads waiting for sem. */ \
-        { \
-          nxsem_post(&(wqueue).sem); \
-        } \
-    } \
-  while (0)
+#ifdef CONFIG_WQUEUE_DEADLINE
+#  define WORK_DEADLINE_DEFAULT MSEC2TICK(CONFIG_WQUEUE_DEADLINE_DEFAULT)
+#endif
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: hp_work_timer_expiry
+ * Name: work_ready
+ *
+ * Description:
+ *   Add work that is due to the ready list of its work queue and wake up
+ *   an idle worker thread.  With CONFIG_WQUEUE_DEADLINE, work->deadline is
+ *   relative on entry; it is made absolute here and the work is inserted
+ *   before any work with a later deadline.
+ *
  ****************************************************************************/
 
-#ifdef CONFIG_SCHED_HPWORK
-static void hp_work_timer_expiry(wdparm_t arg)
+static void work_ready(FAR struct kwork_wqueue_s *wqueue,
+                       FAR struct work_s *work)
 {
-  irqstate_t flags = enter_critical_section();
-  queue_work(g_hpwork, arg);
-  leave_critical_section(flags);
-}
+#ifdef CONFIG_WQUEUE_DEADLINE
+  FAR struct work_s *prev;
 #endif
+  int sem_count;
+
+#ifdef CONFIG_WQUEUE_DEADLINE
+  work->deadline += clock_systime_ticks();
+
+  /* Search from the tail, most work goes there */
+
+  prev = (FAR struct work_s *)dq_tail(&wqueue->q);
+  while (prev != NULL &&
+         (sclock_t)(prev->deadline - work->deadline) > 0)
+    {
+      prev = (FAR struct work_s *)dq_prev((FAR dq_entry_t *)prev);
+    }
+
+  if (prev != NULL)
+    {
+      dq_addafter((FAR dq_entry_t *)prev, (FAR dq_entry_t *)work,
+                  &wqueue->q);
+    }
+  else
+    {
+      dq_addfirst((FAR dq_entry_t *)work, &wqueue->q);
+    }
+#else
+  dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+#endif
+
+  nxsem_get_value(&wqueue->sem, &sem_count);
+  if (sem_count < 0) /* There are threads waiting for sem. */
+    {
+      nxsem_post(&wqueue->sem);
+    }
+}
 
 /****************************************************************************
- * Name: lp_work_timer_expiry
+ * Name: work_timer_expiry
  ****************************************************************************/
 
-#ifdef CONFIG_SCHED_LPWORK
-static void lp_work_timer_expiry(wdparm_t arg)
+static void work_timer_expiry(wdparm_t arg)
 {
+  FAR struct work_s *work = (FAR struct work_s *)arg;
   irqstate_t flags = enter_critical_section();
-  queue_work(g_lpwork, arg);
+
+  work_ready(work->wq, work);
   leave_critical_section(flags);
 }
+
+/****************************************************************************
+ * Name: work_qqueue
+ ****************************************************************************/
+
+static int work_qqueue(FAR struct kwork_wqueue_s *wqueue,
+                       FAR struct work_s *work, worker_t worker,
+                       FAR void *arg, clock_t delay, clock_t deadline)
+{
+  irqstate_t flags;
+
+  if (wqueue == NULL)
+    {
+      return -EINVAL;
+    }
+
+  /* Interrupts are disabled so that this logic can be called from with
+   * task logic or from interrupt handling logic.
+   */
+
+  flags = enter_critical_section();
+
+  /* Remove the entry from the timer and work queue. */
+
+  if (work->worker != NULL)
+    {
+      work_cancel_wq(work->wq, work);
+    }
+
+  /* Initialize the work structure. */
+
+  work->worker = worker;           /* Work callback. non-NULL means queued */
+  work->arg = arg;                 /* Callback argument */
+  work->wq = wqueue;               /* Work queue */
+#ifdef CONFIG_WQUEUE_DEADLINE
+  work->deadline = deadline;       /* Relative until the work is ready */
+#else
+  UNUSED(deadline);
 #endif
 
+  /* Queue the new work */
+
+  if (!delay)
+    {
+      work_ready(wqueue, work);
+    }
+  else
+    {
+      wd_start(&work->u.timer, delay, work_timer_expiry, (wdparm_t)work);
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -122,70 +205,73 @@ static void lp_work_timer_expiry(wdparm_t arg)
 int work_queue(int qid, FAR struct work_s *work, worker_t worker,
                FAR void *arg, clock_t delay)
 {
-  irqstate_t flags;
-  int ret = OK;
-
-  /* Interrupts are disabled so that this logic can be called from with
-   * task logic or from interrupt handling logic.
-   */
-
-  flags = enter_critical_section();
-
-  /* Remove the entry from the timer and work queue. */
-
-  if (work->worker != NULL)
-    {
-      work_cancel(qid, work);
-    }
-
-  /* Initialize the work structure. */
-
-  work->worker = worker;           /* Work callback. non-NULL means queued */
-  work->arg = arg;                 /* Callback argument */
-
-  /* Queue the new work */
+  FAR struct kwork_wqueue_s *wqueue = NULL;
 
 #ifdef CONFIG_SCHED_HPWORK
   if (qid == HPWORK)
     {
-      /* Queue high priority work */
-
-      if (!delay)
-        {
-          queue_work(g_hpwork, work);
-        }
-      else
-        {
-          wd_start(&work->u.timer, delay, hp_work_timer_expiry,
-                   (wdparm_t)work);
-        }
+      wqueue = (FAR struct kwork_wqueue_s *)&g_hpwork;
     }
-  else
 #endif
+
 #ifdef CONFIG_SCHED_LPWORK
   if (qid == LPWORK)
     {
-      /* Queue low priority work */
-
-      if (!delay)
-        {
-          queue_work(g_lpwork, work);
-        }
-      else
-        {
-          wd_start(&work->u.timer, delay, lp_work_timer_expiry,
-                   (wdparm_t)work);
-        }
+      wqueue = (FAR struct kwork_wqueue_s *)&g_lpwork;
     }
-  else
 #endif
-    {
-      ret = -EINVAL;
-    }
 
-  leave_critical_section(flags);
+  return work_queue_wq(wqueue, work, worker, arg, delay);
+}
+
+/****************************************************************************
+ * Name: work_queue_wq
+ *
+ * Description:
+ *   Same as work_queue(), for a work queue created by work_queue_create().
+ *
+ ****************************************************************************/
+
+int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
+                  FAR struct work_s *work, worker_t worker,
+                  FAR void *arg, clock_t delay)
+{
+#ifdef CONFIG_WQUEUE_DEADLINE
+  return work_qqueue(wqueue, work, worker, arg, delay,
+                     WORK_DEADLINE_DEFAULT);
+#else
+  return work_qqueue(wqueue, work, worker, arg, delay, 0);
+#endif
+}
+
+/****************************************************************************
+ * Name: work_queue_deadline
+ *
+ * Description:
+ *   Queue work like work_queue_wq() with an explicit deadline.  The ready
+ *   work of a queue is performed in order of deadline.
+ *
+ * Input Parameters:
+ *   wqueue   - The work queue
+ *   work     - The work structure to queue
+ *   worker   - The worker callback to be invoked
+ *   arg      - The argument that will be passed to the worker callback
+ *   delay    - Delay (in clock ticks) until the work becomes ready
+ *   deadline - Time (in clock ticks) after it became ready by which the
+ *              work should have run
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
 
-  return ret;
+#ifdef CONFIG_WQUEUE_DEADLINE
+int work_queue_deadline(FAR struct kwork_wqueue_s *wqueue,
+                        FAR struct work_s *work, worker_t worker,
+                        FAR void *arg, clock_t delay, clock_t deadline)
+{
+  return work_qqueue(wqueue, work, worker, arg, delay, deadline);
 }
+#endif
 
 #endif /* CONFIG_SCHED_WORKQUEUE */
@@ -36,6 +36,7 @@
 #include <nuttx/queue.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/kthread.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/semaphore.h>
 
 #include "sched/sched.h"
@@ -82,6 +83,7 @@ struct hp_wqueue_s g_hpwork =
 {
   {NULL, NULL},
   SEM_INITIALIZER(0),
+  CONFIG_SCHED_HPNTHREADS,
 };
 
 #endif /* CONFIG_SCHED_HPWORK */
@@ -93,6 +95,7 @@ struct lp_wqueue_s g_lpwork =
 {
   {NULL, NULL},
   SEM_INITIALIZER(0),
+  CONFIG_SCHED_LPNTHREADS,
 };
 
 #endif /* CONFIG_SCHED_LPWORK */
@@ -272,22 +275,19 @@ static int work_thread_create(FAR const char *name, int priority,
 void work_foreach(int qid, work_foreach_t handler, FAR void *arg)
 {
   FAR struct kwork_wqueue_s *wqueue;
-  int nthread;
   int wndx;
 
 #ifdef CONFIG_SCHED_HPWORK
   if (qid == HPWORK)
     {
-      wqueue  = (FAR struct kwork_wqueue_s *)&g_hpwork;
-      nthread = CONFIG_SCHED_HPNTHREADS;
+      wqueue = (FAR struct kwork_wqueue_s *)&g_hpwork;
     }
   else
 #endif
 #ifdef CONFIG_SCHED_LPWORK
   if (qid == LPWORK)
     {
-      wqueue  = (FAR struct kwork_wqueue_s *)&g_lpwork;
-      nthread = CONFIG_SCHED_LPNTHREADS;
+      wqueue = (FAR struct kwork_wqueue_s *)&g_lpwork;
     }
   else
 #endif
@@ -295,12 +295,64 @@ void work_foreach(int qid, work_foreach_t handler, FAR void *arg)
       return;
     }
 
-  for (wndx = 0; wndx < nthread; wndx++)
+  for (wndx = 0; wndx < wqueue->nthreads; wndx++)
     {
       handler(wqueue->worker[wndx].pid, arg);
     }
 }
 
+/****************************************************************************
+ * Name: work_queue_create
+ *
+ * Description:
+ *   Create a kernel work queue with its own worker thread(s).
+ *
+ * Input Parameters:
+ *   name       - Name of the worker thread(s)
+ *   priority   - Priority of the worker thread(s)
+ *   stack_size - Stack size of each worker thread
+ *   nthreads   - Number of worker threads, at least one
+ *
+ * Returned Value:
+ *   The new work queue on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct kwork_wqueue_s *work_queue_create(FAR const char *name,
+                                             int priority, int stack_size,
+                                             int nthreads)
+{
+  FAR struct kwork_wqueue_s *wqueue;
+  int ret;
+
+  if (nthreads < 1)
+    {
+      return NULL;
+    }
+
+  wqueue = kmm_zalloc(sizeof(struct kwork_wqueue_s) +
+                      (nthreads - 1) * sizeof(struct kworker_s));
+  if (wqueue == NULL)
+    {
+      return NULL;
+    }
+
+  nxsem_init(&wqueue->sem, 0, 0);
+  wqueue->nthreads = nthreads;
+
+  /* The threads already created cannot be stopped, so the queue is not
+   * freed if one of them fails.
+   */
+
+  ret = work_thread_create(name, priority, stack_size, nthreads, wqueue);
+  if (ret < 0)
+    {
+      return NULL;
+    }
+
+  return wqueue;
+}
+
 /****************************************************************************
  * Name: work_start_highpri
  *
@@ -61,6 +61,7 @@ struct kwork_wqueue_s
 {
   struct dq_queue_s q;         /* The queue of pending work */
   sem_t             sem;       /* The counting semaphore of the wqueue */
+  int               nthreads;  /* Number of worker threads */
   struct kworker_s  worker[1]; /* Describes a worker thread */
 };
 
@@ -73,6 +74,7 @@ struct hp_wqueue_s
 {
   struct dq_queue_s q;         /* The queue of pending work */
   sem_t             sem;       /* The counting semaphore of the wqueue */
+  int               nthreads;  /* Number of worker threads */
 
   /* Describes each thread in the high priority queue's thread pool */
 
@@ -89,6 +91,7 @@ struct lp_wqueue_s
 {
   struct dq_queue_s q;         /* The queue of pending work */
   sem_t             sem;       /* The counting semaphore of the wqueue */
+  int               nthreads;  /* Number of worker threads */
 
   /* Describes each thread in the low priority queue's thread pool */
 
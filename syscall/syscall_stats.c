@@ -0,0 +1,374 @@
+/****************************************************************************
+ * syscall/syscall_stats.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/stat.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <syscall.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#ifdef CONFIG_SYSCALL_STATS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Output format:
+ *
+ *            1111111111222222222233333333334444444444555555555566
+ *   1234567890123456789012345678901234567890123456789012345678901
+ *
+ *   SYSCALL                       COUNT     TIME(us)  AVG(us)  MAX(us)
+ *   SSSSSSSSSSSSSSSSSSSSSSSS DDDDDDDDDD DDDDDDDDDDDD DDDDDDDD DDDDDDDD
+ *
+ * Only the system calls that were made are listed.  TIME is the total
+ * time of all calls, including the time that they were blocked.
+ */
+
+#define HDR_FMT "SYSCALL                       COUNT     TIME(us)  " \
+                "AVG(us)  MAX(us)\n"
+#define SYS_FMT "%-24s %10lu %12llu %8lu %8lu\n"
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic (plus a couple of
+ * bytes).
+ */
+
+#define SYS_LINELEN 80
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The statistics of one system call */
+
+struct syscall_stat_s
+{
+  uint32_t count;             /* Number of calls */
+  uint32_t maxtime;           /* Longest call, up_perf_gettime() units */
+  uint64_t time;              /* Total time, up_perf_gettime() units */
+};
+
+/* This structure describes one open "file" */
+
+struct syscall_file_s
+{
+  struct procfs_file_s base;  /* Base open file structure */
+  char line[SYS_LINELEN];     /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     syscall_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     syscall_close(FAR struct file *filep);
+static ssize_t syscall_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     syscall_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     syscall_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct syscall_stat_s g_syscall_stats[SYS_nsyscalls];
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly extern'ed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_syscall_operations =
+{
+  syscall_open,   /* open */
+  syscall_close,  /* close */
+  syscall_read,   /* read */
+  NULL,           /* write */
+
+  syscall_dup,    /* dup */
+
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+
+  syscall_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syscall_perf2us
+ ****************************************************************************/
+
+static uint64_t syscall_perf2us(uint64_t elapsed)
+{
+  unsigned long freq = up_perf_getfreq();
+
+  return freq != 0 ? elapsed * 1000000 / freq : 0;
+}
+
+/****************************************************************************
+ * Name: syscall_open
+ ****************************************************************************/
+
+static int syscall_open(FAR struct file *filep, FAR const char *relpath,
+                        int oflags, mode_t mode)
+{
+  FAR struct syscall_file_s *sysfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* This PROCFS file is read-only.  Any attempt to open with write access
+   * is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  sysfile = kmm_zalloc(sizeof(struct syscall_file_s));
+  if (!sysfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)sysfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syscall_close
+ ****************************************************************************/
+
+static int syscall_close(FAR struct file *filep)
+{
+  FAR struct syscall_file_s *sysfile;
+
+  /* Recover our private data from the struct file instance */
+
+  sysfile = (FAR struct syscall_file_s *)filep->f_priv;
+  DEBUGASSERT(sysfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(sysfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syscall_read
+ ****************************************************************************/
+
+static ssize_t syscall_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct syscall_file_s *sysfile;
+  struct syscall_stat_s copy;
+  irqstate_t flags;
+  size_t remaining = buflen;
+  size_t ncopied = 0;
+  size_t linesize;
+  size_t copysize;
+  off_t offset;
+  int nr;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  sysfile = (FAR struct syscall_file_s *)filep->f_priv;
+  DEBUGASSERT(sysfile);
+
+  /* The first line to output is the header */
+
+  offset   = filep->f_pos;
+  linesize = snprintf(sysfile->line, SYS_LINELEN, HDR_FMT);
+  copysize = procfs_memcpy(sysfile->line, linesize, buffer, remaining,
+                           &offset);
+
+  ncopied   += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  /* Followed by one line for each system call that was made */
+
+  for (nr = 0; nr < SYS_nsyscalls && remaining > 0; nr++)
+    {
+      flags = enter_critical_section();
+      memcpy(&copy, &g_syscall_stats[nr], sizeof(copy));
+      leave_critical_section(flags);
+
+      if (copy.count == 0)
+        {
+          continue;
+        }
+
+      linesize = snprintf(sysfile->line, SYS_LINELEN, SYS_FMT,
+                          g_funcnames[nr], (unsigned long)copy.count,
+                          (unsigned long long)syscall_perf2us(copy.time),
+                          (unsigned long)
+                          syscall_perf2us(copy.time / copy.count),
+                          (unsigned long)syscall_perf2us(copy.maxtime));
+
+      copysize  = procfs_memcpy(sysfile->line, linesize, buffer,
+                                remaining, &offset);
+
+      ncopied   += copysize;
+      buffer    += copysize;
+      remaining -= copysize;
+    }
+
+  /* Update the file position */
+
+  filep->f_pos += ncopied;
+  return ncopied;
+}
+
+/****************************************************************************
+ * Name: syscall_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int syscall_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct syscall_file_s *oldattr;
+  FAR struct syscall_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct syscall_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = kmm_malloc(sizeof(struct syscall_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct syscall_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syscall_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int syscall_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "syscalls" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syscall_account
+ *
+ * Description:
+ *   Add one system call to the statistics of /proc/syscalls.  Called by the
+ *   architecture when the call returns to the caller.
+ *
+ * Input Parameters:
+ *   nr      - The system call number, less CONFIG_SYS_RESERVED
+ *   elapsed - The up_perf_gettime() units since the entry of the call
+ *
+ * Assumptions/Limitations:
+ *   Called from the system call trap handler, which does not nest.
+ *
+ ****************************************************************************/
+
+void syscall_account(unsigned int nr, unsigned long elapsed)
+{
+  FAR struct syscall_stat_s *stat;
+
+  if (nr >= SYS_nsyscalls)
+    {
+      return;
+    }
+
+  stat = &g_syscall_stats[nr];
+  stat->count++;
+  stat->time += elapsed;
+  if (elapsed > stat->maxtime)
+    {
+      stat->maxtime = elapsed;
+    }
+}
+
+#endif /* CONFIG_SYSCALL_STATS */
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
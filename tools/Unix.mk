@@ -579,6 +579,16 @@ flash: $(BIN)
 download: $(BIN)
 	$(call FLASH, $<)
 
+# memreport
+#
+# Print the .data and .bss of the image grouped by source directory, see
+# tools/memreport.py.  The image must have debug information; add options
+# like a deeper grouping with MEMREPORT_ARGS="-d 4 -s 5".
+
+memreport: $(BIN)
+	$(Q) python3 $(TOPDIR)$(DELIM)tools$(DELIM)memreport.py static \
+		-z $(TOPDIR) --nm "$(NM)" $(MEMREPORT_ARGS) $(BIN)
+
 # bootloader
 #
 # Some architectures require the provisioning of a bootloader or other
@@ -0,0 +1,273 @@
+#!/usr/bin/env python3
+# tools/memreport.py
+#
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.  The
+# ASF licenses this file to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance with the
+# License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations
+# under the License.
+#
+
+
+"""Attribute the RAM of a NuttX image to the source directories using it.
+
+  memreport.py static nuttx
+      The .data and .bss symbols of the image, grouped by the directory of
+      the file that defines them (requires debug information).
+
+  memreport.py heap nuttx memdump.log
+      The heap blocks of a /proc/memdump ("echo used > /proc/memdump")
+      output, grouped by the directory of the first caller in their
+      backtrace that is not an allocator (requires CONFIG_MM_BACKTRACE > 0).
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+
+# nm symbol types of initialized and zero-initialized data
+
+DATA_TYPES = "dDgG"
+BSS_TYPES = "bBsS"
+
+# Frames in these directories allocate on behalf of their caller
+
+ALLOC_PREFIXES = (
+    "mm/",
+    "include/",
+    "libs/libc/stdlib/",
+    "libs/libc/string/",
+    "sched/group/group_malloc.c",
+    "sched/group/group_zalloc.c",
+    "sched/group/group_realloc.c",
+)
+
+MEMDUMP_LINE = re.compile(
+    r"^\s*(-?\d+)\s+(\d+)\s+(\d+)\s+(0x[0-9a-fA-F]+)((?:\s+0x[0-9a-fA-F]+)*)\s*$"
+)
+SYSLOG_PREFIX = re.compile(r"^\[[^\]]*\]\s*")
+
+
+def subsystem(path, topdir, depth):
+    """Return the first DEPTH directories of PATH relative to the tree."""
+
+    if not path or path.startswith("??"):
+        return "(unknown)"
+
+    path = os.path.normpath(path)
+    if os.path.isabs(path):
+        rel = os.path.relpath(path, topdir)
+        if rel.startswith(".."):
+            # Out of the tree, e.g. apps: keep the name of its top directory
+
+            rel = os.path.relpath(path, os.path.dirname(topdir))
+            if rel.startswith(".."):
+                return "(external)"
+
+        path = rel
+
+    parts = path.split(os.sep)[:-1]
+    return "/".join(parts[:depth]) if parts else "(top)"
+
+
+def static_report(args):
+    out = subprocess.run(
+        [args.nm, "--print-size", "--line-numbers", args.elf],
+        check=True,
+        stdout=subprocess.PIPE,
+        universal_newlines=True,
+    ).stdout
+
+    groups = {}
+    for line in out.splitlines():
+        fields = line.split("\t", 1)
+        cols = fields[0].split()
+        if len(cols) != 4:
+            continue
+
+        size = int(cols[1], 16)
+        kind = cols[2]
+        if kind in DATA_TYPES:
+            column = "data"
+        elif kind in BSS_TYPES:
+            column = "bss"
+        else:
+            continue
+
+        path = fields[1].rsplit(":", 1)[0] if len(fields) > 1 else None
+        group = groups.setdefault(
+            subsystem(path, args.topdir, args.depth),
+            {"data": 0, "bss": 0, "symbols": {}},
+        )
+        group[column] += size
+        group["symbols"][cols[3]] = size
+
+    return groups, ("data", "bss")
+
+
+def resolve(args, addrs):
+    """Map each address to its source file with one addr2line run."""
+
+    if not addrs:
+        return {}
+
+    out = subprocess.run(
+        [args.addr2line, "-e", args.elf] + addrs,
+        check=True,
+        stdout=subprocess.PIPE,
+        universal_newlines=True,
+    ).stdout.splitlines()
+
+    files = {}
+    for addr, line in zip(addrs, out):
+        files[addr] = line.rsplit(":", 1)[0]
+
+    return files
+
+
+def relative(path, topdir):
+    if path and os.path.isabs(path):
+        return os.path.relpath(os.path.normpath(path), topdir)
+
+    return path or ""
+
+
+def heap_report(args):
+    blocks = []
+    with open(args.log, errors="replace") as f:
+        for line in f:
+            match = MEMDUMP_LINE.match(SYSLOG_PREFIX.sub("", line))
+            if match:
+                pid, size = int(match.group(1)), int(match.group(2))
+                blocks.append((pid, size, match.group(5).split()))
+
+    addrs = sorted({a for _, _, bt in blocks for a in bt})
+    files = resolve(args, addrs)
+
+    groups = {}
+    for pid, size, backtrace in blocks:
+        name = None
+        for addr in backtrace:
+            path = files.get(addr)
+            rel = relative(path, args.topdir)
+            if path and not path.startswith("??") and not rel.startswith(
+                ALLOC_PREFIXES
+            ):
+                name = subsystem(path, args.topdir, args.depth)
+                break
+
+        if name is None:
+            name = "(pid %d)" % pid
+
+        group = groups.setdefault(name, {"blocks": 0, "bytes": 0, "symbols": {}})
+        group["blocks"] += 1
+        group["bytes"] += size
+
+    return groups, ("blocks", "bytes")
+
+
+def print_report(groups, columns, args):
+    # The RAM of a group: data + bss, or the bytes of its heap blocks
+
+    sizes = columns if "bss" in columns else columns[-1:]
+
+    def weight(group):
+        return sum(group[c] for c in sizes)
+
+    total = {c: sum(g[c] for g in groups.values()) for c in columns}
+    grand = sum(total[c] for c in sizes)
+    rule = "=" * (48 + 10 * len(columns))
+    head = "%-40s" + "%10s" * len(columns) + "%8s"
+    row = "%-40s" + "%10d" * len(columns)
+
+    print(head % (("Subsystem",) + columns + ("%",)))
+    print(rule)
+    for name, group in sorted(groups.items(), key=lambda kv: -weight(kv[1])):
+        percent = 100.0 * weight(group) / grand if grand else 0
+        values = tuple(group[c] for c in columns)
+        print((row + "%7.2f%%") % ((name,) + values + (percent,)))
+
+        if args.symbols:
+            top = sorted(group["symbols"].items(), key=lambda kv: -kv[1])
+            for sym, size in top[: args.symbols]:
+                print("    %-36s%10d" % (sym, size))
+
+    print(rule)
+    print(row % (("Total",) + tuple(total[c] for c in columns)))
+
+
+def main():
+    common = argparse.ArgumentParser(add_help=False)
+    common.add_argument(
+        "-z", "--topdir", default=os.getcwd(), help="NuttX top directory"
+    )
+    common.add_argument(
+        "-d",
+        "--depth",
+        type=int,
+        default=2,
+        help="number of directory levels of a subsystem (default: 2)",
+    )
+    common.add_argument("--json", help="also store the groups in a JSON file")
+
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter
+    )
+    sub = parser.add_subparsers(dest="command")
+    sub.required = True
+
+    p = sub.add_parser("static", parents=[common], help="report .data and .bss")
+    p.add_argument("elf", help="the nuttx ELF image")
+    p.add_argument("--nm", default="nm", help="nm of the toolchain")
+    p.add_argument(
+        "-s",
+        "--symbols",
+        type=int,
+        default=0,
+        help="list the N largest symbols of each subsystem",
+    )
+
+    p = sub.add_parser(
+        "heap", parents=[common], help="report the blocks of /proc/memdump"
+    )
+    p.add_argument("elf", help="the nuttx ELF image")
+    p.add_argument("log", help="the saved memdump output")
+    p.add_argument(
+        "--addr2line", default="addr2line", help="addr2line of the toolchain"
+    )
+    p.set_defaults(symbols=0)
+
+    args = parser.parse_args()
+    args.topdir = os.path.abspath(args.topdir)
+
+    if args.command == "static":
+        groups, columns = static_report(args)
+    else:
+        groups, columns = heap_report(args)
+
+    print_report(groups, columns, args)
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(
+                {n: {c: g[c] for c in columns} for n, g in groups.items()},
+                f,
+                indent=2,
+                sort_keys=True,
+            )
+
+
+if __name__ == "__main__":
+    main()
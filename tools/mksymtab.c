@@ -23,6 +23,7 @@
  ****************************************************************************/
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -43,6 +44,13 @@
  * Private Types
  ****************************************************************************/
 
+struct symbol_s
+{
+  char *name;
+  char *cond;
+  uint32_t hash;
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -50,6 +58,9 @@
 static const char *g_hdrfiles[MAX_HEADER_FILES];
 static int nhdrfiles;
 
+static struct symbol_s *g_symbols;
+static int nsymbols;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -59,7 +70,8 @@ static void show_usage(const char *progname)
   fprintf(stderr,
     "USAGE:\n");
   fprintf(stderr,
-    "%s [-d] <cvs-file> <symtab-file> [<symtab-name> [<nsymbols-name>]]\n\n",
+    "%s [-d] [-h] <cvs-file> <symtab-file> "
+    "[<symtab-name> [<nsymbols-name>]]\n\n",
     progname);
   fprintf(stderr,
     "Where:\n\n");
@@ -79,9 +91,58 @@ static void show_usage(const char *progname)
     "                   Default: \"%s\"\n", NSYMBOLS_NAME);
   fprintf(stderr,
     "  -d              : Enable debug output\n");
+  fprintf(stderr,
+    "  -h              : Add the name hashes and order the table by hash\n");
+  fprintf(stderr,
+    "                    (CONFIG_SYMTAB_HASHED)\n");
   exit(EXIT_FAILURE);
 }
 
+/* Must match symtab_hash() in libs/libc/symtab/symtab_sortbyhash.c */
+
+static uint32_t hash_name(const char *name)
+{
+  uint32_t hash = 5381;
+
+  while (*name != '\0')
+    {
+      hash = (hash << 5) + hash + (unsigned char)*name++;
+    }
+
+  return hash;
+}
+
+static int compare_hash(const void *arg1, const void *arg2)
+{
+  const struct symbol_s *sym1 = arg1;
+  const struct symbol_s *sym2 = arg2;
+
+  if (sym1->hash != sym2->hash)
+    {
+      return sym1->hash < sym2->hash ? -1 : 1;
+    }
+
+  return strcmp(sym1->name, sym2->name);
+}
+
+static void add_symbol(const char *name, const char *cond)
+{
+  struct symbol_s *symbols;
+
+  symbols = realloc(g_symbols, (nsymbols + 1) * sizeof(struct symbol_s));
+  if (symbols == NULL)
+    {
+      fprintf(stderr, "ERROR:  Out of memory\n");
+      exit(EXIT_FAILURE);
+    }
+
+  g_symbols                 = symbols;
+  g_symbols[nsymbols].name  = strdup(name);
+  g_symbols[nsymbols].cond  = strdup(cond);
+  g_symbols[nsymbols].hash  = hash_name(name);
+  nsymbols++;
+}
+
 static bool check_hdrfile(const char *hdrfile)
 {
   int i;
@@ -125,10 +186,11 @@ int main(int argc, char **argv, char **envp)
   char *csvpath;
   char *sympath;
   char *symtab;
-  char *nsymbols;
+  char *nsymname;
   char *nextterm;
   char *finalterm;
   char *ptr;
+  bool hashed;
   bool cond;
   FILE *instream;
   FILE *outstream;
@@ -138,10 +200,11 @@ int main(int argc, char **argv, char **envp)
   /* Parse command line options */
 
   symtab   = SYMTAB_NAME;
-  nsymbols = NSYMBOLS_NAME;
+  nsymname = NSYMBOLS_NAME;
   g_debug  = false;
+  hashed   = false;
 
-  while ((ch = getopt(argc, argv, ":d")) > 0)
+  while ((ch = getopt(argc, argv, ":dh")) > 0)
     {
       switch (ch)
         {
@@ -149,6 +212,10 @@ int main(int argc, char **argv, char **envp)
             g_debug = true;
             break;
 
+          case 'h' :
+            hashed = true;
+            break;
+
           case '?' :
             fprintf(stderr, "Unrecognized option: %c\n", optopt);
             show_usage(argv[0]);
@@ -189,7 +256,7 @@ int main(int argc, char **argv, char **envp)
 
   if (optind < argc)
     {
-       nsymbols = argv[optind];
+       nsymname = argv[optind];
        optind++;
     }
 
@@ -233,11 +300,18 @@ int main(int argc, char **argv, char **envp)
       /* Add the header file to the list of header files we need to include */
 
       add_hdrfile(g_parm[HEADER_INDEX]);
+
+      /* And the symbol to the list of symbols */
+
+      add_symbol(g_parm[NAME_INDEX], g_parm[COND_INDEX]);
     }
 
-  /* Back to the beginning */
+  /* The conditional entries do not break the hash order of the others */
 
-  rewind(instream);
+  if (hashed)
+    {
+      qsort(g_symbols, nsymbols, sizeof(struct symbol_s), compare_hash);
+    }
 
   /* Output up-front file boilerplate */
 
@@ -247,6 +321,19 @@ int main(int argc, char **argv, char **envp)
   fprintf(outstream, "#include <nuttx/compiler.h>\n");
   fprintf(outstream, "#include <nuttx/symtab.h>\n\n");
 
+  if (hashed)
+    {
+      fprintf(outstream, "#ifdef CONFIG_SYMTAB_ORDEREDBYNAME\n");
+      fprintf(outstream, "#  error \"Generated with mksymtab -h\"\n");
+    }
+  else
+    {
+      fprintf(outstream, "#ifdef CONFIG_SYMTAB_HASHED\n");
+      fprintf(outstream, "#  error \"Generated without mksymtab -h\"\n");
+    }
+
+  fprintf(outstream, "#endif\n\n");
+
   /* Output all of the require header files */
 
   for (i = 0; i < nhdrfiles; i++)
@@ -259,35 +346,35 @@ int main(int argc, char **argv, char **envp)
   fprintf(outstream, "\nconst struct symtab_s %s[] =\n", symtab);
   fprintf(outstream, "{\n");
 
-  /* Parse each line in the CVS file */
+  /* Output each symbol of the CVS file */
 
   nextterm  = "";
   finalterm = "";
 
-  while ((ptr = read_line(instream)) != NULL)
+  for (i = 0; i < nsymbols; i++)
     {
-      /* Parse the line from the CVS file */
-
-      int nargs = parse_csvline(ptr);
-      if (nargs < PARM1_INDEX)
-        {
-          fprintf(stderr, "Only %d arguments found: %s\n", nargs, g_line);
-          exit(EXIT_FAILURE);
-        }
-
       /* Output any conditional compilation */
 
-      cond = strlen(g_parm[COND_INDEX]) > 0;
+      cond = strlen(g_symbols[i].cond) > 0;
       if (cond)
         {
-          fprintf(outstream, "%s#if %s\n", nextterm, g_parm[COND_INDEX]);
+          fprintf(outstream, "%s#if %s\n", nextterm, g_symbols[i].cond);
           nextterm  = "";
         }
 
       /* Output the symbol table entry */
 
-      fprintf(outstream, "%s  { \"%s\", (FAR const void *)%s }",
-              nextterm, g_parm[NAME_INDEX], g_parm[NAME_INDEX]);
+      if (hashed)
+        {
+          fprintf(outstream, "%s  SYMTAB_ENTRY(\"%s\", %s, 0x%08xu)",
+                  nextterm, g_symbols[i].name, g_symbols[i].name,
+                  (unsigned int)g_symbols[i].hash);
+        }
+      else
+        {
+          fprintf(outstream, "%s  { \"%s\", (FAR const void *)%s }",
+                  nextterm, g_symbols[i].name, g_symbols[i].name);
+        }
 
       if (cond)
         {
@@ -304,7 +391,7 @@ int main(int argc, char **argv, char **envp)
   fprintf(outstream, "%s};\n\n", finalterm);
   fprintf(outstream,
     "#define NSYMBOLS (sizeof(%s) / sizeof (struct symtab_s))\n", symtab);
-  fprintf(outstream, "int %s = NSYMBOLS;\n", nsymbols);
+  fprintf(outstream, "int %s = NSYMBOLS;\n", nsymname);
 
   /* Close the CSV and symbol table files and exit */
 
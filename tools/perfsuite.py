@@ -0,0 +1,192 @@
+#!/usr/bin/env python3
+# tools/perfsuite.py
+#
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.  The
+# ASF licenses this file to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance with the
+# License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations
+# under the License.
+#
+
+
+"""Run, extract and compare the results of the boards/perfsuite.c suite.
+
+  perfsuite.py run nuttx > new.json
+  perfsuite.py extract console.log > new.json
+  perfsuite.py compare old.json new.json
+"""
+
+import argparse
+import json
+import subprocess
+import sys
+
+# Units where a larger value is a better result; all other units are costs
+
+RATE_SUFFIX = "/s"
+
+
+def parse(lines):
+    """Return the suite document found in an iterable of console lines.
+
+    Only the header, the records and the trailer are kept, so that syslog
+    output interleaved with the document does not break it.
+    """
+
+    header = None
+    records = []
+
+    for line in lines:
+        line = line.rstrip("\r\n")
+        if header is None:
+            start = line.find('{"perfsuite"')
+            if start >= 0:
+                header = line[start:]
+            continue
+
+        if line.startswith("]}"):
+            doc = json.loads(header + "]}")
+            doc["results"] = [json.loads(r.rstrip(",")) for r in records]
+            return doc
+
+        if line.startswith('  {"bench"'):
+            records.append(line.strip())
+
+    if header is None:
+        raise ValueError("no perfsuite document found")
+
+    raise ValueError("perfsuite document is truncated")
+
+
+def run(args):
+    proc = subprocess.Popen(
+        [args.nuttx],
+        stdin=subprocess.DEVNULL,
+        stdout=subprocess.PIPE,
+        universal_newlines=True,
+        errors="replace",
+    )
+
+    lines = []
+    try:
+        for line in proc.stdout:
+            lines.append(line)
+            if line.startswith("]}"):
+                break
+    finally:
+        proc.kill()
+        proc.wait()
+
+    return parse(lines)
+
+
+def extract(args):
+    with open(args.log, errors="replace") as f:
+        return parse(f)
+
+
+def load(path):
+    with open(path) as f:
+        doc = json.load(f)
+
+    return {(r["bench"], r["test"], r["unit"]): r["value"] for r in doc["results"]}, doc
+
+
+def compare(args):
+    base, basedoc = load(args.base)
+    new, newdoc = load(args.new)
+    regressions = 0
+
+    if basedoc.get("board") != newdoc.get("board"):
+        print(
+            "warning: comparing board %s with %s"
+            % (basedoc.get("board"), newdoc.get("board"))
+        )
+
+    for key in sorted(set(base) | set(new)):
+        bench, test, unit = key
+        name = "%s %s [%s]" % (bench, test, unit)
+
+        if key not in new:
+            print("%-48s missing" % name)
+            regressions += 1
+            continue
+        if key not in base:
+            print("%-48s new %d" % (name, new[key]))
+            continue
+
+        old = base[key]
+        cur = new[key]
+
+        if unit == "status":
+            if cur != 0:
+                print("%-48s failed with %d" % (name, cur))
+                regressions += 1
+            continue
+
+        if old == 0:
+            continue
+
+        change = (cur - old) * 100.0 / old
+        if abs(change) < args.threshold:
+            continue
+
+        worse = change < 0 if unit.endswith(RATE_SUFFIX) else change > 0
+        print(
+            "%-48s %12d -> %12d %+7.1f%% %s"
+            % (name, old, cur, change, "regression" if worse else "improvement")
+        )
+        if worse:
+            regressions += 1
+
+    print("%d regression(s)" % regressions)
+    return 1 if regressions else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest="command")
+    sub.required = True
+
+    p = sub.add_parser("run", help="run a simulator build and print its document")
+    p.add_argument("nuttx", help="the nuttx binary of a sim:perfsuite build")
+
+    p = sub.add_parser("extract", help="take the document out of a console log")
+    p.add_argument("log", help="the saved console output")
+
+    p = sub.add_parser("compare", help="compare two documents")
+    p.add_argument("base", help="the document of the reference build")
+    p.add_argument("new", help="the document of the build under test")
+    p.add_argument(
+        "--threshold",
+        type=float,
+        default=5.0,
+        help="percentage below which a change is ignored (default: 5)",
+    )
+
+    args = parser.parse_args()
+
+    if args.command == "compare":
+        sys.exit(compare(args))
+
+    try:
+        doc = run(args) if args.command == "run" else extract(args)
+    except ValueError as e:
+        sys.exit("error: %s" % e)
+
+    json.dump(doc, sys.stdout, indent=2)
+    print()
+
+
+if __name__ == "__main__":
+    main()
@@ -1519,6 +1519,81 @@ static void cmd_queue_init(void)
   UNUSED(ret);
 }
 
+/****************************************************************************
+ * Name: bt_receive_buf
+ *
+ * Description:
+ *   Queue a received buffer for processing on the work queue that matches
+ *   its priority.  The buffer is consumed in any case.
+ *
+ ****************************************************************************/
+
+static int bt_receive_buf(FAR struct bt_buf_s *buf)
+{
+  FAR struct bt_hci_evt_hdr_s *hdr;
+  int ret;
+
+  if (buf->type != BT_ACL_IN)
+    {
+      if (buf->type != BT_EVT)
+        {
+          wlerr("ERROR: Invalid buf type %u\n", buf->type);
+          bt_buf_release(buf);
+          return -EINVAL;
+        }
+
+      /* Command Complete/Status events use high priority messages. */
+
+      hdr = (FAR void *)buf->data;
+      if (hdr->evt == BT_HCI_EVT_CMD_COMPLETE ||
+          hdr->evt == BT_HCI_EVT_CMD_STATUS ||
+          hdr->evt == BT_HCI_EVT_NUM_COMPLETED_PACKETS)
+        {
+          /* Add the buffer to the high priority Rx buffer list */
+
+          bt_enqueue_bufwork(&g_hp_rxlist, buf);
+
+          /* If there is already pending work, then do nothing.  Otherwise,
+           * schedule processing of the Rx buffer list on the high priority
+           * work queue.
+           */
+
+          if (work_available(&g_hp_work))
+            {
+              ret = work_queue(HPWORK, &g_hp_work, priority_rx_work,
+                               &g_hp_rxlist, 0);
+              if (ret < 0)
+                {
+                  wlerr("ERROR:  Failed to schedule HPWORK: %d\n", ret);
+                }
+            }
+
+          return OK;
+        }
+    }
+
+  /* All others use the low priority work queue */
+
+  /* Add the buffer to the low priority Rx buffer list */
+
+  bt_enqueue_bufwork(&g_lp_rxlist, buf);
+
+  /* If there is already pending work, then do nothing.  Otherwise, schedule
+   * processing of the Rx buffer list on the low priority work queue.
+   */
+
+  if (work_available(&g_lp_work))
+    {
+      ret = work_queue(LPWORK, &g_lp_work, hci_rx_work, &g_lp_rxlist, 0);
+      if (ret < 0)
+        {
+          wlerr("ERROR:  Failed to schedule LPWORK: %d\n", ret);
+        }
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1716,9 +1791,7 @@ void bt_driver_unregister(FAR struct bt_driver_s *btdev)
 int bt_receive(FAR struct bt_driver_s *btdev, enum bt_buf_type_e type,
                FAR void *data, size_t len)
 {
-  FAR struct bt_hci_evt_hdr_s *hdr;
-  struct bt_buf_s *buf;
-  int ret;
+  FAR struct bt_buf_s *buf;
 
   wlinfo("data %p len %zu\n", data, len);
 
@@ -1733,66 +1806,50 @@ int bt_receive(FAR struct bt_driver_s *btdev, enum bt_buf_type_e type,
     }
 
   memcpy(bt_buf_extend(buf, len), data, len);
+  return bt_receive_buf(buf);
+}
 
-  if (type != BT_ACL_IN)
-    {
-      if (type != BT_EVT)
-        {
-          wlerr("ERROR: Invalid buf type %u\n", buf->type);
-          bt_buf_release(buf);
-          return -EINVAL;
-        }
-
-      /* Command Complete/Status events use high priority messages. */
-
-      hdr = (FAR void *)buf->data;
-      if (hdr->evt == BT_HCI_EVT_CMD_COMPLETE ||
-          hdr->evt == BT_HCI_EVT_CMD_STATUS ||
-          hdr->evt == BT_HCI_EVT_NUM_COMPLETED_PACKETS)
-        {
-          /* Add the buffer to the high priority Rx buffer list */
-
-          bt_enqueue_bufwork(&g_hp_rxlist, buf);
+/****************************************************************************
+ * Name: bt_receive_iob
+ *
+ * Description:
+ *   Called by the Bluetooth low-level driver when a new frame has been
+ *   received directly into an IOB.  The IOB is wrapped in a buffer
+ *   structure without copying the frame.
+ *
+ *   NOTE:  As bt_receive(), this may safely be called from interrupt
+ *   handling logic.
+ *
+ * Input Parameters:
+ *   btdev - The Bluetooth driver that received the frame.
+ *   type  - The type of the frame, BT_EVT or BT_ACL_IN.
+ *   iob   - The IOB holding the frame, starting at io_offset.
+ *
+ * Returned Value:
+ *   Zero on success; the IOB then belongs to the stack.  A negated errno
+ *   value on failure; the IOB then still belongs to the caller.
+ *
+ ****************************************************************************/
 
-          /* If there is already pending work, then do nothing.  Otherwise,
-           * schedule processing of the Rx buffer list on the high priority
-           * work queue.
-           */
+int bt_receive_iob(FAR struct bt_driver_s *btdev, enum bt_buf_type_e type,
+                   FAR struct iob_s *iob)
+{
+  FAR struct bt_buf_s *buf;
 
-          if (work_available(&g_hp_work))
-            {
-              ret = work_queue(HPWORK, &g_hp_work, priority_rx_work,
-                               &g_hp_rxlist, 0);
-              if (ret < 0)
-                {
-                  wlerr("ERROR:  Failed to schedule HPWORK: %d\n", ret);
-                }
-            }
+  wlinfo("iob %p len %u\n", iob, iob->io_len);
 
-          return OK;
-        }
+  if (type != BT_EVT && type != BT_ACL_IN)
+    {
+      return -EINVAL;
     }
 
-  /* All others use the low priority work queue */
-
-  /* Add the buffer to the low priority Rx buffer list */
-
-  bt_enqueue_bufwork(&g_lp_rxlist, buf);
-
-  /* If there is already pending work, then do nothing.  Otherwise, schedule
-   * processing of the Rx buffer list on the low priority work queue.
-   */
-
-  if (work_available(&g_lp_work))
+  buf = bt_buf_alloc(type, iob, 0);
+  if (buf == NULL)
     {
-      ret = work_queue(LPWORK, &g_lp_work, hci_rx_work, &g_lp_rxlist, 0);
-      if (ret < 0)
-        {
-          wlerr("ERROR:  Failed to schedule LPWORK: %d\n", ret);
-        }
+      return -ENOMEM;
     }
 
-  return OK;
+  return bt_receive_buf(buf);
 }
 
 #ifdef CONFIG_WIRELESS_BLUETOOTH_HOST
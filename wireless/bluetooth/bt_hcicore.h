@@ -488,4 +488,16 @@ void bt_hci_cb_register(FAR struct bt_hci_cb_s *cb);
 int bt_receive(FAR struct bt_driver_s *btdev, enum bt_buf_type_e type,
                FAR void *data, size_t len);
 
+/****************************************************************************
+ * Name: bt_receive_iob
+ *
+ * Description:
+ *   Like bt_receive(), but the received frame is already held in an IOB
+ *   that is handed over to the stack instead of being copied.
+ *
+ ****************************************************************************/
+
+int bt_receive_iob(FAR struct bt_driver_s *btdev, enum bt_buf_type_e type,
+                   FAR struct iob_s *iob);
+
 #endif /* __WIRELESS_BLUETOOTH_BT_HDICORE_H */